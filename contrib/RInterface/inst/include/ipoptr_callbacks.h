@@ -0,0 +1,108 @@
+/* Copyright (C) 2020 COIN-OR Foundation
+ * All Rights Reserved.
+ * This code is published under the Eclipse Public License.
+ *
+ * file:   ipoptr_callbacks.h
+ *
+ * This file defines the compiled callbacks that can be passed to ipoptr
+ * instead of R functions. The evaluations are then done without calling
+ * the R interpreter.
+ *
+ * The callbacks are collected in a struct ipoptr_callbacks, which is
+ * passed to R as an external pointer with tag ipoptr_callbacks, see
+ * ipoptr_make_callbacks(). The same external pointer can be given for
+ * the arguments eval_f, eval_grad_f, eval_g, eval_jac_g, and eval_h
+ * of ipoptr; for each argument, the corresponding member of the struct
+ * is used. R functions and compiled callbacks can be mixed.
+ *
+ * The callbacks return nonzero if the evaluation was successful.
+ * The arrays x and lambda must not be modified. The values of the
+ * Jacobian and Hessian have to be returned in the order of
+ * eval_jac_g_structure and eval_h_structure, respectively.
+ */
+
+#ifndef __IPOPTR_CALLBACKS_H__
+#define __IPOPTR_CALLBACKS_H__
+
+#include <Rinternals.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** objective function */
+typedef int (*ipoptr_eval_f_cb)(
+   int           n,
+   const double* x,
+   double*       obj_value,
+   void*         user_data
+);
+
+/** gradient of objective function */
+typedef int (*ipoptr_eval_grad_f_cb)(
+   int           n,
+   const double* x,
+   double*       grad_f,
+   void*         user_data
+);
+
+/** constraint functions */
+typedef int (*ipoptr_eval_g_cb)(
+   int           n,
+   const double* x,
+   int           m,
+   double*       g,
+   void*         user_data
+);
+
+/** values of the nonzeros of the Jacobian of the constraints */
+typedef int (*ipoptr_eval_jac_g_cb)(
+   int           n,
+   const double* x,
+   int           nele_jac,
+   double*       values,
+   void*         user_data
+);
+
+/** values of the nonzeros of the Hessian of the Lagrangian */
+typedef int (*ipoptr_eval_h_cb)(
+   int           n,
+   const double* x,
+   double        obj_factor,
+   int           m,
+   const double* lambda,
+   int           nele_hess,
+   double*       values,
+   void*         user_data
+);
+
+/** compiled callbacks; members that are not used can be NULL */
+typedef struct ipoptr_callbacks
+{
+   ipoptr_eval_f_cb      eval_f;
+   ipoptr_eval_grad_f_cb eval_grad_f;
+   ipoptr_eval_g_cb      eval_g;
+   ipoptr_eval_jac_g_cb  eval_jac_g;
+   ipoptr_eval_h_cb      eval_h;
+   void*                 user_data;  /**< passed to all callbacks */
+} ipoptr_callbacks;
+
+/** Creates the external pointer that passes callbacks to ipoptr.
+ *
+ *  The struct is not copied, so it must exist as long as the external
+ *  pointer is used. prot is kept alive with the external pointer and
+ *  can be used for an R object that owns the struct or user data.
+ */
+static R_INLINE SEXP ipoptr_make_callbacks(
+   ipoptr_callbacks* callbacks,
+   SEXP              prot
+)
+{
+   return R_MakeExternalPtr(callbacks, install("ipoptr_callbacks"), prot);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
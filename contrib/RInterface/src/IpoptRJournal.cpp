@@ -15,25 +15,38 @@
 
 #include "IpoptRJournal.hpp"
 
+#include <R_ext/Utils.h>        // USES R_FlushConsole
+
+/// Size of the buffer up to which the output is collected before it is printed.
+static const std::size_t MaxBufferLen = 65536;
+
 IpoptRJournal::IpoptRJournal(
    Ipopt::EJournalLevel default_level
 )
    : Journal("IpoptRJournal", default_level)
 { }
 
+IpoptRJournal::~IpoptRJournal()
+{
+   FlushBufferImpl();
+}
+
 void IpoptRJournal::PrintImpl(
    Ipopt::EJournalCategory /*category*/,
-   Ipopt::EJournalLevel    /*level*/,
+   Ipopt::EJournalLevel    level,
    const char*             str
 )
 {
-   // print string to R console
-   Rprintf(str);
+   buffer_ += str;
+   if( level <= Ipopt::J_ERROR || buffer_.size() >= MaxBufferLen )
+   {
+      FlushBufferImpl();
+   }
 }
 
 void IpoptRJournal::PrintfImpl(
-   Ipopt::EJournalCategory /*category*/,
-   Ipopt::EJournalLevel    /*level*/,
+   Ipopt::EJournalCategory category,
+   Ipopt::EJournalLevel    level,
    const char*             pformat,
    va_list                 ap
 )
@@ -44,14 +57,23 @@ void IpoptRJournal::PrintfImpl(
 
    // R guarantees to have an implementation of vsnprintf available
    // http://www.mail-archive.com/r-devel@stat.math.ethz.ch/msg07054.html
-   if( vsnprintf(s, MaxStrLen, pformat, ap) > MaxStrLen )
+   if( vsnprintf(s, MaxStrLen, pformat, ap) >= MaxStrLen )
    {
-      Rprintf("Warning: not all characters of next line are printed to the R console.\n");
+      buffer_ += "Warning: not all characters of next line are printed to the R console.\n";
    }
 
-   // print string to R console
-   Rprintf(s);
+   PrintImpl(category, level, s);
 }
 
 void IpoptRJournal::FlushBufferImpl()
-{ }
+{
+   if( buffer_.empty() )
+   {
+      return;
+   }
+
+   // print buffer to R console
+   Rprintf("%s", buffer_.c_str());
+   R_FlushConsole();
+   buffer_.clear();
+}
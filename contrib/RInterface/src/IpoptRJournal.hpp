@@ -8,6 +8,11 @@
  * This file defines a C++ class that takes care of re-directing
  * output to the R terminal. Needed for Windows.
  *
+ * The output is collected in a buffer and passed to the R console when
+ * Ipopt flushes its output, e.g., after each iteration, since printing
+ * to the R console can be slow (e.g., in RStudio). Error messages are
+ * printed immediately.
+ *
  * Financial support of the UK Economic and Social Research Council
  * through a grant (RES-589-28-0001) to the ESRC Centre for Microdata
  * Methods and Practice (CeMMAP) is gratefully acknowledged.
@@ -19,6 +24,8 @@
 #include "IpJournalist.hpp"     // ISA  Journal
 #include <R.h>                  // USES Rprintf
 
+#include <string>
+
 class IpoptRJournal: public Ipopt::Journal
 {
 public:
@@ -27,9 +34,8 @@ public:
       Ipopt::EJournalLevel default_level
    );
 
-   // The destructor.
-   virtual ~IpoptRJournal()
-   { }
+   // The destructor, prints what is left in the buffer.
+   virtual ~IpoptRJournal();
 
 protected:
    // These functions override the functions in the Journal class.
@@ -46,7 +52,12 @@ protected:
       va_list                 ap
    );
 
+   // Prints the buffer to the R console.
    virtual void FlushBufferImpl();
+
+private:
+   // output that has not been printed to the R console yet
+   std::string buffer_;
 };
 
 #endif
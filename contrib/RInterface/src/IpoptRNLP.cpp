@@ -14,13 +14,87 @@
  *
  * Changelog:
  *   09/03/2012: added outputs in finalize_solution; z_L, z_U, constraints, lambda (thanks to Michael Schedl)
+ *   compiled callbacks (see ipoptr_callbacks.h) and reuse of the argument vectors of the R functions
  */
 
 #include "IpoptRNLP.hpp"
 
+/** Returns the compiled callbacks if f is an external pointer, otherwise NULL.
+ *
+ * Raises an R error if f is an external pointer that has not been created
+ * by ipoptr_make_callbacks().
+ */
+static const ipoptr_callbacks* get_compiled_callbacks(
+   SEXP        f,
+   const char* name
+)
+{
+   if( TYPEOF(f) != EXTPTRSXP )
+   {
+      return NULL;
+   }
+   if( R_ExternalPtrTag(f) != install("ipoptr_callbacks") || R_ExternalPtrAddr(f) == NULL )
+   {
+      error("%s is an external pointer, but not one created by ipoptr_make_callbacks().", name);
+   }
+   return static_cast<const ipoptr_callbacks*>(R_ExternalPtrAddr(f));
+}
+
+/** Raises an R error if f gives compiled callbacks, but not the one that is required. */
+static void check_compiled_callback(
+   SEXP        f,
+   const char* name,
+   bool        (*has_callback)(const ipoptr_callbacks*)
+)
+{
+   const ipoptr_callbacks* cb = get_compiled_callbacks(f, name);
+   if( cb != NULL && !has_callback(cb) )
+   {
+      error("%s is given by compiled callbacks, but the callback for %s is NULL.", name, name);
+   }
+}
+
+static bool has_eval_f(
+   const ipoptr_callbacks* cb
+)
+{
+   return cb->eval_f != NULL;
+}
+
+static bool has_eval_grad_f(
+   const ipoptr_callbacks* cb
+)
+{
+   return cb->eval_grad_f != NULL;
+}
+
+static bool has_eval_g(
+   const ipoptr_callbacks* cb
+)
+{
+   return cb->eval_g != NULL;
+}
+
+static bool has_eval_jac_g(
+   const ipoptr_callbacks* cb
+)
+{
+   return cb->eval_jac_g != NULL;
+}
+
+static bool has_eval_h(
+   const ipoptr_callbacks* cb
+)
+{
+   return cb->eval_h != NULL;
+}
+
 /* Constructor. */
 IpoptRNLP::IpoptRNLP()
    : d_hessian_approximation(false),
+     R_x(R_NilValue),
+     R_obj_factor(R_NilValue),
+     R_lambda(R_NilValue),
      d_num_protected_members(0)
 { }
 
@@ -28,6 +102,33 @@ IpoptRNLP::~IpoptRNLP()
 {
    // UNPROTECT all SEXP members that we PROTECT
    UNPROTECT(d_num_protected_members);
+
+   // release the argument vectors
+   R_ReleaseObject(R_x);
+   R_ReleaseObject(R_obj_factor);
+   R_ReleaseObject(R_lambda);
+}
+
+SEXP IpoptRNLP::get_R_argument(
+   SEXP&                vec,
+   Ipopt::Index         len,
+   const Ipopt::Number* values
+)
+{
+   // The vector can only be overwritten if no R object refers to it anymore.
+   // Otherwise, e.g., if a user function stored its argument, a new vector is allocated.
+   if( vec == R_NilValue || length(vec) != len || MAYBE_SHARED(vec) )
+   {
+      R_ReleaseObject(vec);
+      PROTECT(vec = allocVector(REALSXP, len));
+      R_PreserveObject(vec);
+      UNPROTECT(1);
+   }
+   for( Ipopt::Index i = 0; i < len; i++ )
+   {
+      REAL(vec)[i] = values[i];
+   }
+   return vec;
 }
 
 //
@@ -45,6 +146,7 @@ void IpoptRNLP::set_R_eval_f(
    SEXP f
 )
 {
+   check_compiled_callback(f, "eval_f", has_eval_f);
    PROTECT(R_eval_f = f);
    d_num_protected_members++;
 }
@@ -53,6 +155,7 @@ void IpoptRNLP::set_R_eval_grad_f(
    SEXP f
 )
 {
+   check_compiled_callback(f, "eval_grad_f", has_eval_grad_f);
    PROTECT(R_eval_grad_f = f);
    d_num_protected_members++;
 }
@@ -85,6 +188,7 @@ void IpoptRNLP::set_R_eval_g(
    SEXP g
 )
 {
+   check_compiled_callback(g, "eval_g", has_eval_g);
    PROTECT(R_eval_g = g);
    d_num_protected_members++;
 }
@@ -93,6 +197,7 @@ void IpoptRNLP::set_R_eval_jac_g(
    SEXP g
 )
 {
+   check_compiled_callback(g, "eval_jac_g", has_eval_jac_g);
    PROTECT(R_eval_jac_g = g);
    d_num_protected_members++;
 }
@@ -125,6 +230,7 @@ void IpoptRNLP::set_R_eval_h(
    SEXP h
 )
 {
+   check_compiled_callback(h, "eval_h", has_eval_h);
    PROTECT(R_eval_h = h);
    d_num_protected_members++;
 }
@@ -281,25 +387,23 @@ bool IpoptRNLP::eval_f(
    // Check for user interruption from R
    R_CheckUserInterrupt();
 
-   SEXP rargs, Rcall, result;
-
-   // Allocate memory for a vector of reals.
-   // This vector will contain the elements of x,
-   // x is the argument to the R function R_eval_f
-   PROTECT(rargs = allocVector(REALSXP, n));
-   for( Ipopt::Index i = 0; i < n; i++ )
+   // compiled callback, called without the R interpreter
+   const ipoptr_callbacks* cb = get_compiled_callbacks(R_eval_f, "eval_f");
+   if( cb != NULL )
    {
-      REAL(rargs)[i] = x[i];
+      return cb->eval_f((int) n, x, &obj_value, cb->user_data) != 0;
    }
 
+   SEXP Rcall, result;
+
    // evaluate R function R_eval_f with the control x as an argument
-   PROTECT(Rcall = lang2(R_eval_f, rargs));
+   PROTECT(Rcall = lang2(R_eval_f, get_R_argument(R_x, n, x)));
    PROTECT(result = eval(Rcall, R_environment));
 
    // recode the return value from SEXP to Number
    obj_value = REAL(result)[0];
 
-   UNPROTECT(3);
+   UNPROTECT(2);
 
    return true;
 }
@@ -320,19 +424,16 @@ bool IpoptRNLP::eval_grad_f(
    // Check for user interruption from R
    R_CheckUserInterrupt();
 
-   SEXP rargs, Rcall, result;
-
-   // allocate memory for a vector of reals
-   // this vector will contain the elements of x
-   // x is the argument to the R function R_eval_grad_f
-   PROTECT(rargs = allocVector(REALSXP, n));
-   for( Ipopt::Index i = 0; i < n; i++ )
+   const ipoptr_callbacks* cb = get_compiled_callbacks(R_eval_grad_f, "eval_grad_f");
+   if( cb != NULL )
    {
-      REAL(rargs)[i] = x[i];
+      return cb->eval_grad_f((int) n, x, grad_f, cb->user_data) != 0;
    }
 
+   SEXP Rcall, result;
+
    // evaluate R function R_eval_grad_f with the control x as an argument
-   PROTECT(Rcall = lang2(R_eval_grad_f, rargs));
+   PROTECT(Rcall = lang2(R_eval_grad_f, get_R_argument(R_x, n, x)));
    PROTECT(result = eval(Rcall, R_environment));
 
    // recode the return values from SEXP to Numbers
@@ -341,7 +442,7 @@ bool IpoptRNLP::eval_grad_f(
       grad_f[i] = REAL(result)[i];
    }
 
-   UNPROTECT(3);
+   UNPROTECT(2);
 
    return true;
 }
@@ -359,18 +460,15 @@ bool IpoptRNLP::eval_g(
    // Check for user interruption from R
    R_CheckUserInterrupt();
 
-   SEXP rargs, Rcall, result;
-
-   // Allocate memory for a vector of reals
-   // this vector will contain the elements of x
-   // x is the argument to the R function R_eval_g
-   PROTECT(rargs = allocVector(REALSXP, n));
-   for( Ipopt::Index i = 0; i < n; i++ )
+   const ipoptr_callbacks* cb = get_compiled_callbacks(R_eval_g, "eval_g");
+   if( cb != NULL )
    {
-      REAL(rargs)[i] = x[i];
+      return cb->eval_g((int) n, x, (int) m, g, cb->user_data) != 0;
    }
 
-   PROTECT(Rcall = lang2(R_eval_g, rargs));
+   SEXP Rcall, result;
+
+   PROTECT(Rcall = lang2(R_eval_g, get_R_argument(R_x, n, x)));
    PROTECT(result = eval(Rcall, R_environment));
 
    for( Ipopt::Index i = 0; i < m; i++ )
@@ -378,7 +476,7 @@ bool IpoptRNLP::eval_g(
       g[i] = REAL(result)[i];
    }
 
-   UNPROTECT(3);
+   UNPROTECT(2);
 
    return true;
 }
@@ -431,18 +529,15 @@ bool IpoptRNLP::eval_jac_g(
    {
       // return the values of the jacobian of the constraints
 
-      SEXP rargs, Rcall, result;
-
-      // allocate memory for a vector of reals
-      // this vector will contain the elements of x
-      // x is the argument to the R function R_eval_g_jac
-      PROTECT(rargs = allocVector(REALSXP, n));
-      for( Ipopt::Index i = 0; i < n; i++ )
+      const ipoptr_callbacks* cb = get_compiled_callbacks(R_eval_jac_g, "eval_jac_g");
+      if( cb != NULL )
       {
-         REAL(rargs)[i] = x[i];
+         return cb->eval_jac_g((int) n, x, (int) nele_jac, values, cb->user_data) != 0;
       }
 
-      PROTECT(Rcall = lang2(R_eval_jac_g, rargs));
+      SEXP Rcall, result;
+
+      PROTECT(Rcall = lang2(R_eval_jac_g, get_R_argument(R_x, n, x)));
       PROTECT(result = eval(Rcall, R_environment));
 
       for( Ipopt::Index i = 0; i < nele_jac; i++ )
@@ -450,7 +545,7 @@ bool IpoptRNLP::eval_jac_g(
          values[i] = REAL(result)[i];
       }
 
-      UNPROTECT(3);
+      UNPROTECT(2);
 
    }
 
@@ -521,26 +616,15 @@ bool IpoptRNLP::eval_h(
          // element at 2,2: grad^2_{x2,x2} L(x,lambda)
          // values[1] = -2.0 * obj_factor;
 
-         SEXP rargs_x;
-         PROTECT(rargs_x = allocVector(REALSXP, n));
-         for( Ipopt::Index i = 0; i < n; i++ )
-         {
-            REAL(rargs_x)[i] = x[i];
-         }
-
-         SEXP rargs_obj_factor;
-         PROTECT(rargs_obj_factor = allocVector(REALSXP, 1));
-         REAL(rargs_obj_factor)[0] = obj_factor;
-
-         SEXP rargs_lambda;
-         PROTECT(rargs_lambda = allocVector(REALSXP, m));
-         for( Ipopt::Index i = 0; i < m; i++ )
+         const ipoptr_callbacks* cb = get_compiled_callbacks(R_eval_h, "eval_h");
+         if( cb != NULL )
          {
-            REAL(rargs_lambda)[i] = lambda[i];
+            return cb->eval_h((int) n, x, obj_factor, (int) m, lambda, (int) nele_hess, values, cb->user_data) != 0;
          }
 
          SEXP Rcall, result;
-         PROTECT(Rcall = lang4(R_eval_h, rargs_x, rargs_obj_factor, rargs_lambda));
+         PROTECT(Rcall = lang4(R_eval_h, get_R_argument(R_x, n, x), get_R_argument(R_obj_factor, 1, &obj_factor),
+                               get_R_argument(R_lambda, m, lambda)));
          PROTECT(result = eval(Rcall, R_environment));
 
          for( Ipopt::Index i = 0; i < nele_hess; i++ )
@@ -548,7 +632,7 @@ bool IpoptRNLP::eval_h(
             values[i] = REAL(result)[i];
          }
 
-         UNPROTECT(5);
+         UNPROTECT(2);
       }
 
       return true;
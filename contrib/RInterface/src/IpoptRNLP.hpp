@@ -17,6 +17,7 @@
 #define __IpoptRNLP_HPP__
 
 #include "IpTNLP.hpp"               // ISA TNLP
+#include "ipoptr_callbacks.h"
 
 #include <assert.h>
 
@@ -54,6 +55,19 @@ class IpoptRNLP: public Ipopt::TNLP
 
    bool d_hessian_approximation;   ///< should we approximate the Hessian? default: false
 
+   /** @name Arguments of the R functions.
+    *
+    * These vectors are kept between the evaluations and only allocated
+    * again if R still references them, e.g., because the user function
+    * stored its argument. They are preserved by R_PreserveObject, or
+    * R_NilValue if not allocated yet.
+    */
+   //@{
+   SEXP R_x;                       ///< argument x
+   SEXP R_obj_factor;              ///< argument obj_factor of R_eval_h
+   SEXP R_lambda;                  ///< argument hessian_lambda of R_eval_h
+   //@}
+
    int d_num_protected_members;    ///< counter of the number of PROTECT calls of the SEXPs above
 public:
    /** default constructor */
@@ -204,6 +218,16 @@ public:
    );
 
 private:
+   /** Returns a vector of reals with the len elements of values, reusing vec if possible.
+    *
+    * vec is one of the argument vectors R_x, R_obj_factor, R_lambda.
+    */
+   SEXP get_R_argument(
+      SEXP&                vec,
+      Ipopt::Index         len,
+      const Ipopt::Number* values
+   );
+
    /**@name Methods to block default compiler methods.
     * The compiler automatically generates the following three methods.
     *  Since the default compiler implementation is generally not what
@@ -16,6 +16,7 @@
  * Methods and Practice (CeMMAP) is gratefully acknowledged.
  *
  * 30/01/2011: added IpoptRJournal to correctly direct output to R terminal.
+ * IpoptRJournal is not added if print_level is 0.
  */
 
 #include "IpIpoptApplication.hpp"
@@ -166,9 +167,13 @@ extern "C" {
       // Set print_level to 0 for default console (to avoid double output under Linux)
       app->Options()->SetIntegerValue("print_level", 0);
 
-      // Add new journal with user-supplied print_level to print output to R console
-      Ipopt::SmartPtr<Ipopt::Journal> console = new IpoptRJournal(static_cast<Ipopt::EJournalLevel>(print_level));
-      app->Jnlst()->AddJournal(console);
+      // Add new journal with user-supplied print_level to print output to R console,
+      // unless the output only goes to the output_file
+      if( print_level > 0 )
+      {
+         Ipopt::SmartPtr<Ipopt::Journal> console = new IpoptRJournal(static_cast<Ipopt::EJournalLevel>(print_level));
+         app->Jnlst()->AddJournal(console);
+      }
 
       // Initialize the IpoptApplication and process the options
       Ipopt::ApplicationReturnStatus status;
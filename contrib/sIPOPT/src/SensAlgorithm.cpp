@@ -9,6 +9,7 @@
 #include "IpSmartPtr.hpp"
 
 #include "IpVector.hpp"
+#include "IpBlas.hpp"
 
 namespace Ipopt
 {
@@ -193,25 +194,46 @@ SensAlgorithmExitStatus SensAlgorithm::Run()
    return retval;
 }
 
-SensAlgorithmExitStatus SensAlgorithm::ComputeSensitivityMatrix(void)
+SensAlgorithmExitStatus SensAlgorithm::ComputeStep(
+   const Number* delta_p,
+   Number*       x_p
+)
 {
-   DBG_START_METH("SensAlgorithm::ComputeSensitivityMatrix", dbg_verbosity);
+   DBG_START_METH("SensAlgorithm::ComputeStep", dbg_verbosity);
 
-   SensAlgorithmExitStatus retval = SOLVE_SUCCESS;
+   SmartPtr < DenseVectorSpace > delta_u_space = new DenseVectorSpace(np_);
+   SmartPtr < DenseVector > delta_u = new DenseVector(GetRawPtr(ConstPtr(delta_u_space)));
+   delta_u->SetValues(delta_p);
+   delta_u->Print(Jnlst(), J_VECTOR, J_USER1, "delta_u");
 
-   /* Loop through all steps */
+   // the first driver is reset by SetSchurDriver, so every step starts
+   // without the bounds added by the boundcheck of earlier steps
    SmartPtr < IteratesVector > sol = IpData().curr()->MakeNewIteratesVector();
-   SmartPtr<const Vector> unscaled_x;
-   SmartPtr<const Vector> unscaled_yc;
+   sens_step_calc_->SetSchurDriver(driver_vec_[0]);
+   if( !sens_step_calc_->Step(*delta_u, *sol) )
+   {
+      return FATAL_ERROR;
+   }
 
-   SmartPtr < IteratesVector > trialcopy;
+   if( x_p != NULL )
+   {
+      SmartPtr < IteratesVector > saved_sol = sol->MakeNewIteratesVectorCopy();
+      UnScaleIteratesVector (&saved_sol);
+      const Number* x_val = dynamic_cast<const DenseVector*>(GetRawPtr(saved_sol->x()))->Values();
+      IpBlasDcopy(nx_, x_val, 1, x_p, 1);
+   }
 
-   SmartPtr < DenseVectorSpace > delta_u_space;
-   delta_u_space = new DenseVectorSpace(2);
+   // get sensitivity vector
+   GetDirectionalDerivatives();
 
-   SmartPtr < DenseVector > delta_u = new DenseVector(GetRawPtr(ConstPtr(delta_u_space)));
+   return SOLVE_SUCCESS;
+}
 
-   Number* du_val = delta_u->Values();
+SensAlgorithmExitStatus SensAlgorithm::ComputeSensitivityMatrix(void)
+{
+   DBG_START_METH("SensAlgorithm::ComputeSensitivityMatrix", dbg_verbosity);
+
+   SensAlgorithmExitStatus retval = SOLVE_SUCCESS;
 
    std::string state;
    std::string statevalue;
@@ -225,44 +247,55 @@ SensAlgorithmExitStatus SensAlgorithm::ComputeSensitivityMatrix(void)
 
    const std::vector<Index> idx_ipopt = x_owner_space_->GetIntegerMetaData(state.c_str());
 
-   char buffer[250];
+   // the perturbation vector has one entry per parameter
+   Index n_params = 0;
+   for( Index j = 0; j < (int) idx_ipopt.size(); ++j )
+   {
+      n_params = Max(n_params, idx_ipopt[j]);
+   }
 
-   Index col = 0;
+   SmartPtr < DenseVectorSpace > delta_u_space;
+   delta_u_space = new DenseVectorSpace(n_params);
+
+   // set up one rhs for each column, with a 1 at its parameter (eq. 9-10)
+   std::vector<SmartPtr<DenseVector> > delta_uV;
    for( Index Scol = 0; Scol < (int) idx_ipopt.size(); ++Scol )
    {
-
       if( idx_ipopt[Scol] > 0 )
       {
+         SmartPtr < DenseVector > delta_u = new DenseVector(GetRawPtr(ConstPtr(delta_u_space)));
+         delta_u->Set(0.);
+         delta_u->Values()[idx_ipopt[Scol] - 1] = 1.;
+         delta_uV.push_back(delta_u);
+      }
+   }
 
-         // reset rhs vector to zero
-         for( Index j = 0; j < (int) idx_ipopt.size(); ++j )
-         {
-            if( idx_ipopt[j] > 0 )
-            {
-               du_val[idx_ipopt[j] - 1] = 0;
-            }
-         }
-
-         sprintf(buffer, "Column %i", idx_ipopt[Scol]);
-
-         sens_step_calc_->SetSchurDriver(driver_vec_[0]);
+   if( delta_uV.empty() )
+   {
+      return retval;
+   }
 
-         // set rhs to 1 (eq. 9-10)
-         du_val[idx_ipopt[Scol] - 1] = 1;
+   sens_step_calc_->SetSchurDriver(driver_vec_[0]);
 
-         delta_u->SetValues(du_val);
-         //delta_u->Print(Jnlst(),J_VECTOR,J_USER1,"delta_u 1234567");
-         sens_step_calc_->Step(*delta_u, *sol);
-         SmartPtr < IteratesVector > saved_sol = sol->MakeNewIteratesVectorCopy();
-         saved_sol->Print(Jnlst(), J_VECTOR, J_USER1, "sol_vec");
+   // solve for all columns at once with the factorization of the KKT matrix
+   std::vector<SmartPtr<IteratesVector> > sensV;
+   if( !sens_step_calc_->SensitivityVectors(delta_uV, sensV) )
+   {
+      return FATAL_ERROR;
+   }
 
-         // unscale solution...
-         UnScaleIteratesVector (&saved_sol);
+   char buffer[250];
 
-         saved_sol->Print(Jnlst(), J_VECTOR, J_USER1, buffer);
+   Index col = 0;
+   for( Index Scol = 0; Scol < (int) idx_ipopt.size(); ++Scol )
+   {
+      if( idx_ipopt[Scol] > 0 )
+      {
+         sprintf(buffer, "Column %" IPOPT_INDEX_FORMAT, idx_ipopt[Scol]);
 
-         // Save column
-         GetSensitivityMatrix(col);
+         // unscale and save column
+         GetSensitivityMatrix(col, sensV[col]);
+         sensV[col]->Print(Jnlst(), J_VECTOR, J_USER1, buffer);
          ++col; // increase column counter
       }
    }
@@ -270,7 +303,8 @@ SensAlgorithmExitStatus SensAlgorithm::ComputeSensitivityMatrix(void)
 }
 
 void SensAlgorithm::GetSensitivityMatrix(
-   Index col
+   Index                    col,
+   SmartPtr<IteratesVector> SV
 )
 {
 
@@ -281,7 +315,6 @@ void SensAlgorithm::GetSensitivityMatrix(
 
    Index offset;
 
-   SmartPtr < IteratesVector > SV = sens_step_calc_->GetSensitivityVector();
    UnScaleIteratesVector (&SV);
 
    const Number* X_ = dynamic_cast<const DenseVector*>(GetRawPtr((*SV).x()))->Values();
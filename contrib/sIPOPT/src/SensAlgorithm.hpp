@@ -43,6 +43,20 @@ public:
    SensAlgorithmExitStatus Run();
    SensAlgorithmExitStatus ComputeSensitivityMatrix(void);
 
+   /** Compute a sensitivity step for a given parameter perturbation.
+    *
+    *  This can be called repeatedly after Run, as long as the
+    *  factorization of the KKT matrix has not been changed.
+    *  delta_p holds the np() perturbations of the parameters, ordered
+    *  by their number in sens_init_constr.  The directional derivatives
+    *  are updated, and if x_p is not NULL, the nx() values of the
+    *  perturbed unscaled primal solution are stored in x_p.
+    */
+   SensAlgorithmExitStatus ComputeStep(
+      const Number* delta_p,
+      Number*       x_p = NULL
+   );
+
    /** accessor methods to get access to variable sizes */
    Index nl(void)
    {
@@ -99,9 +113,10 @@ private:
    /** method to extract sensitivity vectors */
    void GetDirectionalDerivatives(void);
 
-   /** method to extract sensitivity matrix */
+   /** method to unscale the sensitivity vector SV and store it as column col of the sensitivity matrix */
    void GetSensitivityMatrix(
-      Index col
+      Index                    col,
+      SmartPtr<IteratesVector> SV
    );
 
    /** private method used to uncale perturbed solution and sensitivities */
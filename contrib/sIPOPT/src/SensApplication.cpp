@@ -66,6 +66,14 @@ void SensApplication::RegisterOptions(
                               "no", "don't check bounds and do another SchurSolve",
                               "yes", "check bounds and resolve Schur decomposition",
                               "If this option is activated, the algorithm will check the iterate after an initial Schursolve and will resolve the decomposition if any bounds are not satisfied");
+   roptions->AddStringOption2("sens_schur_driver",
+                              "Method for the factorization of the Schur matrix in the boundcheck of sIPOPT",
+                              "dense",
+                              "dense", "compute a new dense LU factorization whenever rows are added",
+                              "incremental", "update the factorization for the added rows only",
+                              "The boundcheck appends the violated bounds to the Schur matrix and solves again. "
+                              "With the incremental driver, only the Schur complement of the appended rows and columns is factorized. "
+                              "The costs for adding m rows to a Schur matrix of dimension k are then of order k^2*m+m^3 instead of (k+m)^3.");
    roptions->AddLowerBoundedNumberOption("sens_bound_eps",
                                          "Bound accuracy within which a bound still is considered to be valid",
                                          0, true, 1e-3,
@@ -117,6 +125,23 @@ void SensApplication::RegisterOptions(
                               "yes", "compute eigenvalue decomposition of reduced hessian",
                               "no", "don't compute eigenvalue decomposition of reduced hessian",
                               "The eigenvalue decomposition of the reduced hessian has different meanings depending on the specific problem. For parameter estimation problems, the eigenvalues are linked to the confidence interval of the parameters. See for example Victor Zavala's Phd thesis, chapter 4 for details.");
+   roptions->AddStringOption2("rh_matrix_free",
+                              "If yes, the reduced hessian matrix is not formed explicitly",
+                              "no",
+                              "yes", "estimate trace, diagonal, and eigenvalues from products with the reduced hessian",
+                              "no", "compute and print the reduced hessian matrix",
+                              "Forming the reduced hessian matrix requires one backsolve and storage of one column of the inverse KKT matrix for each free variable. "
+                              "With this option, only products of the reduced hessian with vectors are computed, each with one backsolve. "
+                              "The trace and the diagonal are estimated from rh_num_probes products with random vectors. "
+                              "If rh_eigendecomp is set, the extreme eigenvalues are estimated by at most rh_lanczos_steps steps of the Lanczos method.");
+   roptions->AddLowerBoundedIntegerOption("rh_num_probes",
+                                          "Number of random vectors for the trace and diagonal estimates of the reduced hessian",
+                                          1, 30,
+                                          "Only used if rh_matrix_free is set to yes. The statistical error of the estimates decreases with the square root of this number.");
+   roptions->AddLowerBoundedIntegerOption("rh_lanczos_steps",
+                                          "Maximal number of Lanczos steps for the eigenvalue estimates of the reduced hessian",
+                                          1, 50,
+                                          "Only used if rh_matrix_free and rh_eigendecomp are set to yes.");
    roptions->AddStringOption2("sens_allow_inexact_backsolve",
                               "Allow inexact computation of backsolve in sIPOPT.",
                               "yes",
@@ -303,6 +328,30 @@ SensAlgorithmExitStatus SensApplication::Run()
    return retval;
 }
 
+SensAlgorithmExitStatus SensApplication::ComputeSensitivityStep(
+   const Number* delta_p,
+   Number*       x_p
+)
+{
+   DBG_START_METH("SensApplication::ComputeSensitivityStep", dbg_verbosity);
+
+   if( !IsValid(controller) )
+   {
+      jnlst_->Printf(J_ERROR, J_MAIN, "\nsIPOPT: no sensitivity step can be computed before Run has computed one.\n"
+                     "Check the options run_sens and n_sens_steps.\n\n");
+      return FATAL_ERROR;
+   }
+
+   SensAlgorithmExitStatus retval = controller->ComputeStep(delta_p, x_p);
+
+   DirectionalD_X = controller->DirectionalD_X_;
+   DirectionalD_L = controller->DirectionalD_L_;
+   DirectionalD_Z_L = controller->DirectionalD_Z_L_;
+   DirectionalD_Z_U = controller->DirectionalD_Z_U_;
+
+   return retval;
+}
+
 void SensApplication::Initialize()
 {
    DBG_START_METH("SensApplication::Initialize", dbg_verbosity);
@@ -357,11 +406,10 @@ void SensApplication::SetIpoptAlgorithmObjects(
    // get pointers from IpoptApplication assessor methods
    SmartPtr<IpoptAlgorithm> alg = app_ipopt->AlgorithmObject();
 
-   SmartPtr<PDSearchDirCalculator> pd_search;
-   pd_search = dynamic_cast<PDSearchDirCalculator*>(GetRawPtr(alg->SearchDirCalc()));
-
    // get PD_Solver
-   pd_solver_ = pd_search->PDSolver();
+   pd_solver_ = alg->SearchDirCalc()->PDSolver();
+   ASSERT_EXCEPTION(IsValid(pd_solver_), OPTION_INVALID,
+                    "sIPOPT requires a search direction that is computed from the primal-dual system.");
 
    // get data
    ip_data_ = app_ipopt->IpoptDataObject();
@@ -41,6 +41,25 @@ public:
 
    SensAlgorithmExitStatus Run();
 
+   /** Compute another sensitivity step after Run.
+    *
+    *  The factorization of the KKT matrix and the controller built by
+    *  Run are reused, so that new parameter perturbations can be
+    *  processed repeatedly, e.g., for each new measurement in a
+    *  controller loop, without solving the NLP again.  This requires
+    *  that Run has computed sensitivity steps (run_sens and
+    *  n_sens_steps > 0) and that Ipopt has not been run in between.
+    *
+    *  delta_p holds np() perturbations of the parameters, ordered by
+    *  their number in sens_init_constr.  On return, GetDirectionalDerivatives
+    *  provides the derivatives for this perturbation, and x_p, if not
+    *  NULL, holds the nx() values of the perturbed primal solution.
+    */
+   SensAlgorithmExitStatus ComputeSensitivityStep(
+      const Number* delta_p,
+      Number*       x_p = NULL
+   );
+
    void Initialize();
 
    void SetIpoptAlgorithmObjects(
@@ -10,6 +10,8 @@
 #include "IpAlgStrategy.hpp"
 #include "IpIteratesVector.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 
@@ -29,6 +31,25 @@ public:
       SmartPtr<IteratesVector>       delta_lhs,
       SmartPtr<const IteratesVector> delta_rhs
    ) = 0;
+
+   /** Solve for several right hand sides at once.
+    *
+    *  The default implementation calls Solve for each right hand side.
+    */
+   virtual bool MultiSolve(
+      std::vector<SmartPtr<IteratesVector> >&       delta_lhsV,
+      std::vector<SmartPtr<const IteratesVector> >& delta_rhsV
+   )
+   {
+      DBG_ASSERT(delta_lhsV.size() == delta_rhsV.size());
+
+      bool retval = true;
+      for( size_t i = 0; i < delta_rhsV.size() && retval; ++i )
+      {
+         retval = Solve(delta_lhsV[i], delta_rhsV[i]);
+      }
+      return retval;
+   }
 };
 
 }
@@ -10,6 +10,7 @@
 #include "SensSchurData.hpp"
 #include "SensIndexSchurData.hpp"
 #include "SensDenseGenSchurDriver.hpp"
+#include "SensIncrementalSchurDriver.hpp"
 #include "SensMeasurement.hpp"
 #include "SensMetadataMeasurement.hpp"
 #include "SensStdStepCalc.hpp"
@@ -76,8 +77,11 @@ SmartPtr<SensAlgorithm> SensBuilder::BuildSensAlg(
       (void) retval;
    }
 
+   std::string schur_driver;
+   options.GetStringValue("sens_schur_driver", schur_driver, prefix);
+
    // Find out how many steps there are and create as many SchurSolveDrivers
-   int n_sens_steps;
+   Index n_sens_steps;
    options.GetIntegerValue("n_sens_steps", n_sens_steps, prefix);
 
    // Create std::vector container in which we are going to keep the SchurDrivers
@@ -93,7 +97,14 @@ SmartPtr<SensAlgorithm> SensBuilder::BuildSensAlg(
     *  Measurement class. This should get it's own branch! */
    for( Index i = 0; i < n_sens_steps; ++i )
    {
-      driver_vec[i] = new DenseGenSchurDriver(backsolver, pcalc, E_0);
+      if( schur_driver == "incremental" )
+      {
+         driver_vec[i] = new IncrementalSchurDriver(backsolver, pcalc, E_0);
+      }
+      else
+      {
+         driver_vec[i] = new DenseGenSchurDriver(backsolver, pcalc, E_0);
+      }
       driver_vec[i]->Initialize(jnlst, ip_nlp, ip_data, ip_cq, options, prefix);
       schur_retval = driver_vec[i]->SchurBuild();
       DBG_ASSERT(schur_retval);
@@ -141,7 +152,7 @@ SmartPtr<ReducedHessianCalculator> SensBuilder::BuildRedHessCalc(
    {
       jnlst.Printf(J_ERROR, J_MAIN,
                    "\nEXIT: An Error Occured while processing the Indices for the reduced Hessian computation: "
-                   "Something is wrong with index %d\n", setdata_error);
+                   "Something is wrong with index %" IPOPT_INDEX_FORMAT "\n", setdata_error);
       THROW_EXCEPTION(SENS_BUILDER_ERROR, "Reduced Hessian Index Error");
    }
 
@@ -152,7 +163,13 @@ SmartPtr<ReducedHessianCalculator> SensBuilder::BuildRedHessCalc(
    DBG_ASSERT(retval);
    (void) retval;
 
-   pcalc->ComputeP();
+   // the matrix free mode does not need the columns of P
+   bool matrix_free;
+   options.GetBoolValue("rh_matrix_free", matrix_free, prefix);
+   if( !matrix_free )
+   {
+      pcalc->ComputeP();
+   }
 
    SmartPtr<ReducedHessianCalculator> red_hess_calc = new ReducedHessianCalculator(E_0, pcalc);
 
@@ -0,0 +1,226 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "SensIncrementalSchurDriver.hpp"
+#include "SensIndexSchurData.hpp"
+#include "IpDenseVector.hpp"
+#include "IpDenseGenMatrix.hpp"
+#include "IpBlas.hpp"
+#include "IpLapack.hpp"
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 1;
+#endif
+
+IncrementalSchurDriver::IncrementalSchurDriver(
+   SmartPtr<SensBacksolver> backsolver,
+   SmartPtr<PCalculator>    pcalc,
+   SmartPtr<SchurData>      /*data_B*/
+)
+   : SchurDriver(pcalc, new IndexSchurData()),
+     backsolver_(backsolver),
+     dim_(0),
+     new_dim_(0)
+{
+   DBG_START_METH("IncrementalSchurDriver::IncrementalSchurDriver", dbg_verbosity);
+}
+
+IncrementalSchurDriver::~IncrementalSchurDriver()
+{
+   DBG_START_METH("IncrementalSchurDriver::~IncrementalSchurDriver", dbg_verbosity);
+}
+
+bool IncrementalSchurDriver::SchurBuild()
+{
+   DBG_START_METH("IncrementalSchurDriver::SchurBuild", dbg_verbosity);
+   bool retval = true;
+   new_dim_ = 0;
+   if( IsValid(data_B()) )
+   {
+      new_dim_ = data_B()->GetNRowsAdded();
+   }
+   if( new_dim_ > 0 )
+   {
+      SmartPtr<DenseGenMatrixSpace> S_space = new DenseGenMatrixSpace(new_dim_, new_dim_);
+      SmartPtr<DenseGenMatrix> S = new DenseGenMatrix(GetRawPtr(S_space));
+      SmartPtr<Matrix> S2 = GetRawPtr(S);
+      retval = pcalc_nonconst()->GetSchurMatrix(data_B(), S2);
+      S->Print(Jnlst(), J_VECTOR, J_USER1, "S_");
+      new_S_values_.assign(S->Values(), S->Values() + new_dim_ * new_dim_);
+   }
+   return retval;
+}
+
+bool IncrementalSchurDriver::SchurFactorize()
+{
+   DBG_START_METH("IncrementalSchurDriver::SchurFactorize", dbg_verbosity);
+
+   // check whether the factorized matrix is the leading block of the new one
+   bool is_leading = dim_ > 0 && dim_ <= new_dim_;
+   for( Index j = 0; j < dim_ && is_leading; ++j )
+   {
+      for( Index i = 0; i < dim_; ++i )
+      {
+         if( S_values_[j * dim_ + i] != new_S_values_[j * new_dim_ + i] )
+         {
+            is_leading = false;
+            break;
+         }
+      }
+   }
+
+   bool retval = true;
+   if( is_leading && dim_ == new_dim_ )
+   {
+      // nothing has changed
+      return true;
+   }
+   else if( is_leading && AddBlock(new_dim_) )
+   {
+      Jnlst().Printf(J_DETAILED, J_MAIN, "Updated factorization of Schur matrix from dimension %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT ".\n", dim_,
+                     new_dim_);
+   }
+   else
+   {
+      blocks_.clear();
+      dim_ = 0;
+      if( new_dim_ > 0 )
+      {
+         retval = AddBlock(new_dim_);
+      }
+   }
+
+   if( retval )
+   {
+      dim_ = new_dim_;
+      S_values_.swap(new_S_values_);
+   }
+   else
+   {
+      blocks_.clear();
+      dim_ = 0;
+      S_values_.clear();
+   }
+   new_S_values_.clear();
+
+   return retval;
+}
+
+bool IncrementalSchurDriver::AddBlock(
+   Index dim_S
+)
+{
+   DBG_START_METH("IncrementalSchurDriver::AddBlock", dbg_verbosity);
+
+   SchurBlock block;
+   block.offset = dim_;
+   block.dim = dim_S - dim_;
+   const Index off = block.offset;
+   const Index m = block.dim;
+   const Number* S = &new_S_values_[0];
+
+   block.T.resize(m * m);
+   for( Index j = 0; j < m; ++j )
+   {
+      IpBlasDcopy(m, S + (off + j) * dim_S + off, 1, &block.T[j * m], 1);
+   }
+
+   if( off > 0 )
+   {
+      // R = S(off:dim_S-1, 0:off-1)
+      block.R.resize(m * off);
+      for( Index j = 0; j < off; ++j )
+      {
+         IpBlasDcopy(m, S + j * dim_S + off, 1, &block.R[j * m], 1);
+      }
+
+      // X = S_0^{-1} S(0:off-1, off:dim_S-1)
+      block.X.resize(off * m);
+      for( Index j = 0; j < m; ++j )
+      {
+         IpBlasDcopy(off, S + (off + j) * dim_S, 1, &block.X[j * off], 1);
+      }
+      SolveS(m, &block.X[0], off);
+
+      // T = D - R X
+      IpBlasDgemm(false, false, m, m, off, -1., &block.R[0], m, &block.X[0], off, 1., &block.T[0], m);
+   }
+
+   block.ipiv.resize(m);
+   Index info;
+   IpLapackDgetrf(m, &block.T[0], &block.ipiv[0], m, info);
+   if( info != 0 )
+   {
+      return false;
+   }
+
+   blocks_.push_back(block);
+   return true;
+}
+
+void IncrementalSchurDriver::SolveS(
+   Index   nrhs,
+   Number* b,
+   Index   ldb
+)
+{
+   DBG_START_METH("IncrementalSchurDriver::SolveS", dbg_verbosity);
+
+   // after block l, the first offset+dim rows of b hold the solution with
+   // the leading block of S of this dimension
+   for( std::vector<SchurBlock>::iterator it = blocks_.begin(); it != blocks_.end(); ++it )
+   {
+      const Index off = it->offset;
+      const Index m = it->dim;
+      if( off > 0 )
+      {
+         IpBlasDgemm(false, false, m, nrhs, off, -1., &it->R[0], m, b, ldb, 1., b + off, ldb);
+      }
+      IpLapackDgetrs(m, nrhs, &it->T[0], m, &it->ipiv[0], b + off, ldb);
+      if( off > 0 )
+      {
+         IpBlasDgemm(false, false, off, nrhs, m, -1., &it->X[0], off, b + off, ldb, 1., b, ldb);
+      }
+   }
+}
+
+bool IncrementalSchurDriver::SchurSolve(
+   SmartPtr<IteratesVector>       lhs,     ///< new left hand side will be stored here
+   SmartPtr<const IteratesVector> rhs,     ///< rhs r_s
+   SmartPtr<Vector>               delta_u, ///< should be (u_p - u_0), at the end, delta_nu is saved in here.
+   SmartPtr<IteratesVector>       sol      ///< the vector K^(-1)*r_s which usually should have been computed before.
+)
+{
+   DBG_START_METH("IncrementalSchurDriver::SchurSolve", dbg_verbosity);
+   DBG_ASSERT(dim_ == delta_u->Dim());
+   bool retval;
+
+   // set up rhs of equation (3.48a)
+   SmartPtr<Vector> delta_rhs = delta_u->MakeNew();
+   data_B()->Multiply(*sol, *delta_rhs);
+   delta_rhs->Print(Jnlst(), J_VECTOR, J_USER1, "delta_rhs");
+   delta_rhs->Scal(-1.0);
+   delta_rhs->Axpy(1.0, *delta_u);
+   delta_rhs->Print(Jnlst(), J_VECTOR, J_USER1, "rhs 3.48a");
+
+   // solve equation (3.48a) for delta_nu
+   SmartPtr<DenseVector> delta_nu = dynamic_cast<DenseVector*>(GetRawPtr(delta_rhs))->MakeNewDenseVector();
+   delta_nu->Copy(*delta_rhs);
+   SolveS(1, delta_nu->Values(), dim_);
+   delta_nu->Print(Jnlst(), J_VECTOR, J_USER1, "delta_nu");
+
+   // solve equation (3.48b) for lhs (=delta_s)
+   SmartPtr<IteratesVector> new_rhs = lhs->MakeNewIteratesVector();
+   data_A()->TransMultiply(*delta_nu, *new_rhs);
+   new_rhs->Axpy(-1.0, *rhs);
+   new_rhs->Scal(-1.0);
+   new_rhs->Print(Jnlst(), J_VECTOR, J_USER1, "new_rhs");
+   retval = backsolver_->Solve(lhs, ConstPtr(new_rhs));
+
+   return retval;
+}
+
+}
@@ -0,0 +1,113 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __ASINCREMENTALSCHURDRIVER_HPP__
+#define __ASINCREMENTALSCHURDRIVER_HPP__
+
+#include "SensSchurDriver.hpp"
+#include "SensBacksolver.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+/** SchurDriver that updates the factorization of the Schur matrix
+ *  when rows and columns are appended to it.
+ *
+ *  The bound check of the sensitivity step appends the violated bounds
+ *  to data_A and data_B and rebuilds the Schur matrix S.  Instead of
+ *  a new LU factorization of S, this driver keeps the factorization
+ *  of the old matrix \f$S_0\f$ and factorizes only the Schur complement
+ *  of the appended block,
+ *
+ *  \f$S = \left[\begin{array}{cc} S_0 & C\\ R & D \end{array}\right],
+ *  \quad T = D - R S_0^{-1} C.\f$
+ *
+ *  Adding m rows to a Schur matrix of dimension k then costs
+ *  \f$O(k^2 m + m^3)\f$ instead of \f$O((k+m)^3)\f$.  If the leading block
+ *  of S has changed, or if T is singular, S is factorized anew.
+ */
+class IncrementalSchurDriver: public SchurDriver
+{
+public:
+   IncrementalSchurDriver(
+      SmartPtr<SensBacksolver> backsolver,
+      SmartPtr<PCalculator>    pcalc,
+      SmartPtr<SchurData>      data_B
+   );
+
+   virtual ~IncrementalSchurDriver();
+
+   /** Creates the SchurMatrix from B and P */
+   virtual bool SchurBuild();
+
+   /** Updates or computes the factorization of the SchurMatrix */
+   virtual bool SchurFactorize();
+
+   /** Performs a backsolve on S and K, see DenseGenSchurDriver::SchurSolve */
+   virtual bool SchurSolve(
+      SmartPtr<IteratesVector>       x,
+      SmartPtr<const IteratesVector> f,
+      SmartPtr<Vector>               g,
+      SmartPtr<IteratesVector>       Kf = NULL
+   );
+
+private:
+   /** Data of one block row and column of the factorization.
+    *
+    *  Block l consists of rows and columns offset to offset+dim-1 of S.
+    */
+   struct SchurBlock
+   {
+      /** First row and column of the block */
+      Index offset;
+      /** Number of rows and columns of the block */
+      Index dim;
+      /** Rows of S left of the diagonal block (dim x offset, column major) */
+      std::vector<Number> R;
+      /** Leading block inverse times the columns of S above the diagonal
+       *  block (offset x dim, column major) */
+      std::vector<Number> X;
+      /** LU factors of the Schur complement T of the block */
+      std::vector<Number> T;
+      /** Pivots of the LU factorization of T */
+      std::vector<Index> ipiv;
+   };
+
+   /** Solve with the factorized S for nrhs right hand sides in b,
+    *  which are overwritten by the solution */
+   void SolveS(
+      Index   nrhs,
+      Number* b,
+      Index   ldb
+   );
+
+   /** Append the rows and columns from dim_ on of new_S_values_,
+    *  which has dimension dim_S, as a new block to the factorization */
+   bool AddBlock(
+      Index dim_S
+   );
+
+   SmartPtr<SensBacksolver> backsolver_;
+
+   /** Dimension of the factorized Schur matrix */
+   Index dim_;
+
+   /** Values of the factorized Schur matrix (column major) */
+   std::vector<Number> S_values_;
+
+   /** Dimension of the Schur matrix built by the last SchurBuild */
+   Index new_dim_;
+
+   /** Values of the Schur matrix built by the last SchurBuild */
+   std::vector<Number> new_S_values_;
+
+   /** Blocks of the factorization */
+   std::vector<SchurBlock> blocks_;
+};
+
+}
+
+#endif
@@ -11,12 +11,19 @@
 #include "IpBlas.hpp"
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Ipopt
 {
 #if IPOPT_VERBOSITY > 0
 static const Index dbg_verbosity = 1;
 #endif
 
+/** Number of columns of P that are computed with one MultiSolve */
+static const Index col_block_size = 64;
+
 IndexPCalculator::IndexPCalculator(
    SmartPtr<SensBacksolver> backsolver,
    SmartPtr<SchurData>      A_data
@@ -56,47 +63,71 @@ bool IndexPCalculator::ComputeP()
    DBG_START_METH("IndexPCalculator::ComputeP", dbg_verbosity);
    bool retval = true;
 
-   // 1. check whether all columns needed by data_A() are in map cols_ - we suppose data_A is IndexSchurData
+   // 1. check whether all columns needed by data_A() are in P - we suppose data_A is IndexSchurData
    const std::vector<Index>* p2col_idx = dynamic_cast<const IndexSchurData*>(GetRawPtr(data_A()))->GetColIndices();
-   Index col;
-   Number* col_values = NULL;
-   Index curr_dim, curr_schur_row = 0;
-   SmartPtr<const DenseVector> comp_vec;
-   const Number* comp_values;
-   std::map<Index, SmartPtr<PColumn> >::iterator find_it;
-   SmartPtr<IteratesVector> col_vec = IpData().curr()->MakeNewIteratesVector();
-   SmartPtr<IteratesVector> sol_vec = col_vec->MakeNewIteratesVector();
+   Index curr_schur_row = 0;
+   Index first_new = (Index) col_pos_.size();
+   std::vector<Index> new_cols;
+   std::vector<Index> new_rows;
    for( std::vector<Index>::const_iterator col_it = p2col_idx->begin(); col_it != p2col_idx->end(); ++col_it )
    {
-      col = *col_it;
+      // column is in data_A but not in P-matrix ->create
+      if( col_pos_.find(*col_it) == col_pos_.end() )
+      {
+         col_pos_[*col_it] = first_new + (Index) new_cols.size();
+         new_cols.push_back(*col_it);
+         new_rows.push_back(curr_schur_row);
+      }
+      curr_schur_row++;
+   }
 
-      find_it = cols_.find(col);
-      if( find_it == cols_.end() )
+   if( new_cols.empty() )
+   {
+      return retval;
+   }
+
+   // 2. compute the missing columns, col_block_size columns with each MultiSolve
+   Index n_new = (Index) new_cols.size();
+   P_values_.resize(P_values_.size() + (size_t) n_new * nrows_);
+   for( Index block_start = 0; block_start < n_new && retval; block_start += col_block_size )
+   {
+      Index block_end = Min(block_start + col_block_size, n_new);
+
+      std::vector<SmartPtr<const IteratesVector> > col_vecs;
+      std::vector<SmartPtr<IteratesVector> > sol_vecs;
+      for( Index i = block_start; i < block_end; ++i )
+      {
+         SmartPtr<IteratesVector> col_vec = IpData().curr()->MakeNewIteratesVector();
+         data_A()->GetRow(new_rows[i], *col_vec);
+         col_vecs.push_back(ConstPtr(col_vec));
+         sol_vecs.push_back(col_vec->MakeNewIteratesVector());
+      }
+
+      retval = Solver()->MultiSolve(sol_vecs, col_vecs);
+      DBG_ASSERT(retval);
+
+      // 3. copy the solutions into their columns of P
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(static)
+#endif
+      for( Index i = block_start; i < block_end; ++i )
       {
-         // column is in data_A but not in P-matrix ->create
-         data_A()->GetRow(curr_schur_row, *col_vec);
-         retval = Solver()->Solve(sol_vec, ConstPtr(col_vec));
-         DBG_ASSERT(retval);
-
-         /* This part is for displaying norm2(I_z*K^(-1)*I_1) */
-         DBG_PRINT((dbg_verbosity, "\ncurr_schur_row=%d, ", curr_schur_row));
-         DBG_PRINT((dbg_verbosity, "norm2(z)=%23.16e\n", sol_vec->x()->Nrm2()));
-         /* end displaying norm2 */
-
-         DBG_ASSERT(col_values == NULL);
-         col_values = new Number[nrows_];
-         curr_dim = 0;
-         for( Index j = 0; j < sol_vec->NComps(); ++j )
+         const IteratesVector& sol_vec = *sol_vecs[i - block_start];
+         Number* col_values = &P_values_[(size_t) (first_new + i) * nrows_];
+         Index curr_dim = 0;
+         for( Index j = 0; j < sol_vec.NComps(); ++j )
          {
-            comp_vec = dynamic_cast<const DenseVector*>(GetRawPtr(sol_vec->GetComp(j)));
-            comp_values = comp_vec->Values();
-            IpBlasDcopy(comp_vec->Dim(), comp_values, 1, col_values + curr_dim, 1);
+            const DenseVector* comp_vec = static_cast<const DenseVector*>(GetRawPtr(sol_vec.GetComp(j)));
+            DBG_ASSERT(dynamic_cast<const DenseVector*>(GetRawPtr(sol_vec.GetComp(j))));
+            IpBlasDcopy(comp_vec->Dim(), comp_vec->Values(), 1, col_values + curr_dim, 1);
             curr_dim += comp_vec->Dim();
          }
-         cols_[col] = new PColumn(col_values);
-         col_values = NULL;
       }
-      curr_schur_row++;
+
+      /* This part is for displaying norm2(I_z*K^(-1)*I_1) */
+      DBG_PRINT((dbg_verbosity, "\ncol=%d, ", new_cols[block_end - 1]));
+      DBG_PRINT((dbg_verbosity, "norm2(z)=%23.16e\n", sol_vecs.back()->x()->Nrm2()));
+      /* end displaying norm2 */
    }
 
    return retval;
@@ -162,11 +193,23 @@ bool IndexPCalculator::GetSchurMatrix(
    // Compute S = B^T*P from indices, factors and P
    const std::vector<Index>* data_A_idx = dynamic_cast<const IndexSchurData*>(GetRawPtr(data_A()))->GetColIndices();
    const std::vector<Index>* data_B_idx = dynamic_cast<const IndexSchurData*>(GetRawPtr(B))->GetColIndices();
-   Index col_count = 0;
-   for( std::vector<Index>::const_iterator a_it = data_A_idx->begin(); a_it != data_A_idx->end(); ++a_it )
+   Index n_A = (Index) data_A_idx->size();
+   Index n_B = (Index) data_B_idx->size();
+   std::vector<const Number*> A_cols(n_A);
+   for( Index col = 0; col < n_A; ++col )
    {
-      cols_[*a_it]->GetSchurMatrixRows(data_B_idx, S_values + col_count * ncols_);
-      col_count++;
+      A_cols[col] = &P_values_[(size_t) col_pos_[(*data_A_idx)[col]] * nrows_];
+   }
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static)
+#endif
+   for( Index col = 0; col < n_A; ++col )
+   {
+      Number* S_col = S_values + col * ncols_;
+      for( Index i = 0; i < n_B; ++i )
+      {
+         S_col[i] = -A_cols[col][(*data_B_idx)[i]];
+      }
    }
 
    return retval;
@@ -183,53 +226,19 @@ void IndexPCalculator::PrintImpl(
 {
    DBG_START_METH("IndexPCalculator::PrintImpl", dbg_verbosity);
 
-   const Number* col_val;
-   jnlst.PrintfIndented(level, category, indent, "%sIndexPCalculator \"%s\" with %d rows and %d columns:\n",
+   jnlst.PrintfIndented(level, category, indent, "%sIndexPCalculator \"%s\" with %" IPOPT_INDEX_FORMAT " rows and %" IPOPT_INDEX_FORMAT " columns:\n",
                         prefix.c_str(), name.c_str(), nrows_, ncols_);
    Index col_counter = 0;
-   for( std::map<Index, SmartPtr<PColumn> >::const_iterator j = cols_.begin(); j != cols_.end(); ++j )
+   for( std::map<Index, Index>::const_iterator j = col_pos_.begin(); j != col_pos_.end(); ++j )
    {
-      col_val = j->second->Values();
+      const Number* col_val = &P_values_[(size_t) j->second * nrows_];
       for( Index i = 0; i < nrows_; ++i )
       {
-         jnlst.PrintfIndented(level, category, indent, "%s%s[%5d,%5d]=%23.16e\n", prefix.c_str(), name.c_str(), i,
+         jnlst.PrintfIndented(level, category, indent, "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e\n", prefix.c_str(), name.c_str(), i,
                               col_counter, col_val[i]);
       }
       col_counter++;
    }
 }
 
-PColumn::PColumn(
-   Number* values
-)
-   : val_(values)
-{
-   DBG_START_METH("PColumn::PColumn", dbg_verbosity);
-}
-
-PColumn::~PColumn()
-{
-   DBG_START_METH("PColumn::~PColumn", dbg_verbosity);
-   delete[] val_;
-}
-
-void PColumn::GetSchurMatrixRows(
-   const std::vector<Index>* row_idx_B,
-   Number*                   S_col
-) const
-{
-   DBG_START_METH("PColumn::GetSchurMatrixRows", dbg_verbosity);
-
-   for( Index i = 0; i < (int) row_idx_B->size(); ++i )
-   {
-      S_col[i] = -val_[(*row_idx_B)[i]];
-   }
-}
-
-const Number* PColumn::Values() const
-{
-   DBG_START_METH("PColumn::Values", dbg_verbosity);
-   return val_;
-}
-
 }
@@ -9,10 +9,11 @@
 
 #include "SensPCalculator.hpp"
 
+#include <map>
+#include <vector>
+
 namespace Ipopt
 {
-/* Forward declarations */
-class PColumn;
 
 class IndexPCalculator: public PCalculator
 {
@@ -57,30 +58,12 @@ private:
    /** Cols of P */
    Index ncols_;
 
-   std::map<Index, SmartPtr<PColumn> > cols_;
-
-};
-
-/** This class provides an easy interface for PCalculators with data where columns are
- *  not necessarily in adjacent parts of memory. */
-class PColumn: public ReferencedObject
-{
-public:
-   PColumn(
-      Number* values
-   );
-
-   virtual ~PColumn();
-
-   virtual void GetSchurMatrixRows(
-      const std::vector<Index>* row_idx_B,
-      Number*                   S
-   ) const;
-
-   virtual const Number* Values() const;
+   /** Values of the computed columns of P, stored contiguously
+    *  (column major, nrows_ values for each column) */
+   std::vector<Number> P_values_;
 
-private:
-   Number* val_;
+   /** Position in P_values_ of the column for each index of data_A */
+   std::map<Index, Index> col_pos_;
 };
 
 }
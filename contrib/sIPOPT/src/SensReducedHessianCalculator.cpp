@@ -6,6 +6,11 @@
 
 #include "SensReducedHessianCalculator.hpp"
 #include "IpDenseGenMatrix.hpp"
+#include "IpDenseSymMatrix.hpp"
+#include "IpBlas.hpp"
+#include "IpUtils.hpp"
+
+#include <cmath>
 
 namespace Ipopt
 {
@@ -36,26 +41,14 @@ bool ReducedHessianCalculator::InitializeImpl(
    DBG_START_METH("ReducedHessianCalculator::InitializeImpl", dbg_verbosity);
 
    options.GetBoolValue("rh_eigendecomp", compute_eigenvalues_, prefix);
+   options.GetBoolValue("rh_matrix_free", matrix_free_, prefix);
+   options.GetIntegerValue("rh_num_probes", num_probes_, prefix);
+   options.GetIntegerValue("rh_lanczos_steps", lanczos_steps_, prefix);
    return true;
 }
 
-bool ReducedHessianCalculator::ComputeReducedHessian()
+void ReducedHessianCalculator::WarnScaling()
 {
-   DBG_START_METH("ReducedHessianCalculator::ComputeReducedHessian", dbg_verbosity);
-
-   Index dim_S = hess_data_->GetNRowsAdded();
-   //SmartPtr<DenseGenMatrixSpace> S_space = new DenseGenMatrixSpace(dim_S, dim_S);
-   //SmartPtr<DenseGenMatrix> S = new DenseGenMatrix(GetRawPtr(S_space));
-   SmartPtr<Matrix> S;
-   bool retval = pcalc_->GetSchurMatrix(GetRawPtr(hess_data_), S);
-
-   SmartPtr<DenseSymMatrix> S_sym = dynamic_cast<DenseSymMatrix*>(GetRawPtr(S));
-   if( !IsValid(S_sym) )
-   {
-      std::exception exc;
-      throw(exc);
-   }
-
    bool have_x_scaling, have_c_scaling, have_d_scaling;
    have_x_scaling = IpNLP().NLP_scaling()->have_x_scaling();
    have_c_scaling = IpNLP().NLP_scaling()->have_c_scaling();
@@ -86,6 +79,32 @@ bool ReducedHessianCalculator::ComputeReducedHessian()
                      "-------------------------------------------------------------------------------\n\n");
 
    }
+}
+
+bool ReducedHessianCalculator::ComputeReducedHessian()
+{
+   DBG_START_METH("ReducedHessianCalculator::ComputeReducedHessian", dbg_verbosity);
+
+   if( matrix_free_ )
+   {
+      WarnScaling();
+      return EstimateReducedHessian();
+   }
+
+   Index dim_S = hess_data_->GetNRowsAdded();
+   //SmartPtr<DenseGenMatrixSpace> S_space = new DenseGenMatrixSpace(dim_S, dim_S);
+   //SmartPtr<DenseGenMatrix> S = new DenseGenMatrix(GetRawPtr(S_space));
+   SmartPtr<Matrix> S;
+   bool retval = pcalc_->GetSchurMatrix(GetRawPtr(hess_data_), S);
+
+   SmartPtr<DenseSymMatrix> S_sym = dynamic_cast<DenseSymMatrix*>(GetRawPtr(S));
+   if( !IsValid(S_sym) )
+   {
+      std::exception exc;
+      throw(exc);
+   }
+
+   WarnScaling();
 
    // Unscale by objective factor and multiply by (-1)
    Number obj_scal = IpNLP().NLP_scaling()->apply_obj_scaling(1.0);
@@ -112,4 +131,161 @@ bool ReducedHessianCalculator::ComputeReducedHessian()
    return retval;
 }
 
+bool ReducedHessianCalculator::MultiplyReducedHessian(
+   const std::vector<SmartPtr<const DenseVector> >& vV,
+   std::vector<SmartPtr<DenseVector> >&             SvV
+)
+{
+   DBG_START_METH("ReducedHessianCalculator::MultiplyReducedHessian", dbg_verbosity);
+
+   // the reduced hessian is obj_scal * E^T K^{-1} E
+   std::vector<SmartPtr<const IteratesVector> > rhsV;
+   std::vector<SmartPtr<IteratesVector> > solV;
+   for( size_t i = 0; i < vV.size(); ++i )
+   {
+      SmartPtr<IteratesVector> rhs = IpData().curr()->MakeNewIteratesVector();
+      hess_data_->TransMultiply(*vV[i], *rhs);
+      rhsV.push_back(ConstPtr(rhs));
+      solV.push_back(rhs->MakeNewIteratesVector());
+   }
+
+   bool retval = vV.empty() || pcalc_->Solver()->MultiSolve(solV, rhsV);
+
+   Number obj_scal = IpNLP().NLP_scaling()->apply_obj_scaling(1.0);
+   SvV.clear();
+   for( size_t i = 0; i < vV.size(); ++i )
+   {
+      SmartPtr<DenseVector> Sv = vV[i]->MakeNewDenseVector();
+      hess_data_->Multiply(*solV[i], *Sv);
+      Sv->Scal(obj_scal);
+      SvV.push_back(Sv);
+   }
+
+   return retval;
+}
+
+bool ReducedHessianCalculator::EstimateReducedHessian()
+{
+   DBG_START_METH("ReducedHessianCalculator::EstimateReducedHessian", dbg_verbosity);
+
+   Index dim_S = hess_data_->GetNRowsAdded();
+   SmartPtr<DenseVectorSpace> S_space = new DenseVectorSpace(dim_S);
+
+   // Estimate trace and diagonal from products with random vectors z
+   // with entries +-1, for which E[z^T S z] = tr(S) and E[z_i (S z)_i] = S_ii
+   IpResetRandom01();
+   std::vector<SmartPtr<const DenseVector> > zV;
+   for( Index k = 0; k < num_probes_; ++k )
+   {
+      SmartPtr<DenseVector> z = new DenseVector(GetRawPtr(S_space));
+      Number* z_val = z->Values();
+      for( Index i = 0; i < dim_S; ++i )
+      {
+         z_val[i] = IpRandom01() < 0.5 ? -1. : 1.;
+      }
+      zV.push_back(ConstPtr(z));
+   }
+   std::vector<SmartPtr<DenseVector> > SzV;
+   bool retval = MultiplyReducedHessian(zV, SzV);
+   if( !retval )
+   {
+      return false;
+   }
+
+   SmartPtr<DenseVector> diag = new DenseVector(GetRawPtr(S_space));
+   diag->Set(0.);
+   Number* diag_val = diag->Values();
+   Number trace = 0.;
+   for( Index k = 0; k < num_probes_; ++k )
+   {
+      const Number* z_val = zV[k]->Values();
+      const Number* Sz_val = SzV[k]->Values();
+      for( Index i = 0; i < dim_S; ++i )
+      {
+         diag_val[i] += z_val[i] * Sz_val[i];
+      }
+      trace += zV[k]->Dot(*SzV[k]);
+   }
+   diag->Scal(1. / num_probes_);
+   trace /= num_probes_;
+
+   Jnlst().Printf(J_INSUPPRESSIBLE, J_USER1, "Estimated trace of reduced hessian matrix (%" IPOPT_INDEX_FORMAT " random vectors): %23.16e\n",
+                  num_probes_, trace);
+   diag->Print(Jnlst(), J_INSUPPRESSIBLE, J_USER1, "Estimated diagonal of reduced hessian matrix");
+
+   if( !compute_eigenvalues_ )
+   {
+      return true;
+   }
+
+   // Lanczos iteration with full reorthogonalization; the eigenvalues
+   // of the tridiagonal matrix approximate the extreme eigenvalues
+   Index max_steps = Min(lanczos_steps_, dim_S);
+   std::vector<SmartPtr<DenseVector> > Q;
+   std::vector<Number> alpha;
+   std::vector<Number> beta;
+
+   SmartPtr<DenseVector> q = new DenseVector(GetRawPtr(S_space));
+   Number* q_val = q->Values();
+   for( Index i = 0; i < dim_S; ++i )
+   {
+      q_val[i] = IpRandom01() - 0.5;
+   }
+   q->Scal(1. / q->Nrm2());
+
+   for( Index j = 0; j < max_steps; ++j )
+   {
+      Q.push_back(q);
+      std::vector<SmartPtr<const DenseVector> > qV(1, ConstPtr(q));
+      std::vector<SmartPtr<DenseVector> > SqV;
+      if( !MultiplyReducedHessian(qV, SqV) )
+      {
+         return false;
+      }
+      SmartPtr<DenseVector> w = SqV[0];
+      alpha.push_back(q->Dot(*w));
+      for( size_t l = 0; l < Q.size(); ++l )
+      {
+         w->Axpy(-Q[l]->Dot(*w), *Q[l]);
+      }
+      Number b = w->Nrm2();
+      if( j + 1 == max_steps || b <= 1e-12 * std::abs(alpha.back()) )
+      {
+         break;
+      }
+      beta.push_back(b);
+      w->Scal(1. / b);
+      q = w;
+   }
+
+   Index m = (Index) alpha.size();
+   SmartPtr<DenseSymMatrixSpace> T_space = new DenseSymMatrixSpace(m);
+   SmartPtr<DenseSymMatrix> T = new DenseSymMatrix(GetRawPtr(T_space));
+   Number* T_val = T->Values();
+   for( Index k = 0; k < m * m; ++k )
+   {
+      T_val[k] = 0.;
+   }
+   for( Index j = 0; j < m; ++j )
+   {
+      T_val[j + j * m] = alpha[j];
+      if( j + 1 < m )
+      {
+         T_val[j + 1 + j * m] = beta[j];
+      }
+   }
+
+   SmartPtr<DenseGenMatrixSpace> eigenvectorspace = new DenseGenMatrixSpace(m, m);
+   SmartPtr<DenseGenMatrix> eigenvectors = new DenseGenMatrix(GetRawPtr(eigenvectorspace));
+   SmartPtr<DenseVectorSpace> eigenvaluesspace = new DenseVectorSpace(m);
+   SmartPtr<DenseVector> eigenvalues = new DenseVector(GetRawPtr(eigenvaluesspace));
+
+   eigenvectors->ComputeEigenVectors(*T, *eigenvalues);
+   char buffer[100];
+   Snprintf(buffer, 99, "Ritz values of reduced hessian matrix (%" IPOPT_INDEX_FORMAT " Lanczos steps)", m);
+   eigenvalues->Print(Jnlst(), J_INSUPPRESSIBLE, J_USER1, buffer);
+
+   return true;
+}
+
 }
@@ -10,6 +10,9 @@
 #include "IpAlgStrategy.hpp"
 #include "SensSchurData.hpp"
 #include "SensPCalculator.hpp"
+#include "IpDenseVector.hpp"
+
+#include <vector>
 
 namespace Ipopt
 {
@@ -33,10 +36,32 @@ public:
       const std::string& prefix
    );
 
-   /** This function computes the unscaled reduced hessian matrix */
+   /** This function computes the unscaled reduced hessian matrix
+    *
+    *  If rh_matrix_free is set, the matrix is not formed.  Instead,
+    *  estimates of its trace and diagonal and, if rh_eigendecomp is
+    *  set, of its extreme eigenvalues are computed from products with
+    *  vectors, see MultiplyReducedHessian.
+    */
    virtual bool ComputeReducedHessian();
 
+   /** Multiply the unscaled reduced hessian matrix with the vectors in vV.
+    *
+    *  The products are stored in SvV.  One backsolve with the KKT
+    *  matrix is needed for each vector; all of them are done by one
+    *  MultiSolve.
+    */
+   virtual bool MultiplyReducedHessian(
+      const std::vector<SmartPtr<const DenseVector> >& vV,
+      std::vector<SmartPtr<DenseVector> >&             SvV
+   );
+
 private:
+   /** Print a warning if the NLP is scaled */
+   void WarnScaling();
+
+   /** Compute and print the estimates of the matrix free mode */
+   bool EstimateReducedHessian();
 
    /** Pointer to Schurdata object holding the indices for selecting the free variables */
    SmartPtr<SchurData> hess_data_;
@@ -46,6 +71,15 @@ private:
 
    /** True, if option rh_eigendecomp was set to yes */
    bool compute_eigenvalues_;
+
+   /** True, if option rh_matrix_free was set to yes */
+   bool matrix_free_;
+
+   /** Number of random vectors for the trace and diagonal estimates */
+   Index num_probes_;
+
+   /** Maximal number of Lanczos steps for the eigenvalue estimates */
+   Index lanczos_steps_;
 };
 
 }
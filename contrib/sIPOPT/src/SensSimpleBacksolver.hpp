@@ -37,6 +37,13 @@ public:
       SmartPtr<const IteratesVector> delta_rhs
    );
 
+   /** Solve for all right hand sides with a single call to the
+    *  MultiSolve of the PDSystemSolver */
+   bool MultiSolve(
+      std::vector<SmartPtr<IteratesVector> >&       delta_lhsV,
+      std::vector<SmartPtr<const IteratesVector> >& delta_rhsV
+   );
+
 private:
    SimpleBacksolver();
 
@@ -45,6 +45,65 @@ bool StdStepCalculator::InitializeImpl(
    return true;
 }
 
+SmartPtr<IteratesVector> StdStepCalculator::KKTResiduals()
+{
+   SmartPtr<IteratesVector> r_s = IpData().trial()->MakeNewIteratesVector();
+
+   /* This should be almost zero... */
+   r_s->Set_x_NonConst(*IpCq().curr_grad_lag_x()->MakeNewCopy());
+   r_s->Set_s_NonConst(*IpCq().curr_grad_lag_s()->MakeNewCopy());
+   r_s->Set_y_c_NonConst(*IpCq().curr_c()->MakeNewCopy());
+   r_s->Set_y_d_NonConst(*IpCq().curr_d_minus_s()->MakeNewCopy());
+   r_s->Set_z_L_NonConst(*IpCq().curr_compl_x_L()->MakeNewCopy());
+   r_s->Set_z_U_NonConst(*IpCq().curr_compl_x_U()->MakeNewCopy());
+   r_s->Set_v_L_NonConst(*IpCq().curr_compl_s_L()->MakeNewCopy());
+   r_s->Set_v_U_NonConst(*IpCq().curr_compl_s_U()->MakeNewCopy());
+
+   r_s->Print(Jnlst(), J_VECTOR, J_USER1, "r_s init");
+
+   return r_s;
+}
+
+bool StdStepCalculator::SensitivityVectors(
+   std::vector<SmartPtr<DenseVector> >&    delta_uV,
+   std::vector<SmartPtr<IteratesVector> >& sensV
+)
+{
+   DBG_START_METH("StdStepCalculator::SensitivityVectors", dbg_verbosity);
+
+   sensV.clear();
+   if( delta_uV.empty() )
+   {
+      return true;
+   }
+
+   SmartPtr<IteratesVector> r_s;
+   if( kkt_residuals_ )
+   {
+      r_s = KKTResiduals();
+   }
+
+   std::vector<SmartPtr<const IteratesVector> > rhsV;
+   for( size_t i = 0; i < delta_uV.size(); ++i )
+   {
+      SmartPtr<IteratesVector> delta_u_long = IpData().trial()->MakeNewIteratesVector();
+      ift_data_->TransMultiply(*delta_uV[i], *delta_u_long);
+      if( kkt_residuals_ )
+      {
+         delta_u_long->Axpy(-1.0, *r_s);
+      }
+      rhsV.push_back(ConstPtr(delta_u_long));
+      sensV.push_back(IpData().trial()->MakeNewIteratesVector());
+   }
+
+   bool retval = backsolver_->MultiSolve(sensV, rhsV);
+
+   // keep a copy of the last sensitivities for GetSensitivityVector
+   SensitivityVector = sensV.back()->MakeNewIteratesVectorCopy();
+
+   return retval;
+}
+
 bool StdStepCalculator::Step(
    DenseVector&    delta_u,
    IteratesVector& sol
@@ -58,20 +117,9 @@ bool StdStepCalculator::Step(
    SmartPtr<IteratesVector> delta_u_long = IpData().trial()->MakeNewIteratesVector();
    ift_data_->TransMultiply(delta_u, *delta_u_long);
 
-   SmartPtr<IteratesVector> r_s = IpData().trial()->MakeNewIteratesVector();
    if( kkt_residuals_ )
    {
-      /* This should be almost zero... */
-      r_s->Set_x_NonConst(*IpCq().curr_grad_lag_x()->MakeNewCopy());
-      r_s->Set_s_NonConst(*IpCq().curr_grad_lag_s()->MakeNewCopy());
-      r_s->Set_y_c_NonConst(*IpCq().curr_c()->MakeNewCopy());
-      r_s->Set_y_d_NonConst(*IpCq().curr_d_minus_s()->MakeNewCopy());
-      r_s->Set_z_L_NonConst(*IpCq().curr_compl_x_L()->MakeNewCopy());
-      r_s->Set_z_U_NonConst(*IpCq().curr_compl_x_U()->MakeNewCopy());
-      r_s->Set_v_L_NonConst(*IpCq().curr_compl_s_L()->MakeNewCopy());
-      r_s->Set_v_U_NonConst(*IpCq().curr_compl_s_U()->MakeNewCopy());
-
-      r_s->Print(Jnlst(), J_VECTOR, J_USER1, "r_s init");
+      SmartPtr<IteratesVector> r_s = KKTResiduals();
       delta_u.Print(Jnlst(), J_VECTOR, J_USER1, "delta_u init");
       DBG_PRINT((dbg_verbosity, "r_s init Nrm2=%23.16e\n", r_s->Asum()));
 
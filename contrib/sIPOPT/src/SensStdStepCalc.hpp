@@ -53,7 +53,18 @@ public:
       return SensitivityVector;
    }
 
+   /** Compute the sensitivity vectors for several perturbations
+    *  with a single call to the MultiSolve of the backsolver.
+    */
+   virtual bool SensitivityVectors(
+      std::vector<SmartPtr<DenseVector> >&    delta_uV,
+      std::vector<SmartPtr<IteratesVector> >& sensV
+   );
+
 private:
+   /** Compute the residuals of the KKT conditions at the current point */
+   SmartPtr<IteratesVector> KKTResiduals();
+
    SmartPtr<SchurData> ift_data_;
    SmartPtr<SensBacksolver> backsolver_;
    Number bound_eps_;
@@ -9,12 +9,13 @@
 
 #include "IpAlgStrategy.hpp"
 #include "SensSchurDriver.hpp"
+#include "IpDenseVector.hpp"
+#include "IpIteratesVector.hpp"
+
+#include <vector>
 
 namespace Ipopt
 {
-/* Forward declarations */
-class DenseVector;
-class IteratesVector;
 
 /** This is the interface for the classes that perform the actual step. */
 class SIPOPTLIB_EXPORT SensitivityStepCalculator: public AlgorithmStrategyObject
@@ -75,6 +76,29 @@ public:
    /** return the sensitivity vector */
    virtual SmartPtr<IteratesVector> GetSensitivityVector() = 0;
 
+   /** Compute the sensitivity vectors for several perturbations.
+    *
+    *  On return, sensV[i] holds the sensitivity vector for the
+    *  perturbation delta_uV[i], as GetSensitivityVector would after
+    *  a call to Step.  The default implementation calls Step for
+    *  each perturbation.
+    */
+   virtual bool SensitivityVectors(
+      std::vector<SmartPtr<DenseVector> >&    delta_uV,
+      std::vector<SmartPtr<IteratesVector> >& sensV
+   )
+   {
+      bool retval = true;
+      sensV.clear();
+      SmartPtr<IteratesVector> sol = IpData().curr()->MakeNewIteratesVector();
+      for( size_t i = 0; i < delta_uV.size() && retval; ++i )
+      {
+         retval = Step(*delta_uV[i], *sol);
+         sensV.push_back(GetSensitivityVector()->MakeNewIteratesVectorCopy());
+      }
+      return retval;
+   }
+
 private:
    SmartPtr<SchurDriver> driver_;
    bool do_boundcheck_;
@@ -187,9 +187,12 @@ bool LuksanVlcek1::eval_jac_g(
    {
       // return the structure of the jacobian
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ - 2; i++ )
       {
+         Index ijac = 3 * i;
          iRow[ijac] = i;
          jCol[ijac] = i;
          ijac++;
@@ -205,9 +208,12 @@ bool LuksanVlcek1::eval_jac_g(
    {
       // return the values of the jacobian of the constraints
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ - 2; i++ )
       {
+         Index ijac = 3 * i;
          // x[i]
          values[ijac] = -(1. + x[i]) * exp(x[i] - x[i + 1]);
          ijac++;
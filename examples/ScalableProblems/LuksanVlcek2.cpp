@@ -249,14 +249,18 @@ bool LuksanVlcek2::eval_h(
 {
    if( values == NULL )
    {
-      Index ihes = 0;
       // First the diagonal elements
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < n; i++ )
       {
+         Index ihes = i;
          iRow[ihes] = i;
          jCol[ihes] = i;
          ihes++;
       }
+      Index ihes = n;
       // And now the off-diagonal elements
       for( Index i = 0; i < N_ / 2; i++ )
       {
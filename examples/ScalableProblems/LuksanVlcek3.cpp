@@ -243,9 +243,12 @@ bool LuksanVlcek3::eval_h(
 {
    if( values == NULL )
    {
-      Index ihes = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ / 2; i++ )
       {
+         Index ihes = 5 * i;
          iRow[ihes] = 2 * i;
          jCol[ihes] = 2 * i;
          ihes++;
@@ -262,6 +265,7 @@ bool LuksanVlcek3::eval_h(
          jCol[ihes] = 2 * i + 2;
          ihes++;
       }
+      Index ihes = 5 * (N_ / 2);
       iRow[ihes] = N_;
       jCol[ihes] = N_;
       ihes++;
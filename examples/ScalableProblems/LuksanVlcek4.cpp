@@ -197,9 +197,12 @@ bool LuksanVlcek4::eval_jac_g(
    {
       // return the structure of the jacobian
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ - 2; i++ )
       {
+         Index ijac = 3 * i;
          iRow[ijac] = i;
          jCol[ijac] = i;
          ijac++;
@@ -210,16 +213,19 @@ bool LuksanVlcek4::eval_jac_g(
          jCol[ijac] = i + 2;
          ijac++;
       }
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(3 * (N_ - 2) == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ - 2; i++ )
       {
+         Index ijac = 3 * i;
          values[ijac] = -8. * x[i + 1];
          ijac++;
          values[ijac] = 6. - 8. * x[i] + 24. * x[i + 1] * x[i + 1];
@@ -249,9 +255,12 @@ bool LuksanVlcek4::eval_h(
 {
    if( values == NULL )
    {
-      Index ihes = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < n - 1; i++ )
       {
+         Index ihes = 2 * i;
          iRow[ihes] = i;
          jCol[ihes] = i;
          ihes++;
@@ -259,6 +268,7 @@ bool LuksanVlcek4::eval_h(
          jCol[ihes] = i + 1;
          ihes++;
       }
+      Index ihes = 2 * (n - 1);
       iRow[ihes] = n - 1;
       jCol[ihes] = n - 1;
       ihes++;
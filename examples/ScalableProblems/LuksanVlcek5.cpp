@@ -204,9 +204,12 @@ bool LuksanVlcek5::eval_jac_g(
    {
       // return the structure of the jacobian
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ - 4; i++ )
       {
+         Index ijac = 5 * i;
          iRow[ijac] = i;
          jCol[ijac] = i + 1;
          ijac++;
@@ -223,16 +226,19 @@ bool LuksanVlcek5::eval_jac_g(
          jCol[ijac] = i + 5;
          ijac++;
       }
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(5 * (N_ - 4) == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ - 4; i++ )
       {
+         Index ijac = 5 * i;
          values[ijac] = -1.;
          ijac++;
          values[ijac] = -8. * x[i + 3] + 2. * x[i + 2];
@@ -266,14 +272,18 @@ bool LuksanVlcek5::eval_h(
 {
    if( values == NULL )
    {
-      Index ihes = 0;
       // First the diagonal
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < n; i++ )
       {
+         Index ihes = i;
          iRow[ihes] = i;
          jCol[ihes] = i;
          ihes++;
       }
+      Index ihes = n;
       // Now the first off-diagonal
       for( Index i = 0; i < n - 1; i++ )
       {
@@ -215,9 +215,12 @@ bool LuksanVlcek6::eval_jac_g(
    {
       // return the structure of the jacobian
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ / 2; i++ )
       {
+         Index ijac = 3 * i;
          iRow[ijac] = i;
          jCol[ijac] = 2 * i;
          ijac++;
@@ -228,16 +231,19 @@ bool LuksanVlcek6::eval_jac_g(
          jCol[ijac] = 2 * i + 2;
          ijac++;
       }
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(3 * (N_ / 2) == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < N_ / 2; i++ )
       {
+         Index ijac = 3 * i;
          Number e = exp(x[2 * i] - x[2 * i + 1] - x[2 * i + 2]);
          Number a1 = (1. + x[2 * i] - x[2 * i + 2]) * e;
          values[ijac] = -a1;
@@ -269,14 +275,18 @@ bool LuksanVlcek6::eval_h(
 {
    if( values == NULL )
    {
-      Index ihes = 0;
       // First the diagonal
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 0; i < n; i++ )
       {
+         Index ihes = i;
          iRow[ihes] = i;
          jCol[ihes] = i;
          ihes++;
       }
+      Index ihes = n;
       // 1st off-diagonal
       for( Index i = 0; i < n - 1; i++ )
       {
@@ -396,10 +396,13 @@ bool MittelmannBndryCntrlDiriBase::eval_jac_g(
    {
       // return the structure of the jacobian of the constraints
 
-      Index ijac = 0;
-      Index ig = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 5 * N_ * (i - 1);
+         Index ig = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
 
@@ -432,15 +435,18 @@ bool MittelmannBndryCntrlDiriBase::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(5 * N_ * N_ == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 5 * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             // y(i,j)
@@ -465,7 +471,7 @@ bool MittelmannBndryCntrlDiriBase::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(5 * N_ * N_ == nele_jac);
    }
 
    return true;
@@ -490,10 +496,13 @@ bool MittelmannBndryCntrlDiriBase::eval_h(
       // return the structure. This is a symmetric matrix, fill the lower left
       // triangle only.
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             iRow[ihes] = y_index(i, j);
@@ -501,6 +510,7 @@ bool MittelmannBndryCntrlDiriBase::eval_h(
             ihes++;
          }
       }
+      Index ihes = N_ * N_;
 
       if( alpha_ > 0. )
       {
@@ -542,10 +552,13 @@ bool MittelmannBndryCntrlDiriBase::eval_h(
    {
       // return the values
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             // Contribution from the objective function
@@ -554,6 +567,7 @@ bool MittelmannBndryCntrlDiriBase::eval_h(
             ihes++;
          }
       }
+      Index ihes = N_ * N_;
 
       // Now the diagonal entries for u(i,j)
       if( alpha_ > 0. )
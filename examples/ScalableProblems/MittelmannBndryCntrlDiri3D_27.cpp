@@ -629,10 +629,13 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_jac_g(
    {
       // return the structure of the jacobian of the constraints
 
-      Index ijac = 0;
-      Index ig = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 27 * N_ * N_ * (i - 1);
+         Index ig = N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -760,15 +763,18 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(27 * N_ * N_ * N_ == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 27 * N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -868,7 +874,7 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(27 * N_ * N_ * N_ == nele_jac);
    }
 
    return true;
@@ -893,10 +899,13 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_h(
       // return the structure. This is a symmetric matrix, fill the lower left
       // triangle only.
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -907,6 +916,7 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_h(
             }
          }
       }
+      Index ihes = N_ * N_ * N_;
 
       if( alpha_ > 0. )
       {
@@ -979,10 +989,13 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_h(
    {
       // return the values
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -995,6 +1008,7 @@ bool MittelmannBndryCntrlDiriBase3D_27::eval_h(
             }
          }
       }
+      Index ihes = N_ * N_ * N_;
 
       // Now the diagonal entries for u(i,j)
       if( alpha_ > 0. )
@@ -626,10 +626,13 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_jac_g(
    {
       // return the structure of the jacobian of the constraints
 
-      Index ijac = 0;
-      Index ig = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 7 * N_ * N_ * (i - 1);
+         Index ig = N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -675,15 +678,18 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(7 * N_ * N_ * N_ == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 7 * N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -719,7 +725,7 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(7 * N_ * N_ * N_ == nele_jac);
    }
 
    return true;
@@ -883,10 +889,13 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_h(
       // return the structure. This is a symmetric matrix, fill the lower left
       // triangle only.
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -897,6 +906,7 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_h(
             }
          }
       }
+      Index ihes = N_ * N_ * N_;
 
       if( alpha_ > 0. )
       {
@@ -934,10 +944,13 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_h(
    {
       // return the values
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             for( Index k = 1; k <= N_; k++ )
@@ -949,6 +962,7 @@ bool MittelmannBndryCntrlDiriBase3Dsin::eval_h(
             }
          }
       }
+      Index ihes = N_ * N_ * N_;
 
       // Now the diagonal entries for u(i,j)
       if( alpha_ > 0. )
@@ -438,10 +438,13 @@ bool MittelmannBndryCntrlNeumBase::eval_jac_g(
       // return the structure of the jacobian of the constraints
 
       // distretized PDEs
-      Index ijac = 0;
-      Index ig = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 5 * N_ * (i - 1);
+         Index ig = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             // y(i,j)
@@ -471,6 +474,8 @@ bool MittelmannBndryCntrlNeumBase::eval_jac_g(
             ig++;
          }
       }
+      Index ijac = 5 * N_ * N_;
+      Index ig = N_ * N_;
 
       // set up the Neumann boundary conditions
       for( Index j = 1; j <= N_; j++ )
@@ -532,9 +537,12 @@ bool MittelmannBndryCntrlNeumBase::eval_jac_g(
    else
    {
       // return the values of the jacobian of the constraints
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 5 * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             // y(i,j)
@@ -558,6 +566,7 @@ bool MittelmannBndryCntrlNeumBase::eval_jac_g(
             ijac++;
          }
       }
+      Index ijac = 5 * N_ * N_;
 
       for( Index j = 1; j <= N_; j++ )
       {
@@ -621,10 +630,13 @@ bool MittelmannBndryCntrlNeumBase::eval_h(
       // return the structure. This is a symmetric matrix, fill the lower left
       // triangle only.
 
-      Index ihes = 0;
       // First the diagonal entries for dydy in the interior
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             iRow[ihes] = y_index(i, j);
@@ -632,6 +644,7 @@ bool MittelmannBndryCntrlNeumBase::eval_h(
             ihes++;
          }
       }
+      Index ihes = N_ * N_;
 
       // Now, if necessary, the dydy entries on the boundary
       if( !b_cont_dydy_alwayszero() )
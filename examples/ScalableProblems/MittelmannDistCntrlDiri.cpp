@@ -355,9 +355,12 @@ bool MittelmannDistCntrlDiriBase::eval_jac_g(
    {
       // return the structure of the jacobian of the constraints
 
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 6 * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             Index ig = pde_index(i, j);
@@ -394,15 +397,18 @@ bool MittelmannDistCntrlDiriBase::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(6 * N_ * N_ == nele_jac);
       (void) nele_jac;
    }
    else
    {
       // return the values of the jacobian of the constraints
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 6 * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             // y(i,j)
@@ -431,7 +437,7 @@ bool MittelmannDistCntrlDiriBase::eval_jac_g(
          }
       }
 
-      DBG_ASSERT(ijac == nele_jac);
+      DBG_ASSERT(6 * N_ * N_ == nele_jac);
    }
 
    return true;
@@ -456,10 +462,13 @@ bool MittelmannDistCntrlDiriBase::eval_h(
       // return the structure. This is a symmetric matrix, fill the lower left
       // triangle only.
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             iRow[ihes] = y_index(i, j);
@@ -467,6 +476,7 @@ bool MittelmannDistCntrlDiriBase::eval_h(
             ihes++;
          }
       }
+      Index ihes = N_ * N_;
 
       if( alpha_ > 0. )
       {
@@ -489,10 +499,13 @@ bool MittelmannDistCntrlDiriBase::eval_h(
    {
       // return the values
 
-      Index ihes = 0;
       // First the diagonal entries for y(i,j)
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ihes = N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
 
@@ -506,6 +519,7 @@ bool MittelmannDistCntrlDiriBase::eval_h(
             ihes++;
          }
       }
+      Index ihes = N_ * N_;
 
       // Now the diagonal entries for u(i,j)
       if( alpha_ > 0. )
@@ -347,9 +347,12 @@ bool MittelmannDistCntrlNeumABase::eval_jac_g(
       // return the structure of the jacobian of the constraints
 
       // distretized PDEs
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 6 * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             Index ig = pde_index(i, j);
@@ -385,6 +388,7 @@ bool MittelmannDistCntrlNeumABase::eval_jac_g(
             ijac++;
          }
       }
+      Index ijac = 6 * N_ * N_;
 
       Index ig = N_ * N_;
       // set up the Neumann boundary conditions
@@ -435,9 +439,12 @@ bool MittelmannDistCntrlNeumABase::eval_jac_g(
    else
    {
       // return the values of the jacobian of the constraints
-      Index ijac = 0;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
       for( Index i = 1; i <= N_; i++ )
       {
+         Index ijac = 6 * N_ * (i - 1);
          for( Index j = 1; j <= N_; j++ )
          {
             // y(i,j)
@@ -465,6 +472,7 @@ bool MittelmannDistCntrlNeumABase::eval_jac_g(
             ijac++;
          }
       }
+      Index ijac = 6 * N_ * N_;
 
       for( Index i = 1; i <= N_; i++ )
       {
@@ -5,12 +5,17 @@
 // Authors:  Andreas Waechter            IBM    2004-11-05
 
 #include "IpIpoptApplication.hpp"
+#include "IpSolveStatistics.hpp"
+#include "IpIpoptData.hpp"
+#include "IpOrigIpoptNLP.hpp"
 #include "RegisteredTNLP.hpp"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 
 //**********************************************************************
 // Stuff for benchmarking
@@ -117,6 +122,356 @@ static void print_problems()
    RegisteredTNLPs::PrintRegisteredProblems();
 }
 
+//**********************************************************************
+// Benchmark mode
+//**********************************************************************
+
+/** Settings of a benchmark */
+struct BenchSettings
+{
+   std::vector<string> problems;
+   std::vector<Index> sizes;
+   /** values for the option linear_solver, empty string for the default */
+   std::vector<string> linear_solvers;
+   /** values for the options linear_solver_num_threads and blas_num_threads, 0 for the default */
+   std::vector<Index> threads;
+   Index repetitions;
+   bool json;
+   FILE* out;
+};
+
+/** Split a comma separated list */
+static std::vector<string> split_list(
+   const char* list
+)
+{
+   std::vector<string> items;
+   string str(list);
+   size_t start = 0;
+   while( start <= str.size() )
+   {
+      size_t end = str.find(',', start);
+      if( end == string::npos )
+      {
+         end = str.size();
+      }
+      if( end > start )
+      {
+         items.push_back(str.substr(start, end - start));
+      }
+      start = end + 1;
+   }
+   return items;
+}
+
+static bool parse_int_list(
+   const char*         list,
+   std::vector<Index>& values,
+   Index               min_value
+)
+{
+   std::vector<string> items = split_list(list);
+   values.clear();
+   for( size_t i = 0; i < items.size(); ++i )
+   {
+      char* end;
+      long value = strtol(items[i].c_str(), &end, 10);
+      if( *end != '\0' || value < min_value )
+      {
+         return false;
+      }
+      values.push_back((Index) value);
+   }
+   return !values.empty();
+}
+
+static void print_bench_usage(
+   const char* exe
+)
+{
+   printf("Usage: %s bench [-p PROBLEMS] [-n SIZES] [-l SOLVERS] [-t THREADS] [-r REPEAT] [-f csv|json] [-o FILE]\n", exe);
+   printf("          solves every combination of the given problems, sizes, linear solvers, and thread counts\n");
+   printf("          REPEAT times and writes the solve and timing statistics of each run as CSV or JSON.\n");
+   printf("          PROBLEMS, SIZES, SOLVERS, and THREADS are comma separated lists, e.g., -n 100,200,400.\n");
+   printf("          SOLVERS are values of the option linear_solver (default: as set in ipopt.opt).\n");
+   printf("          THREADS are values for the options linear_solver_num_threads and blas_num_threads\n");
+   printf("          (default: 0, which does not change the number of threads).\n");
+   printf("          Other options are read from ipopt.opt; print_level is 0 and print_timing_statistics\n");
+   printf("          is yes unless set there.\n");
+}
+
+/** Task of the timing statistics that is reported in the CSV output */
+struct BenchTask
+{
+   const char* column;
+   TimedTask& (TimingStatistics::*task)();
+};
+
+static const BenchTask bench_tasks[] =
+{
+   { "search_direction_wall", &TimingStatistics::ComputeSearchDirection },
+   { "line_search_wall", &TimingStatistics::ComputeAcceptableTrialPoint },
+   { "symbolic_factorization_wall", &TimingStatistics::LinearSystemSymbolicFactorization },
+   { "factorization_wall", &TimingStatistics::LinearSystemFactorization },
+   { "backsolve_wall", &TimingStatistics::LinearSystemBackSolve }
+};
+static const size_t num_bench_tasks = sizeof(bench_tasks) / sizeof(bench_tasks[0]);
+
+static void write_bench_header(
+   const BenchSettings& settings
+)
+{
+   if( settings.json )
+   {
+      fprintf(settings.out, "{\"runs\": [");
+      return;
+   }
+   fprintf(settings.out, "problem,N,linear_solver,threads,repetition,status,iterations,objective,"
+           "constr_viol,dual_inf,compl,kkt_error,obj_evals,constr_evals,obj_grad_evals,constr_jac_evals,hess_evals,"
+           "cpu_time,sys_time,wall_time,func_eval_wall");
+   for( size_t k = 0; k < num_bench_tasks; ++k )
+   {
+      fprintf(settings.out, ",%s", bench_tasks[k].column);
+   }
+   fprintf(settings.out, "\n");
+}
+
+static void write_bench_footer(
+   const BenchSettings& settings
+)
+{
+   if( settings.json )
+   {
+      fprintf(settings.out, "\n]}\n");
+   }
+}
+
+/** Solve one instance and write its statistics */
+static void bench_run(
+   const BenchSettings& settings,
+   const string&        problem,
+   Index                N,
+   const string&        linear_solver,
+   Index                threads,
+   Index                repetition,
+   bool                 first_run
+)
+{
+   SmartPtr<RegisteredTNLP> tnlp = RegisteredTNLPs::GetTNLP(problem);
+   ApplicationReturnStatus status = Internal_Error;
+   SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+   if( !tnlp->InitializeProblem(N) )
+   {
+      printf("Cannot initialize problem %s with N = %d.\n", problem.c_str(), (int) N);
+      status = Invalid_Problem_Definition;
+   }
+   else
+   {
+      status = app->Initialize();
+      if( status == Solve_Succeeded )
+      {
+         app->Options()->SetIntegerValueIfUnset("print_level", 0);
+         app->Options()->SetStringValueIfUnset("sb", "yes");
+         // the tasks of the timing statistics are timed only if they are printed
+         app->Options()->SetStringValueIfUnset("print_timing_statistics", "yes");
+         bool ok = true;
+         if( !linear_solver.empty() )
+         {
+            ok = app->Options()->SetStringValue("linear_solver", linear_solver);
+         }
+         if( ok && threads > 0 )
+         {
+            ok = app->Options()->SetIntegerValue("linear_solver_num_threads", threads)
+                 && app->Options()->SetIntegerValue("blas_num_threads", threads);
+         }
+         status = ok ? app->OptimizeTNLP(GetRawPtr(tnlp)) : Invalid_Option;
+      }
+   }
+
+   Index iters = -1;
+   Number obj = 0., constr_viol = 0., dual_inf = 0., compl_ = 0., kkt_error = 0.;
+   Index n_obj = 0, n_constr = 0, n_grad = 0, n_jac = 0, n_hess = 0;
+   Number cpu = 0., sys = 0., wall = 0., func_wall = 0.;
+   std::vector<Number> task_walls(num_bench_tasks, 0.);
+   SmartPtr<SolveStatistics> stats = app->Statistics();
+   if( IsValid(stats) )
+   {
+      iters = stats->IterationCount();
+      obj = stats->FinalObjective();
+      stats->Infeasibilities(dual_inf, constr_viol, compl_, kkt_error);
+      stats->NumberOfEvaluations(n_obj, n_constr, n_grad, n_jac, n_hess);
+      cpu = stats->TotalCpuTime();
+      sys = stats->TotalSysTime();
+      wall = stats->TotalWallclockTime();
+   }
+   OrigIpoptNLP* orignlp = dynamic_cast<OrigIpoptNLP*>(GetRawPtr(app->IpoptNLPObject()));
+   if( orignlp != NULL )
+   {
+      func_wall = orignlp->TotalFunctionEvaluationWallclockTime();
+   }
+   SmartPtr<IpoptData> ip_data = app->IpoptDataObject();
+   if( IsValid(stats) && IsValid(ip_data) )
+   {
+      for( size_t k = 0; k < num_bench_tasks; ++k )
+      {
+         task_walls[k] = (ip_data->TimingStats().*bench_tasks[k].task)().TotalWallclockTime();
+      }
+   }
+   const char* solver_name = linear_solver.empty() ? "default" : linear_solver.c_str();
+
+   FILE* out = settings.out;
+   if( settings.json )
+   {
+      fprintf(out, "%s\n{\"problem\": \"%s\", \"N\": %d, \"linear_solver\": \"%s\", \"threads\": %d, \"repetition\": %d, ",
+              first_run ? "" : ",", problem.c_str(), (int) N, solver_name, (int) threads, (int) repetition);
+      fprintf(out, "\"status\": %d, \"iterations\": %d, \"objective\": %.16g, ", (int) status, (int) iters, obj);
+      fprintf(out, "\"constr_viol\": %.9g, \"dual_inf\": %.9g, \"compl\": %.9g, \"kkt_error\": %.9g,\n", constr_viol,
+              dual_inf, compl_, kkt_error);
+      fprintf(out, " \"evaluations\": {\"obj\": %d, \"constr\": %d, \"obj_grad\": %d, \"constr_jac\": %d, \"hess\": %d},\n",
+              (int) n_obj, (int) n_constr, (int) n_grad, (int) n_jac, (int) n_hess);
+      fprintf(out, " \"cpu_time\": %.9g, \"sys_time\": %.9g, \"wall_time\": %.9g, \"func_eval_wall\": %.9g,\n", cpu, sys,
+              wall, func_wall);
+      fprintf(out, " \"timing\": ");
+      if( IsValid(stats) && IsValid(ip_data) )
+      {
+         ip_data->TimingStats().WriteJSON(out);
+      }
+      else
+      {
+         fprintf(out, "null\n");
+      }
+      fprintf(out, "}");
+   }
+   else
+   {
+      fprintf(out, "%s,%d,%s,%d,%d,%d,%d,%.16g,%.9g,%.9g,%.9g,%.9g,%d,%d,%d,%d,%d,%.9g,%.9g,%.9g,%.9g", problem.c_str(),
+              (int) N, solver_name, (int) threads, (int) repetition, (int) status, (int) iters, obj, constr_viol, dual_inf,
+              compl_, kkt_error, (int) n_obj, (int) n_constr, (int) n_grad, (int) n_jac, (int) n_hess, cpu, sys, wall,
+              func_wall);
+      for( size_t k = 0; k < num_bench_tasks; ++k )
+      {
+         fprintf(out, ",%.9g", task_walls[k]);
+      }
+      fprintf(out, "\n");
+   }
+   fflush(out);
+
+   if( out != stdout )
+   {
+      printf("%-20s N=%-6d %-10s threads=%-3d rep=%-3d status=%-3d iters=%-5d wall=%.3fs\n", problem.c_str(), (int) N,
+             solver_name, (int) threads, (int) repetition, (int) status, (int) iters, wall);
+   }
+}
+
+static int bench(
+   int   argv,
+   char* argc[]
+)
+{
+   BenchSettings settings;
+   settings.problems.push_back("LukVlE1");
+   settings.sizes.push_back(1000);
+   settings.linear_solvers.push_back("");
+   settings.threads.push_back(0);
+   settings.repetitions = 1;
+   settings.json = false;
+   settings.out = stdout;
+   const char* outfile = NULL;
+
+   for( int i = 2; i < argv; i++ )
+   {
+      if( i + 1 >= argv || argc[i][0] != '-' || strlen(argc[i]) != 2 )
+      {
+         print_bench_usage(argc[0]);
+         return -1;
+      }
+      const char* arg = argc[++i];
+      bool ok = true;
+      switch( argc[i - 1][1] )
+      {
+         case 'p':
+            settings.problems = split_list(arg);
+            ok = !settings.problems.empty();
+            break;
+         case 'n':
+            ok = parse_int_list(arg, settings.sizes, 1);
+            break;
+         case 'l':
+            settings.linear_solvers = split_list(arg);
+            ok = !settings.linear_solvers.empty();
+            break;
+         case 't':
+            ok = parse_int_list(arg, settings.threads, 0);
+            break;
+         case 'r':
+         {
+            std::vector<Index> repetitions;
+            ok = parse_int_list(arg, repetitions, 1) && repetitions.size() == 1;
+            if( ok )
+            {
+               settings.repetitions = repetitions[0];
+            }
+            break;
+         }
+         case 'f':
+            ok = !strcmp(arg, "csv") || !strcmp(arg, "json");
+            settings.json = !strcmp(arg, "json");
+            break;
+         case 'o':
+            outfile = arg;
+            break;
+         default:
+            ok = false;
+      }
+      if( !ok )
+      {
+         printf("Invalid argument \"%s\" for %s.\n", arg, argc[i - 1]);
+         print_bench_usage(argc[0]);
+         return -1;
+      }
+   }
+
+   for( size_t i = 0; i < settings.problems.size(); ++i )
+   {
+      if( !IsValid(RegisteredTNLPs::GetTNLP(settings.problems[i])) )
+      {
+         printf("Problem with name \"%s\" not known.\n", settings.problems[i].c_str());
+         print_problems();
+         return -2;
+      }
+   }
+
+   if( outfile != NULL )
+   {
+      settings.out = fopen(outfile, "w");
+      if( settings.out == NULL )
+      {
+         printf("Cannot open output file %s.\n", outfile);
+         return -5;
+      }
+   }
+
+   write_bench_header(settings);
+   bool first_run = true;
+   for( size_t ip = 0; ip < settings.problems.size(); ++ip )
+      for( size_t in = 0; in < settings.sizes.size(); ++in )
+         for( size_t il = 0; il < settings.linear_solvers.size(); ++il )
+            for( size_t it = 0; it < settings.threads.size(); ++it )
+               for( Index r = 0; r < settings.repetitions; ++r )
+               {
+                  bench_run(settings, settings.problems[ip], settings.sizes[in], settings.linear_solvers[il],
+                            settings.threads[it], r, first_run);
+                  first_run = false;
+               }
+   write_bench_footer(settings);
+
+   if( settings.out != stdout )
+   {
+      fclose(settings.out);
+   }
+   return 0;
+}
+
 int main(
    int   argv,
    char* argc[]
@@ -128,6 +483,11 @@ int main(
       return 0;
    }
 
+   if( argv >= 2 && !strcmp(argc[1], "bench") )
+   {
+      return bench(argv, argc);
+   }
+
 #ifdef TIME_LIMIT
    if (argv == 4)
    {
@@ -144,6 +504,7 @@ int main(
          printf("          where N is a positive parameter determining problem size\n");
          printf("       %s list\n", argc[0]);
          printf("          to list all registered problems.\n");
+         print_bench_usage(argc[0]);
          return -1;
       }
 
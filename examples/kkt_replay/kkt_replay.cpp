@@ -0,0 +1,303 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+/** @file kkt_replay.cpp
+ *
+ * Factorizes linear systems that Ipopt has written with the option
+ * kkt_export_file with each of the available linear solvers and
+ * reports the wallclock times, the inertia, and the residuals.
+ *
+ * Usage: kkt_replay [-s solver1,solver2,...] file1.kkt [file2.kkt ...]
+ *
+ * The solvers are named as for the option linear_solver.  If no
+ * solvers are given, all linear solvers that Ipopt knows are tried and
+ * the ones that are not available are skipped.  Further options, e.g.,
+ * for the linear solvers or linear_system_scaling, can be set in an
+ * ipopt.opt file in the current directory.
+ *
+ * For every system, the time of the first solve includes the symbolic
+ * and numerical factorization and the backsolves for all right hand
+ * sides.  The time of the refactorization is for a second numerical
+ * factorization of the same matrix and the backsolves.
+ */
+
+#include "IpIpoptApplication.hpp"
+#include "IpAlgBuilder.hpp"
+#include "IpSymLinearSolver.hpp"
+#include "IpSymTMatrix.hpp"
+#include "IpDenseVector.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace Ipopt;
+
+/** Linear system as written by TSymLinearSolver::ExportSystem */
+struct KKTSystem
+{
+   Index dim;
+   Index nonzeros;
+   Index nrhs;
+   bool check_negevals;
+   Index negevals;
+   Index iter;
+   std::vector<Index> irn;
+   std::vector<Index> jcn;
+   std::vector<Number> values;
+   std::vector<Number> rhs;
+};
+
+/** Pointer to the first element of a vector, or NULL if it is empty */
+template<class T>
+static T* Data(
+   std::vector<T>& v
+)
+{
+   return v.empty() ? NULL : &v[0];
+}
+
+template<class T>
+static const T* Data(
+   const std::vector<T>& v
+)
+{
+   return v.empty() ? NULL : &v[0];
+}
+
+static bool ReadKKTSystem(
+   const char* filename,
+   KKTSystem&  sys
+)
+{
+   FILE* fp = fopen(filename, "rb");
+   if( fp == NULL )
+   {
+      fprintf(stderr, "Cannot open file %s.\n", filename);
+      return false;
+   }
+
+   char magic[8];
+   unsigned char format[4];
+   Index header[6];
+   bool ok = fread(magic, 1, 8, fp) == 8 && memcmp(magic, "IPOPTKKT", 8) == 0
+             && fread(format, 1, 4, fp) == 4;
+   if( ok && (format[0] != 1 || format[1] != sizeof(Index) || format[2] != sizeof(Number)) )
+   {
+      fprintf(stderr, "File %s has been written in a different format or by a build of Ipopt with different Index or Number types.\n", filename);
+      fclose(fp);
+      return false;
+   }
+   ok = ok && fread(header, sizeof(Index), 6, fp) == 6 && header[0] >= 0 && header[1] >= 0 && header[2] >= 0;
+   if( ok )
+   {
+      sys.dim = header[0];
+      sys.nonzeros = header[1];
+      sys.nrhs = header[2];
+      sys.check_negevals = header[3] != 0;
+      sys.negevals = header[4];
+      sys.iter = header[5];
+      sys.irn.resize(sys.nonzeros);
+      sys.jcn.resize(sys.nonzeros);
+      sys.values.resize(sys.nonzeros);
+      sys.rhs.resize((size_t) sys.dim * sys.nrhs);
+      ok = fread(Data(sys.irn), sizeof(Index), sys.nonzeros, fp) == (size_t) sys.nonzeros
+           && fread(Data(sys.jcn), sizeof(Index), sys.nonzeros, fp) == (size_t) sys.nonzeros
+           && fread(Data(sys.values), sizeof(Number), sys.nonzeros, fp) == (size_t) sys.nonzeros
+           && fread(Data(sys.rhs), sizeof(Number), sys.rhs.size(), fp) == sys.rhs.size();
+   }
+   fclose(fp);
+   for( Index i = 0; ok && i < sys.nonzeros; i++ )
+   {
+      ok = sys.irn[i] >= 1 && sys.irn[i] <= sys.dim && sys.jcn[i] >= 1 && sys.jcn[i] <= sys.dim;
+   }
+   if( !ok )
+   {
+      fprintf(stderr, "File %s is not a valid linear system file of Ipopt.\n", filename);
+   }
+   return ok;
+}
+
+static const char* StatusName(
+   ESymSolverStatus status
+)
+{
+   switch( status )
+   {
+      case SYMSOLVER_SUCCESS:
+         return "success";
+      case SYMSOLVER_SINGULAR:
+         return "singular";
+      case SYMSOLVER_WRONG_INERTIA:
+         return "wrong inertia";
+      case SYMSOLVER_CALL_AGAIN:
+         return "call again";
+      case SYMSOLVER_FATAL_ERROR:
+         return "fatal error";
+   }
+   return "unknown";
+}
+
+/** Factorize a system with one linear solver and print a line with the results */
+static void ReplaySystem(
+   const Journalist&     jnlst,
+   const OptionsList&    options,
+   const std::string&    solver_name,
+   const KKTSystem&      sys,
+   const char*           filename
+)
+{
+   SmartPtr<SymLinearSolver> solver;
+   try
+   {
+      AlgorithmBuilder builder;
+      solver = builder.SymLinearSolverFactory(jnlst, options, "");
+      if( !solver->ReducedInitialize(jnlst, options, "") )
+      {
+         solver = NULL;
+      }
+   }
+   catch( IpoptException& )
+   {
+      solver = NULL;
+   }
+   if( IsNull(solver) )
+   {
+      printf("%-24s %-8s not available\n", filename, solver_name.c_str());
+      return;
+   }
+
+   SmartPtr<SymTMatrixSpace> space = new SymTMatrixSpace(sys.dim, sys.nonzeros, Data(sys.irn), Data(sys.jcn));
+   SmartPtr<SymTMatrix> A = space->MakeNewSymTMatrix();
+   A->SetValues(Data(sys.values));
+
+   SmartPtr<DenseVectorSpace> vec_space = new DenseVectorSpace(sys.dim);
+   std::vector<SmartPtr<const Vector> > rhsV(sys.nrhs);
+   std::vector<SmartPtr<Vector> > solV(sys.nrhs);
+   for( Index irhs = 0; irhs < sys.nrhs; irhs++ )
+   {
+      SmartPtr<DenseVector> rhs = vec_space->MakeNewDenseVector();
+      rhs->SetValues(Data(sys.rhs) + (size_t) irhs * sys.dim);
+      rhsV[irhs] = GetRawPtr(rhs);
+      solV[irhs] = vec_space->MakeNew();
+   }
+
+   bool check_negevals = sys.check_negevals && solver->ProvidesInertia();
+   ESymSolverStatus status;
+   Number time_first;
+   Number time_refactor = -1.;
+   try
+   {
+      Number start = WallclockTime();
+      status = solver->MultiSolve(*A, rhsV, solV, check_negevals, sys.negevals);
+      time_first = WallclockTime() - start;
+      if( status == SYMSOLVER_SUCCESS || status == SYMSOLVER_WRONG_INERTIA )
+      {
+         // setting the values again gives a new matrix for the solver
+         A->SetValues(Data(sys.values));
+         start = WallclockTime();
+         solver->MultiSolve(*A, rhsV, solV, check_negevals, sys.negevals);
+         time_refactor = WallclockTime() - start;
+      }
+   }
+   catch( IpoptException& exc )
+   {
+      printf("%-24s %-8s %s\n", filename, solver_name.c_str(), exc.Message().c_str());
+      return;
+   }
+
+   char inertia[64] = "-";
+   if( solver->ProvidesInertia() && (status == SYMSOLVER_SUCCESS || status == SYMSOLVER_WRONG_INERTIA) )
+   {
+      Snprintf(inertia, 63, "%" IPOPT_INDEX_FORMAT "/%" IPOPT_INDEX_FORMAT, solver->NumberOfNegEVals(), sys.negevals);
+   }
+
+   // maximum norm of the residuals of all right hand sides
+   Number residual = -1.;
+   if( status == SYMSOLVER_SUCCESS )
+   {
+      residual = 0.;
+      for( Index irhs = 0; irhs < sys.nrhs; irhs++ )
+      {
+         SmartPtr<Vector> res = rhsV[irhs]->MakeNewCopy();
+         A->MultVector(1., *solV[irhs], -1., *res);
+         residual = Max(residual, res->Amax());
+      }
+   }
+
+   printf("%-24s %-8s %-14s %-12s %12.6f %12.6f %12.3e\n", filename, solver_name.c_str(), StatusName(status), inertia,
+          time_first, time_refactor, residual);
+}
+
+int main(
+   int   argc,
+   char** argv
+)
+{
+   std::vector<std::string> solvers;
+   int first_file = 1;
+   if( argc > 2 && strcmp(argv[1], "-s") == 0 )
+   {
+      std::string list = argv[2];
+      size_t pos = 0;
+      while( pos <= list.length() )
+      {
+         size_t end = list.find(',', pos);
+         if( end == std::string::npos )
+         {
+            end = list.length();
+         }
+         if( end > pos )
+         {
+            solvers.push_back(list.substr(pos, end - pos));
+         }
+         pos = end + 1;
+      }
+      first_file = 3;
+   }
+   if( first_file >= argc )
+   {
+      printf("Usage: %s [-s solver1,solver2,...] file1.kkt [file2.kkt ...]\n", argv[0]);
+      return 1;
+   }
+   if( solvers.empty() )
+   {
+      const char* all_solvers[] = { "ma27", "ma57", "ma77", "ma86", "ma97", "pardiso", "wsmp", "mumps", "cudss", "lapack" };
+      solvers.assign(all_solvers, all_solvers + sizeof(all_solvers) / sizeof(all_solvers[0]));
+   }
+
+   SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+   if( app->Initialize() != Solve_Succeeded )
+   {
+      return 1;
+   }
+   // every solve should factorize the matrix
+   app->Options()->SetStringValue("reuse_identical_factorization", "no");
+
+   printf("%-24s %-8s %-14s %-12s %12s %12s %12s\n", "file", "solver", "status", "neg.eig.", "first [s]", "refactor [s]",
+          "residual");
+   int retval = 0;
+   for( int i = first_file; i < argc; i++ )
+   {
+      KKTSystem sys;
+      if( !ReadKKTSystem(argv[i], sys) )
+      {
+         retval = 1;
+         continue;
+      }
+      for( size_t k = 0; k < solvers.size(); k++ )
+      {
+         if( !app->Options()->SetStringValue("linear_solver", solvers[k]) )
+         {
+            printf("%-24s %-8s unknown linear solver\n", argv[i], solvers[k].c_str());
+            continue;
+         }
+         ReplaySystem(*app->Jnlst(), *app->Options(), solvers[k], sys, argv[i]);
+      }
+   }
+
+   return retval;
+}
@@ -13,6 +13,12 @@
  * Inner problem:  minimize exp [ 0.5 * (x - a)^2    + 0.5 * x^2 ] w.r.t x
  * Define y(a):    arg_min  exp [ 0.5 * (x - a)^2    + 0.5 * x^2 ] w.r.t x
  * Outer problem:  minimize exp [ 0.5 * (y(a) - a)^2 + 0.5 * y(a)^2 ] w.r.t a
+ *
+ * The inner problem is solved for each new point of the outer problem.
+ * Since only a changes, the outer problem keeps one inner_solver that
+ * reoptimizes the same inner TNLP, so that the structure of the problem
+ * and the symbolic factorization are kept, and each solve is started
+ * from the solution of the previous one.
  */
 
 #include "IpIpoptApplication.hpp"
@@ -28,14 +34,20 @@
 
 using namespace Ipopt;
 
+class inner_solver;
+
 class recursive_nlp: public TNLP
 {
 private:
    const bool   inner_;
-   const Number a_;
+   Number       a_;
    Number       arg_min_;
+   bool         have_arg_min_;
    Number       y_;
 
+   // solver for the inner problem, only used by the outer problem
+   SmartPtr<inner_solver> inner_solver_;
+
 public:
    // arg_min
    Number arg_min(void) const
@@ -43,21 +55,23 @@ public:
       return arg_min_;
    }
 
+   // set the parameter of the inner problem
+   void set_a(const Number &a)
+   {
+      a_ = a;
+   }
+
    // constructor for the inner problem
    recursive_nlp(const Number &a)
    : inner_(true),
      a_(a),
      arg_min_(0.0),
+     have_arg_min_(false),
      y_(0.0)
    { }
 
    // constructor for the outer problem
-   recursive_nlp(void)
-   : inner_(false),
-     a_(0.0),
-     arg_min_(0.0),
-     y_(0.0)
-   { }
+   recursive_nlp(void);
 
    // default destructor
    virtual ~recursive_nlp() { }
@@ -114,6 +128,12 @@ public:
       // x[0] == 0 is solution for outer problem
       x[0] = 2.0;
 
+      // warm start the inner problem from the previous solution
+      if( inner_ && have_arg_min_ )
+      {
+         x[0] = arg_min_;
+      }
+
       return true;
    }
 
@@ -136,20 +156,9 @@ public:
       if( new_x )
       {
          // solve the inner problem with corresponding to x[0]
-         SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
-         app->Options()->SetIntegerValue("print_level", J_STRONGWARNING);
-         app->Options()->SetStringValue("hessian_approximation", "limited-memory");
-         ApplicationReturnStatus status = app->Initialize();
-         if( status != Solve_Succeeded )
+         // and set y_ equal to its arg_min
+         if( !solve_inner(x[0]) )
             return false;
-
-         SmartPtr<recursive_nlp> nlp = new recursive_nlp(x[0]);
-         status = app->OptimizeTNLP(nlp);
-         if( status != Solve_Succeeded )
-            return false;
-
-         // set y_ equal to the arg_min for the inner problem
-         y_ = nlp->arg_min();
       }
 
       // evaluate object for the outer problem
@@ -248,9 +257,91 @@ public:
       assert(n == 1 && m == 0);
 
       arg_min_ = x[0];
+      have_arg_min_ = true;
+   }
+
+   // solve the inner problem for a and set y_ to its arg_min
+   bool solve_inner(const Number &a);
+};
+
+/** Solver for the inner problem that is kept over all solves.
+ *
+ *  The first solve optimizes the inner TNLP, all further solves
+ *  reoptimize it for another value of a.  The IpoptApplication thus
+ *  keeps the structure of the problem and, with
+ *  reuse_symbolic_factorization, the symbolic factorization of the
+ *  linear solver, and the TNLP provides the previous solution as
+ *  starting point.
+ */
+class inner_solver: public ReferencedObject
+{
+private:
+   SmartPtr<IpoptApplication> app_;
+   SmartPtr<recursive_nlp>    nlp_;
+   bool                       solved_;
+
+public:
+   inner_solver()
+   : solved_(false)
+   {
+      app_ = IpoptApplicationFactory();
+      app_->Options()->SetIntegerValue("print_level", J_STRONGWARNING);
+      app_->Options()->SetStringValue("hessian_approximation", "limited-memory");
+      app_->Options()->SetStringValue("reuse_symbolic_factorization", "yes");
+      nlp_ = new recursive_nlp(0.0);
+   }
+
+   bool initialize()
+   {
+      return app_->Initialize() == Solve_Succeeded;
+   }
+
+   // solve the inner problem for a, returns whether it was solved
+   bool solve(
+      const Number &a,
+      Number       &arg_min)
+   {
+      nlp_->set_a(a);
+      ApplicationReturnStatus status;
+      if( !solved_ )
+      {
+         status = app_->OptimizeTNLP(nlp_);
+         solved_ = true;
+      }
+      else
+      {
+         status = app_->ReOptimizeTNLP(nlp_);
+      }
+      if( status != Solve_Succeeded )
+         return false;
+
+      arg_min = nlp_->arg_min();
+      return true;
    }
 };
 
+recursive_nlp::recursive_nlp(void)
+: inner_(false),
+  a_(0.0),
+  arg_min_(0.0),
+  have_arg_min_(false),
+  y_(0.0)
+{ }
+
+bool recursive_nlp::solve_inner(const Number &a)
+{
+   if( !IsValid(inner_solver_) )
+   {
+      inner_solver_ = new inner_solver();
+      if( !inner_solver_->initialize() )
+      {
+         inner_solver_ = NULL;
+         return false;
+      }
+   }
+   return inner_solver_->solve(a, y_);
+}
+
 int main(int argc, char** argv)
 {
    SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
@@ -13,6 +13,7 @@
 
 #include "IpOptErrorConvCheck.hpp"
 #include "IpStdAugSystemSolver.hpp"
+#include "IpOrigIpoptNLP.hpp"
 #include "IpTSymLinearSolver.hpp"
 #include "IpPDPerturbationHandler.hpp"
 
@@ -34,12 +35,15 @@
 #include "IpInexactSearchDirCalc.hpp"
 #include "IpInexactNewtonNormal.hpp"
 #include "IpInexactPDSolver.hpp"
+#include "IpInexactKrylovAugSystemSolver.hpp"
 
 #include "IpMa27TSolverInterface.hpp"
 #include "IpMa57TSolverInterface.hpp"
 #include "IpMc19TSymScalingMethod.hpp"
 #include "IpInexactTSymScalingMethod.hpp"
-#include "IpIterativePardisoSolverInterface.hpp"
+#if defined(IPOPT_HAS_PARDISO) && !defined(IPOPT_HAS_PARDISO_MKL)
+# include "IpIterativePardisoSolverInterface.hpp"
+#endif
 #include "IpInexactNormalTerminationTester.hpp"
 #include "IpInexactPDTerminationTester.hpp"
 
@@ -65,8 +69,10 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
-InexactAlgorithmBuilder::InexactAlgorithmBuilder()
-   : AlgorithmBuilder()
+InexactAlgorithmBuilder::InexactAlgorithmBuilder(
+   SmartPtr<AugSystemPreconditioner> custom_preconditioner /*=NULL*/
+)
+   : AlgorithmBuilder(NULL, custom_preconditioner)
 { }
 
 void InexactAlgorithmBuilder::BuildIpoptObjects(
@@ -112,6 +118,17 @@ void InexactAlgorithmBuilder::RegisterOptions(
       "Method for scaling the linear system for the inexact approach", "slack-based",
       "none", "no scaling will be performed",
       "slack-based", "scale the linear system as in paper");
+   roptions->AddStringOption2(
+      "inexact_aug_solver",
+      "Solver for the augmented system in the inexact approach.",
+      "linear-solver",
+      "linear-solver", "use the iterative solver selected by linear_solver",
+      "krylov", "use the Krylov subspace method selected by krylov_method",
+      "The termination tests of the inexact approach are available for the iterative solver in Pardiso "
+      "and for the Krylov subspace methods of Ipopt. "
+      "The latter can be used with any preconditioner, see krylov_preconditioner, "
+      "and do not require Pardiso. "
+      "If hessian_approximation is \"matrix-free\", the Krylov subspace method is always used.");
 }
 
 SmartPtr<IpoptAlgorithm> InexactAlgorithmBuilder::BuildBasicAlgorithm(
@@ -128,9 +145,24 @@ SmartPtr<IpoptAlgorithm> InexactAlgorithmBuilder::BuildBasicAlgorithm(
 
    SmartPtr<InexactNormalTerminationTester> NormalTester;
    SmartPtr<SparseSymLinearSolverInterface> SolverInterface;
+   SmartPtr<AugSystemSolver> AugSolver;
+   Index enum_int;
+   options.GetEnumValue("hessian_approximation", enum_int, prefix);
+   HessianApproximationType hessian_approximation = HessianApproximationType(enum_int);
    std::string linear_solver;
    options.GetStringValue("linear_solver", linear_solver, prefix);
-   if( linear_solver == "ma27" )
+   std::string inexact_aug_solver;
+   options.GetStringValue("inexact_aug_solver", inexact_aug_solver, prefix);
+   if( hessian_approximation == MATRIX_FREE || inexact_aug_solver == "krylov" )
+   {
+      // The augmented system is solved by a Krylov method that uses the
+      // termination tests of the inexact algorithm
+      NormalTester = new InexactNormalTerminationTester();
+      SmartPtr<IterativeSolverTerminationTester> pd_tester = new InexactPDTerminationTester();
+      AugSolver = new InexactKrylovAugSystemSolver(*NormalTester, *pd_tester,
+            AugSystemPreconditionerFactory(jnlst, options, prefix));
+   }
+   else if( linear_solver == "ma27" )
    {
 #ifndef COINHSL_HAS_MA27
 # ifdef IPOPT_HAS_LINEARSOLVERLOADER
@@ -180,27 +212,15 @@ SmartPtr<IpoptAlgorithm> InexactAlgorithmBuilder::BuildBasicAlgorithm(
    }
    else if( linear_solver == "pardiso" )
    {
+      // The iterative solver with the callback for the termination
+      // tests is only available in Pardiso from pardiso-project.org
+#if defined(IPOPT_HAS_PARDISO) && !defined(IPOPT_HAS_PARDISO_MKL)
       NormalTester = new InexactNormalTerminationTester();
       SmartPtr<IterativeSolverTerminationTester> pd_tester = new InexactPDTerminationTester();
-#ifndef IPOPT_HAS_PARDISO
-# ifdef IPOPT_HAS_LINEARSOLVERLOADER
       SolverInterface = new IterativePardisoSolverInterface(*NormalTester, *pd_tester);
-      char buf[256];
-      int rc = LSL_loadPardisoLib(NULL, buf, 255);
-      if (rc)
-      {
-         std::string errmsg;
-         errmsg = "Selected linear solver Pardiso not available.\nTried to obtain Pardiso from shared library \"";
-         errmsg += LSL_PardisoLibraryName();
-         errmsg += "\", but the following error occured:\n";
-         errmsg += buf;
-         THROW_EXCEPTION(OPTION_INVALID, errmsg.c_str());
-      }
-# else
-      THROW_EXCEPTION(OPTION_INVALID, "Support for Pardiso has not been compiled into Ipopt.");
-# endif
 #else
-      SolverInterface = new IterativePardisoSolverInterface(*NormalTester, *pd_tester);
+      THROW_EXCEPTION(OPTION_INVALID,
+                      "The inexact version requires Pardiso from pardiso-project.org for linear_solver=pardiso. Choose inexact_aug_solver=krylov instead.");
 #endif
 
    }
@@ -229,18 +249,21 @@ SmartPtr<IpoptAlgorithm> InexactAlgorithmBuilder::BuildBasicAlgorithm(
       THROW_EXCEPTION(OPTION_INVALID, "Inexact version not available for this selection of linear solver.");
    }
 
-   SmartPtr<TSymScalingMethod> ScalingMethod;
-
-   std::string inexact_linear_system_scaling;
-   options.GetStringValue("inexact_linear_system_scaling", inexact_linear_system_scaling, prefix);
-   if( inexact_linear_system_scaling == "slack-based" )
+   if( IsNull(AugSolver) )
    {
-      ScalingMethod = new InexactTSymScalingMethod();
-   }
+      SmartPtr<TSymScalingMethod> ScalingMethod;
+
+      std::string inexact_linear_system_scaling;
+      options.GetStringValue("inexact_linear_system_scaling", inexact_linear_system_scaling, prefix);
+      if( inexact_linear_system_scaling == "slack-based" )
+      {
+         ScalingMethod = new InexactTSymScalingMethod();
+      }
 
-   SmartPtr<SymLinearSolver> ScaledSolver = new TSymLinearSolver(SolverInterface, ScalingMethod);
+      SmartPtr<SymLinearSolver> ScaledSolver = new TSymLinearSolver(SolverInterface, ScalingMethod);
 
-   SmartPtr<AugSystemSolver> AugSolver = new StdAugSystemSolver(*ScaledSolver);
+      AugSolver = new StdAugSystemSolver(*ScaledSolver);
+   }
 
    // Create the object for initializing the iterates Initialization
    // object.  We include both the warm start and the defaut
@@ -307,6 +330,10 @@ void AddInexactDefaultOptions(
    //options_list.SetNumericValueIfUnset("bound_relax_factor", 0.);
    options_list.SetNumericValueIfUnset("kappa_d", 0.);
    options_list.SetStringValueIfUnset("linear_solver", "pardiso");
+#if !defined(IPOPT_HAS_PARDISO) || defined(IPOPT_HAS_PARDISO_MKL)
+   // without the iterative solver in Pardiso, use Ipopt's Krylov methods
+   options_list.SetStringValueIfUnset("inexact_aug_solver", "krylov");
+#endif
    options_list.SetStringValue("linear_scaling_on_demand", "no");
    options_list.SetStringValue("replace_bounds", "yes");
 }
@@ -27,8 +27,14 @@ class InexactAlgorithmBuilder: public AlgorithmBuilder
 public:
    /**@name Constructors/Destructors */
    ///@{
-   /** Constructor */
-   InexactAlgorithmBuilder();
+   /** Constructor
+    *
+    *  custom_preconditioner is used by the Krylov subspace method for
+    *  the augmented system if krylov_preconditioner is "custom".
+    */
+   InexactAlgorithmBuilder(
+      SmartPtr<AugSystemPreconditioner> custom_preconditioner = NULL
+   );
 
    /** Destructor */
    virtual ~InexactAlgorithmBuilder()
@@ -41,6 +41,16 @@ void InexactDoglegNormalStep::RegisterOptions(
       "Maximal trust region factor for normal problem.",
       0.0, true,
       1e20);
+   reg_options->AddBoundedNumberOption(
+      "dogleg_cauchy_tol",
+      "Relative linearized constraint violation after the Cauchy step below which the Newton step is skipped.",
+      0.0, false,
+      1.0, true,
+      0.0,
+      "If the norm of the linearized constraint violation at the Cauchy point is at most this factor times the "
+      "current constraint violation, the Cauchy step is used as normal step, "
+      "and the iterative solve for the Newton step of the normal problem is skipped. "
+      "The value 0 always computes the Newton step unless the Cauchy step hits the trust region.");
 }
 
 bool InexactDoglegNormalStep::InitializeImpl(
@@ -50,6 +60,7 @@ bool InexactDoglegNormalStep::InitializeImpl(
 {
    options.GetNumericValue("omega_init", curr_omega_, prefix);
    options.GetNumericValue("omega_max", omega_max_, prefix);
+   options.GetNumericValue("dogleg_cauchy_tol", dogleg_cauchy_tol_, prefix);
 
    // We do not want to trigger an increase of the trust region
    // factor in the first iteration, so we initialize this flag to
@@ -89,8 +100,11 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
    }
    last_tr_inactive_ = false;
 
-   // TODO if (IpCq().curr_primal_infeasibility(NORM_2) == 0.) {
-   if( IpCq().curr_primal_infeasibility(NORM_2) <= 1e-12 )
+   // norm of the current constraint violation (c, d-s)
+   const Number c_norm = IpCq().curr_primal_infeasibility(NORM_2);
+
+   // TODO if (c_norm == 0.) {
+   if( c_norm <= 1e-12 )
    {
       Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                      "Dogleg step:  We are at a feasible point, the normal step is set to zero.\n");
@@ -116,14 +130,16 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
    // function (A^T c)
    Number v_ATc_norm = InexCq().curr_scaled_Ac_norm();
 
-   // Compute A * A^T * c
+   // Compute A * A^T * c.  The products of the Jacobians with A^T c
+   // are kept, since they also give the products with the Cauchy step.
    SmartPtr<const Vector> vec_AATc_c = IpCq().curr_jac_c_times_vec(*curr_jac_cdT_times_curr_cdminuss);
+   SmartPtr<const Vector> jac_d_ATc = IpCq().curr_jac_d_times_vec(*curr_jac_cdT_times_curr_cdminuss);
    SmartPtr<Vector> vec_AATc_d = curr_slack_scaled_d_minus_s->MakeNewCopy();
    vec_AATc_d->ElementWiseMultiply(*InexCq().curr_scaling_slacks());
    DBG_PRINT_VECTOR(1, "curr_scaling_slacks", *InexCq().curr_scaling_slacks());
    DBG_PRINT_VECTOR(1, "vec_AATc_d", *vec_AATc_d);
-   vec_AATc_d->AddOneVector(1., *IpCq().curr_jac_d_times_vec(*curr_jac_cdT_times_curr_cdminuss), 1.);
-   DBG_PRINT_VECTOR(1, "IpCq().curr_jac_d_times_vec(*curr_jac_cdT_times_curr_cdminuss)", *IpCq().curr_jac_d_times_vec(*curr_jac_cdT_times_curr_cdminuss));
+   vec_AATc_d->AddOneVector(1., *jac_d_ATc, 1.);
+   DBG_PRINT_VECTOR(1, "jac_d_ATc", *jac_d_ATc);
    DBG_PRINT_VECTOR(1, "vec_AATc_c", *vec_AATc_c);
    DBG_PRINT_VECTOR(1, "vec_AATc_d", *vec_AATc_d);
    Number AATc_norm = IpCq().CalcNormOfType(NORM_2, *vec_AATc_c, *vec_AATc_d);
@@ -162,7 +178,7 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
    {
       normal_tester_->Set_c_Avc_norm_cauchy(c_Avc_norm_cauchy);
    }
-   Number objred_normal_cs = 0.5 * (IpCq().CalcNormOfType(NORM_2, *curr_c, *curr_d_minus_s) - c_Avc_norm_cauchy);
+   Number objred_normal_cs = 0.5 * (c_norm - c_Avc_norm_cauchy);
    Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                   "Dogleg: Reduction of normal problem objective function by Cauchy step = %23.16e\n", objred_normal_cs);
 
@@ -178,9 +194,21 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
       IpData().Append_info_string("Nc ");
       return true;
    }
-   // ToDo: We don't need this if we do a proper check for Newton step below
-   SmartPtr<Vector> v_cauchy_x_bak = v_cauchy_x->MakeNewCopy();
-   SmartPtr<Vector> v_cauchy_s_bak = v_cauchy_s->MakeNewCopy();
+
+   // If the Cauchy step reduces the linearized constraint violation
+   // enough, the Newton step is not computed
+   if( c_Avc_norm_cauchy <= dogleg_cauchy_tol_ * c_norm )
+   {
+      Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
+                     "Dogleg step:  Cauchy step reduces the linearized constraint violation sufficiently.\n");
+      normal_x = v_cauchy_x;
+      normal_s = v_cauchy_s;
+      // unscale the slack-based scaling
+      normal_s->ElementWiseMultiply(*InexCq().curr_scaling_slacks());
+      last_tr_inactive_ = true;
+      IpData().Append_info_string("Nc ");
+      return true;
+   }
 
    ///////////////////// Newton Step
 
@@ -191,8 +219,8 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
    {
       Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                      "Dogleg step: Newton step could not be calculated, return Cauchy step.\n");
-      normal_x = v_cauchy_x_bak;
-      normal_s = v_cauchy_s_bak;
+      normal_x = v_cauchy_x;
+      normal_s = v_cauchy_s;
       // unscale the slack-based scaling
       normal_s->ElementWiseMultiply(*InexCq().curr_scaling_slacks());
       IpData().Append_info_string("NF ");
@@ -239,10 +267,11 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
 
       Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                      "Dogleg step:  Using convex combination of Cauchy and Newton step with factor lambda = %e\n", lambda);
-      v_cauchy_x->AddOneVector(1. - lambda, *v_newton_x, lambda);
-      v_cauchy_s->AddOneVector(1. - lambda, *v_newton_s, lambda);
-      normal_x = v_cauchy_x;
-      normal_s = v_cauchy_s;
+      // the Cauchy step is kept for the comparison below
+      v_newton_x->AddOneVector(lambda, *v_cauchy_x, 1. - lambda);
+      v_newton_s->AddOneVector(lambda, *v_cauchy_s, 1. - lambda);
+      normal_x = v_newton_x;
+      normal_s = v_newton_s;
       IpData().Append_info_string("Nd ");
 
       DBG_PRINT((1, "v_normal^2  = %e\n", normal_x->Dot(*normal_x) + normal_s->Dot(*normal_s)));
@@ -253,7 +282,7 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
 
    // Compute the unscaled steps
    normal_s->ElementWiseMultiply(*InexCq().curr_scaling_slacks());
-   v_cauchy_s_bak->ElementWiseMultiply(*InexCq().curr_scaling_slacks());
+   v_cauchy_s->ElementWiseMultiply(*InexCq().curr_scaling_slacks());
 
    // We now check if the Dogleg step, shorted by the
    // fraction-to-the-boundary rule, gives at least as much progress
@@ -263,27 +292,26 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
 
    // TODO: Implement efficiently
    const Number tau = IpData().curr_tau();
-   Number ftb_cauchy = IpCq().primal_frac_to_the_bound(tau, *v_cauchy_x_bak, *v_cauchy_s_bak);
+   Number ftb_cauchy = IpCq().primal_frac_to_the_bound(tau, *v_cauchy_x, *v_cauchy_s);
    Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                   "Dogleg: Fraction-to-the-bounary step size for Cauchy step = %23.16e\n", ftb_cauchy);
-   inf_c = IpCq().curr_jac_c_times_vec(*v_cauchy_x_bak)->MakeNewCopy();
-   inf_c->AddOneVector(1., *curr_c, ftb_cauchy);
-   inf_d = curr_d_minus_s->MakeNewCopy();
-   inf_d->AddTwoVectors(-ftb_cauchy, *v_cauchy_s_bak, ftb_cauchy, *IpCq().curr_jac_d_times_vec(*v_cauchy_x_bak), 1.);
-   Number objred_ftb_cauchy = 0.5
-                              * (IpCq().CalcNormOfType(NORM_2, *curr_c, *curr_d_minus_s) - IpCq().CalcNormOfType(NORM_2, *inf_c, *inf_d));
+   // the Jacobian products of the Cauchy step are -alpha_cs times the
+   // ones of A^T c
+   inf_c->AddTwoVectors(1., *curr_c, -alpha_cs * ftb_cauchy, *vec_AATc_c, 0.);
+   inf_d->AddTwoVectors(1., *curr_d_minus_s, -ftb_cauchy, *v_cauchy_s, 0.);
+   inf_d->Axpy(-alpha_cs * ftb_cauchy, *jac_d_ATc);
+   Number objred_ftb_cauchy = 0.5 * (c_norm - IpCq().CalcNormOfType(NORM_2, *inf_c, *inf_d));
    Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                   "Dogleg: Reduction of normal problem objective function by ftb cauchy step = %23.16e\n", objred_ftb_cauchy);
 
    Number ftb_dogleg = IpCq().primal_frac_to_the_bound(tau, *normal_x, *normal_s);
    Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                   "Dogleg: Fraction-to-the-bounary step size for Dogleg step = %23.16e\n", ftb_dogleg);
-   inf_c = IpCq().curr_jac_c_times_vec(*normal_x)->MakeNewCopy();
-   inf_c->AddOneVector(1., *curr_c, ftb_dogleg);
-   inf_d = curr_d_minus_s->MakeNewCopy();
-   inf_d->AddTwoVectors(-ftb_dogleg, *normal_s, ftb_dogleg, *IpCq().curr_jac_d_times_vec(*normal_x), 1.);
-   Number objred_ftb_dogleg = 0.5
-                              * (IpCq().CalcNormOfType(NORM_2, *curr_c, *curr_d_minus_s) - IpCq().CalcNormOfType(NORM_2, *inf_c, *inf_d));
+   IpCq().curr_jac_c()->MultVector(ftb_dogleg, *normal_x, 0., *inf_c);
+   inf_c->Axpy(1., *curr_c);
+   IpCq().curr_jac_d()->MultVector(ftb_dogleg, *normal_x, 0., *inf_d);
+   inf_d->AddTwoVectors(1., *curr_d_minus_s, -ftb_dogleg, *normal_s, 1.);
+   Number objred_ftb_dogleg = 0.5 * (c_norm - IpCq().CalcNormOfType(NORM_2, *inf_c, *inf_d));
    Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                   "Dogleg: Reduction of normal problem objective function by ftb dogleg step = %23.16e\n", objred_ftb_dogleg);
 
@@ -295,8 +323,8 @@ bool InexactDoglegNormalStep::ComputeNormalStep(
    {
       Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
                      "Dogleg step: Dogleg step makes less progress than Cauchy step, resetting to Cauchy step.\n");
-      normal_x = v_cauchy_x_bak;
-      normal_s = v_cauchy_s_bak;
+      normal_x = v_cauchy_x;
+      normal_s = v_cauchy_s;
       IpData().Append_info_string("NR ");
    }
 
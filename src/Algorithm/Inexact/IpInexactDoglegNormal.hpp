@@ -93,6 +93,10 @@ private:
    /** @name Algorithmic options */
    ///@{
    Number omega_max_;
+   /** Fraction of the constraint violation below which the
+    *  linearized violation after the Cauchy step has to be, so that
+    *  the Newton step is skipped */
+   Number dogleg_cauchy_tol_;
    ///@}
 
    /** Current value of the trust region factor */
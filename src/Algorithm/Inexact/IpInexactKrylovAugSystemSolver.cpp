@@ -0,0 +1,164 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpInexactKrylovAugSystemSolver.hpp"
+#include "IpTripletHelper.hpp"
+
+extern Ipopt::IterativeSolverTerminationTester::ETerminationTest test_result_;
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+InexactKrylovAugSystemSolver::InexactKrylovAugSystemSolver(
+   IterativeSolverTerminationTester& normal_tester,
+   IterativeSolverTerminationTester& pd_tester,
+   SmartPtr<AugSystemPreconditioner> precond
+)
+   : KrylovAugSystemSolver(precond),
+     normal_tester_(&normal_tester),
+     pd_tester_(&pd_tester),
+     requires_scaling_(false),
+     ndim_(0),
+     sol_vals_(NULL),
+     resid_vals_(NULL)
+{
+   DBG_START_METH("InexactKrylovAugSystemSolver::InexactKrylovAugSystemSolver()", dbg_verbosity);
+}
+
+InexactKrylovAugSystemSolver::~InexactKrylovAugSystemSolver()
+{
+   DBG_START_METH("InexactKrylovAugSystemSolver::~InexactKrylovAugSystemSolver()", dbg_verbosity);
+   delete[] sol_vals_;
+   delete[] resid_vals_;
+}
+
+bool InexactKrylovAugSystemSolver::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   if( !KrylovAugSystemSolver::InitializeImpl(options, prefix) )
+   {
+      return false;
+   }
+
+   std::string inexact_linear_system_scaling;
+   options.GetStringValue("inexact_linear_system_scaling", inexact_linear_system_scaling, prefix);
+   requires_scaling_ = (inexact_linear_system_scaling == "slack-based");
+
+   bool retval = normal_tester_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+   if( retval )
+   {
+      retval = pd_tester_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+   }
+
+   return retval;
+}
+
+bool InexactKrylovAugSystemSolver::InitializeTerminationTest()
+{
+   DBG_START_METH("InexactKrylovAugSystemSolver::InitializeTerminationTest", dbg_verbosity);
+
+   if( IsNull(InexData().normal_x()) && InexData().compute_normal() )
+   {
+      tester_ = normal_tester_;
+   }
+   else
+   {
+      tester_ = pd_tester_;
+   }
+
+   Index ndim = IpData().curr()->x()->Dim() + IpData().curr()->s()->Dim() + IpData().curr()->y_c()->Dim()
+                + IpData().curr()->y_d()->Dim();
+   if( ndim != ndim_ )
+   {
+      delete[] sol_vals_;
+      delete[] resid_vals_;
+      ndim_ = ndim;
+      sol_vals_ = new Number[ndim_];
+      resid_vals_ = new Number[ndim_];
+   }
+
+   test_result_ = IterativeSolverTerminationTester::CONTINUE;
+
+   return tester_->InitializeSolve();
+}
+
+Index InexactKrylovAugSystemSolver::WarmStartKey(
+   Index irhs
+) const
+{
+   DBG_ASSERT(IsValid(tester_));
+   return 2 * irhs + (tester_ == normal_tester_ ? 1 : 0);
+}
+
+void InexactKrylovAugSystemSolver::FinalizeTerminationTest()
+{
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Number of iterations of Krylov method for %s step = %" IPOPT_INDEX_FORMAT ".\n",
+                  tester_ == normal_tester_ ? "normal" : "PD", tester_->GetSolverIterations());
+   tester_->Clear();
+   tester_ = NULL;
+}
+
+KrylovAugSystemSolver::EKrylovTest InexactKrylovAugSystemSolver::TestTermination(
+   Index                 iter,
+   const CompoundVector& sol,
+   const CompoundVector& resid,
+   Number                norm2_rhs
+)
+{
+   DBG_START_METH("InexactKrylovAugSystemSolver::TestTermination", dbg_verbosity);
+   DBG_ASSERT(IsValid(tester_));
+
+   // The testers expect the solution and residual of the augmented
+   // system that is scaled by the slacks if the slack-based scaling
+   // is chosen
+   SmartPtr<const Vector> sol_s = sol.GetComp(1);
+   SmartPtr<const Vector> resid_s = resid.GetComp(1);
+   if( requires_scaling_ )
+   {
+      SmartPtr<const Vector> scaling_vec = InexCq().curr_scaling_slacks();
+      SmartPtr<Vector> tmp = sol_s->MakeNewCopy();
+      tmp->ElementWiseDivide(*scaling_vec);
+      sol_s = ConstPtr(tmp);
+      tmp = resid_s->MakeNewCopy();
+      tmp->ElementWiseMultiply(*scaling_vec);
+      resid_s = ConstPtr(tmp);
+   }
+
+   Number* sol_vals = sol_vals_;
+   Number* resid_vals = resid_vals_;
+   for( Index i = 0; i < 4; i++ )
+   {
+      SmartPtr<const Vector> sol_i = i == 1 ? sol_s : sol.GetComp(i);
+      SmartPtr<const Vector> resid_i = i == 1 ? resid_s : resid.GetComp(i);
+      Index dim = sol_i->Dim();
+      TripletHelper::FillValuesFromVector(dim, *sol_i, sol_vals);
+      TripletHelper::FillValuesFromVector(dim, *resid_i, resid_vals);
+      sol_vals += dim;
+      resid_vals += dim;
+   }
+
+   test_result_ = tester_->TestTermination(ndim_, sol_vals_, resid_vals_, iter, norm2_rhs);
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Termination Tester Result = %d.\n", test_result_);
+
+   switch( test_result_ )
+   {
+      case IterativeSolverTerminationTester::CONTINUE:
+         return KRYLOV_CONTINUE;
+      case IterativeSolverTerminationTester::TEST_2_SATISFIED:
+         return KRYLOV_ACCEPT_ZERO_PRIMAL;
+      case IterativeSolverTerminationTester::MODIFY_HESSIAN:
+         return KRYLOV_MODIFY_HESSIAN;
+      default:
+         return KRYLOV_ACCEPT;
+   }
+}
+
+} // namespace Ipopt
@@ -0,0 +1,131 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPINEXACTKRYLOVAUGSYSTEMSOLVER_HPP__
+#define __IPINEXACTKRYLOVAUGSYSTEMSOLVER_HPP__
+
+#include "IpKrylovAugSystemSolver.hpp"
+#include "IpIterativeSolverTerminationTester.hpp"
+
+namespace Ipopt
+{
+/** Krylov subspace solver for the augmented system in the inexact
+ *  version of Ipopt.
+ *
+ *  Instead of the test on the relative residual, the iterations are
+ *  stopped by the termination testers of the inexact algorithm, as
+ *  for the iterative solver in Pardiso.  The tester for the normal
+ *  step is used while the normal step is computed, and the tester
+ *  for the primal-dual step otherwise.
+ */
+class InexactKrylovAugSystemSolver: public KrylovAugSystemSolver
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor */
+   InexactKrylovAugSystemSolver(
+      IterativeSolverTerminationTester& normal_tester,
+      IterativeSolverTerminationTester& pd_tester,
+      SmartPtr<AugSystemPreconditioner> precond
+   );
+
+   /** Destructor */
+   virtual ~InexactKrylovAugSystemSolver();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+protected:
+   virtual bool UseTerminationTest() const
+   {
+      return true;
+   }
+
+   virtual bool InitializeTerminationTest();
+
+   virtual void FinalizeTerminationTest();
+
+   virtual EKrylovTest TestTermination(
+      Index                 iter,
+      const CompoundVector& sol,
+      const CompoundVector& resid,
+      Number                norm2_rhs
+   );
+
+   /** The normal and the primal-dual steps are kept separately */
+   virtual Index WarmStartKey(
+      Index irhs
+   ) const;
+
+   /** Method to easily access Inexact data */
+   InexactData& InexData()
+   {
+      InexactData& inexact_data = static_cast<InexactData&>(IpData().AdditionalData());
+      DBG_ASSERT(dynamic_cast<InexactData*>(&IpData().AdditionalData()));
+      return inexact_data;
+   }
+
+   /** Method to easily access Inexact calculated quantities */
+   InexactCq& InexCq()
+   {
+      InexactCq& inexact_cq = static_cast<InexactCq&>(IpCq().AdditionalCq());
+      DBG_ASSERT(dynamic_cast<InexactCq*>(&IpCq().AdditionalCq()));
+      return inexact_cq;
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   InexactKrylovAugSystemSolver();
+
+   /** Copy Constructor */
+   InexactKrylovAugSystemSolver(
+      const InexactKrylovAugSystemSolver&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const InexactKrylovAugSystemSolver&
+   );
+   ///@}
+
+   /** Termination tester for the normal step */
+   SmartPtr<IterativeSolverTerminationTester> normal_tester_;
+
+   /** Termination tester for the primal-dual step */
+   SmartPtr<IterativeSolverTerminationTester> pd_tester_;
+
+   /** Tester for the current solve */
+   SmartPtr<IterativeSolverTerminationTester> tester_;
+
+   /** Whether the testers expect the slack-based scaling of the
+    *  augmented system (inexact_linear_system_scaling).
+    */
+   bool requires_scaling_;
+
+   /** Work space for the solution and residual in the form expected
+    *  by the testers
+    */
+   ///@{
+   Index ndim_;
+   Number* sol_vals_;
+   Number* resid_vals_;
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
@@ -9,6 +9,7 @@
 #include <cmath>
 
 #include "IpIterativeSolverTerminationTester.hpp"
+#include "IpOrigIpoptNLP.hpp"
 
 extern Ipopt::IterativeSolverTerminationTester::ETerminationTest test_result_;
 
@@ -65,7 +66,12 @@ bool InexactPDSolver::InitializeImpl(
 
    std::string linear_solver;
    options.GetStringValue("linear_solver", linear_solver, prefix);
-   is_pardiso_ = (linear_solver == "pardiso");
+   std::string inexact_aug_solver;
+   options.GetStringValue("inexact_aug_solver", inexact_aug_solver, prefix);
+   Index enum_int;
+   options.GetEnumValue("hessian_approximation", enum_int, prefix);
+   uses_termination_tests_ = (linear_solver == "pardiso" || inexact_aug_solver == "krylov"
+                              || HessianApproximationType(enum_int) == MATRIX_FREE);
 
    if( !augSysSolver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix) )
    {
@@ -242,7 +248,7 @@ bool InexactPDSolver::Solve(
          InexData().set_tangential_x(tangential_x);
          InexData().set_tangential_s(tangential_s);
 
-         if( !is_pardiso_ )
+         if( !uses_termination_tests_ )
          {
             // check if we need to modify the system
             bool modify_hessian = HessianRequiresChange();
@@ -303,7 +309,7 @@ bool InexactPDSolver::Solve(
 
    // Some output
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of trial factorizations performed: %d\n", count);
+                  "Number of trial factorizations performed: %" IPOPT_INDEX_FORMAT "\n", count);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                   "Final perturbation parameters: delta_x=%e delta_s=%e\n                         delta_c=%e delta_d=%e\n", delta_x,
                   delta_s, delta_c, delta_d);
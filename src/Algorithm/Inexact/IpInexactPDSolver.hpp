@@ -141,10 +141,10 @@ private:
    Index inexact_regularization_ls_count_trigger_;
    ///@}
 
-   /** flag indicating if we are dealing with the Pardiso solver
-    *  (temporary)
+   /** flag indicating if the augmented system solver uses the
+    *  termination tests (iterative solver in Pardiso or Krylov method)
     */
-   bool is_pardiso_;
+   bool uses_termination_tests_;
 
    Index last_info_ls_count_;
 };
@@ -14,7 +14,9 @@
 #include "IpInexactPDSolver.hpp"
 #include "IpInexactLSAcceptor.hpp"
 #include "IpInexactCq.hpp"
-#include "IpIterativePardisoSolverInterface.hpp"
+#if defined(IPOPT_HAS_PARDISO) && !defined(IPOPT_HAS_PARDISO_MKL)
+# include "IpIterativePardisoSolverInterface.hpp"
+#endif
 #include "IpInexactNormalTerminationTester.hpp"
 #include "IpInexactPDTerminationTester.hpp"
 
@@ -33,7 +35,9 @@ void RegisterOptions_Inexact(
    InexactPDSolver::RegisterOptions(roptions);
    InexactLSAcceptor::RegisterOptions(roptions);
    InexactCq::RegisterOptions(roptions);
+#if defined(IPOPT_HAS_PARDISO) && !defined(IPOPT_HAS_PARDISO_MKL)
    IterativePardisoSolverInterface::RegisterOptions(roptions);
+#endif
    InexactNormalTerminationTester::RegisterOptions(roptions);
    InexactPDTerminationTester::RegisterOptions(roptions);
 }
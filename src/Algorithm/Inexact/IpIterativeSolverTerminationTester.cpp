@@ -7,6 +7,9 @@
 #include "IpIterativeSolverTerminationTester.hpp"
 #include "IpTripletHelper.hpp"
 
+// result of the most recent termination test of an iterative solver
+Ipopt::IterativeSolverTerminationTester::ETerminationTest test_result_;
+
 namespace Ipopt
 {
 
@@ -6,6 +6,7 @@
 
 #include "IpAdaptiveMuUpdate.hpp"
 #include "IpJournalist.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 
@@ -399,6 +400,7 @@ bool AdaptiveMuUpdate::UpdateBarrierParameter()
                         "The mu oracle could not compute a new value of the barrier parameter.\n");
          return false;
       }
+      Number mu_oracle = mu;
 
       mu = Max(mu, mu_min_);
       Number mu_lower_safe = lower_mu_safeguard();
@@ -418,6 +420,12 @@ bool AdaptiveMuUpdate::UpdateBarrierParameter()
       Jnlst().Printf(J_DETAILED, J_BARRIER_UPDATE,
                      "Barrier parameter mu after safeguards is %e\n", mu);
 
+      // A search direction computed by the oracle is only valid for its mu
+      if( mu != mu_oracle )
+      {
+         IpData().SetHaveDeltas(false);
+      }
+
       // Set the new values
       IpData().Set_mu(mu);
 
@@ -504,7 +512,7 @@ void AdaptiveMuUpdate::RememberCurrentPointAsAccepted()
             {
                num_refs++;
                Jnlst().Printf(J_MOREDETAILED, J_BARRIER_UPDATE,
-                              "pd system reference[%2d] = %.6e\n", num_refs, *iter);
+                              "pd system reference[%2" IPOPT_INDEX_FORMAT "] = %.6e\n", num_refs, *iter);
             }
          }
       }
@@ -599,11 +607,13 @@ Number AdaptiveMuUpdate::NewFixedMu()
     */
 
    Number new_mu;
+   Number mu_oracle = 0.;
    bool have_mu = false;
    ;
    if( IsValid(fix_mu_oracle_) )
    {
       have_mu = fix_mu_oracle_->CalculateMu(Max(mu_min_, mu_target_), mu_max_, new_mu);
+      mu_oracle = new_mu;
       if( !have_mu )
       {
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
@@ -620,6 +630,12 @@ Number AdaptiveMuUpdate::NewFixedMu()
    new_mu = Max(new_mu, mu_min_);
    new_mu = Min(new_mu, mu_max_);
 
+   // A search direction computed by the oracle is only valid for its mu
+   if( have_mu && new_mu != mu_oracle )
+   {
+      IpData().SetHaveDeltas(false);
+   }
+
    return new_mu;
 }
 
@@ -782,4 +798,41 @@ Number AdaptiveMuUpdate::lower_mu_safeguard()
    return lower_mu_safeguard;
 }
 
+void AdaptiveMuUpdate::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   checkpoint.WriteSection("AdaptiveMuUpdate");
+   checkpoint.WriteNumber(init_dual_inf_);
+   checkpoint.WriteNumber(init_primal_inf_);
+   checkpoint.WriteIndex((Index) refs_vals_.size());
+   for( std::list<Number>::const_iterator iter = refs_vals_.begin(); iter != refs_vals_.end(); ++iter )
+   {
+      checkpoint.WriteNumber(*iter);
+   }
+   filter_.WriteCheckpoint(checkpoint);
+   checkpoint.WriteBool(no_bounds_);
+   checkpoint.WriteBool(check_if_no_bounds_);
+   checkpoint.WriteIterates(accepted_point_);
+}
+
+void AdaptiveMuUpdate::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("AdaptiveMuUpdate");
+   init_dual_inf_ = checkpoint.ReadNumber();
+   init_primal_inf_ = checkpoint.ReadNumber();
+   refs_vals_.clear();
+   Index num_refs = checkpoint.ReadIndex();
+   for( Index i = 0; i < num_refs; i++ )
+   {
+      refs_vals_.push_back(checkpoint.ReadNumber());
+   }
+   filter_.ReadCheckpoint(checkpoint);
+   no_bounds_ = checkpoint.ReadBool();
+   check_if_no_bounds_ = checkpoint.ReadBool();
+   accepted_point_ = ConstPtr(checkpoint.ReadIterates(*IpData().curr()));
+}
+
 } // namespace Ipopt
@@ -46,6 +46,16 @@ public:
     *  linesearch is called. */
    virtual bool UpdateBarrierParameter();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    /** Methods for IpoptType */
    ///@{
    static void RegisterOptions(
@@ -25,6 +25,7 @@
 #include "IpPenaltyLSAcceptor.hpp"
 #include "IpPDSearchDirCalc.hpp"
 #include "IpCGSearchDirCalc.hpp"
+#include "IpPredCorrSearchDirCalc.hpp"
 #include "IpMonotoneMuUpdate.hpp"
 #include "IpAdaptiveMuUpdate.hpp"
 #include "IpLoqoMuOracle.hpp"
@@ -36,15 +37,22 @@
 #include "IpWarmStartIterateInitializer.hpp"
 #include "IpOrigIterationOutput.hpp"
 #include "IpLimMemQuasiNewtonUpdater.hpp"
+#include "IpPartitionedQuasiNewtonUpdater.hpp"
+#include "IpLaggedHessianUpdater.hpp"
 #include "IpOrigIpoptNLP.hpp"
 #include "IpLowRankAugSystemSolver.hpp"
 #include "IpLowRankSSAugSystemSolver.hpp"
+#include "IpKrylovAugSystemSolver.hpp"
+#include "IpSchurAugSystemSolver.hpp"
+#include "IpDiagHessianAugSystemSolver.hpp"
+#include "IpDiagonalAugSystemPreconditioner.hpp"
 #include "IpRestoIterationOutput.hpp"
 #include "IpRestoFilterConvCheck.hpp"
 #include "IpRestoIterateInitializer.hpp"
 #include "IpRestoPenaltyConvCheck.hpp"
 #include "IpRestoRestoPhase.hpp"
 #include "IpTSymLinearSolver.hpp"
+#include "IpAutoTuneSymLinearSolver.hpp"
 #include "IpUserScaling.hpp"
 #include "IpGradientScaling.hpp"
 #include "IpEquilibrationScaling.hpp"
@@ -60,6 +68,7 @@
 #include "IpMa97SolverInterface.hpp"
 #include "IpMc19TSymScalingMethod.hpp"
 #include "IpPardisoSolverInterface.hpp"
+#include "IpRuizTSymScalingMethod.hpp"
 #include "IpSlackBasedTSymScalingMethod.hpp"
 
 #ifdef IPOPT_HAS_WSMP
@@ -69,6 +78,10 @@
 #ifdef IPOPT_HAS_MUMPS
 # include "IpMumpsSolverInterface.hpp"
 #endif
+#ifdef IPOPT_HAS_CUDSS
+# include "IpCuDSSSolverInterface.hpp"
+#endif
+#include "IpLapackSolverInterface.hpp"
 
 #ifdef IPOPT_HAS_LINEARSOLVERLOADER
 # include "HSLLoader.h"
@@ -82,9 +95,11 @@ static const Index dbg_verbosity = 0;
 #endif
 
 AlgorithmBuilder::AlgorithmBuilder(
-   SmartPtr<AugSystemSolver> custom_solver /*=NULL*/
+   SmartPtr<AugSystemSolver>         custom_solver /*=NULL*/,
+   SmartPtr<AugSystemPreconditioner> custom_preconditioner /*=NULL*/
 )
-   : custom_solver_(custom_solver)
+   : custom_solver_(custom_solver),
+     custom_preconditioner_(custom_preconditioner)
 { }
 
 void AlgorithmBuilder::RegisterOptions(
@@ -92,7 +107,7 @@ void AlgorithmBuilder::RegisterOptions(
 )
 {
    roptions->SetRegisteringCategory("Linear Solver");
-   roptions->AddStringOption9(
+   roptions->AddStringOption11(
       "linear_solver",
       "Linear solver used for step computations.",
 #ifdef COINHSL_HAS_MA27
@@ -119,7 +134,11 @@ void AlgorithmBuilder::RegisterOptions(
 #       ifdef COINHSL_HAS_MA77
       "ma77",
 #       else
+#        ifdef IPOPT_HAS_CUDSS
+      "cudss",
+#        else
       "ma27",
+#        endif
 #       endif
 #      endif
 #     endif
@@ -136,12 +155,14 @@ void AlgorithmBuilder::RegisterOptions(
       "pardiso", "use the Pardiso package",
       "wsmp", "use WSMP package",
       "mumps", "use MUMPS package",
+      "cudss", "use the NVIDIA cuDSS package on a GPU",
+      "lapack", "use the dense symmetric indefinite factorization of LAPACK",
       "custom", "use custom linear solver",
       "Determines which linear algebra package is to be used for the solution of the augmented linear system (for obtaining the search directions). "
       "Note, the code must have been compiled with the linear solver you want to choose. "
       "Depending on your Ipopt installation, not all options are available.");
    roptions->SetRegisteringCategory("Linear Solver");
-   roptions->AddStringOption3(
+   roptions->AddStringOption4(
       "linear_system_scaling", "Method for scaling the linear system.",
 #ifdef COINHSL_HAS_MC19
       "mc19",
@@ -150,12 +171,14 @@ void AlgorithmBuilder::RegisterOptions(
 #endif
       "none", "no scaling will be performed",
       "mc19", "use the Harwell routine MC19",
+      "ruiz", "use the equilibration by Ruiz",
       "slack-based", "use the slack values",
       "Determines the method used to compute symmetric scaling factors for the augmented system "
       "(see also the \"linear_scaling_on_demand\" option). "
       "This scaling is independent of the NLP problem scaling. "
       "By default, MC19 is only used if MA27 or MA57 are selected as linear solvers. "
-      "This value is only available if Ipopt has been compiled with MC19.");
+      "The value mc19 is only available if Ipopt has been compiled with MC19. "
+      "The Ruiz equilibration does not require HSL and can use several threads.");
 
    roptions->SetRegisteringCategory("NLP Scaling");
    roptions->AddStringOption4(
@@ -216,6 +239,23 @@ void AlgorithmBuilder::RegisterOptions(
       "penalty", "Standard penalty function",
       "Only the \"filter\" choice is officially supported. "
       "But sometimes, good results might be obtained with the other choices.");
+   roptions->SetRegisteringCategory("Step Calculation");
+   roptions->AddStringOption3(
+      "search_direction_method",
+      "Method for computing the search direction.",
+      "auto",
+      "auto", "the predictor-corrector step for quadratic programs, the primal-dual step otherwise",
+      "primal-dual", "the primal-dual step for the current barrier parameter",
+      "predictor-corrector", "Mehrotra's predictor-corrector step for the current barrier parameter",
+      "The predictor-corrector step adds a second-order correction to the primal-dual step, "
+      "for which the primal-dual system is solved with further right hand sides at the same factorization. "
+      "This usually reduces the number of iterations for LPs and convex QPs. "
+      "For \"auto\", the problem is considered a quadratic program if hessian_approximation is exact, "
+      "hessian_constant is enabled, and the Jacobians are constant, "
+      "because jac_c_constant and jac_d_constant are enabled or all constraints are declared linear by the TNLP. "
+      "It can be combined with any barrier parameter update; "
+      "if the affine step has already been computed by the \"probing\" oracle, it is reused. "
+      "The restoration phase and the \"cg-penalty\" line search always use the primal-dual step.");
    roptions->SetRegisteringCategory("Undocumented");
    roptions->AddStringOption2(
       "wsmp_iterative",
@@ -246,9 +286,47 @@ SmartPtr<SymLinearSolver> AlgorithmBuilder::SymLinearSolverFactory(
    const std::string&    prefix
 )
 {
-   SmartPtr<SparseSymLinearSolverInterface> SolverInterface;
+   bool linear_solver_autotune;
+   options.GetBoolValue("linear_solver_autotune", linear_solver_autotune, prefix);
+   if( linear_solver_autotune )
+   {
+      // create a linear solver for every configuration that is available
+      SmartPtr<AutoTuneSymLinearSolver> AutoTuneSolver = new AutoTuneSymLinearSolver();
+      std::vector<AutoTuneSymLinearSolver::Configuration> configs =
+         AutoTuneSymLinearSolver::CandidateConfigurations(options, prefix);
+      for( size_t i = 0; i < configs.size(); i++ )
+      {
+         OptionsList config_options(options);
+         if( !AutoTuneSymLinearSolver::SetConfigurationOptions(configs[i], config_options) )
+         {
+            continue;
+         }
+         try
+         {
+            AutoTuneSolver->AddCandidate(configs[i], TSymLinearSolverFactory(config_options, prefix, configs[i].linear_solver));
+         }
+         catch( OPTION_INVALID& )
+         {
+            // linear solver not available
+         }
+      }
+      ASSERT_EXCEPTION(AutoTuneSolver->NumCandidates() > 0, OPTION_INVALID,
+                       "None of the linear solvers for linear_solver_autotune is available.");
+      return GetRawPtr(AutoTuneSolver);
+   }
+
    std::string linear_solver;
    options.GetStringValue("linear_solver", linear_solver, prefix);
+   return TSymLinearSolverFactory(options, prefix, linear_solver);
+}
+
+SmartPtr<SymLinearSolver> AlgorithmBuilder::TSymLinearSolverFactory(
+   const OptionsList& options,
+   const std::string& prefix,
+   const std::string& linear_solver
+)
+{
+   SmartPtr<SparseSymLinearSolverInterface> SolverInterface;
    if( linear_solver == "ma27" )
    {
 #ifndef COINHSL_HAS_MA27
@@ -305,7 +383,9 @@ SmartPtr<SymLinearSolver> AlgorithmBuilder::SymLinearSolverFactory(
    }
    else if( linear_solver == "ma77" )
    {
-#ifndef COINHSL_HAS_MA77
+#if defined(IPOPT_INT64)
+      THROW_EXCEPTION(OPTION_INVALID, "HSL_MA77 does not support 64-bit integers.");
+#elif !defined(COINHSL_HAS_MA77)
 # ifdef IPOPT_HAS_LINEARSOLVERLOADER
       SolverInterface = new Ma77SolverInterface();
       if (!LSL_isMA77available())
@@ -332,7 +412,9 @@ SmartPtr<SymLinearSolver> AlgorithmBuilder::SymLinearSolverFactory(
    }
    else if( linear_solver == "ma86" )
    {
-#ifndef COINHSL_HAS_MA86
+#if defined(IPOPT_INT64)
+      THROW_EXCEPTION(OPTION_INVALID, "HSL_MA86 does not support 64-bit integers.");
+#elif !defined(COINHSL_HAS_MA86)
 # ifdef IPOPT_HAS_LINEARSOLVERLOADER
       SolverInterface = new Ma86SolverInterface();
       if (!LSL_isMA86available())
@@ -383,7 +465,9 @@ SmartPtr<SymLinearSolver> AlgorithmBuilder::SymLinearSolverFactory(
    }
    else if( linear_solver == "ma97" )
    {
-#ifndef COINHSL_HAS_MA97
+#if defined(IPOPT_INT64)
+      THROW_EXCEPTION(OPTION_INVALID, "HSL_MA97 does not support 64-bit integers.");
+#elif !defined(COINHSL_HAS_MA97)
 # ifdef IPOPT_HAS_LINEARSOLVERLOADER
       SolverInterface = new Ma97SolverInterface();
       if (!LSL_isMA97available())
@@ -437,11 +521,34 @@ SmartPtr<SymLinearSolver> AlgorithmBuilder::SymLinearSolverFactory(
 #endif
 
    }
+   else if( linear_solver == "cudss" )
+   {
+#ifdef IPOPT_HAS_CUDSS
+      SolverInterface = new CuDSSSolverInterface();
+#else
+
+      THROW_EXCEPTION(OPTION_INVALID, "Selected linear solver cuDSS not available.");
+#endif
+
+   }
+   else if( linear_solver == "lapack" )
+   {
+      SolverInterface = new LapackSolverInterface();
+   }
    else if( linear_solver == "custom" )
    {
       SolverInterface = NULL;
    }
 
+   // Small matrices are factorized as dense matrices, larger ones by
+   // the chosen sparse solver
+   Index dense_linear_solver_max_dim;
+   options.GetIntegerValue("dense_linear_solver_max_dim", dense_linear_solver_max_dim, prefix);
+   if( dense_linear_solver_max_dim > 0 && IsValid(SolverInterface) && linear_solver != "lapack" )
+   {
+      SolverInterface = new LapackSolverInterface(SolverInterface);
+   }
+
    SmartPtr<TSymScalingMethod> ScalingMethod;
    std::string linear_system_scaling;
    if( !options.GetStringValue("linear_system_scaling", linear_system_scaling, prefix) )
@@ -477,6 +584,10 @@ SmartPtr<SymLinearSolver> AlgorithmBuilder::SymLinearSolverFactory(
 #endif
 
    }
+   else if( linear_system_scaling == "ruiz" )
+   {
+      ScalingMethod = new RuizTSymScalingMethod();
+   }
    else if( linear_system_scaling == "slack-based" )
    {
       ScalingMethod = new SlackBasedTSymScalingMethod();
@@ -500,6 +611,28 @@ SmartPtr<AugSystemSolver> AlgorithmBuilder::GetAugSystemSolver(
    return AugSolver_;
 }
 
+SmartPtr<AugSystemPreconditioner> AlgorithmBuilder::AugSystemPreconditionerFactory(
+   const Journalist&     /*jnlst*/,
+   const OptionsList&    options,
+   const std::string&    prefix
+)
+{
+   SmartPtr<AugSystemPreconditioner> Precond;
+   std::string krylov_preconditioner;
+   options.GetStringValue("krylov_preconditioner", krylov_preconditioner, prefix);
+   if( krylov_preconditioner == "custom" )
+   {
+      ASSERT_EXCEPTION(IsValid(custom_preconditioner_), OPTION_INVALID,
+                       "Selected preconditioner CUSTOM not available.");
+      Precond = custom_preconditioner_;
+   }
+   else if( krylov_preconditioner == "diagonal" )
+   {
+      Precond = new DiagonalAugSystemPreconditioner();
+   }
+   return Precond;
+}
+
 SmartPtr<AugSystemSolver> AlgorithmBuilder::AugSystemSolverFactory(
    const Journalist&     jnlst,
    const OptionsList&    options,
@@ -507,6 +640,17 @@ SmartPtr<AugSystemSolver> AlgorithmBuilder::AugSystemSolverFactory(
 )
 {
    SmartPtr<AugSystemSolver> AugSolver;
+   Index enum_int;
+   options.GetEnumValue("hessian_approximation", enum_int, prefix);
+   HessianApproximationType hessian_approximation = HessianApproximationType(enum_int);
+   if( hessian_approximation == MATRIX_FREE )
+   {
+      // The Hessian is only available through products with vectors,
+      // so the augmented system cannot be factorized
+      AugSolver = new KrylovAugSystemSolver(AugSystemPreconditionerFactory(jnlst, options, prefix));
+      return AugSolver;
+   }
+
    std::string linear_solver;
    options.GetStringValue("linear_solver", linear_solver, prefix);
    if( linear_solver == "custom" )
@@ -517,11 +661,42 @@ SmartPtr<AugSystemSolver> AlgorithmBuilder::AugSystemSolverFactory(
    else
    {
       AugSolver = new StdAugSystemSolver(*GetSymLinearSolver(jnlst, options, prefix));
+
+      bool schur_complement_solver;
+      options.GetBoolValue("schur_complement_solver", schur_complement_solver, prefix);
+      Index num_blocks = 0;
+      if( schur_complement_solver && IsValid(nlp_) )
+      {
+         num_blocks = nlp_->GetNumberOfDiagonalBlocks();
+      }
+      if( num_blocks > 1 )
+      {
+         // one linear solver for each diagonal block; the solver for the
+         // whole system is used if the structure cannot be exploited
+         std::vector<SmartPtr<SymLinearSolver> > block_solvers(num_blocks);
+         for( Index k = 0; k < num_blocks; k++ )
+         {
+            block_solvers[k] = SymLinearSolverFactory(jnlst, options, prefix);
+         }
+         AugSolver = new SchurAugSystemSolver(*AugSolver, block_solvers);
+      }
+
+      bool diagonal_hessian_solver;
+      options.GetBoolValue("diagonal_hessian_solver", diagonal_hessian_solver, prefix);
+      if( diagonal_hessian_solver && hessian_approximation != LIMITED_MEMORY )
+      {
+         std::string diagonal_hessian_factorization;
+         options.GetStringValue("diagonal_hessian_factorization", diagonal_hessian_factorization, prefix);
+         SmartPtr<SymLinearSolver> schur_solver;
+         if( diagonal_hessian_factorization == "sparse" )
+         {
+            schur_solver = SymLinearSolverFactory(jnlst, options, prefix);
+         }
+         // the solver for the whole system is used if W is not diagonal
+         AugSolver = new DiagHessianAugSystemSolver(*AugSolver, schur_solver);
+      }
    }
 
-   Index enum_int;
-   options.GetEnumValue("hessian_approximation", enum_int, prefix);
-   HessianApproximationType hessian_approximation = HessianApproximationType(enum_int);
    if( hessian_approximation == LIMITED_MEMORY )
    {
       std::string lm_aug_solver;
@@ -532,6 +707,11 @@ SmartPtr<AugSystemSolver> AlgorithmBuilder::AugSystemSolverFactory(
       }
       else if( lm_aug_solver == "extended" )
       {
+         // The following option is registered by OrigIpoptNLP
+         bool exact_part;
+         options.GetBoolValue("hessian_approximation_exact_part", exact_part, prefix);
+         ASSERT_EXCEPTION(!exact_part, OPTION_INVALID,
+                          "hessian_approximation_exact_part=yes requires limited_memory_aug_solver=sherman-morrison.");
          Index lm_history;
          options.GetIntegerValue("limited_memory_max_history", lm_history, prefix);
          Index max_rank;
@@ -607,6 +787,8 @@ void AlgorithmBuilder::BuildIpoptObjects(
 {
    DBG_ASSERT(prefix == "");
 
+   nlp_ = nlp;
+
    SmartPtr<NLPScalingObject> nlp_scaling;
    std::string nlp_scaling_method;
    options.GetStringValue("nlp_scaling_method", nlp_scaling_method, "");
@@ -717,12 +899,20 @@ SmartPtr<HessianUpdater> AlgorithmBuilder::BuildHessianUpdater(
    switch( hessian_approximation )
    {
       case EXACT:
+      case MATRIX_FREE:
+      case FINDIFF_VALUES:
          HessUpdater = new ExactHessianUpdater();
          break;
       case LIMITED_MEMORY:
          // ToDo This needs to be replaced!
          HessUpdater = new LimMemQuasiNewtonUpdater(false);
          break;
+      case PARTITIONED:
+         HessUpdater = new PartitionedQuasiNewtonUpdater(false);
+         break;
+      case LAGGED_EXACT:
+         HessUpdater = new LaggedHessianUpdater();
+         break;
    }
    return HessUpdater;
 }
@@ -752,7 +942,21 @@ SmartPtr<SearchDirectionCalculator> AlgorithmBuilder::BuildSearchDirectionCalcul
    }
    else
    {
-      SearchDirCalc = new PDSearchDirCalculator(GetRawPtr(GetPDSystemSolver(jnlst, options, prefix)));
+      std::string sdmethod;
+      options.GetStringValue("search_direction_method", sdmethod, prefix);
+      if( sdmethod == "predictor-corrector" )
+      {
+         SearchDirCalc = new PredCorrSearchDirCalculator(GetRawPtr(GetPDSystemSolver(jnlst, options, prefix)));
+      }
+      else if( sdmethod == "auto" )
+      {
+         SmartPtr<PDSystemSolver> pd_solver = GetPDSystemSolver(jnlst, options, prefix);
+         SearchDirCalc = new PredCorrSearchDirCalculator(pd_solver, new PDSearchDirCalculator(pd_solver));
+      }
+      else
+      {
+         SearchDirCalc = new PDSearchDirCalculator(GetRawPtr(GetPDSystemSolver(jnlst, options, prefix)));
+      }
    }
    return SearchDirCalc;
 }
@@ -919,12 +1123,20 @@ SmartPtr<LineSearch> AlgorithmBuilder::BuildLineSearch(
       switch( hessian_approximation )
       {
          case EXACT:
+         case MATRIX_FREE:
+         case FINDIFF_VALUES:
+         case LAGGED_EXACT:
+            // the Hessian of the restoration phase includes the
+            // proximity term and is not reused
             resto_HessUpdater = new ExactHessianUpdater();
             break;
          case LIMITED_MEMORY:
             // ToDo This needs to be replaced!
             resto_HessUpdater = new LimMemQuasiNewtonUpdater(true);
             break;
+         case PARTITIONED:
+            resto_HessUpdater = new PartitionedQuasiNewtonUpdater(true);
+            break;
       }
 
       // Put together the overall restoration phase IP algorithm
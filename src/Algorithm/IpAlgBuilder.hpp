@@ -10,6 +10,7 @@
 #include "IpIpoptAlg.hpp"
 #include "IpReferenced.hpp"
 #include "IpAugSystemSolver.hpp"
+#include "IpAugSystemPreconditioner.hpp"
 #include "IpPDSystemSolver.hpp"
 
 namespace Ipopt
@@ -50,9 +51,14 @@ class IPOPTLIB_EXPORT AlgorithmBuilder: public ReferencedObject
 public:
    /**@name Constructors/Destructors */
    ///@{
-   /** Constructor */
+   /** Constructor
+    *
+    *  custom_preconditioner is used by the Krylov subspace method for
+    *  the augmented system if krylov_preconditioner is "custom".
+    */
    AlgorithmBuilder(
-      SmartPtr<AugSystemSolver> custom_solver = NULL
+      SmartPtr<AugSystemSolver>         custom_solver = NULL,
+      SmartPtr<AugSystemPreconditioner> custom_preconditioner = NULL
    );
 
    /** Destructor */
@@ -100,11 +106,23 @@ public:
       const std::string& prefix
    );
 
+   /** Create the preconditioner for the Krylov subspace method for
+    *  the augmented system, or NULL if no preconditioner is to be used.
+    *  Dependencies:
+    *     -> custom_preconditioner_
+    */
+   virtual SmartPtr<AugSystemPreconditioner> AugSystemPreconditionerFactory(
+      const Journalist&  jnlst,
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
    /** Create a solver that can be used to solve an
     *  augmented system.
     *  Dependencies:
     *     -> GetSymLinearSolver()
     *         -> SymLinearSolverFactory()
+    *     -> AugSystemPreconditionerFactory()
     *     -> custom_solver_
     */
    virtual SmartPtr<AugSystemSolver> AugSystemSolverFactory(
@@ -351,6 +369,14 @@ private:
    );
    ///@}
 
+   /** Create a TSymLinearSolver with the linear solver linear_solver
+    *  (a value of the option linear_solver). */
+   SmartPtr<SymLinearSolver> TSymLinearSolverFactory(
+      const OptionsList& options,
+      const std::string& prefix,
+      const std::string& linear_solver
+   );
+
    /** @name IpoptAlgorithm constructor arguments.
     *  These components are built in separate Build
     *  methods in the order defined by BuildBasicAlgorithm.
@@ -383,6 +409,14 @@ private:
     *  contructor, we will use this to solve the linear systems. */
    SmartPtr<AugSystemSolver> custom_solver_;
 
+   /** Optional pointer to AugSystemPreconditioner.  If this is set in
+    *  the constructor, it is used for krylov_preconditioner=custom. */
+   SmartPtr<AugSystemPreconditioner> custom_preconditioner_;
+
+   /** NLP given to BuildIpoptObjects.  It is used to query the block
+    *  structure for the Schur complement solver. */
+   SmartPtr<NLP> nlp_;
+
 };
 } // namespace Ipopt
 
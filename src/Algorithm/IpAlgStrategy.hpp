@@ -16,6 +16,9 @@
 namespace Ipopt
 {
 
+/* Forward declaration */
+class Checkpoint;
+
 /** This is the base class for all algorithm strategy objects.
  *
  *  The AlgorithmStrategyObject base class implements a common interface
@@ -116,6 +119,30 @@ public:
       return retval;
    }
 
+   /** Write the state of this strategy object to a checkpoint.
+    *
+    *  The state consists of everything apart from the options that is
+    *  needed to continue the optimization from the current iterate as
+    *  if it had not been interrupted.  It is written between two
+    *  iterations of the (regular) algorithm.  Strategy objects that own
+    *  other strategy objects pass the call on to them.  The default
+    *  implementation writes nothing.
+    */
+   virtual void WriteCheckpoint(
+      Checkpoint& /*checkpoint*/
+   ) const
+   { }
+
+   /** Restore the state that has been written by WriteCheckpoint.
+    *
+    *  This is called after Initialize, with the current iterate
+    *  already restored.
+    */
+   virtual void ReadCheckpoint(
+      Checkpoint& /*checkpoint*/
+   )
+   { }
+
 protected:
    /** Implementation of the initialization method that has to be
     *  overloaded by for each derived class.
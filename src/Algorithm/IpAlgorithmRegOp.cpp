@@ -17,15 +17,21 @@
 #include "IpIpoptAlg.hpp"
 #include "IpIpoptCalculatedQuantities.hpp"
 #include "IpIpoptData.hpp"
+#include "IpKrylovAugSystemSolver.hpp"
+#include "IpSchurAugSystemSolver.hpp"
+#include "IpDiagHessianAugSystemSolver.hpp"
 #include "IpMonotoneMuUpdate.hpp"
 #include "IpNLPScaling.hpp"
 #include "IpOptErrorConvCheck.hpp"
 #include "IpOrigIpoptNLP.hpp"
 #include "IpOrigIterationOutput.hpp"
 #include "IpLimMemQuasiNewtonUpdater.hpp"
+#include "IpPartitionedQuasiNewtonUpdater.hpp"
+#include "IpLaggedHessianUpdater.hpp"
 #include "IpPDFullSpaceSolver.hpp"
 #include "IpPDPerturbationHandler.hpp"
 #include "IpPDSearchDirCalc.hpp"
+#include "IpPredCorrSearchDirCalc.hpp"
 #include "IpPenaltyLSAcceptor.hpp"
 #include "IpProbingMuOracle.hpp"
 #include "IpQualityFunctionMuOracle.hpp"
@@ -67,8 +73,17 @@ void RegisterOptions_Algorithm(
    IpoptData::RegisterOptions(roptions);
    roptions->SetRegisteringCategory("Uncategorized");
    IpoptCalculatedQuantities::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Linear Solver");
+   KrylovAugSystemSolver::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Linear Solver");
+   SchurAugSystemSolver::RegisterOptions(roptions);
+   DiagHessianAugSystemSolver::RegisterOptions(roptions);
    roptions->SetRegisteringCategory("Hessian Approximation");
    LimMemQuasiNewtonUpdater::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Hessian Approximation");
+   PartitionedQuasiNewtonUpdater::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Hessian Approximation");
+   LaggedHessianUpdater::RegisterOptions(roptions);
    roptions->SetRegisteringCategory("Barrier Parameter Update");
    MonotoneMuUpdate::RegisterOptions(roptions);
    roptions->SetRegisteringCategory("Convergence");
@@ -80,6 +95,8 @@ void RegisterOptions_Algorithm(
    roptions->SetRegisteringCategory("Step Calculation");
    PDSearchDirCalculator::RegisterOptions(roptions);
    roptions->SetRegisteringCategory("Step Calculation");
+   PredCorrSearchDirCalculator::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Step Calculation");
    PDFullSpaceSolver::RegisterOptions(roptions);
    roptions->SetRegisteringCategory("Step Calculation");
    PDPerturbationHandler::RegisterOptions(roptions);
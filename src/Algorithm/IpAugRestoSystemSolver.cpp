@@ -240,7 +240,7 @@ ESymSolverStatus AugRestoSystemSolver::Solve(
    SmartPtr<const Matrix> J_cR = CJ_c->GetComp(0, 0);
    SmartPtr<const Vector> D_cR = Neg_Omega_c_plus_D_c(sigma_tilde_n_c_inv, sigma_tilde_p_c_inv, GetRawPtr(CD_c0),
                                  *Crhs_c0);
-   DBG_PRINT((1, "D_cR tag = %u\n", D_cR->GetTag()));
+   DBG_PRINT((1, "D_cR tag = %llu\n", D_cR->GetTag()));
    Number delta_cR = delta_c;
    SmartPtr<const Matrix> J_dR = CJ_d->GetComp(0, 0);
    SmartPtr<const Vector> D_dR = Neg_Omega_d_plus_D_d(*pd_l, sigma_tilde_n_d_inv, *neg_pd_u, sigma_tilde_p_d_inv,
@@ -264,16 +264,20 @@ ESymSolverStatus AugRestoSystemSolver::Solve(
    if( status == SYMSOLVER_SUCCESS )
    {
       // Now back out the solutions for the n and p variables
+      // The components are overwritten, so they are only set to zero
+      // if there is no contribution
       SmartPtr<Vector> sol_n_c = Csol_x->GetCompNonConst(1);
-      sol_n_c->Set(0.0);
       if( IsValid(sigma_tilde_n_c_inv) )
       {
          sol_n_c->AddTwoVectors(1., *Crhs_x->GetComp(1), -1.0, *sol_cR, 0.);
          sol_n_c->ElementWiseMultiply(*sigma_tilde_n_c_inv);
       }
+      else
+      {
+         sol_n_c->Set(0.0);
+      }
 
       SmartPtr<Vector> sol_p_c = Csol_x->GetCompNonConst(2);
-      sol_p_c->Set(0.0);
       if( IsValid(sigma_tilde_p_c_inv) )
       {
          DBG_PRINT_VECTOR(2, "rhs_pc", *Crhs_x->GetComp(2));
@@ -282,24 +286,34 @@ ESymSolverStatus AugRestoSystemSolver::Solve(
          sol_p_c->AddTwoVectors(1., *Crhs_x->GetComp(2), 1.0, *sol_cR, 0.);
          sol_p_c->ElementWiseMultiply(*sigma_tilde_p_c_inv);
       }
+      else
+      {
+         sol_p_c->Set(0.0);
+      }
 
       SmartPtr<Vector> sol_n_d = Csol_x->GetCompNonConst(3);
-      sol_n_d->Set(0.0);
       if( IsValid(sigma_tilde_n_d_inv) )
       {
          pd_l->TransMultVector(-1.0, *sol_dR, 0.0, *sol_n_d);
          sol_n_d->Axpy(1.0, *Crhs_x->GetComp(3));
          sol_n_d->ElementWiseMultiply(*sigma_tilde_n_d_inv);
       }
+      else
+      {
+         sol_n_d->Set(0.0);
+      }
 
       SmartPtr<Vector> sol_p_d = Csol_x->GetCompNonConst(4);
-      sol_p_d->Set(0.0);
       if( IsValid(sigma_tilde_p_d_inv) )
       {
          neg_pd_u->TransMultVector(-1.0, *sol_dR, 0.0, *sol_p_d);
          sol_p_d->Axpy(1.0, *Crhs_x->GetComp(4));
          sol_p_d->ElementWiseMultiply(*sigma_tilde_p_d_inv);
       }
+      else
+      {
+         sol_p_d->Set(0.0);
+      }
    }
 
    return status;
@@ -651,21 +665,18 @@ SmartPtr<const Vector> AugRestoSystemSolver::Rhs_cR(
    {
       DBG_PRINT((1, "Not found in cache\n"));
       retVec = rhs_c.MakeNew();
-      retVec->Copy(rhs_c);
-
-      SmartPtr<Vector> tmp = retVec->MakeNew();
       if( IsValid(sigma_tilde_n_c_inv) )
       {
-         tmp->Copy(*sigma_tilde_n_c_inv);
-         tmp->ElementWiseMultiply(rhs_n_c);
-         retVec->Axpy(-1.0, *tmp);
+         retVec->AddVectorProduct(1., rhs_c, -1., *sigma_tilde_n_c_inv, rhs_n_c, 0.);
+      }
+      else
+      {
+         retVec->Copy(rhs_c);
       }
 
       if( IsValid(sigma_tilde_p_c_inv) )
       {
-         tmp->Copy(*sigma_tilde_p_c_inv);
-         tmp->ElementWiseMultiply(rhs_p_c);
-         retVec->Axpy(1.0, *tmp);
+         retVec->AddVectorProduct(0., rhs_c, 1., *sigma_tilde_p_c_inv, rhs_p_c, 1.);
       }
       rhs_cR_cache_.AddCachedResult(retVec, deps, scalar_deps);
    }
@@ -701,18 +712,16 @@ SmartPtr<const Vector> AugRestoSystemSolver::Rhs_dR(
 
       if( IsValid(sigma_tilde_n_d_inv) )
       {
-         SmartPtr<Vector> tmpn = sigma_tilde_n_d_inv->MakeNew();
-         tmpn->Copy(*sigma_tilde_n_d_inv);
-         tmpn->ElementWiseMultiply(rhs_n_d);
-         pd_L.MultVector(-1.0, *tmpn, 1.0, *retVec);
+         Vector& tmpn = WorkVector(tmp_n_d_, *sigma_tilde_n_d_inv);
+         tmpn.AddVectorProduct(0., rhs_n_d, 1., *sigma_tilde_n_d_inv, rhs_n_d, 0.);
+         pd_L.MultVector(-1.0, tmpn, 1.0, *retVec);
       }
 
       if( IsValid(sigma_tilde_p_d_inv) )
       {
-         SmartPtr<Vector> tmpp = sigma_tilde_p_d_inv->MakeNew();
-         tmpp->Copy(*sigma_tilde_p_d_inv);
-         tmpp->ElementWiseMultiply(rhs_p_d);
-         neg_pd_U.MultVector(-1.0, *tmpp, 1.0, *retVec);
+         Vector& tmpp = WorkVector(tmp_p_d_, *sigma_tilde_p_d_inv);
+         tmpp.AddVectorProduct(0., rhs_p_d, 1., *sigma_tilde_p_d_inv, rhs_p_d, 0.);
+         neg_pd_U.MultVector(-1.0, tmpp, 1.0, *retVec);
       }
 
       rhs_dR_cache_.AddCachedResult(retVec, deps, scalar_deps);
@@ -720,4 +729,16 @@ SmartPtr<const Vector> AugRestoSystemSolver::Rhs_dR(
    return ConstPtr(retVec);
 }
 
+Vector& AugRestoSystemSolver::WorkVector(
+   SmartPtr<Vector>& work,
+   const Vector&     any_vec_in_space
+)
+{
+   if( IsNull(work) || work->OwnerSpace() != any_vec_in_space.OwnerSpace() )
+   {
+      work = any_vec_in_space.MakeNew();
+   }
+   return *work;
+}
+
 } // namespace Ipopt
@@ -145,6 +145,13 @@ private:
    CachedResults<SmartPtr<Vector> > rhs_dR_cache_;
    ///@}
 
+   /**@name Work space for intermediate vectors, which is kept between
+    * calls as long as the vector spaces do not change */
+   ///@{
+   SmartPtr<Vector> tmp_n_d_;
+   SmartPtr<Vector> tmp_p_d_;
+   ///@}
+
    /**@name Methods to calculate the cached quantities */
    ///@{
    SmartPtr<const Vector> Neg_Omega_c_plus_D_c(
@@ -213,6 +220,13 @@ private:
    );
    ///@}
 
+   /** Method returning the work vector, which is allocated in the space
+    *  of the given vector if it does not exist yet or lives in another space */
+   Vector& WorkVector(
+      SmartPtr<Vector>& work,
+      const Vector&     any_vec_in_space
+   );
+
    SmartPtr<AugSystemSolver> orig_aug_solver_;
    bool skip_orig_aug_solver_init_;
 };
@@ -0,0 +1,136 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IP_AUGSYSTEMPRECONDITIONER_HPP__
+#define __IP_AUGSYSTEMPRECONDITIONER_HPP__
+
+#include "IpSymMatrix.hpp"
+#include "IpAlgStrategy.hpp"
+
+namespace Ipopt
+{
+
+/** Base class for preconditioners of the augmented system.
+ *
+ *  A preconditioner is used by the Krylov subspace method in
+ *  KrylovAugSystemSolver to solve the augmented system
+ *
+ *  \f$\left[\begin{array}{cccc}
+ *  W + D_x + \delta_xI & 0 & J_c^T & J_d^T\\
+ *  0 & D_s + \delta_sI & 0 & -I \\
+ *  J_c & 0 & D_c - \delta_cI & 0\\
+ *  J_d & -I & 0 & D_d - \delta_dI
+ *  \end{array}\right]\f$
+ *
+ *  iteratively.  Before the Krylov method is started for a new
+ *  augmented system, UpdatePreconditioner is called with the
+ *  matrices of this system.  Then, ApplyPreconditioner is called in
+ *  each iteration to compute \f$z = M^{-1}r\f$ for the
+ *  preconditioner \f$M\f$.
+ *
+ *  The matrices might be available only through products with
+ *  vectors, e.g., W is a HessianProductMatrix if
+ *  hessian_approximation is "matrix-free".  A preconditioner that
+ *  requires the elements of a matrix, e.g., an algebraic multigrid or
+ *  block-Jacobi method, therefore has to obtain them elsewhere, e.g.,
+ *  from the NLP.
+ *
+ *  An object of a derived class can be provided to the
+ *  AlgorithmBuilder or InexactAlgorithmBuilder and is then used if
+ *  krylov_preconditioner is "custom".
+ */
+class IPOPTLIB_EXPORT AugSystemPreconditioner: public AlgorithmStrategyObject
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Default constructor. */
+   AugSystemPreconditioner()
+   { }
+
+   /** Destructor */
+   virtual ~AugSystemPreconditioner()
+   { }
+   ///@}
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   ) = 0;
+
+   /** Set up the preconditioner for a new augmented system.
+    *
+    *  The matrices and vectors are only valid until the Krylov method
+    *  has finished for all right hand sides of this system.  D_x, D_s,
+    *  D_c, or D_d may be NULL, which means that they are zero.  W may
+    *  be NULL, which means that W_factor is zero.
+    *
+    *  @return false if the preconditioner could not be computed
+    */
+   virtual bool UpdatePreconditioner(
+      const SymMatrix* W,
+      double           W_factor,
+      const Vector*    D_x,
+      double           delta_x,
+      const Vector*    D_s,
+      double           delta_s,
+      const Matrix*    J_c,
+      const Vector*    D_c,
+      double           delta_c,
+      const Matrix*    J_d,
+      const Vector*    D_d,
+      double           delta_d
+   ) = 0;
+
+   /** Apply the inverse of the preconditioner to the vector
+    *  (r_x, r_s, r_c, r_d) and store the result in (z_x, z_s, z_c, z_d).
+    */
+   virtual void ApplyPreconditioner(
+      const Vector& r_x,
+      const Vector& r_s,
+      const Vector& r_c,
+      const Vector& r_d,
+      Vector&       z_x,
+      Vector&       z_s,
+      Vector&       z_c,
+      Vector&       z_d
+   ) = 0;
+
+   /** Whether the preconditioner is symmetric positive definite.
+    *
+    *  MINRES requires a symmetric positive definite preconditioner.
+    *  For other preconditioners, e.g., indefinite constraint
+    *  preconditioners, GMRES is used.
+    */
+   virtual bool IsPositiveDefinite() const
+   {
+      return true;
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   AugSystemPreconditioner(
+      const AugSystemPreconditioner&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const AugSystemPreconditioner&
+   );
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
@@ -174,6 +174,25 @@ public:
     */
    virtual bool ProvidesInertia() const = 0;
 
+   /** Query whether the backward error of the solutions is computed
+    *  by the linear solver.
+    */
+   virtual bool ProvidesBackwardError() const
+   {
+      return false;
+   }
+
+   /** Componentwise backward error of the solutions of the augmented
+    *  system in the most recent solve.
+    *
+    * @note This must not be called if the linear solver does not compute
+    * this quantity (see ProvidesBackwardError).
+    */
+   virtual Number BackwardError() const
+   {
+      return -1.;
+   }
+
    /** Request to increase quality of solution for next solve.
     *
     *  Asks underlying linear solver to increase quality of solution for
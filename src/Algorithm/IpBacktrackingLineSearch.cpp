@@ -10,6 +10,7 @@
 #include "IpJournalist.hpp"
 #include "IpRestoPhase.hpp"
 #include "IpAlgTypes.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 #include <limits>
@@ -79,6 +80,20 @@ void BacktrackingLineSearch::RegisterOptions(
       -1,
       -1,
       "Even if it does not satisfy line search conditions.");
+   roptions->AddLowerBoundedIntegerOption(
+      "concurrent_trial_points",
+      "Number of trial step sizes for which the functions are evaluated at the same time.",
+      1,
+      1,
+      "If this is larger than one and the first trial point of the backtracking line search has been rejected, "
+      "then the objective and constraint functions are requested from the NLP for this number of "
+      "successively shorter trial step sizes at once, which allows the NLP to evaluate them concurrently. "
+      "If Ipopt has been build with OpenMP support and a TNLP declares with get_evaluation_concurrency "
+      "that it can be evaluated concurrently, then its eval_f and eval_g are called at different points "
+      "in parallel from several threads. "
+      "The accepted trial point is the same as when the trial points are evaluated one after the other, "
+      "but the functions may be evaluated at more trial points. "
+      "This option is ignored while magic steps or the watchdog procedure are active.");
 
    roptions->AddStringOption10(
       "alpha_for_y",
@@ -198,6 +213,7 @@ bool BacktrackingLineSearch::InitializeImpl(
    options.GetBoolValue("magic_steps", magic_steps_, prefix);
    options.GetBoolValue("accept_every_trial_step", accept_every_trial_step_, prefix);
    options.GetIntegerValue("accept_after_max_steps", accept_after_max_steps_, prefix);
+   options.GetIntegerValue("concurrent_trial_points", concurrent_trial_points_, prefix);
    Index enum_int;
    bool is_default = !options.GetEnumValue("alpha_for_y", enum_int, prefix);
    alpha_for_y_ = AlphaForYEnum(enum_int);
@@ -254,7 +270,7 @@ void BacktrackingLineSearch::FindAcceptableTrialPoint()
    DBG_START_METH("BacktrackingLineSearch::FindAcceptableTrialPoint",
                   dbg_verbosity);
    Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                  "--> Starting line search in iteration %d <--\n", IpData().iter_count());
+                  "--> Starting line search in iteration %" IPOPT_INDEX_FORMAT " <--\n", IpData().iter_count());
 
    Number curr_mu = IpData().curr_mu();
    if( last_mu_ != curr_mu )
@@ -383,14 +399,8 @@ void BacktrackingLineSearch::FindAcceptableTrialPoint()
 
       // Evaluate functions at trial point - if that fails, don't use
       // the tiny step and continue with regular line search
-      try
-      {
-         IpCq().trial_barrier_obj();
-         IpCq().trial_constraint_violation();
-      }
-      catch( IpoptNLP::Eval_Error& e )
+      if( !IpNLP().EvaluateFunctions(*IpData().trial()->x()) )
       {
-         e.ReportException(Jnlst(), J_DETAILED);
          tiny_step = false;
       }
 
@@ -573,7 +583,7 @@ void BacktrackingLineSearch::FindAcceptableTrialPoint()
                if( found_acceptable )
                {
                   Jnlst().Printf(J_WARNING, J_LINE_SEARCH,
-                                 "Restoration phase is called at almost feasible point,\n  but acceptable point from iteration %d could be restored.\n",
+                                 "Restoration phase is called at almost feasible point,\n  but acceptable point from iteration %" IPOPT_INDEX_FORMAT " could be restored.\n",
                                  acceptable_iteration_number_);
                   THROW_EXCEPTION(ACCEPTABLE_POINT_REACHED,
                                   "Restoration phase called at almost feasible point, but acceptable point could be restored.\n");
@@ -596,7 +606,20 @@ void BacktrackingLineSearch::FindAcceptableTrialPoint()
             IpData().Set_info_alpha_primal_char('R');
             IpData().Set_info_ls_count(n_steps + 1);
 
-            accept = resto_phase_->PerformRestoration();
+            // the restoration phase has its own IpoptData, so time it here
+            TimedTask& resto_timing =
+               IpData().TimingStats().NamedTask("OverallAlgorithm/ComputeAcceptableTrialPoint/RestorationPhase");
+            resto_timing.Start();
+            try
+            {
+               accept = resto_phase_->PerformRestoration();
+            }
+            catch( ... )
+            {
+               resto_timing.EndIfStarted();
+               throw;
+            }
+            resto_timing.End();
             if( !accept )
             {
                bool found_acceptable = RestoreAcceptablePoint();
@@ -645,9 +668,9 @@ void BacktrackingLineSearch::FindAcceptableTrialPoint()
 
       if( expect_infeasible_problem_ && IpCq().curr_constraint_violation() <= expect_infeasible_problem_ctol_ )
       {
-         Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                        "Constraint violation is with %e less than expect_infeasible_problem_ctol.\nDisable expect_infeasible_problem_heuristic.\n",
-                        IpCq().curr_constraint_violation());
+         IPOPT_JNLST_PRINTF(Jnlst(), J_DETAILED, J_LINE_SEARCH,
+                            "Constraint violation is with %e less than expect_infeasible_problem_ctol.\nDisable expect_infeasible_problem_heuristic.\n",
+                            IpCq().curr_constraint_violation());
          expect_infeasible_problem_ = false;
       }
 
@@ -733,10 +756,14 @@ bool BacktrackingLineSearch::DoBacktrackingLineSearch(
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
                         "Starting checks for alpha (primal) = %8.2e\n", alpha_primal);
 
+         bool trial_evaluation_error = false;
          try
          {
             // Compute the primal trial point
-            IpData().SetTrialPrimalVariablesFromStep(alpha_primal, *actual_delta->x(), *actual_delta->s());
+            if( !SetSpeculativeTrialPoint(alpha_primal, alpha_min, n_steps, *actual_delta) )
+            {
+               IpData().SetTrialPrimalVariablesFromStep(alpha_primal, *actual_delta->x(), *actual_delta->s());
+            }
 
             if( magic_steps_ )
             {
@@ -745,14 +772,15 @@ bool BacktrackingLineSearch::DoBacktrackingLineSearch(
 
             // If it is acceptable, stop the search
             alpha_primal_test = alpha_primal;
-            if( accept_every_trial_step_ || (accept_after_max_steps_ != -1 && n_steps >= accept_after_max_steps_) )
+            if( !IpNLP().EvaluateFunctions(*IpData().trial()->x()) )
+            {
+               // Evaluation errors at trial points are expected, so they
+               // are checked here without an exception
+               trial_evaluation_error = true;
+            }
+            else if( accept_every_trial_step_
+                     || (accept_after_max_steps_ != -1 && n_steps >= accept_after_max_steps_) )
             {
-               // We call the evaluation at the trial point here, so that an
-               // exception will the thrown if there are problem during the
-               // evaluation of the functions (in that case, we want to further
-               // reduce the step size
-               IpCq().trial_barrier_obj();
-               IpCq().trial_constraint_violation();
                IpData().Append_info_string("MaxS");
                Reset();
                accept = true;
@@ -765,6 +793,11 @@ bool BacktrackingLineSearch::DoBacktrackingLineSearch(
          catch( IpoptNLP::Eval_Error& e )
          {
             e.ReportException(Jnlst(), J_DETAILED);
+            trial_evaluation_error = true;
+         }
+
+         if( trial_evaluation_error )
+         {
             Jnlst().Printf(J_WARNING, J_LINE_SEARCH,
                            "Warning: Cutting back alpha due to evaluation error\n");
             IpData().Append_info_string("e");
@@ -818,6 +851,10 @@ bool BacktrackingLineSearch::DoBacktrackingLineSearch(
       }
    } /* if (!accept) */
 
+   speculative_alpha_.clear();
+   speculative_x_.clear();
+   speculative_s_.clear();
+
    char info_alpha_primal_char = '?';
    if( !accept && in_watchdog_ )
    {
@@ -841,6 +878,63 @@ bool BacktrackingLineSearch::DoBacktrackingLineSearch(
    return accept;
 }
 
+bool BacktrackingLineSearch::SetSpeculativeTrialPoint(
+   Number                alpha_primal,
+   Number                alpha_min,
+   Index                 n_steps,
+   const IteratesVector& delta
+)
+{
+   // The first trial point is accepted most of the time, so we only
+   // start to evaluate several trial points after it has been rejected
+   if( concurrent_trial_points_ <= 1 || n_steps == 0 || magic_steps_ || in_watchdog_ || accept_every_trial_step_ )
+   {
+      return false;
+   }
+
+   Index j = 0;
+   while( j < (Index) speculative_alpha_.size() && speculative_alpha_[j] != alpha_primal )
+   {
+      j++;
+   }
+   if( j == (Index) speculative_alpha_.size() )
+   {
+      // Compute the next step sizes that the backtracking would try,
+      // and let the NLP evaluate the functions at all trial points
+      speculative_alpha_.clear();
+      speculative_x_.clear();
+      speculative_s_.clear();
+      SmartPtr<const Vector> curr_x = IpData().curr()->x();
+      SmartPtr<const Vector> curr_s = IpData().curr()->s();
+      Number alpha = alpha_primal;
+      for( Index i = 0; i < concurrent_trial_points_ && alpha > alpha_min; i++ )
+      {
+         if( accept_after_max_steps_ != -1 && n_steps + i > accept_after_max_steps_ )
+         {
+            break;
+         }
+         SmartPtr<Vector> x = curr_x->MakeNew();
+         x->AddTwoVectors(1., *curr_x, alpha, *delta.x(), 0.);
+         SmartPtr<Vector> s = curr_s->MakeNew();
+         s->AddTwoVectors(1., *curr_s, alpha, *delta.s(), 0.);
+         speculative_alpha_.push_back(alpha);
+         speculative_x_.push_back(ConstPtr(x));
+         speculative_s_.push_back(ConstPtr(s));
+         alpha *= alpha_red_factor_;
+      }
+      IpNLP().PrecomputeFunctions(speculative_x_);
+      j = 0;
+   }
+
+   // This is the same trial point as computed by SetTrialPrimalVariablesFromStep
+   SmartPtr<IteratesVector> trial = IpData().trial()->MakeNewContainer();
+   trial->Set_x(*speculative_x_[j]);
+   trial->Set_s(*speculative_s_[j]);
+   IpData().set_trial(trial);
+
+   return true;
+}
+
 void BacktrackingLineSearch::StartWatchDog()
 {
    DBG_START_FUN("BacktrackingLineSearch::StartWatchDog", dbg_verbosity);
@@ -895,6 +989,25 @@ void BacktrackingLineSearch::Reset()
    acceptor_->Reset();
 }
 
+void BacktrackingLineSearch::ResetAfterScalingUpdate()
+{
+   DBG_START_METH("BacktrackingLineSearch::ResetAfterScalingUpdate", dbg_verbosity);
+
+   if( in_watchdog_ )
+   {
+      in_watchdog_ = false;
+      watchdog_iterate_ = NULL;
+      watchdog_delta_ = NULL;
+      watchdog_shortened_iter_ = 0;
+      acceptor_->StopWatchDog();
+   }
+
+   acceptable_iterate_ = NULL;
+   acceptable_iteration_number_ = -1;
+
+   Reset();
+}
+
 void BacktrackingLineSearch::PerformDualStep(
    Number                    alpha_primal,
    Number                    alpha_dual,
@@ -1069,7 +1182,7 @@ void BacktrackingLineSearch::PerformMagicStep()
       {
          IpData().Append_info_string("M");
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                        "Magic step with max-norm %.6e taken.\n", delta_s_magic->Amax());
+                        "Magic step with max-norm %.6e taken.\n", delta_s_magic_max);
          delta_s_magic->Print(Jnlst(), J_MOREVECTOR, J_LINE_SEARCH, "delta_s_magic");
       }
 
@@ -1129,15 +1242,12 @@ bool BacktrackingLineSearch::TrySoftRestoStep(
 
       // Check if that point is acceptable with respect to the current
       // original filter
-      try
+      if( IpNLP().EvaluateFunctions(*IpData().trial()->x()) )
       {
-         IpCq().trial_barrier_obj();
-         IpCq().trial_constraint_violation();
          done = true;
       }
-      catch( IpoptNLP::Eval_Error& e )
+      else
       {
-         e.ReportException(Jnlst(), J_DETAILED);
          Jnlst().Printf(J_WARNING, J_LINE_SEARCH,
                         "Warning: Evaluation error during soft restoration phase step.\n");
          IpData().Append_info_string("e");
@@ -1307,4 +1417,63 @@ bool BacktrackingLineSearch::ActivateFallbackMechanism()
    return true;
 }
 
+void BacktrackingLineSearch::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   checkpoint.WriteSection("BacktrackingLineSearch");
+   checkpoint.WriteBool(in_watchdog_);
+   checkpoint.WriteIndex(watchdog_shortened_iter_);
+   checkpoint.WriteIndex(watchdog_trial_iter_);
+   checkpoint.WriteNumber(watchdog_alpha_primal_test_);
+   checkpoint.WriteIterates(watchdog_iterate_);
+   checkpoint.WriteIterates(watchdog_delta_);
+   checkpoint.WriteNumber(last_mu_);
+   checkpoint.WriteIterates(acceptable_iterate_);
+   checkpoint.WriteIndex(acceptable_iteration_number_);
+   checkpoint.WriteBool(fallback_activated_);
+   checkpoint.WriteBool(rigorous_);
+   checkpoint.WriteBool(skipped_line_search_);
+   checkpoint.WriteBool(in_soft_resto_phase_);
+   checkpoint.WriteIndex(soft_resto_counter_);
+   checkpoint.WriteIndex(count_successive_shortened_steps_);
+   checkpoint.WriteBool(tiny_step_last_iteration_);
+
+   // the convergence check is shared with the algorithm, which writes its state
+   acceptor_->WriteCheckpoint(checkpoint);
+   if( IsValid(resto_phase_) )
+   {
+      resto_phase_->WriteCheckpoint(checkpoint);
+   }
+}
+
+void BacktrackingLineSearch::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("BacktrackingLineSearch");
+   in_watchdog_ = checkpoint.ReadBool();
+   watchdog_shortened_iter_ = checkpoint.ReadIndex();
+   watchdog_trial_iter_ = checkpoint.ReadIndex();
+   watchdog_alpha_primal_test_ = checkpoint.ReadNumber();
+   watchdog_iterate_ = ConstPtr(checkpoint.ReadIterates(*IpData().curr()));
+   watchdog_delta_ = ConstPtr(checkpoint.ReadIterates(*IpData().curr()));
+   last_mu_ = checkpoint.ReadNumber();
+   acceptable_iterate_ = ConstPtr(checkpoint.ReadIterates(*IpData().curr()));
+   acceptable_iteration_number_ = checkpoint.ReadIndex();
+   fallback_activated_ = checkpoint.ReadBool();
+   rigorous_ = checkpoint.ReadBool();
+   skipped_line_search_ = checkpoint.ReadBool();
+   in_soft_resto_phase_ = checkpoint.ReadBool();
+   soft_resto_counter_ = checkpoint.ReadIndex();
+   count_successive_shortened_steps_ = checkpoint.ReadIndex();
+   tiny_step_last_iteration_ = checkpoint.ReadBool();
+
+   acceptor_->ReadCheckpoint(checkpoint);
+   if( IsValid(resto_phase_) )
+   {
+      resto_phase_->ReadCheckpoint(checkpoint);
+   }
+}
+
 } // namespace Ipopt
@@ -14,6 +14,8 @@
 #include "IpRestoPhase.hpp"
 #include "IpConvCheck.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 
@@ -78,6 +80,13 @@ public:
     */
    virtual void Reset();
 
+   /** Reset the line search after the NLP has been rescaled.
+    *
+    *  In addition to Reset(), this leaves the watchdog procedure
+    *  and forgets the stored acceptable iterate.
+    */
+   virtual void ResetAfterScalingUpdate();
+
    /** Set flag indicating whether a very rigorous line search should
     *  be performed.
     *
@@ -112,6 +121,16 @@ public:
     */
    virtual bool ActivateFallbackMechanism();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    /** Methods for OptionsList */
    ///@{
    static void RegisterOptions(
@@ -253,6 +272,22 @@ private:
     *  violation. */
    void PerformMagicStep();
 
+   /** Method for setting the trial point for alpha_primal from the
+    *  trial points for which the functions have been evaluated at the
+    *  same time.
+    *
+    *  If alpha_primal is not among them, a new set of trial points
+    *  for alpha_primal and the following step sizes is computed.
+    *
+    *  @return false if the trial point has to be computed as usual
+    */
+   bool SetSpeculativeTrialPoint(
+      Number                alpha_primal,
+      Number                alpha_min,
+      Index                 n_steps,
+      const IteratesVector& delta
+   );
+
    /** Detect if the search direction is too small.
     *
     *  This should be
@@ -340,6 +375,10 @@ private:
     *  even if it is not satisfying acceptance criteria.
     */
    Index accept_after_max_steps_;
+   /** Number of trial step sizes for which the functions are
+    *  evaluated at the same time.
+    */
+   Index concurrent_trial_points_;
    /** Indicates whether problem can be expected to be infeasible.
     *
     *  This will trigger requesting a tighter reduction in
@@ -390,6 +429,15 @@ private:
    ///@{
    /** Flag indicating if the watchdog is active */
    bool in_watchdog_;
+
+   /** @name Trial points for which the functions have been evaluated
+    *  at the same time (see SetSpeculativeTrialPoint)
+    */
+   ///@{
+   std::vector<Number> speculative_alpha_;
+   std::vector<SmartPtr<const Vector> > speculative_x_;
+   std::vector<SmartPtr<const Vector> > speculative_s_;
+   ///@}
    /** Counter for shortened iterations. */
    Index watchdog_shortened_iter_;
    /** Counter for watch dog iterations */
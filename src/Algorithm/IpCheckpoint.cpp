@@ -0,0 +1,360 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpCheckpoint.hpp"
+#include "IpAlgTypes.hpp"
+#include "IpIteratesVector.hpp"
+#include "IpDenseVector.hpp"
+#include "IpCompoundVector.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace Ipopt
+{
+
+/** Identification of a checkpoint file at its beginning */
+static const char checkpoint_magic[8] = { 'I', 'P', 'O', 'P', 'T', 'C', 'K', 'P' };
+
+/** Version of the checkpoint format, to be increased whenever the
+ *  state written by any object changes */
+static const Index checkpoint_version = 3;
+
+Checkpoint::Checkpoint()
+   : file_(NULL),
+     writing_(false),
+     write_failed_(false)
+{ }
+
+Checkpoint::~Checkpoint()
+{
+   Close();
+}
+
+void Checkpoint::Close()
+{
+   if( file_ == NULL )
+   {
+      return;
+   }
+   std::fclose(file_);
+   file_ = NULL;
+   if( writing_ )
+   {
+      // the checkpoint has not been committed
+      std::remove((filename_ + ".tmp").c_str());
+   }
+   writing_ = false;
+}
+
+bool Checkpoint::OpenForWriting(
+   const std::string& filename
+)
+{
+   Close();
+   filename_ = filename;
+   file_ = std::fopen((filename_ + ".tmp").c_str(), "wb");
+   if( file_ == NULL )
+   {
+      return false;
+   }
+   writing_ = true;
+   write_failed_ = false;
+
+   WriteBytes(checkpoint_magic, sizeof(checkpoint_magic));
+   WriteIndex(checkpoint_version);
+   WriteIndex((Index) sizeof(Number));
+   WriteIndex((Index) sizeof(Index));
+   return true;
+}
+
+bool Checkpoint::Commit()
+{
+   DBG_ASSERT(writing_);
+   if( file_ == NULL )
+   {
+      return false;
+   }
+   if( std::fclose(file_) != 0 )
+   {
+      write_failed_ = true;
+   }
+   file_ = NULL;
+   writing_ = false;
+
+   std::string tmpname = filename_ + ".tmp";
+   if( !write_failed_ && std::rename(tmpname.c_str(), filename_.c_str()) != 0 )
+   {
+      // rename does not replace an existing file on some systems
+      std::remove(filename_.c_str());
+      write_failed_ = std::rename(tmpname.c_str(), filename_.c_str()) != 0;
+   }
+   if( write_failed_ )
+   {
+      std::remove(tmpname.c_str());
+   }
+   return !write_failed_;
+}
+
+bool Checkpoint::OpenForReading(
+   const std::string& filename
+)
+{
+   Close();
+   filename_ = filename;
+   file_ = std::fopen(filename_.c_str(), "rb");
+   if( file_ == NULL )
+   {
+      return false;
+   }
+
+   char magic[sizeof(checkpoint_magic)];
+   Index header[3];
+   if( std::fread(magic, 1, sizeof(magic), file_) != sizeof(magic)
+       || std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0
+       || std::fread(header, sizeof(Index), 3, file_) != 3
+       || header[0] != checkpoint_version || header[1] != (Index) sizeof(Number) || header[2] != (Index) sizeof(Index) )
+   {
+      Close();
+      return false;
+   }
+   return true;
+}
+
+void Checkpoint::Error(
+   const std::string& msg
+) const
+{
+   THROW_EXCEPTION(INVALID_WARMSTART, "Checkpoint file " + filename_ + ": " + msg);
+}
+
+void Checkpoint::WriteBytes(
+   const void* data,
+   std::size_t size
+)
+{
+   DBG_ASSERT(writing_);
+   if( !write_failed_ && std::fwrite(data, 1, size, file_) != size )
+   {
+      write_failed_ = true;
+   }
+}
+
+void Checkpoint::ReadBytes(
+   void*       data,
+   std::size_t size
+)
+{
+   DBG_ASSERT(file_ != NULL && !writing_);
+   if( std::fread(data, 1, size, file_) != size )
+   {
+      Error("unexpected end of file.");
+   }
+}
+
+void Checkpoint::WriteSection(
+   const std::string& name
+)
+{
+   WriteString(name);
+}
+
+void Checkpoint::WriteNumber(
+   Number value
+)
+{
+   WriteBytes(&value, sizeof(value));
+}
+
+void Checkpoint::WriteIndex(
+   Index value
+)
+{
+   WriteBytes(&value, sizeof(value));
+}
+
+void Checkpoint::WriteBool(
+   bool value
+)
+{
+   char c = value ? 1 : 0;
+   WriteBytes(&c, 1);
+}
+
+void Checkpoint::WriteString(
+   const std::string& value
+)
+{
+   WriteIndex((Index) value.size());
+   WriteBytes(value.data(), value.size());
+}
+
+void Checkpoint::WriteNumbers(
+   Index         n,
+   const Number* values
+)
+{
+   WriteIndex(n);
+   WriteBytes(values, n * sizeof(Number));
+}
+
+void Checkpoint::WriteVector(
+   const Vector& vector
+)
+{
+   const DenseVector* dense = dynamic_cast<const DenseVector*>(&vector);
+   if( dense != NULL )
+   {
+      WriteIndex(dense->Dim());
+      WriteBool(dense->IsHomogeneous());
+      if( dense->IsHomogeneous() )
+      {
+         WriteNumber(dense->Scalar());
+      }
+      else
+      {
+         WriteBytes(dense->Values(), dense->Dim() * sizeof(Number));
+      }
+      return;
+   }
+
+   const CompoundVector* compound = dynamic_cast<const CompoundVector*>(&vector);
+   if( compound == NULL )
+   {
+      // vectors of other types cannot be written
+      write_failed_ = true;
+      return;
+   }
+   WriteIndex(compound->NComps());
+   for( Index i = 0; i < compound->NComps(); i++ )
+   {
+      if( compound->IsCompNull(i) )
+      {
+         write_failed_ = true;
+         return;
+      }
+      WriteVector(*compound->GetComp(i));
+   }
+}
+
+void Checkpoint::WriteIterates(
+   const SmartPtr<const IteratesVector>& iterates
+)
+{
+   WriteBool(IsValid(iterates));
+   if( IsValid(iterates) )
+   {
+      WriteVector(*iterates);
+   }
+}
+
+void Checkpoint::ReadSection(
+   const std::string& name
+)
+{
+   std::string found = ReadString();
+   if( found != name )
+   {
+      Error("expected the state of " + name + ", but found " + found
+            + ". The checkpoint has been written with different options.");
+   }
+}
+
+Number Checkpoint::ReadNumber()
+{
+   Number value;
+   ReadBytes(&value, sizeof(value));
+   return value;
+}
+
+Index Checkpoint::ReadIndex()
+{
+   Index value;
+   ReadBytes(&value, sizeof(value));
+   return value;
+}
+
+bool Checkpoint::ReadBool()
+{
+   char c;
+   ReadBytes(&c, 1);
+   return c != 0;
+}
+
+std::string Checkpoint::ReadString()
+{
+   Index len = ReadIndex();
+   // names of sections and info strings are short
+   if( len < 0 || len > 1000000 )
+   {
+      Error("invalid string length.");
+   }
+   std::vector<char> chars(len);
+   if( len > 0 )
+   {
+      ReadBytes(&chars[0], len);
+   }
+   return std::string(chars.begin(), chars.end());
+}
+
+void Checkpoint::ReadNumbers(
+   Index   n,
+   Number* values
+)
+{
+   if( ReadIndex() != n )
+   {
+      Error("the number of stored values does not match.");
+   }
+   ReadBytes(values, n * sizeof(Number));
+}
+
+void Checkpoint::ReadVector(
+   Vector& vector
+)
+{
+   DenseVector* dense = dynamic_cast<DenseVector*>(&vector);
+   if( dense != NULL )
+   {
+      if( ReadIndex() != dense->Dim() )
+      {
+         Error("the dimension of a vector does not match the problem.");
+      }
+      if( ReadBool() )
+      {
+         dense->Set(ReadNumber());
+      }
+      else
+      {
+         ReadBytes(dense->Values(), dense->Dim() * sizeof(Number));
+      }
+      return;
+   }
+
+   CompoundVector* compound = dynamic_cast<CompoundVector*>(&vector);
+   DBG_ASSERT(compound != NULL);
+   if( compound == NULL || ReadIndex() != compound->NComps() )
+   {
+      Error("the structure of a vector does not match the problem.");
+   }
+   for( Index i = 0; i < compound->NComps(); i++ )
+   {
+      ReadVector(*compound->GetCompNonConst(i));
+   }
+}
+
+SmartPtr<IteratesVector> Checkpoint::ReadIterates(
+   const IteratesVector& prototype
+)
+{
+   if( !ReadBool() )
+   {
+      return NULL;
+   }
+   SmartPtr<IteratesVector> iterates = prototype.MakeNewIteratesVector(true);
+   ReadVector(*iterates);
+   return iterates;
+}
+
+} // namespace Ipopt
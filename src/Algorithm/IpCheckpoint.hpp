@@ -0,0 +1,225 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPCHECKPOINT_HPP__
+#define __IPCHECKPOINT_HPP__
+
+#include "IpUtils.hpp"
+#include "IpSmartPtr.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace Ipopt
+{
+
+/* Forward declarations */
+class Vector;
+class IteratesVector;
+
+/** Binary file with the state of the algorithm, from which an
+ *  interrupted optimization can be continued.
+ *
+ *  The state consists of sections, one for each object that has a
+ *  state (see AlgorithmStrategyObject::WriteCheckpoint).  Each section
+ *  starts with the name of the object, which is checked when the
+ *  checkpoint is read, so that a checkpoint that has been written with
+ *  a different algorithm configuration is rejected.  Likewise, the
+ *  dimensions of the vectors are checked.  Apart from that, the
+ *  problem and the options must be the same as for the run that wrote
+ *  the checkpoint.
+ *
+ *  A checkpoint is first written to a temporary file, which replaces
+ *  the checkpoint file only when it is complete, so that the previous
+ *  checkpoint survives if the process is killed while writing.
+ *
+ *  Numbers are written in their native binary representation, so a
+ *  checkpoint can only be read on a machine of the same architecture
+ *  and by a build of Ipopt with the same Number and Index types.
+ *
+ *  Errors while reading a checkpoint are reported by an
+ *  INVALID_WARMSTART exception.  Errors while writing are only
+ *  reported by the return value of Commit.
+ */
+class IPOPTLIB_EXPORT Checkpoint
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Default Constructor */
+   Checkpoint();
+
+   /** Destructor, which discards an uncommitted checkpoint */
+   ~Checkpoint();
+   ///@}
+
+   /** Start writing a checkpoint that replaces the file filename when
+    *  it is committed.
+    *
+    *  @return false, if the temporary file cannot be opened
+    */
+   bool OpenForWriting(
+      const std::string& filename
+   );
+
+   /** Finish writing the checkpoint and replace the checkpoint file.
+    *
+    *  @return false, if an error occurred while writing
+    */
+   bool Commit();
+
+   /** Open a checkpoint for reading.
+    *
+    *  @return false, if the file cannot be opened or is not a
+    *  checkpoint of this version of Ipopt
+    */
+   bool OpenForReading(
+      const std::string& filename
+   );
+
+   /** Name of the checkpoint file */
+   const std::string& FileName() const
+   {
+      return filename_;
+   }
+
+   /** @name Methods for writing */
+   ///@{
+   /** Start the section of the state of an object */
+   void WriteSection(
+      const std::string& name
+   );
+
+   void WriteNumber(
+      Number value
+   );
+
+   void WriteIndex(
+      Index value
+   );
+
+   void WriteBool(
+      bool value
+   );
+
+   void WriteString(
+      const std::string& value
+   );
+
+   void WriteNumbers(
+      Index         n,
+      const Number* values
+   );
+
+   /** Write a vector.
+    *
+    *  Only DenseVectors and CompoundVectors of supported vectors can
+    *  be written; for other vectors, Commit fails.
+    */
+   void WriteVector(
+      const Vector& vector
+   );
+
+   /** Write iterates, which might be NULL */
+   void WriteIterates(
+      const SmartPtr<const IteratesVector>& iterates
+   );
+   ///@}
+
+   /** @name Methods for reading */
+   ///@{
+   /** Read the start of the section of an object, which must be the
+    *  one with the given name
+    */
+   void ReadSection(
+      const std::string& name
+   );
+
+   Number ReadNumber();
+
+   Index ReadIndex();
+
+   bool ReadBool();
+
+   std::string ReadString();
+
+   void ReadNumbers(
+      Index   n,
+      Number* values
+   );
+
+   /** Read the values of a vector, which must have the structure of
+    *  the vector that has been written
+    */
+   void ReadVector(
+      Vector& vector
+   );
+
+   /** Read iterates that have been written by WriteIterates.
+    *
+    *  The iterates are created with the structure of prototype.
+    *
+    *  @return the iterates, or NULL, if NULL has been written
+    */
+   SmartPtr<IteratesVector> ReadIterates(
+      const IteratesVector& prototype
+   );
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   Checkpoint(
+      const Checkpoint&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const Checkpoint&
+   );
+   ///@}
+
+   void WriteBytes(
+      const void* data,
+      std::size_t size
+   );
+
+   void ReadBytes(
+      void*       data,
+      std::size_t size
+   );
+
+   /** Throw an INVALID_WARMSTART exception for the checkpoint file */
+   void Error(
+      const std::string& msg
+   ) const;
+
+   /** Close the file and remove an uncommitted temporary file */
+   void Close();
+
+   /** Checkpoint file */
+   std::string filename_;
+
+   /** Open file, NULL if no file is open */
+   std::FILE* file_;
+
+   /** Whether the file is open for writing */
+   bool writing_;
+
+   /** Whether an error occurred while writing */
+   bool write_failed_;
+};
+
+} // namespace Ipopt
+
+#endif
@@ -0,0 +1,857 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpDiagHessianAugSystemSolver.hpp"
+#include "IpTripletHelper.hpp"
+#include "IpLapack.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+/** Set values to the elements of D plus delta, or to delta if D is NULL. */
+static void FillDiagonal(
+   Index         dim,
+   const Vector* D,
+   double        delta,
+   Number*       values
+)
+{
+   if( D )
+   {
+      TripletHelper::FillValuesFromVector(dim, *D, values);
+      for( Index i = 0; i < dim; i++ )
+      {
+         values[i] += delta;
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < dim; i++ )
+      {
+         values[i] = delta;
+      }
+   }
+}
+
+DiagHessianAugSystemSolver::DiagHessianAugSystemSolver(
+   AugSystemSolver&                 fallback_solver,
+   const SmartPtr<SymLinearSolver>& schur_solver
+)
+   : AugSystemSolver(),
+     fallback_solver_(&fallback_solver),
+     structure_initialized_(false),
+     w_diagonal_(false),
+     n_x_(0),
+     n_s_(0),
+     n_c_(0),
+     n_d_(0),
+     nnz_W_(0),
+     nnz_J_c_(0),
+     nnz_J_d_(0),
+     have_factorization_(false),
+     use_fallback_(false),
+     use_cholesky_(false),
+     negevals_(-1),
+     negevals_h_(0),
+     schur_solver_(schur_solver),
+     use_sparse_(false),
+     w_tag_(0),
+     w_factor_(0.),
+     d_x_tag_(0),
+     delta_x_(0.),
+     d_s_tag_(0),
+     delta_s_(0.),
+     j_c_tag_(0),
+     d_c_tag_(0),
+     delta_c_(0.),
+     j_d_tag_(0),
+     d_d_tag_(0),
+     delta_d_(0.)
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::DiagHessianAugSystemSolver()", dbg_verbosity);
+}
+
+DiagHessianAugSystemSolver::~DiagHessianAugSystemSolver()
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::~DiagHessianAugSystemSolver()", dbg_verbosity);
+}
+
+void DiagHessianAugSystemSolver::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddStringOption2(
+      "diagonal_hessian_solver",
+      "Whether to solve the augmented system by a dense Schur complement if the Hessian is diagonal.",
+      "no",
+      "no", "factorize the augmented system as a whole",
+      "yes", "eliminate the primal variables if the Hessian of the Lagrangian is diagonal",
+      "If the sparsity structure of the Hessian of the Lagrangian is diagonal, e.g., for separable problems, "
+      "the primal variables are eliminated from the augmented system, "
+      "and the dense Schur complement, whose dimension is the number of constraints, is factorized by LAPACK. "
+      "This is efficient if there are few constraints compared to the number of variables. "
+      "If the Hessian is not diagonal, the augmented system is factorized by the selected linear solver. "
+      "This option is ignored for a limited-memory Hessian approximation.");
+   roptions->AddStringOption2(
+      "diagonal_hessian_factorization",
+      "Factorization of the Schur complement for a diagonal Hessian.",
+      "dense",
+      "dense", "dense Cholesky factorization or eigenvalue decomposition by LAPACK",
+      "sparse", "sparse factorization by the selected linear solver",
+      "Determines how the Schur complement of the primal variables is factorized if diagonal_hessian_solver is enabled. "
+      "The sparse Schur complement has the sparsity structure of the product of the constraint Jacobian with its transpose "
+      "and is positive definite if the augmented system has the required inertia, "
+      "so that it can be factorized without pivoting. "
+      "It is only used if there are not more constraints than variables.");
+}
+
+bool DiagHessianAugSystemSolver::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   // the structure is analyzed again in the next call of MultiSolve
+   structure_initialized_ = false;
+   w_diagonal_ = false;
+   have_factorization_ = false;
+   use_sparse_ = false;
+   schur_matrix_ = NULL;
+   y_space_ = NULL;
+
+   if( !fallback_solver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix) )
+   {
+      return false;
+   }
+
+   if( IsValid(schur_solver_) )
+   {
+      return schur_solver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+   }
+
+   return true;
+}
+
+void DiagHessianAugSystemSolver::InitializeSparseSchur()
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::InitializeSparseSchur", dbg_verbosity);
+
+   const Index m = n_c_ + n_d_;
+   const Index nnz_J = nnz_J_c_ + nnz_J_d_;
+
+   // Sort the elements of J by rows
+   row_start_.assign(m + 1, 0);
+   for( Index e = 0; e < nnz_J; e++ )
+   {
+      row_start_[jac_row_[e] + 1]++;
+   }
+   for( Index i = 0; i < m; i++ )
+   {
+      row_start_[i + 1] += row_start_[i];
+   }
+   row_entry_.resize(nnz_J);
+   std::vector<Index> next(row_start_.begin(), row_start_.end() - 1);
+   for( Index e = 0; e < nnz_J; e++ )
+   {
+      row_entry_[next[jac_row_[e]]++] = e;
+   }
+
+   // Row i of the lower triangle of J J^T has an element in column
+   // k <= i if the rows i and k of J have a common column
+   std::vector<Index> marker(m, -1);
+   schur_row_start_.resize(m + 1);
+   schur_col_.clear();
+   schur_diag_pos_.resize(m);
+   for( Index i = 0; i < m; i++ )
+   {
+      schur_row_start_[i] = (Index) schur_col_.size();
+      schur_diag_pos_[i] = (Index) schur_col_.size();
+      schur_col_.push_back(i);
+      marker[i] = i;
+      for( Index p = row_start_[i]; p < row_start_[i + 1]; p++ )
+      {
+         const Index j = jac_col_[row_entry_[p]];
+         for( Index q = col_start_[j]; q < col_start_[j + 1]; q++ )
+         {
+            const Index k = jac_row_[col_entry_[q]];
+            if( k < i && marker[k] != i )
+            {
+               marker[k] = i;
+               schur_col_.push_back(k);
+            }
+         }
+      }
+   }
+   const Index nnz_S = (Index) schur_col_.size();
+   schur_row_start_[m] = nnz_S;
+
+   std::vector<Index> irows(nnz_S);
+   std::vector<Index> jcols(nnz_S);
+   for( Index i = 0; i < m; i++ )
+   {
+      for( Index p = schur_row_start_[i]; p < schur_row_start_[i + 1]; p++ )
+      {
+         irows[p] = i + 1;
+         jcols[p] = schur_col_[p] + 1;
+      }
+   }
+   SmartPtr<SymTMatrixSpace> space = new SymTMatrixSpace(m, nnz_S, &irows[0], &jcols[0]);
+   schur_matrix_ = space->MakeNewSymTMatrix();
+   schur_values_.resize(nnz_S);
+   y_space_ = new DenseVectorSpace(m);
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Diagonal Hessian solver: sparse Schur complement with %" IPOPT_INDEX_FORMAT " nonzeros in the lower triangle.\n", nnz_S);
+}
+
+void DiagHessianAugSystemSolver::FillSparseSchur(
+   const Vector* D_c,
+   double        delta_c,
+   const Vector* D_d,
+   double        delta_d
+)
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::FillSparseSchur", dbg_verbosity);
+
+   // Row i of the lower triangle of J H_x^{-1} J^T is accumulated in
+   // work and then gathered into the elements of the row
+   const Index m = n_c_ + n_d_;
+   std::vector<Number> work(m, 0.);
+   for( Index i = 0; i < m; i++ )
+   {
+      for( Index p = row_start_[i]; p < row_start_[i + 1]; p++ )
+      {
+         const Index e1 = row_entry_[p];
+         const Index j = jac_col_[e1];
+         const Number v1 = jac_val_[e1] * inv_h_x_[j];
+         for( Index q = col_start_[j]; q < col_start_[j + 1]; q++ )
+         {
+            const Index e2 = col_entry_[q];
+            const Index k = jac_row_[e2];
+            if( k <= i )
+            {
+               work[k] += v1 * jac_val_[e2];
+            }
+         }
+      }
+      for( Index p = schur_row_start_[i]; p < schur_row_start_[i + 1]; p++ )
+      {
+         schur_values_[p] = work[schur_col_[p]];
+         work[schur_col_[p]] = 0.;
+      }
+   }
+
+   std::vector<Number> diag(Max(n_c_, n_d_));
+   if( n_c_ > 0 )
+   {
+      FillDiagonal(n_c_, D_c, -delta_c, &diag[0]);
+      for( Index i = 0; i < n_c_; i++ )
+      {
+         schur_values_[schur_diag_pos_[i]] -= diag[i];
+      }
+   }
+   if( n_d_ > 0 )
+   {
+      FillDiagonal(n_d_, D_d, -delta_d, &diag[0]);
+      for( Index i = 0; i < n_d_; i++ )
+      {
+         schur_values_[schur_diag_pos_[n_c_ + i]] += inv_h_s_[i] - diag[i];
+      }
+   }
+
+   schur_matrix_->SetValues(&schur_values_[0]);
+}
+
+void DiagHessianAugSystemSolver::InitializeStructure(
+   const SymMatrix& W,
+   const Matrix&    J_c,
+   const Matrix&    J_d
+)
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::InitializeStructure", dbg_verbosity);
+
+   w_diagonal_ = false;
+   use_sparse_ = false;
+   have_factorization_ = false;
+
+   n_x_ = J_c.NCols();
+   n_s_ = J_d.NRows();
+   n_c_ = J_c.NRows();
+   n_d_ = J_d.NRows();
+
+   nnz_W_ = TripletHelper::GetNumberEntries(W);
+   std::vector<Index> irows(nnz_W_);
+   std::vector<Index> jcols(nnz_W_);
+   if( nnz_W_ > 0 )
+   {
+      TripletHelper::FillRowCol(nnz_W_, W, &irows[0], &jcols[0]);
+   }
+   w_row_.resize(nnz_W_);
+   for( Index e = 0; e < nnz_W_; e++ )
+   {
+      if( irows[e] != jcols[e] )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "The Hessian is not diagonal, the augmented system is factorized as a whole.\n");
+         return;
+      }
+      w_row_[e] = irows[e] - 1;
+   }
+
+   // Rows and columns of the elements of J = [J_c; J_d]
+   nnz_J_c_ = TripletHelper::GetNumberEntries(J_c);
+   nnz_J_d_ = TripletHelper::GetNumberEntries(J_d);
+   const Index nnz_J = nnz_J_c_ + nnz_J_d_;
+   jac_row_.resize(nnz_J);
+   jac_col_.resize(nnz_J);
+   if( nnz_J_c_ > 0 )
+   {
+      TripletHelper::FillRowCol(nnz_J_c_, J_c, &jac_row_[0], &jac_col_[0], -1, -1);
+   }
+   if( nnz_J_d_ > 0 )
+   {
+      TripletHelper::FillRowCol(nnz_J_d_, J_d, &jac_row_[nnz_J_c_], &jac_col_[nnz_J_c_], n_c_ - 1, -1);
+   }
+
+   // Sort the elements by columns
+   col_start_.assign(n_x_ + 1, 0);
+   for( Index e = 0; e < nnz_J; e++ )
+   {
+      col_start_[jac_col_[e] + 1]++;
+   }
+   for( Index j = 0; j < n_x_; j++ )
+   {
+      col_start_[j + 1] += col_start_[j];
+   }
+   col_entry_.resize(nnz_J);
+   std::vector<Index> next(col_start_.begin(), col_start_.end() - 1);
+   for( Index e = 0; e < nnz_J; e++ )
+   {
+      col_entry_[next[jac_col_[e]]++] = e;
+   }
+
+   inv_h_x_.resize(n_x_);
+   inv_h_s_.resize(n_s_);
+   jac_val_.resize(nnz_J);
+
+   if( IsValid(schur_solver_) && n_c_ + n_d_ > 0 )
+   {
+      if( n_c_ + n_d_ > n_x_ )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "More constraints than variables, the augmented system is factorized as a whole.\n");
+         return;
+      }
+      InitializeSparseSchur();
+      use_sparse_ = true;
+   }
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Diagonal Hessian solver: %" IPOPT_INDEX_FORMAT " variables, %s Schur complement of dimension %" IPOPT_INDEX_FORMAT ".\n", n_x_ + n_s_,
+                  use_sparse_ ? "sparse" : "dense", n_c_ + n_d_);
+   w_diagonal_ = true;
+}
+
+bool DiagHessianAugSystemSolver::AugmentedSystemRequiresChange(
+   const SymMatrix* W,
+   double           W_factor,
+   const Vector*    D_x,
+   double           delta_x,
+   const Vector*    D_s,
+   double           delta_s,
+   const Matrix&    J_c,
+   const Vector*    D_c,
+   double           delta_c,
+   const Matrix&    J_d,
+   const Vector*    D_d,
+   double           delta_d
+)
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::AugmentedSystemRequiresChange", dbg_verbosity);
+
+   // the values of W do not matter if it is not used
+   TaggedObject::Tag w_tag = (W && W_factor != 0.) ? W->GetTag() : 0;
+   double w_factor = W ? W_factor : 0.;
+
+   return w_tag != w_tag_ || w_factor != w_factor_ || (D_x ? D_x->GetTag() : 0) != d_x_tag_ || delta_x != delta_x_
+          || (D_s ? D_s->GetTag() : 0) != d_s_tag_ || delta_s != delta_s_ || J_c.GetTag() != j_c_tag_
+          || (D_c ? D_c->GetTag() : 0) != d_c_tag_ || delta_c != delta_c_ || J_d.GetTag() != j_d_tag_
+          || (D_d ? D_d->GetTag() : 0) != d_d_tag_ || delta_d != delta_d_;
+}
+
+ESymSolverStatus DiagHessianAugSystemSolver::Factorize(
+   const SymMatrix* W,
+   double           W_factor,
+   const Vector*    D_x,
+   double           delta_x,
+   const Vector*    D_s,
+   double           delta_s,
+   const Matrix&    J_c,
+   const Vector*    D_c,
+   double           delta_c,
+   const Matrix&    J_d,
+   const Vector*    D_d,
+   double           delta_d
+)
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::Factorize", dbg_verbosity);
+
+   have_factorization_ = false;
+   use_fallback_ = false;
+
+   // Diagonals of the primal blocks
+   if( n_x_ > 0 )
+   {
+      FillDiagonal(n_x_, D_x, delta_x, &inv_h_x_[0]);
+   }
+   if( W && W_factor != 0. && nnz_W_ > 0 )
+   {
+      DBG_ASSERT(TripletHelper::GetNumberEntries(*W) == nnz_W_);
+      std::vector<Number> w_val(nnz_W_);
+      TripletHelper::FillValues(nnz_W_, *W, &w_val[0]);
+      for( Index e = 0; e < nnz_W_; e++ )
+      {
+         inv_h_x_[w_row_[e]] += W_factor * w_val[e];
+      }
+   }
+   if( n_s_ > 0 )
+   {
+      FillDiagonal(n_s_, D_s, delta_s, &inv_h_s_[0]);
+   }
+
+   Index negevals_h = 0;
+   for( Index i = 0; i < n_x_ + n_s_; i++ )
+   {
+      Number& h = i < n_x_ ? inv_h_x_[i] : inv_h_s_[i - n_x_];
+      if( h == 0. )
+      {
+         // the primal variables cannot be eliminated
+         use_fallback_ = true;
+         break;
+      }
+      if( h < 0. )
+      {
+         negevals_h++;
+      }
+      h = 1. / h;
+   }
+
+   if( !use_fallback_ )
+   {
+      if( nnz_J_c_ > 0 )
+      {
+         TripletHelper::FillValues(nnz_J_c_, J_c, &jac_val_[0]);
+      }
+      if( nnz_J_d_ > 0 )
+      {
+         TripletHelper::FillValues(nnz_J_d_, J_d, &jac_val_[nnz_J_c_]);
+      }
+      negevals_h_ = negevals_h;
+   }
+
+   if( !use_fallback_ && use_sparse_ )
+   {
+      // S is factorized by schur_solver_ in the next solve, which
+      // gives the inertia
+      FillSparseSchur(D_c, delta_c, D_d, delta_d);
+      negevals_ = -1;
+   }
+   else if( !use_fallback_ )
+   {
+      // Schur complement S = J H_x^{-1} J^T + diag(delta_c - D_c, H_s^{-1} + delta_d - D_d)
+      const Index m = n_c_ + n_d_;
+      std::vector<Number> schur((size_t) m * m, 0.);
+      for( Index j = 0; j < n_x_; j++ )
+      {
+         for( Index p = col_start_[j]; p < col_start_[j + 1]; p++ )
+         {
+            const Index e1 = col_entry_[p];
+            const Index r1 = jac_row_[e1];
+            const Number v1 = jac_val_[e1] * inv_h_x_[j];
+            for( Index q = col_start_[j]; q <= p; q++ )
+            {
+               const Index e2 = col_entry_[q];
+               const Index r2 = jac_row_[e2];
+               const Number val = v1 * jac_val_[e2];
+               if( p == q )
+               {
+                  schur[r1 + r1 * m] += val;
+               }
+               else if( r1 == r2 )
+               {
+                  schur[r1 + r1 * m] += 2. * val;
+               }
+               else
+               {
+                  schur[r1 + r2 * m] += val;
+                  schur[r2 + r1 * m] += val;
+               }
+            }
+         }
+      }
+      std::vector<Number> diag(Max(n_c_, n_d_));
+      if( n_c_ > 0 )
+      {
+         FillDiagonal(n_c_, D_c, -delta_c, &diag[0]);
+         for( Index i = 0; i < n_c_; i++ )
+         {
+            schur[i + i * m] -= diag[i];
+         }
+      }
+      if( n_d_ > 0 )
+      {
+         FillDiagonal(n_d_, D_d, -delta_d, &diag[0]);
+         for( Index i = 0; i < n_d_; i++ )
+         {
+            const Index k = n_c_ + i;
+            schur[k + k * m] += inv_h_s_[i] - diag[i];
+         }
+      }
+
+      // If the primal blocks are positive definite, the augmented
+      // system has the required inertia if and only if S is positive
+      // definite
+      Index posevals_schur = m;
+      use_cholesky_ = false;
+      if( negevals_h == 0 && m > 0 )
+      {
+         schur_ = schur;
+         Index info;
+         IpLapackDpotrf(m, &schur_[0], m, info);
+         use_cholesky_ = (info == 0);
+      }
+      if( !use_cholesky_ && m > 0 )
+      {
+         schur_.swap(schur);
+         schur_evals_.resize(m);
+         Index info;
+         IpLapackDsyev(true, m, &schur_[0], m, &schur_evals_[0], info, schur_work_);
+         if( info != 0 )
+         {
+            Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                           "Eigenvalue decomposition of the Schur complement failed with info = %" IPOPT_INDEX_FORMAT ".\n", info);
+            return SYMSOLVER_FATAL_ERROR;
+         }
+
+         Number max_abs = 0.;
+         for( Index i = 0; i < m; i++ )
+         {
+            max_abs = Max(max_abs, std::abs(schur_evals_[i]));
+         }
+         const Number tol = m * std::numeric_limits<Number>::epsilon() * max_abs;
+         posevals_schur = 0;
+         for( Index i = 0; i < m; i++ )
+         {
+            if( std::abs(schur_evals_[i]) <= tol )
+            {
+               Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                              "Schur complement is singular.\n");
+               return SYMSOLVER_SINGULAR;
+            }
+            if( schur_evals_[i] > 0. )
+            {
+               posevals_schur++;
+            }
+         }
+      }
+
+      // the Schur complement of the primal blocks in the augmented system is -S
+      negevals_ = negevals_h + posevals_schur;
+
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Diagonal Hessian solver: %" IPOPT_INDEX_FORMAT " negative eigenvalues, %" IPOPT_INDEX_FORMAT " of them in the primal blocks; %s.\n", negevals_,
+                     negevals_h, use_cholesky_ ? "Cholesky factorization" : "eigenvalue decomposition");
+   }
+   else
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Diagonal Hessian solver: zero entry in the primal blocks, the augmented system is factorized as a whole.\n");
+   }
+
+   w_tag_ = (W && W_factor != 0.) ? W->GetTag() : 0;
+   w_factor_ = W ? W_factor : 0.;
+   d_x_tag_ = D_x ? D_x->GetTag() : 0;
+   delta_x_ = delta_x;
+   d_s_tag_ = D_s ? D_s->GetTag() : 0;
+   delta_s_ = delta_s;
+   j_c_tag_ = J_c.GetTag();
+   d_c_tag_ = D_c ? D_c->GetTag() : 0;
+   delta_c_ = delta_c;
+   j_d_tag_ = J_d.GetTag();
+   d_d_tag_ = D_d ? D_d->GetTag() : 0;
+   delta_d_ = delta_d;
+   have_factorization_ = true;
+
+   return SYMSOLVER_SUCCESS;
+}
+
+ESymSolverStatus DiagHessianAugSystemSolver::MultiSolve(
+   const SymMatrix*                      W,
+   double                                W_factor,
+   const Vector*                         D_x,
+   double                                delta_x,
+   const Vector*                         D_s,
+   double                                delta_s,
+   const Matrix*                         J_c,
+   const Vector*                         D_c,
+   double                                delta_c,
+   const Matrix*                         J_d,
+   const Vector*                         D_d,
+   double                                delta_d,
+   std::vector<SmartPtr<const Vector> >& rhs_xV,
+   std::vector<SmartPtr<const Vector> >& rhs_sV,
+   std::vector<SmartPtr<const Vector> >& rhs_cV,
+   std::vector<SmartPtr<const Vector> >& rhs_dV,
+   std::vector<SmartPtr<Vector> >&       sol_xV,
+   std::vector<SmartPtr<Vector> >&       sol_sV,
+   std::vector<SmartPtr<Vector> >&       sol_cV,
+   std::vector<SmartPtr<Vector> >&       sol_dV,
+   bool                                  check_NegEVals,
+   Index                                 numberOfNegEVals
+)
+{
+   DBG_START_METH("DiagHessianAugSystemSolver::MultiSolve", dbg_verbosity);
+   DBG_ASSERT(J_c && J_d && "Currently, you MUST specify J_c and J_d in the augmented system");
+
+   if( !structure_initialized_ )
+   {
+      DBG_ASSERT(W);// W must exist during the first call to setup the structure!
+      InitializeStructure(*W, *J_c, *J_d);
+      structure_initialized_ = true;
+   }
+
+   if( w_diagonal_
+       && (!have_factorization_
+           || AugmentedSystemRequiresChange(W, W_factor, D_x, delta_x, D_s, delta_s, *J_c, D_c, delta_c, *J_d, D_d,
+                                            delta_d)) )
+   {
+      ESymSolverStatus retval = Factorize(W, W_factor, D_x, delta_x, D_s, delta_s, *J_c, D_c, delta_c, *J_d, D_d,
+                                          delta_d);
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         return retval;
+      }
+   }
+
+   if( !w_diagonal_ || use_fallback_ )
+   {
+      return fallback_solver_->MultiSolve(W, W_factor, D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d,
+                                          rhs_xV, rhs_sV, rhs_cV, rhs_dV, sol_xV, sol_sV, sol_cV, sol_dV, check_NegEVals, numberOfNegEVals);
+   }
+
+   if( check_NegEVals && !use_sparse_ && negevals_ != numberOfNegEVals )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Wrong inertia: required are %" IPOPT_INDEX_FORMAT ", but we got %" IPOPT_INDEX_FORMAT ".\n", numberOfNegEVals, negevals_);
+      return SYMSOLVER_WRONG_INERTIA;
+   }
+
+   const Index nrhs = (Index) rhs_xV.size();
+   const Index m = n_c_ + n_d_;
+   const Index nnz_J = nnz_J_c_ + nnz_J_d_;
+   std::vector<Number> x(n_x_);
+   std::vector<Number> s(n_s_);
+   std::vector<Number> r_d(n_d_);
+   std::vector<Number> tmp(m);
+
+   // right hand sides y = J H_x^{-1} r_x - [r_c; r_d + H_s^{-1} r_s]
+   // of the Schur complement
+   std::vector<std::vector<Number> > yV(nrhs, std::vector<Number>(m));
+   for( Index irhs = 0; irhs < nrhs; irhs++ )
+   {
+      std::vector<Number>& y = yV[irhs];
+      if( n_x_ > 0 )
+      {
+         TripletHelper::FillValuesFromVector(n_x_, *rhs_xV[irhs], &x[0]);
+      }
+      for( Index i = 0; i < n_x_; i++ )
+      {
+         x[i] *= inv_h_x_[i];
+      }
+      if( n_s_ > 0 )
+      {
+         TripletHelper::FillValuesFromVector(n_s_, *rhs_sV[irhs], &s[0]);
+      }
+      if( n_c_ > 0 )
+      {
+         TripletHelper::FillValuesFromVector(n_c_, *rhs_cV[irhs], &y[0]);
+      }
+      if( n_d_ > 0 )
+      {
+         TripletHelper::FillValuesFromVector(n_d_, *rhs_dV[irhs], &r_d[0]);
+      }
+      for( Index i = 0; i < n_c_; i++ )
+      {
+         y[i] = -y[i];
+      }
+      for( Index i = 0; i < n_d_; i++ )
+      {
+         y[n_c_ + i] = -r_d[i] - inv_h_s_[i] * s[i];
+      }
+      for( Index e = 0; e < nnz_J; e++ )
+      {
+         y[jac_row_[e]] += jac_val_[e] * x[jac_col_[e]];
+      }
+   }
+
+   // multipliers y = S^{-1} y
+   if( use_sparse_ )
+   {
+      // all right hand sides are solved with one call, which
+      // factorizes S if it has changed
+      std::vector<SmartPtr<const Vector> > schur_rhsV(nrhs);
+      std::vector<SmartPtr<Vector> > schur_solV(nrhs);
+      for( Index irhs = 0; irhs < nrhs; irhs++ )
+      {
+         SmartPtr<DenseVector> rhs = y_space_->MakeNewDenseVector();
+         rhs->SetValues(&yV[irhs][0]);
+         schur_rhsV[irhs] = GetRawPtr(rhs);
+         schur_solV[irhs] = y_space_->MakeNewDenseVector();
+      }
+      ESymSolverStatus retval = schur_solver_->MultiSolve(*schur_matrix_, schur_rhsV, schur_solV, false, 0);
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Factorization of the sparse Schur complement failed with retval = %d\n", retval);
+         return retval;
+      }
+
+      // the Schur complement of the primal blocks in the augmented system is -S
+      if( schur_solver_->ProvidesInertia() )
+      {
+         negevals_ = negevals_h_ + m - schur_solver_->NumberOfNegEVals();
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Diagonal Hessian solver: %" IPOPT_INDEX_FORMAT " negative eigenvalues, %" IPOPT_INDEX_FORMAT " of them in the primal blocks; sparse factorization.\n",
+                        negevals_, negevals_h_);
+         if( check_NegEVals && negevals_ != numberOfNegEVals )
+         {
+            Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                           "Wrong inertia: required are %" IPOPT_INDEX_FORMAT ", but we got %" IPOPT_INDEX_FORMAT ".\n", numberOfNegEVals, negevals_);
+            return SYMSOLVER_WRONG_INERTIA;
+         }
+      }
+      for( Index irhs = 0; irhs < nrhs; irhs++ )
+      {
+         TripletHelper::FillValuesFromVector(m, *schur_solV[irhs], &yV[irhs][0]);
+      }
+   }
+   else if( m > 0 )
+   {
+      for( Index irhs = 0; irhs < nrhs; irhs++ )
+      {
+         std::vector<Number>& y = yV[irhs];
+         if( use_cholesky_ )
+         {
+            IpLapackDpotrs(m, 1, &schur_[0], m, &y[0], m);
+         }
+         else
+         {
+            for( Index j = 0; j < m; j++ )
+            {
+               Number val = 0.;
+               for( Index i = 0; i < m; i++ )
+               {
+                  val += schur_[i + j * m] * y[i];
+               }
+               tmp[j] = val / schur_evals_[j];
+            }
+            for( Index i = 0; i < m; i++ )
+            {
+               Number val = 0.;
+               for( Index j = 0; j < m; j++ )
+               {
+                  val += schur_[i + j * m] * tmp[j];
+               }
+               y[i] = val;
+            }
+         }
+      }
+   }
+
+   for( Index irhs = 0; irhs < nrhs; irhs++ )
+   {
+      // x = H_x^{-1} (r_x - J^T y), s = H_s^{-1} (r_s + y_d)
+      const std::vector<Number>& y = yV[irhs];
+      if( n_x_ > 0 )
+      {
+         TripletHelper::FillValuesFromVector(n_x_, *rhs_xV[irhs], &x[0]);
+      }
+      if( n_s_ > 0 )
+      {
+         TripletHelper::FillValuesFromVector(n_s_, *rhs_sV[irhs], &s[0]);
+      }
+      for( Index j = 0; j < n_x_; j++ )
+      {
+         Number val = 0.;
+         for( Index p = col_start_[j]; p < col_start_[j + 1]; p++ )
+         {
+            const Index e = col_entry_[p];
+            val += jac_val_[e] * y[jac_row_[e]];
+         }
+         x[j] = inv_h_x_[j] * (x[j] - val);
+      }
+      for( Index i = 0; i < n_s_; i++ )
+      {
+         s[i] = inv_h_s_[i] * (s[i] + y[n_c_ + i]);
+      }
+
+      if( n_x_ > 0 )
+      {
+         TripletHelper::PutValuesInVector(n_x_, &x[0], *sol_xV[irhs]);
+      }
+      if( n_s_ > 0 )
+      {
+         TripletHelper::PutValuesInVector(n_s_, &s[0], *sol_sV[irhs]);
+      }
+      if( n_c_ > 0 )
+      {
+         TripletHelper::PutValuesInVector(n_c_, &y[0], *sol_cV[irhs]);
+      }
+      if( n_d_ > 0 )
+      {
+         TripletHelper::PutValuesInVector(n_d_, &y[n_c_], *sol_dV[irhs]);
+      }
+   }
+
+   return SYMSOLVER_SUCCESS;
+}
+
+Index DiagHessianAugSystemSolver::NumberOfNegEVals() const
+{
+   if( !w_diagonal_ || use_fallback_ )
+   {
+      return fallback_solver_->NumberOfNegEVals();
+   }
+   return negevals_;
+}
+
+bool DiagHessianAugSystemSolver::ProvidesInertia() const
+{
+   // the inertia is always known if the dense Schur complement is used
+   if( structure_initialized_ && w_diagonal_ )
+   {
+      return !use_sparse_ || schur_solver_->ProvidesInertia();
+   }
+   return fallback_solver_->ProvidesInertia();
+}
+
+bool DiagHessianAugSystemSolver::IncreaseQuality()
+{
+   if( !w_diagonal_ || use_fallback_ )
+   {
+      return fallback_solver_->IncreaseQuality();
+   }
+   if( use_sparse_ )
+   {
+      return schur_solver_->IncreaseQuality();
+   }
+   return false;
+}
+
+} // namespace Ipopt
@@ -0,0 +1,308 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IP_DIAGHESSIANAUGSYSTEMSOLVER_HPP__
+#define __IP_DIAGHESSIANAUGSYSTEMSOLVER_HPP__
+
+#include "IpAugSystemSolver.hpp"
+#include "IpSymLinearSolver.hpp"
+#include "IpSymTMatrix.hpp"
+#include "IpDenseVector.hpp"
+
+namespace Ipopt
+{
+/** Solver for the augmented system of problems with a diagonal
+ *  Hessian of the Lagrangian, based on the dense Schur complement of
+ *  the primal part.
+ *
+ *  If the sparsity structure of W is diagonal, the primal blocks
+ *  \f$H_x = W + D_x + \delta_xI\f$ and \f$H_s = D_s + \delta_sI\f$
+ *  of the augmented system are diagonal.  The primal variables are
+ *  then eliminated, and the multipliers are obtained from the dense
+ *  system
+ *
+ *  \f$S = J H_x^{-1} J^T + \left[\begin{array}{cc}
+ *  \delta_cI - D_c & 0\\
+ *  0 & H_s^{-1} + \delta_dI - D_d
+ *  \end{array}\right]\f$
+ *
+ *  with \f$J = [J_c; J_d]\f$, which has only as many rows as there
+ *  are constraints.  S is factorized by a dense Cholesky
+ *  factorization if the primal blocks are positive definite, which
+ *  gives the required inertia.  Otherwise, or if S is not positive
+ *  definite, S is decomposed into its eigenvalues, so that the
+ *  inertia of the augmented system is the number of negative entries
+ *  of the primal blocks plus the number of positive eigenvalues of S.
+ *
+ *  This is efficient if the number of constraints is small compared
+ *  to the number of variables.  If W is not diagonal, or if the
+ *  primal blocks have a zero entry, the augmented system is passed to
+ *  a fallback solver.
+ *
+ *  If a linear solver for the Schur complement is given, S is
+ *  assembled as a sparse matrix with the sparsity structure of
+ *  \f$J J^T\f$ instead, and factorized by this solver.  Since S
+ *  is positive definite if the augmented system has the required
+ *  inertia, the factorization does not need pivoting for stability.
+ *  The inertia of the augmented system is then obtained from the
+ *  number of negative eigenvalues of S reported by the solver.  The
+ *  sparse Schur complement is only used if there are not more
+ *  constraints than variables.
+ */
+class DiagHessianAugSystemSolver: public AugSystemSolver
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor.
+    *
+    *  fallback_solver is used if W is not diagonal.  If schur_solver
+    *  is given, the Schur complement is factorized by this solver as
+    *  a sparse matrix, otherwise by LAPACK as a dense matrix.
+    */
+   DiagHessianAugSystemSolver(
+      AugSystemSolver&                 fallback_solver,
+      const SmartPtr<SymLinearSolver>& schur_solver = NULL
+   );
+
+   /** Destructor */
+   virtual ~DiagHessianAugSystemSolver();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   virtual ESymSolverStatus MultiSolve(
+      const SymMatrix*                      W,
+      double                                W_factor,
+      const Vector*                         D_x,
+      double                                delta_x,
+      const Vector*                         D_s,
+      double                                delta_s,
+      const Matrix*                         J_c,
+      const Vector*                         D_c,
+      double                                delta_c,
+      const Matrix*                         J_d,
+      const Vector*                         D_d,
+      double                                delta_d,
+      std::vector<SmartPtr<const Vector> >& rhs_xV,
+      std::vector<SmartPtr<const Vector> >& rhs_sV,
+      std::vector<SmartPtr<const Vector> >& rhs_cV,
+      std::vector<SmartPtr<const Vector> >& rhs_dV,
+      std::vector<SmartPtr<Vector> >&       sol_xV,
+      std::vector<SmartPtr<Vector> >&       sol_sV,
+      std::vector<SmartPtr<Vector> >&       sol_cV,
+      std::vector<SmartPtr<Vector> >&       sol_dV,
+      bool                                  check_NegEVals,
+      Index                                 numberOfNegEVals
+   );
+
+   /** Number of negative eigenvalues of the most recent factorization,
+    *  from the primal blocks and the Schur complement.
+    */
+   virtual Index NumberOfNegEVals() const;
+
+   virtual bool ProvidesInertia() const;
+
+   /** Request to increase the quality of the solution.
+    *
+    *  This is only possible for the fallback solver and the solver
+    *  of the sparse Schur complement.
+    */
+   virtual bool IncreaseQuality();
+
+   /** Methods for IpoptType */
+   ///@{
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default constructor */
+   DiagHessianAugSystemSolver();
+
+   /** Copy Constructor */
+   DiagHessianAugSystemSolver(
+      const DiagHessianAugSystemSolver&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const DiagHessianAugSystemSolver&
+   );
+   ///@}
+
+   /** Solver for the augmented system if the Schur complement is not used */
+   SmartPtr<AugSystemSolver> fallback_solver_;
+
+   /** @name Structure of the augmented system */
+   ///@{
+   /** Whether the structure has been set up by the first call of MultiSolve */
+   bool structure_initialized_;
+   /** Whether W is diagonal, otherwise the fallback solver is used */
+   bool w_diagonal_;
+   /** Dimensions of x, s, c, and d */
+   Index n_x_;
+   Index n_s_;
+   Index n_c_;
+   Index n_d_;
+   /** Number of elements of W, J_c, and J_d */
+   Index nnz_W_;
+   Index nnz_J_c_;
+   Index nnz_J_d_;
+   /** For each element of W its row (and column) */
+   std::vector<Index> w_row_;
+   /** For each element of J_c and J_d (in this order) its row in J
+    *  and its column.
+    */
+   std::vector<Index> jac_row_;
+   std::vector<Index> jac_col_;
+   /** Elements of J sorted by columns: the elements of column j are
+    *  col_entry_[col_start_[j]] to col_entry_[col_start_[j+1]-1].
+    */
+   std::vector<Index> col_start_;
+   std::vector<Index> col_entry_;
+   ///@}
+
+   /** @name Current factorization */
+   ///@{
+   /** Whether a factorization is available */
+   bool have_factorization_;
+   /** Whether the primal blocks have a zero entry, so that the
+    *  fallback solver is used for these matrices.
+    */
+   bool use_fallback_;
+   /** Inverses of the diagonals of the primal blocks */
+   std::vector<Number> inv_h_x_;
+   std::vector<Number> inv_h_s_;
+   /** Values of the elements of J */
+   std::vector<Number> jac_val_;
+   /** Whether schur_ holds a Cholesky factor, otherwise the eigenvectors */
+   bool use_cholesky_;
+   /** Cholesky factor or eigenvectors of the Schur complement (column-major) */
+   std::vector<Number> schur_;
+   /** Eigenvalues of the Schur complement, if it is not factorized by Cholesky */
+   std::vector<Number> schur_evals_;
+   /** LAPACK workspace for the eigenvalue decomposition, kept between factorizations */
+   std::vector<Number> schur_work_;
+   /** Number of negative eigenvalues of the augmented system */
+   Index negevals_;
+   /** Number of negative entries of the primal blocks */
+   Index negevals_h_;
+   ///@}
+
+   /** @name Sparse Schur complement */
+   ///@{
+   /** Solver for the sparse Schur complement, or NULL for the dense Schur complement */
+   SmartPtr<SymLinearSolver> schur_solver_;
+   /** Whether the sparse Schur complement is used for the current structure */
+   bool use_sparse_;
+   /** Elements of J sorted by rows: the elements of row i are
+    *  row_entry_[row_start_[i]] to row_entry_[row_start_[i+1]-1].
+    */
+   std::vector<Index> row_start_;
+   std::vector<Index> row_entry_;
+   /** Lower triangle of S sorted by rows: the elements of row i are
+    *  schur_col_[schur_row_start_[i]] to
+    *  schur_col_[schur_row_start_[i+1]-1].
+    */
+   std::vector<Index> schur_row_start_;
+   std::vector<Index> schur_col_;
+   /** Position of the diagonal element of each row of S */
+   std::vector<Index> schur_diag_pos_;
+   /** Values of the elements of S */
+   std::vector<Number> schur_values_;
+   /** Sparse Schur complement passed to schur_solver_ */
+   SmartPtr<SymTMatrix> schur_matrix_;
+   /** Vector space for the multipliers */
+   SmartPtr<DenseVectorSpace> y_space_;
+   ///@}
+
+   /** @name Information about the matrices of the current factorization */
+   ///@{
+   TaggedObject::Tag w_tag_;
+   double w_factor_;
+   TaggedObject::Tag d_x_tag_;
+   double delta_x_;
+   TaggedObject::Tag d_s_tag_;
+   double delta_s_;
+   TaggedObject::Tag j_c_tag_;
+   TaggedObject::Tag d_c_tag_;
+   double delta_c_;
+   TaggedObject::Tag j_d_tag_;
+   TaggedObject::Tag d_d_tag_;
+   double delta_d_;
+   ///@}
+
+   /** Compute the sparsity structure of the lower triangle of the
+    *  Schur complement.
+    */
+   void InitializeSparseSchur();
+
+   /** Assemble the values of the sparse Schur complement */
+   void FillSparseSchur(
+      const Vector* D_c,
+      double        delta_c,
+      const Vector* D_d,
+      double        delta_d
+   );
+
+   /** Analyze the structure of the augmented system.
+    *
+    *  Sets w_diagonal_ to false if W is not diagonal.
+    */
+   void InitializeStructure(
+      const SymMatrix& W,
+      const Matrix&    J_c,
+      const Matrix&    J_d
+   );
+
+   /** Whether the matrices differ from those of the current factorization */
+   bool AugmentedSystemRequiresChange(
+      const SymMatrix* W,
+      double           W_factor,
+      const Vector*    D_x,
+      double           delta_x,
+      const Vector*    D_s,
+      double           delta_s,
+      const Matrix&    J_c,
+      const Vector*    D_c,
+      double           delta_c,
+      const Matrix&    J_d,
+      const Vector*    D_d,
+      double           delta_d
+   );
+
+   /** Compute the primal blocks and factorize the Schur complement */
+   ESymSolverStatus Factorize(
+      const SymMatrix* W,
+      double           W_factor,
+      const Vector*    D_x,
+      double           delta_x,
+      const Vector*    D_s,
+      double           delta_s,
+      const Matrix&    J_c,
+      const Vector*    D_c,
+      double           delta_c,
+      const Matrix&    J_d,
+      const Vector*    D_d,
+      double           delta_d
+   );
+};
+
+} // namespace Ipopt
+
+#endif
@@ -0,0 +1,124 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpDiagonalAugSystemPreconditioner.hpp"
+
+#include <cmath>
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+DiagonalAugSystemPreconditioner::DiagonalAugSystemPreconditioner()
+   : AugSystemPreconditioner(),
+     scalar_x_(1.),
+     scalar_s_(1.),
+     scalar_c_(1.),
+     scalar_d_(1.)
+{ }
+
+DiagonalAugSystemPreconditioner::~DiagonalAugSystemPreconditioner()
+{ }
+
+bool DiagonalAugSystemPreconditioner::InitializeImpl(
+   const OptionsList& /*options*/,
+   const std::string& /*prefix*/
+)
+{
+   inv_x_ = NULL;
+   inv_s_ = NULL;
+   inv_c_ = NULL;
+   inv_d_ = NULL;
+   return true;
+}
+
+bool DiagonalAugSystemPreconditioner::UpdatePreconditioner(
+   const SymMatrix* /*W*/,
+   double           /*W_factor*/,
+   const Vector*    D_x,
+   double           delta_x,
+   const Vector*    D_s,
+   double           delta_s,
+   const Matrix*    /*J_c*/,
+   const Vector*    D_c,
+   double           delta_c,
+   const Matrix*    /*J_d*/,
+   const Vector*    D_d,
+   double           delta_d
+)
+{
+   DBG_START_METH("DiagonalAugSystemPreconditioner::UpdatePreconditioner", dbg_verbosity);
+
+   ComputeInverse(D_x, delta_x, inv_x_, scalar_x_);
+   ComputeInverse(D_s, delta_s, inv_s_, scalar_s_);
+   ComputeInverse(D_c, -delta_c, inv_c_, scalar_c_);
+   ComputeInverse(D_d, -delta_d, inv_d_, scalar_d_);
+
+   return true;
+}
+
+void DiagonalAugSystemPreconditioner::ApplyPreconditioner(
+   const Vector& r_x,
+   const Vector& r_s,
+   const Vector& r_c,
+   const Vector& r_d,
+   Vector&       z_x,
+   Vector&       z_s,
+   Vector&       z_c,
+   Vector&       z_d
+)
+{
+   MultInverse(inv_x_, scalar_x_, r_x, z_x);
+   MultInverse(inv_s_, scalar_s_, r_s, z_s);
+   MultInverse(inv_c_, scalar_c_, r_c, z_c);
+   MultInverse(inv_d_, scalar_d_, r_d, z_d);
+}
+
+void DiagonalAugSystemPreconditioner::ComputeInverse(
+   const Vector*     D,
+   Number            delta,
+   SmartPtr<Vector>& inv,
+   Number&           scalar
+)
+{
+   if( D )
+   {
+      if( IsNull(inv) || GetRawPtr(inv->OwnerSpace()) != GetRawPtr(D->OwnerSpace()) )
+      {
+         inv = D->MakeNew();
+      }
+      inv->Copy(*D);
+      inv->AddScalar(delta);
+      inv->ElementWiseAbs();
+      inv->AddScalar(1.);
+      inv->ElementWiseReciprocal();
+   }
+   else
+   {
+      inv = NULL;
+      scalar = 1. / (1. + std::abs(delta));
+   }
+}
+
+void DiagonalAugSystemPreconditioner::MultInverse(
+   const SmartPtr<Vector>& inv,
+   Number                  scalar,
+   const Vector&           r,
+   Vector&                 z
+)
+{
+   if( IsValid(inv) )
+   {
+      z.Copy(r);
+      z.ElementWiseMultiply(*inv);
+   }
+   else
+   {
+      z.AddOneVector(scalar, r, 0.);
+   }
+}
+
+} // namespace Ipopt
@@ -0,0 +1,124 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IP_DIAGONALAUGSYSTEMPRECONDITIONER_HPP__
+#define __IP_DIAGONALAUGSYSTEMPRECONDITIONER_HPP__
+
+#include "IpAugSystemPreconditioner.hpp"
+
+namespace Ipopt
+{
+
+/** Diagonal preconditioner for the augmented system.
+ *
+ *  The diagonal elements are 1 plus the absolute value of the
+ *  diagonal terms D_x + delta_x, D_s + delta_s, D_c - delta_c, and
+ *  D_d - delta_d of the augmented system.  The Hessian and the
+ *  constraint Jacobians are not used, so that this preconditioner
+ *  accounts mainly for the barrier terms.  It is positive definite.
+ */
+class DiagonalAugSystemPreconditioner: public AugSystemPreconditioner
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Default constructor. */
+   DiagonalAugSystemPreconditioner();
+
+   /** Destructor */
+   virtual ~DiagonalAugSystemPreconditioner();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   virtual bool UpdatePreconditioner(
+      const SymMatrix* W,
+      double           W_factor,
+      const Vector*    D_x,
+      double           delta_x,
+      const Vector*    D_s,
+      double           delta_s,
+      const Matrix*    J_c,
+      const Vector*    D_c,
+      double           delta_c,
+      const Matrix*    J_d,
+      const Vector*    D_d,
+      double           delta_d
+   );
+
+   virtual void ApplyPreconditioner(
+      const Vector& r_x,
+      const Vector& r_s,
+      const Vector& r_c,
+      const Vector& r_d,
+      Vector&       z_x,
+      Vector&       z_s,
+      Vector&       z_c,
+      Vector&       z_d
+   );
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   DiagonalAugSystemPreconditioner(
+      const DiagonalAugSystemPreconditioner&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const DiagonalAugSystemPreconditioner&
+   );
+   ///@}
+
+   /** @name Inverses of the diagonal elements for the components
+    *  x, s, c, and d.
+    *
+    *  If the corresponding diagonal term of the augmented system is a
+    *  multiple of the identity, the vector is NULL and the inverse is
+    *  given by the scalar.
+    */
+   ///@{
+   SmartPtr<Vector> inv_x_;
+   Number scalar_x_;
+   SmartPtr<Vector> inv_s_;
+   Number scalar_s_;
+   SmartPtr<Vector> inv_c_;
+   Number scalar_c_;
+   SmartPtr<Vector> inv_d_;
+   Number scalar_d_;
+   ///@}
+
+   /** Compute the inverse of 1 + |D + delta| in inv, or in scalar if
+    *  D is NULL.
+    */
+   static void ComputeInverse(
+      const Vector*     D,
+      Number            delta,
+      SmartPtr<Vector>& inv,
+      Number&           scalar
+   );
+
+   /** Compute z = inv.*r, or z = scalar*r if inv is NULL. */
+   static void MultInverse(
+      const SmartPtr<Vector>& inv,
+      Number                  scalar,
+      const Vector&           r,
+      Vector&                 z
+   );
+};
+
+} // namespace Ipopt
+
+#endif
@@ -7,6 +7,8 @@
 #include "IpoptConfig.h"
 #include "IpEquilibrationScaling.hpp"
 #include "IpTripletHelper.hpp"
+#include "IpGenTMatrix.hpp"
+#include "IpDenseVector.hpp"
 
 #ifdef IPOPT_HAS_HSL
 #include "CoinHslConfig.h"
@@ -16,6 +18,19 @@
 #endif
 
 #include <cmath>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** The absolute values of the derivatives are accumulated by several
+ *  threads if there are at least this number of them and Ipopt has
+ *  been compiled with OpenMP support.
+ */
+#ifndef IPOPT_EQUILIBRATION_PARALLEL_MIN_NONZEROS
+#define IPOPT_EQUILIBRATION_PARALLEL_MIN_NONZEROS 100000
+#endif
 
 /** Prototypes for MA27's Fortran subroutines */
 extern "C"
@@ -40,6 +55,65 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Get the values of a matrix in triplet format.
+ *
+ *  For a GenTMatrix, its own array is returned, otherwise the values
+ *  are copied into buffer.
+ */
+static const Number* TripletValues(
+   Index                nnz,
+   const Matrix&        matrix,
+   std::vector<Number>& buffer
+)
+{
+   const GenTMatrix* gen_matrix = dynamic_cast<const GenTMatrix*>(&matrix);
+   if( gen_matrix != NULL )
+   {
+      return gen_matrix->Values();
+   }
+   buffer.resize(Max(nnz, 1));
+   TripletHelper::FillValues(nnz, matrix, &buffer[0]);
+   return &buffer[0];
+}
+
+/** Get the values of a vector, without a copy for a non-homogeneous
+ *  DenseVector
+ */
+static const Number* VectorValues(
+   Index                n,
+   const Vector&        vector,
+   std::vector<Number>& buffer
+)
+{
+   const DenseVector* dense_vector = dynamic_cast<const DenseVector*>(&vector);
+   if( dense_vector != NULL && !dense_vector->IsHomogeneous() )
+   {
+      return dense_vector->Values();
+   }
+   buffer.resize(Max(n, 1));
+   TripletHelper::FillValuesFromVector(n, vector, &buffer[0]);
+   return &buffer[0];
+}
+
+/** Add the absolute values of vals to sum, or overwrite sum with them
+ *  if first is true.
+ */
+static void AddAbsValues(
+   Index         n,
+   const Number* vals,
+   bool          first,
+   Number*       sum
+)
+{
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static) if(n >= IPOPT_EQUILIBRATION_PARALLEL_MIN_NONZEROS && !omp_in_parallel())
+#endif
+   for( Index i = 0; i < n; i++ )
+   {
+      sum[i] = first ? fabs(vals[i]) : sum[i] + fabs(vals[i]);
+   }
+}
+
 void EquilibrationScaling::RegisterOptions(
    const SmartPtr<RegisteredOptions>& /*roptions*/
 )
@@ -95,7 +169,8 @@ void EquilibrationScaling::DetermineScalingParametersImpl(
    const Index nd = jac_d_space->NRows();
    const Index nx = x_space->Dim();
    Number* avrg_values = new Number[nnz_jac_c + nnz_jac_d + nx];
-   Number* val_buffer = new Number[Max(nnz_jac_c, nnz_jac_d, nx)];
+   // only needed for matrices and vectors that do not store their values in an array
+   std::vector<Number> val_buffer;
 
    SmartPtr<PointPerturber> perturber = new PointPerturber(*x0, point_perturbation_radius_, Px_L, x_L, Px_U, x_U);
 
@@ -119,60 +194,15 @@ void EquilibrationScaling::DetermineScalingParametersImpl(
          }
          if( num_eval_errors > max_num_eval_errors )
          {
-            delete[] val_buffer;
             delete[] avrg_values;
             THROW_EXCEPTION(FAILED_INITIALIZATION, "Too many evaluation failures during equilibiration-based scaling.");
          }
       }
-      // Get the numbers out of the matrices and vectors, and add it
-      // to avrg_values
-      TripletHelper::FillValues(nnz_jac_c, *jac_c, val_buffer);
-      if( ieval == 0 )
-      {
-         for( Index i = 0; i < nnz_jac_c; i++ )
-         {
-            avrg_values[i] = fabs(val_buffer[i]);
-         }
-      }
-      else
-      {
-         for( Index i = 0; i < nnz_jac_c; i++ )
-         {
-            avrg_values[i] += fabs(val_buffer[i]);
-         }
-      }
-      TripletHelper::FillValues(nnz_jac_d, *jac_d, val_buffer);
-      if( ieval == 0 )
-      {
-         for( Index i = 0; i < nnz_jac_d; i++ )
-         {
-            avrg_values[nnz_jac_c + i] = fabs(val_buffer[i]);
-         }
-      }
-      else
-      {
-         for( Index i = 0; i < nnz_jac_d; i++ )
-         {
-            avrg_values[nnz_jac_c + i] += fabs(val_buffer[i]);
-         }
-      }
-      TripletHelper::FillValuesFromVector(nx, *grad_f, val_buffer);
-      if( ieval == 0 )
-      {
-         for( Index i = 0; i < nx; i++ )
-         {
-            avrg_values[nnz_jac_c + nnz_jac_d + i] = fabs(val_buffer[i]);
-         }
-      }
-      else
-      {
-         for( Index i = 0; i < nx; i++ )
-         {
-            avrg_values[nnz_jac_c + nnz_jac_d + i] += fabs(val_buffer[i]);
-         }
-      }
+      // Add the absolute values of the derivatives to avrg_values
+      AddAbsValues(nnz_jac_c, TripletValues(nnz_jac_c, *jac_c, val_buffer), ieval == 0, avrg_values);
+      AddAbsValues(nnz_jac_d, TripletValues(nnz_jac_d, *jac_d, val_buffer), ieval == 0, &avrg_values[nnz_jac_c]);
+      AddAbsValues(nx, VectorValues(nx, *grad_f, val_buffer), ieval == 0, &avrg_values[nnz_jac_c + nnz_jac_d]);
    }
-   delete[] val_buffer;
    for( Index i = 0; i < nnz_jac_c + nnz_jac_d + nx; i++ )
    {
       avrg_values[i] /= (Number) num_evals;
@@ -6,6 +6,10 @@
 
 #include "IpFilter.hpp"
 #include "IpJournalist.hpp"
+#include "IpCheckpoint.hpp"
+#include "IpAlgTypes.hpp"
+
+#include <algorithm>
 
 namespace Ipopt
 {
@@ -39,12 +43,140 @@ Filter::Filter(
    : dim_(dim)
 { }
 
+bool Filter::Val1Less(
+   const Entry2& entry,
+   Number        val1
+)
+{
+   return entry.val1 < val1;
+}
+
+bool Filter::LessVal1(
+   Number        val1,
+   const Entry2& entry
+)
+{
+   return val1 < entry.val1;
+}
+
+bool Filter::Acceptable(
+   Number val1,
+   Number val2
+) const
+{
+   DBG_START_METH("FilterLineSearch::Filter::Acceptable", dbg_verbosity);
+   DBG_ASSERT(dim_ == 2);
+
+   // an entry rejects the point if both of its coordinates are smaller
+   for( size_t i = 0; i < unordered_.size(); ++i )
+   {
+      if( !(val1 <= unordered_[i].val1) && !(val2 <= unordered_[i].val2) )
+      {
+         return false;
+      }
+   }
+
+   if( val1 != val1 || val2 != val2 )
+   {
+      // no order to search for, so check all entries
+      for( size_t i = 0; i < front_.size(); ++i )
+      {
+         if( !(val1 <= front_[i].val1) && !(val2 <= front_[i].val2) )
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   // Among the entries with val1 smaller than the point, the last has the
+   // smallest val2.  The point is acceptable if this is not smaller, too.
+   std::vector<Entry2>::const_iterator it = std::lower_bound(front_.begin(), front_.end(), val1, Val1Less);
+   if( it == front_.begin() )
+   {
+      return true;
+   }
+   --it;
+   return val2 <= it->val2;
+}
+
+void Filter::AddEntry(
+   Number val1,
+   Number val2,
+   Index  iteration
+)
+{
+   DBG_START_METH("FilterLineSearch::Filter::AddEntry", dbg_verbosity);
+   DBG_ASSERT(dim_ == 2);
+
+   Entry2 entry;
+   entry.val1 = val1;
+   entry.val2 = val2;
+   entry.iter = iteration;
+
+   // remove all entries that are dominated by the new one (as in FilterEntry::Dominated)
+   size_t n = 0;
+   for( size_t i = 0; i < unordered_.size(); ++i )
+   {
+      if( val1 > unordered_[i].val1 || val2 > unordered_[i].val2 )
+      {
+         unordered_[n++] = unordered_[i];
+      }
+   }
+   unordered_.resize(n);
+
+   if( val1 != val1 || val2 != val2 )
+   {
+      // no order to search for, so check all entries
+      n = 0;
+      for( size_t i = 0; i < front_.size(); ++i )
+      {
+         if( val1 > front_[i].val1 || val2 > front_[i].val2 )
+         {
+            front_[n++] = front_[i];
+         }
+      }
+      front_.resize(n);
+      unordered_.push_back(entry);
+      return;
+   }
+
+   // The entries with val1 >= the new val1 follow first, and the ones
+   // among them with val2 >= the new val2 are dominated.
+   std::vector<Entry2>::iterator first = std::lower_bound(front_.begin(), front_.end(), val1, Val1Less);
+   std::vector<Entry2>::iterator last = first;
+   while( last != front_.end() && val2 <= last->val2 )
+   {
+      ++last;
+   }
+   if( first != last )
+   {
+      first = front_.erase(first, last);
+   }
+   else
+   {
+      // The new entry is dominated by an entry with val1 <= the new
+      // val1 and val2 <= the new val2, if the last of the entries with
+      // val1 <= the new val1 has val2 <= the new val2.
+      std::vector<Entry2>::iterator prev = std::upper_bound(front_.begin(), front_.end(), val1, LessVal1);
+      if( prev != front_.begin() && (prev - 1)->val2 <= val2 )
+      {
+         return;
+      }
+   }
+   front_.insert(first, entry);
+}
+
 bool Filter::Acceptable(
    std::vector<Number> vals
 ) const
 {
    DBG_START_METH("FilterLineSearch::Filter::Acceptable", dbg_verbosity);
    DBG_ASSERT((Index)vals.size() == dim_);
+   if( dim_ == 2 )
+   {
+      return Acceptable(vals[0], vals[1]);
+   }
    bool acceptable = true;
    std::list<FilterEntry*>::iterator iter;
    for( iter = filter_list_.begin(); iter != filter_list_.end(); iter++ )
@@ -65,6 +197,11 @@ void Filter::AddEntry(
 {
    DBG_START_METH("FilterLineSearch::Filter::AddEntry", dbg_verbosity);
    DBG_ASSERT((Index)vals.size() == dim_);
+   if( dim_ == 2 )
+   {
+      AddEntry(vals[0], vals[1], iteration);
+      return;
+   }
    std::list<FilterEntry*>::iterator iter;
    iter = filter_list_.begin();
    while( iter != filter_list_.end() )
@@ -89,6 +226,8 @@ void Filter::AddEntry(
 void Filter::Clear()
 {
    DBG_START_METH("FilterLineSearch::Filter::Clear", dbg_verbosity);
+   front_.clear();
+   unordered_.clear();
    while( !filter_list_.empty() )
    {
       FilterEntry* entry = filter_list_.back();
@@ -103,11 +242,26 @@ void Filter::Print(
 {
    DBG_START_METH("FilterLineSearch::Filter::Print", dbg_verbosity);
    jnlst.Printf(J_DETAILED, J_LINE_SEARCH,
-                "The current filter has %d entries.\n", filter_list_.size());
+                "The current filter has %d entries.\n", (int) (filter_list_.size() + front_.size() + unordered_.size()));
    if( !jnlst.ProduceOutput(J_VECTOR, J_LINE_SEARCH) )
    {
       return;
    }
+   if( dim_ == 2 )
+   {
+      for( size_t i = 0; i < front_.size() + unordered_.size(); ++i )
+      {
+         const Entry2& entry = i < front_.size() ? front_[i] : unordered_[i - front_.size()];
+         if( i % 10 == 0 )
+         {
+            jnlst.Printf(J_VECTOR, J_LINE_SEARCH,
+                         "                phi                    theta            iter\n");
+         }
+         jnlst.Printf(J_VECTOR, J_LINE_SEARCH,
+                      "%5d %23.16e %23.16e %5" IPOPT_INDEX_FORMAT "\n", (int) i + 1, entry.val1, entry.val2, entry.iter);
+      }
+      return;
+   }
    std::list<FilterEntry*>::iterator iter;
    Index count = 0;
    for( iter = filter_list_.begin(); iter != filter_list_.end(); iter++ )
@@ -119,14 +273,84 @@ void Filter::Print(
       }
       count++;
       jnlst.Printf(J_VECTOR, J_LINE_SEARCH,
-                   "%5d ", count);
+                   "%5" IPOPT_INDEX_FORMAT " ", count);
       for( Index i = 0; i < dim_; i++ )
       {
          jnlst.Printf(J_VECTOR, J_LINE_SEARCH,
                       "%23.16e ", (*iter)->val(i));
       }
       jnlst.Printf(J_VECTOR, J_LINE_SEARCH,
-                   "%5d\n", (*iter)->iter());
+                   "%5" IPOPT_INDEX_FORMAT "\n", (*iter)->iter());
+   }
+}
+
+void Filter::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   checkpoint.WriteIndex(dim_);
+   if( dim_ == 2 )
+   {
+      const std::vector<Entry2>* entries[2] = { &front_, &unordered_ };
+      for( int k = 0; k < 2; ++k )
+      {
+         checkpoint.WriteIndex((Index) entries[k]->size());
+         for( size_t i = 0; i < entries[k]->size(); ++i )
+         {
+            checkpoint.WriteNumber((*entries[k])[i].val1);
+            checkpoint.WriteNumber((*entries[k])[i].val2);
+            checkpoint.WriteIndex((*entries[k])[i].iter);
+         }
+      }
+      return;
+   }
+   checkpoint.WriteIndex((Index) filter_list_.size());
+   std::list<FilterEntry*>::const_iterator iter;
+   for( iter = filter_list_.begin(); iter != filter_list_.end(); iter++ )
+   {
+      for( Index i = 0; i < dim_; i++ )
+      {
+         checkpoint.WriteNumber((*iter)->val(i));
+      }
+      checkpoint.WriteIndex((*iter)->iter());
+   }
+}
+
+void Filter::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   Clear();
+   if( checkpoint.ReadIndex() != dim_ )
+   {
+      THROW_EXCEPTION(INVALID_WARMSTART, "Checkpoint file " + checkpoint.FileName() + " contains a filter of a different dimension.");
+   }
+   if( dim_ == 2 )
+   {
+      std::vector<Entry2>* entries[2] = { &front_, &unordered_ };
+      for( int k = 0; k < 2; ++k )
+      {
+         // the entries are stored in the order in which they are kept
+         entries[k]->resize(checkpoint.ReadIndex());
+         for( size_t i = 0; i < entries[k]->size(); ++i )
+         {
+            (*entries[k])[i].val1 = checkpoint.ReadNumber();
+            (*entries[k])[i].val2 = checkpoint.ReadNumber();
+            (*entries[k])[i].iter = checkpoint.ReadIndex();
+         }
+      }
+      return;
+   }
+   Index n = checkpoint.ReadIndex();
+   std::vector<Number> vals(dim_);
+   for( Index j = 0; j < n; j++ )
+   {
+      for( Index i = 0; i < dim_; i++ )
+      {
+         vals[i] = checkpoint.ReadNumber();
+      }
+      Index iteration = checkpoint.ReadIndex();
+      filter_list_.push_back(new FilterEntry(vals, iteration));
    }
 }
 
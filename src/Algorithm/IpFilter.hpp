@@ -15,6 +15,9 @@
 namespace Ipopt
 {
 
+/* Forward declaration */
+class Checkpoint;
+
 /** Class for one filter entry. */
 class FilterEntry
 {
@@ -130,6 +133,12 @@ private:
  *  This class contains all filter entries.
  *  The entries are stored as the corner point, including the
  *  margin.
+ *
+ *  A 2-dimensional filter keeps its entries as a Pareto front in an
+ *  array that is sorted by increasing first and decreasing second
+ *  coordinate, so that the acceptability of a point is checked by a
+ *  binary search.  Entries that are dominated by another entry are not
+ *  kept, since they do not change which points are acceptable.
  */
 class Filter
 {
@@ -167,32 +176,18 @@ public:
       Index               iteration
    );
 
-   /** @name Wrappers for 2-dimensional filter. */
+   /** @name Methods for 2-dimensional filter. */
    ///@{
    bool Acceptable(
       Number val1,
       Number val2
-   ) const
-   {
-      std::vector<Number> vals(2);
-      vals[0] = val1;
-      vals[1] = val2;
-
-      return Acceptable(vals);
-   }
+   ) const;
 
    void AddEntry(
       Number val1,
       Number val2,
       Index  iteration
-   )
-   {
-      std::vector<Number> vals(2);
-      vals[0] = val1;
-      vals[1] = val2;
-
-      AddEntry(vals, iteration);
-   }
+   );
    ///@}
 
    /** Delete all filter entries */
@@ -203,6 +198,16 @@ public:
       const Journalist& jnlst
    );
 
+   /** Write the filter entries to a checkpoint */
+   void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** Replace the filter entries by the ones written by WriteCheckpoint */
+   void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -230,8 +235,37 @@ private:
    /** Dimension of the filter (number of coordinates per entry) */
    Index dim_;
 
-   /** List storing the filter entries */
+   /** List storing the filter entries if dim_ is not 2 */
    mutable std::list<FilterEntry*> filter_list_;
+
+   /** Entry of a 2-dimensional filter */
+   struct Entry2
+   {
+      Number val1;
+      Number val2;
+      /** iteration number in which this entry was added to filter */
+      Index iter;
+   };
+
+   /** whether the first coordinate of an entry is smaller than a value */
+   static bool Val1Less(
+      const Entry2& entry,
+      Number        val1
+   );
+
+   /** whether a value is smaller than the first coordinate of an entry */
+   static bool LessVal1(
+      Number        val1,
+      const Entry2& entry
+   );
+
+   /** Pareto front of a 2-dimensional filter, sorted by increasing val1
+    *  and (thereby) decreasing val2 */
+   std::vector<Entry2> front_;
+
+   /** Entries of a 2-dimensional filter with a NaN coordinate, which
+    *  cannot be sorted into front_ */
+   std::vector<Entry2> unordered_;
 };
 
 } // namespace Ipopt
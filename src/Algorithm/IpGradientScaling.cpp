@@ -50,6 +50,26 @@ void GradientScaling::RegisterOptions(
       "If some derivatives of some functions are huge, the scaling factors will otherwise become very small, "
       "and the (unscaled) final constraint violation, for example, might then be significant. "
       "Note: This option is only used if \"nlp_scaling_method\" is chosen as \"gradient-based\".");
+   roptions->AddLowerBoundedIntegerOption(
+      "nlp_scaling_update_frequency",
+      "Number of iterations between updates of the gradient-based scaling of the constraints.",
+      0,
+      0,
+      "If positive, the scaling factors of the constraints are computed again from the Jacobian at the current iterate "
+      "at every iteration whose number is a multiple of this value, "
+      "and the iterates, the multipliers, and the bounds are transformed to the new scaling without restarting the algorithm. "
+      "The filter of the line search is reset after such an update. "
+      "This can help if the Jacobian changes by orders of magnitude during the optimization. "
+      "The value 0 keeps the scaling of the starting point. "
+      "Note: This option is only used if \"nlp_scaling_method\" is chosen as \"gradient-based\".");
+   roptions->AddLowerBoundedNumberOption(
+      "nlp_scaling_update_factor",
+      "Minimal change of a scaling factor that triggers an update of the constraint scaling.",
+      1., true,
+      10.,
+      "The scaling of the constraints is only updated if at least one scaling factor is to be multiplied "
+      "or divided by more than this value. "
+      "Note: This option is only used if \"nlp_scaling_update_frequency\" is positive.");
 }
 
 bool GradientScaling::InitializeImpl(
@@ -61,6 +81,8 @@ bool GradientScaling::InitializeImpl(
    options.GetNumericValue("nlp_scaling_obj_target_gradient", scaling_obj_target_gradient_, prefix);
    options.GetNumericValue("nlp_scaling_constr_target_gradient", scaling_constr_target_gradient_, prefix);
    options.GetNumericValue("nlp_scaling_min_value", scaling_min_value_, prefix);
+   options.GetIntegerValue("nlp_scaling_update_frequency", update_frequency_, prefix);
+   options.GetNumericValue("nlp_scaling_update_factor", update_factor_, prefix);
    return StandardScalingBase::InitializeImpl(options, prefix);
 }
 
@@ -144,36 +166,7 @@ void GradientScaling::DetermineScalingParametersImpl(
       SmartPtr<Matrix> jac_c = jac_c_space->MakeNew();
       if( nlp_->Eval_jac_c(*x, *jac_c) )
       {
-         dc = c_space->MakeNew();
-         const double dbl_min = std::numeric_limits<double>::min();
-         dc->Set(dbl_min);
-         jac_c->ComputeRowAMax(*dc, false);
-         Number arow_max = dc->Amax();
-         if( scaling_constr_target_gradient_ <= 0. )
-         {
-            if( arow_max > scaling_max_gradient_ )
-            {
-               dc->ElementWiseReciprocal();
-               dc->Scal(scaling_max_gradient_);
-               SmartPtr<Vector> dummy = dc->MakeNew();
-               dummy->Set(1.);
-               dc->ElementWiseMin(*dummy);
-            }
-            else
-            {
-               dc = NULL;
-            }
-         }
-         else
-         {
-            dc->Set(scaling_constr_target_gradient_ / arow_max);
-         }
-         if( IsValid(dc) && scaling_min_value_ > 0. )
-         {
-            SmartPtr<Vector> tmp = dc->MakeNew();
-            tmp->Set(scaling_min_value_);
-            dc->ElementWiseMax(*tmp);
-         }
+         dc = ComputeRowScaling(*jac_c, *c_space);
       }
       else
       {
@@ -191,36 +184,7 @@ void GradientScaling::DetermineScalingParametersImpl(
       SmartPtr<Matrix> jac_d = jac_d_space->MakeNew();
       if( nlp_->Eval_jac_d(*x, *jac_d) )
       {
-         dd = d_space->MakeNew();
-         const double dbl_min = std::numeric_limits<double>::min();
-         dd->Set(dbl_min);
-         jac_d->ComputeRowAMax(*dd, false);
-         Number arow_max = dd->Amax();
-         if( scaling_constr_target_gradient_ <= 0. )
-         {
-            if( arow_max > scaling_max_gradient_ )
-            {
-               dd->ElementWiseReciprocal();
-               dd->Scal(scaling_max_gradient_);
-               SmartPtr<Vector> dummy = dd->MakeNew();
-               dummy->Set(1.);
-               dd->ElementWiseMin(*dummy);
-            }
-            else
-            {
-               dd = NULL;
-            }
-         }
-         else
-         {
-            dd->Set(scaling_constr_target_gradient_ / arow_max);
-         }
-         if( IsValid(dd) && scaling_min_value_ > 0. )
-         {
-            SmartPtr<Vector> tmp = dd->MakeNew();
-            tmp->Set(scaling_min_value_);
-            dd->ElementWiseMax(*tmp);
-         }
+         dd = ComputeRowScaling(*jac_d, *d_space);
       }
       else
       {
@@ -228,6 +192,116 @@ void GradientScaling::DetermineScalingParametersImpl(
                         "Error evaluating Jacobian of inequality constraints at user provided starting point.\n  No scaling factors for inequality constraints computed!\n");
       }
    }
+
+   if( update_frequency_ > 0 )
+   {
+      // the updates change the row scaling vectors, so they have to exist
+      if( IsNull(dc) )
+      {
+         dc = c_space->MakeNew();
+         dc->Set(1.);
+      }
+      if( IsNull(dd) )
+      {
+         dd = d_space->MakeNew();
+         dd->Set(1.);
+      }
+      c_space_ = c_space;
+      d_space_ = d_space;
+      jac_c_space_ = jac_c_space;
+      jac_d_space_ = jac_d_space;
+   }
+}
+
+SmartPtr<Vector> GradientScaling::ComputeRowScaling(
+   const Matrix&      jac,
+   const VectorSpace& space
+) const
+{
+   SmartPtr<Vector> drow = space.MakeNew();
+   const double dbl_min = std::numeric_limits<double>::min();
+   drow->Set(dbl_min);
+   jac.ComputeRowAMax(*drow, false);
+   Number arow_max = drow->Amax();
+   if( scaling_constr_target_gradient_ <= 0. )
+   {
+      if( arow_max > scaling_max_gradient_ )
+      {
+         drow->ElementWiseReciprocal();
+         drow->Scal(scaling_max_gradient_);
+         SmartPtr<Vector> dummy = drow->MakeNew();
+         dummy->Set(1.);
+         drow->ElementWiseMin(*dummy);
+      }
+      else
+      {
+         drow = NULL;
+      }
+   }
+   else
+   {
+      drow->Set(scaling_constr_target_gradient_ / arow_max);
+   }
+   if( IsValid(drow) && scaling_min_value_ > 0. )
+   {
+      SmartPtr<Vector> tmp = drow->MakeNew();
+      tmp->Set(scaling_min_value_);
+      drow->ElementWiseMax(*tmp);
+   }
+   return drow;
+}
+
+bool GradientScaling::ComputeConstraintScalingUpdate(
+   const Vector&     x,
+   SmartPtr<Vector>& c_factors,
+   SmartPtr<Vector>& d_factors
+)
+{
+   if( update_frequency_ == 0 )
+   {
+      return false;
+   }
+
+   SmartPtr<Matrix> jac_c = jac_c_space_->MakeNew();
+   SmartPtr<Matrix> jac_d = jac_d_space_->MakeNew();
+   if( (c_space_->Dim() > 0 && !nlp_->Eval_jac_c(x, *jac_c)) || (d_space_->Dim() > 0 && !nlp_->Eval_jac_d(x, *jac_d)) )
+   {
+      Jnlst().Printf(J_WARNING, J_MAIN,
+                     "Error evaluating the Jacobians for the update of the NLP scaling. The scaling is not changed.\n");
+      return false;
+   }
+
+   // the factors are the ratios of the new and the current scaling
+   c_factors = ComputeRowScaling(*jac_c, *c_space_);
+   if( IsNull(c_factors) )
+   {
+      c_factors = c_space_->MakeNew();
+      c_factors->Set(1.);
+   }
+   SmartPtr<Vector> ones = c_space_->MakeNew();
+   ones->Set(1.);
+   c_factors->ElementWiseDivide(*apply_vector_scaling_c(ConstPtr(ones)));
+
+   d_factors = ComputeRowScaling(*jac_d, *d_space_);
+   if( IsNull(d_factors) )
+   {
+      d_factors = d_space_->MakeNew();
+      d_factors->Set(1.);
+   }
+   ones = d_space_->MakeNew();
+   ones->Set(1.);
+   d_factors->ElementWiseDivide(*apply_vector_scaling_d(ConstPtr(ones)));
+
+   bool significant = false;
+   if( c_space_->Dim() > 0 )
+   {
+      significant = c_factors->Max() > update_factor_ || c_factors->Min() < 1. / update_factor_;
+   }
+   if( d_space_->Dim() > 0 && !significant )
+   {
+      significant = d_factors->Max() > update_factor_ || d_factors->Min() < 1. / update_factor_;
+   }
+   return significant;
 }
 
 } // namespace Ipopt
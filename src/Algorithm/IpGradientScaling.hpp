@@ -35,6 +35,12 @@ public:
    { }
    ///@}
 
+   virtual bool ComputeConstraintScalingUpdate(
+      const Vector&     x,
+      SmartPtr<Vector>& c_factors,
+      SmartPtr<Vector>& d_factors
+   );
+
    /** Register the options for this class */
    static void RegisterOptions(
       const SmartPtr<RegisteredOptions>& roptions
@@ -87,6 +93,16 @@ private:
    );
    ///@}
 
+   /** Compute the scaling factors for the constraints with Jacobian
+    *  jac.
+    *
+    *  @return NULL, if the constraints do not need to be scaled
+    */
+   SmartPtr<Vector> ComputeRowScaling(
+      const Matrix&      jac,
+      const VectorSpace& space
+   ) const;
+
    /** pointer to the NLP to get scaling parameters */
    SmartPtr<NLP> nlp_;
 
@@ -101,6 +117,21 @@ private:
 
    /** minimum value of a scaling parameter */
    Number scaling_min_value_;
+
+   /** number of iterations between updates of the constraint scaling */
+   Index update_frequency_;
+
+   /** minimal change of a scaling factor for an update */
+   Number update_factor_;
+
+   /** @name Spaces of the constraints and their unscaled Jacobians,
+    *  only set if the constraint scaling is updated */
+   ///@{
+   SmartPtr<const VectorSpace> c_space_;
+   SmartPtr<const VectorSpace> d_space_;
+   SmartPtr<const MatrixSpace> jac_c_space_;
+   SmartPtr<const MatrixSpace> jac_d_space_;
+   ///@}
 };
 
 } // namespace Ipopt
@@ -0,0 +1,82 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpHessianProductMatrix.hpp"
+#include "IpIpoptNLP.hpp"
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+HessianProductMatrix::HessianProductMatrix(
+   const HessianProductMatrixSpace* owner_space
+)
+   : SymMatrix(owner_space),
+     obj_factor_(0.)
+{ }
+
+HessianProductMatrix::~HessianProductMatrix()
+{ }
+
+void HessianProductMatrix::SetEvaluationPoint(
+   const SmartPtr<NLP>& nlp,
+   const Vector&        x,
+   Number               obj_factor,
+   const Vector&        yc,
+   const Vector&        yd
+)
+{
+   nlp_ = nlp;
+   x_ = &x;
+   obj_factor_ = obj_factor;
+   yc_ = &yc;
+   yd_ = &yd;
+   ObjectChanged();
+}
+
+void HessianProductMatrix::MultVectorImpl(
+   Number        alpha,
+   const Vector& x,
+   Number        beta,
+   Vector&       y
+) const
+{
+   DBG_START_METH("HessianProductMatrix::MultVectorImpl", dbg_verbosity);
+   DBG_ASSERT(IsValid(nlp_));
+
+   SmartPtr<Vector> hv = y.MakeNew();
+   bool success = nlp_->Eval_h_times_vec(*x_, obj_factor_, *yc_, *yd_, x, *hv);
+   ASSERT_EXCEPTION(success, IpoptNLP::Eval_Error,
+                    "Error evaluating the product of the hessian of the lagrangian with a vector");
+   y.AddOneVector(alpha, *hv, beta);
+}
+
+void HessianProductMatrix::ComputeRowAMaxImpl(
+   Vector& /*rows_norms*/,
+   bool    /*init*/
+) const
+{
+   THROW_EXCEPTION(UNIMPLEMENTED_LINALG_METHOD_CALLED, "HessianProductMatrix::ComputeRowAMaxImpl not implemented");
+}
+
+void HessianProductMatrix::PrintImpl(
+   const Journalist&  jnlst,
+   EJournalLevel      level,
+   EJournalCategory   category,
+   const std::string& name,
+   Index              indent,
+   const std::string& prefix
+) const
+{
+   jnlst.Printf(level, category,
+                "\n");
+   jnlst.PrintfIndented(level, category, indent,
+                        "%sHessianProductMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " rows and columns, available only as products with vectors\n",
+                        prefix.c_str(), name.c_str(), Dim());
+}
+
+} // namespace Ipopt
@@ -0,0 +1,170 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPHESSIANPRODUCTMATRIX_HPP__
+#define __IPHESSIANPRODUCTMATRIX_HPP__
+
+#include "IpSymMatrix.hpp"
+#include "IpNLP.hpp"
+
+namespace Ipopt
+{
+
+/* forward declarations */
+class HessianProductMatrixSpace;
+
+/** Class for the Hessian of the Lagrangian that is only available
+ *  through products with vectors.
+ *
+ *  The matrix stores the point (x, obj_factor, yc, yd) at which the
+ *  Hessian is to be evaluated, and each call of MultVector asks the
+ *  NLP for the product of the Hessian with a vector via
+ *  NLP::Eval_h_times_vec.  The elements of the matrix are never
+ *  formed, so this matrix can only be used with solvers for the
+ *  augmented system that need only matrix-vector products.
+ */
+class HessianProductMatrix: public SymMatrix
+{
+public:
+   /**@name Constructors / Destructors */
+   ///@{
+   /** Constructor, given the corresponding matrix space. */
+   HessianProductMatrix(
+      const HessianProductMatrixSpace* owner_space
+   );
+
+   /** Destructor */
+   ~HessianProductMatrix();
+   ///@}
+
+   /** Method for setting the NLP and the point at which the Hessian
+    *  is evaluated.
+    *
+    *  The vectors are in the unscaled space of the NLP.
+    */
+   void SetEvaluationPoint(
+      const SmartPtr<NLP>& nlp,
+      const Vector&        x,
+      Number               obj_factor,
+      const Vector&        yc,
+      const Vector&        yd
+   );
+
+protected:
+   /**@name Overloaded methods from SymMatrix base class */
+   ///@{
+   virtual void MultVectorImpl(
+      Number        alpha,
+      const Vector& x,
+      Number        beta,
+      Vector&       y
+   ) const;
+
+   virtual void ComputeRowAMaxImpl(
+      Vector& rows_norms,
+      bool    init
+   ) const;
+
+   virtual void PrintImpl(
+      const Journalist&  jnlst,
+      EJournalLevel      level,
+      EJournalCategory   category,
+      const std::string& name,
+      Index              indent,
+      const std::string& prefix
+   ) const;
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   HessianProductMatrix();
+
+   /** Copy Constructor */
+   HessianProductMatrix(
+      const HessianProductMatrix&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const HessianProductMatrix&
+   );
+   ///@}
+
+   /** NLP that computes the products */
+   SmartPtr<NLP> nlp_;
+
+   /** @name Point at which the Hessian is evaluated. */
+   ///@{
+   SmartPtr<const Vector> x_;
+   Number obj_factor_;
+   SmartPtr<const Vector> yc_;
+   SmartPtr<const Vector> yd_;
+   ///@}
+};
+
+/** This is the matrix space for HessianProductMatrix. */
+class HessianProductMatrixSpace: public SymMatrixSpace
+{
+public:
+   /** @name Constructors / Destructors */
+   ///@{
+   /** Constructor, given the dimension of the matrix. */
+   HessianProductMatrixSpace(
+      Index dim
+   )
+      : SymMatrixSpace(dim)
+   { }
+
+   /** Destructor */
+   virtual ~HessianProductMatrixSpace()
+   { }
+   ///@}
+
+   virtual SymMatrix* MakeNewSymMatrix() const
+   {
+      return MakeNewHessianProductMatrix();
+   }
+
+   /** Method for creating a new matrix of this specific type. */
+   HessianProductMatrix* MakeNewHessianProductMatrix() const
+   {
+      return new HessianProductMatrix(this);
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   HessianProductMatrixSpace();
+
+   /** Copy Constructor */
+   HessianProductMatrixSpace(
+      const HessianProductMatrixSpace&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const HessianProductMatrixSpace&
+   );
+   ///@}
+};
+
+} // namespace Ipopt
+#endif
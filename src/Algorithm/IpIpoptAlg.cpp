@@ -9,6 +9,7 @@
 #include "IpJournalist.hpp"
 #include "IpRestoPhase.hpp"
 #include "IpOrigIpoptNLP.hpp"
+#include "IpCheckpoint.hpp"
 
 #ifdef IPOPT_HAS_HSL
 #include "CoinHslConfig.h"
@@ -99,6 +100,32 @@ void IpoptAlgorithm::RegisterOptions(
       "you should not set any of those options explicitly in addition. "
       "Also, unless otherwise specified, the values of \"bound_push\", \"bound_frac\", and "
       "\"bound_mult_init_val\" are set more aggressive, and sets \"alpha_for_y=bound_mult\".");
+   roptions->SetRegisteringCategory("Warm Start");
+   roptions->AddStringOption1(
+      "checkpoint_file",
+      "File to which the state of the algorithm is written periodically (leave unset for no checkpoints).",
+      "",
+      "*", "Any acceptable standard file name",
+      "From such a checkpoint, an interrupted optimization can be continued with the option checkpoint_restart. "
+      "A checkpoint is first written to a temporary file with the additional extension .tmp, "
+      "which replaces the checkpoint file when it is complete. "
+      "No checkpoints are written during the restoration phase.");
+   roptions->AddLowerBoundedIntegerOption(
+      "checkpoint_interval",
+      "Number of iterations between two checkpoints.",
+      0,
+      10,
+      "If checkpoint_file is set, a checkpoint is written at every iteration whose number is a multiple of this value. "
+      "The value 0 disables the checkpoints.");
+   roptions->AddStringOption2(
+      "checkpoint_restart",
+      "Indicates whether the optimization continues from the checkpoint in checkpoint_file.",
+      "no",
+      "no", "Start the optimization from the initial point.",
+      "yes", "Continue from the state of the algorithm that has been written to the checkpoint.",
+      "The problem and all options, apart from the checkpoint options and options that only affect the output, "
+      "must be the same as for the run that wrote the checkpoint. "
+      "The continued run then performs the same iterations as the interrupted one would have done.");
    roptions->SetRegisteringCategory("");
    roptions->AddStringOption2("sb", "", "no", "no", "", "yes", "");
 }
@@ -175,6 +202,12 @@ bool IpoptAlgorithm::InitializeImpl(
 
    // Store which linear solver is chosen for later output
    options.GetStringValue("linear_solver", linear_solver_, prefix);
+   bool linear_solver_autotune;
+   options.GetBoolValue("linear_solver_autotune", linear_solver_autotune, prefix);
+   if( linear_solver_autotune )
+   {
+      linear_solver_ = "chosen by linear_solver_autotune";
+   }
 
    // Read the IpoptAlgorithm options
    // Initialize the Data object
@@ -231,10 +264,22 @@ bool IpoptAlgorithm::InitializeImpl(
    if( prefix == "resto." )
    {
       skip_print_problem_stats_ = true;
+      // the state of the restoration phase is not written to checkpoints
+      checkpoint_file_ = "";
+      checkpoint_interval_ = 0;
+      checkpoint_restart_ = false;
+      // the restoration phase problem keeps the scaling of the original NLP
+      nlp_scaling_update_frequency_ = 0;
    }
    else
    {
       skip_print_problem_stats_ = false;
+      options.GetStringValue("checkpoint_file", checkpoint_file_, prefix);
+      options.GetIntegerValue("checkpoint_interval", checkpoint_interval_, prefix);
+      options.GetBoolValue("checkpoint_restart", checkpoint_restart_, prefix);
+      options.GetIntegerValue("nlp_scaling_update_frequency", nlp_scaling_update_frequency_, prefix);
+      ASSERT_EXCEPTION(!checkpoint_restart_ || !checkpoint_file_.empty(), OPTION_INVALID,
+                       "Option \"checkpoint_restart\" requires that \"checkpoint_file\" is set.");
    }
 
    return true;
@@ -289,9 +334,14 @@ SolverReturn IpoptAlgorithm::Optimize(
          IpData().TimingStats().PrintProblemStatistics().End();
       }
 
+      // the derivatives at the current iterate are required from here on
+      PrecomputeDerivatives();
+
       IpData().TimingStats().CheckConvergence().Start();
       ConvergenceCheck::ConvergenceStatus conv_status = conv_check_->CheckConvergence();
       IpData().TimingStats().CheckConvergence().End();
+      IpData().TimingStats().EndIteration(IpData().iter_count());
+      IpData().WorkCounts().EndIteration(IpData().iter_count());
 
       // main loop
       while( conv_status == ConvergenceCheck::CONTINUE )
@@ -357,9 +407,26 @@ SolverReturn IpoptAlgorithm::Optimize(
 
          IpData().Set_iter_count(IpData().iter_count() + 1);
 
+         if( nlp_scaling_update_frequency_ > 0
+             && IpData().iter_count() % nlp_scaling_update_frequency_ == 0 )
+         {
+            UpdateNLPScaling();
+         }
+
+         PrecomputeDerivatives();
+
+         if( !checkpoint_file_.empty() && checkpoint_interval_ > 0
+             && IpData().iter_count() % checkpoint_interval_ == 0 )
+         {
+            SaveCheckpoint();
+         }
+
          IpData().TimingStats().CheckConvergence().Start();
          conv_status = conv_check_->CheckConvergence();
          IpData().TimingStats().CheckConvergence().End();
+
+         IpData().TimingStats().EndIteration(IpData().iter_count());
+         IpData().WorkCounts().EndIteration(IpData().iter_count());
       }
 
       IpData().TimingStats().OutputIteration().Start();
@@ -499,18 +566,28 @@ void IpoptAlgorithm::UpdateHessian()
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n");
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "*** Update HessianMatrix for Iteration %d:", IpData().iter_count());
+                  "*** Update HessianMatrix for Iteration %" IPOPT_INDEX_FORMAT ":", IpData().iter_count());
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n\n");
    hessian_updater_->UpdateHessian();
 }
 
+void IpoptAlgorithm::PrecomputeDerivatives()
+{
+   // the Hessian is evaluated with obj_factor 1 in curr_exact_hessian
+   if( !IpNLP().objective_depends_on_mu() )
+   {
+      SmartPtr<const IteratesVector> curr = IpData().curr();
+      IpNLP().PrecomputeDerivatives(*curr->x(), 1., *curr->y_c(), *curr->y_d());
+   }
+}
+
 bool IpoptAlgorithm::UpdateBarrierParameter()
 {
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n");
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "*** Update Barrier Parameter for Iteration %d:", IpData().iter_count());
+                  "*** Update Barrier Parameter for Iteration %" IPOPT_INDEX_FORMAT ":", IpData().iter_count());
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n\n");
    bool retval = mu_update_->UpdateBarrierParameter();
@@ -536,22 +613,28 @@ bool IpoptAlgorithm::ComputeSearchDirection()
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n");
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "*** Solving the Primal Dual System for Iteration %d:", IpData().iter_count());
+                  "*** Solving the Primal Dual System for Iteration %" IPOPT_INDEX_FORMAT ":", IpData().iter_count());
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n\n");
 
    bool retval = search_dir_calculator_->ComputeSearchDirection();
 
+   if( IpData().LowMemoryMode() )
+   {
+      // the corrector in the line search recomputes it if necessary
+      IpData().ReleaseAffineDeltas();
+   }
+
    if( retval )
    {
       Jnlst().Printf(J_MOREVECTOR, J_MAIN,
-                     "*** Step Calculated for Iteration: %d\n", IpData().iter_count());
+                     "*** Step Calculated for Iteration: %" IPOPT_INDEX_FORMAT "\n", IpData().iter_count());
       IpData().delta()->Print(Jnlst(), J_MOREVECTOR, J_MAIN, "delta");
    }
    else
    {
       Jnlst().Printf(J_DETAILED, J_MAIN,
-                     "*** Step could not be computed in iteration %d!\n", IpData().iter_count());
+                     "*** Step could not be computed in iteration %" IPOPT_INDEX_FORMAT "!\n", IpData().iter_count());
    }
 
    return retval;
@@ -562,12 +645,66 @@ void IpoptAlgorithm::ComputeAcceptableTrialPoint()
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n");
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "*** Finding Acceptable Trial Point for Iteration %d:", IpData().iter_count());
+                  "*** Finding Acceptable Trial Point for Iteration %" IPOPT_INDEX_FORMAT ":", IpData().iter_count());
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n\n");
    line_search_->FindAcceptableTrialPoint();
 }
 
+void IpoptAlgorithm::UpdateNLPScaling()
+{
+   DBG_START_METH("IpoptAlgorithm::UpdateNLPScaling", dbg_verbosity);
+
+   SmartPtr<Vector> c_factors;
+   SmartPtr<Vector> d_factors;
+   if( !IpNLP().ComputeConstraintScalingUpdate(*IpData().curr()->x(), c_factors, d_factors) )
+   {
+      return;
+   }
+
+   Jnlst().Printf(J_DETAILED, J_MAIN,
+                  "Updating the scaling of the constraints in iteration %" IPOPT_INDEX_FORMAT ".\n", IpData().iter_count());
+   c_factors->Print(Jnlst(), J_VECTOR, J_MAIN, "c_factors");
+   d_factors->Print(Jnlst(), J_VECTOR, J_MAIN, "d_factors");
+
+   IpNLP().ApplyConstraintScalingUpdate(*c_factors, *d_factors);
+
+   // Transform the iterate into the new scaling.  All components get
+   // new tags, so that no quantity computed in the old scaling is
+   // taken from a cache.
+   SmartPtr<IteratesVector> iterates = IpData().curr()->MakeNewIteratesVectorCopy();
+   iterates->s_NonConst()->ElementWiseMultiply(*d_factors);
+   iterates->y_c_NonConst()->ElementWiseDivide(*c_factors);
+   iterates->y_d_NonConst()->ElementWiseDivide(*d_factors);
+
+   SmartPtr<Vector> tmp = iterates->v_L()->MakeNew();
+   IpNLP().Pd_L()->TransMultVector(1., *d_factors, 0., *tmp);
+   iterates->v_L_NonConst()->ElementWiseDivide(*tmp);
+   tmp = iterates->v_U()->MakeNew();
+   IpNLP().Pd_U()->TransMultVector(1., *d_factors, 0., *tmp);
+   iterates->v_U_NonConst()->ElementWiseDivide(*tmp);
+
+   IpData().set_trial(iterates);
+   IpData().AcceptTrialPoint();
+   IpData().SetHaveAffineDeltas(false);
+
+   // the filter and the watchdog refer to the previous scaling
+   line_search_->ResetAfterScalingUpdate();
+   IpData().Append_info_string("S");
+
+   // remember the accumulated update for checkpoints
+   if( IsValid(nlp_scaling_c_factors_) )
+   {
+      nlp_scaling_c_factors_->ElementWiseMultiply(*c_factors);
+      nlp_scaling_d_factors_->ElementWiseMultiply(*d_factors);
+   }
+   else
+   {
+      nlp_scaling_c_factors_ = c_factors->MakeNewCopy();
+      nlp_scaling_d_factors_ = d_factors->MakeNewCopy();
+   }
+}
+
 void IpoptAlgorithm::OutputIteration()
 {
    iter_output_->WriteOutput();
@@ -577,10 +714,122 @@ void IpoptAlgorithm::InitializeIterates()
 {
    DBG_START_METH("IpoptAlgorithm::InitializeIterates", dbg_verbosity);
 
+   if( checkpoint_restart_ )
+   {
+      LoadCheckpoint();
+      return;
+   }
+
    bool retval = iterate_initializer_->SetInitialIterates();
    ASSERT_EXCEPTION(retval, FAILED_INITIALIZATION, "Error while obtaining initial iterates.");
 }
 
+void IpoptAlgorithm::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   IpData().WriteCheckpoint(checkpoint);
+
+   // the variable bounds might have been adjusted
+   checkpoint.WriteSection("IpoptNLP");
+   checkpoint.WriteBool(IsValid(nlp_scaling_c_factors_));
+   if( IsValid(nlp_scaling_c_factors_) )
+   {
+      checkpoint.WriteVector(*nlp_scaling_c_factors_);
+      checkpoint.WriteVector(*nlp_scaling_d_factors_);
+   }
+   checkpoint.WriteVector(*IpNLP().x_L());
+   checkpoint.WriteVector(*IpNLP().x_U());
+   checkpoint.WriteVector(*IpNLP().d_L());
+   checkpoint.WriteVector(*IpNLP().d_U());
+
+   search_dir_calculator_->WriteCheckpoint(checkpoint);
+   line_search_->WriteCheckpoint(checkpoint);
+   mu_update_->WriteCheckpoint(checkpoint);
+   conv_check_->WriteCheckpoint(checkpoint);
+   hessian_updater_->WriteCheckpoint(checkpoint);
+}
+
+void IpoptAlgorithm::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   IpData().ReadCheckpoint(checkpoint);
+
+   checkpoint.ReadSection("IpoptNLP");
+   nlp_scaling_c_factors_ = NULL;
+   nlp_scaling_d_factors_ = NULL;
+   if( checkpoint.ReadBool() )
+   {
+      // redo the updates of the constraint scaling before the bounds are restored
+      nlp_scaling_c_factors_ = IpData().curr()->y_c()->MakeNew();
+      nlp_scaling_d_factors_ = IpData().curr()->y_d()->MakeNew();
+      checkpoint.ReadVector(*nlp_scaling_c_factors_);
+      checkpoint.ReadVector(*nlp_scaling_d_factors_);
+      IpNLP().ApplyConstraintScalingUpdate(*nlp_scaling_c_factors_, *nlp_scaling_d_factors_);
+   }
+   SmartPtr<Vector> x_L = IpNLP().x_L()->MakeNew();
+   SmartPtr<Vector> x_U = IpNLP().x_U()->MakeNew();
+   SmartPtr<Vector> d_L = IpNLP().d_L()->MakeNew();
+   SmartPtr<Vector> d_U = IpNLP().d_U()->MakeNew();
+   checkpoint.ReadVector(*x_L);
+   checkpoint.ReadVector(*x_U);
+   checkpoint.ReadVector(*d_L);
+   checkpoint.ReadVector(*d_U);
+   IpNLP().AdjustVariableBounds(*x_L, *x_U, *d_L, *d_U);
+
+   search_dir_calculator_->ReadCheckpoint(checkpoint);
+   line_search_->ReadCheckpoint(checkpoint);
+   mu_update_->ReadCheckpoint(checkpoint);
+   conv_check_->ReadCheckpoint(checkpoint);
+   hessian_updater_->ReadCheckpoint(checkpoint);
+}
+
+void IpoptAlgorithm::SaveCheckpoint()
+{
+   DBG_START_METH("IpoptAlgorithm::SaveCheckpoint", dbg_verbosity);
+
+   Checkpoint checkpoint;
+   bool retval = checkpoint.OpenForWriting(checkpoint_file_);
+   if( retval )
+   {
+      WriteCheckpoint(checkpoint);
+      retval = checkpoint.Commit();
+   }
+   if( !retval )
+   {
+      // a failed checkpoint does not affect the optimization
+      Jnlst().Printf(J_WARNING, J_MAIN,
+                     "WARNING: Failed to write checkpoint file %s in iteration %" IPOPT_INDEX_FORMAT ".\n", checkpoint_file_.c_str(),
+                     IpData().iter_count());
+   }
+   else
+   {
+      Jnlst().Printf(J_DETAILED, J_MAIN,
+                     "Wrote checkpoint file %s in iteration %" IPOPT_INDEX_FORMAT ".\n", checkpoint_file_.c_str(), IpData().iter_count());
+   }
+}
+
+void IpoptAlgorithm::LoadCheckpoint()
+{
+   DBG_START_METH("IpoptAlgorithm::LoadCheckpoint", dbg_verbosity);
+
+   Checkpoint checkpoint;
+   bool retval = checkpoint.OpenForReading(checkpoint_file_);
+   ASSERT_EXCEPTION(retval, INVALID_WARMSTART,
+                    "Checkpoint file " + checkpoint_file_ + " cannot be opened or is not a checkpoint of this version of Ipopt.");
+
+   // the values of the iterates are read from the checkpoint
+   retval = IpData().InitializeDataStructures(IpNLP(), false, false, false, false, false);
+   ASSERT_EXCEPTION(retval, FAILED_INITIALIZATION, "Error while initializing the iterates.");
+
+   ReadCheckpoint(checkpoint);
+
+   Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
+                  "Continuing from checkpoint file %s at iteration %" IPOPT_INDEX_FORMAT ".\n\n", checkpoint_file_.c_str(),
+                  IpData().iter_count());
+}
+
 void IpoptAlgorithm::AcceptTrialPoint()
 {
    DBG_START_METH("IpoptAlgorithm::AcceptTrialPoint", dbg_verbosity);
@@ -593,6 +842,13 @@ void IpoptAlgorithm::AcceptTrialPoint()
       return;
    }
 
+   if( IpData().LowMemoryMode() )
+   {
+      // free the quantities of the current iterate before computing
+      // those of the trial point that is accepted
+      IpCq().ReleaseCurrVectors();
+   }
+
    // Adjust the bounds if necessary
    Index adjusted_slacks = IpCq().AdjustedTrialSlacks();
    DBG_PRINT((1, "adjusted_slacks = %d\n", adjusted_slacks));
@@ -602,12 +858,12 @@ void IpoptAlgorithm::AcceptTrialPoint()
       if( adjusted_slacks == 1 )
       {
          Jnlst().Printf(J_WARNING, J_MAIN,
-                        "In iteration %d, %d Slack too small, adjusting variable bound\n", IpData().iter_count(), adjusted_slacks);
+                        "In iteration %" IPOPT_INDEX_FORMAT ", %" IPOPT_INDEX_FORMAT " Slack too small, adjusting variable bound\n", IpData().iter_count(), adjusted_slacks);
       }
       else
       {
          Jnlst().Printf(J_WARNING, J_MAIN,
-                        "In iteration %d, %d Slacks too small, adjusting variable bounds\n", IpData().iter_count(), adjusted_slacks);
+                        "In iteration %" IPOPT_INDEX_FORMAT ", %" IPOPT_INDEX_FORMAT " Slacks too small, adjusting variable bounds\n", IpData().iter_count(), adjusted_slacks);
       }
       if( Jnlst().ProduceOutput(J_VECTOR, J_MAIN) )
       {
@@ -713,12 +969,9 @@ void IpoptAlgorithm::AcceptTrialPoint()
    }
    if( recalc_y_ && IpCq().curr_constraint_violation() < recalc_y_feas_tol_ )
    {
-      if( Jnlst().ProduceOutput(J_MOREDETAILED, J_MAIN) )
-      {
-         Jnlst().Printf(J_MOREDETAILED, J_MAIN,
-                        "dual infeasibility before least square multiplier update = %e\n",
-                        IpCq().curr_dual_infeasibility(NORM_MAX));
-      }
+      IPOPT_JNLST_PRINTF(Jnlst(), J_MOREDETAILED, J_MAIN,
+                         "dual infeasibility before least square multiplier update = %e\n",
+                         IpCq().curr_dual_infeasibility(NORM_MAX));
       IpData().Append_info_string("y ");
       DBG_ASSERT(IsValid(eq_multiplier_calculator_));
       if( IpData().curr()->y_c()->Dim() + IpData().curr()->y_d()->Dim() > 0 )
@@ -773,23 +1026,23 @@ void IpoptAlgorithm::PrintProblemStatistics()
                          ns_tot, ns_only_lower, ns_both, ns_only_upper);
 
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "Total number of variables............................: %8d\n", nx_tot);
+                  "Total number of variables............................: %8" IPOPT_INDEX_FORMAT "\n", nx_tot);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "                     variables with only lower bounds: %8d\n", nx_only_lower);
+                  "                     variables with only lower bounds: %8" IPOPT_INDEX_FORMAT "\n", nx_only_lower);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "                variables with lower and upper bounds: %8d\n", nx_both);
+                  "                variables with lower and upper bounds: %8" IPOPT_INDEX_FORMAT "\n", nx_both);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "                     variables with only upper bounds: %8d\n", nx_only_upper);
+                  "                     variables with only upper bounds: %8" IPOPT_INDEX_FORMAT "\n", nx_only_upper);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "Total number of equality constraints.................: %8d\n", IpData().curr()->y_c()->Dim());
+                  "Total number of equality constraints.................: %8" IPOPT_INDEX_FORMAT "\n", IpData().curr()->y_c()->Dim());
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "Total number of inequality constraints...............: %8d\n", ns_tot);
+                  "Total number of inequality constraints...............: %8" IPOPT_INDEX_FORMAT "\n", ns_tot);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "        inequality constraints with only lower bounds: %8d\n", ns_only_lower);
+                  "        inequality constraints with only lower bounds: %8" IPOPT_INDEX_FORMAT "\n", ns_only_lower);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "   inequality constraints with lower and upper bounds: %8d\n", ns_both);
+                  "   inequality constraints with lower and upper bounds: %8" IPOPT_INDEX_FORMAT "\n", ns_both);
    Jnlst().Printf(J_SUMMARY, J_STATISTICS,
-                  "        inequality constraints with only upper bounds: %8d\n\n", ns_only_upper);
+                  "        inequality constraints with only upper bounds: %8" IPOPT_INDEX_FORMAT "\n\n", ns_only_upper);
 }
 
 void IpoptAlgorithm::ComputeFeasibilityMultipliers()
@@ -86,6 +86,16 @@ public:
    );
    ///@}
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    /**@name Access to internal strategy objects */
    ///@{
    SmartPtr<SearchDirectionCalculator> SearchDirCalc()
@@ -147,6 +157,11 @@ private:
     */
    void UpdateHessian();
 
+   /** Method to let the NLP evaluate the constraint Jacobians and
+    *  the Hessian at the current iterate before they are requested.
+    */
+   void PrecomputeDerivatives();
+
    /** Method to update the barrier parameter.
     *
     *  @return false, if the algorithm can't continue with the
@@ -186,6 +201,21 @@ private:
    /** Print the problem size statistics */
    void PrintProblemStatistics();
 
+   /** Write a checkpoint to checkpoint_file_.
+    *
+    *  A failure is only reported by a warning.
+    */
+   void SaveCheckpoint();
+
+   /** Initialize the iterates and the state of the algorithm from the
+    *  checkpoint in checkpoint_file_ */
+   void LoadCheckpoint();
+
+   /** Update the scaling of the constraints if the scaling object
+    *  suggests it, and transform the current iterate into the new
+    *  scaling */
+   void UpdateNLPScaling();
+
    /** Compute the Lagrangian multipliers for a feasibility problem */
    void ComputeFeasibilityMultipliers();
    ///@}
@@ -220,6 +250,23 @@ private:
    bool mehrotra_algorithm_;
    /** String specifying linear solver */
    std::string linear_solver_;
+   /** File to which checkpoints are written, empty for none */
+   std::string checkpoint_file_;
+   /** Number of iterations between two checkpoints */
+   Index checkpoint_interval_;
+   /** Flag indicating whether the optimization continues from the
+    *  checkpoint in checkpoint_file_ */
+   bool checkpoint_restart_;
+   /** Number of iterations between two updates of the constraint
+    *  scaling, 0 for none */
+   Index nlp_scaling_update_frequency_;
+   ///@}
+
+   /** @name Accumulated updates of the constraint scaling, NULL if the
+    *  scaling has not been updated */
+   ///@{
+   SmartPtr<Vector> nlp_scaling_c_factors_;
+   SmartPtr<Vector> nlp_scaling_d_factors_;
    ///@}
 
    /** @name auxiliary functions */
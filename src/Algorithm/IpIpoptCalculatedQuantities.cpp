@@ -8,6 +8,10 @@
 #include "IpSumSymMatrix.hpp"
 #include "IpLowRankUpdateSymMatrix.hpp"
 #include "IpRestoIpoptNLP.hpp"
+#include "IpDenseVector.hpp"
+#include "IpCompoundVector.hpp"
+#include "IpCompoundMatrix.hpp"
+#include "IpExpansionMatrix.hpp"
 
 #include <cmath>
 #include <limits>
@@ -33,6 +37,10 @@ IpoptCalculatedQuantities::IpoptCalculatedQuantities(
      trial_slack_x_U_cache_(1),
      trial_slack_s_L_cache_(1),
      trial_slack_s_U_cache_(1),
+     slack_step_x_L_cache_(1),
+     slack_step_x_U_cache_(1),
+     slack_step_s_L_cache_(1),
+     slack_step_s_U_cache_(1),
      num_adjusted_slack_x_L_(0),
      num_adjusted_slack_x_U_(0),
      num_adjusted_slack_s_L_(0),
@@ -126,10 +134,19 @@ IpoptCalculatedQuantities::IpoptCalculatedQuantities(
    DBG_START_METH("IpoptCalculatedQuantities::IpoptCalculatedQuantities",
                   dbg_verbosity);
    DBG_ASSERT(IsValid(ip_nlp_) && IsValid(ip_data_));
+   for( Index i = 0; i < 4; i++ )
+   {
+      clean_curr_slack_tag_[i] = 0;
+      clean_trial_slack_tag_[i] = 0;
+   }
 }
 
 IpoptCalculatedQuantities::~IpoptCalculatedQuantities()
-{ }
+{
+   // the budget is declared before the caches, so it would be destroyed
+   // after them and could not detach from them anymore
+   vector_cache_budget_.RemoveCaches();
+}
 
 void IpoptCalculatedQuantities::RegisterOptions(
    SmartPtr<RegisteredOptions> roptions
@@ -171,6 +188,49 @@ void IpoptCalculatedQuantities::RegisterOptions(
       "2-norm", "use the 2-norm",
       "max-norm", "use the infinity norm",
       "Determines which norm should be used when the algorithm computes the constraint violation in the line search.");
+
+   roptions->SetRegisteringCategory("Main Algorithm");
+   roptions->AddLowerBoundedIntegerOption(
+      "cq_num_threads",
+      "Number of threads for computing the complementarity vectors and barrier terms.",
+      1,
+      1,
+      "If larger than 1, the complementarity vectors for the four types of bounds and the sums of the "
+      "logarithms of the slacks in the barrier term are computed concurrently. "
+      "The gradient of the Lagrangian and the dual infeasibility are not covered by this option, "
+      "since they are dominated by products with the constraint Jacobians. "
+      "This has only an effect if Ipopt has been compiled with OpenMP support.");
+   roptions->AddLowerBoundedIntegerOption(
+      "trial_slack_refresh",
+      "Number of iterations between computations of the slacks of trial points from the trial points.",
+      0,
+      0,
+      "If positive, the slacks to the bounds at a trial point of the line search are obtained "
+      "by adding the step, multiplied by the step size, to the slacks at the current point. "
+      "This avoids the gathering of the bounded variables and constraints for each trial point. "
+      "To remove the accumulated rounding errors, the slacks are computed from the trial point "
+      "in every iteration whose number is a multiple of this value. "
+      "The value 0 means that the slacks are always computed from the trial point.");
+   roptions->AddStringOption3(
+      "cq_vector_cache_sizes",
+      "Number of vectors kept in the caches of calculated quantities.",
+      "default",
+      "default", "use the built-in cache size of each quantity",
+      "minimal", "keep at most one vector for each quantity",
+      "extended", "keep twice as many vectors as by default for each quantity",
+      "The calculated quantities, e.g., gradients, constraint values, and complementarity products, "
+      "are cached for the current and trial iterates to avoid recomputing them. "
+      "Smaller caches need less memory, larger caches can avoid recomputations. "
+      "Quantities that are not cached by default are never cached.");
+   roptions->AddLowerBoundedNumberOption(
+      "cq_vector_cache_budget",
+      "Maximal memory in MB for the vectors in the caches of calculated quantities.",
+      0., false,
+      0.,
+      "If positive, the largest cached vectors are removed from the caches of the calculated quantities "
+      "whenever the memory of all cached vectors exceeds this budget. "
+      "The vector that has just been computed is never removed. "
+      "The value 0 means that there is no budget.");
 }
 
 bool IpoptCalculatedQuantities::Initialize(
@@ -187,6 +247,12 @@ bool IpoptCalculatedQuantities::Initialize(
    options.GetNumericValue("slack_move", slack_move_, prefix);
    options.GetEnumValue("constraint_violation_norm_type", enum_int, prefix);
    constr_viol_normtype_ = ENormType(enum_int);
+   options.GetIntegerValue("cq_num_threads", cq_num_threads_, prefix);
+   options.GetIntegerValue("trial_slack_refresh", trial_slack_refresh_, prefix);
+   options.GetEnumValue("cq_vector_cache_sizes", enum_int, prefix);
+   vector_cache_sizes_ = VectorCacheSizes(enum_int);
+   Number vector_cache_budget;
+   options.GetNumericValue("cq_vector_cache_budget", vector_cache_budget, prefix);
    // The following option is registered by OrigIpoptNLP
    options.GetBoolValue("warm_start_same_structure", warm_start_same_structure_, prefix);
    options.GetNumericValue("mu_target", mu_target_, prefix);
@@ -208,6 +274,47 @@ bool IpoptCalculatedQuantities::Initialize(
       tmp_s_U_ = NULL;
    }
 
+   vector_cache_budget_.RemoveCaches();
+   vector_cache_budget_.SetMaxBytes((std::size_t) (vector_cache_budget * 1e6));
+   ConfigureVectorCache(curr_grad_f_cache_);
+   ConfigureVectorCache(trial_grad_f_cache_);
+   ConfigureVectorCache(curr_grad_barrier_obj_x_cache_);
+   ConfigureVectorCache(curr_grad_barrier_obj_s_cache_);
+   ConfigureVectorCache(grad_kappa_times_damping_x_cache_);
+   ConfigureVectorCache(grad_kappa_times_damping_s_cache_);
+   ConfigureVectorCache(curr_c_cache_);
+   ConfigureVectorCache(trial_c_cache_);
+   ConfigureVectorCache(curr_d_cache_);
+   ConfigureVectorCache(trial_d_cache_);
+   ConfigureVectorCache(curr_d_minus_s_cache_);
+   ConfigureVectorCache(trial_d_minus_s_cache_);
+   ConfigureVectorCache(curr_jac_cT_times_vec_cache_);
+   ConfigureVectorCache(trial_jac_cT_times_vec_cache_);
+   ConfigureVectorCache(curr_jac_dT_times_vec_cache_);
+   ConfigureVectorCache(trial_jac_dT_times_vec_cache_);
+   ConfigureVectorCache(curr_jac_c_times_vec_cache_);
+   ConfigureVectorCache(curr_jac_d_times_vec_cache_);
+   ConfigureVectorCache(curr_grad_lag_x_cache_);
+   ConfigureVectorCache(trial_grad_lag_x_cache_);
+   ConfigureVectorCache(curr_grad_lag_s_cache_);
+   ConfigureVectorCache(trial_grad_lag_s_cache_);
+   ConfigureVectorCache(curr_grad_lag_with_damping_x_cache_);
+   ConfigureVectorCache(curr_grad_lag_with_damping_s_cache_);
+   ConfigureVectorCache(curr_compl_x_L_cache_);
+   ConfigureVectorCache(curr_compl_x_U_cache_);
+   ConfigureVectorCache(curr_compl_s_L_cache_);
+   ConfigureVectorCache(curr_compl_s_U_cache_);
+   ConfigureVectorCache(trial_compl_x_L_cache_);
+   ConfigureVectorCache(trial_compl_x_U_cache_);
+   ConfigureVectorCache(trial_compl_s_L_cache_);
+   ConfigureVectorCache(trial_compl_s_U_cache_);
+   ConfigureVectorCache(curr_relaxed_compl_x_L_cache_);
+   ConfigureVectorCache(curr_relaxed_compl_x_U_cache_);
+   ConfigureVectorCache(curr_relaxed_compl_s_L_cache_);
+   ConfigureVectorCache(curr_relaxed_compl_s_U_cache_);
+   ConfigureVectorCache(curr_sigma_x_cache_);
+   ConfigureVectorCache(curr_sigma_s_cache_);
+
    num_adjusted_slack_x_L_ = 0;
    num_adjusted_slack_x_U_ = 0;
    num_adjusted_slack_s_L_ = 0;
@@ -223,6 +330,33 @@ bool IpoptCalculatedQuantities::Initialize(
    return retval;
 }
 
+void IpoptCalculatedQuantities::ConfigureVectorCache(
+   CachedResults<SmartPtr<const Vector> >& cache
+)
+{
+   Int size = cache.InitialMaxCacheSize();
+   if( size > 0 )
+   {
+      switch( vector_cache_sizes_ )
+      {
+         case VCS_MINIMAL:
+            size = 1;
+            break;
+         case VCS_EXTENDED:
+            size *= 2;
+            break;
+         default:
+            break;
+      }
+   }
+   cache.Clear(size);
+
+   if( vector_cache_budget_.MaxBytes() > 0 )
+   {
+      vector_cache_budget_.AddCache(cache);
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 //                         Slack Calculations                            //
 ///////////////////////////////////////////////////////////////////////////
@@ -257,6 +391,67 @@ SmartPtr<Vector> IpoptCalculatedQuantities::CalcSlack_U(
    return result;
 }
 
+SmartPtr<Vector> IpoptCalculatedQuantities::CalcTrialSlackFromStep(
+   Index         bound_type,
+   const Matrix& P,
+   const Vector& x_bound
+)
+{
+   DBG_START_METH("IpoptCalculatedQuantities::CalcTrialSlackFromStep",
+                  dbg_verbosity);
+   SmartPtr<Vector> result;
+   if( trial_slack_refresh_ == 0 || ip_data_->iter_count() % trial_slack_refresh_ == 0 )
+   {
+      return result;
+   }
+
+   SmartPtr<const Vector> base_x;
+   SmartPtr<const Vector> delta_x;
+   SmartPtr<const Vector> base_s;
+   SmartPtr<const Vector> delta_s;
+   Number alpha;
+   if( !ip_data_->GetTrialPrimalStep(base_x, delta_x, base_s, delta_s, alpha) )
+   {
+      return result;
+   }
+   const bool primal_x = (bound_type == 0 || bound_type == 1);
+   const bool lower = (bound_type == 0 || bound_type == 2);
+   const Vector& base = primal_x ? *base_x : *base_s;
+   const Vector& delta = primal_x ? *delta_x : *delta_s;
+
+   // the slacks at the base point must be known and must not have been
+   // corrected by CalculateSafeSlack
+   CachedResults<SmartPtr<Vector> >* curr_caches[4] =
+   {
+      &curr_slack_x_L_cache_, &curr_slack_x_U_cache_, &curr_slack_s_L_cache_, &curr_slack_s_U_cache_
+   };
+   SmartPtr<Vector> base_slack;
+   if( !curr_caches[bound_type]->GetCachedResult1Dep(base_slack, base)
+       || (base_slack->GetTag() != clean_curr_slack_tag_[bound_type]
+           && base_slack->GetTag() != clean_trial_slack_tag_[bound_type]) )
+   {
+      return result;
+   }
+
+   // the step in the slacks is shared by all trial points of this step
+   CachedResults<SmartPtr<const Vector> >* step_caches[4] =
+   {
+      &slack_step_x_L_cache_, &slack_step_x_U_cache_, &slack_step_s_L_cache_, &slack_step_s_U_cache_
+   };
+   SmartPtr<const Vector> slack_step;
+   if( !step_caches[bound_type]->GetCachedResult1Dep(slack_step, delta) )
+   {
+      SmartPtr<Vector> tmp = x_bound.MakeNew();
+      P.TransMultVector(1.0, delta, 0.0, *tmp);
+      slack_step = ConstPtr(tmp);
+      step_caches[bound_type]->AddCachedResult1Dep(slack_step, delta);
+   }
+
+   result = x_bound.MakeNew();
+   result->AddTwoVectors(1.0, *base_slack, lower ? alpha : -alpha, *slack_step, 0.0);
+   return result;
+}
+
 SmartPtr<const Vector> IpoptCalculatedQuantities::curr_slack_x_L()
 {
    DBG_START_METH("IpoptCalculatedQuantities::curr_slack_x_L()",
@@ -266,13 +461,18 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_slack_x_L()
    SmartPtr<const Vector> x_bound = ip_nlp_->x_L();
    if( !curr_slack_x_L_cache_.GetCachedResult1Dep(result, *x) )
    {
-      if( !trial_slack_x_L_cache_.GetCachedResult1Dep(result, *x) )
+      if( trial_slack_x_L_cache_.GetCachedResult1Dep(result, *x) )
+      {
+         clean_curr_slack_tag_[0] = clean_trial_slack_tag_[0];
+      }
+      else
       {
          SmartPtr<const Matrix> P = ip_nlp_->Px_L();
          DBG_PRINT_VECTOR(2, "x_L", *x_bound);
          result = CalcSlack_L(*P, *x, *x_bound);
          DBG_ASSERT(num_adjusted_slack_x_L_ == 0);
          num_adjusted_slack_x_L_ = CalculateSafeSlack(result, x_bound, x, ip_data_->curr()->z_L());
+         clean_curr_slack_tag_[0] = (num_adjusted_slack_x_L_ == 0) ? result->GetTag() : 0;
       }
       curr_slack_x_L_cache_.AddCachedResult1Dep(result, *x);
    }
@@ -289,12 +489,17 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_slack_x_U()
    SmartPtr<const Vector> x_bound = ip_nlp_->x_U();
    if( !curr_slack_x_U_cache_.GetCachedResult1Dep(result, *x) )
    {
-      if( !trial_slack_x_U_cache_.GetCachedResult1Dep(result, *x) )
+      if( trial_slack_x_U_cache_.GetCachedResult1Dep(result, *x) )
+      {
+         clean_curr_slack_tag_[1] = clean_trial_slack_tag_[1];
+      }
+      else
       {
          SmartPtr<const Matrix> P = ip_nlp_->Px_U();
          result = CalcSlack_U(*P, *x, *x_bound);
          DBG_ASSERT(num_adjusted_slack_x_U_ == 0);
          num_adjusted_slack_x_U_ = CalculateSafeSlack(result, x_bound, x, ip_data_->curr()->z_U());
+         clean_curr_slack_tag_[1] = (num_adjusted_slack_x_U_ == 0) ? result->GetTag() : 0;
       }
       curr_slack_x_U_cache_.AddCachedResult1Dep(result, *x);
    }
@@ -311,12 +516,17 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_slack_s_L()
    SmartPtr<const Vector> s_bound = ip_nlp_->d_L();
    if( !curr_slack_s_L_cache_.GetCachedResult1Dep(result, *s) )
    {
-      if( !trial_slack_s_L_cache_.GetCachedResult1Dep(result, *s) )
+      if( trial_slack_s_L_cache_.GetCachedResult1Dep(result, *s) )
+      {
+         clean_curr_slack_tag_[2] = clean_trial_slack_tag_[2];
+      }
+      else
       {
          SmartPtr<const Matrix> P = ip_nlp_->Pd_L();
          result = CalcSlack_L(*P, *s, *s_bound);
          DBG_ASSERT(num_adjusted_slack_s_L_ == 0);
          num_adjusted_slack_s_L_ = CalculateSafeSlack(result, s_bound, s, ip_data_->curr()->v_L());
+         clean_curr_slack_tag_[2] = (num_adjusted_slack_s_L_ == 0) ? result->GetTag() : 0;
       }
       curr_slack_s_L_cache_.AddCachedResult1Dep(result, *s);
    }
@@ -333,12 +543,17 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_slack_s_U()
    SmartPtr<const Vector> s_bound = ip_nlp_->d_U();
    if( !curr_slack_s_U_cache_.GetCachedResult1Dep(result, *s) )
    {
-      if( !trial_slack_s_U_cache_.GetCachedResult1Dep(result, *s) )
+      if( trial_slack_s_U_cache_.GetCachedResult1Dep(result, *s) )
+      {
+         clean_curr_slack_tag_[3] = clean_trial_slack_tag_[3];
+      }
+      else
       {
          SmartPtr<const Matrix> P = ip_nlp_->Pd_U();
          result = CalcSlack_U(*P, *s, *s_bound);
          DBG_ASSERT(num_adjusted_slack_s_U_ == 0);
          num_adjusted_slack_s_U_ = CalculateSafeSlack(result, s_bound, s, ip_data_->curr()->v_U());
+         clean_curr_slack_tag_[3] = (num_adjusted_slack_s_U_ == 0) ? result->GetTag() : 0;
          DBG_PRINT_VECTOR(2, "result", *result);
          DBG_PRINT((1, "num_adjusted_slack_s_U = %d\n", num_adjusted_slack_s_U_));
       }
@@ -361,9 +576,14 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_slack_x_L()
       if( !curr_slack_x_L_cache_.GetCachedResult1Dep(result, *x) )
       {
          SmartPtr<const Matrix> P = ip_nlp_->Px_L();
-         result = CalcSlack_L(*P, *x, *x_bound);
+         result = CalcTrialSlackFromStep(0, *P, *x_bound);
+         if( IsNull(result) )
+         {
+            result = CalcSlack_L(*P, *x, *x_bound);
+         }
          DBG_ASSERT(num_adjusted_slack_x_L_ == 0);
          num_adjusted_slack_x_L_ = CalculateSafeSlack(result, x_bound, x, ip_data_->curr()->z_L());
+         clean_trial_slack_tag_[0] = (num_adjusted_slack_x_L_ == 0) ? result->GetTag() : 0;
       }
       trial_slack_x_L_cache_.AddCachedResult1Dep(result, *x);
    }
@@ -384,9 +604,14 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_slack_x_U()
       if( !curr_slack_x_U_cache_.GetCachedResult1Dep(result, *x) )
       {
          SmartPtr<const Matrix> P = ip_nlp_->Px_U();
-         result = CalcSlack_U(*P, *x, *x_bound);
+         result = CalcTrialSlackFromStep(1, *P, *x_bound);
+         if( IsNull(result) )
+         {
+            result = CalcSlack_U(*P, *x, *x_bound);
+         }
          DBG_ASSERT(num_adjusted_slack_x_U_ == 0);
          num_adjusted_slack_x_U_ = CalculateSafeSlack(result, x_bound, x, ip_data_->curr()->z_U());
+         clean_trial_slack_tag_[1] = (num_adjusted_slack_x_U_ == 0) ? result->GetTag() : 0;
       }
       trial_slack_x_U_cache_.AddCachedResult1Dep(result, *x);
    }
@@ -407,9 +632,14 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_slack_s_L()
       if( !curr_slack_s_L_cache_.GetCachedResult1Dep(result, *s) )
       {
          SmartPtr<const Matrix> P = ip_nlp_->Pd_L();
-         result = CalcSlack_L(*P, *s, *s_bound);
+         result = CalcTrialSlackFromStep(2, *P, *s_bound);
+         if( IsNull(result) )
+         {
+            result = CalcSlack_L(*P, *s, *s_bound);
+         }
          DBG_ASSERT(num_adjusted_slack_s_L_ == 0);
          num_adjusted_slack_s_L_ = CalculateSafeSlack(result, s_bound, s, ip_data_->curr()->v_L());
+         clean_trial_slack_tag_[2] = (num_adjusted_slack_s_L_ == 0) ? result->GetTag() : 0;
       }
       trial_slack_s_L_cache_.AddCachedResult1Dep(result, *s);
    }
@@ -432,10 +662,15 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_slack_s_U()
          SmartPtr<const Matrix> P = ip_nlp_->Pd_U();
          DBG_PRINT_VECTOR(2, "d_U", *s_bound);
          DBG_PRINT_VECTOR(2, "s", *s);
-         result = CalcSlack_U(*P, *s, *s_bound);
+         result = CalcTrialSlackFromStep(3, *P, *s_bound);
+         if( IsNull(result) )
+         {
+            result = CalcSlack_U(*P, *s, *s_bound);
+         }
          DBG_PRINT_VECTOR(2, "result", *result);
          DBG_ASSERT(num_adjusted_slack_s_U_ == 0);
          num_adjusted_slack_s_U_ = CalculateSafeSlack(result, s_bound, s, ip_data_->curr()->v_U());
+         clean_trial_slack_tag_[3] = (num_adjusted_slack_s_U_ == 0) ? result->GetTag() : 0;
          DBG_PRINT((1, "num_adjusted_slack_s_U = %d\n", num_adjusted_slack_s_U_));
          DBG_PRINT_VECTOR(2, "trial_slack_s_U", *result);
       }
@@ -533,6 +768,44 @@ void IpoptCalculatedQuantities::ResetAdjustedTrialSlacks()
    num_adjusted_slack_x_L_ = num_adjusted_slack_x_U_ = num_adjusted_slack_s_L_ = num_adjusted_slack_s_U_ = 0;
 }
 
+void IpoptCalculatedQuantities::ReleaseCurrVectors()
+{
+   DBG_START_METH("IpoptCalculatedQuantities::ReleaseCurrVectors()",
+                  dbg_verbosity);
+   curr_slack_x_L_cache_.Clear();
+   curr_slack_x_U_cache_.Clear();
+   curr_slack_s_L_cache_.Clear();
+   curr_slack_s_U_cache_.Clear();
+   slack_step_x_L_cache_.Clear();
+   slack_step_x_U_cache_.Clear();
+   slack_step_s_L_cache_.Clear();
+   slack_step_s_U_cache_.Clear();
+   curr_grad_f_cache_.Clear();
+   curr_grad_barrier_obj_x_cache_.Clear();
+   curr_grad_barrier_obj_s_cache_.Clear();
+   curr_c_cache_.Clear();
+   curr_d_cache_.Clear();
+   curr_d_minus_s_cache_.Clear();
+   curr_jac_cT_times_vec_cache_.Clear();
+   curr_jac_dT_times_vec_cache_.Clear();
+   curr_jac_c_times_vec_cache_.Clear();
+   curr_jac_d_times_vec_cache_.Clear();
+   curr_grad_lag_x_cache_.Clear();
+   curr_grad_lag_s_cache_.Clear();
+   curr_grad_lag_with_damping_x_cache_.Clear();
+   curr_grad_lag_with_damping_s_cache_.Clear();
+   curr_compl_x_L_cache_.Clear();
+   curr_compl_x_U_cache_.Clear();
+   curr_compl_s_L_cache_.Clear();
+   curr_compl_s_U_cache_.Clear();
+   curr_relaxed_compl_x_L_cache_.Clear();
+   curr_relaxed_compl_x_U_cache_.Clear();
+   curr_relaxed_compl_s_L_cache_.Clear();
+   curr_relaxed_compl_s_U_cache_.Clear();
+   curr_sigma_x_cache_.Clear();
+   curr_sigma_s_cache_.Clear();
+}
+
 ///////////////////////////////////////////////////////////////////////////
 //                          Objective Function                           //
 ///////////////////////////////////////////////////////////////////////////
@@ -544,7 +817,7 @@ Number IpoptCalculatedQuantities::curr_f()
    Number result;
    SmartPtr<const Vector> x = ip_data_->curr()->x();
    DBG_PRINT_VECTOR(2, "curr_x", *x);
-   DBG_PRINT((1, "curr_x tag = %u\n", x->GetTag()));
+   DBG_PRINT((1, "curr_x tag = %llu\n", x->GetTag()));
 
    bool objective_depends_on_mu = ip_nlp_->objective_depends_on_mu();
    std::vector<const TaggedObject*> tdeps(1);
@@ -591,7 +864,7 @@ Number IpoptCalculatedQuantities::trial_f()
    Number result;
    SmartPtr<const Vector> x = ip_data_->trial()->x();
    DBG_PRINT_VECTOR(2, "trial_x", *x);
-   DBG_PRINT((1, "trial_x tag = %u\n", x->GetTag()));
+   DBG_PRINT((1, "trial_x tag = %llu\n", x->GetTag()));
 
    bool objective_depends_on_mu = ip_nlp_->objective_depends_on_mu();
    std::vector<const TaggedObject*> tdeps(1);
@@ -828,6 +1101,11 @@ Number IpoptCalculatedQuantities::trial_barrier_obj()
          result = trial_f();
          DBG_PRINT((1, "trial_F=%e\n", result));
          DBG_PRINT_VECTOR(2, "trial_slack_s_U", *trial_slack_s_U());
+         if( cq_num_threads_ > 1 )
+         {
+            ComputeSlackSumLogsConcurrently(*trial_slack_x_L(), *trial_slack_x_U(), *trial_slack_s_L(),
+                                            *trial_slack_s_U());
+         }
          result += CalcBarrierTerm(ip_data_->curr_mu(), *trial_slack_x_L(), *trial_slack_x_U(), *trial_slack_s_L(),
                                    *trial_slack_s_U());
       }
@@ -1482,23 +1760,11 @@ Number IpoptCalculatedQuantities::curr_nlp_constraint_violation(
 
       SmartPtr<Vector> d_viol_L = ip_nlp_->d_L()->MakeNewCopy();
       ip_nlp_->Pd_L()->TransMultVector(-1., *d, 1., *d_viol_L);
-      SmartPtr<Vector> tmp = d_viol_L->MakeNew();
-      tmp->Set(0.);
-      d_viol_L->ElementWiseMax(*tmp);
-      DBG_PRINT_VECTOR(2, "d_viol_L", *d_viol_L);
 
       SmartPtr<Vector> d_viol_U = ip_nlp_->d_U()->MakeNewCopy();
       ip_nlp_->Pd_U()->TransMultVector(-1., *d, 1., *d_viol_U);
-      tmp = d_viol_U->MakeNew();
-      tmp->Set(0.);
-      d_viol_U->ElementWiseMin(*tmp);
-      DBG_PRINT_VECTOR(2, "d_viol_U", *d_viol_U);
-
-      std::vector<SmartPtr<const Vector> > vecs(3);
-      vecs[0] = c;
-      vecs[1] = GetRawPtr(d_viol_L);
-      vecs[2] = GetRawPtr(d_viol_U);
-      result = CalcNormOfType(NormType, vecs);
+
+      result = CalcNormOfViolation(NormType, *c, *d_viol_L, *d_viol_U);
       curr_nlp_constraint_violation_cache_.AddCachedResult(result, deps, sdeps);
    }
 
@@ -1522,7 +1788,12 @@ Number IpoptCalculatedQuantities::unscaled_curr_nlp_constraint_violation(
 
    if( !unscaled_curr_nlp_constraint_violation_cache_.GetCachedResult(result, deps, sdeps) )
    {
-      if( !unscaled_trial_nlp_constraint_violation_cache_.GetCachedResult(result, deps, sdeps) )
+      if( !ip_nlp_->NLP_scaling()->have_c_scaling() && !ip_nlp_->NLP_scaling()->have_d_scaling() )
+      {
+         // the unscaled violation is the same as the scaled one
+         result = curr_nlp_constraint_violation(NormType);
+      }
+      else if( !unscaled_trial_nlp_constraint_violation_cache_.GetCachedResult(result, deps, sdeps) )
       {
          SmartPtr<const Vector> c = unscaled_curr_c();
 
@@ -1536,11 +1807,7 @@ Number IpoptCalculatedQuantities::unscaled_curr_nlp_constraint_violation(
             ip_nlp_->Pd_L()->MultVector(1., *d_L, -1., *d_viol);
             SmartPtr<const Vector> d_viol2 = ip_nlp_->NLP_scaling()->unapply_vector_scaling_d(ConstPtr(d_viol));
             ip_nlp_->Pd_L()->TransMultVector(1., *d_viol2, 0., *d_viol_L);
-            SmartPtr<Vector> tmp = d_viol_L->MakeNew();
-            tmp->Set(0.);
-            d_viol_L->ElementWiseMax(*tmp);
          }
-         DBG_PRINT_VECTOR(2, "d_viol_L", *d_viol_L);
 
          SmartPtr<const Vector> d_U = ip_nlp_->d_U();
          SmartPtr<Vector> d_viol_U = d_U->MakeNew();
@@ -1550,17 +1817,9 @@ Number IpoptCalculatedQuantities::unscaled_curr_nlp_constraint_violation(
             ip_nlp_->Pd_U()->MultVector(1., *d_U, -1., *d_viol);
             SmartPtr<const Vector> d_viol2 = ip_nlp_->NLP_scaling()->unapply_vector_scaling_d(ConstPtr(d_viol));
             ip_nlp_->Pd_U()->TransMultVector(1., *d_viol2, 0., *d_viol_U);
-            SmartPtr<Vector> tmp = d_viol_U->MakeNew();
-            tmp->Set(0.);
-            d_viol_U->ElementWiseMin(*tmp);
          }
-         DBG_PRINT_VECTOR(2, "d_viol_U", *d_viol_U);
 
-         std::vector<SmartPtr<const Vector> > vecs(3);
-         vecs[0] = c;
-         vecs[1] = GetRawPtr(d_viol_L);
-         vecs[2] = GetRawPtr(d_viol_U);
-         result = CalcNormOfType(NormType, vecs);
+         result = CalcNormOfViolation(NormType, *c, *d_viol_L, *d_viol_U);
       }
       unscaled_curr_nlp_constraint_violation_cache_.AddCachedResult(result, deps, sdeps);
    }
@@ -1599,11 +1858,7 @@ Number IpoptCalculatedQuantities::unscaled_trial_nlp_constraint_violation(
             ip_nlp_->Pd_L()->MultVector(1., *d_L, -1., *d_viol);
             SmartPtr<const Vector> d_viol2 = ip_nlp_->NLP_scaling()->unapply_vector_scaling_d(ConstPtr(d_viol));
             ip_nlp_->Pd_L()->TransMultVector(1., *d_viol2, 0., *d_viol_L);
-            SmartPtr<Vector> tmp = d_viol_L->MakeNew();
-            tmp->Set(0.);
-            d_viol_L->ElementWiseMax(*tmp);
          }
-         DBG_PRINT_VECTOR(2, "d_viol_L", *d_viol_L);
 
          SmartPtr<const Vector> d_U = ip_nlp_->d_U();
          SmartPtr<Vector> d_viol_U = d_U->MakeNew();
@@ -1613,17 +1868,9 @@ Number IpoptCalculatedQuantities::unscaled_trial_nlp_constraint_violation(
             ip_nlp_->Pd_U()->MultVector(1., *d_U, -1., *d_viol);
             SmartPtr<const Vector> d_viol2 = ip_nlp_->NLP_scaling()->unapply_vector_scaling_d(ConstPtr(d_viol));
             ip_nlp_->Pd_U()->TransMultVector(1., *d_viol2, 0., *d_viol_U);
-            SmartPtr<Vector> tmp = d_viol_U->MakeNew();
-            tmp->Set(0.);
-            d_viol_U->ElementWiseMin(*tmp);
          }
-         DBG_PRINT_VECTOR(2, "d_viol_U", *d_viol_U);
 
-         std::vector<SmartPtr<const Vector> > vecs(3);
-         vecs[0] = c;
-         vecs[1] = GetRawPtr(d_viol_L);
-         vecs[2] = GetRawPtr(d_viol_U);
-         result = CalcNormOfType(NormType, vecs);
+         result = CalcNormOfViolation(NormType, *c, *d_viol_L, *d_viol_U);
       }
       unscaled_trial_nlp_constraint_violation_cache_.AddCachedResult(result, deps, sdeps);
    }
@@ -1705,12 +1952,11 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_grad_lag_x()
       {
          SmartPtr<Vector> tmp = x->MakeNew();
          DBG_PRINT_VECTOR(2, "curr_grad_f", *curr_grad_f());
-         tmp->Copy(*curr_grad_f());
-         tmp->AddTwoVectors(1., *curr_jac_cT_times_curr_y_c(), 1., *curr_jac_dT_times_curr_y_d(), 1.);
          DBG_PRINT_VECTOR(2, "jac_cT*y_c", *curr_jac_cT_times_curr_y_c());
          DBG_PRINT_VECTOR(2, "jac_dT*y_d", *curr_jac_dT_times_curr_y_d());
-         ip_nlp_->Px_L()->MultVector(-1., *z_L, 1., *tmp);
-         ip_nlp_->Px_U()->MultVector(1., *z_U, 1., *tmp);
+         CalcGradLag(*tmp, 1., *curr_grad_f(), GetRawPtr(curr_jac_cT_times_curr_y_c()),
+                     GetRawPtr(curr_jac_dT_times_curr_y_d()), GetRawPtr(ip_nlp_->Px_L()), GetRawPtr(z_L),
+                     GetRawPtr(ip_nlp_->Px_U()), GetRawPtr(z_U), false);
          result = ConstPtr(tmp);
       }
       curr_grad_lag_x_cache_.AddCachedResult(result, deps);
@@ -1744,10 +1990,9 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_grad_lag_x()
       {
          SmartPtr<Vector> tmp = x->MakeNew();
          DBG_PRINT_VECTOR(2, "trial_grad_f", *trial_grad_f());
-         tmp->Copy(*trial_grad_f());
-         tmp->AddTwoVectors(1., *trial_jac_cT_times_trial_y_c(), 1., *trial_jac_dT_times_trial_y_d(), 1.);
-         ip_nlp_->Px_L()->MultVector(-1., *z_L, 1., *tmp);
-         ip_nlp_->Px_U()->MultVector(1., *z_U, 1., *tmp);
+         CalcGradLag(*tmp, 1., *trial_grad_f(), GetRawPtr(trial_jac_cT_times_trial_y_c()),
+                     GetRawPtr(trial_jac_dT_times_trial_y_d()), GetRawPtr(ip_nlp_->Px_L()), GetRawPtr(z_L),
+                     GetRawPtr(ip_nlp_->Px_U()), GetRawPtr(z_U), false);
          result = ConstPtr(tmp);
       }
       trial_grad_lag_x_cache_.AddCachedResult(result, deps);
@@ -1776,9 +2021,8 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_grad_lag_s()
       if( !trial_grad_lag_s_cache_.GetCachedResult(result, deps) )
       {
          SmartPtr<Vector> tmp = y_d->MakeNew();
-         ip_nlp_->Pd_U()->MultVector(1., *v_U, 0., *tmp);
-         ip_nlp_->Pd_L()->MultVector(-1., *v_L, 1., *tmp);
-         tmp->Axpy(-1., *y_d);
+         CalcGradLag(*tmp, -1., *y_d, NULL, NULL, GetRawPtr(ip_nlp_->Pd_L()), GetRawPtr(v_L), GetRawPtr(ip_nlp_->Pd_U()),
+                     GetRawPtr(v_U), true);
          result = ConstPtr(tmp);
       }
       curr_grad_lag_s_cache_.AddCachedResult(result, deps);
@@ -1807,9 +2051,8 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_grad_lag_s()
       if( !curr_grad_lag_s_cache_.GetCachedResult(result, deps) )
       {
          SmartPtr<Vector> tmp = y_d->MakeNew();
-         ip_nlp_->Pd_U()->MultVector(1., *v_U, 0., *tmp);
-         ip_nlp_->Pd_L()->MultVector(-1., *v_L, 1., *tmp);
-         tmp->Axpy(-1., *y_d);
+         CalcGradLag(*tmp, -1., *y_d, NULL, NULL, GetRawPtr(ip_nlp_->Pd_L()), GetRawPtr(v_L), GetRawPtr(ip_nlp_->Pd_U()),
+                     GetRawPtr(v_U), true);
          result = ConstPtr(tmp);
       }
       trial_grad_lag_s_cache_.AddCachedResult(result, deps);
@@ -1818,6 +2061,292 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::trial_grad_lag_s()
    return result;
 }
 
+/** Find for each block row of a CompoundMatrix P the only block column
+ *  with a nonzero block, or -1 if the row has no nonzero block.
+ *
+ *  Returns false if P is not a CompoundMatrix with nrows block rows and
+ *  ncols block columns, or if a block row has more than one block.
+ */
+static bool GetBoundBlocks(
+   const Matrix*       P,
+   Index               nrows,
+   Index               ncols,
+   std::vector<Index>& block_col
+)
+{
+   block_col.assign(nrows, -1);
+   if( P == NULL )
+   {
+      return true;
+   }
+   const CompoundMatrix* comp_P = dynamic_cast<const CompoundMatrix*>(P);
+   if( comp_P == NULL || comp_P->NComps_Rows() != nrows || comp_P->NComps_Cols() != ncols )
+   {
+      return false;
+   }
+   for( Index i = 0; i < nrows; i++ )
+   {
+      for( Index j = 0; j < ncols; j++ )
+      {
+         if( IsValid(comp_P->GetComp(i, j)) )
+         {
+            if( block_col[i] >= 0 )
+            {
+               return false;
+            }
+            block_col[i] = j;
+         }
+      }
+   }
+   return true;
+}
+
+/** Subtract (sign < 0) or add (sign > 0) P*z for an ExpansionMatrix P */
+static void AddExpandedVector(
+   Number*                vals,
+   Number                 sign,
+   const ExpansionMatrix& P,
+   const DenseVector&     z
+)
+{
+   const Index* pos = P.ExpandedPosIndices();
+   const Index n = P.NCols();
+   if( z.IsHomogeneous() )
+   {
+      Number scalar = z.Scalar();
+      if( scalar == 0. )
+      {
+         return;
+      }
+      if( sign < 0. )
+      {
+         for( Index i = 0; i < n; i++ )
+         {
+            vals[pos[i]] -= scalar;
+         }
+      }
+      else
+      {
+         for( Index i = 0; i < n; i++ )
+         {
+            vals[pos[i]] += scalar;
+         }
+      }
+   }
+   else
+   {
+      const Number* zvals = z.Values();
+      if( sign < 0. )
+      {
+         for( Index i = 0; i < n; i++ )
+         {
+            vals[pos[i]] -= zvals[i];
+         }
+      }
+      else
+      {
+         for( Index i = 0; i < n; i++ )
+         {
+            vals[pos[i]] += zvals[i];
+         }
+      }
+   }
+}
+
+void IpoptCalculatedQuantities::CalcGradLag(
+   Vector&       result,
+   Number        factor,
+   const Vector& v,
+   const Vector* w1,
+   const Vector* w2,
+   const Matrix* P_L,
+   const Vector* z_L,
+   const Matrix* P_U,
+   const Vector* z_U,
+   bool          bounds_first
+)
+{
+   CompoundVector* comp_result = dynamic_cast<CompoundVector*>(&result);
+   if( comp_result != NULL )
+   {
+      const Index ncomps = comp_result->NComps();
+      const CompoundVector* comp_v = dynamic_cast<const CompoundVector*>(&v);
+      const CompoundVector* comp_w1 = dynamic_cast<const CompoundVector*>(w1);
+      const CompoundVector* comp_w2 = dynamic_cast<const CompoundVector*>(w2);
+      const CompoundVector* comp_z_L = dynamic_cast<const CompoundVector*>(z_L);
+      const CompoundVector* comp_z_U = dynamic_cast<const CompoundVector*>(z_U);
+      std::vector<Index> block_L;
+      std::vector<Index> block_U;
+      bool blockwise = comp_v != NULL && comp_v->NComps() == ncomps
+                       && (w1 == NULL || (comp_w1 != NULL && comp_w1->NComps() == ncomps))
+                       && (w2 == NULL || (comp_w2 != NULL && comp_w2->NComps() == ncomps))
+                       && (z_L == NULL || comp_z_L != NULL) && (z_U == NULL || comp_z_U != NULL)
+                       && GetBoundBlocks(P_L, ncomps, comp_z_L != NULL ? comp_z_L->NComps() : 0, block_L)
+                       && GetBoundBlocks(P_U, ncomps, comp_z_U != NULL ? comp_z_U->NComps() : 0, block_U);
+      if( blockwise )
+      {
+         const CompoundMatrix* comp_P_L = static_cast<const CompoundMatrix*>(P_L);
+         const CompoundMatrix* comp_P_U = static_cast<const CompoundMatrix*>(P_U);
+         for( Index i = 0; i < ncomps; i++ )
+         {
+            CalcGradLag(*comp_result->GetCompNonConst(i), factor, *comp_v->GetComp(i),
+                        comp_w1 != NULL ? GetRawPtr(comp_w1->GetComp(i)) : NULL,
+                        comp_w2 != NULL ? GetRawPtr(comp_w2->GetComp(i)) : NULL,
+                        block_L[i] >= 0 ? GetRawPtr(comp_P_L->GetComp(i, block_L[i])) : NULL,
+                        block_L[i] >= 0 ? GetRawPtr(comp_z_L->GetComp(block_L[i])) : NULL,
+                        block_U[i] >= 0 ? GetRawPtr(comp_P_U->GetComp(i, block_U[i])) : NULL,
+                        block_U[i] >= 0 ? GetRawPtr(comp_z_U->GetComp(block_U[i])) : NULL, bounds_first);
+         }
+         return;
+      }
+   }
+
+   DenseVector* dense_result = dynamic_cast<DenseVector*>(&result);
+   const DenseVector* dense_v = dynamic_cast<const DenseVector*>(&v);
+   const DenseVector* dense_w1 = dynamic_cast<const DenseVector*>(w1);
+   const DenseVector* dense_w2 = dynamic_cast<const DenseVector*>(w2);
+   const DenseVector* dense_z_L = dynamic_cast<const DenseVector*>(z_L);
+   const DenseVector* dense_z_U = dynamic_cast<const DenseVector*>(z_U);
+   const ExpansionMatrix* exp_P_L = dynamic_cast<const ExpansionMatrix*>(P_L);
+   const ExpansionMatrix* exp_P_U = dynamic_cast<const ExpansionMatrix*>(P_U);
+
+   // homogeneous zero vectors, e.g., J_c^T*y_c without equality
+   // constraints, can be skipped; other homogeneous vectors are left to
+   // the general code
+   if( dense_w1 != NULL && dense_w1->IsHomogeneous() && dense_w1->Scalar() == 0. )
+   {
+      w1 = NULL;
+      dense_w1 = NULL;
+   }
+   if( dense_w2 != NULL && dense_w2->IsHomogeneous() && dense_w2->Scalar() == 0. )
+   {
+      w2 = NULL;
+      dense_w2 = NULL;
+   }
+
+   bool fused = dense_result != NULL && dense_v != NULL && !dense_v->IsHomogeneous()
+                && (w1 == NULL || (dense_w1 != NULL && !dense_w1->IsHomogeneous()))
+                && (w2 == NULL || (dense_w2 != NULL && !dense_w2->IsHomogeneous()))
+                && (P_L == NULL || (exp_P_L != NULL && dense_z_L != NULL))
+                && (P_U == NULL || (exp_P_U != NULL && dense_z_U != NULL));
+
+   if( !fused )
+   {
+      if( bounds_first )
+      {
+         result.Set(0.);
+         if( P_U != NULL )
+         {
+            P_U->MultVector(1., *z_U, 1., result);
+         }
+         if( P_L != NULL )
+         {
+            P_L->MultVector(-1., *z_L, 1., result);
+         }
+         result.Axpy(factor, v);
+      }
+      else
+      {
+         result.AddOneVector(factor, v, 0.);
+      }
+      if( w1 != NULL && w2 != NULL )
+      {
+         result.AddTwoVectors(1., *w1, 1., *w2, 1.);
+      }
+      else if( w1 != NULL || w2 != NULL )
+      {
+         result.Axpy(1., w1 != NULL ? *w1 : *w2);
+      }
+      if( !bounds_first )
+      {
+         if( P_L != NULL )
+         {
+            P_L->MultVector(-1., *z_L, 1., result);
+         }
+         if( P_U != NULL )
+         {
+            P_U->MultVector(1., *z_U, 1., result);
+         }
+      }
+      return;
+   }
+
+   const Index dim = result.Dim();
+   Number* vals = dense_result->Values();
+   const Number* vvals = dense_v->Values();
+   const Number* w1vals = dense_w1 != NULL ? dense_w1->Values() : NULL;
+   const Number* w2vals = dense_w2 != NULL ? dense_w2->Values() : NULL;
+   const Number* wvals = w1vals != NULL ? w1vals : w2vals;
+
+   if( bounds_first )
+   {
+      for( Index i = 0; i < dim; i++ )
+      {
+         vals[i] = 0.;
+      }
+      if( exp_P_U != NULL )
+      {
+         AddExpandedVector(vals, 1., *exp_P_U, *dense_z_U);
+      }
+      if( exp_P_L != NULL )
+      {
+         AddExpandedVector(vals, -1., *exp_P_L, *dense_z_L);
+      }
+      if( w1vals != NULL && w2vals != NULL )
+      {
+         for( Index i = 0; i < dim; i++ )
+         {
+            vals[i] = (vals[i] + factor * vvals[i]) + (w1vals[i] + w2vals[i]);
+         }
+      }
+      else if( wvals != NULL )
+      {
+         for( Index i = 0; i < dim; i++ )
+         {
+            vals[i] = (vals[i] + factor * vvals[i]) + wvals[i];
+         }
+      }
+      else
+      {
+         for( Index i = 0; i < dim; i++ )
+         {
+            vals[i] += factor * vvals[i];
+         }
+      }
+      return;
+   }
+
+   if( w1vals != NULL && w2vals != NULL )
+   {
+      for( Index i = 0; i < dim; i++ )
+      {
+         vals[i] = factor * vvals[i] + (w1vals[i] + w2vals[i]);
+      }
+   }
+   else if( wvals != NULL )
+   {
+      for( Index i = 0; i < dim; i++ )
+      {
+         vals[i] = factor * vvals[i] + wvals[i];
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < dim; i++ )
+      {
+         vals[i] = factor * vvals[i];
+      }
+   }
+   if( exp_P_L != NULL )
+   {
+      AddExpandedVector(vals, -1., *exp_P_L, *dense_z_L);
+   }
+   if( exp_P_U != NULL )
+   {
+      AddExpandedVector(vals, 1., *exp_P_U, *dense_z_U);
+   }
+}
+
 SmartPtr<const Vector> IpoptCalculatedQuantities::curr_grad_lag_with_damping_x()
 {
    DBG_START_METH("IpoptCalculatedQuantities::curr_grad_lag_with_damping_x()",
@@ -1929,6 +2458,279 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::CalcCompl(
    return ConstPtr(result);
 }
 
+/** Collects the DenseVector pieces of a vector that is either a
+ *  DenseVector or a (nested) CompoundVector, as for the slacks of the
+ *  restoration phase NLP.
+ *
+ *  Returns false if the vector contains any other type of vector.
+ */
+static bool CollectDenseComps(
+   const Vector&                    v,
+   std::vector<const DenseVector*>& comps
+)
+{
+   const DenseVector* dv = dynamic_cast<const DenseVector*>(&v);
+   if( dv != NULL )
+   {
+      comps.push_back(dv);
+      return true;
+   }
+   const CompoundVector* cv = dynamic_cast<const CompoundVector*>(&v);
+   if( cv == NULL )
+   {
+      return false;
+   }
+   for( Index i = 0; i < cv->NComps(); i++ )
+   {
+      if( cv->IsCompNull(i) || !CollectDenseComps(*cv->GetComp(i), comps) )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+/** Non-const version of CollectDenseComps, for a new vector */
+static bool CollectDenseComps(
+   Vector&                    v,
+   std::vector<DenseVector*>& comps
+)
+{
+   DenseVector* dv = dynamic_cast<DenseVector*>(&v);
+   if( dv != NULL )
+   {
+      comps.push_back(dv);
+      return true;
+   }
+   CompoundVector* cv = dynamic_cast<CompoundVector*>(&v);
+   if( cv == NULL )
+   {
+      return false;
+   }
+   for( Index i = 0; i < cv->NComps(); i++ )
+   {
+      if( cv->IsCompNull(i) || !CollectDenseComps(*cv->GetCompNonConst(i), comps) )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void IpoptCalculatedQuantities::ComputeCurrComplConcurrently()
+{
+   DBG_START_METH("IpoptCalculatedQuantities::ComputeCurrComplConcurrently()",
+                  dbg_verbosity);
+
+   SmartPtr<const Vector> slacks[4];
+   slacks[0] = curr_slack_x_L();
+   slacks[1] = curr_slack_x_U();
+   slacks[2] = curr_slack_s_L();
+   slacks[3] = curr_slack_s_U();
+   SmartPtr<const Vector> mults[4];
+   mults[0] = ip_data_->curr()->z_L();
+   mults[1] = ip_data_->curr()->z_U();
+   mults[2] = ip_data_->curr()->v_L();
+   mults[3] = ip_data_->curr()->v_U();
+   CachedResults<SmartPtr<const Vector> >* curr_caches[4] =
+   {
+      &curr_compl_x_L_cache_, &curr_compl_x_U_cache_, &curr_compl_s_L_cache_, &curr_compl_s_U_cache_
+   };
+   CachedResults<SmartPtr<const Vector> >* trial_caches[4] =
+   {
+      &trial_compl_x_L_cache_, &trial_compl_x_U_cache_, &trial_compl_s_L_cache_, &trial_compl_s_U_cache_
+   };
+
+   // Serial part: lookup caches, allocate results, and obtain the raw
+   // arrays of the DenseVector pieces
+   SmartPtr<Vector> results[4];
+   std::vector<const DenseVector*> task_slack;
+   std::vector<const Number*> vals_slack;
+   std::vector<const Number*> vals_mult;
+   std::vector<Index> inc_slack;
+   std::vector<Index> inc_mult;
+   std::vector<Number> scalar_slack;
+   std::vector<Number> scalar_mult;
+   std::vector<Number*> vals_result;
+   std::vector<Index> dims;
+   for( Index i = 0; i < 4; i++ )
+   {
+      SmartPtr<const Vector> result;
+      if( curr_caches[i]->GetCachedResult2Dep(result, *slacks[i], *mults[i]) )
+      {
+         continue;
+      }
+      if( trial_caches[i]->GetCachedResult2Dep(result, *slacks[i], *mults[i]) )
+      {
+         curr_caches[i]->AddCachedResult2Dep(result, *slacks[i], *mults[i]);
+         continue;
+      }
+      SmartPtr<Vector> res = slacks[i]->MakeNew();
+      std::vector<const DenseVector*> dslacks;
+      std::vector<const DenseVector*> dmults;
+      std::vector<DenseVector*> dresults;
+      if( !CollectDenseComps(*slacks[i], dslacks) || !CollectDenseComps(*mults[i], dmults)
+          || !CollectDenseComps(*res, dresults) || dmults.size() != dslacks.size()
+          || dresults.size() != dslacks.size() )
+      {
+         // left to CalcCompl
+         continue;
+      }
+      results[i] = res;
+      for( size_t j = 0; j < dslacks.size(); j++ )
+      {
+         const DenseVector* dslack = dslacks[j];
+         const DenseVector* dmult = dmults[j];
+         if( dslack->Dim() == 0 || (dslack->IsHomogeneous() && dmult->IsHomogeneous()) )
+         {
+            // nothing to gain here
+            dresults[j]->Set(dslack->Dim() == 0 ? 0. : dslack->Scalar() * dmult->Scalar());
+            continue;
+         }
+         task_slack.push_back(dslack);
+         // a homogeneous vector is accessed with increment 0 instead of
+         // being expanded
+         if( dslack->IsHomogeneous() )
+         {
+            scalar_slack.push_back(dslack->Scalar());
+            vals_slack.push_back(NULL);
+            inc_slack.push_back(0);
+         }
+         else
+         {
+            scalar_slack.push_back(0.);
+            vals_slack.push_back(dslack->Values());
+            inc_slack.push_back(1);
+         }
+         if( dmult->IsHomogeneous() )
+         {
+            scalar_mult.push_back(dmult->Scalar());
+            vals_mult.push_back(NULL);
+            inc_mult.push_back(0);
+         }
+         else
+         {
+            scalar_mult.push_back(0.);
+            vals_mult.push_back(dmult->Values());
+            inc_mult.push_back(1);
+         }
+         vals_result.push_back(dresults[j]->Values());
+         dims.push_back(dslack->Dim());
+      }
+   }
+   const Index ntasks = (Index) dims.size();
+   // the scalars may only be addressed once all of them have been added
+   for( Index k = 0; k < ntasks; k++ )
+   {
+      if( inc_slack[k] == 0 )
+      {
+         vals_slack[k] = &scalar_slack[k];
+      }
+      if( inc_mult[k] == 0 )
+      {
+         vals_mult[k] = &scalar_mult[k];
+      }
+   }
+
+   // Parallel part: only plain Number arrays are touched here.  The sum
+   // of the logarithms of the slacks for the barrier term is obtained in
+   // the same pass, in the order of DenseVector::SumLogs.
+   std::vector<Number> sumlogs(ntasks);
+#ifdef _OPENMP
+   #pragma omp parallel for num_threads(ParallelSectionThreads(cq_num_threads_)) schedule(static, 1)
+#endif
+   for( Index k = 0; k < ntasks; k++ )
+   {
+      const Number* sl = vals_slack[k];
+      const Number* mt = vals_mult[k];
+      const Index isl = inc_slack[k];
+      const Index imt = inc_mult[k];
+      Number* res = vals_result[k];
+      Number sum = 0.;
+      for( Index j = 0; j < dims[k]; j++ )
+      {
+         res[j] = sl[j * isl] * mt[j * imt];
+         sum += log(sl[j * isl]);
+      }
+      sumlogs[k] = sum;
+   }
+
+   // Serial part: store results in caches
+   for( Index k = 0; k < ntasks; k++ )
+   {
+      if( inc_slack[k] == 1 )
+      {
+         task_slack[k]->SetCachedSumLogs(sumlogs[k]);
+      }
+   }
+   for( Index i = 0; i < 4; i++ )
+   {
+      if( IsValid(results[i]) )
+      {
+         SmartPtr<const Vector> result = ConstPtr(results[i]);
+         curr_caches[i]->AddCachedResult2Dep(result, *slacks[i], *mults[i]);
+      }
+   }
+}
+
+void IpoptCalculatedQuantities::ComputeSlackSumLogsConcurrently(
+   const Vector& slack_x_L,
+   const Vector& slack_x_U,
+   const Vector& slack_s_L,
+   const Vector& slack_s_U
+)
+{
+   DBG_START_METH("IpoptCalculatedQuantities::ComputeSlackSumLogsConcurrently()",
+                  dbg_verbosity);
+
+   // Serial part: obtain the DenseVector pieces with more than one value
+   std::vector<const DenseVector*> dslacks;
+   if( !CollectDenseComps(slack_x_L, dslacks) || !CollectDenseComps(slack_x_U, dslacks)
+       || !CollectDenseComps(slack_s_L, dslacks) || !CollectDenseComps(slack_s_U, dslacks) )
+   {
+      // left to Vector::SumLogs
+      return;
+   }
+   std::vector<const DenseVector*> task_slack;
+   std::vector<const Number*> vals_slack;
+   for( size_t j = 0; j < dslacks.size(); j++ )
+   {
+      if( dslacks[j]->Dim() > 0 && !dslacks[j]->IsHomogeneous() )
+      {
+         task_slack.push_back(dslacks[j]);
+         vals_slack.push_back(dslacks[j]->Values());
+      }
+   }
+   const Index ntasks = (Index) task_slack.size();
+   if( ntasks < 2 )
+   {
+      return;
+   }
+
+   // Parallel part: only plain Number arrays are touched here
+   std::vector<Number> sumlogs(ntasks);
+#ifdef _OPENMP
+   #pragma omp parallel for num_threads(ParallelSectionThreads(cq_num_threads_)) schedule(static, 1)
+#endif
+   for( Index k = 0; k < ntasks; k++ )
+   {
+      const Number* sl = vals_slack[k];
+      const Index dim = task_slack[k]->Dim();
+      Number sum = 0.;
+      for( Index j = 0; j < dim; j++ )
+      {
+         sum += log(sl[j]);
+      }
+      sumlogs[k] = sum;
+   }
+
+   // Serial part: store results in the caches of the vectors
+   for( Index k = 0; k < ntasks; k++ )
+   {
+      task_slack[k]->SetCachedSumLogs(sumlogs[k]);
+   }
+}
+
 SmartPtr<const Vector> IpoptCalculatedQuantities::curr_compl_x_L()
 {
    DBG_START_METH("IpoptCalculatedQuantities::curr_compl_x_L()",
@@ -1940,6 +2742,10 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_compl_x_L()
    DBG_PRINT_VECTOR(2, "slack_x_L", *slack);
    DBG_PRINT_VECTOR(2, "z_L", *mult);
 
+   if( !curr_compl_x_L_cache_.GetCachedResult2Dep(result, *slack, *mult) && cq_num_threads_ > 1 )
+   {
+      ComputeCurrComplConcurrently();
+   }
    if( !curr_compl_x_L_cache_.GetCachedResult2Dep(result, *slack, *mult) )
    {
       if( !trial_compl_x_L_cache_.GetCachedResult2Dep(result, *slack, *mult) )
@@ -1982,6 +2788,10 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_compl_x_U()
    SmartPtr<const Vector> slack = curr_slack_x_U();
    SmartPtr<const Vector> mult = ip_data_->curr()->z_U();
 
+   if( !curr_compl_x_U_cache_.GetCachedResult2Dep(result, *slack, *mult) && cq_num_threads_ > 1 )
+   {
+      ComputeCurrComplConcurrently();
+   }
    if( !curr_compl_x_U_cache_.GetCachedResult2Dep(result, *slack, *mult) )
    {
       if( !trial_compl_x_U_cache_.GetCachedResult2Dep(result, *slack, *mult) )
@@ -2022,6 +2832,10 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_compl_s_L()
    SmartPtr<const Vector> slack = curr_slack_s_L();
    SmartPtr<const Vector> mult = ip_data_->curr()->v_L();
 
+   if( !curr_compl_s_L_cache_.GetCachedResult2Dep(result, *slack, *mult) && cq_num_threads_ > 1 )
+   {
+      ComputeCurrComplConcurrently();
+   }
    if( !curr_compl_s_L_cache_.GetCachedResult2Dep(result, *slack, *mult) )
    {
       if( !trial_compl_s_L_cache_.GetCachedResult2Dep(result, *slack, *mult) )
@@ -2062,6 +2876,10 @@ SmartPtr<const Vector> IpoptCalculatedQuantities::curr_compl_s_U()
    SmartPtr<const Vector> slack = curr_slack_s_U();
    SmartPtr<const Vector> mult = ip_data_->curr()->v_U();
 
+   if( !curr_compl_s_U_cache_.GetCachedResult2Dep(result, *slack, *mult) && cq_num_threads_ > 1 )
+   {
+      ComputeCurrComplConcurrently();
+   }
    if( !curr_compl_s_U_cache_.GetCachedResult2Dep(result, *slack, *mult) )
    {
       if( !trial_compl_s_U_cache_.GetCachedResult2Dep(result, *slack, *mult) )
@@ -2257,6 +3075,68 @@ Number IpoptCalculatedQuantities::CalcNormOfType(
    return result;
 }
 
+Number IpoptCalculatedQuantities::CalcShiftedNormMax(
+   Number                                      shift,
+   const std::vector<SmartPtr<const Vector> >& vecs
+)
+{
+   Number result = 0.;
+   for( Index i = 0; i < (Index) vecs.size(); i++ )
+   {
+      if( vecs[i]->Dim() > 0 )
+      {
+         result = Max(result, vecs[i]->Max() - shift, shift - vecs[i]->Min());
+      }
+   }
+   return result;
+}
+
+Number IpoptCalculatedQuantities::CalcNormOfViolation(
+   ENormType     NormType,
+   const Vector& c,
+   Vector&       d_viol_L,
+   Vector&       d_viol_U
+)
+{
+   if( NormType == NORM_MAX )
+   {
+      // only the positive entries of d_viol_L and the negative entries
+      // of d_viol_U are violations, so no clipping is needed
+      Number result = c.Amax();
+      if( d_viol_L.Dim() > 0 )
+      {
+         result = Max(result, d_viol_L.Max());
+      }
+      if( d_viol_U.Dim() > 0 )
+      {
+         result = Max(result, -d_viol_U.Min());
+      }
+      return result;
+   }
+
+   if( d_viol_L.Dim() > 0 )
+   {
+      SmartPtr<Vector> tmp = d_viol_L.MakeNew();
+      tmp->Set(0.);
+      d_viol_L.ElementWiseMax(*tmp);
+   }
+   DBG_PRINT_VECTOR(2, "d_viol_L", d_viol_L);
+
+   if( d_viol_U.Dim() > 0 )
+   {
+      SmartPtr<Vector> tmp = d_viol_U.MakeNew();
+      tmp->Set(0.);
+      d_viol_U.ElementWiseMin(*tmp);
+   }
+   DBG_PRINT_VECTOR(2, "d_viol_U", d_viol_U);
+
+   std::vector<SmartPtr<const Vector> > vecs(3);
+   vecs[0] = &c;
+   vecs[1] = &d_viol_L;
+   vecs[2] = &d_viol_U;
+   return CalcNormOfType(NormType, vecs);
+}
+
 Number IpoptCalculatedQuantities::curr_primal_infeasibility(
    ENormType NormType
 )
@@ -2464,22 +3344,30 @@ Number IpoptCalculatedQuantities::unscaled_curr_dual_infeasibility(
 
    if( !unscaled_curr_dual_infeasibility_cache_.GetCachedResult(result, deps, sdeps) )
    {
-      SmartPtr<const Vector> grad_lag_x = ip_nlp_->NLP_scaling()->unapply_grad_obj_scaling(curr_grad_lag_x());
-
       Number obj_unscal = ip_nlp_->NLP_scaling()->unapply_obj_scaling(1.);
-      SmartPtr<const Vector> grad_lag_s;
-      if( obj_unscal != 1. )
+      if( obj_unscal == 1. && !ip_nlp_->NLP_scaling()->have_x_scaling() && !ip_nlp_->NLP_scaling()->have_d_scaling() )
       {
-         SmartPtr<Vector> tmp = ip_nlp_->NLP_scaling()->apply_vector_scaling_d_NonConst(ConstPtr(curr_grad_lag_s()));
-         tmp->Scal(obj_unscal);
-         grad_lag_s = ConstPtr(tmp);
+         // the unscaled infeasibility is the same as the scaled one
+         result = curr_dual_infeasibility(NormType);
       }
       else
       {
-         grad_lag_s = ip_nlp_->NLP_scaling()->apply_vector_scaling_d(curr_grad_lag_s());
-      }
+         SmartPtr<const Vector> grad_lag_x = ip_nlp_->NLP_scaling()->unapply_grad_obj_scaling(curr_grad_lag_x());
 
-      result = CalcNormOfType(NormType, *grad_lag_x, *grad_lag_s);
+         SmartPtr<const Vector> grad_lag_s;
+         if( obj_unscal != 1. )
+         {
+            SmartPtr<Vector> tmp = ip_nlp_->NLP_scaling()->apply_vector_scaling_d_NonConst(ConstPtr(curr_grad_lag_s()));
+            tmp->Scal(obj_unscal);
+            grad_lag_s = ConstPtr(tmp);
+         }
+         else
+         {
+            grad_lag_s = ip_nlp_->NLP_scaling()->apply_vector_scaling_d(curr_grad_lag_s());
+         }
+
+         result = CalcNormOfType(NormType, *grad_lag_x, *grad_lag_s);
+      }
       unscaled_curr_dual_infeasibility_cache_.AddCachedResult(result, deps, sdeps);
    }
 
@@ -2524,7 +3412,7 @@ Number IpoptCalculatedQuantities::curr_complementarity(
          SmartPtr<const Vector> compl_s_L = curr_compl_s_L();
          SmartPtr<const Vector> compl_s_U = curr_compl_s_U();
 
-         if( mu == .0 )
+         if( mu == .0 || NormType == NORM_MAX )
          {
             vecs[0] = GetRawPtr(compl_x_L);
             vecs[1] = GetRawPtr(compl_x_U);
@@ -2551,7 +3439,16 @@ Number IpoptCalculatedQuantities::curr_complementarity(
             vecs[3] = GetRawPtr(tmp);
          }
 
-         result = CalcNormOfType(NormType, vecs);
+         if( mu != .0 && NormType == NORM_MAX )
+         {
+            // the shifted norm is obtained from the extremal elements,
+            // which the vectors can keep in their caches
+            result = CalcShiftedNormMax(mu, vecs);
+         }
+         else
+         {
+            result = CalcNormOfType(NormType, vecs);
+         }
       }
 
       curr_complementarity_cache_.AddCachedResult(result, deps, sdeps);
@@ -2598,7 +3495,7 @@ Number IpoptCalculatedQuantities::trial_complementarity(
          SmartPtr<const Vector> compl_s_L = trial_compl_s_L();
          SmartPtr<const Vector> compl_s_U = trial_compl_s_U();
 
-         if( mu == .0 )
+         if( mu == .0 || NormType == NORM_MAX )
          {
             vecs[0] = GetRawPtr(compl_x_L);
             vecs[1] = GetRawPtr(compl_x_U);
@@ -2625,7 +3522,16 @@ Number IpoptCalculatedQuantities::trial_complementarity(
             vecs[3] = GetRawPtr(tmp);
          }
 
-         result = CalcNormOfType(NormType, vecs);
+         if( mu != .0 && NormType == NORM_MAX )
+         {
+            // the shifted norm is obtained from the extremal elements,
+            // which the vectors can keep in their caches
+            result = CalcShiftedNormMax(mu, vecs);
+         }
+         else
+         {
+            result = CalcNormOfType(NormType, vecs);
+         }
       }
 
       trial_complementarity_cache_.AddCachedResult(result, deps, sdeps);
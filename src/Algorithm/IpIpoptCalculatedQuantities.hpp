@@ -562,6 +562,14 @@ public:
    /** Method returning true if this is a square problem */
    bool IsSquareProblem() const;
 
+   /** Remove the vectors computed at the current iterate from the caches.
+    *
+    *  This is used in the low memory mode right before a trial point
+    *  is accepted, since these vectors cannot be used anymore once the
+    *  current iterate has changed.
+    */
+   void ReleaseCurrVectors();
+
    /** Method returning the IpoptNLP object.
     *
     *  This should only be used with care!
@@ -641,8 +649,29 @@ private:
    bool warm_start_same_structure_;
    /** Desired value of the barrier parameter */
    Number mu_target_;
+   /** Number of threads used to compute independent quantities concurrently */
+   Index cq_num_threads_;
+   /** Number of iterations between computations of the trial slacks
+    *  from the trial point; 0 if they are never computed from the step
+    */
+   Index trial_slack_refresh_;
+   /** Size model for the caches of vectors */
+   enum VectorCacheSizes
+   {
+      VCS_DEFAULT = 0,
+      VCS_MINIMAL,
+      VCS_EXTENDED
+   };
+   VectorCacheSizes vector_cache_sizes_;
    ///@}
 
+   /** Memory budget shared by the caches of vectors
+    *
+    *  The caches are detached from it in the destructor, since they are
+    *  destroyed before it.
+    */
+   CachedResultsBudget<SmartPtr<const Vector> > vector_cache_budget_;
+
    /** @name Caches for slacks */
    ///@{
    CachedResults<SmartPtr<Vector> > curr_slack_x_L_cache_;
@@ -653,10 +682,22 @@ private:
    CachedResults<SmartPtr<Vector> > trial_slack_x_U_cache_;
    CachedResults<SmartPtr<Vector> > trial_slack_s_L_cache_;
    CachedResults<SmartPtr<Vector> > trial_slack_s_U_cache_;
+   /** Steps in the slacks for the incremental computation of the
+    *  trial slacks, see CalcTrialSlackFromStep
+    */
+   CachedResults<SmartPtr<const Vector> > slack_step_x_L_cache_;
+   CachedResults<SmartPtr<const Vector> > slack_step_x_U_cache_;
+   CachedResults<SmartPtr<const Vector> > slack_step_s_L_cache_;
+   CachedResults<SmartPtr<const Vector> > slack_step_s_U_cache_;
    Index num_adjusted_slack_x_L_;
    Index num_adjusted_slack_x_U_;
    Index num_adjusted_slack_s_L_;
    Index num_adjusted_slack_s_U_;
+   /** Tags of the last current and trial slacks (for x_L, x_U, s_L,
+    *  s_U) that have not been corrected by CalculateSafeSlack, or 0
+    */
+   TaggedObject::Tag clean_curr_slack_tag_[4];
+   TaggedObject::Tag clean_trial_slack_tag_[4];
    ///@}
 
    /** @name Cached for objective function stuff */
@@ -814,6 +855,14 @@ private:
 
    /** @name Auxiliary functions */
    ///@{
+   /** Set the size of a cache of vectors according to
+    *  vector_cache_sizes_ and add it to vector_cache_budget_ if
+    *  there is a budget.
+    */
+   void ConfigureVectorCache(
+      CachedResults<SmartPtr<const Vector> >& cache
+   );
+
    /** Compute new vector containing the slack to a lower bound
     *  (uncached)
     */
@@ -830,6 +879,18 @@ private:
       const Vector& x,
       const Vector& x_bound
    );
+   /** Compute new vector containing the slack at the trial point
+    *  from the slack at the current point and the step, if possible.
+    *
+    *  bound_type is 0 for x_L, 1 for x_U, 2 for s_L, and 3 for s_U.
+    *  Returns NULL if the slack has to be computed from the trial
+    *  point, see the trial_slack_refresh option.
+    */
+   SmartPtr<Vector> CalcTrialSlackFromStep(
+      Index         bound_type,
+      const Matrix& P,
+      const Vector& x_bound
+   );
    /** Compute barrier term at given point
     *  (uncached)
     */
@@ -841,12 +902,69 @@ private:
       const Vector& slack_s_U
    );
 
+   /** Compute the gradient of the Lagrangian with respect to x or s
+    *  (uncached).
+    *
+    *  Sets result to factor*v + (w1 + w2) - P_L*z_L + P_U*z_U, where
+    *  w1 and w2, as well as P_L and z_L or P_U and z_U, may be NULL.
+    *  If all vectors are DenseVectors and P_L and P_U are
+    *  ExpansionMatrices, this is done in one loop over the elements of
+    *  result, and the bound multipliers are added directly via the
+    *  index maps of P_L and P_U.  For CompoundVectors and
+    *  CompoundMatrices P_L and P_U with at most one block in each
+    *  block row, as in the restoration phase, this is applied to each
+    *  component.  If bounds_first is true, P_U*z_U - P_L*z_L is
+    *  computed first and factor*v is added to it; otherwise the bound
+    *  terms are added to factor*v + (w1 + w2).
+    */
+   void CalcGradLag(
+      Vector&       result,
+      Number        factor,
+      const Vector& v,
+      const Vector* w1,
+      const Vector* w2,
+      const Matrix* P_L,
+      const Vector* z_L,
+      const Matrix* P_U,
+      const Vector* z_U,
+      bool          bounds_first
+   );
+
    /** Compute complementarity for slack / multiplier pair */
    SmartPtr<const Vector> CalcCompl(
       const Vector& slack,
       const Vector& mult
    );
 
+   /** Compute the complementarity vectors for all four bound types at
+    *  the current point concurrently and store them in the
+    *  curr_compl_*_cache_ caches.
+    *
+    *  Only pairs whose slacks and multipliers consist of DenseVectors,
+    *  possibly within CompoundVectors, are handled here; all other
+    *  pairs are left for the regular (serial) code.  The sums of the
+    *  logarithms of the slacks are computed in the same pass and stored
+    *  in the slack vectors (see Vector::SetCachedSumLogs), so that the
+    *  barrier term does not traverse the slacks again.  The allocation
+    *  of the result vectors and all cache operations are done outside
+    *  of the parallel region, so that only plain Number arrays are
+    *  touched concurrently.
+    */
+   void ComputeCurrComplConcurrently();
+
+   /** Compute the sums of the logarithms of the given slacks
+    *  concurrently and store them in the slack vectors.
+    *
+    *  Used for the barrier term at trial points, for which the
+    *  complementarity products are usually not needed.
+    */
+   void ComputeSlackSumLogsConcurrently(
+      const Vector& slack_x_L,
+      const Vector& slack_x_U,
+      const Vector& slack_s_L,
+      const Vector& slack_s_U
+   );
+
    /** Compute fraction to the boundary parameter for lower and upper bounds */
    Number CalcFracToBound(
       const Vector& slack_L,
@@ -859,6 +977,30 @@ private:
       Number        tau
    );
 
+   /** Compute the max-norm of a set of vectors shifted by a scalar
+    *  (uncached).
+    *
+    *  The norm is computed from the (cached) largest and smallest
+    *  elements of the vectors, so that no shifted copies are needed.
+    */
+   Number CalcShiftedNormMax(
+      Number                                      shift,
+      const std::vector<SmartPtr<const Vector> >& vecs
+   );
+
+   /** Compute the norm of the constraint violation (uncached).
+    *
+    *  d_viol_L and d_viol_U are the differences of the lower and upper
+    *  bounds and the values of d, of which only positive and negative
+    *  entries, respectively, are violations.  They might be overwritten.
+    */
+   Number CalcNormOfViolation(
+      ENormType     NormType,
+      const Vector& c,
+      Vector&       d_viol_L,
+      Vector&       d_viol_U
+   );
+
    /** Compute the scaling factors for the optimality error. */
    void ComputeOptimalityErrorScaling(
       const Vector& y_c,
@@ -6,6 +6,9 @@
 
 #include "IpIpoptData.hpp"
 #include "IpIpoptNLP.hpp"
+#include "IpCheckpoint.hpp"
+#include "IpAlgTypes.hpp"
+#include "IpDenseVector.hpp"
 
 namespace Ipopt
 {
@@ -14,7 +17,13 @@ IpoptData::IpoptData(
    SmartPtr<IpoptAdditionalData> add_data /*= NULL*/,
    Number                        cpu_time_start /*= -1.*/
 )
-   : cpu_time_start_(cpu_time_start),
+   : trial_step_alpha_(0.),
+     trial_step_x_tag_(0),
+     trial_step_s_tag_(0),
+     curr_mu_(-1.),
+     mu_initialized_(false),
+     work_counters_(new WorkCounters()),
+     cpu_time_start_(cpu_time_start),
      add_data_(add_data)
 { }
 
@@ -37,6 +46,21 @@ void IpoptData::RegisterOptions(
       "(This is epsilon_tol in Eqn. (6) in implementation paper). "
       "See also \"acceptable_tol\" as a second termination criterion. "
       "Note, some other algorithmic features also use this quantity to determine thresholds etc.");
+
+   roptions->SetRegisteringCategory("Main Algorithm");
+   roptions->AddStringOption2(
+      "low_memory_mode",
+      "Whether to store as few iterates at the same time as possible.",
+      "no",
+      "no", "keep the iterates as long as they may be useful",
+      "yes", "free the iterates as soon as possible",
+      "If enabled, the previous trial point is freed before a new trial point is computed in the line search, "
+      "the previous search direction is freed before the new one is computed, "
+      "and the affine-scaling step is freed as soon as it has been used, so that it is recomputed if it is needed again. "
+      "This reduces the number of vectors of the size of the iterates that are allocated at the same time, "
+      "at the cost of some recomputation. "
+      "The backup iterates of the watchdog procedure are freed whenever the watchdog is inactive; "
+      "the watchdog can be disabled by setting \"watchdog_shortened_iter_trigger\" to 0.");
 }
 
 bool IpoptData::Initialize(
@@ -68,10 +92,25 @@ bool IpoptData::Initialize(
 #else
    options.GetNumericValue("tol", tol_, prefix);
 #endif
+   options.GetBoolValue("low_memory_mode", low_memory_mode_, prefix);
+
+   // keep the barrier parameter of a previous solve if requested
+   bool keep_state = false;
+   if( prefix != "resto." )
+   {
+      // The following options are registered by OrigIpoptNLP
+      bool warm_start_same_structure;
+      options.GetBoolValue("warm_start_keep_state", keep_state, prefix);
+      options.GetBoolValue("warm_start_same_structure", warm_start_same_structure, prefix);
+      keep_state = keep_state && warm_start_same_structure;
+   }
 
    iter_count_ = 0;
-   curr_mu_ = -1.;
-   mu_initialized_ = false;
+   if( !keep_state )
+   {
+      curr_mu_ = -1.;
+      mu_initialized_ = false;
+   }
    curr_tau_ = -1.;
    tau_initialized_ = false;
    have_prototypes_ = false;
@@ -86,6 +125,8 @@ bool IpoptData::Initialize(
    info_last_output_ = -1.;
    info_iters_since_header_ = 1000; // need to be larger 10
 
+   work_counters_ = new WorkCounters();
+
    initialize_called_ = true;
 
    // will be set to cputime in IpoptApplication::call_optimize()
@@ -111,6 +152,9 @@ bool IpoptData::InitializeDataStructures(
 )
 {
    DBG_ASSERT(initialize_called_);
+
+   work_counters_->SetNLP(&ip_nlp);
+
    /*
     * Allocate space for all the required linear algebra
     * structures
@@ -172,6 +216,41 @@ bool IpoptData::InitializeDataStructures(
    return retval;
 }
 
+/** Whether a step component is known to be zero without looking at its elements */
+static bool IsZeroStep(
+   const Vector& delta_comp
+)
+{
+   const DenseVector* dense_delta = dynamic_cast<const DenseVector*>(&delta_comp);
+   return dense_delta != NULL && dense_delta->IsHomogeneous() && dense_delta->Scalar() == 0.;
+}
+
+/** Set component comp of trial to curr_comp + alpha * delta_comp.
+ *
+ *  If the component does not change, the trial point shares it with
+ *  the current point instead of storing a copy, which also keeps the
+ *  results that have been cached for it.
+ */
+static void SetTrialCompFromStep(
+   IteratesVector& trial,
+   Index           comp,
+   const Vector&   curr_comp,
+   Number          alpha,
+   const Vector&   delta_comp
+)
+{
+   if( alpha == 0. || curr_comp.Dim() == 0 || IsZeroStep(delta_comp) )
+   {
+      trial.SetComp(comp, curr_comp);
+   }
+   else
+   {
+      SmartPtr<Vector> new_comp = curr_comp.MakeNew();
+      new_comp->AddTwoVectors(1., curr_comp, alpha, delta_comp, 0.);
+      trial.SetCompNonConst(comp, *new_comp);
+   }
+}
+
 void IpoptData::SetTrialPrimalVariablesFromStep(
    Number        alpha,
    const Vector& delta_x,
@@ -180,21 +259,53 @@ void IpoptData::SetTrialPrimalVariablesFromStep(
 {
    DBG_ASSERT(have_prototypes_);
 
+   if( low_memory_mode_ )
+   {
+      // free the previous trial point before the new one is allocated;
+      // the multipliers are set from the step after the primal variables
+      trial_ = NULL;
+   }
    if( IsNull(trial_) )
    {
       trial_ = iterates_space_->MakeNewIteratesVector(false);
    }
 
    SmartPtr<IteratesVector> newvec = trial_->MakeNewContainer();
-   newvec->create_new_x();
-   newvec->x_NonConst()->AddTwoVectors(1., *curr_->x(), alpha, delta_x, 0.);
+   SetTrialCompFromStep(*newvec, 0, *curr_->x(), alpha, delta_x);
+   SetTrialCompFromStep(*newvec, 1, *curr_->s(), alpha, delta_s);
 
-   newvec->create_new_s();
-   newvec->s_NonConst()->AddTwoVectors(1., *curr_->s(), alpha, delta_s, 0.);
+   trial_step_base_x_ = curr_->x();
+   trial_step_delta_x_ = &delta_x;
+   trial_step_base_s_ = curr_->s();
+   trial_step_delta_s_ = &delta_s;
+   trial_step_alpha_ = alpha;
+   trial_step_x_tag_ = newvec->x()->GetTag();
+   trial_step_s_tag_ = newvec->s()->GetTag();
 
    set_trial(newvec);
 }
 
+bool IpoptData::GetTrialPrimalStep(
+   SmartPtr<const Vector>& base_x,
+   SmartPtr<const Vector>& delta_x,
+   SmartPtr<const Vector>& base_s,
+   SmartPtr<const Vector>& delta_s,
+   Number&                 alpha
+) const
+{
+   if( IsNull(trial_) || IsNull(trial_step_delta_x_) || trial_->x()->GetTag() != trial_step_x_tag_
+       || trial_->s()->GetTag() != trial_step_s_tag_ )
+   {
+      return false;
+   }
+   base_x = trial_step_base_x_;
+   delta_x = trial_step_delta_x_;
+   base_s = trial_step_base_s_;
+   delta_s = trial_step_delta_s_;
+   alpha = trial_step_alpha_;
+   return true;
+}
+
 void IpoptData::SetTrialEqMultipliersFromStep(
    Number        alpha,
    const Vector& delta_y_c,
@@ -204,11 +315,8 @@ void IpoptData::SetTrialEqMultipliersFromStep(
    DBG_ASSERT(have_prototypes_);
 
    SmartPtr<IteratesVector> newvec = trial()->MakeNewContainer();
-   newvec->create_new_y_c();
-   newvec->y_c_NonConst()->AddTwoVectors(1., *curr()->y_c(), alpha, delta_y_c, 0.);
-
-   newvec->create_new_y_d();
-   newvec->y_d_NonConst()->AddTwoVectors(1., *curr()->y_d(), alpha, delta_y_d, 0.);
+   SetTrialCompFromStep(*newvec, 2, *curr()->y_c(), alpha, delta_y_c);
+   SetTrialCompFromStep(*newvec, 3, *curr()->y_d(), alpha, delta_y_d);
 
    set_trial(newvec);
 }
@@ -224,17 +332,10 @@ void IpoptData::SetTrialBoundMultipliersFromStep(
    DBG_ASSERT(have_prototypes_);
 
    SmartPtr<IteratesVector> newvec = trial()->MakeNewContainer();
-   newvec->create_new_z_L();
-   newvec->z_L_NonConst()->AddTwoVectors(1., *curr()->z_L(), alpha, delta_z_L, 0.);
-
-   newvec->create_new_z_U();
-   newvec->z_U_NonConst()->AddTwoVectors(1., *curr()->z_U(), alpha, delta_z_U, 0.);
-
-   newvec->create_new_v_L();
-   newvec->v_L_NonConst()->AddTwoVectors(1., *curr()->v_L(), alpha, delta_v_L, 0.);
-
-   newvec->create_new_v_U();
-   newvec->v_U_NonConst()->AddTwoVectors(1., *curr()->v_U(), alpha, delta_v_U, 0.);
+   SetTrialCompFromStep(*newvec, 4, *curr()->z_L(), alpha, delta_z_L);
+   SetTrialCompFromStep(*newvec, 5, *curr()->z_U(), alpha, delta_z_U);
+   SetTrialCompFromStep(*newvec, 6, *curr()->v_L(), alpha, delta_v_L);
+   SetTrialCompFromStep(*newvec, 7, *curr()->v_U(), alpha, delta_v_U);
 
    set_trial(newvec);
 }
@@ -261,6 +362,12 @@ void IpoptData::AcceptTrialPoint()
    // Free the memory for the affine-scaling step
    delta_aff_ = NULL;
 
+   // The step of the trial point is not needed anymore
+   trial_step_base_x_ = NULL;
+   trial_step_delta_x_ = NULL;
+   trial_step_base_s_ = NULL;
+   trial_step_delta_s_ = NULL;
+
    have_deltas_ = false;
    have_affine_deltas_ = false;
 
@@ -270,4 +377,62 @@ void IpoptData::AcceptTrialPoint()
    }
 }
 
+void IpoptData::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   checkpoint.WriteSection("IpoptData");
+   checkpoint.WriteIndex(iter_count_);
+   checkpoint.WriteNumber(curr_mu_);
+   checkpoint.WriteNumber(curr_tau_);
+   checkpoint.WriteBool(free_mu_mode_);
+   checkpoint.WriteBool(tiny_step_flag_);
+   checkpoint.WriteIterates(curr_);
+
+   // the output of the current iterate is not done yet
+   checkpoint.WriteNumber(info_regu_x_);
+   checkpoint.WriteNumber(info_alpha_primal_);
+   checkpoint.WriteIndex(info_alpha_primal_char_);
+   checkpoint.WriteNumber(info_alpha_dual_);
+   checkpoint.WriteIndex(info_ls_count_);
+   checkpoint.WriteBool(info_skip_output_);
+   checkpoint.WriteString(info_string_);
+   checkpoint.WriteNumber(pd_pert_x_);
+   checkpoint.WriteNumber(pd_pert_s_);
+   checkpoint.WriteNumber(pd_pert_c_);
+   checkpoint.WriteNumber(pd_pert_d_);
+}
+
+void IpoptData::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   DBG_ASSERT(IsValid(curr_));
+   checkpoint.ReadSection("IpoptData");
+   iter_count_ = checkpoint.ReadIndex();
+   Set_mu(checkpoint.ReadNumber());
+   Set_tau(checkpoint.ReadNumber());
+   free_mu_mode_ = checkpoint.ReadBool();
+   tiny_step_flag_ = checkpoint.ReadBool();
+   SmartPtr<IteratesVector> iterates = checkpoint.ReadIterates(*curr_);
+   if( IsNull(iterates) )
+   {
+      THROW_EXCEPTION(INVALID_WARMSTART, "Checkpoint file " + checkpoint.FileName() + " does not contain an iterate.");
+   }
+   set_trial(iterates);
+   AcceptTrialPoint();
+
+   info_regu_x_ = checkpoint.ReadNumber();
+   info_alpha_primal_ = checkpoint.ReadNumber();
+   info_alpha_primal_char_ = (char) checkpoint.ReadIndex();
+   info_alpha_dual_ = checkpoint.ReadNumber();
+   info_ls_count_ = checkpoint.ReadIndex();
+   info_skip_output_ = checkpoint.ReadBool();
+   info_string_ = checkpoint.ReadString();
+   pd_pert_x_ = checkpoint.ReadNumber();
+   pd_pert_s_ = checkpoint.ReadNumber();
+   pd_pert_c_ = checkpoint.ReadNumber();
+   pd_pert_d_ = checkpoint.ReadNumber();
+}
+
 } // namespace Ipopt
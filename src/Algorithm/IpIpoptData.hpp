@@ -12,12 +12,14 @@
 #include "IpIteratesVector.hpp"
 #include "IpRegOptions.hpp"
 #include "IpTimingStatistics.hpp"
+#include "IpWorkCounters.hpp"
 
 namespace Ipopt
 {
 
 /* Forward declaration */
 class IpoptNLP;
+class Checkpoint;
 
 /** Base class for additional data that is special to a particular
  *  type of algorithm, such as the CG penalty function, or using
@@ -133,7 +135,7 @@ public:
    /** @name Get Methods for Iterates */
    ///@{
    /** Current point */
-   inline SmartPtr<const IteratesVector> curr() const;
+   inline const SmartPtr<const IteratesVector>& curr() const;
 
    /** Get the current point in a copied container that is non-const.
     *
@@ -142,7 +144,7 @@ public:
     */
    //    SmartPtr<IteratesVector> curr_container() const;
    /** Get Trial point */
-   inline SmartPtr<const IteratesVector> trial() const;
+   inline const SmartPtr<const IteratesVector>& trial() const;
 
    /** Get Trial point in a copied container that is non-const.
     *
@@ -169,6 +171,21 @@ public:
       const Vector& delta_x,
       const Vector& delta_s
    );
+
+   /** Get the step from which the primal trial variables have been
+    *  computed by SetTrialPrimalVariablesFromStep.
+    *
+    *  Then trial x = base_x + alpha * delta_x and trial s = base_s +
+    *  alpha * delta_s, up to rounding.  Returns false if the primal
+    *  trial variables have been set in a different way.
+    */
+   bool GetTrialPrimalStep(
+      SmartPtr<const Vector>& base_x,
+      SmartPtr<const Vector>& delta_x,
+      SmartPtr<const Vector>& base_s,
+      SmartPtr<const Vector>& delta_s,
+      Number&                 alpha
+   ) const;
    /** Set the values of the trial values for the equality constraint
     *  multipliers (y_c and y_d) from provided step with step length
     *  alpha.
@@ -196,7 +213,7 @@ public:
    // void set_trial(const SmartPtr<IteratesVector>& trial_iterates);
    // void set_trial(SmartPtr<const IteratesVector>& trial_iterates);
    /** get the current delta */
-   inline SmartPtr<const IteratesVector> delta() const;
+   inline const SmartPtr<const IteratesVector>& delta() const;
 
    /** Set the current delta.
     *
@@ -223,7 +240,7 @@ public:
    );
 
    /** Affine Delta */
-   inline SmartPtr<const IteratesVector> delta_aff() const;
+   inline const SmartPtr<const IteratesVector>& delta_aff() const;
 
    /** Set the affine delta.
     *
@@ -236,8 +253,23 @@ public:
       SmartPtr<IteratesVector>& delta_aff
    );
 
+   /** Free the affine delta and reset the HaveAffineDeltas flag.
+    *
+    *  The affine delta is then recomputed if it is needed again.
+    */
+   inline
+   void ReleaseAffineDeltas();
+
+   /** Free the delta of the previous iteration.
+    *
+    *  This should only be called right before the new delta is
+    *  computed, so that both do not need to be stored at the same time.
+    */
+   inline
+   void ReleaseDelta();
+
    /** Hessian or Hessian approximation (do not hold on to it, it might be changed) */
-   SmartPtr<const SymMatrix> W()
+   const SmartPtr<const SymMatrix>& W()
    {
       DBG_ASSERT(IsValid(W_));
       return W_;
@@ -446,6 +478,15 @@ public:
    }
    ///@}
 
+   /** Whether the algorithm should store as few iterates at the same
+    *  time as possible, at the cost of recomputing some of them.
+    */
+   bool LowMemoryMode() const
+   {
+      DBG_ASSERT(initialize_called_);
+      return low_memory_mode_;
+   }
+
    /** Cpu time counter at the beginning of the optimization.
     *
     *  This is useful to see how much CPU time has been spent in this
@@ -590,6 +631,24 @@ public:
       return timing_statistics_;
    }
 
+   /** Return the object counting the work done in each iteration */
+   WorkCounters& WorkCounts()
+   {
+      return *work_counters_;
+   }
+
+   /** Use the work counters of another IpoptData object.
+    *
+    *  This is used by the restoration phase, so that its work is
+    *  counted together with the work of the regular algorithm.
+    */
+   void ShareWorkCounts(
+      IpoptData& ip_data
+   )
+   {
+      work_counters_ = ip_data.work_counters_;
+   }
+
    /** Resetting CPU Start Time */
    void ResetCpuStartTime()
    {
@@ -645,6 +704,23 @@ public:
       pd_pert_d = pd_pert_d_;
    }
 
+   /** Write the current iterate, the barrier parameter, the iteration
+    *  counter, and the information for the iteration output to a
+    *  checkpoint.
+    */
+   void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** Restore the state that has been written by WriteCheckpoint.
+    *
+    *  The data structures must have been initialized by
+    *  InitializeDataStructures.
+    */
+   void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    static void RegisterOptions(
       const SmartPtr<RegisteredOptions>& roptions
    );
@@ -658,6 +734,18 @@ private:
    /** Main iteration variables (trial calculations) */
    SmartPtr<const IteratesVector> trial_;
 
+   /** @name Step of the primal trial variables, see GetTrialPrimalStep */
+   ///@{
+   SmartPtr<const Vector> trial_step_base_x_;
+   SmartPtr<const Vector> trial_step_delta_x_;
+   SmartPtr<const Vector> trial_step_base_s_;
+   SmartPtr<const Vector> trial_step_delta_s_;
+   Number trial_step_alpha_;
+   /** Tags of the trial x and s that have been computed from the step */
+   TaggedObject::Tag trial_step_x_tag_;
+   TaggedObject::Tag trial_step_s_tag_;
+   ///@}
+
    /** Hessian (approximation) - might be changed elsewhere! */
    SmartPtr<const SymMatrix> W_;
 
@@ -723,6 +811,8 @@ private:
    ///@{
    /** Overall convergence tolerance */
    Number tol_;
+   /** Whether as few iterates as possible should be stored */
+   bool low_memory_mode_;
    ///@}
 
    /** @name Status data **/
@@ -765,6 +855,9 @@ private:
    /** TimingStatistics object collecting all Ipopt timing statistics */
    TimingStatistics timing_statistics_;
 
+   /** Counters of the work done in each iteration */
+   SmartPtr<WorkCounters> work_counters_;
+
    /** CPU time counter at begin of optimization. */
    Number cpu_time_start_;
 
@@ -820,28 +913,28 @@ private:
 
 };
 
-inline SmartPtr<const IteratesVector> IpoptData::curr() const
+inline const SmartPtr<const IteratesVector>& IpoptData::curr() const
 {
    DBG_ASSERT(IsNull(curr_) || (curr_->GetTag() == debug_curr_tag_ && curr_->GetTagSum() == debug_curr_tag_sum_) );
 
    return curr_;
 }
 
-inline SmartPtr<const IteratesVector> IpoptData::trial() const
+inline const SmartPtr<const IteratesVector>& IpoptData::trial() const
 {
    DBG_ASSERT(IsNull(trial_) || (trial_->GetTag() == debug_trial_tag_ && trial_->GetTagSum() == debug_trial_tag_sum_) );
 
    return trial_;
 }
 
-inline SmartPtr<const IteratesVector> IpoptData::delta() const
+inline const SmartPtr<const IteratesVector>& IpoptData::delta() const
 {
    DBG_ASSERT(IsNull(delta_) || (delta_->GetTag() == debug_delta_tag_ && delta_->GetTagSum() == debug_delta_tag_sum_) );
 
    return delta_;
 }
 
-inline SmartPtr<const IteratesVector> IpoptData::delta_aff() const
+inline const SmartPtr<const IteratesVector>& IpoptData::delta_aff() const
 {
    DBG_ASSERT(IsNull(delta_aff_) || (delta_aff_->GetTag() == debug_delta_aff_tag_ && delta_aff_->GetTagSum() == debug_delta_aff_tag_sum_) );
 
@@ -962,6 +1055,28 @@ void IpoptData::set_delta_aff(
    delta_aff = NULL;
 }
 
+inline
+void IpoptData::ReleaseAffineDeltas()
+{
+   delta_aff_ = NULL;
+   have_affine_deltas_ = false;
+#if IPOPT_CHECKLEVEL > 0
+   debug_delta_aff_tag_ = 0;
+   debug_delta_aff_tag_sum_ = 0;
+#endif
+}
+
+inline
+void IpoptData::ReleaseDelta()
+{
+   DBG_ASSERT(!have_deltas_);
+   delta_ = NULL;
+#if IPOPT_CHECKLEVEL > 0
+   debug_delta_tag_ = 0;
+   debug_delta_tag_sum_ = 0;
+#endif
+}
+
 } // namespace Ipopt
 
 #endif
@@ -11,6 +11,8 @@
 #include "IpJournalist.hpp"
 #include "IpNLPScaling.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 // forward declarations
@@ -127,6 +129,80 @@ public:
       const Vector& yd
    ) = 0;
 
+   /** Announce that jac_c, jac_d, and h are going to be requested at x
+    *  (and at obj_factor, yc, and yd for h).
+    *
+    *  This allows an implementation to evaluate these derivatives
+    *  together, e.g., concurrently, before they are requested.  The
+    *  default implementation does nothing.
+    */
+   virtual void PrecomputeDerivatives(
+      const Vector& /*x*/,
+      Number        /*obj_factor*/,
+      const Vector& /*yc*/,
+      const Vector& /*yd*/
+   )
+   { }
+
+   /** Announce that f, c, and d are going to be requested at (some
+    *  of) the points in x.
+    *
+    *  This allows an implementation to evaluate the functions at all
+    *  points together, e.g., concurrently, before they are requested.
+    *  The default implementation does nothing.
+    */
+   virtual void PrecomputeFunctions(
+      const std::vector<SmartPtr<const Vector> >& /*x*/
+   )
+   { }
+
+   /** Evaluate f, c, and d at x.
+    *
+    *  Returns false if one of them cannot be evaluated, so that
+    *  callers that expect evaluation errors, like the line search at
+    *  trial points, do not need to catch Eval_Error.  The values are
+    *  then available from f, c, and d.  The default implementation
+    *  calls f (unless the objective depends on mu) and
+    *  EvaluateConstraints, and catches Eval_Error.
+    */
+   virtual bool EvaluateFunctions(
+      const Vector& x
+   )
+   {
+      if( !objective_depends_on_mu() )
+      {
+         try
+         {
+            f(x);
+         }
+         catch( Eval_Error& )
+         {
+            return false;
+         }
+      }
+      return EvaluateConstraints(x);
+   }
+
+   /** Evaluate c and d at x, see EvaluateFunctions.
+    *
+    *  The default implementation calls c and d and catches Eval_Error.
+    */
+   virtual bool EvaluateConstraints(
+      const Vector& x
+   )
+   {
+      try
+      {
+         c(x);
+         d(x);
+      }
+      catch( Eval_Error& )
+      {
+         return false;
+      }
+      return true;
+   }
+
    /** Lower bounds on x */
    virtual SmartPtr<const Vector> x_L() const = 0;
 
@@ -187,6 +263,98 @@ public:
       const Vector& new_d_U
    ) = 0;
 
+   /** @name Methods for updating the scaling of the constraints during the optimization */
+   ///@{
+   /** Compute new scaling factors for the constraints at the scaled
+    *  point x.
+    *
+    *  On success, c_factors and d_factors are the ratios of the new
+    *  and the current scaling factors of each constraint.  The default
+    *  implementation returns false, that is, the scaling is kept.
+    */
+   virtual bool ComputeConstraintScalingUpdate(
+      const Vector&     /*x*/,
+      SmartPtr<Vector>& /*c_factors*/,
+      SmartPtr<Vector>& /*d_factors*/
+   )
+   {
+      return false;
+   }
+
+   /** Multiply the scaling factors of the constraints by c_factors
+    *  and d_factors.
+    *
+    *  The bounds d_L and d_U are transformed to the new scaling and
+    *  all cached function values and derivatives are discarded.  The
+    *  caller has to transform the iterates.
+    */
+   virtual void ApplyConstraintScalingUpdate(
+      const Vector& /*c_factors*/,
+      const Vector& /*d_factors*/
+   )
+   { }
+   ///@}
+
+   /** Method for obtaining a block-angular structure of the problem.
+    *
+    *  Each entry of x, c, and d is assigned to a diagonal block
+    *  between 0 and num_blocks-1, or to -1 if it is linking, see
+    *  TNLP::get_diagonal_blocks.  The default implementation returns
+    *  false, i.e., no structure is known.
+    */
+   virtual bool GetDiagonalBlocks(
+      Index&              /*num_blocks*/,
+      std::vector<Index>& /*x_block*/,
+      std::vector<Index>& /*c_block*/,
+      std::vector<Index>& /*d_block*/
+   )
+   {
+      return false;
+   }
+
+   /** Method for obtaining the element functions of a partially
+    *  separable problem.
+    *
+    *  The variables of element function e are
+    *  elem_vars[elem_start[e]], ..., elem_vars[elem_start[e+1]-1],
+    *  see NLP::GetElementFunctions.  The default implementation
+    *  returns false, i.e., no structure is known.
+    */
+   virtual bool GetElementFunctions(
+      std::vector<Index>& /*elem_start*/,
+      std::vector<Index>& /*elem_vars*/
+   )
+   {
+      return false;
+   }
+
+   /** Gradients of the element functions of the Lagrangian
+    *
+    *  The entries of the returned vector correspond to elem_vars of
+    *  GetElementFunctions.  The default implementation returns NULL.
+    */
+   virtual SmartPtr<const Vector> element_gradients(
+      const Vector& /*x*/,
+      Number        /*obj_factor*/,
+      const Vector& /*yc*/,
+      const Vector& /*yd*/
+   )
+   {
+      return NULL;
+   }
+
+   /** Indicates whether the problem is known to be a quadratic
+    *  program, i.e., the Hessian of the Lagrangian and the Jacobians of
+    *  the constraints are constant.
+    *
+    *  This is only known after InitializeStructures has been called.
+    *  The default implementation returns false.
+    */
+   virtual bool IsQuadraticProgram() const
+   {
+      return false;
+   }
+
    /** @name Counters for the number of function evaluations. */
    ///@{
    virtual Index f_evals() const = 0;
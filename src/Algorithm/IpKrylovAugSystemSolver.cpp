@@ -0,0 +1,758 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpKrylovAugSystemSolver.hpp"
+#include "IpIpoptData.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+KrylovAugSystemSolver::KrylovAugSystemSolver(
+   SmartPtr<AugSystemPreconditioner> precond
+)
+   : AugSystemSolver(),
+     W_(NULL),
+     W_factor_(0.),
+     D_x_(NULL),
+     delta_x_(0.),
+     D_s_(NULL),
+     delta_s_(0.),
+     J_c_(NULL),
+     D_c_(NULL),
+     delta_c_(0.),
+     J_d_(NULL),
+     D_d_(NULL),
+     delta_d_(0.),
+     precond_(precond),
+     last_iter_(0),
+     negevals_(-1)
+{
+   DBG_START_METH("KrylovAugSystemSolver::KrylovAugSystemSolver()", dbg_verbosity);
+}
+
+KrylovAugSystemSolver::~KrylovAugSystemSolver()
+{
+   DBG_START_METH("KrylovAugSystemSolver::~KrylovAugSystemSolver()", dbg_verbosity);
+}
+
+void KrylovAugSystemSolver::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddStringOption2(
+      "krylov_method",
+      "Krylov subspace method for the augmented system if the Hessian is only available as products with vectors.",
+      "minres",
+      "minres", "use MINRES",
+      "gmres", "use restarted GMRES",
+      "This option is only used if hessian_approximation is \"matrix-free\". "
+      "MINRES needs less memory and fewer operations per iteration, "
+      "while GMRES is more robust if the augmented system is badly conditioned.");
+   roptions->AddLowerBoundedNumberOption(
+      "krylov_tol",
+      "Relative residual tolerance of the Krylov subspace method.",
+      0., true,
+      1e-10,
+      "The Krylov method stops if the norm of the residual is below this factor times the norm of the right hand side. "
+      "If the solution is not accurate enough, the tolerance is decreased.");
+   roptions->AddLowerBoundedIntegerOption(
+      "krylov_max_iter",
+      "Maximal number of iterations of the Krylov subspace method per right hand side.",
+      1,
+      1000,
+      "If the Krylov method does not converge within this number of iterations, "
+      "the augmented system is treated as singular.");
+   roptions->AddLowerBoundedIntegerOption(
+      "krylov_restart",
+      "Number of iterations after which GMRES is restarted.",
+      1,
+      50,
+      "This determines how many vectors of the Krylov subspace are kept by GMRES.");
+   roptions->AddStringOption2(
+      "krylov_warm_start",
+      "Whether the Krylov subspace method starts from the solution of the previous augmented system.",
+      "no",
+      "no", "start from zero",
+      "yes", "start from the previous solution for the same kind of right hand side",
+      "Consecutive augmented systems are often close, so that the previous solution can be a good initial guess. "
+      "It is only used if its residual is smaller than the norm of the right hand side. "
+      "In the inexact algorithm, the normal and the primal-dual steps are kept separately.");
+   roptions->AddStringOption3(
+      "krylov_preconditioner",
+      "Preconditioner for the Krylov subspace method.",
+      "diagonal",
+      "none", "no preconditioner",
+      "diagonal", "diagonal preconditioner",
+      "custom", "use custom preconditioner",
+      "The diagonal preconditioner is 1 plus the absolute value of the diagonal terms of the augmented system "
+      "(without the Hessian), that is, it accounts mainly for the barrier terms. "
+      "A custom preconditioner, e.g., an algebraic multigrid or constraint preconditioner, "
+      "can be provided as an AugSystemPreconditioner to the algorithm builder.");
+}
+
+bool KrylovAugSystemSolver::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   std::string method;
+   options.GetStringValue("krylov_method", method, prefix);
+   use_gmres_ = (method == "gmres");
+   options.GetNumericValue("krylov_tol", tol_, prefix);
+   options.GetIntegerValue("krylov_max_iter", max_iter_, prefix);
+   options.GetIntegerValue("krylov_restart", restart_, prefix);
+   options.GetBoolValue("krylov_warm_start", warm_start_, prefix);
+
+   kkt_space_ = NULL;
+   warm_start_sol_.clear();
+   last_iter_ = 0;
+   negevals_ = -1;
+
+   if( IsNull(precond_) )
+   {
+      return true;
+   }
+   if( !use_gmres_ && !precond_->IsPositiveDefinite() )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "The preconditioner is not positive definite, using GMRES instead of MINRES.\n");
+      use_gmres_ = true;
+   }
+   return precond_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+}
+
+ESymSolverStatus KrylovAugSystemSolver::MultiSolve(
+   const SymMatrix*                      W,
+   double                                W_factor,
+   const Vector*                         D_x,
+   double                                delta_x,
+   const Vector*                         D_s,
+   double                                delta_s,
+   const Matrix*                         J_c,
+   const Vector*                         D_c,
+   double                                delta_c,
+   const Matrix*                         J_d,
+   const Vector*                         D_d,
+   double                                delta_d,
+   std::vector<SmartPtr<const Vector> >& rhs_xV,
+   std::vector<SmartPtr<const Vector> >& rhs_sV,
+   std::vector<SmartPtr<const Vector> >& rhs_cV,
+   std::vector<SmartPtr<const Vector> >& rhs_dV,
+   std::vector<SmartPtr<Vector> >&       sol_xV,
+   std::vector<SmartPtr<Vector> >&       sol_sV,
+   std::vector<SmartPtr<Vector> >&       sol_cV,
+   std::vector<SmartPtr<Vector> >&       sol_dV,
+   bool                                  /*check_NegEVals*/,
+   Index                                 numberOfNegEVals
+)
+{
+   DBG_START_METH("KrylovAugSystemSolver::MultiSolve", dbg_verbosity);
+   DBG_ASSERT(J_c && J_d);
+
+   Index nrhs = (Index) rhs_xV.size();
+   DBG_ASSERT(nrhs > 0);
+
+   // The inertia is not known; we report the expected number of
+   // negative eigenvalues unless the Hessian is to be modified
+   negevals_ = numberOfNegEVals;
+
+   W_ = W;
+   W_factor_ = W_factor;
+   D_x_ = D_x;
+   delta_x_ = delta_x;
+   D_s_ = D_s;
+   delta_s_ = delta_s;
+   J_c_ = J_c;
+   D_c_ = D_c;
+   delta_c_ = delta_c;
+   J_d_ = J_d;
+   D_d_ = D_d;
+   delta_d_ = delta_d;
+
+   UpdateKKTSpace(*rhs_xV[0], *rhs_sV[0], *rhs_cV[0], *rhs_dV[0]);
+
+   ESymSolverStatus retval = SYMSOLVER_SUCCESS;
+   if( IsValid(precond_)
+       && !precond_->UpdatePreconditioner(W, W_factor, D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d) )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Preconditioner for the augmented system could not be computed.\n");
+      retval = SYMSOLVER_FATAL_ERROR;
+   }
+   for( Index i = 0; i < nrhs && retval == SYMSOLVER_SUCCESS; i++ )
+   {
+      SmartPtr<CompoundVector> rhs = kkt_space_->MakeNewCompoundVector(false);
+      rhs->SetComp(0, *rhs_xV[i]);
+      rhs->SetComp(1, *rhs_sV[i]);
+      rhs->SetComp(2, *rhs_cV[i]);
+      rhs->SetComp(3, *rhs_dV[i]);
+      SmartPtr<CompoundVector> sol = kkt_space_->MakeNewCompoundVector(false);
+      sol->SetCompNonConst(0, *sol_xV[i]);
+      sol->SetCompNonConst(1, *sol_sV[i]);
+      sol->SetCompNonConst(2, *sol_cV[i]);
+      sol->SetCompNonConst(3, *sol_dV[i]);
+
+      if( UseTerminationTest() && !InitializeTerminationTest() )
+      {
+         retval = SYMSOLVER_FATAL_ERROR;
+         break;
+      }
+
+      const CompoundVector* x0 = NULL;
+      Index key = -1;
+      if( warm_start_ )
+      {
+         key = WarmStartKey(i);
+         if( key >= (Index) warm_start_sol_.size() )
+         {
+            warm_start_sol_.resize(key + 1);
+         }
+         x0 = GetRawPtr(warm_start_sol_[key]);
+      }
+
+      if( HaveIpData() )
+      {
+         IpData().TimingStats().LinearSystemBackSolve().Start();
+      }
+      if( use_gmres_ )
+      {
+         retval = SolveGmres(*rhs, *sol, x0);
+      }
+      else
+      {
+         retval = SolveMinres(*rhs, *sol, x0);
+      }
+      if( UseTerminationTest() )
+      {
+         FinalizeTerminationTest();
+      }
+      if( HaveIpData() )
+      {
+         IpData().TimingStats().LinearSystemBackSolve().End();
+      }
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Number of iterations of %s for right hand side %" IPOPT_INDEX_FORMAT " = %" IPOPT_INDEX_FORMAT ".\n", use_gmres_ ? "GMRES" : "MINRES", i,
+                     last_iter_);
+
+      if( warm_start_ && retval == SYMSOLVER_SUCCESS )
+      {
+         if( IsNull(warm_start_sol_[key]) )
+         {
+            warm_start_sol_[key] = kkt_space_->MakeNewCompoundVector();
+         }
+         warm_start_sol_[key]->Copy(*sol);
+      }
+   }
+
+   if( retval == SYMSOLVER_WRONG_INERTIA )
+   {
+      negevals_ = numberOfNegEVals + 1;
+   }
+
+   W_ = NULL;
+   D_x_ = NULL;
+   D_s_ = NULL;
+   J_c_ = NULL;
+   D_c_ = NULL;
+   J_d_ = NULL;
+   D_d_ = NULL;
+
+   return retval;
+}
+
+Index KrylovAugSystemSolver::NumberOfNegEVals() const
+{
+   return negevals_;
+}
+
+bool KrylovAugSystemSolver::IncreaseQuality()
+{
+   const Number min_tol = 1e2 * std::numeric_limits<Number>::epsilon();
+   if( tol_ <= min_tol )
+   {
+      return false;
+   }
+   tol_ = Max(1e-2 * tol_, min_tol);
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Decreasing tolerance of Krylov method to %e.\n", tol_);
+   return true;
+}
+
+void KrylovAugSystemSolver::UpdateKKTSpace(
+   const Vector& proto_x,
+   const Vector& proto_s,
+   const Vector& proto_c,
+   const Vector& proto_d
+)
+{
+   if( IsValid(kkt_space_) && GetRawPtr(kkt_space_->GetCompSpace(0)) == GetRawPtr(proto_x.OwnerSpace())
+       && GetRawPtr(kkt_space_->GetCompSpace(1)) == GetRawPtr(proto_s.OwnerSpace())
+       && GetRawPtr(kkt_space_->GetCompSpace(2)) == GetRawPtr(proto_c.OwnerSpace())
+       && GetRawPtr(kkt_space_->GetCompSpace(3)) == GetRawPtr(proto_d.OwnerSpace()) )
+   {
+      return;
+   }
+
+   // previous solutions do not belong to the new spaces
+   warm_start_sol_.clear();
+
+   Index dimtot = proto_x.Dim() + proto_s.Dim() + proto_c.Dim() + proto_d.Dim();
+   kkt_space_ = new CompoundVectorSpace(4, dimtot);
+   kkt_space_->SetCompSpace(0, *proto_x.OwnerSpace());
+   kkt_space_->SetCompSpace(1, *proto_s.OwnerSpace());
+   kkt_space_->SetCompSpace(2, *proto_c.OwnerSpace());
+   kkt_space_->SetCompSpace(3, *proto_d.OwnerSpace());
+}
+
+void KrylovAugSystemSolver::ApplyKKT(
+   const CompoundVector& v,
+   CompoundVector&       r
+) const
+{
+   SmartPtr<const Vector> v_x = v.GetComp(0);
+   SmartPtr<const Vector> v_s = v.GetComp(1);
+   SmartPtr<const Vector> v_c = v.GetComp(2);
+   SmartPtr<const Vector> v_d = v.GetComp(3);
+   SmartPtr<Vector> r_x = r.GetCompNonConst(0);
+   SmartPtr<Vector> r_s = r.GetCompNonConst(1);
+   SmartPtr<Vector> r_c = r.GetCompNonConst(2);
+   SmartPtr<Vector> r_d = r.GetCompNonConst(3);
+
+   // r_x = (W + D_x + delta_x I) v_x + J_c^T v_c + J_d^T v_d
+   if( W_ && W_factor_ != 0. )
+   {
+      W_->MultVector(W_factor_, *v_x, 0., *r_x);
+      r_x->Axpy(delta_x_, *v_x);
+   }
+   else
+   {
+      r_x->AddOneVector(delta_x_, *v_x, 0.);
+   }
+   if( D_x_ )
+   {
+      SmartPtr<Vector> tmp = v_x->MakeNewCopy();
+      tmp->ElementWiseMultiply(*D_x_);
+      r_x->Axpy(1., *tmp);
+   }
+   J_c_->TransMultVector(1., *v_c, 1., *r_x);
+   J_d_->TransMultVector(1., *v_d, 1., *r_x);
+
+   // r_s = (D_s + delta_s I) v_s - v_d
+   r_s->AddTwoVectors(delta_s_, *v_s, -1., *v_d, 0.);
+   if( D_s_ )
+   {
+      SmartPtr<Vector> tmp = v_s->MakeNewCopy();
+      tmp->ElementWiseMultiply(*D_s_);
+      r_s->Axpy(1., *tmp);
+   }
+
+   // r_c = J_c v_x + (D_c - delta_c I) v_c
+   J_c_->MultVector(1., *v_x, 0., *r_c);
+   r_c->Axpy(-delta_c_, *v_c);
+   if( D_c_ )
+   {
+      SmartPtr<Vector> tmp = v_c->MakeNewCopy();
+      tmp->ElementWiseMultiply(*D_c_);
+      r_c->Axpy(1., *tmp);
+   }
+
+   // r_d = J_d v_x - v_s + (D_d - delta_d I) v_d
+   J_d_->MultVector(1., *v_x, 0., *r_d);
+   r_d->AddTwoVectors(-1., *v_s, -delta_d_, *v_d, 1.);
+   if( D_d_ )
+   {
+      SmartPtr<Vector> tmp = v_d->MakeNewCopy();
+      tmp->ElementWiseMultiply(*D_d_);
+      r_d->Axpy(1., *tmp);
+   }
+}
+
+void KrylovAugSystemSolver::ApplyPreconditioner(
+   const CompoundVector& r,
+   CompoundVector&       z
+)
+{
+   if( IsNull(precond_) )
+   {
+      z.Copy(r);
+      return;
+   }
+   precond_->ApplyPreconditioner(*r.GetComp(0), *r.GetComp(1), *r.GetComp(2), *r.GetComp(3), *z.GetCompNonConst(0),
+                                 *z.GetCompNonConst(1), *z.GetCompNonConst(2), *z.GetCompNonConst(3));
+}
+
+KrylovAugSystemSolver::EKrylovTest KrylovAugSystemSolver::CallTerminationTest(
+   Index                 iter,
+   const CompoundVector& rhs,
+   const CompoundVector& sol,
+   Number                norm2_rhs
+)
+{
+   SmartPtr<CompoundVector> resid = kkt_space_->MakeNewCompoundVector();
+   ApplyKKT(sol, *resid);
+   resid->Axpy(-1., rhs);
+   return TestTermination(iter, sol, *resid, norm2_rhs);
+}
+
+ESymSolverStatus KrylovAugSystemSolver::AcceptTermination(
+   EKrylovTest     result,
+   CompoundVector& sol
+) const
+{
+   switch( result )
+   {
+      case KRYLOV_ACCEPT_ZERO_PRIMAL:
+         // the step for the primal variables is to be zero
+         sol.GetCompNonConst(0)->Set(0.);
+         sol.GetCompNonConst(1)->Set(0.);
+         return SYMSOLVER_SUCCESS;
+      case KRYLOV_MODIFY_HESSIAN:
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Termination test requests modification of Hessian.\n");
+         return SYMSOLVER_WRONG_INERTIA;
+      default:
+         return SYMSOLVER_SUCCESS;
+   }
+}
+
+ESymSolverStatus KrylovAugSystemSolver::SolveMinres(
+   const CompoundVector& rhs,
+   CompoundVector&       sol,
+   const CompoundVector* x0
+)
+{
+   DBG_START_METH("KrylovAugSystemSolver::SolveMinres", dbg_verbosity);
+
+   // Preconditioned MINRES of Paige and Saunders, starting from zero
+   // or from x0
+   const bool use_test = UseTerminationTest();
+   const Number norm2_rhs = rhs.Nrm2();
+   last_iter_ = 0;
+   sol.Set(0.);
+
+   SmartPtr<CompoundVector> r1 = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> r2 = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> y = kkt_space_->MakeNewCompoundVector();
+   r1->Copy(rhs);
+   ApplyPreconditioner(*r1, *y);
+   Number beta_rhs = r1->Dot(*y);
+   DBG_ASSERT(beta_rhs >= 0.);
+   if( beta_rhs <= 0. )
+   {
+      return SYMSOLVER_SUCCESS;
+   }
+   beta_rhs = sqrt(beta_rhs);
+
+   // The relative residual refers to the right hand side also if the
+   // iteration starts from x0
+   Number beta1 = beta_rhs;
+   if( x0 )
+   {
+      ApplyKKT(*x0, *r2);
+      r2->AddOneVector(1., rhs, -1.);
+      SmartPtr<CompoundVector> z = kkt_space_->MakeNewCompoundVector();
+      ApplyPreconditioner(*r2, *z);
+      Number beta0 = sqrt(Max(r2->Dot(*z), 0.));
+      if( beta0 < beta_rhs )
+      {
+         sol.Copy(*x0);
+         r1->Copy(*r2);
+         y = z;
+         beta1 = beta0;
+         if( beta1 <= 0. )
+         {
+            return SYMSOLVER_SUCCESS;
+         }
+      }
+   }
+   r2->Copy(*r1);
+
+   SmartPtr<CompoundVector> v = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> w = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> w1 = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> w2 = kkt_space_->MakeNewCompoundVector();
+   w->Set(0.);
+   w1->Set(0.);
+   w2->Set(0.);
+
+   Number oldb = 0.;
+   Number beta = beta1;
+   Number dbar = 0.;
+   Number epsln = 0.;
+   Number phibar = beta1;
+   Number cs = -1.;
+   Number sn = 0.;
+
+   for( Index iter = 1; iter <= max_iter_; iter++ )
+   {
+      // Lanczos step
+      v->AddOneVector(1. / beta, *y, 0.);
+      ApplyKKT(*v, *y);
+      if( iter >= 2 )
+      {
+         y->Axpy(-beta / oldb, *r1);
+      }
+      Number alfa = v->Dot(*y);
+      y->Axpy(-alfa / beta, *r2);
+      SmartPtr<CompoundVector> tmp = r1;
+      r1 = r2;
+      r2 = y;
+      y = tmp;
+      ApplyPreconditioner(*r2, *y);
+      oldb = beta;
+      beta = sqrt(Max(r2->Dot(*y), 0.));
+
+      // Apply previous rotation and compute the new one
+      Number oldeps = epsln;
+      Number delta = cs * dbar + sn * alfa;
+      Number gbar = sn * dbar - cs * alfa;
+      epsln = sn * beta;
+      dbar = -cs * beta;
+      Number gamma = Max(sqrt(gbar * gbar + beta * beta), std::numeric_limits<Number>::epsilon());
+      cs = gbar / gamma;
+      sn = beta / gamma;
+      Number phi = cs * phibar;
+      phibar = sn * phibar;
+
+      // Update the solution
+      tmp = w1;
+      w1 = w2;
+      w2 = w;
+      w = tmp;
+      w->AddTwoVectors(-oldeps / gamma, *w1, -delta / gamma, *w2, 0.);
+      w->Axpy(1. / gamma, *v);
+      sol.Axpy(phi, *w);
+      last_iter_ = iter;
+
+      if( use_test )
+      {
+         EKrylovTest result = CallTerminationTest(iter, rhs, sol, norm2_rhs);
+         if( result != KRYLOV_CONTINUE )
+         {
+            return AcceptTermination(result, sol);
+         }
+      }
+      else if( phibar <= tol_ * beta_rhs )
+      {
+         return SYMSOLVER_SUCCESS;
+      }
+
+      if( beta == 0. )
+      {
+         // The Krylov subspace is invariant, no further progress possible
+         break;
+      }
+   }
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "MINRES did not converge in %" IPOPT_INDEX_FORMAT " iterations (relative residual %e).\n", last_iter_, phibar / beta_rhs);
+   return SYMSOLVER_SINGULAR;
+}
+
+ESymSolverStatus KrylovAugSystemSolver::SolveGmres(
+   const CompoundVector& rhs,
+   CompoundVector&       sol,
+   const CompoundVector* x0
+)
+{
+   DBG_START_METH("KrylovAugSystemSolver::SolveGmres", dbg_verbosity);
+
+   // Right preconditioned GMRES with restarts, starting from zero or
+   // from x0
+   const bool use_test = UseTerminationTest();
+   const Number norm2_rhs = rhs.Nrm2();
+   last_iter_ = 0;
+   sol.Set(0.);
+   if( norm2_rhs == 0. )
+   {
+      return SYMSOLVER_SUCCESS;
+   }
+
+   const Index m = restart_;
+   std::vector<SmartPtr<CompoundVector> > V(m + 1);
+   Number* H = new Number[(m + 1) * m];
+   Number* cs = new Number[m];
+   Number* sn = new Number[m];
+   Number* g = new Number[m + 1];
+   Number* ycoef = new Number[m];
+
+   SmartPtr<CompoundVector> r = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> z = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> w = kkt_space_->MakeNewCompoundVector();
+   SmartPtr<CompoundVector> cand;
+   if( use_test )
+   {
+      cand = kkt_space_->MakeNewCompoundVector();
+   }
+   r->Copy(rhs);
+   if( x0 )
+   {
+      ApplyKKT(*x0, *w);
+      w->AddOneVector(1., rhs, -1.);
+      if( w->Nrm2() < norm2_rhs )
+      {
+         sol.Copy(*x0);
+         r->Copy(*w);
+      }
+   }
+
+   ESymSolverStatus retval = SYMSOLVER_SINGULAR;
+   Number resid = norm2_rhs;
+   bool stop = false;
+   while( !stop && last_iter_ < max_iter_ )
+   {
+      Number beta = r->Nrm2();
+      resid = beta;
+      if( beta == 0. || (!use_test && beta <= tol_ * norm2_rhs) )
+      {
+         retval = SYMSOLVER_SUCCESS;
+         break;
+      }
+      if( IsNull(V[0]) )
+      {
+         V[0] = kkt_space_->MakeNewCompoundVector();
+      }
+      V[0]->AddOneVector(1. / beta, *r, 0.);
+      g[0] = beta;
+
+      Index k = 0;
+      for( Index j = 0; j < m && last_iter_ < max_iter_; j++ )
+      {
+         last_iter_++;
+         ApplyPreconditioner(*V[j], *z);
+         ApplyKKT(*z, *w);
+
+         // modified Gram-Schmidt
+         for( Index i = 0; i <= j; i++ )
+         {
+            H[i + j * (m + 1)] = w->Dot(*V[i]);
+            w->Axpy(-H[i + j * (m + 1)], *V[i]);
+         }
+         Number hnext = w->Nrm2();
+
+         // apply the previous rotations and compute the new one
+         for( Index i = 0; i < j; i++ )
+         {
+            Number tmp = cs[i] * H[i + j * (m + 1)] + sn[i] * H[i + 1 + j * (m + 1)];
+            H[i + 1 + j * (m + 1)] = -sn[i] * H[i + j * (m + 1)] + cs[i] * H[i + 1 + j * (m + 1)];
+            H[i + j * (m + 1)] = tmp;
+         }
+         Number denom = sqrt(H[j + j * (m + 1)] * H[j + j * (m + 1)] + hnext * hnext);
+         if( denom == 0. )
+         {
+            cs[j] = 1.;
+            sn[j] = 0.;
+         }
+         else
+         {
+            cs[j] = H[j + j * (m + 1)] / denom;
+            sn[j] = hnext / denom;
+         }
+         H[j + j * (m + 1)] = cs[j] * H[j + j * (m + 1)] + sn[j] * hnext;
+         g[j + 1] = -sn[j] * g[j];
+         g[j] = cs[j] * g[j];
+         resid = std::abs(g[j + 1]);
+         k = j + 1;
+
+         if( use_test )
+         {
+            // form the current solution for the termination test
+            for( Index i = k - 1; i >= 0; i-- )
+            {
+               Number val = g[i];
+               for( Index l = i + 1; l < k; l++ )
+               {
+                  val -= H[i + l * (m + 1)] * ycoef[l];
+               }
+               ycoef[i] = H[i + i * (m + 1)] != 0. ? val / H[i + i * (m + 1)] : 0.;
+            }
+            // w is still needed for the next basis vector
+            cand->Set(0.);
+            for( Index i = 0; i < k; i++ )
+            {
+               cand->Axpy(ycoef[i], *V[i]);
+            }
+            ApplyPreconditioner(*cand, *z);
+            cand->Copy(sol);
+            cand->Axpy(1., *z);
+            EKrylovTest result = CallTerminationTest(last_iter_, rhs, *cand, norm2_rhs);
+            if( result != KRYLOV_CONTINUE )
+            {
+               sol.Copy(*cand);
+               retval = AcceptTermination(result, sol);
+               k = 0;
+               stop = true;
+               break;
+            }
+         }
+         else if( resid <= tol_ * norm2_rhs )
+         {
+            retval = SYMSOLVER_SUCCESS;
+            stop = true;
+            break;
+         }
+
+         if( hnext == 0. )
+         {
+            // The Krylov subspace is invariant, no further progress possible
+            stop = true;
+            break;
+         }
+         if( IsNull(V[j + 1]) )
+         {
+            V[j + 1] = kkt_space_->MakeNewCompoundVector();
+         }
+         V[j + 1]->AddOneVector(1. / hnext, *w, 0.);
+      }
+
+      if( k > 0 )
+      {
+         // update the solution with the minimizer in the Krylov subspace
+         for( Index i = k - 1; i >= 0; i-- )
+         {
+            Number val = g[i];
+            for( Index l = i + 1; l < k; l++ )
+            {
+               val -= H[i + l * (m + 1)] * ycoef[l];
+            }
+            ycoef[i] = H[i + i * (m + 1)] != 0. ? val / H[i + i * (m + 1)] : 0.;
+         }
+         w->Set(0.);
+         for( Index i = 0; i < k; i++ )
+         {
+            w->Axpy(ycoef[i], *V[i]);
+         }
+         ApplyPreconditioner(*w, *z);
+         sol.Axpy(1., *z);
+      }
+
+      if( !stop )
+      {
+         // residual for the restart
+         ApplyKKT(sol, *r);
+         r->AddOneVector(1., rhs, -1.);
+      }
+   }
+
+   delete[] ycoef;
+   delete[] g;
+   delete[] sn;
+   delete[] cs;
+   delete[] H;
+
+   if( retval == SYMSOLVER_SINGULAR )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "GMRES did not converge in %" IPOPT_INDEX_FORMAT " iterations (relative residual %e).\n", last_iter_, resid / norm2_rhs);
+   }
+   return retval;
+}
+
+} // namespace Ipopt
@@ -0,0 +1,320 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IP_KRYLOVAUGSYSTEMSOLVER_HPP__
+#define __IP_KRYLOVAUGSYSTEMSOLVER_HPP__
+
+#include "IpAugSystemSolver.hpp"
+#include "IpAugSystemPreconditioner.hpp"
+#include "IpCompoundVector.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+/** Solver for the augmented system by a preconditioned Krylov
+ *  subspace method.
+ *
+ *  The matrices in the augmented system are only used through
+ *  products with vectors, so that this solver can be used if the
+ *  Hessian is available only as products with vectors
+ *  (hessian_approximation=matrix-free).  The system is solved by
+ *  MINRES or by restarted GMRES, with a preconditioner that is given
+ *  as an AugSystemPreconditioner, e.g., the diagonal preconditioner
+ *  DiagonalAugSystemPreconditioner.
+ *
+ *  Since no factorization is computed, the inertia of the augmented
+ *  system is not available.  If the Krylov method does not converge,
+ *  SYMSOLVER_SINGULAR is returned, so that the system is regularized
+ *  by the caller.
+ *
+ *  By default, an iteration is stopped when the relative residual is
+ *  below krylov_tol.  A derived class can replace this by its own
+ *  termination test, see UseTerminationTest and TestTermination.
+ *
+ *  If krylov_warm_start is enabled, the solution of the previous call
+ *  for the same right hand side (see WarmStartKey) is used as the
+ *  initial guess, since consecutive augmented systems are often close.
+ */
+class KrylovAugSystemSolver: public AugSystemSolver
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor.
+    *
+    *  If precond is NULL, no preconditioner is used.
+    */
+   KrylovAugSystemSolver(
+      SmartPtr<AugSystemPreconditioner> precond
+   );
+
+   /** Destructor */
+   virtual ~KrylovAugSystemSolver();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   virtual ESymSolverStatus MultiSolve(
+      const SymMatrix*                      W,
+      double                                W_factor,
+      const Vector*                         D_x,
+      double                                delta_x,
+      const Vector*                         D_s,
+      double                                delta_s,
+      const Matrix*                         J_c,
+      const Vector*                         D_c,
+      double                                delta_c,
+      const Matrix*                         J_d,
+      const Vector*                         D_d,
+      double                                delta_d,
+      std::vector<SmartPtr<const Vector> >& rhs_xV,
+      std::vector<SmartPtr<const Vector> >& rhs_sV,
+      std::vector<SmartPtr<const Vector> >& rhs_cV,
+      std::vector<SmartPtr<const Vector> >& rhs_dV,
+      std::vector<SmartPtr<Vector> >&       sol_xV,
+      std::vector<SmartPtr<Vector> >&       sol_sV,
+      std::vector<SmartPtr<Vector> >&       sol_cV,
+      std::vector<SmartPtr<Vector> >&       sol_dV,
+      bool                                  check_NegEVals,
+      Index                                 numberOfNegEVals
+   );
+
+   /** The inertia is not known.
+    *
+    *  This returns the expected number of negative eigenvalues given
+    *  to the most recent call of MultiSolve, or one more if the
+    *  termination test requested a modification of the Hessian.
+    */
+   virtual Index NumberOfNegEVals() const;
+
+   virtual bool ProvidesInertia() const
+   {
+      return false;
+   }
+
+   /** Decreases the tolerance of the Krylov method. */
+   virtual bool IncreaseQuality();
+
+   /** Methods for IpoptType */
+   ///@{
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+   ///@}
+
+protected:
+   /** Result of a termination test of a derived class */
+   enum EKrylovTest
+   {
+      /** The current solution is not yet good enough */
+      KRYLOV_CONTINUE,
+      /** The current solution is accepted */
+      KRYLOV_ACCEPT,
+      /** The current solution is accepted, but its primal part is to be set to zero */
+      KRYLOV_ACCEPT_ZERO_PRIMAL,
+      /** The solve is stopped since the Hessian should be modified */
+      KRYLOV_MODIFY_HESSIAN
+   };
+
+   /** Whether TestTermination is used instead of the test on the
+    *  relative residual.
+    *
+    *  Since the termination test requires the current solution and its
+    *  residual, these are computed explicitly in each iteration then,
+    *  which costs an additional product with the augmented system.
+    */
+   virtual bool UseTerminationTest() const
+   {
+      return false;
+   }
+
+   /** Method that is called before the Krylov method is started for a
+    *  right hand side if UseTerminationTest returns true.
+    */
+   virtual bool InitializeTerminationTest()
+   {
+      return true;
+   }
+
+   /** Method that is called after the Krylov method has finished for
+    *  a right hand side if UseTerminationTest returns true.
+    */
+   virtual void FinalizeTerminationTest()
+   { }
+
+   /** Termination test that is called in each iteration of the Krylov
+    *  method if UseTerminationTest returns true.
+    *
+    *  sol is the current solution, resid = K*sol - rhs its residual,
+    *  and norm2_rhs the 2-norm of the right hand side.  Both vectors
+    *  have the components x, s, c, and d.
+    */
+   virtual EKrylovTest TestTermination(
+      Index                 /*iter*/,
+      const CompoundVector& /*sol*/,
+      const CompoundVector& /*resid*/,
+      Number                /*norm2_rhs*/
+   )
+   {
+      return KRYLOV_CONTINUE;
+   }
+
+   /** Key under which the solution for the right hand side irhs is
+    *  kept as initial guess for the next call of MultiSolve.
+    *
+    *  A derived class that solves different kinds of systems can use
+    *  different keys for them.  This is called after
+    *  InitializeTerminationTest.
+    */
+   virtual Index WarmStartKey(
+      Index irhs
+   ) const
+   {
+      return irhs;
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   KrylovAugSystemSolver();
+
+   /** Copy Constructor */
+   KrylovAugSystemSolver(
+      const KrylovAugSystemSolver&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const KrylovAugSystemSolver&
+   );
+   ///@}
+
+   /** @name The augmented system of the current call of MultiSolve.
+    *
+    *  These pointers are only valid during MultiSolve.
+    */
+   ///@{
+   const SymMatrix* W_;
+   double W_factor_;
+   const Vector* D_x_;
+   double delta_x_;
+   const Vector* D_s_;
+   double delta_s_;
+   const Matrix* J_c_;
+   const Vector* D_c_;
+   double delta_c_;
+   const Matrix* J_d_;
+   const Vector* D_d_;
+   double delta_d_;
+   ///@}
+
+   /** Vector space for the vectors of the whole augmented system,
+    *  with components x, s, c, and d
+    */
+   SmartPtr<CompoundVectorSpace> kkt_space_;
+
+   /** Preconditioner, or NULL if none is used */
+   SmartPtr<AugSystemPreconditioner> precond_;
+
+   /** @name Algorithmic parameters */
+   ///@{
+   /** Whether GMRES instead of MINRES is used */
+   bool use_gmres_;
+   /** Relative residual tolerance for the Krylov method */
+   Number tol_;
+   /** Maximal number of iterations per right hand side */
+   Index max_iter_;
+   /** Number of iterations after which GMRES is restarted */
+   Index restart_;
+   /** Whether previous solutions are used as initial guesses */
+   bool warm_start_;
+   ///@}
+
+   /** Solutions of the previous solves, indexed by WarmStartKey */
+   std::vector<SmartPtr<CompoundVector> > warm_start_sol_;
+
+   /** Number of iterations of the most recent solve */
+   Index last_iter_;
+
+   /** Number of negative eigenvalues reported by NumberOfNegEVals */
+   Index negevals_;
+
+   /** @name Internal functions */
+   ///@{
+   /** Create the vector space for the augmented system if the
+    *  component spaces have changed.
+    */
+   void UpdateKKTSpace(
+      const Vector& proto_x,
+      const Vector& proto_s,
+      const Vector& proto_c,
+      const Vector& proto_d
+   );
+
+   /** Multiply the augmented system with v: r = K*v */
+   void ApplyKKT(
+      const CompoundVector& v,
+      CompoundVector&       r
+   ) const;
+
+   /** Apply the inverse of the preconditioner: z = M^{-1}*r */
+   void ApplyPreconditioner(
+      const CompoundVector& r,
+      CompoundVector&       z
+   );
+
+   /** Compute the residual of sol and call TestTermination. */
+   EKrylovTest CallTerminationTest(
+      Index                 iter,
+      const CompoundVector& rhs,
+      const CompoundVector& sol,
+      Number                norm2_rhs
+   );
+
+   /** Translate the result of TestTermination into the return value
+    *  of the solve, and set the primal part of sol to zero if requested.
+    */
+   ESymSolverStatus AcceptTermination(
+      EKrylovTest     result,
+      CompoundVector& sol
+   ) const;
+
+   /** Solve K*sol = rhs by MINRES.
+    *
+    *  If x0 is not NULL, it is used as initial guess if its residual
+    *  is smaller than the one of zero.
+    */
+   ESymSolverStatus SolveMinres(
+      const CompoundVector& rhs,
+      CompoundVector&       sol,
+      const CompoundVector* x0
+   );
+
+   /** Solve K*sol = rhs by restarted GMRES.
+    *
+    *  x0 is an optional initial guess as for SolveMinres.
+    */
+   ESymSolverStatus SolveGmres(
+      const CompoundVector& rhs,
+      CompoundVector&       sol,
+      const CompoundVector* x0
+   );
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
@@ -0,0 +1,87 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpLaggedHessianUpdater.hpp"
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+LaggedHessianUpdater::LaggedHessianUpdater()
+   : hessian_lag_iterations_(1),
+     hessian_lag_error_reduction_(1.),
+     lag_count_(0),
+     last_nlp_error_(0.),
+     last_iter_(-1)
+{ }
+
+void LaggedHessianUpdater::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddLowerBoundedIntegerOption(
+      "hessian_lag_iterations",
+      "Maximal number of iterations for which the exact Hessian is reused.",
+      1,
+      5,
+      "If hessian_approximation is \"lagged-exact\", the Hessian of the Lagrangian is evaluated "
+      "at least every this many iterations and reused in between.");
+   roptions->AddBoundedNumberOption(
+      "hessian_lag_error_reduction",
+      "Required reduction of the optimality error while the exact Hessian is reused.",
+      0., true,
+      1., false,
+      0.5,
+      "If hessian_approximation is \"lagged-exact\", the Hessian of the Lagrangian is evaluated again "
+      "if the optimality error of an iterate is larger than this factor times the optimality error "
+      "of the previous iterate.");
+}
+
+bool LaggedHessianUpdater::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   options.GetIntegerValue("hessian_lag_iterations", hessian_lag_iterations_, prefix);
+   options.GetNumericValue("hessian_lag_error_reduction", hessian_lag_error_reduction_, prefix);
+
+   lagged_W_ = NULL;
+   lag_count_ = 0;
+   last_nlp_error_ = 0.;
+   last_iter_ = -1;
+
+   return true;
+}
+
+void LaggedHessianUpdater::UpdateHessian()
+{
+   DBG_START_METH("LaggedHessianUpdater::UpdateHessian",
+                  dbg_verbosity);
+
+   Number nlp_error = IpCq().curr_nlp_error();
+   Index iter = IpData().iter_count();
+   lag_count_++;
+   // the iteration counter increases by more than one if the
+   // restoration phase has been used
+   if( IsNull(lagged_W_) || lag_count_ >= hessian_lag_iterations_ || iter != last_iter_ + 1
+       || nlp_error > hessian_lag_error_reduction_ * last_nlp_error_ )
+   {
+      lagged_W_ = IpCq().curr_exact_hessian();
+      lag_count_ = 0;
+   }
+   else
+   {
+      Jnlst().Printf(J_DETAILED, J_MAIN,
+                     "Reusing the Hessian evaluated %" IPOPT_INDEX_FORMAT " iterations ago.\n", lag_count_);
+   }
+   last_nlp_error_ = nlp_error;
+   last_iter_ = iter;
+
+   IpData().Set_W(lagged_W_);
+}
+
+} // namespace Ipopt
@@ -0,0 +1,100 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPLAGGEDHESSIANUPDATER_HPP__
+#define __IPLAGGEDHESSIANUPDATER_HPP__
+
+#include "IpHessianUpdater.hpp"
+
+namespace Ipopt
+{
+
+/** Implementation of the HessianUpdater that reuses the exact second
+ *  derivatives for several iterations.
+ *
+ *  The exact Hessian is evaluated at most every
+ *  hessian_lag_iterations iterations, and additionally whenever the
+ *  optimality error of the NLP has not decreased by the factor
+ *  hessian_lag_error_reduction since the previous iteration, or if
+ *  iterations have been taken by the restoration phase.  In
+ *  between, the same matrix is set as W, so that its values are not
+ *  filled into the linear solver again.
+ */
+class LaggedHessianUpdater: public HessianUpdater
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Default Constructor */
+   LaggedHessianUpdater();
+
+   /** Destructor */
+   virtual ~LaggedHessianUpdater()
+   { }
+   ///@}
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** Update the Hessian based on the current information in IpData. */
+   virtual void UpdateHessian();
+
+   /** Methods for IpoptType */
+   ///@{
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   LaggedHessianUpdater(
+      const LaggedHessianUpdater&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const LaggedHessianUpdater&
+   );
+   ///@}
+
+   /** @name Algorithmic parameters */
+   ///@{
+   /** Maximal number of iterations for which the Hessian is reused */
+   Index hessian_lag_iterations_;
+   /** Required reduction of the optimality error per iteration while
+    *  the Hessian is reused
+    */
+   Number hessian_lag_error_reduction_;
+   ///@}
+
+   /** Most recently evaluated exact Hessian, or NULL */
+   SmartPtr<const SymMatrix> lagged_W_;
+
+   /** Number of iterations since lagged_W_ has been evaluated */
+   Index lag_count_;
+
+   /** Optimality error in the previous call of UpdateHessian */
+   Number last_nlp_error_;
+
+   /** Iteration counter in the previous call of UpdateHessian */
+   Index last_iter_;
+};
+
+} // namespace Ipopt
+
+#endif
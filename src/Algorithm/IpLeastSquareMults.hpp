@@ -27,7 +27,11 @@ public:
    /** Constructor.
     *
     *  It needs to be given the strategy object for
-    *  solving the augmented system.
+    *  solving the augmented system.  This should be the object that
+    *  is also used for the primal-dual system, so that the structure
+    *  of the augmented system and its symbolic factorization are
+    *  shared with the search direction computation.  The numerical
+    *  factorization cannot be reused, since the matrix values differ.
     */
    LeastSquareMultipliers(
       AugSystemSolver& augSysSolver
@@ -6,6 +6,9 @@
 
 #include "IpLimMemQuasiNewtonUpdater.hpp"
 #include "IpRestoIpoptNLP.hpp"
+#include "IpCheckpoint.hpp"
+#include "IpAlgTypes.hpp"
+#include "IpBlas.hpp"
 
 #include <cmath>
 #include <limits>
@@ -17,12 +20,25 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Updates for which the ratio of the smallest over the largest
+ *  eigenvalue (in absolute values) of the middle matrix of the SR1
+ *  update is smaller than this are skipped.
+ */
+static const Number sr1_eigenvalue_ratio_tol = 1e-12;
+
 LimMemQuasiNewtonUpdater::LimMemQuasiNewtonUpdater(
    bool update_for_resto
 )
-   : update_for_resto_(update_for_resto)
+   : update_for_resto_(update_for_resto),
+     accounted_memory_(0),
+     memory_account_(MemoryStatistics::LIMITED_MEMORY_UPDATE)
 { }
 
+LimMemQuasiNewtonUpdater::~LimMemQuasiNewtonUpdater()
+{
+   memory_account_.Free(accounted_memory_);
+}
+
 void LimMemQuasiNewtonUpdater::RegisterOptions(
    SmartPtr<RegisteredOptions> roptions
 )
@@ -267,12 +283,20 @@ void LimMemQuasiNewtonUpdater::UpdateHessian()
       {
          sigma_ = -1;
       }
+      else if( IsValid(h_space_->ExactSpace()) )
+      {
+         // Without curvature information, the exact part is used alone.
+         // A multiple of I would stay in W as a proximal term if the
+         // exact part is (almost) exact, so that all pairs are skipped.
+         sigma_ = 0.;
+      }
       else
       {
          // Set up W to be multiple of I
          sigma_ = limited_memory_init_val_;
       }
       SetW();
+      AccountMemory();
       return;
    }
 
@@ -308,6 +332,13 @@ void LimMemQuasiNewtonUpdater::UpdateHessian()
       y_full_new->AddTwoVectors(1., *IpCq().curr_jac_cT_times_curr_y_c(), 1., *IpCq().curr_jac_dT_times_curr_y_d(), 1.);
       last_jac_c_->TransMultVector(-1., *IpData().curr()->y_c(), 1., *y_full_new);
       last_jac_d_->TransMultVector(-1., *IpData().curr()->y_d(), 1., *y_full_new);
+
+      if( IsValid(h_space_->ExactSpace()) )
+      {
+         // structured update: only the difference to the exact part
+         // of the Hessian is approximated
+         IpCq().curr_exact_hessian()->MultVector(-1., *s_full_new, 1., *y_full_new);
+      }
    }
 
    SmartPtr<Vector> s_new;
@@ -611,23 +642,27 @@ void LimMemQuasiNewtonUpdater::UpdateHessian()
             DBG_PRINT_MATRIX(3, "L", *L_);
             DBG_PRINT_VECTOR(3, "D", *D_);
             Z->SpecialAddForLMSR1(*D_, *L_);
-            // Compute the eigenvectors Q and eignevalues E for Z
-            SmartPtr<DenseGenMatrix> Q = L_->MakeNewDenseGenMatrix();
-            SmartPtr<DenseVector> E = D_->MakeNewDenseVector();
             DBG_PRINT_MATRIX(3, "Z", *Z);
-            bool retval = Q->ComputeEigenVectors(*Z, *E);
-            ASSERT_EXCEPTION(retval, INTERNAL_ABORT, "Eigenvalue decomposition failed for limited-memory SR1 update.")
-            ;
-            DBG_PRINT_VECTOR(2, "E", *E);
-            DBG_PRINT_MATRIX(3, "Q", *Q);
             SmartPtr<DenseGenMatrix> Qminus;
             SmartPtr<DenseGenMatrix> Qplus;
-            // Split the eigenvectors and scale them
-            skipping = SplitEigenvalues(*Q, *E, Qminus, Qplus);
-            if( skipping )
+            // If Z is definite, a Cholesky factorization is sufficient
+            if( !SplitByCholesky(*Z, Qminus, Qplus) )
             {
-               RestoreInternalDataBackup();
-               break;
+               // Compute the eigenvectors Q and eignevalues E for Z
+               SmartPtr<DenseGenMatrix> Q = L_->MakeNewDenseGenMatrix();
+               SmartPtr<DenseVector> E = D_->MakeNewDenseVector();
+               bool retval = Q->ComputeEigenVectors(*Z, *E);
+               ASSERT_EXCEPTION(retval, INTERNAL_ABORT, "Eigenvalue decomposition failed for limited-memory SR1 update.")
+               ;
+               DBG_PRINT_VECTOR(2, "E", *E);
+               DBG_PRINT_MATRIX(3, "Q", *Q);
+               // Split the eigenvectors and scale them
+               skipping = SplitEigenvalues(*Q, *E, Qminus, Qplus);
+               if( skipping )
+               {
+                  RestoreInternalDataBackup();
+                  break;
+               }
             }
 
             // Compute Vtilde = Y - B_0*S
@@ -693,7 +728,7 @@ void LimMemQuasiNewtonUpdater::UpdateHessian()
       lm_skipped_iter_++;
    }
    Jnlst().Printf(J_DETAILED, J_HESSIAN_APPROXIMATION,
-                  "Number of successive iterations with skipping: %d\n", lm_skipped_iter_);
+                  "Number of successive iterations with skipping: %" IPOPT_INDEX_FORMAT "\n", lm_skipped_iter_);
 
    // Keep stuff around in case we want to skip SR1 retroactively
    // because of negative curvature!
@@ -710,6 +745,51 @@ void LimMemQuasiNewtonUpdater::UpdateHessian()
       last_eta_ = curr_eta_;
       curr_DR_x_ = NULL;
    }
+
+   AccountMemory();
+}
+
+/** Number of bytes of the values of a dense matrix or multi vector matrix */
+static std::size_t MatrixBytes(
+   const Matrix* M
+)
+{
+   return M == NULL ? 0 : (std::size_t) M->NRows() * M->NCols() * sizeof(Number);
+}
+
+/** Number of bytes of the values of a matrix and its backup, if it differs */
+static std::size_t MatrixBytes(
+   const Matrix* M,
+   const Matrix* M_old
+)
+{
+   return MatrixBytes(M) + (M_old != M ? MatrixBytes(M_old) : 0);
+}
+
+void LimMemQuasiNewtonUpdater::AccountMemory()
+{
+   std::size_t memory = 0;
+   memory += MatrixBytes(GetRawPtr(S_), GetRawPtr(S_old_));
+   memory += MatrixBytes(GetRawPtr(Y_), GetRawPtr(Y_old_));
+   memory += MatrixBytes(GetRawPtr(Ypart_), GetRawPtr(Ypart_old_));
+   memory += MatrixBytes(GetRawPtr(L_), GetRawPtr(L_old_));
+   memory += MatrixBytes(GetRawPtr(V_), GetRawPtr(V_old_));
+   memory += MatrixBytes(GetRawPtr(U_), GetRawPtr(U_old_));
+   memory += MatrixBytes(GetRawPtr(SdotS_), GetRawPtr(SdotS_old_));
+   memory += MatrixBytes(GetRawPtr(DRS_), GetRawPtr(DRS_old_));
+   memory += MatrixBytes(GetRawPtr(STDRS_), GetRawPtr(STDRS_old_));
+   if( IsValid(D_) )
+   {
+      memory += D_->Dim() * sizeof(Number);
+   }
+   if( IsValid(D_old_) && D_old_ != D_ )
+   {
+      memory += D_old_->Dim() * sizeof(Number);
+   }
+
+   memory_account_.Free(accounted_memory_);
+   accounted_memory_ = memory;
+   memory_account_.Allocate(accounted_memory_);
 }
 
 void LimMemQuasiNewtonUpdater::StoreInternalDataBackup()
@@ -921,9 +1001,8 @@ bool LimMemQuasiNewtonUpdater::SplitEigenvalues(
    Jnlst().Printf(J_DETAILED, J_HESSIAN_APPROXIMATION,
                   "Eigenvalues in SR1 update: emin=%e emax=%e ratio=%e\n", emin, emax, ratio);
    DBG_ASSERT(ratio >= 0.);
-   // ToDo make the following an option?
-   const Number tol = 1e-12;
-   if( ratio < tol )
+   // ToDo make the tolerance an option?
+   if( ratio < sr1_eigenvalue_ratio_tol )
    {
       return true;
    }
@@ -983,6 +1062,79 @@ bool LimMemQuasiNewtonUpdater::SplitEigenvalues(
    return false;
 }
 
+bool LimMemQuasiNewtonUpdater::SplitByCholesky(
+   const DenseSymMatrix&     Z,
+   SmartPtr<DenseGenMatrix>& Qminus,
+   SmartPtr<DenseGenMatrix>& Qplus
+)
+{
+   DBG_START_METH("LimMemQuasiNewtonUpdater::SplitByCholesky",
+                  dbg_verbosity);
+
+   const Index dim = Z.Dim();
+   const Number* Zvals = Z.Values();
+
+   // Z can only be positive (negative) definite if its diagonal is
+   // positive (negative).  We also get the Frobenius norm of Z, which
+   // is an upper bound on the largest eigenvalue (in absolute value).
+   bool pos_diag = true;
+   bool neg_diag = true;
+   Number Znrm2 = 0.;
+   for( Index j = 0; j < dim; j++ )
+   {
+      Number Zjj = Zvals[j + j * dim];
+      pos_diag = pos_diag && Zjj > 0.;
+      neg_diag = neg_diag && Zjj < 0.;
+      Znrm2 += Zjj * Zjj;
+      for( Index i = j + 1; i < dim; i++ )
+      {
+         Znrm2 += 2. * Zvals[i + j * dim] * Zvals[i + j * dim];
+      }
+   }
+   if( !pos_diag && !neg_diag )
+   {
+      return false;
+   }
+   Number sign = pos_diag ? 1. : -1.;
+
+   // Compute the Cholesky factor J with sign*Z = J J^T
+   SmartPtr<DenseSymMatrix> M = Z.MakeNewDenseSymMatrix();
+   M->AddMatrix(sign, Z, 0.);
+   SmartPtr<DenseGenMatrix> J = L_->MakeNewDenseGenMatrix();
+   if( !J->ComputeCholeskyFactor(*M) )
+   {
+      return false;
+   }
+
+   // Compute Jinvt = J^{-T}, so that Z^{-1} = sign*Jinvt*Jinvt^T
+   SmartPtr<DenseGenMatrix> Jinvt = L_->MakeNewDenseGenMatrix();
+   Jinvt->FillIdentity();
+   J->CholeskyBackSolveMatrix(true, 1., *Jinvt);
+
+   // The squared Frobenius norm of Jinvt is an upper bound on the
+   // inverse of the smallest eigenvalue (in absolute value) of Z
+   Number Jinvt_nrm = IpBlasDnrm2(dim * dim, Jinvt->Values(), 1);
+   Number ratio_bound = 1. / (Jinvt_nrm * Jinvt_nrm * sqrt(Znrm2));
+   Jnlst().Printf(J_DETAILED, J_HESSIAN_APPROXIMATION,
+                  "Cholesky factorization in SR1 update: sign=%e lower bound on eigenvalue ratio=%e\n", sign, ratio_bound);
+   if( !(ratio_bound >= sr1_eigenvalue_ratio_tol) )
+   {
+      return false;
+   }
+
+   if( sign > 0. )
+   {
+      Qplus = Jinvt;
+      Qminus = NULL;
+   }
+   else
+   {
+      Qminus = Jinvt;
+      Qplus = NULL;
+   }
+   return true;
+}
+
 bool LimMemQuasiNewtonUpdater::CheckSkippingBFGS(
    Vector& s_new,
    Vector& y_new
@@ -1213,6 +1365,8 @@ void LimMemQuasiNewtonUpdater::ShiftMultiVector(
 
    SmartPtr<MultiVectorMatrix> new_V = V->MakeNewMultiVectorMatrix();
 
+   // Only the references to the columns are moved; the vectors are
+   // shared with V, which may still be kept by StoreInternalDataBackup
    for( Index i = 0; i < ncols - 1; i++ )
    {
       new_V->SetVector(i, *V->GetVector(i + 1));
@@ -1231,8 +1385,10 @@ void LimMemQuasiNewtonUpdater::ShiftDenseVector(
 
    SmartPtr<DenseVector> new_V = V->MakeNewDenseVector();
 
+   // V is only read, so that its tag does not change if it is kept by
+   // StoreInternalDataBackup
    DBG_ASSERT(!V->IsHomogeneous());
-   Number* Vvalues = V->Values();
+   const Number* Vvalues = ConstPtr(V)->Values();
    Number* new_Vvalues = new_V->Values();
    for( Index i = 0; i < ndim - 1; i++ )
    {
@@ -1256,7 +1412,7 @@ void LimMemQuasiNewtonUpdater::ShiftLMatrix(
 
    SmartPtr<DenseGenMatrix> new_V = V->MakeNewDenseGenMatrix();
 
-   Number* Vvalues = V->Values();
+   const Number* Vvalues = ConstPtr(V)->Values();
    Number* new_Vvalues = new_V->Values();
    for( Index j = 0; j < ndim - 1; j++ )
    {
@@ -1289,7 +1445,7 @@ void LimMemQuasiNewtonUpdater::ShiftSdotSMatrix(
 
    SmartPtr<DenseSymMatrix> new_V = V->MakeNewDenseSymMatrix();
 
-   Number* Vvalues = V->Values();
+   const Number* Vvalues = ConstPtr(V)->Values();
    Number* new_Vvalues = new_V->Values();
    for( Index j = 0; j < ndim - 1; j++ )
    {
@@ -1318,7 +1474,7 @@ void LimMemQuasiNewtonUpdater::ShiftSTDRSMatrix(
 
    SmartPtr<DenseSymMatrix> new_V = V->MakeNewDenseSymMatrix();
 
-   Number* Vvalues = V->Values();
+   const Number* Vvalues = ConstPtr(V)->Values();
    Number* new_Vvalues = new_V->Values();
    for( Index j = 0; j < ndim - 1; j++ )
    {
@@ -1366,6 +1522,10 @@ void LimMemQuasiNewtonUpdater::SetW()
    {
       W->SetU(*U_);
    }
+   if( IsValid(h_space_->ExactSpace()) )
+   {
+      W->SetExact(*IpCq().curr_exact_hessian());
+   }
    if( update_for_resto_ )
    {
       SmartPtr<const SymMatrixSpace> sp = IpNLP().HessianMatrixSpace();
@@ -1456,4 +1616,226 @@ void LimMemQuasiNewtonUpdater::RecalcL(
    }
 }
 
+/** Write a multi vector matrix, which might be NULL */
+static void WriteMultiVectorMatrix(
+   Checkpoint&              checkpoint,
+   const MultiVectorMatrix* M
+)
+{
+   checkpoint.WriteBool(M != NULL);
+   if( M == NULL )
+   {
+      return;
+   }
+   checkpoint.WriteIndex(M->NCols());
+   for( Index i = 0; i < M->NCols(); i++ )
+   {
+      checkpoint.WriteVector(*M->GetVector(i));
+   }
+}
+
+/** Read a multi vector matrix with columns in vec_space */
+static SmartPtr<MultiVectorMatrix> ReadMultiVectorMatrix(
+   Checkpoint&        checkpoint,
+   const VectorSpace& vec_space
+)
+{
+   if( !checkpoint.ReadBool() )
+   {
+      return NULL;
+   }
+   Index ncols = checkpoint.ReadIndex();
+   SmartPtr<MultiVectorMatrixSpace> M_space = new MultiVectorMatrixSpace(ncols, vec_space);
+   SmartPtr<MultiVectorMatrix> M = M_space->MakeNewMultiVectorMatrix();
+   for( Index i = 0; i < ncols; i++ )
+   {
+      SmartPtr<Vector> v = vec_space.MakeNew();
+      checkpoint.ReadVector(*v);
+      M->SetVector(i, *v);
+   }
+   return M;
+}
+
+/** Write the dimensions and elements of a dense matrix, which might be NULL */
+static void WriteDenseValues(
+   Checkpoint&   checkpoint,
+   const Matrix* M,
+   const Number* values
+)
+{
+   checkpoint.WriteBool(M != NULL);
+   if( M == NULL )
+   {
+      return;
+   }
+   checkpoint.WriteIndex(M->NRows());
+   checkpoint.WriteIndex(M->NCols());
+   checkpoint.WriteNumbers(M->NRows() * M->NCols(), values);
+}
+
+static void WriteDenseVector(
+   Checkpoint&        checkpoint,
+   const DenseVector* V
+)
+{
+   checkpoint.WriteBool(V != NULL);
+   if( V != NULL )
+   {
+      checkpoint.WriteIndex(V->Dim());
+      checkpoint.WriteVector(*V);
+   }
+}
+
+static SmartPtr<DenseVector> ReadDenseVector(
+   Checkpoint& checkpoint
+)
+{
+   if( !checkpoint.ReadBool() )
+   {
+      return NULL;
+   }
+   SmartPtr<DenseVectorSpace> V_space = new DenseVectorSpace(checkpoint.ReadIndex());
+   SmartPtr<DenseVector> V = V_space->MakeNewDenseVector();
+   checkpoint.ReadVector(*V);
+   return V;
+}
+
+static SmartPtr<DenseGenMatrix> ReadDenseGenMatrix(
+   Checkpoint& checkpoint
+)
+{
+   if( !checkpoint.ReadBool() )
+   {
+      return NULL;
+   }
+   Index nrows = checkpoint.ReadIndex();
+   Index ncols = checkpoint.ReadIndex();
+   SmartPtr<DenseGenMatrixSpace> M_space = new DenseGenMatrixSpace(nrows, ncols);
+   SmartPtr<DenseGenMatrix> M = M_space->MakeNewDenseGenMatrix();
+   checkpoint.ReadNumbers(nrows * ncols, M->Values());
+   return M;
+}
+
+static SmartPtr<DenseSymMatrix> ReadDenseSymMatrix(
+   Checkpoint& checkpoint
+)
+{
+   if( !checkpoint.ReadBool() )
+   {
+      return NULL;
+   }
+   Index dim = checkpoint.ReadIndex();
+   if( checkpoint.ReadIndex() != dim )
+   {
+      THROW_EXCEPTION(INVALID_WARMSTART, "Checkpoint file " + checkpoint.FileName() + " contains an invalid limited-memory update.");
+   }
+   SmartPtr<DenseSymMatrixSpace> M_space = new DenseSymMatrixSpace(dim);
+   SmartPtr<DenseSymMatrix> M = M_space->MakeNewDenseSymMatrix();
+   checkpoint.ReadNumbers(dim * dim, M->Values());
+   return M;
+}
+
+void LimMemQuasiNewtonUpdater::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   // checkpoints are not written in the restoration phase, so the data
+   // for the structured update of the restoration phase is not needed
+   DBG_ASSERT(!update_for_resto_);
+   checkpoint.WriteSection("LimMemQuasiNewtonUpdater");
+   checkpoint.WriteBool(IsValid(last_x_));
+   if( IsNull(last_x_) )
+   {
+      return;
+   }
+   checkpoint.WriteVector(*last_x_);
+   checkpoint.WriteVector(*last_grad_f_);
+   checkpoint.WriteIndex(lm_skipped_iter_);
+
+   checkpoint.WriteIndex(curr_lm_memory_);
+   WriteMultiVectorMatrix(checkpoint, GetRawPtr(S_));
+   WriteMultiVectorMatrix(checkpoint, GetRawPtr(Y_));
+   WriteDenseVector(checkpoint, GetRawPtr(D_));
+   WriteDenseValues(checkpoint, GetRawPtr(L_), IsValid(L_) ? L_->Values() : NULL);
+   WriteDenseValues(checkpoint, GetRawPtr(SdotS_), IsValid(SdotS_) ? SdotS_->Values() : NULL);
+   checkpoint.WriteBool(SdotS_uptodate_);
+   checkpoint.WriteNumber(sigma_);
+   WriteMultiVectorMatrix(checkpoint, GetRawPtr(V_));
+   WriteMultiVectorMatrix(checkpoint, GetRawPtr(U_));
+
+   // the backup is needed to undo the most recent SR1 update
+   checkpoint.WriteBool(limited_memory_update_type_ == SR1);
+   if( limited_memory_update_type_ == SR1 )
+   {
+      checkpoint.WriteIndex(curr_lm_memory_old_);
+      WriteMultiVectorMatrix(checkpoint, GetRawPtr(S_old_));
+      WriteMultiVectorMatrix(checkpoint, GetRawPtr(Y_old_));
+      WriteDenseVector(checkpoint, GetRawPtr(D_old_));
+      WriteDenseValues(checkpoint, GetRawPtr(L_old_), IsValid(L_old_) ? L_old_->Values() : NULL);
+      WriteDenseValues(checkpoint, GetRawPtr(SdotS_old_), IsValid(SdotS_old_) ? SdotS_old_->Values() : NULL);
+      checkpoint.WriteBool(SdotS_uptodate_old_);
+      checkpoint.WriteNumber(sigma_old_);
+      WriteMultiVectorMatrix(checkpoint, GetRawPtr(V_old_));
+      WriteMultiVectorMatrix(checkpoint, GetRawPtr(U_old_));
+   }
+}
+
+void LimMemQuasiNewtonUpdater::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   DBG_ASSERT(!update_for_resto_);
+   checkpoint.ReadSection("LimMemQuasiNewtonUpdater");
+   if( !checkpoint.ReadBool() )
+   {
+      return;
+   }
+
+   SmartPtr<const SymMatrixSpace> sp = IpNLP().HessianMatrixSpace();
+   h_space_ = static_cast<const LowRankUpdateSymMatrixSpace*>(GetRawPtr(sp));
+   ASSERT_EXCEPTION(IsValid(h_space_), OPTION_INVALID,
+                    "Limited-memory quasi-Newton option chosen, but NLP doesn't provide LowRankUpdateSymMatrixSpace.");
+   SmartPtr<const VectorSpace> LM_vecspace = h_space_->LowRankVectorSpace();
+
+   SmartPtr<Vector> x = IpData().curr()->x()->MakeNew();
+   checkpoint.ReadVector(*x);
+   SmartPtr<Vector> grad_f = x->MakeNew();
+   checkpoint.ReadVector(*grad_f);
+   last_x_ = ConstPtr(x);
+   last_grad_f_ = ConstPtr(grad_f);
+   // the Jacobians at the previous iterate are evaluated again
+   last_jac_c_ = IpNLP().jac_c(*last_x_);
+   last_jac_d_ = IpNLP().jac_d(*last_x_);
+   lm_skipped_iter_ = checkpoint.ReadIndex();
+
+   curr_lm_memory_ = checkpoint.ReadIndex();
+   S_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+   Y_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+   D_ = ReadDenseVector(checkpoint);
+   L_ = ReadDenseGenMatrix(checkpoint);
+   SdotS_ = ReadDenseSymMatrix(checkpoint);
+   SdotS_uptodate_ = checkpoint.ReadBool();
+   sigma_ = checkpoint.ReadNumber();
+   V_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+   U_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+
+   if( checkpoint.ReadBool() )
+   {
+      curr_lm_memory_old_ = checkpoint.ReadIndex();
+      S_old_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+      Y_old_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+      D_old_ = ReadDenseVector(checkpoint);
+      L_old_ = ReadDenseGenMatrix(checkpoint);
+      SdotS_old_ = ReadDenseSymMatrix(checkpoint);
+      SdotS_uptodate_old_ = checkpoint.ReadBool();
+      sigma_old_ = checkpoint.ReadNumber();
+      V_old_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+      U_old_ = ReadMultiVectorMatrix(checkpoint, *LM_vecspace);
+   }
+
+   // W is kept if the next update is skipped
+   SetW();
+   AccountMemory();
+}
+
 } // namespace Ipopt
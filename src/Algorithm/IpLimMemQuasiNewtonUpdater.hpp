@@ -13,12 +13,18 @@
 #include "IpDenseVector.hpp"
 #include "IpDenseGenMatrix.hpp"
 #include "IpDenseSymMatrix.hpp"
+#include "IpMemoryStatistics.hpp"
 
 namespace Ipopt
 {
 
 /** Implementation of the HessianUpdater for limit-memory
  *  quasi-Newton approximation of the Lagrangian Hessian.
+ *
+ *  If the Hessian matrix space has an exact part, the Hessian
+ *  provided by the NLP is evaluated at every iterate and only the
+ *  difference to it is approximated, that is, the Hessian term times
+ *  s is subtracted from y.
  */
 class LimMemQuasiNewtonUpdater: public HessianUpdater
 {
@@ -31,8 +37,7 @@ public:
    );
 
    /** Destructor */
-   virtual ~LimMemQuasiNewtonUpdater()
-   { }
+   virtual ~LimMemQuasiNewtonUpdater();
    ///@}
 
    virtual bool InitializeImpl(
@@ -43,6 +48,16 @@ public:
    /** Update the Hessian based on the current information in IpData. */
    virtual void UpdateHessian();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    /** Methods for OptionsList */
    ///@{
    static void RegisterOptions(
@@ -163,6 +178,13 @@ private:
    /** Counter for successive iterations in which the update was skipped */
    Index lm_skipped_iter_;
 
+   /** Memory of the stored vectors and matrices that is accounted
+    *  for in MemoryStatistics */
+   std::size_t accounted_memory_;
+
+   /** Account in which accounted_memory_ is allocated */
+   MemoryAccount memory_account_;
+
    /** @name Information for the limited memory update */
    ///@{
    /** current size of limited memory */
@@ -300,6 +322,9 @@ private:
 
    /** @name Auxiliary function */
    ///@{
+   /** Update the memory of the stored vectors and matrices in MemoryStatistics */
+   void AccountMemory();
+
    /** Method deciding whether the BFGS update should be skipped.
     *
     *  If Powell-damping is performed, the Vectors s_new and y_new
@@ -396,7 +421,9 @@ private:
     *  other columns to the left, and make v_new the last column.
     *
     *  The entity that V points to at the call, is not changed - a
-    *  new entity is created in the method and returned as V.
+    *  new entity is created in the method and returned as V.  The
+    *  column vectors are not copied; the new entity refers to the
+    *  same vectors.
     */
    void ShiftMultiVector(
       SmartPtr<MultiVectorMatrix>& V,
@@ -499,6 +526,25 @@ private:
       SmartPtr<DenseGenMatrix>& Qplus
    );
 
+   /** Split the inverse of the middle matrix Z of the SR1 update by a
+    *  Cholesky factorization, if Z is positive or negative definite.
+    *
+    *  If Z = sign*J*J^T, this returns J^{-T} as Qplus (sign = 1) or as
+    *  Qminus (sign = -1) and NULL as the other one, so that Qminus and
+    *  Qplus have the same meaning as for SplitEigenvalues.  This is
+    *  only done if a lower bound on the ratio of the smallest over the
+    *  largest eigenvalue (in absolute values) shows that the update
+    *  will not be skipped by SplitEigenvalues.
+    *
+    *  @return false, if Z is indefinite or the bound is too small; in
+    *  that case, the eigenvalue decomposition has to be computed.
+    */
+   bool SplitByCholesky(
+      const DenseSymMatrix&     Z,
+      SmartPtr<DenseGenMatrix>& Qminus,
+      SmartPtr<DenseGenMatrix>& Qplus
+   );
+
    /** Store a copy of the pointers to the internal data (S, Y, D, L,
     *  SdotS, curr_lm_memory).
     *
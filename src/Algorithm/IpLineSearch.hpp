@@ -43,6 +43,17 @@ public:
     */
    virtual void Reset() = 0;
 
+   /** Reset the line search after the NLP has been rescaled.
+    *
+    *  Any iterates and reference values stored by the line search
+    *  refer to the previous scaling and must be discarded.  The
+    *  default implementation calls Reset().
+    */
+   virtual void ResetAfterScalingUpdate()
+   {
+      Reset();
+   }
+
    /** Set flag indicating whether a very rigorous line search should
     *  be performed.
     *
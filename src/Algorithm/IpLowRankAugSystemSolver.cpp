@@ -51,6 +51,9 @@ bool LowRankAugSystemSolver::InitializeImpl(
    Vtilde1_ = NULL;
    Utilde2_ = NULL;
    Wdiag_ = NULL;
+   Wsum_space_ = NULL;
+   Wsum_ = NULL;
+   Wexact_zero_ = NULL;
    compound_sol_vecspace_ = NULL;
 
    return aug_system_solver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
@@ -92,6 +95,19 @@ ESymSolverStatus LowRankAugSystemSolver::Solve(
       Index dimx = rhs_x.Dim();
       SmartPtr<DiagMatrixSpace> Wdiag_space = new DiagMatrixSpace(dimx);
       Wdiag_ = Wdiag_space->MakeNewDiagMatrix();
+
+      // If the Hessian has an exact part, the underlying augmented
+      // system solver gets the sum of the exact part and Wdiag_
+      const LowRankUpdateSymMatrix* LR_W = static_cast<const LowRankUpdateSymMatrix*>(W);
+      DBG_ASSERT(dynamic_cast<const LowRankUpdateSymMatrix*>(W));
+      SmartPtr<const SymMatrixSpace> exact_space = LR_W->ExactSpace();
+      if( IsValid(exact_space) )
+      {
+         Wsum_space_ = new SumSymMatrixSpace(dimx, 2);
+         Wsum_space_->SetTermSpace(0, *exact_space);
+         Wsum_space_->SetTermSpace(1, *Wdiag_space);
+         Wexact_zero_ = exact_space->MakeNewSymMatrix();
+      }
    }
 
    // This might be used with a linear solver that cannot detect the
@@ -175,7 +191,8 @@ ESymSolverStatus LowRankAugSystemSolver::Solve(
    // Now solve the system for the given right hand side, using the
    // Sherman-Morrison formula with factorization information already
    // computed.
-   retval = aug_system_solver_->Solve(GetRawPtr(Wdiag_), W_factor, D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d,
+   const SymMatrix* Wbase = IsValid(Wsum_) ? static_cast<const SymMatrix*>(GetRawPtr(Wsum_)) : GetRawPtr(Wdiag_);
+   retval = aug_system_solver_->Solve(Wbase, W_factor, D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d,
                                       D_d, delta_d, rhs_x, rhs_s, rhs_c, rhs_d, sol_x, sol_s, sol_c, sol_d, check_NegEVals, numberOfNegEVals);
    if( aug_system_solver_->ProvidesInertia() )
    {
@@ -292,21 +309,84 @@ ESymSolverStatus LowRankAugSystemSolver::UpdateFactorization(
       DBG_PRINT_VECTOR(2, "B0", *B0);
    }
 
+   if( IsValid(Wsum_space_) )
+   {
+      // add the exact part of the Hessian; the values of Wexact_zero_
+      // are not used since its factor is zero
+      SmartPtr<const SymMatrix> E;
+      if( W_factor == 1.0 )
+      {
+         E = LR_W->GetExact();
+      }
+      Wsum_ = Wsum_space_->MakeNewSumSymMatrix();
+      if( IsValid(E) )
+      {
+         Wsum_->SetTerm(0, 1., *E);
+      }
+      else
+      {
+         Wsum_->SetTerm(0, 0., *Wexact_zero_);
+      }
+      Wsum_->SetTerm(1, 1., *Wdiag_);
+   }
+
+   SmartPtr<MultiVectorMatrix> V_x;
    SmartPtr<MultiVectorMatrix> Vtilde1_x;
-   if( IsValid(V) )
+   SmartPtr<MultiVectorMatrix> U_x;
+   SmartPtr<MultiVectorMatrix> Utilde1;
+   SmartPtr<MultiVectorMatrix> Utilde1_x;
+   if( IsValid(V) && IsValid(U) )
    {
-      SmartPtr<MultiVectorMatrix> V_x;
+      // The solves for U do not depend on those for V, so we do all
+      // backsolves with a single call of the augmented system solver
       Index nV = V->NCols();
-      //DBG_PRINT((1, "delta_x  = %e\n", delta_x));
-      //DBG_PRINT_MATRIX(2, "V", *V);
+      Index nU = U->NCols();
+      DBG_ASSERT(V->ColVectorSpace() == U->ColVectorSpace());
+      SmartPtr<MultiVectorMatrixSpace> VUspace = new MultiVectorMatrixSpace(nV + nU, *V->ColVectorSpace());
+      SmartPtr<MultiVectorMatrix> VU = VUspace->MakeNewMultiVectorMatrix();
+      for( Index i = 0; i < nV; i++ )
+      {
+         VU->SetVector(i, *V->GetVector(i));
+      }
+      for( Index i = 0; i < nU; i++ )
+      {
+         VU->SetVector(nV + i, *U->GetVector(i));
+      }
+      SmartPtr<MultiVectorMatrix> VU_x;
+      SmartPtr<MultiVectorMatrix> VUtilde1;
+      SmartPtr<MultiVectorMatrix> VUtilde1_x;
       retval = SolveMultiVector(D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d, proto_rhs_x,
-                                proto_rhs_s, proto_rhs_c, proto_rhs_d, *V, P_LM, V_x, Vtilde1_, Vtilde1_x, check_NegEVals, numberOfNegEVals);
+                                proto_rhs_s, proto_rhs_c, proto_rhs_d, *VU, P_LM, VU_x, VUtilde1, VUtilde1_x, check_NegEVals, numberOfNegEVals);
       if( retval != SYMSOLVER_SUCCESS )
       {
          Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
-                        "LowRankAugSystemSolver: SolveMultiVector returned retval = %d for V.\n", retval);
+                        "LowRankAugSystemSolver: SolveMultiVector returned retval = %d for V and U.\n", retval);
          return retval;
       }
+      V_x = ExtractColumns(*VU_x, 0, nV, false);
+      Vtilde1_ = ExtractColumns(*VUtilde1, 0, nV, true);
+      Vtilde1_x = ExtractColumns(*VUtilde1_x, 0, nV, false);
+      U_x = ExtractColumns(*VU_x, nV, nU, false);
+      Utilde1 = ExtractColumns(*VUtilde1, nV, nU, true);
+      Utilde1_x = ExtractColumns(*VUtilde1_x, nV, nU, false);
+   }
+
+   if( IsValid(V) )
+   {
+      Index nV = V->NCols();
+      //DBG_PRINT((1, "delta_x  = %e\n", delta_x));
+      //DBG_PRINT_MATRIX(2, "V", *V);
+      if( IsNull(V_x) )
+      {
+         retval = SolveMultiVector(D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d, proto_rhs_x,
+                                   proto_rhs_s, proto_rhs_c, proto_rhs_d, *V, P_LM, V_x, Vtilde1_, Vtilde1_x, check_NegEVals, numberOfNegEVals);
+         if( retval != SYMSOLVER_SUCCESS )
+         {
+            Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
+                           "LowRankAugSystemSolver: SolveMultiVector returned retval = %d for V.\n", retval);
+            return retval;
+         }
+      }
       //DBG_PRINT_MATRIX(2, "Vtilde1_x", *Vtilde1_x);
 
       SmartPtr<DenseSymMatrixSpace> M1space = new DenseSymMatrixSpace(nV);
@@ -337,17 +417,17 @@ ESymSolverStatus LowRankAugSystemSolver::UpdateFactorization(
    if( IsValid(U) )
    {
       Index nU = U->NCols();
-      SmartPtr<MultiVectorMatrix> U_x;
-      SmartPtr<MultiVectorMatrix> Utilde1;
-      SmartPtr<MultiVectorMatrix> Utilde1_x;
       SmartPtr<MultiVectorMatrix> Utilde2_x;
-      retval = SolveMultiVector(D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d, proto_rhs_x,
-                                proto_rhs_s, proto_rhs_c, proto_rhs_d, *U, P_LM, U_x, Utilde1, Utilde1_x, check_NegEVals, numberOfNegEVals);
-      if( retval != SYMSOLVER_SUCCESS )
+      if( IsNull(U_x) )
       {
-         Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
-                        "LowRankAugSystemSolver: SolveMultiVector returned retval = %d for U.\n", retval);
-         return retval;
+         retval = SolveMultiVector(D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d, proto_rhs_x,
+                                   proto_rhs_s, proto_rhs_c, proto_rhs_d, *U, P_LM, U_x, Utilde1, Utilde1_x, check_NegEVals, numberOfNegEVals);
+         if( retval != SYMSOLVER_SUCCESS )
+         {
+            Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
+                           "LowRankAugSystemSolver: SolveMultiVector returned retval = %d for U.\n", retval);
+            return retval;
+         }
       }
 
       if( IsNull(Vtilde1_) )
@@ -399,6 +479,29 @@ ESymSolverStatus LowRankAugSystemSolver::UpdateFactorization(
    return retval;
 }
 
+SmartPtr<MultiVectorMatrix> LowRankAugSystemSolver::ExtractColumns(
+   MultiVectorMatrix& V,
+   Index              first,
+   Index              ncols,
+   bool               non_const
+)
+{
+   SmartPtr<MultiVectorMatrixSpace> space = new MultiVectorMatrixSpace(ncols, *V.ColVectorSpace());
+   SmartPtr<MultiVectorMatrix> part = space->MakeNewMultiVectorMatrix();
+   for( Index i = 0; i < ncols; i++ )
+   {
+      if( non_const )
+      {
+         part->SetVectorNonConst(i, *V.GetVectorNonConst(first + i));
+      }
+      else
+      {
+         part->SetVector(i, *V.GetVector(first + i));
+      }
+   }
+   return part;
+}
+
 ESymSolverStatus LowRankAugSystemSolver::SolveMultiVector(
    const Vector*                 D_x,
    double                        delta_x,
@@ -480,7 +583,8 @@ ESymSolverStatus LowRankAugSystemSolver::SolveMultiVector(
    }
 
    // Call the actual augmented system solver to obtain Vtilde
-   retval = aug_system_solver_->MultiSolve(GetRawPtr(Wdiag_), 1.0, D_x, delta_x, D_s, delta_s, &J_c, D_c, delta_c, &J_d,
+   const SymMatrix* Wbase = IsValid(Wsum_) ? static_cast<const SymMatrix*>(GetRawPtr(Wsum_)) : GetRawPtr(Wdiag_);
+   retval = aug_system_solver_->MultiSolve(Wbase, 1.0, D_x, delta_x, D_s, delta_s, &J_c, D_c, delta_c, &J_d,
                                            D_d, delta_d, rhs_xV, rhs_sV, rhs_cV, rhs_dV, sol_xV, sol_sV, sol_cV, sol_dV, check_NegEVals, numberOfNegEVals);
 
    if( aug_system_solver_->ProvidesInertia() )
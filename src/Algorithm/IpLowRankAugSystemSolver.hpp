@@ -11,6 +11,7 @@
 #include "IpDenseGenMatrix.hpp"
 #include "IpMultiVectorMatrix.hpp"
 #include "IpDiagMatrix.hpp"
+#include "IpSumSymMatrix.hpp"
 
 namespace Ipopt
 {
@@ -18,6 +19,9 @@ namespace Ipopt
 /** Solver for the augmented system with LowRankUpdateSymMatrix
  *  Hessian matrices.  This version works with the Sherman-Morrison
  *  formula and multiple backsolves.
+ *
+ *  If the Hessian matrix has an exact part, it is passed together
+ *  with the diagonal to the underlying augmented system solver.
  */
 class LowRankAugSystemSolver: public AugSystemSolver
 {
@@ -194,6 +198,20 @@ private:
     *  the matrix without the low-rank update. */
    SmartPtr<DiagMatrix> Wdiag_;
 
+   /** Space for the sum of the exact part of the Hessian and Wdiag_.
+    *
+    *  This is NULL if the Hessian matrix has no exact part.
+    */
+   SmartPtr<SumSymMatrixSpace> Wsum_space_;
+
+   /** Hessian Matrix passed to the augmented system solver if the
+    *  Hessian matrix has an exact part. */
+   SmartPtr<SumSymMatrix> Wsum_;
+
+   /** Matrix from the space of the exact part that is used with
+    *  factor zero if no exact part is given. */
+   SmartPtr<const SymMatrix> Wexact_zero_;
+
    /** Vector space for Compound vectors that capture the entire
     *  right hand side and solution vectors .*/
    SmartPtr<const CompoundVectorSpace> compound_sol_vecspace_;
@@ -213,7 +231,7 @@ private:
    /** @name Internal functions */
    ///@{
    /** Method for updating the factorization, including J1_, J2_,
-    *  Vtilde1_, Utilde2, Wdiag_, compound_sol_vecspace_
+    *  Vtilde1_, Utilde2, Wdiag_, Wsum_, compound_sol_vecspace_
     */
    ESymSolverStatus UpdateFactorization(
       const SymMatrix* W,
@@ -267,6 +285,19 @@ private:
       Index                         numberOfNegEVals
    );
 
+   /** Method for creating a MultiVectorMatrix that contains the
+    *  ncols columns of V starting at column first.
+    *
+    *  If non_const is true, the columns are taken as non-const
+    *  Vectors, so that changing the result also changes V.
+    */
+   SmartPtr<MultiVectorMatrix> ExtractColumns(
+      MultiVectorMatrix& V,
+      Index              first,
+      Index              ncols,
+      bool               non_const
+   );
+
    /** Method that compares the tags of the data for the matrix with
     *  those from the previous call.
     *
@@ -6,6 +6,7 @@
 
 #include "IpMonotoneMuUpdate.hpp"
 #include "IpJournalist.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 
@@ -107,8 +108,11 @@ bool MonotoneMuUpdate::InitializeImpl(
    options.GetNumericValue("compl_inf_tol", compl_inf_tol_, prefix);
    options.GetNumericValue("mu_target", mu_target_, prefix);
 
-   IpData().Set_mu(mu_init_);
-   Number tau = Max(tau_min_, 1.0 - mu_init_);
+   // IpoptData keeps the barrier parameter of the previous solve
+   // only if this is requested by warm_start_keep_state
+   Number mu = IpData().MuInitialized() ? IpData().curr_mu() : mu_init_;
+   IpData().Set_mu(mu);
+   Number tau = Max(tau_min_, 1.0 - mu);
    IpData().Set_tau(tau);
 
    initialized_ = false;
@@ -231,4 +235,23 @@ void MonotoneMuUpdate::CalcNewMuAndTau(
    new_tau = Max(tau_min_, 1. - new_mu);
 }
 
+void MonotoneMuUpdate::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   // the barrier parameter itself is part of IpoptData
+   checkpoint.WriteSection("MonotoneMuUpdate");
+   checkpoint.WriteBool(initialized_);
+   checkpoint.WriteBool(first_iter_resto_);
+}
+
+void MonotoneMuUpdate::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("MonotoneMuUpdate");
+   initialized_ = checkpoint.ReadBool();
+   first_iter_resto_ = checkpoint.ReadBool();
+}
+
 } // namespace Ipopt
@@ -47,6 +47,16 @@ public:
     */
    virtual bool UpdateBarrierParameter();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    static void RegisterOptions(
       const SmartPtr<RegisteredOptions>& roptions
    );
@@ -12,6 +12,7 @@
 #include "IpTransposeMatrix.hpp"
 #include "IpDenseVector.hpp"
 #include "IpZeroMatrix.hpp"
+#include "IpExpansionMatrix.hpp"
 
 namespace Ipopt
 {
@@ -128,11 +129,15 @@ bool NLPBoundsRemover::GetSpaces(
    Jac_d_space_new->SetBlockRows(1, x_l_space_orig->Dim());
    Jac_d_space_new->SetBlockRows(2, x_u_space_orig->Dim());
    Jac_d_space_new->SetBlockCols(0, x_space->Dim());
-   Jac_d_space_new->SetCompSpace(0, 0, *Jac_d_space_orig);
+   Jac_d_space_new->SetCompSpace(0, 0, *Jac_d_space_orig, true);
+   // The blocks for the bounds do not depend on x, so they are created
+   // only once here and set in each Jacobian by Eval_jac_d
    SmartPtr<MatrixSpace> trans_px_l_space_orig = new TransposeMatrixSpace(GetRawPtr(px_l_space_orig));
-   Jac_d_space_new->SetCompSpace(1, 0, *trans_px_l_space_orig, true);
+   Jac_d_space_new->SetCompSpace(1, 0, *trans_px_l_space_orig);
+   trans_Px_l_orig_ = trans_px_l_space_orig->MakeNew();
    SmartPtr<MatrixSpace> trans_px_u_space_orig = new TransposeMatrixSpace(GetRawPtr(px_u_space_orig));
-   Jac_d_space_new->SetCompSpace(2, 0, *trans_px_u_space_orig, true);
+   Jac_d_space_new->SetCompSpace(2, 0, *trans_px_u_space_orig);
+   trans_Px_u_orig_ = trans_px_u_space_orig->MakeNew();
    Jac_d_space = GetRawPtr(Jac_d_space_new);
 
    // We keep the original d_space around in order to be able to do
@@ -250,14 +255,13 @@ bool NLPBoundsRemover::Eval_jac_d(
 {
    CompoundMatrix* comp_jac_d = static_cast<CompoundMatrix*>(&jac_d);
    DBG_ASSERT(dynamic_cast<CompoundMatrix*>(&jac_d));
-   SmartPtr<const MatrixSpace> jac_d_space = comp_jac_d->OwnerSpace();
-   const CompoundMatrixSpace* comp_jac_d_space = static_cast<const CompoundMatrixSpace*>(GetRawPtr(jac_d_space));
-   DBG_ASSERT(dynamic_cast<const CompoundMatrixSpace*>(GetRawPtr(jac_d_space)));
-   SmartPtr<Matrix> jac_d_orig = comp_jac_d_space->GetCompSpace(0, 0)->MakeNew();
+   SmartPtr<Matrix> jac_d_orig = comp_jac_d->GetCompNonConst(0, 0);
+   DBG_ASSERT(IsValid(jac_d_orig));
    bool retval = nlp_->Eval_jac_d(x, *jac_d_orig);
    if( retval )
    {
-      comp_jac_d->SetComp(0, 0, *jac_d_orig);
+      comp_jac_d->SetComp(1, 0, *trans_Px_l_orig_);
+      comp_jac_d->SetComp(2, 0, *trans_Px_u_orig_);
    }
    return retval;
 }
@@ -278,6 +282,86 @@ bool NLPBoundsRemover::Eval_h(
    return retval;
 }
 
+bool NLPBoundsRemover::Eval_jac_and_h(
+   const Vector& x,
+   Matrix*       jac_c,
+   Matrix*       jac_d,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd,
+   SymMatrix&    h
+)
+{
+   const CompoundVector* comp_yd = static_cast<const CompoundVector*>(&yd);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&yd));
+   SmartPtr<const Vector> yd_orig = comp_yd->GetComp(0);
+
+   CompoundMatrix* comp_jac_d = NULL;
+   SmartPtr<Matrix> jac_d_orig;
+   if( jac_d != NULL )
+   {
+      comp_jac_d = static_cast<CompoundMatrix*>(jac_d);
+      DBG_ASSERT(dynamic_cast<CompoundMatrix*>(jac_d));
+      jac_d_orig = comp_jac_d->GetCompNonConst(0, 0);
+      DBG_ASSERT(IsValid(jac_d_orig));
+   }
+
+   bool retval = nlp_->Eval_jac_and_h(x, jac_c, GetRawPtr(jac_d_orig), obj_factor, yc, *yd_orig, h);
+   if( retval && comp_jac_d != NULL )
+   {
+      comp_jac_d->SetComp(1, 0, *trans_Px_l_orig_);
+      comp_jac_d->SetComp(2, 0, *trans_Px_u_orig_);
+   }
+   return retval;
+}
+
+bool NLPBoundsRemover::Eval_h_times_vec(
+   const Vector& x,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd,
+   const Vector& v,
+   Vector&       hv
+)
+{
+   const CompoundVector* comp_yd = static_cast<const CompoundVector*>(&yd);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&yd));
+   SmartPtr<const Vector> yd_orig = comp_yd->GetComp(0);
+
+   bool retval = nlp_->Eval_h_times_vec(x, obj_factor, yc, *yd_orig, v, hv);
+   return retval;
+}
+
+bool NLPBoundsRemover::GetDiagonalBlocks(
+   Index               num_blocks,
+   std::vector<Index>& x_block,
+   std::vector<Index>& c_block,
+   std::vector<Index>& d_block
+)
+{
+   if( !nlp_->GetDiagonalBlocks(num_blocks, x_block, c_block, d_block) )
+   {
+      return false;
+   }
+
+   // the new d consists of the original d and the lower and upper bounds of x
+   const ExpansionMatrix* Px_l = static_cast<const ExpansionMatrix*>(GetRawPtr(Px_l_orig_));
+   DBG_ASSERT(dynamic_cast<const ExpansionMatrix*>(GetRawPtr(Px_l_orig_)));
+   const ExpansionMatrix* Px_u = static_cast<const ExpansionMatrix*>(GetRawPtr(Px_u_orig_));
+   DBG_ASSERT(dynamic_cast<const ExpansionMatrix*>(GetRawPtr(Px_u_orig_)));
+   const Index* l_pos = Px_l->ExpandedPosIndices();
+   const Index* u_pos = Px_u->ExpandedPosIndices();
+   for( Index i = 0; i < Px_l->NCols(); i++ )
+   {
+      d_block.push_back(x_block[l_pos[i]]);
+   }
+   for( Index i = 0; i < Px_u->NCols(); i++ )
+   {
+      d_block.push_back(x_block[u_pos[i]]);
+   }
+   return true;
+}
+
 void NLPBoundsRemover::FinalizeSolution(
    SolverReturn               status,
    const Vector&              x,
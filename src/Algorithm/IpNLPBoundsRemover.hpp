@@ -153,6 +153,9 @@ public:
       Vector&       d
    );
 
+   /** The block of the original Jacobian is evaluated in place, the
+    *  blocks for the bounds are shared by all Jacobians.
+    */
    virtual bool Eval_jac_d(
       const Vector& x,
       Matrix&       jac_d
@@ -165,6 +168,28 @@ public:
       const Vector& yd,
       SymMatrix&    h
    );
+
+   /** Passed on to the original NLP, so that it can still evaluate
+    *  the Jacobians and the Hessian concurrently.
+    */
+   virtual bool Eval_jac_and_h(
+      const Vector& x,
+      Matrix*       jac_c,
+      Matrix*       jac_d,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      SymMatrix&    h
+   );
+
+   virtual bool Eval_h_times_vec(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      const Vector& v,
+      Vector&       hv
+   );
    ///@}
 
    /** @name NLP solution routines. */
@@ -225,6 +250,21 @@ public:
       nlp_->GetQuasiNewtonApproximationSpaces(approx_space, P_approx);
    }
 
+   virtual Index GetNumberOfDiagonalBlocks()
+   {
+      return nlp_->GetNumberOfDiagonalBlocks();
+   }
+
+   /** The bounds of a variable that are turned into inequality
+    *  constraints belong to the block of the variable.
+    */
+   virtual bool GetDiagonalBlocks(
+      Index               num_blocks,
+      std::vector<Index>& x_block,
+      std::vector<Index>& c_block,
+      std::vector<Index>& d_block
+   );
+
    /** Accessor method to the original NLP */
    SmartPtr<NLP> nlp()
    {
@@ -264,6 +304,14 @@ private:
    /** Pointer to the expansion matrix for the upper x bounds */
    SmartPtr<const Matrix> Px_u_orig_;
 
+   /** Transpose of the expansion matrix for the lower x bounds,
+    *  i.e., the Jacobian block of the lower bound constraints */
+   SmartPtr<const Matrix> trans_Px_l_orig_;
+
+   /** Transpose of the expansion matrix for the upper x bounds,
+    *  i.e., the Jacobian block of the upper bound constraints */
+   SmartPtr<const Matrix> trans_Px_u_orig_;
+
    /** Pointer to the original d space */
    SmartPtr<const VectorSpace> d_space_orig_;
 
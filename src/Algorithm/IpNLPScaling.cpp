@@ -225,6 +225,7 @@ SmartPtr<const Vector> NLPScalingObject::unapply_grad_obj_scaling(
 }
 
 StandardScalingBase::StandardScalingBase()
+   : store_scaled_matrices_(false)
 { }
 
 StandardScalingBase::~StandardScalingBase()
@@ -241,6 +242,18 @@ void StandardScalingBase::RegisterOptions(
       "The scaling is seen internally by Ipopt but the unscaled objective is reported in the console output. "
       "If additional scaling parameters are computed (e.g. user-scaling or gradient-based), both factors are multiplied. "
       "If this value is chosen to be negative, Ipopt will maximize the objective function instead of minimizing it.");
+   roptions->AddStringOption2(
+      "nlp_scaling_store_scaled_matrices",
+      "Whether to store the scaled values of the Jacobians and the Hessian",
+      "no",
+      "no", "apply the scaling vectors in each matrix-vector product",
+      "yes", "compute the scaled values once after each evaluation",
+      "If the NLP is scaled, products with the scaled Jacobians and Hessian otherwise apply the scaling vectors "
+      "to temporary copies of the vectors in each product. "
+      "With this option, the scaled values are computed and stored once after each evaluation, "
+      "and the products are computed with them directly. "
+      "This requires additional memory for a copy of the values of these matrices, "
+      "and the results can differ in the last digits.");
 }
 
 bool StandardScalingBase::InitializeImpl(
@@ -249,6 +262,7 @@ bool StandardScalingBase::InitializeImpl(
 )
 {
    options.GetNumericValue("obj_scaling_factor", obj_scaling_factor_, prefix);
+   options.GetBoolValue("nlp_scaling_store_scaled_matrices", store_scaled_matrices_, prefix);
    return true;
 }
 
@@ -330,7 +344,8 @@ void StandardScalingBase::DetermineScaling(
    // create the scaling matrix spaces
    if( IsValid(dx_) || IsValid(dc) )
    {
-      scaled_jac_c_space_ = new ScaledMatrixSpace(ConstPtr(dc), false, jac_c_space, ConstPtr(dx_), true);
+      scaled_jac_c_space_ = new ScaledMatrixSpace(ConstPtr(dc), false, jac_c_space, ConstPtr(dx_), true,
+                                                  store_scaled_matrices_);
       new_jac_c_space = GetRawPtr(scaled_jac_c_space_);
    }
    else
@@ -341,7 +356,8 @@ void StandardScalingBase::DetermineScaling(
 
    if( IsValid(dx_) || IsValid(dd) )
    {
-      scaled_jac_d_space_ = new ScaledMatrixSpace(ConstPtr(dd), false, jac_d_space, ConstPtr(dx_), true);
+      scaled_jac_d_space_ = new ScaledMatrixSpace(ConstPtr(dd), false, jac_d_space, ConstPtr(dx_), true,
+                                                  store_scaled_matrices_);
       new_jac_d_space = GetRawPtr(scaled_jac_d_space_);
    }
    else
@@ -354,7 +370,7 @@ void StandardScalingBase::DetermineScaling(
    {
       if( IsValid(dx_) )
       {
-         scaled_h_space_ = new SymScaledMatrixSpace(ConstPtr(dx_), true, h_space);
+         scaled_h_space_ = new SymScaledMatrixSpace(ConstPtr(dx_), true, h_space, store_scaled_matrices_);
          new_h_space = GetRawPtr(scaled_h_space_);
       }
       else
@@ -656,6 +672,25 @@ bool StandardScalingBase::have_d_scaling()
    return (IsValid(scaled_jac_d_space_) && IsValid(scaled_jac_d_space_->RowScaling()));
 }
 
+void StandardScalingBase::ApplyConstraintScalingUpdate(
+   const Vector& c_factors,
+   const Vector& d_factors
+)
+{
+   // a scaling method that updates the scaling has to provide row
+   // scaling vectors from the start, since the matrix spaces are fixed
+   DBG_ASSERT(c_factors.Dim() == 0 || have_c_scaling());
+   DBG_ASSERT(d_factors.Dim() == 0 || have_d_scaling());
+   if( have_c_scaling() )
+   {
+      scaled_jac_c_space_->ScaleRowScaling(c_factors);
+   }
+   if( have_d_scaling() )
+   {
+      scaled_jac_d_space_->ScaleRowScaling(d_factors);
+   }
+}
+
 void NoNLPScalingObject::DetermineScalingParametersImpl(
    const SmartPtr<const VectorSpace>    /*x_space*/,
    const SmartPtr<const VectorSpace>    /*c_space*/,
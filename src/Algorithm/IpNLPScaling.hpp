@@ -251,6 +251,40 @@ public:
    virtual bool have_d_scaling() = 0;
    ///@}
 
+   /** @name Methods for updating the scaling of the constraints during the optimization */
+   ///@{
+   /** Compute new scaling factors for the constraints at the
+    *  (unscaled) point x.
+    *
+    *  On success, c_factors and d_factors are the ratios of the new
+    *  and the current scaling factors of each constraint.  The scaling
+    *  is not changed yet, see ApplyConstraintScalingUpdate.
+    *
+    *  @return false, if the scaling method does not update its scaling
+    *  or no scaling factor changes significantly
+    */
+   virtual bool ComputeConstraintScalingUpdate(
+      const Vector&     /*x*/,
+      SmartPtr<Vector>& /*c_factors*/,
+      SmartPtr<Vector>& /*d_factors*/
+   )
+   {
+      return false;
+   }
+
+   /** Multiply the scaling factors of the constraints by c_factors
+    *  and d_factors.
+    *
+    *  All scaled quantities, including the scaled Jacobians that have
+    *  been returned before, change accordingly.
+    */
+   virtual void ApplyConstraintScalingUpdate(
+      const Vector& /*c_factors*/,
+      const Vector& /*d_factors*/
+   )
+   { }
+   ///@}
+
    /** This method is called by the IpoptNLP's at a convenient time to
     *  compute and/or read scaling factors
     */
@@ -415,6 +449,11 @@ public:
    virtual bool have_d_scaling();
    ///@}
 
+   virtual void ApplyConstraintScalingUpdate(
+      const Vector& c_factors,
+      const Vector& d_factors
+   );
+
    /** This method is called by the IpoptNLP's at a convenient time to
     *  compute and/or read scaling factors
     */
@@ -518,6 +557,9 @@ private:
    ///@{
    /** Additional scaling value for the objective function */
    Number obj_scaling_factor_;
+
+   /** Whether the scaled matrices store their scaled values */
+   bool store_scaled_matrices_;
    ///@}
 };
 
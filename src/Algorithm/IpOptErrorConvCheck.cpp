@@ -5,6 +5,7 @@
 // Authors:  Carl Laird, Andreas Waechter     IBM    2004-08-13
 
 #include "IpOptErrorConvCheck.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 
@@ -274,7 +275,7 @@ bool OptimalityErrorConvergenceCheck::CurrentIsAcceptable()
    {
       // DELETEME
       Jnlst().Printf(J_MOREDETAILED, J_MAIN,
-                     "obj val update iter = %d\n", IpData().iter_count());
+                     "obj val update iter = %" IPOPT_INDEX_FORMAT "\n", IpData().iter_count());
       last_obj_val_ = curr_obj_val_;
       curr_obj_val_ = IpCq().curr_f();
       last_obj_val_iter_ = IpData().iter_count();
@@ -317,7 +318,7 @@ bool OptimalityErrorConvergenceCheck::CurrentIsAcceptable()
                      fabs(curr_obj_val_ - last_obj_val_) / Max(1., fabs(curr_obj_val_)), acceptable_obj_change_tol_);
       // DELETEME
       Jnlst().Printf(J_MOREDETAILED, J_MAIN,
-                     "test iter = %d\n", IpData().iter_count());
+                     "test iter = %" IPOPT_INDEX_FORMAT "\n", IpData().iter_count());
    }
 
    return (overall_error <= acceptable_tol_ && dual_inf <= acceptable_dual_inf_tol_
@@ -325,4 +326,26 @@ bool OptimalityErrorConvergenceCheck::CurrentIsAcceptable()
            && fabs(curr_obj_val_ - last_obj_val_) / Max(1., fabs(curr_obj_val_)) <= acceptable_obj_change_tol_);
 }
 
+void OptimalityErrorConvergenceCheck::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   checkpoint.WriteSection("OptimalityErrorConvergenceCheck");
+   checkpoint.WriteIndex(acceptable_counter_);
+   checkpoint.WriteNumber(last_obj_val_);
+   checkpoint.WriteNumber(curr_obj_val_);
+   checkpoint.WriteIndex(last_obj_val_iter_);
+}
+
+void OptimalityErrorConvergenceCheck::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("OptimalityErrorConvergenceCheck");
+   acceptable_counter_ = checkpoint.ReadIndex();
+   last_obj_val_ = checkpoint.ReadNumber();
+   curr_obj_val_ = checkpoint.ReadNumber();
+   last_obj_val_iter_ = checkpoint.ReadIndex();
+}
+
 } // namespace Ipopt
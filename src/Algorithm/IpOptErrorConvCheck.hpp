@@ -39,6 +39,16 @@ public:
     */
    virtual bool CurrentIsAcceptable();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    static void RegisterOptions(
       SmartPtr<RegisteredOptions> roptions
    );
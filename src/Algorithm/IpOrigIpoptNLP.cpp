@@ -6,6 +6,8 @@
 
 #include "IpOrigIpoptNLP.hpp"
 #include "IpLowRankUpdateSymMatrix.hpp"
+#include "IpHessianProductMatrix.hpp"
+#include "IpDenseVector.hpp"
 #include "IpIpoptData.hpp"
 #include "IpIpoptCalculatedQuantities.hpp"
 
@@ -35,8 +37,19 @@ OrigIpoptNLP::OrigIpoptNLP(
      jac_d_cache_(1),
      h_cache_(1),
      unscaled_x_cache_(1),
+     precomputed_x_tag_(0),
+     precomputed_yc_tag_(0),
+     precomputed_yd_tag_(0),
+     precomputed_obj_factor_(0.),
      initialized_(false)
 {
+   f_eval_time_.SetName("FunctionEvaluations/ObjectiveFunction");
+   grad_f_eval_time_.SetName("FunctionEvaluations/ObjectiveFunctionGradient");
+   c_eval_time_.SetName("FunctionEvaluations/EqualityConstraints");
+   d_eval_time_.SetName("FunctionEvaluations/InequalityConstraints");
+   jac_c_eval_time_.SetName("FunctionEvaluations/EqualityConstraintJacobian");
+   jac_d_eval_time_.SetName("FunctionEvaluations/InequalityConstraintJacobian");
+   h_eval_time_.SetName("FunctionEvaluations/LagrangianHessian");
 }
 
 OrigIpoptNLP::~OrigIpoptNLP()
@@ -75,6 +88,34 @@ void OrigIpoptNLP::RegisterOptions(
       "yes", "Assume this is problem has known structure",
       "If \"yes\" is chosen, then the algorithm assumes that an NLP is now to be solved, "
       "whose structure is identical to one that already was considered (with the same NLP object).");
+   roptions->AddStringOption2(
+      "warm_start_keep_state",
+      "Indicates whether the state of the algorithm from the previous solve is kept.",
+      "no",
+      "no", "Start with the initial algorithmic state.",
+      "yes", "Continue with the state of the previous solve.",
+      "If \"yes\" is chosen together with \"warm_start_same_structure\", a reoptimization starts with "
+      "the final barrier parameter of the previous solve (for the monotone barrier parameter update) and "
+      "keeps the degeneracy information and the last perturbations of the primal-dual system. "
+      "Together with \"warm_start_entire_iterate\" and small warm start bound pushes, "
+      "this is meant for solving a sequence of slightly perturbed problems.");
+   roptions->AddStringOption2(
+      "warm_start_previous_solution",
+      "Indicates whether a reoptimization of a TNLP starts from the solution of the previous solve.",
+      "no",
+      "no", "Take the starting point from the TNLP.",
+      "yes", "Start from the final point of the previous solve.",
+      "If \"yes\" is chosen, a reoptimization of a TNLP (ReOptimizeTNLP) takes the starting point of the primal variables "
+      "and, if \"warm_start_init_point\" is chosen, of the bound and constraint multipliers from the final point of the previous solve "
+      "instead of calling get_starting_point of the TNLP. "
+      "The number of variables must be unchanged, but the structure of the problem may change. "
+      "In particular, constraints may have been appended since the previous solve, e.g., "
+      "cuts in a cutting-plane method or constraints of an active-set outer loop; "
+      "the multipliers of the appended constraints start at zero. "
+      "If constraints have been removed, the constraint multipliers are taken from the TNLP. "
+      "This option is ignored if \"presolve\" is enabled. "
+      "Together with \"warm_start_init_point\" and small warm start bound pushes, "
+      "this avoids storing the solution in the TNLP to warm start each outer iteration.");
    roptions->SetRegisteringCategory("NLP");
    roptions->AddStringOption2(
       "check_derivatives_for_naninf",
@@ -95,7 +136,8 @@ void OrigIpoptNLP::RegisterOptions(
       "no", "Don't assume that all equality constraints are linear",
       "yes", "Assume that equality constraints Jacobian are constant",
       "Activating this option will cause Ipopt to ask for the Jacobian of the equality constraints "
-      "only once from the NLP and reuse this information later.");
+      "only once from the NLP and reuse this information later. "
+      "This is also done if the NLP declares all equality constraints as linear.");
    roptions->AddStringOption2(
       "jac_d_constant",
       "Indicates whether all inequality constraints are linear",
@@ -103,7 +145,8 @@ void OrigIpoptNLP::RegisterOptions(
       "no", "Don't assume that all inequality constraints are linear",
       "yes", "Assume that equality constraints Jacobian are constant",
       "Activating this option will cause Ipopt to ask for the Jacobian of the inequality constraints "
-      "only once from the NLP and reuse this information later.");
+      "only once from the NLP and reuse this information later. "
+      "This is also done if the NLP declares all inequality constraints as linear.");
    roptions->AddStringOption2(
       "hessian_constant",
       "Indicates whether the problem is a quadratic problem",
@@ -113,19 +156,63 @@ void OrigIpoptNLP::RegisterOptions(
       "Activating this option will cause Ipopt to ask for the Hessian of the Lagrangian function "
       "only once from the NLP and reuse this information later.");
    roptions->SetRegisteringCategory("Hessian Approximation");
-   roptions->AddStringOption2(
+   roptions->AddStringOption6(
       "hessian_approximation",
       "Indicates what Hessian information is to be used.",
       "exact",
       "exact", "Use second derivatives provided by the NLP.",
       "limited-memory", "Perform a limited-memory quasi-Newton approximation",
-      "This determines which kind of information for the Hessian of the Lagrangian function is used by the algorithm.");
+      "matrix-free", "Use products of second derivatives with vectors provided by the NLP.",
+      "partitioned", "Perform a quasi-Newton approximation of each element function of a partially separable NLP.",
+      "finite-difference-values", "Use the sparsity structure provided by the NLP and compute the values by finite differences of first derivatives.",
+      "lagged-exact", "Use second derivatives provided by the NLP, but reuse them for several iterations.",
+      "This determines which kind of information for the Hessian of the Lagrangian function is used by the algorithm. "
+      "If \"matrix-free\" is chosen, the Hessian is never formed, so that the linear systems are solved "
+      "by an iterative method instead of a direct linear solver (see option krylov_method). "
+      "For a TNLP, eval_h_times_vec is called instead of eval_h then. "
+      "If \"partitioned\" is chosen, the Lagrangian function is assumed to be a sum of element functions, "
+      "each depending on a few variables only, and a dense quasi-Newton approximation is maintained for each of them "
+      "(see option partitioned_update_type). "
+      "For a TNLP, get_element_functions_info, get_element_functions_structure, and eval_element_gradients "
+      "are called instead of eval_h then. "
+      "If \"finite-difference-values\" is chosen, the values of the Hessian are approximated by differences "
+      "of the gradient of the Lagrangian function along groups of variables that are obtained from a star coloring "
+      "of the Hessian sparsity structure (see option findiff_perturbation). "
+      "For a TNLP, eval_h is then only called for the sparsity structure, and the constraint Jacobian has to be exact. "
+      "If \"lagged-exact\" is chosen, the second derivatives are only evaluated again after a number of iterations "
+      "or if the optimality error does not decrease sufficiently (see options hessian_lag_iterations and "
+      "hessian_lag_error_reduction).");
    roptions->AddStringOption2(
       "hessian_approximation_space",
       "Indicates in which subspace the Hessian information is to be approximated.",
       "nonlinear-variables",
       "nonlinear-variables", "only in space of nonlinear variables.",
       "all-variables", "in space of all variables (without slacks)");
+   roptions->AddStringOption2(
+      "hessian_approximation_exact_part",
+      "Indicates whether the limited-memory approximation corrects second derivatives provided by the NLP.",
+      "no",
+      "no", "approximate the whole Hessian of the Lagrangian",
+      "yes", "approximate the difference to the Hessian provided by the NLP",
+      "If \"yes\" is chosen and hessian_approximation is \"limited-memory\", the Hessian of the Lagrangian is the sum "
+      "of the (sparse) Hessian provided by the NLP, e.g., of the terms that are cheap to differentiate, "
+      "and a limited-memory quasi-Newton approximation of the remaining terms "
+      "in the space given by hessian_approximation_space. "
+      "For a TNLP, eval_h then has to return the Hessian of the exact part only. "
+      "This requires limited_memory_aug_solver to be \"sherman-morrison\". "
+      "The restoration phase approximates the whole Hessian.");
+   roptions->SetRegisteringCategory("NLP");
+   roptions->AddStringOption2(
+      "concurrent_derivative_evaluation",
+      "Indicates whether the constraint Jacobian and the Lagrangian Hessian are evaluated concurrently",
+      "no",
+      "no", "Evaluate the Jacobian and the Hessian one after the other.",
+      "yes", "Evaluate the Jacobian and the Hessian at the same time in two threads.",
+      "If \"yes\" is chosen, then the Jacobian and the Hessian for an accepted iterate are requested "
+      "from the NLP at the same time, which allows the NLP to evaluate them concurrently. "
+      "For a TNLP, eval_jac_g and eval_h are then called in parallel from two threads. "
+      "This option has only an effect if Ipopt has been build with OpenMP support, exact second derivatives are used, "
+      "and the TNLP declares with get_evaluation_concurrency that it can be evaluated concurrently.");
 }
 
 bool OrigIpoptNLP::Initialize(
@@ -143,10 +230,12 @@ bool OrigIpoptNLP::Initialize(
    hessian_approximation_ = HessianApproximationType(enum_int);
    options.GetEnumValue("hessian_approximation_space", enum_int, prefix);
    hessian_approximation_space_ = HessianApproximationSpace(enum_int);
+   options.GetBoolValue("hessian_approximation_exact_part", hessian_approximation_exact_part_, prefix);
 
    options.GetBoolValue("jac_c_constant", jac_c_constant_, prefix);
    options.GetBoolValue("jac_d_constant", jac_d_constant_, prefix);
    options.GetBoolValue("hessian_constant", hessian_constant_, prefix);
+   options.GetBoolValue("concurrent_derivative_evaluation", concurrent_derivative_evaluation_, prefix);
 
    // Reset the function evaluation counters (for warm start)
    f_evals_ = 0;
@@ -192,6 +281,14 @@ bool OrigIpoptNLP::Initialize(
    jac_d_cache_.InvalidateResult(deps, sdeps);
    h_cache_.InvalidateResult(deps, sdeps);
 
+   precomputed_jac_c_ = NULL;
+   precomputed_jac_d_ = NULL;
+   precomputed_h_ = NULL;
+   precomputed_fcd_x_tags_.clear();
+   precomputed_f_.clear();
+   precomputed_c_.clear();
+   precomputed_d_.clear();
+
    if( !nlp_->ProcessOptions(options, prefix) )
    {
       return false;
@@ -240,12 +337,28 @@ bool OrigIpoptNLP::InitializeStructures(
          jnlst_->Printf(J_WARNING, J_INITIALIZATION, "GetSpaces method for the NLP returns false.\n");
          return false;
       }
+      exact_h_space_ = NULL;
+
+      // If only products with the Hessian are available, the
+      // Hessian space of the NLP is replaced
+      if( hessian_approximation_ == MATRIX_FREE )
+      {
+         h_space_ = new HessianProductMatrixSpace(x_space_->Dim());
+      }
 
       // Check if the Hessian space is actually a limited-memory
       // approximation.  If so, get the required information from the
       // NLP and create an appropreate h_space
       if( hessian_approximation_ == LIMITED_MEMORY )
       {
+         // If the NLP provides an exact part, its Hessian space is
+         // kept for the evaluation of that part
+         if( hessian_approximation_exact_part_ )
+         {
+            ASSERT_EXCEPTION(IsValid(h_space_), OPTION_INVALID,
+                             "hessian_approximation_exact_part is chosen, but the NLP provides no Hessian space.");
+            exact_h_space_ = h_space_;
+         }
          SmartPtr<VectorSpace> approx_vecspace;
          SmartPtr<Matrix> P_approx;
          if( hessian_approximation_space_ == NONLINEAR_VARS )
@@ -256,17 +369,18 @@ bool OrigIpoptNLP::InitializeStructures(
          {
             DBG_ASSERT(IsValid(P_approx));
             h_space_ = new LowRankUpdateSymMatrixSpace(x_space_->Dim(), ConstPtr(P_approx), ConstPtr(approx_vecspace),
-                  true);
+                  true, exact_h_space_);
             jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
-                           "Hessian approximation will be done in smaller space of dimension %d (instead of %d)\n\n",
+                           "Hessian approximation will be done in smaller space of dimension %" IPOPT_INDEX_FORMAT " (instead of %" IPOPT_INDEX_FORMAT ")\n\n",
                            P_approx->NCols(), P_approx->NRows());
          }
          else
          {
             DBG_ASSERT(IsNull(P_approx));
-            h_space_ = new LowRankUpdateSymMatrixSpace(x_space_->Dim(), ConstPtr(P_approx), ConstPtr(x_space_), true);
+            h_space_ = new LowRankUpdateSymMatrixSpace(x_space_->Dim(), ConstPtr(P_approx), ConstPtr(x_space_), true,
+                  exact_h_space_);
             jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
-                           "Hessian approximation will be done in the space of all %d x variables.\n\n", x_space_->Dim());
+                           "Hessian approximation will be done in the space of all %" IPOPT_INDEX_FORMAT " x variables.\n\n", x_space_->Dim());
          }
       }
 
@@ -289,10 +403,15 @@ bool OrigIpoptNLP::InitializeStructures(
       NLP_scaling()->DetermineScaling(x_space_, c_space_, d_space_, jac_c_space_, jac_d_space_, h_space_,
                                       scaled_jac_c_space_, scaled_jac_d_space_, scaled_h_space_, *Px_L, *x_L, *Px_U, *x_U);
 
+      // The element gradients are not transformed by the scaling of the variables
+      ASSERT_EXCEPTION(hessian_approximation_ != PARTITIONED || !NLP_scaling()->have_x_scaling(), OPTION_INVALID,
+                       "hessian_approximation=partitioned cannot be used with a scaling of the variables.");
+      elem_grad_space_ = NULL;
+
       if( x_space_->Dim() < c_space_->Dim() )
       {
          char msg[128];
-         Snprintf(msg, 127, "Too few degrees of freedom: %d equality constriants but only %d variables",
+         Snprintf(msg, 127, "Too few degrees of freedom: %" IPOPT_INDEX_FORMAT " equality constriants but only %" IPOPT_INDEX_FORMAT " variables",
                   c_space_->Dim(), x_space_->Dim());
          THROW_EXCEPTION(TOO_FEW_DOF, msg);
       }
@@ -330,6 +449,25 @@ bool OrigIpoptNLP::InitializeStructures(
       }
    }
 
+   // Linear constraints declared by the NLP have constant Jacobians
+   bool nlp_jac_c_constant;
+   bool nlp_jac_d_constant;
+   if( nlp_->GetConstantJacobians(nlp_jac_c_constant, nlp_jac_d_constant) )
+   {
+      if( nlp_jac_c_constant && !jac_c_constant_ && c_space_->Dim() > 0 )
+      {
+         jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
+                        "All equality constraints are linear; evaluating their Jacobian only once.\n");
+      }
+      if( nlp_jac_d_constant && !jac_d_constant_ && d_space_->Dim() > 0 )
+      {
+         jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
+                        "All inequality constraints are linear; evaluating their Jacobian only once.\n");
+      }
+      jac_c_constant_ = jac_c_constant_ || nlp_jac_c_constant;
+      jac_d_constant_ = jac_d_constant_ || nlp_jac_d_constant;
+   }
+
    x_L->Print(*jnlst_, J_MOREVECTOR, J_INITIALIZATION, "original x_L unscaled");
    x_U->Print(*jnlst_, J_MOREVECTOR, J_INITIALIZATION, "original x_U unscaled");
    d_L->Print(*jnlst_, J_MOREVECTOR, J_INITIALIZATION, "original d_L unscaled");
@@ -475,21 +613,45 @@ Number OrigIpoptNLP::f(
 {
    DBG_START_METH("OrigIpoptNLP::f", dbg_verbosity);
    Number ret = 0.0;
-   DBG_PRINT((2, "x.Tag = %u\n", x.GetTag()));
-   if( !f_cache_.GetCachedResult1Dep(ret, &x) )
+   bool success = eval_f(x, ret);
+   ASSERT_EXCEPTION(success, Eval_Error, "Error evaluating the objective function");
+
+   return ret;
+}
+
+bool OrigIpoptNLP::eval_f(
+   const Vector& x,
+   Number&       f
+)
+{
+   DBG_PRINT((2, "x.Tag = %llu\n", x.GetTag()));
+   if( !f_cache_.GetCachedResult1Dep(f, &x) )
    {
       f_evals_++;
-      SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
-      f_eval_time_.Start();
-      bool success = nlp_->Eval_f(*unscaled_x, ret);
-      f_eval_time_.End();
-      DBG_PRINT((1, "success = %d ret = %e\n", success, ret));
-      ASSERT_EXCEPTION(success && IsFiniteNumber(ret), Eval_Error, "Error evaluating the objective function");
-      ret = NLP_scaling()->apply_obj_scaling(ret);
-      f_cache_.AddCachedResult1Dep(ret, &x);
+      bool success = true;
+      Index ipre = get_precomputed_fcd_index(x);
+      if( ipre >= 0 )
+      {
+         // already evaluated in PrecomputeFunctions
+         f = precomputed_f_[ipre];
+      }
+      else
+      {
+         SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+         f_eval_time_.Start();
+         success = nlp_->Eval_f(*unscaled_x, f);
+         f_eval_time_.End();
+      }
+      DBG_PRINT((1, "success = %d ret = %e\n", success, f));
+      if( !success || !IsFiniteNumber(f) )
+      {
+         return false;
+      }
+      f = NLP_scaling()->apply_obj_scaling(f);
+      f_cache_.AddCachedResult1Dep(f, &x);
    }
 
-   return ret;
+   return true;
 }
 
 Number OrigIpoptNLP::f(
@@ -539,6 +701,17 @@ SmartPtr<const Vector> OrigIpoptNLP::c(
 )
 {
    SmartPtr<const Vector> retValue;
+   bool success = eval_c(x, retValue);
+   ASSERT_EXCEPTION(success, Eval_Error, "Error evaluating the equality constraints");
+
+   return retValue;
+}
+
+bool OrigIpoptNLP::eval_c(
+   const Vector&           x,
+   SmartPtr<const Vector>& retValue
+)
+{
    if( c_space_->Dim() == 0 )
    {
       // We do this caching of an empty vector so that the returned
@@ -555,12 +728,23 @@ SmartPtr<const Vector> OrigIpoptNLP::c(
    {
       if( !c_cache_.GetCachedResult1Dep(retValue, x) )
       {
-         SmartPtr<Vector> unscaled_c = c_space_->MakeNew();
+         SmartPtr<Vector> unscaled_c;
          c_evals_++;
-         SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
-         c_eval_time_.Start();
-         bool success = nlp_->Eval_c(*unscaled_x, *unscaled_c);
-         c_eval_time_.End();
+         bool success = true;
+         Index ipre = get_precomputed_fcd_index(x);
+         if( ipre >= 0 )
+         {
+            // already evaluated in PrecomputeFunctions
+            unscaled_c = precomputed_c_[ipre];
+         }
+         else
+         {
+            unscaled_c = c_space_->MakeNew();
+            SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+            c_eval_time_.Start();
+            success = nlp_->Eval_c(*unscaled_x, *unscaled_c);
+            c_eval_time_.End();
+         }
          if( !success || !IsFiniteNumber(unscaled_c->Nrm2()) )
          {
             if( check_derivatives_for_naninf_ && !IsFiniteNumber(unscaled_c->Nrm2()) )
@@ -569,14 +753,14 @@ SmartPtr<const Vector> OrigIpoptNLP::c(
                unscaled_c->Print(*jnlst_, J_MOREDETAILED, J_MAIN, "unscaled_c");
                jnlst_->FlushBuffer();
             }
-            THROW_EXCEPTION(Eval_Error, "Error evaluating the equality constraints");
+            return false;
          }
          retValue = NLP_scaling()->apply_vector_scaling_c(ConstPtr(unscaled_c));
          c_cache_.AddCachedResult1Dep(retValue, x);
       }
    }
 
-   return retValue;
+   return true;
 }
 
 SmartPtr<const Vector> OrigIpoptNLP::d(
@@ -585,6 +769,17 @@ SmartPtr<const Vector> OrigIpoptNLP::d(
 {
    DBG_START_METH("OrigIpoptNLP::d", dbg_verbosity);
    SmartPtr<const Vector> retValue;
+   bool success = eval_d(x, retValue);
+   ASSERT_EXCEPTION(success, Eval_Error, "Error evaluating the inequality constraints");
+
+   return retValue;
+}
+
+bool OrigIpoptNLP::eval_d(
+   const Vector&           x,
+   SmartPtr<const Vector>& retValue
+)
+{
    if( d_space_->Dim() == 0 )
    {
       // We do this caching of an empty vector so that the returned
@@ -602,13 +797,24 @@ SmartPtr<const Vector> OrigIpoptNLP::d(
       if( !d_cache_.GetCachedResult1Dep(retValue, x) )
       {
          d_evals_++;
-         SmartPtr<Vector> unscaled_d = d_space_->MakeNew();
+         SmartPtr<Vector> unscaled_d;
+         bool success = true;
 
          DBG_PRINT_VECTOR(2, "scaled_x", x);
-         SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
-         d_eval_time_.Start();
-         bool success = nlp_->Eval_d(*unscaled_x, *unscaled_d);
-         d_eval_time_.End();
+         Index ipre = get_precomputed_fcd_index(x);
+         if( ipre >= 0 )
+         {
+            // already evaluated in PrecomputeFunctions
+            unscaled_d = precomputed_d_[ipre];
+         }
+         else
+         {
+            unscaled_d = d_space_->MakeNew();
+            SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+            d_eval_time_.Start();
+            success = nlp_->Eval_d(*unscaled_x, *unscaled_d);
+            d_eval_time_.End();
+         }
          DBG_PRINT_VECTOR(2, "unscaled_d", *unscaled_d);
          if( !success || !IsFiniteNumber(unscaled_d->Nrm2()) )
          {
@@ -618,14 +824,14 @@ SmartPtr<const Vector> OrigIpoptNLP::d(
                unscaled_d->Print(*jnlst_, J_MOREDETAILED, J_MAIN, "unscaled_d");
                jnlst_->FlushBuffer();
             }
-            THROW_EXCEPTION(Eval_Error, "Error evaluating the inequality constraints");
+            return false;
          }
          retValue = NLP_scaling()->apply_vector_scaling_d(ConstPtr(unscaled_d));
          d_cache_.AddCachedResult1Dep(retValue, x);
       }
    }
 
-   return retValue;
+   return true;
 }
 
 SmartPtr<const Matrix> OrigIpoptNLP::jac_c(
@@ -655,12 +861,23 @@ SmartPtr<const Matrix> OrigIpoptNLP::jac_c(
       if( !jac_c_cache_.GetCachedResult1Dep(retValue, GetRawPtr(dep)) )
       {
          jac_c_evals_++;
-         SmartPtr<Matrix> unscaled_jac_c = jac_c_space_->MakeNew();
+         SmartPtr<Matrix> unscaled_jac_c;
+         bool success = true;
+         if( IsValid(precomputed_jac_c_) && precomputed_x_tag_ == x.GetTag() )
+         {
+            // already evaluated in PrecomputeDerivatives
+            unscaled_jac_c = precomputed_jac_c_;
+         }
+         else
+         {
+            unscaled_jac_c = jac_c_space_->MakeNew();
 
-         SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
-         jac_c_eval_time_.Start();
-         bool success = nlp_->Eval_jac_c(*unscaled_x, *unscaled_jac_c);
-         jac_c_eval_time_.End();
+            SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+            jac_c_eval_time_.Start();
+            success = nlp_->Eval_jac_c(*unscaled_x, *unscaled_jac_c);
+            jac_c_eval_time_.End();
+         }
+         precomputed_jac_c_ = NULL;
          ASSERT_EXCEPTION(success, Eval_Error, "Error evaluating the jacobian of the equality constraints");
          if( check_derivatives_for_naninf_ )
          {
@@ -709,12 +926,23 @@ SmartPtr<const Matrix> OrigIpoptNLP::jac_d(
       if( !jac_d_cache_.GetCachedResult1Dep(retValue, GetRawPtr(dep)) )
       {
          jac_d_evals_++;
-         SmartPtr<Matrix> unscaled_jac_d = jac_d_space_->MakeNew();
+         SmartPtr<Matrix> unscaled_jac_d;
+         bool success = true;
+         if( IsValid(precomputed_jac_d_) && precomputed_x_tag_ == x.GetTag() )
+         {
+            // already evaluated in PrecomputeDerivatives
+            unscaled_jac_d = precomputed_jac_d_;
+         }
+         else
+         {
+            unscaled_jac_d = jac_d_space_->MakeNew();
 
-         SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
-         jac_d_eval_time_.Start();
-         bool success = nlp_->Eval_jac_d(*unscaled_x, *unscaled_jac_d);
-         jac_d_eval_time_.End();
+            SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+            jac_d_eval_time_.Start();
+            success = nlp_->Eval_jac_d(*unscaled_x, *unscaled_jac_d);
+            jac_d_eval_time_.End();
+         }
+         precomputed_jac_d_ = NULL;
          ASSERT_EXCEPTION(success, Eval_Error, "Error evaluating the jacobian of the inequality constraints");
          if( check_derivatives_for_naninf_ )
          {
@@ -770,15 +998,37 @@ SmartPtr<const SymMatrix> OrigIpoptNLP::h(
    if( !h_cache_.GetCachedResult(retValue, deps, scalar_deps) )
    {
       h_evals_++;
-      unscaled_h = h_space_->MakeNewSymMatrix();
+      bool success = true;
+      if( IsValid(precomputed_h_) && precomputed_x_tag_ == x.GetTag() && precomputed_yc_tag_ == yc.GetTag()
+          && precomputed_yd_tag_ == yd.GetTag() && precomputed_obj_factor_ == obj_factor )
+      {
+         // already evaluated in PrecomputeDerivatives
+         unscaled_h = precomputed_h_;
+      }
+      else
+      {
+         // For a limited-memory approximation, only the exact part is evaluated
+         unscaled_h = IsValid(exact_h_space_) ? exact_h_space_->MakeNewSymMatrix() : h_space_->MakeNewSymMatrix();
 
-      SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
-      SmartPtr<const Vector> unscaled_yc = NLP_scaling()->apply_vector_scaling_c(&yc);
-      SmartPtr<const Vector> unscaled_yd = NLP_scaling()->apply_vector_scaling_d(&yd);
-      Number scaled_obj_factor = NLP_scaling()->apply_obj_scaling(obj_factor);
-      h_eval_time_.Start();
-      bool success = nlp_->Eval_h(*unscaled_x, scaled_obj_factor, *unscaled_yc, *unscaled_yd, *unscaled_h);
-      h_eval_time_.End();
+         SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+         SmartPtr<const Vector> unscaled_yc = NLP_scaling()->apply_vector_scaling_c(&yc);
+         SmartPtr<const Vector> unscaled_yd = NLP_scaling()->apply_vector_scaling_d(&yd);
+         Number scaled_obj_factor = NLP_scaling()->apply_obj_scaling(obj_factor);
+         if( hessian_approximation_ == MATRIX_FREE )
+         {
+            // the products with vectors are computed when they are needed
+            HessianProductMatrix* hp = static_cast<HessianProductMatrix*>(GetRawPtr(unscaled_h));
+            DBG_ASSERT(dynamic_cast<HessianProductMatrix*>(GetRawPtr(unscaled_h)));
+            hp->SetEvaluationPoint(nlp_, *unscaled_x, scaled_obj_factor, *unscaled_yc, *unscaled_yd);
+         }
+         else
+         {
+            h_eval_time_.Start();
+            success = nlp_->Eval_h(*unscaled_x, scaled_obj_factor, *unscaled_yc, *unscaled_yd, *unscaled_h);
+            h_eval_time_.End();
+         }
+      }
+      precomputed_h_ = NULL;
       ASSERT_EXCEPTION(success, Eval_Error, "Error evaluating the hessian of the lagrangian");
       if( check_derivatives_for_naninf_ )
       {
@@ -798,6 +1048,188 @@ SmartPtr<const SymMatrix> OrigIpoptNLP::h(
    return retValue;
 }
 
+void OrigIpoptNLP::PrecomputeDerivatives(
+   const Vector& x,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd
+)
+{
+   if( !concurrent_derivative_evaluation_ || hessian_approximation_ != EXACT )
+   {
+      return;
+   }
+
+   // this is only worthwhile if the Hessian and at least one of the
+   // Jacobians still have to be evaluated
+   SmartPtr<const Matrix> jac;
+   bool need_jac_c = c_space_->Dim() > 0
+                     && !jac_c_cache_.GetCachedResult1Dep(jac, jac_c_constant_ ? NULL : &x);
+   bool need_jac_d = d_space_->Dim() > 0
+                     && !jac_d_cache_.GetCachedResult1Dep(jac, jac_d_constant_ ? NULL : &x);
+
+   std::vector<const TaggedObject*> deps(3);
+   if( !hessian_constant_ )
+   {
+      deps[0] = &x;
+      deps[1] = &yc;
+      deps[2] = &yd;
+   }
+   else
+   {
+      deps[0] = NULL;
+      deps[1] = NULL;
+      deps[2] = NULL;
+   }
+   std::vector<Number> scalar_deps(1);
+   scalar_deps[0] = obj_factor;
+   SmartPtr<const SymMatrix> hess;
+   bool need_h = !h_cache_.GetCachedResult(hess, deps, scalar_deps);
+
+   if( !need_h || (!need_jac_c && !need_jac_d) )
+   {
+      return;
+   }
+
+   SmartPtr<Matrix> unscaled_jac_c;
+   if( need_jac_c )
+   {
+      unscaled_jac_c = jac_c_space_->MakeNew();
+   }
+   SmartPtr<Matrix> unscaled_jac_d;
+   if( need_jac_d )
+   {
+      unscaled_jac_d = jac_d_space_->MakeNew();
+   }
+   SmartPtr<SymMatrix> unscaled_h = h_space_->MakeNewSymMatrix();
+
+   SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+   SmartPtr<const Vector> unscaled_yc = NLP_scaling()->apply_vector_scaling_c(&yc);
+   SmartPtr<const Vector> unscaled_yd = NLP_scaling()->apply_vector_scaling_d(&yd);
+   Number scaled_obj_factor = NLP_scaling()->apply_obj_scaling(obj_factor);
+
+   // since the evaluations overlap, each timer gets the time of the whole call
+   if( need_jac_c )
+   {
+      jac_c_eval_time_.Start();
+   }
+   if( need_jac_d )
+   {
+      jac_d_eval_time_.Start();
+   }
+   h_eval_time_.Start();
+   bool success = nlp_->Eval_jac_and_h(*unscaled_x, GetRawPtr(unscaled_jac_c), GetRawPtr(unscaled_jac_d),
+                                       scaled_obj_factor, *unscaled_yc, *unscaled_yd, *unscaled_h);
+   h_eval_time_.End();
+   if( need_jac_d )
+   {
+      jac_d_eval_time_.End();
+   }
+   if( need_jac_c )
+   {
+      jac_c_eval_time_.End();
+   }
+
+   if( !success )
+   {
+      // the evaluations are repeated in jac_c, jac_d, and h, which
+      // then report the error
+      return;
+   }
+
+   precomputed_jac_c_ = unscaled_jac_c;
+   precomputed_jac_d_ = unscaled_jac_d;
+   precomputed_h_ = unscaled_h;
+   precomputed_x_tag_ = x.GetTag();
+   precomputed_yc_tag_ = yc.GetTag();
+   precomputed_yd_tag_ = yd.GetTag();
+   precomputed_obj_factor_ = obj_factor;
+}
+
+void OrigIpoptNLP::PrecomputeFunctions(
+   const std::vector<SmartPtr<const Vector> >& x
+)
+{
+   precomputed_fcd_x_tags_.clear();
+   precomputed_f_.clear();
+   precomputed_c_.clear();
+   precomputed_d_.clear();
+
+   Index npoints = (Index) x.size();
+   if( npoints < 2 )
+   {
+      // nothing to be gained
+      return;
+   }
+
+   std::vector<SmartPtr<const Vector> > unscaled_x(npoints);
+   std::vector<Number> unscaled_f(npoints);
+   std::vector<SmartPtr<Vector> > unscaled_c(npoints);
+   std::vector<SmartPtr<Vector> > unscaled_d(npoints);
+   std::vector<bool> success(npoints);
+   for( Index i = 0; i < npoints; i++ )
+   {
+      unscaled_x[i] = get_unscaled_x(*x[i]);
+      unscaled_c[i] = c_space_->MakeNew();
+      unscaled_d[i] = d_space_->MakeNew();
+   }
+
+   // since the evaluations overlap, each timer gets the time of the whole call
+   f_eval_time_.Start();
+   c_eval_time_.Start();
+   d_eval_time_.Start();
+   nlp_->Eval_f_c_d(unscaled_x, unscaled_f, unscaled_c, unscaled_d, success);
+   d_eval_time_.End();
+   c_eval_time_.End();
+   f_eval_time_.End();
+
+   // failed evaluations are repeated in f, c, and d, which then report the error
+   for( Index i = 0; i < npoints; i++ )
+   {
+      if( success[i] )
+      {
+         precomputed_fcd_x_tags_.push_back(x[i]->GetTag());
+         precomputed_f_.push_back(unscaled_f[i]);
+         precomputed_c_.push_back(unscaled_c[i]);
+         precomputed_d_.push_back(unscaled_d[i]);
+      }
+   }
+}
+
+bool OrigIpoptNLP::EvaluateFunctions(
+   const Vector& x
+)
+{
+   Number f;
+   if( !eval_f(x, f) )
+   {
+      jnlst_->Printf(J_DETAILED, J_NLP, "Error evaluating the objective function\n");
+      return false;
+   }
+
+   return EvaluateConstraints(x);
+}
+
+bool OrigIpoptNLP::EvaluateConstraints(
+   const Vector& x
+)
+{
+   SmartPtr<const Vector> c;
+   SmartPtr<const Vector> d;
+   if( !eval_c(x, c) )
+   {
+      jnlst_->Printf(J_DETAILED, J_NLP, "Error evaluating the equality constraints\n");
+      return false;
+   }
+   if( !eval_d(x, d) )
+   {
+      jnlst_->Printf(J_DETAILED, J_NLP, "Error evaluating the inequality constraints\n");
+      return false;
+   }
+
+   return true;
+}
+
 SmartPtr<const SymMatrix> OrigIpoptNLP::h(
    const Vector& /*x*/,
    Number        /*obj_factor*/,
@@ -810,6 +1242,39 @@ SmartPtr<const SymMatrix> OrigIpoptNLP::h(
    return NULL;
 }
 
+SmartPtr<const Vector> OrigIpoptNLP::element_gradients(
+   const Vector& x,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd
+)
+{
+   if( IsNull(elem_grad_space_) )
+   {
+      std::vector<Index> elem_start;
+      std::vector<Index> elem_vars;
+      if( !nlp_->GetElementFunctions(elem_start, elem_vars) )
+      {
+         return NULL;
+      }
+      elem_grad_space_ = new DenseVectorSpace((Index) elem_vars.size());
+   }
+
+   SmartPtr<Vector> elem_grad = elem_grad_space_->MakeNew();
+   SmartPtr<const Vector> unscaled_x = get_unscaled_x(x);
+   SmartPtr<const Vector> unscaled_yc = NLP_scaling()->apply_vector_scaling_c(&yc);
+   SmartPtr<const Vector> unscaled_yd = NLP_scaling()->apply_vector_scaling_d(&yd);
+   Number scaled_obj_factor = NLP_scaling()->apply_obj_scaling(obj_factor);
+
+   h_eval_time_.Start();
+   bool success = nlp_->Eval_element_gradients(*unscaled_x, scaled_obj_factor, *unscaled_yc, *unscaled_yd, *elem_grad);
+   h_eval_time_.End();
+   ASSERT_EXCEPTION(success && IsFiniteNumber(elem_grad->Nrm2()), Eval_Error,
+                    "Error evaluating the gradients of the element functions");
+
+   return ConstPtr(elem_grad);
+}
+
 void OrigIpoptNLP::GetSpaces(
    SmartPtr<const VectorSpace>&    x_space,
    SmartPtr<const VectorSpace>&    c_space,
@@ -982,6 +1447,38 @@ void OrigIpoptNLP::AdjustVariableBounds(
    d_U_ = new_d_U.MakeNewCopy();
 }
 
+bool OrigIpoptNLP::ComputeConstraintScalingUpdate(
+   const Vector&     x,
+   SmartPtr<Vector>& c_factors,
+   SmartPtr<Vector>& d_factors
+)
+{
+   return NLP_scaling()->ComputeConstraintScalingUpdate(*get_unscaled_x(x), c_factors, d_factors);
+}
+
+void OrigIpoptNLP::ApplyConstraintScalingUpdate(
+   const Vector& c_factors,
+   const Vector& d_factors
+)
+{
+   NLP_scaling()->ApplyConstraintScalingUpdate(c_factors, d_factors);
+
+   SmartPtr<Vector> factors_L = d_L_->MakeNew();
+   Pd_L_->TransMultVector(1., d_factors, 0., *factors_L);
+   factors_L->ElementWiseMultiply(*d_L_);
+   d_L_ = ConstPtr(factors_L);
+   SmartPtr<Vector> factors_U = d_U_->MakeNew();
+   Pd_U_->TransMultVector(1., d_factors, 0., *factors_U);
+   factors_U->ElementWiseMultiply(*d_U_);
+   d_U_ = ConstPtr(factors_U);
+
+   // the cached constraint values and Jacobians have the old scaling
+   c_cache_.Clear();
+   d_cache_.Clear();
+   jac_c_cache_.Clear();
+   jac_d_cache_.Clear();
+}
+
 void OrigIpoptNLP::PrintTimingStatistics(
    Journalist&      jnlst,
    EJournalLevel    level,
@@ -1056,4 +1553,18 @@ SmartPtr<const Vector> OrigIpoptNLP::get_unscaled_x(
    return ret;
 }
 
+Index OrigIpoptNLP::get_precomputed_fcd_index(
+   const Vector& x
+) const
+{
+   for( Index i = 0; i < (Index) precomputed_fcd_x_tags_.size(); i++ )
+   {
+      if( precomputed_fcd_x_tags_[i] == x.GetTag() )
+      {
+         return i;
+      }
+   }
+   return -1;
+}
+
 } // namespace Ipopt
@@ -18,7 +18,11 @@ namespace Ipopt
 enum HessianApproximationType
 {
    EXACT = 0,
-   LIMITED_MEMORY
+   LIMITED_MEMORY,
+   MATRIX_FREE,
+   PARTITIONED,
+   FINDIFF_VALUES,
+   LAGGED_EXACT
 };
 
 /** enumeration for the Hessian approximation space. */
@@ -150,6 +154,53 @@ public:
       Number        mu
    );
 
+   /** Evaluates the constraint Jacobians and the Hessian of the
+    *  Lagrangian in one call to the NLP if concurrent_derivative_evaluation
+    *  is enabled.
+    *
+    *  The results are kept until jac_c, jac_d, and h are called for the
+    *  same arguments.
+    */
+   virtual void PrecomputeDerivatives(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd
+   );
+
+   /** Evaluates the objective function and the constraints at all
+    *  points in x in one call to the NLP.
+    *
+    *  The results are kept until the next call of this method.
+    */
+   virtual void PrecomputeFunctions(
+      const std::vector<SmartPtr<const Vector> >& x
+   );
+
+   /** Evaluates the objective function and the constraints at x
+    *  without throwing Eval_Error if an evaluation fails.
+    */
+   virtual bool EvaluateFunctions(
+      const Vector& x
+   );
+
+   /** Evaluates the constraints at x without throwing Eval_Error if an
+    *  evaluation fails.
+    */
+   virtual bool EvaluateConstraints(
+      const Vector& x
+   );
+
+   /** The problem is a quadratic program if the exact Hessian is used
+    *  and declared constant by hessian_constant, and the Jacobians are
+    *  constant because they have been declared constant by the options
+    *  or all constraints are linear.
+    */
+   virtual bool IsQuadraticProgram() const
+   {
+      return (hessian_approximation_ == EXACT || hessian_approximation_ == LAGGED_EXACT) && hessian_constant_ && jac_c_constant_ && jac_d_constant_;
+   }
+
    /** Provides a Hessian matrix from the correct matrix space with
     *  uninitialized values.
     *
@@ -243,6 +294,43 @@ public:
       const Vector& new_d_U
    );
 
+   virtual bool ComputeConstraintScalingUpdate(
+      const Vector&     x,
+      SmartPtr<Vector>& c_factors,
+      SmartPtr<Vector>& d_factors
+   );
+
+   virtual void ApplyConstraintScalingUpdate(
+      const Vector& c_factors,
+      const Vector& d_factors
+   );
+
+   virtual bool GetDiagonalBlocks(
+      Index&              num_blocks,
+      std::vector<Index>& x_block,
+      std::vector<Index>& c_block,
+      std::vector<Index>& d_block
+   )
+   {
+      num_blocks = nlp_->GetNumberOfDiagonalBlocks();
+      return num_blocks > 0 && nlp_->GetDiagonalBlocks(num_blocks, x_block, c_block, d_block);
+   }
+
+   virtual bool GetElementFunctions(
+      std::vector<Index>& elem_start,
+      std::vector<Index>& elem_vars
+   )
+   {
+      return nlp_->GetElementFunctions(elem_start, elem_vars);
+   }
+
+   virtual SmartPtr<const Vector> element_gradients(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd
+   );
+
    /** @name Counters for the number of function evaluations. */
    ///@{
    virtual Index f_evals() const
@@ -387,6 +475,10 @@ private:
    SmartPtr<const MatrixSpace> jac_c_space_;
    SmartPtr<const MatrixSpace> jac_d_space_;
    SmartPtr<const SymMatrixSpace> h_space_;
+   /** Hessian space of the NLP for the exact part of a limited-memory approximation */
+   SmartPtr<const SymMatrixSpace> exact_h_space_;
+   /** Space for the gradients of the element functions of the NLP */
+   SmartPtr<const VectorSpace> elem_grad_space_;
 
    SmartPtr<const MatrixSpace> scaled_jac_c_space_;
    SmartPtr<const MatrixSpace> scaled_jac_d_space_;
@@ -494,10 +586,39 @@ private:
       Vector& bounds
    );
 
+   /** Method for evaluating f at x.
+    *
+    *  Returns false instead of throwing Eval_Error if the NLP cannot
+    *  evaluate the function or the value is not finite.
+    */
+   bool eval_f(
+      const Vector& x,
+      Number&       f
+   );
+
+   /** Method for evaluating c at x, see eval_f */
+   bool eval_c(
+      const Vector&           x,
+      SmartPtr<const Vector>& c
+   );
+
+   /** Method for evaluating d at x, see eval_f */
+   bool eval_d(
+      const Vector&           x,
+      SmartPtr<const Vector>& d
+   );
+
    /** Method for getting the unscaled version of the x vector */
    SmartPtr<const Vector> get_unscaled_x(
       const Vector& x
    );
+
+   /** Method for getting the position of x in the points given to
+    *  PrecomputeFunctions, or -1 if it is not among them
+    */
+   Index get_precomputed_fcd_index(
+      const Vector& x
+   ) const;
    ///@}
 
    /** @name Algorithmic parameters */
@@ -522,6 +643,10 @@ private:
    /** Flag indicating in which space Hessian is to be approximated. */
    HessianApproximationSpace hessian_approximation_space_;
 
+   /** Flag indicating whether the limited-memory approximation
+    *  corrects the Hessian provided by the NLP. */
+   bool hessian_approximation_exact_part_;
+
    /** Flag indicating whether it is desired to check if there are
     *  Nan or Inf entries in first and second derivative matrices.
     */
@@ -539,6 +664,37 @@ private:
 
    /** Flag indicating if we need to ask for Hessian only once */
    bool hessian_constant_;
+
+   /** Flag indicating whether the NLP should be asked to evaluate
+    *  the constraint Jacobians and the Hessian concurrently.
+    */
+   bool concurrent_derivative_evaluation_;
+   ///@}
+
+   /** @name Unscaled derivatives computed by PrecomputeDerivatives
+    *  that have not been requested yet
+    */
+   ///@{
+   SmartPtr<Matrix> precomputed_jac_c_;
+   SmartPtr<Matrix> precomputed_jac_d_;
+   SmartPtr<SymMatrix> precomputed_h_;
+   /** Tag of (scaled) x at which the derivatives have been computed */
+   TaggedObject::Tag precomputed_x_tag_;
+   /** Tag of (scaled) yc at which the Hessian has been computed */
+   TaggedObject::Tag precomputed_yc_tag_;
+   /** Tag of (scaled) yd at which the Hessian has been computed */
+   TaggedObject::Tag precomputed_yd_tag_;
+   /** Objective factor at which the Hessian has been computed */
+   Number precomputed_obj_factor_;
+   ///@}
+
+   /** @name Unscaled function values computed by PrecomputeFunctions */
+   ///@{
+   /** Tags of the (scaled) points at which the functions have been computed */
+   std::vector<TaggedObject::Tag> precomputed_fcd_x_tags_;
+   std::vector<Number> precomputed_f_;
+   std::vector<SmartPtr<Vector> > precomputed_c_;
+   std::vector<SmartPtr<Vector> > precomputed_d_;
    ///@}
 
    /** @name Counters for the function evaluations */
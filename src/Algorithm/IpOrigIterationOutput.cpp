@@ -13,10 +13,16 @@ namespace Ipopt
 {
 
 OrigIterationOutput::OrigIterationOutput()
+   : trace_file_(NULL)
 { }
 
 OrigIterationOutput::~OrigIterationOutput()
-{ }
+{
+   if( trace_file_ != NULL )
+   {
+      fclose(trace_file_);
+   }
+}
 
 void OrigIterationOutput::RegisterOptions(
    SmartPtr<RegisteredOptions> roptions
@@ -55,6 +61,20 @@ void OrigIterationOutput::RegisterOptions(
       0.,
       "Summarizing iteration output is printed if at least print_frequency_time seconds have "
       "passed since last output and the iteration number is a multiple of print_frequency_iter.");
+   roptions->AddStringOption1(
+      "iteration_trace_file",
+      "File name for a trace of the iterations (leave unset for no trace).",
+      "",
+      "*", "Any acceptable standard file name",
+      "For every iteration, a line with a JSON object is written to this file and the file is flushed. "
+      "The object has the iteration number (\"iter\"), the values of the summary line "
+      "(\"obj\", \"inf_pr\", \"inf_du\", \"mu\", \"d_norm\", \"alpha_du\", \"alpha_pr\", \"alpha_pr_type\", \"ls\", \"info\"), "
+      "the regularization of the primal-dual system (\"delta_x\", \"delta_s\", \"delta_c\", \"delta_d\"), "
+      "the number of factorizations and backsolves of the linear solver and the wallclock times "
+      "spent for the iteration, the search direction, the line search, the factorizations, and the backsolves "
+      "since the previous iteration, and the number of function and Hessian evaluations so far. "
+      "Values that are not finite are written as null. "
+      "The iterations of the restoration phase are not written.");
    roptions->SetRegisteringCategory(prev_cat);
 }
 
@@ -70,6 +90,33 @@ bool OrigIterationOutput::InitializeImpl(
    options.GetIntegerValue("print_frequency_iter", print_frequency_iter_, prefix);
    options.GetNumericValue("print_frequency_time", print_frequency_time_, prefix);
 
+   if( trace_file_ != NULL )
+   {
+      fclose(trace_file_);
+      trace_file_ = NULL;
+   }
+   std::string trace_file_name;
+   options.GetStringValue("iteration_trace_file", trace_file_name, prefix);
+   if( !trace_file_name.empty() )
+   {
+      trace_file_ = fopen(trace_file_name.c_str(), "w");
+      if( trace_file_ == NULL )
+      {
+         Jnlst().Printf(J_ERROR, J_INITIALIZATION,
+                        "Error opening iteration trace file \"%s\"\n", trace_file_name.c_str());
+         return false;
+      }
+   }
+
+   TimingStatistics& timing = IpData().TimingStats();
+   last_factorizations_ = timing.LinearSystemFactorization().NumberOfCalls();
+   last_backsolves_ = timing.LinearSystemBackSolve().NumberOfCalls();
+   last_time_ = MonotonicTime();
+   last_search_direction_time_ = timing.ComputeSearchDirection().TotalWallclockTime();
+   last_line_search_time_ = timing.ComputeAcceptableTrialPoint().TotalWallclockTime();
+   last_factorization_time_ = timing.LinearSystemFactorization().TotalWallclockTime();
+   last_backsolve_time_ = timing.LinearSystemBackSolve().TotalWallclockTime();
+
    return true;
 }
 
@@ -84,7 +131,7 @@ void OrigIterationOutput::WriteOutput()
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n\n**************************************************\n");
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "*** Summary of Iteration: %d:", IpData().iter_count());
+                  "*** Summary of Iteration: %" IPOPT_INDEX_FORMAT ":", IpData().iter_count());
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n\n");
    if( IpData().info_iters_since_header() >= 10 && !IpData().info_skip_output() )
@@ -99,73 +146,89 @@ void OrigIterationOutput::WriteOutput()
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      header.c_str());
    }
-   Number inf_pr = 0.0;
-   switch( inf_pr_output_ )
-   {
-      case INTERNAL:
-         inf_pr = IpCq().curr_primal_infeasibility(NORM_MAX);
-         break;
-      case ORIGINAL:
-         inf_pr = IpCq().unscaled_curr_nlp_constraint_violation(NORM_MAX);
-         break;
-   }
-   Number inf_du = IpCq().curr_dual_infeasibility(NORM_MAX);
-   Number mu = IpData().curr_mu();
-   Number dnrm;
-   if( IsValid(IpData().delta()) && IsValid(IpData().delta()->x()) && IsValid(IpData().delta()->s()) )
-   {
-      dnrm = Max(IpData().delta()->x()->Amax(), IpData().delta()->s()->Amax());
-   }
-   else
-   {
-      // This is the first iteration - no search direction has been
-      // computed yet.
-      dnrm = 0.;
-   }
-   Number unscaled_f = IpCq().unscaled_curr_f();
-
-   // Retrieve some information set in the different parts of the algorithm
-   char info_iter = ' ';
-   Number alpha_primal = IpData().info_alpha_primal();
-   char alpha_primal_char = IpData().info_alpha_primal_char();
-   Number alpha_dual = IpData().info_alpha_dual();
-   Number regu_x = IpData().info_regu_x();
-   char regu_x_buf[8];
-   char dashes[] = "   - ";
-   char* regu_x_ptr;
-   if( regu_x == .0 )
-   {
-      regu_x_ptr = dashes;
-   }
-   else
-   {
-      Snprintf(regu_x_buf, 7, "%5.1f", log10(regu_x));
-      regu_x_ptr = regu_x_buf;
-   }
-   Index ls_count = IpData().info_ls_count();
-   const std::string info_string = IpData().info_string();
-
    Number current_time = 0.0;
    Number last_output = IpData().info_last_output();
-   if( !IpData().info_skip_output() && (iter % print_frequency_iter_) == 0
-       && (print_frequency_time_ == 0.0 || last_output < (current_time = WallclockTime()) - print_frequency_time_
-           || last_output < 0.0) )
+   bool summary_line = !IpData().info_skip_output() && (iter % print_frequency_iter_) == 0
+                       && (print_frequency_time_ == 0.0 || last_output < (current_time = WallclockTime()) - print_frequency_time_
+                           || last_output < 0.0);
+
+   // the quantities of the summary line are only computed if some
+   // journal prints the line or if it is written to the trace file
+   if( (summary_line && Jnlst().ProduceOutput(J_ITERSUMMARY, J_MAIN)) || trace_file_ != NULL )
    {
-      Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
-                     "%4d%c%14.7e %7.2e %7.2e %5.1f %7.2e %5s %7.2e %7.2e%c%3d", iter, info_iter, unscaled_f, inf_pr, inf_du, log10(mu), dnrm, regu_x_ptr, alpha_dual, alpha_primal, alpha_primal_char, ls_count);
-      if( print_info_string_ )
+      Number inf_pr = 0.0;
+      switch( inf_pr_output_ )
       {
-         Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
-                        " %s", info_string.c_str());
+         case INTERNAL:
+            inf_pr = IpCq().curr_primal_infeasibility(NORM_MAX);
+            break;
+         case ORIGINAL:
+            inf_pr = IpCq().unscaled_curr_nlp_constraint_violation(NORM_MAX);
+            break;
+      }
+      Number inf_du = IpCq().curr_dual_infeasibility(NORM_MAX);
+      Number mu = IpData().curr_mu();
+      Number dnrm;
+      if( IsValid(IpData().delta()) && IsValid(IpData().delta()->x()) && IsValid(IpData().delta()->s()) )
+      {
+         dnrm = Max(IpData().delta()->x()->Amax(), IpData().delta()->s()->Amax());
       }
       else
       {
-         Jnlst().Printf(J_DETAILED, J_MAIN,
-                        " %s", info_string.c_str());
+         // This is the first iteration - no search direction has been
+         // computed yet.
+         dnrm = 0.;
       }
-      Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
-                     "\n");
+      Number unscaled_f = IpCq().unscaled_curr_f();
+
+      // Retrieve some information set in the different parts of the algorithm
+      char info_iter = ' ';
+      Number alpha_primal = IpData().info_alpha_primal();
+      char alpha_primal_char = IpData().info_alpha_primal_char();
+      Number alpha_dual = IpData().info_alpha_dual();
+      Number regu_x = IpData().info_regu_x();
+      char regu_x_buf[8];
+      char dashes[] = "   - ";
+      char* regu_x_ptr;
+      if( regu_x == .0 )
+      {
+         regu_x_ptr = dashes;
+      }
+      else
+      {
+         Snprintf(regu_x_buf, 7, "%5.1f", log10(regu_x));
+         regu_x_ptr = regu_x_buf;
+      }
+      Index ls_count = IpData().info_ls_count();
+      const std::string info_string = IpData().info_string();
 
+      if( summary_line )
+      {
+         Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
+                        "%4" IPOPT_INDEX_FORMAT "%c%14.7e %7.2e %7.2e %5.1f %7.2e %5s %7.2e %7.2e%c%3" IPOPT_INDEX_FORMAT, iter, info_iter, unscaled_f, inf_pr, inf_du, log10(mu), dnrm, regu_x_ptr, alpha_dual, alpha_primal, alpha_primal_char, ls_count);
+         if( print_info_string_ )
+         {
+            Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
+                           " %s", info_string.c_str());
+         }
+         else
+         {
+            Jnlst().Printf(J_DETAILED, J_MAIN,
+                           " %s", info_string.c_str());
+         }
+         Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
+                        "\n");
+      }
+
+      if( trace_file_ != NULL )
+      {
+         WriteTrace(iter, unscaled_f, inf_pr, inf_du, mu, dnrm, alpha_primal, alpha_primal_char, alpha_dual, ls_count,
+                    info_string.c_str());
+      }
+   }
+
+   if( summary_line )
+   {
       IpData().Set_info_last_output(current_time);
       IpData().Inc_info_iters_since_header();
    }
@@ -179,7 +242,7 @@ void OrigIterationOutput::WriteOutput()
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      "\n**************************************************\n");
       Jnlst().Printf(J_DETAILED, J_MAIN,
-                     "*** Beginning Iteration %d from the following point:", IpData().iter_count());
+                     "*** Beginning Iteration %" IPOPT_INDEX_FORMAT " from the following point:", IpData().iter_count());
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      "\n**************************************************\n\n");
 
@@ -262,7 +325,7 @@ void OrigIterationOutput::WriteOutput()
    if( Jnlst().ProduceOutput(J_DETAILED, J_MAIN) )
    {
       Jnlst().Printf(J_DETAILED, J_MAIN,
-                     "\n\n***Current NLP Values for Iteration %d:\n", IpData().iter_count());
+                     "\n\n***Current NLP Values for Iteration %" IPOPT_INDEX_FORMAT ":\n", IpData().iter_count());
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      "\n                                   (scaled)                 (unscaled)\n");
       Jnlst().Printf(J_DETAILED, J_MAIN,
@@ -299,4 +362,107 @@ void OrigIterationOutput::WriteOutput()
    Jnlst().FlushBuffer();
 }
 
+/** write a number as JSON value, which does not allow inf and nan */
+static void WriteJSONNumber(
+   FILE*       fp,
+   const char* name,
+   Number      value
+)
+{
+   if( IsFiniteNumber(value) )
+   {
+      fprintf(fp, ",\"%s\":%.16g", name, value);
+   }
+   else
+   {
+      fprintf(fp, ",\"%s\":null", name);
+   }
+}
+
+/** write a string as JSON value */
+static void WriteJSONString(
+   FILE*       fp,
+   const char* str
+)
+{
+   fputc('"', fp);
+   for( const char* c = str; *c != '\0'; ++c )
+   {
+      if( *c == '"' || *c == '\\' )
+      {
+         fputc('\\', fp);
+         fputc(*c, fp);
+      }
+      else if( (unsigned char) *c >= 0x20 )
+      {
+         fputc(*c, fp);
+      }
+   }
+   fputc('"', fp);
+}
+
+void OrigIterationOutput::WriteTrace(
+   Index       iter,
+   Number      unscaled_f,
+   Number      inf_pr,
+   Number      inf_du,
+   Number      mu,
+   Number      dnrm,
+   Number      alpha_primal,
+   char        alpha_primal_char,
+   Number      alpha_dual,
+   Index       ls_count,
+   const char* info_string
+)
+{
+   DBG_ASSERT(trace_file_ != NULL);
+
+   Number delta_x, delta_s, delta_c, delta_d;
+   IpData().getPDPert(delta_x, delta_s, delta_c, delta_d);
+
+   // OutputIteration is still timed, so only the tasks that are done are read
+   TimingStatistics& timing = IpData().TimingStats();
+   Index factorizations = timing.LinearSystemFactorization().NumberOfCalls();
+   Index backsolves = timing.LinearSystemBackSolve().NumberOfCalls();
+   Number time = MonotonicTime();
+   Number search_direction_time = timing.ComputeSearchDirection().TotalWallclockTime();
+   Number line_search_time = timing.ComputeAcceptableTrialPoint().TotalWallclockTime();
+   Number factorization_time = timing.LinearSystemFactorization().TotalWallclockTime();
+   Number backsolve_time = timing.LinearSystemBackSolve().TotalWallclockTime();
+
+   fprintf(trace_file_, "{\"iter\":%d", (int) iter);
+   WriteJSONNumber(trace_file_, "obj", unscaled_f);
+   WriteJSONNumber(trace_file_, "inf_pr", inf_pr);
+   WriteJSONNumber(trace_file_, "inf_du", inf_du);
+   WriteJSONNumber(trace_file_, "mu", mu);
+   WriteJSONNumber(trace_file_, "d_norm", dnrm);
+   WriteJSONNumber(trace_file_, "alpha_du", alpha_dual);
+   WriteJSONNumber(trace_file_, "alpha_pr", alpha_primal);
+   fprintf(trace_file_, ",\"alpha_pr_type\":");
+   WriteJSONString(trace_file_, std::string(1, alpha_primal_char).c_str());
+   fprintf(trace_file_, ",\"ls\":%d,\"info\":", (int) ls_count);
+   WriteJSONString(trace_file_, info_string);
+   WriteJSONNumber(trace_file_, "delta_x", delta_x);
+   WriteJSONNumber(trace_file_, "delta_s", delta_s);
+   WriteJSONNumber(trace_file_, "delta_c", delta_c);
+   WriteJSONNumber(trace_file_, "delta_d", delta_d);
+   fprintf(trace_file_, ",\"factorizations\":%d,\"backsolves\":%d",
+           (int) (factorizations - last_factorizations_), (int) (backsolves - last_backsolves_));
+   WriteJSONNumber(trace_file_, "time", time - last_time_);
+   WriteJSONNumber(trace_file_, "time_search_direction", search_direction_time - last_search_direction_time_);
+   WriteJSONNumber(trace_file_, "time_line_search", line_search_time - last_line_search_time_);
+   WriteJSONNumber(trace_file_, "time_factorization", factorization_time - last_factorization_time_);
+   WriteJSONNumber(trace_file_, "time_backsolve", backsolve_time - last_backsolve_time_);
+   fprintf(trace_file_, ",\"f_evals\":%d,\"h_evals\":%d}\n", (int) IpNLP().f_evals(), (int) IpNLP().h_evals());
+   fflush(trace_file_);
+
+   last_factorizations_ = factorizations;
+   last_backsolves_ = backsolves;
+   last_time_ = time;
+   last_search_direction_time_ = search_direction_time;
+   last_line_search_time_ = line_search_time;
+   last_factorization_time_ = factorization_time;
+   last_backsolve_time_ = backsolve_time;
+}
+
 } // namespace Ipopt
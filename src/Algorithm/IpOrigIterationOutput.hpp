@@ -9,10 +9,17 @@
 
 #include "IpIterationOutput.hpp"
 
+#include <cstdio>
+
 namespace Ipopt
 {
 
 /** Class for the iteration summary output for the original NLP.
+ *
+ *  Next to the summary line, this can write a trace of the iterations
+ *  to a file, see option iteration_trace_file.  This file has one JSON
+ *  object per line and iteration (newline-delimited JSON), so that it
+ *  can be read by other tools, also if the optimization did not finish.
  */
 class OrigIterationOutput: public IterationOutput
 {
@@ -75,10 +82,39 @@ private:
    InfPrOutput inf_pr_output_;
 
    /** Option indicating at which iteration frequency the summary line should be printed */
-   int print_frequency_iter_;
+   Index print_frequency_iter_;
 
    /** Option indicating at which time frequency the summary line should be printed */
    Number print_frequency_time_;
+
+   /** Write the record of the current iteration to the trace file */
+   void WriteTrace(
+      Index       iter,
+      Number      unscaled_f,
+      Number      inf_pr,
+      Number      inf_du,
+      Number      mu,
+      Number      dnrm,
+      Number      alpha_primal,
+      char        alpha_primal_char,
+      Number      alpha_dual,
+      Index       ls_count,
+      const char* info_string
+   );
+
+   /** File for the iteration trace, or NULL if no trace is written */
+   FILE* trace_file_;
+
+   /**@name Counters and times at the previous trace record */
+   ///@{
+   Index last_factorizations_;
+   Index last_backsolves_;
+   Number last_time_;
+   Number last_search_direction_time_;
+   Number last_line_search_time_;
+   Number last_factorization_time_;
+   Number last_backsolve_time_;
+   ///@}
 };
 
 } // namespace Ipopt
@@ -6,6 +6,7 @@
 
 #include "IpPDFullSpaceSolver.hpp"
 #include "IpDebug.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 
@@ -23,7 +24,9 @@ PDFullSpaceSolver::PDFullSpaceSolver(
    : PDSystemSolver(),
      augSysSolver_(&augSysSolver),
      perturbHandler_(&perturbHandler),
-     dummy_cache_(1)
+     dummy_cache_(1),
+     lag_count_(0),
+     lagged_cache_(1)
 {
    DBG_START_METH("PDFullSpaceSolver::PDFullSpaceSolver", dbg_verbosity);
 }
@@ -90,6 +93,30 @@ void PDFullSpaceSolver::RegisterOptions(
       "yes",
       "yes", "use primal regularization with the inertia-free curvature test",
       "no",  "use original IPOPT approach, in which the primal regularization is ignored");
+   roptions->AddStringOption2(
+      "linear_solver_backward_error",
+      "Whether to accept solutions of the linear system based on the backward error reported by the linear solver.",
+      "no",
+      "no", "always compute the residuals of the solutions",
+      "yes", "skip the residuals and iterative refinement if the backward error is small enough",
+      "If enabled and the linear solver computes the componentwise backward error of its solutions "
+      "(currently only MUMPS), a solution of the augmented system with a backward error "
+      "below \"residual_ratio_max\" is accepted without computing the residuals of the full system, "
+      "and no iterative refinement steps are performed, regardless of \"min_refinement_steps\".");
+   roptions->AddLowerBoundedIntegerOption(
+      "factorization_lag_iterations",
+      "Maximal number of linear systems that are solved with the factorization of a previous system.",
+      0,
+      0,
+      "If positive, a new primal-dual system is first solved by iterative refinement "
+      "that uses the factorization of the most recently factorized system as preconditioner, "
+      "so that the new system need not be factorized. "
+      "The new system is factorized if the refinement does not reach \"residual_ratio_max\" "
+      "within \"max_refinement_steps\" steps or stalls, "
+      "or if the factorization has already been reused for this number of systems. "
+      "A factorization is not reused if the system has been regularized for its inertia. "
+      "This is advantageous if the systems change little between iterations, "
+      "e.g., close to the solution.");
 }
 
 
@@ -111,9 +138,13 @@ bool PDFullSpaceSolver::InitializeImpl(
    options.GetNumericValue("residual_improvement_factor", residual_improvement_factor_, prefix);
    options.GetNumericValue("neg_curv_test_tol", neg_curv_test_tol_, prefix);
    options.GetBoolValue("neg_curv_test_reg", neg_curv_test_reg_, prefix);
+   options.GetBoolValue("linear_solver_backward_error", linear_solver_backward_error_, prefix);
+   options.GetIntegerValue("factorization_lag_iterations", factorization_lag_iterations_, prefix);
 
    // Reset internal flags and data
    augsys_improved_ = false;
+   lag_W_ = NULL;
+   lag_count_ = 0;
 
    if( !augSysSolver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix) )
    {
@@ -186,7 +217,8 @@ bool PDFullSpaceSolver::Solve(
    DBG_PRINT_VECTOR(2, "Sigma_x", *sigma_x);
    DBG_PRINT_VECTOR(2, "Sigma_s", *sigma_s);
 
-   bool done = false;
+   // a new system is possibly solved with a previous factorization
+   bool done = !improve_solution && SolveWithLaggedFactorization(rhs, res);
    // The following flag is set to true, if we asked the linear
    // solver to improve the quality of the solution in
    // the next solve
@@ -206,7 +238,8 @@ bool PDFullSpaceSolver::Solve(
       // if improve_solution is true, we are given already a solution
       // from the calling function, so we can skip the first solve
       bool solve_retval = true;
-      if( !improve_solution )
+      bool solved = !improve_solution;
+      if( solved )
       {
          solve_retval = SolveOnce(resolve_with_better_quality, pretend_singular, *W, *J_c, *J_d, *Px_L, *Px_U, *Pd_L,
                                   *Pd_U, *z_L, *z_U, *v_L, *v_U, *slack_x_L, *slack_x_U, *slack_s_L, *slack_s_U, *sigma_x, *sigma_s, 1., 0.,
@@ -236,6 +269,12 @@ bool PDFullSpaceSolver::Solve(
          break;
       }
 
+      if( solved && BackwardErrorAcceptable() )
+      {
+         // the residuals need not be checked
+         break;
+      }
+
       // Get space for the residual
       SmartPtr<IteratesVector> resid = res.MakeNewIteratesVector(true);
 
@@ -268,6 +307,7 @@ bool PDFullSpaceSolver::Solve(
                         "residual_ratio = %e\n", residual_ratio);
 
          num_iter_ref++;
+         IpData().WorkCounts().Increase(WorkCounters::REFINEMENT_STEPS);
          // Check if we have to give up on iterative refinement
          if( residual_ratio > residual_ratio_max_ && num_iter_ref > min_refinement_steps_
              && (num_iter_ref > max_refinement_steps_
@@ -372,6 +412,133 @@ bool PDFullSpaceSolver::Solve(
    return true;
 }
 
+bool PDFullSpaceSolver::MultiSolve(
+   Number                                        alpha,
+   Number                                        beta,
+   std::vector<SmartPtr<const IteratesVector> >& rhsV,
+   std::vector<SmartPtr<IteratesVector> >&       resV,
+   bool                                          allow_inexact
+)
+{
+   DBG_START_METH("PDFullSpaceSolver::MultiSolve", dbg_verbosity);
+
+   const Index nrhs = (Index) rhsV.size();
+   DBG_ASSERT(nrhs > 0);
+   DBG_ASSERT(nrhs == (Index)resV.size());
+
+   if( nrhs == 1 || (factorization_lag_iterations_ > 0 && IsValid(lag_W_)) )
+   {
+      // each system is refined separately when a previous
+      // factorization is possibly reused
+      for( Index i = 0; i < nrhs; i++ )
+      {
+         if( !Solve(alpha, beta, *rhsV[i], *resV[i], allow_inexact) )
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   // Timing of PDSystem solver starts here
+   IpData().TimingStats().PDSystemSolverTotal().Start();
+
+   // if beta is nonzero, keep a copy of the incoming values in resV
+   std::vector<SmartPtr<IteratesVector> > copy_resV(nrhs);
+   if( beta != 0. )
+   {
+      for( Index i = 0; i < nrhs; i++ )
+      {
+         copy_resV[i] = resV[i]->MakeNewIteratesVectorCopy();
+      }
+   }
+
+   // Receive data about matrix
+   SmartPtr<const SymMatrix> W = IpData().W();
+   SmartPtr<const Matrix> J_c = IpCq().curr_jac_c();
+   SmartPtr<const Matrix> J_d = IpCq().curr_jac_d();
+   SmartPtr<const Matrix> Px_L = IpNLP().Px_L();
+   SmartPtr<const Matrix> Px_U = IpNLP().Px_U();
+   SmartPtr<const Matrix> Pd_L = IpNLP().Pd_L();
+   SmartPtr<const Matrix> Pd_U = IpNLP().Pd_U();
+   SmartPtr<const Vector> z_L = IpData().curr()->z_L();
+   SmartPtr<const Vector> z_U = IpData().curr()->z_U();
+   SmartPtr<const Vector> v_L = IpData().curr()->v_L();
+   SmartPtr<const Vector> v_U = IpData().curr()->v_U();
+   SmartPtr<const Vector> slack_x_L = IpCq().curr_slack_x_L();
+   SmartPtr<const Vector> slack_x_U = IpCq().curr_slack_x_U();
+   SmartPtr<const Vector> slack_s_L = IpCq().curr_slack_s_L();
+   SmartPtr<const Vector> slack_s_U = IpCq().curr_slack_s_U();
+   SmartPtr<const Vector> sigma_x = IpCq().curr_sigma_x();
+   SmartPtr<const Vector> sigma_s = IpCq().curr_sigma_s();
+
+   // Solve for all right hand sides at once.  If the matrix has changed,
+   // this also determines the modification of the system.
+   bool solve_retval = MultiSolveOnce(false, false, *W, *J_c, *J_d, *Px_L, *Px_U, *Pd_L, *Pd_U, *z_L, *z_U, *v_L, *v_U,
+                                      *slack_x_L, *slack_x_U, *slack_s_L, *slack_s_U, *sigma_x, *sigma_s, 1., 0., rhsV, resV);
+   if( !solve_retval )
+   {
+      IpData().TimingStats().PDSystemSolverTotal().End();
+      return false;
+   }
+
+   if( allow_inexact && Jnlst().ProduceOutput(J_MOREDETAILED, J_LINEAR_ALGEBRA) )
+   {
+      // no safety checks required
+      for( Index i = 0; i < nrhs; i++ )
+      {
+         SmartPtr<IteratesVector> resid = resV[i]->MakeNewIteratesVector(true);
+         ComputeResiduals(*W, *J_c, *J_d, *Px_L, *Px_U, *Pd_L, *Pd_U, *z_L, *z_U, *v_L, *v_U, *slack_x_L, *slack_x_U,
+                          *slack_s_L, *slack_s_U, *sigma_x, *sigma_s, alpha, beta, *rhsV[i], *resV[i], *resid);
+      }
+   }
+
+   // the residuals need not be checked if the linear solver
+   // reports a small backward error for all solutions
+   bool refine = !allow_inexact && !BackwardErrorAcceptable();
+
+   IpData().TimingStats().PDSystemSolverTotal().End();
+
+   for( Index i = 0; i < nrhs; i++ )
+   {
+      if( refine )
+      {
+         // Do the iterative refinement (and possibly modify the system)
+         // for each right hand side, starting from the solution above
+         if( !Solve(1., 0., *rhsV[i], *resV[i], false, true) )
+         {
+            return false;
+         }
+      }
+
+      // Finally let's assemble the res result vectors
+      if( alpha != 0. )
+      {
+         resV[i]->Scal(alpha);
+      }
+
+      if( beta != 0. )
+      {
+         resV[i]->Axpy(beta, *copy_resV[i]);
+      }
+   }
+
+   return true;
+}
+
+bool PDFullSpaceSolver::BackwardErrorAcceptable() const
+{
+   if( !linear_solver_backward_error_ || !augSysSolver_->ProvidesBackwardError() )
+   {
+      return false;
+   }
+
+   Number backward_error = augSysSolver_->BackwardError();
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "backward error of linear solver = %e\n", backward_error);
+   return backward_error <= residual_ratio_max_;
+}
+
 bool PDFullSpaceSolver::SolveOnce(
    bool                  resolve_with_better_quality,
    bool                  pretend_singular,
@@ -397,6 +564,40 @@ bool PDFullSpaceSolver::SolveOnce(
    const IteratesVector& rhs,
    IteratesVector&       res
 )
+{
+   std::vector<SmartPtr<const IteratesVector> > rhsV(1);
+   rhsV[0] = &rhs;
+   std::vector<SmartPtr<IteratesVector> > resV(1);
+   resV[0] = &res;
+   return MultiSolveOnce(resolve_with_better_quality, pretend_singular, W, J_c, J_d, Px_L, Px_U, Pd_L, Pd_U, z_L, z_U, v_L,
+                         v_U, slack_x_L, slack_x_U, slack_s_L, slack_s_U, sigma_x, sigma_s, alpha, beta, rhsV, resV);
+}
+
+bool PDFullSpaceSolver::MultiSolveOnce(
+   bool                                                resolve_with_better_quality,
+   bool                                                pretend_singular,
+   const SymMatrix&                                    W,
+   const Matrix&                                       J_c,
+   const Matrix&                                       J_d,
+   const Matrix&                                       Px_L,
+   const Matrix&                                       Px_U,
+   const Matrix&                                       Pd_L,
+   const Matrix&                                       Pd_U,
+   const Vector&                                       z_L,
+   const Vector&                                       z_U,
+   const Vector&                                       v_L,
+   const Vector&                                       v_U,
+   const Vector&                                       slack_x_L,
+   const Vector&                                       slack_x_U,
+   const Vector&                                       slack_s_L,
+   const Vector&                                       slack_s_U,
+   const Vector&                                       sigma_x,
+   const Vector&                                       sigma_s,
+   Number                                              alpha,
+   Number                                              beta,
+   const std::vector<SmartPtr<const IteratesVector> >& rhsV,
+   std::vector<SmartPtr<IteratesVector> >&             resV
+)
 {
    // TO DO LIST:
    //
@@ -408,21 +609,48 @@ bool PDFullSpaceSolver::SolveOnce(
    // 5. see if it makes sense to distinguish delta_x and delta_s,
    //    or delta_c and delta_d
    // 6. increase pivot tolerance if number of get evals so too small
-   DBG_START_METH("PDFullSpaceSolver::SolveOnce", dbg_verbosity);
+   DBG_START_METH("PDFullSpaceSolver::MultiSolveOnce", dbg_verbosity);
 
    IpData().TimingStats().PDSystemSolverSolveOnce().Start();
 
-   // Compute the right hand side for the augmented system formulation
-   SmartPtr<Vector> augRhs_x = rhs.x()->MakeNewCopy();
-   Px_L.AddMSinvZ(1.0, slack_x_L, *rhs.z_L(), *augRhs_x);
-   Px_U.AddMSinvZ(-1.0, slack_x_U, *rhs.z_U(), *augRhs_x);
-
-   SmartPtr<Vector> augRhs_s = rhs.s()->MakeNewCopy();
-   Pd_L.AddMSinvZ(1.0, slack_s_L, *rhs.v_L(), *augRhs_s);
-   Pd_U.AddMSinvZ(-1.0, slack_s_U, *rhs.v_U(), *augRhs_s);
-
-   // Get space into which we can put the solution of the augmented system
-   SmartPtr<IteratesVector> sol = res.MakeNewIteratesVector(true);
+   const Index nrhs = (Index) rhsV.size();
+   DBG_ASSERT(nrhs > 0);
+   DBG_ASSERT(nrhs == (Index)resV.size());
+
+   std::vector<SmartPtr<const Vector> > augRhs_xV(nrhs);
+   std::vector<SmartPtr<const Vector> > augRhs_sV(nrhs);
+   std::vector<SmartPtr<const Vector> > rhs_cV(nrhs);
+   std::vector<SmartPtr<const Vector> > rhs_dV(nrhs);
+   std::vector<SmartPtr<IteratesVector> > solV(nrhs);
+   std::vector<SmartPtr<Vector> > sol_xV(nrhs);
+   std::vector<SmartPtr<Vector> > sol_sV(nrhs);
+   std::vector<SmartPtr<Vector> > sol_cV(nrhs);
+   std::vector<SmartPtr<Vector> > sol_dV(nrhs);
+   for( Index i = 0; i < nrhs; i++ )
+   {
+      const IteratesVector& rhs = *rhsV[i];
+
+      // Compute the right hand side for the augmented system formulation
+      SmartPtr<Vector> augRhs_x = rhs.x()->MakeNewCopy();
+      Px_L.AddMSinvZ(1.0, slack_x_L, *rhs.z_L(), *augRhs_x);
+      Px_U.AddMSinvZ(-1.0, slack_x_U, *rhs.z_U(), *augRhs_x);
+      augRhs_xV[i] = ConstPtr(augRhs_x);
+
+      SmartPtr<Vector> augRhs_s = rhs.s()->MakeNewCopy();
+      Pd_L.AddMSinvZ(1.0, slack_s_L, *rhs.v_L(), *augRhs_s);
+      Pd_U.AddMSinvZ(-1.0, slack_s_U, *rhs.v_U(), *augRhs_s);
+      augRhs_sV[i] = ConstPtr(augRhs_s);
+
+      rhs_cV[i] = rhs.y_c();
+      rhs_dV[i] = rhs.y_d();
+
+      // Get space into which we can put the solution of the augmented system
+      solV[i] = resV[i]->MakeNewIteratesVector(true);
+      sol_xV[i] = solV[i]->x_NonConst();
+      sol_sV[i] = solV[i]->s_NonConst();
+      sol_cV[i] = solV[i]->y_c_NonConst();
+      sol_dV[i] = solV[i]->y_d_NonConst();
+   }
 
    // Now check whether any data has changed
    std::vector<const TaggedObject*> deps(13);
@@ -470,9 +698,8 @@ bool PDFullSpaceSolver::SolveOnce(
       // method has already asked the augSysSolver to increase the
       // quality at the end solve, and we are now getting the solution
       // with that better quality
-      retval = augSysSolver_->Solve(&W, 1.0, &sigma_x, delta_x, &sigma_s, delta_s, &J_c, NULL, delta_c, &J_d, NULL,
-                                    delta_d, *augRhs_x, *augRhs_s, *rhs.y_c(), *rhs.y_d(), *sol->x_NonConst(), *sol->s_NonConst(),
-                                    *sol->y_c_NonConst(), *sol->y_d_NonConst(), false, 0);
+      retval = augSysSolver_->MultiSolve(&W, 1.0, &sigma_x, delta_x, &sigma_s, delta_s, &J_c, NULL, delta_c, &J_d, NULL,
+                                         delta_d, augRhs_xV, augRhs_sV, rhs_cV, rhs_dV, sol_xV, sol_sV, sol_cV, sol_dV, false, 0);
       if( retval != SYMSOLVER_SUCCESS )
       {
          IpData().TimingStats().PDSystemSolverSolveOnce().End();
@@ -481,7 +708,7 @@ bool PDFullSpaceSolver::SolveOnce(
    }
    else
    {
-      const Index numberOfEVals = rhs.y_c()->Dim() + rhs.y_d()->Dim();
+      const Index numberOfEVals = rhsV[0]->y_c()->Dim() + rhsV[0]->y_d()->Dim();
       // counter for the number of trial evaluations
       // (ToDo is not at the correct place)
       Index count = 0;
@@ -508,6 +735,10 @@ bool PDFullSpaceSolver::SolveOnce(
          else
          {
             count++;
+            if( count > 1 )
+            {
+               IpData().WorkCounts().Increase(WorkCounters::INERTIA_CORRECTIONS);
+            }
             Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                            "Solving system with delta_x=%e delta_s=%e\n                    delta_c=%e delta_d=%e\n", delta_x,
                            delta_s, delta_c, delta_d);
@@ -516,15 +747,15 @@ bool PDFullSpaceSolver::SolveOnce(
             {
                check_inertia = false;
             }
-            retval = augSysSolver_->Solve(&W, 1.0, &sigma_x, delta_x, &sigma_s, delta_s, &J_c, NULL, delta_c, &J_d,
-                                          NULL, delta_d, *augRhs_x, *augRhs_s, *rhs.y_c(), *rhs.y_d(), *sol->x_NonConst(), *sol->s_NonConst(),
-                                          *sol->y_c_NonConst(), *sol->y_d_NonConst(), check_inertia, numberOfEVals);
+            retval = augSysSolver_->MultiSolve(&W, 1.0, &sigma_x, delta_x, &sigma_s, delta_s, &J_c, NULL, delta_c, &J_d,
+                                               NULL, delta_d, augRhs_xV, augRhs_sV, rhs_cV, rhs_dV, sol_xV, sol_sV, sol_cV, sol_dV,
+                                               check_inertia, numberOfEVals);
          }
          if( retval == SYMSOLVER_FATAL_ERROR )
          {
             return false;
          }
-         if( retval == SYMSOLVER_SINGULAR && (rhs.y_c()->Dim() + rhs.y_d()->Dim() > 0) )
+         if( retval == SYMSOLVER_SINGULAR && (numberOfEVals > 0) )
          {
 
             // Get new perturbation factors from the perturbation
@@ -580,6 +811,10 @@ bool PDFullSpaceSolver::SolveOnce(
          {
             // Get new perturbation factors from the perturbation
             // handlers for the case of wrong inertia
+            if( retval == SYMSOLVER_WRONG_INERTIA )
+            {
+               perturbHandler_->SetExcessNegEVals(augSysSolver_->NumberOfNegEVals() - numberOfEVals);
+            }
             bool pert_return = perturbHandler_->PerturbForWrongInertia(delta_x, delta_s, delta_c, delta_d);
             if( !pert_return )
             {
@@ -596,6 +831,8 @@ bool PDFullSpaceSolver::SolveOnce(
             Index neg_values = augSysSolver_->NumberOfNegEVals();
             if (neg_values != numberOfEVals)
             {
+               // use the solution for the first right hand side
+               SmartPtr<const IteratesVector> sol = ConstPtr(solV[0]);
                // check if we have a direction of sufficient positive curvature
                SmartPtr<Vector> x_tmp = sol->x()->MakeNew();
                W.MultVector(1., *sol->x(), 0., *x_tmp);
@@ -624,6 +861,10 @@ bool PDFullSpaceSolver::SolveOnce(
                {
                   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                                  "    -> Redo with modified matrix.\n");
+                  if( neg_values > numberOfEVals )
+                  {
+                     perturbHandler_->SetExcessNegEVals(neg_values - numberOfEVals);
+                  }
                   bool pert_return = perturbHandler_->PerturbForWrongInertia(delta_x, delta_s,
                                      delta_c, delta_d);
                   if (!pert_return)
@@ -641,28 +882,192 @@ bool PDFullSpaceSolver::SolveOnce(
 
       // Some output
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "Number of trial factorizations performed: %d\n", count);
+                     "Number of trial factorizations performed: %" IPOPT_INDEX_FORMAT "\n", count);
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                      "Perturbation parameters: delta_x=%e delta_s=%e\n                         delta_c=%e delta_d=%e\n", delta_x,
                      delta_s, delta_c, delta_d);
       // Set the perturbation values in the Data object
       IpData().setPDPert(delta_x, delta_s, delta_c, delta_d);
+
+      // Remember the factorized system, unless it has been regularized
+      // for its inertia
+      lag_W_ = NULL;
+      if( factorization_lag_iterations_ > 0 && delta_x == 0. )
+      {
+         lag_W_ = &W;
+         lag_J_c_ = &J_c;
+         lag_J_d_ = &J_d;
+         lag_z_L_ = &z_L;
+         lag_z_U_ = &z_U;
+         lag_v_L_ = &v_L;
+         lag_v_U_ = &v_U;
+         lag_slack_x_L_ = &slack_x_L;
+         lag_slack_x_U_ = &slack_x_U;
+         lag_slack_s_L_ = &slack_s_L;
+         lag_slack_s_U_ = &slack_s_U;
+         lag_sigma_x_ = &sigma_x;
+         lag_sigma_s_ = &sigma_s;
+         lag_count_ = 0;
+      }
    }
 
-   // Compute the remaining sol Vectors
-   Px_L.SinvBlrmZMTdBr(-1., slack_x_L, *rhs.z_L(), z_L, *sol->x(), *sol->z_L_NonConst());
-   Px_U.SinvBlrmZMTdBr(1., slack_x_U, *rhs.z_U(), z_U, *sol->x(), *sol->z_U_NonConst());
-   Pd_L.SinvBlrmZMTdBr(-1., slack_s_L, *rhs.v_L(), v_L, *sol->s(), *sol->v_L_NonConst());
-   Pd_U.SinvBlrmZMTdBr(1., slack_s_U, *rhs.v_U(), v_U, *sol->s(), *sol->v_U_NonConst());
+   for( Index i = 0; i < nrhs; i++ )
+   {
+      const IteratesVector& rhs = *rhsV[i];
+      IteratesVector& sol = *solV[i];
 
-   // Finally let's assemble the res result vectors
-   res.AddOneVector(alpha, *sol, beta);
+      // Compute the remaining sol Vectors
+      Px_L.SinvBlrmZMTdBr(-1., slack_x_L, *rhs.z_L(), z_L, *sol.x(), *sol.z_L_NonConst());
+      Px_U.SinvBlrmZMTdBr(1., slack_x_U, *rhs.z_U(), z_U, *sol.x(), *sol.z_U_NonConst());
+      Pd_L.SinvBlrmZMTdBr(-1., slack_s_L, *rhs.v_L(), v_L, *sol.s(), *sol.v_L_NonConst());
+      Pd_U.SinvBlrmZMTdBr(1., slack_s_U, *rhs.v_U(), v_U, *sol.s(), *sol.v_U_NonConst());
+
+      // Finally let's assemble the res result vectors
+      resV[i]->AddOneVector(alpha, sol, beta);
+   }
 
    IpData().TimingStats().PDSystemSolverSolveOnce().End();
 
    return true;
 }
 
+bool PDFullSpaceSolver::SolveWithLaggedFactorization(
+   const IteratesVector& rhs,
+   IteratesVector&       res
+)
+{
+   DBG_START_METH("PDFullSpaceSolver::SolveWithLaggedFactorization", dbg_verbosity);
+
+   if( factorization_lag_iterations_ == 0 || IsNull(lag_W_) )
+   {
+      return false;
+   }
+
+   SmartPtr<const SymMatrix> W = IpData().W();
+   SmartPtr<const Matrix> J_c = IpCq().curr_jac_c();
+   SmartPtr<const Matrix> J_d = IpCq().curr_jac_d();
+   SmartPtr<const Matrix> Px_L = IpNLP().Px_L();
+   SmartPtr<const Matrix> Px_U = IpNLP().Px_U();
+   SmartPtr<const Matrix> Pd_L = IpNLP().Pd_L();
+   SmartPtr<const Matrix> Pd_U = IpNLP().Pd_U();
+   SmartPtr<const Vector> z_L = IpData().curr()->z_L();
+   SmartPtr<const Vector> z_U = IpData().curr()->z_U();
+   SmartPtr<const Vector> v_L = IpData().curr()->v_L();
+   SmartPtr<const Vector> v_U = IpData().curr()->v_U();
+   SmartPtr<const Vector> slack_x_L = IpCq().curr_slack_x_L();
+   SmartPtr<const Vector> slack_x_U = IpCq().curr_slack_x_U();
+   SmartPtr<const Vector> slack_s_L = IpCq().curr_slack_s_L();
+   SmartPtr<const Vector> slack_s_U = IpCq().curr_slack_s_U();
+   SmartPtr<const Vector> sigma_x = IpCq().curr_sigma_x();
+   SmartPtr<const Vector> sigma_s = IpCq().curr_sigma_s();
+
+   std::vector<const TaggedObject*> deps(13);
+   deps[0] = GetRawPtr(W);
+   deps[1] = GetRawPtr(J_c);
+   deps[2] = GetRawPtr(J_d);
+   deps[3] = GetRawPtr(z_L);
+   deps[4] = GetRawPtr(z_U);
+   deps[5] = GetRawPtr(v_L);
+   deps[6] = GetRawPtr(v_U);
+   deps[7] = GetRawPtr(slack_x_L);
+   deps[8] = GetRawPtr(slack_x_U);
+   deps[9] = GetRawPtr(slack_s_L);
+   deps[10] = GetRawPtr(slack_s_U);
+   deps[11] = GetRawPtr(sigma_x);
+   deps[12] = GetRawPtr(sigma_s);
+   void* dummy;
+   if( dummy_cache_.GetCachedResult(dummy, deps) )
+   {
+      // the current system has been factorized
+      return false;
+   }
+   bool counted = lagged_cache_.GetCachedResult(dummy, deps);
+   if( !counted && lag_count_ >= factorization_lag_iterations_ )
+   {
+      return false;
+   }
+
+   // the factorization must still be the one of the remembered system
+   std::vector<const TaggedObject*> lag_deps(13);
+   lag_deps[0] = GetRawPtr(lag_W_);
+   lag_deps[1] = GetRawPtr(lag_J_c_);
+   lag_deps[2] = GetRawPtr(lag_J_d_);
+   lag_deps[3] = GetRawPtr(lag_z_L_);
+   lag_deps[4] = GetRawPtr(lag_z_U_);
+   lag_deps[5] = GetRawPtr(lag_v_L_);
+   lag_deps[6] = GetRawPtr(lag_v_U_);
+   lag_deps[7] = GetRawPtr(lag_slack_x_L_);
+   lag_deps[8] = GetRawPtr(lag_slack_x_U_);
+   lag_deps[9] = GetRawPtr(lag_slack_s_L_);
+   lag_deps[10] = GetRawPtr(lag_slack_s_U_);
+   lag_deps[11] = GetRawPtr(lag_sigma_x_);
+   lag_deps[12] = GetRawPtr(lag_sigma_s_);
+   if( !dummy_cache_.GetCachedResult(dummy, lag_deps) || lag_sigma_x_->Dim() != sigma_x->Dim() )
+   {
+      lag_W_ = NULL;
+      return false;
+   }
+
+   // Iterative refinement for the current system, where the steps are
+   // computed with the factorization of the remembered system
+   bool solve_retval = SolveOnce(false, false, *lag_W_, *lag_J_c_, *lag_J_d_, *Px_L, *Px_U, *Pd_L, *Pd_U, *lag_z_L_,
+                                 *lag_z_U_, *lag_v_L_, *lag_v_U_, *lag_slack_x_L_, *lag_slack_x_U_, *lag_slack_s_L_, *lag_slack_s_U_,
+                                 *lag_sigma_x_, *lag_sigma_s_, 1., 0., rhs, res);
+   if( !solve_retval )
+   {
+      return false;
+   }
+   SmartPtr<IteratesVector> resid = res.MakeNewIteratesVector(true);
+   ComputeResiduals(*W, *J_c, *J_d, *Px_L, *Px_U, *Pd_L, *Pd_U, *z_L, *z_U, *v_L, *v_U, *slack_x_L, *slack_x_U,
+                    *slack_s_L, *slack_s_U, *sigma_x, *sigma_s, 1., 0., rhs, res, *resid);
+   Number residual_ratio = ComputeResidualRatio(rhs, res, *resid);
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "residual_ratio with previous factorization = %e\n", residual_ratio);
+
+   Index num_iter_ref = 0;
+   while( num_iter_ref < min_refinement_steps_ || residual_ratio > residual_ratio_max_ )
+   {
+      if( num_iter_ref >= max_refinement_steps_ )
+      {
+         return false;
+      }
+      Number residual_ratio_old = residual_ratio;
+
+      solve_retval = SolveOnce(false, false, *lag_W_, *lag_J_c_, *lag_J_d_, *Px_L, *Px_U, *Pd_L, *Pd_U, *lag_z_L_,
+                               *lag_z_U_, *lag_v_L_, *lag_v_U_, *lag_slack_x_L_, *lag_slack_x_U_, *lag_slack_s_L_, *lag_slack_s_U_,
+                               *lag_sigma_x_, *lag_sigma_s_, -1., 1., *resid, res);
+      if( !solve_retval )
+      {
+         return false;
+      }
+      ComputeResiduals(*W, *J_c, *J_d, *Px_L, *Px_U, *Pd_L, *Pd_U, *z_L, *z_U, *v_L, *v_U, *slack_x_L, *slack_x_U,
+                       *slack_s_L, *slack_s_U, *sigma_x, *sigma_s, 1., 0., rhs, res, *resid);
+      residual_ratio = ComputeResidualRatio(rhs, res, *resid);
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "residual_ratio with previous factorization = %e\n", residual_ratio);
+
+      num_iter_ref++;
+      IpData().WorkCounts().Increase(WorkCounters::REFINEMENT_STEPS);
+      if( residual_ratio > residual_ratio_max_ && residual_ratio > residual_improvement_factor_ * residual_ratio_old )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Refinement with previous factorization stalls, factorizing the system.\n");
+         return false;
+      }
+   }
+
+   if( !counted )
+   {
+      lagged_cache_.AddCachedResult(dummy, deps);
+      lag_count_++;
+   }
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "System solved with the factorization of a previous system (%" IPOPT_INDEX_FORMAT " of %" IPOPT_INDEX_FORMAT ").\n",
+                  lag_count_, factorization_lag_iterations_);
+
+   return true;
+}
+
 void PDFullSpaceSolver::ComputeResiduals(
    const SymMatrix&      W,
    const Matrix&         J_c,
@@ -700,8 +1105,6 @@ void PDFullSpaceSolver::ComputeResiduals(
    Number delta_d;
    perturbHandler_->CurrentPerturbation(delta_x, delta_s, delta_c, delta_d);
 
-   SmartPtr<Vector> tmp;
-
    // x
    W.MultVector(1., *res.x(), 0., *resid.x_NonConst());
    J_c.TransMultVector(1., *res.y_c(), 1., *resid.x_NonConst());
@@ -732,36 +1135,24 @@ void PDFullSpaceSolver::ComputeResiduals(
    }
 
    // zL
-   resid.z_L_NonConst()->Copy(*res.z_L());
-   resid.z_L_NonConst()->ElementWiseMultiply(slack_x_L);
-   tmp = z_L.MakeNew();
-   Px_L.TransMultVector(1., *res.x(), 0., *tmp);
-   tmp->ElementWiseMultiply(z_L);
-   resid.z_L_NonConst()->AddTwoVectors(1., *tmp, -1., *rhs.z_L(), 1.);
+   Px_L.TransMultVector(1., *res.x(), 0., *resid.z_L_NonConst());
+   resid.z_L_NonConst()->ElementWiseMultiply(z_L);
+   resid.z_L_NonConst()->AddVectorProduct(-1., *rhs.z_L(), 1., *res.z_L(), slack_x_L, 1.);
 
    // zU
-   resid.z_U_NonConst()->Copy(*res.z_U());
-   resid.z_U_NonConst()->ElementWiseMultiply(slack_x_U);
-   tmp = z_U.MakeNew();
-   Px_U.TransMultVector(1., *res.x(), 0., *tmp);
-   tmp->ElementWiseMultiply(z_U);
-   resid.z_U_NonConst()->AddTwoVectors(-1., *tmp, -1., *rhs.z_U(), 1.);
+   Px_U.TransMultVector(-1., *res.x(), 0., *resid.z_U_NonConst());
+   resid.z_U_NonConst()->ElementWiseMultiply(z_U);
+   resid.z_U_NonConst()->AddVectorProduct(-1., *rhs.z_U(), 1., *res.z_U(), slack_x_U, 1.);
 
    // vL
-   resid.v_L_NonConst()->Copy(*res.v_L());
-   resid.v_L_NonConst()->ElementWiseMultiply(slack_s_L);
-   tmp = v_L.MakeNew();
-   Pd_L.TransMultVector(1., *res.s(), 0., *tmp);
-   tmp->ElementWiseMultiply(v_L);
-   resid.v_L_NonConst()->AddTwoVectors(1., *tmp, -1., *rhs.v_L(), 1.);
+   Pd_L.TransMultVector(1., *res.s(), 0., *resid.v_L_NonConst());
+   resid.v_L_NonConst()->ElementWiseMultiply(v_L);
+   resid.v_L_NonConst()->AddVectorProduct(-1., *rhs.v_L(), 1., *res.v_L(), slack_s_L, 1.);
 
    // vU
-   resid.v_U_NonConst()->Copy(*res.v_U());
-   resid.v_U_NonConst()->ElementWiseMultiply(slack_s_U);
-   tmp = v_U.MakeNew();
-   Pd_U.TransMultVector(1., *res.s(), 0., *tmp);
-   tmp->ElementWiseMultiply(v_U);
-   resid.v_U_NonConst()->AddTwoVectors(-1., *tmp, -1., *rhs.v_U(), 1.);
+   Pd_U.TransMultVector(-1., *res.s(), 0., *resid.v_U_NonConst());
+   resid.v_U_NonConst()->ElementWiseMultiply(v_U);
+   resid.v_U_NonConst()->AddVectorProduct(-1., *rhs.v_U(), 1., *res.v_U(), slack_s_U, 1.);
 
    DBG_PRINT_VECTOR(2, "resid", resid);
 
@@ -819,4 +1210,19 @@ Number PDFullSpaceSolver::ComputeResidualRatio(
    }
 }
 
+void PDFullSpaceSolver::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   // the state of the linear solver is not written, it starts anew
+   perturbHandler_->WriteCheckpoint(checkpoint);
+}
+
+void PDFullSpaceSolver::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   perturbHandler_->ReadCheckpoint(checkpoint);
+}
+
 } // namespace Ipopt
@@ -26,6 +26,13 @@ namespace Ipopt
  *  to solve the system more accurately (e.g. by increasing the
  *  pivot tolerance).  If that doesn't help or is not possible, we
  *  treat the system, as if it is singular (i.e. increase delta's).
+ *
+ *  If factorization_lag_iterations is positive, a new system is first
+ *  solved by iterative refinement with the factorization of the
+ *  previous system as preconditioner.  The new system is only
+ *  factorized if the refinement does not reach residual_ratio_max or
+ *  stalls, or if the factorization has already been reused for
+ *  factorization_lag_iterations systems.
  */
 class PDFullSpaceSolver: public PDSystemSolver
 {
@@ -61,6 +68,30 @@ public:
       bool                  improve_solution = false
    );
 
+   /** Solve the primal dual system for several right hand sides.
+    *
+    *  All right hand sides are passed to the augmented system solver
+    *  at once.  If allow_inexact is false, iterative refinement is
+    *  afterwards done for each right hand side separately.
+    */
+   virtual bool MultiSolve(
+      Number                                        alpha,
+      Number                                        beta,
+      std::vector<SmartPtr<const IteratesVector> >& rhsV,
+      std::vector<SmartPtr<IteratesVector> >&       resV,
+      bool                                          allow_inexact = false
+   );
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    /** Methods for IpoptType */
    ///@{
    static void RegisterOptions(
@@ -137,8 +168,61 @@ private:
 
    /** Do curvature test with primal regularization */
    bool neg_curv_test_reg_;
+
+   /** Accept solutions based on the backward error reported by the
+    *  linear solver */
+   bool linear_solver_backward_error_;
+
+   /** Maximal number of systems that are solved with the
+    *  factorization of a previous system
+    */
+   Index factorization_lag_iterations_;
+   ///@}
+
+   /** @name System of the most recent factorization, for reusing it
+    *  for later systems
+    */
+   ///@{
+   SmartPtr<const SymMatrix> lag_W_;
+   SmartPtr<const Matrix> lag_J_c_;
+   SmartPtr<const Matrix> lag_J_d_;
+   SmartPtr<const Vector> lag_z_L_;
+   SmartPtr<const Vector> lag_z_U_;
+   SmartPtr<const Vector> lag_v_L_;
+   SmartPtr<const Vector> lag_v_U_;
+   SmartPtr<const Vector> lag_slack_x_L_;
+   SmartPtr<const Vector> lag_slack_x_U_;
+   SmartPtr<const Vector> lag_slack_s_L_;
+   SmartPtr<const Vector> lag_slack_s_U_;
+   SmartPtr<const Vector> lag_sigma_x_;
+   SmartPtr<const Vector> lag_sigma_s_;
+
+   /** Number of systems that have been solved with this factorization */
+   Index lag_count_;
+
+   /** A dummy cache to figure out if the current system has already
+    *  been solved with the factorization of a previous system
+    */
+   CachedResults<void*> lagged_cache_;
    ///@}
 
+   /** Solve the current system by iterative refinement with the
+    *  factorization of a previous system.
+    *
+    *  @return false, if the factorization cannot be reused or the
+    *  refinement does not give a sufficiently accurate solution
+    */
+   bool SolveWithLaggedFactorization(
+      const IteratesVector& rhs,
+      IteratesVector&       res
+   );
+
+   /** Check whether the linear solver reports a backward error of the
+    *  most recent solve that is small enough to accept the solution
+    *  without computing the residuals.
+    */
+   bool BackwardErrorAcceptable() const;
+
    /** Internal function for a single backsolve (which will be used
     *  for iterative refinement on the outside).
     *
@@ -172,6 +256,37 @@ private:
       IteratesVector&       res
    );
 
+   /** Like SolveOnce, but for several right hand sides.
+    *
+    *  If the matrix needs to be factorized, the solution for the first
+    *  right hand side is used in the inertia heuristic.
+    */
+   bool MultiSolveOnce(
+      bool                                                resolve_unmodified,
+      bool                                                pretend_singular,
+      const SymMatrix&                                    W,
+      const Matrix&                                       J_c,
+      const Matrix&                                       J_d,
+      const Matrix&                                       Px_L,
+      const Matrix&                                       Px_U,
+      const Matrix&                                       Pd_L,
+      const Matrix&                                       Pd_U,
+      const Vector&                                       z_L,
+      const Vector&                                       z_U,
+      const Vector&                                       v_L,
+      const Vector&                                       v_U,
+      const Vector&                                       slack_x_L,
+      const Vector&                                       slack_x_U,
+      const Vector&                                       slack_s_L,
+      const Vector&                                       slack_s_U,
+      const Vector&                                       sigma_x,
+      const Vector&                                       sigma_s,
+      Number                                              alpha,
+      Number                                              beta,
+      const std::vector<SmartPtr<const IteratesVector> >& rhsV,
+      std::vector<SmartPtr<IteratesVector> >&             resV
+   );
+
    /** Internal function for computing the residual (resid) given the
     * right hand side (rhs) and the solution of the system (res).
     */
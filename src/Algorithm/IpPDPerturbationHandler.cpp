@@ -5,6 +5,7 @@
 // Authors:  Carl Laird, Andreas Waechter              IBM    2005-08-04
 
 #include "IpPDPerturbationHandler.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 
@@ -14,9 +15,23 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Number of successful perturbations kept for perturb_inertia_prediction */
+static const std::size_t perturb_history_length = 5;
+
 PDPerturbationHandler::PDPerturbationHandler()
-   : reset_last_(false),
-     degen_iters_max_(3)
+   : delta_x_last_increased_(false),
+     delta_x_curr_increased_(false),
+     excess_neg_evals_curr_(-1),
+     delta_x_prev_(0.),
+     excess_neg_evals_prev_(-1),
+     first_excess_neg_evals_(-1),
+     perturbed_matrices_(0),
+     skipped_unperturbed_(0),
+     predicted_start_(false),
+     reset_last_(false),
+     degen_iters_max_(3),
+     perturb_inertia_extrapolation_(false),
+     perturb_inertia_prediction_(PREDICT_NONE)
 {
 }
 
@@ -99,6 +114,36 @@ void PDPerturbationHandler::RegisterOptions(
       "yes", "always use perturbation",
       "This options makes the delta_c and delta_d perturbation be used for the computation of every search direction. "
       "Usually, it is only used when the iteration matrix is singular.");
+   roptions->AddStringOption2(
+      "perturb_inertia_extrapolation",
+      "Whether to estimate the x-s perturbation from the inertia of previous trials.",
+      "no",
+      "no", "increase the perturbation by perturb_inc_fact",
+      "yes", "extrapolate the required perturbation",
+      "If enabled, the number of excess negative eigenvalues of the last two trial factorizations for a matrix "
+      "is assumed to decrease linearly in the logarithm of the perturbation, and the perturbation is increased "
+      "directly to the value where this model predicts the correct inertia. "
+      "The increase factor is at least perturb_inc_fact and at most perturb_inc_fact_first. "
+      "If the count did not decrease, the perturbation is increased by perturb_inc_fact squared. "
+      "Further, if the perturbation had to be increased for the previous matrix, the first trial value for "
+      "the next matrix is the previous perturbation instead of the decreased one. "
+      "This aims at reducing the number of factorizations for nonconvex problems.");
+   roptions->AddStringOption3(
+      "perturb_inertia_prediction",
+      "Whether to predict the first x-s perturbation of a matrix from previous successful perturbations.",
+      "no",
+      "no", "start from the decreased previous perturbation",
+      "history", "start from a perturbation that was sufficient for recent matrices",
+      "history-skip", "as history, and skip the unperturbed factorization while it keeps failing",
+      "If not \"no\", the final x-s perturbations of the last five matrices with wrong inertia are kept "
+      "together with the excess of negative eigenvalues of their unperturbed factorization. "
+      "The first trial perturbation for a matrix with wrong inertia is then the smallest kept perturbation "
+      "whose matrix had at least as many excess negative eigenvalues, or the largest kept perturbation if there is none, "
+      "but at most perturb_dec_fact times the perturbation of the previous matrix. "
+      "With \"history-skip\", the factorization of the unperturbed matrix is skipped and the predicted "
+      "perturbation is tried first if the last five matrices all had the wrong inertia without perturbation. "
+      "Every sixth matrix is still factorized without perturbation to detect when the perturbation is no longer required. "
+      "This aims at reducing the number of factorizations for nonconvex problems.");
 }
 
 bool PDPerturbationHandler::InitializeImpl(
@@ -115,26 +160,58 @@ bool PDPerturbationHandler::InitializeImpl(
    options.GetNumericValue("jacobian_regularization_value", delta_cd_val_, prefix);
    options.GetNumericValue("jacobian_regularization_exponent", delta_cd_exp_, prefix);
    options.GetBoolValue("perturb_always_cd", perturb_always_cd_, prefix);
-
-   hess_degenerate_ = NOT_YET_DETERMINED;
-   if( !perturb_always_cd_ )
+   options.GetBoolValue("perturb_inertia_extrapolation", perturb_inertia_extrapolation_, prefix);
+   Index enum_int;
+   options.GetEnumValue("perturb_inertia_prediction", enum_int, prefix);
+   perturb_inertia_prediction_ = PredictionType(enum_int);
+
+   // keep the information from a previous solve if requested
+   bool keep_state = false;
+   if( prefix != "resto." )
    {
-      jac_degenerate_ = NOT_YET_DETERMINED;
+      // The following options are registered by OrigIpoptNLP
+      bool warm_start_same_structure;
+      options.GetBoolValue("warm_start_keep_state", keep_state, prefix);
+      options.GetBoolValue("warm_start_same_structure", warm_start_same_structure, prefix);
+      keep_state = keep_state && warm_start_same_structure;
    }
-   else
+
+   if( !keep_state )
    {
-      jac_degenerate_ = NOT_DEGENERATE;
+      hess_degenerate_ = NOT_YET_DETERMINED;
+      if( !perturb_always_cd_ )
+      {
+         jac_degenerate_ = NOT_YET_DETERMINED;
+      }
+      else
+      {
+         jac_degenerate_ = NOT_DEGENERATE;
+      }
+      degen_iters_ = 0;
+
+      delta_x_last_ = 0.;
+      delta_s_last_ = 0.;
+      delta_c_last_ = 0.;
+      delta_d_last_ = 0.;
+      delta_x_last_increased_ = false;
+
+      history_delta_x_.clear();
+      history_excess_neg_evals_.clear();
+      perturbed_matrices_ = 0;
+      skipped_unperturbed_ = 0;
    }
-   degen_iters_ = 0;
 
    delta_x_curr_ = 0.;
    delta_s_curr_ = 0.;
    delta_c_curr_ = 0.;
    delta_d_curr_ = 0.;
-   delta_x_last_ = 0.;
-   delta_s_last_ = 0.;
-   delta_c_last_ = 0.;
-   delta_d_last_ = 0.;
+   delta_x_curr_increased_ = false;
+
+   excess_neg_evals_curr_ = -1;
+   delta_x_prev_ = 0.;
+   excess_neg_evals_prev_ = -1;
+   first_excess_neg_evals_ = -1;
+   predicted_start_ = false;
 
    test_status_ = NO_TEST;
 
@@ -154,6 +231,11 @@ bool PDPerturbationHandler::ConsiderNewSystem(
    // structurally degenerate
    finalize_test();
 
+   if( perturb_inertia_prediction_ != PREDICT_NONE )
+   {
+      RecordPerturbation();
+   }
+
    // Store the perturbation from the previous matrix
    if( reset_last_ )
    {
@@ -161,12 +243,14 @@ bool PDPerturbationHandler::ConsiderNewSystem(
       delta_s_last_ = delta_s_curr_;
       delta_c_last_ = delta_c_curr_;
       delta_d_last_ = delta_d_curr_;
+      delta_x_last_increased_ = delta_x_curr_increased_;
    }
    else
    {
       if( delta_x_curr_ > 0. )
       {
          delta_x_last_ = delta_x_curr_;
+         delta_x_last_increased_ = delta_x_curr_increased_;
       }
       if( delta_s_curr_ > 0. )
       {
@@ -226,10 +310,25 @@ bool PDPerturbationHandler::ConsiderNewSystem(
          return false;
       }
    }
+   else if( perturb_inertia_prediction_ == PREDICT_HISTORY_SKIP && test_status_ == NO_TEST
+            && perturbed_matrices_ >= (Index) perturb_history_length
+            && skipped_unperturbed_ < (Index) perturb_history_length )
+   {
+      // the recent matrices all required a perturbation, so try the
+      // predicted one without factorizing the unperturbed matrix
+      delta_x = PredictDeltaX(-1);
+      delta_s = delta_x;
+      skipped_unperturbed_++;
+      predicted_start_ = true;
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Skipping unperturbed factorization, trying predicted delta_x = %e first\n", delta_x);
+   }
    else
    {
       delta_x = 0.;
       delta_s = delta_x;
+      skipped_unperturbed_ = 0;
+      predicted_start_ = false;
    }
 
    delta_x_curr_ = delta_x;
@@ -241,6 +340,12 @@ bool PDPerturbationHandler::ConsiderNewSystem(
 
    get_deltas_for_wrong_inertia_called_ = false;
 
+   delta_x_curr_increased_ = false;
+   excess_neg_evals_curr_ = -1;
+   delta_x_prev_ = 0.;
+   excess_neg_evals_prev_ = -1;
+   first_excess_neg_evals_ = -1;
+
    return true;
 }
 
@@ -374,10 +479,24 @@ bool PDPerturbationHandler::get_deltas_for_wrong_inertia(
 {
    if( delta_x_curr_ == 0. )
    {
-      if( delta_x_last_ == 0. )
+      first_excess_neg_evals_ = excess_neg_evals_curr_;
+      if( perturb_inertia_prediction_ != PREDICT_NONE && !history_delta_x_.empty() )
+      {
+         delta_x_curr_ = PredictDeltaX(first_excess_neg_evals_);
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Predicted delta_x = %e for excess negative eigenvalues %" IPOPT_INDEX_FORMAT "\n", delta_x_curr_,
+                        first_excess_neg_evals_);
+      }
+      else if( delta_x_last_ == 0. )
       {
          delta_x_curr_ = delta_xs_init_;
       }
+      else if( perturb_inertia_extrapolation_ && delta_x_last_increased_ )
+      {
+         // the decreased value was not sufficient for the previous matrix,
+         // so it is likely not sufficient for this one either
+         delta_x_curr_ = Max(delta_xs_min_, delta_x_last_);
+      }
       else
       {
          delta_x_curr_ = Max(delta_xs_min_, delta_x_last_ * delta_xs_dec_fact_);
@@ -385,15 +504,38 @@ bool PDPerturbationHandler::get_deltas_for_wrong_inertia(
    }
    else
    {
+      Number inc_fact;
       if( delta_x_last_ == 0. || 1e5 * delta_x_last_ < delta_x_curr_ )
       {
-         delta_x_curr_ = delta_xs_first_inc_fact_ * delta_x_curr_;
+         inc_fact = delta_xs_first_inc_fact_;
       }
       else
       {
-         delta_x_curr_ = delta_xs_inc_fact_ * delta_x_curr_;
+         inc_fact = delta_xs_inc_fact_;
+         if( perturb_inertia_extrapolation_ && excess_neg_evals_curr_ > 0 && excess_neg_evals_prev_ > 0 )
+         {
+            if( excess_neg_evals_curr_ < excess_neg_evals_prev_ )
+            {
+               // extrapolate the excess linearly in log(delta_x) to zero
+               inc_fact = pow(delta_x_curr_ / delta_x_prev_,
+                              Number(excess_neg_evals_curr_) / Number(excess_neg_evals_prev_ - excess_neg_evals_curr_));
+            }
+            else
+            {
+               inc_fact = delta_xs_inc_fact_ * delta_xs_inc_fact_;
+            }
+            inc_fact = Max(delta_xs_inc_fact_, Min(inc_fact, delta_xs_first_inc_fact_));
+            Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                           "Excess negative eigenvalues %" IPOPT_INDEX_FORMAT " (previously %" IPOPT_INDEX_FORMAT "), increasing delta_x by %e\n",
+                           excess_neg_evals_curr_, excess_neg_evals_prev_, inc_fact);
+         }
       }
+      delta_x_prev_ = delta_x_curr_;
+      excess_neg_evals_prev_ = excess_neg_evals_curr_;
+      delta_x_curr_ = inc_fact * delta_x_curr_;
+      delta_x_curr_increased_ = true;
    }
+   excess_neg_evals_curr_ = -1;
    if( delta_x_curr_ > delta_xs_max_ )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
@@ -451,6 +593,13 @@ bool PDPerturbationHandler::PerturbForWrongInertia(
    return retval;
 }
 
+void PDPerturbationHandler::SetExcessNegEVals(
+   Index excess_neg_evals
+)
+{
+   excess_neg_evals_curr_ = excess_neg_evals;
+}
+
 void PDPerturbationHandler::CurrentPerturbation(
    Number& delta_x,
    Number& delta_s,
@@ -469,6 +618,67 @@ Number PDPerturbationHandler::delta_cd()
    return delta_cd_val_ * pow(IpData().curr_mu(), delta_cd_exp_);
 }
 
+void PDPerturbationHandler::RecordPerturbation()
+{
+   if( !get_deltas_for_wrong_inertia_called_ && !predicted_start_ )
+   {
+      // the unperturbed matrix had the correct inertia (or this is the first matrix)
+      perturbed_matrices_ = 0;
+      return;
+   }
+   if( hess_degenerate_ == DEGENERATE || delta_x_curr_ == 0. || delta_x_curr_ > delta_xs_max_ )
+   {
+      return;
+   }
+
+   history_delta_x_.push_back(delta_x_curr_);
+   history_excess_neg_evals_.push_back(predicted_start_ ? -1 : first_excess_neg_evals_);
+   if( history_delta_x_.size() > perturb_history_length )
+   {
+      history_delta_x_.pop_front();
+      history_excess_neg_evals_.pop_front();
+   }
+   if( !predicted_start_ )
+   {
+      perturbed_matrices_++;
+   }
+}
+
+Number PDPerturbationHandler::PredictDeltaX(
+   Index excess_neg_evals
+) const
+{
+   DBG_ASSERT(!history_delta_x_.empty());
+
+   // smallest perturbation that was sufficient for a matrix with at
+   // least as many excess negative eigenvalues
+   Number delta_x = -1.;
+   if( excess_neg_evals > 0 )
+   {
+      for( std::size_t i = 0; i < history_delta_x_.size(); i++ )
+      {
+         if( history_excess_neg_evals_[i] >= excess_neg_evals && (delta_x < 0. || history_delta_x_[i] < delta_x) )
+         {
+            delta_x = history_delta_x_[i];
+         }
+      }
+   }
+   if( delta_x < 0. )
+   {
+      for( std::size_t i = 0; i < history_delta_x_.size(); i++ )
+      {
+         delta_x = Max(delta_x, history_delta_x_[i]);
+      }
+   }
+   // the history also contains predicted values, so that the
+   // prediction has to be able to decay as in the regular strategy
+   if( delta_x_last_ > 0. )
+   {
+      delta_x = Min(delta_x, delta_x_last_ * delta_xs_dec_fact_);
+   }
+   return Max(delta_xs_min_, delta_x);
+}
+
 void PDPerturbationHandler::finalize_test()
 {
    switch( test_status_ )
@@ -539,4 +749,76 @@ void PDPerturbationHandler::finalize_test()
    }
 }
 
+void PDPerturbationHandler::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   checkpoint.WriteSection("PDPerturbationHandler");
+   checkpoint.WriteNumber(delta_x_last_);
+   checkpoint.WriteNumber(delta_s_last_);
+   checkpoint.WriteNumber(delta_c_last_);
+   checkpoint.WriteNumber(delta_d_last_);
+   checkpoint.WriteBool(delta_x_last_increased_);
+   checkpoint.WriteNumber(delta_x_curr_);
+   checkpoint.WriteNumber(delta_s_curr_);
+   checkpoint.WriteNumber(delta_c_curr_);
+   checkpoint.WriteNumber(delta_d_curr_);
+   checkpoint.WriteBool(delta_x_curr_increased_);
+   checkpoint.WriteIndex(excess_neg_evals_curr_);
+   checkpoint.WriteNumber(delta_x_prev_);
+   checkpoint.WriteIndex(excess_neg_evals_prev_);
+   checkpoint.WriteBool(get_deltas_for_wrong_inertia_called_);
+   checkpoint.WriteIndex((Index) history_delta_x_.size());
+   for( std::size_t i = 0; i < history_delta_x_.size(); i++ )
+   {
+      checkpoint.WriteNumber(history_delta_x_[i]);
+      checkpoint.WriteIndex(history_excess_neg_evals_[i]);
+   }
+   checkpoint.WriteIndex(first_excess_neg_evals_);
+   checkpoint.WriteIndex(perturbed_matrices_);
+   checkpoint.WriteIndex(skipped_unperturbed_);
+   checkpoint.WriteBool(predicted_start_);
+   checkpoint.WriteIndex(hess_degenerate_);
+   checkpoint.WriteIndex(jac_degenerate_);
+   checkpoint.WriteIndex(degen_iters_);
+   checkpoint.WriteIndex(test_status_);
+}
+
+void PDPerturbationHandler::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("PDPerturbationHandler");
+   delta_x_last_ = checkpoint.ReadNumber();
+   delta_s_last_ = checkpoint.ReadNumber();
+   delta_c_last_ = checkpoint.ReadNumber();
+   delta_d_last_ = checkpoint.ReadNumber();
+   delta_x_last_increased_ = checkpoint.ReadBool();
+   delta_x_curr_ = checkpoint.ReadNumber();
+   delta_s_curr_ = checkpoint.ReadNumber();
+   delta_c_curr_ = checkpoint.ReadNumber();
+   delta_d_curr_ = checkpoint.ReadNumber();
+   delta_x_curr_increased_ = checkpoint.ReadBool();
+   excess_neg_evals_curr_ = checkpoint.ReadIndex();
+   delta_x_prev_ = checkpoint.ReadNumber();
+   excess_neg_evals_prev_ = checkpoint.ReadIndex();
+   get_deltas_for_wrong_inertia_called_ = checkpoint.ReadBool();
+   history_delta_x_.clear();
+   history_excess_neg_evals_.clear();
+   Index history_size = checkpoint.ReadIndex();
+   for( Index i = 0; i < history_size; i++ )
+   {
+      history_delta_x_.push_back(checkpoint.ReadNumber());
+      history_excess_neg_evals_.push_back(checkpoint.ReadIndex());
+   }
+   first_excess_neg_evals_ = checkpoint.ReadIndex();
+   perturbed_matrices_ = checkpoint.ReadIndex();
+   skipped_unperturbed_ = checkpoint.ReadIndex();
+   predicted_start_ = checkpoint.ReadBool();
+   hess_degenerate_ = DegenType(checkpoint.ReadIndex());
+   jac_degenerate_ = DegenType(checkpoint.ReadIndex());
+   degen_iters_ = checkpoint.ReadIndex();
+   test_status_ = TrialStatus(checkpoint.ReadIndex());
+}
+
 } // namespace Ipopt
@@ -9,6 +9,8 @@
 
 #include "IpAlgStrategy.hpp"
 
+#include <deque>
+
 namespace Ipopt
 {
 
@@ -79,6 +81,17 @@ public:
       Number& delta_c,
       Number& delta_d);
 
+   /** Tell the handler by how many the number of negative eigenvalues
+    *  of the most recent factorization exceeded the required number.
+    *
+    *  This is optional and has to be called before PerturbForWrongInertia.
+    *  It is used by the perturb_inertia_extrapolation and
+    *  perturb_inertia_prediction strategies only.
+    */
+   virtual void SetExcessNegEVals(
+      Index excess_neg_evals
+   );
+
    /** Just return the perturbation values that have been determined
     *  most recently.
     */
@@ -89,6 +102,16 @@ public:
       Number& delta_d
    );
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    static void RegisterOptions(
       SmartPtr<RegisteredOptions> roptions
    );
@@ -125,6 +148,9 @@ protected:
    Number delta_c_last_;
    /** The last nonzero value for delta_d */
    Number delta_d_last_;
+   /** Flag indicating whether the last nonzero delta_x had to be
+    *  increased from the first trial value for its matrix. */
+   bool delta_x_last_increased_;
    ///@}
 
    /** @name Size of the most recently suggested perturbation for the
@@ -139,6 +165,19 @@ protected:
    Number delta_c_curr_;
    /** The current value for delta_d */
    Number delta_d_curr_;
+   /** Flag indicating whether delta_x has been increased for the current matrix. */
+   bool delta_x_curr_increased_;
+   ///@}
+
+   /** @name Inertia information for the current matrix. */
+   ///@{
+   /** Excess of negative eigenvalues for the most recent trial
+    *  delta_x, or -1 if unknown. */
+   Index excess_neg_evals_curr_;
+   /** Previous positive trial value for delta_x for the current matrix. */
+   Number delta_x_prev_;
+   /** Excess of negative eigenvalues for delta_x_prev_, or -1 if unknown. */
+   Index excess_neg_evals_prev_;
    ///@}
 
    /** Flag indicating if for the given matrix the perturb for wrong
@@ -146,6 +185,30 @@ protected:
     */
    bool get_deltas_for_wrong_inertia_called_;
 
+   /** @name History of successful perturbations for
+    *  perturb_inertia_prediction. */
+   ///@{
+   /** Final delta_x of the most recent matrices that required a
+    *  perturbation, oldest first. */
+   std::deque<Number> history_delta_x_;
+   /** Excess of negative eigenvalues of the unperturbed matrix for
+    *  each entry of history_delta_x_, or -1 if unknown. */
+   std::deque<Index> history_excess_neg_evals_;
+   /** Excess of negative eigenvalues of the unperturbed current
+    *  matrix, or -1 if unknown. */
+   Index first_excess_neg_evals_;
+   /** Number of consecutive matrices whose unperturbed factorization
+    *  had the wrong inertia. */
+   Index perturbed_matrices_;
+   /** Number of matrices since the last unperturbed trial
+    *  factorization for which the first trial was the predicted
+    *  perturbation. */
+   Index skipped_unperturbed_;
+   /** Flag indicating whether the first trial for the current matrix
+    *  was the predicted perturbation. */
+   bool predicted_start_;
+   ///@}
+
    /** @name Handling structural degeneracy */
    ///@{
    /** Type for degeneracy flags */
@@ -217,6 +280,19 @@ protected:
     *  always be used.
     */
    bool perturb_always_cd_;
+   /** Flag indicating whether the increase of delta_x should be
+    *  estimated from the number of excess negative eigenvalues.
+    */
+   bool perturb_inertia_extrapolation_;
+   /** Strategies for the first trial perturbation of a matrix */
+   enum PredictionType
+   {
+      PREDICT_NONE = 0,
+      PREDICT_HISTORY,
+      PREDICT_HISTORY_SKIP
+   };
+   /** Strategy for the first trial perturbation of a matrix */
+   PredictionType perturb_inertia_prediction_;
    ///@}
 
    /** @name Auxiliary methods */
@@ -242,6 +318,20 @@ protected:
 
    /** Compute perturbation value for constraints */
    Number delta_cd();
+
+   /** Add the perturbation of the previous matrix to the history of
+    *  successful perturbations. */
+   void RecordPerturbation();
+
+   /** Predict the delta_x that corrects the inertia of a matrix from
+    *  the history of successful perturbations.
+    *
+    *  @param excess_neg_evals excess of negative eigenvalues of the
+    *         unperturbed matrix, or -1 if unknown.
+    */
+   Number PredictDeltaX(
+      Index excess_neg_evals
+   ) const;
    ///@}
 
 };
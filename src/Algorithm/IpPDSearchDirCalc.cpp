@@ -6,6 +6,7 @@
 //               derived from IpIpoptAlg.cpp
 
 #include "IpPDSearchDirCalc.hpp"
+#include "IpCheckpoint.hpp"
 
 namespace Ipopt
 {
@@ -121,6 +122,12 @@ bool PDSearchDirCalculator::ComputeSearchDirection()
 
       DBG_PRINT_VECTOR(2, "rhs", *rhs);
 
+      if( !improve_solution && IpData().LowMemoryMode() )
+      {
+         // the direction of the previous iteration is no longer needed
+         IpData().ReleaseDelta();
+      }
+
       // Get space for the search direction
       SmartPtr<IteratesVector> delta = IpData().curr()->MakeNewIteratesVector(true);
 
@@ -141,4 +148,18 @@ bool PDSearchDirCalculator::ComputeSearchDirection()
    return retval;
 }
 
+void PDSearchDirCalculator::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   pd_solver_->WriteCheckpoint(checkpoint);
+}
+
+void PDSearchDirCalculator::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   pd_solver_->ReadCheckpoint(checkpoint);
+}
+
 } // namespace Ipopt
@@ -42,12 +42,22 @@ public:
     */
    virtual bool ComputeSearchDirection();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    static void RegisterOptions(
       const SmartPtr<RegisteredOptions>& roptions
    );
 
    /** Returns the pd_solver for additional processing. */
-   SmartPtr<PDSystemSolver> PDSolver()
+   virtual SmartPtr<PDSystemSolver> PDSolver()
    {
       return pd_solver_;
    }
@@ -12,6 +12,8 @@
 #include "IpAlgStrategy.hpp"
 #include "IpIteratesVector.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 
@@ -114,6 +116,40 @@ public:
       bool                  improve_solution = false
    ) = 0;
 
+   /** Solve the primal dual system for several right hand sides.
+    *
+    *  This is equivalent to calling Solve (with improve_solution
+    *  false) for each pair rhsV[i] and resV[i], but an implementation
+    *  can pass all right hand sides to the linear solver at once.
+    *  The inheriting class does not need to overload this method;
+    *  the default implementation solves for one right hand side after
+    *  the other.
+    *
+    *  @return false, if a solution could not be computed for one of
+    *  the right hand sides
+    */
+   virtual bool MultiSolve(
+      Number                                        alpha,
+      Number                                        beta,
+      std::vector<SmartPtr<const IteratesVector> >& rhsV,
+      std::vector<SmartPtr<IteratesVector> >&       resV,
+      bool                                          allow_inexact = false
+   )
+   {
+      Index nrhs = (Index) rhsV.size();
+      DBG_ASSERT(nrhs > 0);
+      DBG_ASSERT(nrhs == (Index)resV.size());
+
+      for( Index i = 0; i < nrhs; i++ )
+      {
+         if( !Solve(alpha, beta, *rhsV[i], *resV[i], allow_inexact) )
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -0,0 +1,352 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpPartitionedQuasiNewtonUpdater.hpp"
+#include "IpRestoIpoptNLP.hpp"
+#include "IpDenseVector.hpp"
+#include "IpCompoundVector.hpp"
+#include "IpSymTMatrix.hpp"
+
+#include <cmath>
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+PartitionedQuasiNewtonUpdater::PartitionedQuasiNewtonUpdater(
+   bool update_for_resto
+)
+   : update_for_resto_(update_for_resto)
+{ }
+
+void PartitionedQuasiNewtonUpdater::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddStringOption2(
+      "partitioned_update_type",
+      "Quasi-Newton update formula for the partitioned approximation.",
+      "bfgs",
+      "bfgs", "damped BFGS update",
+      "sr1", "SR1 update (with skipping)",
+      "Determines which update formula is applied to the Hessian of each element function "
+      "if hessian_approximation is \"partitioned\". "
+      "The BFGS update uses Powell's damping, so that the element Hessians stay positive definite "
+      "also if an element function is not convex. "
+      "The SR1 update can capture negative curvature, but is skipped if its denominator is too small.");
+   roptions->AddLowerBoundedNumberOption(
+      "partitioned_init_val",
+      "Value for the initial element Hessians in the partitioned approximation.",
+      0., true,
+      1.,
+      "The Hessian of each element function is initialized to this multiple of the identity. "
+      "At the first update of an element with positive curvature, it is rescaled by y^Ty/s^Ty.");
+}
+
+bool PartitionedQuasiNewtonUpdater::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   Index enum_int;
+   options.GetEnumValue("partitioned_update_type", enum_int, prefix);
+   partitioned_update_type_ = PartitionedUpdateType(enum_int);
+   options.GetNumericValue("partitioned_init_val", partitioned_init_val_, prefix);
+
+   elem_start_.clear();
+   elem_vars_.clear();
+   elem_hess_.clear();
+   elem_scaled_.clear();
+   last_x_ = NULL;
+
+   return true;
+}
+
+void PartitionedQuasiNewtonUpdater::UpdateHessian()
+{
+   DBG_START_METH("PartitionedQuasiNewtonUpdater::UpdateHessian",
+                  dbg_verbosity);
+
+   // In the restoration phase, the constraint part of the Hessian of
+   // the original problem is approximated
+   IpoptNLP* nlp;
+   SmartPtr<const Vector> curr_x;
+   SmartPtr<const Vector> curr_y_c;
+   SmartPtr<const Vector> curr_y_d;
+   Number obj_factor;
+   if( update_for_resto_ )
+   {
+      RestoIpoptNLP* resto_nlp = static_cast<RestoIpoptNLP*>(&IpNLP());
+      DBG_ASSERT(dynamic_cast<RestoIpoptNLP*>(&IpNLP()));
+      nlp = &resto_nlp->OrigIpNLP();
+      const CompoundVector* cv = static_cast<const CompoundVector*>(GetRawPtr(IpData().curr()->x()));
+      DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(IpData().curr()->x())));
+      curr_x = cv->GetComp(0);
+      cv = static_cast<const CompoundVector*>(GetRawPtr(IpData().curr()->y_c()));
+      DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(IpData().curr()->y_c())));
+      curr_y_c = cv->GetComp(0);
+      cv = static_cast<const CompoundVector*>(GetRawPtr(IpData().curr()->y_d()));
+      DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(IpData().curr()->y_d())));
+      curr_y_d = cv->GetComp(0);
+      obj_factor = 0.;
+   }
+   else
+   {
+      nlp = &IpNLP();
+      curr_x = IpData().curr()->x();
+      curr_y_c = IpData().curr()->y_c();
+      curr_y_d = IpData().curr()->y_d();
+      obj_factor = 1.;
+   }
+
+   // If this is the first call, get the element functions
+   if( elem_start_.empty() )
+   {
+      bool retval = nlp->GetElementFunctions(elem_start_, elem_vars_);
+      ASSERT_EXCEPTION(retval, OPTION_INVALID,
+                       "Partitioned quasi-Newton option chosen, but NLP doesn't provide element functions.");
+      ASSERT_EXCEPTION(dynamic_cast<const SymTMatrixSpace*>(GetRawPtr(nlp->HessianMatrixSpace())) != NULL,
+                       OPTION_INVALID,
+                       "Partitioned quasi-Newton option chosen, but NLP doesn't provide SymTMatrixSpace.");
+      Index nnz = 0;
+      for( Index e = 0; e < (Index) elem_start_.size() - 1; e++ )
+      {
+         Index n_e = elem_start_[e + 1] - elem_start_[e];
+         nnz += n_e * (n_e + 1) / 2;
+      }
+      elem_hess_.resize(nnz);
+   }
+   const Index n_elements = (Index) elem_start_.size() - 1;
+
+   // If there is no previous iterate, start with multiples of the
+   // identity
+   if( IsNull(last_x_) )
+   {
+      Jnlst().Printf(J_DETAILED, J_HESSIAN_APPROXIMATION,
+                     "Partitioned approximation started for %" IPOPT_INDEX_FORMAT " element functions; store data at current iterate.\n",
+                     n_elements);
+      Index pos = 0;
+      for( Index e = 0; e < n_elements; e++ )
+      {
+         Index n_e = elem_start_[e + 1] - elem_start_[e];
+         for( Index i = 0; i < n_e; i++ )
+         {
+            for( Index j = 0; j <= i; j++ )
+            {
+               elem_hess_[pos++] = i == j ? partitioned_init_val_ : 0.;
+            }
+         }
+      }
+      elem_scaled_.assign(n_elements, false);
+      last_x_ = curr_x;
+      SetW();
+      return;
+   }
+
+   // s = x_k - x_{k-1}
+   SmartPtr<Vector> s = curr_x->MakeNewCopy();
+   s->Axpy(-1., *last_x_);
+
+   // y_e = grad_lag_e(x_k,y_k) - grad_lag_e(x_{k-1},y_k)
+   SmartPtr<const Vector> curr_grad = nlp->element_gradients(*curr_x, obj_factor, *curr_y_c, *curr_y_d);
+   SmartPtr<const Vector> last_grad = nlp->element_gradients(*last_x_, obj_factor, *curr_y_c, *curr_y_d);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(GetRawPtr(s)));
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(GetRawPtr(curr_grad)));
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(GetRawPtr(last_grad)));
+   const Number* s_vals = static_cast<const DenseVector*>(GetRawPtr(s))->ExpandedValues();
+   const Number* curr_grad_vals = static_cast<const DenseVector*>(GetRawPtr(curr_grad))->ExpandedValues();
+   const Number* last_grad_vals = static_cast<const DenseVector*>(GetRawPtr(last_grad))->ExpandedValues();
+
+   std::vector<Number> s_e;
+   std::vector<Number> y_e;
+   Index pos = 0;
+   Index n_skipped = 0;
+   for( Index e = 0; e < n_elements; e++ )
+   {
+      Index n_e = elem_start_[e + 1] - elem_start_[e];
+      if( n_e == 0 )
+      {
+         continue;
+      }
+      s_e.resize(n_e);
+      y_e.resize(n_e);
+      for( Index i = 0; i < n_e; i++ )
+      {
+         Index k = elem_start_[e] + i;
+         s_e[i] = s_vals[elem_vars_[k]];
+         y_e[i] = curr_grad_vals[k] - last_grad_vals[k];
+      }
+      if( UpdateElement(&elem_hess_[pos], n_e, &s_e[0], &y_e[0], !elem_scaled_[e]) )
+      {
+         elem_scaled_[e] = true;
+      }
+      else
+      {
+         n_skipped++;
+      }
+      pos += n_e * (n_e + 1) / 2;
+   }
+   DBG_ASSERT(pos == (Index) elem_hess_.size());
+
+   Jnlst().Printf(J_DETAILED, J_HESSIAN_APPROXIMATION,
+                  "Partitioned update skipped for %" IPOPT_INDEX_FORMAT " of %" IPOPT_INDEX_FORMAT " element functions.\n", n_skipped, n_elements);
+   if( n_skipped == n_elements )
+   {
+      IpData().Append_info_string("Ws");
+   }
+
+   last_x_ = curr_x;
+   SetW();
+}
+
+bool PartitionedQuasiNewtonUpdater::UpdateElement(
+   Number*       B,
+   Index         n_e,
+   const Number* s,
+   const Number* y,
+   bool          first
+)
+{
+   Number sTs = 0.;
+   Number sTy = 0.;
+   Number yTy = 0.;
+   for( Index i = 0; i < n_e; i++ )
+   {
+      sTs += s[i] * s[i];
+      sTy += s[i] * y[i];
+      yTy += y[i] * y[i];
+   }
+   if( sTs == 0. )
+   {
+      // the element function does not depend on the step
+      return false;
+   }
+
+   // Rescale the initial matrix as in the limited-memory update
+   if( first && sTy > 0. )
+   {
+      Number sigma = yTy / sTy;
+      Index pos = 0;
+      for( Index i = 0; i < n_e; i++ )
+      {
+         for( Index j = 0; j <= i; j++ )
+         {
+            B[pos++] = i == j ? sigma : 0.;
+         }
+      }
+   }
+
+   // Bs = B*s, where B is the packed lower triangle
+   std::vector<Number> Bs(n_e, 0.);
+   Index pos = 0;
+   for( Index i = 0; i < n_e; i++ )
+   {
+      for( Index j = 0; j < i; j++ )
+      {
+         Bs[i] += B[pos] * s[j];
+         Bs[j] += B[pos] * s[i];
+         pos++;
+      }
+      Bs[i] += B[pos] * s[i];
+      pos++;
+   }
+   Number sBs = 0.;
+   for( Index i = 0; i < n_e; i++ )
+   {
+      sBs += s[i] * Bs[i];
+   }
+
+   std::vector<Number> v(n_e);
+   if( partitioned_update_type_ == BFGS )
+   {
+      if( sBs <= 0. )
+      {
+         return false;
+      }
+      // Powell's damping: r = theta*y + (1-theta)*Bs with s^Tr >= 0.2*s^TBs
+      Number theta = 1.;
+      if( sTy < 0.2 * sBs )
+      {
+         theta = 0.8 * sBs / (sBs - sTy);
+      }
+      for( Index i = 0; i < n_e; i++ )
+      {
+         v[i] = theta * y[i] + (1. - theta) * Bs[i];
+      }
+      Number sTr = theta * sTy + (1. - theta) * sBs;
+
+      // B = B - Bs (Bs)^T/s^TBs + r r^T/s^Tr
+      pos = 0;
+      for( Index i = 0; i < n_e; i++ )
+      {
+         for( Index j = 0; j <= i; j++ )
+         {
+            B[pos++] += v[i] * v[j] / sTr - Bs[i] * Bs[j] / sBs;
+         }
+      }
+   }
+   else
+   {
+      // v = y - Bs
+      Number vTv = 0.;
+      for( Index i = 0; i < n_e; i++ )
+      {
+         v[i] = y[i] - Bs[i];
+         vTv += v[i] * v[i];
+      }
+      Number vTs = sTy - sBs;
+      if( std::abs(vTs) <= 1e-8 * std::sqrt(sTs * vTv) )
+      {
+         return false;
+      }
+
+      // B = B + v v^T/v^Ts
+      pos = 0;
+      for( Index i = 0; i < n_e; i++ )
+      {
+         for( Index j = 0; j <= i; j++ )
+         {
+            B[pos++] += v[i] * v[j] / vTs;
+         }
+      }
+   }
+
+   return true;
+}
+
+void PartitionedQuasiNewtonUpdater::SetW()
+{
+   DBG_START_METH("PartitionedQuasiNewtonUpdater::SetW",
+                  dbg_verbosity);
+
+   if( update_for_resto_ )
+   {
+      RestoIpoptNLP* resto_nlp = static_cast<RestoIpoptNLP*>(&IpNLP());
+      DBG_ASSERT(dynamic_cast<RestoIpoptNLP*>(&IpNLP()));
+      SmartPtr<const SymMatrixSpace> sp = resto_nlp->OrigIpNLP().HessianMatrixSpace();
+      SmartPtr<SymTMatrix> W = static_cast<const SymTMatrixSpace*>(GetRawPtr(sp))->MakeNewSymTMatrix();
+      DBG_ASSERT(W->Nonzeros() == (Index) elem_hess_.size());
+      if( !elem_hess_.empty() )
+      {
+         W->SetValues(&elem_hess_[0]);
+      }
+      IpData().Set_W(resto_nlp->h_from_orig(*W, 1., IpData().curr_mu()));
+   }
+   else
+   {
+      SmartPtr<const SymMatrixSpace> sp = IpNLP().HessianMatrixSpace();
+      SmartPtr<SymTMatrix> W = static_cast<const SymTMatrixSpace*>(GetRawPtr(sp))->MakeNewSymTMatrix();
+      DBG_ASSERT(W->Nonzeros() == (Index) elem_hess_.size());
+      if( !elem_hess_.empty() )
+      {
+         W->SetValues(&elem_hess_[0]);
+      }
+      IpData().Set_W(GetRawPtr(W));
+   }
+}
+
+} // namespace Ipopt
@@ -0,0 +1,140 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPPARTITIONEDQUASINEWTONUPDATER_HPP__
+#define __IPPARTITIONEDQUASINEWTONUPDATER_HPP__
+
+#include "IpHessianUpdater.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+/** Implementation of the HessianUpdater for a partitioned
+ *  quasi-Newton approximation.
+ *
+ *  The Lagrangian function is assumed to be a sum of element
+ *  functions, each depending on a few variables only, see
+ *  NLP::GetElementFunctions.  For each element function, a dense
+ *  quasi-Newton approximation of its Hessian is updated with the
+ *  difference of its gradients, and the sum of these small matrices
+ *  is put into W.  In contrast to a limited-memory approximation,
+ *  the result is sparse and keeps the curvature information of all
+ *  iterations.
+ */
+class PartitionedQuasiNewtonUpdater: public HessianUpdater
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor */
+   PartitionedQuasiNewtonUpdater(
+      bool update_for_resto
+   );
+
+   /** Destructor */
+   virtual ~PartitionedQuasiNewtonUpdater()
+   { }
+   ///@}
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** Update the Hessian based on the current information in IpData. */
+   virtual void UpdateHessian();
+
+   /** Methods for IpoptType */
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   PartitionedQuasiNewtonUpdater(
+      const PartitionedQuasiNewtonUpdater&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const PartitionedQuasiNewtonUpdater&
+   );
+   ///@}
+
+   /** Type of the update of the element Hessians */
+   enum PartitionedUpdateType
+   {
+      BFGS = 0,
+      SR1
+   };
+
+   /** @name Algorithmic parameters */
+   ///@{
+   /** Update formula for the element Hessians */
+   PartitionedUpdateType partitioned_update_type_;
+   /** Multiple of the identity for the initial element Hessians */
+   Number partitioned_init_val_;
+   ///@}
+
+   /** Flag indicating if the update is for the restoration phase.
+    *
+    *  Then only the constraint part of the Hessian of the original
+    *  problem is approximated.
+    */
+   const bool update_for_resto_;
+
+   /** @name Element functions, see NLP::GetElementFunctions */
+   ///@{
+   std::vector<Index> elem_start_;
+   std::vector<Index> elem_vars_;
+   ///@}
+
+   /** Lower triangles of the element Hessians, stored row by row
+    *  for one element after the other.
+    *
+    *  This is the order of the nonzeros of W.
+    */
+   std::vector<Number> elem_hess_;
+
+   /** Flags indicating if the initial element Hessian has been
+    *  scaled by the first update. */
+   std::vector<bool> elem_scaled_;
+
+   /** Primal variables at the previous update */
+   SmartPtr<const Vector> last_x_;
+
+   /** Update the Hessian of one element function with the step s
+    *  and the gradient difference y (of length n_e).
+    *
+    *  If first is true, the initial matrix is rescaled before the
+    *  update.  Returns false if the update has been skipped.
+    */
+   bool UpdateElement(
+      Number*       B,
+      Index         n_e,
+      const Number* s,
+      const Number* y,
+      bool          first
+   );
+
+   /** Put the current element Hessians into W */
+   void SetW();
+};
+
+} // namespace Ipopt
+
+#endif
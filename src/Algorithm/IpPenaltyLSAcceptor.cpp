@@ -6,6 +6,7 @@
 //               derived file from IpFilterLSAcceptor.cpp
 
 #include "IpPenaltyLSAcceptor.hpp"
+#include "IpCheckpoint.hpp"
 
 #include <cmath>
 #include <cstdio>
@@ -294,53 +295,59 @@ bool PenaltyLSAcceptor::TrySecondOrderCorrection(
    SmartPtr<Vector> dms_soc = IpCq().curr_d_minus_s()->MakeNew();
    c_soc->Copy(*IpCq().curr_c());
    dms_soc->Copy(*IpCq().curr_d_minus_s());
+
+   // The matrix of the primal-dual system is the same for all SOC
+   // steps, so that the solver reuses its factorization.  The space
+   // for the SOC step and the scaled gradients is shared by all SOC
+   // steps, since a rejected SOC step is not referenced anymore.
+   SmartPtr<const Vector> grad_lag_x = IpCq().curr_grad_lag_with_damping_x();
+   SmartPtr<const Vector> grad_lag_s = IpCq().curr_grad_lag_with_damping_s();
+   SmartPtr<const Vector> compl_x_L = IpCq().curr_relaxed_compl_x_L();
+   SmartPtr<const Vector> compl_x_U = IpCq().curr_relaxed_compl_x_U();
+   SmartPtr<const Vector> compl_s_L = IpCq().curr_relaxed_compl_s_L();
+   SmartPtr<const Vector> compl_s_U = IpCq().curr_relaxed_compl_s_U();
+   SmartPtr<Vector> x_soc;
+   SmartPtr<Vector> s_soc;
+   if( soc_method_ == 1 )
+   {
+      x_soc = grad_lag_x->MakeNew();
+      s_soc = grad_lag_s->MakeNew();
+   }
+   SmartPtr<IteratesVector> delta_soc = actual_delta->MakeNewIteratesVector(true);
+
    while( count_soc < max_soc_ && !accept && (count_soc == 0 || theta_trial <= kappa_soc_ * theta_soc_old) )
    {
       theta_soc_old = theta_trial;
 
       Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                     "Trying second order correction number %d\n", count_soc + 1);
+                     "Trying second order correction number %" IPOPT_INDEX_FORMAT "\n", count_soc + 1);
+      IpData().WorkCounts().Increase(WorkCounters::SOC_TRIALS);
 
       // Compute SOC constraint violation
       c_soc->AddOneVector(1.0, *IpCq().trial_c(), alpha_primal_soc);
       dms_soc->AddOneVector(1.0, *IpCq().trial_d_minus_s(), alpha_primal_soc);
 
       // Compute the SOC search direction
-      SmartPtr<IteratesVector> delta_soc = actual_delta->MakeNewIteratesVector(true);
       SmartPtr<IteratesVector> rhs = actual_delta->MakeNewContainer();
-
-      switch (soc_method_)
+      if( soc_method_ == 1 )
+      {
+         x_soc->AddOneVector(alpha_primal_soc, *grad_lag_x, 0.);
+         s_soc->AddOneVector(alpha_primal_soc, *grad_lag_s, 0.);
+         rhs->Set_x(*x_soc);
+         rhs->Set_s(*s_soc);
+      }
+      else
       {
-         case 0:
-            rhs->Set_x(*IpCq().curr_grad_lag_with_damping_x());
-            rhs->Set_s(*IpCq().curr_grad_lag_with_damping_s());
-            rhs->Set_y_c(*c_soc);
-            rhs->Set_y_d(*dms_soc);
-            rhs->Set_z_L(*IpCq().curr_relaxed_compl_x_L());
-            rhs->Set_z_U(*IpCq().curr_relaxed_compl_x_U());
-            rhs->Set_v_L(*IpCq().curr_relaxed_compl_s_L());
-            rhs->Set_v_U(*IpCq().curr_relaxed_compl_s_U());
-            break;
-         case 1:
-            SmartPtr<Vector> x_soc =
-               IpCq().curr_grad_lag_with_damping_x()->MakeNew();
-            SmartPtr<Vector> s_soc =
-               IpCq().curr_grad_lag_with_damping_s()->MakeNew();
-            x_soc->Copy(*IpCq().curr_grad_lag_with_damping_x());
-            s_soc->Copy(*IpCq().curr_grad_lag_with_damping_s());
-            x_soc->Scal(alpha_primal_soc);
-            s_soc->Scal(alpha_primal_soc);
-
-            rhs->Set_x(*x_soc);
-            rhs->Set_s(*s_soc);
-            rhs->Set_y_c(*c_soc);
-            rhs->Set_y_d(*dms_soc);
-            rhs->Set_z_L(*IpCq().curr_relaxed_compl_x_L());
-            rhs->Set_z_U(*IpCq().curr_relaxed_compl_x_U());
-            rhs->Set_v_L(*IpCq().curr_relaxed_compl_s_L());
-            rhs->Set_v_U(*IpCq().curr_relaxed_compl_s_U());
-            break;
+         rhs->Set_x(*grad_lag_x);
+         rhs->Set_s(*grad_lag_s);
       }
+      rhs->Set_y_c(*c_soc);
+      rhs->Set_y_d(*dms_soc);
+      rhs->Set_z_L(*compl_x_L);
+      rhs->Set_z_U(*compl_x_U);
+      rhs->Set_v_L(*compl_s_L);
+      rhs->Set_v_U(*compl_s_U);
+
       bool retval = pd_solver_->Solve(-1.0, 0.0, *rhs, *delta_soc, true);
       if( !retval )
       {
@@ -352,18 +359,26 @@ bool PenaltyLSAcceptor::TrySecondOrderCorrection(
       // Compute step size
       alpha_primal_soc = IpCq().primal_frac_to_the_bound(IpData().curr_tau(), *delta_soc->x(), *delta_soc->s());
 
+      // Compute the primal trial point
+      IpData().SetTrialPrimalVariablesFromStep(alpha_primal_soc, *delta_soc->x(), *delta_soc->s());
+      bool evaluation_error = !IpNLP().EvaluateFunctions(*IpData().trial()->x());
+
       // Check if trial point is acceptable
-      try
+      if( !evaluation_error )
       {
-         // Compute the primal trial point
-         IpData().SetTrialPrimalVariablesFromStep(alpha_primal_soc, *delta_soc->x(), *delta_soc->s());
-
-         // in acceptance tests, use original step size!
-         accept = CheckAcceptabilityOfTrialPoint(alpha_primal_test);
+         try
+         {
+            // in acceptance tests, use original step size!
+            accept = CheckAcceptabilityOfTrialPoint(alpha_primal_test);
+         }
+         catch( IpoptNLP::Eval_Error& e )
+         {
+            e.ReportException(Jnlst(), J_DETAILED);
+            evaluation_error = true;
+         }
       }
-      catch( IpoptNLP::Eval_Error& e )
+      if( evaluation_error )
       {
-         e.ReportException(Jnlst(), J_DETAILED);
          Jnlst().Printf(J_WARNING, J_MAIN,
                         "Warning: SOC step rejected due to evaluation error\n");
          IpData().Append_info_string("e");
@@ -375,7 +390,7 @@ bool PenaltyLSAcceptor::TrySecondOrderCorrection(
       if( accept )
       {
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                        "Second order correction step accepted with %d corrections.\n", count_soc + 1);
+                        "Second order correction step accepted with %" IPOPT_INDEX_FORMAT " corrections.\n", count_soc + 1);
          // Accept all SOC quantities
          alpha_primal = alpha_primal_soc;
          actual_delta = delta_soc;
@@ -455,4 +470,41 @@ bool PenaltyLSAcceptor::IsAcceptableToCurrentIterate(
    return accept;
 }
 
+void PenaltyLSAcceptor::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   // the products of the Jacobians with the step are recomputed for each line search
+   checkpoint.WriteSection("PenaltyLSAcceptor");
+   checkpoint.WriteNumber(reference_theta_);
+   checkpoint.WriteNumber(reference_barr_);
+   checkpoint.WriteNumber(reference_gradBarrTDelta_);
+   checkpoint.WriteNumber(reference_dWd_);
+   checkpoint.WriteNumber(reference_pred_);
+   checkpoint.WriteNumber(watchdog_theta_);
+   checkpoint.WriteNumber(watchdog_barr_);
+   checkpoint.WriteNumber(watchdog_pred_);
+   checkpoint.WriteNumber(nu_);
+   checkpoint.WriteNumber(last_nu_);
+   checkpoint.WriteNumber(resto_pred_);
+}
+
+void PenaltyLSAcceptor::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("PenaltyLSAcceptor");
+   reference_theta_ = checkpoint.ReadNumber();
+   reference_barr_ = checkpoint.ReadNumber();
+   reference_gradBarrTDelta_ = checkpoint.ReadNumber();
+   reference_dWd_ = checkpoint.ReadNumber();
+   reference_pred_ = checkpoint.ReadNumber();
+   watchdog_theta_ = checkpoint.ReadNumber();
+   watchdog_barr_ = checkpoint.ReadNumber();
+   watchdog_pred_ = checkpoint.ReadNumber();
+   nu_ = checkpoint.ReadNumber();
+   last_nu_ = checkpoint.ReadNumber();
+   resto_pred_ = checkpoint.ReadNumber();
+}
+
 } // namespace Ipopt
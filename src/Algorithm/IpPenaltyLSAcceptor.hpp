@@ -128,6 +128,16 @@ public:
    /** Method for setting internal data if the watchdog procedure is stopped. */
    virtual void StopWatchDog();
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    /**@name Trial Point Accepting Methods.
     *
     * Used internally to check certain
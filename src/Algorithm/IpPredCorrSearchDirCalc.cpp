@@ -0,0 +1,367 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpPredCorrSearchDirCalc.hpp"
+#include "IpCheckpoint.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+PredCorrSearchDirCalculator::PredCorrSearchDirCalculator(
+   const SmartPtr<PDSystemSolver>&            pd_solver,
+   const SmartPtr<SearchDirectionCalculator>& non_qp_calculator
+)
+   : pd_solver_(pd_solver),
+     non_qp_calculator_(non_qp_calculator),
+     calculator_choice_(CALCULATOR_UNDECIDED),
+     predictor_task_(NULL),
+     corrector_task_(NULL),
+     num_rejected_corrections_(0)
+{
+   DBG_START_FUN("PredCorrSearchDirCalculator::PredCorrSearchDirCalculator",
+                 dbg_verbosity);
+   DBG_ASSERT(IsValid(pd_solver_));
+}
+
+PredCorrSearchDirCalculator::~PredCorrSearchDirCalculator()
+{
+   DBG_START_FUN("PredCorrSearchDirCalculator::~PredCorrSearchDirCalculator()",
+                 dbg_verbosity);
+}
+
+void PredCorrSearchDirCalculator::RegisterOptions(
+   const SmartPtr<RegisteredOptions>& roptions
+)
+{
+   roptions->SetRegisteringCategory("Step Calculation");
+   roptions->AddStringOption2(
+      "pred_corr_safeguard",
+      "Indicates if the correction of the predictor-corrector step is safeguarded.",
+      "yes",
+      "no", "always take the corrected step",
+      "yes", "drop the correction if it shortens the step",
+      "If set to yes, the second-order correction is not used in an iteration "
+      "if the fraction-to-the-boundary step size for the corrected step is smaller than for the uncorrected primal-dual step. "
+      "Only used if the predictor-corrector step is computed, see \"search_direction_method\".");
+}
+
+bool PredCorrSearchDirCalculator::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   options.GetBoolValue("fast_step_computation", fast_step_computation_, prefix);
+   options.GetBoolValue("pred_corr_safeguard", safeguard_, prefix);
+
+   predictor_task_ = &IpData().TimingStats().NamedTask("OverallAlgorithm/ComputeSearchDirection/PredictorStep");
+   corrector_task_ = &IpData().TimingStats().NamedTask("OverallAlgorithm/ComputeSearchDirection/CorrectorStep");
+   num_rejected_corrections_ = 0;
+   calculator_choice_ = IsValid(non_qp_calculator_) ? CALCULATOR_UNDECIDED : CALCULATOR_PRED_CORR;
+
+   if( IsValid(non_qp_calculator_) )
+   {
+      // this also initializes pd_solver_
+      return non_qp_calculator_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+   }
+   return pd_solver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+}
+
+void PredCorrSearchDirCalculator::SetCorrectorRhs(
+   const IteratesVector& delta_aff,
+   IteratesVector&       rhs
+)
+{
+   SmartPtr<Vector> tmpvec = delta_aff.z_L()->MakeNew();
+   IpNLP().Px_L()->TransMultVector(1., *delta_aff.x(), 0., *tmpvec);
+   tmpvec->ElementWiseMultiply(*delta_aff.z_L());
+   rhs.Set_z_L(*tmpvec);
+
+   tmpvec = delta_aff.z_U()->MakeNew();
+   IpNLP().Px_U()->TransMultVector(-1., *delta_aff.x(), 0., *tmpvec);
+   tmpvec->ElementWiseMultiply(*delta_aff.z_U());
+   rhs.Set_z_U(*tmpvec);
+
+   tmpvec = delta_aff.v_L()->MakeNew();
+   IpNLP().Pd_L()->TransMultVector(1., *delta_aff.s(), 0., *tmpvec);
+   tmpvec->ElementWiseMultiply(*delta_aff.v_L());
+   rhs.Set_v_L(*tmpvec);
+
+   tmpvec = delta_aff.v_U()->MakeNew();
+   IpNLP().Pd_U()->TransMultVector(-1., *delta_aff.s(), 0., *tmpvec);
+   tmpvec->ElementWiseMultiply(*delta_aff.v_U());
+   rhs.Set_v_U(*tmpvec);
+}
+
+bool PredCorrSearchDirCalculator::ComputeSearchDirection()
+{
+   DBG_START_METH("PredCorrSearchDirCalculator::ComputeSearchDirection",
+                  dbg_verbosity);
+
+   if( calculator_choice_ == CALCULATOR_UNDECIDED )
+   {
+      if( IpNLP().IsQuadraticProgram() )
+      {
+         Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
+                        "The problem is a quadratic program; using the predictor-corrector step.\n");
+         calculator_choice_ = CALCULATOR_PRED_CORR;
+      }
+      else
+      {
+         calculator_choice_ = CALCULATOR_NON_QP;
+      }
+   }
+   if( calculator_choice_ == CALCULATOR_NON_QP )
+   {
+      return non_qp_calculator_->ComputeSearchDirection();
+   }
+
+   // steps that might have been computed by the barrier parameter
+   // oracle in this iteration
+   SmartPtr<const IteratesVector> delta_aff;
+   if( IpData().HaveAffineDeltas() )
+   {
+      delta_aff = IpData().delta_aff();
+   }
+   SmartPtr<const IteratesVector> delta_pd;
+   if( IpData().HaveDeltas() )
+   {
+      delta_pd = IpData().delta();
+   }
+   else if( IpData().LowMemoryMode() )
+   {
+      // the direction of the previous iteration is no longer needed
+      IpData().ReleaseDelta();
+   }
+
+   Index nbounds = IpNLP().x_L()->Dim() + IpNLP().x_U()->Dim() + IpNLP().d_L()->Dim() + IpNLP().d_U()->Dim();
+   if( nbounds == 0 && IsValid(delta_pd) )
+   {
+      // without bounds, there is nothing to correct
+      return true;
+   }
+
+   SmartPtr<const IteratesVector> curr = IpData().curr();
+   bool& allow_inexact = fast_step_computation_;
+   Number mu = IpData().curr_mu();
+
+   // The zero blocks of the right hand sides of the centering step
+   // and the correction are shared
+   SmartPtr<Vector> zero_y_c = curr->y_c()->MakeNew();
+   zero_y_c->Set(0.);
+   SmartPtr<Vector> zero_y_d = curr->y_d()->MakeNew();
+   zero_y_d->Set(0.);
+
+   SmartPtr<IteratesVector> rhs_cen;
+   if( IsNull(delta_pd) && nbounds > 0 )
+   {
+      // right hand side for the difference between the primal-dual
+      // step for mu and the affine step
+      rhs_cen = curr->MakeNewContainer();
+      SmartPtr<Vector> tmp = curr->x()->MakeNew();
+      tmp->AddOneVector(mu, *IpCq().grad_kappa_times_damping_x(), 0.);
+      rhs_cen->Set_x(*tmp);
+      tmp = curr->s()->MakeNew();
+      tmp->AddOneVector(mu, *IpCq().grad_kappa_times_damping_s(), 0.);
+      rhs_cen->Set_s(*tmp);
+      rhs_cen->Set_y_c(*zero_y_c);
+      rhs_cen->Set_y_d(*zero_y_d);
+      tmp = curr->z_L()->MakeNew();
+      tmp->Set(-mu);
+      rhs_cen->Set_z_L(*tmp);
+      tmp = curr->z_U()->MakeNew();
+      tmp->Set(-mu);
+      rhs_cen->Set_z_U(*tmp);
+      tmp = curr->v_L()->MakeNew();
+      tmp->Set(-mu);
+      rhs_cen->Set_v_L(*tmp);
+      tmp = curr->v_U()->MakeNew();
+      tmp->Set(-mu);
+      rhs_cen->Set_v_U(*tmp);
+   }
+   SmartPtr<IteratesVector> step_cen;
+
+   /////////////////////////////////////////////////////////
+   // Predictor: affine step and centering step together  //
+   /////////////////////////////////////////////////////////
+
+   if( IsNull(delta_aff) )
+   {
+      predictor_task_->Start();
+
+      // the residuals of the current iterate are shared with the
+      // cached quantities and not copied
+      SmartPtr<IteratesVector> rhs_aff = curr->MakeNewContainer();
+      rhs_aff->Set_x(*IpCq().curr_grad_lag_x());
+      rhs_aff->Set_s(*IpCq().curr_grad_lag_s());
+      rhs_aff->Set_y_c(*IpCq().curr_c());
+      rhs_aff->Set_y_d(*IpCq().curr_d_minus_s());
+      rhs_aff->Set_z_L(*IpCq().curr_compl_x_L());
+      rhs_aff->Set_z_U(*IpCq().curr_compl_x_U());
+      rhs_aff->Set_v_L(*IpCq().curr_compl_s_L());
+      rhs_aff->Set_v_U(*IpCq().curr_compl_s_U());
+
+      SmartPtr<IteratesVector> step_aff = curr->MakeNewIteratesVector(true);
+      bool retval;
+      if( IsValid(rhs_cen) )
+      {
+         step_cen = curr->MakeNewIteratesVector(true);
+
+         std::vector<SmartPtr<const IteratesVector> > rhsV(2);
+         rhsV[0] = ConstPtr(rhs_aff);
+         rhsV[1] = ConstPtr(rhs_cen);
+         std::vector<SmartPtr<IteratesVector> > stepV(2);
+         stepV[0] = step_aff;
+         stepV[1] = step_cen;
+
+         retval = pd_solver_->MultiSolve(-1.0, 0.0, rhsV, stepV, allow_inexact);
+      }
+      else
+      {
+         retval = pd_solver_->Solve(-1.0, 0.0, *rhs_aff, *step_aff, allow_inexact);
+      }
+
+      predictor_task_->End();
+      if( !retval )
+      {
+         return false;
+      }
+      DBG_PRINT_VECTOR(2, "step_aff", *step_aff);
+
+      // Store the affine step (in case it is needed in the line
+      // search for a corrector step)
+      delta_aff = ConstPtr(step_aff);
+      IpData().set_delta_aff(step_aff);
+      IpData().SetHaveAffineDeltas(true);
+   }
+
+   if( nbounds == 0 )
+   {
+      // without bounds, the affine step is the primal-dual step
+      SmartPtr<IteratesVector> delta = delta_aff->MakeNewIteratesVectorCopy();
+      IpData().set_delta(delta);
+      return true;
+   }
+
+   ///////////////////////////////////////////////////////////////
+   // Corrector: second-order correction (and centering step)   //
+   ///////////////////////////////////////////////////////////////
+
+   corrector_task_->Start();
+
+   SmartPtr<IteratesVector> rhs_soc = curr->MakeNewContainer();
+   SmartPtr<Vector> zero_x = curr->x()->MakeNew();
+   zero_x->Set(0.);
+   SmartPtr<Vector> zero_s = curr->s()->MakeNew();
+   zero_s->Set(0.);
+   rhs_soc->Set_x(*zero_x);
+   rhs_soc->Set_s(*zero_s);
+   rhs_soc->Set_y_c(*zero_y_c);
+   rhs_soc->Set_y_d(*zero_y_d);
+   SetCorrectorRhs(*delta_aff, *rhs_soc);
+   DBG_PRINT_VECTOR(2, "rhs_soc", *rhs_soc);
+
+   SmartPtr<IteratesVector> step_soc = curr->MakeNewIteratesVector(true);
+   bool retval;
+   if( IsValid(rhs_cen) && IsNull(step_cen) )
+   {
+      // the affine step came from the oracle, so the centering step
+      // is computed in the same call as the correction
+      step_cen = curr->MakeNewIteratesVector(true);
+
+      std::vector<SmartPtr<const IteratesVector> > rhsV(2);
+      rhsV[0] = ConstPtr(rhs_cen);
+      rhsV[1] = ConstPtr(rhs_soc);
+      std::vector<SmartPtr<IteratesVector> > stepV(2);
+      stepV[0] = step_cen;
+      stepV[1] = step_soc;
+
+      retval = pd_solver_->MultiSolve(-1.0, 0.0, rhsV, stepV, allow_inexact);
+   }
+   else
+   {
+      retval = pd_solver_->Solve(-1.0, 0.0, *rhs_soc, *step_soc, allow_inexact);
+   }
+   if( !retval )
+   {
+      corrector_task_->End();
+      return false;
+   }
+   DBG_PRINT_VECTOR(2, "step_soc", *step_soc);
+
+   // the uncorrected primal-dual step for mu
+   SmartPtr<IteratesVector> delta = curr->MakeNewIteratesVector(true);
+   if( IsValid(delta_pd) )
+   {
+      delta->Copy(*delta_pd);
+   }
+   else
+   {
+      delta->AddTwoVectors(1., *delta_aff, 1., *step_cen, 0.);
+   }
+
+   bool use_correction = true;
+   if( safeguard_ )
+   {
+      Number tau = IpData().curr_tau();
+      Number alpha_pd = Min(IpCq().primal_frac_to_the_bound(tau, *delta->x(), *delta->s()),
+                            IpCq().dual_frac_to_the_bound(tau, *delta->z_L(), *delta->z_U(), *delta->v_L(), *delta->v_U()));
+
+      SmartPtr<IteratesVector> delta_corr = delta->MakeNewIteratesVectorCopy();
+      delta_corr->Axpy(1., *step_soc);
+      Number alpha_corr = Min(IpCq().primal_frac_to_the_bound(tau, *delta_corr->x(), *delta_corr->s()),
+                              IpCq().dual_frac_to_the_bound(tau, *delta_corr->z_L(), *delta_corr->z_U(), *delta_corr->v_L(),
+                                    *delta_corr->v_U()));
+
+      Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
+                     "Fraction-to-the-boundary step size without correction %23.16e and with correction %23.16e\n", alpha_pd,
+                     alpha_corr);
+      if( alpha_corr < alpha_pd )
+      {
+         use_correction = false;
+         num_rejected_corrections_++;
+         IpData().Append_info_string("Pc");
+      }
+      else
+      {
+         delta = delta_corr;
+      }
+   }
+   else
+   {
+      delta->Axpy(1., *step_soc);
+   }
+
+   corrector_task_->End();
+
+   Jnlst().Printf(J_DETAILED, J_SOLVE_PD_SYSTEM,
+                  "The second-order correction has %sbeen used (dropped in %" IPOPT_INDEX_FORMAT " iterations so far).\n",
+                  use_correction ? "" : "not ", num_rejected_corrections_);
+
+   DBG_PRINT_VECTOR(2, "delta", *delta);
+   IpData().set_delta(delta);
+
+   return true;
+}
+
+void PredCorrSearchDirCalculator::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   pd_solver_->WriteCheckpoint(checkpoint);
+}
+
+void PredCorrSearchDirCalculator::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   pd_solver_->ReadCheckpoint(checkpoint);
+}
+
+} // namespace Ipopt
@@ -0,0 +1,174 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPPREDCORRSEARCHDIRCALC_HPP__
+#define __IPPREDCORRSEARCHDIRCALC_HPP__
+
+#include "IpSearchDirCalculator.hpp"
+#include "IpPDSystemSolver.hpp"
+
+namespace Ipopt
+{
+
+/** Implementation of the search direction calculator that computes
+ *  a Mehrotra-style predictor-corrector step for the current barrier
+ *  parameter.
+ *
+ *  The step is assembled from three solutions of the primal-dual
+ *  system with the same matrix, so the matrix is factorized only
+ *  once: the affine scaling (predictor) step, the centering step for
+ *  the current barrier parameter, whose sum is the primal-dual step
+ *  of PDSearchDirCalculator, and the second-order correction for the
+ *  products of the affine steps of the slacks and bound multipliers.
+ *  The affine and centering steps are computed in one call of
+ *  PDSystemSolver::MultiSolve.  An affine step or a primal-dual step
+ *  that has been computed already in this iteration (by the probing
+ *  oracle) is reused, and the remaining solves are batched.  Since the
+ *  correction depends on the affine step, it cannot be batched with
+ *  the affine step.
+ *
+ *  Unlike mehrotra_algorithm, this does not depend on a particular
+ *  barrier parameter update or line search.
+ */
+class IPOPTLIB_EXPORT PredCorrSearchDirCalculator: public SearchDirectionCalculator
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor.
+    *
+    *  If non_qp_calculator is given, the predictor-corrector step is
+    *  only computed if the problem is a quadratic program (see
+    *  IpoptNLP::IsQuadraticProgram), and the step is computed by
+    *  non_qp_calculator otherwise.  It must use the same pd_solver.
+    */
+   PredCorrSearchDirCalculator(
+      const SmartPtr<PDSystemSolver>&            pd_solver,
+      const SmartPtr<SearchDirectionCalculator>& non_qp_calculator = NULL
+   );
+
+   /** Destructor */
+   virtual ~PredCorrSearchDirCalculator();
+   ///@}
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** Method for computing the search direction.
+    *
+    *  The computed direction is stored in IpData().delta(), and the
+    *  affine step in IpData().delta_aff().
+    */
+   virtual bool ComputeSearchDirection();
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
+   static void RegisterOptions(
+      const SmartPtr<RegisteredOptions>& roptions
+   );
+
+   /** Returns the pd_solver for additional processing. */
+   virtual SmartPtr<PDSystemSolver> PDSolver()
+   {
+      return pd_solver_;
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   PredCorrSearchDirCalculator();
+
+   /** Copy Constructor */
+   PredCorrSearchDirCalculator(
+      const PredCorrSearchDirCalculator&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const PredCorrSearchDirCalculator&
+   );
+   ///@}
+
+   /** Set the bound parts of rhs to the products of the affine steps
+    *  of the slacks and the bound multipliers.
+    */
+   void SetCorrectorRhs(
+      const IteratesVector& delta_aff,
+      IteratesVector&       rhs
+   );
+
+   /** Pointer to the object that should be used to solve the
+    *  primal-dual system.
+    */
+   SmartPtr<PDSystemSolver> pd_solver_;
+
+   /** Calculator for problems that are not quadratic programs, or NULL */
+   SmartPtr<SearchDirectionCalculator> non_qp_calculator_;
+
+   /** Choices for the calculator of the steps */
+   enum ECalculatorChoice
+   {
+      CALCULATOR_UNDECIDED,
+      CALCULATOR_PRED_CORR,
+      CALCULATOR_NON_QP
+   };
+
+   /** Whether the steps are computed by non_qp_calculator_.
+    *
+    *  This is decided in the first call of ComputeSearchDirection,
+    *  since the NLP is initialized after this object.
+    */
+   ECalculatorChoice calculator_choice_;
+
+   /** @name Algorithmic parameters */
+   ///@{
+   /** Flag indicating that we trust that the steps can be computed
+    *  sufficiently accurately by the linear solver.
+    */
+   bool fast_step_computation_;
+
+   /** Flag indicating whether the correction is dropped if it
+    *  reduces the fraction-to-the-boundary step size.
+    */
+   bool safeguard_;
+   ///@}
+
+   /** @name Timed parts of the step computation */
+   ///@{
+   /** Computation of the affine (and centering) steps */
+   TimedTask* predictor_task_;
+
+   /** Computation of the second-order correction */
+   TimedTask* corrector_task_;
+   ///@}
+
+   /** Number of iterations in which the correction has been dropped
+    *  by the safeguard
+    */
+   Index num_rejected_corrections_;
+};
+
+} // namespace Ipopt
+
+#endif
@@ -28,10 +28,20 @@ ProbingMuOracle::~ProbingMuOracle()
 { }
 
 void ProbingMuOracle::RegisterOptions(
-   SmartPtr<RegisteredOptions> /*roptions*/
+   SmartPtr<RegisteredOptions> roptions
 )
 {
-   // None to register...
+   roptions->AddStringOption2(
+      "probing_combined_step",
+      "Whether the probing oracle also computes the search direction.",
+      "no",
+      "no", "only compute the affine step",
+      "yes", "compute the affine and the centering step in one solve",
+      "If enabled, the primal-dual system is solved for the affine and the centering right hand side "
+      "with a single call, and the combination for the barrier parameter found by the oracle is used "
+      "as the search direction, so that it does not need to be computed again. "
+      "(Only used if option \"mu_oracle\" or \"fixed_mu_oracle\" is set to \"probing\", "
+      "and ignored if \"mehrotra_algorithm\" is enabled.)");
 }
 
 bool ProbingMuOracle::InitializeImpl(
@@ -40,6 +50,14 @@ bool ProbingMuOracle::InitializeImpl(
 )
 {
    options.GetNumericValue("sigma_max", sigma_max_, prefix);
+   options.GetBoolValue("probing_combined_step", combined_step_, prefix);
+   bool mehrotra_algorithm;
+   options.GetBoolValue("mehrotra_algorithm", mehrotra_algorithm, prefix);
+   // Mehrotra's corrector needs the affine step in the search direction computation
+   if( mehrotra_algorithm )
+   {
+      combined_step_ = false;
+   }
 
    return true;
 }
@@ -73,11 +91,43 @@ bool ProbingMuOracle::CalculateMu(
 
    // Get space for the affine scaling step
    SmartPtr<IteratesVector> step = rhs->MakeNewIteratesVector(true);
+   SmartPtr<IteratesVector> step_cen;
 
    // Now solve the primal-dual system to get the affine step.  We
    // allow a somewhat inexact solution here
    bool allow_inexact = true;
-   bool retval = pd_solver_->Solve(-1.0, 0.0, *rhs, *step, allow_inexact);
+   bool retval;
+   if( combined_step_ )
+   {
+      // Also get the centering step, with the same right hand side as
+      // in the quality function oracle, so that the search direction
+      // can be assembled without another solve
+      Number avrg_compl = IpCq().curr_avrg_compl();
+      SmartPtr<IteratesVector> rhs_cen = rhs->MakeNewIteratesVector(true);
+      rhs_cen->x_NonConst()->AddOneVector(avrg_compl, *IpCq().grad_kappa_times_damping_x(), 0.);
+      rhs_cen->s_NonConst()->AddOneVector(avrg_compl, *IpCq().grad_kappa_times_damping_s(), 0.);
+      rhs_cen->y_c_NonConst()->Set(0.);
+      rhs_cen->y_d_NonConst()->Set(0.);
+      rhs_cen->z_L_NonConst()->Set(-avrg_compl);
+      rhs_cen->z_U_NonConst()->Set(-avrg_compl);
+      rhs_cen->v_L_NonConst()->Set(-avrg_compl);
+      rhs_cen->v_U_NonConst()->Set(-avrg_compl);
+
+      step_cen = rhs->MakeNewIteratesVector(true);
+
+      std::vector<SmartPtr<const IteratesVector> > rhsV(2);
+      rhsV[0] = ConstPtr(rhs);
+      rhsV[1] = ConstPtr(rhs_cen);
+      std::vector<SmartPtr<IteratesVector> > stepV(2);
+      stepV[0] = step;
+      stepV[1] = step_cen;
+
+      retval = pd_solver_->MultiSolve(-1.0, 0.0, rhsV, stepV, allow_inexact);
+   }
+   else
+   {
+      retval = pd_solver_->Solve(-1.0, 0.0, *rhs, *step, allow_inexact);
+   }
    if( !retval )
    {
       Jnlst().Printf(J_DETAILED, J_BARRIER_UPDATE,
@@ -120,11 +170,6 @@ bool ProbingMuOracle::CalculateMu(
 
    Number mu = sigma * mu_curr;
 
-   // Store the affine search direction (in case it is needed in the
-   // line search for a corrector step)
-   IpData().set_delta_aff(step);
-   IpData().SetHaveAffineDeltas(true);
-
    char ssigma[40];
    sprintf(ssigma, " sigma=%8.2e", sigma);
    IpData().Append_info_string(ssigma);
@@ -132,6 +177,24 @@ bool ProbingMuOracle::CalculateMu(
    //IpData().Append_info_string(ssigma);
 
    new_mu = Max(Min(mu, mu_max), mu_min);
+
+   if( combined_step_ )
+   {
+      // Construct the search direction for the final barrier parameter
+      SmartPtr<IteratesVector> delta = step->MakeNewIteratesVector(true);
+      delta->AddTwoVectors(new_mu / mu_curr, *step_cen, 1.0, *step, 0.0);
+
+      DBG_PRINT_VECTOR(2, "delta", *delta);
+      IpData().set_delta(delta);
+      IpData().SetHaveDeltas(true);
+   }
+
+   // Store the affine search direction (in case it is needed in the
+   // line search for a corrector step); this takes over step, so it
+   // is done after the combined step has been computed from it
+   IpData().set_delta_aff(step);
+   IpData().SetHaveAffineDeltas(true);
+
    return true;
 }
 
@@ -93,6 +93,9 @@ private:
    ///@{
    /** safeguarding upper bound on centering parameter sigma */
    Number sigma_max_;
+   /** whether the search direction is computed together with the
+    *  affine step */
+   bool combined_step_;
    ///@}
 };
 
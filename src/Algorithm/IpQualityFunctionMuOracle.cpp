@@ -30,15 +30,6 @@ QualityFunctionMuOracle::QualityFunctionMuOracle(
      tmp_step_v_L_(NULL),
      tmp_step_v_U_(NULL),
 
-     tmp_slack_x_L_(NULL),
-     tmp_slack_x_U_(NULL),
-     tmp_slack_s_L_(NULL),
-     tmp_slack_s_U_(NULL),
-     tmp_z_L_(NULL),
-     tmp_z_U_(NULL),
-     tmp_v_L_(NULL),
-     tmp_v_U_(NULL),
-
      count_qf_evals_(0)
 {
    DBG_ASSERT(IsValid(pd_solver_));
@@ -166,22 +157,13 @@ bool QualityFunctionMuOracle::CalculateMu(
    tmp_step_v_L_ = IpNLP().d_L()->MakeNew();
    tmp_step_v_U_ = IpNLP().d_U()->MakeNew();
 
-   tmp_slack_x_L_ = IpNLP().x_L()->MakeNew();
-   tmp_slack_x_U_ = IpNLP().x_U()->MakeNew();
-   tmp_slack_s_L_ = IpNLP().d_L()->MakeNew();
-   tmp_slack_s_U_ = IpNLP().d_U()->MakeNew();
-   tmp_z_L_ = IpNLP().x_L()->MakeNew();
-   tmp_z_U_ = IpNLP().x_U()->MakeNew();
-   tmp_v_L_ = IpNLP().d_L()->MakeNew();
-   tmp_v_U_ = IpNLP().d_U()->MakeNew();
-
-   /////////////////////////////////////
-   // Compute the affine scaling step //
-   /////////////////////////////////////
+   ////////////////////////////////////////////////////////
+   // Compute the affine scaling and pure centering step //
+   ////////////////////////////////////////////////////////
 
    Jnlst().Printf(J_DETAILED, J_BARRIER_UPDATE,
-                  "Solving the Primal Dual System for the affine step\n");
-   // First get the right hand side
+                  "Solving the Primal Dual System for the affine and centering step\n");
+   // First get the right hand side for the affine step
    SmartPtr<IteratesVector> rhs_aff = IpData().curr()->MakeNewIteratesVector(false);
    rhs_aff->Set_x(*IpCq().curr_grad_lag_x());
    rhs_aff->Set_s(*IpCq().curr_grad_lag_s());
@@ -192,56 +174,46 @@ bool QualityFunctionMuOracle::CalculateMu(
    rhs_aff->Set_v_L(*IpCq().curr_compl_s_L());
    rhs_aff->Set_v_U(*IpCq().curr_compl_s_U());
 
-   // Get space for the affine scaling step
-   SmartPtr<IteratesVector> step_aff = IpData().curr()->MakeNewIteratesVector(true);
-
-   // Now solve the primal-dual system to get the step.  We allow a
-   // somewhat inexact solution, iterative refinement will be done
-   // after mu is known
-   bool allow_inexact = true;
-   bool retval = pd_solver_->Solve(-1.0, 0.0, *rhs_aff, *step_aff, allow_inexact);
-   if( !retval )
-   {
-      Jnlst().Printf(J_DETAILED, J_BARRIER_UPDATE,
-                     "The linear system could not be solved for the affine step!\n");
-      return false;
-   }
-
-   DBG_PRINT_VECTOR(2, "step_aff", *step_aff);
-
-   /////////////////////////////////////
-   // Compute the pure centering step //
-   /////////////////////////////////////
-
    Number avrg_compl = IpCq().curr_avrg_compl();
 
-   Jnlst().Printf(J_DETAILED, J_BARRIER_UPDATE,
-                  "Solving the Primal Dual System for the centering step\n");
-   // First get the right hand side
+   // Now the right hand side for the centering step.  Both systems are
+   // solved with a factor of -1 for the solution, so that the centering
+   // right hand side has the opposite sign.
    SmartPtr<IteratesVector> rhs_cen = IpData().curr()->MakeNewIteratesVector(true);
-   rhs_cen->x_NonConst()->AddOneVector(-avrg_compl, *IpCq().grad_kappa_times_damping_x(), 0.);
-   rhs_cen->s_NonConst()->AddOneVector(-avrg_compl, *IpCq().grad_kappa_times_damping_s(), 0.);
+   rhs_cen->x_NonConst()->AddOneVector(avrg_compl, *IpCq().grad_kappa_times_damping_x(), 0.);
+   rhs_cen->s_NonConst()->AddOneVector(avrg_compl, *IpCq().grad_kappa_times_damping_s(), 0.);
 
    rhs_cen->y_c_NonConst()->Set(0.);
    rhs_cen->y_d_NonConst()->Set(0.);
-   rhs_cen->z_L_NonConst()->Set(avrg_compl);
-   rhs_cen->z_U_NonConst()->Set(avrg_compl);
-   rhs_cen->v_L_NonConst()->Set(avrg_compl);
-   rhs_cen->v_U_NonConst()->Set(avrg_compl);
+   rhs_cen->z_L_NonConst()->Set(-avrg_compl);
+   rhs_cen->z_U_NonConst()->Set(-avrg_compl);
+   rhs_cen->v_L_NonConst()->Set(-avrg_compl);
+   rhs_cen->v_U_NonConst()->Set(-avrg_compl);
 
-   // Get space for the centering step
+   // Get space for the affine scaling and centering step
+   SmartPtr<IteratesVector> step_aff = IpData().curr()->MakeNewIteratesVector(true);
    SmartPtr<IteratesVector> step_cen = IpData().curr()->MakeNewIteratesVector(true);
 
-   // Now solve the primal-dual system to get the step
-   allow_inexact = true;
-   retval = pd_solver_->Solve(1.0, 0.0, *rhs_cen, *step_cen, allow_inexact);
+   std::vector<SmartPtr<const IteratesVector> > rhsV(2);
+   rhsV[0] = ConstPtr(rhs_aff);
+   rhsV[1] = ConstPtr(rhs_cen);
+   std::vector<SmartPtr<IteratesVector> > stepV(2);
+   stepV[0] = step_aff;
+   stepV[1] = step_cen;
+
+   // Now solve the primal-dual system to get both steps with one call
+   // to the linear solver.  We allow a somewhat inexact solution,
+   // iterative refinement will be done after mu is known
+   bool allow_inexact = true;
+   bool retval = pd_solver_->MultiSolve(-1.0, 0.0, rhsV, stepV, allow_inexact);
    if( !retval )
    {
       Jnlst().Printf(J_DETAILED, J_BARRIER_UPDATE,
-                     "The linear system could not be solved for the centering step!\n");
+                     "The linear system could not be solved for the affine and centering step!\n");
       return false;
    }
 
+   DBG_PRINT_VECTOR(2, "step_aff", *step_aff);
    DBG_PRINT_VECTOR(2, "step_cen", *step_cen);
 
    // Start the timing for the quality function search here
@@ -448,15 +420,6 @@ bool QualityFunctionMuOracle::CalculateMu(
    tmp_step_v_L_ = NULL;
    tmp_step_v_U_ = NULL;
 
-   tmp_slack_x_L_ = NULL;
-   tmp_slack_x_U_ = NULL;
-   tmp_slack_s_L_ = NULL;
-   tmp_slack_s_U_ = NULL;
-   tmp_z_L_ = NULL;
-   tmp_z_U_ = NULL;
-   tmp_v_L_ = NULL;
-   tmp_v_U_ = NULL;
-
    curr_slack_x_L_ = NULL;
    curr_slack_x_U_ = NULL;
    curr_slack_s_L_ = NULL;
@@ -466,7 +429,7 @@ bool QualityFunctionMuOracle::CalculateMu(
    char ssigma[40];
    Snprintf(ssigma, 39, " sigma=%8.2e", sigma);
    IpData().Append_info_string(ssigma);
-   Snprintf(ssigma, 39, " qf=%d", count_qf_evals_);
+   Snprintf(ssigma, 39, " qf=%" IPOPT_INDEX_FORMAT, count_qf_evals_);
    IpData().Append_info_string(ssigma);
    /*
     Snprintf(ssigma, 39, " xi=%8.2e ", IpCq().curr_centrality_measure());
@@ -531,29 +494,38 @@ Number QualityFunctionMuOracle::CalculateQualityFunction(
 
    Number xi = 0.; // centrality measure
 
+   // The steps are not needed anymore, so the trial slacks and
+   // multipliers, and then the complementarities, are computed in the
+   // same space.  This halves the number of work vectors that are
+   // traversed for each evaluation.
    IpData().TimingStats().Task1().Start();
-   tmp_slack_x_L_->AddTwoVectors(1., *curr_slack_x_L_, alpha_primal, *tmp_step_x_L_, 0.);
-   tmp_slack_x_U_->AddTwoVectors(1., *curr_slack_x_U_, alpha_primal, *tmp_step_x_U_, 0.);
-   tmp_slack_s_L_->AddTwoVectors(1., *curr_slack_s_L_, alpha_primal, *tmp_step_s_L_, 0.);
-   tmp_slack_s_U_->AddTwoVectors(1., *curr_slack_s_U_, alpha_primal, *tmp_step_s_U_, 0.);
-
-   tmp_z_L_->AddTwoVectors(1., *curr_z_L_, alpha_dual, *tmp_step_z_L_, 0.);
-   tmp_z_U_->AddTwoVectors(1., *curr_z_U_, alpha_dual, *tmp_step_z_U_, 0.);
-   tmp_v_L_->AddTwoVectors(1., *curr_v_L_, alpha_dual, *tmp_step_v_L_, 0.);
-   tmp_v_U_->AddTwoVectors(1., *curr_v_U_, alpha_dual, *tmp_step_v_U_, 0.);
+   tmp_step_x_L_->AddOneVector(1., *curr_slack_x_L_, alpha_primal);
+   tmp_step_x_U_->AddOneVector(1., *curr_slack_x_U_, alpha_primal);
+   tmp_step_s_L_->AddOneVector(1., *curr_slack_s_L_, alpha_primal);
+   tmp_step_s_U_->AddOneVector(1., *curr_slack_s_U_, alpha_primal);
+
+   tmp_step_z_L_->AddOneVector(1., *curr_z_L_, alpha_dual);
+   tmp_step_z_U_->AddOneVector(1., *curr_z_U_, alpha_dual);
+   tmp_step_v_L_->AddOneVector(1., *curr_v_L_, alpha_dual);
+   tmp_step_v_U_->AddOneVector(1., *curr_v_U_, alpha_dual);
    IpData().TimingStats().Task1().End();
 
    IpData().TimingStats().Task3().Start();
-   tmp_slack_x_L_->ElementWiseMultiply(*tmp_z_L_);
-   tmp_slack_x_U_->ElementWiseMultiply(*tmp_z_U_);
-   tmp_slack_s_L_->ElementWiseMultiply(*tmp_v_L_);
-   tmp_slack_s_U_->ElementWiseMultiply(*tmp_v_U_);
+   tmp_step_x_L_->ElementWiseMultiply(*tmp_step_z_L_);
+   tmp_step_x_U_->ElementWiseMultiply(*tmp_step_z_U_);
+   tmp_step_s_L_->ElementWiseMultiply(*tmp_step_v_L_);
+   tmp_step_s_U_->ElementWiseMultiply(*tmp_step_v_U_);
    IpData().TimingStats().Task3().End();
 
-   DBG_PRINT_VECTOR(2, "compl_x_L", *tmp_slack_x_L_);
-   DBG_PRINT_VECTOR(2, "compl_x_U", *tmp_slack_x_U_);
-   DBG_PRINT_VECTOR(2, "compl_s_L", *tmp_slack_s_L_);
-   DBG_PRINT_VECTOR(2, "compl_s_U", *tmp_slack_s_U_);
+   const Vector& compl_x_L = *tmp_step_x_L_;
+   const Vector& compl_x_U = *tmp_step_x_U_;
+   const Vector& compl_s_L = *tmp_step_s_L_;
+   const Vector& compl_s_U = *tmp_step_s_U_;
+
+   DBG_PRINT_VECTOR(2, "compl_x_L", compl_x_L);
+   DBG_PRINT_VECTOR(2, "compl_x_U", compl_x_U);
+   DBG_PRINT_VECTOR(2, "compl_s_L", compl_s_L);
+   DBG_PRINT_VECTOR(2, "compl_s_U", compl_s_U);
 
    Number dual_inf = -1.;
    Number primal_inf = -1.;
@@ -567,7 +539,7 @@ Number QualityFunctionMuOracle::CalculateQualityFunction(
 
          primal_inf = (1. - alpha_primal) * (curr_c_asum_ + curr_d_minus_s_asum_);
 
-         compl_inf = tmp_slack_x_L_->Asum() + tmp_slack_x_U_->Asum() + tmp_slack_s_L_->Asum() + tmp_slack_s_U_->Asum();
+         compl_inf = compl_x_L.Asum() + compl_x_U.Asum() + compl_s_L.Asum() + compl_s_U.Asum();
 
          dual_inf /= n_dual_;
          if( n_pri_ > 0 )
@@ -580,8 +552,8 @@ Number QualityFunctionMuOracle::CalculateQualityFunction(
       case NM_NORM_2_SQUARED:
          dual_inf = pow(1. - alpha_dual, 2) * (pow(curr_grad_lag_x_nrm2_, 2) + pow(curr_grad_lag_s_nrm2_, 2));
          primal_inf = pow(1. - alpha_primal, 2) * (pow(curr_c_nrm2_, 2) + pow(curr_d_minus_s_nrm2_, 2));
-         compl_inf = pow(tmp_slack_x_L_->Nrm2(), 2) + pow(tmp_slack_x_U_->Nrm2(), 2) + pow(tmp_slack_s_L_->Nrm2(), 2)
-                     + pow(tmp_slack_s_U_->Nrm2(), 2);
+         compl_inf = pow(compl_x_L.Nrm2(), 2) + pow(compl_x_U.Nrm2(), 2) + pow(compl_s_L.Nrm2(), 2)
+                     + pow(compl_s_U.Nrm2(), 2);
 
          dual_inf /= n_dual_;
          if( n_pri_ > 0 )
@@ -594,15 +566,15 @@ Number QualityFunctionMuOracle::CalculateQualityFunction(
       case NM_NORM_MAX:
          dual_inf = (1. - alpha_dual) * Max(curr_grad_lag_x_amax_, curr_grad_lag_s_amax_);
          primal_inf = (1. - alpha_primal) * Max(curr_c_amax_, curr_d_minus_s_amax_);
-         compl_inf = Max(tmp_slack_x_L_->Amax(), tmp_slack_x_U_->Amax(), tmp_slack_s_L_->Amax(),
-                         tmp_slack_s_U_->Amax());
+         compl_inf = Max(compl_x_L.Amax(), compl_x_U.Amax(), compl_s_L.Amax(),
+                         compl_s_U.Amax());
          break;
       case NM_NORM_2:
          dual_inf = (1. - alpha_dual) * sqrt(pow(curr_grad_lag_x_nrm2_, 2) + pow(curr_grad_lag_s_nrm2_, 2));
          primal_inf = (1. - alpha_primal) * sqrt(pow(curr_c_nrm2_, 2) + pow(curr_d_minus_s_nrm2_, 2));
          compl_inf = sqrt(
-                        pow(tmp_slack_x_L_->Nrm2(), 2) + pow(tmp_slack_x_U_->Nrm2(), 2) + pow(tmp_slack_s_L_->Nrm2(), 2)
-                        + pow(tmp_slack_s_U_->Nrm2(), 2));
+                        pow(compl_x_L.Nrm2(), 2) + pow(compl_x_U.Nrm2(), 2) + pow(compl_s_L.Nrm2(), 2)
+                        + pow(compl_s_U.Nrm2(), 2));
 
          dual_inf /= sqrt((Number) n_dual_);
          if( n_pri_ > 0 )
@@ -622,7 +594,7 @@ Number QualityFunctionMuOracle::CalculateQualityFunction(
    if( quality_function_centrality_ != CEN_NONE )
    {
       IpData().TimingStats().Task4().Start();
-      xi = IpCq().CalcCentralityMeasure(*tmp_slack_x_L_, *tmp_slack_x_U_, *tmp_slack_s_L_, *tmp_slack_s_U_);
+      xi = IpCq().CalcCentralityMeasure(compl_x_L, compl_x_U, compl_s_L, compl_s_U);
       IpData().TimingStats().Task4().End();
    }
    switch( quality_function_centrality_ )
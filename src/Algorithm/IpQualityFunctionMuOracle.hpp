@@ -260,15 +260,6 @@ private:
    SmartPtr<Vector> tmp_step_z_U_;
    SmartPtr<Vector> tmp_step_v_L_;
    SmartPtr<Vector> tmp_step_v_U_;
-
-   SmartPtr<Vector> tmp_slack_x_L_;
-   SmartPtr<Vector> tmp_slack_x_U_;
-   SmartPtr<Vector> tmp_slack_s_L_;
-   SmartPtr<Vector> tmp_slack_s_U_;
-   SmartPtr<Vector> tmp_z_L_;
-   SmartPtr<Vector> tmp_z_U_;
-   SmartPtr<Vector> tmp_v_L_;
-   SmartPtr<Vector> tmp_v_U_;
    ///@}
 
    /* Counter for the qualify function evaluations */
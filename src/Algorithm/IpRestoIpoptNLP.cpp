@@ -126,191 +126,199 @@ bool RestoIpoptNLP::InitializeStructures(
                            orig_px_u_space, orig_d_l_space, orig_pd_l_space, orig_d_u_space, orig_pd_u_space, orig_jac_c_space,
                            orig_jac_d_space, orig_h_space);
 
-   // Create the restoration phase problem vector/matrix spaces, based
-   // on the original spaces (pretty inconvenient with all the
-   // matrix spaces, isn't it?!?)
-   DBG_PRINT((1, "Creating the x_space_\n"));
-   // vector x
-   Index total_dim = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   x_space_ = new CompoundVectorSpace(5, total_dim);
-   x_space_->SetCompSpace(0, *orig_x_space);
-   x_space_->SetCompSpace(1, *orig_c_space); // n_c
-   x_space_->SetCompSpace(2, *orig_c_space); // p_c
-   x_space_->SetCompSpace(3, *orig_d_space); // n_d
-   x_space_->SetCompSpace(4, *orig_d_space); // p_d
-
-   DBG_PRINT((1, "Setting the c_space_\n"));
-   // vector c
-   //c_space_ = orig_c_space;
-   c_space_ = new CompoundVectorSpace(1, orig_c_space->Dim());
-   c_space_->SetCompSpace(0, *orig_c_space);
-
-   DBG_PRINT((1, "Setting the d_space_\n"));
-   // vector d
-   //d_space_ = orig_d_space;
-   d_space_ = new CompoundVectorSpace(1, orig_d_space->Dim());
-   d_space_->SetCompSpace(0, *orig_d_space);
-
-   DBG_PRINT((1, "Creating the x_l_space_\n"));
-   // vector x_L
-   total_dim = orig_x_l_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   x_l_space_ = new CompoundVectorSpace(5, total_dim);
-   x_l_space_->SetCompSpace(0, *orig_x_l_space);
-   x_l_space_->SetCompSpace(1, *orig_c_space); // n_c >=0
-   x_l_space_->SetCompSpace(2, *orig_c_space); // p_c >=0
-   x_l_space_->SetCompSpace(3, *orig_d_space); // n_d >=0
-   x_l_space_->SetCompSpace(4, *orig_d_space); // p_d >=0
-
-   DBG_PRINT((1, "Setting the x_u_space_\n"));
-   // vector x_U
-   x_u_space_ = new CompoundVectorSpace(1, orig_x_u_space->Dim());
-   x_u_space_->SetCompSpace(0, *orig_x_u_space);
-
-   DBG_PRINT((1, "Creating the px_l_space_\n"));
-   // matrix px_l
-   Index total_rows = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   Index total_cols = orig_x_l_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   px_l_space_ = new CompoundMatrixSpace(5, 5, total_rows, total_cols);
-   px_l_space_->SetBlockRows(0, orig_x_space->Dim());
-   px_l_space_->SetBlockRows(1, orig_c_space->Dim());
-   px_l_space_->SetBlockRows(2, orig_c_space->Dim());
-   px_l_space_->SetBlockRows(3, orig_d_space->Dim());
-   px_l_space_->SetBlockRows(4, orig_d_space->Dim());
-   px_l_space_->SetBlockCols(0, orig_x_l_space->Dim());
-   px_l_space_->SetBlockCols(1, orig_c_space->Dim());
-   px_l_space_->SetBlockCols(2, orig_c_space->Dim());
-   px_l_space_->SetBlockCols(3, orig_d_space->Dim());
-   px_l_space_->SetBlockCols(4, orig_d_space->Dim());
-
-   px_l_space_->SetCompSpace(0, 0, *orig_px_l_space);
-   // now setup the identity matrix
-   // This could be changed to be something like...
-   // px_l_space_->SetBlockToIdentity(1,1,1.0);
-   // px_l_space_->SetBlockToIdentity(2,2,other_factor);
-   // ... etc with some simple changes to the CompoundMatrixSpace
-   // to allow this (space should auto create the matrices)
-   //
-   // for now, we use the new feature and set the true flag for this block
-   // to say that the matrices should be auto_allocated
-   SmartPtr<const MatrixSpace> identity_mat_space_nc = new IdentityMatrixSpace(orig_c_space->Dim());
-   px_l_space_->SetCompSpace(1, 1, *identity_mat_space_nc, true);
-   px_l_space_->SetCompSpace(2, 2, *identity_mat_space_nc, true);
-   SmartPtr<const MatrixSpace> identity_mat_space_nd = new IdentityMatrixSpace(orig_d_space->Dim());
-   px_l_space_->SetCompSpace(3, 3, *identity_mat_space_nd, true);
-   px_l_space_->SetCompSpace(4, 4, *identity_mat_space_nd, true);
-
-   DBG_PRINT((1, "Creating the px_u_space_\n"));
-   // matrix px_u
-   total_rows = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   total_cols = orig_x_u_space->Dim();
-   DBG_PRINT((1, "total_rows = %d, total_cols = %d\n", total_rows, total_cols));
-   px_u_space_ = new CompoundMatrixSpace(5, 1, total_rows, total_cols);
-   px_u_space_->SetBlockRows(0, orig_x_space->Dim());
-   px_u_space_->SetBlockRows(1, orig_c_space->Dim());
-   px_u_space_->SetBlockRows(2, orig_c_space->Dim());
-   px_u_space_->SetBlockRows(3, orig_d_space->Dim());
-   px_u_space_->SetBlockRows(4, orig_d_space->Dim());
-   px_u_space_->SetBlockCols(0, orig_x_u_space->Dim());
-
-   px_u_space_->SetCompSpace(0, 0, *orig_px_u_space);
-   // other matrices are zero'ed out
-
-   // vector d_L
-   //d_l_space_ = orig_d_l_space;
-   d_l_space_ = new CompoundVectorSpace(1, orig_d_l_space->Dim());
-   d_l_space_->SetCompSpace(0, *orig_d_l_space);
-
-   // vector d_U
-   //d_u_space_ = orig_d_u_space;
-   d_u_space_ = new CompoundVectorSpace(1, orig_d_u_space->Dim());
-   d_u_space_->SetCompSpace(0, *orig_d_u_space);
-
-   // matrix pd_L
-   //pd_l_space_ = orig_pd_l_space;
-   pd_l_space_ = new CompoundMatrixSpace(1, 1, orig_pd_l_space->NRows(), orig_pd_l_space->NCols());
-   pd_l_space_->SetBlockRows(0, orig_pd_l_space->NRows());
-   pd_l_space_->SetBlockCols(0, orig_pd_l_space->NCols());
-   pd_l_space_->SetCompSpace(0, 0, *orig_pd_l_space);
-
-   // matrix pd_U
-   //pd_u_space_ = orig_pd_u_space;
-   pd_u_space_ = new CompoundMatrixSpace(1, 1, orig_pd_u_space->NRows(), orig_pd_u_space->NCols());
-   pd_u_space_->SetBlockRows(0, orig_pd_u_space->NRows());
-   pd_u_space_->SetBlockCols(0, orig_pd_u_space->NCols());
-   pd_u_space_->SetCompSpace(0, 0, *orig_pd_u_space);
-
-   DBG_PRINT((1, "Creating the jac_c_space_\n"));
-   // matrix jac_c
-   total_rows = orig_c_space->Dim();
-   total_cols = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   jac_c_space_ = new CompoundMatrixSpace(1, 5, total_rows, total_cols);
-   jac_c_space_->SetBlockRows(0, orig_c_space->Dim());
-   jac_c_space_->SetBlockCols(0, orig_x_space->Dim());
-   jac_c_space_->SetBlockCols(1, orig_c_space->Dim());
-   jac_c_space_->SetBlockCols(2, orig_c_space->Dim());
-   jac_c_space_->SetBlockCols(3, orig_d_space->Dim());
-   jac_c_space_->SetBlockCols(4, orig_d_space->Dim());
-
-   jac_c_space_->SetCompSpace(0, 0, *orig_jac_c_space);
-   // **NOTE: By placing "flat" identity matrices here, we are creating
-   //         potential issues for linalg operations that arise when the original
-   //         NLP has a "compound" c_space. To avoid problems like this,
-   //         we place all unmodified component spaces in trivial (size 1)
-   //         "compound" spaces.
-   jac_c_space_->SetCompSpace(0, 1, *identity_mat_space_nc, true);
-   jac_c_space_->SetCompSpace(0, 2, *identity_mat_space_nc, true);
-   // remaining blocks are zero'ed
-
-   DBG_PRINT((1, "Creating the jac_d_space_\n"));
-   // matrix jac_d
-   total_rows = orig_d_space->Dim();
-   total_cols = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   jac_d_space_ = new CompoundMatrixSpace(1, 5, total_rows, total_cols);
-   jac_d_space_->SetBlockRows(0, orig_d_space->Dim());
-   jac_d_space_->SetBlockCols(0, orig_x_space->Dim());
-   jac_d_space_->SetBlockCols(1, orig_c_space->Dim());
-   jac_d_space_->SetBlockCols(2, orig_c_space->Dim());
-   jac_d_space_->SetBlockCols(3, orig_d_space->Dim());
-   jac_d_space_->SetBlockCols(4, orig_d_space->Dim());
-
-   jac_d_space_->SetCompSpace(0, 0, *orig_jac_d_space);
-   DBG_PRINT((1, "orig_jac_d_space = %x\n", GetRawPtr(orig_jac_d_space)))
-   // Blocks (0,1) and (0,2) are zero'ed out
-   // **NOTE: By placing "flat" identity matrices here, we are creating
-   //         potential issues for linalg operations that arise when the original
-   //         NLP has a "compound" d_space. To avoid problems like this,
-   //         we place all unmodified component spaces in trivial (size 1)
-   //         "compound" spaces.
-   jac_d_space_->SetCompSpace(0, 3, *identity_mat_space_nd, true);
-   jac_d_space_->SetCompSpace(0, 4, *identity_mat_space_nd, true);
-
-   DBG_PRINT((1, "Creating the h_space_\n"));
-   // matrix h
-   total_dim = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
-   h_space_ = new CompoundSymMatrixSpace(5, total_dim);
-   h_space_->SetBlockDim(0, orig_x_space->Dim());
-   h_space_->SetBlockDim(1, orig_c_space->Dim());
-   h_space_->SetBlockDim(2, orig_c_space->Dim());
-   h_space_->SetBlockDim(3, orig_d_space->Dim());
-   h_space_->SetBlockDim(4, orig_d_space->Dim());
-
-   SmartPtr<DiagMatrixSpace> DR_x_space = new DiagMatrixSpace(orig_x_space->Dim());
-   if( hessian_approximation_ == LIMITED_MEMORY )
-   {
-      const LowRankUpdateSymMatrixSpace* LR_h_space = static_cast<const LowRankUpdateSymMatrixSpace*>(GetRawPtr(
-               orig_h_space));
-      DBG_ASSERT(LR_h_space);
-      SmartPtr<LowRankUpdateSymMatrixSpace> new_orig_h_space = new LowRankUpdateSymMatrixSpace(LR_h_space->Dim(),
-            NULL, orig_x_space, false);
-      h_space_->SetCompSpace(0, 0, *new_orig_h_space, true);
-   }
-   else
+   // The spaces are kept from a previous restoration phase if the
+   // spaces of the original problem did not change, so that they
+   // are not rebuilt for every call of the restoration phase
+   if( !HaveSpacesFor(orig_x_space, orig_c_space, orig_d_space, orig_x_l_space, orig_px_l_space, orig_x_u_space,
+                      orig_px_u_space, orig_d_l_space, orig_pd_l_space, orig_d_u_space, orig_pd_u_space, orig_jac_c_space,
+                      orig_jac_d_space, orig_h_space) )
    {
-      SmartPtr<SumSymMatrixSpace> sumsym_mat_space = new SumSymMatrixSpace(orig_x_space->Dim(), 2);
-      sumsym_mat_space->SetTermSpace(0, *orig_h_space);
-      sumsym_mat_space->SetTermSpace(1, *DR_x_space);
-      h_space_->SetCompSpace(0, 0, *sumsym_mat_space, true);
-      // All remaining blocks are zero'ed out
+      // Create the restoration phase problem vector/matrix spaces, based
+      // on the original spaces (pretty inconvenient with all the
+      // matrix spaces, isn't it?!?)
+      DBG_PRINT((1, "Creating the x_space_\n"));
+      // vector x
+      Index total_dim = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      x_space_ = new CompoundVectorSpace(5, total_dim);
+      x_space_->SetCompSpace(0, *orig_x_space);
+      x_space_->SetCompSpace(1, *orig_c_space); // n_c
+      x_space_->SetCompSpace(2, *orig_c_space); // p_c
+      x_space_->SetCompSpace(3, *orig_d_space); // n_d
+      x_space_->SetCompSpace(4, *orig_d_space); // p_d
+
+      DBG_PRINT((1, "Setting the c_space_\n"));
+      // vector c
+      //c_space_ = orig_c_space;
+      c_space_ = new CompoundVectorSpace(1, orig_c_space->Dim());
+      c_space_->SetCompSpace(0, *orig_c_space);
+
+      DBG_PRINT((1, "Setting the d_space_\n"));
+      // vector d
+      //d_space_ = orig_d_space;
+      d_space_ = new CompoundVectorSpace(1, orig_d_space->Dim());
+      d_space_->SetCompSpace(0, *orig_d_space);
+
+      DBG_PRINT((1, "Creating the x_l_space_\n"));
+      // vector x_L
+      total_dim = orig_x_l_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      x_l_space_ = new CompoundVectorSpace(5, total_dim);
+      x_l_space_->SetCompSpace(0, *orig_x_l_space);
+      x_l_space_->SetCompSpace(1, *orig_c_space); // n_c >=0
+      x_l_space_->SetCompSpace(2, *orig_c_space); // p_c >=0
+      x_l_space_->SetCompSpace(3, *orig_d_space); // n_d >=0
+      x_l_space_->SetCompSpace(4, *orig_d_space); // p_d >=0
+
+      DBG_PRINT((1, "Setting the x_u_space_\n"));
+      // vector x_U
+      x_u_space_ = new CompoundVectorSpace(1, orig_x_u_space->Dim());
+      x_u_space_->SetCompSpace(0, *orig_x_u_space);
+
+      DBG_PRINT((1, "Creating the px_l_space_\n"));
+      // matrix px_l
+      Index total_rows = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      Index total_cols = orig_x_l_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      px_l_space_ = new CompoundMatrixSpace(5, 5, total_rows, total_cols);
+      px_l_space_->SetBlockRows(0, orig_x_space->Dim());
+      px_l_space_->SetBlockRows(1, orig_c_space->Dim());
+      px_l_space_->SetBlockRows(2, orig_c_space->Dim());
+      px_l_space_->SetBlockRows(3, orig_d_space->Dim());
+      px_l_space_->SetBlockRows(4, orig_d_space->Dim());
+      px_l_space_->SetBlockCols(0, orig_x_l_space->Dim());
+      px_l_space_->SetBlockCols(1, orig_c_space->Dim());
+      px_l_space_->SetBlockCols(2, orig_c_space->Dim());
+      px_l_space_->SetBlockCols(3, orig_d_space->Dim());
+      px_l_space_->SetBlockCols(4, orig_d_space->Dim());
+
+      px_l_space_->SetCompSpace(0, 0, *orig_px_l_space);
+      // now setup the identity matrix
+      // This could be changed to be something like...
+      // px_l_space_->SetBlockToIdentity(1,1,1.0);
+      // px_l_space_->SetBlockToIdentity(2,2,other_factor);
+      // ... etc with some simple changes to the CompoundMatrixSpace
+      // to allow this (space should auto create the matrices)
+      //
+      // for now, we use the new feature and set the true flag for this block
+      // to say that the matrices should be auto_allocated
+      SmartPtr<const MatrixSpace> identity_mat_space_nc = new IdentityMatrixSpace(orig_c_space->Dim());
+      px_l_space_->SetCompSpace(1, 1, *identity_mat_space_nc, true);
+      px_l_space_->SetCompSpace(2, 2, *identity_mat_space_nc, true);
+      SmartPtr<const MatrixSpace> identity_mat_space_nd = new IdentityMatrixSpace(orig_d_space->Dim());
+      px_l_space_->SetCompSpace(3, 3, *identity_mat_space_nd, true);
+      px_l_space_->SetCompSpace(4, 4, *identity_mat_space_nd, true);
+
+      DBG_PRINT((1, "Creating the px_u_space_\n"));
+      // matrix px_u
+      total_rows = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      total_cols = orig_x_u_space->Dim();
+      DBG_PRINT((1, "total_rows = %d, total_cols = %d\n", total_rows, total_cols));
+      px_u_space_ = new CompoundMatrixSpace(5, 1, total_rows, total_cols);
+      px_u_space_->SetBlockRows(0, orig_x_space->Dim());
+      px_u_space_->SetBlockRows(1, orig_c_space->Dim());
+      px_u_space_->SetBlockRows(2, orig_c_space->Dim());
+      px_u_space_->SetBlockRows(3, orig_d_space->Dim());
+      px_u_space_->SetBlockRows(4, orig_d_space->Dim());
+      px_u_space_->SetBlockCols(0, orig_x_u_space->Dim());
+
+      px_u_space_->SetCompSpace(0, 0, *orig_px_u_space);
+      // other matrices are zero'ed out
+
+      // vector d_L
+      //d_l_space_ = orig_d_l_space;
+      d_l_space_ = new CompoundVectorSpace(1, orig_d_l_space->Dim());
+      d_l_space_->SetCompSpace(0, *orig_d_l_space);
+
+      // vector d_U
+      //d_u_space_ = orig_d_u_space;
+      d_u_space_ = new CompoundVectorSpace(1, orig_d_u_space->Dim());
+      d_u_space_->SetCompSpace(0, *orig_d_u_space);
+
+      // matrix pd_L
+      //pd_l_space_ = orig_pd_l_space;
+      pd_l_space_ = new CompoundMatrixSpace(1, 1, orig_pd_l_space->NRows(), orig_pd_l_space->NCols());
+      pd_l_space_->SetBlockRows(0, orig_pd_l_space->NRows());
+      pd_l_space_->SetBlockCols(0, orig_pd_l_space->NCols());
+      pd_l_space_->SetCompSpace(0, 0, *orig_pd_l_space);
+
+      // matrix pd_U
+      //pd_u_space_ = orig_pd_u_space;
+      pd_u_space_ = new CompoundMatrixSpace(1, 1, orig_pd_u_space->NRows(), orig_pd_u_space->NCols());
+      pd_u_space_->SetBlockRows(0, orig_pd_u_space->NRows());
+      pd_u_space_->SetBlockCols(0, orig_pd_u_space->NCols());
+      pd_u_space_->SetCompSpace(0, 0, *orig_pd_u_space);
+
+      DBG_PRINT((1, "Creating the jac_c_space_\n"));
+      // matrix jac_c
+      total_rows = orig_c_space->Dim();
+      total_cols = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      jac_c_space_ = new CompoundMatrixSpace(1, 5, total_rows, total_cols);
+      jac_c_space_->SetBlockRows(0, orig_c_space->Dim());
+      jac_c_space_->SetBlockCols(0, orig_x_space->Dim());
+      jac_c_space_->SetBlockCols(1, orig_c_space->Dim());
+      jac_c_space_->SetBlockCols(2, orig_c_space->Dim());
+      jac_c_space_->SetBlockCols(3, orig_d_space->Dim());
+      jac_c_space_->SetBlockCols(4, orig_d_space->Dim());
+
+      jac_c_space_->SetCompSpace(0, 0, *orig_jac_c_space);
+      // **NOTE: By placing "flat" identity matrices here, we are creating
+      //         potential issues for linalg operations that arise when the original
+      //         NLP has a "compound" c_space. To avoid problems like this,
+      //         we place all unmodified component spaces in trivial (size 1)
+      //         "compound" spaces.
+      jac_c_space_->SetCompSpace(0, 1, *identity_mat_space_nc, true);
+      jac_c_space_->SetCompSpace(0, 2, *identity_mat_space_nc, true);
+      // remaining blocks are zero'ed
+
+      DBG_PRINT((1, "Creating the jac_d_space_\n"));
+      // matrix jac_d
+      total_rows = orig_d_space->Dim();
+      total_cols = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      jac_d_space_ = new CompoundMatrixSpace(1, 5, total_rows, total_cols);
+      jac_d_space_->SetBlockRows(0, orig_d_space->Dim());
+      jac_d_space_->SetBlockCols(0, orig_x_space->Dim());
+      jac_d_space_->SetBlockCols(1, orig_c_space->Dim());
+      jac_d_space_->SetBlockCols(2, orig_c_space->Dim());
+      jac_d_space_->SetBlockCols(3, orig_d_space->Dim());
+      jac_d_space_->SetBlockCols(4, orig_d_space->Dim());
+
+      jac_d_space_->SetCompSpace(0, 0, *orig_jac_d_space);
+      DBG_PRINT((1, "orig_jac_d_space = %x\n", GetRawPtr(orig_jac_d_space)))
+      // Blocks (0,1) and (0,2) are zero'ed out
+      // **NOTE: By placing "flat" identity matrices here, we are creating
+      //         potential issues for linalg operations that arise when the original
+      //         NLP has a "compound" d_space. To avoid problems like this,
+      //         we place all unmodified component spaces in trivial (size 1)
+      //         "compound" spaces.
+      jac_d_space_->SetCompSpace(0, 3, *identity_mat_space_nd, true);
+      jac_d_space_->SetCompSpace(0, 4, *identity_mat_space_nd, true);
+
+      DBG_PRINT((1, "Creating the h_space_\n"));
+      // matrix h
+      total_dim = orig_x_space->Dim() + 2 * orig_c_space->Dim() + 2 * orig_d_space->Dim();
+      h_space_ = new CompoundSymMatrixSpace(5, total_dim);
+      h_space_->SetBlockDim(0, orig_x_space->Dim());
+      h_space_->SetBlockDim(1, orig_c_space->Dim());
+      h_space_->SetBlockDim(2, orig_c_space->Dim());
+      h_space_->SetBlockDim(3, orig_d_space->Dim());
+      h_space_->SetBlockDim(4, orig_d_space->Dim());
+
+      DR_x_space_ = new DiagMatrixSpace(orig_x_space->Dim());
+      if( hessian_approximation_ == LIMITED_MEMORY )
+      {
+         const LowRankUpdateSymMatrixSpace* LR_h_space = static_cast<const LowRankUpdateSymMatrixSpace*>(GetRawPtr(
+                  orig_h_space));
+         DBG_ASSERT(LR_h_space);
+         SmartPtr<LowRankUpdateSymMatrixSpace> new_orig_h_space = new LowRankUpdateSymMatrixSpace(LR_h_space->Dim(),
+               NULL, orig_x_space, false);
+         h_space_->SetCompSpace(0, 0, *new_orig_h_space, true);
+      }
+      else
+      {
+         SmartPtr<SumSymMatrixSpace> sumsym_mat_space = new SumSymMatrixSpace(orig_x_space->Dim(), 2);
+         sumsym_mat_space->SetTermSpace(0, *orig_h_space);
+         sumsym_mat_space->SetTermSpace(1, *DR_x_space_);
+         h_space_->SetCompSpace(0, 0, *sumsym_mat_space, true);
+         // All remaining blocks are zero'ed out
+      }
    }
 
    ///////////////////////////
@@ -436,12 +444,58 @@ bool RestoIpoptNLP::InitializeStructures(
    dr_x_->ElementWiseMax(*tmp);
    dr_x_->ElementWiseReciprocal();
    DBG_PRINT_VECTOR(2, "dr_x_", *dr_x_);
-   DR_x_ = DR_x_space->MakeNewDiagMatrix();
+   DR_x_ = DR_x_space_->MakeNewDiagMatrix();
    DR_x_->SetDiag(*dr_x_);
 
    return true;
 }
 
+bool RestoIpoptNLP::HaveSpacesFor(
+   const SmartPtr<const VectorSpace>&    orig_x_space,
+   const SmartPtr<const VectorSpace>&    orig_c_space,
+   const SmartPtr<const VectorSpace>&    orig_d_space,
+   const SmartPtr<const VectorSpace>&    orig_x_l_space,
+   const SmartPtr<const MatrixSpace>&    orig_px_l_space,
+   const SmartPtr<const VectorSpace>&    orig_x_u_space,
+   const SmartPtr<const MatrixSpace>&    orig_px_u_space,
+   const SmartPtr<const VectorSpace>&    orig_d_l_space,
+   const SmartPtr<const MatrixSpace>&    orig_pd_l_space,
+   const SmartPtr<const VectorSpace>&    orig_d_u_space,
+   const SmartPtr<const MatrixSpace>&    orig_pd_u_space,
+   const SmartPtr<const MatrixSpace>&    orig_jac_c_space,
+   const SmartPtr<const MatrixSpace>&    orig_jac_d_space,
+   const SmartPtr<const SymMatrixSpace>& orig_h_space
+) const
+{
+   if( IsNull(x_space_) )
+   {
+      return false;
+   }
+
+   // the spaces of the original problem are kept as components of
+   // the restoration phase spaces
+   if( x_space_->GetCompSpace(0) != orig_x_space || x_space_->GetCompSpace(1) != orig_c_space
+       || x_space_->GetCompSpace(3) != orig_d_space || x_l_space_->GetCompSpace(0) != orig_x_l_space
+       || x_u_space_->GetCompSpace(0) != orig_x_u_space || d_l_space_->GetCompSpace(0) != orig_d_l_space
+       || d_u_space_->GetCompSpace(0) != orig_d_u_space || px_l_space_->GetCompSpace(0, 0) != orig_px_l_space
+       || px_u_space_->GetCompSpace(0, 0) != orig_px_u_space || pd_l_space_->GetCompSpace(0, 0) != orig_pd_l_space
+       || pd_u_space_->GetCompSpace(0, 0) != orig_pd_u_space || jac_c_space_->GetCompSpace(0, 0) != orig_jac_c_space
+       || jac_d_space_->GetCompSpace(0, 0) != orig_jac_d_space )
+   {
+      return false;
+   }
+
+   // for a limited-memory approximation, the Hessian space only
+   // depends on the space of x, otherwise it contains the original one
+   SmartPtr<const MatrixSpace> h_comp_space = h_space_->GetCompSpace(0, 0);
+   const SumSymMatrixSpace* sumsym_mat_space = dynamic_cast<const SumSymMatrixSpace*>(GetRawPtr(h_comp_space));
+   if( hessian_approximation_ == LIMITED_MEMORY )
+   {
+      return sumsym_mat_space == NULL;
+   }
+   return sumsym_mat_space != NULL && sumsym_mat_space->GetTermSpace(0) == orig_h_space;
+}
+
 Number RestoIpoptNLP::f(
    const Vector& /*x*/
 )
@@ -534,6 +588,16 @@ SmartPtr<const Vector> RestoIpoptNLP::c(
    return GetRawPtr(retPtr);
 }
 
+bool RestoIpoptNLP::EvaluateFunctions(
+   const Vector& x
+)
+{
+   const CompoundVector* c_vec = static_cast<const CompoundVector*>(&x);
+   SmartPtr<const Vector> x_only = c_vec->GetComp(0);
+
+   return orig_ip_nlp_->EvaluateConstraints(*x_only);
+}
+
 SmartPtr<const Vector> RestoIpoptNLP::grad_f(
    const Vector& /*x*/
 )
@@ -681,6 +745,17 @@ SmartPtr<const SymMatrix> RestoIpoptNLP::h(
    // calculate the original hessian
    SmartPtr<const SymMatrix> h_con_orig = orig_ip_nlp_->h(*x_only, 0.0, *Cyc0, *Cyd0);
 
+   return h_from_orig(*h_con_orig, obj_factor, mu);
+}
+
+SmartPtr<const SymMatrix> RestoIpoptNLP::h_from_orig(
+   const SymMatrix& h_con_orig,
+   Number           obj_factor,
+   Number           mu
+)
+{
+   DBG_ASSERT(hessian_approximation_ != LIMITED_MEMORY);
+
    // Create the new compound matrix
    // The SumSymMatrix is auto_allocated
    SmartPtr<CompoundSymMatrix> retPtr = h_space_->MakeNewCompoundSymMatrix();
@@ -688,7 +763,7 @@ SmartPtr<const SymMatrix> RestoIpoptNLP::h(
    // Set the entries in the SumSymMatrix
    SmartPtr<Matrix> h_sum_mat = retPtr->GetCompNonConst(0, 0);
    SmartPtr<SumSymMatrix> h_sum = static_cast<SumSymMatrix*>(GetRawPtr(h_sum_mat));
-   h_sum->SetTerm(0, 1.0, *h_con_orig);
+   h_sum->SetTerm(0, 1.0, h_con_orig);
    h_sum->SetTerm(1, obj_factor * Eta(mu), *DR_x_);
 
    return GetRawPtr(retPtr);
@@ -136,6 +136,15 @@ public:
       const Vector& x
    );
 
+   /** Evaluates the constraints of the original NLP at the x part of x.
+    *
+    *  The objective function does not require evaluations of the
+    *  original NLP.
+    */
+   virtual bool EvaluateFunctions(
+      const Vector& x
+   );
+
    /** Jacobian Matrix for inequality constraints */
    virtual SmartPtr<const Matrix> jac_d(
       const Vector& x
@@ -158,6 +167,18 @@ public:
       Number        mu
    );
 
+   /** Hessian of the Lagrangian for a given constraint-only part of
+    *  the Hessian of the original problem.
+    *
+    *  This is used by a quasi-Newton approximation of that part,
+    *  which is not available through h() then.
+    */
+   SmartPtr<const SymMatrix> h_from_orig(
+      const SymMatrix& h_con_orig,
+      Number           obj_factor,
+      Number           mu
+   );
+
    /** Provides a Hessian matrix from the correct matrix space with
     *  uninitialized values.
     *
@@ -388,6 +409,9 @@ private:
    SmartPtr<CompoundMatrixSpace> jac_d_space_;
 
    SmartPtr<CompoundSymMatrixSpace> h_space_;
+
+   /** Space of the diagonal scaling matrix for the proximity term */
+   SmartPtr<DiagMatrixSpace> DR_x_space_;
    ///@}
 
    /**@name Storage for Model Quantities */
@@ -463,6 +487,29 @@ private:
    );
    ///@}
 
+   /** Method checking whether the vector and matrix spaces have already
+    *  been created for the given spaces of the original problem.
+    *
+    *  In that case, InitializeStructures does not need to create them
+    *  again when the restoration phase is started another time.
+    */
+   bool HaveSpacesFor(
+      const SmartPtr<const VectorSpace>&    orig_x_space,
+      const SmartPtr<const VectorSpace>&    orig_c_space,
+      const SmartPtr<const VectorSpace>&    orig_d_space,
+      const SmartPtr<const VectorSpace>&    orig_x_l_space,
+      const SmartPtr<const MatrixSpace>&    orig_px_l_space,
+      const SmartPtr<const VectorSpace>&    orig_x_u_space,
+      const SmartPtr<const MatrixSpace>&    orig_px_u_space,
+      const SmartPtr<const VectorSpace>&    orig_d_l_space,
+      const SmartPtr<const MatrixSpace>&    orig_pd_l_space,
+      const SmartPtr<const VectorSpace>&    orig_d_u_space,
+      const SmartPtr<const MatrixSpace>&    orig_pd_u_space,
+      const SmartPtr<const MatrixSpace>&    orig_jac_c_space,
+      const SmartPtr<const MatrixSpace>&    orig_jac_d_space,
+      const SmartPtr<const SymMatrixSpace>& orig_h_space
+   ) const;
+
    /** @name Algorithmic parameter */
    ///@{
    /** Flag indicating if evaluation of the objective should be
@@ -72,7 +72,7 @@ void RestoIterationOutput::WriteOutput()
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n\n**************************************************\n");
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "*** Summary of Iteration %d for original NLP:", IpData().iter_count());
+                  "*** Summary of Iteration %" IPOPT_INDEX_FORMAT " for original NLP:", IpData().iter_count());
    Jnlst().Printf(J_DETAILED, J_MAIN,
                   "\n**************************************************\n\n");
    if( IpData().info_iters_since_header() >= 10 && !IsValid(resto_orig_iteration_output_) )
@@ -88,74 +88,80 @@ void RestoIterationOutput::WriteOutput()
                      header.c_str());
    }
 
-   // For now, just print the total NLP error for the restoration
-   // phase problem in the dual infeasibility column
-   Number inf_du = IpCq().curr_dual_infeasibility(NORM_MAX);
-
-   Number mu = IpData().curr_mu();
-   Number dnrm = 0.;
-   if( IsValid(IpData().delta()) && IsValid(IpData().delta()->x()) && IsValid(IpData().delta()->s()) )
-   {
-      dnrm = Max(IpData().delta()->x()->Amax(), IpData().delta()->s()->Amax());
-   }
-
-   // Set  the trial  values  for  the original  Data  object to  the
-   // current restoration phase values
-   SmartPtr<const Vector> x = IpData().curr()->x();
-   const CompoundVector* cx = static_cast<const CompoundVector*>(GetRawPtr(x));
-   DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(x)));
-   SmartPtr<const Vector> s = IpData().curr()->s();
-   const CompoundVector* cs = static_cast<const CompoundVector*>(GetRawPtr(s));
-   DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(s)));
-
-   SmartPtr<IteratesVector> trial = orig_ip_data->trial()->MakeNewContainer();
-   trial->Set_x(*cx->GetComp(0));
-   trial->Set_s(*cs->GetComp(0));
-   orig_ip_data->set_trial(trial);
-
-   // Compute primal infeasibility
-   Number inf_pr = 0.0;
-   switch( inf_pr_output_ )
-   {
-      case INTERNAL:
-         inf_pr = orig_ip_cq->trial_primal_infeasibility(NORM_MAX);
-         break;
-      case ORIGINAL:
-         inf_pr = orig_ip_cq->unscaled_trial_nlp_constraint_violation(NORM_MAX);
-         break;
-   }
-   // Compute original objective function
-   Number f = orig_ip_cq->unscaled_trial_f();
-
-   // Retrieve some information set in the different parts of the algorithm
-   char info_iter = 'r';
-
-   Number alpha_primal = IpData().info_alpha_primal();
-   char alpha_primal_char = IpData().info_alpha_primal_char();
-   Number alpha_dual = IpData().info_alpha_dual();
-   Number regu_x = IpData().info_regu_x();
-   char regu_x_buf[8];
-   char dashes[] = "   - ";
-   char* regu_x_ptr;
-   if( regu_x == .0 )
-   {
-      regu_x_ptr = dashes;
-   }
-   else
-   {
-      Snprintf(regu_x_buf, 7, "%5.1f", log10(regu_x));
-      regu_x_ptr = regu_x_buf;
-   }
-   Index ls_count = IpData().info_ls_count();
-   const std::string info_string = IpData().info_string();
-
    Number current_time = 0.0;
    Number last_output = IpData().info_last_output();
-   if( (iter % print_frequency_iter_) == 0 && (print_frequency_time_ == 0.0 || last_output < (current_time =
-            WallclockTime()) - print_frequency_time_ || last_output < 0.0) )
+   bool summary_line = (iter % print_frequency_iter_) == 0
+                       && (print_frequency_time_ == 0.0 || last_output < (current_time = WallclockTime()) - print_frequency_time_
+                           || last_output < 0.0);
+
+   // the quantities of the summary line, in particular the
+   // infeasibility of the original NLP, are only computed if some
+   // journal prints the line
+   if( summary_line && Jnlst().ProduceOutput(J_ITERSUMMARY, J_MAIN) )
    {
+      // For now, just print the total NLP error for the restoration
+      // phase problem in the dual infeasibility column
+      Number inf_du = IpCq().curr_dual_infeasibility(NORM_MAX);
+
+      Number mu = IpData().curr_mu();
+      Number dnrm = 0.;
+      if( IsValid(IpData().delta()) && IsValid(IpData().delta()->x()) && IsValid(IpData().delta()->s()) )
+      {
+         dnrm = Max(IpData().delta()->x()->Amax(), IpData().delta()->s()->Amax());
+      }
+
+      // Set  the trial  values  for  the original  Data  object to  the
+      // current restoration phase values
+      SmartPtr<const Vector> x = IpData().curr()->x();
+      const CompoundVector* cx = static_cast<const CompoundVector*>(GetRawPtr(x));
+      DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(x)));
+      SmartPtr<const Vector> s = IpData().curr()->s();
+      const CompoundVector* cs = static_cast<const CompoundVector*>(GetRawPtr(s));
+      DBG_ASSERT(dynamic_cast<const CompoundVector*>(GetRawPtr(s)));
+
+      SmartPtr<IteratesVector> trial = orig_ip_data->trial()->MakeNewContainer();
+      trial->Set_x(*cx->GetComp(0));
+      trial->Set_s(*cs->GetComp(0));
+      orig_ip_data->set_trial(trial);
+
+      // Compute primal infeasibility
+      Number inf_pr = 0.0;
+      switch( inf_pr_output_ )
+      {
+         case INTERNAL:
+            inf_pr = orig_ip_cq->trial_primal_infeasibility(NORM_MAX);
+            break;
+         case ORIGINAL:
+            inf_pr = orig_ip_cq->unscaled_trial_nlp_constraint_violation(NORM_MAX);
+            break;
+      }
+      // Compute original objective function
+      Number f = orig_ip_cq->unscaled_trial_f();
+
+      // Retrieve some information set in the different parts of the algorithm
+      char info_iter = 'r';
+
+      Number alpha_primal = IpData().info_alpha_primal();
+      char alpha_primal_char = IpData().info_alpha_primal_char();
+      Number alpha_dual = IpData().info_alpha_dual();
+      Number regu_x = IpData().info_regu_x();
+      char regu_x_buf[8];
+      char dashes[] = "   - ";
+      char* regu_x_ptr;
+      if( regu_x == .0 )
+      {
+         regu_x_ptr = dashes;
+      }
+      else
+      {
+         Snprintf(regu_x_buf, 7, "%5.1f", log10(regu_x));
+         regu_x_ptr = regu_x_buf;
+      }
+      Index ls_count = IpData().info_ls_count();
+      const std::string info_string = IpData().info_string();
+
       Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
-                     "%4d%c%14.7e %7.2e %7.2e %5.1f %7.2e %5s %7.2e %7.2e%c%3d", iter, info_iter, f, inf_pr, inf_du, log10(mu), dnrm, regu_x_ptr, alpha_dual, alpha_primal, alpha_primal_char, ls_count);
+                     "%4" IPOPT_INDEX_FORMAT "%c%14.7e %7.2e %7.2e %5.1f %7.2e %5s %7.2e %7.2e%c%3" IPOPT_INDEX_FORMAT, iter, info_iter, f, inf_pr, inf_du, log10(mu), dnrm, regu_x_ptr, alpha_dual, alpha_primal, alpha_primal_char, ls_count);
       if( print_info_string_ )
       {
          Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
@@ -168,7 +174,10 @@ void RestoIterationOutput::WriteOutput()
       }
       Jnlst().Printf(J_ITERSUMMARY, J_MAIN,
                      "\n");
+   }
 
+   if( summary_line )
+   {
       IpData().Set_info_last_output(current_time);
       IpData().Inc_info_iters_since_header();
    }
@@ -182,7 +191,7 @@ void RestoIterationOutput::WriteOutput()
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      "\n**************************************************\n");
       Jnlst().Printf(J_DETAILED, J_MAIN,
-                     "*** Beginning Iteration %d from the following point:", IpData().iter_count());
+                     "*** Beginning Iteration %" IPOPT_INDEX_FORMAT " from the following point:", IpData().iter_count());
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      "\n**************************************************\n\n");
 
@@ -266,7 +275,7 @@ void RestoIterationOutput::WriteOutput()
    if( Jnlst().ProduceOutput(J_DETAILED, J_MAIN) )
    {
       Jnlst().Printf(J_DETAILED, J_MAIN,
-                     "\n\n***Current NLP Values for Iteration (Restoration phase problem) %d:\n", IpData().iter_count());
+                     "\n\n***Current NLP Values for Iteration (Restoration phase problem) %" IPOPT_INDEX_FORMAT ":\n", IpData().iter_count());
       Jnlst().Printf(J_DETAILED, J_MAIN,
                      "\n                                   (scaled)                 (unscaled)\n");
       Jnlst().Printf(J_DETAILED, J_MAIN,
@@ -8,6 +8,7 @@
 #include "IpCompoundVector.hpp"
 #include "IpRestoIpoptNLP.hpp"
 #include "IpDefaultIterateInitializer.hpp"
+#include "IpCheckpoint.hpp"
 
 namespace Ipopt
 {
@@ -21,7 +22,8 @@ MinC_1NrmRestorationPhase::MinC_1NrmRestorationPhase(
 )
    : resto_alg_(&resto_alg),
      eq_mult_calculator_(eq_mult_calculator),
-     resto_options_(NULL)
+     resto_options_(NULL),
+     resto_ip_nlp_(NULL)
 {
    DBG_ASSERT(IsValid(resto_alg_));
 }
@@ -110,14 +112,20 @@ bool MinC_1NrmRestorationPhase::PerformRestoration()
    // Increase counter for restoration phase calls
    count_restorations_++;
    Jnlst().Printf(J_DETAILED, J_MAIN,
-                  "Starting Restoration Phase for the %d. time\n", count_restorations_);
+                  "Starting Restoration Phase for the %" IPOPT_INDEX_FORMAT ". time\n", count_restorations_);
 
    DBG_ASSERT(IpCq().curr_constraint_violation() > 0.);
 
-   // ToDo set those up during initialize?
-   // Create the restoration phase NLP etc objects
+   // Create the restoration phase NLP etc objects.  The restoration
+   // phase NLP is kept from the previous call for the same original
+   // problem, so that it does not need to create its spaces again.
    SmartPtr<IpoptData> resto_ip_data = new IpoptData(NULL, IpData().cpu_time_start());
-   SmartPtr<IpoptNLP> resto_ip_nlp = new RestoIpoptNLP(IpNLP(), IpData(), IpCq());
+   if( IsNull(resto_ip_nlp_) || &resto_ip_nlp_->OrigIpNLP() != &IpNLP() || &resto_ip_nlp_->OrigIpData() != &IpData()
+       || &resto_ip_nlp_->OrigIpCq() != &IpCq() )
+   {
+      resto_ip_nlp_ = new RestoIpoptNLP(IpNLP(), IpData(), IpCq());
+   }
+   SmartPtr<IpoptNLP> resto_ip_nlp = GetRawPtr(resto_ip_nlp_);
    SmartPtr<IpoptCalculatedQuantities> resto_ip_cq = new IpoptCalculatedQuantities(resto_ip_nlp, resto_ip_data);
 
    // Determine if this is a square problem
@@ -158,6 +166,7 @@ bool MinC_1NrmRestorationPhase::PerformRestoration()
    resto_ip_data->Set_info_ls_count(IpData().info_ls_count());
    resto_ip_data->Set_info_iters_since_header(IpData().info_iters_since_header());
    resto_ip_data->Set_info_last_output(IpData().info_last_output());
+   resto_ip_data->ShareWorkCounts(IpData());
 
    // Call the optimization algorithm to solve the restoration phase
    // problem
@@ -229,7 +238,7 @@ bool MinC_1NrmRestorationPhase::PerformRestoration()
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
                         "Optimal Objective Value = %.16E\n", resto_ip_cq->curr_f());
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                        "Number of Iterations = %d\n", resto_ip_data->iter_count());
+                        "Number of Iterations = %" IPOPT_INDEX_FORMAT "\n", resto_ip_data->iter_count());
       }
       if( Jnlst().ProduceOutput(J_VECTOR, J_LINE_SEARCH) )
       {
@@ -398,4 +407,21 @@ void MinC_1NrmRestorationPhase::ComputeBoundMultiplierStep(
    delta_z.Axpy(-1., curr_z);
 }
 
+void MinC_1NrmRestorationPhase::WriteCheckpoint(
+   Checkpoint& checkpoint
+) const
+{
+   // the restoration phase algorithm is initialized anew for each call
+   checkpoint.WriteSection("MinC_1NrmRestorationPhase");
+   checkpoint.WriteIndex(count_restorations_);
+}
+
+void MinC_1NrmRestorationPhase::ReadCheckpoint(
+   Checkpoint& checkpoint
+)
+{
+   checkpoint.ReadSection("MinC_1NrmRestorationPhase");
+   count_restorations_ = checkpoint.ReadIndex();
+}
+
 } // namespace Ipopt
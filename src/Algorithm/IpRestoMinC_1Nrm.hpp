@@ -14,6 +14,8 @@
 namespace Ipopt
 {
 
+class RestoIpoptNLP;
+
 /** Restoration Phase that minimizes the 1-norm of the constraint
  *  violation - using the interior point method (Ipopt).
  */
@@ -44,6 +46,16 @@ public:
       const std::string& prefix
    );
 
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void WriteCheckpoint(
+      Checkpoint& checkpoint
+   ) const;
+
+   /** overloaded from AlgorithmStrategyObject */
+   virtual void ReadCheckpoint(
+      Checkpoint& checkpoint
+   );
+
    static void RegisterOptions(
       SmartPtr<RegisteredOptions> roptions
    );
@@ -87,6 +99,10 @@ private:
     */
    SmartPtr<OptionsList> resto_options_;
 
+   /** Restoration phase NLP from the previous call, which is kept so
+    *  that its vector and matrix spaces can be reused */
+   SmartPtr<RestoIpoptNLP> resto_ip_nlp_;
+
    /** @name Algorithmic parameters */
    ///@{
    Number constr_mult_reset_threshold_;
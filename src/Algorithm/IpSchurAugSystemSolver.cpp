@@ -0,0 +1,926 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpSchurAugSystemSolver.hpp"
+#include "IpIpoptNLP.hpp"
+#include "IpTripletHelper.hpp"
+#include "IpLapack.hpp"
+
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+/** Set values to the elements of D plus delta, or to delta if D is NULL. */
+static void FillDiagonal(
+   Index         dim,
+   const Vector* D,
+   double        delta,
+   Number*       values
+)
+{
+   if( D )
+   {
+      TripletHelper::FillValuesFromVector(dim, *D, values);
+      for( Index i = 0; i < dim; i++ )
+      {
+         values[i] += delta;
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < dim; i++ )
+      {
+         values[i] = delta;
+      }
+   }
+}
+
+SchurAugSystemSolver::SchurAugSystemSolver(
+   AugSystemSolver&                              fallback_solver,
+   const std::vector<SmartPtr<SymLinearSolver> >& block_solvers
+)
+   : AugSystemSolver(),
+     fallback_solver_(&fallback_solver),
+     block_solvers_(block_solvers),
+     num_threads_(1),
+     structure_initialized_(false),
+     use_blocks_(false),
+     num_blocks_(0),
+     n_x_(0),
+     n_s_(0),
+     n_c_(0),
+     n_d_(0),
+     n_link_(0),
+     nnz_W_(0),
+     nnz_J_c_(0),
+     nnz_J_d_(0),
+     have_factorization_(false),
+     negevals_(-1),
+     provides_inertia_(false),
+     w_tag_(0),
+     w_factor_(0.),
+     d_x_tag_(0),
+     delta_x_(0.),
+     d_s_tag_(0),
+     delta_s_(0.),
+     j_c_tag_(0),
+     d_c_tag_(0),
+     delta_c_(0.),
+     j_d_tag_(0),
+     d_d_tag_(0),
+     delta_d_(0.)
+{
+   DBG_START_METH("SchurAugSystemSolver::SchurAugSystemSolver()", dbg_verbosity);
+}
+
+SchurAugSystemSolver::~SchurAugSystemSolver()
+{
+   DBG_START_METH("SchurAugSystemSolver::~SchurAugSystemSolver()", dbg_verbosity);
+}
+
+void SchurAugSystemSolver::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddStringOption2(
+      "schur_complement_solver",
+      "Whether to solve the augmented system by the Schur complement of its linking part.",
+      "no",
+      "no", "factorize the augmented system as a whole",
+      "yes", "factorize the diagonal blocks declared by the NLP separately",
+      "This requires that the NLP declares a block-angular structure, see TNLP::get_diagonal_blocks, "
+      "e.g., for two-stage stochastic or multi-period problems. "
+      "Each diagonal block is factorized by its own instance of the linear solver selected by linear_solver, "
+      "and the dense Schur complement for the linking variables and constraints is decomposed into its eigenvalues. "
+      "This is efficient if the number of linking variables and constraints is small. "
+      "If the NLP does not declare a block structure, the augmented system is factorized as a whole.");
+   roptions->AddLowerBoundedIntegerOption(
+      "schur_num_threads",
+      "Number of threads for the diagonal blocks in the Schur complement solver.",
+      1,
+      1,
+      "If this is larger than 1 and Ipopt has been build with OpenMP support, "
+      "the diagonal blocks are factorized and solved in parallel. "
+      "This requires that the selected linear solver can be used concurrently from several threads. "
+      "The time spent in the linear solver is then not included in the timing statistics.");
+}
+
+bool SchurAugSystemSolver::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   options.GetIntegerValue("schur_num_threads", num_threads_, prefix);
+
+   // the structure is analyzed again in the next call of MultiSolve
+   structure_initialized_ = false;
+   use_blocks_ = false;
+   have_factorization_ = false;
+
+   if( !fallback_solver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix) )
+   {
+      return false;
+   }
+
+   for( size_t k = 0; k < block_solvers_.size(); k++ )
+   {
+      bool retval;
+      if( num_threads_ > 1 )
+      {
+         // the timing statistics in IpoptData cannot be updated by
+         // several threads at the same time
+         retval = block_solvers_[k]->ReducedInitialize(Jnlst(), options, prefix);
+      }
+      else
+      {
+         retval = block_solvers_[k]->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+      }
+      if( !retval )
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void SchurAugSystemSolver::InitializeStructure(
+   const SymMatrix& W,
+   const Matrix&    J_c,
+   const Matrix&    J_d
+)
+{
+   DBG_START_METH("SchurAugSystemSolver::InitializeStructure", dbg_verbosity);
+
+   use_blocks_ = false;
+   have_factorization_ = false;
+
+   n_x_ = J_c.NCols();
+   n_s_ = J_d.NRows();
+   n_c_ = J_c.NRows();
+   n_d_ = J_d.NRows();
+
+   std::vector<Index> x_block;
+   std::vector<Index> c_block;
+   std::vector<Index> d_block;
+   if( block_solvers_.size() < 1 || !IpNLP().GetDiagonalBlocks(num_blocks_, x_block, c_block, d_block) )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "The NLP does not declare a block structure, the augmented system is factorized as a whole.\n");
+      return;
+   }
+   if( num_blocks_ != (Index) block_solvers_.size() || (Index) x_block.size() != n_x_ || (Index) c_block.size() != n_c_
+       || (Index) d_block.size() != n_d_ )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "The block structure of the NLP does not fit the augmented system, the augmented system is factorized as a whole.\n");
+      return;
+   }
+
+   // Assign the rows of the augmented system to the blocks; the slack
+   // of an inequality belongs to the block of the inequality
+   const Index n_tot = n_x_ + n_s_ + n_c_ + n_d_;
+   row_block_.resize(n_tot);
+   row_pos_.resize(n_tot);
+   for( Index i = 0; i < n_x_; i++ )
+   {
+      row_block_[i] = x_block[i];
+   }
+   for( Index i = 0; i < n_s_; i++ )
+   {
+      row_block_[n_x_ + i] = d_block[i];
+   }
+   for( Index i = 0; i < n_c_; i++ )
+   {
+      row_block_[n_x_ + n_s_ + i] = c_block[i];
+   }
+   for( Index i = 0; i < n_d_; i++ )
+   {
+      row_block_[n_x_ + n_s_ + n_c_ + i] = d_block[i];
+   }
+
+   std::vector<Index> block_dim(num_blocks_, 0);
+   n_link_ = 0;
+   for( Index i = 0; i < n_tot; i++ )
+   {
+      Index k = row_block_[i];
+      if( k == -1 )
+      {
+         row_block_[i] = num_blocks_;
+         row_pos_[i] = n_link_++;
+      }
+      else if( k >= 0 && k < num_blocks_ )
+      {
+         row_pos_[i] = block_dim[k]++;
+      }
+      else
+      {
+         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                        "The NLP assigns an entry to the invalid block %" IPOPT_INDEX_FORMAT ", the augmented system is factorized as a whole.\n", k);
+         return;
+      }
+   }
+
+   // Obtain the rows and columns of the elements of the augmented
+   // system, in the order used in Factorize
+   nnz_W_ = TripletHelper::GetNumberEntries(W);
+   nnz_J_c_ = TripletHelper::GetNumberEntries(J_c);
+   nnz_J_d_ = TripletHelper::GetNumberEntries(J_d);
+   const Index nnz = nnz_W_ + n_x_ + n_s_ + nnz_J_c_ + n_c_ + nnz_J_d_ + n_d_ + n_d_;
+   Index* irows = new Index[nnz];
+   Index* jcols = new Index[nnz];
+   Index pos = 0;
+   TripletHelper::FillRowCol(nnz_W_, W, irows, jcols);
+   pos += nnz_W_;
+   for( Index i = 0; i < n_x_ + n_s_; i++ )
+   {
+      irows[pos] = jcols[pos] = i + 1;
+      pos++;
+   }
+   TripletHelper::FillRowCol(nnz_J_c_, J_c, irows + pos, jcols + pos, n_x_ + n_s_, 0);
+   pos += nnz_J_c_;
+   for( Index i = 0; i < n_c_; i++ )
+   {
+      irows[pos] = jcols[pos] = n_x_ + n_s_ + i + 1;
+      pos++;
+   }
+   TripletHelper::FillRowCol(nnz_J_d_, J_d, irows + pos, jcols + pos, n_x_ + n_s_ + n_c_, 0);
+   pos += nnz_J_d_;
+   for( Index i = 0; i < n_d_; i++ )
+   {
+      irows[pos] = n_x_ + n_s_ + n_c_ + i + 1;
+      jcols[pos] = n_x_ + i + 1;
+      pos++;
+   }
+   for( Index i = 0; i < n_d_; i++ )
+   {
+      irows[pos] = jcols[pos] = n_x_ + n_s_ + n_c_ + i + 1;
+      pos++;
+   }
+   DBG_ASSERT(pos == nnz);
+
+   // Sort the elements into the diagonal, coupling, and linking blocks
+   entry_kind_.resize(nnz);
+   entry_block_.resize(nnz);
+   entry_pos_.resize(nnz);
+   std::vector<std::vector<Index> > block_irows(num_blocks_);
+   std::vector<std::vector<Index> > block_jcols(num_blocks_);
+   coupling_row_.assign(num_blocks_, std::vector<Index>());
+   coupling_col_.assign(num_blocks_, std::vector<Index>());
+   bool structure_ok = true;
+   for( Index e = 0; e < nnz; e++ )
+   {
+      Index r = irows[e] - 1;
+      Index c = jcols[e] - 1;
+      Index kr = row_block_[r];
+      Index kc = row_block_[c];
+      if( kr == kc && kr < num_blocks_ )
+      {
+         entry_kind_[e] = ENTRY_BLOCK;
+         entry_block_[e] = kr;
+         entry_pos_[e] = (Index) block_irows[kr].size();
+         block_irows[kr].push_back(row_pos_[r] + 1);
+         block_jcols[kr].push_back(row_pos_[c] + 1);
+      }
+      else if( kr == num_blocks_ && kc == num_blocks_ )
+      {
+         entry_kind_[e] = ENTRY_LINKING;
+         entry_block_[e] = row_pos_[r];
+         entry_pos_[e] = row_pos_[c];
+      }
+      else if( kr == num_blocks_ || kc == num_blocks_ )
+      {
+         // coupling between a block and a linking row; the linking
+         // column is replaced by its position in link_cols_ below
+         Index k = kr == num_blocks_ ? kc : kr;
+         entry_kind_[e] = ENTRY_COUPLING;
+         entry_block_[e] = k;
+         entry_pos_[e] = (Index) coupling_row_[k].size();
+         coupling_row_[k].push_back(row_pos_[kr == num_blocks_ ? c : r]);
+         coupling_col_[k].push_back(row_pos_[kr == num_blocks_ ? r : c]);
+      }
+      else
+      {
+         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                        "The augmented system couples the blocks %" IPOPT_INDEX_FORMAT " and %" IPOPT_INDEX_FORMAT ", it is factorized as a whole.\n", kr, kc);
+         structure_ok = false;
+         break;
+      }
+   }
+   delete[] irows;
+   delete[] jcols;
+   if( !structure_ok )
+   {
+      return;
+   }
+
+   // Linking columns of each coupling block
+   link_cols_.assign(num_blocks_, std::vector<Index>());
+   std::vector<Index> link_col_pos(n_link_, -1);
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      for( size_t e = 0; e < coupling_col_[k].size(); e++ )
+      {
+         Index l = coupling_col_[k][e];
+         if( link_col_pos[l] == -1 )
+         {
+            link_col_pos[l] = (Index) link_cols_[k].size();
+            link_cols_[k].push_back(l);
+         }
+         coupling_col_[k][e] = link_col_pos[l];
+      }
+      for( size_t j = 0; j < link_cols_[k].size(); j++ )
+      {
+         link_col_pos[link_cols_[k][j]] = -1;
+      }
+   }
+   coupling_val_.assign(num_blocks_, std::vector<Number>());
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      coupling_val_[k].resize(coupling_row_[k].size());
+   }
+
+   // Matrices of the diagonal blocks
+   block_spaces_.resize(num_blocks_);
+   block_matrices_.resize(num_blocks_);
+   Index min_dim = n_tot;
+   Index max_dim = 0;
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      block_spaces_[k] = new DenseVectorSpace(block_dim[k]);
+      block_matrices_[k] = NULL;
+      if( block_dim[k] > 0 )
+      {
+         SmartPtr<SymTMatrixSpace> space = new SymTMatrixSpace(block_dim[k], (Index) block_irows[k].size(),
+               &block_irows[k][0], &block_jcols[k][0]);
+         block_matrices_[k] = space->MakeNewSymTMatrix();
+      }
+      min_dim = Min(min_dim, block_dim[k]);
+      max_dim = Max(max_dim, block_dim[k]);
+   }
+   block_times_coupling_.assign(num_blocks_, std::vector<SmartPtr<Vector> >());
+
+   provides_inertia_ = true;
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      provides_inertia_ = provides_inertia_ && block_solvers_[k]->ProvidesInertia();
+   }
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Schur complement solver: %" IPOPT_INDEX_FORMAT " diagonal blocks of dimension %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT ", %" IPOPT_INDEX_FORMAT " linking rows.\n", num_blocks_,
+                  min_dim, max_dim, n_link_);
+   use_blocks_ = true;
+}
+
+bool SchurAugSystemSolver::AugmentedSystemRequiresChange(
+   const SymMatrix* W,
+   double           W_factor,
+   const Vector*    D_x,
+   double           delta_x,
+   const Vector*    D_s,
+   double           delta_s,
+   const Matrix&    J_c,
+   const Vector*    D_c,
+   double           delta_c,
+   const Matrix&    J_d,
+   const Vector*    D_d,
+   double           delta_d
+)
+{
+   DBG_START_METH("SchurAugSystemSolver::AugmentedSystemRequiresChange", dbg_verbosity);
+
+   // the values of W do not matter if it is not used
+   TaggedObject::Tag w_tag = (W && W_factor != 0.) ? W->GetTag() : 0;
+   double w_factor = W ? W_factor : 0.;
+
+   return w_tag != w_tag_ || w_factor != w_factor_ || (D_x ? D_x->GetTag() : 0) != d_x_tag_ || delta_x != delta_x_
+          || (D_s ? D_s->GetTag() : 0) != d_s_tag_ || delta_s != delta_s_ || J_c.GetTag() != j_c_tag_
+          || (D_c ? D_c->GetTag() : 0) != d_c_tag_ || delta_c != delta_c_ || J_d.GetTag() != j_d_tag_
+          || (D_d ? D_d->GetTag() : 0) != d_d_tag_ || delta_d != delta_d_;
+}
+
+ESymSolverStatus SchurAugSystemSolver::SolveBlocks(
+   std::vector<std::vector<SmartPtr<const Vector> > >& rhsV,
+   std::vector<std::vector<SmartPtr<Vector> > >&       solV
+)
+{
+   std::vector<ESymSolverStatus> status(num_blocks_, SYMSOLVER_SUCCESS);
+#ifdef _OPENMP
+   int nthreads = ParallelSectionThreads(num_threads_);
+   if( nthreads > 1 )
+   {
+      // Exceptions must not leave the parallel region; they are turned
+      // into a failed solve.
+      #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+      for( Index k = 0; k < num_blocks_; k++ )
+      {
+         if( IsValid(block_matrices_[k]) )
+         {
+            try
+            {
+               status[k] = block_solvers_[k]->MultiSolve(*block_matrices_[k], rhsV[k], solV[k], false, 0);
+            }
+            catch( ... )
+            {
+               status[k] = SYMSOLVER_FATAL_ERROR;
+            }
+         }
+      }
+   }
+   else
+#endif
+   {
+      for( Index k = 0; k < num_blocks_; k++ )
+      {
+         if( IsValid(block_matrices_[k]) )
+         {
+            status[k] = block_solvers_[k]->MultiSolve(*block_matrices_[k], rhsV[k], solV[k], false, 0);
+         }
+      }
+   }
+
+   // report the most severe failure
+   ESymSolverStatus retval = SYMSOLVER_SUCCESS;
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      if( status[k] == SYMSOLVER_FATAL_ERROR )
+      {
+         return SYMSOLVER_FATAL_ERROR;
+      }
+      if( status[k] != SYMSOLVER_SUCCESS )
+      {
+         retval = status[k];
+      }
+   }
+   return retval;
+}
+
+ESymSolverStatus SchurAugSystemSolver::Factorize(
+   const SymMatrix* W,
+   double           W_factor,
+   const Vector*    D_x,
+   double           delta_x,
+   const Vector*    D_s,
+   double           delta_s,
+   const Matrix&    J_c,
+   const Vector*    D_c,
+   double           delta_c,
+   const Matrix&    J_d,
+   const Vector*    D_d,
+   double           delta_d
+)
+{
+   DBG_START_METH("SchurAugSystemSolver::Factorize", dbg_verbosity);
+
+   have_factorization_ = false;
+
+   // Values of the elements of the augmented system, in the order of
+   // InitializeStructure
+   const Index nnz = (Index) entry_kind_.size();
+   Number* values = new Number[nnz];
+   Index pos = 0;
+   if( W && W_factor != 0. )
+   {
+      DBG_ASSERT(TripletHelper::GetNumberEntries(*W) == nnz_W_);
+      TripletHelper::FillValues(nnz_W_, *W, values);
+      if( W_factor != 1. )
+      {
+         for( Index i = 0; i < nnz_W_; i++ )
+         {
+            values[i] *= W_factor;
+         }
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < nnz_W_; i++ )
+      {
+         values[i] = 0.;
+      }
+   }
+   pos += nnz_W_;
+   FillDiagonal(n_x_, D_x, delta_x, values + pos);
+   pos += n_x_;
+   FillDiagonal(n_s_, D_s, delta_s, values + pos);
+   pos += n_s_;
+   TripletHelper::FillValues(nnz_J_c_, J_c, values + pos);
+   pos += nnz_J_c_;
+   FillDiagonal(n_c_, D_c, -delta_c, values + pos);
+   pos += n_c_;
+   TripletHelper::FillValues(nnz_J_d_, J_d, values + pos);
+   pos += nnz_J_d_;
+   for( Index i = 0; i < n_d_; i++ )
+   {
+      values[pos++] = -1.;
+   }
+   FillDiagonal(n_d_, D_d, -delta_d, values + pos);
+   pos += n_d_;
+   DBG_ASSERT(pos == nnz);
+
+   // Distribute the values into the blocks
+   std::vector<std::vector<Number> > block_values(num_blocks_);
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      if( IsValid(block_matrices_[k]) )
+      {
+         block_values[k].resize(block_matrices_[k]->Nonzeros());
+      }
+   }
+   std::vector<Number> schur((size_t) n_link_ * n_link_, 0.);
+   for( Index e = 0; e < nnz; e++ )
+   {
+      switch( entry_kind_[e] )
+      {
+         case ENTRY_BLOCK:
+            block_values[entry_block_[e]][entry_pos_[e]] = values[e];
+            break;
+         case ENTRY_COUPLING:
+            coupling_val_[entry_block_[e]][entry_pos_[e]] = values[e];
+            break;
+         case ENTRY_LINKING:
+         {
+            Index i = entry_block_[e];
+            Index j = entry_pos_[e];
+            schur[i + j * n_link_] += values[e];
+            if( i != j )
+            {
+               schur[j + i * n_link_] += values[e];
+            }
+            break;
+         }
+      }
+   }
+   delete[] values;
+
+   // Factorize the diagonal blocks and solve for the coupling columns
+   std::vector<std::vector<SmartPtr<const Vector> > > rhsV(num_blocks_);
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      block_times_coupling_[k].clear();
+      if( IsNull(block_matrices_[k]) )
+      {
+         continue;
+      }
+      block_matrices_[k]->SetValues(&block_values[k][0]);
+
+      // a zero right hand side is used to obtain the factorization if
+      // the block is not coupled
+      Index ncols = Max((Index) link_cols_[k].size(), (Index) 1);
+      std::vector<Number*> rhs_vals(ncols);
+      for( Index j = 0; j < ncols; j++ )
+      {
+         SmartPtr<DenseVector> rhs = block_spaces_[k]->MakeNewDenseVector();
+         rhs_vals[j] = rhs->Values();
+         for( Index i = 0; i < block_spaces_[k]->Dim(); i++ )
+         {
+            rhs_vals[j][i] = 0.;
+         }
+         rhsV[k].push_back(ConstPtr(rhs));
+         block_times_coupling_[k].push_back(block_spaces_[k]->MakeNew());
+      }
+      for( size_t e = 0; e < coupling_row_[k].size(); e++ )
+      {
+         rhs_vals[coupling_col_[k][e]][coupling_row_[k][e]] += coupling_val_[k][e];
+      }
+   }
+
+   ESymSolverStatus retval = SolveBlocks(rhsV, block_times_coupling_);
+   if( retval != SYMSOLVER_SUCCESS )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Factorization of a diagonal block failed with retval = %d\n", retval);
+      return retval;
+   }
+
+   negevals_ = 0;
+   if( provides_inertia_ )
+   {
+      for( Index k = 0; k < num_blocks_; k++ )
+      {
+         if( IsValid(block_matrices_[k]) )
+         {
+            negevals_ += block_solvers_[k]->NumberOfNegEVals();
+         }
+      }
+   }
+
+   // Schur complement S = C - sum_k B_k^T A_k^{-1} B_k
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      const std::vector<Index>& cols = link_cols_[k];
+      if( cols.empty() )
+      {
+         continue;
+      }
+      std::vector<const Number*> y_vals(cols.size());
+      for( size_t j = 0; j < cols.size(); j++ )
+      {
+         y_vals[j] = static_cast<DenseVector*>(GetRawPtr(block_times_coupling_[k][j]))->ExpandedValues();
+      }
+      for( size_t e = 0; e < coupling_row_[k].size(); e++ )
+      {
+         Index r = coupling_row_[k][e];
+         Index i = cols[coupling_col_[k][e]];
+         Number b = coupling_val_[k][e];
+         for( size_t j = 0; j < cols.size(); j++ )
+         {
+            schur[i + cols[j] * n_link_] -= b * y_vals[j][r];
+         }
+      }
+   }
+
+   // Eigenvalue decomposition of the Schur complement
+   Index negevals_schur = 0;
+   if( n_link_ > 0 )
+   {
+      schur_evecs_.swap(schur);
+      schur_evals_.resize(n_link_);
+      Index info;
+      IpLapackDsyev(true, n_link_, &schur_evecs_[0], n_link_, &schur_evals_[0], info, schur_work_);
+      if( info != 0 )
+      {
+         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                        "Eigenvalue decomposition of the Schur complement failed with info = %" IPOPT_INDEX_FORMAT ".\n", info);
+         return SYMSOLVER_FATAL_ERROR;
+      }
+
+      Number max_abs = 0.;
+      for( Index i = 0; i < n_link_; i++ )
+      {
+         max_abs = Max(max_abs, std::abs(schur_evals_[i]));
+      }
+      const Number tol = n_link_ * std::numeric_limits<Number>::epsilon() * max_abs;
+      for( Index i = 0; i < n_link_; i++ )
+      {
+         if( std::abs(schur_evals_[i]) <= tol )
+         {
+            Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                           "Schur complement is singular.\n");
+            return SYMSOLVER_SINGULAR;
+         }
+         if( schur_evals_[i] < 0. )
+         {
+            negevals_schur++;
+         }
+      }
+   }
+   negevals_ += negevals_schur;
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Schur complement solver: %" IPOPT_INDEX_FORMAT " negative eigenvalues, %" IPOPT_INDEX_FORMAT " of them in the Schur complement.\n", negevals_,
+                  negevals_schur);
+
+   w_tag_ = (W && W_factor != 0.) ? W->GetTag() : 0;
+   w_factor_ = W ? W_factor : 0.;
+   d_x_tag_ = D_x ? D_x->GetTag() : 0;
+   delta_x_ = delta_x;
+   d_s_tag_ = D_s ? D_s->GetTag() : 0;
+   delta_s_ = delta_s;
+   j_c_tag_ = J_c.GetTag();
+   d_c_tag_ = D_c ? D_c->GetTag() : 0;
+   delta_c_ = delta_c;
+   j_d_tag_ = J_d.GetTag();
+   d_d_tag_ = D_d ? D_d->GetTag() : 0;
+   delta_d_ = delta_d;
+   have_factorization_ = true;
+
+   return SYMSOLVER_SUCCESS;
+}
+
+ESymSolverStatus SchurAugSystemSolver::MultiSolve(
+   const SymMatrix*                      W,
+   double                                W_factor,
+   const Vector*                         D_x,
+   double                                delta_x,
+   const Vector*                         D_s,
+   double                                delta_s,
+   const Matrix*                         J_c,
+   const Vector*                         D_c,
+   double                                delta_c,
+   const Matrix*                         J_d,
+   const Vector*                         D_d,
+   double                                delta_d,
+   std::vector<SmartPtr<const Vector> >& rhs_xV,
+   std::vector<SmartPtr<const Vector> >& rhs_sV,
+   std::vector<SmartPtr<const Vector> >& rhs_cV,
+   std::vector<SmartPtr<const Vector> >& rhs_dV,
+   std::vector<SmartPtr<Vector> >&       sol_xV,
+   std::vector<SmartPtr<Vector> >&       sol_sV,
+   std::vector<SmartPtr<Vector> >&       sol_cV,
+   std::vector<SmartPtr<Vector> >&       sol_dV,
+   bool                                  check_NegEVals,
+   Index                                 numberOfNegEVals
+)
+{
+   DBG_START_METH("SchurAugSystemSolver::MultiSolve", dbg_verbosity);
+   DBG_ASSERT(J_c && J_d && "Currently, you MUST specify J_c and J_d in the augmented system");
+
+   if( !structure_initialized_ )
+   {
+      DBG_ASSERT(W);// W must exist during the first call to setup the structure!
+      InitializeStructure(*W, *J_c, *J_d);
+      structure_initialized_ = true;
+   }
+
+   if( !use_blocks_ )
+   {
+      return fallback_solver_->MultiSolve(W, W_factor, D_x, delta_x, D_s, delta_s, J_c, D_c, delta_c, J_d, D_d, delta_d,
+                                          rhs_xV, rhs_sV, rhs_cV, rhs_dV, sol_xV, sol_sV, sol_cV, sol_dV, check_NegEVals, numberOfNegEVals);
+   }
+
+   if( !have_factorization_
+       || AugmentedSystemRequiresChange(W, W_factor, D_x, delta_x, D_s, delta_s, *J_c, D_c, delta_c, *J_d, D_d,
+                                        delta_d) )
+   {
+      ESymSolverStatus retval = Factorize(W, W_factor, D_x, delta_x, D_s, delta_s, *J_c, D_c, delta_c, *J_d, D_d,
+                                          delta_d);
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         return retval;
+      }
+   }
+
+   if( check_NegEVals && provides_inertia_ && negevals_ != numberOfNegEVals )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Wrong inertia: required are %" IPOPT_INDEX_FORMAT ", but we got %" IPOPT_INDEX_FORMAT ".\n", numberOfNegEVals, negevals_);
+      return SYMSOLVER_WRONG_INERTIA;
+   }
+
+   // Split the right hand sides into the blocks and the linking part
+   const Index nrhs = (Index) rhs_xV.size();
+   const Index n_tot = n_x_ + n_s_ + n_c_ + n_d_;
+   Number* full = new Number[n_tot];
+   std::vector<std::vector<SmartPtr<const Vector> > > block_rhsV(num_blocks_);
+   std::vector<std::vector<SmartPtr<Vector> > > block_solV(num_blocks_);
+   std::vector<std::vector<Number> > link_rhs(nrhs, std::vector<Number>(n_link_));
+   std::vector<Number*> block_vals(num_blocks_);
+   for( Index irhs = 0; irhs < nrhs; irhs++ )
+   {
+      TripletHelper::FillValuesFromVector(n_x_, *rhs_xV[irhs], full);
+      TripletHelper::FillValuesFromVector(n_s_, *rhs_sV[irhs], full + n_x_);
+      TripletHelper::FillValuesFromVector(n_c_, *rhs_cV[irhs], full + n_x_ + n_s_);
+      TripletHelper::FillValuesFromVector(n_d_, *rhs_dV[irhs], full + n_x_ + n_s_ + n_c_);
+      for( Index k = 0; k < num_blocks_; k++ )
+      {
+         SmartPtr<DenseVector> rhs = block_spaces_[k]->MakeNewDenseVector();
+         block_vals[k] = rhs->Values();
+         block_rhsV[k].push_back(ConstPtr(rhs));
+         block_solV[k].push_back(block_spaces_[k]->MakeNew());
+      }
+      for( Index i = 0; i < n_tot; i++ )
+      {
+         Index k = row_block_[i];
+         if( k < num_blocks_ )
+         {
+            block_vals[k][row_pos_[i]] = full[i];
+         }
+         else
+         {
+            link_rhs[irhs][row_pos_[i]] = full[i];
+         }
+      }
+   }
+
+   // z_k = A_k^{-1} r_k
+   ESymSolverStatus retval = SolveBlocks(block_rhsV, block_solV);
+   if( retval != SYMSOLVER_SUCCESS )
+   {
+      delete[] full;
+      return retval;
+   }
+
+   std::vector<Number> tmp(n_link_);
+   for( Index irhs = 0; irhs < nrhs; irhs++ )
+   {
+      std::vector<Number>& x_link = link_rhs[irhs];
+      if( n_link_ > 0 )
+      {
+         // x_0 = S^{-1} (r_0 - sum_k B_k^T z_k)
+         for( Index k = 0; k < num_blocks_; k++ )
+         {
+            if( coupling_row_[k].empty() )
+            {
+               continue;
+            }
+            const Number* z = static_cast<DenseVector*>(GetRawPtr(block_solV[k][irhs]))->ExpandedValues();
+            for( size_t e = 0; e < coupling_row_[k].size(); e++ )
+            {
+               x_link[link_cols_[k][coupling_col_[k][e]]] -= coupling_val_[k][e] * z[coupling_row_[k][e]];
+            }
+         }
+         for( Index j = 0; j < n_link_; j++ )
+         {
+            Number val = 0.;
+            for( Index i = 0; i < n_link_; i++ )
+            {
+               val += schur_evecs_[i + j * n_link_] * x_link[i];
+            }
+            tmp[j] = val / schur_evals_[j];
+         }
+         for( Index i = 0; i < n_link_; i++ )
+         {
+            Number val = 0.;
+            for( Index j = 0; j < n_link_; j++ )
+            {
+               val += schur_evecs_[i + j * n_link_] * tmp[j];
+            }
+            x_link[i] = val;
+         }
+
+         // x_k = z_k - A_k^{-1} B_k x_0
+         for( Index k = 0; k < num_blocks_; k++ )
+         {
+            for( size_t j = 0; j < link_cols_[k].size(); j++ )
+            {
+               block_solV[k][irhs]->Axpy(-x_link[link_cols_[k][j]], *block_times_coupling_[k][j]);
+            }
+         }
+      }
+
+      // Assemble the solution
+      for( Index k = 0; k < num_blocks_; k++ )
+      {
+         block_vals[k] = NULL;
+         if( block_spaces_[k]->Dim() > 0 )
+         {
+            block_vals[k] = static_cast<DenseVector*>(GetRawPtr(block_solV[k][irhs]))->Values();
+         }
+      }
+      for( Index i = 0; i < n_tot; i++ )
+      {
+         Index k = row_block_[i];
+         full[i] = k < num_blocks_ ? block_vals[k][row_pos_[i]] : x_link[row_pos_[i]];
+      }
+      TripletHelper::PutValuesInVector(n_x_, full, *sol_xV[irhs]);
+      TripletHelper::PutValuesInVector(n_s_, full + n_x_, *sol_sV[irhs]);
+      TripletHelper::PutValuesInVector(n_c_, full + n_x_ + n_s_, *sol_cV[irhs]);
+      TripletHelper::PutValuesInVector(n_d_, full + n_x_ + n_s_ + n_c_, *sol_dV[irhs]);
+   }
+   delete[] full;
+
+   return SYMSOLVER_SUCCESS;
+}
+
+Index SchurAugSystemSolver::NumberOfNegEVals() const
+{
+   if( !use_blocks_ )
+   {
+      return fallback_solver_->NumberOfNegEVals();
+   }
+   return negevals_;
+}
+
+bool SchurAugSystemSolver::ProvidesInertia() const
+{
+   if( structure_initialized_ )
+   {
+      return use_blocks_ ? provides_inertia_ : fallback_solver_->ProvidesInertia();
+   }
+
+   // the structure is not yet known; the result must hold in both cases
+   if( !fallback_solver_->ProvidesInertia() )
+   {
+      return false;
+   }
+   for( size_t k = 0; k < block_solvers_.size(); k++ )
+   {
+      if( !block_solvers_[k]->ProvidesInertia() )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool SchurAugSystemSolver::IncreaseQuality()
+{
+   if( !use_blocks_ )
+   {
+      return fallback_solver_->IncreaseQuality();
+   }
+
+   bool retval = false;
+   for( Index k = 0; k < num_blocks_; k++ )
+   {
+      if( block_solvers_[k]->IncreaseQuality() )
+      {
+         retval = true;
+      }
+   }
+   // the factorizations have to be recomputed with the new settings
+   have_factorization_ = false;
+   return retval;
+}
+
+} // namespace Ipopt
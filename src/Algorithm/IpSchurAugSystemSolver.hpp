@@ -0,0 +1,310 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IP_SCHURAUGSYSTEMSOLVER_HPP__
+#define __IP_SCHURAUGSYSTEMSOLVER_HPP__
+
+#include "IpAugSystemSolver.hpp"
+#include "IpSymLinearSolver.hpp"
+#include "IpSymTMatrix.hpp"
+#include "IpDenseVector.hpp"
+
+namespace Ipopt
+{
+/** Solver for the augmented system of problems with a block-angular
+ *  structure, based on the Schur complement of the linking part.
+ *
+ *  If the NLP declares a partition of its variables and constraints
+ *  into diagonal blocks and linking entries (see
+ *  TNLP::get_diagonal_blocks), the augmented system has the
+ *  block-bordered diagonal form
+ *
+ *  \f$\left[\begin{array}{cccc}
+ *  A_1 & & & B_1\\
+ *  & \ddots & & \vdots\\
+ *  & & A_N & B_N\\
+ *  B_1^T & \cdots & B_N^T & C
+ *  \end{array}\right]\f$,
+ *
+ *  where the last block row and column belong to the linking
+ *  variables, slacks, and multipliers.  Each \f$A_k\f$ is factorized
+ *  by its own SymLinearSolver, independently of the others and in
+ *  parallel if schur_num_threads is larger than 1.  The dense Schur
+ *  complement \f$S = C - \sum_k B_k^TA_k^{-1}B_k\f$ is then
+ *  decomposed into its eigenvalues, which also gives its inertia, so
+ *  that the inertia of the augmented system is the sum of the inertias
+ *  of the \f$A_k\f$ and \f$S\f$.
+ *
+ *  If no block structure is available, or if the matrices do not
+ *  respect it, the augmented system is passed to a fallback solver.
+ */
+class SchurAugSystemSolver: public AugSystemSolver
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor.
+    *
+    *  block_solvers contains one linear solver for each diagonal
+    *  block; fallback_solver is used if the block structure cannot be
+    *  exploited.
+    */
+   SchurAugSystemSolver(
+      AugSystemSolver&                              fallback_solver,
+      const std::vector<SmartPtr<SymLinearSolver> >& block_solvers
+   );
+
+   /** Destructor */
+   virtual ~SchurAugSystemSolver();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   virtual ESymSolverStatus MultiSolve(
+      const SymMatrix*                      W,
+      double                                W_factor,
+      const Vector*                         D_x,
+      double                                delta_x,
+      const Vector*                         D_s,
+      double                                delta_s,
+      const Matrix*                         J_c,
+      const Vector*                         D_c,
+      double                                delta_c,
+      const Matrix*                         J_d,
+      const Vector*                         D_d,
+      double                                delta_d,
+      std::vector<SmartPtr<const Vector> >& rhs_xV,
+      std::vector<SmartPtr<const Vector> >& rhs_sV,
+      std::vector<SmartPtr<const Vector> >& rhs_cV,
+      std::vector<SmartPtr<const Vector> >& rhs_dV,
+      std::vector<SmartPtr<Vector> >&       sol_xV,
+      std::vector<SmartPtr<Vector> >&       sol_sV,
+      std::vector<SmartPtr<Vector> >&       sol_cV,
+      std::vector<SmartPtr<Vector> >&       sol_dV,
+      bool                                  check_NegEVals,
+      Index                                 numberOfNegEVals
+   );
+
+   /** Number of negative eigenvalues of the most recent factorization,
+    *  summed over the diagonal blocks and the Schur complement.
+    */
+   virtual Index NumberOfNegEVals() const;
+
+   virtual bool ProvidesInertia() const;
+
+   /** Request to increase the quality of the solution of the
+    *  diagonal blocks.
+    */
+   virtual bool IncreaseQuality();
+
+   /** Methods for IpoptType */
+   ///@{
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default constructor */
+   SchurAugSystemSolver();
+
+   /** Copy Constructor */
+   SchurAugSystemSolver(
+      const SchurAugSystemSolver&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const SchurAugSystemSolver&
+   );
+   ///@}
+
+   /** Kind of the target of an element of the augmented system */
+   enum EEntryKind
+   {
+      /** element of a diagonal block \f$A_k\f$ */
+      ENTRY_BLOCK,
+      /** element of a coupling block \f$B_k\f$ */
+      ENTRY_COUPLING,
+      /** element of the linking block \f$C\f$ */
+      ENTRY_LINKING
+   };
+
+   /** Solver for the augmented system if the block structure is not used */
+   SmartPtr<AugSystemSolver> fallback_solver_;
+
+   /** Linear solvers for the diagonal blocks */
+   std::vector<SmartPtr<SymLinearSolver> > block_solvers_;
+
+   /** Number of threads for the diagonal blocks (schur_num_threads) */
+   Index num_threads_;
+
+   /** @name Block structure of the augmented system */
+   ///@{
+   /** Whether the structure has been set up by the first call of MultiSolve */
+   bool structure_initialized_;
+
+   /** Whether the block structure is used, otherwise the fallback solver is used */
+   bool use_blocks_;
+
+   /** Number of diagonal blocks */
+   Index num_blocks_;
+
+   /** Dimensions of x, s, c, and d */
+   Index n_x_;
+   Index n_s_;
+   Index n_c_;
+   Index n_d_;
+
+   /** Number of linking rows of the augmented system */
+   Index n_link_;
+
+   /** For each row of the augmented system its diagonal block, or
+    *  num_blocks_ if it is linking.
+    */
+   std::vector<Index> row_block_;
+
+   /** For each row of the augmented system its position within its
+    *  diagonal block or within the linking rows.
+    */
+   std::vector<Index> row_pos_;
+
+   /** Number of elements of W, J_c, and J_d */
+   Index nnz_W_;
+   Index nnz_J_c_;
+   Index nnz_J_d_;
+
+   /** For each element of the augmented system (in the order of
+    *  Factorize) the kind of its target, its block (or linking row for
+    *  ENTRY_LINKING), and its position in the block (or linking
+    *  column).
+    */
+   std::vector<EEntryKind> entry_kind_;
+   std::vector<Index> entry_block_;
+   std::vector<Index> entry_pos_;
+
+   /** Vector spaces of the diagonal blocks */
+   std::vector<SmartPtr<DenseVectorSpace> > block_spaces_;
+
+   /** Matrices of the diagonal blocks */
+   std::vector<SmartPtr<SymTMatrix> > block_matrices_;
+
+   /** Elements of the coupling blocks: row within the block, position
+    *  in the list of linking columns of the block, and value.
+    */
+   std::vector<std::vector<Index> > coupling_row_;
+   std::vector<std::vector<Index> > coupling_col_;
+   std::vector<std::vector<Number> > coupling_val_;
+
+   /** Linking columns that appear in each coupling block */
+   std::vector<std::vector<Index> > link_cols_;
+   ///@}
+
+   /** @name Current factorization */
+   ///@{
+   /** Whether a factorization is available */
+   bool have_factorization_;
+
+   /** Solutions \f$A_k^{-1}B_k\f$ for the linking columns of each block */
+   std::vector<std::vector<SmartPtr<Vector> > > block_times_coupling_;
+
+   /** Eigenvectors of the Schur complement (column-major) */
+   std::vector<Number> schur_evecs_;
+
+   /** Eigenvalues of the Schur complement */
+   std::vector<Number> schur_evals_;
+
+   /** LAPACK workspace for the eigenvalue decomposition, kept between factorizations */
+   std::vector<Number> schur_work_;
+
+   /** Number of negative eigenvalues of the augmented system */
+   Index negevals_;
+
+   /** Whether all block solvers provide the inertia */
+   bool provides_inertia_;
+   ///@}
+
+   /** @name Information about the matrices of the current factorization */
+   ///@{
+   TaggedObject::Tag w_tag_;
+   double w_factor_;
+   TaggedObject::Tag d_x_tag_;
+   double delta_x_;
+   TaggedObject::Tag d_s_tag_;
+   double delta_s_;
+   TaggedObject::Tag j_c_tag_;
+   TaggedObject::Tag d_c_tag_;
+   double delta_c_;
+   TaggedObject::Tag j_d_tag_;
+   TaggedObject::Tag d_d_tag_;
+   double delta_d_;
+   ///@}
+
+   /** Analyze the block structure of the augmented system.
+    *
+    *  Sets use_blocks_ to false if the structure is not available or
+    *  violated by the given matrices.
+    */
+   void InitializeStructure(
+      const SymMatrix& W,
+      const Matrix&    J_c,
+      const Matrix&    J_d
+   );
+
+   /** Whether the matrices differ from those of the current factorization */
+   bool AugmentedSystemRequiresChange(
+      const SymMatrix* W,
+      double           W_factor,
+      const Vector*    D_x,
+      double           delta_x,
+      const Vector*    D_s,
+      double           delta_s,
+      const Matrix&    J_c,
+      const Vector*    D_c,
+      double           delta_c,
+      const Matrix&    J_d,
+      const Vector*    D_d,
+      double           delta_d
+   );
+
+   /** Factorize the diagonal blocks and the Schur complement */
+   ESymSolverStatus Factorize(
+      const SymMatrix* W,
+      double           W_factor,
+      const Vector*    D_x,
+      double           delta_x,
+      const Vector*    D_s,
+      double           delta_s,
+      const Matrix&    J_c,
+      const Vector*    D_c,
+      double           delta_c,
+      const Matrix&    J_d,
+      const Vector*    D_d,
+      double           delta_d
+   );
+
+   /** Solve with the diagonal blocks for the given right hand sides
+    *  of all blocks, in parallel over the blocks.
+    */
+   ESymSolverStatus SolveBlocks(
+      std::vector<std::vector<SmartPtr<const Vector> > >& rhsV,
+      std::vector<std::vector<SmartPtr<Vector> > >&       solV
+   );
+};
+
+} // namespace Ipopt
+
+#endif
@@ -8,6 +8,7 @@
 #define __IPSEARCHDIRCALCULATOR_HPP__
 
 #include "IpAlgStrategy.hpp"
+#include "IpPDSystemSolver.hpp"
 
 namespace Ipopt
 {
@@ -40,6 +41,13 @@ public:
     */
    virtual bool ComputeSearchDirection() = 0;
 
+   /** Returns the solver for the primal-dual system that is used for
+    *  the search direction, or NULL if there is none. */
+   virtual SmartPtr<PDSystemSolver> PDSolver()
+   {
+      return NULL;
+   }
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
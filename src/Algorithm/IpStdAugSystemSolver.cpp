@@ -70,6 +70,16 @@ bool StdAugSystemSolver::InitializeImpl(
    {
       augsys_tag_ = 0;
       augmented_system_ = NULL;
+      augmented_diag_ = NULL;
+      sumsym_x_ = NULL;
+      diag_x_ = NULL;
+      diag_s_ = NULL;
+      diag_c_ = NULL;
+      diag_d_ = NULL;
+      diag_x_work_ = NULL;
+      diag_s_work_ = NULL;
+      diag_c_work_ = NULL;
+      diag_d_work_ = NULL;
    }
    else
    {
@@ -145,8 +155,17 @@ ESymSolverStatus StdAugSystemSolver::MultiSolve(
    if( AugmentedSystemRequiresChange(W, W_factor, D_x, delta_x, D_s, delta_s, *J_c, D_c, delta_c, *J_d, D_d, delta_d) )
    {
       DBG_ASSERT(!debug_first_time_through);
+      // If only the diagonal matrices change, e.g., for a new
+      // perturbation in the inertia correction, the linear solver can
+      // update the diagonal of the previous matrix
+      const bool only_diagonal = OnlyDiagonalRequiresChange(W, W_factor, *J_c, *J_d);
+      const TaggedObject::Tag prev_tag = augsys_tag_;
       CreateAugmentedSystem(W, W_factor, D_x, delta_x, D_s, delta_s, *J_c, D_c, delta_c, *J_d, D_d, delta_d, *rhs_xV[0],
                             *rhs_sV[0], *rhs_cV[0], *rhs_dV[0]);
+      if( only_diagonal )
+      {
+         linsolver_->SetDiagonalChange(*augmented_system_, prev_tag, *augmented_diag_);
+      }
    }
 
    // Sanity checks
@@ -166,7 +185,7 @@ ESymSolverStatus StdAugSystemSolver::MultiSolve(
       augrhs->SetComp(2, *rhs_cV[i]);
       augrhs->SetComp(3, *rhs_dV[i]);
       char buffer[16];
-      Snprintf(buffer, 15, "RHS[%2d]", i);
+      Snprintf(buffer, 15, "RHS[%2" IPOPT_INDEX_FORMAT "]", i);
       augrhs->Print(Jnlst(), J_MOREVECTOR, J_LINEAR_ALGEBRA, buffer);
       augmented_rhsV[i] = GetRawPtr(augrhs);
    }
@@ -187,7 +206,7 @@ ESymSolverStatus StdAugSystemSolver::MultiSolve(
       for( Index dbg_i = 0; dbg_i < dbg_nz; dbg_i++ )
       {
          Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                        "(%d) KKT[%d][%d] = %23.15e\n", dbg_i, dbg_iRows[dbg_i], dbg_jCols[dbg_i], dbg_values[dbg_i]);
+                        "(%" IPOPT_INDEX_FORMAT ") KKT[%" IPOPT_INDEX_FORMAT "][%" IPOPT_INDEX_FORMAT "] = %23.15e\n", dbg_i, dbg_iRows[dbg_i], dbg_jCols[dbg_i], dbg_values[dbg_i]);
       }
       delete[] dbg_iRows;
       dbg_iRows = NULL;
@@ -219,7 +238,7 @@ ESymSolverStatus StdAugSystemSolver::MultiSolve(
       for( Index i = 0; i < nrhs; i++ )
       {
          char buffer[16];
-         Snprintf(buffer, 15, "SOL[%2d]", i);
+         Snprintf(buffer, 15, "SOL[%2" IPOPT_INDEX_FORMAT "]", i);
          augmented_solV[i]->Print(Jnlst(), J_MOREVECTOR, J_LINEAR_ALGEBRA, buffer);
       }
    }
@@ -329,146 +348,154 @@ void StdAugSystemSolver::CreateAugmentedSystem(
    const Vector&    proto_d
 )
 {
-   augmented_system_ = augmented_system_space_->MakeNewCompoundSymMatrix();
-
-   // (1,1) block
-   SmartPtr<SumSymMatrix> sumsym_x = sumsym_space_x_->MakeNewSumSymMatrix();
-
-   if( W )
+   const bool first_time = !IsValid(augmented_system_);
+   if( first_time )
    {
-      sumsym_x->SetTerm(0, W_factor, *W);
-      old_w_ = W;
-      w_tag_ = W->GetTag();
+      augmented_system_ = augmented_system_space_->MakeNewCompoundSymMatrix();
+      sumsym_x_ = sumsym_space_x_->MakeNewSumSymMatrix();
+      diag_x_ = diag_space_x_->MakeNewDiagMatrix();
+      diag_s_ = diag_space_s_->MakeNewDiagMatrix();
+      diag_c_ = diag_space_c_->MakeNewDiagMatrix();
+      diag_d_ = diag_space_d_->MakeNewDiagMatrix();
+      diag_x_work_ = NULL;
+      diag_s_work_ = NULL;
+      diag_c_work_ = NULL;
+      diag_d_work_ = NULL;
+
+      // (4,2) block
+      SmartPtr<IdentityMatrix> ident_ds = ident_space_ds_->MakeNewIdentityMatrix();
+      ident_ds->SetFactor(-1.0);
+      augmented_system_->SetComp(3, 1, *ident_ds);
    }
-   else
-   {
-      sumsym_x->SetTerm(0, 0.0, *old_w_);
-      w_tag_ = 0;
-   }
-   w_factor_ = W_factor;
 
-   SmartPtr<DiagMatrix> diag_x = diag_space_x_->MakeNewDiagMatrix();
-   if( D_x )
+   // (1,1) block
+   // a W that is multiplied by zero is equivalent to no W
+   const bool use_W = (W != NULL && W_factor != 0.);
+   const bool W_changed = first_time || (use_W && W->GetTag() != w_tag_) || (!use_W && w_tag_ != 0)
+                          || ((use_W ? W_factor : 0.) != w_factor_);
+   const bool x_changed = first_time || (D_x && D_x->GetTag() != d_x_tag_) || (!D_x && d_x_tag_ != 0)
+                          || (delta_x != delta_x_);
+   if( W_changed )
    {
-      if( delta_x == 0. )
+      if( W )
       {
-         diag_x->SetDiag(*D_x);
+         sumsym_x_->SetTerm(0, W_factor, *W);
+         old_w_ = W;
+         // the values of W do not matter if it is not used
+         w_tag_ = W_factor != 0. ? W->GetTag() : 0;
+         w_factor_ = W_factor;
       }
       else
       {
-         SmartPtr<Vector> tmp = D_x->MakeNewCopy();
-         tmp->AddScalar(delta_x);
-         diag_x->SetDiag(*tmp);
+         sumsym_x_->SetTerm(0, 0.0, *old_w_);
+         w_tag_ = 0;
+         w_factor_ = 0.;
       }
-      d_x_tag_ = D_x->GetTag();
    }
-   else
+   if( x_changed )
    {
-      SmartPtr<Vector> tmp = proto_x.MakeNew();
-      tmp->Set(delta_x);
-      diag_x->SetDiag(*tmp);
-      d_x_tag_ = 0;
+      SetDiagBlock(*diag_x_, diag_x_work_, D_x, delta_x, proto_x);
+      sumsym_x_->SetTerm(1, 1.0, *diag_x_);
+      d_x_tag_ = D_x ? D_x->GetTag() : 0;
+      delta_x_ = delta_x;
    }
-   sumsym_x->SetTerm(1, 1.0, *diag_x);
-   delta_x_ = delta_x;
-
-   augmented_system_->SetComp(0, 0, *sumsym_x);
-
-   // (2,2) block
-   SmartPtr<DiagMatrix> diag_s = diag_space_s_->MakeNewDiagMatrix();
-   if( D_s )
+   if( W_changed || x_changed )
    {
-      if( delta_s == 0. )
-      {
-         diag_s->SetDiag(*D_s);
-      }
-      else
-      {
-         SmartPtr<Vector> tmp = D_s->MakeNewCopy();
-         tmp->AddScalar(delta_s);
-         diag_s->SetDiag(*tmp);
-      }
-      d_s_tag_ = D_s->GetTag();
+      augmented_system_->SetComp(0, 0, *sumsym_x_);
    }
-   else
+
+   // (2,2) block
+   if( first_time || (D_s && D_s->GetTag() != d_s_tag_) || (!D_s && d_s_tag_ != 0) || (delta_s != delta_s_) )
    {
-      SmartPtr<Vector> tmp = proto_s.MakeNew();
-      tmp->Set(delta_s);
-      diag_s->SetDiag(*tmp);
-      d_s_tag_ = 0;
+      SetDiagBlock(*diag_s_, diag_s_work_, D_s, delta_s, proto_s);
+      d_s_tag_ = D_s ? D_s->GetTag() : 0;
+      delta_s_ = delta_s;
+      augmented_system_->SetComp(1, 1, *diag_s_);
    }
-   delta_s_ = delta_s;
-
-   augmented_system_->SetComp(1, 1, *diag_s);
 
    // (3,1) block
-   augmented_system_->SetComp(2, 0, J_c);
-   j_c_tag_ = J_c.GetTag();
+   if( first_time || J_c.GetTag() != j_c_tag_ )
+   {
+      augmented_system_->SetComp(2, 0, J_c);
+      j_c_tag_ = J_c.GetTag();
+   }
 
    // (3,3) block
-   SmartPtr<DiagMatrix> diag_c = diag_space_c_->MakeNewDiagMatrix();
-   if( D_c )
+   if( first_time || (D_c && D_c->GetTag() != d_c_tag_) || (!D_c && d_c_tag_ != 0) || (delta_c != delta_c_) )
    {
-      if( delta_c == 0. )
-      {
-         diag_c->SetDiag(*D_c);
-      }
-      else
-      {
-         SmartPtr<Vector> tmp = D_c->MakeNewCopy();
-         tmp->AddScalar(-delta_c);
-         diag_c->SetDiag(*tmp);
-      }
-      d_c_tag_ = D_c->GetTag();
+      SetDiagBlock(*diag_c_, diag_c_work_, D_c, -delta_c, proto_c);
+      d_c_tag_ = D_c ? D_c->GetTag() : 0;
+      delta_c_ = delta_c;
+      augmented_system_->SetComp(2, 2, *diag_c_);
    }
-   else
+
+   // (4,1) block
+   if( first_time || J_d.GetTag() != j_d_tag_ )
+   {
+      augmented_system_->SetComp(3, 0, J_d);
+      j_d_tag_ = J_d.GetTag();
+   }
+
+   // (4,4) block
+   if( first_time || (D_d && D_d->GetTag() != d_d_tag_) || (!D_d && d_d_tag_ != 0) || (delta_d != delta_d_) )
    {
-      SmartPtr<Vector> tmp = proto_c.MakeNew();
-      tmp->Set(-delta_c);
-      diag_c->SetDiag(*tmp);
-      d_c_tag_ = 0;
+      SetDiagBlock(*diag_d_, diag_d_work_, D_d, -delta_d, proto_d);
+      d_d_tag_ = D_d ? D_d->GetTag() : 0;
+      delta_d_ = delta_d;
+      augmented_system_->SetComp(3, 3, *diag_d_);
    }
-   delta_c_ = delta_c;
 
-   augmented_system_->SetComp(2, 2, *diag_c);
+   augsys_tag_ = augmented_system_->GetTag();
 
-   // (4,1) block
-   augmented_system_->SetComp(3, 0, J_d);
-   j_d_tag_ = J_d.GetTag();
+   augmented_diag_ = augmented_vector_space_->MakeNewCompoundVector(false);
+   augmented_diag_->SetComp(0, *diag_x_->GetDiag());
+   augmented_diag_->SetComp(1, *diag_s_->GetDiag());
+   augmented_diag_->SetComp(2, *diag_c_->GetDiag());
+   augmented_diag_->SetComp(3, *diag_d_->GetDiag());
+}
 
-   // (4,2) block
-   SmartPtr<IdentityMatrix> ident_ds = ident_space_ds_->MakeNewIdentityMatrix();
-   ident_ds->SetFactor(-1.0);
-   augmented_system_->SetComp(3, 1, *ident_ds);
+void StdAugSystemSolver::SetDiagBlock(
+   DiagMatrix&       diag_mat,
+   SmartPtr<Vector>& work,
+   const Vector*     D,
+   double            delta,
+   const Vector&     proto
+)
+{
+   if( D && delta == 0. )
+   {
+      diag_mat.SetDiag(*D);
+      return;
+   }
 
-   // (4,4) block
-   SmartPtr<DiagMatrix> diag_d = diag_space_d_->MakeNewDiagMatrix();
-   if( D_d )
+   if( !IsValid(work) )
    {
-      if( delta_d == 0. )
-      {
-         diag_d->SetDiag(*D_d);
-      }
-      else
-      {
-         SmartPtr<Vector> tmp = D_d->MakeNewCopy();
-         tmp->AddScalar(-delta_d);
-         diag_d->SetDiag(*tmp);
-      }
-      d_d_tag_ = D_d->GetTag();
+      work = proto.MakeNew();
+   }
+   if( D )
+   {
+      work->Copy(*D);
+      work->AddScalar(delta);
    }
    else
    {
-      SmartPtr<Vector> tmp = proto_d.MakeNew();
-      tmp->Set(-delta_d);
-      diag_d->SetDiag(*tmp);
-      d_d_tag_ = 0;
+      work->Set(delta);
    }
-   delta_d_ = delta_d;
+   diag_mat.SetDiag(*work);
+}
 
-   augmented_system_->SetComp(3, 3, *diag_d);
+bool StdAugSystemSolver::OnlyDiagonalRequiresChange(
+   const SymMatrix* W,
+   double           W_factor,
+   const Matrix&    J_c,
+   const Matrix&    J_d
+)
+{
+   // a W that is multiplied by zero is equivalent to no W
+   const bool use_W = (W != NULL && W_factor != 0.);
 
-   augsys_tag_ = augmented_system_->GetTag();
+   return !((use_W && W->GetTag() != w_tag_) || (!use_W && w_tag_ != 0) || ((use_W ? W_factor : 0.) != w_factor_)
+            || (J_c.GetTag() != j_c_tag_) || (J_d.GetTag() != j_d_tag_));
 }
 
 bool StdAugSystemSolver::AugmentedSystemRequiresChange(
@@ -489,11 +516,14 @@ bool StdAugSystemSolver::AugmentedSystemRequiresChange(
    DBG_START_METH("StdAugSystemSolver::AugmentedSystemRequiresChange", dbg_verbosity);
    DBG_ASSERT(augsys_tag_ == augmented_system_->GetTag() && "Someone has changed the augmented system outside of the AugSystemSolver. This should NOT happen.");
 
+   // a W that is multiplied by zero is equivalent to no W
+   const bool use_W = (W != NULL && W_factor != 0.);
+
 #if IPOPT_VERBOSITY > 0
 
-   bool Wtest = (W && W->GetTag() != w_tag_);
-   bool iWtest = (!W && w_tag_ != 0);
-   bool wfactor_test = (W_factor != w_factor_);
+   bool Wtest = (use_W && W->GetTag() != w_tag_);
+   bool iWtest = (!use_W && w_tag_ != 0);
+   bool wfactor_test = ((use_W ? W_factor : 0.) != w_factor_);
    bool D_xtest = (D_x && D_x->GetTag() != d_x_tag_);
    bool iD_xtest = (!D_x && d_x_tag_ != 0);
    bool delta_xtest = (delta_x != delta_x_);
@@ -528,7 +558,8 @@ bool StdAugSystemSolver::AugmentedSystemRequiresChange(
    DBG_PRINT((2, "iD_dtest = %d\n", iD_dtest));
    DBG_PRINT((2, "delta_dtest = %d\n", delta_dtest));
 
-   if( (W && W->GetTag() != w_tag_) || (!W && w_tag_ != 0) || (W_factor != w_factor_) || (D_x && D_x->GetTag() != d_x_tag_)
+   if( (use_W && W->GetTag() != w_tag_) || (!use_W && w_tag_ != 0) || ((use_W ? W_factor : 0.) != w_factor_)
+       || (D_x && D_x->GetTag() != d_x_tag_)
        || (!D_x && d_x_tag_ != 0) || (delta_x != delta_x_) || (D_s && D_s->GetTag() != d_s_tag_) || (!D_s && d_s_tag_ != 0)
        || (delta_s != delta_s_) || (J_c.GetTag() != j_c_tag_) || (D_c && D_c->GetTag() != d_c_tag_)
        || (!D_c && d_c_tag_ != 0) || (delta_c != delta_c_) || (J_d.GetTag() != j_d_tag_)
@@ -551,6 +582,16 @@ bool StdAugSystemSolver::ProvidesInertia() const
    return linsolver_->ProvidesInertia();
 }
 
+bool StdAugSystemSolver::ProvidesBackwardError() const
+{
+   return linsolver_->ProvidesBackwardError();
+}
+
+Number StdAugSystemSolver::BackwardError() const
+{
+   return linsolver_->BackwardError();
+}
+
 bool StdAugSystemSolver::IncreaseQuality()
 {
    return linsolver_->IncreaseQuality();
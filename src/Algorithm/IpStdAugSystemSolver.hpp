@@ -86,6 +86,10 @@ public:
     */
    virtual bool ProvidesInertia() const;
 
+   virtual bool ProvidesBackwardError() const;
+
+   virtual Number BackwardError() const;
+
    /** Request to increase quality of solution for next solve.
     *
     *  Ask underlying linear solver to increase quality of solution
@@ -137,11 +141,14 @@ private:
       const Vector&    proto_d
    );
 
-   /** Create the new compound sym matrix that represents the
+   /** Create or update the compound sym matrix that represents the
     *  augmented system.
     *
-    *  This is done EVERY time Solve is called
-    *  with ANY different information.
+    *  This is done EVERY time Solve is called with ANY different
+    *  information.  The compound matrix and its blocks are created
+    *  only in the first call.  Later calls update the blocks in place
+    *  and only set the blocks that changed again, so that the tags of
+    *  the unchanged blocks stay the same.
     */
    void CreateAugmentedSystem(
       const SymMatrix* W,
@@ -162,6 +169,20 @@ private:
       const Vector&    proto_d
    );
 
+   /** Set the diagonal of diag_mat to D+delta*I, or to delta*I if D
+    *  is NULL.
+    *
+    *  If needed, the sum is stored in work, which is created from
+    *  proto in the first call and reused afterwards.
+    */
+   void SetDiagBlock(
+      DiagMatrix&       diag_mat,
+      SmartPtr<Vector>& work,
+      const Vector*     D,
+      double            delta,
+      const Vector&     proto
+   );
+
    /** Check the internal tags and decide if the passed variables are
     *  different from what is in the augmented_system_.
     */
@@ -180,6 +201,16 @@ private:
       double           delta_d
    );
 
+   /** Check whether an augmented system that requires a change
+    *  differs from augmented_system_ only in the diagonal matrices.
+    */
+   bool OnlyDiagonalRequiresChange(
+      const SymMatrix* W,
+      double           W_factor,
+      const Matrix&    J_c,
+      const Matrix&    J_d
+   );
+
    /** The linear solver object that is to be used to solve the
     *  linear systems.
     */
@@ -277,6 +308,37 @@ private:
     */
    SmartPtr<CompoundSymMatrix> augmented_system_;
 
+   /** @name Blocks of augmented_system_ that are updated in place */
+   ///@{
+   /** (1,1) block, W_factor*W + D_x + delta_x*I */
+   SmartPtr<SumSymMatrix> sumsym_x_;
+   /** Diagonal term of the (1,1) block */
+   SmartPtr<DiagMatrix> diag_x_;
+   /** (2,2) block, D_s + delta_s*I */
+   SmartPtr<DiagMatrix> diag_s_;
+   /** (3,3) block, D_c - delta_c*I */
+   SmartPtr<DiagMatrix> diag_c_;
+   /** (4,4) block, D_d - delta_d*I */
+   SmartPtr<DiagMatrix> diag_d_;
+   ///@}
+
+   /** @name Work vectors for the diagonals that are not given directly
+    *  by D_x, D_s, D_c, or D_d
+    */
+   ///@{
+   SmartPtr<Vector> diag_x_work_;
+   SmartPtr<Vector> diag_s_work_;
+   SmartPtr<Vector> diag_c_work_;
+   SmartPtr<Vector> diag_d_work_;
+   ///@}
+
+   /** The diagonals of the diagonal matrices in augmented_system_.
+    *
+    *  These are the elements that are listed last for each row of the
+    *  augmented system in triplet format.
+    */
+   SmartPtr<CompoundVector> augmented_diag_;
+
    /** A copy of a previous W used in the augmented_system_.
     *
     *  Since Solve can be called with a NULL W, we keep a copy of the last W
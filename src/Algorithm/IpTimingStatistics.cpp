@@ -9,36 +9,236 @@
 namespace Ipopt
 {
 
+TimingStatistics::TimingStatistics()
+   : num_fixed_tasks_(0),
+     timing_mode_(TimedTask::TIMING_ALL),
+     record_iterations_(false),
+     trace_(false),
+     last_iteration_time_(0.),
+     LinearSystemThreads_(0),
+     LinearSystemFactorizationsSkipped_(0)
+{
+   RegisterTask("OverallAlgorithm", OverallAlgorithm_);
+   RegisterTask("OverallAlgorithm/PrintProblemStatistics", PrintProblemStatistics_);
+   RegisterTask("OverallAlgorithm/InitializeIterates", InitializeIterates_);
+   RegisterTask("OverallAlgorithm/UpdateHessian", UpdateHessian_);
+   RegisterTask("OverallAlgorithm/OutputIteration", OutputIteration_);
+   RegisterTask("OverallAlgorithm/UpdateBarrierParameter", UpdateBarrierParameter_);
+   RegisterTask("OverallAlgorithm/ComputeSearchDirection", ComputeSearchDirection_);
+   RegisterTask("OverallAlgorithm/ComputeAcceptableTrialPoint", ComputeAcceptableTrialPoint_);
+   RegisterTask("OverallAlgorithm/AcceptTrialPoint", AcceptTrialPoint_);
+   RegisterTask("OverallAlgorithm/CheckConvergence", CheckConvergence_);
+   RegisterTask("PDSystemSolverTotal", PDSystemSolverTotal_);
+   RegisterTask("PDSystemSolverTotal/PDSystemSolverSolveOnce", PDSystemSolverSolveOnce_);
+   RegisterTask("PDSystemSolverTotal/ComputeResiduals", ComputeResiduals_);
+   RegisterTask("PDSystemSolverTotal/StdAugSystemSolverMultiSolve", StdAugSystemSolverMultiSolve_);
+   RegisterTask("PDSystemSolverTotal/LinearSystemScaling", LinearSystemScaling_);
+   RegisterTask("PDSystemSolverTotal/LinearSystemSymbolicFactorization", LinearSystemSymbolicFactorization_);
+   RegisterTask("PDSystemSolverTotal/LinearSystemFactorization", LinearSystemFactorization_);
+   RegisterTask("PDSystemSolverTotal/LinearSystemBackSolve", LinearSystemBackSolve_);
+   RegisterTask("PDSystemSolverTotal/LinearSystemStructureConverter", LinearSystemStructureConverter_);
+   RegisterTask("PDSystemSolverTotal/LinearSystemStructureConverter/LinearSystemStructureConverterInit",
+                LinearSystemStructureConverterInit_);
+   RegisterTask("QualityFunctionSearch", QualityFunctionSearch_);
+   RegisterTask("TryCorrector", TryCorrector_);
+   RegisterTask("Task1", Task1_);
+   RegisterTask("Task2", Task2_);
+   RegisterTask("Task3", Task3_);
+   RegisterTask("Task4", Task4_);
+   RegisterTask("Task5", Task5_);
+   RegisterTask("Task6", Task6_);
+   num_fixed_tasks_ = tasks_.size();
+}
+
+TimingStatistics::~TimingStatistics()
+{
+   for( size_t i = num_fixed_tasks_; i < tasks_.size(); ++i )
+   {
+      delete tasks_[i];
+   }
+}
+
+void TimingStatistics::RegisterTask(
+   const std::string& name,
+   TimedTask&         task
+)
+{
+   DBG_ASSERT(task_positions_.find(name) == task_positions_.end());
+   task_positions_[name] = tasks_.size();
+   task_names_.push_back(name);
+   tasks_.push_back(&task);
+   task.SetName(name);
+   last_task_walltimes_.push_back(0.);
+}
+
+TimedTask& TimingStatistics::NamedTask(
+   const std::string& name
+)
+{
+   std::map<std::string, size_t>::const_iterator it = task_positions_.find(name);
+   if( it != task_positions_.end() )
+   {
+      return *tasks_[it->second];
+   }
+
+   TimedTask* task = new TimedTask();
+   task->SetTimingMode(timing_mode_);
+   task->SetTracing(trace_);
+   RegisterTask(name, *task);
+   return *task;
+}
+
 void TimingStatistics::ResetTimes()
 {
-   OverallAlgorithm_.Reset();
-   PrintProblemStatistics_.Reset();
-   InitializeIterates_.Reset();
-   UpdateHessian_.Reset();
-   OutputIteration_.Reset();
-   UpdateBarrierParameter_.Reset();
-   ComputeSearchDirection_.Reset();
-   ComputeAcceptableTrialPoint_.Reset();
-   AcceptTrialPoint_.Reset();
-   CheckConvergence_.Reset();
-   PDSystemSolverTotal_.Reset();
-   PDSystemSolverSolveOnce_.Reset();
-   ComputeResiduals_.Reset();
-   StdAugSystemSolverMultiSolve_.Reset();
-   LinearSystemScaling_.Reset();
-   LinearSystemSymbolicFactorization_.Reset();
-   LinearSystemFactorization_.Reset();
-   LinearSystemBackSolve_.Reset();
-   LinearSystemStructureConverter_.Reset();
-   LinearSystemStructureConverterInit_.Reset();
-   QualityFunctionSearch_.Reset();
-   TryCorrector_.Reset();
-   Task1_.Reset();
-   Task2_.Reset();
-   Task3_.Reset();
-   Task4_.Reset();
-   Task5_.Reset();
-   Task6_.Reset();
+   for( size_t i = 0; i < tasks_.size(); ++i )
+   {
+      tasks_[i]->Reset();
+      last_task_walltimes_[i] = 0.;
+   }
+   iteration_times_.clear();
+   last_iteration_time_ = MonotonicTime();
+   LinearSystemThreads_ = 0;
+   LinearSystemFactorizationsSkipped_ = 0;
+}
+
+void TimingStatistics::SetTimingMode(
+   TimedTask::ETimingMode mode
+)
+{
+   timing_mode_ = mode;
+   for( size_t i = 0; i < tasks_.size(); ++i )
+   {
+      if( tasks_[i] != &OverallAlgorithm_ )
+      {
+         tasks_[i]->SetTimingMode(mode);
+      }
+   }
+}
+
+void TimingStatistics::SetRecording(
+   bool record_iterations,
+   bool trace
+)
+{
+   record_iterations_ = record_iterations;
+   trace_ = trace;
+   for( size_t i = 0; i < tasks_.size(); ++i )
+   {
+      tasks_[i]->SetTracing(trace);
+   }
+}
+
+void TimingStatistics::EndIteration(
+   Index iter
+)
+{
+   if( !record_iterations_ )
+   {
+      return;
+   }
+
+   IterationTimes times;
+   times.iter = iter;
+   Number now = MonotonicTime();
+   times.walltime = now - last_iteration_time_;
+   last_iteration_time_ = now;
+
+   // tasks that are still running (e.g., OverallAlgorithm) are accounted
+   // for in the iteration in which they end
+   times.task_walltimes.resize(tasks_.size(), 0.);
+   for( size_t i = 0; i < tasks_.size(); ++i )
+   {
+      if( !tasks_[i]->IsStarted() )
+      {
+         Number total = tasks_[i]->TotalWallclockTime();
+         times.task_walltimes[i] = total - last_task_walltimes_[i];
+         last_task_walltimes_[i] = total;
+      }
+   }
+   iteration_times_.push_back(times);
+}
+
+/** write a string with JSON escapes */
+static void WriteJSONString(
+   FILE*              fp,
+   const std::string& str
+)
+{
+   fputc('"', fp);
+   for( size_t i = 0; i < str.size(); ++i )
+   {
+      if( str[i] == '"' || str[i] == '\\' )
+      {
+         fputc('\\', fp);
+      }
+      fputc(str[i], fp);
+   }
+   fputc('"', fp);
+}
+
+void TimingStatistics::WriteJSON(
+   FILE* fp
+) const
+{
+   fprintf(fp, "{\n  \"tasks\": [");
+   bool first = true;
+   for( size_t i = 0; i < tasks_.size(); ++i )
+   {
+      // times of a running task are not available
+      if( tasks_[i]->IsStarted() )
+      {
+         continue;
+      }
+      fprintf(fp, "%s\n    {\"name\": ", first ? "" : ",");
+      first = false;
+      WriteJSONString(fp, task_names_[i]);
+      fprintf(fp, ", \"cpu\": %.9g, \"sys\": %.9g, \"wall\": %.9g}", tasks_[i]->TotalCpuTime(),
+              tasks_[i]->TotalSysTime(), tasks_[i]->TotalWallclockTime());
+   }
+   fprintf(fp, "\n  ],\n  \"iterations\": [");
+   for( size_t k = 0; k < iteration_times_.size(); ++k )
+   {
+      const IterationTimes& times = iteration_times_[k];
+      fprintf(fp, "%s\n    {\"iter\": %d, \"wall\": %.9g, \"tasks\": {", k > 0 ? "," : "", (int) times.iter,
+              times.walltime);
+      first = true;
+      for( size_t i = 0; i < times.task_walltimes.size(); ++i )
+      {
+         if( times.task_walltimes[i] == 0. )
+         {
+            continue;
+         }
+         fprintf(fp, "%s", first ? "" : ", ");
+         WriteJSONString(fp, task_names_[i]);
+         fprintf(fp, ": %.9g", times.task_walltimes[i]);
+         first = false;
+      }
+      fprintf(fp, "}}");
+   }
+   fprintf(fp, "\n  ]\n}\n");
+}
+
+void TimingStatistics::WriteChromeTrace(
+   FILE* fp
+) const
+{
+   fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+   bool first = true;
+   for( size_t i = 0; i < tasks_.size(); ++i )
+   {
+      const std::vector<std::pair<Number, Number> >& intervals = tasks_[i]->TraceIntervals();
+      for( size_t k = 0; k < intervals.size(); ++k )
+      {
+         // complete events with timestamps in microseconds; the viewer
+         // nests events of the same thread by their time intervals
+         fprintf(fp, "%s\n  {\"name\": ", first ? "" : ",");
+         WriteJSONString(fp, task_names_[i]);
+         fprintf(fp, ", \"cat\": \"ipopt\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %.3f, \"dur\": %.3f}",
+                 1e6 * intervals[k].first, 1e6 * (intervals[k].second - intervals[k].first));
+         first = false;
+      }
+   }
+   fprintf(fp, "\n]}\n");
 }
 
 void TimingStatistics::PrintAllTimingStatistics(
@@ -93,6 +293,16 @@ void TimingStatistics::PrintAllTimingStatistics(
                 " LinearSystemStructureConverter.....: %10.3f (sys: %10.3f wall: %10.3f)\n", LinearSystemStructureConverter_.TotalCpuTime(), LinearSystemStructureConverter_.TotalSysTime(), LinearSystemStructureConverter_.TotalWallclockTime());
    jnlst.Printf(level, category,
                 "  LinearSystemStructureConverterInit: %10.3f (sys: %10.3f wall: %10.3f)\n", LinearSystemStructureConverterInit_.TotalCpuTime(), LinearSystemStructureConverterInit_.TotalSysTime(), LinearSystemStructureConverterInit_.TotalWallclockTime());
+   if( LinearSystemThreads_ > 0 )
+   {
+      jnlst.Printf(level, category,
+                   " LinearSystemThreads................: %10" IPOPT_INDEX_FORMAT "\n", LinearSystemThreads_);
+   }
+   if( LinearSystemFactorizationsSkipped_ > 0 )
+   {
+      jnlst.Printf(level, category,
+                   " LinearSystemFactorizationsSkipped..: %10" IPOPT_INDEX_FORMAT "\n", LinearSystemFactorizationsSkipped_);
+   }
    jnlst.Printf(level, category,
                 "QualityFunctionSearch...............: %10.3f (sys: %10.3f wall: %10.3f)\n", QualityFunctionSearch_.TotalCpuTime(), QualityFunctionSearch_.TotalSysTime(), QualityFunctionSearch_.TotalWallclockTime());
    jnlst.Printf(level, category,
@@ -107,6 +317,18 @@ void TimingStatistics::PrintAllTimingStatistics(
                 "Task4...............................: %10.3f (sys: %10.3f wall: %10.3f)\n", Task4_.TotalCpuTime(), Task4_.TotalSysTime(), Task4_.TotalWallclockTime());
    jnlst.Printf(level, category,
                 "Task5...............................: %10.3f (sys: %10.3f wall: %10.3f)\n", Task5_.TotalCpuTime(), Task5_.TotalSysTime(), Task5_.TotalWallclockTime());
+
+   // tasks that have been registered by name
+   for( size_t i = num_fixed_tasks_; i < tasks_.size(); ++i )
+   {
+      std::string label = task_names_[i];
+      if( label.size() < 36 )
+      {
+         label.append(36 - label.size(), '.');
+      }
+      jnlst.Printf(level, category,
+                   "%s: %10.3f (sys: %10.3f wall: %10.3f)\n", label.c_str(), tasks_[i]->TotalCpuTime(), tasks_[i]->TotalSysTime(), tasks_[i]->TotalWallclockTime());
+   }
 }
 
 } // namespace Ipopt
@@ -11,9 +11,20 @@
 #include "IpJournalist.hpp"
 #include "IpTimedTask.hpp"
 
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+
 namespace Ipopt
 {
 /** This class collects all timing statistics for Ipopt.
+ *
+ *  Next to the fixed tasks with accessor methods, any component can
+ *  obtain additional tasks by name, see NamedTask.  All tasks are kept
+ *  in one registry with hierarchical names, where the levels are
+ *  separated by '/', and can be exported with their per-iteration
+ *  breakdown as JSON or in the Chrome trace event format.
  */
 class IPOPTLIB_EXPORT TimingStatistics: public ReferencedObject
 {
@@ -21,17 +32,26 @@ public:
    /**@name Constructors/Destructors */
    ///@{
    /** Default constructor. */
-   TimingStatistics()
-   { }
+   TimingStatistics();
 
    /** Destructor */
-   virtual ~TimingStatistics()
-   { }
+   virtual ~TimingStatistics();
    ///@}
 
    /** Method for resetting all times. */
    void ResetTimes();
 
+   /** Method for setting the clocks that are read for all tasks
+    *  except OverallAlgorithm.
+    *
+    *  OverallAlgorithm always reads all clocks, since its times are
+    *  reported in the solve statistics.  This should only be called
+    *  while no task is timed.
+    */
+   void SetTimingMode(
+      TimedTask::ETimingMode mode
+   );
+
    /** Method for printing all timing information */
    void PrintAllTimingStatistics(
       Journalist&      jnlst,
@@ -39,6 +59,50 @@ public:
       EJournalCategory category
    ) const;
 
+   /** Method returning the task with the given name.
+    *
+    *  The task is created at the first call for a name.  Levels of the
+    *  hierarchy are separated by '/' in the name, e.g.,
+    *  "OverallAlgorithm/ComputeAcceptableTrialPoint/RestorationPhase".
+    *  The fixed tasks are registered with such names, too.  Since the
+    *  task is found by a string lookup, the reference should be kept
+    *  if the task is timed frequently.
+    */
+   TimedTask& NamedTask(
+      const std::string& name
+   );
+
+   /** Method for enabling the recording needed for the export.
+    *
+    *  If record_iterations is true, EndIteration stores the time spent
+    *  in each task since the previous call.  If trace is true, every
+    *  timed interval of every task is stored for the Chrome trace.
+    */
+   void SetRecording(
+      bool record_iterations,
+      bool trace
+   );
+
+   /** Method for marking the end of an iteration.
+    *
+    *  Does nothing if the recording of iterations is not enabled.
+    */
+   void EndIteration(
+      Index iter
+   );
+
+   /** Method for writing all tasks and the per-iteration breakdown
+    *  of their wallclock times as JSON. */
+   void WriteJSON(
+      FILE* fp
+   ) const;
+
+   /** Method for writing all recorded intervals in the Chrome trace
+    *  event format (as read by chrome://tracing or Perfetto). */
+   void WriteChromeTrace(
+      FILE* fp
+   ) const;
+
    /**@name Accessor methods to all timed tasks. */
    ///@{
    TimedTask& OverallAlgorithm()
@@ -182,6 +246,32 @@ public:
    }
    ///@}
 
+   /** Number of threads that the linear solver could use at most, or 0 if not known. */
+   Index LinearSystemThreads() const
+   {
+      return LinearSystemThreads_;
+   }
+
+   /** Record the number of threads that the linear solver could use in a call. */
+   void SetLinearSystemThreads(
+      Index nthreads
+   )
+   {
+      LinearSystemThreads_ = Max(LinearSystemThreads_, nthreads);
+   }
+
+   /** Number of factorizations that were skipped because the matrix values did not change. */
+   Index LinearSystemFactorizationsSkipped() const
+   {
+      return LinearSystemFactorizationsSkipped_;
+   }
+
+   /** Record that a factorization of an unchanged matrix has been skipped. */
+   void IncreaseLinearSystemFactorizationsSkipped()
+   {
+      LinearSystemFactorizationsSkipped_++;
+   }
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -237,6 +327,56 @@ private:
    TimedTask Task5_;
    TimedTask Task6_;
    ///@}
+
+   /** Register a task under a name */
+   void RegisterTask(
+      const std::string& name,
+      TimedTask&         task
+   );
+
+   /**@name Registry of all tasks */
+   ///@{
+   /** Names of the tasks */
+   std::vector<std::string> task_names_;
+   /** Tasks in the order of their registration */
+   std::vector<TimedTask*> tasks_;
+   /** Position of a task in tasks_ by name */
+   std::map<std::string, size_t> task_positions_;
+   /** Number of fixed tasks; the remaining tasks are owned by this object */
+   size_t num_fixed_tasks_;
+   /** Timing mode for all tasks except OverallAlgorithm */
+   TimedTask::ETimingMode timing_mode_;
+   ///@}
+
+   /**@name Recording for the export */
+   ///@{
+   /** Wallclock times of one iteration */
+   struct IterationTimes
+   {
+      /** iteration counter */
+      Index iter;
+      /** monotonic time spent in the iteration */
+      Number walltime;
+      /** wallclock time spent in each task during the iteration */
+      std::vector<Number> task_walltimes;
+   };
+
+   /** Whether EndIteration records the iteration times */
+   bool record_iterations_;
+   /** Whether all timed intervals are recorded */
+   bool trace_;
+   /** Recorded iteration times */
+   std::vector<IterationTimes> iteration_times_;
+   /** Total wallclock time of each task at the previous EndIteration */
+   std::vector<Number> last_task_walltimes_;
+   /** Monotonic time at the previous EndIteration or reset */
+   Number last_iteration_time_;
+   ///@}
+
+   /** Maximal number of threads of the linear solver */
+   Index LinearSystemThreads_;
+   /** Number of skipped factorizations of unchanged matrices */
+   Index LinearSystemFactorizationsSkipped_;
 };
 
 } // namespace Ipopt
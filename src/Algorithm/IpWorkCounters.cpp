@@ -0,0 +1,94 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpWorkCounters.hpp"
+#include "IpIpoptNLP.hpp"
+
+namespace Ipopt
+{
+
+WorkCounters::WorkCounters()
+{
+   for( Index i = 0; i < NUM_COUNTERS; ++i )
+   {
+      current_[i] = 0;
+      recorded_[i] = 0;
+   }
+}
+
+WorkCounters::~WorkCounters()
+{ }
+
+void WorkCounters::SetNLP(
+   const SmartPtr<const IpoptNLP>& ip_nlp
+)
+{
+   if( IsNull(ip_nlp_) )
+   {
+      ip_nlp_ = ip_nlp;
+   }
+}
+
+void WorkCounters::UpdateEvaluations()
+{
+   if( IsNull(ip_nlp_) )
+   {
+      return;
+   }
+   current_[OBJ_EVALS] = ip_nlp_->f_evals() - recorded_[OBJ_EVALS];
+   current_[CONSTR_EVALS] = Max(ip_nlp_->c_evals(), ip_nlp_->d_evals()) - recorded_[CONSTR_EVALS];
+   current_[OBJ_GRAD_EVALS] = ip_nlp_->grad_f_evals() - recorded_[OBJ_GRAD_EVALS];
+   current_[CONSTR_JAC_EVALS] = Max(ip_nlp_->jac_c_evals(), ip_nlp_->jac_d_evals()) - recorded_[CONSTR_JAC_EVALS];
+   current_[HESS_EVALS] = ip_nlp_->h_evals() - recorded_[HESS_EVALS];
+}
+
+void WorkCounters::EndIteration(
+   Index iter
+)
+{
+   if( iter < 0 )
+   {
+      return;
+   }
+   UpdateEvaluations();
+   for( Index i = 0; i < NUM_COUNTERS; ++i )
+   {
+      if( (Index) per_iteration_[i].size() <= iter )
+      {
+         per_iteration_[i].resize(iter + 1, 0);
+      }
+      // the restoration phase ends an iteration that is ended again
+      // by the regular algorithm, so counts are added up
+      per_iteration_[i][iter] += current_[i];
+      recorded_[i] += current_[i];
+      current_[i] = 0;
+   }
+}
+
+Index WorkCounters::Total(
+   Counter counter
+) const
+{
+   if( counter >= OBJ_EVALS && IsValid(ip_nlp_) )
+   {
+      switch( counter )
+      {
+         case OBJ_EVALS:
+            return ip_nlp_->f_evals();
+         case CONSTR_EVALS:
+            return Max(ip_nlp_->c_evals(), ip_nlp_->d_evals());
+         case OBJ_GRAD_EVALS:
+            return ip_nlp_->grad_f_evals();
+         case CONSTR_JAC_EVALS:
+            return Max(ip_nlp_->jac_c_evals(), ip_nlp_->jac_d_evals());
+         case HESS_EVALS:
+            return ip_nlp_->h_evals();
+         default:
+            break;
+      }
+   }
+   return recorded_[counter] + current_[counter];
+}
+
+} // namespace Ipopt
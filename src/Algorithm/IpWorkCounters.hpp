@@ -0,0 +1,152 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPWORKCOUNTERS_HPP__
+#define __IPWORKCOUNTERS_HPP__
+
+#include "IpReferenced.hpp"
+#include "IpSmartPtr.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+/* Forward declaration */
+class IpoptNLP;
+
+/** This class counts the work done by the algorithm in each iteration,
+ *  such as the number of factorizations of the linear solver and the
+ *  number of function evaluations.
+ *
+ *  The work done after the end of iteration k-1 until the end of
+ *  iteration k is counted for iteration k, and the work done for the
+ *  initialization is counted for iteration 0.  The restoration phase
+ *  shares the counters of the regular algorithm, so that the work of a
+ *  restoration phase iteration is counted for the iteration number that
+ *  is shown in the output.
+ */
+class IPOPTLIB_EXPORT WorkCounters: public ReferencedObject
+{
+public:
+   /** Kinds of work that are counted */
+   enum Counter
+   {
+      /** Numerical factorizations by the linear solver */
+      FACTORIZATIONS = 0,
+      /** Repeated solves of the primal-dual system with a modified
+       *  perturbation or an increased pivot tolerance, because the
+       *  matrix was singular or had the wrong inertia */
+      INERTIA_CORRECTIONS,
+      /** Right hand sides solved by the linear solver */
+      BACKSOLVES,
+      /** Iterative refinement steps for the primal-dual system */
+      REFINEMENT_STEPS,
+      /** Second order correction steps tried by the line search */
+      SOC_TRIALS,
+      /** Objective function evaluations */
+      OBJ_EVALS,
+      /** Constraint evaluations (max of equality and inequality) */
+      CONSTR_EVALS,
+      /** Objective gradient evaluations */
+      OBJ_GRAD_EVALS,
+      /** Constraint Jacobian evaluations (max of equality and inequality) */
+      CONSTR_JAC_EVALS,
+      /** Lagrangian Hessian evaluations */
+      HESS_EVALS,
+      /** Number of counters */
+      NUM_COUNTERS
+   };
+
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Default Constructor */
+   WorkCounters();
+
+   /** Destructor */
+   virtual ~WorkCounters();
+   ///@}
+
+   /** Set the NLP whose evaluation counts are recorded.
+    *
+    *  Only the first NLP is kept, so that the restoration phase
+    *  does not replace the original NLP by the restoration phase NLP.
+    */
+   void SetNLP(
+      const SmartPtr<const IpoptNLP>& ip_nlp
+   );
+
+   /** Count inc units of work of the given kind for the current iteration. */
+   void Increase(
+      Counter counter,
+      Index   inc = 1
+   )
+   {
+      current_[counter] += inc;
+   }
+
+   /** Finish the counts of iteration iter. */
+   void EndIteration(
+      Index iter
+   );
+
+   /** Total count of the given kind, including the work done after the
+    *  last call of EndIteration. */
+   Index Total(
+      Counter counter
+   ) const;
+
+   /** Counts of the given kind for each finished iteration.
+    *
+    *  The vector has an entry for every iteration up to the last
+    *  one for which EndIteration has been called.
+    */
+   const std::vector<Index>& PerIteration(
+      Counter counter
+   ) const
+   {
+      return per_iteration_[counter];
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   WorkCounters(
+      const WorkCounters&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const WorkCounters&
+   );
+   ///@}
+
+   /** Get the evaluation counts of the NLP into the current counts */
+   void UpdateEvaluations();
+
+   /** NLP whose evaluations are counted */
+   SmartPtr<const IpoptNLP> ip_nlp_;
+
+   /** Counts since the last EndIteration */
+   Index current_[NUM_COUNTERS];
+
+   /** Counts up to the last EndIteration */
+   Index recorded_[NUM_COUNTERS];
+
+   /** Counts for each iteration */
+   std::vector<Index> per_iteration_[NUM_COUNTERS];
+};
+
+} // namespace Ipopt
+
+#endif
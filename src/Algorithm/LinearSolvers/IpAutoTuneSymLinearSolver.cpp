@@ -0,0 +1,488 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpAutoTuneSymLinearSolver.hpp"
+#include "IpOrderingCache.hpp"
+#include "IpTripletHelper.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+/** Identification of the files with cached choices */
+static const char* autotune_file_magic = "ipopt-autotune";
+
+/** Choices of all AutoTuneSymLinearSolvers of this process, keyed by structure */
+static std::map<std::string, std::string> autotune_choices;
+/** Mutex for autotune_choices, since solves may run concurrently */
+static std::mutex autotune_choices_mutex;
+
+AutoTuneSymLinearSolver::AutoTuneSymLinearSolver()
+   : SymLinearSolver(),
+     selected_(-1)
+{ }
+
+AutoTuneSymLinearSolver::~AutoTuneSymLinearSolver()
+{ }
+
+void AutoTuneSymLinearSolver::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddStringOption2(
+      "linear_solver_autotune",
+      "Whether to choose the fastest linear solver configuration for the first linear system.",
+      "no",
+      "no", "Use the linear solver given by linear_solver.",
+      "yes", "Try all available linear solvers with different orderings for the first linear system.",
+      "If \"yes\" is chosen, the first linear system is factorized and solved with each available linear solver, "
+      "for MA57, HSL_MA77, HSL_MA86, HSL_MA97, Pardiso, and MUMPS with both an AMD and a MeTiS ordering, "
+      "unless the ordering option of the linear solver has been set. "
+      "The configuration that needed the least wallclock time is used for the remaining linear systems, "
+      "and the option linear_solver is ignored. "
+      "Other options of the linear solvers, e.g., linear_system_scaling, are used as given for all configurations. "
+      "The choice is remembered for the nonzero structure of the linear system, "
+      "so that later solves in the same process for a linear system with the same structure use it without trials. "
+      "If ordering_cache_dir is set, the choice is also stored in a file in this directory, "
+      "so that it is available for other processes.");
+}
+
+std::vector<AutoTuneSymLinearSolver::Configuration> AutoTuneSymLinearSolver::CandidateConfigurations(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   static const char* configs[][4] =
+   {
+      // name, linear_solver, option, value
+      { "ma27", "ma27", "", "" },
+      { "ma57-amd", "ma57", "ma57_pivot_order", "2" },
+      { "ma57-metis", "ma57", "ma57_pivot_order", "4" },
+      { "ma77-amd", "ma77", "ma77_order", "amd" },
+      { "ma77-metis", "ma77", "ma77_order", "metis" },
+      { "ma86-amd", "ma86", "ma86_order", "amd" },
+      { "ma86-metis", "ma86", "ma86_order", "metis" },
+      { "ma97-amd", "ma97", "ma97_order", "amd" },
+      { "ma97-metis", "ma97", "ma97_order", "metis" },
+      { "pardiso-amd", "pardiso", "pardiso_order", "amd" },
+      { "pardiso-metis", "pardiso", "pardiso_order", "metis" },
+      { "wsmp", "wsmp", "", "" },
+      { "mumps-amd", "mumps", "mumps_pivot_order", "0" },
+      { "mumps-metis", "mumps", "mumps_pivot_order", "5" },
+      { "cudss", "cudss", "", "" }
+   };
+
+   std::vector<Configuration> candidates;
+   for( size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++ )
+   {
+      Configuration config;
+      config.name = configs[i][0];
+      config.linear_solver = configs[i][1];
+      config.option = configs[i][2];
+      config.value = configs[i][3];
+      config.integer_option = config.option == "ma57_pivot_order" || config.option == "mumps_pivot_order";
+
+      if( !config.option.empty() )
+      {
+         // an ordering that has been set by the user is kept, so
+         // there is only one configuration for this linear solver
+         std::string str_value;
+         Index int_value;
+         bool user_set;
+         try
+         {
+            user_set = config.integer_option ? options.GetIntegerValue(config.option, int_value, prefix)
+                       : options.GetStringValue(config.option, str_value, prefix);
+         }
+         catch( OPTION_INVALID& )
+         {
+            // the option is not registered, since the linear solver is not part of this build
+            continue;
+         }
+         if( user_set )
+         {
+            if( !candidates.empty() && candidates.back().linear_solver == config.linear_solver )
+            {
+               continue;
+            }
+            config.name = config.linear_solver;
+            config.option.clear();
+            config.value.clear();
+         }
+      }
+      candidates.push_back(config);
+   }
+   return candidates;
+}
+
+bool AutoTuneSymLinearSolver::SetConfigurationOptions(
+   const Configuration& config,
+   OptionsList&         options
+)
+{
+   if( config.option.empty() )
+   {
+      return true;
+   }
+   if( config.integer_option )
+   {
+      return options.SetIntegerValue(config.option, atoi(config.value.c_str()), true, true);
+   }
+   return options.SetStringValue(config.option, config.value, true, true);
+}
+
+void AutoTuneSymLinearSolver::AddCandidate(
+   const Configuration&      config,
+   SmartPtr<SymLinearSolver> solver
+)
+{
+   DBG_ASSERT(selected_ < 0);
+   configs_.push_back(config);
+   candidates_.push_back(solver);
+}
+
+bool AutoTuneSymLinearSolver::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   DBG_START_METH("AutoTuneSymLinearSolver::InitializeImpl", dbg_verbosity);
+
+   options.GetStringValue("ordering_cache_dir", cache_dir_, prefix);
+
+   // initialize the candidates with their options; after the choice
+   // has been made, only the chosen one is left
+   bool any_inertia = false;
+   for( size_t i = 0; i < candidates_.size(); i++ )
+   {
+      if( IsNull(candidates_[i]) )
+      {
+         continue;
+      }
+      OptionsList config_options(options);
+      bool ok = SetConfigurationOptions(configs_[i], config_options);
+      if( ok )
+      {
+         if( HaveIpData() )
+         {
+            ok = candidates_[i]->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), config_options, prefix);
+         }
+         else
+         {
+            ok = candidates_[i]->ReducedInitialize(Jnlst(), config_options, prefix);
+         }
+      }
+      if( !ok )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Linear solver configuration %s could not be initialized.\n", configs_[i].name.c_str());
+         candidates_[i] = NULL;
+         if( selected_ == (Index) i )
+         {
+            return false;
+         }
+         continue;
+      }
+      any_inertia = any_inertia || candidates_[i]->ProvidesInertia();
+   }
+
+   // all candidates must provide the inertia if one does, since this
+   // is queried before the choice is made
+   Index num_candidates = 0;
+   for( size_t i = 0; i < candidates_.size(); i++ )
+   {
+      if( IsValid(candidates_[i]) && any_inertia && !candidates_[i]->ProvidesInertia() )
+      {
+         candidates_[i] = NULL;
+      }
+      if( IsValid(candidates_[i]) )
+      {
+         num_candidates++;
+      }
+   }
+
+   return num_candidates > 0;
+}
+
+ESymSolverStatus AutoTuneSymLinearSolver::MultiSolve(
+   const SymMatrix&                      A,
+   std::vector<SmartPtr<const Vector> >& rhsV,
+   std::vector<SmartPtr<Vector> >&       solV,
+   bool                                  check_NegEVals,
+   Index                                 numberOfNegEVals
+)
+{
+   DBG_START_METH("AutoTuneSymLinearSolver::MultiSolve", dbg_verbosity);
+
+   if( selected_ >= 0 )
+   {
+      return candidates_[selected_]->MultiSolve(A, rhsV, solV, check_NegEVals, numberOfNegEVals);
+   }
+
+   std::string key;
+   Index cached = LookupCache(A, key);
+   if( cached >= 0 )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Using linear solver configuration %s from the cache for structure %s.\n",
+                     configs_[cached].name.c_str(), key.c_str());
+      Select(cached);
+      return candidates_[selected_]->MultiSolve(A, rhsV, solV, check_NegEVals, numberOfNegEVals);
+   }
+
+   // factorize the matrix with all candidates, each with its own
+   // solution vectors
+   Index best = -1;
+   Number best_time = 0.;
+   ESymSolverStatus best_status = SYMSOLVER_FATAL_ERROR;
+   std::vector<SmartPtr<Vector> > best_solV;
+   for( size_t i = 0; i < candidates_.size(); i++ )
+   {
+      if( IsNull(candidates_[i]) )
+      {
+         continue;
+      }
+      std::vector<SmartPtr<Vector> > trial_solV(solV.size());
+      for( size_t irhs = 0; irhs < solV.size(); irhs++ )
+      {
+         trial_solV[irhs] = solV[irhs]->MakeNew();
+      }
+
+      Number start = WallclockTime();
+      ESymSolverStatus status = candidates_[i]->MultiSolve(A, rhsV, trial_solV, check_NegEVals, numberOfNegEVals);
+      Number time = WallclockTime() - start;
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Linear solver configuration %-14s: status %d, %10.6f seconds.\n",
+                     configs_[i].name.c_str(), (int) status, time);
+
+      if( status != SYMSOLVER_FATAL_ERROR && (best < 0 || best_status == SYMSOLVER_FATAL_ERROR || time < best_time) )
+      {
+         best = (Index) i;
+         best_time = time;
+         best_status = status;
+         best_solV = trial_solV;
+      }
+      else if( best < 0 )
+      {
+         // keep the first candidate if all of them fail
+         best = (Index) i;
+         best_status = status;
+      }
+   }
+   DBG_ASSERT(best >= 0);
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Choosing linear solver configuration %s for structure %s.\n", configs_[best].name.c_str(), key.c_str());
+   Select(best);
+   if( best_status != SYMSOLVER_FATAL_ERROR )
+   {
+      StoreCache(key);
+   }
+   if( best_status == SYMSOLVER_SUCCESS )
+   {
+      for( size_t irhs = 0; irhs < solV.size(); irhs++ )
+      {
+         solV[irhs]->Copy(*best_solV[irhs]);
+      }
+   }
+   return best_status;
+}
+
+void AutoTuneSymLinearSolver::Select(
+   Index pos
+)
+{
+   DBG_ASSERT(pos >= 0 && pos < (Index) candidates_.size() && IsValid(candidates_[pos]));
+   for( size_t i = 0; i < candidates_.size(); i++ )
+   {
+      if( (Index) i != pos )
+      {
+         candidates_[i] = NULL;
+      }
+   }
+   selected_ = pos;
+}
+
+Index AutoTuneSymLinearSolver::LookupCache(
+   const SymMatrix& A,
+   std::string&     key
+) const
+{
+   Index nonzeros = TripletHelper::GetNumberEntries(A);
+   std::vector<Index> irn(nonzeros);
+   std::vector<Index> jcn(nonzeros);
+   if( nonzeros > 0 )
+   {
+      TripletHelper::FillRowCol(nonzeros, A, &irn[0], &jcn[0]);
+   }
+   OrderingCache structure("", "autotune");
+   structure.SetStructure(A.Dim(), nonzeros, nonzeros > 0 ? &irn[0] : NULL, nonzeros > 0 ? &jcn[0] : NULL);
+
+   char buffer[64];
+   Snprintf(buffer, 63, "%" IPOPT_INDEX_FORMAT "_%" IPOPT_INDEX_FORMAT "_%08x", A.Dim(), nonzeros, structure.Hash());
+   key = buffer;
+
+   std::string name;
+   {
+      std::lock_guard<std::mutex> lock(autotune_choices_mutex);
+      std::map<std::string, std::string>::const_iterator it = autotune_choices.find(key);
+      if( it != autotune_choices.end() )
+      {
+         name = it->second;
+      }
+   }
+
+   if( name.empty() && !cache_dir_.empty() )
+   {
+      std::string filename = cache_dir_ + "/autotune_" + key + ".cfg";
+      FILE* fp = fopen(filename.c_str(), "r");
+      if( fp != NULL )
+      {
+         char magic[32];
+         char file_key[64];
+         char config[64];
+         if( fscanf(fp, "%31s %63s %63s", magic, file_key, config) == 3 && std::string(magic) == autotune_file_magic
+             && key == file_key )
+         {
+            name = config;
+         }
+         fclose(fp);
+      }
+   }
+
+   for( size_t i = 0; !name.empty() && i < candidates_.size(); i++ )
+   {
+      if( IsValid(candidates_[i]) && configs_[i].name == name )
+      {
+         return (Index) i;
+      }
+   }
+   return -1;
+}
+
+void AutoTuneSymLinearSolver::StoreCache(
+   const std::string& key
+) const
+{
+   const std::string& name = configs_[selected_].name;
+   {
+      std::lock_guard<std::mutex> lock(autotune_choices_mutex);
+      autotune_choices[key] = name;
+   }
+
+   if( cache_dir_.empty() )
+   {
+      return;
+   }
+
+   // write to a temporary file first, so that other processes never see
+   // an incomplete file
+   std::string filename = cache_dir_ + "/autotune_" + key + ".cfg";
+   std::string tmpname = filename + ".tmp";
+   FILE* fp = fopen(tmpname.c_str(), "w");
+   bool ok = fp != NULL;
+   if( ok )
+   {
+      ok = fprintf(fp, "%s %s %s\n", autotune_file_magic, key.c_str(), name.c_str()) > 0;
+      ok = (fclose(fp) == 0) && ok;
+      ok = ok && (rename(tmpname.c_str(), filename.c_str()) == 0);
+      if( !ok )
+      {
+         remove(tmpname.c_str());
+      }
+   }
+   if( !ok )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "Could not write the linear solver configuration to file %s.\n", filename.c_str());
+   }
+}
+
+Index AutoTuneSymLinearSolver::NumberOfNegEVals() const
+{
+   DBG_ASSERT(selected_ >= 0);
+   return candidates_[selected_]->NumberOfNegEVals();
+}
+
+void AutoTuneSymLinearSolver::SetDiagonalChange(
+   const SymMatrix&  A,
+   TaggedObject::Tag prev_tag,
+   const Vector&     diag
+)
+{
+   if( selected_ >= 0 )
+   {
+      candidates_[selected_]->SetDiagonalChange(A, prev_tag, diag);
+   }
+}
+
+bool AutoTuneSymLinearSolver::IncreaseQuality()
+{
+   if( selected_ >= 0 )
+   {
+      return candidates_[selected_]->IncreaseQuality();
+   }
+   bool retval = false;
+   for( size_t i = 0; i < candidates_.size(); i++ )
+   {
+      if( IsValid(candidates_[i]) && candidates_[i]->IncreaseQuality() )
+      {
+         retval = true;
+      }
+   }
+   return retval;
+}
+
+bool AutoTuneSymLinearSolver::ProvidesInertia() const
+{
+   for( size_t i = 0; i < candidates_.size(); i++ )
+   {
+      // InitializeImpl ensures that all candidates agree
+      if( IsValid(candidates_[i]) )
+      {
+         return candidates_[i]->ProvidesInertia();
+      }
+   }
+   return false;
+}
+
+bool AutoTuneSymLinearSolver::ProvidesBackwardError() const
+{
+   if( selected_ >= 0 )
+   {
+      return candidates_[selected_]->ProvidesBackwardError();
+   }
+   return false;
+}
+
+Number AutoTuneSymLinearSolver::BackwardError() const
+{
+   DBG_ASSERT(selected_ >= 0);
+   return candidates_[selected_]->BackwardError();
+}
+
+bool AutoTuneSymLinearSolver::EstimateFactorization(
+   const SymMatrix& A,
+   Number&          factor_nonzeros,
+   Number&          flops,
+   Number&          memory
+)
+{
+   // the estimate depends on the configuration, which has not been
+   // chosen before the first matrix has been factorized
+   if( selected_ >= 0 )
+   {
+      return candidates_[selected_]->EstimateFactorization(A, factor_nonzeros, flops, memory);
+   }
+   return false;
+}
+
+} // namespace Ipopt
@@ -0,0 +1,201 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPAUTOTUNESYMLINEARSOLVER_HPP__
+#define __IPAUTOTUNESYMLINEARSOLVER_HPP__
+
+#include "IpSymLinearSolver.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Ipopt
+{
+
+/** Linear solver that chooses the fastest of several linear solver
+ *  configurations for the first matrix it is given.
+ *
+ *  A configuration is a linear solver (as for the option
+ *  linear_solver) together with at most one option of this solver,
+ *  usually its fill-reducing ordering.  The AlgorithmBuilder creates a
+ *  SymLinearSolver for every configuration that is available.  For
+ *  the first matrix, each of them factorizes the matrix and solves the
+ *  linear systems, and the one that needed the least wallclock time is
+ *  kept and used for all further linear systems, also in
+ *  reoptimizations.  The other solvers are deleted, so that their
+ *  factorizations do not take memory.
+ *
+ *  The choice is stored in a cache that is keyed by a hash of the
+ *  structure of the matrix (see OrderingCache).  If a later solve,
+ *  e.g., of the same model with other data, encounters the same
+ *  structure, the stored configuration is used without trial
+ *  factorizations.  The cache is kept in memory for the lifetime of
+ *  the process and, if the option ordering_cache_dir is set, in files
+ *  in this directory.
+ */
+class AutoTuneSymLinearSolver: public SymLinearSolver
+{
+public:
+   /** A candidate configuration of a linear solver */
+   struct Configuration
+   {
+      /** Name of the configuration, which is used in the cache (without blanks) */
+      std::string name;
+      /** Value of the option linear_solver for this configuration */
+      std::string linear_solver;
+      /** Additional option that is set, or empty */
+      std::string option;
+      /** Value of the additional option */
+      std::string value;
+      /** Whether the additional option is an integer option */
+      bool integer_option;
+   };
+
+   /** @name Constructor/Destructor */
+   ///@{
+   AutoTuneSymLinearSolver();
+
+   virtual ~AutoTuneSymLinearSolver();
+   ///@}
+
+   /** The configurations that are tried, if the linear solver is available.
+    *
+    *  If an ordering option has been set in options, only one
+    *  configuration with this ordering is returned for the linear
+    *  solver.
+    */
+   static std::vector<Configuration> CandidateConfigurations(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** Set the additional option of a configuration in options.
+    *
+    *  @return false, if the option could not be set, e.g., since it is
+    *  not registered in this build of Ipopt.
+    */
+   static bool SetConfigurationOptions(
+      const Configuration& config,
+      OptionsList&         options
+   );
+
+   /** Add a candidate configuration and the linear solver that has
+    *  been created with its options. */
+   void AddCandidate(
+      const Configuration&      config,
+      SmartPtr<SymLinearSolver> solver
+   );
+
+   /** Number of candidate configurations */
+   Index NumCandidates() const
+   {
+      return (Index) candidates_.size();
+   }
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** @name Methods for requesting solution of the linear system. */
+   ///@{
+   virtual ESymSolverStatus MultiSolve(
+      const SymMatrix&                      A,
+      std::vector<SmartPtr<const Vector> >& rhsV,
+      std::vector<SmartPtr<Vector> >&       solV,
+      bool                                  check_NegEVals,
+      Index                                 numberOfNegEVals
+   );
+
+   virtual Index NumberOfNegEVals() const;
+
+   virtual void SetDiagonalChange(
+      const SymMatrix&  A,
+      TaggedObject::Tag prev_tag,
+      const Vector&     diag
+   );
+   ///@}
+
+   //* @name Options of Linear solver */
+   ///@{
+   virtual bool IncreaseQuality();
+
+   virtual bool ProvidesInertia() const;
+
+   virtual bool ProvidesBackwardError() const;
+
+   virtual Number BackwardError() const;
+
+   virtual bool EstimateFactorization(
+      const SymMatrix& A,
+      Number&          factor_nonzeros,
+      Number&          flops,
+      Number&          memory
+   );
+   ///@}
+
+   /** Methods for OptionsList */
+   ///@{
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called. */
+   ///@{
+   /** Copy Constructor */
+   AutoTuneSymLinearSolver(
+      const AutoTuneSymLinearSolver&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const AutoTuneSymLinearSolver&
+   );
+   ///@}
+
+   /** Candidate configurations */
+   std::vector<Configuration> configs_;
+   /** Linear solvers of the candidate configurations; NULL for
+    *  candidates that are not used anymore */
+   std::vector<SmartPtr<SymLinearSolver> > candidates_;
+
+   /** Position of the chosen configuration in candidates_, or -1 if
+    *  it has not been chosen yet */
+   Index selected_;
+
+   /** Directory for the cached choices (option ordering_cache_dir) */
+   std::string cache_dir_;
+
+   /** Keep only the candidate with position pos */
+   void Select(
+      Index pos
+   );
+
+   /** Find the cached configuration for the structure of A.
+    *
+    *  @return the position of the configuration in candidates_, or -1
+    *  if there is none, and the key of the structure in key.
+    */
+   Index LookupCache(
+      const SymMatrix& A,
+      std::string&     key
+   ) const;
+
+   /** Store the chosen configuration for the structure with key key */
+   void StoreCache(
+      const std::string& key
+   ) const;
+};
+
+} // namespace Ipopt
+
+#endif
@@ -0,0 +1,759 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpCuDSSSolverInterface.hpp"
+
+#include <cuda_runtime.h>
+#include <cudss.h>
+
+#include <cmath>
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+/* cuDSS data type of the index arrays of the matrix, which are copied from Index arrays */
+#ifdef IPOPT_INT64
+#define IPOPT_CUDSS_INDEX_TYPE CUDA_R_64I
+#else
+#define IPOPT_CUDSS_INDEX_TYPE CUDA_R_32I
+#endif
+
+/** cuDSS objects and device memory of a CuDSSSolverInterface */
+struct CuDSSData
+{
+   cudssHandle_t handle;
+   cudssConfig_t config;
+   cudssData_t   data;
+   /** matrix (upper triangle in CSR format) */
+   cudssMatrix_t A;
+   /** solution and right hand sides as dense matrices with nrhs columns */
+   cudssMatrix_t x;
+   cudssMatrix_t b;
+   /** number of columns of x and b */
+   Index nrhs;
+   /** number of columns for which d_x and d_b are allocated */
+   Index rhs_capacity;
+   /** whether the values of A, x, and b are of type float instead of double */
+   bool single;
+
+   Index* d_ia;
+   Index* d_ja;
+   void* d_a;
+   void* d_x;
+   void* d_b;
+
+   /** buffer on the host for converting values to and from single precision */
+   float* h_single;
+   /** number of elements of h_single */
+   size_t h_single_size;
+};
+
+/** Print an error and return false if a call of cuDSS has not been successful. */
+static bool CuDSSCallOk(
+   const Journalist& jnlst,
+   cudssStatus_t     status,
+   const char*       what
+)
+{
+   if( status != CUDSS_STATUS_SUCCESS )
+   {
+      jnlst.Printf(J_ERROR, J_LINEAR_ALGEBRA,
+                   "cuDSS: %s failed with status %d.\n", what, (int) status);
+      return false;
+   }
+   return true;
+}
+
+/** Print an error and return false if a call of the CUDA runtime has not been successful. */
+static bool CudaCallOk(
+   const Journalist& jnlst,
+   cudaError_t       error,
+   const char*       what
+)
+{
+   if( error != cudaSuccess )
+   {
+      jnlst.Printf(J_ERROR, J_LINEAR_ALGEBRA,
+                   "cuDSS: %s failed: %s\n", what, cudaGetErrorString(error));
+      return false;
+   }
+   return true;
+}
+
+/** Copy n values to the device, converting them to single precision if needed. */
+static bool CopyToDevice(
+   const Journalist& jnlst,
+   CuDSSData*        cudss,
+   void*             dst,
+   const double*     src,
+   size_t            n,
+   const char*       what
+)
+{
+   if( !cudss->single )
+   {
+      return CudaCallOk(jnlst, cudaMemcpy(dst, src, n * sizeof(double), cudaMemcpyHostToDevice), what);
+   }
+
+   if( cudss->h_single_size < n )
+   {
+      delete[] cudss->h_single;
+      cudss->h_single = new float[n];
+      cudss->h_single_size = n;
+   }
+   for( size_t i = 0; i < n; i++ )
+   {
+      cudss->h_single[i] = (float) src[i];
+   }
+   return CudaCallOk(jnlst, cudaMemcpy(dst, cudss->h_single, n * sizeof(float), cudaMemcpyHostToDevice), what);
+}
+
+/** Copy n values from the device, converting them to double precision if needed. */
+static bool CopyFromDevice(
+   const Journalist& jnlst,
+   CuDSSData*        cudss,
+   double*           dst,
+   const void*       src,
+   size_t            n,
+   const char*       what
+)
+{
+   if( !cudss->single )
+   {
+      return CudaCallOk(jnlst, cudaMemcpy(dst, src, n * sizeof(double), cudaMemcpyDeviceToHost), what);
+   }
+
+   if( cudss->h_single_size < n )
+   {
+      delete[] cudss->h_single;
+      cudss->h_single = new float[n];
+      cudss->h_single_size = n;
+   }
+   if( !CudaCallOk(jnlst, cudaMemcpy(cudss->h_single, src, n * sizeof(float), cudaMemcpyDeviceToHost), what) )
+   {
+      return false;
+   }
+   for( size_t i = 0; i < n; i++ )
+   {
+      dst[i] = cudss->h_single[i];
+   }
+   return true;
+}
+
+/** Free the dense matrices for solution and right hand sides. */
+static void FreeRhsData(
+   CuDSSData* cudss
+)
+{
+   if( cudss->x != NULL )
+   {
+      cudssMatrixDestroy(cudss->x);
+      cudss->x = NULL;
+   }
+   if( cudss->b != NULL )
+   {
+      cudssMatrixDestroy(cudss->b);
+      cudss->b = NULL;
+   }
+   cudaFree(cudss->d_x);
+   cudss->d_x = NULL;
+   cudaFree(cudss->d_b);
+   cudss->d_b = NULL;
+   cudss->nrhs = 0;
+   cudss->rhs_capacity = 0;
+}
+
+/** Free the matrix and the analysis and factorization data. */
+static void FreeMatrixData(
+   CuDSSData* cudss
+)
+{
+   if( cudss->A != NULL )
+   {
+      cudssMatrixDestroy(cudss->A);
+      cudss->A = NULL;
+   }
+   if( cudss->data != NULL )
+   {
+      cudssDataDestroy(cudss->handle, cudss->data);
+      cudss->data = NULL;
+   }
+   cudaFree(cudss->d_ia);
+   cudss->d_ia = NULL;
+   cudaFree(cudss->d_ja);
+   cudss->d_ja = NULL;
+   cudaFree(cudss->d_a);
+   cudss->d_a = NULL;
+}
+
+/** Make sure that the dense matrices x and b have nrhs columns. */
+static bool PrepareRhsData(
+   const Journalist& jnlst,
+   CuDSSData*        cudss,
+   Index             dim,
+   Index             nrhs
+)
+{
+   if( cudss->nrhs == nrhs )
+   {
+      return true;
+   }
+   size_t elemsize = cudss->single ? sizeof(float) : sizeof(double);
+   cudaDataType_t valuetype = cudss->single ? CUDA_R_32F : CUDA_R_64F;
+   if( nrhs > cudss->rhs_capacity )
+   {
+      FreeRhsData(cudss);
+      if( !CudaCallOk(jnlst, cudaMalloc(&cudss->d_x, (size_t) dim * nrhs * elemsize), "allocation of solution")
+          || !CudaCallOk(jnlst, cudaMalloc(&cudss->d_b, (size_t) dim * nrhs * elemsize), "allocation of right hand sides") )
+      {
+         return false;
+      }
+      cudss->rhs_capacity = nrhs;
+   }
+   else
+   {
+      if( cudss->x != NULL )
+      {
+         cudssMatrixDestroy(cudss->x);
+         cudss->x = NULL;
+      }
+      if( cudss->b != NULL )
+      {
+         cudssMatrixDestroy(cudss->b);
+         cudss->b = NULL;
+      }
+   }
+   if( !CuDSSCallOk(jnlst, cudssMatrixCreateDn(&cudss->x, dim, nrhs, dim, cudss->d_x, valuetype, CUDSS_LAYOUT_COL_MAJOR),
+                    "cudssMatrixCreateDn")
+       || !CuDSSCallOk(jnlst, cudssMatrixCreateDn(&cudss->b, dim, nrhs, dim, cudss->d_b, valuetype, CUDSS_LAYOUT_COL_MAJOR),
+                       "cudssMatrixCreateDn") )
+   {
+      return false;
+   }
+   cudss->nrhs = nrhs;
+   return true;
+}
+
+CuDSSSolverInterface::CuDSSSolverInterface()
+   : dim_(0),
+     nonzeros_(0),
+     a_(NULL),
+     negevals_(-1),
+     initialized_(false),
+     pivtol_changed_(false),
+     refactorize_(false),
+     have_symbolic_factorization_(false),
+     pivtol_(1e-6),
+     pivtolmax_(0.1),
+     pivot_epsilon_(0.),
+     hybrid_memory_(false),
+     single_precision_(false)
+{
+   DBG_START_METH("CuDSSSolverInterface::CuDSSSolverInterface()", dbg_verbosity);
+
+   CuDSSData* cudss = new CuDSSData;
+   cudss->handle = NULL;
+   cudss->config = NULL;
+   cudss->data = NULL;
+   cudss->A = NULL;
+   cudss->x = NULL;
+   cudss->b = NULL;
+   cudss->nrhs = 0;
+   cudss->rhs_capacity = 0;
+   cudss->single = false;
+   cudss->d_ia = NULL;
+   cudss->d_ja = NULL;
+   cudss->d_a = NULL;
+   cudss->d_x = NULL;
+   cudss->d_b = NULL;
+   cudss->h_single = NULL;
+   cudss->h_single_size = 0;
+   cudss_ptr_ = (void*) cudss;
+}
+
+CuDSSSolverInterface::~CuDSSSolverInterface()
+{
+   DBG_START_METH("CuDSSSolverInterface::~CuDSSSolverInterface()", dbg_verbosity);
+
+   FreeCuDSSData();
+   delete[] ((CuDSSData*) cudss_ptr_)->h_single;
+   delete (CuDSSData*) cudss_ptr_;
+   delete[] a_;
+}
+
+void CuDSSSolverInterface::FreeCuDSSData()
+{
+   CuDSSData* cudss = (CuDSSData*) cudss_ptr_;
+
+   FreeRhsData(cudss);
+   FreeMatrixData(cudss);
+   if( cudss->config != NULL )
+   {
+      cudssConfigDestroy(cudss->config);
+      cudss->config = NULL;
+   }
+   if( cudss->handle != NULL )
+   {
+      cudssDestroy(cudss->handle);
+      cudss->handle = NULL;
+   }
+}
+
+void CuDSSSolverInterface::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddBoundedNumberOption(
+      "cudss_pivtol",
+      "Pivot tolerance for the linear solver cuDSS.",
+      0.0, false,
+      1.0, false,
+      1e-6,
+      "A smaller number pivots for sparsity, a larger number pivots for stability. "
+      "This is the pivoting threshold (CUDSS_CONFIG_PIVOT_THRESHOLD) of cuDSS. "
+      "This option is only available if Ipopt has been compiled with cuDSS.");
+   roptions->AddBoundedNumberOption(
+      "cudss_pivtolmax",
+      "Maximum pivot tolerance for the linear solver cuDSS.",
+      0.0, false,
+      1.0, false,
+      0.1,
+      "Ipopt may increase pivtol as high as pivtolmax to get a more accurate solution to the linear system. "
+      "This option is only available if Ipopt has been compiled with cuDSS.");
+   roptions->AddLowerBoundedNumberOption(
+      "cudss_pivot_epsilon",
+      "Value by which cuDSS replaces too small pivots.",
+      0.0, false,
+      0.0,
+      "This is CUDSS_CONFIG_PIVOT_EPSILON in cuDSS. "
+      "If 0, the default of cuDSS is used. "
+      "This option is only available if Ipopt has been compiled with cuDSS.");
+   roptions->AddStringOption2(
+      "cudss_hybrid_memory",
+      "Whether cuDSS may keep the factors in host memory.",
+      "no",
+      "no", "keep the factors in device memory",
+      "yes", "keep the factors in host memory",
+      "In the hybrid memory mode of cuDSS (CUDSS_CONFIG_HYBRID_MODE), the factors are kept in host memory "
+      "and moved to the GPU when needed, so that matrices whose factors do not fit into the memory of the GPU "
+      "can be factorized. "
+      "This option is only available if Ipopt has been compiled with cuDSS.");
+   roptions->AddStringOption2(
+      "cudss_precision",
+      "Precision of the factorization by cuDSS.",
+      "double",
+      "double", "factorize and solve in double precision",
+      "single", "factorize and solve in single precision",
+      "With single precision, the matrix is factorized in single precision, which halves the memory for the factors, "
+      "and the iterative refinement of the primal-dual system solver recovers the double precision accuracy "
+      "of the solution. "
+      "If the iterative refinement fails, cuDSS switches to double precision for the remainder of the optimization. "
+      "This option is only available if Ipopt has been compiled with cuDSS.");
+}
+
+bool CuDSSSolverInterface::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   options.GetNumericValue("cudss_pivtol", pivtol_, prefix);
+   if( options.GetNumericValue("cudss_pivtolmax", pivtolmax_, prefix) )
+   {
+      ASSERT_EXCEPTION(pivtolmax_ >= pivtol_, OPTION_INVALID, "Option \"cudss_pivtolmax\": This value must be between "
+                       "cudss_pivtol and 1.");
+   }
+   else
+   {
+      pivtolmax_ = Max(pivtolmax_, pivtol_);
+   }
+   options.GetNumericValue("cudss_pivot_epsilon", pivot_epsilon_, prefix);
+   bool hybrid_memory = hybrid_memory_;
+   options.GetBoolValue("cudss_hybrid_memory", hybrid_memory_, prefix);
+   std::string precision;
+   options.GetStringValue("cudss_precision", precision, prefix);
+   single_precision_ = (precision == "single");
+   // The following option is registered by TSymLinearSolver
+   bool reuse_symbolic_factorization;
+   options.GetBoolValue("reuse_symbolic_factorization", reuse_symbolic_factorization, prefix);
+
+   // Reset all private data
+   initialized_ = false;
+   pivtol_changed_ = false;
+   refactorize_ = false;
+
+   CuDSSData* cudss = (CuDSSData*) cudss_ptr_;
+   // keep the analysis if it might be reused; the memory mode and the
+   // precision have to be chosen before the analysis
+   if( !reuse_symbolic_factorization || hybrid_memory != hybrid_memory_ || single_precision_ != cudss->single )
+   {
+      have_symbolic_factorization_ = false;
+      FreeRhsData(cudss);
+      FreeMatrixData(cudss);
+   }
+   if( cudss->handle == NULL )
+   {
+      if( !CuDSSCallOk(Jnlst(), cudssCreate(&cudss->handle), "cudssCreate") )
+      {
+         return false;
+      }
+   }
+   if( cudss->config == NULL )
+   {
+      if( !CuDSSCallOk(Jnlst(), cudssConfigCreate(&cudss->config), "cudssConfigCreate") )
+      {
+         return false;
+      }
+   }
+
+   int hybrid_mode = hybrid_memory_ ? 1 : 0;
+   if( !CuDSSCallOk(Jnlst(), cudssConfigSet(cudss->config, CUDSS_CONFIG_HYBRID_MODE, &hybrid_mode, sizeof(hybrid_mode)),
+                    "setting CUDSS_CONFIG_HYBRID_MODE") )
+   {
+      return false;
+   }
+   if( pivot_epsilon_ > 0. )
+   {
+      double pivot_epsilon = pivot_epsilon_;
+      if( !CuDSSCallOk(Jnlst(),
+                       cudssConfigSet(cudss->config, CUDSS_CONFIG_PIVOT_EPSILON, &pivot_epsilon, sizeof(pivot_epsilon)),
+                       "setting CUDSS_CONFIG_PIVOT_EPSILON") )
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+ESymSolverStatus CuDSSSolverInterface::MultiSolve(
+   bool         new_matrix,
+   const Index* ia,
+   const Index* ja,
+   Index        nrhs,
+   double*      rhs_vals,
+   bool         check_NegEVals,
+   Index        numberOfNegEVals
+)
+{
+   DBG_START_METH("CuDSSSolverInterface::MultiSolve", dbg_verbosity);
+   DBG_ASSERT(!check_NegEVals || ProvidesInertia());
+   DBG_ASSERT(initialized_);
+
+   if( pivtol_changed_ )
+   {
+      DBG_PRINT((1, "Pivot tolerance has changed.\n"));
+      pivtol_changed_ = false;
+      // If the pivot tolerance has been changed but the matrix is not
+      // new, we have to request the values for the matrix again to do
+      // the factorization again.
+      if( !new_matrix )
+      {
+         DBG_PRINT((1, "Ask caller to call again.\n"));
+         refactorize_ = true;
+         return SYMSOLVER_CALL_AGAIN;
+      }
+   }
+
+   // check if a factorization has to be done
+   DBG_PRINT((1, "new_matrix = %d\n", new_matrix));
+   if( new_matrix || refactorize_ )
+   {
+      ESymSolverStatus retval;
+      // Create the matrix on the device again if the precision has changed
+      if( single_precision_ != ((CuDSSData*) cudss_ptr_)->single )
+      {
+         retval = CreateDeviceMatrix(ia, ja);
+         if( retval != SYMSOLVER_SUCCESS )
+         {
+            return retval;
+         }
+      }
+      // Do the analysis if it hasn't been done yet
+      if( !have_symbolic_factorization_ )
+      {
+         retval = SymbolicFactorization();
+         if( retval != SYMSOLVER_SUCCESS )
+         {
+            return retval;
+         }
+         have_symbolic_factorization_ = true;
+      }
+      // perform the factorization
+      retval = Factorization(check_NegEVals, numberOfNegEVals);
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         DBG_PRINT((1, "FACTORIZATION FAILED!\n"));
+         return retval;  // Matrix singular or error occurred
+      }
+      refactorize_ = false;
+   }
+   // do the solve
+   return Solve(nrhs, rhs_vals);
+}
+
+double* CuDSSSolverInterface::GetValuesArrayPtr()
+{
+   DBG_START_METH("CuDSSSolverInterface::GetValuesArrayPtr", dbg_verbosity)
+   DBG_ASSERT(initialized_);
+   return a_;
+}
+
+ESymSolverStatus CuDSSSolverInterface::InitializeStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* ia,
+   const Index* ja
+)
+{
+   DBG_START_METH("CuDSSSolverInterface::InitializeStructure", dbg_verbosity);
+
+   dim_ = dim;
+   nonzeros_ = nonzeros;
+   delete[] a_;
+   a_ = new double[nonzeros];
+
+   ESymSolverStatus retval = CreateDeviceMatrix(ia, ja);
+   if( retval != SYMSOLVER_SUCCESS )
+   {
+      return retval;
+   }
+
+   initialized_ = true;
+   return SYMSOLVER_SUCCESS;
+}
+
+ESymSolverStatus CuDSSSolverInterface::CreateDeviceMatrix(
+   const Index* ia,
+   const Index* ja
+)
+{
+   DBG_START_METH("CuDSSSolverInterface::CreateDeviceMatrix", dbg_verbosity);
+   CuDSSData* cudss = (CuDSSData*) cudss_ptr_;
+
+   FreeRhsData(cudss);
+   FreeMatrixData(cudss);
+   have_symbolic_factorization_ = false;
+   cudss->single = single_precision_;
+   size_t elemsize = cudss->single ? sizeof(float) : sizeof(double);
+
+   // copy the structure to the device
+   if( !CudaCallOk(Jnlst(), cudaMalloc((void**) &cudss->d_ia, (size_t) (dim_ + 1) * sizeof(Index)), "allocation of matrix")
+       || !CudaCallOk(Jnlst(), cudaMalloc((void**) &cudss->d_ja, (size_t) nonzeros_ * sizeof(Index)), "allocation of matrix")
+       || !CudaCallOk(Jnlst(), cudaMalloc(&cudss->d_a, (size_t) nonzeros_ * elemsize), "allocation of matrix") )
+   {
+      return SYMSOLVER_FATAL_ERROR;
+   }
+   if( !CudaCallOk(Jnlst(), cudaMemcpy(cudss->d_ia, ia, (size_t) (dim_ + 1) * sizeof(Index), cudaMemcpyHostToDevice),
+                   "copy of matrix structure")
+       || !CudaCallOk(Jnlst(), cudaMemcpy(cudss->d_ja, ja, (size_t) nonzeros_ * sizeof(Index), cudaMemcpyHostToDevice),
+                      "copy of matrix structure") )
+   {
+      return SYMSOLVER_FATAL_ERROR;
+   }
+
+   // the matrix is given by its upper triangle
+   if( !CuDSSCallOk(Jnlst(),
+                    cudssMatrixCreateCsr(&cudss->A, dim_, dim_, nonzeros_, cudss->d_ia, NULL, cudss->d_ja, cudss->d_a, IPOPT_CUDSS_INDEX_TYPE,
+                                         cudss->single ? CUDA_R_32F : CUDA_R_64F, CUDSS_MTYPE_SYMMETRIC, CUDSS_MVIEW_UPPER, CUDSS_BASE_ZERO),
+                    "cudssMatrixCreateCsr")
+       || !CuDSSCallOk(Jnlst(), cudssDataCreate(cudss->handle, &cudss->data), "cudssDataCreate") )
+   {
+      return SYMSOLVER_FATAL_ERROR;
+   }
+
+   if( !PrepareRhsData(Jnlst(), cudss, dim_, 1) )
+   {
+      return SYMSOLVER_FATAL_ERROR;
+   }
+
+   return SYMSOLVER_SUCCESS;
+}
+
+bool CuDSSSolverInterface::ReuseStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* /*ia*/,
+   const Index* /*ja*/
+)
+{
+   DBG_START_METH("CuDSSSolverInterface::ReuseStructure", dbg_verbosity);
+
+   if( !have_symbolic_factorization_ || dim_ != dim || nonzeros_ != nonzeros )
+   {
+      return false;
+   }
+
+   initialized_ = true;
+   return true;
+}
+
+ESymSolverStatus CuDSSSolverInterface::SymbolicFactorization()
+{
+   DBG_START_METH("CuDSSSolverInterface::SymbolicFactorization", dbg_verbosity);
+   CuDSSData* cudss = (CuDSSData*) cudss_ptr_;
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemSymbolicFactorization().Start();
+   }
+
+   // the reordering may use the values of the matrix
+   bool ok = CopyToDevice(Jnlst(), cudss, cudss->d_a, a_, (size_t) nonzeros_, "copy of matrix values");
+   if( ok )
+   {
+      Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
+                     "Calling cuDSS analysis at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
+      ok = CuDSSCallOk(Jnlst(),
+                       cudssExecute(cudss->handle, CUDSS_PHASE_ANALYSIS, cudss->config, cudss->data, cudss->A, cudss->x, cudss->b),
+                       "analysis");
+      Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
+                     "Done with cuDSS analysis at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
+   }
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemSymbolicFactorization().End();
+   }
+
+   return ok ? SYMSOLVER_SUCCESS : SYMSOLVER_FATAL_ERROR;
+}
+
+ESymSolverStatus CuDSSSolverInterface::Factorization(
+   bool  check_NegEVals,
+   Index numberOfNegEVals
+)
+{
+   DBG_START_METH("CuDSSSolverInterface::Factorization", dbg_verbosity);
+   CuDSSData* cudss = (CuDSSData*) cudss_ptr_;
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemFactorization().Start();
+   }
+
+   double pivtol = pivtol_;
+   bool ok = CuDSSCallOk(Jnlst(), cudssConfigSet(cudss->config, CUDSS_CONFIG_PIVOT_THRESHOLD, &pivtol, sizeof(pivtol)),
+                         "setting CUDSS_CONFIG_PIVOT_THRESHOLD")
+             && CopyToDevice(Jnlst(), cudss, cudss->d_a, a_, (size_t) nonzeros_, "copy of matrix values");
+   if( ok )
+   {
+      Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
+                     "Calling cuDSS factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
+      ok = CuDSSCallOk(Jnlst(),
+                       cudssExecute(cudss->handle, CUDSS_PHASE_FACTORIZATION, cudss->config, cudss->data, cudss->A, cudss->x,
+                                    cudss->b), "factorization");
+      Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
+                     "Done with cuDSS factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
+   }
+
+   int info = 0;
+   int inertia[2] = { 0, 0 };
+   size_t size_written;
+   if( ok )
+   {
+      ok = CuDSSCallOk(Jnlst(), cudssDataGet(cudss->handle, cudss->data, CUDSS_DATA_INFO, &info, sizeof(info), &size_written),
+                       "query of CUDSS_DATA_INFO")
+           && CuDSSCallOk(Jnlst(),
+                          cudssDataGet(cudss->handle, cudss->data, CUDSS_DATA_INERTIA, inertia, sizeof(inertia), &size_written),
+                          "query of CUDSS_DATA_INERTIA");
+   }
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemFactorization().End();
+   }
+
+   if( !ok )
+   {
+      return SYMSOLVER_FATAL_ERROR;
+   }
+
+   if( info > 0 || inertia[0] + inertia[1] < dim_ )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "cuDSS returned info = %d and inertia (%d, %d): matrix is singular.\n", info, inertia[0], inertia[1]);
+      return SYMSOLVER_SINGULAR;
+   }
+
+   negevals_ = inertia[1];
+
+   if( check_NegEVals && (numberOfNegEVals != negevals_) )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "In CuDSSSolverInterface::Factorization: negevals_ = %" IPOPT_INDEX_FORMAT ", but numberOfNegEVals = %" IPOPT_INDEX_FORMAT "\n", negevals_,
+                     numberOfNegEVals);
+      return SYMSOLVER_WRONG_INERTIA;
+   }
+
+   return SYMSOLVER_SUCCESS;
+}
+
+ESymSolverStatus CuDSSSolverInterface::Solve(
+   Index   nrhs,
+   double* rhs_vals
+)
+{
+   DBG_START_METH("CuDSSSolverInterface::Solve", dbg_verbosity);
+   CuDSSData* cudss = (CuDSSData*) cudss_ptr_;
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemBackSolve().Start();
+   }
+
+   // all right hand sides are solved for in one solve phase
+   size_t n = (size_t) dim_ * nrhs;
+   bool ok = PrepareRhsData(Jnlst(), cudss, dim_, nrhs)
+             && CopyToDevice(Jnlst(), cudss, cudss->d_b, rhs_vals, n, "copy of right hand sides")
+             && CuDSSCallOk(Jnlst(),
+                            cudssExecute(cudss->handle, CUDSS_PHASE_SOLVE, cudss->config, cudss->data, cudss->A, cudss->x, cudss->b),
+                            "solve")
+             && CopyFromDevice(Jnlst(), cudss, rhs_vals, cudss->d_x, n, "copy of solution");
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemBackSolve().End();
+   }
+
+   return ok ? SYMSOLVER_SUCCESS : SYMSOLVER_FATAL_ERROR;
+}
+
+Index CuDSSSolverInterface::NumberOfNegEVals() const
+{
+   DBG_START_METH("CuDSSSolverInterface::NumberOfNegEVals", dbg_verbosity);
+   DBG_ASSERT(negevals_ >= 0);
+   return negevals_;
+}
+
+bool CuDSSSolverInterface::IncreaseQuality()
+{
+   DBG_START_METH("CuDSSSolverInterface::IncreaseQuality", dbg_verbosity);
+   if( single_precision_ )
+   {
+      // the single precision factorization is not accurate enough
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Switching cuDSS from single to double precision.\n");
+      single_precision_ = false;
+      pivtol_changed_ = true;
+      return true;
+   }
+   if( pivtol_ == pivtolmax_ )
+   {
+      return false;
+   }
+   pivtol_changed_ = true;
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Increasing pivot tolerance for cuDSS from %7.2e ", pivtol_);
+   pivtol_ = Min(pivtolmax_, pow(pivtol_, 0.75));
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "to %7.2e.\n", pivtol_);
+   return true;
+}
+
+} // namespace Ipopt
@@ -0,0 +1,217 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPCUDSSSOLVERINTERFACE_HPP__
+#define __IPCUDSSSOLVERINTERFACE_HPP__
+
+#include "IpSparseSymLinearSolverInterface.hpp"
+
+namespace Ipopt
+{
+
+/** Interface to the sparse direct solver cuDSS of NVIDIA, derived from
+ *  SparseSymLinearSolverInterface.
+ *
+ *  The analysis, the LDL^T factorization with pivoting, and the solves
+ *  are done on the GPU.  The structure of the matrix is copied to the
+ *  device once, the values for each factorization, and the right hand
+ *  sides for each solve.  All right hand sides of a call of MultiSolve
+ *  are solved for in one solve phase.
+ *
+ *  Optionally, the factorization and solves are done in single
+ *  precision, relying on the iterative refinement of the caller to
+ *  recover the accuracy of the solution.
+ */
+class CuDSSSolverInterface: public SparseSymLinearSolverInterface
+{
+public:
+   /** @name Constructor/Destructor */
+   ///@{
+   /** Constructor */
+   CuDSSSolverInterface();
+
+   /** Destructor */
+   virtual ~CuDSSSolverInterface();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** @name Methods for requesting solution of the linear system. */
+   ///@{
+   virtual ESymSolverStatus InitializeStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
+   virtual bool ReuseStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
+   virtual double* GetValuesArrayPtr();
+
+   virtual bool PreservesValues() const
+   {
+      return true;
+   }
+
+   virtual ESymSolverStatus MultiSolve(
+      bool         new_matrix,
+      const Index* ia,
+      const Index* ja,
+      Index        nrhs,
+      double*      rhs_vals,
+      bool         check_NegEVals,
+      Index        numberOfNegEVals
+   );
+
+   virtual Index NumberOfNegEVals() const;
+   ///@}
+
+   //* @name Options of Linear solver */
+   ///@{
+   virtual bool IncreaseQuality();
+
+   virtual bool ProvidesInertia() const
+   {
+      return true;
+   }
+
+   EMatrixFormat MatrixFormat() const
+   {
+      return CSR_Format_0_Offset;
+   }
+   ///@}
+
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called. */
+   ///@{
+   /** Copy Constructor */
+   CuDSSSolverInterface(
+      const CuDSSSolverInterface&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const CuDSSSolverInterface&
+   );
+   ///@}
+
+   /** @name Information about the matrix */
+   ///@{
+   /** Number of rows and columns of the matrix */
+   Index dim_;
+
+   /** Number of nonzeros of the matrix */
+   Index nonzeros_;
+
+   /** Array for storing the values of the matrix on the host */
+   double* a_;
+   ///@}
+
+   /** @name Data of cuDSS */
+   ///@{
+   /** Handles of cuDSS and device memory (a CuDSSData) */
+   void* cudss_ptr_;
+   ///@}
+
+   /** @name Information about most recent factorization/solve */
+   ///@{
+   /** Number of negative eigenvalues */
+   Index negevals_;
+   ///@}
+
+   /** @name Initialization flags */
+   ///@{
+   /** Flag indicating if internal data is initialized.
+    *  For initialization, this object needs to have seen a matrix.
+    */
+   bool initialized_;
+   /** Flag indicating if the matrix has to be refactorized because
+    *  the pivot tolerance or the precision has been changed.
+    */
+   bool pivtol_changed_;
+   /** Flag that is true if we just requested the values of the
+    *  matrix again (SYMSOLVER_CALL_AGAIN) and have to factorize
+    *  again.
+    */
+   bool refactorize_;
+   /** Flag indicating if the analysis phase has been done for the
+    *  current structure.
+    */
+   bool have_symbolic_factorization_;
+   ///@}
+
+   /** @name Solver specific options */
+   ///@{
+   /** Pivot tolerance */
+   Number pivtol_;
+
+   /** Maximal pivot tolerance */
+   Number pivtolmax_;
+
+   /** Value that replaces too small pivots, 0 for the cuDSS default */
+   Number pivot_epsilon_;
+
+   /** Whether the factors may be kept in host memory */
+   bool hybrid_memory_;
+
+   /** Whether the factorization is to be done in single precision */
+   bool single_precision_;
+   ///@}
+
+   /** @name Internal functions */
+   ///@{
+   /** Free all cuDSS objects and device memory. */
+   void FreeCuDSSData();
+
+   /** Copy the structure of the matrix to the device and create the
+    *  cuDSS matrix with the precision given by single_precision_.
+    */
+   ESymSolverStatus CreateDeviceMatrix(
+      const Index* ia,
+      const Index* ja
+   );
+
+   /** Call cuDSS to perform the analysis phase. */
+   ESymSolverStatus SymbolicFactorization();
+
+   /** Call cuDSS to factorize the matrix.
+    *
+    *  It is assumed that the first nonzeros_ element of a_ contain the
+    *  values of the matrix to be factorized.
+    */
+   ESymSolverStatus Factorization(
+      bool  check_NegEVals,
+      Index numberOfNegEVals
+   );
+
+   /** Call cuDSS to do the solve for nrhs right hand sides. */
+   ESymSolverStatus Solve(
+      Index   nrhs,
+      double* rhs_vals
+   );
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
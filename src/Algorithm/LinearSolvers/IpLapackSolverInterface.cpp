@@ -0,0 +1,432 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpLapackSolverInterface.hpp"
+#include "IpLapack.hpp"
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+LapackSolverInterface::LapackSolverInterface(
+   SmartPtr<SparseSymLinearSolverInterface> sparse_solver
+)
+   : sparse_solver_(sparse_solver),
+     dense_max_dim_(0),
+     use_dense_(true),
+     dim_(0),
+     have_factorization_(false),
+     negevals_(-1)
+{
+   DBG_START_METH("LapackSolverInterface::LapackSolverInterface()", dbg_verbosity);
+}
+
+LapackSolverInterface::~LapackSolverInterface()
+{
+   DBG_START_METH("LapackSolverInterface::~LapackSolverInterface()", dbg_verbosity);
+}
+
+void LapackSolverInterface::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddLowerBoundedIntegerOption(
+      "dense_linear_solver_max_dim",
+      "Largest dimension of the augmented system that is factorized as a dense matrix.",
+      0,
+      0,
+      "If positive, linear systems with at most this many rows are factorized by the dense symmetric indefinite "
+      "factorization of LAPACK (DSYTRF) instead of the linear solver chosen by \"linear_solver\". "
+      "For small problems, this avoids the overhead of the symbolic analysis and the setup of a sparse linear solver. "
+      "The value 0 disables the dense factorization, unless linear_solver=lapack is chosen, "
+      "which factorizes all linear systems as dense matrices.");
+}
+
+bool LapackSolverInterface::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   options.GetIntegerValue("dense_linear_solver_max_dim", dense_max_dim_, prefix);
+
+   have_factorization_ = false;
+
+   if( IsNull(sparse_solver_) )
+   {
+      return true;
+   }
+   if( HaveIpData() )
+   {
+      return sparse_solver_->Initialize(Jnlst(), IpNLP(), IpData(), IpCq(), options, prefix);
+   }
+   return sparse_solver_->ReducedInitialize(Jnlst(), options, prefix);
+}
+
+SparseSymLinearSolverInterface::EMatrixFormat LapackSolverInterface::MatrixFormat() const
+{
+   if( IsValid(sparse_solver_) )
+   {
+      // the dense matrix can be assembled from any format
+      return sparse_solver_->MatrixFormat();
+   }
+   return Triplet_Format;
+}
+
+ESymSolverStatus LapackSolverInterface::InitializeStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* ia,
+   const Index* ja
+)
+{
+   DBG_START_METH("LapackSolverInterface::InitializeStructure", dbg_verbosity);
+
+   have_factorization_ = false;
+   dim_ = dim;
+   use_dense_ = IsNull(sparse_solver_) || dim <= dense_max_dim_;
+   if( !use_dense_ )
+   {
+      dense_pos_.clear();
+      values_.clear();
+      factor_.clear();
+      ipiv_.clear();
+      return sparse_solver_->InitializeStructure(dim, nonzeros, ia, ja);
+   }
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Using the dense factorization of LAPACK for a matrix of dimension %" IPOPT_INDEX_FORMAT ".\n", dim);
+
+   // Row and column (starting at 0) of each nonzero
+   dense_pos_.resize(nonzeros);
+   const EMatrixFormat format = MatrixFormat();
+   bool full_format = false;
+   if( format == Triplet_Format )
+   {
+      for( Index k = 0; k < nonzeros; k++ )
+      {
+         const Index irow = ia[k] - 1;
+         const Index jcol = ja[k] - 1;
+         dense_pos_[k] = Max(irow, jcol) + Min(irow, jcol) * dim;
+      }
+   }
+   else
+   {
+      Index offset = 0;
+      if( format == CSR_Format_1_Offset || format == CSR_Full_Format_1_Offset )
+      {
+         offset = 1;
+      }
+      full_format = format == CSR_Full_Format_0_Offset || format == CSR_Full_Format_1_Offset;
+      for( Index irow = 0; irow < dim; irow++ )
+      {
+         for( Index k = ia[irow] - offset; k < ia[irow + 1] - offset; k++ )
+         {
+            const Index jcol = ja[k] - offset;
+            if( full_format && jcol > irow )
+            {
+               // the strict upper triangle is given by the transposed elements
+               dense_pos_[k] = -1;
+            }
+            else
+            {
+               dense_pos_[k] = Max(irow, jcol) + Min(irow, jcol) * dim;
+            }
+         }
+      }
+   }
+
+   values_.resize(nonzeros);
+   factor_.resize((size_t) dim * dim);
+   ipiv_.resize(dim);
+
+   return SYMSOLVER_SUCCESS;
+}
+
+bool LapackSolverInterface::ReuseStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* ia,
+   const Index* ja
+)
+{
+   DBG_START_METH("LapackSolverInterface::ReuseStructure", dbg_verbosity);
+
+   // there is no symbolic factorization to keep for the dense matrix
+   if( use_dense_ || IsNull(sparse_solver_) || dim <= dense_max_dim_ )
+   {
+      return false;
+   }
+   have_factorization_ = false;
+   return sparse_solver_->ReuseStructure(dim, nonzeros, ia, ja);
+}
+
+double* LapackSolverInterface::GetValuesArrayPtr()
+{
+   if( !use_dense_ )
+   {
+      return sparse_solver_->GetValuesArrayPtr();
+   }
+   return values_.empty() ? NULL : &values_[0];
+}
+
+bool LapackSolverInterface::PreservesValues() const
+{
+   if( !use_dense_ )
+   {
+      return sparse_solver_->PreservesValues();
+   }
+   // the values are copied into the dense matrix
+   return true;
+}
+
+ESymSolverStatus LapackSolverInterface::Factorization(
+   bool  check_NegEVals,
+   Index numberOfNegEVals
+)
+{
+   DBG_START_METH("LapackSolverInterface::Factorization", dbg_verbosity);
+
+   have_factorization_ = false;
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemFactorization().Start();
+   }
+
+   // assemble the lower triangle of the dense matrix; the upper
+   // triangle is not referenced by LAPACK
+   const Index nonzeros = (Index) values_.size();
+   for( Index j = 0; j < dim_; j++ )
+   {
+      for( Index i = j; i < dim_; i++ )
+      {
+         factor_[i + j * dim_] = 0.;
+      }
+   }
+   for( Index k = 0; k < nonzeros; k++ )
+   {
+      if( dense_pos_[k] >= 0 )
+      {
+         factor_[dense_pos_[k]] += values_[k];
+      }
+   }
+
+   Index info = 0;
+   if( dim_ > 0 )
+   {
+      IpLapackDsytrf(dim_, &factor_[0], &ipiv_[0], dim_, info);
+   }
+   if( info < 0 )
+   {
+      Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
+                     "Error in DSYTRF: argument %" IPOPT_INDEX_FORMAT " has an illegal value.\n", -info);
+      if( HaveIpData() )
+      {
+         IpData().TimingStats().LinearSystemFactorization().End();
+      }
+      return SYMSOLVER_FATAL_ERROR;
+   }
+   if( info > 0 )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "DSYTRF: pivot %" IPOPT_INDEX_FORMAT " is exactly zero, the matrix is singular.\n", info);
+      if( HaveIpData() )
+      {
+         IpData().TimingStats().LinearSystemFactorization().End();
+      }
+      return SYMSOLVER_SINGULAR;
+   }
+
+   // Inertia from the blocks of D: a 2x2 block with negative
+   // determinant has one negative eigenvalue
+   negevals_ = 0;
+   for( Index k = 0; k < dim_; k++ )
+   {
+      const Number d = factor_[k + k * dim_];
+      if( ipiv_[k] > 0 )
+      {
+         if( d < 0. )
+         {
+            negevals_++;
+         }
+      }
+      else
+      {
+         DBG_ASSERT(k + 1 < dim_ && ipiv_[k + 1] == ipiv_[k]);
+         const Number offdiag = factor_[k + 1 + k * dim_];
+         const Number det = d * factor_[k + 1 + (k + 1) * dim_] - offdiag * offdiag;
+         if( det < 0. )
+         {
+            negevals_++;
+         }
+         else if( d < 0. )
+         {
+            negevals_ += 2;
+         }
+         k++;
+      }
+   }
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemFactorization().End();
+   }
+   have_factorization_ = true;
+
+   DBG_PRINT((1, "Number of negative eigenvalues = %d\n", negevals_));
+   if( check_NegEVals && negevals_ != numberOfNegEVals )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Wrong inertia: required are %" IPOPT_INDEX_FORMAT ", but we got %" IPOPT_INDEX_FORMAT ".\n", numberOfNegEVals, negevals_);
+      return SYMSOLVER_WRONG_INERTIA;
+   }
+   return SYMSOLVER_SUCCESS;
+}
+
+ESymSolverStatus LapackSolverInterface::MultiSolve(
+   bool         new_matrix,
+   const Index* ia,
+   const Index* ja,
+   Index        nrhs,
+   double*      rhs_vals,
+   bool         check_NegEVals,
+   Index        numberOfNegEVals
+)
+{
+   DBG_START_METH("LapackSolverInterface::MultiSolve", dbg_verbosity);
+
+   if( !use_dense_ )
+   {
+      return sparse_solver_->MultiSolve(new_matrix, ia, ja, nrhs, rhs_vals, check_NegEVals, numberOfNegEVals);
+   }
+
+   if( new_matrix || !have_factorization_ )
+   {
+      ESymSolverStatus retval = Factorization(check_NegEVals, numberOfNegEVals);
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         return retval;
+      }
+   }
+
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemBackSolve().Start();
+   }
+   if( dim_ > 0 && nrhs > 0 )
+   {
+      IpLapackDsytrs(dim_, nrhs, &factor_[0], dim_, &ipiv_[0], rhs_vals, dim_);
+   }
+   if( HaveIpData() )
+   {
+      IpData().TimingStats().LinearSystemBackSolve().End();
+   }
+
+   return SYMSOLVER_SUCCESS;
+}
+
+Index LapackSolverInterface::NumberOfNegEVals() const
+{
+   if( !use_dense_ )
+   {
+      return sparse_solver_->NumberOfNegEVals();
+   }
+   DBG_ASSERT(negevals_ >= 0);
+   return negevals_;
+}
+
+bool LapackSolverInterface::IncreaseQuality()
+{
+   if( !use_dense_ )
+   {
+      return sparse_solver_->IncreaseQuality();
+   }
+   // the Bunch-Kaufman pivoting has no tolerance that could be increased
+   return false;
+}
+
+bool LapackSolverInterface::ProvidesInertia() const
+{
+   // this may be called before the structure is known
+   if( IsValid(sparse_solver_) )
+   {
+      return sparse_solver_->ProvidesInertia();
+   }
+   return true;
+}
+
+bool LapackSolverInterface::ProvidesBackwardError() const
+{
+   if( IsValid(sparse_solver_) )
+   {
+      return sparse_solver_->ProvidesBackwardError();
+   }
+   return false;
+}
+
+Number LapackSolverInterface::BackwardError() const
+{
+   if( !use_dense_ )
+   {
+      return sparse_solver_->BackwardError();
+   }
+   return -1.;
+}
+
+bool LapackSolverInterface::EstimateFactorization(
+   Number& factor_nonzeros,
+   Number& flops,
+   Number& memory
+)
+{
+   if( !use_dense_ )
+   {
+      return sparse_solver_->EstimateFactorization(factor_nonzeros, flops, memory);
+   }
+
+   // the factor of DSYTRF is the dense lower triangle
+   const Number n = (Number) dim_;
+   factor_nonzeros = 0.5 * n * (n + 1.);
+   flops = n * n * n / 3.;
+   memory = (n * n + values_.size()) * sizeof(Number) + (n + dense_pos_.size()) * sizeof(Index);
+   return true;
+}
+
+bool LapackSolverInterface::ProvidesDegeneracyDetection() const
+{
+   return IsValid(sparse_solver_) && sparse_solver_->ProvidesDegeneracyDetection();
+}
+
+ESymSolverStatus LapackSolverInterface::DetermineDependentRows(
+   const Index*      ia,
+   const Index*      ja,
+   std::list<Index>& c_deps
+)
+{
+   DBG_START_METH("LapackSolverInterface::DetermineDependentRows", dbg_verbosity);
+   DBG_ASSERT(ProvidesDegeneracyDetection());
+
+   if( use_dense_ )
+   {
+      // the dependencies are determined by the sparse solver, so the
+      // matrix is handed over to it
+      const Index nonzeros = (Index) values_.size();
+      ESymSolverStatus retval = sparse_solver_->InitializeStructure(dim_, nonzeros, ia, ja);
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         return retval;
+      }
+      double* pa = sparse_solver_->GetValuesArrayPtr();
+      for( Index k = 0; k < nonzeros; k++ )
+      {
+         pa[k] = values_[k];
+      }
+      use_dense_ = false;
+      have_factorization_ = false;
+   }
+   return sparse_solver_->DetermineDependentRows(ia, ja, c_deps);
+}
+
+} // namespace Ipopt
@@ -0,0 +1,183 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPLAPACKSOLVERINTERFACE_HPP__
+#define __IPLAPACKSOLVERINTERFACE_HPP__
+
+#include "IpSparseSymLinearSolverInterface.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+/** Interface to the dense symmetric indefinite factorization of
+ *  LAPACK (DSYTRF/DSYTRS), derived from SparseSymLinearSolverInterface.
+ *
+ *  The matrix is stored as a dense lower triangle and factorized by
+ *  the Bunch-Kaufman method \f$LDL^T\f$.  The inertia is obtained from
+ *  the 1x1 and 2x2 blocks of D.  For small matrices, this avoids the
+ *  overhead of the symbolic analysis and the setup of a sparse solver.
+ *
+ *  If a sparse solver is given to the constructor, then the dense
+ *  factorization is only used if the dimension of the matrix does
+ *  not exceed the value of the option dense_linear_solver_max_dim.
+ *  Otherwise, all calls are passed on to the sparse solver.  The
+ *  matrix is then accepted in the format of the sparse solver.
+ */
+class LapackSolverInterface: public SparseSymLinearSolverInterface
+{
+public:
+   /** @name Constructor/Destructor */
+   ///@{
+   /** Constructor.
+    *
+    *  If sparse_solver is not NULL, it is used for matrices that are
+    *  too large for the dense factorization.
+    */
+   LapackSolverInterface(
+      SmartPtr<SparseSymLinearSolverInterface> sparse_solver = NULL
+   );
+
+   /** Destructor */
+   virtual ~LapackSolverInterface();
+   ///@}
+
+   bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** @name Methods for requesting solution of the linear system. */
+   ///@{
+   virtual ESymSolverStatus InitializeStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
+   virtual bool ReuseStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
+   virtual double* GetValuesArrayPtr();
+
+   virtual bool PreservesValues() const;
+
+   virtual ESymSolverStatus MultiSolve(
+      bool         new_matrix,
+      const Index* ia,
+      const Index* ja,
+      Index        nrhs,
+      double*      rhs_vals,
+      bool         check_NegEVals,
+      Index        numberOfNegEVals
+   );
+
+   virtual Index NumberOfNegEVals() const;
+   ///@}
+
+   //* @name Options of Linear solver */
+   ///@{
+   virtual bool IncreaseQuality();
+
+   virtual bool ProvidesInertia() const;
+
+   virtual bool ProvidesBackwardError() const;
+
+   virtual Number BackwardError() const;
+
+   virtual bool EstimateFactorization(
+      Number& factor_nonzeros,
+      Number& flops,
+      Number& memory
+   );
+
+   EMatrixFormat MatrixFormat() const;
+   ///@}
+
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+
+   virtual bool ProvidesDegeneracyDetection() const;
+
+   virtual ESymSolverStatus DetermineDependentRows(
+      const Index*      ia,
+      const Index*      ja,
+      std::list<Index>& c_deps
+   );
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called. */
+   ///@{
+   /** Copy Constructor */
+   LapackSolverInterface(
+      const LapackSolverInterface&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const LapackSolverInterface&
+   );
+   ///@}
+
+   /** Sparse solver for large matrices, or NULL */
+   SmartPtr<SparseSymLinearSolverInterface> sparse_solver_;
+
+   /** @name Algorithmic parameters */
+   ///@{
+   /** Largest dimension for which the dense factorization is used
+    *  if a sparse solver is given */
+   Index dense_max_dim_;
+   ///@}
+
+   /** Flag indicating whether the current matrix is factorized
+    *  densely, as decided in InitializeStructure */
+   bool use_dense_;
+
+   /** @name Information about the matrix */
+   ///@{
+   /** Number of rows and columns of the matrix */
+   Index dim_;
+   /** Position of each nonzero in the dense lower triangle (column
+    *  major), or -1 if the nonzero is in the strict upper triangle of
+    *  a matrix given in full format */
+   std::vector<Index> dense_pos_;
+   /** Values of the nonzeros */
+   std::vector<Number> values_;
+   /** Dense factor computed by DSYTRF */
+   std::vector<Number> factor_;
+   /** Pivot information computed by DSYTRF */
+   std::vector<Index> ipiv_;
+   ///@}
+
+   /** @name Information about most recent factorization */
+   ///@{
+   /** Flag indicating whether factor_ holds a valid factorization */
+   bool have_factorization_;
+   /** Number of negative eigenvalues */
+   Index negevals_;
+   ///@}
+
+   /** Factorize the matrix given by values_ */
+   ESymSolverStatus Factorization(
+      bool  check_NegEVals,
+      Index numberOfNegEVals
+   );
+};
+
+} // namespace Ipopt
+
+#endif
@@ -11,6 +11,9 @@
 #include "IpLinearSolversRegOp.hpp"
 #include "IpRegOptions.hpp"
 #include "IpTSymLinearSolver.hpp"
+#include "IpAutoTuneSymLinearSolver.hpp"
+#include "IpRuizTSymScalingMethod.hpp"
+#include "IpLapackSolverInterface.hpp"
 
 #include "IpMa27TSolverInterface.hpp"
 #include "IpMa57TSolverInterface.hpp"
@@ -26,6 +29,9 @@
 # include "IpWsmpSolverInterface.hpp"
 # include "IpIterativeWsmpSolverInterface.hpp"
 #endif
+#ifdef IPOPT_HAS_CUDSS
+# include "IpCuDSSSolverInterface.hpp"
+#endif
 
 namespace Ipopt
 {
@@ -36,6 +42,12 @@ void RegisterOptions_LinearSolvers(
 {
    roptions->SetRegisteringCategory("Linear Solver");
    TSymLinearSolver::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Linear Solver");
+   AutoTuneSymLinearSolver::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Linear Solver");
+   RuizTSymScalingMethod::RegisterOptions(roptions);
+   roptions->SetRegisteringCategory("Linear Solver");
+   LapackSolverInterface::RegisterOptions(roptions);
 #if defined(COINHSL_HAS_MA27) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
    roptions->SetRegisteringCategory("MA27 Linear Solver");
    Ma27TSolverInterface::RegisterOptions(roptions);
@@ -44,15 +56,15 @@ void RegisterOptions_LinearSolvers(
    roptions->SetRegisteringCategory("MA57 Linear Solver");
    Ma57TSolverInterface::RegisterOptions(roptions);
 #endif
-#if defined(COINHSL_HAS_MA77) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
+#if (defined(COINHSL_HAS_MA77) || defined(IPOPT_HAS_LINEARSOLVERLOADER)) && !defined(IPOPT_INT64)
    roptions->SetRegisteringCategory("MA77 Linear Solver");
    Ma77SolverInterface::RegisterOptions(roptions);
 #endif
-#if defined(COINHSL_HAS_MA86) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
+#if (defined(COINHSL_HAS_MA86) || defined(IPOPT_HAS_LINEARSOLVERLOADER)) && !defined(IPOPT_INT64)
    roptions->SetRegisteringCategory("MA86 Linear Solver");
    Ma86SolverInterface::RegisterOptions(roptions);
 #endif
-#if defined(COINHSL_HAS_MA97) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
+#if (defined(COINHSL_HAS_MA97) || defined(IPOPT_HAS_LINEARSOLVERLOADER)) && !defined(IPOPT_INT64)
    roptions->SetRegisteringCategory("MA97 Linear Solver");
    Ma97SolverInterface::RegisterOptions(roptions);
 #endif
@@ -73,6 +85,11 @@ void RegisterOptions_LinearSolvers(
    IterativeWsmpSolverInterface::RegisterOptions(roptions);
 #endif
 
+#ifdef IPOPT_HAS_CUDSS
+   roptions->SetRegisteringCategory("cuDSS Linear Solver");
+   CuDSSSolverInterface::RegisterOptions(roptions);
+#endif
+
 #if defined(COINHSL_HAS_MA28) && defined(F77_FUNC)
    roptions->SetRegisteringCategory("MA28 Linear Solver");
    Ma28TDependencyDetector::RegisterOptions(roptions);
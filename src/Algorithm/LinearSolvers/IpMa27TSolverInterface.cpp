@@ -94,6 +94,8 @@ Ma27TSolverInterface::Ma27TSolverInterface()
      liw_(0),
      iw_(NULL),
      ikeep_(NULL),
+     nrladu_(0.),
+     ops_(0.),
      la_(0),
      a_(NULL),
      la_increase_(false),
@@ -196,6 +198,11 @@ bool Ma27TSolverInterface::InitializeImpl(
    options.GetBoolValue("ma27_ignore_singularity", ignore_singularity_, prefix);
    // The following option is registered by OrigIpoptNLP
    options.GetBoolValue("warm_start_same_structure", warm_start_same_structure_, prefix);
+   // The following options are registered by TSymLinearSolver
+   options.GetBoolValue("reuse_symbolic_factorization", reuse_symbolic_factorization_, prefix);
+   std::string ordering_cache_dir;
+   options.GetStringValue("ordering_cache_dir", ordering_cache_dir, prefix);
+   ordering_cache_ = new OrderingCache(ordering_cache_dir, "ma27");
 
    /* Set the default options for MA27 */
    IPOPT_HSL_FUNC(ma27id, MA27ID)(icntl_, cntl_);
@@ -215,8 +222,12 @@ bool Ma27TSolverInterface::InitializeImpl(
 
    if( !warm_start_same_structure_ )
    {
-      dim_ = 0;
-      nonzeros_ = 0;
+      // keep the symbolic factorization if it might be reused
+      if( !reuse_symbolic_factorization_ )
+      {
+         dim_ = 0;
+         nonzeros_ = 0;
+      }
    }
    else
    {
@@ -329,6 +340,24 @@ ESymSolverStatus Ma27TSolverInterface::InitializeStructure(
    return retval;
 }
 
+bool Ma27TSolverInterface::ReuseStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* /*airn*/,
+   const Index* /*ajcn*/
+)
+{
+   DBG_START_METH("Ma27TSolverInterface::ReuseStructure", dbg_verbosity);
+
+   if( dim_ != dim || nonzeros_ != nonzeros || dim_ == 0 )
+   {
+      return false;
+   }
+
+   initialized_ = true;
+   return true;
+}
+
 ESymSolverStatus Ma27TSolverInterface::SymbolicFactorization(
    const Index* airn,
    const Index* ajcn
@@ -360,18 +389,31 @@ ESymSolverStatus Ma27TSolverInterface::SymbolicFactorization(
    if( Jnlst().ProduceOutput(J_MOREMATRIX, J_LINEAR_ALGEBRA) )
    {
       Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                     "\nMatrix structure given to MA27 with dimension %d and %d nonzero entries:\n", dim_, nonzeros_);
+                     "\nMatrix structure given to MA27 with dimension %" IPOPT_INDEX_FORMAT " and %" IPOPT_INDEX_FORMAT " nonzero entries:\n", dim_, nonzeros_);
       for( Index i = 0; i < nonzeros_; i++ )
       {
          Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                        "A[%5d,%5d]\n", airn[i], ajcn[i]);
+                        "A[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]\n", airn[i], ajcn[i]);
+      }
+   }
+
+   // Use the pivot order from the ordering cache, if available
+   bool have_cached_ordering = false;
+   if( ordering_cache_->IsActive() )
+   {
+      ordering_cache_->SetStructure(dim_, nonzeros_, airn, ajcn);
+      have_cached_ordering = ordering_cache_->LoadOrdering(ikeep_);
+      if( have_cached_ordering )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Using pivot order from file %s.\n", ordering_cache_->FileName().c_str());
       }
    }
 
    // Call MA27AD (cast to ipfint for Index types)
    ipfint N = dim_;
    ipfint NZ = nonzeros_;
-   ipfint IFLAG = 0;
+   ipfint IFLAG = have_cached_ordering ? 1 : 0;
    double OPS;
    ipfint INFO[20];
    ipfint* IW1 = new ipfint[2 * dim_];      // Get memory for IW1 (only local)
@@ -383,15 +425,17 @@ ESymSolverStatus Ma27TSolverInterface::SymbolicFactorization(
    const ipfint& ierror = INFO[1];      // Error flag
    const ipfint& nrlnec = INFO[4];      // recommended value for la
    const ipfint& nirnec = INFO[5];      // recommended value for liw
+   nrladu_ = (Number) INFO[6];      // number of reals in the factors
+   ops_ = OPS;
 
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
-                  "Return values from MA27AD: IFLAG = %d, IERROR = %d\n", iflag, ierror);
+                  "Return values from MA27AD: IFLAG = %" IPOPT_INDEX_FORMAT ", IERROR = %" IPOPT_INDEX_FORMAT "\n", iflag, ierror);
 
    // Check if error occurred
    if( iflag != 0 )
    {
       Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                     "*** Error from MA27AD *** IFLAG = %d IERROR = %d\n", iflag, ierror);
+                     "*** Error from MA27AD *** IFLAG = %" IPOPT_INDEX_FORMAT " IERROR = %" IPOPT_INDEX_FORMAT "\n", iflag, ierror);
       if( iflag == 1 )
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
                         "The index of a matrix is out of range.\nPlease check your implementation of the Jacobian and Hessian matrices.\n");
@@ -402,25 +446,32 @@ ESymSolverStatus Ma27TSolverInterface::SymbolicFactorization(
       return SYMSOLVER_FATAL_ERROR;
    }
 
+   // IKEEP(:,1) now holds the position of each variable in the pivot order
+   if( ordering_cache_->IsActive() && !have_cached_ordering && !ordering_cache_->StoreOrdering(ikeep_) )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "Could not write pivot order to file %s.\n", ordering_cache_->FileName().c_str());
+   }
+
    // ToDo: try and catch
    // Reserve memory for iw_ for later calls, based on suggested size
    delete[] iw_;
    iw_ = NULL;
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Size of integer work space recommended by MA27 is %d\n", nirnec);
+                  "Size of integer work space recommended by MA27 is %" IPOPT_INDEX_FORMAT "\n", nirnec);
    liw_ = (ipfint) (liw_init_factor_ * (double) (nirnec));
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Setting integer work space size to %d\n", liw_);
+                  "Setting integer work space size to %" IPOPT_INDEX_FORMAT "\n", liw_);
    iw_ = new ipfint[liw_];
 
    // Reserve memory for a_
    delete[] a_;
    a_ = NULL;
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Size of doublespace recommended by MA27 is %d\n", nrlnec);
+                  "Size of doublespace recommended by MA27 is %" IPOPT_INDEX_FORMAT "\n", nrlnec);
    la_ = Max(nonzeros_, (ipfint) (la_init_factor_ * (double) (nrlnec)));
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Setting double work space size to %d\n", la_);
+                  "Setting double work space size to %" IPOPT_INDEX_FORMAT "\n", la_);
    a_ = new double[la_];
 
    if( HaveIpData() )
@@ -459,7 +510,7 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
       delete[] a_old;
       la_increase_ = false;
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "In Ma27TSolverInterface::Factorization: Increasing la from %d to %d\n", la_old, la_);
+                     "In Ma27TSolverInterface::Factorization: Increasing la from %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT "\n", la_old, la_);
    }
 
    // Check if liw should be increased
@@ -472,7 +523,7 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
       iw_ = new ipfint[liw_];
       liw_increase_ = false;
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "In Ma27TSolverInterface::Factorization: Increasing liw from %d to %d\n", liw_old, liw_);
+                     "In Ma27TSolverInterface::Factorization: Increasing liw from %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT "\n", liw_old, liw_);
    }
 
    ipfint iflag;  // Information flag
@@ -498,7 +549,7 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
    negevals_ = INFO[14];  // Number of negative eigenvalues
 
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
-                  "Return values from MA27BD: IFLAG = %d, IERROR = %d\n", iflag, ierror);
+                  "Return values from MA27BD: IFLAG = %" IPOPT_INDEX_FORMAT ", IERROR = %" IPOPT_INDEX_FORMAT "\n", iflag, ierror);
 
    DBG_PRINT((1, "Return from MA27BD iflag = %d and ierror = %d\n",
               iflag, ierror));
@@ -528,7 +579,7 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
       iw_ = new ipfint[liw_];
       a_ = new double[la_];
       Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                     "MA27BD returned iflag=%d and requires more memory.\n Increase liw from %d to %d and la from %d to %d and factorize again.\n",
+                     "MA27BD returned iflag=%" IPOPT_INDEX_FORMAT " and requires more memory.\n Increase liw from %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT " and la from %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT " and factorize again.\n",
                      iflag, liw_old, liw_, la_old, la_);
       if( HaveIpData() )
       {
@@ -550,7 +601,7 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
    {
       Index missing_rank = dim_ - INFO[1];
       Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                     "MA27BD returned iflag=%d and detected rank deficiency of degree %d.\n", iflag, missing_rank);
+                     "MA27BD returned iflag=%" IPOPT_INDEX_FORMAT " and detected rank deficiency of degree %" IPOPT_INDEX_FORMAT ".\n", iflag, missing_rank);
       // We correct the number of negative eigenvalues here to include
       // the zero eigenvalues, since otherwise we indicate the wrong
       // inertia.
@@ -572,19 +623,19 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
    {
       la_increase_ = true;
       Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                     "MA27BD returned ncmpbr=%d. Increase la before the next factorization.\n", ncmpbr);
+                     "MA27BD returned ncmpbr=%" IPOPT_INDEX_FORMAT ". Increase la before the next factorization.\n", ncmpbr);
    }
    if( ncmpbi >= 10 )
    {
       liw_increase_ = true;
       Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                     "MA27BD returned ncmpbi=%d. Increase liw before the next factorization.\n", ncmpbr);
+                     "MA27BD returned ncmpbi=%" IPOPT_INDEX_FORMAT ". Increase liw before the next factorization.\n", ncmpbr);
    }
 
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of doubles for MA27 to hold factorization (INFO(9)) = %d\n", INFO[8]);
+                  "Number of doubles for MA27 to hold factorization (INFO(9)) = %" IPOPT_INDEX_FORMAT "\n", INFO[8]);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of integers for MA27 to hold factorization (INFO(10)) = %d\n", INFO[9]);
+                  "Number of integers for MA27 to hold factorization (INFO(10)) = %" IPOPT_INDEX_FORMAT "\n", INFO[9]);
 
    // Check whether the number of negative eigenvalues matches the requested
    // count
@@ -595,7 +646,7 @@ ESymSolverStatus Ma27TSolverInterface::Factorization(
    if( !skip_inertia_check_ && check_NegEVals && (numberOfNegEVals != negevals_) )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "In Ma27TSolverInterface::Factorization: negevals_ = %d, but numberOfNegEVals = %d\n", negevals_,
+                     "In Ma27TSolverInterface::Factorization: negevals_ = %" IPOPT_INDEX_FORMAT ", but numberOfNegEVals = %" IPOPT_INDEX_FORMAT "\n", negevals_,
                      numberOfNegEVals);
       return SYMSOLVER_WRONG_INERTIA;
    }
@@ -659,6 +710,19 @@ Index Ma27TSolverInterface::NumberOfNegEVals() const
    return negevals_;
 }
 
+bool Ma27TSolverInterface::EstimateFactorization(
+   Number& factor_nonzeros,
+   Number& flops,
+   Number& memory
+)
+{
+   DBG_ASSERT(initialized_);
+   factor_nonzeros = nrladu_;
+   flops = ops_;
+   memory = (Number) la_ * sizeof(double) + ((Number) liw_ + 3. * dim_) * sizeof(ipfint);
+   return true;
+}
+
 bool Ma27TSolverInterface::IncreaseQuality()
 {
    DBG_START_METH("Ma27TSolverInterface::IncreaseQuality", dbg_verbosity);
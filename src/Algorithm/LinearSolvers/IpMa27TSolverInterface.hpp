@@ -8,6 +8,7 @@
 #define __IPMA27TSOLVERINTERFACE_HPP__
 
 #include "IpSparseSymLinearSolverInterface.hpp"
+#include "IpOrderingCache.hpp"
 
 namespace Ipopt
 {
@@ -40,6 +41,13 @@ public:
       const Index* ajcn
    );
 
+   virtual bool ReuseStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
    virtual double* GetValuesArrayPtr();
 
    virtual ESymSolverStatus MultiSolve(
@@ -63,6 +71,12 @@ public:
       return true;
    }
 
+   virtual bool EstimateFactorization(
+      Number& factor_nonzeros,
+      Number& flops,
+      Number& memory
+   );
+
    EMatrixFormat MatrixFormat() const
    {
       return Triplet_Format;
@@ -146,6 +160,12 @@ private:
     *  already been solved before.
     */
    bool warm_start_same_structure_;
+   /** Flag indicating whether the symbolic factorization is to be
+    *  kept for a reoptimization with identical structure.
+    */
+   bool reuse_symbolic_factorization_;
+   /** Cache for the pivot orderings computed by MA27AD */
+   SmartPtr<OrderingCache> ordering_cache_;
    /** Flag indicating if the inertia is always assumed to be correct. */
    bool skip_inertia_check_;
    /** Flag indicating if MA27 should continue if a singular matrix
@@ -175,6 +195,11 @@ private:
    /** MA27's MAXFRT */
    ipfint maxfrt_;
 
+   /** Number of reals in the factors, as predicted by MA27AD */
+   Number nrladu_;
+   /** Number of operations of the factorization, as predicted by MA27AD */
+   Number ops_;
+
    /** length LA of A */
    ipfint la_;
    /** factor A of matrix */
@@ -22,6 +22,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 /** Prototypes for MA57's Fortran subroutines */
 extern "C"
@@ -224,6 +225,8 @@ Ma57TSolverInterface::Ma57TSolverInterface()
      wd_iwork_(NULL),
      wd_fact_(NULL),
      wd_ifact_(NULL),
+     wd_factor_nonzeros_(0.),
+     wd_flops_(0.),
      a_(NULL)
 {
    DBG_START_METH("Ma57TSolverInterface::Ma57TSolverInterface()", dbg_verbosity);
@@ -313,8 +316,43 @@ void Ma57TSolverInterface::RegisterOptions(
       "the corresponding pivots placed at the end of the factorization. "
       "This can be particularly efficient if the matrix is highly rank deficient. "
       "This is ICNTL(16) in MA57.");
+
+   roptions->AddLowerBoundedNumberOption(
+      "ma57_static_pivot_value",
+      "Threshold for static pivoting in MA57",
+      0.0, false,
+      0.0,
+      "If positive, MA57 uses static pivoting instead of delaying pivots that fail the threshold test: "
+      "a pivot with absolute value less than this value is replaced by this value (with the same sign). "
+      "This avoids the extra fill-in from delayed pivots, but the factorization is then the one of a perturbed matrix, "
+      "so that more iterative refinement steps may be needed. "
+      "The value 0 disables static pivoting. "
+      "This is CNTL(4) in MA57.");
+
+   roptions->AddLowerBoundedNumberOption(
+      "ma57_static_pivot_min",
+      "Smallest pivot accepted before static pivoting in MA57",
+      0.0, false,
+      0.0,
+      "This is used in conjunction with ma57_static_pivot_value: "
+      "a diagonal entry is only chosen as pivot if its absolute value is at least this value. "
+      "This is CNTL(5) in MA57.");
    // CET 04-29-2010
 
+   roptions->AddStringOption2(
+      "ma57_definite_factorization",
+      "Whether to factorize matrices that should be positive definite without pivoting",
+      "no",
+      "no", "always use threshold pivoting",
+      "yes", "factorize without pivoting if no negative eigenvalues are expected",
+      "If the matrix is expected to have no negative eigenvalues, e.g., the augmented system of a problem "
+      "that has only bound constraints, MA57 computes a Cholesky-like factorization without pivoting. "
+      "This is faster and does not create fill-in by delayed pivots. "
+      "If a pivot of the wrong sign or a too small pivot is encountered, "
+      "the factorization stops immediately and reports a wrong inertia or a singular matrix, respectively, "
+      "so that the matrix is regularized. "
+      "This sets ICNTL(7) in MA57 to 2 for these matrices.");
+
 }
 
 bool Ma57TSolverInterface::InitializeImpl(
@@ -340,10 +378,13 @@ bool Ma57TSolverInterface::InitializeImpl(
 
    // The following option is registered by OrigIpoptNLP
    options.GetBoolValue("warm_start_same_structure", warm_start_same_structure_, prefix);
+   // The following option is registered by TSymLinearSolver
+   options.GetBoolValue("reuse_symbolic_factorization", reuse_symbolic_factorization_, prefix);
    DBG_ASSERT(!warm_start_same_structure_ && "warm_start_same_structure not yet implemented");
 
    bool ma57_automatic_scaling;
    options.GetBoolValue("ma57_automatic_scaling", ma57_automatic_scaling, prefix);
+   options.GetBoolValue("ma57_definite_factorization", ma57_definite_factorization_, prefix);
 
    // CET 04-29-2010
    Index ma57_block_size;
@@ -356,6 +397,16 @@ bool Ma57TSolverInterface::InitializeImpl(
    options.GetIntegerValue("ma57_small_pivot_flag", ma57_small_pivot_flag, prefix);
    // CET 04-29-2010
 
+   Number ma57_static_pivot_value;
+   options.GetNumericValue("ma57_static_pivot_value", ma57_static_pivot_value, prefix);
+   Number ma57_static_pivot_min;
+   options.GetNumericValue("ma57_static_pivot_min", ma57_static_pivot_min, prefix);
+
+   // The following option is registered by TSymLinearSolver
+   std::string ordering_cache_dir;
+   options.GetStringValue("ordering_cache_dir", ordering_cache_dir, prefix);
+   ordering_cache_ = new OrderingCache(ordering_cache_dir, "ma57");
+
    /* Initialize. */
    IPOPT_HSL_FUNC (ma57id, MA57ID)(wd_cntl_, wd_icntl_);
 
@@ -389,9 +440,12 @@ bool Ma57TSolverInterface::InitializeImpl(
    wd_icntl_[16 - 1] = ma57_small_pivot_flag; /* If set to 1, small entries are removed and corresponding pivots are placed at the end of factorization.  May be useful for highly rank deficient matrices.  Default is 0. */
    // CET: 04-29-2010
 
+   wd_cntl_[4 - 1] = ma57_static_pivot_value; /* Static pivoting is used if positive.  Default is 0. */
+   wd_cntl_[5 - 1] = ma57_static_pivot_min; /* Smallest pivot accepted if static pivoting is used.  Default is 0. */
+
    // wd_icntl[8-1] = 0;       /* Retry factorization. */
 
-   if( !warm_start_same_structure_ )
+   if( !warm_start_same_structure_ && !reuse_symbolic_factorization_ )
    {
       dim_ = 0;
       nonzeros_ = 0;
@@ -406,7 +460,7 @@ bool Ma57TSolverInterface::InitializeImpl(
       delete[] wd_keep_;
       wd_keep_ = NULL;
    }
-   else
+   else if( warm_start_same_structure_ )
    {
       ASSERT_EXCEPTION(dim_ > 0 && nonzeros_ > 0, INVALID_WARMSTART,
                        "Ma57TSolverInterface called with warm_start_same_structure, "
@@ -514,6 +568,24 @@ ESymSolverStatus Ma57TSolverInterface::InitializeStructure(
    return retval;
 }
 
+bool Ma57TSolverInterface::ReuseStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* /*airn*/,
+   const Index* /*ajcn*/
+)
+{
+   DBG_START_METH("Ma57TSolverInterface::ReuseStructure", dbg_verbosity);
+
+   if( dim_ != dim || nonzeros_ != nonzeros || wd_keep_ == NULL || a_ == NULL )
+   {
+      return false;
+   }
+
+   initialized_ = true;
+   return true;
+}
+
 ESymSolverStatus Ma57TSolverInterface::SymbolicFactorization(
    const Index* airn,
    const Index* ajcn
@@ -533,7 +605,9 @@ ESymSolverStatus Ma57TSolverInterface::SymbolicFactorization(
 
    wd_cntl_[1 - 1] = pivtol_; /* Pivot threshold. */
 
+   delete[] wd_iwork_;
    wd_iwork_ = new ma57int[5 * n];
+   delete[] wd_keep_;
    wd_keep_ = new ma57int[wd_lkeep_];
    // Initialize to 0 as otherwise MA57ED can sometimes fail
    for( int k = 0; k < wd_lkeep_; k++ )
@@ -560,8 +634,62 @@ ESymSolverStatus Ma57TSolverInterface::SymbolicFactorization(
       ajcn_ma57int = (ma57int*) (void*) const_cast<Index*>(ajcn);
    }
 
+   // Use the pivot order from the ordering cache, if available
+   bool have_cached_ordering = false;
+   if( ordering_cache_->IsActive() && dim_ > 0 )
+   {
+      ordering_cache_->SetStructure(dim_, nonzeros_, airn, ajcn);
+      std::vector<Index> perm(dim_);
+      have_cached_ordering = ordering_cache_->LoadOrdering(&perm[0]);
+      if( have_cached_ordering )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Using pivot order from file %s.\n", ordering_cache_->FileName().c_str());
+         for( Index i = 0; i < dim_; i++ )
+         {
+            wd_keep_[i] = (ma57int) perm[i];
+         }
+      }
+   }
+
+   // KEEP(1:N) holds a given pivot order if ICNTL(6) = 1
+   const ma57int pivot_order = wd_icntl_[6 - 1];
+   if( have_cached_ordering )
+   {
+      wd_icntl_[6 - 1] = 1;
+   }
    IPOPT_HSL_FUNC (ma57ad, MA57AD)(&n, &ne, airn_ma57int, ajcn_ma57int, &wd_lkeep_, wd_keep_, wd_iwork_, wd_icntl_, wd_info_,
                              wd_rinfo_);
+   wd_icntl_[6 - 1] = pivot_order;
+
+   if( have_cached_ordering && wd_info_[0] < 0 )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "MA57AD rejected the pivot order from file %s (INFO(1) = %" IPOPT_INDEX_FORMAT "), computing a new one.\n",
+                     ordering_cache_->FileName().c_str(), wd_info_[0]);
+      have_cached_ordering = false;
+      for( int k = 0; k < wd_lkeep_; k++ )
+      {
+         wd_keep_[k] = 0;
+      }
+      IPOPT_HSL_FUNC (ma57ad, MA57AD)(&n, &ne, airn_ma57int, ajcn_ma57int, &wd_lkeep_, wd_keep_, wd_iwork_, wd_icntl_, wd_info_,
+                                wd_rinfo_);
+   }
+
+   // KEEP(1:N) now holds the pivot order in the form that MA57AD accepts as input
+   if( ordering_cache_->IsActive() && dim_ > 0 && !have_cached_ordering && wd_info_[0] >= 0 )
+   {
+      std::vector<Index> perm(dim_);
+      for( Index i = 0; i < dim_; i++ )
+      {
+         perm[i] = (Index) wd_keep_[i];
+      }
+      if( !ordering_cache_->StoreOrdering(&perm[0]) )
+      {
+         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                        "Could not write pivot order to file %s.\n", ordering_cache_->FileName().c_str());
+      }
+   }
 
    // free copy-casted ma57int arrays, no longer needed
    if( sizeof(ma57int) != sizeof(Index) )
@@ -573,9 +701,14 @@ ESymSolverStatus Ma57TSolverInterface::SymbolicFactorization(
    if( wd_info_[0] < 0 )
    {
       Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                     "*** Error from MA57AD *** INFO(0) = %d\n", wd_info_[0]);
+                     "*** Error from MA57AD *** INFO(0) = %" IPOPT_INDEX_FORMAT "\n", wd_info_[0]);
    }
 
+   // forecasts of the size of the factors and of the assembly and
+   // elimination operations
+   wd_factor_nonzeros_ = (Number) wd_info_[4];
+   wd_flops_ = wd_rinfo_[0] + wd_rinfo_[1];
+
    wd_lfact_ = (ma57int) ((Number) wd_info_[8] * ma57_pre_alloc_);
    wd_lifact_ = (ma57int) ((Number) wd_info_[9] * ma57_pre_alloc_);
 
@@ -596,9 +729,9 @@ ESymSolverStatus Ma57TSolverInterface::SymbolicFactorization(
    wd_ifact_ = new ma57int[wd_lifact_];
 
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Suggested lfact  (*%e):  %d\n", ma57_pre_alloc_, wd_lfact_);
+                  "Suggested lfact  (*%e):  %" IPOPT_INDEX_FORMAT "\n", ma57_pre_alloc_, wd_lfact_);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Suggested lifact (*%e):  %d\n", ma57_pre_alloc_, wd_lifact_);
+                  "Suggested lifact (*%e):  %" IPOPT_INDEX_FORMAT "\n", ma57_pre_alloc_, wd_lifact_);
 
    if( HaveIpData() )
    {
@@ -624,6 +757,10 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
 
    wd_cntl_[1 - 1] = pivtol_; /* Pivot threshold. */
 
+   // Without pivoting if the matrix should be positive definite
+   const bool definite = ma57_definite_factorization_ && check_NegEVals && numberOfNegEVals == 0;
+   wd_icntl_[7 - 1] = definite ? 2 : 1; /* Pivoting strategy. */
+
    ma57int n = dim_;
    ma57int ne = nonzeros_;
 
@@ -651,12 +788,12 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
 
          wd_lfact_ = (ma57int) ((Number) wd_info_[16] * ma57_pre_alloc_);
          Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                        "Reallocating memory for MA57: lfact (%d)\n", wd_lfact_);
+                        "Reallocating memory for MA57: lfact (%" IPOPT_INDEX_FORMAT ")\n", wd_lfact_);
 
          if( (size_t) wd_lfact_ > std::numeric_limits<size_t>::max() / sizeof(double) )
          {
             Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                           "Cannot allocate memory of size %d exceeding SIZE_MAX = %u\n", wd_lfact_, std::numeric_limits<size_t>::max());
+                           "Cannot allocate memory of size %" IPOPT_INDEX_FORMAT " exceeding SIZE_MAX = %u\n", wd_lfact_, std::numeric_limits<size_t>::max());
             return SYMSOLVER_FATAL_ERROR;
          }
 
@@ -685,7 +822,7 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
          temp = new ma57int[wd_lifact_];
 
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "Reallocating lifact (%d)\n", wd_lifact_);
+                        "Reallocating lifact (%" IPOPT_INDEX_FORMAT ")\n", wd_lifact_);
 
          double ddmy;
          IPOPT_HSL_FUNC (ma57ed, MA57ED)(&n, &ic, wd_keep_, wd_fact_, &wd_info_[1], &ddmy, &wd_lifact_, wd_ifact_,
@@ -694,10 +831,24 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
          delete[] wd_ifact_;
          wd_ifact_ = temp;
       }
+      else if( definite && (wd_info_[0] == -5 || wd_info_[0] == -6) )
+      {
+         /* A too small pivot, or a pivot with a different sign, has been
+          * found in the factorization without pivoting, so the matrix is
+          * not sufficiently positive definite.
+          */
+         if( HaveIpData() )
+         {
+            IpData().TimingStats().LinearSystemFactorization().End();
+         }
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Matrix not positive definite in MA57BD: %" IPOPT_INDEX_FORMAT " at pivot %" IPOPT_INDEX_FORMAT "\n", wd_info_[0], wd_info_[1]);
+         return wd_info_[0] == -5 ? SYMSOLVER_SINGULAR : SYMSOLVER_WRONG_INERTIA;
+      }
       else if( wd_info_[0] < 0 )
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Error in MA57BD:  %d\n", wd_info_[0]);
+                        "Error in MA57BD:  %" IPOPT_INDEX_FORMAT "\n", wd_info_[0]);
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                         "MA57 Error message: %s\n", ma57_err_msg[-wd_info_[1 - 1]]);
          return SYMSOLVER_FATAL_ERROR;
@@ -710,13 +861,13 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
             IpData().TimingStats().LinearSystemFactorization().End();
          }
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "System singular, rank = %d\n", wd_info_[25 - 1]);
+                        "System singular, rank = %" IPOPT_INDEX_FORMAT "\n", wd_info_[25 - 1]);
          return SYMSOLVER_SINGULAR;
       }
       else if( wd_info_[0] > 0 )
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Warning in MA57BD:  %d\n", wd_info_[0]);
+                        "Warning in MA57BD:  %" IPOPT_INDEX_FORMAT "\n", wd_info_[0]);
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                         "MA57 Warning message: %s\n", ma57_wrn_msg[wd_info_[1 - 1]]);
          // For now, abort the process so that we don't miss any problems
@@ -726,7 +877,7 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
 
    double peak_mem = 1.0e-3 * ((double) wd_lfact_ * 8.0 + (double) wd_lifact_ * 4.0 + (double) wd_lkeep_ * 4.0);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "MA57 peak memory use: %dKB\n", (ma57int) (peak_mem));
+                  "MA57 peak memory use: %" IPOPT_INDEX_FORMAT "KB\n", (ma57int) (peak_mem));
 
    // Check whether the number of negative eigenvalues matches the
    // requested count.
@@ -737,7 +888,7 @@ ESymSolverStatus Ma57TSolverInterface::Factorization(
    if( check_NegEVals && (numberOfNegEVals != negevals_) )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "In Ma57TSolverInterface::Factorization: negevals_ = %d, but numberOfNegEVals = %d\n", negevals_, numberOfNegEVals);
+                     "In Ma57TSolverInterface::Factorization: negevals_ = %" IPOPT_INDEX_FORMAT ", but numberOfNegEVals = %" IPOPT_INDEX_FORMAT "\n", negevals_, numberOfNegEVals);
       return SYMSOLVER_WRONG_INERTIA;
    }
 
@@ -787,7 +938,7 @@ ESymSolverStatus Ma57TSolverInterface::Backsolve(
    if( wd_info_[0] != 0 )
    {
       Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                     "Error in MA57CD:  %d.\n", wd_info_[0]);
+                     "Error in MA57CD:  %" IPOPT_INDEX_FORMAT ".\n", wd_info_[0]);
    }
 
    if( DBG_VERBOSITY() >= 2 )
@@ -818,6 +969,19 @@ Index Ma57TSolverInterface::NumberOfNegEVals() const
    return negevals_;
 }
 
+bool Ma57TSolverInterface::EstimateFactorization(
+   Number& factor_nonzeros,
+   Number& flops,
+   Number& memory
+)
+{
+   DBG_ASSERT(initialized_);
+   factor_nonzeros = wd_factor_nonzeros_;
+   flops = wd_flops_;
+   memory = (Number) wd_lfact_ * sizeof(double) + ((Number) wd_lifact_ + wd_lkeep_ + 5. * dim_) * sizeof(ma57int);
+   return true;
+}
+
 bool Ma57TSolverInterface::IncreaseQuality()
 {
    DBG_START_METH("Ma57TSolverInterface::IncreaseQuality", dbg_verbosity);
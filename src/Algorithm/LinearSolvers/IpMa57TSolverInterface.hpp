@@ -9,6 +9,7 @@
 #define __IPMA57TSOLVERINTERFACE_HPP__
 
 #include "IpSparseSymLinearSolverInterface.hpp"
+#include "IpOrderingCache.hpp"
 
 #ifdef FUNNY_MA57_FINT
 #include <cstddef>
@@ -48,8 +49,20 @@ public:
       const Index* ajcn
    );
 
+   virtual bool ReuseStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
    virtual double* GetValuesArrayPtr();
 
+   virtual bool PreservesValues() const
+   {
+      return true;
+   }
+
    virtual ESymSolverStatus MultiSolve(
       bool         new_matrix,
       const Index* airn,
@@ -72,6 +85,12 @@ public:
       return true;
    }
 
+   virtual bool EstimateFactorization(
+      Number& factor_nonzeros,
+      Number& flops,
+      Number& memory
+   );
+
    EMatrixFormat MatrixFormat() const
    {
       return Triplet_Format;
@@ -145,10 +164,20 @@ private:
    Number pivtolmax_;
    /** Factor for estimating initial size of work arrays */
    Number ma57_pre_alloc_;
+   /** Flag indicating whether matrices that are expected to be
+    *  positive definite are factorized without pivoting.
+    */
+   bool ma57_definite_factorization_;
    /** Flag indicating whether the TNLP with identical structure has
     *  already been solved before.
     */
    bool warm_start_same_structure_;
+   /** Flag indicating whether the symbolic factorization is to be
+    *  kept for a reoptimization with identical structure.
+    */
+   bool reuse_symbolic_factorization_;
+   /** Cache for the pivot orderings computed by MA57AD */
+   SmartPtr<OrderingCache> ordering_cache_;
    ///@}
 
    /** @name Data for the linear solver.
@@ -171,6 +200,11 @@ private:
    ma57int* wd_ifact_;
    ma57int wd_lifact_;
 
+   /** Number of reals in the factors, as forecast by MA57AD */
+   Number wd_factor_nonzeros_;
+   /** Number of operations of the factorization, as forecast by MA57AD */
+   Number wd_flops_;
+
    /** factor A of matrix */
    double* a_;
    ///@}
@@ -15,7 +15,8 @@
 #endif
 
 // if we do not have HSL_MA77 in HSL or the linear solver loader, then we want to build the MA77 interface
-#if defined(COINHSL_HAS_MA77) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
+// the C interface of HSL_MA77 only supports 32-bit integers, so it is not available if Index is 64-bit
+#if (defined(COINHSL_HAS_MA77) || defined(IPOPT_HAS_LINEARSOLVERLOADER)) && !defined(IPOPT_INT64)
 
 #include "IpMa77SolverInterface.hpp"
 #include <iostream>
@@ -67,7 +68,17 @@ void Ma77SolverInterface::RegisterOptions(
       "Number of pages that make up MA77 buffer",
       1,
       1600,
-      "Number of pages of size buffer_lpage that exist in-core for the out-of-core solver MA77.");
+      "Number of pages of size buffer_lpage that exist in-core for the out-of-core solver MA77. "
+      "This is ignored if ma77_buffer_memory is positive.");
+   roptions->AddLowerBoundedNumberOption(
+      "ma77_buffer_memory",
+      "Memory for the MA77 buffers in megabytes",
+      0.0, false,
+      0.0,
+      "If positive, the number of buffer pages is chosen such that the in-core buffers for the integer and the real data "
+      "of the out-of-core solver MA77 each take up half of this memory, "
+      "e.g., the memory that is available besides the other data of the problem. "
+      "If zero, ma77_buffer_npage is used.");
    roptions->AddLowerBoundedIntegerOption(
       "ma77_file_size",
       "Target size of each temporary file for MA77, scalars per type",
@@ -75,6 +86,34 @@ void Ma77SolverInterface::RegisterOptions(
       2097152,
       "MA77 uses many temporary files, this option controls the size of each one. "
       "It is measured in the number of entries (int or double), NOT bytes.");
+   roptions->AddStringOption1(
+      "ma77_int_file",
+      "Base name of the temporary files of MA77 for integer data",
+      "ma77_int",
+      "*", "Any acceptable file name",
+      "The name may include a directory, e.g., on a fast scratch device. "
+      "MA77 appends a number to the name for each file.");
+   roptions->AddStringOption1(
+      "ma77_real_file",
+      "Base name of the temporary files of MA77 for real data",
+      "ma77_real",
+      "*", "Any acceptable file name",
+      "The name may include a directory, e.g., on a fast scratch device. "
+      "MA77 appends a number to the name for each file.");
+   roptions->AddStringOption1(
+      "ma77_work_file",
+      "Base name of the temporary files of MA77 for work data",
+      "ma77_work",
+      "*", "Any acceptable file name",
+      "The name may include a directory, e.g., on a fast scratch device. "
+      "MA77 appends a number to the name for each file.");
+   roptions->AddStringOption1(
+      "ma77_delay_file",
+      "Base name of the temporary files of MA77 for delayed pivots",
+      "ma77_delay",
+      "*", "Any acceptable file name",
+      "The name may include a directory, e.g., on a fast scratch device. "
+      "MA77 appends a number to the name for each file.");
    roptions->AddLowerBoundedIntegerOption(
       "ma77_maxstore",
       "Maximum storage size for MA77 in-core mode",
@@ -144,6 +183,19 @@ bool Ma77SolverInterface::InitializeImpl(
    options.GetIntegerValue("ma77_buffer_lpage", control_.buffer_lpage[1], prefix);
    options.GetIntegerValue("ma77_buffer_npage", control_.buffer_npage[0], prefix);
    options.GetIntegerValue("ma77_buffer_npage", control_.buffer_npage[1], prefix);
+   Number buffer_memory;
+   options.GetNumericValue("ma77_buffer_memory", buffer_memory, prefix);
+   if( buffer_memory > 0. )
+   {
+      // half of the memory for each of the integer and real buffers
+      Number bytes = 0.5 * buffer_memory * 1024. * 1024.;
+      control_.buffer_npage[0] = (int) Max(1., bytes / ((Number) control_.buffer_lpage[0] * sizeof(int)));
+      control_.buffer_npage[1] = (int) Max(1., bytes / ((Number) control_.buffer_lpage[1] * sizeof(double)));
+   }
+   options.GetStringValue("ma77_int_file", file_name_[0], prefix);
+   options.GetStringValue("ma77_real_file", file_name_[1], prefix);
+   options.GetStringValue("ma77_work_file", file_name_[2], prefix);
+   options.GetStringValue("ma77_delay_file", file_name_[3], prefix);
    int temp;
    options.GetIntegerValue("ma77_file_size", temp, prefix);
    control_.file_size = temp;
@@ -240,7 +292,8 @@ ESymSolverStatus Ma77SolverInterface::InitializeStructure(
    delete[] ja_half;
 
    // Open files
-   ma77_open(ndim_, "ma77_int", "ma77_real", "ma77_work", "ma77_delay", &keep_, &control_, &info);
+   ma77_open(ndim_, file_name_[0].c_str(), file_name_[1].c_str(), file_name_[2].c_str(), file_name_[3].c_str(), &keep_,
+             &control_, &info);
    if( info.flag < 0 )
    {
       return SYMSOLVER_FATAL_ERROR;
@@ -365,4 +418,4 @@ bool Ma77SolverInterface::IncreaseQuality()
 
 } // namespace Ipopt
 
-#endif /* COINHSL_HAS_MA77 or IPOPT_HAS_LINEARSOLVERLOADER */
+#endif /* (COINHSL_HAS_MA77 or IPOPT_HAS_LINEARSOLVERLOADER) and not IPOPT_INT64 */
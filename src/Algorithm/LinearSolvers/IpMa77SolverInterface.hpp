@@ -39,6 +39,10 @@ private:
    struct ma77_control control_;
    double umax_;
    int ordering_;
+   /** Base names of the temporary files for the integer, real,
+    *  work, and delay data
+    */
+   std::string file_name_[4];
 
 public:
 
@@ -15,7 +15,8 @@
 #endif
 
 // if we do not have MA86 in HSL or the linear solver loader, then we want to build the MA86 interface
-#if defined(COINHSL_HAS_MA86) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
+// the C interface of HSL_MA86 only supports 32-bit integers, so it is not available if Index is 64-bit
+#if (defined(COINHSL_HAS_MA86) || defined(IPOPT_HAS_LINEARSOLVERLOADER)) && !defined(IPOPT_INT64)
 
 #include "IpMa86SolverInterface.hpp"
 #include <iostream>
@@ -61,6 +62,25 @@ void Ma86SolverInterface::RegisterOptions(
       1,
       32,
       "Two nodes in elimination tree are merged if result has fewer than ma86_nemin variables.");
+   roptions->AddLowerBoundedIntegerOption(
+      "ma86_nb",
+      "Block size of the nodes",
+      1,
+      256,
+      "The nodes of the elimination tree are split into blocks of this size, "
+      "which are the tasks that are scheduled on the threads.");
+   roptions->AddLowerBoundedIntegerOption(
+      "ma86_nbi",
+      "Inner block size for the factorization of the blocks",
+      1,
+      16,
+      "See MA86 documentation.");
+   roptions->AddLowerBoundedIntegerOption(
+      "ma86_pool_size",
+      "Initial size of the task pool",
+      1,
+      25000,
+      "The task pool is enlarged during the factorization if it is too small.");
    roptions->AddLowerBoundedNumberOption(
       "ma86_small",
       "Zero Pivot Threshold",
@@ -121,6 +141,9 @@ bool Ma86SolverInterface::InitializeImpl(
 
    options.GetIntegerValue("ma86_print_level", control_.diagnostics_level, prefix);
    options.GetIntegerValue("ma86_nemin", control_.nemin, prefix);
+   options.GetIntegerValue("ma86_nb", control_.nb, prefix);
+   options.GetIntegerValue("ma86_nbi", control_.nbi, prefix);
+   options.GetIntegerValue("ma86_pool_size", control_.pool_size, prefix);
    options.GetNumericValue("ma86_small", control_.small_, prefix);
    options.GetNumericValue("ma86_static", control_.static_, prefix);
    options.GetNumericValue("ma86_u", control_.u, prefix);
@@ -359,4 +382,4 @@ bool Ma86SolverInterface::IncreaseQuality()
 
 } // namespace Ipopt
 
-#endif /* COINHSL_HAS_MA86 or IPOPT_HAS_LINEARSOLVERLOADER */
+#endif /* (COINHSL_HAS_MA86 or IPOPT_HAS_LINEARSOLVERLOADER) and not IPOPT_INT64 */
@@ -76,6 +76,11 @@ public:
       return val_;
    }
 
+   bool PreservesValues() const
+   {
+      return true;
+   }
+
    ESymSolverStatus MultiSolve(
       bool         new_matrix,
       const Index* ia,
@@ -18,9 +18,11 @@
 #endif
 
 // if we have MA97 in HSL or the linear solver loader, then we want to build the MA97 interface
-#if defined(COINHSL_HAS_MA97) || defined(IPOPT_HAS_LINEARSOLVERLOADER)
+// the C interface of HSL_MA97 only supports 32-bit integers, so it is not available if Index is 64-bit
+#if (defined(COINHSL_HAS_MA97) || defined(IPOPT_HAS_LINEARSOLVERLOADER)) && !defined(IPOPT_INT64)
 
 #include "IpMa97SolverInterface.hpp"
+#include "IpBlas.hpp"
 #include <iostream>
 #include <cstdio>
 #include <cmath>
@@ -55,8 +57,13 @@ Ma97SolverInterface::~Ma97SolverInterface()
    {
       delete[] scaling_;
    }
+   delete[] scaled_val_;
 
-   ma97_finalise(&akeep_, &fkeep_);
+   // HSL_MA97 might not have been loaded if nothing has been analysed
+   if( akeep_ != NULL || fkeep_ != NULL )
+   {
+      ma97_finalise(&akeep_, &fkeep_);
+   }
 }
 
 void Ma97SolverInterface::RegisterOptions(
@@ -205,6 +212,37 @@ void Ma97SolverInterface::RegisterOptions(
       "no",
       "no", "Use BLAS2 (faster, some implementations bit incompatible)",
       "yes", "Use BLAS3 (slower)");
+   roptions->AddLowerBoundedIntegerOption(
+      "ma97_factor_min",
+      "Minimum number of flops for a parallel factorization",
+      0,
+      20000000,
+      "If the factorization is expected to need fewer floating point operations, it is done serially. "
+      "A value larger than the number of flops of all factorizations makes the factorization deterministic "
+      "independent of the number of threads.");
+   roptions->AddLowerBoundedIntegerOption(
+      "ma97_solve_min",
+      "Minimum number of entries in the factors for a parallel solve",
+      0,
+      100000,
+      "If there are fewer entries in the factors, the solves are done serially.");
+   roptions->AddStringOption2(
+      "ma97_solve_mf",
+      "Controls if the solves use the multifrontal or the supernodal form of the factors",
+      "no",
+      "no", "Use the supernodal form",
+      "yes", "Use the multifrontal form");
+   roptions->AddLowerBoundedNumberOption(
+      "ma97_rescale_tol",
+      "Relative change of matrix values up to which a previously computed scaling is reused",
+      0.0, false,
+      0.0,
+      "If a matrix is to be scaled (according to ma97_scaling and the ma97_switchX options) and no entry "
+      "differs from the values of the matrix for which the current scaling has been computed by more than "
+      "this tolerance (relative to the absolute value of the old entry, but at least 1), "
+      "then the scaling is not recomputed but reused. "
+      "A new scaling is always computed if scaling is enabled because of a failure of iterative refinement "
+      "or excess delays. The value 0 disables the reuse.");
 }
 
 int Ma97SolverInterface::ScaleNameToNum(
@@ -246,6 +284,7 @@ bool Ma97SolverInterface::InitializeImpl(
    options.GetNumericValue("ma97_small", control_.small, prefix);
    options.GetNumericValue("ma97_u", control_.u, prefix);
    options.GetNumericValue("ma97_umax", umax_, prefix);
+   options.GetNumericValue("ma97_rescale_tol", rescale_tol_, prefix);
    std::string order_method, scaling_method, rescale_strategy;
    options.GetStringValue("ma97_order", order_method, prefix);
    if( order_method == "metis" )
@@ -350,6 +389,14 @@ bool Ma97SolverInterface::InitializeImpl(
    bool solve_blas3;
    options.GetBoolValue("ma97_solve_blas3", solve_blas3, prefix);
    control_.solve_blas3 = solve_blas3 ? 1 : 0;
+   Index factor_min, solve_min;
+   options.GetIntegerValue("ma97_factor_min", factor_min, prefix);
+   control_.factor_min = factor_min;
+   options.GetIntegerValue("ma97_solve_min", solve_min, prefix);
+   control_.solve_min = solve_min;
+   bool solve_mf;
+   options.GetBoolValue("ma97_solve_mf", solve_mf, prefix);
+   control_.solve_mf = solve_mf ? 1 : 0;
 
    // Set whether we scale on first iteration or not
    switch( switch_[current_level_] )
@@ -370,6 +417,7 @@ bool Ma97SolverInterface::InitializeImpl(
    }
    // Set scaling
    control_.scaling = scaling_type_;
+   scaled_type_ = -1;
 
    return true; // All is well
 }
@@ -386,6 +434,7 @@ ESymSolverStatus Ma97SolverInterface::InitializeStructure(
 
    // Store size for later use
    ndim_ = dim;
+   nonzeros_ = nonzeros;
 
    // Setup memory for values
    if( val_ != NULL )
@@ -394,6 +443,11 @@ ESymSolverStatus Ma97SolverInterface::InitializeStructure(
    }
    val_ = new double[nonzeros];
 
+   // A scaling for a previous structure cannot be reused
+   delete[] scaled_val_;
+   scaled_val_ = NULL;
+   scaled_type_ = -1;
+
    // Check if analyse needs to be postponed
    if( ordering_ == ORDER_MATCHED_AMD || ordering_ == ORDER_MATCHED_METIS )
    {
@@ -518,6 +572,24 @@ ESymSolverStatus Ma97SolverInterface::InitializeStructure(
    }
 }
 
+bool Ma97SolverInterface::ReuseStructure(
+   Index        dim,
+   Index        /*nonzeros*/,
+   const Index* /*ia*/,
+   const Index* /*ja*/
+)
+{
+   // with a matching-based ordering, the analyse phase depends on the values
+   if( akeep_ == NULL || ndim_ != dim || ordering_ == ORDER_MATCHED_AMD || ordering_ == ORDER_MATCHED_METIS )
+   {
+      return false;
+   }
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "HSL_MA97: Reusing analyse of previous matrix\n");
+   return true;
+}
+
 ESymSolverStatus Ma97SolverInterface::MultiSolve(
    bool         new_matrix,
    const Index* ia,
@@ -548,8 +620,16 @@ ESymSolverStatus Ma97SolverInterface::MultiSolve(
       (void) dump_;
 #endif
 
+      // Check whether the scaling of a previous matrix is good enough
+      bool reuse_scaling = rescale_ && CanReuseScaling();
+      if( reuse_scaling )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "HSL_MA97: Reusing scaling of previous matrix\n");
+      }
+
       // Set scaling option
-      if( rescale_ )
+      if( rescale_ && !reuse_scaling )
       {
          control_.scaling = scaling_type_;
          if( scaling_type_ != 0 && scaling_ == NULL )
@@ -562,7 +642,7 @@ ESymSolverStatus Ma97SolverInterface::MultiSolve(
          control_.scaling = 0; // None or user (depends if scaling_ is alloc'd)
       }
 
-      if( (ordering_ == ORDER_MATCHED_AMD || ordering_ == ORDER_MATCHED_METIS) && rescale_ )
+      if( (ordering_ == ORDER_MATCHED_AMD || ordering_ == ORDER_MATCHED_METIS) && rescale_ && !reuse_scaling )
       {
          /*
           * Perform delayed analyse
@@ -632,6 +712,16 @@ ESymSolverStatus Ma97SolverInterface::MultiSolve(
                         "In Ma97SolverInterface::Factorization: Singular system, estimated rank %d of %d\n", info.matrix_rank, ndim_);
          return SYMSOLVER_SINGULAR;
       }
+      if( rescale_tol_ > 0. && rescale_ && !reuse_scaling && scaling_type_ != 0 && info.flag >= 0 )
+      {
+         // Remember the values for which the scaling has been computed
+         if( scaled_val_ == NULL )
+         {
+            scaled_val_ = new double[nonzeros_];
+         }
+         IpBlasDcopy(nonzeros_, val_, 1, scaled_val_, 1);
+         scaled_type_ = scaling_type_;
+      }
       for( int i = current_level_; i < 3; i++ )
       {
          switch( switch_[i] )
@@ -676,6 +766,7 @@ ESymSolverStatus Ma97SolverInterface::MultiSolve(
                   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                                  "HSL_MA97: Enabling scaling %d due to excess delays\n", i);
                   rescale_ = true;
+                  scaled_type_ = -1;
                }
                break;
          }
@@ -722,6 +813,28 @@ ESymSolverStatus Ma97SolverInterface::MultiSolve(
    return SYMSOLVER_SUCCESS;
 }
 
+bool Ma97SolverInterface::CanReuseScaling() const
+{
+   if( rescale_tol_ <= 0. || scaled_type_ != scaling_type_ || scaling_ == NULL || scaled_val_ == NULL )
+   {
+      return false;
+   }
+   // with a matched ordering, the analyse (and the MC64 scaling) needs to be redone
+   if( ordering_ == ORDER_MATCHED_AMD || ordering_ == ORDER_MATCHED_METIS )
+   {
+      return false;
+   }
+
+   for( int i = 0; i < nonzeros_; i++ )
+   {
+      if( std::abs(val_[i] - scaled_val_[i]) > rescale_tol_ * Max(1., std::abs(scaled_val_[i])) )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
 bool Ma97SolverInterface::IncreaseQuality()
 {
    for( int i = current_level_; i < 3; i++ )
@@ -733,6 +846,7 @@ bool Ma97SolverInterface::IncreaseQuality()
          case SWITCH_OD_ND:
          case SWITCH_OD_ND_REUSE:
             rescale_ = true;
+            scaled_type_ = -1;
             current_level_ = i;
             scaling_type_ = scaling_val_[i];
             Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
@@ -758,4 +872,4 @@ bool Ma97SolverInterface::IncreaseQuality()
 
 } // namespace Ipopt
 
-#endif /* COINHSL_HAS_MA97 or IPOPT_HAS_LINEARSOLVERLOADER */
+#endif /* (COINHSL_HAS_MA97 or IPOPT_HAS_LINEARSOLVERLOADER) and not IPOPT_INT64 */
@@ -47,6 +47,7 @@ private:
    };
 
    int ndim_;            ///< Number of dimensions
+   int nonzeros_;        ///< Number of nonzeros
    double* val_;         ///< Storage for variables
    int numneg_;          ///< Number of negative pivots in last factorization
    int numdelay_;        ///< Number of delayed pivots last time we scaled
@@ -55,6 +56,8 @@ private:
    bool pivtol_changed_; ///< indicates if pivtol has been changed
    bool rescale_;        ///< Indicates if we should rescale next factorization
    double* scaling_;     ///< Store scaling for reuse if doing dynamic scaling
+   double* scaled_val_;  ///< Matrix values for which scaling_ has been computed
+   int scaled_type_;     ///< Scaling type of scaling_, -1 if scaling_ is not reusable
    int fctidx_;          ///< Current factorization number to dump to
 
    /* Options */
@@ -66,20 +69,25 @@ private:
    int scaling_val_[3];
    int current_level_;
    bool dump_;
+   double rescale_tol_;
 
 public:
 
    Ma97SolverInterface()
-      : val_(NULL),
+      : nonzeros_(0),
+        val_(NULL),
         numdelay_(0),
         akeep_(NULL),
         fkeep_(NULL),
         pivtol_changed_(false),
         rescale_(false),
         scaling_(NULL),
+        scaled_val_(NULL),
+        scaled_type_(-1),
         fctidx_(0),
         scaling_type_(0),
-        dump_(false)
+        dump_(false),
+        rescale_tol_(0.)
    { }
 
    ~Ma97SolverInterface();
@@ -102,11 +110,23 @@ public:
       const Index* ja
    );
 
+   bool ReuseStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
    double* GetValuesArrayPtr()
    {
       return val_;
    }
 
+   bool PreservesValues() const
+   {
+      return true;
+   }
+
    ESymSolverStatus MultiSolve(
       bool         new_matrix,
       const Index* ia,
@@ -160,6 +180,13 @@ public:
    static int ScaleNameToNum(
       const std::string& name
    );
+
+   /** checks whether the scaling stored in scaling_ can be used for the
+    *  current matrix values, i.e., whether no value has changed relative
+    *  to the values for which the scaling was computed by more than
+    *  ma97_rescale_tol
+    */
+   bool CanReuseScaling() const;
 };
 
 } // namespace Ipopt
@@ -36,9 +36,19 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
 
 namespace Ipopt
 {
+
+/* The index arrays of the KKT matrix are passed to MUMPS without copies,
+ * so MUMPS_INT must have the size of Index.  If Ipopt is configured with
+ * --enable-int64, MUMPS needs to be compiled with 64-bit integers
+ * (-DINTSIZE64).
+ */
+typedef char MumpsIntSizeCheck[sizeof(MUMPS_INT) == sizeof(Index) ? 1 : -1];
 #if IPOPT_VERBOSITY > 0
 static const Index dbg_verbosity = 0;
 #endif
@@ -46,8 +56,110 @@ static const Index dbg_verbosity = 0;
 #define USE_COMM_WORLD -987654
 
 int MumpsSolverInterface::instancecount_mpi = 0;
+bool MumpsSolverInterface::use_mpi_workers = false;
+int MumpsSolverInterface::last_mpi_instance_id = 0;
+
+#ifndef MUMPS_MPI_H
+/** Commands that rank 0 broadcasts to the MPI workers */
+enum MpiWorkerCommand
+{
+   MPI_WORKER_CALL_MUMPS = 1, ///< call MUMPS for the instance and job in the header
+   MPI_WORKER_STOP            ///< leave MpiWorkerLoop
+};
+
+/** Length of the header of a command for the MPI workers: command, instance, job, sym */
+#define MPI_WORKER_HEADER_LEN 4
+
+/** Broadcast the control parameters of a MUMPS instance from rank 0 */
+static void BroadcastMumpsControls(
+   DMUMPS_STRUC_C* mumps_data
+)
+{
+   // MUMPS_INT can be a 64-bit integer, so broadcast the bytes
+   MPI_Bcast(mumps_data->icntl, (int) sizeof(mumps_data->icntl), MPI_BYTE, 0, MPI_COMM_WORLD);
+   MPI_Bcast(mumps_data->cntl, (int) (sizeof(mumps_data->cntl) / sizeof(mumps_data->cntl[0])), MPI_DOUBLE, 0,
+             MPI_COMM_WORLD);
+}
+#endif
+
+bool MumpsSolverInterface::SetUseMpiWorkers(
+   bool use_workers
+)
+{
+#ifndef MUMPS_MPI_H
+   if( use_mpi_workers && !use_workers )
+   {
+      int header[MPI_WORKER_HEADER_LEN] = { MPI_WORKER_STOP, 0, 0, 0 };
+      MPI_Bcast(header, MPI_WORKER_HEADER_LEN, MPI_INT, 0, MPI_COMM_WORLD);
+   }
+   use_mpi_workers = use_workers;
+   return true;
+#else
+   return !use_workers;
+#endif
+}
+
+bool MumpsSolverInterface::MpiWorkerLoop()
+{
+#ifndef MUMPS_MPI_H
+   // MUMPS instances of the workers, by identifier of the instance on rank 0
+   std::map<int, DMUMPS_STRUC_C*> instances;
+   while( true )
+   {
+      int header[MPI_WORKER_HEADER_LEN];
+      MPI_Bcast(header, MPI_WORKER_HEADER_LEN, MPI_INT, 0, MPI_COMM_WORLD);
+      if( header[0] == MPI_WORKER_STOP )
+      {
+         break;
+      }
+      DBG_ASSERT(header[0] == MPI_WORKER_CALL_MUMPS);
+
+      DMUMPS_STRUC_C*& mumps_data = instances[header[1]];
+      if( mumps_data == NULL )
+      {
+         mumps_data = (DMUMPS_STRUC_C*) calloc(1, sizeof(DMUMPS_STRUC_C));
+      }
+      // the matrix and right hand sides are only given on rank 0
+      BroadcastMumpsControls(mumps_data);
+      mumps_data->job = header[2];
+      if( mumps_data->job == -1 )
+      {
+         mumps_data->par = 1;
+         mumps_data->sym = header[3];
+         mumps_data->comm_fortran = USE_COMM_WORLD;
+      }
+      dmumps_c(mumps_data);
+      if( mumps_data->job == -2 )
+      {
+         free(mumps_data);
+         instances.erase(header[1]);
+      }
+   }
+   DBG_ASSERT(instances.empty());
+   return true;
+#else
+   return false;
+#endif
+}
+
+void MumpsSolverInterface::CallMumps()
+{
+   DMUMPS_STRUC_C* mumps_data = (DMUMPS_STRUC_C*) mumps_ptr_;
+#ifndef MUMPS_MPI_H
+   if( use_mpi_workers )
+   {
+      int header[MPI_WORKER_HEADER_LEN] = { MPI_WORKER_CALL_MUMPS, mpi_instance_id_, (int) mumps_data->job, (int) mumps_data->sym };
+      MPI_Bcast(header, MPI_WORKER_HEADER_LEN, MPI_INT, 0, MPI_COMM_WORLD);
+      BroadcastMumpsControls(mumps_data);
+   }
+#endif
+   dmumps_c(mumps_data);
+}
 
 MumpsSolverInterface::MumpsSolverInterface()
+   : mpi_instance_id_(++last_mpi_instance_id),
+     learned_mem_percent_(0),
+     analysis_mem_percent_(0)
 {
    DBG_START_METH("MumpsSolverInterface::MumpsSolverInterface()",
                   dbg_verbosity);
@@ -79,11 +191,11 @@ MumpsSolverInterface::MumpsSolverInterface()
    mumps_->par = 1; //working host for sequential version
    mumps_->sym = 2; //general symetric matrix
    mumps_->comm_fortran = USE_COMM_WORLD;
-   dmumps_c(mumps_);
+   mumps_ptr_ = (void*) mumps_;
+   CallMumps();
    mumps_->icntl[1] = 0;
    mumps_->icntl[2] = 0; //QUIETLY!
    mumps_->icntl[3] = 0;
-   mumps_ptr_ = (void*) mumps_;
 }
 
 MumpsSolverInterface::~MumpsSolverInterface()
@@ -93,7 +205,7 @@ MumpsSolverInterface::~MumpsSolverInterface()
 
    DMUMPS_STRUC_C* mumps_ = (DMUMPS_STRUC_C*) mumps_ptr_;
    mumps_->job = -2; //terminate mumps
-   dmumps_c(mumps_);
+   CallMumps();
 #ifndef MUMPS_MPI_H
 #ifdef HAVE_MPI_INITIALIZED
    if( instancecount_mpi == 1 )
@@ -164,6 +276,30 @@ void MumpsSolverInterface::RegisterOptions(
       "When MUMPS is used to determine linearly dependent constraints, "
       "this is determines the threshold for a pivot to be considered zero. "
       "This is CNTL(3) in MUMPS.");
+   roptions->AddStringOption3(
+      "mumps_out_of_core",
+      "Whether MUMPS stores the factors on disk.",
+      "no",
+      "no", "keep the factors in memory (ICNTL(22)=0)",
+      "yes", "store the factors on disk (ICNTL(22)=1)",
+      "auto", "switch to storing the factors on disk if the working space has been increased "
+      "mumps_ooc_mem_retries times after MUMPS ran out of memory",
+      "An out-of-core factorization allows to factorize matrices whose factors do not fit into memory, "
+      "but the solves become slower. "
+      "This is ICNTL(22) in MUMPS.");
+   roptions->AddStringOption1(
+      "mumps_ooc_tmpdir",
+      "Directory for the files of an out-of-core factorization of MUMPS.",
+      "",
+      "*", "Any existing directory name",
+      "If empty, MUMPS uses the directory in environment variable MUMPS_OOC_TMPDIR, or its default. "
+      "On MPI worker processes, the directory is always taken from MUMPS_OOC_TMPDIR.");
+   roptions->AddLowerBoundedIntegerOption(
+      "mumps_ooc_mem_retries",
+      "Number of working space increases before MUMPS switches to an out-of-core factorization.",
+      0,
+      3,
+      "This is only used if mumps_out_of_core is set to auto.");
 }
 
 bool MumpsSolverInterface::InitializeImpl(
@@ -186,26 +322,56 @@ bool MumpsSolverInterface::InitializeImpl(
 
    // The following option is registered by OrigIpoptNLP
    options.GetBoolValue("warm_start_same_structure", warm_start_same_structure_, prefix);
+   // The following options are registered by TSymLinearSolver
+   options.GetBoolValue("reuse_symbolic_factorization", reuse_symbolic_factorization_, prefix);
+   std::string ordering_cache_dir;
+   options.GetStringValue("ordering_cache_dir", ordering_cache_dir, prefix);
+   ordering_cache_ = new OrderingCache(ordering_cache_dir, "mumps");
 
    options.GetIntegerValue("mumps_permuting_scaling", mumps_permuting_scaling_, prefix);
    options.GetIntegerValue("mumps_pivot_order", mumps_pivot_order_, prefix);
    options.GetIntegerValue("mumps_scaling", mumps_scaling_, prefix);
    options.GetNumericValue("mumps_dep_tol", mumps_dep_tol_, prefix);
+   Index enum_int;
+   options.GetEnumValue("mumps_out_of_core", enum_int, prefix);
+   mumps_out_of_core_ = MumpsOutOfCore(enum_int);
+   options.GetIntegerValue("mumps_ooc_mem_retries", mumps_ooc_mem_retries_, prefix);
+   std::string ooc_tmpdir;
+   options.GetStringValue("mumps_ooc_tmpdir", ooc_tmpdir, prefix);
+   // The following option is registered by PDFullSpaceSolver
+   options.GetBoolValue("linear_solver_backward_error", compute_backward_error_, prefix);
+   // The following option is registered by TSymLinearSolver
+   Index num_threads;
+   options.GetIntegerValue("linear_solver_num_threads", num_threads, prefix);
 
    // Reset all private data
    initialized_ = false;
    pivtol_changed_ = false;
    refactorize_ = false;
-   have_symbolic_factorization_ = false;
+   backward_error_ = 0.;
 
    DMUMPS_STRUC_C* mumps_ = (DMUMPS_STRUC_C*) mumps_ptr_;
+   mumps_->icntl[21] = mumps_out_of_core_ == OOC_YES ? 1 : 0;
+   mumps_->icntl[15] = num_threads; // number of OpenMP threads, 0 for the default
+   if( !ooc_tmpdir.empty() )
+   {
+      ASSERT_EXCEPTION(ooc_tmpdir.size() < sizeof(mumps_->ooc_tmpdir), OPTION_INVALID,
+                       "Option \"mumps_ooc_tmpdir\": The directory name is too long for MUMPS.");
+      strcpy(mumps_->ooc_tmpdir, ooc_tmpdir.c_str());
+   }
    if( !warm_start_same_structure_ )
    {
-      mumps_->n = 0;
-      mumps_->nz = 0;
+      // keep the symbolic factorization if it might be reused
+      if( !reuse_symbolic_factorization_ )
+      {
+         have_symbolic_factorization_ = false;
+         mumps_->n = 0;
+         mumps_->nz = 0;
+      }
    }
    else
    {
+      have_symbolic_factorization_ = false;
       ASSERT_EXCEPTION(mumps_->n > 0 && mumps_->nz > 0, INVALID_WARMSTART,
                        "MumpsSolverInterface called with warm_start_same_structure, but the problem is solved for the first time.");
    }
@@ -291,17 +457,17 @@ void dump_matrix(
    // Dump the matrix
    for (int i = 0; i < 40; i++)
    {
-      printf("%d\n", mumps_data->icntl[i]);
+      printf("%" IPOPT_INDEX_FORMAT "\n", mumps_data->icntl[i]);
    }
    for (int i = 0; i < 5; i++)
    {
       printf("%25.15e\n", mumps_data->cntl[i]);
    }
-   printf("%-15d :N\n", mumps_data->n);
-   printf("%-15d :NZ", mumps_data->nz);
+   printf("%-15" IPOPT_INDEX_FORMAT " :N\n", mumps_data->n);
+   printf("%-15" IPOPT_INDEX_FORMAT " :NZ", mumps_data->nz);
    for (int i = 0; i < mumps_data->nz; i++)
    {
-      printf("\n%d %d %25.15e", mumps_data->irn[i], mumps_data->jcn[i], mumps_data->a[i]);
+      printf("\n%" IPOPT_INDEX_FORMAT " %" IPOPT_INDEX_FORMAT " %25.15e", mumps_data->irn[i], mumps_data->jcn[i], mumps_data->a[i]);
    }
    printf("       :values");
    // Dummy RHS for now
@@ -334,8 +500,8 @@ ESymSolverStatus MumpsSolverInterface::InitializeStructure(
       mumps_->a = NULL;
 
       mumps_->a = new double[nonzeros];
-      mumps_->irn = const_cast<int*>(ia);
-      mumps_->jcn = const_cast<int*>(ja);
+      mumps_->irn = const_cast<MUMPS_INT*>(ia);
+      mumps_->jcn = const_cast<MUMPS_INT*>(ja);
 
       // make sure we do the symbolic factorization before a real
       // factorization
@@ -351,6 +517,28 @@ ESymSolverStatus MumpsSolverInterface::InitializeStructure(
    return retval;
 }
 
+bool MumpsSolverInterface::ReuseStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* ia,
+   const Index* ja
+)
+{
+   DMUMPS_STRUC_C* mumps_ = (DMUMPS_STRUC_C*) mumps_ptr_;
+   DBG_START_METH("MumpsSolverInterface::ReuseStructure", dbg_verbosity);
+
+   if( !have_symbolic_factorization_ || mumps_->n != dim || mumps_->nz != nonzeros )
+   {
+      return false;
+   }
+
+   mumps_->irn = const_cast<MUMPS_INT*>(ia);
+   mumps_->jcn = const_cast<MUMPS_INT*>(ja);
+
+   initialized_ = true;
+   return true;
+}
+
 ESymSolverStatus MumpsSolverInterface::SymbolicFactorization()
 {
    DBG_START_METH("MumpsSolverInterface::SymbolicFactorization",
@@ -368,29 +556,62 @@ ESymSolverStatus MumpsSolverInterface::SymbolicFactorization()
    //mumps_data->icntl[2] = 6;//QUIETLY!
    //mumps_data->icntl[3] = 4;
 
+   // Use the pivot order from the ordering cache, if available
+   std::vector<MUMPS_INT> perm_in;
+   bool have_cached_ordering = false;
+   if( ordering_cache_->IsActive() )
+   {
+      ordering_cache_->SetStructure(mumps_data->n, mumps_data->nz, mumps_data->irn, mumps_data->jcn);
+      perm_in.resize(mumps_data->n);
+      have_cached_ordering = ordering_cache_->LoadOrdering(&perm_in[0]);
+      if( have_cached_ordering )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Using pivot order from file %s.\n", ordering_cache_->FileName().c_str());
+      }
+   }
+
    mumps_data->icntl[5] = mumps_permuting_scaling_;
-   mumps_data->icntl[6] = mumps_pivot_order_;
+   if( have_cached_ordering )
+   {
+      mumps_data->icntl[6] = 1;   // user-given pivot order in perm_in
+      mumps_data->perm_in = &perm_in[0];
+   }
+   else
+   {
+      mumps_data->icntl[6] = mumps_pivot_order_;
+   }
    mumps_data->icntl[7] = mumps_scaling_;
    mumps_data->icntl[9] = 0;   //no iterative refinement iterations
 
    mumps_data->icntl[12] = 1;   //avoid lapack bug, ensures proper inertia; mentioned to be very expensive in mumps manual
-   mumps_data->icntl[13] = mem_percent_; //% memory to allocate over expected
+   mumps_data->icntl[13] = Max(mem_percent_, learned_mem_percent_); //% memory to allocate over expected
+   analysis_mem_percent_ = mumps_data->icntl[13];
    mumps_data->cntl[0] = pivtol_;  // Set pivot tolerance
 
    dump_matrix(mumps_data);
 
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Calling MUMPS-1 for symbolic factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
-   dmumps_c(mumps_data);
+   CallMumps();
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Done with MUMPS-1 for symbolic factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
+   mumps_data->perm_in = NULL;
    int error = mumps_data->info[0];
+
+   // SYM_PERM holds the position of each variable in the pivot order
+   if( error >= 0 && ordering_cache_->IsActive() && !have_cached_ordering
+       && !ordering_cache_->StoreOrdering(mumps_data->sym_perm) )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "Could not write pivot order to file %s.\n", ordering_cache_->FileName().c_str());
+   }
    const int& mumps_permuting_scaling_used = mumps_data->infog[22];
    const int& mumps_pivot_order_used = mumps_data->infog[6];
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
                   "MUMPS used permuting_scaling %d and pivot_order %d.\n", mumps_permuting_scaling_used, mumps_pivot_order_used);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "           scaling will be %d.\n", mumps_data->icntl[7]);
+                  "           scaling will be %" IPOPT_INDEX_FORMAT ".\n", mumps_data->icntl[7]);
 
    if( HaveIpData() )
    {
@@ -427,7 +648,7 @@ ESymSolverStatus MumpsSolverInterface::Factorization(
    dump_matrix(mumps_data);
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Calling MUMPS-2 for numerical factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
-   dmumps_c(mumps_data);
+   CallMumps();
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Done with MUMPS-2 for numerical factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
    int error = mumps_data->info[0];
@@ -440,18 +661,13 @@ ESymSolverStatus MumpsSolverInterface::Factorization(
       {
          Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
                         "MUMPS returned INFO(1) = %d and requires more memory, reallocating.  Attempt %d\n", error, trycount + 1);
-         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                        "  Increasing icntl[13] from %d to ", mumps_data->icntl[13]);
-         double mem_percent = mumps_data->icntl[13];
-         mumps_data->icntl[13] = (Index) (2.0 * mem_percent);
-         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                        "%d.\n", mumps_data->icntl[13]);
+         IncreaseMemory(error, trycount);
 
          dump_matrix(mumps_data);
          Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                         "Calling MUMPS-2 (repeated) for numerical factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(),
                         WallclockTime());
-         dmumps_c(mumps_data);
+         CallMumps();
          Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                         "Done with MUMPS-2 (repeated) for numerical factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(),
                         WallclockTime());
@@ -467,12 +683,14 @@ ESymSolverStatus MumpsSolverInterface::Factorization(
                         "MUMPS was not able to obtain enough memory.\n");
          return SYMSOLVER_FATAL_ERROR;
       }
+      // start later factorizations with the working space that was sufficient
+      learned_mem_percent_ = Max(learned_mem_percent_, (Index) mumps_data->icntl[13]);
    }
 
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of doubles for MUMPS to hold factorization (INFO(9)) = %d\n", mumps_data->info[8]);
+                  "Number of doubles for MUMPS to hold factorization (INFO(9)) = %" IPOPT_INDEX_FORMAT "\n", mumps_data->info[8]);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of integers for MUMPS to hold factorization (INFO(10)) = %d\n", mumps_data->info[9]);
+                  "Number of integers for MUMPS to hold factorization (INFO(10)) = %" IPOPT_INDEX_FORMAT "\n", mumps_data->info[9]);
 
    if( error == -10 )  //system is singular
    {
@@ -486,7 +704,7 @@ ESymSolverStatus MumpsSolverInterface::Factorization(
    if( error == -13 )
    {
       Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                     "MUMPS returned INFO(1) =%d - out of memory when trying to allocate %d %s.\nIn some cases it helps to decrease the value of the option \"mumps_mem_percent\".\n",
+                     "MUMPS returned INFO(1) =%d - out of memory when trying to allocate %" IPOPT_INDEX_FORMAT " %s.\nIn some cases it helps to decrease the value of the option \"mumps_mem_percent\".\n",
                      error, mumps_data->info[1] < 0 ? -mumps_data->info[1] : mumps_data->info[1],
                      mumps_data->info[1] < 0 ? "MB" : "bytes");
       return SYMSOLVER_FATAL_ERROR;
@@ -501,7 +719,7 @@ ESymSolverStatus MumpsSolverInterface::Factorization(
    if( check_NegEVals && (numberOfNegEVals != negevals_) )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "In MumpsSolverInterface::Factorization: negevals_ = %d, but numberOfNegEVals = %d\n", negevals_,
+                     "In MumpsSolverInterface::Factorization: negevals_ = %" IPOPT_INDEX_FORMAT ", but numberOfNegEVals = %" IPOPT_INDEX_FORMAT "\n", negevals_,
                      numberOfNegEVals);
       return SYMSOLVER_WRONG_INERTIA;
    }
@@ -509,6 +727,42 @@ ESymSolverStatus MumpsSolverInterface::Factorization(
    return SYMSOLVER_SUCCESS;
 }
 
+void MumpsSolverInterface::IncreaseMemory(
+   int   error,
+   Index trycount
+)
+{
+   DMUMPS_STRUC_C* mumps_data = (DMUMPS_STRUC_C*) mumps_ptr_;
+
+   if( mumps_out_of_core_ == OOC_AUTO && mumps_data->icntl[21] == 0 && trycount >= mumps_ooc_mem_retries_ )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "  Switching to out-of-core factorization.\n");
+      mumps_data->icntl[21] = 1;
+      return;
+   }
+
+   Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                  "  Increasing icntl[13] from %" IPOPT_INDEX_FORMAT " to ", mumps_data->icntl[13]);
+   double mem_percent = mumps_data->icntl[13];
+   double new_mem_percent = 2.0 * mem_percent;
+   // For a too small real workspace, INFO(2) is the number of missing
+   // entries (in millions if negative), and INFOG(16) is the estimated
+   // memory in MB of the analysis, which increased the workspace by
+   // analysis_mem_percent_.  Add twice the missing memory relative to it.
+   const int& missing = mumps_data->info[1];
+   const int& estimated_mb = mumps_data->infog[15];
+   if( error == -9 && missing != 0 && estimated_mb > 0 )
+   {
+      double missing_mb = missing > 0 ? missing * (sizeof(double) / 1e6) : -missing * (double) sizeof(double);
+      double base_mb = estimated_mb / (1.0 + analysis_mem_percent_ / 100.0);
+      new_mem_percent = mem_percent + Max(1.0, 200.0 * missing_mb / base_mb);
+   }
+   mumps_data->icntl[13] = (Index) Min(new_mem_percent, 1e9);
+   Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                  "%" IPOPT_INDEX_FORMAT ".\n", mumps_data->icntl[13]);
+}
+
 ESymSolverStatus MumpsSolverInterface::Solve(
    Index   nrhs,
    double* rhs_vals
@@ -521,6 +775,9 @@ ESymSolverStatus MumpsSolverInterface::Solve(
    {
       IpData().TimingStats().LinearSystemBackSolve().Start();
    }
+   // only the main statistics of the error analysis, without condition numbers
+   mumps_data->icntl[10] = compute_backward_error_ ? 2 : 0;
+   backward_error_ = 0.;
    for( Index i = 0; i < nrhs; i++ )
    {
       Index offset = i * mumps_data->n;
@@ -528,7 +785,7 @@ ESymSolverStatus MumpsSolverInterface::Solve(
       mumps_data->job = 3;  //solve
       Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                      "Calling MUMPS-3 for solve at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
-      dmumps_c(mumps_data);
+      CallMumps();
       Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                      "Done with MUMPS-3 for solve at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
       int error = mumps_data->info[0];
@@ -538,6 +795,10 @@ ESymSolverStatus MumpsSolverInterface::Solve(
                         "Error=%d returned from MUMPS in Solve.\n", error);
          retval = SYMSOLVER_FATAL_ERROR;
       }
+      else if( compute_backward_error_ )
+      {
+         backward_error_ = Max(backward_error_, (Number) mumps_data->rinfog[6]);
+      }
    }
    if( HaveIpData() )
    {
@@ -546,6 +807,46 @@ ESymSolverStatus MumpsSolverInterface::Solve(
    return retval;
 }
 
+Number MumpsSolverInterface::BackwardError() const
+{
+   DBG_ASSERT(compute_backward_error_);
+   return backward_error_;
+}
+
+bool MumpsSolverInterface::EstimateFactorization(
+   Number& factor_nonzeros,
+   Number& flops,
+   Number& memory
+)
+{
+   DBG_START_METH("MumpsSolverInterface::EstimateFactorization", dbg_verbosity);
+   DMUMPS_STRUC_C* mumps_data = (DMUMPS_STRUC_C*) mumps_ptr_;
+
+   // Do the symbolic factorization if it hasn't been done yet; as in
+   // DetermineDependentRows, the permuting scaling is switched off,
+   // since it would need the values of the matrix
+   if( !have_symbolic_factorization_ )
+   {
+      const Index mumps_permuting_scaling_orig = mumps_permuting_scaling_;
+      mumps_permuting_scaling_ = 0;
+      ESymSolverStatus retval = SymbolicFactorization();
+      mumps_permuting_scaling_ = mumps_permuting_scaling_orig;
+      if( retval != SYMSOLVER_SUCCESS )
+      {
+         return false;
+      }
+      have_symbolic_factorization_ = true;
+   }
+
+   // INFOG(20) is given in millions if it is negative
+   const int& nnz_factors = mumps_data->infog[19];
+   factor_nonzeros = nnz_factors >= 0 ? (Number) nnz_factors : -1e6 * nnz_factors;
+   flops = mumps_data->rinfog[0];
+   // INFOG(17) is the total memory in millions of bytes
+   memory = 1e6 * mumps_data->infog[16];
+   return true;
+}
+
 Index MumpsSolverInterface::NumberOfNegEVals() const
 {
    DBG_START_METH("MumpsSolverInterface::NumberOfNegEVals", dbg_verbosity);
@@ -615,7 +916,7 @@ ESymSolverStatus MumpsSolverInterface::DetermineDependentRows(
    mumps_data->job = 2;   //numerical factorization
 
    dump_matrix(mumps_data);
-   dmumps_c(mumps_data);
+   CallMumps();
    int error = mumps_data->info[0];
 
    //Check for errors
@@ -626,15 +927,10 @@ ESymSolverStatus MumpsSolverInterface::DetermineDependentRows(
       {
          Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
                         "MUMPS returned INFO(1) = %d and requires more memory, reallocating.  Attempt %d\n", error, trycount + 1);
-         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                        "  Increasing icntl[13] from %d to ", mumps_data->icntl[13]);
-         double mem_percent = mumps_data->icntl[13];
-         mumps_data->icntl[13] = (Index) (2.0 * mem_percent);
-         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                        "%d.\n", mumps_data->icntl[13]);
+         IncreaseMemory(error, trycount);
 
          dump_matrix(mumps_data);
-         dmumps_c(mumps_data);
+         CallMumps();
          error = mumps_data->info[0];
          if( error != -8 && error != -9 )
          {
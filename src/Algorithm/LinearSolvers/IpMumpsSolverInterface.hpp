@@ -14,6 +14,7 @@
 #define __IPMUMPSSOLVERINTERFACE_HPP__
 
 #include "IpSparseSymLinearSolverInterface.hpp"
+#include "IpOrderingCache.hpp"
 
 namespace Ipopt
 {
@@ -47,6 +48,13 @@ public:
       const Index* ajcn
    );
 
+   virtual bool ReuseStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
    virtual double* GetValuesArrayPtr();
 
    virtual ESymSolverStatus MultiSolve(
@@ -71,6 +79,19 @@ public:
       return true;
    }
 
+   virtual bool ProvidesBackwardError() const
+   {
+      return compute_backward_error_;
+   }
+
+   virtual Number BackwardError() const;
+
+   virtual bool EstimateFactorization(
+      Number& factor_nonzeros,
+      Number& flops,
+      Number& memory
+   );
+
    EMatrixFormat MatrixFormat() const
    {
       return Triplet_Format;
@@ -89,6 +110,37 @@ public:
       std::list<Index>& c_deps
    );
 
+   /** @name Distributed-memory factorization with MPI
+    *
+    *  With a parallel MUMPS, every process of MPI_COMM_WORLD takes part
+    *  in the factorization.  By default, this requires that every process
+    *  runs Ipopt.  Alternatively, Ipopt runs on rank 0 only, which calls
+    *  SetUseMpiWorkers(true) before the first MumpsSolverInterface is
+    *  created, while all other ranks call MpiWorkerLoop().  The MUMPS
+    *  calls on rank 0 are then broadcast to the workers, which execute
+    *  them with their own MUMPS instances.  The matrix and right hand
+    *  sides remain on rank 0 (centralized input), while the factors are
+    *  distributed over all processes.
+    */
+   ///@{
+   /** Set whether the MUMPS calls are to be executed by MPI workers.
+    *
+    *  To be called on rank 0 when no MumpsSolverInterface object exists.
+    *  Switching the workers off makes MpiWorkerLoop() return on the other
+    *  ranks.  Returns false if MUMPS has not been built with MPI and
+    *  use_workers is true.
+    */
+   static bool SetUseMpiWorkers(
+      bool use_workers
+   );
+
+   /** Execute the MUMPS calls of rank 0 until SetUseMpiWorkers(false) is called there.
+    *
+    *  Returns false if MUMPS has not been built with MPI.
+    */
+   static bool MpiWorkerLoop();
+   ///@}
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -119,6 +171,9 @@ private:
    ///@{
    /** Number of negative eigenvalues */
    Index negevals_;
+   /** Largest componentwise backward error of the solutions in the
+    *  most recent solve */
+   Number backward_error_;
    ///@}
 
    /** @name Initialization flags */
@@ -141,6 +196,12 @@ private:
     * When the last object is destroyed, we will call MPI_Finalize.
     */
    static int instancecount_mpi;
+   /** Whether the MUMPS calls are broadcast to MPI workers */
+   static bool use_mpi_workers;
+   /** Identifier assigned to the most recently created Mumps interface object */
+   static int last_mpi_instance_id;
+   /** Identifier of this object for the MPI workers */
+   int mpi_instance_id_;
    ///@}
 
    /** @name Solver specific data/options */
@@ -154,6 +215,16 @@ private:
    /** Percent increase in memory */
    Index mem_percent_;
 
+   /** Percent increase in memory that a factorization needed before.
+    *
+    *  This is kept for the lifetime of this object, so that later
+    *  factorizations, also in a reoptimization, start with it.
+    */
+   Index learned_mem_percent_;
+
+   /** Percent increase in memory at the last symbolic factorization */
+   Index analysis_mem_percent_;
+
    /** Permutation and scaling method in MUMPS */
    Index mumps_permuting_scaling_;
 
@@ -166,10 +237,32 @@ private:
    /** Threshold in MUMPS to state that a constraint is linearly dependent */
    Number mumps_dep_tol_;
 
+   /** Type for the use of the out-of-core facility of MUMPS */
+   enum MumpsOutOfCore
+   {
+      OOC_NO,
+      OOC_YES,
+      OOC_AUTO
+   };
+   /** Whether the factors are stored on disk */
+   MumpsOutOfCore mumps_out_of_core_;
+
+   /** Number of memory increases before switching to out-of-core automatically */
+   Index mumps_ooc_mem_retries_;
+
    /** Flag indicating whether the TNLP with identical structure has
     *  already been solved before.
     */
    bool warm_start_same_structure_;
+   /** Flag indicating whether the symbolic factorization is to be
+    *  kept for a reoptimization with identical structure.
+    */
+   bool reuse_symbolic_factorization_;
+   /** Flag indicating whether MUMPS computes the backward error of
+    *  the solutions (error analysis with ICNTL(11)). */
+   bool compute_backward_error_;
+   /** Cache for the orderings computed in the analysis phase */
+   SmartPtr<OrderingCache> ordering_cache_;
    ///@}
 
    /** Flag indicating if symbolic factorization has already been called */
@@ -177,6 +270,11 @@ private:
 
    /** @name Internal functions */
    ///@{
+   /** Call MUMPS for the job set in the MUMPS data structure,
+    *  on all MPI workers if they are used.
+    */
+   void CallMumps();
+
    /** Call MUMPS (job=1) to perform symbolic manipulations, and reserve
     *  memory.
     */
@@ -191,6 +289,18 @@ private:
       Index numberOfNegEVals
    );
 
+   /** Prepare the repetition of a factorization after MUMPS ran out of memory.
+    *
+    *  Increases the working space by the amount that MUMPS reported to
+    *  be missing, or switches to an out-of-core factorization if this is
+    *  allowed and the working space has been increased
+    *  mumps_ooc_mem_retries_ times already.
+    */
+   void IncreaseMemory(
+      int   error,
+      Index trycount
+   );
+
    /** Call MUMPS (job=3) to do the solve. */
    ESymSolverStatus Solve(
       Index   nrhs,
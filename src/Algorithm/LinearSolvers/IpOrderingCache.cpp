@@ -0,0 +1,191 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpOrderingCache.hpp"
+#include "IpDebug.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#include <sys/stat.h>
+#elif defined(_WIN32)
+#include <process.h>
+#endif
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+/** Identification of the files written by OrderingCache */
+static const char* ordering_file_magic = "ipopt-ordering";
+
+OrderingCache::OrderingCache(
+   const std::string& directory,
+   const std::string& solver_name
+)
+   : directory_(directory),
+     solver_name_(solver_name),
+     dim_(0),
+     nonzeros_(0),
+     hash_(0)
+{ }
+
+OrderingCache::~OrderingCache()
+{ }
+
+void OrderingCache::SetStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* ia,
+   const Index* ja
+)
+{
+   DBG_START_METH("OrderingCache::SetStructure", dbg_verbosity);
+
+   dim_ = dim;
+   nonzeros_ = nonzeros;
+
+   unsigned int hash = HashBytes(&dim, sizeof(Index));
+   hash = HashBytes(&nonzeros, sizeof(Index), hash);
+   hash = HashBytes(ia, nonzeros * sizeof(Index), hash);
+   hash = HashBytes(ja, nonzeros * sizeof(Index), hash);
+   hash_ = hash;
+
+   if( IsActive() )
+   {
+      char buffer[64];
+      Snprintf(buffer, 63, "_%" IPOPT_INDEX_FORMAT "_%" IPOPT_INDEX_FORMAT "_%08x.ord", dim_, nonzeros_, hash_);
+      filename_ = directory_ + "/" + solver_name_ + buffer;
+   }
+}
+
+bool OrderingCache::LoadOrdering(
+   Index* perm
+) const
+{
+   DBG_START_METH("OrderingCache::LoadOrdering", dbg_verbosity);
+
+   if( !IsActive() || dim_ <= 0 )
+   {
+      return false;
+   }
+
+   FILE* fp = fopen(filename_.c_str(), "r");
+   if( fp == NULL )
+   {
+      return false;
+   }
+
+   char magic[32];
+   Index dim;
+   Index nonzeros;
+   unsigned int hash;
+   bool ok = (fscanf(fp, "%31s %" IPOPT_INDEX_FORMAT " %" IPOPT_INDEX_FORMAT " %x", magic, &dim, &nonzeros, &hash) == 4)
+             && std::string(magic) == ordering_file_magic && dim == dim_ && nonzeros == nonzeros_ && hash == hash_;
+
+   // check that we read a permutation of 1..dim
+   std::vector<bool> seen(dim_, false);
+   for( Index i = 0; ok && i < dim_; i++ )
+   {
+      Index pos;
+      ok = (fscanf(fp, "%" IPOPT_INDEX_FORMAT, &pos) == 1) && pos >= 1 && pos <= dim_ && !seen[pos - 1];
+      if( ok )
+      {
+         seen[pos - 1] = true;
+         perm[i] = pos;
+      }
+   }
+   fclose(fp);
+
+   return ok;
+}
+
+bool OrderingCache::StoreOrdering(
+   const Index* perm
+) const
+{
+   DBG_START_METH("OrderingCache::StoreOrdering", dbg_verbosity);
+
+   if( !IsActive() || dim_ <= 0 )
+   {
+      return false;
+   }
+
+   // only store valid permutations
+   std::vector<bool> seen(dim_, false);
+   for( Index i = 0; i < dim_; i++ )
+   {
+      if( perm[i] < 1 || perm[i] > dim_ || seen[perm[i] - 1] )
+      {
+         return false;
+      }
+      seen[perm[i] - 1] = true;
+   }
+
+   // write to a temporary file in the same directory first, so that other
+   // processes never see an incomplete file; its name is unique, so that
+   // concurrent writers of the same ordering do not mix their output
+#ifdef HAVE_UNISTD_H
+   std::vector<char> tmpbuf(filename_.begin(), filename_.end());
+   static const char tmpsuffix[] = ".tmpXXXXXX";
+   tmpbuf.insert(tmpbuf.end(), tmpsuffix, tmpsuffix + sizeof(tmpsuffix));
+   int fd = mkstemp(&tmpbuf[0]);
+   if( fd < 0 )
+   {
+      return false;
+   }
+   std::string tmpname(&tmpbuf[0]);
+   // mkstemp creates the file readable only by the user, but the cache
+   // may be shared with other users
+   (void) fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+   FILE* fp = fdopen(fd, "w");
+   if( fp == NULL )
+   {
+      close(fd);
+      remove(tmpname.c_str());
+      return false;
+   }
+#else
+   // without mkstemp, the process id and the address of this object
+   // distinguish the writers
+   char tmpsuffix[64];
+#ifdef _WIN32
+   Snprintf(tmpsuffix, sizeof(tmpsuffix), ".tmp%d_%p", _getpid(), (const void*) this);
+#else
+   Snprintf(tmpsuffix, sizeof(tmpsuffix), ".tmp%p", (const void*) this);
+#endif
+   std::string tmpname = filename_ + tmpsuffix;
+   FILE* fp = fopen(tmpname.c_str(), "w");
+   if( fp == NULL )
+   {
+      return false;
+   }
+#endif
+
+   bool ok = fprintf(fp, "%s %" IPOPT_INDEX_FORMAT " %" IPOPT_INDEX_FORMAT " %08x\n", ordering_file_magic, dim_, nonzeros_, hash_) > 0;
+   for( Index i = 0; ok && i < dim_; i++ )
+   {
+      ok = fprintf(fp, "%" IPOPT_INDEX_FORMAT "\n", perm[i]) > 0;
+   }
+   ok = (fclose(fp) == 0) && ok;
+
+   if( ok )
+   {
+      ok = (rename(tmpname.c_str(), filename_.c_str()) == 0);
+   }
+   if( !ok )
+   {
+      remove(tmpname.c_str());
+   }
+
+   return ok;
+}
+
+} // namespace Ipopt
@@ -0,0 +1,138 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPORDERINGCACHE_HPP__
+#define __IPORDERINGCACHE_HPP__
+
+#include "IpUtils.hpp"
+#include "IpReferenced.hpp"
+
+#include <string>
+
+namespace Ipopt
+{
+
+/** Class for storing fill-reducing orderings of linear solvers on disk.
+ *
+ *  The ordering computed by a linear solver for a matrix is stored in a
+ *  file in a user-specified directory.  The name of the file is derived
+ *  from the name of the linear solver and a hash of the dimension and
+ *  nonzero structure of the matrix, so that a later run (e.g., in a
+ *  different process) for a matrix with the same structure can load the
+ *  ordering and pass it to the linear solver instead of computing it
+ *  again.
+ *
+ *  The ordering is given as an array perm of length dim, where perm[i]
+ *  (with values between 1 and dim) is the position of variable i in the
+ *  pivot order.  Any permutation is a valid pivot order, so a hash
+ *  collision may only lead to a bad ordering, but not to wrong results.
+ */
+class OrderingCache: public ReferencedObject
+{
+public:
+   /** @name Constructor/Destructor */
+   ///@{
+   /** Constructor.
+    *
+    *  If directory is empty, the cache is disabled.
+    */
+   OrderingCache(
+      const std::string& directory,
+      const std::string& solver_name
+   );
+
+   virtual ~OrderingCache();
+   ///@}
+
+   /** Whether the cache is enabled. */
+   bool IsActive() const
+   {
+      return !directory_.empty();
+   }
+
+   /** Set the structure of the matrix for which orderings are loaded and stored.
+    *
+    *  The positions of the nonzero elements are given by ia and ja in
+    *  triplet format.
+    */
+   void SetStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* ia,
+      const Index* ja
+   );
+
+   /** Load the ordering for the current structure.
+    *
+    *  @return true if an ordering has been found and stored in perm,
+    *  which must have space for dim entries.
+    */
+   bool LoadOrdering(
+      Index* perm
+   ) const;
+
+   /** Store the ordering for the current structure.
+    *
+    *  @return false if the ordering could not be written.
+    */
+   bool StoreOrdering(
+      const Index* perm
+   ) const;
+
+   /** Name of the file for the current structure. */
+   const std::string& FileName() const
+   {
+      return filename_;
+   }
+
+   /** Hash of the current structure. */
+   unsigned int Hash() const
+   {
+      return hash_;
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   OrderingCache();
+
+   /** Copy Constructor */
+   OrderingCache(
+      const OrderingCache&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const OrderingCache&
+   );
+   ///@}
+
+   /** Directory in which the orderings are stored */
+   std::string directory_;
+   /** Name of the linear solver, used as prefix for the file names */
+   std::string solver_name_;
+
+   /** @name Information about the current structure */
+   ///@{
+   Index dim_;
+   Index nonzeros_;
+   /** Hash of the structure */
+   unsigned int hash_;
+   /** Name of the file for the current structure */
+   std::string filename_;
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
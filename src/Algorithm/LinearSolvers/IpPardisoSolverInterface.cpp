@@ -20,6 +20,10 @@
 #include <cstdlib>
 #include <cstring>
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 // determine the correct name of the Pardiso function
 #ifndef IPOPT_HAS_PARDISO
 // if we build for the Linear Solver loader, then use normal C-naming style
@@ -67,6 +71,12 @@ extern "C"
       double*       DPARM
    );
 
+#ifdef IPOPT_HAS_PARDISO_MKL
+   int mkl_set_num_threads_local(
+      int nt
+   );
+#endif
+
 #ifdef PARDISO_MATCHING_PREPROCESS
    void IPOPT_PARDISO_FUNC(smat_reordering_pardiso_wsmp, SMAT_REORDERING_PARDISO_WSMP)(
       const ipfint* N,
@@ -90,8 +100,65 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Sets the number of threads of MKL for the calling thread while
+ *  Pardiso is called, if it is given by the option pardiso_num_threads.
+ *
+ *  For Pardiso from pardiso-project.org, the number of threads is
+ *  passed in IPARM(3) instead.
+ */
+class PardisoThreads
+{
+public:
+   PardisoThreads(
+      Index num_threads
+   )
+      : num_threads_(num_threads),
+        saved_num_threads_(0)
+   {
+#ifdef IPOPT_HAS_PARDISO_MKL
+      if( num_threads_ > 0 )
+      {
+         saved_num_threads_ = mkl_set_num_threads_local(num_threads_);
+      }
+#endif
+   }
+
+   ~PardisoThreads()
+   {
+#ifdef IPOPT_HAS_PARDISO_MKL
+      if( num_threads_ > 0 )
+      {
+         // 0 restores the global setting of MKL
+         mkl_set_num_threads_local(saved_num_threads_);
+      }
+#endif
+   }
+
+private:
+   Index num_threads_;
+   int saved_num_threads_;
+};
+
+#ifdef IPOPT_HAS_PARDISO_MKL
+/** Size of the physical memory in MB, or 0 if it cannot be determined */
+static Number PhysicalMemoryMB()
+{
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+   long pages = sysconf(_SC_PHYS_PAGES);
+   long pagesize = sysconf(_SC_PAGESIZE);
+   if( pages > 0 && pagesize > 0 )
+   {
+      return (Number) pages * (Number) pagesize / (1024. * 1024.);
+   }
+#endif
+   return 0.;
+}
+#endif
+
 PardisoSolverInterface::PardisoSolverInterface()
    : a_(NULL),
+     a_factor_(NULL),
+     have_factorization_(false),
 #ifdef PARDISO_MATCHING_PREPROCESS
      ia2(NULL),
      ja2(NULL),
@@ -137,6 +204,7 @@ PardisoSolverInterface::~PardisoSolverInterface()
    delete[] IPARM_;
    delete[] DPARM_;
    delete[] a_;
+   delete[] a_factor_;
 
 #ifdef PARDISO_MATCHING_PREPROCESS
    delete[] ia2;
@@ -173,14 +241,29 @@ void PardisoSolverInterface::RegisterOptions(
       "no",
       "no", "Don't assume that matrix is singular if elements were perturbed after recent symbolic factorization",
       "yes", "Assume that matrix is singular if elements were perturbed after recent symbolic factorization");
-   //roptions->AddLowerBoundedIntegerOption(
-   //  "pardiso_out_of_core_power",
-   //  "Enables out-of-core variant of Pardiso",
-   //  0, 0,
-   //  "Setting this option to a positive integer k makes Pardiso work in the "
-   //  "out-of-core variant where the factor is split in 2^k subdomains.  This "
-   //  "is IPARM(50) in the Pardiso manual.  This option is only available if "
-   //  "Ipopt has been compiled with Pardiso.");
+#ifdef IPOPT_HAS_PARDISO_MKL
+   roptions->AddStringOption3(
+      "pardiso_out_of_core",
+      "Whether MKL Pardiso stores the factors on disk.",
+      "no",
+      "no", "keep the factors in memory (IPARM(60)=0)",
+      "yes", "store the factors on disk (IPARM(60)=2)",
+      "auto", "switch to storing the factors on disk if the memory estimated by the analysis phase "
+      "exceeds pardiso_max_memory or if Pardiso ran out of memory in the factorization",
+      "An out-of-core factorization allows to factorize matrices whose factors do not fit into memory, "
+      "but the factorization and the solves become slower. "
+      "The location of the files is given by the environment variable MKL_PARDISO_OOC_PATH. "
+      "This is IPARM(60) in the MKL Pardiso documentation.");
+   roptions->AddLowerBoundedNumberOption(
+      "pardiso_max_memory",
+      "Memory budget in MB for an in-core factorization of MKL Pardiso.",
+      0.0, false,
+      0.0,
+      "This is only used if pardiso_out_of_core is set to auto. "
+      "If the peak memory of the in-core factorization and solves that is estimated by the analysis phase "
+      "(max(IPARM(15), IPARM(16)+IPARM(17))) exceeds this value, the analysis is repeated for an out-of-core factorization. "
+      "The value 0 stands for the size of the physical memory, if it can be determined, and for no limit otherwise.");
+#endif
    roptions->AddLowerBoundedIntegerOption(
       "pardiso_msglvl",
       "Pardiso message level",
@@ -216,6 +299,36 @@ void PardisoSolverInterface::RegisterOptions(
       "If negative, the accumulation of the residue uses extended precision real and complex data types. "
       "Perturbed pivots result in iterative refinement. "
       "The solver automatically performs two steps of iterative refinements when perturbed pivots are obtained during the numerical factorization and this option is set to 0.");
+   roptions->AddLowerBoundedNumberOption(
+      "pardiso_reuse_factor_max_shift",
+      "Largest diagonal shift for which the previous factorization is tried.",
+      0.0, false,
+      0.0,
+      "If positive and no inertia is required for a new matrix that differs from the most recently factorized one "
+      "only in the diagonal elements, and by at most this value, then the system is first solved with the previous "
+      "factorization and iterative refinement w.r.t. the new matrix. "
+      "A new numerical factorization is done only if the residual ratio does not reach residual_ratio_max. "
+      "This is useful for the inertia-free regularization of the primal-dual system (neg_curv_test_tol > 0). "
+      "The default 0 disables this.");
+   roptions->AddLowerBoundedIntegerOption(
+      "pardiso_reuse_factor_max_refinement_steps",
+      "Maximal number of refinement steps with the previous factorization.",
+      1,
+      10,
+      "This limits the iterative refinement steps when solving with the previous factorization, "
+      "see pardiso_reuse_factor_max_shift.");
+   roptions->AddLowerBoundedIntegerOption(
+      "pardiso_num_threads",
+      "Number of threads of Pardiso.",
+      0,
+      0,
+      "If positive, Pardiso uses this number of threads for the factorization and the solves, "
+      "regardless of linear_solver_num_threads and the environment variable OMP_NUM_THREADS. "
+      "Since every thread of the parallel factorization needs its own working space, "
+      "fewer threads can reduce the memory that is needed for very large matrices. "
+      "For MKL Pardiso, the number of threads of MKL is set during the calls of Pardiso; "
+      "otherwise, this is IPARM(3) in the Pardiso manual. "
+      "The value 0 keeps the number of threads from linear_solver_num_threads or OMP_NUM_THREADS.");
 #ifdef IPOPT_HAS_PARDISO_MKL
    roptions->AddStringOption4(
       "pardiso_order",
@@ -317,19 +430,33 @@ bool PardisoSolverInterface::InitializeImpl(
                         pardiso_redo_symbolic_fact_only_if_inertia_wrong_, prefix);
    options.GetBoolValue("pardiso_repeated_perturbation_means_singular", pardiso_repeated_perturbation_means_singular_,
                         prefix);
-   //Index pardiso_out_of_core_power;
-   //options.GetIntegerValue("pardiso_out_of_core_power",
-   //                        pardiso_out_of_core_power, prefix);
+#ifdef IPOPT_HAS_PARDISO_MKL
+   options.GetEnumValue("pardiso_out_of_core", enum_int, prefix);
+   out_of_core_ = PardisoOutOfCore(enum_int);
+   options.GetNumericValue("pardiso_max_memory", max_memory_, prefix);
+   if( max_memory_ == 0. )
+   {
+      max_memory_ = PhysicalMemoryMB();
+   }
+#else
+   out_of_core_ = OOC_NO;
+   max_memory_ = 0.;
+#endif
+   options.GetIntegerValue("pardiso_num_threads", num_threads_, prefix);
    options.GetBoolValue("pardiso_skip_inertia_check", skip_inertia_check_, prefix);
-   int pardiso_msglvl;
+   Index pardiso_msglvl;
    options.GetIntegerValue("pardiso_msglvl", pardiso_msglvl, prefix);
-   int max_iterref_steps;
+   Index max_iterref_steps;
    options.GetIntegerValue("pardiso_max_iterative_refinement_steps", max_iterref_steps, prefix);
-   int order;
+   Index order;
    options.GetEnumValue("pardiso_order", order, prefix);
+   options.GetNumericValue("pardiso_reuse_factor_max_shift", reuse_factor_max_shift_, prefix);
+   options.GetIntegerValue("pardiso_reuse_factor_max_refinement_steps", reuse_factor_max_refinement_steps_, prefix);
+   // The following option is registered by PDFullSpaceSolver
+   options.GetNumericValue("residual_ratio_max", residual_ratio_max_, prefix);
 #ifndef IPOPT_HAS_PARDISO_MKL
    options.GetBoolValue("pardiso_iterative", pardiso_iterative_, prefix);
-   int pardiso_max_iter;
+   Index pardiso_max_iter;
    options.GetIntegerValue("pardiso_max_iter", pardiso_max_iter, prefix);
    Number pardiso_iter_relative_tol;
    options.GetNumericValue("pardiso_iter_relative_tol", pardiso_iter_relative_tol, prefix);
@@ -373,6 +500,9 @@ bool PardisoSolverInterface::InitializeImpl(
    initialized_ = false;
    delete[] a_;
    a_ = NULL;
+   delete[] a_factor_;
+   a_factor_ = NULL;
+   have_factorization_ = false;
 
 #ifdef PARDISO_MATCHING_PREPROCESS
    delete[] ia2;
@@ -409,9 +539,24 @@ bool PardisoSolverInterface::InitializeImpl(
 
    int num_procs = 1;
 #if defined(IPOPT_HAS_PARDISO_PARALLEL) || ! defined(IPOPT_HAS_PARDISO)
+   // The following option is registered by TSymLinearSolver
+   Index num_threads;
+   options.GetIntegerValue("linear_solver_num_threads", num_threads, prefix);
    // Obtain the numbers of processors from the value of OMP_NUM_THREADS
    char* var = getenv("OMP_NUM_THREADS");
-   if( var != NULL )
+   if( num_threads_ > 0 )
+   {
+      num_procs = num_threads_;
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Using pardiso_num_threads = %d as the number of processors for PARDISO.\n", num_procs);
+   }
+   else if( num_threads > 0 )
+   {
+      num_procs = num_threads;
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Using linear_solver_num_threads = %d as the number of processors for PARDISO.\n", num_procs);
+   }
+   else if( var != NULL )
    {
       sscanf(var, "%d", &num_procs);
       if( num_procs < 1 )
@@ -471,11 +616,11 @@ bool PardisoSolverInterface::InitializeImpl(
 #endif
 
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Pardiso matrix ordering     (IPARM(2)): %d\n", IPARM_[1]);
+                  "Pardiso matrix ordering     (IPARM(2)): %" IPOPT_INDEX_FORMAT "\n", IPARM_[1]);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Pardiso max. iterref. steps (IPARM(8)): %d\n", IPARM_[7]);
+                  "Pardiso max. iterref. steps (IPARM(8)): %" IPOPT_INDEX_FORMAT "\n", IPARM_[7]);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Pardiso matching strategy  (IPARM(13)): %d\n", IPARM_[12]);
+                  "Pardiso matching strategy  (IPARM(13)): %" IPOPT_INDEX_FORMAT "\n", IPARM_[12]);
 
    if( pardiso_iterative_ )
    {
@@ -522,8 +667,11 @@ bool PardisoSolverInterface::InitializeImpl(
 
    MSGLVL_ = pardiso_msglvl;
 
-   // Option for the out of core variant
-   //IPARM_[49] = pardiso_out_of_core_power;
+#ifdef IPOPT_HAS_PARDISO_MKL
+   // Option for the out of core variant; for auto, this is changed
+   // after the analysis phase if the factors would not fit into memory
+   IPARM_[59] = out_of_core_ == OOC_YES ? 2 : 0;
+#endif
 
    return true;
 }
@@ -545,9 +693,27 @@ ESymSolverStatus PardisoSolverInterface::MultiSolve(
    // check if a factorization has to be done
    if( new_matrix )
    {
+      // if only the diagonal has been shifted slightly and no inertia
+      // is required, the previous factorization might still be good enough
+      if( !check_NegEVals && IsSmallDiagonalShift(ia, ja) && SolveWithPreviousFactor(ia, ja, nrhs, rhs_vals) )
+      {
+         return SYMSOLVER_SUCCESS;
+      }
+
       // perform the factorization
       ESymSolverStatus retval;
       retval = Factorization(ia, ja, check_NegEVals, numberOfNegEVals);
+      if( a_factor_ != NULL )
+      {
+         have_factorization_ = (retval == SYMSOLVER_SUCCESS || retval == SYMSOLVER_WRONG_INERTIA);
+         if( have_factorization_ )
+         {
+            for( Index i = 0; i < nonzeros_; i++ )
+            {
+               a_factor_[i] = a_[i];
+            }
+         }
+      }
       if( retval != SYMSOLVER_SUCCESS )
       {
          DBG_PRINT((1, "FACTORIZATION FAILED!\n"));
@@ -582,6 +748,14 @@ ESymSolverStatus PardisoSolverInterface::InitializeStructure(
    a_ = NULL;
    a_ = new double[nonzeros_];
 
+   delete[] a_factor_;
+   a_factor_ = NULL;
+   have_factorization_ = false;
+   if( reuse_factor_max_shift_ > 0. && !pardiso_iterative_ )
+   {
+      a_factor_ = new double[nonzeros_];
+   }
+
    // Do the symbolic facotrization
    ESymSolverStatus retval = SymbolicFactorization(ia, ja);
    if( retval != SYMSOLVER_SUCCESS )
@@ -649,15 +823,15 @@ void write_iajaa_matrix(
       mat_file = fopen(mat_name, "w");
 
       fprintf(mat_file, "%d\n", N);
-      fprintf(mat_file, "%d\n", NNZ);
+      fprintf(mat_file, "%" IPOPT_INDEX_FORMAT "\n", NNZ);
 
       for( i = 0; i < N + 1; i++ )
       {
-         fprintf(mat_file, "%d\n", ia[i]);
+         fprintf(mat_file, "%" IPOPT_INDEX_FORMAT "\n", ia[i]);
       }
       for( i = 0; i < NNZ; i++ )
       {
-         fprintf(mat_file, "%d\n", ja[i]);
+         fprintf(mat_file, "%" IPOPT_INDEX_FORMAT "\n", ja[i]);
       }
       for( i = 0; i < NNZ; i++ )
       {
@@ -701,7 +875,7 @@ void write_iajaa_matrix(
       for( i = 0; i < N; i++ )
          for( j = ia[i]; j < ia[i + 1] - 1; j++ )
          {
-            fprintf(mat_file, " %d %d %32.24e \n", i + 1, ja[j - 1], a_[j - 1]);
+            fprintf(mat_file, " %" IPOPT_INDEX_FORMAT " %" IPOPT_INDEX_FORMAT " %32.24e \n", i + 1, ja[j - 1], a_[j - 1]);
          }
 
       fclose(mat_file);
@@ -731,6 +905,8 @@ ESymSolverStatus PardisoSolverInterface::Factorization(
    bool done = false;
    bool just_performed_symbolic_factorization = false;
 
+   PardisoThreads threads(num_threads_);
+
    while( !done )
    {
       if( !have_symbolic_factorization_ )
@@ -786,24 +962,41 @@ ESymSolverStatus PardisoSolverInterface::Factorization(
          if( ERROR == -7 )
          {
             Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
-                           "Pardiso symbolic factorization returns ERROR = %d.  Matrix is singular.\n", ERROR);
+                           "Pardiso symbolic factorization returns ERROR = %" IPOPT_INDEX_FORMAT ".  Matrix is singular.\n", ERROR);
             return SYMSOLVER_SINGULAR;
          }
          else if( ERROR != 0 )
          {
             Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                           "Error in Pardiso during symbolic factorization phase.  ERROR = %d.\n", ERROR);
+                           "Error in Pardiso during symbolic factorization phase.  ERROR = %" IPOPT_INDEX_FORMAT ".\n", ERROR);
             return SYMSOLVER_FATAL_ERROR;
          }
          have_symbolic_factorization_ = true;
          just_performed_symbolic_factorization = true;
 
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "Memory in KB required for the symbolic factorization  = %d.\n", IPARM_[14]);
+                        "Memory in KB required for the symbolic factorization  = %" IPOPT_INDEX_FORMAT ".\n", IPARM_[14]);
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "Integer memory in KB required for the numerical factorization  = %d.\n", IPARM_[15]);
+                        "Integer memory in KB required for the numerical factorization  = %" IPOPT_INDEX_FORMAT ".\n", IPARM_[15]);
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "Double  memory in KB required for the numerical factorization  = %d.\n", IPARM_[16]);
+                        "Double  memory in KB required for the numerical factorization  = %" IPOPT_INDEX_FORMAT ".\n", IPARM_[16]);
+
+#ifdef IPOPT_HAS_PARDISO_MKL
+         if( out_of_core_ == OOC_AUTO && IPARM_[59] == 0 && max_memory_ > 0. )
+         {
+            // peak memory of the in-core factorization and solves
+            Number estimated_mb = Max(IPARM_[14], IPARM_[15] + IPARM_[16]) / 1024.;
+            if( estimated_mb > max_memory_ )
+            {
+               Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                              "Estimated memory for the Pardiso factorization (%.0f MB) exceeds pardiso_max_memory (%.0f MB).\n"
+                              "  Switching to out-of-core factorization.\n", estimated_mb, max_memory_);
+               IPARM_[59] = 2;
+               have_symbolic_factorization_ = false;
+               continue;
+            }
+         }
+#endif
       }
 
       PHASE = 22;
@@ -851,7 +1044,7 @@ ESymSolverStatus PardisoSolverInterface::Factorization(
       if( ERROR == -7 )
       {
          Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
-                        "Pardiso factorization returns ERROR = %d.  Matrix is singular.\n", ERROR);
+                        "Pardiso factorization returns ERROR = %" IPOPT_INDEX_FORMAT ".  Matrix is singular.\n", ERROR);
          return SYMSOLVER_SINGULAR;
       }
       else if( ERROR == -4 )
@@ -860,10 +1053,21 @@ ESymSolverStatus PardisoSolverInterface::Factorization(
          // OLAF said that this will never happen (ToDo)
          return SYMSOLVER_SINGULAR;
       }
+#ifdef IPOPT_HAS_PARDISO_MKL
+      else if( ERROR == -2 && out_of_core_ == OOC_AUTO && IPARM_[59] == 0 )
+      {
+         Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                        "Pardiso ran out of memory during factorization.\n"
+                        "  Switching to out-of-core factorization.\n");
+         IPARM_[59] = 2;
+         have_symbolic_factorization_ = false;
+         continue;
+      }
+#endif
       else if( ERROR != 0 )
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Error in Pardiso during factorization phase.  ERROR = %d.\n", ERROR);
+                        "Error in Pardiso during factorization phase.  ERROR = %" IPOPT_INDEX_FORMAT ".\n", ERROR);
          return SYMSOLVER_FATAL_ERROR;
       }
 
@@ -871,7 +1075,7 @@ ESymSolverStatus PardisoSolverInterface::Factorization(
       if( IPARM_[13] != 0 )
       {
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "Number of perturbed pivots in factorization phase = %d.\n", IPARM_[13]);
+                        "Number of perturbed pivots in factorization phase = %" IPOPT_INDEX_FORMAT ".\n", IPARM_[13]);
          if( !pardiso_redo_symbolic_fact_only_if_inertia_wrong_ || (negevals_ != numberOfNegEVals) )
          {
             if( HaveIpData() )
@@ -930,7 +1134,7 @@ ESymSolverStatus PardisoSolverInterface::Factorization(
    if( check_NegEVals && (numberOfNegEVals != negevals_) )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "Wrong inertia: required are %d, but we got %d.\n", numberOfNegEVals, negevals_);
+                     "Wrong inertia: required are %" IPOPT_INDEX_FORMAT ", but we got %" IPOPT_INDEX_FORMAT ".\n", numberOfNegEVals, negevals_);
       return SYMSOLVER_WRONG_INERTIA;
    }
 
@@ -979,6 +1183,8 @@ ESymSolverStatus PardisoSolverInterface::Solve(
    write_iajaa_matrix(N, ia, ja, a_, rhs_vals, iter_count, debug_cnt_);
 #endif
 
+   PardisoThreads threads(num_threads_);
+
    int attempts = 0;
    const int max_attempts = pardiso_iterative_ ? pardiso_max_droptol_corrections_ + 1 : 1;
 
@@ -1015,7 +1221,7 @@ ESymSolverStatus PardisoSolverInterface::Solve(
       if( ERROR <= -100 && ERROR >= -102 )
       {
          Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
-                        "Iterative solver in Pardiso did not converge (ERROR = %d)\n", ERROR);
+                        "Iterative solver in Pardiso did not converge (ERROR = %" IPOPT_INDEX_FORMAT ")\n", ERROR);
          Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
                         "  Decreasing drop tolerances from DPARM_[4] = %e and DPARM_[5] = %e\n", DPARM_[4], DPARM_[5]);
          PHASE = 23;
@@ -1039,7 +1245,7 @@ ESymSolverStatus PardisoSolverInterface::Solve(
    if( IPARM_[6] != 0 )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "Number of iterative refinement steps = %d.\n", IPARM_[6]);
+                     "Number of iterative refinement steps = %" IPOPT_INDEX_FORMAT ".\n", IPARM_[6]);
       if( HaveIpData() )
       {
          IpData().Append_info_string("Pi");
@@ -1053,12 +1259,157 @@ ESymSolverStatus PardisoSolverInterface::Solve(
    if( ERROR != 0 )
    {
       Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                     "Error in Pardiso during solve phase.  ERROR = %d.\n", ERROR);
+                     "Error in Pardiso during solve phase.  ERROR = %" IPOPT_INDEX_FORMAT ".\n", ERROR);
       return SYMSOLVER_FATAL_ERROR;
    }
    return SYMSOLVER_SUCCESS;
 }
 
+bool PardisoSolverInterface::IsSmallDiagonalShift(
+   const Index* ia,
+   const Index* ja
+) const
+{
+   if( !have_factorization_ )
+   {
+      return false;
+   }
+
+   for( Index i = 0; i < dim_; i++ )
+   {
+      for( Index k = ia[i] - 1; k < ia[i + 1] - 1; k++ )
+      {
+         if( ja[k] - 1 == i )
+         {
+            if( std::abs(a_[k] - a_factor_[k]) > reuse_factor_max_shift_ )
+            {
+               return false;
+            }
+         }
+         else if( a_[k] != a_factor_[k] )
+         {
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+bool PardisoSolverInterface::SolveWithPreviousFactor(
+   const Index* ia,
+   const Index* ja,
+   Index        nrhs,
+   double*      rhs_vals
+)
+{
+   DBG_START_METH("PardisoSolverInterface::SolveWithPreviousFactor", dbg_verbosity);
+
+   const Index len = nrhs * dim_;
+   double* orig_rhs = new double[len];
+   double* resid = new double[len];
+   for( Index i = 0; i < len; i++ )
+   {
+      orig_rhs[i] = rhs_vals[i];
+   }
+
+   bool accepted = false;
+   for( Index step = 0; ; step++ )
+   {
+      // the first solve gives the initial solution, later ones the corrections
+      if( step == 0 )
+      {
+         if( Solve(ia, ja, nrhs, rhs_vals) != SYMSOLVER_SUCCESS )
+         {
+            break;
+         }
+      }
+      else
+      {
+         if( Solve(ia, ja, nrhs, resid) != SYMSOLVER_SUCCESS )
+         {
+            break;
+         }
+         for( Index i = 0; i < len; i++ )
+         {
+            rhs_vals[i] += resid[i];
+         }
+      }
+
+      // compute the residuals w.r.t. the current matrix, of which only
+      // the upper triangle is stored
+      Number resid_ratio = 0.;
+      for( Index irhs = 0; irhs < nrhs; irhs++ )
+      {
+         const double* x = rhs_vals + irhs * dim_;
+         const double* b = orig_rhs + irhs * dim_;
+         double* r = resid + irhs * dim_;
+         for( Index i = 0; i < dim_; i++ )
+         {
+            r[i] = b[i];
+         }
+         for( Index i = 0; i < dim_; i++ )
+         {
+            for( Index k = ia[i] - 1; k < ia[i + 1] - 1; k++ )
+            {
+               const Index j = ja[k] - 1;
+               r[i] -= a_[k] * x[j];
+               if( j != i )
+               {
+                  r[j] -= a_[k] * x[i];
+               }
+            }
+         }
+
+         Number nrm_r = 0.;
+         Number nrm_x = 0.;
+         Number nrm_b = 0.;
+         for( Index i = 0; i < dim_; i++ )
+         {
+            nrm_r = Max(nrm_r, std::abs(r[i]));
+            nrm_x = Max(nrm_x, std::abs(x[i]));
+            nrm_b = Max(nrm_b, std::abs(b[i]));
+         }
+         if( nrm_x + nrm_b > 0. )
+         {
+            resid_ratio = Max(resid_ratio, nrm_r / (nrm_x + nrm_b));
+         }
+      }
+
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Residual ratio with previous Pardiso factorization after %" IPOPT_INDEX_FORMAT " refinement steps: %e\n", step, resid_ratio);
+      if( resid_ratio <= residual_ratio_max_ )
+      {
+         accepted = true;
+         break;
+      }
+      if( step >= reuse_factor_max_refinement_steps_ )
+      {
+         break;
+      }
+   }
+
+   if( accepted )
+   {
+      if( HaveIpData() )
+      {
+         IpData().Append_info_string("Pr");
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < len; i++ )
+      {
+         rhs_vals[i] = orig_rhs[i];
+      }
+   }
+
+   delete[] orig_rhs;
+   delete[] resid;
+
+   return accepted;
+}
+
 Index PardisoSolverInterface::NumberOfNegEVals() const
 {
    DBG_START_METH("PardisoSolverInterface::NumberOfNegEVals", dbg_verbosity);
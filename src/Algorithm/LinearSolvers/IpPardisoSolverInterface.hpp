@@ -45,6 +45,11 @@ public:
 
    virtual double* GetValuesArrayPtr();
 
+   virtual bool PreservesValues() const
+   {
+      return true;
+   }
+
    virtual ESymSolverStatus MultiSolve(
       bool         new_matrix,
       const Index* ia,
@@ -106,6 +111,18 @@ private:
 
    /** Array for storing the values of the matrix. */
    double* a_;
+
+   /** Array for storing the values of the matrix at the most recent
+    *  numerical factorization.
+    *
+    *  Only allocated if the previous factorization may be reused
+    *  for diagonally shifted matrices.
+    */
+   double* a_factor_;
+
+   /** Flag indicating whether a_factor_ holds the values of the
+    *  current numerical factorization. */
+   bool have_factorization_;
    ///@}
 
 #ifdef PARDISO_MATCHING_PREPROCESS
@@ -153,6 +170,26 @@ private:
    bool pardiso_iterative_;
    /** Maximal number of decreases of drop tolerance during one solve. */
    Index pardiso_max_droptol_corrections_;
+   /** Largest change of a diagonal element for which the previous
+    *  factorization is tried before refactorizing (0 disables this). */
+   Number reuse_factor_max_shift_;
+   /** Maximal number of refinement steps with the previous factorization. */
+   Index reuse_factor_max_refinement_steps_;
+   /** Residual ratio at which a solution with the previous factorization is accepted. */
+   Number residual_ratio_max_;
+   /** Type for the use of the out-of-core mode of MKL Pardiso */
+   enum PardisoOutOfCore
+   {
+      OOC_NO,
+      OOC_YES,
+      OOC_AUTO
+   };
+   /** Whether the factors are stored on disk */
+   PardisoOutOfCore out_of_core_;
+   /** Memory budget in MB for an in-core factorization, 0 for no limit */
+   Number max_memory_;
+   /** Number of threads of Pardiso, 0 if not set */
+   Index num_threads_;
    ///@}
 
    /** @name Initialization flags */
@@ -212,6 +249,26 @@ private:
       Index        nrhs,
       double*      rhs_vals
    );
+
+   /** Check whether the current matrix differs from the factorized one
+    *  only by a small shift of the diagonal elements. */
+   bool IsSmallDiagonalShift(
+      const Index* ia,
+      const Index* ja
+   ) const;
+
+   /** Solve with the previous factorization and iterative refinement
+    *  w.r.t. the current matrix.
+    *
+    *  Returns false, with the right-hand sides restored, if the
+    *  residual could not be reduced sufficiently.
+    */
+   bool SolveWithPreviousFactor(
+      const Index* ia,
+      const Index* ja,
+      Index        nrhs,
+      double*      rhs_vals
+   );
    ///@}
 };
 
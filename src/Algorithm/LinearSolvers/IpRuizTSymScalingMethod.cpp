@@ -0,0 +1,191 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpRuizTSymScalingMethod.hpp"
+
+#include <cmath>
+
+namespace Ipopt
+{
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+void RuizTSymScalingMethod::RegisterOptions(
+   SmartPtr<RegisteredOptions> roptions
+)
+{
+   roptions->AddLowerBoundedIntegerOption(
+      "linear_scaling_ruiz_max_iter",
+      "Maximal number of iterations of the Ruiz equilibration.",
+      0,
+      10,
+      "This is only used if linear_system_scaling is set to ruiz.");
+   roptions->AddLowerBoundedNumberOption(
+      "linear_scaling_ruiz_tol",
+      "Tolerance for the Ruiz equilibration.",
+      0., true,
+      1e-1,
+      "The equilibration stops if the maximal absolute value in each nonzero row of the scaled matrix "
+      "deviates from one by at most this value. "
+      "This is only used if linear_system_scaling is set to ruiz.");
+   roptions->AddLowerBoundedIntegerOption(
+      "linear_scaling_ruiz_num_threads",
+      "Number of threads for the Ruiz equilibration.",
+      1,
+      1,
+      "The rows of the matrix are processed in parallel if Ipopt has been compiled with OpenMP support. "
+      "This is only used if linear_system_scaling is set to ruiz.");
+}
+
+bool RuizTSymScalingMethod::InitializeImpl(
+   const OptionsList& options,
+   const std::string& prefix
+)
+{
+   options.GetIntegerValue("linear_scaling_ruiz_max_iter", max_iter_, prefix);
+   options.GetNumericValue("linear_scaling_ruiz_tol", tol_, prefix);
+   options.GetIntegerValue("linear_scaling_ruiz_num_threads", num_threads_, prefix);
+
+   // the structure of the matrix may change after a reinitialization
+   dim_ = -1;
+   nnz_ = -1;
+
+   return true;
+}
+
+bool RuizTSymScalingMethod::ComputeSymTScalingFactors(
+   Index         n,
+   Index         nnz,
+   const ipfint* airn,
+   const ipfint* ajcn,
+   const double* a,
+   double*       scaling_factors
+)
+{
+   DBG_START_METH("RuizTSymScalingMethod::ComputeSymTScalingFactors",
+                  dbg_verbosity);
+
+   if( n != dim_ || nnz != nnz_ )
+   {
+      // Set up the row-wise index of the entries; the structure does
+      // not change between calls
+      row_start_.assign(n + 1, 0);
+      for( Index i = 0; i < nnz; i++ )
+      {
+         row_start_[airn[i]]++;
+         if( airn[i] != ajcn[i] )
+         {
+            row_start_[ajcn[i]]++;
+         }
+      }
+      for( Index i = 0; i < n; i++ )
+      {
+         row_start_[i + 1] += row_start_[i];
+      }
+      std::vector<Index> next(row_start_.begin(), row_start_.end() - 1);
+      csr_col_.resize(row_start_[n]);
+      csr_pos_.resize(row_start_[n]);
+      for( Index i = 0; i < nnz; i++ )
+      {
+         Index r = airn[i] - 1;
+         Index c = ajcn[i] - 1;
+         csr_col_[next[r]] = c;
+         csr_pos_[next[r]++] = i;
+         if( r != c )
+         {
+            csr_col_[next[c]] = r;
+            csr_pos_[next[c]++] = i;
+         }
+      }
+      dim_ = n;
+      nnz_ = nnz;
+   }
+
+   const Index* row_start = &row_start_[0];
+   const Index* csr_col = csr_col_.empty() ? NULL : &csr_col_[0];
+   const Index* csr_pos = csr_pos_.empty() ? NULL : &csr_pos_[0];
+
+   std::vector<Number> row_max(n);
+   for( Index i = 0; i < n; i++ )
+   {
+      scaling_factors[i] = 1.;
+   }
+
+   Index iter;
+   for( iter = 0; iter < max_iter_; iter++ )
+   {
+      // Maximal absolute values in the rows of the scaled matrix
+      Number dev = 0.;
+#ifdef _OPENMP
+      #pragma omp parallel for num_threads(ParallelSectionThreads(num_threads_)) schedule(static) reduction(max:dev)
+#endif
+      for( Index i = 0; i < n; i++ )
+      {
+         Number rmax = 0.;
+         for( Index k = row_start[i]; k < row_start[i + 1]; k++ )
+         {
+            rmax = Max(rmax, std::abs(a[csr_pos[k]]) * scaling_factors[csr_col[k]]);
+         }
+         rmax *= scaling_factors[i];
+         row_max[i] = rmax;
+         if( rmax > 0. )
+         {
+            dev = Max(dev, std::abs(1. - rmax));
+         }
+      }
+      DBG_PRINT((1, "iter %d: max deviation of row maxima from one: %e\n", iter, dev));
+      if( dev <= tol_ )
+      {
+         break;
+      }
+
+#ifdef _OPENMP
+      #pragma omp parallel for num_threads(ParallelSectionThreads(num_threads_)) schedule(static)
+#endif
+      for( Index i = 0; i < n; i++ )
+      {
+         if( row_max[i] > 0. )
+         {
+            scaling_factors[i] /= std::sqrt(row_max[i]);
+         }
+      }
+   }
+
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Ruiz equilibration of the linear system took %" IPOPT_INDEX_FORMAT " iterations.\n", iter);
+
+   // If some of the entries are too large or tiny, the scaling factors
+   // are unusable; return no scaling in that case
+   Number sum = 0.;
+   Number smax = 0.;
+   for( Index i = 0; i < n; i++ )
+   {
+      sum += scaling_factors[i];
+      smax = Max(smax, scaling_factors[i]);
+   }
+   if( !IsFiniteNumber(sum) || smax > 1e40 )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "Scaling factors are invalid - setting them all to 1.\n");
+      for( Index i = 0; i < n; i++ )
+      {
+         scaling_factors[i] = 1.;
+      }
+   }
+
+   if( DBG_VERBOSITY() >= 2 )
+   {
+      for( Index i = 0; i < n; i++ )
+      {
+         DBG_PRINT((2, "scaling_factors[%5d] = %23.15e\n",
+                    i, scaling_factors[i]));
+      }
+   }
+
+   return true;
+}
+
+} // namespace Ipopt
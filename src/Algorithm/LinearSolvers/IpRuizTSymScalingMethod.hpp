@@ -0,0 +1,112 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPRUIZTSYMSCALINGMETHOD_HPP__
+#define __IPRUIZTSYMSCALINGMETHOD_HPP__
+
+#include "IpUtils.hpp"
+#include "IpTSymScalingMethod.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+/** Class for the method for computing scaling factors for symmetric
+ *  matrices in triplet format, using the equilibration by Ruiz.
+ *
+ *  The scaling factors \f$d\f$ are updated repeatedly by
+ *  \f$d_i \leftarrow d_i / \sqrt{\max_j |d_i a_{ij} d_j|}\f$, until the
+ *  maximal absolute value in each row of the scaled matrix is close to
+ *  one.  The matrix is accessed through a row-wise index of the
+ *  triplet entries, which is set up once for the sparsity structure, so
+ *  that the rows can be processed in parallel.  This does not require
+ *  HSL.
+ */
+class RuizTSymScalingMethod: public TSymScalingMethod
+{
+public:
+   /** @name Constructor/Destructor */
+   ///@{
+   RuizTSymScalingMethod()
+      : dim_(-1),
+        nnz_(-1)
+   { }
+
+   virtual ~RuizTSymScalingMethod()
+   { }
+   ///@}
+
+   virtual bool InitializeImpl(
+      const OptionsList& options,
+      const std::string& prefix
+   );
+
+   /** Method for computing the symmetric scaling factors, given the
+    *  symmetric matrix in triplet (MA27) format.
+    */
+   virtual bool ComputeSymTScalingFactors(
+      Index         n,
+      Index         nnz,
+      const ipfint* airn,
+      const ipfint* ajcn,
+      const double* a,
+      double*       scaling_factors
+   );
+
+   /** Methods for IpoptType */
+   ///@{
+   static void RegisterOptions(
+      SmartPtr<RegisteredOptions> roptions
+   );
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods (Hidden to avoid
+    * implicit creation/calling).  These methods are not implemented
+    * and we do not want the compiler to implement them for us, so we
+    * declare them private and do not define them. This ensures that
+    * they will not be implicitly created/called. */
+   ///@{
+   /** Copy Constructor */
+   RuizTSymScalingMethod(
+      const RuizTSymScalingMethod&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const RuizTSymScalingMethod&
+   );
+   ///@}
+
+   /** @name Algorithmic parameters */
+   ///@{
+   /** Maximal number of equilibration iterations */
+   Index max_iter_;
+   /** Tolerance for the deviation of the row maxima from one */
+   Number tol_;
+   /** Number of threads */
+   Index num_threads_;
+   ///@}
+
+   /** @name Row-wise index of the triplet entries.
+    *
+    *  Row i consists of the entries csr_pos_[k] of the triplet arrays
+    *  with columns csr_col_[k] for row_start_[i] <= k < row_start_[i+1];
+    *  off-diagonal entries appear in both of their rows.
+    */
+   ///@{
+   /** Dimension of the matrix for which the index has been set up */
+   Index dim_;
+   /** Number of triplet entries for which the index has been set up */
+   Index nnz_;
+   std::vector<Index> row_start_;
+   std::vector<Index> csr_col_;
+   std::vector<Index> csr_pos_;
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
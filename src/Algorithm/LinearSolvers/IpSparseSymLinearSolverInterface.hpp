@@ -141,6 +141,29 @@ public:
       const Index* ja
    ) = 0;
 
+   /** Method for keeping the internal structures of a previous matrix.
+    *
+    *  This is called instead of InitializeStructure after a
+    *  re-initialization (e.g., by IpoptApplication::ReOptimizeTNLP)
+    *  if option reuse_symbolic_factorization is enabled and the
+    *  nonzero structure of the matrix is identical to the one given
+    *  in the last call of InitializeStructure.  The arrays ia and ja
+    *  contain the same structure as in that call, but may be stored
+    *  at a different location.
+    *
+    *  An implementation can keep its symbolic factorization in this
+    *  case.  If false is returned, InitializeStructure is called.
+    */
+   virtual bool ReuseStructure(
+      Index        /*dim*/,
+      Index        /*nonzeros*/,
+      const Index* /*ia*/,
+      const Index* /*ja*/
+   )
+   {
+      return false;
+   }
+
    /** Method returning an internal array into which the nonzero
     *  elements (in the same order as ja) will be stored by the
     *  calling routine before a call to MultiSolve with a
@@ -152,6 +175,18 @@ public:
     */
    virtual double* GetValuesArrayPtr() = 0;
 
+   /** Query whether the values in the array returned by
+    *  GetValuesArrayPtr are left unchanged by MultiSolve.
+    *
+    *  If true, the calling routine may only overwrite the values that
+    *  have changed before the next call of MultiSolve with
+    *  new_matrix=true.  Otherwise, all values are written again.
+    */
+   virtual bool PreservesValues() const
+   {
+      return false;
+   }
+
    /** Solve operation for multiple right hand sides.
     *
     *  Solves the linear system A * x = b with multiple right hand sides,
@@ -223,6 +258,49 @@ public:
     */
    virtual bool ProvidesInertia() const = 0;
 
+   /** Query whether the backward error of the solutions is computed
+    *  by the linear solver.
+    *
+    *  @return true, if BackwardError can be called after MultiSolve
+    */
+   virtual bool ProvidesBackwardError() const
+   {
+      return false;
+   }
+
+   /** Componentwise backward error of the solutions of the most
+    *  recent call of MultiSolve (the maximum over all right hand
+    *  sides).
+    *
+    *  This must not be called if the linear solver does not compute
+    *  this quantity (see ProvidesBackwardError).
+    */
+   virtual Number BackwardError() const
+   {
+      return -1.;
+   }
+
+   /** Predicted size and cost of the factorization of the matrix
+    *  whose structure has been given to InitializeStructure.
+    *
+    *  factor_nonzeros is the number of entries in the factors, flops
+    *  the number of floating point operations of one factorization,
+    *  and memory the number of bytes that the solver needs for it.
+    *  A solver that does the symbolic analysis only with the first
+    *  factorization does it here, without using the values of the
+    *  matrix.
+    *
+    *  @return false, if the linear solver does not provide these estimates
+    */
+   virtual bool EstimateFactorization(
+      Number& /*factor_nonzeros*/,
+      Number& /*flops*/,
+      Number& /*memory*/
+   )
+   {
+      return false;
+   }
+
    /** Query of requested matrix type that the linear solver
     *  understands.
     */
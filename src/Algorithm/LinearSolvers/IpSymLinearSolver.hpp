@@ -115,6 +115,26 @@ public:
     *  (see ProvidesInertia).
     */
    virtual Index NumberOfNegEVals() const = 0;
+
+   /** Announce that a matrix differs from the previous one only on its diagonal.
+    *
+    *  This can be called before MultiSolve for A, if A differs from
+    *  the matrix with tag prev_tag, which has been given to the most
+    *  recent call of MultiSolve, only in the values of the diagonal
+    *  elements that are listed last for each row in the triplet
+    *  format of A.  Each row of A must have such an element, and diag
+    *  contains their new values.
+    *
+    *  A solver can then update its copy of the previous matrix instead
+    *  of retrieving all elements of A again.  The default
+    *  implementation ignores this information.
+    */
+   virtual void SetDiagonalChange(
+      const SymMatrix&  /*A*/,
+      TaggedObject::Tag /*prev_tag*/,
+      const Vector&     /*diag*/
+   )
+   { }
    ///@}
 
    //* @name Options of Linear solver */
@@ -133,6 +153,45 @@ public:
     * @return true, if linear solver provides inertia
     */
    virtual bool ProvidesInertia() const = 0;
+
+   /** Query whether the backward error of the solutions is computed
+    *  by the linear solver.
+    */
+   virtual bool ProvidesBackwardError() const
+   {
+      return false;
+   }
+
+   /** Componentwise backward error of the solutions of the most
+    *  recent solve.
+    *
+    * @note This must not be called if the linear solver does not compute
+    * this quantity (see ProvidesBackwardError).
+    */
+   virtual Number BackwardError() const
+   {
+      return -1.;
+   }
+
+   /** Predicted size and cost of the factorization of A.
+    *
+    *  Only the structure of A is used.  If this is the first matrix
+    *  given to the solver, its structure is analyzed as for the first
+    *  call of MultiSolve, so this can be called before any solve.
+    *  See SparseSymLinearSolverInterface::EstimateFactorization for
+    *  the meaning of the estimates.
+    *
+    *  @return false, if the linear solver does not provide these estimates
+    */
+   virtual bool EstimateFactorization(
+      const SymMatrix& /*A*/,
+      Number&          /*factor_nonzeros*/,
+      Number&          /*flops*/,
+      Number&          /*memory*/
+   )
+   {
+      return false;
+   }
    ///@}
 };
 
@@ -6,14 +6,78 @@
 
 #include "IpTSymLinearSolver.hpp"
 #include "IpTripletHelper.hpp"
+#include "IpCompoundSymMatrix.hpp"
 #include "IpBlas.hpp"
 
+#include <cmath>
+#include <cstdio>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Ipopt
 {
 #if IPOPT_VERBOSITY > 0
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Sets the OpenMP threads for a call of the linear solver and restores them afterwards. */
+class LinearSolverThreads
+{
+public:
+   LinearSolverThreads(
+      Index num_threads,
+      bool  nested_parallelism
+   )
+#ifdef _OPENMP
+      : saved_num_threads_(omp_get_max_threads())
+#endif
+   {
+#ifdef _OPENMP
+      if( num_threads > 0 )
+      {
+         omp_set_num_threads(num_threads);
+      }
+      // the maximal number of active levels is not restored, since it
+      // may be shared with concurrent solves
+      if( nested_parallelism && omp_get_active_level() >= omp_get_max_active_levels() )
+      {
+         omp_set_max_active_levels(omp_get_active_level() + 1);
+      }
+#else
+      (void) num_threads;
+      (void) nested_parallelism;
+#endif
+   }
+
+   ~LinearSolverThreads()
+   {
+#ifdef _OPENMP
+      omp_set_num_threads(saved_num_threads_);
+#endif
+   }
+
+   /** Number of threads that a parallel region in the linear solver could use, or 0 if not known */
+   Index NumThreads() const
+   {
+#ifdef _OPENMP
+      if( omp_get_active_level() >= omp_get_max_active_levels() )
+      {
+         return 1;
+      }
+      return omp_get_max_threads();
+#else
+      return 0;
+#endif
+   }
+
+private:
+#ifdef _OPENMP
+   int saved_num_threads_;
+#endif
+};
+
 TSymLinearSolver::TSymLinearSolver(
    SmartPtr<SparseSymLinearSolverInterface> solver_interface,
    SmartPtr<TSymScalingMethod>              scaling_method
@@ -28,8 +92,32 @@ TSymLinearSolver::TSymLinearSolver(
      solver_interface_(solver_interface),
      scaling_method_(scaling_method),
      scaling_factors_(NULL),
+     use_scaling_(false),
+     just_switched_on_scaling_(false),
+     scaling_diag_(NULL),
      airn_(NULL),
-     ajcn_(NULL)
+     ajcn_(NULL),
+     last_values_(NULL),
+     last_factorization_ok_(false),
+     factorization_memory_(0),
+     memory_account_(MemoryStatistics::LINEAR_SOLVER),
+     comp_values_(NULL),
+     diag_start_(NULL),
+     diag_triplet_(NULL),
+     diag_compressed_(NULL),
+     diag_base_(NULL),
+     values_copy_(NULL),
+     have_diag_values_(false),
+     diag_change_tag_(0),
+     diag_change_prev_tag_(0),
+     check_structure_reuse_(false),
+     incremental_diagonal_update_(false),
+     compact_structure_(false),
+     linear_scaling_reuse_tol_(0.),
+     export_first_iter_(0),
+     export_last_iter_(-1),
+     export_iter_(-1),
+     export_count_(0)
 {
    DBG_START_METH("TSymLinearSolver::TSymLinearSolver()", dbg_verbosity);
    DBG_ASSERT(IsValid(solver_interface));
@@ -42,6 +130,11 @@ TSymLinearSolver::~TSymLinearSolver()
    delete[] airn_;
    delete[] ajcn_;
    delete[] scaling_factors_;
+   delete[] scaling_diag_;
+   delete[] last_values_;
+   delete[] comp_values_;
+   FreeDiagonalIndex();
+   memory_account_.Free(factorization_memory_);
 }
 
 void TSymLinearSolver::RegisterOptions(
@@ -58,6 +151,123 @@ void TSymLinearSolver::RegisterOptions(
       "This can be quite expensive. "
       "Choosing \"yes\" means that the algorithm will start the scaling method only "
       "when the solutions to the linear system seem not good, and then use it until the end.");
+   roptions->AddLowerBoundedNumberOption(
+      "linear_scaling_reuse_tol",
+      "Change of the diagonal of the linear system up to which its scaling factors are reused.",
+      0., false,
+      0.,
+      "If positive, the scaling factors of the linear system are not computed again for a new matrix "
+      "as long as the absolute value of no diagonal element has changed by more than this number of orders of magnitude "
+      "since the scaling factors were computed. "
+      "If also the matrix structure is kept (see \"reuse_symbolic_factorization\" and \"warm_start_same_structure\"), "
+      "the scaling factors are kept for a reoptimization, too. "
+      "The value 0 computes the scaling factors for every new matrix. "
+      "This option is only important if a linear scaling method (e.g., mc19) is used.");
+   roptions->AddStringOption2(
+      "reuse_symbolic_factorization",
+      "Keep the symbolic factorization of the linear solver when reoptimizing a problem with unchanged structure.",
+      "no",
+      "no", "Redo the symbolic factorization for each optimization.",
+      "yes", "Reuse the symbolic factorization if the structure of the matrix did not change.",
+      "If \"yes\" is chosen, then at the beginning of a reoptimization (e.g., ReOptimizeTNLP) "
+      "the nonzero structure of the first linear system is compared with the one of the previous optimization. "
+      "If it is identical, then the compressed matrix structure and, for the linear solvers MA27, MA57, MA97, and MUMPS, "
+      "also the ordering and symbolic factorization are kept. "
+      "Changes to options of the linear solver that affect the ordering or analysis phase are then ignored. "
+      "Different from \"warm_start_same_structure\", the structure is checked and the user does not need to promise that it is unchanged.");
+   roptions->AddStringOption1(
+      "ordering_cache_dir",
+      "Directory in which fill-reducing orderings of the linear solver are cached.",
+      "",
+      "*", "Any existing directory name",
+      "If set, the ordering that the linear solver computes in its symbolic factorization is stored in this directory "
+      "under a name that is derived from a hash of the matrix structure. "
+      "If a later symbolic factorization, possibly in another process, is done for a matrix with the same structure, "
+      "then the stored ordering is passed to the linear solver instead of computing a new one. "
+      "This is currently supported for the linear solvers MA27, MA57, and MUMPS. "
+      "Leave unset to disable the cache.");
+   roptions->AddLowerBoundedIntegerOption(
+      "linear_solver_num_threads",
+      "Number of threads that the linear solver may use.",
+      0,
+      0,
+      "If positive, the number of OpenMP threads is set to this value during the calls of the linear solver, "
+      "and the number of threads of MUMPS (ICNTL(16)) and Pardiso is set accordingly. "
+      "This allows to choose the number of threads of the linear solver independently "
+      "of the number of threads of function evaluations or of other concurrent solves. "
+      "The value 0 keeps the number of OpenMP threads and the defaults of the linear solver. "
+      "Setting the OpenMP threads, e.g., for MA97, requires that Ipopt has been compiled with OpenMP support.");
+   roptions->AddStringOption2(
+      "linear_solver_nested_parallelism",
+      "Whether the linear solver may use threads if Ipopt is run inside a parallel region.",
+      "no",
+      "no", "Keep the maximal number of active OpenMP levels.",
+      "yes", "Increase the maximal number of active OpenMP levels if required.",
+      "If Ipopt itself is run by a thread of an OpenMP parallel region, e.g., to do several solves concurrently, "
+      "then the linear solver cannot use additional threads, unless nested parallelism is enabled. "
+      "This requires that Ipopt has been compiled with OpenMP support.");
+   roptions->AddStringOption2(
+      "reuse_identical_factorization",
+      "Whether to compare the values of a changed matrix with the factorized one.",
+      "no",
+      "no", "Factorize every matrix that has been recomputed.",
+      "yes", "Skip the factorization if the values did not change.",
+      "A matrix is passed to the linear solver whenever one of its components has been recomputed. "
+      "If \"yes\" is chosen, the values of such a matrix are compared with the ones of the most recent successful "
+      "factorization, and the factorization is kept if they are identical. "
+      "This requires to store one copy of the matrix values and to extract the values of every recomputed matrix, "
+      "so it only pays off if identical matrices are recomputed frequently, "
+      "e.g., in the restoration phase or for second-order corrections. "
+      "The number of skipped factorizations is reported in the timing statistics.");
+   roptions->AddStringOption2(
+      "incremental_diagonal_update",
+      "Whether to update only the diagonal of the matrix if nothing else has changed.",
+      "no",
+      "no", "Retrieve all elements of every new matrix.",
+      "yes", "Only write the new diagonal elements into the values of the previous matrix.",
+      "If only the diagonal of the augmented system changes, e.g., when the inertia correction increases the "
+      "perturbation of the diagonal, the new diagonal elements are written into the values of the previous matrix "
+      "that have been given to the linear solver, instead of retrieving and converting all elements of the matrix again. "
+      "This is not done if the linear system is scaled. "
+      "For linear solvers that overwrite the matrix during the factorization, e.g., MA27, "
+      "this requires to store one copy of the matrix values.");
+   roptions->AddStringOption2(
+      "compact_linear_system_structure",
+      "Whether to free the triplet structure of the linear system once the compressed structure has been built.",
+      "yes",
+      "no", "Keep the row and column indices of the triplet format.",
+      "yes", "Free the row and column indices of the triplet format if they are not needed anymore.",
+      "For linear solvers that take the matrix in compressed sparse row format (e.g., Pardiso, WSMP, MA86, MA97, SPRAL), "
+      "the row and column indices of the triplet format are only needed to set up the compressed format, "
+      "unless the linear system is scaled, i.e., linear_system_scaling is not none. "
+      "If \"yes\" is chosen, they are freed in this case, "
+      "which saves two integers per nonzero of the matrix. "
+      "A change of the matrix structure is then detected with the compressed format.");
+   roptions->AddStringOption1(
+      "kkt_export_file",
+      "Start of the names of binary files to which the factorized linear systems are written.",
+      "",
+      "*", "Any acceptable standard file name",
+      "If set, every linear system that is factorized in an iteration between kkt_export_first_iter and kkt_export_last_iter "
+      "is written to a file whose name is this value followed by \"_\", the iteration number, \"_\", "
+      "the number of the system within the iteration, and \".kkt\". "
+      "For the restoration phase, the options prefix (e.g., \"resto\") is inserted after the first \"_\". "
+      "The file contains the matrix in triplet format, the right hand sides, and the requested inertia, "
+      "in the native binary representation of the numbers. "
+      "The systems can be factorized again with the different linear solvers by the example program kkt_replay. "
+      "Leave unset to disable the export.");
+   roptions->AddLowerBoundedIntegerOption(
+      "kkt_export_first_iter",
+      "First iteration whose linear systems are written to files.",
+      0,
+      0,
+      "See kkt_export_file.");
+   roptions->AddLowerBoundedIntegerOption(
+      "kkt_export_last_iter",
+      "Last iteration whose linear systems are written to files.",
+      -1,
+      -1,
+      "See kkt_export_file. The value -1 exports the linear systems of all iterations from kkt_export_first_iter on.");
 }
 
 bool TSymLinearSolver::InitializeImpl(
@@ -75,6 +285,28 @@ bool TSymLinearSolver::InitializeImpl(
    }
    // This option is registered by OrigIpoptNLP
    options.GetBoolValue("warm_start_same_structure", warm_start_same_structure_, prefix);
+   options.GetBoolValue("reuse_symbolic_factorization", reuse_symbolic_factorization_, prefix);
+   options.GetIntegerValue("linear_solver_num_threads", num_threads_, prefix);
+   options.GetBoolValue("linear_solver_nested_parallelism", nested_parallelism_, prefix);
+   options.GetBoolValue("reuse_identical_factorization", reuse_identical_factorization_, prefix);
+   options.GetBoolValue("incremental_diagonal_update", incremental_diagonal_update_, prefix);
+   options.GetBoolValue("compact_linear_system_structure", compact_structure_, prefix);
+   options.GetNumericValue("linear_scaling_reuse_tol", linear_scaling_reuse_tol_, prefix);
+   options.GetStringValue("kkt_export_file", export_file_, prefix);
+   options.GetIntegerValue("kkt_export_first_iter", export_first_iter_, prefix);
+   options.GetIntegerValue("kkt_export_last_iter", export_last_iter_, prefix);
+   if( !export_file_.empty() && !prefix.empty() )
+   {
+      // distinguish the files of the restoration phase
+      std::string tag = prefix;
+      if( tag[tag.length() - 1] == '.' )
+      {
+         tag.erase(tag.length() - 1);
+      }
+      export_file_ += "_" + tag;
+   }
+   export_iter_ = -1;
+   export_count_ = 0;
 
    bool retval;
    if( HaveIpData() )
@@ -90,7 +322,16 @@ bool TSymLinearSolver::InitializeImpl(
       return false;
    }
 
-   if( !warm_start_same_structure_ )
+   // If requested, keep the structure of the previous matrix, so that
+   // InitializeStructure can check whether it can be reused
+   check_structure_reuse_ = !warm_start_same_structure_ && reuse_symbolic_factorization_ && have_structure_
+                            && matrix_format_ == solver_interface_->MatrixFormat();
+
+   if( check_structure_reuse_ )
+   {
+      atag_ = 0;
+   }
+   else if( !warm_start_same_structure_ )
    {
       // Reset all private data
       atag_ = 0;
@@ -131,14 +372,27 @@ bool TSymLinearSolver::InitializeImpl(
    // reset the initialize flag to make sure that InitializeStructure
    // is called for the linear solver
    initialized_ = false;
-
-   if( IsValid(scaling_method_) && !linear_scaling_on_demand_ )
+   delete[] last_values_;
+   last_values_ = NULL;
+   last_factorization_ok_ = false;
+   comp_tags_.clear();
+   fill_plan_.Clear();
+   have_diag_values_ = false;
+   diag_change_ = NULL;
+
+   if( use_scaling_ && scaling_diag_ != NULL && linear_scaling_reuse_tol_ > 0.
+       && (check_structure_reuse_ || warm_start_same_structure_) )
    {
-      use_scaling_ = true;
+      // keep the scaling factors of the previous optimization; they
+      // are discarded by InitializeStructure if the structure changed
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Keeping the scaling factors of the linear system of the previous optimization.\n");
    }
    else
    {
-      use_scaling_ = false;
+      use_scaling_ = IsValid(scaling_method_) && !linear_scaling_on_demand_;
+      delete[] scaling_diag_;
+      scaling_diag_ = NULL;
    }
    just_switched_on_scaling_ = false;
 
@@ -184,19 +438,61 @@ ESymSolverStatus TSymLinearSolver::MultiSolve(
    DBG_ASSERT(nonzeros_triplet_ == TripletHelper::GetNumberEntries(sym_A));
 
    // Check if the matrix has been changed
-   DBG_PRINT((1, "atag_ = %u   sym_A->GetTag() = %u\n", atag_, sym_A.GetTag()));
+   DBG_PRINT((1, "atag_ = %llu   sym_A->GetTag() = %llu\n", atag_, sym_A.GetTag()));
    bool new_matrix = sym_A.HasChanged(atag_);
+   const TaggedObject::Tag prev_tag = atag_;
    atag_ = sym_A.GetTag();
 
+   // If the matrix differs from the previous one only on the diagonal
+   // (see SetDiagonalChange), get the new diagonal elements
+   double* new_diag = NULL;
+   if( IsValid(diag_change_) )
+   {
+      if( new_matrix && have_diag_values_ && !use_scaling_ && !just_switched_on_scaling_
+          && diag_change_tag_ == atag_ && diag_change_prev_tag_ == prev_tag )
+      {
+         new_diag = new double[dim_];
+         TripletHelper::FillValuesFromVector(dim_, *diag_change_, new_diag);
+      }
+      diag_change_ = NULL;
+   }
+
+   // A recomputed matrix might still have the values of the current
+   // factorization, e.g., if it has been assembled from new but
+   // identical components
+   if( new_matrix && !just_switched_on_scaling_ && last_factorization_ok_
+       && (!check_NegEVals || solver_interface_->NumberOfNegEVals() == numberOfNegEVals)
+       && (new_diag != NULL ? HasSameDiagonal(new_diag) : HasSameValues(sym_A)) )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Matrix values did not change, keeping the previous factorization.\n");
+      if( HaveIpData() )
+      {
+         IpData().TimingStats().IncreaseLinearSystemFactorizationsSkipped();
+      }
+      new_matrix = false;
+   }
+
+   if( new_matrix && !export_file_.empty() && HaveIpData() && IpData().iter_count() >= export_first_iter_
+       && (export_last_iter_ < 0 || IpData().iter_count() <= export_last_iter_) )
+   {
+      ExportSystem(sym_A, rhsV, check_NegEVals, numberOfNegEVals);
+   }
+
    // If a new matrix is encountered, get the array for storing the
    // entries from the linear solver interface, fill in the new
    // values, compute the new scaling factors (if required), and
    // scale the matrix
-   if( new_matrix || just_switched_on_scaling_ )
+   if( new_matrix && new_diag != NULL )
+   {
+      UpdateDiagonalOfSolver(new_diag);
+   }
+   else if( new_matrix || just_switched_on_scaling_ )
    {
       GiveMatrixToSolver(true, sym_A);
       new_matrix = true;
    }
+   delete[] new_diag;
 
    // Retrieve the right hand sides and scale if required
    Index nrhs = (Index) rhsV.size();
@@ -207,11 +503,11 @@ ESymSolverStatus TSymLinearSolver::MultiSolve(
       if( Jnlst().ProduceOutput(J_MOREMATRIX, J_LINEAR_ALGEBRA) )
       {
          Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                        "Right hand side %d in TSymLinearSolver:\n", irhs);
+                        "Right hand side %" IPOPT_INDEX_FORMAT " in TSymLinearSolver:\n", irhs);
          for( Index i = 0; i < dim_; i++ )
          {
             Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                           "Trhs[%5d,%5d] = %23.16e\n", irhs, i, rhs_vals[irhs * (dim_) + i]);
+                           "Trhs[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e\n", irhs, i, rhs_vals[irhs * (dim_) + i]);
          }
       }
       if( use_scaling_ )
@@ -238,6 +534,7 @@ ESymSolverStatus TSymLinearSolver::MultiSolve(
    // for MA27 if the size of the work space arrays was not large
    // enough).
    ESymSolverStatus retval;
+   bool factorized = new_matrix;
    while( !done )
    {
       const Index* ia;
@@ -261,17 +558,54 @@ ESymSolverStatus TSymLinearSolver::MultiSolve(
          }
       }
 
-      retval = solver_interface_->MultiSolve(new_matrix, ia, ja, nrhs, rhs_vals, check_NegEVals, numberOfNegEVals);
+      {
+         LinearSolverThreads threads(num_threads_, nested_parallelism_);
+         if( HaveIpData() )
+         {
+            IpData().TimingStats().SetLinearSystemThreads(threads.NumThreads());
+            if( new_matrix )
+            {
+               IpData().WorkCounts().Increase(WorkCounters::FACTORIZATIONS);
+            }
+         }
+         retval = solver_interface_->MultiSolve(new_matrix, ia, ja, nrhs, rhs_vals, check_NegEVals, numberOfNegEVals);
+      }
       if( retval == SYMSOLVER_CALL_AGAIN )
       {
          DBG_PRINT((1, "Solver interface asks to be called again.\n"));
          GiveMatrixToSolver(false, sym_A);
+         factorized = true;
       }
       else
       {
          done = true;
       }
    }
+   if( retval != SYMSOLVER_SUCCESS )
+   {
+      last_factorization_ok_ = false;
+   }
+   else if( factorized )
+   {
+      last_factorization_ok_ = (last_values_ != NULL);
+   }
+   if( retval == SYMSOLVER_SUCCESS && HaveIpData() )
+   {
+      IpData().WorkCounts().Increase(WorkCounters::BACKSOLVES, nrhs);
+   }
+
+   // account for the memory of a new factorization, as far as the
+   // linear solver can estimate it
+   Number factor_nonzeros;
+   Number factor_flops;
+   Number factor_memory;
+   if( retval == SYMSOLVER_SUCCESS && factorized
+       && solver_interface_->EstimateFactorization(factor_nonzeros, factor_flops, factor_memory) && factor_memory >= 0. )
+   {
+      memory_account_.Free(factorization_memory_);
+      factorization_memory_ = (std::size_t) factor_memory;
+      memory_account_.Allocate(factorization_memory_);
+   }
 
    // If the solve was successful, unscale the solution (if required)
    // and transfer the result into the Vectors
@@ -297,11 +631,11 @@ ESymSolverStatus TSymLinearSolver::MultiSolve(
          if( Jnlst().ProduceOutput(J_MOREMATRIX, J_LINEAR_ALGEBRA) )
          {
             Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                           "Solution %d in TSymLinearSolver:\n", irhs);
+                           "Solution %" IPOPT_INDEX_FORMAT " in TSymLinearSolver:\n", irhs);
             for( Index i = 0; i < dim_; i++ )
             {
                Jnlst().Printf(J_MOREMATRIX, J_LINEAR_ALGEBRA,
-                              "Tsol[%5d,%5d] = %23.16e\n", irhs, i, rhs_vals[irhs * (dim_) + i]);
+                              "Tsol[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e\n", irhs, i, rhs_vals[irhs * (dim_) + i]);
             }
          }
          TripletHelper::PutValuesInVector(dim_, &rhs_vals[irhs * (dim_)], *solV[irhs]);
@@ -323,6 +657,21 @@ ESymSolverStatus TSymLinearSolver::InitializeStructure(
 
    ESymSolverStatus retval;
 
+   // if we kept the structure of the previous matrix, check whether
+   // it can be used
+   bool reuse_structure = false;
+   if( check_structure_reuse_ )
+   {
+      check_structure_reuse_ = false;
+      reuse_structure = HasSameStructure(sym_A);
+      if( !reuse_structure )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Structure of the linear system has changed, symbolic factorization is not reused.\n");
+         have_structure_ = false;
+      }
+   }
+
    // have_structure_ is already true if this is a warm start for a
    // problem with identical structure
    if( !have_structure_ )
@@ -330,6 +679,14 @@ ESymSolverStatus TSymLinearSolver::InitializeStructure(
 
       dim_ = sym_A.Dim();
       nonzeros_triplet_ = TripletHelper::GetNumberEntries(sym_A);
+      delete[] last_values_;
+      last_values_ = NULL;
+      last_factorization_ok_ = false;
+      delete[] comp_values_;
+      comp_values_ = NULL;
+      comp_tags_.clear();
+      fill_plan_.Clear();
+      FreeDiagonalIndex();
 
       delete[] airn_;
       delete[] ajcn_;
@@ -370,7 +727,10 @@ ESymSolverStatus TSymLinearSolver::InitializeStructure(
          nonzeros = nonzeros_compressed_;
       }
 
-      retval = solver_interface_->InitializeStructure(dim_, nonzeros, ia, ja);
+      {
+         LinearSolverThreads threads(num_threads_, nested_parallelism_);
+         retval = solver_interface_->InitializeStructure(dim_, nonzeros, ia, ja);
+      }
       if( retval != SYMSOLVER_SUCCESS )
       {
          return retval;
@@ -378,6 +738,8 @@ ESymSolverStatus TSymLinearSolver::InitializeStructure(
 
       // Get space for the scaling factors
       delete[] scaling_factors_;
+      delete[] scaling_diag_;
+      scaling_diag_ = NULL;
       if( IsValid(scaling_method_) )
       {
          if( HaveIpData() )
@@ -416,12 +778,134 @@ ESymSolverStatus TSymLinearSolver::InitializeStructure(
          IpData().TimingStats().LinearSystemStructureConverter().End();
          nonzeros = nonzeros_compressed_;
       }
-      retval = solver_interface_->InitializeStructure(dim_, nonzeros, ia, ja);
+      if( reuse_structure && solver_interface_->ReuseStructure(dim_, nonzeros, ia, ja) )
+      {
+         Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                        "Reusing structure and symbolic factorization of previous linear system.\n");
+         retval = SYMSOLVER_SUCCESS;
+      }
+      else
+      {
+         {
+            LinearSolverThreads threads(num_threads_, nested_parallelism_);
+            retval = solver_interface_->InitializeStructure(dim_, nonzeros, ia, ja);
+         }
+      }
+   }
+
+   if( !incremental_diagonal_update_ )
+   {
+      FreeDiagonalIndex();
+   }
+   else if( diag_start_ == NULL && retval == SYMSOLVER_SUCCESS && airn_ != NULL )
+   {
+      InitializeDiagonalIndex();
+   }
+
+   // The triplet structure is not required anymore if the solver works
+   // with the compressed format and the system is not scaled
+   if( compact_structure_ && matrix_format_ != SparseSymLinearSolverInterface::Triplet_Format
+       && IsNull(scaling_method_) && retval == SYMSOLVER_SUCCESS )
+   {
+      delete[] airn_;
+      delete[] ajcn_;
+      airn_ = NULL;
+      ajcn_ = NULL;
    }
+
    initialized_ = true;
    return retval;
 }
 
+void TSymLinearSolver::ComputeDiagonalMagnitudes(
+   const double* atriplet,
+   double*       diag
+) const
+{
+   for( Index i = 0; i < dim_; i++ )
+   {
+      diag[i] = 0.;
+   }
+   for( Index i = 0; i < nonzeros_triplet_; i++ )
+   {
+      if( airn_[i] == ajcn_[i] )
+      {
+         diag[airn_[i] - 1] += atriplet[i];
+      }
+   }
+   for( Index i = 0; i < dim_; i++ )
+   {
+      diag[i] = std::abs(diag[i]);
+   }
+}
+
+bool TSymLinearSolver::CanReuseScaling(
+   const double* diag
+) const
+{
+   if( scaling_diag_ == NULL )
+   {
+      return false;
+   }
+
+   const Number max_ratio = std::pow(10., linear_scaling_reuse_tol_);
+   for( Index i = 0; i < dim_; i++ )
+   {
+      // a zero element may only stay zero
+      if( diag[i] == 0. || scaling_diag_[i] == 0. )
+      {
+         if( diag[i] != scaling_diag_[i] )
+         {
+            return false;
+         }
+      }
+      else if( diag[i] > max_ratio * scaling_diag_[i] || scaling_diag_[i] > max_ratio * diag[i] )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool TSymLinearSolver::HasSameStructure(
+   const SymMatrix& sym_A
+) const
+{
+   DBG_START_METH("TSymLinearSolver::HasSameStructure",
+                  dbg_verbosity);
+   DBG_ASSERT(have_structure_);
+
+   if( sym_A.Dim() != dim_ || TripletHelper::GetNumberEntries(sym_A) != nonzeros_triplet_ )
+   {
+      return false;
+   }
+
+   Index* airn = new Index[nonzeros_triplet_];
+   Index* ajcn = new Index[nonzeros_triplet_];
+   TripletHelper::FillRowCol(nonzeros_triplet_, sym_A, airn, ajcn);
+
+   bool same = true;
+   if( airn_ == NULL )
+   {
+      same = triplet_to_csr_converter_->HasSameStructure(dim_, nonzeros_triplet_, airn, ajcn);
+   }
+   else
+   {
+      for( Index i = 0; i < nonzeros_triplet_; i++ )
+      {
+         if( airn[i] != airn_[i] || ajcn[i] != ajcn_[i] )
+         {
+            same = false;
+            break;
+         }
+      }
+   }
+
+   delete[] airn;
+   delete[] ajcn;
+   return same;
+}
+
 Index TSymLinearSolver::NumberOfNegEVals() const
 {
    DBG_START_METH("TSymLinearSolver::NumberOfNegEVals", dbg_verbosity);
@@ -452,6 +936,58 @@ bool TSymLinearSolver::ProvidesInertia() const
    return solver_interface_->ProvidesInertia();
 }
 
+bool TSymLinearSolver::ProvidesBackwardError() const
+{
+   return solver_interface_->ProvidesBackwardError();
+}
+
+Number TSymLinearSolver::BackwardError() const
+{
+   return solver_interface_->BackwardError();
+}
+
+bool TSymLinearSolver::EstimateFactorization(
+   const SymMatrix& A,
+   Number&          factor_nonzeros,
+   Number&          flops,
+   Number&          memory
+)
+{
+   DBG_START_METH("TSymLinearSolver::EstimateFactorization", dbg_verbosity);
+
+   if( !initialized_ && InitializeStructure(A) != SYMSOLVER_SUCCESS )
+   {
+      return false;
+   }
+
+   return solver_interface_->EstimateFactorization(factor_nonzeros, flops, memory);
+}
+
+bool TSymLinearSolver::HasSameValues(
+   const SymMatrix& sym_A
+) const
+{
+   DBG_START_METH("TSymLinearSolver::HasSameValues",
+                  dbg_verbosity);
+   DBG_ASSERT(last_values_);
+
+   double* values = new double[nonzeros_triplet_];
+   TripletHelper::FillValues(nonzeros_triplet_, sym_A, values);
+
+   bool same = true;
+   for( Index i = 0; i < nonzeros_triplet_; i++ )
+   {
+      if( values[i] != last_values_[i] )
+      {
+         same = false;
+         break;
+      }
+   }
+
+   delete[] values;
+   return same;
+}
+
 void TSymLinearSolver::GiveMatrixToSolver(
    bool             new_matrix,
    const SymMatrix& sym_A
@@ -463,18 +999,61 @@ void TSymLinearSolver::GiveMatrixToSolver(
    double* pa = solver_interface_->GetValuesArrayPtr();
    double* atriplet;
 
-   if( matrix_format_ != SparseSymLinearSolverInterface::Triplet_Format )
+   // For a compound matrix, only the components that changed since the
+   // previous matrix are filled into comp_values_.  They cannot be kept
+   // in the array of the solver interface, since the factorization may
+   // overwrite it.
+   const CompoundSymMatrix* comp_A = dynamic_cast<const CompoundSymMatrix*>(&sym_A);
+   if( comp_A != NULL )
    {
-      atriplet = new double[nonzeros_triplet_];
+      if( comp_values_ == NULL )
+      {
+         comp_values_ = new double[nonzeros_triplet_];
+         comp_tags_.clear();
+      }
+      Index n_filled = fill_plan_.FillChangedValues(nonzeros_triplet_, *comp_A, comp_tags_, comp_values_);
+      DBG_PRINT((1, "filled %d of %d entries\n", n_filled, nonzeros_triplet_));
+      (void) n_filled;
    }
-   else
+
+   bool delete_atriplet = false;
+   if( matrix_format_ == SparseSymLinearSolverInterface::Triplet_Format )
    {
       atriplet = pa;
    }
+   else if( comp_A != NULL && !use_scaling_ )
+   {
+      // the values are not changed before the conversion
+      atriplet = comp_values_;
+   }
+   else
+   {
+      atriplet = new double[nonzeros_triplet_];
+      delete_atriplet = true;
+   }
 
    //DBG_PRINT_MATRIX(3, "Aunscaled", sym_A);
-   TripletHelper::FillValues(nonzeros_triplet_, sym_A, atriplet);
-   if( DBG_VERBOSITY() >= 3 )
+   if( comp_A != NULL )
+   {
+      if( atriplet != comp_values_ )
+      {
+         IpBlasDcopy(nonzeros_triplet_, comp_values_, 1, atriplet, 1);
+      }
+   }
+   else
+   {
+      fill_plan_.FillValues(nonzeros_triplet_, sym_A, atriplet);
+   }
+   if( reuse_identical_factorization_ )
+   {
+      // remember the values to detect an identical matrix later
+      if( last_values_ == NULL )
+      {
+         last_values_ = new double[nonzeros_triplet_];
+      }
+      IpBlasDcopy(nonzeros_triplet_, atriplet, 1, last_values_, 1);
+   }
+   if( DBG_VERBOSITY() >= 3 && airn_ != NULL )
    {
       for( Index i = 0; i < nonzeros_triplet_; i++ )
       {
@@ -486,7 +1065,25 @@ void TSymLinearSolver::GiveMatrixToSolver(
    {
       IpData().TimingStats().LinearSystemScaling().Start();
       DBG_ASSERT(scaling_factors_);
-      if( new_matrix || just_switched_on_scaling_ )
+      bool reuse_scaling = false;
+      if( (new_matrix || just_switched_on_scaling_) && linear_scaling_reuse_tol_ > 0. )
+      {
+         double* diag = new double[dim_];
+         ComputeDiagonalMagnitudes(atriplet, diag);
+         reuse_scaling = !just_switched_on_scaling_ && CanReuseScaling(diag);
+         if( reuse_scaling )
+         {
+            Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                           "Diagonal of the linear system changed only little, keeping the scaling factors.\n");
+            delete[] diag;
+         }
+         else
+         {
+            delete[] scaling_diag_;
+            scaling_diag_ = diag;
+         }
+      }
+      if( (new_matrix || just_switched_on_scaling_) && !reuse_scaling )
       {
          // only compute scaling factors if the matrix has not been
          // changed since the last call to this method
@@ -505,7 +1102,7 @@ void TSymLinearSolver::GiveMatrixToSolver(
             for( Index i = 0; i < dim_; i++ )
             {
                Jnlst().Printf(J_MOREVECTOR, J_LINEAR_ALGEBRA,
-                              "scaling factor[%6d] = %22.17e\n", i, scaling_factors_[i]);
+                              "scaling factor[%6" IPOPT_INDEX_FORMAT "] = %22.17e\n", i, scaling_factors_[i]);
             }
          }
          just_switched_on_scaling_ = false;
@@ -529,9 +1126,272 @@ void TSymLinearSolver::GiveMatrixToSolver(
       IpData().TimingStats().LinearSystemStructureConverter().Start();
       triplet_to_csr_converter_->ConvertValues(nonzeros_triplet_, atriplet, nonzeros_compressed_, pa);
       IpData().TimingStats().LinearSystemStructureConverter().End();
+   }
+
+   // Keep what is required to update the diagonal of this matrix later
+   have_diag_values_ = false;
+   if( diag_start_ != NULL && !use_scaling_ )
+   {
+      if( matrix_format_ != SparseSymLinearSolverInterface::Triplet_Format )
+      {
+         // The converter adds the entries of an element in the order of
+         // the triplet format, so that adding the last entry to this sum
+         // gives the same result as a conversion of all values
+         for( Index i = 0; i < dim_; i++ )
+         {
+            const Index last = diag_start_[i + 1] - 1;
+            if( last > diag_start_[i] )
+            {
+               double val = atriplet[diag_triplet_[diag_start_[i]]];
+               for( Index j = diag_start_[i] + 1; j < last; j++ )
+               {
+                  val += atriplet[diag_triplet_[j]];
+               }
+               diag_base_[i] = val;
+            }
+         }
+      }
+      if( values_copy_ != NULL )
+      {
+         const Index nonzeros =
+            matrix_format_ == SparseSymLinearSolverInterface::Triplet_Format ? nonzeros_triplet_ : nonzeros_compressed_;
+         IpBlasDcopy(nonzeros, pa, 1, values_copy_, 1);
+      }
+      have_diag_values_ = true;
+   }
+
+   if( delete_atriplet )
+   {
       delete[] atriplet;
    }
+}
+
+void TSymLinearSolver::SetDiagonalChange(
+   const SymMatrix&  A,
+   TaggedObject::Tag prev_tag,
+   const Vector&     diag
+)
+{
+   DBG_START_METH("TSymLinearSolver::SetDiagonalChange", dbg_verbosity);
+
+   if( diag_start_ == NULL )
+   {
+      return;
+   }
+
+   diag_change_ = &diag;
+   diag_change_tag_ = A.GetTag();
+   diag_change_prev_tag_ = prev_tag;
+}
+
+void TSymLinearSolver::InitializeDiagonalIndex()
+{
+   DBG_START_METH("TSymLinearSolver::InitializeDiagonalIndex", dbg_verbosity);
+
+   FreeDiagonalIndex();
+
+   // Count the triplet entries of each diagonal element
+   Index* diag_start = new Index[dim_ + 1];
+   for( Index i = 0; i <= dim_; i++ )
+   {
+      diag_start[i] = 0;
+   }
+   for( Index k = 0; k < nonzeros_triplet_; k++ )
+   {
+      if( airn_[k] == ajcn_[k] )
+      {
+         diag_start[airn_[k]]++;
+      }
+   }
+   for( Index i = 0; i < dim_; i++ )
+   {
+      if( diag_start[i + 1] == 0 )
+      {
+         // not every row has a diagonal element
+         delete[] diag_start;
+         return;
+      }
+      diag_start[i + 1] += diag_start[i];
+   }
 
+   diag_triplet_ = new Index[diag_start[dim_]];
+   Index* insert_pos = new Index[dim_];
+   for( Index i = 0; i < dim_; i++ )
+   {
+      insert_pos[i] = diag_start[i];
+   }
+   for( Index k = 0; k < nonzeros_triplet_; k++ )
+   {
+      if( airn_[k] == ajcn_[k] )
+      {
+         diag_triplet_[insert_pos[airn_[k] - 1]++] = k;
+      }
+   }
+   delete[] insert_pos;
+
+   Index nonzeros = nonzeros_triplet_;
+   if( matrix_format_ != SparseSymLinearSolverInterface::Triplet_Format )
+   {
+      // the compressed element of a diagonal element is the one whose
+      // first triplet entry is on the diagonal
+      const Index* ipos_first = triplet_to_csr_converter_->iPosFirst();
+      diag_compressed_ = new Index[dim_];
+      for( Index p = 0; p < nonzeros_compressed_; p++ )
+      {
+         const Index k = ipos_first[p];
+         if( airn_[k] == ajcn_[k] )
+         {
+            diag_compressed_[airn_[k] - 1] = p;
+         }
+      }
+      diag_base_ = new double[dim_];
+      nonzeros = nonzeros_compressed_;
+   }
+
+   if( !solver_interface_->PreservesValues() )
+   {
+      values_copy_ = new double[nonzeros];
+   }
+
+   diag_start_ = diag_start;
+}
+
+void TSymLinearSolver::FreeDiagonalIndex()
+{
+   delete[] diag_start_;
+   diag_start_ = NULL;
+   delete[] diag_triplet_;
+   diag_triplet_ = NULL;
+   delete[] diag_compressed_;
+   diag_compressed_ = NULL;
+   delete[] diag_base_;
+   diag_base_ = NULL;
+   delete[] values_copy_;
+   values_copy_ = NULL;
+   have_diag_values_ = false;
+}
+
+bool TSymLinearSolver::HasSameDiagonal(
+   const double* diag
+) const
+{
+   DBG_ASSERT(last_values_);
+   DBG_ASSERT(diag_start_);
+
+   for( Index i = 0; i < dim_; i++ )
+   {
+      if( diag[i] != last_values_[diag_triplet_[diag_start_[i + 1] - 1]] )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void TSymLinearSolver::UpdateDiagonalOfSolver(
+   const double* diag
+)
+{
+   DBG_START_METH("TSymLinearSolver::UpdateDiagonalOfSolver", dbg_verbosity);
+   DBG_ASSERT(have_diag_values_ && !use_scaling_);
+
+   Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
+                  "Only the diagonal of the matrix has changed, updating the diagonal elements.\n");
+
+   double* pa = solver_interface_->GetValuesArrayPtr();
+   double* values = values_copy_ != NULL ? values_copy_ : pa;
+   for( Index i = 0; i < dim_; i++ )
+   {
+      const Index last = diag_triplet_[diag_start_[i + 1] - 1];
+      if( matrix_format_ == SparseSymLinearSolverInterface::Triplet_Format )
+      {
+         values[last] = diag[i];
+      }
+      else if( diag_start_[i + 1] - diag_start_[i] > 1 )
+      {
+         values[diag_compressed_[i]] = diag_base_[i] + diag[i];
+      }
+      else
+      {
+         values[diag_compressed_[i]] = diag[i];
+      }
+      if( last_values_ != NULL )
+      {
+         last_values_[last] = diag[i];
+      }
+   }
+
+   if( values_copy_ != NULL )
+   {
+      const Index nonzeros =
+         matrix_format_ == SparseSymLinearSolverInterface::Triplet_Format ? nonzeros_triplet_ : nonzeros_compressed_;
+      IpBlasDcopy(nonzeros, values_copy_, 1, pa, 1);
+   }
+}
+
+void TSymLinearSolver::ExportSystem(
+   const SymMatrix&                            sym_A,
+   const std::vector<SmartPtr<const Vector> >& rhsV,
+   bool                                        check_NegEVals,
+   Index                                       numberOfNegEVals
+)
+{
+   DBG_START_METH("TSymLinearSolver::ExportSystem", dbg_verbosity);
+
+   Index iter = IpData().iter_count();
+   if( iter != export_iter_ )
+   {
+      export_iter_ = iter;
+      export_count_ = 0;
+   }
+   char buf[64];
+   Snprintf(buf, 63, "_%" IPOPT_INDEX_FORMAT "_%" IPOPT_INDEX_FORMAT ".kkt", iter, export_count_);
+   std::string filename = export_file_ + buf;
+   export_count_++;
+
+   FILE* fp = fopen(filename.c_str(), "wb");
+   if( fp == NULL )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "Error opening file \"%s\" for the export of the linear system.\n", filename.c_str());
+      return;
+   }
+
+   Index nrhs = (Index) rhsV.size();
+   const unsigned char format[4] = { 1, (unsigned char) sizeof(Index), (unsigned char) sizeof(Number), 0 };
+   const Index header[6] = { dim_, nonzeros_triplet_, nrhs, check_NegEVals ? 1 : 0, numberOfNegEVals, iter };
+
+   Index* irn = new Index[nonzeros_triplet_];
+   Index* jcn = new Index[nonzeros_triplet_];
+   Number* vals = new Number[nonzeros_triplet_];
+   Number* rhs = new Number[dim_];
+   TripletHelper::FillRowCol(nonzeros_triplet_, sym_A, irn, jcn);
+   TripletHelper::FillValues(nonzeros_triplet_, sym_A, vals);
+
+   bool ok = fwrite("IPOPTKKT", 1, 8, fp) == 8
+             && fwrite(format, 1, 4, fp) == 4
+             && fwrite(header, sizeof(Index), 6, fp) == 6
+             && fwrite(irn, sizeof(Index), nonzeros_triplet_, fp) == (size_t) nonzeros_triplet_
+             && fwrite(jcn, sizeof(Index), nonzeros_triplet_, fp) == (size_t) nonzeros_triplet_
+             && fwrite(vals, sizeof(Number), nonzeros_triplet_, fp) == (size_t) nonzeros_triplet_;
+   for( Index irhs = 0; ok && irhs < nrhs; irhs++ )
+   {
+      TripletHelper::FillValuesFromVector(dim_, *rhsV[irhs], rhs);
+      ok = fwrite(rhs, sizeof(Number), dim_, fp) == (size_t) dim_;
+   }
+   delete[] irn;
+   delete[] jcn;
+   delete[] vals;
+   delete[] rhs;
+
+   if( fclose(fp) != 0 || !ok )
+   {
+      Jnlst().Printf(J_WARNING, J_LINEAR_ALGEBRA,
+                     "Error writing the linear system to file \"%s\".\n", filename.c_str());
+      return;
+   }
+   Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                  "Linear system written to file \"%s\".\n", filename.c_str());
 }
 
 bool TSymLinearSolver::ProvidesDegeneracyDetection() const
@@ -556,6 +1416,14 @@ ESymSolverStatus TSymLinearSolver::DetermineDependentRows(
    // quite because of structural singularity
    dim_ = n_rows + n_cols;
    nonzeros_triplet_ = n_jac_nz + dim_;
+   delete[] last_values_;
+   last_values_ = NULL;
+   last_factorization_ok_ = false;
+   delete[] comp_values_;
+   comp_values_ = NULL;
+   comp_tags_.clear();
+   fill_plan_.Clear();
+   FreeDiagonalIndex();
 
    delete[] airn_;
    delete[] ajcn_;
@@ -605,7 +1473,11 @@ ESymSolverStatus TSymLinearSolver::DetermineDependentRows(
       nonzeros = nonzeros_compressed_;
    }
 
-   ESymSolverStatus retval = solver_interface_->InitializeStructure(dim_, nonzeros, ia, ja);
+   ESymSolverStatus retval;
+   {
+      LinearSolverThreads threads(num_threads_, nested_parallelism_);
+      retval = solver_interface_->InitializeStructure(dim_, nonzeros, ia, ja);
+   }
    if( retval != SYMSOLVER_SUCCESS )
    {
       return retval;
@@ -613,6 +1485,8 @@ ESymSolverStatus TSymLinearSolver::DetermineDependentRows(
 
    // Get space for the scaling factors
    delete[] scaling_factors_;
+   delete[] scaling_diag_;
+   scaling_diag_ = NULL;
    if( IsValid(scaling_method_) )
    {
       if( HaveIpData() )
@@ -672,7 +1546,7 @@ ESymSolverStatus TSymLinearSolver::DetermineDependentRows(
          for( Index i = 0; i < dim_; i++ )
          {
             Jnlst().Printf(J_MOREVECTOR, J_LINEAR_ALGEBRA,
-                           "scaling factor[%6d] = %22.17e\n", i, scaling_factors_[i]);
+                           "scaling factor[%6" IPOPT_INDEX_FORMAT "] = %22.17e\n", i, scaling_factors_[i]);
          }
       }
       for( Index i = 0; i < nonzeros_triplet_; i++ )
@@ -703,7 +1577,10 @@ ESymSolverStatus TSymLinearSolver::DetermineDependentRows(
       delete[] atriplet;
    }
 
-   retval = solver_interface_->DetermineDependentRows(ia, ja, c_deps);
+   {
+      LinearSolverThreads threads(num_threads_, nested_parallelism_);
+      retval = solver_interface_->DetermineDependentRows(ia, ja, c_deps);
+   }
 
    // We need to correct the indices
    if( retval == SYMSOLVER_SUCCESS )
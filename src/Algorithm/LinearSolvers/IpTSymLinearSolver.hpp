@@ -12,8 +12,11 @@
 #include "IpTSymScalingMethod.hpp"
 #include "IpSymMatrix.hpp"
 #include "IpTripletToCSRConverter.hpp"
+#include "IpTripletHelper.hpp"
+#include "IpMemoryStatistics.hpp"
 #include <vector>
 #include <list>
+#include <string>
 
 namespace Ipopt
 {
@@ -66,6 +69,19 @@ public:
    );
 
    virtual Index NumberOfNegEVals() const;
+
+   /** Remember the new diagonal of A, so that the next call of
+    *  MultiSolve for A only updates the diagonal elements of the
+    *  values given to the solver interface.
+    *
+    *  This is only done if incremental_diagonal_update is enabled and
+    *  the linear system is not scaled.
+    */
+   virtual void SetDiagonalChange(
+      const SymMatrix&  A,
+      TaggedObject::Tag prev_tag,
+      const Vector&     diag
+   );
    ///@}
 
    //* @name Options of Linear solver */
@@ -73,6 +89,17 @@ public:
    virtual bool IncreaseQuality();
 
    virtual bool ProvidesInertia() const;
+
+   virtual bool ProvidesBackwardError() const;
+
+   virtual Number BackwardError() const;
+
+   virtual bool EstimateFactorization(
+      const SymMatrix& A,
+      Number&          factor_nonzeros,
+      Number&          flops,
+      Number&          memory
+   );
    ///@}
 
    /** @name Methods related to the detection of linearly dependent
@@ -177,14 +204,45 @@ private:
    bool use_scaling_;
    /** Flag indicating whether we just switched on the scaling */
    bool just_switched_on_scaling_;
+   /** Magnitudes of the diagonal elements of the matrix for which
+    *  scaling_factors_ have been computed, or NULL if the scaling
+    *  factors are not reused. */
+   double* scaling_diag_;
    ///@}
 
    /** @name information about the matrix. */
    ///@{
-   /** row indices of matrix in triplet (MA27) format. */
+   /** row indices of matrix in triplet (MA27) format, or NULL if
+    *  they are not kept for a solver that takes the compressed format
+    *  (see compact_structure_). */
    Index* airn_;
-   /** column indices of matrix in triplet (MA27) format. */
+   /** column indices of matrix in triplet (MA27) format, or NULL if
+    *  they are not kept (see compact_structure_). */
    Index* ajcn_;
+   /** Values of the most recently factorized matrix in triplet format
+    *  (before scaling), or NULL if identical matrices are not detected. */
+   double* last_values_;
+   /** Flag indicating whether the factorization of the matrix stored in
+    *  last_values_ was successful. */
+   bool last_factorization_ok_;
+   /** Memory of the current factorization as estimated by the linear
+    *  solver, which is accounted for in MemoryStatistics. */
+   std::size_t factorization_memory_;
+   /** Account in which factorization_memory_ is allocated */
+   MemoryAccount memory_account_;
+   /** Values of the most recent matrix in triplet format (before
+    *  scaling), if it is a CompoundSymMatrix.
+    *
+    *  The values of components that did not change since the previous
+    *  matrix, e.g., constant Jacobians, are kept and not filled again.
+    */
+   double* comp_values_;
+   /** Tags of the components whose values are in comp_values_, see
+    *  TripletHelper::FillChangedValues. */
+   std::vector<TaggedObject::Tag> comp_tags_;
+   /** Plan for filling the values of the matrix, which is built for
+    *  the first matrix with the current structure. */
+   TripletFillPlan fill_plan_;
    /** Pointer to object for conversion from triplet to compressed format.
     *
     *  This is only required if the linear solver works with
@@ -195,12 +253,97 @@ private:
    SparseSymLinearSolverInterface::EMatrixFormat matrix_format_;
    ///@}
 
+   /** @name Update of the diagonal elements (see SetDiagonalChange) */
+   ///@{
+   /** Start of the triplet positions of each diagonal element in
+    *  diag_triplet_, or NULL if the diagonal elements have not been
+    *  determined or some row has no diagonal element.
+    */
+   Index* diag_start_;
+   /** Triplet positions of the entries of the diagonal elements, in
+    *  increasing order for each element.
+    */
+   Index* diag_triplet_;
+   /** Positions of the diagonal elements in the compressed format */
+   Index* diag_compressed_;
+   /** For each diagonal element, the sum of all but its last triplet
+    *  entry, in the order in which the converter adds them.
+    */
+   double* diag_base_;
+   /** Copy of the values given to the solver interface, if it does
+    *  not preserve them.
+    */
+   double* values_copy_;
+   /** Flag indicating whether diag_base_ and the values given to the
+    *  solver interface (or values_copy_) belong to the matrix with
+    *  tag atag_.
+    */
+   bool have_diag_values_;
+   /** New diagonal given to SetDiagonalChange, or NULL */
+   SmartPtr<const Vector> diag_change_;
+   /** Tag of the matrix given to SetDiagonalChange */
+   TaggedObject::Tag diag_change_tag_;
+   /** Tag of the matrix that has been changed on the diagonal */
+   TaggedObject::Tag diag_change_prev_tag_;
+   ///@}
+
    /** @name Algorithmic parameters */
    ///@{
    /** Flag indicating whether the TNLP with identical structure has
     *  already been solved before.
     */
    bool warm_start_same_structure_;
+   /** Flag indicating whether the structure and symbolic
+    *  factorization of the previous matrix should be reused if the
+    *  structure of the matrix has not changed after a
+    *  re-initialization.
+    */
+   bool reuse_symbolic_factorization_;
+
+   /** Number of threads for the linear solver, or 0 to keep the number of OpenMP threads */
+   Index num_threads_;
+
+   /** Flag indicating whether the linear solver may use threads inside an active parallel region */
+   bool nested_parallelism_;
+
+   /** Flag indicating whether a matrix with a new tag but identical
+    *  values should reuse the previous factorization. */
+   bool reuse_identical_factorization_;
+   /** Flag indicating whether the structure of the first matrix seen
+    *  after the last initialization still has to be compared with
+    *  the one stored in airn_ and ajcn_.
+    */
+   bool check_structure_reuse_;
+   /** Flag indicating whether a change of the diagonal only is
+    *  applied to the values of the previous matrix.
+    */
+   bool incremental_diagonal_update_;
+   /** Flag indicating whether airn_ and ajcn_ are freed after the
+    *  initialization of the converter to the compressed format if
+    *  they are not needed for the scaling of the linear system.
+    */
+   bool compact_structure_;
+   /** Maximal change of the diagonal elements, in orders of
+    *  magnitude, for which the scaling factors are kept for a new
+    *  matrix; 0 to compute them for every matrix. */
+   Number linear_scaling_reuse_tol_;
+   ///@}
+
+   /** @name Export of the linear systems (see ExportSystem) */
+   ///@{
+   /** Start of the names of the files to which the linear systems
+    *  are written, or empty if they are not exported. */
+   std::string export_file_;
+   /** First iteration for which the linear systems are exported */
+   Index export_first_iter_;
+   /** Last iteration for which the linear systems are exported, or
+    *  -1 for no limit */
+   Index export_last_iter_;
+   /** Iteration of the most recently exported linear system */
+   Index export_iter_;
+   /** Number of linear systems that have been exported in iteration
+    *  export_iter_ */
+   Index export_count_;
    ///@}
 
    /** @name Internal functions */
@@ -214,6 +357,21 @@ private:
       const SymMatrix& symT_A
    );
 
+   /** Check whether the nonzero structure of symT_A is identical to
+    *  the one stored in airn_ and ajcn_, or, if these have been freed,
+    *  whether it gives the same compressed structure.
+    */
+   bool HasSameStructure(
+      const SymMatrix& symT_A
+   ) const;
+
+   /** Check whether the values of sym_A are identical to the ones
+    *  stored in last_values_.
+    */
+   bool HasSameValues(
+      const SymMatrix& sym_A
+   ) const;
+
    /** Copy the elements of the matrix in the required format into
     *  the array that is provided by the solver interface.
     */
@@ -221,6 +379,62 @@ private:
       bool             new_matrix,
       const SymMatrix& sym_A
    );
+
+   /** Compute the absolute values of the diagonal elements of the
+    *  matrix with values atriplet in triplet format. */
+   void ComputeDiagonalMagnitudes(
+      const double* atriplet,
+      double*       diag
+   ) const;
+
+   /** Check whether the scaling factors that have been computed for
+    *  the matrix whose diagonal is stored in scaling_diag_ can be
+    *  used for a matrix with diagonal magnitudes diag. */
+   bool CanReuseScaling(
+      const double* diag
+   ) const;
+
+   /** Determine the positions of the diagonal elements in the triplet
+    *  and compressed formats for the current structure.
+    */
+   void InitializeDiagonalIndex();
+
+   /** Free the arrays for the update of the diagonal elements. */
+   void FreeDiagonalIndex();
+
+   /** Check whether the new diagonal diag is identical to the one
+    *  stored in last_values_.
+    */
+   bool HasSameDiagonal(
+      const double* diag
+   ) const;
+
+   /** Write the new diagonal diag into the values of the previous
+    *  matrix that have been given to the solver interface.
+    */
+   void UpdateDiagonalOfSolver(
+      const double* diag
+   );
+
+   /** Write a linear system that is going to be factorized to a file.
+    *
+    *  The file starts with the 8 characters "IPOPTKKT", followed by
+    *  one byte each for the version of the format (1), sizeof(Index),
+    *  and sizeof(Number), and one unused byte.  Then follow the Index
+    *  values dim, nonzeros, number of right hand sides, whether the
+    *  inertia is checked (0 or 1), the requested number of negative
+    *  eigenvalues, and the iteration number; the row and column
+    *  indices (1-based, lower or upper triangle, duplicate entries are
+    *  added) of the matrix in triplet format; and the Number values of
+    *  the matrix and of the right hand sides.  The matrix and right
+    *  hand sides are not scaled.
+    */
+   void ExportSystem(
+      const SymMatrix&                            sym_A,
+      const std::vector<SmartPtr<const Vector> >& rhsV,
+      bool                                        check_NegEVals,
+      Index                                       numberOfNegEVals
+   );
    ///@}
 };
 
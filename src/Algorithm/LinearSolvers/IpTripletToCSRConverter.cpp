@@ -10,12 +10,76 @@
 
 #include <cstddef>
 
+/** Matrices with at least this number of nonzeros are converted by
+ *  several threads if Ipopt has been compiled with OpenMP support.
+ */
+#ifndef IPOPT_TRIPLETTOCSR_PARALLEL_MIN_NONZEROS
+#define IPOPT_TRIPLETTOCSR_PARALLEL_MIN_NONZEROS 100000
+#endif
+
 namespace Ipopt
 {
 #if IPOPT_VERBOSITY > 0
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Stable counting sort of the triplet positions in by the keys key[in[p]].
+ *
+ *  The keys are between 1 and nkeys.  If in is NULL, the identity is
+ *  sorted.  The sorted positions are stored in out.  The input is split
+ *  into nblocks contiguous blocks, each of which is counted and
+ *  distributed by one thread.  Since the buckets are filled block by
+ *  block, the result does not depend on the number of blocks.
+ */
+static void CountingSort(
+   Index        n,
+   const Index* in,
+   const Index* key,
+   Index        nkeys,
+   Index*       out,
+   int          nblocks
+)
+{
+   // count[blk * nkeys + k] is the number of entries with key k+1 in block blk
+   std::vector<Index> count((size_t) nblocks * nkeys, 0);
+
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index* blk_count = &count[(size_t) blk * nkeys];
+      Index end = BlockStart(n, nblocks, blk + 1);
+      for( Index p = BlockStart(n, nblocks, blk); p < end; p++ )
+      {
+         blk_count[key[in != NULL ? in[p] : p] - 1]++;
+      }
+   }
+
+   // turn counts into insert positions, ordered by key first and block second
+   Index sum = 0;
+   for( Index k = 0; k < nkeys; k++ )
+   {
+      for( int blk = 0; blk < nblocks; blk++ )
+      {
+         Index c = count[(size_t) blk * nkeys + k];
+         count[(size_t) blk * nkeys + k] = sum;
+         sum += c;
+      }
+   }
+   DBG_ASSERT(sum == n);
+
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index* blk_count = &count[(size_t) blk * nkeys];
+      Index end = BlockStart(n, nblocks, blk + 1);
+      for( Index p = BlockStart(n, nblocks, blk); p < end; p++ )
+      {
+         Index idx = (in != NULL ? in[p] : p);
+         out[blk_count[key[idx] - 1]++] = idx;
+      }
+   }
+}
+
 TripletToCSRConverter::TripletToCSRConverter(
    Index offset,
    ETriFull hf /*= Triangular_Format*/)
@@ -28,8 +92,8 @@ TripletToCSRConverter::TripletToCSRConverter(
      nonzeros_compressed_(0),
      initialized_(false),
      ipos_first_(NULL),
-     ipos_double_triplet_(NULL),
-     ipos_double_compressed_(NULL)
+     gather_start_(NULL),
+     gather_pos_(NULL)
 {
    DBG_ASSERT(offset == 0 || offset == 1);
 }
@@ -39,8 +103,8 @@ TripletToCSRConverter::~TripletToCSRConverter()
    delete[] ia_;
    delete[] ja_;
    delete[] ipos_first_;
-   delete[] ipos_double_triplet_;
-   delete[] ipos_double_compressed_;
+   delete[] gather_start_;
+   delete[] gather_pos_;
 }
 
 Index TripletToCSRConverter::InitializeConverter(
@@ -59,21 +123,33 @@ Index TripletToCSRConverter::InitializeConverter(
    delete[] ia_;
    delete[] ja_;
    delete[] ipos_first_;
-   delete[] ipos_double_triplet_;
-   delete[] ipos_double_compressed_;
+   delete[] gather_start_;
+   delete[] gather_pos_;
+   gather_start_ = NULL;
+   gather_pos_ = NULL;
 
    dim_ = dim;
    nonzeros_triplet_ = nonzeros;
 
-   // Create a list with all triplet entries
-   std::vector<TripletEntry> entry_list(nonzeros);
-   std::vector<TripletEntry>::iterator list_iterator = entry_list.begin();
+   const int nthreads = ParallelLoopThreads(nonzeros, IPOPT_TRIPLETTOCSR_PARALLEL_MIN_NONZEROS);
+
+   // Row and column indices of all entries, mapped to the upper triangle
+   Index* irow = new Index[nonzeros];
+   Index* jcol = new Index[nonzeros];
+   IPOPT_OMP_PARALLEL_FOR(nthreads)
    for( Index i = 0; i < nonzeros; i++ )
    {
-      list_iterator->Set(airn[i], ajcn[i], i);
-      list_iterator++;
+      if( airn[i] > ajcn[i] )
+      {
+         irow[i] = ajcn[i];
+         jcol[i] = airn[i];
+      }
+      else
+      {
+         irow[i] = airn[i];
+         jcol[i] = ajcn[i];
+      }
    }
-   DBG_ASSERT(list_iterator == entry_list.end());
 
    if( DBG_VERBOSITY() >= 2 )
    {
@@ -83,8 +159,23 @@ Index TripletToCSRConverter::InitializeConverter(
       }
    }
 
-   // sort the list
-   std::sort(entry_list.begin(), entry_list.end());
+   // Sort the entries by row and column by two stable counting sorts,
+   // first by column and then by row.  Repeated entries remain in the
+   // order of the triplet format.  The histograms of the blocks of the
+   // counting sort take nblocks*dim elements, so the number of blocks is
+   // limited such that this does not exceed the number of nonzeros.
+   int nblocks = nthreads;
+   if( dim > 0 && (Index) nblocks > nonzeros / dim )
+   {
+      nblocks = Max((Index) 1, nonzeros / dim);
+   }
+   Index* sorted = new Index[nonzeros];
+   {
+      Index* sorted_col = new Index[nonzeros];
+      CountingSort(nonzeros, NULL, jcol, dim, sorted_col, nblocks);
+      CountingSort(nonzeros, sorted_col, irow, dim, sorted, nblocks);
+      delete[] sorted_col;
+   }
 
    // Now got through the list and compute ipos_ arrays and the
    // number of elements in the compressed format
@@ -113,42 +204,41 @@ Index TripletToCSRConverter::InitializeConverter(
    }
 
    // Take care of possible empty rows
-   list_iterator = entry_list.begin();
-   while( cur_row < list_iterator->IRow() )
+   while( cur_row < irow[sorted[0]] )
    {
       ia_[cur_row - 1] = 0;
       cur_row++;
    }
    ia_[cur_row - 1] = 0;
-   ja_tmp[0] = list_iterator->JCol();
-   ipos_first_tmp[0] = list_iterator->PosTriplet();
+   ja_tmp[0] = jcol[sorted[0]];
+   ipos_first_tmp[0] = sorted[0];
    if( hf_ == Full_Format )
    {
       // Count in both lower and upper triangles. Count diagonal only once.
       nonzeros_compressed_full++;
       rc_tmp[cur_row - 1]++;
-      if( cur_row != list_iterator->JCol() )
+      if( cur_row != jcol[sorted[0]] )
       {
          nonzeros_compressed_full++;
-         rc_tmp[list_iterator->JCol() - 1]++;
+         rc_tmp[jcol[sorted[0]] - 1]++;
       }
    }
 
-   list_iterator++;
    Index idouble = 0;
    Index idouble_full = 0;
-   while( list_iterator != entry_list.end() )
+   for( Index isorted = 1; isorted < nonzeros; isorted++ )
    {
-      Index irow = list_iterator->IRow();
-      Index jcol = list_iterator->JCol();
-      if( cur_row == irow && ja_tmp[nonzeros_compressed_] == jcol )
+      Index pos_triplet = sorted[isorted];
+      Index irow_cur = irow[pos_triplet];
+      Index jcol_cur = jcol[pos_triplet];
+      if( cur_row == irow_cur && ja_tmp[nonzeros_compressed_] == jcol_cur )
       {
          // This element appears repeatedly, add to the double list
-         ipos_double_triplet_tmp[idouble] = list_iterator->PosTriplet();
+         ipos_double_triplet_tmp[idouble] = pos_triplet;
          ipos_double_compressed_tmp[idouble] = nonzeros_compressed_;
          idouble++;
          idouble_full++;
-         if( hf_ == Full_Format && irow != jcol )
+         if( hf_ == Full_Format && irow_cur != jcol_cur )
          {
             idouble_full++;
          }
@@ -160,17 +250,17 @@ Index TripletToCSRConverter::InitializeConverter(
          {
             // Count in both lower and upper triangles. Count diagonal only once.
             nonzeros_compressed_full++;
-            rc_tmp[jcol - 1]++;
-            if( irow != jcol )
+            rc_tmp[jcol_cur - 1]++;
+            if( irow_cur != jcol_cur )
             {
                nonzeros_compressed_full++;
-               rc_tmp[irow - 1]++;
+               rc_tmp[irow_cur - 1]++;
             }
          }
          nonzeros_compressed_++;
-         ja_tmp[nonzeros_compressed_] = jcol;
-         ipos_first_tmp[nonzeros_compressed_] = list_iterator->PosTriplet();
-         if( cur_row != irow )
+         ja_tmp[nonzeros_compressed_] = jcol_cur;
+         ipos_first_tmp[nonzeros_compressed_] = pos_triplet;
+         if( cur_row != irow_cur )
          {
             // this is in a new row
 
@@ -178,9 +268,10 @@ Index TripletToCSRConverter::InitializeConverter(
             cur_row++;
          }
       }
-
-      list_iterator++;
    }
+   delete[] sorted;
+   delete[] irow;
+   delete[] jcol;
    nonzeros_compressed_++;
    for( Index i = cur_row; i <= dim_; i++ )
    {
@@ -221,17 +312,10 @@ Index TripletToCSRConverter::InitializeConverter(
       }
       delete[] ipos_first_tmp;
 
-      // Reallocate memory for the "double" arrays
-      ipos_double_triplet_ = new Index[idouble];
-      ipos_double_compressed_ = new Index[idouble];
-      for( Index i = 0; i < idouble; i++ )
-      {
-         ipos_double_triplet_[i] = ipos_double_triplet_tmp[i];
-         ipos_double_compressed_[i] = ipos_double_compressed_tmp[i];
-      }
+      num_doubles_ = nonzeros_triplet_ - nonzeros_compressed_;
+      InitializeGatherMap(ipos_double_triplet_tmp, ipos_double_compressed_tmp);
       delete[] ipos_double_triplet_tmp;
       delete[] ipos_double_compressed_tmp;
-      num_doubles_ = nonzeros_triplet_ - nonzeros_compressed_;
    }
    else   // hf_==Full_Format
    {
@@ -249,10 +333,10 @@ Index TripletToCSRConverter::InitializeConverter(
       // Loop over elements of matrix, copying them and duplicating as required
       ja_ = new Index[nonzeros_compressed_full];
       ipos_first_ = new Index[nonzeros_compressed_full];
-      ipos_double_triplet_ = new Index[idouble_full];
-      ipos_double_compressed_ = new Index[idouble_full];
+      Index* ipos_double_triplet = new Index[idouble_full];
+      Index* ipos_double_compressed = new Index[idouble_full];
       Index jd1 = 0; // Entry into ipos_double_compressed_tmp
-      Index jd2 = 0; // Entry into ipos_double_compressed_
+      Index jd2 = 0; // Entry into ipos_double_compressed
       for( Index i = 0; i < dim_; i++ )
       {
          for( Index j = ia_[i]; j < ia_[i + 1]; j++ )
@@ -262,13 +346,13 @@ Index TripletToCSRConverter::InitializeConverter(
             ipos_first_[ia_tmp[i + 1]] = ipos_first_tmp[j];
             while( jd1 < idouble && j == ipos_double_compressed_tmp[jd1] )
             {
-               ipos_double_triplet_[jd2] = ipos_double_triplet_tmp[jd1];
-               ipos_double_compressed_[jd2] = ia_tmp[i + 1];
+               ipos_double_triplet[jd2] = ipos_double_triplet_tmp[jd1];
+               ipos_double_compressed[jd2] = ia_tmp[i + 1];
                jd2++;
                if( jrow != i )
                {
-                  ipos_double_triplet_[jd2] = ipos_double_triplet_tmp[jd1];
-                  ipos_double_compressed_[jd2] = ia_tmp[jrow + 1];
+                  ipos_double_triplet[jd2] = ipos_double_triplet_tmp[jd1];
+                  ipos_double_compressed[jd2] = ia_tmp[jrow + 1];
                   jd2++;
                }
                jd1++;
@@ -297,6 +381,9 @@ Index TripletToCSRConverter::InitializeConverter(
       // Set nonzeros_compressed_ to correct size
       nonzeros_compressed_ = nonzeros_compressed_full;
       num_doubles_ = idouble_full;
+      InitializeGatherMap(ipos_double_triplet, ipos_double_compressed);
+      delete[] ipos_double_triplet;
+      delete[] ipos_double_compressed;
    }
 
    initialized_ = true;
@@ -311,15 +398,66 @@ Index TripletToCSRConverter::InitializeConverter(
       {
          DBG_PRINT((2, "ja[%5d] = %5d ipos_first[%5d] = %5d\n", i, ja_[i], i, ipos_first_[i]));
       }
-      for( Index i = 0; i < nonzeros_triplet_ - nonzeros_compressed_; i++ )
+      if( gather_start_ != NULL )
       {
-         DBG_PRINT((2, "ipos_double_triplet[%5d] = %5d ipos_double_compressed[%5d] = %5d\n", i, ipos_double_triplet_[i], i, ipos_double_compressed_[i]));
+         for( Index i = 0; i < nonzeros_compressed_; i++ )
+         {
+            for( Index j = gather_start_[i]; j < gather_start_[i + 1]; j++ )
+            {
+               DBG_PRINT((2, "gather_pos[%5d] = %5d for compressed element %5d\n", j, gather_pos_[j], i));
+            }
+         }
       }
    }
 
    return nonzeros_compressed_;
 }
 
+bool TripletToCSRConverter::HasSameStructure(
+   Index        dim,
+   Index        nonzeros,
+   const Index* airn,
+   const Index* ajcn
+) const
+{
+   DBG_START_METH("TripletToCSRConverter::HasSameStructure",
+                  dbg_verbosity);
+
+   if( !initialized_ || dim != dim_ || nonzeros != nonzeros_triplet_ )
+   {
+      return false;
+   }
+
+   // Every triplet entry is either the first or a repeated entry of
+   // an element of the compressed format, so all entries are checked.
+   for( Index i = 0; i < dim_; i++ )
+   {
+      for( Index p = ia_[i] - offset_; p < ia_[i + 1] - offset_; p++ )
+      {
+         const Index row = Min(i + 1, ja_[p] - offset_ + 1);
+         const Index col = Max(i + 1, ja_[p] - offset_ + 1);
+         Index k = ipos_first_[p];
+         if( Min(airn[k], ajcn[k]) != row || Max(airn[k], ajcn[k]) != col )
+         {
+            return false;
+         }
+         if( gather_start_ != NULL )
+         {
+            for( Index j = gather_start_[p]; j < gather_start_[p + 1]; j++ )
+            {
+               k = gather_pos_[j];
+               if( Min(airn[k], ajcn[k]) != row || Max(airn[k], ajcn[k]) != col )
+               {
+                  return false;
+               }
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
 void TripletToCSRConverter::ConvertValues(
    Index         nonzeros_triplet,
    const Number* a_triplet,
@@ -335,13 +473,31 @@ void TripletToCSRConverter::ConvertValues(
    DBG_ASSERT(nonzeros_triplet_ == nonzeros_triplet);
    DBG_ASSERT(nonzeros_compressed_ == nonzeros_compressed);
 
-   for( Index i = 0; i < nonzeros_compressed_; i++ )
+   // Each element of the compressed matrix is the sum of its first entry
+   // and its repeated entries (in the order of the triplet format), so
+   // a_compressed is written in a single pass and no element is written
+   // by more than one thread.
+   const int nthreads = ParallelLoopThreads(nonzeros_compressed_, IPOPT_TRIPLETTOCSR_PARALLEL_MIN_NONZEROS);
+   if( gather_start_ == NULL )
    {
-      a_compressed[i] = a_triplet[ipos_first_[i]];
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < nonzeros_compressed_; i++ )
+      {
+         a_compressed[i] = a_triplet[ipos_first_[i]];
+      }
    }
-   for( Index i = 0; i < num_doubles_; i++ )
+   else
    {
-      a_compressed[ipos_double_compressed_[i]] += a_triplet[ipos_double_triplet_[i]];
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < nonzeros_compressed_; i++ )
+      {
+         Number val = a_triplet[ipos_first_[i]];
+         for( Index j = gather_start_[i]; j < gather_start_[i + 1]; j++ )
+         {
+            val += a_triplet[gather_pos_[j]];
+         }
+         a_compressed[i] = val;
+      }
    }
 
    if( DBG_VERBOSITY() >= 2 )
@@ -357,4 +513,47 @@ void TripletToCSRConverter::ConvertValues(
    }
 }
 
+void TripletToCSRConverter::InitializeGatherMap(
+   const Index* ipos_double_triplet,
+   const Index* ipos_double_compressed
+)
+{
+   DBG_ASSERT(gather_start_ == NULL && gather_pos_ == NULL);
+
+   if( num_doubles_ == 0 )
+   {
+      return;
+   }
+
+   // Count the repeated entries for each compressed element, turn the
+   // counts into start positions, and distribute the triplet positions.
+   // This keeps the repeated entries of an element in the order in which
+   // they are listed in ipos_double_triplet.
+   gather_start_ = new Index[nonzeros_compressed_ + 1];
+   for( Index i = 0; i <= nonzeros_compressed_; i++ )
+   {
+      gather_start_[i] = 0;
+   }
+   for( Index i = 0; i < num_doubles_; i++ )
+   {
+      gather_start_[ipos_double_compressed[i] + 1]++;
+   }
+   for( Index i = 0; i < nonzeros_compressed_; i++ )
+   {
+      gather_start_[i + 1] += gather_start_[i];
+   }
+
+   gather_pos_ = new Index[num_doubles_];
+   Index* insert_pos = new Index[nonzeros_compressed_];
+   for( Index i = 0; i < nonzeros_compressed_; i++ )
+   {
+      insert_pos[i] = gather_start_[i];
+   }
+   for( Index i = 0; i < num_doubles_; i++ )
+   {
+      gather_pos_[insert_pos[ipos_double_compressed[i]]++] = ipos_double_triplet[i];
+   }
+   delete[] insert_pos;
+}
+
 } // namespace Ipopt
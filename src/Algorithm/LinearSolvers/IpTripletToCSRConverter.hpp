@@ -21,72 +21,6 @@ namespace Ipopt
  */
 class TripletToCSRConverter: public ReferencedObject
 {
-   /** Class for one triplet position entry. */
-   class TripletEntry
-   {
-   public:
-
-      /** Set the values of an entry */
-      void Set(
-         Index i_row,
-         Index j_col,
-         Index i_pos_triplet
-      )
-      {
-         if( i_row > j_col )
-         {
-            i_row_ = j_col;
-            j_col_ = i_row;
-         }
-         else
-         {
-            i_row_ = i_row;
-            j_col_ = j_col;
-         }
-         i_pos_triplet_ = i_pos_triplet;
-      }
-
-      /** @name Accessor methods. */
-      ///@{
-      /** Row position. */
-      Index IRow() const
-      {
-         return i_row_;
-      }
-
-      /** Column position. */
-      Index JCol() const
-      {
-         return j_col_;
-      }
-
-      /** Index in original triplet matrix. */
-      Index PosTriplet() const
-      {
-         return i_pos_triplet_;
-      }
-      ///@}
-
-      /** Comparison operator.
-       *
-       * This is required for the sort function.
-       */
-      bool operator<(
-         const TripletEntry& Tentry
-      ) const
-      {
-         return ((i_row_ < Tentry.i_row_) || (i_row_ == Tentry.i_row_ && j_col_ < Tentry.j_col_));
-      }
-
-   private:
-      /** @name Entry content. */
-      ///@{
-      Index i_row_;
-      Index j_col_;
-      Index i_pos_triplet_;
-      ///@}
-   };
-
 public:
    /** Enum to specify half or full matrix storage */
    enum ETriFull
@@ -157,6 +91,23 @@ public:
    }
    ///@}
 
+   /** Check whether a triplet structure is converted to the same
+    *  compressed structure.
+    *
+    *  This is the case if dim and nonzeros are the ones given to
+    *  InitializeConverter and each entry of airn and ajcn is, up to
+    *  transposition, the entry at the same position in the structure
+    *  given to InitializeConverter.  Since this is checked with the
+    *  compressed structure, the triplet structure does not need to be
+    *  kept after the initialization.
+    */
+   bool HasSameStructure(
+      Index        dim,
+      Index        nonzeros,
+      const Index* airn,
+      const Index* ajcn
+   ) const;
+
    /** Convert the values of the nonzero elements.
     *
     *  Given the values a_triplet for the triplet format, return
@@ -194,6 +145,15 @@ private:
    );
    ///@}
 
+   /** Set up gather_start_ and gather_pos_ from the list of repeated
+    *  entries, given by the positions ipos_double_triplet in the triplet
+    *  format and ipos_double_compressed in the compressed format
+    *  (both of length num_doubles_). */
+   void InitializeGatherMap(
+      const Index* ipos_double_triplet,
+      const Index* ipos_double_compressed
+   );
+
    /** Offset for CSR numbering. */
    Index offset_;
 
@@ -231,15 +191,19 @@ private:
     */
    Index* ipos_first_;
 
-   /** Position of multiple elements in triplet matrix.
-    *  For i = 0,..,nonzeros_triplet_-nonzeros_compressed_, the
-    *  ipos_double_triplet_[i]-th element in the triplet matrix has
-    *  to be added to the ipos_double_compressed_[i]-th element in
-    *  the compressed matrix. */
-   Index* ipos_double_triplet_;
+   /** Start of the repeated entries for each element in gather_pos_.
+    *
+    *  For i with 0 <= i <= nonzeros_compressed-1, the triplet elements
+    *  gather_pos_[gather_start_[i]], ..., gather_pos_[gather_start_[i+1]-1]
+    *  have to be added to the i-th element in the compressed format.
+    *  This array has nonzeros_compressed+1 elements; it is NULL if there
+    *  are no repeated entries.
+    */
+   Index* gather_start_;
 
-   /** Position of multiple elements in compressed matrix. */
-   Index* ipos_double_compressed_;
+   /** Positions of repeated entries in the triplet matrix, sorted by
+    *  their position in the compressed matrix (length num_doubles_). */
+   Index* gather_pos_;
    ///@}
 };
 
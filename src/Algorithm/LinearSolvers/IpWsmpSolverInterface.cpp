@@ -72,6 +72,7 @@ WsmpSolverInterface::WsmpSolverInterface()
 #endif
      negevals_(-1),
      initialized_(false),
+     current_num_threads_(-1),
      PERM_(NULL),
      INVP_(NULL),
      MRP_(NULL)
@@ -161,6 +162,54 @@ void WsmpSolverInterface::RegisterOptions(
       "WSMP's DPARM(10) parameter. "
       "The smaller this value the less likely a matrix is declared singular. "
       "This option is only available if Ipopt has been compiled with WSMP.");
+   roptions->AddLowerBoundedIntegerOption(
+      "wsmp_num_threads_ordering",
+      "Number of threads to be used in WSMP's ordering and symbolic factorization phase",
+      0,
+      0,
+      "If 0, the value of wsmp_num_threads is used. "
+      "This option is only available if Ipopt has been compiled with WSMP.");
+   roptions->AddLowerBoundedIntegerOption(
+      "wsmp_num_threads_factorization",
+      "Number of threads to be used in WSMP's numerical factorization phase",
+      0,
+      0,
+      "If 0, the value of wsmp_num_threads is used. "
+      "This option is only available if Ipopt has been compiled with WSMP.");
+   roptions->AddLowerBoundedIntegerOption(
+      "wsmp_num_threads_solve",
+      "Number of threads to be used in WSMP's solve phase",
+      0,
+      0,
+      "If 0, the value of wsmp_num_threads is used. "
+      "The triangular solves usually scale worse than the factorization, so fewer threads may be faster here. "
+      "This option is only available if Ipopt has been compiled with WSMP.");
+   roptions->AddStringOption2(
+      "wsmp_reuse_ordering",
+      "Whether to reuse the ordering of WSMP when the solver is reinitialized.",
+      "no",
+      "no", "compute a new ordering",
+      "yes", "reuse the ordering if the structure of the matrix did not change",
+      "If enabled, the permutation computed by WSMP is kept when Ipopt is reinitialized, e.g., by ReOptimizeTNLP, "
+      "and passed to WSMP instead of computing a new ordering, as long as the nonzero structure of the matrix is unchanged. "
+      "This option is only available if Ipopt has been compiled with WSMP.");
+   roptions->AddLowerBoundedNumberOption(
+      "wsmp_pivot_perturbation",
+      "Pivot perturbation for the linear solver WSMP.",
+      0.0, false,
+      0.0,
+      "If positive, WSMP uses limited pivoting and replaces pivots that are too small by this value (DPARM(22)). "
+      "The error introduced by the perturbation is then removed by iterative refinement, "
+      "and when the quality of the solution is to be increased, "
+      "the number of refinement steps is increased first instead of refactorizing the matrix with a larger pivot tolerance. "
+      "This option is only available if Ipopt has been compiled with WSMP.");
+   roptions->AddLowerBoundedIntegerOption(
+      "wsmp_max_refinement_steps",
+      "Maximal number of iterative refinement steps in WSMP's solve phase when pivots are perturbed.",
+      1,
+      10,
+      "This option is only used if wsmp_pivot_perturbation is positive. "
+      "This option is only available if Ipopt has been compiled with WSMP.");
    roptions->SetRegisteringCategory("Uncategorized"); // ????
    roptions->AddLowerBoundedIntegerOption(
       "wsmp_write_matrix_iteration",
@@ -194,8 +243,10 @@ bool WsmpSolverInterface::InitializeImpl(
 )
 {
    options.GetIntegerValue("wsmp_num_threads", wsmp_num_threads_, prefix);
-   Index wsmp_ordering_option;
-   options.GetIntegerValue("wsmp_ordering_option", wsmp_ordering_option, prefix);
+   options.GetIntegerValue("wsmp_num_threads_ordering", wsmp_num_threads_ordering_, prefix);
+   options.GetIntegerValue("wsmp_num_threads_factorization", wsmp_num_threads_factorization_, prefix);
+   options.GetIntegerValue("wsmp_num_threads_solve", wsmp_num_threads_solve_, prefix);
+   options.GetIntegerValue("wsmp_ordering_option", wsmp_ordering_option_, prefix);
    Index wsmp_ordering_option2;
    options.GetIntegerValue("wsmp_ordering_option2", wsmp_ordering_option2, prefix);
    options.GetNumericValue("wsmp_pivtol", wsmp_pivtol_, prefix);
@@ -214,6 +265,9 @@ bool WsmpSolverInterface::InitializeImpl(
    options.GetIntegerValue("wsmp_write_matrix_iteration", wsmp_write_matrix_iteration_, prefix);
    options.GetBoolValue("wsmp_skip_inertia_check", skip_inertia_check_, prefix);
    options.GetBoolValue("wsmp_no_pivoting", wsmp_no_pivoting_, prefix);
+   options.GetBoolValue("wsmp_reuse_ordering", wsmp_reuse_ordering_, prefix);
+   options.GetNumericValue("wsmp_pivot_perturbation", wsmp_pivot_perturbation_, prefix);
+   options.GetIntegerValue("wsmp_max_refinement_steps", wsmp_max_refinement_steps_, prefix);
 
    // Reset all private data
    dim_ = 0;
@@ -222,12 +276,19 @@ bool WsmpSolverInterface::InitializeImpl(
    pivtol_changed_ = false;
    have_symbolic_factorization_ = false;
    factorizations_since_recomputed_ordering_ = -1;
+   refinement_steps_ = 1;
    delete[] a_;
    a_ = NULL;
-   delete[] PERM_;
-   PERM_ = NULL;
-   delete[] INVP_;
-   INVP_ = NULL;
+   if( !wsmp_reuse_ordering_ )
+   {
+      // the ordering is kept otherwise, so that it can be used for the next matrix if its structure is the same
+      delete[] PERM_;
+      PERM_ = NULL;
+      delete[] INVP_;
+      INVP_ = NULL;
+      ordering_ia_.clear();
+      ordering_ja_.clear();
+   }
    delete[] MRP_;
    MRP_ = NULL;
 
@@ -249,10 +310,10 @@ bool WsmpSolverInterface::InitializeImpl(
 #endif
 
    // Set the number of threads
-   ipfint NTHREADS = wsmp_num_threads_;
-   IPOPT_WSMP_FUNC(wsetmaxthrds, WSETMAXTHRDS)(&NTHREADS);
+   current_num_threads_ = -1;
+   SetNumThreads(wsmp_num_threads_);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "WSMP will use %d threads.\n", wsmp_num_threads_);
+                  "WSMP will use %" IPOPT_INDEX_FORMAT " threads.\n", wsmp_num_threads_);
 
    // Get WSMP's default parameters and set the ones we want differently
    IPARM_[0] = 0;
@@ -262,7 +323,7 @@ bool WsmpSolverInterface::InitializeImpl(
    double ddmy;
    IPOPT_WSMP_FUNC(wssmp, WSSMP)(&idmy, &idmy, &idmy, &ddmy, &ddmy, &idmy, &idmy, &ddmy, &idmy, &idmy, &ddmy, &idmy, &idmy,
                            IPARM_, DPARM_);
-   IPARM_[15] = wsmp_ordering_option; // ordering option
+   IPARM_[15] = wsmp_ordering_option_; // ordering option
    IPARM_[17] = 0; // use local minimum fill-in ordering
    IPARM_[19] = wsmp_ordering_option2; // for ordering in IP methods?
    if( wsmp_no_pivoting_ )
@@ -270,6 +331,11 @@ bool WsmpSolverInterface::InitializeImpl(
       IPARM_[30] = 1; // want L D L^T factorization with diagonal no pivoting
       IPARM_[26] = 1;
    }
+   else if( wsmp_pivot_perturbation_ > 0. )
+   {
+      IPARM_[30] = 6; // want L D L^T factorization with limited pivoting
+      DPARM_[21] = wsmp_pivot_perturbation_; // perturbation for tiny pivots
+   }
    else
    {
       IPARM_[30] = 2; // want L D L^T factorization with diagonal with pivoting
@@ -309,7 +375,7 @@ ESymSolverStatus WsmpSolverInterface::MultiSolve(
    if( !printed_num_threads_ )
    {
       Jnlst().Printf(J_ITERSUMMARY, J_LINEAR_ALGEBRA,
-                     "  -- WSMP is working with %d thread%s.\n", IPARM_[32], IPARM_[32] == 1 ? "" : "s");
+                     "  -- WSMP is working with %" IPOPT_INDEX_FORMAT " thread%s.\n", IPARM_[32], IPARM_[32] == 1 ? "" : "s");
       printed_num_threads_ = true;
    }
    // check if a factorization has to be done
@@ -365,6 +431,54 @@ ESymSolverStatus WsmpSolverInterface::InitializeStructure(
    return retval;
 }
 
+void WsmpSolverInterface::SetNumThreads(
+   Index num_threads
+)
+{
+   if( num_threads == 0 )
+   {
+      num_threads = wsmp_num_threads_;
+   }
+   if( num_threads == current_num_threads_ )
+   {
+      return;
+   }
+
+   ipfint NTHREADS = num_threads;
+   IPOPT_WSMP_FUNC(wsetmaxthrds, WSETMAXTHRDS)(&NTHREADS);
+   current_num_threads_ = num_threads;
+}
+
+bool WsmpSolverInterface::HaveOrderingFor(
+   const Index* ia,
+   const Index* ja
+) const
+{
+   if( PERM_ == NULL || INVP_ == NULL )
+   {
+      return false;
+   }
+   if( (Index) ordering_ia_.size() != dim_ + 1 || (Index) ordering_ja_.size() != nonzeros_ )
+   {
+      return false;
+   }
+   for( Index i = 0; i <= dim_; i++ )
+   {
+      if( ordering_ia_[i] != ia[i] )
+      {
+         return false;
+      }
+   }
+   for( Index i = 0; i < nonzeros_; i++ )
+   {
+      if( ordering_ja_[i] != ja[i] )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
 ESymSolverStatus WsmpSolverInterface::SymbolicFactorization(
    const Index* ia,
    const Index* ja
@@ -389,15 +503,29 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
       IpData().TimingStats().LinearSystemSymbolicFactorization().Start();
    }
 
+   // Check whether the ordering from before the last reinitialization can be used
+   bool reuse_ordering = false;
+#ifndef PARDISO_MATCHING_PREPROCESS
+   if( wsmp_reuse_ordering_ && HaveOrderingFor(ia, ja) )
+   {
+      reuse_ordering = true;
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Reusing WSMP's ordering for a matrix with unchanged structure.\n");
+   }
+#endif
+
    // Create space for the permutations
-   delete[] PERM_;
-   PERM_ = NULL;
-   delete[] INVP_;
-   INVP_ = NULL;
+   if( !reuse_ordering )
+   {
+      delete[] PERM_;
+      PERM_ = NULL;
+      delete[] INVP_;
+      INVP_ = NULL;
+      PERM_ = new ipfint[dim_];
+      INVP_ = new ipfint[dim_];
+   }
    delete[] MRP_;
    MRP_ = NULL;
-   PERM_ = new ipfint[dim_];
-   INVP_ = new ipfint[dim_];
    MRP_ = new ipfint[dim_];
 
    ipfint N = dim_;
@@ -446,6 +574,10 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
    // =6 limited pivots
    DPARM_[21] = 2e-8;// set pivot perturbation
 #endif
+   if( reuse_ordering )
+   {
+      IPARM_[15] = -1; // use the ordering given in PERM_ and INVP_
+   }
    ipfint idmy;
    double ddmy;
 
@@ -453,9 +585,10 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
    {
       IPARM_[14] = dim_ - numberOfNegEVals; // CHECK
       Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
-                     "Restricting WSMP static pivot sequence with IPARM(15) = %d\n", IPARM_[14]);
+                     "Restricting WSMP static pivot sequence with IPARM(15) = %" IPOPT_INDEX_FORMAT "\n", IPARM_[14]);
    }
 
+   SetNumThreads(wsmp_num_threads_ordering_);
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Calling WSSMP-1-2 for ordering and symbolic factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(),
                   WallclockTime());
@@ -468,10 +601,16 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Done with WSSMP-1-2 for ordering and symbolic factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(),
                   WallclockTime());
+#ifndef PARDISO_MATCHING_PREPROCESS
+   IPARM_[15] = wsmp_ordering_option_;
+#endif
 
    Index ierror = IPARM_[63];
    if( ierror != 0 )
    {
+      // the ordering may be incomplete
+      ordering_ia_.clear();
+      ordering_ja_.clear();
       if( ierror == -102 )
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
@@ -480,7 +619,7 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
       else if( ierror > 0 )
       {
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                        "Matrix appears to be singular (with ierror = %d).\n", ierror);
+                        "Matrix appears to be singular (with ierror = %" IPOPT_INDEX_FORMAT ").\n", ierror);
          if( HaveIpData() )
          {
             IpData().TimingStats().LinearSystemSymbolicFactorization().End();
@@ -490,7 +629,7 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
       else
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Error in WSMP during ordering/symbolic factorization phase.\n     Error code is %d.\n", ierror);
+                        "Error in WSMP during ordering/symbolic factorization phase.\n     Error code is %" IPOPT_INDEX_FORMAT ".\n", ierror);
       }
       if( HaveIpData() )
       {
@@ -499,9 +638,16 @@ ESymSolverStatus WsmpSolverInterface::InternalSymFact(
       return SYMSOLVER_FATAL_ERROR;
    }
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Predicted memory usage for WSSMP after symbolic factorization IPARM(23)= %d.\n", IPARM_[22]);
+                  "Predicted memory usage for WSSMP after symbolic factorization IPARM(23)= %" IPOPT_INDEX_FORMAT ".\n", IPARM_[22]);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Predicted number of nonzeros in factor for WSSMP after symbolic factorization IPARM(23)= %d.\n", IPARM_[23]);
+                  "Predicted number of nonzeros in factor for WSSMP after symbolic factorization IPARM(23)= %" IPOPT_INDEX_FORMAT ".\n", IPARM_[23]);
+
+   if( wsmp_reuse_ordering_ && !reuse_ordering )
+   {
+      // remember the structure for which the ordering has been computed
+      ordering_ia_.assign(ia, ia + dim_ + 1);
+      ordering_ja_.assign(ja, ja + nonzeros_);
+   }
 
    if( HaveIpData() )
    {
@@ -530,18 +676,18 @@ ESymSolverStatus WsmpSolverInterface::Factorization(
    {
       matrix_file_number_++;
       char buf[256];
-      Snprintf(buf, 255, "wsmp_matrix_%d_%d.dat", iter_count, matrix_file_number_);
+      Snprintf(buf, 255, "wsmp_matrix_%" IPOPT_INDEX_FORMAT "_%" IPOPT_INDEX_FORMAT ".dat", iter_count, matrix_file_number_);
       Jnlst().Printf(J_SUMMARY, J_LINEAR_ALGEBRA,
                      "Writing WSMP matrix into file %s.\n", buf);
       FILE* fp = fopen(buf, "w");
-      fprintf(fp, "%d\n", dim_); // N
+      fprintf(fp, "%" IPOPT_INDEX_FORMAT "\n", dim_); // N
       for( Index icol = 0; icol < dim_; icol++ )
       {
-         fprintf(fp, "%d", ia[icol + 1] - ia[icol]); // number of elements for this column
+         fprintf(fp, "%" IPOPT_INDEX_FORMAT, ia[icol + 1] - ia[icol]); // number of elements for this column
          // Now for each colum we write row indices and values
          for( Index irow = ia[icol]; irow < ia[icol + 1]; irow++ )
          {
-            fprintf(fp, " %23.16e %d", a_[irow - 1], ja[irow - 1]);
+            fprintf(fp, " %23.16e %" IPOPT_INDEX_FORMAT, a_[irow - 1], ja[irow - 1]);
          }
          fprintf(fp, "\n");
       }
@@ -582,6 +728,7 @@ ESymSolverStatus WsmpSolverInterface::Factorization(
    }
 #endif
 
+   SetNumThreads(wsmp_num_threads_factorization_);
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Calling WSSMP-3-3 for numerical factorization at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
 #ifdef PARDISO_MATCHING_PREPROCESS
@@ -598,7 +745,7 @@ ESymSolverStatus WsmpSolverInterface::Factorization(
    if( ierror > 0 )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "WSMP detected that the matrix is singular and encountered %d zero pivots.\n", dim_ + 1 - ierror);
+                     "WSMP detected that the matrix is singular and encountered %" IPOPT_INDEX_FORMAT " zero pivots.\n", dim_ + 1 - ierror);
       if( HaveIpData() )
       {
          IpData().TimingStats().LinearSystemFactorization().End();
@@ -615,7 +762,7 @@ ESymSolverStatus WsmpSolverInterface::Factorization(
       else
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Error in WSMP during factorization phase.\n     Error code is %d.\n", ierror);
+                        "Error in WSMP during factorization phase.\n     Error code is %" IPOPT_INDEX_FORMAT ".\n", ierror);
       }
       if( HaveIpData() )
       {
@@ -624,9 +771,9 @@ ESymSolverStatus WsmpSolverInterface::Factorization(
       return SYMSOLVER_FATAL_ERROR;
    }
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Memory usage for WSSMP after factorization IPARM(23) = %d\n", IPARM_[22]);
+                  "Memory usage for WSSMP after factorization IPARM(23) = %" IPOPT_INDEX_FORMAT "\n", IPARM_[22]);
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of nonzeros in WSSMP after factorization IPARM(24) = %d\n", IPARM_[23]);
+                  "Number of nonzeros in WSSMP after factorization IPARM(24) = %" IPOPT_INDEX_FORMAT "\n", IPARM_[23]);
 
    if( factorizations_since_recomputed_ordering_ != -1 )
    {
@@ -635,12 +782,15 @@ ESymSolverStatus WsmpSolverInterface::Factorization(
 
    negevals_ = IPARM_[21]; // Number of negative eigenvalues determined during factorization
 
+   // a new factorization starts with the default number of refinement steps
+   refinement_steps_ = 1;
+
    // Check whether the number of negative eigenvalues matches the requested
    // count
    if( check_NegEVals && (numberOfNegEVals != negevals_) )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "Wrong inertia: required are %d, but we got %d.\n", numberOfNegEVals, negevals_);
+                     "Wrong inertia: required are %" IPOPT_INDEX_FORMAT ", but we got %" IPOPT_INDEX_FORMAT ".\n", numberOfNegEVals, negevals_);
       if( skip_inertia_check_ )
       {
          Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
@@ -688,10 +838,11 @@ ESymSolverStatus WsmpSolverInterface::Solve(
    ipfint NAUX = 0;
    IPARM_[1] = 4; // Forward and Backward Elimintation
    IPARM_[2] = 5; // Iterative refinement
-   IPARM_[5] = 1;
+   IPARM_[5] = refinement_steps_;
    DPARM_[5] = 1e-12;
 
    double ddmy;
+   SetNumThreads(wsmp_num_threads_solve_);
    Jnlst().Printf(J_MOREDETAILED, J_LINEAR_ALGEBRA,
                   "Calling WSSMP-4-5 for backsolve at cpu time %10.3f (wall %10.3f).\n", CpuTime(), WallclockTime());
 
@@ -733,12 +884,12 @@ ESymSolverStatus WsmpSolverInterface::Solve(
       else
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Error in WSMP during ordering/symbolic factorization phase.\n     Error code is %d.\n", ierror);
+                        "Error in WSMP during ordering/symbolic factorization phase.\n     Error code is %" IPOPT_INDEX_FORMAT ".\n", ierror);
       }
       return SYMSOLVER_FATAL_ERROR;
    }
    Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                  "Number of iterative refinement steps in WSSMP: %d\n", IPARM_[5]);
+                  "Number of iterative refinement steps in WSSMP: %" IPOPT_INDEX_FORMAT "\n", IPARM_[5]);
 
 #ifdef PARDISO_MATCHING_PREPROCESS
    delete [] X;
@@ -758,6 +909,19 @@ bool WsmpSolverInterface::IncreaseQuality()
 {
    DBG_START_METH("WsmpSolverInterface::IncreaseQuality", dbg_verbosity);
 
+   // If tiny pivots are perturbed, first try to remove the error of the
+   // perturbation by more iterative refinement, which does not require
+   // a new factorization
+   if( wsmp_pivot_perturbation_ > 0. && !wsmp_no_pivoting_ && refinement_steps_ < wsmp_max_refinement_steps_ )
+   {
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "Increasing number of iterative refinement steps for WSMP from %" IPOPT_INDEX_FORMAT " ", refinement_steps_);
+      refinement_steps_ = Min(wsmp_max_refinement_steps_, 2 * refinement_steps_ + 1);
+      Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
+                     "to %" IPOPT_INDEX_FORMAT ".\n", refinement_steps_);
+      return true;
+   }
+
    if( factorizations_since_recomputed_ordering_ == -1 || factorizations_since_recomputed_ordering_ > 2 )
    {
       DPARM_[14] = 1.0;
@@ -820,6 +984,7 @@ ESymSolverStatus WsmpSolverInterface::DetermineDependentRows(
    ipfint idmy;
    double ddmy;
 
+   SetNumThreads(wsmp_num_threads_factorization_);
 #ifdef PARDISO_MATCHING_PREPROCESS
    IPOPT_WSMP_FUNC(wssmp, WSSMP)(&N, ia2, ja2, a2_, &ddmy, PERM_, INVP_, &ddmy, &idmy,
                            &idmy, &ddmy, &NAUX, MRP_, IPARM_, DPARM_);
@@ -845,7 +1010,7 @@ ESymSolverStatus WsmpSolverInterface::DetermineDependentRows(
    if( ierror > 0 )
    {
       Jnlst().Printf(J_DETAILED, J_LINEAR_ALGEBRA,
-                     "WSMP detected that the matrix is singular and encountered %d zero pivots.\n", dim_ + 1 - ierror);
+                     "WSMP detected that the matrix is singular and encountered %" IPOPT_INDEX_FORMAT " zero pivots.\n", dim_ + 1 - ierror);
       if( HaveIpData() )
       {
          IpData().TimingStats().LinearSystemFactorization().End();
@@ -862,7 +1027,7 @@ ESymSolverStatus WsmpSolverInterface::DetermineDependentRows(
       else
       {
          Jnlst().Printf(J_ERROR, J_LINEAR_ALGEBRA,
-                        "Error in WSMP during factorization phase.\n     Error code is %d.\n", ierror);
+                        "Error in WSMP during factorization phase.\n     Error code is %" IPOPT_INDEX_FORMAT ".\n", ierror);
       }
       if( HaveIpData() )
       {
@@ -9,6 +9,8 @@
 
 #include "IpSparseSymLinearSolverInterface.hpp"
 
+#include <vector>
+
 //#define PARDISO_MATCHING_PREPROCESS
 
 namespace Ipopt
@@ -45,6 +47,11 @@ public:
 
    virtual double* GetValuesArrayPtr();
 
+   virtual bool PreservesValues() const
+   {
+      return true;
+   }
+
    virtual ESymSolverStatus MultiSolve(
       bool         new_matrix,
       const Index* ia,
@@ -152,6 +159,22 @@ private:
    bool skip_inertia_check_;
    /** Flag indicating whether the positive definite version of WSMP should be used */
    bool wsmp_no_pivoting_;
+   /** Ordering option given to WSMP (IPARM(16)) */
+   Index wsmp_ordering_option_;
+   /** Flag indicating whether the ordering is kept for a matrix with
+    *  the same structure after the solver has been reinitialized.
+    */
+   bool wsmp_reuse_ordering_;
+   /** Number of threads for the ordering and symbolic factorization,
+    *  the numerical factorization, and the solve phase.
+    */
+   Index wsmp_num_threads_ordering_;
+   Index wsmp_num_threads_factorization_;
+   Index wsmp_num_threads_solve_;
+   /** Pivot perturbation (DPARM(22)); zero if tiny pivots are not perturbed. */
+   Number wsmp_pivot_perturbation_;
+   /** Maximal number of iterative refinement steps in the solve phase */
+   Index wsmp_max_refinement_steps_;
    ///@}
 
    /** Counter for matrix file numbers */
@@ -185,6 +208,16 @@ private:
     *  the last recomputation of the ordering.
     */
    Index factorizations_since_recomputed_ordering_;
+   /** Number of threads WSMP has been told to use most recently. */
+   Index current_num_threads_;
+   /** Number of iterative refinement steps allowed in the solve phase. */
+   Index refinement_steps_;
+   ///@}
+
+   /** @name Structure of the matrix for which PERM_ and INVP_ have been computed */
+   ///@{
+   std::vector<Index> ordering_ia_;
+   std::vector<Index> ordering_ja_;
    ///@}
 
    /** @name Solver specific information */
@@ -203,6 +236,20 @@ private:
 
    /** @name Internal functions */
    ///@{
+   /** Set the number of threads used by WSMP.
+    *
+    *  A value of zero means wsmp_num_threads.
+    */
+   void SetNumThreads(
+      Index num_threads
+   );
+
+   /** Whether PERM_ and INVP_ hold an ordering for the given structure. */
+   bool HaveOrderingFor(
+      const Index* ia,
+      const Index* ja
+   ) const;
+
    /** Call Wsmp to do the analysis phase. */
    ESymSolverStatus SymbolicFactorization(
       const Index* ia,
@@ -13,6 +13,20 @@
 #include "IpBlas.hpp"
 
 #include <cstring>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /* AMPL includes */
 #include "asl.h"
@@ -25,6 +39,267 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Pool of ASL structures for concurrent evaluations.
+ *
+ *  An ASL structure keeps the evaluation state of the model,
+ *  so it must not be used by two threads at the same time.
+ *  The pool holds several copies of the model, the first one being
+ *  AmplTNLP::asl_, and hands them out to the evaluation methods.
+ */
+class AmplEvalPool
+{
+public:
+   AmplEvalPool(
+      ASL_pfgh* main_asl
+   )
+      : asl(1, main_asl)
+   { }
+
+   /** Frees all ASL structures except the first one */
+   ~AmplEvalPool()
+   {
+      for( size_t k = 1; k < asl.size(); k++ )
+      {
+         ASL* asl_to_free = (ASL*) asl[k];
+         ASL_free(&asl_to_free);
+      }
+   }
+
+   /** ASL structures of the same model */
+   std::vector<ASL_pfgh*> asl;
+   /** nerror flag for each ASL structure */
+   std::vector<fint> nerror;
+   /** whether an ASL structure is currently used by an evaluation */
+   std::vector<bool> in_use;
+
+   /** Mutex for in_use */
+   std::mutex mutex;
+   /** Signaled when an ASL structure is returned to the pool */
+   std::condition_variable released;
+};
+
+/** An ASL structure of an AmplEvalPool that is reserved for one evaluation.
+ *
+ *  The constructor waits for a free ASL structure and tells it the
+ *  point x, the destructor returns the ASL structure to the pool.
+ */
+class AmplEvalContext
+{
+public:
+   AmplEvalContext(
+      AmplEvalPool& pool,
+      bool          halt_on_error,
+      const Number* x
+   )
+      : pool_(pool)
+   {
+      {
+         std::unique_lock<std::mutex> lock(pool_.mutex);
+         for( ;; )
+         {
+            for( k_ = 0; k_ < pool_.in_use.size() && pool_.in_use[k_]; k_++ )
+            { }
+            if( k_ < pool_.in_use.size() )
+            {
+               break;
+            }
+            pool_.released.wait(lock);
+         }
+         pool_.in_use[k_] = true;
+      }
+
+      nerror_ = NULL;
+      if( !halt_on_error )
+      {
+         nerror_ = &pool_.nerror[k_];
+         *nerror_ = 0;
+      }
+
+      ASL_pfgh* asl = pool_.asl[k_];
+      xknowne(const_cast<Number*>(x), nerror_);
+   }
+
+   ~AmplEvalContext()
+   {
+      ASL_pfgh* asl = pool_.asl[k_];
+      xunknown();
+
+      std::lock_guard<std::mutex> lock(pool_.mutex);
+      pool_.in_use[k_] = false;
+      pool_.released.notify_one();
+   }
+
+   /** The reserved ASL structure */
+   ASL_pfgh* Asl() const
+   {
+      return pool_.asl[k_];
+   }
+
+   /** nerror flag to pass to ASL calls, NULL to halt on error */
+   fint* NError() const
+   {
+      return nerror_;
+   }
+
+private:
+   AmplEvalContext(
+      const AmplEvalContext&
+   );
+
+   void operator=(
+      const AmplEvalContext&
+   );
+
+   AmplEvalPool& pool_;
+   size_t k_;
+   fint* nerror_;
+};
+
+/** The .nl file of a stub, mapped into memory.
+ *
+ *  This allows to read the model into further ASL structures from
+ *  memory instead of reading the file again.  If stub is NULL or the
+ *  file cannot be mapped, Data returns NULL.
+ */
+class AmplNlFileMap
+{
+public:
+   AmplNlFileMap(
+      const char* stub
+   )
+      : data_(NULL),
+        size_(0)
+   {
+#ifndef _WIN32
+      if( stub == NULL )
+      {
+         return;
+      }
+
+      // as jac0dim, try the stub with .nl appended first
+      std::string filename = std::string(stub) + ".nl";
+      int fd = open(filename.c_str(), O_RDONLY);
+      if( fd < 0 )
+      {
+         fd = open(stub, O_RDONLY);
+      }
+      if( fd < 0 )
+      {
+         return;
+      }
+
+      // the content is read like a string, so it must be followed by a
+      // 0 byte, which the zero-filled rest of the last page provides
+      struct stat st;
+      long pagesize = sysconf(_SC_PAGESIZE);
+      if( fstat(fd, &st) == 0 && st.st_size > 0 && pagesize > 0 && st.st_size % pagesize != 0 )
+      {
+         void* data = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+         if( data != MAP_FAILED )
+         {
+            data_ = (char*) data;
+            size_ = (size_t) st.st_size;
+            madvise(data, size_, MADV_SEQUENTIAL);
+         }
+      }
+      close(fd);
+#else
+      (void) stub;
+#endif
+   }
+
+   ~AmplNlFileMap()
+   {
+#ifndef _WIN32
+      if( data_ != NULL )
+      {
+         munmap(data_, size_);
+      }
+#endif
+   }
+
+   /** Content of the .nl file, or NULL */
+   char* Data() const
+   {
+      return data_;
+   }
+
+   /** Length of the content */
+   size_t Size() const
+   {
+      return size_;
+   }
+
+private:
+   AmplNlFileMap(
+      const AmplNlFileMap&
+   );
+
+   void operator=(
+      const AmplNlFileMap&
+   );
+
+   char* data_;
+   size_t size_;
+};
+
+/** Reads the model into another ASL structure for concurrent evaluations.
+ *
+ *  The model is read from nl_content if not NULL, otherwise from the
+ *  .nl file of the stub.
+ *
+ *  @return the new ASL structure, or NULL if the .nl file could not be read
+ */
+static ASL_pfgh* read_eval_asl(
+   const char* stub,
+   const char* nl_content,
+   size_t      nl_content_length
+)
+{
+   ASL_pfgh* asl = (ASL_pfgh*) ASL_alloc(ASL_read_pfgh);
+
+   FILE* nl;
+   if( nl_content )
+   {
+      nl = jac0dim(const_cast<char*>(nl_content), -(ftnlen )nl_content_length);
+   }
+   else
+   {
+      nl = jac0dim(const_cast<char*>(stub), (fint )strlen(stub));
+   }
+
+   // starting point and suffixes are taken from the main ASL structure
+   want_xpi0 = 0;
+   obj_no = 0;
+
+   if( nl == NULL || pfgh_read(nl, ASL_return_read_err | ASL_findgroups) != ASL_readerr_none )
+   {
+      ASL* asl_to_free = (ASL*) asl;
+      ASL_free(&asl_to_free);
+      return NULL;
+   }
+
+   return asl;
+}
+
+/** Calls hesset and sphsetup for another ASL structure as in AmplTNLP::call_hesset */
+static void call_eval_asl_hesset(
+   ASL_pfgh* asl,
+   int       main_obj_no
+)
+{
+   obj_no = main_obj_no;
+   if( n_obj == 0 )
+   {
+      hesset(1, 0, 0, 0, nlc);
+   }
+   else
+   {
+      hesset(1, obj_no, 1, 0, nlc);
+   }
+   sphsetup(-1, 1, 1, 1);
+}
+
 AmplTNLP::AmplTNLP(
    const SmartPtr<const Journalist>& jnlst,
    const SmartPtr<OptionsList>       options,
@@ -53,7 +328,9 @@ AmplTNLP::AmplTNLP(
      hesset_called_(false),
      set_active_objective_called_(false),
      Oinfo_ptr_(NULL),
-     suffix_handler_(suffix_handler)
+     suffix_handler_(suffix_handler),
+     eval_num_threads_(1),
+     eval_pool_(NULL)
 {
    DBG_START_METH("AmplTNLP::AmplTNLP", dbg_verbosity);
 
@@ -76,6 +353,8 @@ AmplTNLP::AmplTNLP(
    // Read the options and stub
    char* stub = get_options(options, ampl_options_list, ampl_option_string, ampl_invokation_string, ampl_banner_string,
                             argv);
+
+   nl_read_time_.Start();
    FILE* nl = NULL;
    if( nl_file_content )
    {
@@ -195,20 +474,64 @@ AmplTNLP::AmplTNLP(
          break;
       }
    }
+
+   // read the model again for each additional evaluation thread, from
+   // memory if possible
+   if( eval_num_threads_ > 1 )
+   {
+      AmplNlFileMap nl_map(nl_file_content ? NULL : stub);
+      const char* nl_content = nl_map.Data();
+      size_t nl_content_length = nl_map.Size();
+      if( nl_file_content )
+      {
+         nl_content = nl_file_content->c_str();
+         nl_content_length = nl_file_content->length();
+      }
+
+      eval_pool_ = new AmplEvalPool(asl_);
+      for( Index k = 1; k < eval_num_threads_; k++ )
+      {
+         ASL_pfgh* eval_asl = read_eval_asl(stub, nl_content, nl_content_length);
+         if( eval_asl == NULL )
+         {
+            jnlst_->Printf(J_ERROR, J_MAIN, "Cannot read .nl file again for concurrent evaluations\n");
+            THROW_EXCEPTION(INVALID_TNLP, "Cannot read .nl file again for concurrent evaluations");
+         }
+         eval_pool_->asl.push_back(eval_asl);
+      }
+      eval_pool_->nerror.resize(eval_num_threads_, 0);
+      eval_pool_->in_use.resize(eval_num_threads_, false);
+
+      // ASL_alloc made the last ASL structure the current one
+      cur_ASL = (ASL*) asl_;
+
+      jnlst_->Printf(J_DETAILED, J_MAIN, "Read the model into %" IPOPT_INDEX_FORMAT " ASL structures for concurrent evaluations.\n",
+                     eval_num_threads_);
+   }
+
+   nl_read_time_.End();
 }
 
 void AmplTNLP::set_active_objective(
    Index in_obj_no
 )
 {
+   ASL_pfgh* asl = asl_;
    if( hesset_called_ )
    {
-      jnlst_->Printf(J_ERROR, J_MAIN,
-                     "Internal error: AmplTNLP::set_active_objective called after AmplTNLP::call_hesset.\n");
-      THROW_EXCEPTION(INVALID_TNLP,
-                      "Internal error: AmplTNLP::set_active_objective called after AmplTNLP::call_hesset.");
+      // the Hessian structure has been set up for the current objective
+      // already, and only needs to be set up again for another one
+      if( in_obj_no == obj_no )
+      {
+         return;
+      }
+      obj_no = in_obj_no;
+      set_active_objective_called_ = true;
+      objval_called_with_current_x_ = false;
+      hesset_called_ = false;
+      call_hesset();
+      return;
    }
-   ASL_pfgh* asl = asl_;
    obj_no = in_obj_no;
    set_active_objective_called_ = true;
 }
@@ -248,11 +571,21 @@ void AmplTNLP::call_hesset()
 
    // find the nonzero structure for the hessian parameters to
    // sphsetup:
+   hessian_setup_time_.Start();
    int coeff_obj = 1;
    int mult_supplied = 1; // multipliers will be supplied
    int uptri = 1; // only need the upper triangular part
    nz_h_full_ = sphsetup(-1, coeff_obj, mult_supplied, uptri);
 
+   if( eval_pool_ != NULL )
+   {
+      for( size_t k = 1; k < eval_pool_->asl.size(); k++ )
+      {
+         call_eval_asl_hesset(eval_pool_->asl[k], obj_no);
+      }
+   }
+   hessian_setup_time_.End();
+
    hesset_called_ = true;
 }
 
@@ -260,6 +593,9 @@ AmplTNLP::~AmplTNLP()
 {
    ASL_pfgh* asl = asl_;
 
+   delete eval_pool_;
+   eval_pool_ = NULL;
+
    if( asl )
    {
       if( X0 )
@@ -497,6 +833,28 @@ bool AmplTNLP::eval_f(
 {
    DBG_START_METH("AmplTNLP::eval_f",
                   dbg_verbosity);
+   if( eval_pool_ != NULL )
+   {
+      AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+      ASL_pfgh* asl = context.Asl();
+      if( !nerror_ok(context.NError()) )
+      {
+         return false;
+      }
+
+      obj_value = 0.;
+      if( n_obj > 0 )
+      {
+         Number retval = objval(obj_no, const_cast<Number*>(x), context.NError());
+         if( !nerror_ok(context.NError()) )
+         {
+            return false;
+         }
+         obj_value = obj_sign_ * retval;
+      }
+      return true;
+   }
+
    if( !apply_new_x(new_x, n, x) )
    {
       return false;
@@ -514,6 +872,39 @@ bool AmplTNLP::eval_grad_f(
 {
    DBG_START_METH("AmplTNLP::eval_grad_f",
                   dbg_verbosity);
+   if( eval_pool_ != NULL )
+   {
+      AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+      ASL_pfgh* asl = context.Asl();
+      if( !nerror_ok(context.NError()) )
+      {
+         return false;
+      }
+
+      if( n_obj == 0 )
+      {
+         for( Index i = 0; i < n; i++ )
+         {
+            grad_f[i] = 0.;
+         }
+         return true;
+      }
+
+      objgrd(obj_no, const_cast<Number*>(x), grad_f, context.NError());
+      if( !nerror_ok(context.NError()) )
+      {
+         return false;
+      }
+      if( obj_sign_ == -1 )
+      {
+         for( Index i = 0; i < n; i++ )
+         {
+            grad_f[i] *= -1.;
+         }
+      }
+      return true;
+   }
+
    ASL_pfgh* asl = asl_;
    DBG_ASSERT(asl_);
 
@@ -562,6 +953,19 @@ bool AmplTNLP::eval_g(
    DBG_ASSERT(n == n_var);
    DBG_ASSERT(m == n_con);
 
+   if( eval_pool_ != NULL )
+   {
+      AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+      ASL_pfgh* asl = context.Asl();
+      if( !nerror_ok(context.NError()) )
+      {
+         return false;
+      }
+
+      conval(const_cast<Number*>(x), g, context.NError());
+      return nerror_ok(context.NError());
+   }
+
    if( !apply_new_x(new_x, n, x) )
    {
       return false;
@@ -570,6 +974,85 @@ bool AmplTNLP::eval_g(
    return internal_conval(x, m, g);
 }
 
+AmplTNLP::EvaluationConcurrency AmplTNLP::get_evaluation_concurrency()
+{
+   return eval_pool_ != NULL ? CONCURRENCY_ROW_RANGES : CONCURRENCY_NONE;
+}
+
+bool AmplTNLP::eval_g_rows(
+   Index         /*n*/,
+   const Number* x,
+   bool          /*new_x*/,
+   Index         /*m*/,
+   Index         first_row,
+   Index         last_row,
+   Number*       g
+)
+{
+   DBG_START_METH("AmplTNLP::eval_g_rows", dbg_verbosity);
+
+   if( eval_pool_ == NULL )
+   {
+      return false;
+   }
+
+   AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+   ASL_pfgh* asl = context.Asl();
+   if( !nerror_ok(context.NError()) )
+   {
+      return false;
+   }
+
+   for( Index i = first_row; i < last_row; i++ )
+   {
+      g[i] = conival(i, const_cast<Number*>(x), context.NError());
+      if( !nerror_ok(context.NError()) )
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+bool AmplTNLP::eval_jac_g_rows(
+   Index         /*n*/,
+   const Number* x,
+   bool          /*new_x*/,
+   Index         /*m*/,
+   Index         first_row,
+   Index         last_row,
+   Index         /*nele_jac*/,
+   Number*       values
+)
+{
+   DBG_START_METH("AmplTNLP::eval_jac_g_rows", dbg_verbosity);
+
+   if( eval_pool_ == NULL )
+   {
+      return false;
+   }
+
+   AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+   ASL_pfgh* asl = context.Asl();
+   if( !nerror_ok(context.NError()) )
+   {
+      return false;
+   }
+
+   // let congrd store the partials at the goff positions, as jacval does
+   asl->i.congrd_mode = 2;
+   bool retval = true;
+   for( Index i = first_row; i < last_row && retval; i++ )
+   {
+      congrd(i, const_cast<Number*>(x), values, context.NError());
+      retval = nerror_ok(context.NError());
+   }
+   asl->i.congrd_mode = 0;
+
+   return retval;
+}
+
 bool AmplTNLP::eval_jac_g(
    Index         n,
    const Number* x,
@@ -610,6 +1093,19 @@ bool AmplTNLP::eval_jac_g(
    }
    else if( !iRow && !jCol && values )
    {
+      if( eval_pool_ != NULL )
+      {
+         AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+         asl = context.Asl();
+         if( !nerror_ok(context.NError()) )
+         {
+            return false;
+         }
+
+         jacval(const_cast<Number*>(x), values, context.NError());
+         return nerror_ok(context.NError());
+      }
+
       if( !apply_new_x(new_x, n, x) )
       {
          return false;
@@ -669,6 +1165,11 @@ bool AmplTNLP::eval_h(
    }
    else if( !iRow && !jCol && values )
    {
+      if( eval_pool_ != NULL )
+      {
+         return eval_h_concurrent(x, obj_factor, m, lambda, nele_hess, values);
+      }
+
       if( !apply_new_x(new_x, n, x) )
       {
          return false;
@@ -705,6 +1206,118 @@ bool AmplTNLP::eval_h(
    return false;
 }
 
+bool AmplTNLP::eval_h_concurrent(
+   const Number* x,
+   Number        obj_factor,
+   Index         m,
+   const Number* lambda,
+   Index         nele_hess,
+   Number*       values
+)
+{
+   DBG_START_METH("AmplTNLP::eval_h_concurrent",
+                  dbg_verbosity);
+
+   // The constraints are split into ranges, and the Hessian of the
+   // Lagrangian of each range (the first with the objective) is computed
+   // with its own ASL structure.  The parts are summed up afterwards.
+   int nparts = 1;
+#ifdef _OPENMP
+   if( !omp_in_parallel() )
+   {
+      nparts = (int) Min((Index) omp_get_max_threads(), (Index) eval_pool_->asl.size());
+      nparts = (int) Max((Index) 1, Min((Index) nparts, m));
+   }
+#endif
+
+   std::vector<Number> part_values((size_t) (nparts - 1) * nele_hess);
+
+   // Exceptions must not leave the parallel region; they are turned
+   // into a failed evaluation
+   bool* ok = new bool[nparts];
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static, 1) num_threads(nparts)
+#endif
+   for( int part = 0; part < nparts; part++ )
+   {
+      try
+      {
+         Index first_row = part * (m / nparts) + Min((Index) part, m % nparts);
+         Index last_row = (part + 1) * (m / nparts) + Min((Index) part + 1, m % nparts);
+         ok[part] = eval_h_part(x, part == 0 ? obj_factor : 0., m, lambda, first_row, last_row,
+                                part == 0 ? values : &part_values[(size_t) (part - 1) * nele_hess]);
+      }
+      catch( ... )
+      {
+         ok[part] = false;
+      }
+   }
+
+   bool retval = true;
+   for( int part = 0; part < nparts; part++ )
+   {
+      retval = retval && ok[part];
+   }
+   delete[] ok;
+
+   if( retval )
+   {
+      for( int part = 1; part < nparts; part++ )
+      {
+         IpBlasDaxpy(nele_hess, 1., &part_values[(size_t) (part - 1) * nele_hess], 1, values, 1);
+      }
+   }
+
+   return retval;
+}
+
+bool AmplTNLP::eval_h_part(
+   const Number* x,
+   Number        obj_factor,
+   Index         m,
+   const Number* lambda,
+   Index         first_row,
+   Index         last_row,
+   Number*       values
+)
+{
+   AmplEvalContext context(*eval_pool_, nerror_ == NULL, x);
+   ASL_pfgh* asl = context.Asl();
+   if( !nerror_ok(context.NError()) )
+   {
+      return false;
+   }
+
+   // sphes needs the functions with nonzero weight evaluated at x
+   std::vector<real> OW(Max(1, n_obj), 0.);
+   if( n_obj > 0 && obj_factor != 0. )
+   {
+      objval(obj_no, const_cast<Number*>(x), context.NError());
+      if( !nerror_ok(context.NError()) )
+      {
+         return false;
+      }
+      OW[obj_no] = obj_sign_ * obj_factor;
+   }
+
+   std::vector<real> y(Max(1, m), 0.);
+   for( Index i = first_row; i < last_row; i++ )
+   {
+      if( lambda[i] != 0. )
+      {
+         conival(i, const_cast<Number*>(x), context.NError());
+         if( !nerror_ok(context.NError()) )
+         {
+            return false;
+         }
+         y[i] = lambda[i];
+      }
+   }
+
+   sphes(values, -1, &OW[0], &y[0]);
+   return true;
+}
+
 void AmplTNLP::finalize_solution(
    SolverReturn               status,
    Index                      n,
@@ -930,6 +1543,23 @@ bool AmplTNLP::apply_new_x(
    return true;
 }
 
+void AmplTNLP::PrintTimingStatistics(
+   Journalist&      jnlst,
+   EJournalLevel    level,
+   EJournalCategory category
+) const
+{
+   if( !jnlst.ProduceOutput(level, category) )
+   {
+      return;
+   }
+
+   jnlst.Printf(level, category,
+                "AMPL .nl file reading...............: %10.3f (sys: %10.3f wall: %10.3f)\n", nl_read_time_.TotalCpuTime(), nl_read_time_.TotalSysTime(), nl_read_time_.TotalWallclockTime());
+   jnlst.Printf(level, category,
+                "AMPL Hessian structure (sphsetup)...: %10.3f (sys: %10.3f wall: %10.3f)\n", hessian_setup_time_.TotalCpuTime(), hessian_setup_time_.TotalSysTime(), hessian_setup_time_.TotalWallclockTime());
+}
+
 void AmplTNLP::write_solution_file(
    const std::string& message
 ) const
@@ -1156,6 +1786,33 @@ extern "C"
 
       return retval;
    }
+
+   static char* get_evalthreads_opt(
+      Option_Info* oi,
+      keyword*     kw,
+      char*        value
+   )
+   {
+      AmplOptionsList::PrivatInfo* pinfo = (AmplOptionsList::PrivatInfo*) kw->info;
+
+      int int_val;
+      kw->info = &int_val;
+      char* retval = I_val(oi, kw, value);
+      kw->info = (void*) pinfo;
+
+      if( int_val < 1 )
+      {
+         pinfo->Jnlst()->Printf(J_ERROR, J_MAIN, "\nInvalid value \"%s\" for option %s.\n", value, kw->name);
+         THROW_EXCEPTION(OPTION_INVALID, "Invalid option");
+      }
+
+      if( pinfo->EvalNumThreads() != NULL )
+      {
+         *pinfo->EvalNumThreads() = int_val;
+      }
+
+      return retval;
+   }
 }
 
 AmplOptionsList::AmplOption::AmplOption(
@@ -1189,7 +1846,8 @@ AmplOptionsList::~AmplOptionsList()
 void* AmplOptionsList::Keywords(
    const SmartPtr<OptionsList>& options,
    SmartPtr<const Journalist>   jnlst,
-   void**                       nerror
+   void**                       nerror,
+   Index*                       eval_num_threads /* = NULL */
 )
 {
    if( keywds_ )
@@ -1247,10 +1905,19 @@ void* AmplOptionsList::Keywords(
             keywords[ioption].kf = WS_val;
             break;
          case HaltOnError_Option:
+         {
             PrivatInfo* pinfo = new PrivatInfo(iter->second->IpoptOptionName(), options, jnlst, nerror);
             keywords[ioption].info = (void*) pinfo;
             keywords[ioption].kf = get_haltonerror_opt;
-            break;
+         }
+         break;
+         case EvalThreads_Option:
+         {
+            PrivatInfo* pinfo = new PrivatInfo(iter->second->IpoptOptionName(), options, jnlst, NULL, eval_num_threads);
+            keywords[ioption].info = (void*) pinfo;
+            keywords[ioption].kf = get_evalthreads_opt;
+         }
+         break;
       }
       ioption++;
    }
@@ -1549,9 +2216,14 @@ AmplTNLP::get_options(
    ampl_options_list->AddAmplOption("halt_on_ampl_error", "", AmplOptionsList::HaltOnError_Option,
                                     "Exit with message on evaluation error");
 
+   // special AMPL option to evaluate the model concurrently with several
+   // copies of the ASL structure
+   ampl_options_list->AddAmplOption("eval_num_threads", "", AmplOptionsList::EvalThreads_Option,
+                                    "Number of copies of the model for concurrent function evaluations (default 1)");
+
    int n_options = ampl_options_list->NumberOfAmplOptions();
 
-   keyword* keywds = (keyword*) ampl_options_list->Keywords(options, jnlst_, (void**) &nerror_);
+   keyword* keywds = (keyword*) ampl_options_list->Keywords(options, jnlst_, (void**) &nerror_, &eval_num_threads_);
 
    static const char sname_default[] = "ipopt";
    static const char bsname_default[] = "Ipopt " IPOPT_VERSION;
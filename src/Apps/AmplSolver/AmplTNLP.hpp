@@ -11,6 +11,7 @@
 #include "IpTNLP.hpp"
 #include "IpJournalist.hpp"
 #include "IpOptionsList.hpp"
+#include "IpTimedTask.hpp"
 
 #include <map>
 #include <string>
@@ -132,7 +133,8 @@ public:
       Number_Option,
       Integer_Option,
       WS_Option,         /**< this is for AMPL's internal wantsol callback */
-      HaltOnError_Option /**< this is for our setting of the nerror_ member */
+      HaltOnError_Option, /**< this is for our setting of the nerror_ member */
+      EvalThreads_Option /**< this is for our setting of the eval_num_threads_ member */
    };
 
    /** Ampl Option class containing name, type and description for an AMPL option */
@@ -196,12 +198,14 @@ public:
          const std::string          ipopt_name,
          SmartPtr<OptionsList>      options,
          SmartPtr<const Journalist> jnlst,
-         void**                     nerror = NULL
+         void**                     nerror = NULL,
+         Index*                     eval_num_threads = NULL
       )
          : ipopt_name_(ipopt_name),
            options_(options),
            jnlst_(jnlst),
-           nerror_(nerror)
+           nerror_(nerror),
+           eval_num_threads_(eval_num_threads)
       {
       }
       const std::string& IpoptName() const
@@ -220,11 +224,16 @@ public:
       {
          return nerror_;
       }
+      Index* EvalNumThreads()
+      {
+         return eval_num_threads_;
+      }
    private:
       const std::string ipopt_name_;
       const SmartPtr<OptionsList> options_;
       const SmartPtr<const Journalist> jnlst_;
       void** nerror_;
+      Index* eval_num_threads_;
    };
 
 public:
@@ -259,7 +268,8 @@ public:
    void* Keywords(
       const SmartPtr<OptionsList>& options,
       SmartPtr<const Journalist>   jnlst,
-      void**                       nerror
+      void**                       nerror,
+      Index*                       eval_num_threads = NULL
    );
 
 private:
@@ -312,6 +322,8 @@ private:
    Index nkeywds_;
 };
 
+class AmplEvalPool;
+
 /** Ampl Interface, implemented as a TNLP. */
 class IPOPTAMPLINTERFACELIB_EXPORT AmplTNLP: public TNLP
 {
@@ -434,6 +446,40 @@ public:
       Number*       values
    );
 
+   /** @name Methods for concurrent evaluations
+    *
+    *  If the AMPL option eval_num_threads is larger than 1, then the
+    *  .nl file is read into several ASL structures, and each evaluation
+    *  uses one ASL structure that is not in use by another thread.
+    *  The constraints and the Jacobian can then be evaluated for ranges
+    *  of rows in parallel, and eval_h splits the constraints among the
+    *  ASL structures and sums up the Hessians of the parts.
+    */
+   ///@{
+   virtual EvaluationConcurrency get_evaluation_concurrency();
+
+   virtual bool eval_g_rows(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         first_row,
+      Index         last_row,
+      Number*       g
+   );
+
+   virtual bool eval_jac_g_rows(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         first_row,
+      Index         last_row,
+      Index         nele_jac,
+      Number*       values
+   );
+   ///@}
+
    virtual bool get_scaling_parameters(
       Number& obj_scaling,
       bool&   use_x_scaling,
@@ -488,6 +534,13 @@ public:
       const std::string& message
    ) const;
 
+   /** Print the time spent in reading the .nl file and in setting up the Hessian structure. */
+   void PrintTimingStatistics(
+      Journalist&      jnlst,
+      EJournalLevel    level,
+      EJournalCategory category
+   ) const;
+
    /** Give the number of binary and integer variables.
     *
     *  AMPL orders the variables like (continuous, binary, integer).
@@ -509,9 +562,12 @@ public:
     *  considered.
     *
     *  This method must be called after the constructor,
-    *  and before anything else is called.  It can only be called
-    *  once, and if there is more than one objective function in the
-    *  AMPL model, it MUST be called.
+    *  and before anything else is called.  If there is more than one
+    *  objective function in the AMPL model, it MUST be called.
+    *
+    *  It can be called again between two solves to change the objective.
+    *  The Hessian structure is then set up again by sphsetup, unless the
+    *  objective does not change.
     */
    void set_active_objective(
       Index obj_no
@@ -648,6 +704,20 @@ protected:
    /** Suffix Handler */
    SmartPtr<AmplSuffixHandler> suffix_handler_;
 
+   /** Number of ASL structures for concurrent evaluations, as given by the AMPL option eval_num_threads */
+   Index eval_num_threads_;
+
+   /** Pool of ASL structures for concurrent evaluations, or NULL if eval_num_threads_ is 1 */
+   AmplEvalPool* eval_pool_;
+
+   /**@name Timing of the model setup */
+   ///@{
+   /** reading of the .nl file into all ASL structures in the constructor */
+   TimedTask nl_read_time_;
+   /** setup of the Hessian structure by sphsetup in call_hesset */
+   TimedTask hessian_setup_time_;
+   ///@}
+
    /** Make the objective call to ampl */
    bool internal_objval(
       const Number* x,
@@ -684,6 +754,30 @@ protected:
       char**&                      argv
    );
 
+   /** Evaluates the Hessian of the Lagrangian with the ASL structures of eval_pool_ */
+   bool eval_h_concurrent(
+      const Number* x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      Index         nele_hess,
+      Number*       values
+   );
+
+   /** Evaluates the Hessian of the Lagrangian for a range of constraints with one ASL structure of eval_pool_
+    *
+    *  The objective is included if obj_factor is not zero.
+    */
+   bool eval_h_part(
+      const Number* x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      Index         first_row,
+      Index         last_row,
+      Number*       values
+   );
+
    /** whether the ampl nerror code is ok */
    bool nerror_ok(
       void* nerror
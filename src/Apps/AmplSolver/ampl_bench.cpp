@@ -0,0 +1,813 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+// Benchmark runner for a corpus of AMPL models.
+//
+// Solves every .nl file that is given on the command line or found in a
+// given directory (recursively) and writes one CSV line per solve with
+// the return status, the solve statistics, the size of the model, the
+// wallclock times of the main tasks of the timing statistics, and the
+// peak resident memory of the solve.  The options are read from the
+// options file (ipopt.opt, or the file given with -s), so all models
+// are solved with the same options.
+//
+// Each solve runs in a process of its own, which loads the model with
+// AmplTNLP and solves it in-process, so that a model for which the ASL
+// exits or Ipopt crashes only loses its own line, and the peak memory
+// is that of the single solve.  With -j, several models are solved at
+// the same time, and with -c, the processes of the job slots are pinned
+// to the given CPUs.
+//
+// With -b, or with "ampl_bench compare OLD.csv NEW.csv", a report is
+// written that compares the results with those of a previous run:
+// changes of the return status and the number of iterations, and the
+// models whose wallclock time or memory changed by more than the
+// tolerance, followed by a summary with the geometric mean of the time
+// ratios of the models solved in both runs.
+
+#include "AmplTNLP.hpp"
+#include "IpIpoptApplication.hpp"
+#include "IpSolveStatistics.hpp"
+#include "IpIpoptData.hpp"
+#include "IpOrigIpoptNLP.hpp"
+#include "IpTimingStatistics.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace Ipopt;
+
+/** Settings of a benchmark run */
+struct BenchSettings
+{
+   /** the .nl files */
+   std::vector<std::string> models;
+   /** options file, empty for ipopt.opt */
+   std::string options_file;
+   /** number of concurrent solves */
+   int jobs;
+   /** CPUs for the job slots, empty for no pinning */
+   std::vector<int> cpus;
+   int repetitions;
+   /** wallclock time limit in seconds for a solve process, 0 for none */
+   int time_limit;
+   FILE* out;
+};
+
+/** Task of the timing statistics that is reported in the CSV output */
+struct BenchTask
+{
+   const char* column;
+   TimedTask& (TimingStatistics::*task)();
+};
+
+static const BenchTask bench_tasks[] =
+{
+   { "search_direction_wall", &TimingStatistics::ComputeSearchDirection },
+   { "line_search_wall", &TimingStatistics::ComputeAcceptableTrialPoint },
+   { "symbolic_factorization_wall", &TimingStatistics::LinearSystemSymbolicFactorization },
+   { "factorization_wall", &TimingStatistics::LinearSystemFactorization },
+   { "backsolve_wall", &TimingStatistics::LinearSystemBackSolve }
+};
+static const size_t num_bench_tasks = sizeof(bench_tasks) / sizeof(bench_tasks[0]);
+
+static void print_usage(
+   const char* exe
+)
+{
+   printf("Usage: %s [-s OPTFILE] [-j JOBS] [-c CPUS] [-r REPEAT] [-T SECONDS] [-o FILE] [-b BASELINE] [-t TOL] PATH...\n", exe);
+   printf("          solves all .nl files given as PATH or found in the directories given as PATH\n");
+   printf("          and writes the solve and timing statistics and the peak memory of each solve as CSV.\n");
+   printf("          -s OPTFILE   options file for all solves (default: ipopt.opt)\n");
+   printf("          -j JOBS      number of models that are solved at the same time (default: 1)\n");
+   printf("          -c CPUS      comma separated list of CPUs to which the job slots are pinned\n");
+   printf("          -r REPEAT    number of solves of each model (default: 1)\n");
+   printf("          -T SECONDS   wallclock time limit of a solve process (default: none)\n");
+   printf("          -o FILE      output file (default: standard output)\n");
+   printf("          -b BASELINE  CSV output of a previous run to compare with\n");
+   printf("          -t TOL       relative change of times and memory that is reported (default: 0.1)\n");
+   printf("          print_level is 0 and print_timing_statistics is yes unless set in the options file.\n");
+   printf("       %s compare OLD.csv NEW.csv [-t TOL]\n", exe);
+   printf("          compares the results of two runs.\n");
+}
+
+/** Split a comma separated list */
+static std::vector<std::string> split_list(
+   const std::string& str
+)
+{
+   std::vector<std::string> items;
+   size_t start = 0;
+   while( start <= str.size() )
+   {
+      size_t end = str.find(',', start);
+      if( end == std::string::npos )
+      {
+         end = str.size();
+      }
+      items.push_back(str.substr(start, end - start));
+      start = end + 1;
+   }
+   return items;
+}
+
+/** Whether the name of a file ends with .nl */
+static bool is_nl_file(
+   const std::string& name
+)
+{
+   return name.size() > 3 && name.compare(name.size() - 3, 3, ".nl") == 0;
+}
+
+/** Add the .nl files of path, which is a file or a directory that is searched recursively */
+static bool collect_models(
+   const std::string&        path,
+   std::vector<std::string>& models
+)
+{
+   struct stat st;
+   if( stat(path.c_str(), &st) != 0 )
+   {
+      fprintf(stderr, "Cannot access %s: %s\n", path.c_str(), strerror(errno));
+      return false;
+   }
+   if( !S_ISDIR(st.st_mode) )
+   {
+      models.push_back(path);
+      return true;
+   }
+
+   DIR* dir = opendir(path.c_str());
+   if( dir == NULL )
+   {
+      fprintf(stderr, "Cannot open directory %s: %s\n", path.c_str(), strerror(errno));
+      return false;
+   }
+   std::vector<std::string> entries;
+   for( struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir) )
+   {
+      if( entry->d_name[0] != '.' )
+      {
+         entries.push_back(entry->d_name);
+      }
+   }
+   closedir(dir);
+   // the order of readdir is arbitrary
+   std::sort(entries.begin(), entries.end());
+
+   bool ok = true;
+   for( size_t i = 0; i < entries.size(); ++i )
+   {
+      std::string entry_path = path + "/" + entries[i];
+      if( stat(entry_path.c_str(), &st) != 0 )
+      {
+         continue;
+      }
+      if( S_ISDIR(st.st_mode) )
+      {
+         ok = collect_models(entry_path, models) && ok;
+      }
+      else if( is_nl_file(entries[i]) )
+      {
+         models.push_back(entry_path);
+      }
+   }
+   return ok;
+}
+
+static void write_header(
+   FILE* out
+)
+{
+   fprintf(out, "model,repetition,process,status,n,m,nnz_jac,nnz_hess,iterations,objective,constr_viol,dual_inf,compl,"
+           "kkt_error,obj_evals,constr_evals,obj_grad_evals,constr_jac_evals,hess_evals,cpu_time,sys_time,wall_time,"
+           "func_eval_wall,model_setup_wall,peak_rss_kb");
+   for( size_t k = 0; k < num_bench_tasks; ++k )
+   {
+      fprintf(out, ",%s", bench_tasks[k].column);
+   }
+   fprintf(out, "\n");
+}
+
+/** Peak resident memory of this process in KiB */
+static long peak_rss_kb()
+{
+   struct rusage usage;
+   if( getrusage(RUSAGE_SELF, &usage) != 0 )
+   {
+      return -1;
+   }
+#ifdef __APPLE__
+   // bytes on macOS
+   return usage.ru_maxrss / 1024;
+#else
+   return usage.ru_maxrss;
+#endif
+}
+
+/** Solve a model and write the CSV columns after model, repetition, and process to fd.
+ *
+ *  This runs in the solve process.
+ */
+static void solve_model(
+   const BenchSettings& settings,
+   const std::string&   model,
+   int                  fd
+)
+{
+   SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+   app->RethrowNonIpoptException(false);
+
+   ApplicationReturnStatus status = app->Initialize(settings.options_file.empty() ? "ipopt.opt" : settings.options_file);
+   Index n = 0, m = 0, nnz_jac = 0, nnz_h = 0;
+   Number setup_wall = 0.;
+   SmartPtr<AmplTNLP> ampl_tnlp;
+   if( status == Solve_Succeeded )
+   {
+      app->Options()->SetIntegerValueIfUnset("print_level", 0);
+      app->Options()->SetStringValueIfUnset("sb", "yes");
+      // the tasks of the timing statistics are timed only if they are printed
+      app->Options()->SetStringValueIfUnset("print_timing_statistics", "yes");
+
+      // arguments as for ampl_ipopt without -AMPL, so that no .sol file is written
+      std::vector<char*> args;
+      args.push_back(const_cast<char*>("ampl_bench"));
+      args.push_back(const_cast<char*>(model.c_str()));
+      args.push_back(NULL);
+      char** argv = &args[0];
+
+      Number start = WallclockTime();
+      ampl_tnlp = new AmplTNLP(ConstPtr(app->Jnlst()), app->Options(), argv);
+      setup_wall = WallclockTime() - start;
+
+      TNLP::IndexStyleEnum index_style;
+      ampl_tnlp->get_nlp_info(n, m, nnz_jac, nnz_h, index_style);
+
+      // process the output related options again, as ampl_ipopt does
+      status = app->Initialize();
+   }
+   if( status == Solve_Succeeded )
+   {
+      status = app->OptimizeTNLP(GetRawPtr(ampl_tnlp));
+   }
+
+   Index iters = -1;
+   Number obj = 0., constr_viol = 0., dual_inf = 0., compl_ = 0., kkt_error = 0.;
+   Index n_obj = 0, n_constr = 0, n_grad = 0, n_jac = 0, n_hess = 0;
+   Number cpu = 0., sys = 0., wall = 0., func_wall = 0.;
+   std::vector<Number> task_walls(num_bench_tasks, 0.);
+   SmartPtr<SolveStatistics> stats = app->Statistics();
+   if( IsValid(stats) )
+   {
+      iters = stats->IterationCount();
+      obj = stats->FinalObjective();
+      stats->Infeasibilities(dual_inf, constr_viol, compl_, kkt_error);
+      stats->NumberOfEvaluations(n_obj, n_constr, n_grad, n_jac, n_hess);
+      cpu = stats->TotalCpuTime();
+      sys = stats->TotalSysTime();
+      wall = stats->TotalWallclockTime();
+   }
+   OrigIpoptNLP* orignlp = dynamic_cast<OrigIpoptNLP*>(GetRawPtr(app->IpoptNLPObject()));
+   if( orignlp != NULL )
+   {
+      func_wall = orignlp->TotalFunctionEvaluationWallclockTime();
+   }
+   SmartPtr<IpoptData> ip_data = app->IpoptDataObject();
+   if( IsValid(stats) && IsValid(ip_data) )
+   {
+      for( size_t k = 0; k < num_bench_tasks; ++k )
+      {
+         task_walls[k] = (ip_data->TimingStats().*bench_tasks[k].task)().TotalWallclockTime();
+      }
+   }
+
+   std::ostringstream line;
+   line.precision(9);
+   line << (int) status << "," << (int) n << "," << (int) m << "," << (int) nnz_jac << "," << (int) nnz_h << ","
+        << (int) iters << ",";
+   line.precision(16);
+   line << obj << ",";
+   line.precision(9);
+   line << constr_viol << "," << dual_inf << "," << compl_ << "," << kkt_error << "," << (int) n_obj << ","
+        << (int) n_constr << "," << (int) n_grad << "," << (int) n_jac << "," << (int) n_hess << "," << cpu << "," << sys
+        << "," << wall << "," << func_wall << "," << setup_wall << "," << peak_rss_kb();
+   for( size_t k = 0; k < num_bench_tasks; ++k )
+   {
+      line << "," << task_walls[k];
+   }
+   std::string str = line.str();
+   if( write(fd, str.c_str(), str.size()) != (ssize_t) str.size() )
+   {
+      fprintf(stderr, "Cannot write the result for %s.\n", model.c_str());
+   }
+}
+
+/** A solve process that is running */
+struct Job
+{
+   size_t model;
+   int repetition;
+   int slot;
+   int fd;
+};
+
+/** Start the process for a solve */
+static bool start_job(
+   const BenchSettings& settings,
+   const Job&           job,
+   pid_t&               pid,
+   int&                 fd
+)
+{
+   int pipefd[2];
+   if( pipe(pipefd) != 0 )
+   {
+      fprintf(stderr, "Cannot create pipe: %s\n", strerror(errno));
+      return false;
+   }
+   fflush(NULL);
+   pid = fork();
+   if( pid < 0 )
+   {
+      fprintf(stderr, "Cannot fork: %s\n", strerror(errno));
+      close(pipefd[0]);
+      close(pipefd[1]);
+      return false;
+   }
+   if( pid == 0 )
+   {
+      close(pipefd[0]);
+      // the ASL and Ipopt may write to stdout, which can be the output file
+      if( freopen("/dev/null", "w", stdout) == NULL )
+      {
+         _exit(1);
+      }
+      if( !settings.cpus.empty() )
+      {
+#ifdef __linux__
+         cpu_set_t cpuset;
+         CPU_ZERO(&cpuset);
+         CPU_SET(settings.cpus[job.slot % settings.cpus.size()], &cpuset);
+         if( sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0 )
+         {
+            fprintf(stderr, "Cannot pin to CPU %d: %s\n", settings.cpus[job.slot % settings.cpus.size()],
+                    strerror(errno));
+         }
+#endif
+      }
+      if( settings.time_limit > 0 )
+      {
+         alarm(settings.time_limit);
+      }
+      solve_model(settings, settings.models[job.model], pipefd[1]);
+      close(pipefd[1]);
+      fflush(NULL);
+      _exit(0);
+   }
+   close(pipefd[1]);
+   fd = pipefd[0];
+   return true;
+}
+
+/** Read the result of a finished solve process and write its CSV line */
+static void finish_job(
+   const BenchSettings& settings,
+   const Job&           job,
+   int                  wstatus
+)
+{
+   std::string result;
+   char buf[4096];
+   ssize_t len;
+   while( (len = read(job.fd, buf, sizeof(buf))) > 0 )
+   {
+      result.append(buf, (size_t) len);
+   }
+   close(job.fd);
+
+   std::string process = "ok";
+   char str[32];
+   if( WIFSIGNALED(wstatus) )
+   {
+      Snprintf(str, sizeof(str), "%s=%d", WTERMSIG(wstatus) == SIGALRM ? "timeout" : "signal", (int) WTERMSIG(wstatus));
+      process = str;
+   }
+   else if( WIFEXITED(wstatus) && WEXITSTATUS(wstatus) != 0 )
+   {
+      Snprintf(str, sizeof(str), "exit=%d", (int) WEXITSTATUS(wstatus));
+      process = str;
+   }
+
+   if( result.empty() )
+   {
+      // no statistics, e.g., since the ASL could not read the model
+      std::ostringstream line;
+      line << (int) Internal_Error << ",0,0,0,0,-1";
+      for( size_t k = 0; k < 16 + num_bench_tasks; ++k )
+      {
+         line << ",0";
+      }
+      result = line.str();
+   }
+   fprintf(settings.out, "%s,%d,%s,%s\n", settings.models[job.model].c_str(), job.repetition, process.c_str(), result.c_str());
+   fflush(settings.out);
+
+   if( settings.out != stdout )
+   {
+      printf("%-40s rep=%-3d %s\n", settings.models[job.model].c_str(), job.repetition, process.c_str());
+   }
+}
+
+/** Solve all models with up to settings.jobs processes at the same time */
+static void run(
+   const BenchSettings& settings
+)
+{
+   std::vector<Job> pending;
+   for( size_t i = 0; i < settings.models.size(); ++i )
+   {
+      for( int r = 0; r < settings.repetitions; ++r )
+      {
+         Job job;
+         job.model = i;
+         job.repetition = r;
+         job.slot = -1;
+         job.fd = -1;
+         pending.push_back(job);
+      }
+   }
+   std::reverse(pending.begin(), pending.end());
+
+   std::map<pid_t, Job> running;
+   std::vector<bool> slot_used(settings.jobs, false);
+   while( !pending.empty() || !running.empty() )
+   {
+      while( !pending.empty() && (int) running.size() < settings.jobs )
+      {
+         Job job = pending.back();
+         pending.pop_back();
+         job.slot = (int) (std::find(slot_used.begin(), slot_used.end(), false) - slot_used.begin());
+         pid_t pid;
+         if( !start_job(settings, job, pid, job.fd) )
+         {
+            fprintf(stderr, "Skipping %s.\n", settings.models[job.model].c_str());
+            continue;
+         }
+         slot_used[job.slot] = true;
+         running[pid] = job;
+      }
+      if( running.empty() )
+      {
+         continue;
+      }
+
+      int wstatus;
+      pid_t pid = waitpid(-1, &wstatus, 0);
+      if( pid < 0 )
+      {
+         if( errno == EINTR )
+         {
+            continue;
+         }
+         fprintf(stderr, "waitpid failed: %s\n", strerror(errno));
+         break;
+      }
+      std::map<pid_t, Job>::iterator it = running.find(pid);
+      if( it == running.end() )
+      {
+         continue;
+      }
+      finish_job(settings, it->second, wstatus);
+      slot_used[it->second.slot] = false;
+      running.erase(it);
+   }
+}
+
+/** Result of a model in a CSV file of a previous run */
+struct BenchResult
+{
+   int status;
+   std::string process;
+   int iterations;
+   Number wall;
+   long rss;
+};
+
+/** Read the results of a run, keeping for every model the first status, and the minimal time and memory */
+static bool read_results(
+   const char*                          filename,
+   std::map<std::string, BenchResult>& results,
+   std::vector<std::string>&           order
+)
+{
+   std::ifstream is(filename);
+   if( !is )
+   {
+      fprintf(stderr, "Cannot open %s.\n", filename);
+      return false;
+   }
+   std::string line;
+   if( !std::getline(is, line) )
+   {
+      fprintf(stderr, "%s is empty.\n", filename);
+      return false;
+   }
+   std::vector<std::string> header = split_list(line);
+   std::map<std::string, size_t> column;
+   for( size_t i = 0; i < header.size(); ++i )
+   {
+      column[header[i]] = i;
+   }
+   const char* required[] = { "model", "status", "process", "iterations", "wall_time", "peak_rss_kb" };
+   for( size_t i = 0; i < sizeof(required) / sizeof(required[0]); ++i )
+   {
+      if( column.count(required[i]) == 0 )
+      {
+         fprintf(stderr, "%s has no column %s.\n", filename, required[i]);
+         return false;
+      }
+   }
+
+   while( std::getline(is, line) )
+   {
+      std::vector<std::string> fields = split_list(line);
+      if( fields.size() != header.size() )
+      {
+         continue;
+      }
+      BenchResult res;
+      res.status = atoi(fields[column["status"]].c_str());
+      res.process = fields[column["process"]];
+      res.iterations = atoi(fields[column["iterations"]].c_str());
+      res.wall = atof(fields[column["wall_time"]].c_str());
+      res.rss = atol(fields[column["peak_rss_kb"]].c_str());
+
+      const std::string& model = fields[column["model"]];
+      std::map<std::string, BenchResult>::iterator it = results.find(model);
+      if( it == results.end() )
+      {
+         results[model] = res;
+         order.push_back(model);
+      }
+      else
+      {
+         it->second.wall = std::min(it->second.wall, res.wall);
+         it->second.rss = std::min(it->second.rss, res.rss);
+      }
+   }
+   return true;
+}
+
+/** Whether a result counts as solved */
+static bool is_solved(
+   const BenchResult& res
+)
+{
+   return res.process == "ok" && (res.status == Solve_Succeeded || res.status == Solved_To_Acceptable_Level);
+}
+
+/** Write a report on the differences between two runs */
+static int compare(
+   const char* old_file,
+   const char* new_file,
+   Number      tol,
+   FILE*       out
+)
+{
+   std::map<std::string, BenchResult> old_results, new_results;
+   std::vector<std::string> old_order, new_order;
+   if( !read_results(old_file, old_results, old_order) || !read_results(new_file, new_results, new_order) )
+   {
+      return -1;
+   }
+
+   fprintf(out, "Comparison of %s (old) and %s (new)\n\n", old_file, new_file);
+   fprintf(out, "%-40s %-18s %-13s %-24s %s\n", "model", "status", "iterations", "wall time [s]", "peak memory [KiB]");
+
+   int common = 0, both_solved = 0, old_solved = 0, new_solved = 0, new_common_solved = 0, slower = 0, faster = 0;
+   Number log_ratio_sum = 0.;
+   for( size_t i = 0; i < new_order.size(); ++i )
+   {
+      const std::string& model = new_order[i];
+      const BenchResult& nres = new_results[model];
+      if( is_solved(nres) )
+      {
+         ++new_solved;
+      }
+      std::map<std::string, BenchResult>::const_iterator it = old_results.find(model);
+      if( it == old_results.end() )
+      {
+         continue;
+      }
+      const BenchResult& ores = it->second;
+      ++common;
+      if( is_solved(ores) )
+      {
+         ++old_solved;
+      }
+      if( is_solved(nres) )
+      {
+         ++new_common_solved;
+      }
+
+      bool status_changed = ores.status != nres.status || ores.process != nres.process;
+      bool iters_changed = ores.iterations != nres.iterations;
+      bool time_changed = false, rss_changed = false;
+      if( is_solved(ores) && is_solved(nres) )
+      {
+         ++both_solved;
+         // times below a millisecond are not resolved
+         Number ratio = Max(nres.wall, 1e-3) / Max(ores.wall, 1e-3);
+         log_ratio_sum += log(ratio);
+         if( ratio > 1. + tol )
+         {
+            ++slower;
+            time_changed = true;
+         }
+         else if( ratio < 1. / (1. + tol) )
+         {
+            ++faster;
+            time_changed = true;
+         }
+         rss_changed = ores.rss > 0 && nres.rss > 0
+                       && (nres.rss > (1. + tol) * ores.rss || (1. + tol) * nres.rss < ores.rss);
+      }
+      if( !status_changed && !iters_changed && !time_changed && !rss_changed )
+      {
+         continue;
+      }
+
+      char status[32], iters[32], wall[32], rss[48];
+      Snprintf(status, sizeof(status), "%d -> %d%s", ores.status, nres.status,
+               ores.process != nres.process ? " (process)" : "");
+      Snprintf(iters, sizeof(iters), "%d -> %d", ores.iterations, nres.iterations);
+      Snprintf(wall, sizeof(wall), "%.3f -> %.3f", ores.wall, nres.wall);
+      Snprintf(rss, sizeof(rss), "%ld -> %ld", ores.rss, nres.rss);
+      fprintf(out, "%-40s %-18s %-13s %-24s %s\n", model.c_str(), status, iters, wall, rss);
+   }
+
+   int only_old = (int) old_order.size() - common;
+   int only_new = (int) new_order.size() - common;
+   fprintf(out, "\nModels in both runs: %d (only old: %d, only new: %d)\n", common, only_old, only_new);
+   fprintf(out, "Solved: old %d, new %d of the common models; new %d of all\n", old_solved, new_common_solved,
+           new_solved);
+   if( both_solved > 0 )
+   {
+      fprintf(out, "Solved in both runs: %d, slower: %d, faster: %d (tolerance %g)\n", both_solved, slower, faster, tol);
+      fprintf(out, "Geometric mean of wall time ratios new/old: %.3f\n", exp(log_ratio_sum / both_solved));
+   }
+   return 0;
+}
+
+int main(
+   int   argc,
+   char* argv[]
+)
+{
+   if( argc >= 2 && !strcmp(argv[1], "compare") )
+   {
+      if( argc != 4 && !(argc == 6 && !strcmp(argv[4], "-t")) )
+      {
+         print_usage(argv[0]);
+         return -1;
+      }
+      Number tol = argc == 6 ? atof(argv[5]) : 0.1;
+      return compare(argv[2], argv[3], tol, stdout);
+   }
+
+   BenchSettings settings;
+   settings.jobs = 1;
+   settings.repetitions = 1;
+   settings.time_limit = 0;
+   settings.out = stdout;
+   const char* outfile = NULL;
+   const char* baseline = NULL;
+   Number tol = 0.1;
+
+   for( int i = 1; i < argc; i++ )
+   {
+      if( argv[i][0] != '-' )
+      {
+         if( !collect_models(argv[i], settings.models) )
+         {
+            return -1;
+         }
+         continue;
+      }
+      if( i + 1 >= argc || strlen(argv[i]) != 2 )
+      {
+         print_usage(argv[0]);
+         return -1;
+      }
+      const char* arg = argv[++i];
+      bool ok = true;
+      switch( argv[i - 1][1] )
+      {
+         case 's':
+            settings.options_file = arg;
+            break;
+         case 'j':
+            settings.jobs = atoi(arg);
+            ok = settings.jobs > 0;
+            break;
+         case 'c':
+         {
+            std::vector<std::string> items = split_list(arg);
+            for( size_t k = 0; k < items.size() && ok; ++k )
+            {
+               char* end;
+               long cpu = strtol(items[k].c_str(), &end, 10);
+               ok = !items[k].empty() && *end == '\0' && cpu >= 0;
+               settings.cpus.push_back((int) cpu);
+            }
+#ifndef __linux__
+            printf("Pinning to CPUs is not supported on this platform, ignoring -c.\n");
+            settings.cpus.clear();
+#endif
+            break;
+         }
+         case 'r':
+            settings.repetitions = atoi(arg);
+            ok = settings.repetitions > 0;
+            break;
+         case 'T':
+            settings.time_limit = atoi(arg);
+            ok = settings.time_limit > 0;
+            break;
+         case 'o':
+            outfile = arg;
+            break;
+         case 'b':
+            baseline = arg;
+            break;
+         case 't':
+            tol = atof(arg);
+            ok = tol >= 0.;
+            break;
+         default:
+            ok = false;
+      }
+      if( !ok )
+      {
+         printf("Invalid argument \"%s\" for %s.\n", arg, argv[i - 1]);
+         print_usage(argv[0]);
+         return -1;
+      }
+   }
+   if( settings.models.empty() )
+   {
+      print_usage(argv[0]);
+      return -1;
+   }
+   if( baseline != NULL && outfile == NULL )
+   {
+      printf("The comparison with a baseline (-b) requires an output file (-o).\n");
+      return -1;
+   }
+
+   if( outfile != NULL )
+   {
+      settings.out = fopen(outfile, "w");
+      if( settings.out == NULL )
+      {
+         printf("Cannot open output file %s.\n", outfile);
+         return -1;
+      }
+   }
+
+   write_header(settings.out);
+   run(settings);
+
+   if( settings.out != stdout )
+   {
+      fclose(settings.out);
+   }
+
+   if( baseline != NULL )
+   {
+      printf("\n");
+      return compare(baseline, outfile, tol, stdout);
+   }
+   return 0;
+}
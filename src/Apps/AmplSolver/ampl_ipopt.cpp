@@ -10,6 +10,163 @@
 
 #include <cstring>
 #include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/** Solves the model of the stub given in args, as for a call of the executable with these arguments.
+ *
+ *  Initialize must have been called once before to create a journalist.
+ */
+static Ipopt::ApplicationReturnStatus solve_ampl_model(
+   Ipopt::SmartPtr<Ipopt::IpoptApplication> app,
+   char**                                   args
+)
+{
+   using namespace Ipopt;
+
+   // Add the suffix handler for scaling
+   SmartPtr<AmplSuffixHandler> suffix_handler = new AmplSuffixHandler();
+   suffix_handler->AddAvailableSuffix("scaling_factor", AmplSuffixHandler::Variable_Source,
+                                      AmplSuffixHandler::Number_Type);
+   suffix_handler->AddAvailableSuffix("scaling_factor", AmplSuffixHandler::Constraint_Source,
+                                      AmplSuffixHandler::Number_Type);
+   suffix_handler->AddAvailableSuffix("scaling_factor", AmplSuffixHandler::Objective_Source,
+                                      AmplSuffixHandler::Number_Type);
+   // Modified for warm-start from AMPL
+   suffix_handler->AddAvailableSuffix("ipopt_zL_out", AmplSuffixHandler::Variable_Source,
+                                      AmplSuffixHandler::Number_Type);
+   suffix_handler->AddAvailableSuffix("ipopt_zU_out", AmplSuffixHandler::Variable_Source,
+                                      AmplSuffixHandler::Number_Type);
+   suffix_handler->AddAvailableSuffix("ipopt_zL_in", AmplSuffixHandler::Variable_Source,
+                                      AmplSuffixHandler::Number_Type);
+   suffix_handler->AddAvailableSuffix("ipopt_zU_in", AmplSuffixHandler::Variable_Source,
+                                      AmplSuffixHandler::Number_Type);
+
+   SmartPtr<AmplTNLP> ampl_tnlp = new AmplTNLP(ConstPtr(app->Jnlst()), app->Options(), args, suffix_handler);
+
+   // Call Initialize again to process output related options
+   ApplicationReturnStatus retval = app->Initialize();
+   if( retval != Solve_Succeeded )
+   {
+      printf("ampl_ipopt.cpp: Error in second Initialize!!!!\n");
+      exit(-101);
+   }
+
+   const int n_loops = 1; // make larger for profiling
+   for( Index i = 0; i < n_loops; i++ )
+   {
+      retval = app->OptimizeTNLP(ampl_tnlp);
+   }
+
+   // the time for reading the model is not part of Ipopt's timing statistics
+   bool print_timing_statistics = false;
+   app->Options()->GetBoolValue("print_timing_statistics", print_timing_statistics, "");
+   if( print_timing_statistics )
+   {
+      ampl_tnlp->PrintTimingStatistics(*app->Jnlst(), J_SUMMARY, J_TIMING_STATISTICS);
+   }
+
+   // finalize_solution method in AmplTNLP writes the solution file
+
+   return retval;
+}
+
+/** Whether the .nl file of a stub can be opened
+ *
+ *  The ASL exits the program if it cannot open the .nl file, which the
+ *  server mode should survive.
+ */
+static bool nl_file_exists(
+   const std::string& stub
+)
+{
+   FILE* fp = fopen((stub + ".nl").c_str(), "rb");
+   if( fp == NULL )
+   {
+      fp = fopen(stub.c_str(), "rb");
+   }
+   if( fp == NULL )
+   {
+      return false;
+   }
+   fclose(fp);
+   return true;
+}
+
+/** Solves models until the end of the input.
+ *
+ *  Each line of the standard input holds the arguments of one call of
+ *  the executable, i.e., the stub and further options, e.g.,
+ *  "model -AMPL max_iter=100".  The options, registered options,
+ *  journalist, and loaded linear solver libraries are kept between the
+ *  solves, but the options are reset before each solve, so each model
+ *  is solved as if the executable had been called on its own.  After
+ *  each solve, a line "ipopt_server: <stub> <status>" is written to the
+ *  standard output, with status the ApplicationReturnStatus.
+ */
+static int run_server(
+   Ipopt::SmartPtr<Ipopt::IpoptApplication> app,
+   char*                                    progname
+)
+{
+   using namespace Ipopt;
+
+   std::string line;
+   while( std::getline(std::cin, line) )
+   {
+      std::istringstream tokens(line);
+      std::vector<std::string> words;
+      std::string word;
+      while( tokens >> word )
+      {
+         words.push_back(word);
+      }
+      if( words.empty() )
+      {
+         continue;
+      }
+      if( words[0] == "quit" )
+      {
+         break;
+      }
+
+      int status = Internal_Error;
+      if( !nl_file_exists(words[0]) )
+      {
+         printf("ampl_ipopt.cpp: Cannot open .nl file for stub %s\n", words[0].c_str());
+         status = Invalid_Problem_Definition;
+      }
+      else
+      {
+         // arguments as for main, with a NULL at the end
+         std::vector<char*> args;
+         args.push_back(progname);
+         for( size_t i = 0; i < words.size(); i++ )
+         {
+            args.push_back(const_cast<char*>(words[i].c_str()));
+         }
+         args.push_back(NULL);
+         char** argv = &args[0];
+
+         app->Options()->clear();
+         try
+         {
+            status = solve_ampl_model(app, argv);
+         }
+         catch( IpoptException& exc )
+         {
+            exc.ReportException(*app->Jnlst(), J_ERROR);
+         }
+      }
+
+      printf("ipopt_server: %s %d\n", words[0].c_str(), status);
+      fflush(stdout);
+   }
+
+   return 0;
+}
 
 int main(
    int argc,
@@ -64,42 +221,13 @@ int main(
       exit(-100);
    }
 
-   // Add the suffix handler for scaling
-   SmartPtr<AmplSuffixHandler> suffix_handler = new AmplSuffixHandler();
-   suffix_handler->AddAvailableSuffix("scaling_factor", AmplSuffixHandler::Variable_Source,
-                                      AmplSuffixHandler::Number_Type);
-   suffix_handler->AddAvailableSuffix("scaling_factor", AmplSuffixHandler::Constraint_Source,
-                                      AmplSuffixHandler::Number_Type);
-   suffix_handler->AddAvailableSuffix("scaling_factor", AmplSuffixHandler::Objective_Source,
-                                      AmplSuffixHandler::Number_Type);
-   // Modified for warm-start from AMPL
-   suffix_handler->AddAvailableSuffix("ipopt_zL_out", AmplSuffixHandler::Variable_Source,
-                                      AmplSuffixHandler::Number_Type);
-   suffix_handler->AddAvailableSuffix("ipopt_zU_out", AmplSuffixHandler::Variable_Source,
-                                      AmplSuffixHandler::Number_Type);
-   suffix_handler->AddAvailableSuffix("ipopt_zL_in", AmplSuffixHandler::Variable_Source,
-                                      AmplSuffixHandler::Number_Type);
-   suffix_handler->AddAvailableSuffix("ipopt_zU_in", AmplSuffixHandler::Variable_Source,
-                                      AmplSuffixHandler::Number_Type);
-
-   SmartPtr<TNLP> ampl_tnlp = new AmplTNLP(ConstPtr(app->Jnlst()), app->Options(), args, suffix_handler);
-
-   // Call Initialize again to process output related options
-   retval = app->Initialize();
-   if( retval != Solve_Succeeded )
-   {
-      printf("ampl_ipopt.cpp: Error in second Initialize!!!!\n");
-      exit(-101);
-   }
-
-   const int n_loops = 1; // make larger for profiling
-   for( Index i = 0; i < n_loops; i++ )
+   // Check if executable is run as server that solves the models given on the standard input
+   if( argc == 2 && !strcmp(args[1], "--server") )
    {
-      retval = app->OptimizeTNLP(ampl_tnlp);
+      return run_server(app, args[0]);
    }
 
-   // finalize_solution method in AmplTNLP writes the solution file
+   solve_ampl_model(app, args);
 
    return 0;
 }
-
@@ -0,0 +1,83 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpAlignedMemory.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#define IPOPT_ALIGNED_MALLOC_WIN32
+#elif defined(__unix__) || defined(__APPLE__)
+#define IPOPT_ALIGNED_MALLOC_POSIX
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace Ipopt
+{
+
+Number* AllocateAlignedNumbers(
+   std::size_t size,
+   bool        huge_pages
+)
+{
+   std::size_t bytes = size * sizeof(Number);
+   std::size_t alignment = IPOPT_ALIGNED_MEMORY_ALIGNMENT;
+   huge_pages = huge_pages && bytes >= IPOPT_ALIGNED_MEMORY_HUGEPAGE_SIZE;
+   if( huge_pages )
+   {
+      alignment = IPOPT_ALIGNED_MEMORY_HUGEPAGE_SIZE;
+   }
+
+   void* values;
+#if defined(IPOPT_ALIGNED_MALLOC_WIN32)
+   values = _aligned_malloc(bytes > 0 ? bytes : 1, alignment);
+#elif defined(IPOPT_ALIGNED_MALLOC_POSIX)
+   if( posix_memalign(&values, alignment, bytes > 0 ? bytes : 1) != 0 )
+   {
+      values = NULL;
+   }
+#else
+   // without an aligned allocation, only the alignment of new is guaranteed
+   (void) alignment;
+   return new Number[size];
+#endif
+   if( values == NULL )
+   {
+      throw std::bad_alloc();
+   }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+   if( huge_pages )
+   {
+      // the advice is only a hint, so its failure is ignored
+      std::size_t huge_bytes = bytes - bytes % IPOPT_ALIGNED_MEMORY_HUGEPAGE_SIZE;
+      (void) madvise(values, huge_bytes, MADV_HUGEPAGE);
+   }
+#else
+   (void) huge_pages;
+#endif
+
+   return static_cast<Number*>(values);
+}
+
+void FreeAlignedNumbers(
+   Number* values
+)
+{
+#if defined(IPOPT_ALIGNED_MALLOC_WIN32)
+   _aligned_free(values);
+#elif defined(IPOPT_ALIGNED_MALLOC_POSIX)
+   std::free(values);
+#else
+   delete[] values;
+#endif
+}
+
+} // namespace Ipopt
@@ -0,0 +1,55 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPALIGNEDMEMORY_HPP__
+#define __IPALIGNEDMEMORY_HPP__
+
+#include "IpTypes.hpp"
+
+#include <cstddef>
+
+namespace Ipopt
+{
+
+/** Alignment in bytes of the arrays returned by AllocateAlignedNumbers.
+ *
+ *  This is the size of a cache line and of an AVX-512 register.
+ */
+#ifndef IPOPT_ALIGNED_MEMORY_ALIGNMENT
+#define IPOPT_ALIGNED_MEMORY_ALIGNMENT 64
+#endif
+
+/** Arrays of at least this number of bytes are put on transparent huge
+ *  pages if this is requested from AllocateAlignedNumbers.
+ */
+#ifndef IPOPT_ALIGNED_MEMORY_HUGEPAGE_SIZE
+#define IPOPT_ALIGNED_MEMORY_HUGEPAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+/** Allocates an uninitialized array of size numbers.
+ *
+ *  The array is aligned to IPOPT_ALIGNED_MEMORY_ALIGNMENT bytes.  If
+ *  huge_pages is true, large arrays are aligned to the size of a huge
+ *  page instead, and transparent huge pages are requested for them
+ *  (only on Linux).
+ *  It must be freed by FreeAlignedNumbers.  Since the operating system
+ *  places each page of the array on the NUMA node of the thread that
+ *  first writes to it, callers of parallel kernels should initialize
+ *  the array with the partitioning of these kernels.
+ *
+ *  @throw std::bad_alloc if the memory cannot be allocated
+ */
+IPOPTLIB_EXPORT Number* AllocateAlignedNumbers(
+   std::size_t size,
+   bool        huge_pages = false
+);
+
+/** Frees an array allocated by AllocateAlignedNumbers; values may be NULL. */
+IPOPTLIB_EXPORT void FreeAlignedNumbers(
+   Number* values
+);
+
+} // namespace Ipopt
+
+#endif
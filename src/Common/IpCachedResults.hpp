@@ -9,9 +9,9 @@
 
 #include "IpTaggedObject.hpp"
 #include "IpObserver.hpp"
+#include "IpMemoryStatistics.hpp"
 #include <algorithm>
 #include <vector>
-#include <list>
 
 namespace Ipopt
 {
@@ -28,6 +28,23 @@ namespace Ipopt
 template<class T>
 class DependentResult;
 
+template<class T>
+class CachedResultsBudget;
+
+/** Number of bytes of memory that is held by a cached result.
+ *
+ *  This is accounted for in MemoryStatistics as memory of the caches.
+ *  Overloads for results that hold memory, e.g., Vectors, are found
+ *  by argument-dependent lookup.
+ */
+template<class T>
+inline std::size_t CachedResultBytes(
+   const T& /*result*/
+)
+{
+   return 0;
+}
+
 //  AW: I'm taking this out, since this is by far the most used
 //  class.  We should keep it as simple as possible.
 //   /** Cache Priority Enum */
@@ -63,6 +80,15 @@ class DependentResult;
  *  DependentResult, inherits off an Observer.  This Observer
  *  retrieves notification whenever a TaggedObject dependency has
  *  changed.  Stale results are later removed from the cache.
+ *  The removed DependentResult objects are kept (up to the
+ *  maximal cache size) and reused for results that are added
+ *  later, which avoids most of the memory allocations for cache
+ *  entries.  They are deleted together with the CachedResults.
+ *
+ *  The pointers to the DependentResults are stored in a small
+ *  array inside the CachedResults object, so that caches with a
+ *  maximal size of up to 3 results do not require any further
+ *  memory allocation.
  */
 template<class T>
 class CachedResults
@@ -251,6 +277,50 @@ public:
       Int max_cache_size
    );
 
+   /** @name Methods for limiting the memory of the cached results. */
+   ///@{
+   /** Maximal number of results that have been given to the constructor */
+   Int InitialMaxCacheSize() const
+   {
+      return initial_max_cache_size_;
+   }
+
+   /** Memory in bytes that is held by the currently cached results,
+    *  see CachedResultBytes.
+    */
+   std::size_t CachedBytes() const;
+
+   /** Memory in bytes of the largest cached result.
+    *
+    *  If keep_newest is true, the most recently added result is not
+    *  considered.
+    */
+   std::size_t LargestResultBytes(
+      bool keep_newest
+   ) const;
+
+   /** Remove the largest cached result from the cache, see LargestResultBytes.
+    *
+    *  Of several largest results, the one that has been added first
+    *  is removed.
+    */
+   void RemoveLargestResult(
+      bool keep_newest
+   );
+
+   /** Set the memory budget that is enforced after adding a result.
+    *
+    *  Pass NULL to remove the budget.  This is called by
+    *  CachedResultsBudget::AddCache.
+    */
+   void SetBudget(
+      const CachedResultsBudget<T>* budget
+   )
+   {
+      budget_ = budget;
+   }
+   ///@}
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -276,11 +346,58 @@ private:
    );
    ///@}
 
-   /** maximum number of cached results */
+   /** number of DependentResult pointers that fit into inline_results_ */
+   enum
+   {
+      InlineCapacity = 4
+   };
+
+   /** Array with the pointers to the DependentResults.
+    *
+    *  The first n_results_ entries are the currently cached results,
+    *  with the most recently added first.  They are followed by
+    *  n_spare_ released DependentResults that can be reused.  This
+    *  points to inline_results_ unless more than InlineCapacity
+    *  entries are required.
+    */
+   mutable DependentResult<T>** results_;
+   /** inline storage for results_ */
+   mutable DependentResult<T>* inline_results_[InlineCapacity];
+   /** length of the array results_ */
+   mutable Index capacity_;
+   /** number of currently cached results */
+   mutable Index n_results_;
+   /** number of released DependentResults following the cached results */
+   mutable Index n_spare_;
+   /** maximum number of cached results
+    *
+    *  Declared after the counters, so that no padding is needed
+    *  after it.
+    */
    Int max_cache_size_;
+   /** maximum number of cached results given to the constructor */
+   Int initial_max_cache_size_;
+   /** memory budget that is enforced after adding a result, or NULL */
+   const CachedResultsBudget<T>* budget_;
+
+   /** Make sure that results_ has space for at least n entries */
+   void ReserveResults(
+      Index n
+   ) const;
 
-   /** list of currently cached results. */
-   mutable std::list<DependentResult<T>*>* cached_results_;
+   /** Remove the cached results from position first on.
+    *
+    *  The DependentResults are moved to the spare results, or deleted
+    *  if there are enough spare results already.
+    */
+   void RemoveResults(
+      Index first
+   ) const;
+
+   /** Position of the largest cached result, or -1 if there is none */
+   Index LargestResult(
+      bool keep_newest
+   ) const;
 
    /** internal method for removing stale DependentResults from the list
     *
@@ -319,6 +436,19 @@ public:
    ~DependentResult();
    ///@}
 
+   /** @name Methods for reusing a DependentResult object. */
+   ///@{
+   /** Detach from the dependencies and drop the result. */
+   void Release();
+
+   /** Set new information about the result, after Release has been called. */
+   void Reset(
+      const T&                                result,
+      const std::vector<const TaggedObject*>& dependents,
+      const std::vector<Number>&              scalar_dependents
+   );
+   ///@}
+
    /** @name Accessor method. */
    ///@{
    /** Indicates, whether the DependentResult is no longer valid. */
@@ -384,6 +514,39 @@ private:
    );
    ///@}
 
+   /** Attach to the dependents and store their tags in dependent_tags_ */
+   void AttachDependents(
+      const std::vector<const TaggedObject*>& dependents
+   );
+
+   /** Account for the allocation or release of the memory held by result_
+    *
+    *  The memory is allocated in the current statistics and freed in
+    *  the same statistics.
+    */
+   void AccountResult(
+      bool allocate
+   )
+   {
+      const std::size_t bytes = CachedResultBytes(result_);
+      if( bytes > 0 )
+      {
+         if( allocate )
+         {
+            memory_stats_ = MemoryStatistics::Current();
+            if( IsValid(memory_stats_) )
+            {
+               memory_stats_->Allocate(MemoryStatistics::CACHED_RESULTS, bytes);
+            }
+         }
+         else if( IsValid(memory_stats_) )
+         {
+            memory_stats_->Free(MemoryStatistics::CACHED_RESULTS, bytes);
+            memory_stats_ = NULL;
+         }
+      }
+   }
+
    /** Flag indicating, if the cached result is still valid.
     *
     *  A result becomes invalid, if the ReceiveNotification method is
@@ -391,13 +554,151 @@ private:
     */
    bool stale_;
    /** The value of the dependent results */
-   const T result_;
+   T result_;
    /** Dependencies in form of TaggedObjects */
    std::vector<TaggedObject::Tag> dependent_tags_;
    /** Dependencies in form a Numbers */
    std::vector<Number> scalar_dependents_;
+   /** Statistics in which the memory of result_ has been allocated */
+   SmartPtr<MemoryStatistics> memory_stats_;
+};
+
+/** Templated class for a memory budget that is shared by several
+ *  CachedResults of the same type.
+ *
+ *  Whenever a result has been added to one of the caches and the
+ *  memory held by all caches (see CachedResultBytes) exceeds the
+ *  budget, the largest results are removed from the caches until
+ *  the budget is met again.  The result that has just been added is
+ *  never removed.  A result that is stored by several caches is
+ *  counted for each of them.
+ */
+template<class T>
+class CachedResultsBudget
+{
+public:
+   /** @name Constructor, Destructors */
+   ///@{
+   /** Constructor, without caches and without a limit */
+   CachedResultsBudget()
+      : max_bytes_(0)
+   { }
+
+   /** Destructor */
+   ~CachedResultsBudget()
+   {
+      RemoveCaches();
+   }
+   ///@}
+
+   /** Set the budget in bytes; 0 means no limit */
+   void SetMaxBytes(
+      std::size_t max_bytes
+   )
+   {
+      max_bytes_ = max_bytes;
+   }
+
+   /** Budget in bytes; 0 means no limit */
+   std::size_t MaxBytes() const
+   {
+      return max_bytes_;
+   }
+
+   /** Add a cache whose results are limited by this budget */
+   void AddCache(
+      CachedResults<T>& cache
+   )
+   {
+      caches_.push_back(&cache);
+      cache.SetBudget(this);
+   }
+
+   /** Remove all caches from this budget */
+   void RemoveCaches()
+   {
+      for( size_t i = 0; i < caches_.size(); ++i )
+      {
+         caches_[i]->SetBudget(NULL);
+      }
+      caches_.clear();
+   }
+
+   /** Remove the largest results from the caches until the budget is met.
+    *
+    *  This is called by CachedResults after last_added has got a new result.
+    */
+   void Enforce(
+      const CachedResults<T>* last_added
+   ) const;
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   CachedResultsBudget(
+      const CachedResultsBudget&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const CachedResultsBudget&
+   );
+   ///@}
+
+   /** budget in bytes, 0 for no limit */
+   std::size_t max_bytes_;
+   /** caches that share the budget */
+   std::vector<CachedResults<T>*> caches_;
 };
 
+template<class T>
+void CachedResultsBudget<T>::Enforce(
+   const CachedResults<T>* last_added
+) const
+{
+   if( max_bytes_ == 0 )
+   {
+      return;
+   }
+
+   std::size_t total = 0;
+   for( size_t i = 0; i < caches_.size(); ++i )
+   {
+      total += caches_[i]->CachedBytes();
+   }
+
+   while( total > max_bytes_ )
+   {
+      CachedResults<T>* largest = NULL;
+      std::size_t largest_bytes = 0;
+      for( size_t i = 0; i < caches_.size(); ++i )
+      {
+         std::size_t bytes = caches_[i]->LargestResultBytes(caches_[i] == last_added);
+         if( bytes > largest_bytes )
+         {
+            largest = caches_[i];
+            largest_bytes = bytes;
+         }
+      }
+      if( largest == NULL )
+      {
+         // only the new result is left
+         break;
+      }
+      largest->RemoveLargestResult(largest == last_added);
+      total -= largest_bytes;
+   }
+}
+
 #ifdef IP_DEBUG_CACHE
 template <class T>
 const Index CachedResults<T>::dbg_verbosity = 0;
@@ -421,6 +722,15 @@ DependentResult<T>::DependentResult(
    DBG_START_METH("DependentResult<T>::DependentResult()", dbg_verbosity);
 #endif
 
+   AttachDependents(dependents);
+   AccountResult(true);
+}
+
+template<class T>
+void DependentResult<T>::AttachDependents(
+   const std::vector<const TaggedObject*>& dependents
+)
+{
    for( Index i = 0; i < (Index) dependents.size(); ++i )
    {
       if( dependents[i] )
@@ -449,9 +759,42 @@ DependentResult<T>::~DependentResult()
    DBG_START_METH("DependentResult<T>::~DependentResult()", dbg_verbosity);
    //DBG_ASSERT(stale_ == true);
 #endif
-   // Nothing to be done here, destructor
+   // Nothing else to be done here, destructor
    // of T should sufficiently remove
    // any memory, etc.
+   AccountResult(false);
+}
+
+template<class T>
+void DependentResult<T>::Release()
+{
+#ifdef IP_DEBUG_CACHE
+   DBG_START_METH("DependentResult<T>::Release()", dbg_verbosity);
+#endif
+
+   RequestDetachAll();
+   stale_ = true;
+   AccountResult(false);
+   result_ = T();
+}
+
+template<class T>
+void DependentResult<T>::Reset(
+   const T&                                result,
+   const std::vector<const TaggedObject*>& dependents,
+   const std::vector<Number>&              scalar_dependents
+)
+{
+#ifdef IP_DEBUG_CACHE
+   DBG_START_METH("DependentResult<T>::Reset()", dbg_verbosity);
+#endif
+
+   stale_ = false;
+   result_ = result;
+   dependent_tags_.resize(dependents.size());
+   scalar_dependents_ = scalar_dependents;
+   AttachDependents(dependents);
+   AccountResult(true);
 }
 
 template<class T>
@@ -549,8 +892,13 @@ template<class T>
 CachedResults<T>::CachedResults(
    Int max_cache_size
 )
-   : max_cache_size_(max_cache_size),
-     cached_results_(NULL)
+   : results_(inline_results_),
+     capacity_(InlineCapacity),
+     n_results_(0),
+     n_spare_(0),
+     max_cache_size_(max_cache_size),
+     initial_max_cache_size_(max_cache_size),
+     budget_(NULL)
 {
 #ifdef IP_DEBUG_CACHE
    DBG_START_METH("CachedResults<T>::CachedResults", dbg_verbosity);
@@ -565,14 +913,13 @@ CachedResults<T>::~CachedResults()
    DBG_START_METH("CachedResults<T>::!CachedResults()", dbg_verbosity);
 #endif
 
-   if( cached_results_ )
+   for( Index i = 0; i < n_results_ + n_spare_; i++ )
    {
-      for( typename std::list<DependentResult<T>*>::iterator iter = cached_results_->begin(); iter != cached_results_->end(); iter++ )
-      {
-         delete *iter;
-      }
-
-      delete cached_results_;
+      delete results_[i];
+   }
+   if( results_ != inline_results_ )
+   {
+      delete[] results_;
    }
    /*
     while (!cached_results_.empty()) {
@@ -596,28 +943,43 @@ void CachedResults<T>::AddCachedResult(
 
    CleanupInvalidatedResults();
 
-   // insert the new one here
-   DependentResult<T>* newResult = new DependentResult<T>(result, dependents, scalar_dependents);
-   if( !cached_results_ )
+   // insert the new one at the front, reusing a released one if possible
+   DependentResult<T>* newResult;
+   if( n_spare_ > 0 )
    {
-      cached_results_ = new std::list<DependentResult<T>*>;
+      newResult = results_[n_results_];
+      newResult->Reset(result, dependents, scalar_dependents);
+      n_spare_--;
    }
-
-   cached_results_->push_front(newResult);
+   else
+   {
+      ReserveResults(n_results_ + 1);
+      newResult = new DependentResult<T>(result, dependents, scalar_dependents);
+   }
+   for( Index i = n_results_; i > 0; i-- )
+   {
+      results_[i] = results_[i - 1];
+   }
+   results_[0] = newResult;
+   n_results_++;
 
    // keep the list small enough
    if( max_cache_size_ >= 0 )
    {
       // if negative, allow infinite cache
       // non-negative - limit size of list to max_cache_size
-      DBG_ASSERT((Int)cached_results_->size() <= max_cache_size_ + 1);
-      if( (Int) cached_results_->size() > max_cache_size_ )
+      DBG_ASSERT(n_results_ <= max_cache_size_ + 1);
+      if( n_results_ > max_cache_size_ )
       {
-         delete cached_results_->back();
-         cached_results_->pop_back();
+         RemoveResults(max_cache_size_);
       }
    }
 
+   if( budget_ != NULL )
+   {
+      budget_->Enforce(this);
+   }
+
 #ifdef IP_DEBUG_CACHE
    DBG_EXEC(2, DebugPrintCachedResults());
 #endif
@@ -645,7 +1007,7 @@ bool CachedResults<T>::GetCachedResult(
    DBG_START_METH("CachedResults<T>::GetCachedResult", dbg_verbosity);
 #endif
 
-   if( !cached_results_ )
+   if( n_results_ == 0 )
    {
       return false;
    }
@@ -653,11 +1015,10 @@ bool CachedResults<T>::GetCachedResult(
    CleanupInvalidatedResults();
 
    bool retValue = false;
-   typename std::list<DependentResult<T>*>::const_iterator iter;
-   for( iter = cached_results_->begin(); iter != cached_results_->end(); iter++ )
-      if( (*iter)->DependentsIdentical(dependents, scalar_dependents) )
+   for( Index i = 0; i < n_results_; i++ )
+      if( results_[i]->DependentsIdentical(dependents, scalar_dependents) )
       {
-         retResult = (*iter)->GetResult();
+         retResult = results_[i]->GetResult();
          retValue = true;
          break;
       }
@@ -794,7 +1155,7 @@ bool CachedResults<T>::InvalidateResult(
    const std::vector<Number>&              scalar_dependents
 )
 {
-   if( !cached_results_ )
+   if( n_results_ == 0 )
    {
       return false;
    }
@@ -802,11 +1163,10 @@ bool CachedResults<T>::InvalidateResult(
    CleanupInvalidatedResults();
 
    bool retValue = false;
-   typename std::list<DependentResult<T>*>::const_iterator iter;
-   for( iter = cached_results_->begin(); iter != cached_results_->end(); iter++ )
-      if( (*iter)->DependentsIdentical(dependents, scalar_dependents) )
+   for( Index i = 0; i < n_results_; i++ )
+      if( results_[i]->DependentsIdentical(dependents, scalar_dependents) )
       {
-         (*iter)->Invalidate();
+         results_[i]->Invalidate();
          retValue = true;
          break;
       }
@@ -817,15 +1177,9 @@ bool CachedResults<T>::InvalidateResult(
 template<class T>
 void CachedResults<T>::Clear()
 {
-   if( !cached_results_ )
+   for( Index i = 0; i < n_results_; i++ )
    {
-      return;
-   }
-
-   typename std::list<DependentResult<T>*>::const_iterator iter;
-   for( iter = cached_results_->begin(); iter != cached_results_->end(); iter++ )
-   {
-      (*iter)->Invalidate();
+      results_[i]->Invalidate();
    }
 
    CleanupInvalidatedResults();
@@ -840,6 +1194,69 @@ void CachedResults<T>::Clear(
    max_cache_size_ = max_cache_size;
 }
 
+template<class T>
+std::size_t CachedResults<T>::CachedBytes() const
+{
+   std::size_t bytes = 0;
+   for( Index i = 0; i < n_results_; i++ )
+   {
+      if( !results_[i]->IsStale() )
+      {
+         bytes += CachedResultBytes(results_[i]->GetResult());
+      }
+   }
+   return bytes;
+}
+
+template<class T>
+Index CachedResults<T>::LargestResult(
+   bool keep_newest
+) const
+{
+   Index largest = -1;
+   std::size_t largest_bytes = 0;
+   for( Index i = keep_newest ? 1 : 0; i < n_results_; i++ )
+   {
+      if( !results_[i]->IsStale() )
+      {
+         // older results are further back, prefer them for equal size
+         std::size_t bytes = CachedResultBytes(results_[i]->GetResult());
+         if( bytes > 0 && bytes >= largest_bytes )
+         {
+            largest = i;
+            largest_bytes = bytes;
+         }
+      }
+   }
+   return largest;
+}
+
+template<class T>
+std::size_t CachedResults<T>::LargestResultBytes(
+   bool keep_newest
+) const
+{
+   Index largest = LargestResult(keep_newest);
+   if( largest < 0 )
+   {
+      return 0;
+   }
+   return CachedResultBytes(results_[largest]->GetResult());
+}
+
+template<class T>
+void CachedResults<T>::RemoveLargestResult(
+   bool keep_newest
+)
+{
+   Index largest = LargestResult(keep_newest);
+   if( largest >= 0 )
+   {
+      results_[largest]->Invalidate();
+      CleanupInvalidatedResults();
+   }
+}
+
 template<class T>
 void CachedResults<T>::CleanupInvalidatedResults() const
 {
@@ -847,28 +1264,74 @@ void CachedResults<T>::CleanupInvalidatedResults() const
    DBG_START_METH("CachedResults<T>::CleanupInvalidatedResults", dbg_verbosity);
 #endif
 
-   if( !cached_results_ )
+   // move the stale results to the end, keeping the order of the others
+   Index n_valid = 0;
+   for( Index i = 0; i < n_results_; i++ )
+   {
+      if( !results_[i]->IsStale() )
+      {
+         if( i != n_valid )
+         {
+            std::swap(results_[i], results_[n_valid]);
+         }
+         n_valid++;
+      }
+   }
+
+   if( n_valid < n_results_ )
+   {
+      RemoveResults(n_valid);
+   }
+}
+
+template<class T>
+void CachedResults<T>::ReserveResults(
+   Index n
+) const
+{
+   if( n <= capacity_ )
    {
       return;
    }
 
-   typename std::list<DependentResult<T>*>::iterator iter;
-   iter = cached_results_->begin();
-   while( iter != cached_results_->end() )
+   Index new_capacity = Max(n, 2 * capacity_);
+   DependentResult<T>** new_results = new DependentResult<T>*[new_capacity];
+   for( Index i = 0; i < n_results_ + n_spare_; i++ )
+   {
+      new_results[i] = results_[i];
+   }
+   if( results_ != inline_results_ )
+   {
+      delete[] results_;
+   }
+   results_ = new_results;
+   capacity_ = new_capacity;
+}
+
+template<class T>
+void CachedResults<T>::RemoveResults(
+   Index first
+) const
+{
+   const Index max_spare = Max((Index) max_cache_size_, 1);
+
+   // end of the spare results
+   Index last = n_results_ + n_spare_;
+   for( Index i = n_results_ - 1; i >= first; i-- )
    {
-      if( (*iter)->IsStale() )
+      // all entries after i are spare results
+      if( last - i - 1 < max_spare )
       {
-         typename std::list<DependentResult<T>*>::iterator iter_to_remove = iter;
-         iter++;
-         DependentResult<T>* result_to_delete = (*iter_to_remove);
-         cached_results_->erase(iter_to_remove);
-         delete result_to_delete;
+         results_[i]->Release();
       }
       else
       {
-         iter++;
+         delete results_[i];
+         results_[i] = results_[--last];
       }
    }
+   n_spare_ = last - first;
+   n_results_ = first;
 }
 
 template<class T>
@@ -878,17 +1341,16 @@ void CachedResults<T>::DebugPrintCachedResults() const
    DBG_START_METH("CachedResults<T>::DebugPrintCachedResults", dbg_verbosity);
    if (DBG_VERBOSITY() >= 2 )
    {
-      if (!cached_results_)
+      if (n_results_ == 0)
       {
          DBG_PRINT((2, "Currentlt no cached results:\n"));
       }
       else
       {
-         typename std::list< DependentResult<T>* >::const_iterator iter;
          DBG_PRINT((2, "Current set of cached results:\n"));
-         for (iter = cached_results_->begin(); iter != cached_results_->end(); iter++)
+         for (Index i = 0; i < n_results_; i++)
          {
-            DBG_PRINT((2, "  DependentResult:0x%x\n", (*iter)));
+            DBG_PRINT((2, "  DependentResult:0x%x\n", results_[i]));
          }
       }
    }
@@ -11,6 +11,13 @@
 #include <cstdio>
 #include <cstring>
 
+#if __cplusplus >= 201103L
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#define IPOPT_ASYNC_JOURNAL
+#endif
+
 namespace Ipopt
 {
 
@@ -278,6 +285,21 @@ SmartPtr<Journal> Journalist::AddFileJournal(
    return NULL;
 }
 
+SmartPtr<Journal> Journalist::AddAsyncFileJournal(
+   const std::string& journal_name,
+   const std::string& fname,
+   EJournalLevel      default_level
+)
+{
+   SmartPtr<AsyncFileJournal> temp = new AsyncFileJournal(journal_name, default_level);
+
+   if( temp->Open(fname.c_str()) && AddJournal(GetRawPtr(temp)) )
+   {
+      return GetRawPtr(temp);
+   }
+   return NULL;
+}
+
 void Journalist::FlushBuffer() const
 {
    for( Index i = 0; i < (Index) journals_.size(); i++ )
@@ -286,6 +308,14 @@ void Journalist::FlushBuffer() const
    }
 }
 
+void Journalist::WaitForOutput() const
+{
+   for( Index i = 0; i < (Index) journals_.size(); i++ )
+   {
+      journals_[i]->WaitForOutput();
+   }
+}
+
 SmartPtr<Journal> Journalist::GetJournal(
    const std::string& journal_name
 )
@@ -461,6 +491,294 @@ void FileJournal::FlushBufferImpl()
    }
 }
 
+///////////////////////////////////////////////////////////////////////////
+//               Implementation of the AsyncFileJournal class            //
+///////////////////////////////////////////////////////////////////////////
+
+#ifdef IPOPT_ASYNC_JOURNAL
+
+/** Buffer of an AsyncFileJournal and the thread that writes it. */
+class AsyncFileJournal::Writer
+{
+public:
+   /** amount of output that is not yet written at which printing waits for the thread */
+   static const size_t max_pending = 1 << 20;
+
+   Writer(
+      AsyncFileJournal* journal
+   )
+      : journal_(journal),
+        flush_(false),
+        busy_(false),
+        stop_(false)
+   {
+      thread_ = std::thread(&Writer::Run, this);
+   }
+
+   ~Writer()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         stop_ = true;
+      }
+      work_cv_.notify_one();
+      thread_.join();
+   }
+
+   /** append a message to the buffer */
+   void Append(
+      const char* str,
+      size_t      len
+   )
+   {
+      std::unique_lock<std::mutex> lock(mutex_);
+      WaitForSpace(lock);
+      bool was_empty = pending_.empty();
+      pending_.append(str, len);
+      lock.unlock();
+      if( was_empty )
+      {
+         work_cv_.notify_one();
+      }
+   }
+
+   /** format a message and append it to the buffer */
+   void Appendf(
+      const char* pformat,
+      va_list     ap
+   )
+   {
+      char buffer[1024];
+      va_list apcopy;
+      va_copy(apcopy, ap);
+      int len = vsnprintf(buffer, sizeof(buffer), pformat, apcopy);
+      va_end(apcopy);
+      if( len < 0 )
+      {
+         return;
+      }
+      if( (size_t) len < sizeof(buffer) )
+      {
+         Append(buffer, (size_t) len);
+         return;
+      }
+
+      std::string str((size_t) len + 1, '\0');
+      va_copy(apcopy, ap);
+      vsnprintf(&str[0], str.size(), pformat, apcopy);
+      va_end(apcopy);
+      Append(str.c_str(), (size_t) len);
+   }
+
+   /** ask the thread to write and flush the buffer */
+   void RequestFlush()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         flush_ = true;
+      }
+      work_cv_.notify_one();
+   }
+
+   /** wait until the whole buffer has been written and flushed */
+   void Wait()
+   {
+      std::unique_lock<std::mutex> lock(mutex_);
+      flush_ = true;
+      work_cv_.notify_one();
+      while( busy_ || flush_ || !pending_.empty() )
+      {
+         done_cv_.wait(lock);
+      }
+   }
+
+private:
+   /** loop of the background thread */
+   void Run()
+   {
+      std::string output;
+      std::unique_lock<std::mutex> lock(mutex_);
+      while( true )
+      {
+         while( !stop_ && !flush_ && pending_.empty() )
+         {
+            work_cv_.wait(lock);
+         }
+         if( stop_ && !flush_ && pending_.empty() )
+         {
+            break;
+         }
+
+         // take the buffer, so that printing can continue while writing
+         output.clear();
+         output.swap(pending_);
+         bool flush = flush_ || stop_;
+         flush_ = false;
+         busy_ = true;
+         lock.unlock();
+         done_cv_.notify_all();
+
+         journal_->WriteOutput(output, flush);
+
+         lock.lock();
+         busy_ = false;
+         done_cv_.notify_all();
+      }
+   }
+
+   /** wait while too much output is not yet written */
+   void WaitForSpace(
+      std::unique_lock<std::mutex>& lock
+   )
+   {
+      while( pending_.size() >= max_pending )
+      {
+         done_cv_.wait(lock);
+      }
+   }
+
+   AsyncFileJournal* journal_;
+
+   std::mutex mutex_;
+   /** signaled when there is something to do for the thread */
+   std::condition_variable work_cv_;
+   /** signaled when the thread has taken or written the buffer */
+   std::condition_variable done_cv_;
+   /** output that is not yet taken by the thread */
+   std::string pending_;
+   /** whether the file should be flushed */
+   bool flush_;
+   /** whether the thread is writing */
+   bool busy_;
+   /** whether the thread should finish */
+   bool stop_;
+
+   std::thread thread_;
+};
+
+#else
+
+// without C++11 threads, the journal writes synchronously
+class AsyncFileJournal::Writer
+{ };
+
+#endif
+
+AsyncFileJournal::AsyncFileJournal(
+   const std::string& name,
+   EJournalLevel      default_level
+)
+   : FileJournal(name, default_level),
+     writer_(NULL)
+{
+#ifdef IPOPT_ASYNC_JOURNAL
+   try
+   {
+      writer_ = new Writer(this);
+   }
+   catch( const std::exception& )
+   {
+      // no thread available, so write synchronously
+      writer_ = NULL;
+   }
+#endif
+}
+
+AsyncFileJournal::~AsyncFileJournal()
+{
+   // finish writing before FileJournal closes the file
+   delete writer_;
+   writer_ = NULL;
+}
+
+bool AsyncFileJournal::Open(
+   const char* fname
+)
+{
+   WaitForOutput();
+   return FileJournal::Open(fname);
+}
+
+void AsyncFileJournal::WaitForOutput()
+{
+#ifdef IPOPT_ASYNC_JOURNAL
+   if( writer_ != NULL )
+   {
+      writer_->Wait();
+      return;
+   }
+#endif
+   FileJournal::FlushBufferImpl();
+}
+
+void AsyncFileJournal::PrintImpl(
+   EJournalCategory category,
+   EJournalLevel    level,
+   const char*      str
+)
+{
+#ifdef IPOPT_ASYNC_JOURNAL
+   if( writer_ != NULL )
+   {
+      writer_->Append(str, strlen(str));
+      if( level <= J_ERROR )
+      {
+         writer_->Wait();
+      }
+      return;
+   }
+#endif
+   FileJournal::PrintImpl(category, level, str);
+}
+
+void AsyncFileJournal::PrintfImpl(
+   EJournalCategory category,
+   EJournalLevel    level,
+   const char*      pformat,
+   va_list          ap
+)
+{
+#ifdef IPOPT_ASYNC_JOURNAL
+   if( writer_ != NULL )
+   {
+      writer_->Appendf(pformat, ap);
+      if( level <= J_ERROR )
+      {
+         writer_->Wait();
+      }
+      return;
+   }
+#endif
+   FileJournal::PrintfImpl(category, level, pformat, ap);
+}
+
+void AsyncFileJournal::FlushBufferImpl()
+{
+#ifdef IPOPT_ASYNC_JOURNAL
+   if( writer_ != NULL )
+   {
+      writer_->RequestFlush();
+      return;
+   }
+#endif
+   FileJournal::FlushBufferImpl();
+}
+
+void AsyncFileJournal::WriteOutput(
+   const std::string& output,
+   bool               flush
+)
+{
+   if( !output.empty() )
+   {
+      FileJournal::PrintImpl(J_DBG, J_ALL, output.c_str());
+   }
+   if( flush )
+   {
+      FileJournal::FlushBufferImpl();
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 //                 Implementation of the StreamJournal class               //
 ///////////////////////////////////////////////////////////////////////////
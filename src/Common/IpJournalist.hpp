@@ -200,6 +200,13 @@ public:
     * program (e.g. written in Fortran)
     */
    virtual void FlushBuffer() const;
+
+   /** Method that waits until the output of all journals has been written.
+    *
+    *  This differs from FlushBuffer only for journals that write
+    *  asynchronously, such as AsyncFileJournal.
+    */
+   virtual void WaitForOutput() const;
    ///@}
 
    /**@name Reader Methods.
@@ -228,6 +235,19 @@ public:
       EJournalLevel      default_level = J_WARNING /**< default journal level used to initialize the printing level for all categories */
    );
 
+   /** Add a new AsyncFileJournal.
+    *
+    *  Same as AddFileJournal, but the output is written to the file by a
+    *  background thread, see AsyncFileJournal.
+    *
+    *  @return the Journal pointer so you can set specific acceptance criteria, or NULL if there was a problem creating a new Journal.
+    */
+   virtual SmartPtr<Journal> AddAsyncFileJournal(
+      const std::string& location_name,            /**< string identifier, which can be used to obtain the pointer to the new Journal at a later point using the GetJournal method */
+      const std::string& fname,                    /**< name of the file to which this Journal corresponds; use "stdout" for stdout and use "stderr" for stderr */
+      EJournalLevel      default_level = J_WARNING /**< default journal level used to initialize the printing level for all categories */
+   );
+
    /** Get an existing journal.
     *
     *  You can use this method to change the acceptance criteria at runtime.
@@ -341,6 +361,15 @@ public:
    {
       FlushBufferImpl();
    }
+
+   /** Wait until all output has been written and flush the output buffer.
+    *
+    *  Journals that write asynchronously need to overload this method.
+    */
+   virtual void WaitForOutput()
+   {
+      FlushBufferImpl();
+   }
    ///@}
 
 protected:
@@ -483,6 +512,108 @@ private:
    FILE* file_;
 };
 
+/** AsyncFileJournal class.
+ *
+ *  This is a FileJournal that only formats the messages into a buffer
+ *  and leaves the writing to the file to a background thread.  This
+ *  keeps slow output locations (e.g., files on network filesystems) from
+ *  slowing down the computation.
+ *
+ *  FlushBuffer only asks the background thread to write and flush the
+ *  buffer.  Messages of level J_ERROR or lower, WaitForOutput, Open, and
+ *  the destructor wait until all output has been written.  If the amount
+ *  of output that is not yet written exceeds a limit, printing waits
+ *  for the background thread, too.
+ *
+ *  If Ipopt has been compiled without C++11 support, no thread is used
+ *  and this class behaves as FileJournal.
+ */
+class IPOPTLIB_EXPORT AsyncFileJournal: public FileJournal
+{
+public:
+   /** Constructor. */
+   AsyncFileJournal(
+      const std::string& name,
+      EJournalLevel default_level
+   );
+
+   /** Destructor. */
+   virtual ~AsyncFileJournal();
+
+   /** Open a new file for the output location.
+    *
+    *  Waits until the output to a previously opened file has been written.
+    */
+   virtual bool Open(
+      const char* fname
+   );
+
+   virtual void WaitForOutput();
+
+protected:
+   /**@name Implementation version of Print methods
+    *
+    * Overloaded from Journal base class.
+    */
+   ///@{
+   /** Print to the buffer */
+   virtual void PrintImpl(
+      EJournalCategory category,
+      EJournalLevel    level,
+      const char*      str
+   );
+
+   /** Printf to the buffer */
+   virtual void PrintfImpl(
+      EJournalCategory category,
+      EJournalLevel    level,
+      const char*      pformat,
+      va_list          ap
+   );
+
+   /** Ask the background thread to write and flush the buffer. */
+   virtual void FlushBufferImpl();
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   AsyncFileJournal();
+
+   /** Copy Constructor */
+   AsyncFileJournal(
+      const AsyncFileJournal&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const AsyncFileJournal&
+   );
+   ///@}
+
+   /** Buffer and thread, defined in the implementation file */
+   class Writer;
+   friend class Writer;
+
+   /** write a piece of output to the file, called by the background thread */
+   void WriteOutput(
+      const std::string& output,
+      bool               flush
+   );
+
+   /** buffer and background thread, NULL if no thread is used */
+   Writer* writer_;
+};
+
 /** StreamJournal class.
  *
  * This is a particular Journal implementation that writes to a stream for output.
@@ -564,4 +695,20 @@ private:
 
 } // namespace
 
+/** Print a message with Journalist::Printf only if some journal accepts it.
+ *
+ *  Different from calling Printf directly, the arguments after the format
+ *  are not evaluated if no journal accepts the level and category, so they
+ *  can contain expensive computations, e.g., norms of vectors.
+ *  jnlst must be a Journalist (not a pointer) and is evaluated twice.
+ */
+#define IPOPT_JNLST_PRINTF(jnlst, level, category, ...) \
+   do \
+   { \
+      if( (jnlst).ProduceOutput(level, category) ) \
+      { \
+         (jnlst).Printf(level, category, __VA_ARGS__); \
+      } \
+   } while( false )
+
 #endif
@@ -0,0 +1,209 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpMemoryStatistics.hpp"
+
+#include "IpUtils.hpp"
+
+/* Before C++11, the counters are updated by the atomic operations of the
+ * compiler, as for the tags of the TaggedObjects.
+ */
+#if __cplusplus < 201103L && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Ipopt
+{
+
+/** Statistics of the solve that runs in the current thread */
+static IPOPT_THREAD_LOCAL MemoryStatistics* current_stats = NULL;
+
+#if __cplusplus < 201103L
+/** Atomically add value to a counter and return the new value */
+static std::size_t AtomicAdd(
+   volatile std::size_t* counter,
+   std::size_t           value
+)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+   return (std::size_t) _InterlockedExchangeAdd64(reinterpret_cast<volatile __int64*>(counter), (__int64) value) + value;
+#elif defined(_MSC_VER)
+   return (std::size_t) _InterlockedExchangeAdd(reinterpret_cast<volatile long*>(counter), (long) value) + value;
+#elif defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 407)
+   return __atomic_add_fetch(counter, value, __ATOMIC_RELAXED);
+#else
+   return *counter += value;
+#endif
+}
+
+/** Atomically raise a high-water mark to value */
+static void AtomicMax(
+   volatile std::size_t* mark,
+   std::size_t           value
+)
+{
+   std::size_t old = *mark;
+   while( value > old )
+   {
+#if defined(_MSC_VER) && defined(_WIN64)
+      std::size_t prev = (std::size_t) _InterlockedCompareExchange64(reinterpret_cast<volatile __int64*>(mark), (__int64) value, (__int64) old);
+#elif defined(_MSC_VER)
+      std::size_t prev = (std::size_t) _InterlockedCompareExchange(reinterpret_cast<volatile long*>(mark), (long) value, (long) old);
+#elif defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 407)
+      std::size_t prev = old;
+      __atomic_compare_exchange_n(mark, &prev, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#else
+      std::size_t prev = old;
+      *mark = value;
+#endif
+      if( prev == old )
+      {
+         break;
+      }
+      old = prev;
+   }
+}
+#endif
+
+MemoryStatistics::MemoryStatistics()
+{
+   for( int i = 0; i < NUM_CATEGORIES; ++i )
+   {
+      current_bytes_[i] = 0;
+      high_water_marks_[i] = 0;
+   }
+}
+
+void MemoryStatistics::Allocate(
+   Category    category,
+   std::size_t bytes
+)
+{
+#if __cplusplus >= 201103L
+   std::size_t current = current_bytes_[category].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+   std::size_t mark = high_water_marks_[category].load(std::memory_order_relaxed);
+   while( current > mark
+          && !high_water_marks_[category].compare_exchange_weak(mark, current, std::memory_order_relaxed) )
+   { }
+#else
+   AtomicMax(&high_water_marks_[category], AtomicAdd(&current_bytes_[category], bytes));
+#endif
+}
+
+void MemoryStatistics::Free(
+   Category    category,
+   std::size_t bytes
+)
+{
+#if __cplusplus >= 201103L
+   current_bytes_[category].fetch_sub(bytes, std::memory_order_relaxed);
+#else
+   // adding the two's complement subtracts bytes
+   AtomicAdd(&current_bytes_[category], ~bytes + 1);
+#endif
+}
+
+std::size_t MemoryStatistics::CurrentBytes(
+   Category category
+) const
+{
+#if __cplusplus >= 201103L
+   return current_bytes_[category].load(std::memory_order_relaxed);
+#else
+   return current_bytes_[category];
+#endif
+}
+
+std::size_t MemoryStatistics::HighWaterMark(
+   Category category
+) const
+{
+#if __cplusplus >= 201103L
+   return high_water_marks_[category].load(std::memory_order_relaxed);
+#else
+   return high_water_marks_[category];
+#endif
+}
+
+void MemoryStatistics::ResetHighWaterMarks()
+{
+   for( int i = 0; i < NUM_CATEGORIES; ++i )
+   {
+#if __cplusplus >= 201103L
+      high_water_marks_[i].store(CurrentBytes(Category(i)), std::memory_order_relaxed);
+#else
+      high_water_marks_[i] = current_bytes_[i];
+#endif
+   }
+}
+
+MemoryStatistics* MemoryStatistics::Current()
+{
+   return current_stats;
+}
+
+MemoryStatistics::CurrentScope::CurrentScope(
+   MemoryStatistics* stats
+)
+   : previous_(current_stats)
+{
+   current_stats = stats;
+}
+
+MemoryStatistics::CurrentScope::~CurrentScope()
+{
+   current_stats = previous_;
+}
+
+const char* MemoryStatistics::Name(
+   Category category
+)
+{
+   switch( category )
+   {
+      case VECTOR_VALUES:
+         return "VectorValues";
+      case TRIPLET_MATRIX_VALUES:
+         return "TripletMatrixValues";
+      case LINEAR_SOLVER:
+         return "LinearSolverFactorization";
+      case LIMITED_MEMORY_UPDATE:
+         return "LimitedMemoryUpdate";
+      case CACHED_RESULTS:
+         return "CachedResults";
+      default:
+         break;
+   }
+   return "Unknown";
+}
+
+void MemoryStatistics::Print(
+   const Journalist& jnlst,
+   EJournalLevel     level,
+   EJournalCategory  category
+) const
+{
+   if( !jnlst.ProduceOutput(level, category) )
+   {
+      return;
+   }
+
+   // names padded with dots like in the timing statistics
+   static const char* labels[NUM_CATEGORIES] =
+   {
+      "VectorValues........................",
+      "TripletMatrixValues.................",
+      "LinearSolverFactorization...........",
+      "LimitedMemoryUpdate.................",
+      "CachedResults......................."
+   };
+   for( int i = 0; i < NUM_CATEGORIES; ++i )
+   {
+      jnlst.Printf(level, category,
+                   "%s: %10.3f (current: %10.3f)\n", labels[i], 1e-6 * (double) HighWaterMark(Category(i)),
+                   1e-6 * (double) CurrentBytes(Category(i)));
+   }
+}
+
+} // namespace Ipopt
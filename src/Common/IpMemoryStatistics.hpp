@@ -0,0 +1,232 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPMEMORYSTATISTICS_HPP__
+#define __IPMEMORYSTATISTICS_HPP__
+
+#include "IpJournalist.hpp"
+#include "IpReferenced.hpp"
+#include "IpSmartPtr.hpp"
+
+#include <cstddef>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
+namespace Ipopt
+{
+
+/** This class accounts for the memory that is allocated by some
+ *  subsystems of Ipopt during the solves of one IpoptApplication,
+ *  and keeps the high-water mark of each.
+ *
+ *  The subsystems report their allocations and deallocations through
+ *  a MemoryAccount.  The linear solver reports the memory estimate of
+ *  its factorization instead of its actual allocations.  The memory of
+ *  the vectors that are stored by the limited-memory quasi-Newton
+ *  update and by the caches of computed results is also part of the
+ *  memory of the vector values, so the categories are not added up.
+ *
+ *  While an IpoptApplication solves a problem, its statistics are the
+ *  current statistics of the thread (see Current).  The counters are
+ *  updated atomically, since the objects of a solve may also be
+ *  allocated and freed by other threads.
+ */
+class IPOPTLIB_EXPORT MemoryStatistics : public ReferencedObject
+{
+public:
+   /** Subsystems whose memory is accounted for */
+   enum Category
+   {
+      /** Values of DenseVectors, including the storage pool of their spaces */
+      VECTOR_VALUES = 0,
+      /** Values of triplet matrices, e.g., Jacobian and Hessian */
+      TRIPLET_MATRIX_VALUES,
+      /** Memory of the factorization reported by the linear solver */
+      LINEAR_SOLVER,
+      /** Vectors and matrices stored by the limited-memory quasi-Newton update */
+      LIMITED_MEMORY_UPDATE,
+      /** Vectors held by the caches of computed results */
+      CACHED_RESULTS,
+      /** Number of categories */
+      NUM_CATEGORIES
+   };
+
+   /** Constructor, with all counters zero */
+   MemoryStatistics();
+
+   /** Account for the allocation of bytes in a category */
+   void Allocate(
+      Category    category,
+      std::size_t bytes
+   );
+
+   /** Account for the deallocation of bytes in a category */
+   void Free(
+      Category    category,
+      std::size_t bytes
+   );
+
+   /** Number of bytes currently allocated in a category */
+   std::size_t CurrentBytes(
+      Category category
+   ) const;
+
+   /** Largest number of bytes allocated in a category since the last
+    *  call of ResetHighWaterMarks */
+   std::size_t HighWaterMark(
+      Category category
+   ) const;
+
+   /** Set the high-water marks to the currently allocated memory */
+   void ResetHighWaterMarks();
+
+   /** Name of a category */
+   static const char* Name(
+      Category category
+   );
+
+   /** Print the high-water marks and the currently allocated memory */
+   void Print(
+      const Journalist& jnlst,
+      EJournalLevel     level,
+      EJournalCategory  category
+   ) const;
+
+   /** Statistics of the solve that runs in the calling thread, or NULL */
+   static MemoryStatistics* Current();
+
+   /** Make some statistics the current statistics of the calling
+    *  thread for the lifetime of this object.
+    */
+   class IPOPTLIB_EXPORT CurrentScope
+   {
+   public:
+      /** Constructor, makes stats the current statistics */
+      explicit CurrentScope(
+         MemoryStatistics* stats
+      );
+
+      /** Destructor, restores the previous current statistics */
+      ~CurrentScope();
+
+   private:
+      /**@name Default Compiler Generated Methods
+       * (Hidden to avoid implicit creation/calling).
+       */
+      ///@{
+      /** Copy Constructor */
+      CurrentScope(
+         const CurrentScope&
+      );
+
+      /** Default Assignment Operator */
+      void operator=(
+         const CurrentScope&
+      );
+      ///@}
+
+      /** Current statistics before the constructor */
+      MemoryStatistics* previous_;
+   };
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    */
+   ///@{
+   /** Copy Constructor */
+   MemoryStatistics(
+      const MemoryStatistics&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const MemoryStatistics&
+   );
+   ///@}
+
+#if __cplusplus >= 201103L
+   /** Bytes currently allocated in each category */
+   std::atomic<std::size_t> current_bytes_[NUM_CATEGORIES];
+
+   /** High-water mark of each category */
+   std::atomic<std::size_t> high_water_marks_[NUM_CATEGORIES];
+#else
+   /** Bytes currently allocated in each category */
+   volatile std::size_t current_bytes_[NUM_CATEGORIES];
+
+   /** High-water mark of each category */
+   volatile std::size_t high_water_marks_[NUM_CATEGORIES];
+#endif
+};
+
+/** The memory of one category that is allocated by one object, e.g., a
+ *  vector space.
+ *
+ *  It reports to the statistics that were current when it was
+ *  constructed, so that the memory is freed in the same statistics in
+ *  which it has been allocated, even if this happens after the solve or
+ *  in another thread.  Outside of a solve, nothing is accounted for.
+ */
+class IPOPTLIB_EXPORT MemoryAccount
+{
+public:
+   /** Constructor */
+   explicit MemoryAccount(
+      MemoryStatistics::Category category
+   )
+      : stats_(MemoryStatistics::Current()),
+        category_(category)
+   { }
+
+   /** Account for the allocation of bytes */
+   void Allocate(
+      std::size_t bytes
+   ) const
+   {
+      if( IsValid(stats_) )
+      {
+         stats_->Allocate(category_, bytes);
+      }
+   }
+
+   /** Account for the deallocation of bytes */
+   void Free(
+      std::size_t bytes
+   ) const
+   {
+      if( IsValid(stats_) )
+      {
+         stats_->Free(category_, bytes);
+      }
+   }
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    */
+   ///@{
+   /** Copy Constructor */
+   MemoryAccount(
+      const MemoryAccount&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const MemoryAccount&
+   );
+   ///@}
+
+   /** Statistics that were current at the construction */
+   SmartPtr<MemoryStatistics> stats_;
+
+   /** Category of the memory */
+   MemoryStatistics::Category category_;
+};
+
+} // namespace Ipopt
+
+#endif
@@ -34,6 +34,12 @@ class Subject;
  *  from a Subject should inherit off of
  *  Observer and overload the protected method,
  *  ReceiveNotification_(...).
+ *
+ *  For each Subject it observes, an Observer holds a link that is
+ *  part of an intrusive doubly-linked list of the Observers attached
+ *  to this Subject.  Hence, attaching and detaching does not
+ *  allocate memory in the Subject and does not search its
+ *  Observers.
  */
 class IPOPTLIB_EXPORT Observer
 {
@@ -86,6 +92,12 @@ protected:
       const Subject* subject
    );
 
+   /** Derived classes can call this method to request a "Detach"
+    * from all Subjects that are currently observed.
+    */
+   inline
+   void RequestDetachAll();
+
    /** Derived classes should overload this method to
     * receive the requested notification from
     * attached Subjects
@@ -117,8 +129,30 @@ private:
    );
    ///@}
 
-   /** A list of the subjects currently being observed. */
-   std::vector<const Subject*> subjects_;
+   /** Link between an Observer and a Subject that it observes. */
+   struct SubjectLink
+   {
+      /** the observed Subject */
+      const Subject* subject;
+      /** the Observer that owns this link */
+      Observer*      observer;
+      /** previous link in the list of the Subject */
+      SubjectLink*   prev;
+      /** next link in the list of the Subject */
+      SubjectLink*   next;
+   };
+
+   /** Links to the subjects currently being observed.
+    *
+    *  All of them are in the lists of their Subjects.
+    */
+   std::vector<SubjectLink> links_;
+
+   /** Remove links_[i], which must have been removed from the list of its Subject already. */
+   inline
+   void RemoveLink(
+      size_t i
+   );
 
    /** Private Method for Receiving Notification
     *  should only be called by the friend class
@@ -130,8 +164,8 @@ private:
     */
    inline
    void ProcessNotification(
-      NotifyType     notify_type,
-      const Subject* subject
+      NotifyType   notify_type,
+      SubjectLink* link
    );
 
    friend class Subject;
@@ -157,6 +191,7 @@ public:
    ///@{
    /** Default Constructor */
    Subject()
+      : first_observer_(NULL)
    { }
 
    /** Destructor */
@@ -177,20 +212,20 @@ public:
     *  necessary.
     */
    ///@{
-   /** Attach the specified observer
+   /** Attach the observer with the specified link
     *  (i.e., begin receiving notifications). */
    inline
    void AttachObserver(
-      Observer::NotifyType notify_type,
-      Observer*            observer
+      Observer::NotifyType   notify_type,
+      Observer::SubjectLink* link
    ) const;
 
-   /** Detach the specified observer
+   /** Detach the observer with the specified link
     *  (i.e., no longer receive notifications). */
    inline
    void DetachObserver(
-      Observer::NotifyType notify_type,
-      Observer*            observer
+      Observer::NotifyType   notify_type,
+      Observer::SubjectLink* link
    ) const;
    ///@}
 
@@ -223,7 +258,10 @@ private:
    );
    ///@}
 
-   mutable std::vector<Observer*> observers_;
+   /** First link in the list of attached Observers */
+   mutable Observer::SubjectLink* first_observer_;
+
+   friend class Observer;
 };
 
 /* inline methods */
@@ -233,21 +271,13 @@ inline Observer::~Observer()
    DBG_START_METH("Observer::~Observer", dbg_verbosity);
    if (DBG_VERBOSITY() >= 1)
    {
-      for (Index i = 0; i < (Index)subjects_.size(); i++)
+      for (Index i = 0; i < (Index)links_.size(); i++)
       {
-         DBG_PRINT((1, "subjects_[%d] = 0x%x\n", i, subjects_[i]));
+         DBG_PRINT((1, "subjects_[%d] = 0x%x\n", i, links_[i].subject));
       }
    }
 #endif
-   // Detach all subjects
-   for( Int i = (Int) (subjects_.size() - 1); i >= 0; i-- )
-   {
-#ifdef IP_DEBUG_OBSERVER
-      DBG_PRINT((1, "About to detach subjects_[%d] = 0x%x\n", i, subjects_[i]));
-#endif
-
-      RequestDetach(NT_All, subjects_[i]);
-   }
+   RequestDetachAll();
 }
 
 inline
@@ -260,16 +290,37 @@ void Observer::RequestAttach(
    DBG_START_METH("Observer::RequestAttach", dbg_verbosity);
 
    // Add the subject to the list if it does not already exist
-   std::vector<const Subject*>::iterator attached_subject;
-   attached_subject = std::find(subjects_.begin(), subjects_.end(), subject);
-   DBG_ASSERT(attached_subject == subjects_.end());
+   for( size_t i = 0; i < links_.size(); i++ )
+   {
+      DBG_ASSERT(links_[i].subject != subject);
+   }
    DBG_ASSERT(subject);
 #endif
 
+   if( !links_.empty() && links_.size() == links_.capacity() )
+   {
+      // the links are moved in memory when links_ grows, so take them
+      // out of the lists of their subjects during the reallocation
+      for( size_t i = 0; i < links_.size(); i++ )
+      {
+         links_[i].subject->DetachObserver(NT_All, &links_[i]);
+      }
+      links_.reserve(2 * links_.size());
+      for( size_t i = 0; i < links_.size(); i++ )
+      {
+         links_[i].subject->AttachObserver(NT_All, &links_[i]);
+      }
+   }
+
    // add the subject to the list
-   subjects_.push_back(subject);
+   SubjectLink link;
+   link.subject = subject;
+   link.observer = this;
+   link.prev = NULL;
+   link.next = NULL;
+   links_.push_back(link);
    // Attach the observer to the subject
-   subject->AttachObserver(notify_type, this);
+   subject->AttachObserver(notify_type, &links_.back());
 }
 
 inline
@@ -286,58 +337,101 @@ void Observer::RequestDetach(
 
    if( subject )
    {
-      std::vector<const Subject*>::iterator attached_subject;
-      attached_subject = std::find(subjects_.begin(), subjects_.end(), subject);
+      size_t i = 0;
+      while( i < links_.size() && links_[i].subject != subject )
+      {
+         i++;
+      }
 #ifdef IP_DEBUG_OBSERVER
 
-      DBG_ASSERT(attached_subject != subjects_.end());
+      DBG_ASSERT(i < links_.size());
 #endif
 
-      if( attached_subject != subjects_.end() )
+      if( i < links_.size() )
       {
 #ifdef IP_DEBUG_OBSERVER
          DBG_PRINT((1, "Removing subject: 0x%x from the list\n", subject));
 #endif
 
-         subjects_.erase(attached_subject);
+         // Detach the observer from the subject
+         subject->DetachObserver(notify_type, &links_[i]);
+         RemoveLink(i);
       }
-
-      // Detach the observer from the subject
-      subject->DetachObserver(notify_type, this);
    }
 }
 
 inline
-void Observer::ProcessNotification(
-   NotifyType     notify_type,
-   const Subject* subject
-)
+void Observer::RequestDetachAll()
 {
 #ifdef IP_DEBUG_OBSERVER
-   DBG_START_METH("Observer::ProcessNotification", dbg_verbosity);
-   DBG_ASSERT(subject);
+   DBG_START_METH("Observer::RequestDetachAll", dbg_verbosity);
 #endif
 
-   if( subject )
+   // Detach all subjects
+   for( Int i = (Int) (links_.size() - 1); i >= 0; i-- )
    {
-      std::vector<const Subject*>::iterator attached_subject;
-      attached_subject = std::find(subjects_.begin(), subjects_.end(), subject);
-
-      // We must be processing a notification for a
-      // subject that was previously attached.
 #ifdef IP_DEBUG_OBSERVER
-
-      DBG_ASSERT(attached_subject != subjects_.end());
+      DBG_PRINT((1, "About to detach subjects_[%d] = 0x%x\n", i, links_[i].subject));
 #endif
 
-      this->ReceiveNotification(notify_type, subject);
+      links_[i].subject->DetachObserver(NT_All, &links_[i]);
+   }
+   // keeps the memory for the links
+   links_.clear();
+}
 
-      if( notify_type == NT_BeingDestroyed )
+inline
+void Observer::RemoveLink(
+   size_t i
+)
+{
+   size_t last = links_.size() - 1;
+   if( i != last )
+   {
+      // move the last link into the gap and update the list of its
+      // subject for the new address
+      links_[i] = links_[last];
+      SubjectLink& moved = links_[i];
+      if( moved.prev != NULL )
+      {
+         moved.prev->next = &moved;
+      }
+      else
+      {
+         moved.subject->first_observer_ = &moved;
+      }
+      if( moved.next != NULL )
       {
-         // the subject is going away, remove it from our list
-         subjects_.erase(attached_subject);
+         moved.next->prev = &moved;
       }
    }
+   links_.pop_back();
+}
+
+inline
+void Observer::ProcessNotification(
+   NotifyType   notify_type,
+   SubjectLink* link
+)
+{
+#ifdef IP_DEBUG_OBSERVER
+   DBG_START_METH("Observer::ProcessNotification", dbg_verbosity);
+   DBG_ASSERT(link);
+
+   // We must be processing a notification for a
+   // subject that was previously attached.
+   DBG_ASSERT(link->observer == this);
+   DBG_ASSERT(!links_.empty() && link >= &links_.front() && link <= &links_.back());
+#endif
+
+   this->ReceiveNotification(notify_type, link->subject);
+
+   if( notify_type == NT_BeingDestroyed )
+   {
+      // the subject is going away and has already taken the link out
+      // of its list, remove it from our list
+      RemoveLink(link - &links_[0]);
+   }
 }
 
 inline Subject::~Subject()
@@ -346,17 +440,24 @@ inline Subject::~Subject()
    DBG_START_METH("Subject::~Subject", dbg_verbosity);
 #endif
 
-   std::vector<Observer*>::iterator iter;
-   for( iter = observers_.begin(); iter != observers_.end(); iter++ )
+   // take the first link out of the list before notifying its observer,
+   // which removes the link and may move another one of its links
+   while( first_observer_ != NULL )
    {
-      (*iter)->ProcessNotification(Observer::NT_BeingDestroyed, this);
+      Observer::SubjectLink* link = first_observer_;
+      first_observer_ = link->next;
+      if( first_observer_ != NULL )
+      {
+         first_observer_->prev = NULL;
+      }
+      link->observer->ProcessNotification(Observer::NT_BeingDestroyed, link);
    }
 }
 
 inline
 void Subject::AttachObserver(
-   Observer::NotifyType /*notify_type*/,
-   Observer*            observer
+   Observer::NotifyType   /*notify_type*/,
+   Observer::SubjectLink* link
 ) const
 {
 #ifdef IP_DEBUG_OBSERVER
@@ -364,43 +465,45 @@ void Subject::AttachObserver(
    // current implementation notifies all observers of everything
    // they must filter the notifications that they are not interested
    // in (i.e. a hub, not a router)
-   DBG_ASSERT(observer);
-
-   std::vector<Observer*>::iterator attached_observer;
-   attached_observer = std::find(observers_.begin(), observers_.end(), observer);
-   DBG_ASSERT(attached_observer == observers_.end());
-
-   DBG_ASSERT(observer);
+   DBG_ASSERT(link);
+   DBG_ASSERT(link->subject == this);
 #endif
 
-   observers_.push_back(observer);
+   link->prev = NULL;
+   link->next = first_observer_;
+   if( first_observer_ != NULL )
+   {
+      first_observer_->prev = link;
+   }
+   first_observer_ = link;
 }
 
 inline
 void Subject::DetachObserver(
-   Observer::NotifyType /*notify_type*/,
-   Observer*            observer
+   Observer::NotifyType   /*notify_type*/,
+   Observer::SubjectLink* link
 ) const
 {
 #ifdef IP_DEBUG_OBSERVER
    DBG_START_METH("Subject::DetachObserver", dbg_verbosity);
-   DBG_ASSERT(observer);
+   DBG_ASSERT(link);
+   DBG_ASSERT(link->subject == this);
 #endif
 
-   if( observer )
+   if( link->prev != NULL )
    {
-      std::vector<Observer*>::iterator attached_observer;
-      attached_observer = std::find(observers_.begin(), observers_.end(), observer);
-#ifdef IP_DEBUG_OBSERVER
-
-      DBG_ASSERT(attached_observer != observers_.end());
-#endif
-
-      if( attached_observer != observers_.end() )
-      {
-         observers_.erase(attached_observer);
-      }
+      link->prev->next = link->next;
+   }
+   else
+   {
+      first_observer_ = link->next;
+   }
+   if( link->next != NULL )
+   {
+      link->next->prev = link->prev;
    }
+   link->prev = NULL;
+   link->next = NULL;
 }
 
 inline
@@ -412,10 +515,9 @@ void Subject::Notify(
    DBG_START_METH("Subject::Notify", dbg_verbosity);
 #endif
 
-   std::vector<Observer*>::iterator iter;
-   for( iter = observers_.begin(); iter != observers_.end(); iter++ )
+   for( Observer::SubjectLink* link = first_observer_; link != NULL; link = link->next )
    {
-      (*iter)->ProcessNotification(notify_type, this);
+      link->observer->ProcessNotification(notify_type, link);
    }
 }
 
@@ -98,6 +98,7 @@ bool OptionsList::SetStringValue(
       //    if (will_allow_clobber(tag)) {
       OptionsList::OptionValue optval(value, allow_clobber, dont_print);
       options_[lowercase(tag)] = optval;
+      ++revision_;
    }
    return true;
 
@@ -198,6 +199,7 @@ bool OptionsList::SetNumericValue(
    {
       OptionsList::OptionValue optval(buffer, allow_clobber, dont_print);
       options_[lowercase(tag)] = optval;
+      ++revision_;
    }
    return true;
 }
@@ -210,7 +212,7 @@ bool OptionsList::SetIntegerValue(
 )
 {
    char buffer[256];
-   Snprintf(buffer, 255, "%d", value);
+   Snprintf(buffer, 255, "%" IPOPT_INDEX_FORMAT, value);
 
    if( IsValid(reg_options_) )
    {
@@ -290,6 +292,7 @@ bool OptionsList::SetIntegerValue(
       //    if (will_allow_clobber(tag)) {
       OptionsList::OptionValue optval(buffer, allow_clobber, dont_print);
       options_[lowercase(tag)] = optval;
+      ++revision_;
    }
    return true;
 }
@@ -348,123 +351,211 @@ bool OptionsList::GetStringValue(
    const std::string& prefix
 ) const
 {
-   SmartPtr<const RegisteredOption> option = NULL;
+   return GetStringValue(GetOptionHandle(tag, prefix), value);
+}
 
-   bool found = find_tag(tag, prefix, value);
+bool OptionsList::GetEnumValue(
+   const std::string& tag,
+   Index&             value,
+   const std::string& prefix
+) const
+{
+   return GetEnumValue(GetOptionHandle(tag, prefix), value);
+}
 
-   if( IsValid(reg_options_) )
+bool OptionsList::GetBoolValue(
+   const std::string& tag,
+   bool&              value,
+   const std::string& prefix
+) const
+{
+   return GetBoolValue(GetOptionHandle(tag, prefix), value);
+}
+
+bool OptionsList::GetNumericValue(
+   const std::string& tag,
+   Number&            value,
+   const std::string& prefix
+) const
+{
+   return GetNumericValue(GetOptionHandle(tag, prefix), value);
+}
+
+bool OptionsList::GetIntegerValue(
+   const std::string& tag,
+   Index&             value,
+   const std::string& prefix
+) const
+{
+   return GetIntegerValue(GetOptionHandle(tag, prefix), value);
+}
+
+OptionsList::OptionHandle OptionsList::GetOptionHandle(
+   const std::string& tag,
+   const std::string& prefix
+) const
+{
+   std::map<std::string, OptionHandle>& prefix_handles = handles_[prefix];
+   std::map<std::string, OptionHandle>::const_iterator p = prefix_handles.find(tag);
+   if( p != prefix_handles.end() )
+   {
+      return p->second;
+   }
+
+   ResolvedOption res;
+   res.tag = tag;
+   res.prefix = prefix;
+   res.revision = -1;
+   res.optvalue = NULL;
+   res.has_string = false;
+   res.has_enum = false;
+   res.has_number = false;
+   res.has_integer = false;
+
+   OptionHandle handle = (OptionHandle) resolved_.size();
+   resolved_.push_back(res);
+   prefix_handles[tag] = handle;
+   return handle;
+}
+
+OptionsList::ResolvedOption& OptionsList::resolve_handle(
+   OptionHandle         handle,
+   RegisteredOptionType type
+) const
+{
+   DBG_ASSERT(handle >= 0 && handle < (Index) resolved_.size());
+   ResolvedOption& res = resolved_[handle];
+
+   if( res.revision != revision_ )
    {
-      option = reg_options_->GetOption(tag);
-      if( IsNull(option) )
+      res.option = NULL;
+      if( IsValid(reg_options_) )
       {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is not a valid registered option.";
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         res.option = reg_options_->GetOption(res.tag);
+         if( IsNull(res.option) )
+         {
+            std::string msg = "IPOPT tried to get the value of Option: " + res.tag;
+            msg += ". It is not a valid registered option.";
+            THROW_EXCEPTION(OPTION_INVALID, msg);
+         }
       }
 
-      if( option->Type() != OT_String )
+      std::map<std::string, OptionValue>::const_iterator p = options_.end();
+      if( res.prefix != "" )
       {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is a valid option, but it is of type ";
-         if( option->Type() == OT_Integer )
-         {
-            msg += " Integer";
-         }
-         else if( option->Type() == OT_Number )
-         {
-            msg += " Number";
-         }
-         else
-         {
-            msg += " Unknown";
-         }
-         msg += ", not of type String. Please check the documentation for options.";
-         if( IsValid(jnlst_) )
-         {
-            option->OutputDescription(*jnlst_);
-         }
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         p = options_.find(lowercase(res.prefix + res.tag));
+      }
+      if( p == options_.end() )
+      {
+         p = options_.find(lowercase(res.tag));
       }
+      res.optvalue = (p != options_.end()) ? &p->second : NULL;
 
-      if( found )
+      res.has_string = false;
+      res.has_enum = false;
+      res.has_number = false;
+      res.has_integer = false;
+      res.revision = revision_;
+   }
+
+   if( IsValid(res.option) && res.option->Type() != type )
+   {
+      std::string msg = "IPOPT tried to get the value of Option: " + res.tag;
+      msg += ". It is a valid option, but it is of type ";
+      switch( res.option->Type() )
       {
-         value = option->MapStringSetting(value);
+         case OT_Number:
+            msg += " Number";
+            break;
+         case OT_Integer:
+            msg += " Integer";
+            break;
+         case OT_String:
+            msg += " String";
+            break;
+         default:
+            msg += " Unknown";
+            break;
       }
-      else
+      msg += ", not of type ";
+      msg += type == OT_Number ? "Number" : type == OT_Integer ? "Integer" : "String";
+      msg += ". Please check the documentation for options.";
+      if( IsValid(jnlst_) )
       {
-         value = option->DefaultString();
+         res.option->OutputDescription(*jnlst_);
       }
+      THROW_EXCEPTION(OPTION_INVALID, msg);
+   }
+
+   if( res.optvalue != NULL )
+   {
+      res.optvalue->IncreaseCounter();
    }
 
-   return found;
+   return res;
 }
 
-bool OptionsList::GetEnumValue(
-   const std::string& tag,
-   Index&             value,
-   const std::string& prefix
+bool OptionsList::GetStringValue(
+   OptionHandle handle,
+   std::string& value
 ) const
 {
-   std::string str;
-   SmartPtr<const RegisteredOption> option = NULL;
-
-   bool found = find_tag(tag, prefix, str);
+   ResolvedOption& res = resolve_handle(handle, OT_String);
 
-   if( IsValid(reg_options_) )
+   if( !res.has_string )
    {
-      option = reg_options_->GetOption(tag);
-      if( IsNull(option) )
+      if( IsValid(res.option) )
       {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is not a valid registered option.";
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         res.string_value = res.optvalue != NULL ? res.option->MapStringSetting(res.optvalue->Value()) :
+                               res.option->DefaultString();
+         res.has_string = true;
       }
-
-      if( option->Type() != OT_String )
+      else if( res.optvalue != NULL )
       {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is a valid option, but it is of type ";
-         if( option->Type() == OT_Integer )
-         {
-            msg += " Integer";
-         }
-         else if( option->Type() == OT_Number )
-         {
-            msg += " Number";
-         }
-         else
-         {
-            msg += " Unknown";
-         }
-         msg += ", not of type String. Please check the documentation for options.";
-         if( IsValid(jnlst_) )
-         {
-            option->OutputDescription(*jnlst_);
-         }
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         res.string_value = res.optvalue->Value();
+         res.has_string = true;
       }
-
-      if( found )
+      else
       {
-         value = option->MapStringSettingToEnum(str);
+         // without registered options, value is not touched if not found
+         return false;
       }
-      else
+   }
+
+   value = res.string_value;
+   return res.optvalue != NULL;
+}
+
+bool OptionsList::GetEnumValue(
+   OptionHandle handle,
+   Index&       value
+) const
+{
+   ResolvedOption& res = resolve_handle(handle, OT_String);
+
+   if( !res.has_enum )
+   {
+      if( IsNull(res.option) )
       {
-         value = option->DefaultStringAsEnum();
+         // enum values are only known for registered options
+         return res.optvalue != NULL;
       }
+      res.enum_value = res.optvalue != NULL ? res.option->MapStringSettingToEnum(res.optvalue->Value()) :
+                          res.option->DefaultStringAsEnum();
+      res.has_enum = true;
    }
 
-   return found;
+   value = res.enum_value;
+   return res.optvalue != NULL;
 }
 
 bool OptionsList::GetBoolValue(
-   const std::string& tag,
-   bool&              value,
-   const std::string& prefix
+   OptionHandle handle,
+   bool&        value
 ) const
 {
    std::string str;
-   bool ret = GetStringValue(tag, str, prefix);
+   bool ret = GetStringValue(handle, str);
    if( str == "no" || str == "false" || str == "off" )
    {
       value = false;
@@ -482,147 +573,90 @@ bool OptionsList::GetBoolValue(
 }
 
 bool OptionsList::GetNumericValue(
-   const std::string& tag,
-   Number&            value,
-   const std::string& prefix
+   OptionHandle handle,
+   Number&      value
 ) const
 {
-   SmartPtr<const RegisteredOption> option = NULL;
+   ResolvedOption& res = resolve_handle(handle, OT_Number);
 
-   if( IsValid(reg_options_) )
+   if( !res.has_number )
    {
-      option = reg_options_->GetOption(tag);
-      if( IsNull(option) )
+      if( res.optvalue != NULL )
       {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is not a valid registered option.";
-         THROW_EXCEPTION(OPTION_INVALID, msg);
-      }
-
-      if( option->Type() != OT_Number )
-      {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is a valid option, but it is of type ";
-         if( option->Type() == OT_Integer )
-         {
-            msg += " Integer";
-         }
-         else if( option->Type() == OT_String )
+         const std::string strvalue = res.optvalue->Value();
+         // Some people like to use 'd' instead of 'e' in floating point
+         // numbers.  Therefore, we change a 'd' to an 'e'
+         char* buffer = new char[strvalue.length() + 1];
+         strcpy(buffer, strvalue.c_str());
+         for( int i = 0; i < (int) strvalue.length(); ++i )
          {
-            msg += " String";
-         }
-         else
-         {
-            msg += " Unknown";
+            if( buffer[i] == 'd' || buffer[i] == 'D' )
+            {
+               buffer[i] = 'e';
+            }
          }
-         msg += ", not of type Number. Please check the documentation for options.";
-         if( IsValid(jnlst_) )
+         char* p_end;
+         Number retval = strtod(buffer, &p_end);
+         if( *p_end != '\0' && !isspace(*p_end) )
          {
-            option->OutputDescription(*jnlst_);
+            delete[] buffer;
+            std::string msg = "Option \"" + res.tag + "\": Double value expected, but non-numeric value \"" + strvalue
+                              + "\" found.\n";
+            THROW_EXCEPTION(OPTION_INVALID, msg);
          }
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         delete[] buffer;
+         res.number_value = retval;
       }
-   }
-
-   std::string strvalue;
-   if( find_tag(tag, prefix, strvalue) )
-   {
-      // Some people like to use 'd' instead of 'e' in floating point
-      // numbers.  Therefore, we change a 'd' to an 'e'
-      char* buffer = new char[strvalue.length() + 1];
-      strcpy(buffer, strvalue.c_str());
-      for( int i = 0; i < (int) strvalue.length(); ++i )
+      else if( IsValid(res.option) )
       {
-         if( buffer[i] == 'd' || buffer[i] == 'D' )
-         {
-            buffer[i] = 'e';
-         }
+         res.number_value = res.option->DefaultNumber();
       }
-      char* p_end;
-      Number retval = strtod(buffer, &p_end);
-      if( *p_end != '\0' && !isspace(*p_end) )
+      else
       {
-         delete[] buffer;
-         std::string msg = "Option \"" + tag + "\": Double value expected, but non-numeric value \"" + strvalue
-                           + "\" found.\n";
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         return false;
       }
-      delete[] buffer;
-      value = retval;
-      return true;
+      res.has_number = true;
    }
-   else if( IsValid(option) )
-   {
-      value = option->DefaultNumber();
-      return false;
-   }
-   return false;
+
+   value = res.number_value;
+   return res.optvalue != NULL;
 }
 
 bool OptionsList::GetIntegerValue(
-   const std::string& tag,
-   Index&             value,
-   const std::string& prefix
+   OptionHandle handle,
+   Index&       value
 ) const
 {
-   SmartPtr<const RegisteredOption> option = NULL;
+   ResolvedOption& res = resolve_handle(handle, OT_Integer);
 
-   if( IsValid(reg_options_) )
+   if( !res.has_integer )
    {
-      option = reg_options_->GetOption(tag);
-      if( IsNull(option) )
-      {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is not a valid registered option.";
-         THROW_EXCEPTION(OPTION_INVALID, msg);
-      }
-
-      if( option->Type() != OT_Integer )
+      if( res.optvalue != NULL )
       {
-         std::string msg = "IPOPT tried to get the value of Option: " + tag;
-         msg += ". It is a valid option, but it is of type ";
-         if( option->Type() == OT_Number )
-         {
-            msg += " Number";
-         }
-         else if( option->Type() == OT_String )
-         {
-            msg += " String";
-         }
-         else
+         const std::string strvalue = res.optvalue->Value();
+         char* p_end;
+         size_t retval = strtol(strvalue.c_str(), &p_end, 10);
+         if( *p_end != '\0' && !isspace(*p_end) )
          {
-            msg += " Unknown";
-         }
-         msg += ", not of type Integer. Please check the documentation for options.";
-         if( IsValid(jnlst_) )
-         {
-            option->OutputDescription(*jnlst_);
+            std::string msg = "Option \"" + res.tag + "\": Integer value expected, but non-integer value \"" + strvalue
+                              + "\" found.\n";
+            THROW_EXCEPTION(OPTION_INVALID, msg);
          }
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         res.integer_value = static_cast<Index>(retval);
       }
-   }
-
-   std::string strvalue;
-   if( find_tag(tag, prefix, strvalue) )
-   {
-      char* p_end;
-      size_t retval = strtol(strvalue.c_str(), &p_end, 10);
-      if( *p_end != '\0' && !isspace(*p_end) )
+      else if( IsValid(res.option) )
       {
-         std::string msg = "Option \"" + tag + "\": Integer value expected, but non-integer value \"" + strvalue
-                           + "\" found.\n";
-         THROW_EXCEPTION(OPTION_INVALID, msg);
+         res.integer_value = res.option->DefaultInteger();
       }
-      value = static_cast<Index>(retval);
-      return true;
-   }
-   else if( IsValid(option) )
-   {
-      value = option->DefaultInteger();
-      return false;
+      else
+      {
+         return false;
+      }
+      res.has_integer = true;
    }
 
-   return false;
+   value = res.integer_value;
+   return res.optvalue != NULL;
 }
 
 const std::string& OptionsList::lowercase(
@@ -647,7 +681,7 @@ void OptionsList::PrintList(
    list += buffer;
    for( std::map<std::string, OptionValue>::const_iterator p = options_.begin(); p != options_.end(); p++ )
    {
-      Snprintf(buffer, 255, "%40s = %-20s %6d\n", p->first.c_str(), p->second.Value().c_str(), p->second.Counter());
+      Snprintf(buffer, 255, "%40s = %-20s %6" IPOPT_INDEX_FORMAT "\n", p->first.c_str(), p->second.Value().c_str(), p->second.Counter());
       list += buffer;
    }
 }
@@ -791,41 +825,6 @@ bool OptionsList::ReadFromStream(
    }
 }
 
-bool OptionsList::find_tag(
-   const std::string& tag,
-   const std::string& prefix,
-   std::string&       value
-) const
-{
-   bool found = false;
-   std::map<std::string, OptionValue>::const_iterator p;
-
-   if( prefix != "" )
-   {
-      p = options_.find(lowercase(prefix + tag));
-      if( p != options_.end() )
-      {
-         found = true;
-      }
-   }
-
-   if( !found )
-   {
-      p = options_.find(lowercase(tag));
-      if( p != options_.end() )
-      {
-         found = true;
-      }
-   }
-
-   if( found )
-   {
-      value = p->second.GetValue();
-   }
-
-   return found;
-}
-
 bool OptionsList::will_allow_clobber(
    const std::string& tag
 ) const
@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 
 namespace Ipopt
 {
@@ -28,6 +29,12 @@ DECLARE_STD_EXCEPTION(OPTION_INVALID);
  *  convenience set and get methods are provided to obtain Index and
  *  Number type values.  For each keyword we also keep track of how
  *  often the value of an option has been requested by a get method.
+ *
+ *  Options that are read repeatedly (e.g., in InitializeImpl methods
+ *  that are run for every reoptimization) can be accessed by a handle,
+ *  see GetOptionHandle.  For a handle, the tag is looked up in the list
+ *  and in the registered options only once and the value is parsed only
+ *  once, until the list is changed.
  */
 class IPOPTLIB_EXPORT OptionsList: public ReferencedObject
 {
@@ -103,6 +110,13 @@ class IPOPTLIB_EXPORT OptionsList: public ReferencedObject
          return value_;
       }
 
+      /** Method for increasing the request counter without retrieving the value */
+      void IncreaseCounter() const
+      {
+         DBG_ASSERT(initialized_);
+         counter_++;
+      }
+
       /** Method for accessing current value of the request counter */
       Index Counter() const
       {
@@ -151,17 +165,20 @@ public:
       SmartPtr<RegisteredOptions> reg_options,
       SmartPtr<Journalist>        jnlst
    )
-      : reg_options_(reg_options),
+      : revision_(0),
+        reg_options_(reg_options),
         jnlst_(jnlst)
    { }
 
    OptionsList()
+      : revision_(0)
    { }
 
    /** Copy Constructor */
    OptionsList(
       const OptionsList& copy
    )
+      : revision_(0)
    {
       // copy all the option strings and values
       options_ = copy.options_;
@@ -181,6 +198,7 @@ public:
       options_ = source.options_;
       reg_options_ = source.reg_options_;
       jnlst_ = source.jnlst_;
+      ++revision_;
    }
    ///@}
 
@@ -188,6 +206,7 @@ public:
    virtual void clear()
    {
       options_.clear();
+      ++revision_;
    }
 
    /** @name Get / Set Methods */
@@ -197,6 +216,7 @@ public:
    )
    {
       reg_options_ = reg_options;
+      ++revision_;
    }
 
    virtual void SetJournalist(
@@ -291,6 +311,54 @@ public:
    ) const;
    ///@}
 
+   /** Handle of an option, see GetOptionHandle */
+   typedef Index OptionHandle;
+
+   /** Method for obtaining a handle for reading an option repeatedly.
+    *
+    *  The handle refers to the tag and prefix and remains valid for
+    *  the lifetime of this list, also if the list is changed, but it
+    *  cannot be used with another OptionsList.  Reading the value by
+    *  the handle does not repeat the lookup and the parsing of the
+    *  value unless the list has been changed after the last read.
+    */
+   OptionHandle GetOptionHandle(
+      const std::string& tag,
+      const std::string& prefix
+   ) const;
+
+   /** @name Methods for retrieving values by a handle.
+    *
+    *  These behave as the methods for retrieving values by tag and
+    *  prefix.
+    */
+   ///@{
+   bool GetStringValue(
+      OptionHandle handle,
+      std::string& value
+   ) const;
+
+   bool GetEnumValue(
+      OptionHandle handle,
+      Index&       value
+   ) const;
+
+   bool GetBoolValue(
+      OptionHandle handle,
+      bool&        value
+   ) const;
+
+   bool GetNumericValue(
+      OptionHandle handle,
+      Number&      value
+   ) const;
+
+   bool GetIntegerValue(
+      OptionHandle handle,
+      Index&       value
+   ) const;
+   ///@}
+
    /** Get a string with the list of all options (tag, value, counter) */
    virtual void PrintList(
       std::string& list
@@ -329,9 +397,45 @@ private:
    /** Default Constructor */
    //    OptionsList();
    ///@}
+   /** An option tag and prefix that has a handle, with the values obtained for it */
+   struct ResolvedOption
+   {
+      /** tag of the option */
+      std::string tag;
+      /** prefix of the option */
+      std::string prefix;
+      /** value of revision_ when the members below have been set, or -1 */
+      Index revision;
+      /** registered option for tag, NULL if there are no registered options */
+      SmartPtr<const RegisteredOption> option;
+      /** option value found for prefix+tag or tag, NULL if not found */
+      const OptionValue* optvalue;
+
+      /**@name values that have been parsed already */
+      ///@{
+      bool has_string;
+      std::string string_value;
+      bool has_enum;
+      Index enum_value;
+      bool has_number;
+      Number number_value;
+      bool has_integer;
+      Index integer_value;
+      ///@}
+   };
+
    /** map for storing the options */
    std::map<std::string, OptionValue> options_;
 
+   /** counter that is increased with every change of the options */
+   Index revision_;
+
+   /** options with a handle; the handle is the position in this vector */
+   mutable std::vector<ResolvedOption> resolved_;
+
+   /** handles of options by prefix and tag */
+   mutable std::map<std::string, std::map<std::string, OptionHandle> > handles_;
+
    /** list of all the registered options to validate against */
    SmartPtr<RegisteredOptions> reg_options_;
 
@@ -343,18 +447,17 @@ private:
       const std::string tag
    ) const;
 
-   /** auxiliary method for finding the value for a tag in the options list
+   /** auxiliary method for updating the lookup of a handle if the list has changed
     *
-    *  This method first looks for the concatenated
-    *  string prefix+tag (if prefix is not ""), and if this is not
-    *  found, it looks for tag.  The return value is true iff
-    *  prefix+tag or tag is found.  In that case, the corresponding
-    *  string value is copied into value.
+    *  The value is looked up for the concatenated string prefix+tag
+    *  (if prefix is not ""), and if this is not found, for tag.
+    *  The request counter of the found value is increased.
+    *  Throws OPTION_INVALID if there are registered options, but the tag
+    *  is not a registered option of the given type.
     */
-   bool find_tag(
-      const std::string& tag,
-      const std::string& prefix,
-      std::string&       value
+   ResolvedOption& resolve_handle(
+      OptionHandle         handle,
+      RegisteredOptionType type
    ) const;
 
    /** tells whether or not we can clobber a particular option
@@ -16,6 +16,30 @@
 #define IP_DEBUG_REFERENCED
 #endif
 
+/* If IPOPT_ATOMIC_REFCOUNT is defined, the reference count of a
+ * ReferencedObject is changed by atomic operations, so that SmartPtrs
+ * to the same object can be created and released concurrently by
+ * several threads.  It needs to be defined consistently when building
+ * Ipopt and the code that uses it.
+ */
+#if defined(IPOPT_ATOMIC_REFCOUNT) && defined(_MSC_VER)
+#include <intrin.h>
+/* The Interlocked functions have to operate on all bytes of an Index,
+ * which is 64-bit with IPOPT_INT64, while long is 32-bit on Windows.
+ */
+#ifdef IPOPT_INT64
+#define IPOPT_REFCOUNT_INTERLOCKED_TYPE    __int64
+#define IPOPT_REFCOUNT_INTERLOCKED_LOAD(x) _InterlockedCompareExchange64(x, 0, 0)
+#define IPOPT_REFCOUNT_INTERLOCKED_INC(x)  _InterlockedIncrement64(x)
+#define IPOPT_REFCOUNT_INTERLOCKED_DEC(x)  _InterlockedDecrement64(x)
+#else
+#define IPOPT_REFCOUNT_INTERLOCKED_TYPE    long
+#define IPOPT_REFCOUNT_INTERLOCKED_LOAD(x) _InterlockedOr(x, 0)
+#define IPOPT_REFCOUNT_INTERLOCKED_INC(x)  _InterlockedIncrement(x)
+#define IPOPT_REFCOUNT_INTERLOCKED_DEC(x)  _InterlockedDecrement(x)
+#endif
+#endif
+
 namespace Ipopt
 {
 
@@ -185,8 +209,12 @@ public:
       const Referencer* referencer
    ) const;
 
+   /** Decrease the reference count.
+    *
+    *  @return the new reference count
+    */
    inline
-   void ReleaseRef(
+   Index ReleaseRef(
       const Referencer* referencer
    ) const;
 
@@ -204,7 +232,13 @@ inline Index ReferencedObject::ReferenceCount() const
 {
    //    DBG_START_METH("ReferencedObject::ReferenceCount()", 0);
    //    DBG_PRINT((1,"Returning reference_count_ = %d\n", reference_count_));
+#if defined(IPOPT_ATOMIC_REFCOUNT) && defined(_MSC_VER)
+   return (Index) IPOPT_REFCOUNT_INTERLOCKED_LOAD(reinterpret_cast<volatile IPOPT_REFCOUNT_INTERLOCKED_TYPE*>(&reference_count_));
+#elif defined(IPOPT_ATOMIC_REFCOUNT)
+   return __atomic_load_n(&reference_count_, __ATOMIC_ACQUIRE);
+#else
    return reference_count_;
+#endif
 }
 
 inline
@@ -213,7 +247,14 @@ void ReferencedObject::AddRef(
 ) const
 {
    //    DBG_START_METH("ReferencedObject::AddRef(const Referencer* referencer)", 0);
+#if defined(IPOPT_ATOMIC_REFCOUNT) && defined(_MSC_VER)
+   IPOPT_REFCOUNT_INTERLOCKED_INC(reinterpret_cast<volatile IPOPT_REFCOUNT_INTERLOCKED_TYPE*>(&reference_count_));
+#elif defined(IPOPT_ATOMIC_REFCOUNT)
+   // the new reference is obtained from an existing one, so no ordering is required
+   __atomic_add_fetch(&reference_count_, 1, __ATOMIC_RELAXED);
+#else
    reference_count_++;
+#endif
    //    DBG_PRINT((1, "New reference_count_ = %d\n", reference_count_));
 #   ifdef IP_DEBUG_REFERENCED
    referencers_.push_back(referencer);
@@ -223,13 +264,20 @@ void ReferencedObject::AddRef(
 }
 
 inline
-void ReferencedObject::ReleaseRef(
+Index ReferencedObject::ReleaseRef(
    const Referencer* referencer
 ) const
 {
    //    DBG_START_METH("ReferencedObject::ReleaseRef(const Referencer* referencer)",
    //                   0);
-   reference_count_--;
+#if defined(IPOPT_ATOMIC_REFCOUNT) && defined(_MSC_VER)
+   Index count = (Index) IPOPT_REFCOUNT_INTERLOCKED_DEC(reinterpret_cast<volatile IPOPT_REFCOUNT_INTERLOCKED_TYPE*>(&reference_count_));
+#elif defined(IPOPT_ATOMIC_REFCOUNT)
+   // all accesses to the object have to happen before it is deleted by the last release
+   Index count = __atomic_sub_fetch(&reference_count_, 1, __ATOMIC_ACQ_REL);
+#else
+   Index count = --reference_count_;
+#endif
    //    DBG_PRINT((1, "New reference_count_ = %d\n", reference_count_));
 
 #   ifdef IP_DEBUG_REFERENCED
@@ -255,6 +303,8 @@ void ReferencedObject::ReleaseRef(
 #   else
    (void) referencer;
 #   endif
+
+   return count;
 }
 
 } // namespace Ipopt
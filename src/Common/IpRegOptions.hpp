@@ -562,6 +562,21 @@ public:
         current_registering_category_("Uncategorized")
    { }
 
+   /** Copy Constructor
+    *
+    *  The copy refers to the same RegisteredOption objects, so that
+    *  copying is cheap.  Options added to the copy are not visible in
+    *  the original and vice versa.
+    */
+   RegisteredOptions(
+      const RegisteredOptions& copy
+   )
+      : ReferencedObject(),
+        next_counter_(copy.next_counter_),
+        current_registering_category_(copy.current_registering_category_),
+        registered_options_(copy.registered_options_)
+   { }
+
    /** Destructor */
    virtual ~RegisteredOptions()
    { }
@@ -856,6 +871,35 @@ public:
       const std::string& long_description = ""
    );
 
+   virtual void AddStringOption11(
+      const std::string& name,
+      const std::string& short_description,
+      const std::string& default_value,
+      const std::string& setting1,
+      const std::string& description1,
+      const std::string& setting2,
+      const std::string& description2,
+      const std::string& setting3,
+      const std::string& description3,
+      const std::string& setting4,
+      const std::string& description4,
+      const std::string& setting5,
+      const std::string& description5,
+      const std::string& setting6,
+      const std::string& description6,
+      const std::string& setting7,
+      const std::string& description7,
+      const std::string& setting8,
+      const std::string& description8,
+      const std::string& setting9,
+      const std::string& description9,
+      const std::string& setting10,
+      const std::string& description10,
+      const std::string& setting11,
+      const std::string& description11,
+      const std::string& long_description = ""
+   );
+
    /** Get a registered option
     *
     * @return NULL, if the option does not exist
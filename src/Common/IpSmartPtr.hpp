@@ -189,6 +189,15 @@ public:
       const SmartPtr<U>& copy
    );
 
+#if __cplusplus >= 201103L
+   /** Move constructor, takes over the reference of other without
+    *  changing the reference count; other is NULL afterwards.
+    */
+   SmartPtr(
+      SmartPtr<T>&& other
+   );
+#endif
+
    /** Constructor, initialized from T* ptr */
    SmartPtr(
       T* ptr
@@ -228,6 +237,15 @@ public:
       const SmartPtr<T>& rhs
    );
 
+#if __cplusplus >= 201103L
+   /** Move assignment operator, takes over the reference of rhs
+    *  without changing its reference count; rhs is NULL afterwards.
+    */
+   SmartPtr<T>& operator=(
+      SmartPtr<T>&& rhs
+   );
+#endif
+
    /** Overloaded equals operator, allows the user to
     * set the value of the SmartPtr from another
     * SmartPtr of a different type
@@ -490,6 +508,29 @@ SmartPtr<T>::SmartPtr(
    (void) SetFromSmartPtr_(GetRawPtr(copy));
 }
 
+#if __cplusplus >= 201103L
+template<class T>
+SmartPtr<T>::SmartPtr(
+   SmartPtr<T>&& other
+)
+   : ptr_(0)
+{
+#ifdef IP_DEBUG_SMARTPTR
+   DBG_START_METH("SmartPtr<T>::SmartPtr(SmartPtr<T>&& other)", ipopt_dbg_smartptr_verbosity);
+#endif
+
+#ifdef IP_DEBUG_REFERENCED
+   // the referenced object keeps track of the referencing SmartPtrs
+   (void) SetFromSmartPtr_(other);
+   other.ReleasePointer_();
+   other.ptr_ = 0;
+#else
+   ptr_ = other.ptr_;
+   other.ptr_ = 0;
+#endif
+}
+#endif
+
 template<class T>
 SmartPtr<T>::SmartPtr(
    T* ptr
@@ -574,6 +615,37 @@ SmartPtr<T>& SmartPtr<T>::operator=(
    return SetFromSmartPtr_(rhs);
 }
 
+#if __cplusplus >= 201103L
+template<class T>
+SmartPtr<T>& SmartPtr<T>::operator=(
+   SmartPtr<T>&& rhs
+)
+{
+#ifdef IP_DEBUG_SMARTPTR
+   DBG_START_METH(
+      "SmartPtr<T>& SmartPtr<T>::operator=(SmartPtr<T>&& rhs)",
+      ipopt_dbg_smartptr_verbosity);
+#endif
+
+   if( this != &rhs )
+   {
+#ifdef IP_DEBUG_REFERENCED
+      (void) SetFromSmartPtr_(rhs);
+      rhs.ReleasePointer_();
+      rhs.ptr_ = 0;
+#else
+      // take the pointer before releasing, since releasing may delete an object that holds rhs
+      T* ptr = rhs.ptr_;
+      rhs.ptr_ = 0;
+      ReleasePointer_();
+      ptr_ = ptr;
+#endif
+   }
+
+   return *this;
+}
+#endif
+
 template<class T>
 template<class U>
 SmartPtr<T>& SmartPtr<T>::operator=(
@@ -639,8 +711,7 @@ void SmartPtr<T>::ReleasePointer_()
 
    if( ptr_ )
    {
-      ptr_->ReleaseRef(this);
-      if( ptr_->ReferenceCount() == 0 )
+      if( ptr_->ReleaseRef(this) == 0 )
       {
          delete ptr_;
       }
@@ -8,26 +8,59 @@
 
 #include <limits>
 
-/* keyword to declare a thread-local variable according to http://en.wikipedia.org/wiki/Thread-local_storage
- * GCC < 4.5 on MacOS X does not support TLS
- * With Intel compiler on MacOS X, problems with __thread were reported. (Hope that C++ thread_local will be OK)
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
+/* Tags are handed out to the threads in blocks by an atomic counter, so
+ * that they are unique over all threads, while each thread increments its
+ * own (thread-local) counter within its block without synchronization.
+ * If no atomic operations are available, each thread counts on its own.
  */
-#ifndef IPOPT_THREAD_LOCAL
+#if __cplusplus >= 201103L || (defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 407)) || defined(_MSC_VER)
+#define IPOPT_TAG_BLOCKS
+#endif
 
+#if defined(IPOPT_TAG_BLOCKS) && __cplusplus < 201103L && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Ipopt
+{
+
+#ifdef IPOPT_TAG_BLOCKS
+
+/** Number of tags that a thread takes at once */
+static const TaggedObject::Tag tag_block_size = 1024;
+
+/** Start of the next block of tags that has not been given to a thread */
 #if __cplusplus >= 201103L
-#define IPOPT_THREAD_LOCAL thread_local
-#elif defined(_MSC_VER)
-#define IPOPT_THREAD_LOCAL __declspec(thread)
-#elif defined(__APPLE__) && ((defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ < 405)) || defined(__INTEL_COMPILER))
-#define IPOPT_THREAD_LOCAL
+static std::atomic<TaggedObject::Tag> next_tag_block(1);
 #else
-#define IPOPT_THREAD_LOCAL __thread
+static volatile TaggedObject::Tag next_tag_block = 1;
 #endif
 
-#endif
+/** Next tag of the current thread; unique_tag == unique_tag_end if the block of the thread is used up. */
+static IPOPT_THREAD_LOCAL TaggedObject::Tag unique_tag = 0;
 
-namespace Ipopt
+/** End of the block of tags of the current thread */
+static IPOPT_THREAD_LOCAL TaggedObject::Tag unique_tag_end = 0;
+
+/** Obtain a new block of tags for the current thread */
+static void NewTagBlock()
 {
+#if __cplusplus >= 201103L
+   unique_tag = next_tag_block.fetch_add(tag_block_size, std::memory_order_relaxed);
+#elif defined(_MSC_VER)
+   unique_tag = (TaggedObject::Tag) _InterlockedExchangeAdd64(reinterpret_cast<volatile __int64*>(&next_tag_block), (__int64) tag_block_size);
+#else
+   unique_tag = __atomic_fetch_add(&next_tag_block, tag_block_size, __ATOMIC_RELAXED);
+#endif
+   unique_tag_end = unique_tag + tag_block_size;
+   DBG_ASSERT(unique_tag_end > unique_tag);
+}
+
+#else
 
 /** Global data that is incremented every time ANY TaggedObject changes.
  *
@@ -35,6 +68,8 @@ namespace Ipopt
  */
 static IPOPT_THREAD_LOCAL TaggedObject::Tag unique_tag =  1;
 
+#endif
+
 /** Objects derived from TaggedObject MUST call this
  *  method every time their internal state changes to
  *  update the internal tag for comparison
@@ -42,6 +77,12 @@ static IPOPT_THREAD_LOCAL TaggedObject::Tag unique_tag =  1;
 void TaggedObject::ObjectChanged()
 {
    DBG_START_METH("TaggedObject::ObjectChanged()", 0);
+#ifdef IPOPT_TAG_BLOCKS
+   if( unique_tag == unique_tag_end )
+   {
+      NewTagBlock();
+   }
+#endif
    tag_ = unique_tag;
    unique_tag++;
    DBG_ASSERT(unique_tag < std::numeric_limits<Tag>::max());
@@ -53,12 +53,21 @@ namespace Ipopt
  *  the base class using the protected member function ObjectChanged(). For
  *  example, a Vector class, inside its own set method, MUST call
  *  ObjectChanged() to update the internally stored tag for comparison.
+ *
+ *  The tags are unique over all threads (unless Ipopt was compiled
+ *  without support for atomic operations), so an object can be
+ *  changed by another thread than the one that created it.
  */
 class IPOPTLIB_EXPORT TaggedObject : public ReferencedObject, public Subject
 {
 public:
-   /** Type for the Tag values */
-   typedef unsigned int Tag;
+   /** Type for the Tag values
+    *
+    *  It has 64 bits, so that the tags do not wrap around to 0, which
+    *  is used for "no tag", even though the threads take blocks of
+    *  tags that they may not use up.
+    */
+   typedef unsigned long long Tag;
 
    /** Constructor. */
    TaggedObject()
@@ -9,6 +9,10 @@
 
 #include "IpUtils.hpp"
 
+#include <string>
+#include <vector>
+#include <utility>
+
 namespace Ipopt
 {
 /** This class is used to collect timing information for a
@@ -16,14 +20,29 @@ namespace Ipopt
 class IPOPTLIB_EXPORT TimedTask
 {
 public:
+   /** Which clocks are read in Start and End */
+   enum ETimingMode
+   {
+      /** no timing, Start and End do not read any clock */
+      TIMING_NONE = 0,
+      /** only a monotonic wallclock, CPU and system time remain zero */
+      TIMING_WALLCLOCK,
+      /** CPU, system, and wallclock time */
+      TIMING_ALL
+   };
+
    /**@name Constructors/Destructors */
    ///@{
    /** Default constructor. */
    TimedTask()
       :
+      mode_(TIMING_ALL),
       total_cputime_(0.),
       total_systime_(0.),
       total_walltime_(0.),
+      n_calls_(0),
+      trace_(false),
+      probe_handle_(NULL),
       start_called_(false),
       end_called_(true)
    {}
@@ -39,10 +58,78 @@ public:
       total_cputime_ = 0.;
       total_systime_ = 0.;
       total_walltime_ = 0.;
+      n_calls_ = 0;
+      trace_intervals_.clear();
       start_called_ = false;
       end_called_ = true;
    }
 
+   /** Method for setting the clocks that are read.
+    *
+    *  This should only be called while the task is not timed.
+    */
+   void SetTimingMode(
+      ETimingMode mode
+   )
+   {
+      DBG_ASSERT(end_called_);
+      mode_ = mode;
+   }
+
+   /** Method returning the clocks that are read. */
+   ETimingMode TimingMode() const
+   {
+      return mode_;
+   }
+
+   /** Method for enabling the recording of all timed intervals.
+    *
+    *  If enabled and the timing mode is not TIMING_NONE, the
+    *  MonotonicTime at Start and End is stored for every execution
+    *  of the task, see TraceIntervals.
+    */
+   void SetTracing(
+      bool trace
+   )
+   {
+      trace_ = trace;
+   }
+
+   /** Method returning the recorded (start, end) pairs of monotonic time. */
+   const std::vector<std::pair<Number, Number> >& TraceIntervals() const
+   {
+      return trace_intervals_;
+   }
+
+   /** Method for setting the name under which the task is reported
+    *  to tracing tools.
+    *
+    *  If Ipopt has been configured with USDT probes or the ITT API,
+    *  Start and End of a task with a name fire the USDT probes
+    *  ipopt:task_start and ipopt:task_end with the name as argument
+    *  and begin and end an ITT task in the domain "Ipopt".  Tasks
+    *  without a name are not reported.
+    */
+   void SetName(
+      const std::string& name
+   )
+   {
+      name_ = name;
+      probe_handle_ = NULL;
+   }
+
+   /** Method returning the name of the task. */
+   const std::string& Name() const
+   {
+      return name_;
+   }
+
+   /** Method returning whether the task is currently timed. */
+   bool IsStarted() const
+   {
+      return start_called_;
+   }
+
    /** Method that is called before execution of the task. */
    void Start()
    {
@@ -50,9 +137,30 @@ public:
       DBG_ASSERT(!start_called_);
       end_called_ = false;
       start_called_ = true;
-      start_cputime_ = CpuTime();
-      start_systime_ = SysTime();
-      start_walltime_ = WallclockTime();
+      n_calls_++;
+#if defined(IPOPT_HAS_USDT) || defined(IPOPT_HAS_ITTNOTIFY)
+      if( !name_.empty() )
+      {
+         TaskProbeStart(name_.c_str(), probe_handle_);
+      }
+#endif
+      switch( mode_ )
+      {
+         case TIMING_NONE:
+            break;
+         case TIMING_WALLCLOCK:
+            start_walltime_ = MonotonicTime();
+            break;
+         case TIMING_ALL:
+            start_cputime_ = CpuTime();
+            start_systime_ = SysTime();
+            start_walltime_ = WallclockTime();
+            break;
+      }
+      if( trace_ && mode_ != TIMING_NONE )
+      {
+         start_tracetime_ = MonotonicTime();
+      }
    }
 
    /** Method that is called after execution of the task. */
@@ -62,9 +170,8 @@ public:
       DBG_ASSERT(start_called_);
       end_called_ = true;
       start_called_ = false;
-      total_cputime_ += CpuTime() - start_cputime_;
-      total_systime_ += SysTime() - start_systime_;
-      total_walltime_ += WallclockTime() - start_walltime_;
+      AddElapsedTimes();
+      EndProbe();
    }
 
    /** Method that is called after execution of the task for which
@@ -77,9 +184,8 @@ public:
       {
          end_called_ = true;
          start_called_ = false;
-         total_cputime_ += CpuTime() - start_cputime_;
-         total_systime_ += SysTime() - start_systime_;
-         total_walltime_ += WallclockTime() - start_walltime_;
+         AddElapsedTimes();
+         EndProbe();
       }
       DBG_ASSERT(end_called_);
    }
@@ -105,6 +211,15 @@ public:
       return total_walltime_;
    }
 
+   /** Method returning how often the task has been started so far.
+    *
+    *  This is counted also if the timing mode is TIMING_NONE.
+    */
+   Index NumberOfCalls() const
+   {
+      return n_calls_;
+   }
+
 private:
    /**@name Default Compiler Generated Methods (Hidden to avoid
     * implicit creation/calling).  These methods are not
@@ -120,6 +235,42 @@ private:
    void operator=(const TimedTask&);
    ///@}
 
+   /** Add the times since the call of Start to the totals. */
+   void AddElapsedTimes()
+   {
+      switch( mode_ )
+      {
+         case TIMING_NONE:
+            break;
+         case TIMING_WALLCLOCK:
+            total_walltime_ += MonotonicTime() - start_walltime_;
+            break;
+         case TIMING_ALL:
+            total_cputime_ += CpuTime() - start_cputime_;
+            total_systime_ += SysTime() - start_systime_;
+            total_walltime_ += WallclockTime() - start_walltime_;
+            break;
+      }
+      if( trace_ && mode_ != TIMING_NONE )
+      {
+         trace_intervals_.push_back(std::make_pair(start_tracetime_, MonotonicTime()));
+      }
+   }
+
+   /** Report the end of the task to tracing tools, see SetName. */
+   void EndProbe()
+   {
+#if defined(IPOPT_HAS_USDT) || defined(IPOPT_HAS_ITTNOTIFY)
+      if( !name_.empty() )
+      {
+         TaskProbeEnd(name_.c_str());
+      }
+#endif
+   }
+
+   /** Clocks that are read */
+   ETimingMode mode_;
+
    /** CPU time at beginning of task. */
    Number start_cputime_;
    /** Total CPU time for task measured so far. */
@@ -132,6 +283,20 @@ private:
    Number start_walltime_;
    /** Total wall clock time for task measured so far. */
    Number total_walltime_;
+   /** Number of calls of Start. */
+   Index n_calls_;
+
+   /** Whether the timed intervals are recorded */
+   bool trace_;
+   /** Monotonic time at beginning of task, if traced. */
+   Number start_tracetime_;
+   /** Recorded (start, end) pairs of timed intervals. */
+   std::vector<std::pair<Number, Number> > trace_intervals_;
+
+   /** Name of the task for tracing tools */
+   std::string name_;
+   /** Handle of the name for the ITT API, created at the first Start */
+   void* probe_handle_;
 
    /** @name fields for debugging */
    ///@{
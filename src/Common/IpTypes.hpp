@@ -13,8 +13,19 @@ namespace Ipopt
 {
 /** Type of all numbers */
 typedef double Number;
-/** Type of all indices of vectors, matrices etc */
+/** Type of all indices of vectors, matrices etc
+ *
+ *  This is a 64-bit integer type if Ipopt has been configured with
+ *  --enable-int64.  In this case, it is the same type as ipfint, so
+ *  that index arrays can be passed to Fortran codes without copies.
+ *  Use IPOPT_INDEX_FORMAT to print an Index with printf, e.g.,
+ *  printf("%" IPOPT_INDEX_FORMAT, i).
+ */
+#ifdef IPOPT_INT64
+typedef IPOPT_FORTRAN_INTEGER_TYPE Index;
+#else
 typedef int Index;
+#endif
 /** Type of default integer */
 typedef int Int;
 
@@ -18,6 +18,18 @@
 #include <cstdarg>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef IPOPT_HAS_USDT
+#include <sys/sdt.h>
+#endif
+
+#ifdef IPOPT_HAS_ITTNOTIFY
+#include <ittnotify.h>
+#endif
+
 // The special treatment of vsnprintf on SUN has been suggsted by Lou Hafer 2010/07/04
 #if defined(HAVE_VSNPRINTF) && defined(__SUNPRO_CC)
 namespace std
@@ -81,6 +93,7 @@ inline double IpCoinGetTimeOfDay()
 #else
 
 #include <sys/time.h>
+#include <time.h>
 
 inline double IpCoinGetTimeOfDay()
 {
@@ -193,6 +206,114 @@ Number WallclockTime()
    return callTime - Wallclock_firstCall_;
 }
 
+static double Monotonic_firstCall_ = -1.;
+
+Number MonotonicTime()
+{
+   double callTime;
+#if !defined(_MSC_VER) && defined(CLOCK_MONOTONIC)
+   // on Linux, this reads the time stamp counter without a system call
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   callTime = static_cast<double>(ts.tv_sec) + 1.0e-9 * static_cast<double>(ts.tv_nsec);
+#else
+   callTime = IpCoinGetTimeOfDay();
+#endif
+   if( Monotonic_firstCall_ == -1. )
+   {
+      Monotonic_firstCall_ = callTime;
+   }
+   return callTime - Monotonic_firstCall_;
+}
+
+int ParallelSectionThreads(
+   int nthreads
+)
+{
+#ifdef _OPENMP
+   int max_threads = omp_get_max_threads();
+   return nthreads < max_threads ? nthreads : max_threads;
+#else
+   (void) nthreads;
+   return 1;
+#endif
+}
+
+unsigned int HashBytes(
+   const void*  data,
+   size_t       len,
+   unsigned int hash
+)
+{
+   const unsigned char* bytes = static_cast<const unsigned char*>(data);
+   for( size_t i = 0; i < len; i++ )
+   {
+      hash ^= bytes[i];
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+int ParallelLoopThreads(
+   Index n,
+   Index min_n,
+   int   nthreads
+)
+{
+#ifdef _OPENMP
+   if( n >= min_n && !omp_in_parallel() )
+   {
+      return nthreads > 0 ? nthreads : omp_get_max_threads();
+   }
+#else
+   (void) n;
+   (void) min_n;
+   (void) nthreads;
+#endif
+   return 1;
+}
+
+#ifdef IPOPT_HAS_ITTNOTIFY
+/** Domain of the ITT tasks of Ipopt */
+static __itt_domain* IttDomain()
+{
+   static __itt_domain* domain = __itt_domain_create("Ipopt");
+   return domain;
+}
+#endif
+
+void TaskProbeStart(
+   const char* name,
+   void*&      handle
+)
+{
+#ifdef IPOPT_HAS_USDT
+   DTRACE_PROBE1(ipopt, task_start, name);
+#endif
+#ifdef IPOPT_HAS_ITTNOTIFY
+   if( handle == NULL )
+   {
+      handle = __itt_string_handle_create(name);
+   }
+   __itt_task_begin(IttDomain(), __itt_null, __itt_null, static_cast<__itt_string_handle*>(handle));
+#endif
+   (void) name;
+   (void) handle;
+}
+
+void TaskProbeEnd(
+   const char* name
+)
+{
+#ifdef IPOPT_HAS_USDT
+   DTRACE_PROBE1(ipopt, task_end, name);
+#endif
+#ifdef IPOPT_HAS_ITTNOTIFY
+   __itt_task_end(IttDomain());
+#endif
+   (void) name;
+}
+
 bool Compare_le(
    Number lhs,
    Number rhs,
@@ -11,6 +11,43 @@
 #include "IpTypes.hpp"
 #include "IpDebug.hpp"
 
+#include <cstddef>
+
+/** IPOPT_OMP_PARALLEL_FOR(nthreads) starts an OpenMP parallel loop with
+ *  nthreads threads and static scheduling if nthreads is larger than 1.
+ *
+ *  Without OpenMP support, it only consumes the thread count, so that it
+ *  is not reported as unused.
+ */
+#ifdef _OPENMP
+#ifdef _MSC_VER
+#define IPOPT_OMP_PARALLEL_FOR(nthreads) __pragma(omp parallel for schedule(static) num_threads(nthreads) if(nthreads > 1))
+#else
+#define IPOPT_OMP_PRAGMA(x) _Pragma(#x)
+#define IPOPT_OMP_PARALLEL_FOR(nthreads) IPOPT_OMP_PRAGMA(omp parallel for schedule(static) num_threads(nthreads) if(nthreads > 1))
+#endif
+#else
+#define IPOPT_OMP_PARALLEL_FOR(nthreads) (void) (nthreads);
+#endif
+
+/* keyword to declare a thread-local variable according to http://en.wikipedia.org/wiki/Thread-local_storage
+ * GCC < 4.5 on MacOS X does not support TLS
+ * With Intel compiler on MacOS X, problems with __thread were reported. (Hope that C++ thread_local will be OK)
+ */
+#ifndef IPOPT_THREAD_LOCAL
+
+#if __cplusplus >= 201103L
+#define IPOPT_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define IPOPT_THREAD_LOCAL __declspec(thread)
+#elif defined(__APPLE__) && ((defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ < 405)) || defined(__INTEL_COMPILER))
+#define IPOPT_THREAD_LOCAL
+#else
+#define IPOPT_THREAD_LOCAL __thread
+#endif
+
+#endif
+
 namespace Ipopt
 {
 
@@ -161,6 +198,77 @@ IPOPTLIB_EXPORT Number SysTime();
 /** method determining wallclock time since first call */
 IPOPTLIB_EXPORT Number WallclockTime();
 
+/** method determining the time of a monotonic clock since first call
+ *
+ *  This is cheaper than WallclockTime where a monotonic clock can be
+ *  read without a system call and should be used to measure short
+ *  time intervals.
+ */
+IPOPTLIB_EXPORT Number MonotonicTime();
+
+/** Number of threads for a parallel section of Ipopt that requests nthreads threads.
+ *
+ *  All parallel sections of a solve share the threads of the OpenMP
+ *  runtime, whose number can be limited by the option num_threads.
+ *  This returns nthreads limited to the number of OpenMP threads,
+ *  and 1 if Ipopt has not been compiled with OpenMP support.
+ */
+IPOPTLIB_EXPORT int ParallelSectionThreads(
+   int nthreads
+);
+
+/** Number of threads for a parallel loop over n elements.
+ *
+ *  This is 1 if Ipopt has not been compiled with OpenMP support, if n is
+ *  less than min_n, or if we are already inside a parallel region.
+ *  Otherwise, it is nthreads, or the number of OpenMP threads if nthreads
+ *  is not positive.
+ */
+IPOPTLIB_EXPORT int ParallelLoopThreads(
+   Index n,
+   Index min_n,
+   int   nthreads = 0
+);
+
+/** Update a 32-bit FNV-1a hash value by the len bytes at data.
+ *
+ *  Without the hash argument, a new hash value is computed.
+ */
+IPOPTLIB_EXPORT unsigned int HashBytes(
+   const void*  data,
+   size_t       len,
+   unsigned int hash = 2166136261u
+);
+
+/** Position of the first element of block blk if n elements are
+ *  split into nblocks contiguous blocks of (almost) equal length.
+ */
+inline Index BlockStart(
+   Index n,
+   int   nblocks,
+   int   blk
+)
+{
+   return blk * (n / nblocks) + Min((Index) blk, n % nblocks);
+}
+
+/** Report the start of a timed task to tracing tools.
+ *
+ *  Fires the USDT probe ipopt:task_start and begins an ITT task if
+ *  Ipopt has been configured with USDT probes or the ITT API, and does
+ *  nothing otherwise.  handle caches the ITT handle of the name and
+ *  must be NULL at the first call for a name.
+ */
+IPOPTLIB_EXPORT void TaskProbeStart(
+   const char* name,
+   void*&      handle
+);
+
+/** Report the end of a timed task to tracing tools, see TaskProbeStart. */
+IPOPTLIB_EXPORT void TaskProbeEnd(
+   const char* name
+);
+
 /** Method for comparing two numbers within machine precision.
  *
  *  @return true, if lhs is less or equal the rhs, relaxing
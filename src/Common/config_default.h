@@ -53,6 +53,18 @@
 /* Define to 1 if WSMP is available */
 /* #undef IPOPT_HAS_WSMP */
 
+/* Define to 1 if CUDA, cuBLAS, and NVRTC are available */
+/* #undef IPOPT_HAS_CUDA */
+
+/* Define to 1 if cuDSS is available */
+/* #undef IPOPT_HAS_CUDSS */
+
+/* Define to 1 if USDT probes are added to the timed tasks */
+/* #undef IPOPT_HAS_USDT */
+
+/* Define to 1 if timed tasks are annotated with the ITT API */
+/* #undef IPOPT_HAS_ITTNOTIFY */
+
 /* Define to the C type corresponding to Fortran INTEGER */
 #ifndef IPOPT_FORTRAN_INTEGER_TYPE
 #define IPOPT_FORTRAN_INTEGER_TYPE int
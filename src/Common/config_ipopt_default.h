@@ -21,6 +21,11 @@
 #define IPOPT_FORTRAN_INTEGER_TYPE int
 #endif
 
+/* Define to the printf conversion (without %) for Index */
+#ifndef IPOPT_INDEX_FORMAT
+#define IPOPT_INDEX_FORMAT "d"
+#endif
+
 #ifndef IPOPTLIB_EXPORT
 #if defined(_WIN32) && defined(DLL_EXPORT)
 #define IPOPTLIB_EXPORT __declspec(dllimport)
@@ -7,6 +7,7 @@
 #include "IpoptConfig.h"
 #include "IpIpoptApplication.hpp"
 #include "IpTNLPAdapter.hpp"
+#include "IpTNLPPresolver.hpp"
 #include "IpIpoptAlg.hpp"
 #include "IpOrigIpoptNLP.hpp"
 #include "IpIpoptData.hpp"
@@ -18,11 +19,19 @@
 #include "IpAlgorithmRegOp.hpp"
 #include "IpCGPenaltyRegOp.hpp"
 #include "IpNLPBoundsRemover.hpp"
+#include "IpBlas.hpp"
+#include "IpGenTMatrix.hpp"
+#include "IpSymTMatrix.hpp"
+#include "IpMemoryStatistics.hpp"
 
 #ifdef IPOPT_HAS_HSL
 #include "CoinHslConfig.h"
 #endif
 
+#ifdef IPOPT_HAS_MUMPS
+# include "IpMumpsSolverInterface.hpp"
+#endif
+
 #ifdef BUILD_INEXACT
 # include "IpInexactRegOp.hpp"
 # include "IpInexactAlgBuilder.hpp"
@@ -30,6 +39,19 @@
 
 #include <cmath>
 #include <fstream>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if __cplusplus >= 201103L && defined(IPOPT_ATOMIC_REFCOUNT)
+#include <atomic>
+#include <mutex>
+#include <thread>
+#define IPOPT_MULTISTART_THREADS
+#endif
 
 // Factory to facilitate creating IpoptApplication objects from within a DLL
 
@@ -40,6 +62,14 @@ Ipopt::IpoptApplication* IpoptApplicationFactory()
 
 namespace Ipopt
 {
+/** create the RegisteredOptions with all Ipopt options */
+static SmartPtr<const RegisteredOptions> CreateSharedRegisteredOptions()
+{
+   SmartPtr<RegisteredOptions> reg_options = new RegisteredOptions();
+   IpoptApplication::RegisterAllIpoptOptions(reg_options);
+   return ConstPtr(reg_options);
+}
+
 #if IPOPT_VERBOSITY > 0
 static const Index dbg_verbosity = 0;
 // Kluge: Add reference counter for DebugJournalistWrapper::jrnl
@@ -52,10 +82,12 @@ IpoptApplication::IpoptApplication(
 )
    : read_params_dat_(true),
      rethrow_nonipoptexception_(false),
+     reg_options_shared_(false),
      inexact_algorithm_(false),
      replace_bounds_(false)
 {
    options_ = new OptionsList();
+   memory_stats_ = new MemoryStatistics();
    if( create_empty )
    {
       return;
@@ -86,9 +118,17 @@ IpoptApplication::IpoptApplication(
          stdout_jrnl->SetPrintLevel(J_DBG, J_NONE);
       }
 
+#ifdef IPOPT_ATOMIC_REFCOUNT
+      // Use the valid options that are shared by all applications;
+      // applications in different threads take references to the same
+      // RegisteredOption objects, so this requires atomic reference counts
+      reg_options_ = const_cast<RegisteredOptions*>(GetRawPtr(SharedRegisteredOptions()));
+      reg_options_shared_ = true;
+#else
       // Register the valid options
       reg_options_ = new RegisteredOptions();
       RegisterAllIpoptOptions(reg_options_);
+#endif
 
       options_->SetJournalist(jnlst_);
       options_->SetRegisteredOptions(reg_options_);
@@ -120,7 +160,9 @@ IpoptApplication::IpoptApplication(
      rethrow_nonipoptexception_(false),
      jnlst_(jnlst),
      reg_options_(reg_options),
+     reg_options_shared_(false),
      options_(options),
+     memory_stats_(new MemoryStatistics()),
      inexact_algorithm_(false),
      replace_bounds_(false)
 { }
@@ -129,7 +171,8 @@ SmartPtr<IpoptApplication> IpoptApplication::clone()
 {
    SmartPtr<IpoptApplication> retval = new IpoptApplication(false, true);
    retval->jnlst_ = Jnlst();
-   retval->reg_options_ = RegOptions();
+   retval->reg_options_ = reg_options_;
+   retval->reg_options_shared_ = reg_options_shared_;
    *retval->options_ = *Options();
 
    retval->read_params_dat_ = read_params_dat_;
@@ -242,10 +285,15 @@ ApplicationReturnStatus IpoptApplication::Initialize(
             options_to_print.push_back("print_frequency_time");
             options_to_print.push_back("output_file");
             options_to_print.push_back("file_print_level");
+            options_to_print.push_back("output_file_async");
             options_to_print.push_back("option_file_name");
             options_to_print.push_back("print_info_string");
             options_to_print.push_back("inf_pr_output");
+            options_to_print.push_back("iteration_trace_file");
             options_to_print.push_back("print_timing_statistics");
+            options_to_print.push_back("timing_statistics_clock");
+            options_to_print.push_back("timing_statistics_file");
+            options_to_print.push_back("timing_statistics_file_format");
 
             options_to_print.push_back("#Termination");
             options_to_print.push_back("tol");
@@ -656,6 +704,17 @@ void IpoptApplication::RegisterOptions(
       "NOTE: This option only works when read from the ipopt.opt options file! "
       "Determines the verbosity level for the file specified by \"output_file\". "
       "By default it is the same as \"print_level\".");
+   roptions->AddStringOption2(
+      "output_file_async",
+      "Whether the output file is written by a background thread.",
+      "no",
+      "no", "write the output file directly",
+      "yes", "write the output file by a background thread",
+      "NOTE: This option only works when read from the ipopt.opt options file! "
+      "If enabled, messages for the file specified by \"output_file\" are only formatted into a buffer, "
+      "which is written to the file by a separate thread, so that a slow file system does not slow down the algorithm. "
+      "The output is complete when the optimization returns. "
+      "This has no effect if Ipopt has been compiled without C++11 support.");
    roptions->AddStringOption2(
       "print_user_options",
       "Print all options set by the user.",
@@ -692,6 +751,34 @@ void IpoptApplication::RegisterOptions(
       "no", "don't print statistics",
       "yes", "print all timing statistics",
       "If selected, the program will print the CPU usage (user time) for selected tasks.");
+   roptions->AddStringOption2(
+      "timing_statistics_clock",
+      "Clocks that are read for the timing statistics.",
+      "all",
+      "all", "measure CPU, system, and wallclock time",
+      "wallclock", "measure only the wallclock time with a monotonic clock",
+      "Reading the CPU and system time requires a system call on many platforms, "
+      "which can be noticeable for problems that are solved within few milliseconds. "
+      "With \"wallclock\", only a cheaper monotonic clock is read and the CPU and system times of the tasks are reported as zero. "
+      "The overall CPU time and the time spent in function evaluations are always measured. "
+      "This option is only relevant if print_timing_statistics is enabled or timing_statistics_file is set, "
+      "since otherwise the individual tasks are not timed at all.");
+   roptions->AddStringOption1(
+      "timing_statistics_file",
+      "File name for exporting the timing statistics (leave unset for no export).",
+      "",
+      "*", "Any acceptable standard file name",
+      "If set, the times of all tasks are written to this file at the end of the optimization, "
+      "in the format selected by timing_statistics_file_format. "
+      "The tasks are then timed even if print_timing_statistics is disabled.");
+   roptions->AddStringOption2(
+      "timing_statistics_file_format",
+      "Format of the file with the timing statistics.",
+      "json",
+      "json", "total times of all tasks and the wallclock time spent in each task per iteration",
+      "chrome_trace", "every timed interval of every task as trace event, as read by chrome://tracing or Perfetto",
+      "The names of the tasks are hierarchical, with levels separated by '/'. "
+      "For the Chrome trace, all intervals are kept in memory during the optimization.");
 
    roptions->AddStringOption1(
       "option_file_name",
@@ -720,6 +807,59 @@ void IpoptApplication::RegisterOptions(
       "In some Ipopt applications, the user might want to call the FinalizeSolution method separately. "
       "Setting this option to \"yes\" will cause the IpoptApplication object to suppress the default call to that method.");
 
+   roptions->SetRegisteringCategory("Main Algorithm");
+   roptions->AddLowerBoundedIntegerOption(
+      "num_threads",
+      "Number of threads that the parallel sections of Ipopt share during a solve.",
+      0,
+      0,
+      "If positive, the number of OpenMP threads is set to this value at the beginning of a solve and restored at its end. "
+      "All parallel sections of Ipopt use the threads of the OpenMP runtime, "
+      "e.g., the evaluations at several points, the vector operations of the BLAS wrappers, "
+      "and linear solvers that use OpenMP, unless linear_solver_num_threads is set. "
+      "The thread counts given by cq_num_threads, schur_num_threads, and linear_scaling_ruiz_num_threads are limited "
+      "to this value. "
+      "The concurrent solves of OptimizeTNLPMultiStart and IpoptSolveBatch share this number of threads, too. "
+      "An application that runs its own threads concurrently with Ipopt should reduce this value accordingly. "
+      "If 0, the number of OpenMP threads is not changed. "
+      "This has only an effect if Ipopt has been compiled with OpenMP support.");
+   roptions->AddLowerBoundedIntegerOption(
+      "blas_num_threads",
+      "Number of threads for BLAS operations during a solve.",
+      0,
+      0,
+      "If positive, the number of threads of the BLAS library (if it is OpenBLAS or MKL) "
+      "and of the multi-threaded vector operations of the BLAS wrappers of Ipopt "
+      "is set to this value at the beginning of a solve and restored at its end. "
+      "If 0, the thread counts are not changed.");
+   roptions->AddStringOption2(
+      "use_huge_pages",
+      "Whether large arrays of vector and matrix values are put on transparent huge pages.",
+      "no",
+      "no", "use the default pages of the operating system",
+      "yes", "request transparent huge pages for large arrays",
+      "If enabled, the values of vectors and triplet matrices that need at least 2 MiB are aligned to 2 MiB "
+      "and transparent huge pages are requested for them, which reduces the misses of the translation lookaside buffer. "
+      "This has only an effect on Linux if transparent huge pages are enabled in the \"madvise\" mode. "
+      "The setting applies to the vector and matrix spaces that are created for a problem given as a TNLP.");
+   roptions->AddStringOption2(
+      "multistart_abort_dominated",
+      "Whether OptimizeTNLPMultiStart stops runs that are dominated by the best solution found so far.",
+      "no",
+      "no", "solve from every starting point until termination",
+      "yes", "stop dominated runs",
+      "If \"yes\", a run of a multi-start (see IpoptApplication::OptimizeTNLPMultiStart) is stopped in the "
+      "intermediate callback if its iterate satisfies the constraints up to constr_viol_tol and its objective value "
+      "exceeds the best objective value that any run has converged to so far by more than multistart_dominance_tol "
+      "(relative to the absolute value of the best objective, or absolute if that is less than 1). "
+      "Such a run ends with status User_Requested_Stop.");
+   roptions->AddLowerBoundedNumberOption(
+      "multistart_dominance_tol",
+      "Relative objective gap above which a run of a multi-start is considered dominated.",
+      0., false,
+      1e-2,
+      "This option is only used if \"multistart_abort_dominated\" is \"yes\".");
+
    roptions->SetRegisteringCategory("Undocumented");
    roptions->AddStringOption3(
       "print_options_mode",
@@ -749,7 +889,36 @@ ApplicationReturnStatus IpoptApplication::OptimizeTNLP(
    const SmartPtr<TNLP>& tnlp
 )
 {
-   nlp_adapter_ = new TNLPAdapter(GetRawPtr(tnlp), ConstPtr(jnlst_));
+   SmartPtr<TNLP> use_tnlp = tnlp;
+   bool presolve;
+   options_->GetBoolValue("presolve", presolve, "");
+   if( presolve )
+   {
+      Number nlp_lower_bound_inf;
+      Number nlp_upper_bound_inf;
+      options_->GetNumericValue("nlp_lower_bound_inf", nlp_lower_bound_inf, "");
+      options_->GetNumericValue("nlp_upper_bound_inf", nlp_upper_bound_inf, "");
+      use_tnlp = new TNLPPresolver(*tnlp, nlp_lower_bound_inf, nlp_upper_bound_inf);
+   }
+
+   nlp_adapter_ = new TNLPAdapter(GetRawPtr(use_tnlp), ConstPtr(jnlst_));
+   return OptimizeNLP(nlp_adapter_);
+}
+
+ApplicationReturnStatus IpoptApplication::OptimizeTNLP(
+   const SmartPtr<TNLP>&   tnlp,
+   const IpoptApplication& structure_source
+)
+{
+   ASSERT_EXCEPTION(IsValid(structure_source.nlp_adapter_), INVALID_WARMSTART,
+                    "OptimizeTNLP called with a structure source that has not solved a TNLP.");
+   const TNLPAdapter* source = dynamic_cast<const TNLPAdapter*>(GetRawPtr(structure_source.nlp_adapter_));
+   ASSERT_EXCEPTION(source != NULL, INVALID_WARMSTART,
+                    "OptimizeTNLP called with a structure source that has not solved a TNLP.");
+
+   SmartPtr<TNLPAdapter> adapter = new TNLPAdapter(GetRawPtr(tnlp), ConstPtr(jnlst_));
+   adapter->SetStructureSource(source);
+   nlp_adapter_ = GetRawPtr(adapter);
    return OptimizeNLP(nlp_adapter_);
 }
 
@@ -760,11 +929,808 @@ ApplicationReturnStatus IpoptApplication::ReOptimizeTNLP(
    ASSERT_EXCEPTION(IsValid(nlp_adapter_), INVALID_WARMSTART, "ReOptimizeTNLP called before OptimizeTNLP.");
    TNLPAdapter* adapter = static_cast<TNLPAdapter*>(GetRawPtr(nlp_adapter_));
    DBG_ASSERT(dynamic_cast<TNLPAdapter*> (GetRawPtr(nlp_adapter_)));
-   ASSERT_EXCEPTION(adapter->tnlp() == tnlp, INVALID_WARMSTART, "ReOptimizeTNLP called for different TNLP.")
+   SmartPtr<TNLP> adapter_tnlp = adapter->tnlp();
+   const TNLPPresolver* presolver = dynamic_cast<const TNLPPresolver*>(GetRawPtr(adapter_tnlp));
+   if( presolver != NULL )
+   {
+      adapter_tnlp = presolver->tnlp();
+   }
+   ASSERT_EXCEPTION(adapter_tnlp == tnlp, INVALID_WARMSTART, "ReOptimizeTNLP called for different TNLP.")
 
    return ReOptimizeNLP(nlp_adapter_);
 }
 
+/** State shared by the runs of OptimizeTNLPMultiStart */
+struct MultiStartData
+{
+   /** TNLP that is solved from all starting points */
+   SmartPtr<TNLP> tnlp;
+   Index          n;
+   Index          m;
+   Index          n_starts;
+   const Number*  x_starts;
+
+   /** @name Abort of dominated runs */
+   ///@{
+   bool   abort_dominated;
+   Number dominance_tol;
+   Number feasibility_tol;
+   ///@}
+
+   /** @name Best (feasible) solution found so far */
+   ///@{
+   Index                best_start;
+   SolverReturn         best_status;
+   Number               best_obj;
+   std::vector<Number>  best_x;
+   std::vector<Number>  best_z_L;
+   std::vector<Number>  best_z_U;
+   std::vector<Number>  best_g;
+   std::vector<Number>  best_lambda;
+   ///@}
+
+   /** @name Outcome of each start */
+   ///@{
+   std::vector<ApplicationReturnStatus> status;
+   std::vector<Number>                  obj_values;
+   std::vector<bool>                    dominated;
+   ///@}
+
+#ifdef IPOPT_MULTISTART_THREADS
+   /** Protects the best solution and the calls of the methods of tnlp that are not evaluations */
+   std::mutex         mutex;
+   /** Next start to be solved */
+   std::atomic<Index> next;
+#endif
+};
+
+/** Locks the mutex of a MultiStartData, if threads are used */
+class MultiStartLock
+{
+public:
+   MultiStartLock(
+      MultiStartData& data
+   )
+#ifdef IPOPT_MULTISTART_THREADS
+      : lock_(data.mutex)
+#endif
+   {
+      (void) data;
+   }
+
+private:
+#ifdef IPOPT_MULTISTART_THREADS
+   std::lock_guard<std::mutex> lock_;
+#endif
+};
+
+/** TNLP that solves the TNLP of a MultiStartData from one of its starting points.
+ *
+ *  All methods are forwarded to the original TNLP, except that the
+ *  starting point for x is taken from the list of starting points,
+ *  finalize_solution keeps the solution if it is the best so far,
+ *  and intermediate_callback stops a run that is dominated by the
+ *  best solution.
+ */
+class MultiStartTNLP: public TNLP
+{
+public:
+   MultiStartTNLP(
+      MultiStartData& data
+   )
+      : data_(data),
+        tnlp_(data.tnlp),
+        start_(-1),
+        dominated_(false)
+   { }
+
+   /** Set the index of the starting point for the next solve */
+   void SetStart(
+      Index start
+   )
+   {
+      start_ = start;
+      dominated_ = false;
+   }
+
+   /** Whether the most recent solve has been stopped because it was dominated */
+   bool Dominated() const
+   {
+      return dominated_;
+   }
+
+   virtual bool get_nlp_info(
+      Index&          n,
+      Index&          m,
+      Index&          nnz_jac_g,
+      Index&          nnz_h_lag,
+      IndexStyleEnum& index_style
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_nlp_info(n, m, nnz_jac_g, nnz_h_lag, index_style);
+   }
+
+   virtual bool get_var_con_metadata(
+      Index                   n,
+      StringMetaDataMapType&  var_string_md,
+      IntegerMetaDataMapType& var_integer_md,
+      NumericMetaDataMapType& var_numeric_md,
+      Index                   m,
+      StringMetaDataMapType&  con_string_md,
+      IntegerMetaDataMapType& con_integer_md,
+      NumericMetaDataMapType& con_numeric_md
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_var_con_metadata(n, var_string_md, var_integer_md, var_numeric_md, m, con_string_md,
+                                         con_integer_md, con_numeric_md);
+   }
+
+   virtual bool get_bounds_info(
+      Index   n,
+      Number* x_l,
+      Number* x_u,
+      Index   m,
+      Number* g_l,
+      Number* g_u
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_bounds_info(n, x_l, x_u, m, g_l, g_u);
+   }
+
+   virtual bool get_scaling_parameters(
+      Number& obj_scaling,
+      bool&   use_x_scaling,
+      Index   n,
+      Number* x_scaling,
+      bool&   use_g_scaling,
+      Index   m,
+      Number* g_scaling
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_scaling_parameters(obj_scaling, use_x_scaling, n, x_scaling, use_g_scaling, m, g_scaling);
+   }
+
+   virtual bool get_variables_linearity(
+      Index          n,
+      LinearityType* var_types
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_variables_linearity(n, var_types);
+   }
+
+   virtual bool get_constraints_linearity(
+      Index          m,
+      LinearityType* const_types
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_constraints_linearity(m, const_types);
+   }
+
+   virtual bool get_starting_point(
+      Index   n,
+      bool    init_x,
+      Number* x,
+      bool    init_z,
+      Number* z_L,
+      Number* z_U,
+      Index   m,
+      bool    init_lambda,
+      Number* lambda
+   )
+   {
+      DBG_ASSERT(start_ >= 0 && start_ < data_.n_starts);
+      if( init_z || init_lambda )
+      {
+         // the multipliers are the same for all starting points
+         MultiStartLock lock(data_);
+         std::vector<Number> x_tnlp(n);
+         if( !tnlp_->get_starting_point(n, init_x, &x_tnlp[0], init_z, z_L, z_U, m, init_lambda, lambda) )
+         {
+            return false;
+         }
+      }
+      if( init_x )
+      {
+         IpBlasDcopy(n, data_.x_starts + start_ * n, 1, x, 1);
+      }
+      return true;
+   }
+
+   virtual bool eval_f(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number&       obj_value
+   )
+   {
+      return tnlp_->eval_f(n, x, new_x, obj_value);
+   }
+
+   virtual bool eval_grad_f(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number*       grad_f
+   )
+   {
+      return tnlp_->eval_grad_f(n, x, new_x, grad_f);
+   }
+
+   virtual bool eval_g(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Number*       g
+   )
+   {
+      return tnlp_->eval_g(n, x, new_x, m, g);
+   }
+
+   virtual bool eval_jac_g(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         nele_jac,
+      Index*        iRow,
+      Index*        jCol,
+      Number*       values
+   )
+   {
+      if( values == NULL )
+      {
+         MultiStartLock lock(data_);
+         return tnlp_->eval_jac_g(n, x, new_x, m, nele_jac, iRow, jCol, values);
+      }
+      return tnlp_->eval_jac_g(n, x, new_x, m, nele_jac, iRow, jCol, values);
+   }
+
+   virtual bool eval_h(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      Index         nele_hess,
+      Index*        iRow,
+      Index*        jCol,
+      Number*       values
+   )
+   {
+      if( values == NULL )
+      {
+         MultiStartLock lock(data_);
+         return tnlp_->eval_h(n, x, new_x, obj_factor, m, lambda, new_lambda, nele_hess, iRow, jCol, values);
+      }
+      return tnlp_->eval_h(n, x, new_x, obj_factor, m, lambda, new_lambda, nele_hess, iRow, jCol, values);
+   }
+
+   virtual void finalize_solution(
+      SolverReturn               status,
+      Index                      n,
+      const Number*              x,
+      const Number*              z_L,
+      const Number*              z_U,
+      Index                      m,
+      const Number*              g,
+      const Number*              lambda,
+      Number                     obj_value,
+      const IpoptData*           /*ip_data*/,
+      IpoptCalculatedQuantities* /*ip_cq*/
+   )
+   {
+      if( status != SUCCESS && status != STOP_AT_ACCEPTABLE_POINT )
+      {
+         return;
+      }
+
+      MultiStartLock lock(data_);
+      // prefer the smaller start index for equal objective values, so that
+      // the result does not depend on the order in which the threads finish
+      if( data_.best_start >= 0
+          && (obj_value > data_.best_obj || (obj_value == data_.best_obj && start_ > data_.best_start)) )
+      {
+         return;
+      }
+      data_.best_start = start_;
+      data_.best_status = status;
+      data_.best_obj = obj_value;
+      data_.best_x.assign(x, x + n);
+      data_.best_z_L.assign(z_L, z_L + n);
+      data_.best_z_U.assign(z_U, z_U + n);
+      data_.best_g.assign(g, g + m);
+      data_.best_lambda.assign(lambda, lambda + m);
+   }
+
+   virtual bool intermediate_callback(
+      AlgorithmMode              mode,
+      Index                      iter,
+      Number                     obj_value,
+      Number                     inf_pr,
+      Number                     inf_du,
+      Number                     mu,
+      Number                     d_norm,
+      Number                     regularization_size,
+      Number                     alpha_du,
+      Number                     alpha_pr,
+      Index                      ls_trials,
+      const IpoptData*           ip_data,
+      IpoptCalculatedQuantities* ip_cq
+   )
+   {
+      MultiStartLock lock(data_);
+      if( data_.abort_dominated && mode == RegularMode && data_.best_start >= 0 && inf_pr <= data_.feasibility_tol
+          && obj_value > data_.best_obj + data_.dominance_tol * Max(Number(1.), std::abs(data_.best_obj)) )
+      {
+         dominated_ = true;
+         return false;
+      }
+      return tnlp_->intermediate_callback(mode, iter, obj_value, inf_pr, inf_du, mu, d_norm, regularization_size,
+                                          alpha_du, alpha_pr, ls_trials, ip_data, ip_cq);
+   }
+
+   virtual Index get_number_of_nonlinear_variables()
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_number_of_nonlinear_variables();
+   }
+
+   virtual bool get_list_of_nonlinear_variables(
+      Index  num_nonlin_vars,
+      Index* pos_nonlin_vars
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_list_of_nonlinear_variables(num_nonlin_vars, pos_nonlin_vars);
+   }
+
+   virtual bool eval_h_times_vec(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      const Number* v,
+      Number*       hv
+   )
+   {
+      return tnlp_->eval_h_times_vec(n, x, new_x, obj_factor, m, lambda, new_lambda, v, hv);
+   }
+
+   virtual bool get_element_functions_info(
+      Index& n_elements,
+      Index& nnz_elements
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_element_functions_info(n_elements, nnz_elements);
+   }
+
+   virtual bool get_element_functions_structure(
+      Index  n_elements,
+      Index  nnz_elements,
+      Index* elem_start,
+      Index* elem_vars
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_element_functions_structure(n_elements, nnz_elements, elem_start, elem_vars);
+   }
+
+   virtual bool eval_element_gradients(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      Index         nnz_elements,
+      Number*       values
+   )
+   {
+      return tnlp_->eval_element_gradients(n, x, new_x, obj_factor, m, lambda, new_lambda, nnz_elements, values);
+   }
+
+   virtual bool get_h_components_info(
+      Index& nnz_h_comp
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_h_components_info(nnz_h_comp);
+   }
+
+   virtual bool get_h_components_structure(
+      Index  nele_hess,
+      Index  nnz_h_comp,
+      Index* comp,
+      Index* pos
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_h_components_structure(nele_hess, nnz_h_comp, comp, pos);
+   }
+
+   virtual bool eval_h_components(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         nnz_h_comp,
+      Number*       values
+   )
+   {
+      return tnlp_->eval_h_components(n, x, new_x, nnz_h_comp, values);
+   }
+
+   virtual EvaluationConcurrency get_evaluation_concurrency()
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_evaluation_concurrency();
+   }
+
+   virtual bool eval_g_rows(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         first_row,
+      Index         last_row,
+      Number*       g
+   )
+   {
+      return tnlp_->eval_g_rows(n, x, new_x, m, first_row, last_row, g);
+   }
+
+   virtual bool eval_jac_g_rows(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         first_row,
+      Index         last_row,
+      Index         nele_jac,
+      Number*       values
+   )
+   {
+      return tnlp_->eval_jac_g_rows(n, x, new_x, m, first_row, last_row, nele_jac, values);
+   }
+
+   virtual Index get_number_of_varying_jac_g_entries()
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_number_of_varying_jac_g_entries();
+   }
+
+   virtual bool get_list_of_varying_jac_g_entries(
+      Index  nele_jac,
+      Index  num_varying,
+      Index* pos_varying
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_list_of_varying_jac_g_entries(nele_jac, num_varying, pos_varying);
+   }
+
+   virtual bool eval_jac_g_varying(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         num_varying,
+      Number*       values
+   )
+   {
+      return tnlp_->eval_jac_g_varying(n, x, new_x, m, num_varying, values);
+   }
+
+   virtual Index get_number_of_hessian_blocks()
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_number_of_hessian_blocks();
+   }
+
+   virtual bool get_hessian_blocks(
+      Index  num_blocks,
+      Index  nele_hess,
+      Index* block_start
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_hessian_blocks(num_blocks, nele_hess, block_start);
+   }
+
+   virtual bool eval_h_block(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      Index         block,
+      Index         nele_hess,
+      Number*       values
+   )
+   {
+      return tnlp_->eval_h_block(n, x, new_x, obj_factor, m, lambda, new_lambda, block, nele_hess, values);
+   }
+
+   virtual Index get_number_of_diagonal_blocks()
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_number_of_diagonal_blocks();
+   }
+
+   virtual bool get_diagonal_blocks(
+      Index  n,
+      Index  m,
+      Index  num_blocks,
+      Index* var_block,
+      Index* con_block
+   )
+   {
+      MultiStartLock lock(data_);
+      return tnlp_->get_diagonal_blocks(n, m, num_blocks, var_block, con_block);
+   }
+
+private:
+   MultiStartData& data_;
+   /** The original TNLP */
+   SmartPtr<TNLP>  tnlp_;
+   /** Index of the current starting point */
+   Index           start_;
+   /** Whether the current run has been stopped because it was dominated */
+   bool            dominated_;
+};
+
+/** Solves the start with index start by app and tnlp.
+ *
+ *  If tnlp is NULL, a new MultiStartTNLP is created and solved by
+ *  OptimizeTNLP, using the problem structure of structure_source if
+ *  that is not NULL.  Otherwise, tnlp is reoptimized.
+ */
+static void SolveMultiStart(
+   MultiStartData&           data,
+   IpoptApplication&         app,
+   SmartPtr<MultiStartTNLP>& tnlp,
+   const IpoptApplication*   structure_source,
+   Index                     start
+)
+{
+   ApplicationReturnStatus retval;
+   if( IsNull(tnlp) )
+   {
+      tnlp = new MultiStartTNLP(data);
+      tnlp->SetStart(start);
+      if( structure_source != NULL )
+      {
+         retval = app.OptimizeTNLP(GetRawPtr(tnlp), *structure_source);
+      }
+      else
+      {
+         retval = app.OptimizeTNLP(GetRawPtr(tnlp));
+      }
+      // if the problem could not be set up, do not try to reuse it for the next start
+      if( retval <= Not_Enough_Degrees_Of_Freedom && retval != Invalid_Number_Detected )
+      {
+         tnlp = NULL;
+      }
+   }
+   else
+   {
+      tnlp->SetStart(start);
+      retval = app.ReOptimizeTNLP(GetRawPtr(tnlp));
+   }
+
+   data.status[start] = retval;
+   if( IsValid(tnlp) && tnlp->Dominated() )
+   {
+      data.dominated[start] = true;
+   }
+   if( IsValid(app.Statistics()) )
+   {
+      data.obj_values[start] = app.Statistics()->FinalObjective();
+   }
+}
+
+#ifdef IPOPT_MULTISTART_THREADS
+/** Solves starts of a multi-start with app until all starts are taken */
+static void SolveMultiStartInstances(
+   MultiStartData*         data,
+   IpoptApplication*       app,
+   const IpoptApplication* structure_source
+)
+{
+   // the TNLP of this thread, which is reoptimized for all but the first start
+   SmartPtr<MultiStartTNLP> tnlp;
+   for( Index i = data->next++; i < data->n_starts; i = data->next++ )
+   {
+      SolveMultiStart(*data, *app, tnlp, structure_source, i);
+   }
+}
+#endif
+
+ApplicationReturnStatus IpoptApplication::OptimizeTNLPMultiStart(
+   const SmartPtr<TNLP>&    tnlp,
+   Index                    n_starts,
+   const Number*            x_starts,
+   Index                    n_threads,
+   Index&                   best_start,
+   ApplicationReturnStatus* status,
+   Number*                  obj_values
+)
+{
+   best_start = -1;
+
+   Index n;
+   Index m;
+   Index nnz_jac_g;
+   Index nnz_h_lag;
+   TNLP::IndexStyleEnum index_style;
+   if( n_starts <= 0 || x_starts == NULL || !tnlp->get_nlp_info(n, m, nnz_jac_g, nnz_h_lag, index_style) )
+   {
+      jnlst_->Printf(J_ERROR, J_MAIN, "Error: Invalid input for OptimizeTNLPMultiStart.\n");
+      return Invalid_Problem_Definition;
+   }
+
+   MultiStartData data;
+   data.tnlp = tnlp;
+   data.n = n;
+   data.m = m;
+   data.n_starts = n_starts;
+   data.x_starts = x_starts;
+   options_->GetBoolValue("multistart_abort_dominated", data.abort_dominated, "");
+   options_->GetNumericValue("multistart_dominance_tol", data.dominance_tol, "");
+   options_->GetNumericValue("constr_viol_tol", data.feasibility_tol, "");
+   data.best_start = -1;
+   data.best_status = UNASSIGNED;
+   data.best_obj = 0.;
+   data.status.assign(n_starts, Internal_Error);
+   data.obj_values.assign(n_starts, std::numeric_limits<Number>::quiet_NaN());
+   data.dominated.assign(n_starts, false);
+
+   // the runs report their solutions through finalize_solution
+   std::string skip_finalize;
+   options_->GetStringValue("skip_finalize_solution_call", skip_finalize, "");
+   options_->SetStringValue("skip_finalize_solution_call", "no", true, true);
+
+   // The first start is solved by this application, which sets up the
+   // problem structure for all other starts.
+   SmartPtr<MultiStartTNLP> ms_tnlp;
+   SolveMultiStart(data, *this, ms_tnlp, NULL, 0);
+
+   bool solved = false;
+#ifdef IPOPT_MULTISTART_THREADS
+   Index num_threads;
+   options_->GetIntegerValue("num_threads", num_threads, "");
+   if( n_threads <= 0 )
+   {
+      n_threads = num_threads > 0 ? num_threads : (Index) std::thread::hardware_concurrency();
+   }
+   if( n_threads > n_starts - 1 )
+   {
+      n_threads = n_starts - 1;
+   }
+
+   if( n_threads > 1 && tnlp->get_evaluation_concurrency() != TNLP::CONCURRENCY_NONE )
+   {
+      // The problem structure can only be shared if the first start
+      // has been set up and the TNLP was not changed by the presolve.
+      bool presolve;
+      options_->GetBoolValue("presolve", presolve, "");
+      const IpoptApplication* structure_source = NULL;
+      if( IsValid(ms_tnlp) && !presolve )
+      {
+         structure_source = this;
+      }
+      data.next = 1;
+
+      // Every thread gets its own application with the options of this
+      // one, but without output, and the output file is not opened
+      // again.  The symbolic factorization is kept for all starts of a
+      // thread.
+      std::vector<SmartPtr<IpoptApplication> > apps(n_threads);
+      ApplicationReturnStatus retval = Solve_Succeeded;
+      for( Index t = 0; t < n_threads && retval == Solve_Succeeded; ++t )
+      {
+         apps[t] = new IpoptApplication(false);
+         *apps[t]->Options() = *options_;
+         apps[t]->Options()->SetJournalist(apps[t]->Jnlst());
+         apps[t]->Options()->SetStringValue("output_file", "", true, true);
+         apps[t]->Options()->SetStringValue("reuse_symbolic_factorization", "yes", true, true);
+         if( num_threads > 0 )
+         {
+            // the concurrent starts share the threads
+            apps[t]->Options()->SetIntegerValue("num_threads", Max(num_threads / n_threads, (Index) 1), true, true);
+         }
+         apps[t]->RethrowNonIpoptException(false);
+         retval = apps[t]->Initialize("");
+      }
+
+      if( retval != Solve_Succeeded )
+      {
+         for( Index i = 1; i < n_starts; ++i )
+         {
+            data.status[i] = retval;
+         }
+      }
+      else
+      {
+         std::vector<std::thread> threads;
+         threads.reserve(n_threads - 1);
+         for( Index t = 1; t < n_threads; ++t )
+         {
+            threads.push_back(std::thread(SolveMultiStartInstances, &data, GetRawPtr(apps[t]), structure_source));
+         }
+         SolveMultiStartInstances(&data, GetRawPtr(apps[0]), structure_source);
+         for( std::size_t t = 0; t < threads.size(); ++t )
+         {
+            threads[t].join();
+         }
+      }
+      solved = true;
+   }
+#else
+   (void) n_threads;
+#endif
+
+   if( !solved )
+   {
+      // solve the remaining starts one after the other by reoptimizing the first one
+      for( Index i = 1; i < n_starts; ++i )
+      {
+         SolveMultiStart(data, *this, ms_tnlp, NULL, i);
+      }
+   }
+
+   options_->SetStringValue("skip_finalize_solution_call", skip_finalize, true, true);
+
+   for( Index i = 0; i < n_starts; ++i )
+   {
+      if( status != NULL )
+      {
+         status[i] = data.status[i];
+      }
+      if( obj_values != NULL )
+      {
+         obj_values[i] = data.obj_values[i];
+      }
+      if( data.dominated[i] )
+      {
+         jnlst_->Printf(J_DETAILED, J_MAIN, "Run from starting point %" IPOPT_INDEX_FORMAT " stopped because it was dominated.\n", i);
+      }
+   }
+
+   best_start = data.best_start;
+   if( best_start < 0 )
+   {
+      jnlst_->Printf(J_SUMMARY, J_MAIN, "\nMulti-start: no run of %" IPOPT_INDEX_FORMAT " found a solution.\n", n_starts);
+      return data.status[0];
+   }
+
+   jnlst_->Printf(J_SUMMARY, J_MAIN,
+                  "\nMulti-start: best objective %23.16e found from starting point %" IPOPT_INDEX_FORMAT " of %" IPOPT_INDEX_FORMAT ".\n", data.best_obj,
+                  best_start, n_starts);
+   if( skip_finalize == "no" )
+   {
+      tnlp->finalize_solution(data.best_status, n, &data.best_x[0], &data.best_z_L[0], &data.best_z_U[0], m,
+                              m > 0 ? &data.best_g[0] : NULL, m > 0 ? &data.best_lambda[0] : NULL, data.best_obj,
+                              NULL, NULL);
+   }
+   return data.status[best_start];
+}
+
 ApplicationReturnStatus IpoptApplication::OptimizeNLP(
    const SmartPtr<NLP>& nlp
 )
@@ -780,6 +1746,9 @@ ApplicationReturnStatus IpoptApplication::OptimizeNLP(
 {
    ApplicationReturnStatus retValue = Internal_Error;
 
+   // Account the memory of the objects that are created for the solve
+   MemoryStatistics::CurrentScope memory_scope(GetRawPtr(memory_stats_));
+
    // Prepare internal data structures of the algorithm
    try
    {
@@ -847,7 +1816,7 @@ ApplicationReturnStatus IpoptApplication::OptimizeNLP(
       }
    }
 
-   jnlst_->FlushBuffer();
+   jnlst_->WaitForOutput();
 
    return retValue;
 }
@@ -864,8 +1833,245 @@ ApplicationReturnStatus IpoptApplication::ReOptimizeNLP(
    return call_optimize();
 }
 
+/** Appends the structure of a GenTMatrixSpace to triplets, shifted by the given row and column offsets. */
+static void AppendStructure(
+   const MatrixSpace&  space,
+   Index               row_offset,
+   Index               col_offset,
+   std::vector<Index>& irows,
+   std::vector<Index>& jcols
+)
+{
+   const GenTMatrixSpace* gspace = dynamic_cast<const GenTMatrixSpace*>(&space);
+   ASSERT_EXCEPTION(gspace != NULL, TNLPAdapter::INVALID_TNLP, "AnalyzeTNLP requires Jacobians in triplet format.");
+   for( Index i = 0; i < gspace->Nonzeros(); i++ )
+   {
+      irows.push_back(gspace->Irows()[i] + row_offset);
+      jcols.push_back(gspace->Jcols()[i] + col_offset);
+   }
+}
+
+/** Appends the diagonal entries first, ..., first + n - 1 (1-based) to triplets. */
+static void AppendDiagonal(
+   Index               first,
+   Index               n,
+   std::vector<Index>& irows,
+   std::vector<Index>& jcols
+)
+{
+   for( Index i = 0; i < n; i++ )
+   {
+      irows.push_back(first + i);
+      jcols.push_back(first + i);
+   }
+}
+
+ApplicationReturnStatus IpoptApplication::AnalyzeTNLP(
+   const SmartPtr<TNLP>& tnlp,
+   Index&                kkt_dim,
+   Index&                kkt_nonzeros,
+   Number&               factor_nonzeros,
+   Number&               factor_flops,
+   Number&               factor_memory
+)
+{
+   ApplicationReturnStatus retValue = Internal_Error;
+   kkt_dim = 0;
+   kkt_nonzeros = 0;
+   factor_nonzeros = -1.;
+   factor_flops = -1.;
+   factor_memory = -1.;
+
+   try
+   {
+      SmartPtr<NLP> nlp = new TNLPAdapter(GetRawPtr(tnlp), ConstPtr(jnlst_));
+      SmartPtr<AlgorithmBuilder> alg_builder = new AlgorithmBuilder();
+      SmartPtr<IpoptNLP> ip_nlp;
+      SmartPtr<IpoptData> ip_data;
+      SmartPtr<IpoptCalculatedQuantities> ip_cq;
+      alg_builder->BuildIpoptObjects(*jnlst_, *options_, "", nlp, ip_nlp, ip_data, ip_cq);
+
+      ASSERT_EXCEPTION(nlp->ProcessOptions(*options_, ""), TNLPAdapter::INVALID_TNLP, "ProcessOptions of the NLP failed.");
+
+      SmartPtr<const VectorSpace> x_space;
+      SmartPtr<const VectorSpace> c_space;
+      SmartPtr<const VectorSpace> d_space;
+      SmartPtr<const VectorSpace> x_l_space;
+      SmartPtr<const MatrixSpace> px_l_space;
+      SmartPtr<const VectorSpace> x_u_space;
+      SmartPtr<const MatrixSpace> px_u_space;
+      SmartPtr<const VectorSpace> d_l_space;
+      SmartPtr<const MatrixSpace> pd_l_space;
+      SmartPtr<const VectorSpace> d_u_space;
+      SmartPtr<const MatrixSpace> pd_u_space;
+      SmartPtr<const MatrixSpace> jac_c_space;
+      SmartPtr<const MatrixSpace> jac_d_space;
+      SmartPtr<const SymMatrixSpace> h_space;
+      ASSERT_EXCEPTION(nlp->GetSpaces(x_space, c_space, d_space, x_l_space, px_l_space, x_u_space, px_u_space, d_l_space,
+                                      pd_l_space, d_u_space, pd_u_space, jac_c_space, jac_d_space, h_space),
+                       TNLPAdapter::INVALID_TNLP, "GetSpaces of the NLP failed.");
+
+      // Structure of the augmented system in the order of the blocks
+      // of StdAugSystemSolver: (W + D_x, D_s, J_c, -D_c, J_d, -I, -D_d)
+      const Index n_x = x_space->Dim();
+      const Index n_s = d_space->Dim();
+      const Index n_c = c_space->Dim();
+      std::vector<Index> irows;
+      std::vector<Index> jcols;
+      if( IsValid(h_space) )
+      {
+         const SymTMatrixSpace* hspace = dynamic_cast<const SymTMatrixSpace*>(GetRawPtr(h_space));
+         ASSERT_EXCEPTION(hspace != NULL, TNLPAdapter::INVALID_TNLP, "AnalyzeTNLP requires a Hessian in triplet format.");
+         irows.assign(hspace->Irows(), hspace->Irows() + hspace->Nonzeros());
+         jcols.assign(hspace->Jcols(), hspace->Jcols() + hspace->Nonzeros());
+      }
+      AppendDiagonal(1, n_x + n_s, irows, jcols);
+      AppendStructure(*jac_c_space, n_x + n_s, 0, irows, jcols);
+      AppendDiagonal(n_x + n_s + 1, n_c, irows, jcols);
+      AppendStructure(*jac_d_space, n_x + n_s + n_c, 0, irows, jcols);
+      for( Index i = 0; i < n_s; i++ )
+      {
+         irows.push_back(n_x + n_s + n_c + 1 + i);
+         jcols.push_back(n_x + 1 + i);
+      }
+      AppendDiagonal(n_x + n_s + n_c + 1, n_s, irows, jcols);
+
+      kkt_dim = n_x + n_s + n_c + n_s;
+      kkt_nonzeros = (Index) irows.size();
+      SmartPtr<SymTMatrixSpace> kkt_space = new SymTMatrixSpace(kkt_dim, kkt_nonzeros,
+            irows.empty() ? NULL : &irows[0], jcols.empty() ? NULL : &jcols[0]);
+      SmartPtr<SymTMatrix> kkt = kkt_space->MakeNewSymTMatrix();
+
+      SmartPtr<SymLinearSolver> solver = alg_builder->GetSymLinearSolver(*jnlst_, *options_, "");
+      ASSERT_EXCEPTION(solver->Initialize(*jnlst_, *ip_nlp, *ip_data, *ip_cq, *options_, ""), FAILED_INITIALIZATION,
+                       "Initialization of the linear solver failed.");
+      if( !solver->EstimateFactorization(*kkt, factor_nonzeros, factor_flops, factor_memory) )
+      {
+         factor_nonzeros = -1.;
+         factor_flops = -1.;
+         factor_memory = -1.;
+      }
+
+      jnlst_->Printf(J_SUMMARY, J_MAIN, "Dimension of the augmented system...............: %12" IPOPT_INDEX_FORMAT "\n", kkt_dim);
+      jnlst_->Printf(J_SUMMARY, J_MAIN, "Number of nonzeros in the augmented system.......: %12" IPOPT_INDEX_FORMAT "\n", kkt_nonzeros);
+      if( factor_nonzeros >= 0. )
+      {
+         jnlst_->Printf(J_SUMMARY, J_MAIN, "Predicted number of nonzeros in the factors......: %12.5e\n", factor_nonzeros);
+         jnlst_->Printf(J_SUMMARY, J_MAIN, "Predicted flops of one factorization.............: %12.5e\n", factor_flops);
+         jnlst_->Printf(J_SUMMARY, J_MAIN, "Predicted memory of the linear solver (bytes)....: %12.5e\n", factor_memory);
+      }
+      else
+      {
+         jnlst_->Printf(J_SUMMARY, J_MAIN, "The linear solver does not predict the size of the factorization.\n");
+      }
+      retValue = Solve_Succeeded;
+   }
+   catch( OPTION_INVALID& exc )
+   {
+      exc.ReportException(*jnlst_, J_ERROR);
+      retValue = Invalid_Option;
+   }
+   catch( TNLPAdapter::INVALID_TNLP& exc )
+   {
+      exc.ReportException(*jnlst_, J_ERROR);
+      retValue = Invalid_Problem_Definition;
+   }
+   catch( IpoptException& exc )
+   {
+      exc.ReportException(*jnlst_, J_ERROR);
+      retValue = Unrecoverable_Exception;
+   }
+   catch( std::bad_alloc& )
+   {
+      retValue = Insufficient_Memory;
+      jnlst_->Printf(J_SUMMARY, J_MAIN, "\nEXIT: Not enough memory.\n");
+   }
+   catch( ... )
+   {
+      if( !rethrow_nonipoptexception_ )
+      {
+         IpoptException exc("Unknown Exception caught in Ipopt", "Unknown File", -1);
+         exc.ReportException(*jnlst_, J_ERROR);
+         retValue = NonIpopt_Exception_Thrown;
+      }
+      else
+      {
+         throw;
+      }
+   }
+
+   jnlst_->WaitForOutput();
+
+   return retValue;
+}
+
+/** Sets the number of threads of the BLAS wrappers for the lifetime of the object. */
+class BlasNumThreadsGuard
+{
+public:
+   BlasNumThreadsGuard(
+      int nthreads
+   )
+      : active_(nthreads > 0),
+        prev_(0)
+   {
+      if( active_ )
+      {
+         prev_ = IpBlasSetNumThreads(nthreads);
+      }
+   }
+
+   ~BlasNumThreadsGuard()
+   {
+      if( active_ )
+      {
+         IpBlasSetNumThreads(prev_);
+      }
+   }
+
+private:
+   bool active_;
+   int prev_;
+};
+
+/** Sets the number of OpenMP threads for the lifetime of the object. */
+class OmpNumThreadsGuard
+{
+public:
+   OmpNumThreadsGuard(
+      int nthreads
+   )
+      : active_(nthreads > 0),
+        prev_(0)
+   {
+#ifdef _OPENMP
+      if( active_ )
+      {
+         prev_ = omp_get_max_threads();
+         omp_set_num_threads(nthreads);
+      }
+#endif
+   }
+
+   ~OmpNumThreadsGuard()
+   {
+#ifdef _OPENMP
+      if( active_ )
+      {
+         omp_set_num_threads(prev_);
+      }
+#endif
+   }
+
+private:
+   bool active_;
+   int prev_;
+};
+
 ApplicationReturnStatus IpoptApplication::call_optimize()
 {
+   MemoryStatistics::CurrentScope memory_scope(GetRawPtr(memory_stats_));
+
    // Reset the print-level for the screen output
    Index ivalue;
    options_->GetIntegerValue("print_level", ivalue, "");
@@ -878,6 +2084,12 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
       stdout_jrnl->SetPrintLevel(J_DBG, J_NONE);
    }
 
+   // Pin the number of OpenMP and BLAS threads until the end of the solve
+   options_->GetIntegerValue("num_threads", ivalue, "");
+   OmpNumThreadsGuard omp_threads((int) ivalue);
+   options_->GetIntegerValue("blas_num_threads", ivalue, "");
+   BlasNumThreadsGuard blas_threads((int) ivalue);
+
    statistics_ = NULL; /* delete old statistics */
    // Get the pointers to the real objects (need to do it that
    // awkwardly since otherwise we would have to include so many
@@ -895,6 +2107,34 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
    // Reset Timing statistics
    ip_data_->TimingStats().ResetTimes();
    p2ip_nlp->ResetTimes();
+   memory_stats_->ResetHighWaterMarks();
+
+   // Time the individual tasks only if their statistics are printed or exported
+   bool print_timing_statistics;
+   options_->GetBoolValue("print_timing_statistics", print_timing_statistics, "");
+   std::string timing_statistics_file;
+   options_->GetStringValue("timing_statistics_file", timing_statistics_file, "");
+   std::string iteration_trace_file;
+   options_->GetStringValue("iteration_trace_file", iteration_trace_file, "");
+   std::string timing_statistics_file_format;
+   options_->GetStringValue("timing_statistics_file_format", timing_statistics_file_format, "");
+   ip_data_->TimingStats().SetRecording(!timing_statistics_file.empty() && timing_statistics_file_format == "json",
+                                        !timing_statistics_file.empty() && timing_statistics_file_format == "chrome_trace");
+   if( !print_timing_statistics && timing_statistics_file.empty() && iteration_trace_file.empty() )
+   {
+      ip_data_->TimingStats().SetTimingMode(TimedTask::TIMING_NONE);
+   }
+   else if( !print_timing_statistics && timing_statistics_file.empty() )
+   {
+      // the iteration trace only needs wallclock times
+      ip_data_->TimingStats().SetTimingMode(TimedTask::TIMING_WALLCLOCK);
+   }
+   else
+   {
+      std::string timing_clock;
+      options_->GetStringValue("timing_statistics_clock", timing_clock, "");
+      ip_data_->TimingStats().SetTimingMode(timing_clock == "wallclock" ? TimedTask::TIMING_WALLCLOCK : TimedTask::TIMING_ALL);
+   }
 
    ApplicationReturnStatus retValue = Internal_Error;
    SolverReturn status = INTERNAL_ERROR;
@@ -907,10 +2147,6 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
       // Set up the algorithm
       p2alg->Initialize(*jnlst_, *p2ip_nlp, *p2ip_data, *p2ip_cq, *options_, "");
 
-      // Process the options used below
-      bool print_timing_statistics;
-      options_->GetBoolValue("print_timing_statistics", print_timing_statistics, "");
-
       // If selected, print the user options
       bool print_user_options;
       options_->GetBoolValue("print_user_options", print_user_options, "");
@@ -936,7 +2172,7 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
       // case, we rethrow the TOO_FEW_DOF exception here
       ASSERT_EXCEPTION(status != TOO_FEW_DEGREES_OF_FREEDOM, TOO_FEW_DOF, "Too few degrees of freedom (rethrown)!");
 
-      jnlst_->Printf(J_SUMMARY, J_SOLUTION, "\nNumber of Iterations....: %d\n", p2ip_data->iter_count());
+      jnlst_->Printf(J_SUMMARY, J_SOLUTION, "\nNumber of Iterations....: %" IPOPT_INDEX_FORMAT "\n", p2ip_data->iter_count());
 
       if( status != INVALID_NUMBER_DETECTED )
       {
@@ -977,19 +2213,19 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
          p2ip_cq->curr_d_minus_s()->Print(*jnlst_, J_VECTOR, J_SOLUTION, "curr_d_minus_s");
       }
 
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "\nNumber of objective function evaluations             = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "\nNumber of objective function evaluations             = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->f_evals());
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of objective gradient evaluations             = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of objective gradient evaluations             = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->grad_f_evals());
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of equality constraint evaluations            = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of equality constraint evaluations            = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->c_evals());
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of inequality constraint evaluations          = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of inequality constraint evaluations          = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->d_evals());
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of equality constraint Jacobian evaluations   = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of equality constraint Jacobian evaluations   = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->jac_c_evals());
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of inequality constraint Jacobian evaluations = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of inequality constraint Jacobian evaluations = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->jac_d_evals());
-      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of Lagrangian Hessian evaluations             = %d\n",
+      jnlst_->Printf(J_SUMMARY, J_STATISTICS, "Number of Lagrangian Hessian evaluations             = %" IPOPT_INDEX_FORMAT "\n",
                      p2ip_nlp->h_evals());
       Number cpu_time_overall_alg = p2ip_data->TimingStats().OverallAlgorithm().TotalCpuTime();
       Number cpu_time_funcs = p2ip_nlp->TotalFunctionEvaluationCpuTime();
@@ -1004,6 +2240,31 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
          jnlst_->Printf(J_SUMMARY, J_TIMING_STATISTICS, "\n\nTiming Statistics:\n\n");
          p2ip_data->TimingStats().PrintAllTimingStatistics(*jnlst_, J_SUMMARY, J_TIMING_STATISTICS);
          p2ip_nlp->PrintTimingStatistics(*jnlst_, J_SUMMARY, J_TIMING_STATISTICS);
+         jnlst_->Printf(J_SUMMARY, J_TIMING_STATISTICS, "\n\nMemory Statistics (high-water mark and current allocation in MB):\n\n");
+         memory_stats_->Print(*jnlst_, J_SUMMARY, J_TIMING_STATISTICS);
+      }
+
+      // Export timing statistics information
+      if( !timing_statistics_file.empty() )
+      {
+         FILE* fp = fopen(timing_statistics_file.c_str(), "w");
+         if( fp == NULL )
+         {
+            jnlst_->Printf(J_WARNING, J_MAIN, "Could not open file %s to write the timing statistics.\n",
+                           timing_statistics_file.c_str());
+         }
+         else
+         {
+            if( timing_statistics_file_format == "chrome_trace" )
+            {
+               p2ip_data->TimingStats().WriteChromeTrace(fp);
+            }
+            else
+            {
+               p2ip_data->TimingStats().WriteJSON(fp);
+            }
+            fclose(fp);
+         }
       }
 
       // Write EXIT message
@@ -1142,7 +2403,7 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
       }
       else
       {
-         jnlst_->FlushBuffer();
+         jnlst_->WaitForOutput();
          throw;
       }
    }
@@ -1204,7 +2465,7 @@ ApplicationReturnStatus IpoptApplication::call_optimize()
       p2ip_nlp->FinalizeSolution(status, *p2ip_data->curr()->x(), *zL, *zU, *c, *d, *yc, *yd, obj, p2ip_data, p2ip_cq);
    }
 
-   jnlst_->FlushBuffer();
+   jnlst_->WaitForOutput();
 
    return retValue;
 }
@@ -1218,7 +2479,19 @@ bool IpoptApplication::OpenOutputFile(
 
    if( IsNull(file_jrnl) )
    {
-      file_jrnl = jnlst_->AddFileJournal("OutputFile:" + file_name, file_name.c_str(), print_level);
+      bool async = false;
+      if( IsValid(options_) )
+      {
+         options_->GetBoolValue("output_file_async", async, "");
+      }
+      if( async )
+      {
+         file_jrnl = jnlst_->AddAsyncFileJournal("OutputFile:" + file_name, file_name.c_str(), print_level);
+      }
+      else
+      {
+         file_jrnl = jnlst_->AddFileJournal("OutputFile:" + file_name, file_name.c_str(), print_level);
+      }
    }
 
    // Check, if the output file could be created properly
@@ -1245,11 +2518,55 @@ void IpoptApplication::RegisterAllIpoptOptions(
 #endif
 }
 
+SmartPtr<const RegisteredOptions> IpoptApplication::SharedRegisteredOptions()
+{
+   // the initialization of a local static is thread-safe since C++11
+   static SmartPtr<const RegisteredOptions> shared_reg_options = CreateSharedRegisteredOptions();
+   return shared_reg_options;
+}
+
+SmartPtr<RegisteredOptions> IpoptApplication::RegOptions()
+{
+   if( reg_options_shared_ )
+   {
+      // copy-on-write, since options should be added to this application only
+      reg_options_ = new RegisteredOptions(*reg_options_);
+      reg_options_shared_ = false;
+      options_->SetRegisteredOptions(reg_options_);
+   }
+   return reg_options_;
+}
+
 SmartPtr<SolveStatistics> IpoptApplication::Statistics()
 {
    return statistics_;
 }
 
+SmartPtr<MemoryStatistics> IpoptApplication::MemoryStats()
+{
+   return memory_stats_;
+}
+
+bool IpoptApplication::SetMumpsMpiWorkers(
+   bool use_workers
+)
+{
+#ifdef IPOPT_HAS_MUMPS
+   return MumpsSolverInterface::SetUseMpiWorkers(use_workers);
+#else
+   return !use_workers;
+#endif
+}
+
+bool IpoptApplication::RunMumpsMpiWorker()
+{
+#ifdef IPOPT_HAS_MUMPS
+   return MumpsSolverInterface::MpiWorkerLoop();
+#else
+   return false;
+#endif
+}
+
 SmartPtr<IpoptNLP> IpoptApplication::IpoptNLPObject()
 {
    return ip_nlp_;
@@ -36,6 +36,7 @@ class AlgorithmBuilder;
 class RegisteredOptions;
 class OptionsList;
 class SolveStatistics;
+class MemoryStatistics;
 
 /** This is the main application class for making calls to Ipopt. */
 class IPOPTLIB_EXPORT IpoptApplication: public ReferencedObject
@@ -152,6 +153,63 @@ public:
       const SmartPtr<TNLP>& tnlp
    );
 
+   /** Solve a problem that inherits from TNLP, reusing the problem
+    *  structure of the last TNLP solved by another IpoptApplication.
+    *
+    *  The TNLP must have the same number of variables and constraints,
+    *  the same position of nonzeros in Jacobian and Hessian, and the
+    *  same fixed variables as the TNLP solved by structure_source, and
+    *  the derivative approximation options must agree.  structure_source
+    *  must not be solving at the same time.  After that, several
+    *  IpoptApplications that share one structure_source can solve
+    *  concurrently, provided that Ipopt has been compiled with
+    *  IPOPT_ATOMIC_REFCOUNT defined (see TNLPAdapter::SetStructureSource).
+    */
+   virtual ApplicationReturnStatus OptimizeTNLP(
+      const SmartPtr<TNLP>&   tnlp,
+      const IpoptApplication& structure_source
+   );
+
+   /** Solve a problem that inherits from TNLP from several starting points.
+    *
+    *  The first start is solved by this IpoptApplication.  If Ipopt
+    *  has been compiled with C++11 and IPOPT_ATOMIC_REFCOUNT defined,
+    *  n_threads is larger than one, and the TNLP allows concurrent
+    *  evaluations (see TNLP::get_evaluation_concurrency), the other
+    *  starts are solved by n_threads threads, each with its own
+    *  IpoptApplication that has the options of this one but no output,
+    *  that takes the problem structure from the first start (unless
+    *  the presolve is enabled), and that keeps its symbolic
+    *  factorization from one start to the next.  Otherwise, the
+    *  starts are solved one after the other by reoptimizing the first
+    *  one.
+    *
+    *  The starting point for x is taken from x_starts.  All other
+    *  methods of the TNLP are called from the runs, with the
+    *  non-evaluation methods (including intermediate_callback) never
+    *  called concurrently, except for finalize_solution:  it is called
+    *  once after all runs have finished for the run that converged
+    *  (possibly to an acceptable level) to the smallest objective
+    *  value, and not at all if no run converged; the ip_data and
+    *  ip_cq arguments are then NULL.  Runs that are dominated by the
+    *  best solution so far can be stopped early, see option
+    *  multistart_abort_dominated.
+    *
+    *  Afterwards, this IpoptApplication cannot reoptimize tnlp by
+    *  ReOptimizeTNLP.
+    *
+    *  @return the status of the best run, or of the first run if no run converged
+    */
+   virtual ApplicationReturnStatus OptimizeTNLPMultiStart(
+      const SmartPtr<TNLP>&    tnlp,
+      Index                    n_starts,          /**< number of starting points */
+      const Number*            x_starts,          /**< starting points one after the other (size n*n_starts) */
+      Index                    n_threads,         /**< number of threads, or a nonpositive value to use option num_threads, if set, or one thread per core */
+      Index&                   best_start,        /**< output: index of the start with the best solution, or -1 if no run converged */
+      ApplicationReturnStatus* status = NULL,     /**< output: outcome of each run (size n_starts; ignored if NULL) */
+      Number*                  obj_values = NULL  /**< output: final objective value of each run (size n_starts; ignored if NULL) */
+   );
+
    /** Solve a problem that inherits from NLP */
    virtual ApplicationReturnStatus OptimizeNLP(
       const SmartPtr<NLP>& nlp
@@ -184,6 +242,29 @@ public:
    virtual ApplicationReturnStatus ReOptimizeNLP(
       const SmartPtr<NLP>& nlp
    );
+
+   /** Predict the size and cost of the linear systems of a problem (that inherits from TNLP) without solving it.
+    *
+    *  The structure of the problem is obtained as for OptimizeTNLP,
+    *  and the augmented system of the primal-dual system with the
+    *  exact Hessian (or a diagonal, if the Hessian is approximated)
+    *  is formed.  The linear solver that is selected by the options
+    *  analyzes only its structure and predicts the size and cost of
+    *  its factorization.  No functions of the TNLP are evaluated,
+    *  unless the derivative checker or the detection of dependent
+    *  constraints are enabled.
+    *
+    *  The estimates are -1 if the linear solver does not predict
+    *  them before the first factorization.
+    */
+   virtual ApplicationReturnStatus AnalyzeTNLP(
+      const SmartPtr<TNLP>& tnlp,
+      Index&                kkt_dim,         /**< dimension of the augmented system */
+      Index&                kkt_nonzeros,    /**< number of nonzeros of the augmented system given to the linear solver */
+      Number&               factor_nonzeros, /**< predicted number of entries in the factors */
+      Number&               factor_flops,    /**< predicted number of floating point operations of one factorization */
+      Number&               factor_memory    /**< predicted memory of the linear solver in bytes */
+   );
    ///@}
 
    /** Method for opening an output file with given print_level.
@@ -203,11 +284,14 @@ public:
       return jnlst_;
    }
 
-   /** Get a pointer to RegisteredOptions object to add new options */
-   virtual SmartPtr<RegisteredOptions> RegOptions()
-   {
-      return reg_options_;
-   }
+   /** Get a pointer to RegisteredOptions object to add new options
+    *
+    *  If this application still uses the RegisteredOptions that are
+    *  shared by all applications (see SharedRegisteredOptions), it
+    *  obtains its own copy first, so that options added here are not
+    *  seen by other applications.
+    */
+   virtual SmartPtr<RegisteredOptions> RegOptions();
 
    /** Get the options list for setting options */
    virtual SmartPtr<OptionsList> Options()
@@ -226,6 +310,11 @@ public:
     */
    virtual SmartPtr<SolveStatistics> Statistics();
 
+   /** Get the object with the memory statistics of the optimization
+    *  runs of this application.
+    */
+   SmartPtr<MemoryStatistics> MemoryStats();
+
    /** Get the IpoptNLP Object */
    virtual SmartPtr<IpoptNLP> IpoptNLPObject();
 
@@ -276,6 +365,36 @@ public:
       const SmartPtr<RegisteredOptions>& roptions
    );
 
+   /** Get the RegisteredOptions with all Ipopt options that are shared
+    *  by all IpoptApplication objects of the process.
+    *
+    *  The object is created at the first call (thread-safe if compiled
+    *  as C++11 or newer) and never changed afterwards.  If Ipopt has been
+    *  compiled with IPOPT_ATOMIC_REFCOUNT defined, the constructor of
+    *  IpoptApplication uses this object instead of registering all options
+    *  anew.  Otherwise, each application has its own RegisteredOptions,
+    *  since the reference counts of the RegisteredOption objects would be
+    *  changed concurrently by applications in different threads.
+    */
+   static SmartPtr<const RegisteredOptions> SharedRegisteredOptions();
+
+   /** @name Distributed factorization with a parallel MUMPS
+    *
+    *  If MUMPS has been built with MPI, all processes of MPI_COMM_WORLD
+    *  take part in the factorization.  To run Ipopt on rank 0 only, call
+    *  SetMumpsMpiWorkers(true) there before solving and RunMumpsMpiWorker()
+    *  on all other ranks, which returns after SetMumpsMpiWorkers(false)
+    *  has been called on rank 0.  MPI must have been initialized before.
+    *  Both methods return false if MUMPS is not available with MPI.
+    */
+   ///@{
+   static bool SetMumpsMpiWorkers(
+      bool use_workers
+   );
+
+   static bool RunMumpsMpiWorker();
+   ///@}
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -317,6 +436,9 @@ private:
    /** RegisteredOptions */
    SmartPtr<RegisteredOptions> reg_options_;
 
+   /** Whether reg_options_ is the object of SharedRegisteredOptions, which must not be changed */
+   bool reg_options_shared_;
+
    /** OptionsList used for the application */
    SmartPtr<OptionsList> options_;
 
@@ -325,6 +447,13 @@ private:
     */
    SmartPtr<SolveStatistics> statistics_;
 
+   /** Memory statistics of the optimization runs of this application.
+    *
+    *  They are the current statistics of the thread while it runs an
+    *  optimization.
+    */
+   SmartPtr<MemoryStatistics> memory_stats_;
+
    /** Object with the algorithm skeleton.
     */
    SmartPtr<IpoptAlgorithm> alg_;
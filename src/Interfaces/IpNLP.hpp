@@ -16,6 +16,8 @@
 #include "IpAlgTypes.hpp"
 #include "IpReturnCodes.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 // forward declarations
@@ -156,6 +158,123 @@ public:
       const Vector& yd,
       SymMatrix&    h
    ) = 0;
+
+   /** Evaluate the constraint Jacobians and the Hessian of the
+    *  Lagrangian at the same point.
+    *
+    *  jac_c or jac_d may be NULL if they are not required.  The default
+    *  implementation calls Eval_jac_c, Eval_jac_d, and Eval_h one after
+    *  the other.  It can be overloaded to evaluate them concurrently.
+    */
+   virtual bool Eval_jac_and_h(
+      const Vector& x,
+      Matrix*       jac_c,
+      Matrix*       jac_d,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      SymMatrix&    h
+   )
+   {
+      if( jac_c != NULL && !Eval_jac_c(x, *jac_c) )
+      {
+         return false;
+      }
+      if( jac_d != NULL && !Eval_jac_d(x, *jac_d) )
+      {
+         return false;
+      }
+      return Eval_h(x, obj_factor, yc, yd, h);
+   }
+
+   /** Compute the product hv of the Hessian of the Lagrangian with a vector v.
+    *
+    *  This is used instead of Eval_h if the Hessian is only available
+    *  through products with vectors (hessian_approximation=matrix-free).
+    *  The default implementation returns false.
+    */
+   virtual bool Eval_h_times_vec(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      const Vector& v,
+      Vector&       hv
+   )
+   {
+      (void) x;
+      (void) obj_factor;
+      (void) yc;
+      (void) yd;
+      (void) v;
+      (void) hv;
+      return false;
+   }
+
+   /** Method for obtaining the element functions of the Lagrangian.
+    *
+    *  This is used for the partitioned quasi-Newton approximation
+    *  (hessian_approximation=partitioned).  The variables of element
+    *  function e, whose indices refer to x, are elem_vars[elem_start[e]],
+    *  ..., elem_vars[elem_start[e+1]-1].  The Hessian space returned by
+    *  GetSpaces has then to be a SymTMatrixSpace whose nonzeros are,
+    *  for each element function in turn, the entries (i,j) with j <= i
+    *  of its dense Hessian (in the order of the variables).  The
+    *  default implementation returns false.
+    */
+   virtual bool GetElementFunctions(
+      std::vector<Index>& elem_start,
+      std::vector<Index>& elem_vars
+   )
+   {
+      (void) elem_start;
+      (void) elem_vars;
+      return false;
+   }
+
+   /** Compute the gradients of the element functions of the Lagrangian.
+    *
+    *  elem_grad has one entry for each entry of elem_vars from
+    *  GetElementFunctions.  The default implementation returns false.
+    */
+   virtual bool Eval_element_gradients(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      Vector&       elem_grad
+   )
+   {
+      (void) x;
+      (void) obj_factor;
+      (void) yc;
+      (void) yd;
+      (void) elem_grad;
+      return false;
+   }
+
+   /** Evaluate the objective function and the constraints at several points.
+    *
+    *  f, c, and d have an entry for each point in x, and success[i]
+    *  is set to indicate whether the evaluation at x[i] was successful.
+    *  The default implementation calls Eval_f, Eval_c, and Eval_d for
+    *  one point after the other.  It can be overloaded to evaluate the
+    *  points concurrently.
+    */
+   virtual void Eval_f_c_d(
+      const std::vector<SmartPtr<const Vector> >& x,
+      std::vector<Number>&                        f,
+      std::vector<SmartPtr<Vector> >&             c,
+      std::vector<SmartPtr<Vector> >&             d,
+      std::vector<bool>&                          success
+   )
+   {
+      for( size_t i = 0; i < x.size(); i++ )
+      {
+         success[i] = Eval_f(*x[i], f[i]) && (c[i]->Dim() == 0 || Eval_c(*x[i], *c[i]))
+                      && (d[i]->Dim() == 0 || Eval_d(*x[i], *d[i]));
+      }
+   }
    ///@}
 
    /** @name NLP solution routines.
@@ -266,6 +385,54 @@ public:
       P_approx     = NULL;
    }
 
+   /** Method for obtaining whether the constraint Jacobians are constant.
+    *
+    *  This is the case if all equality or all inequality constraints
+    *  are known to be linear.  The Jacobians are then only evaluated
+    *  once, as with the options jac_c_constant and jac_d_constant.
+    *  This may only be called after GetSpaces.  The default
+    *  implementation returns false, i.e., nothing is known.
+    */
+   virtual bool GetConstantJacobians(
+      bool& jac_c_constant,
+      bool& jac_d_constant
+   )
+   {
+      jac_c_constant = false;
+      jac_d_constant = false;
+      return false;
+   }
+
+   /** @name Methods for a block-angular structure of the problem.
+    *
+    *  These are used by the Schur complement solver for the augmented
+    *  system.  The default implementations declare that no structure
+    *  is known.
+    */
+   ///@{
+   /** Number of diagonal blocks, or 0 if no block structure is known. */
+   virtual Index GetNumberOfDiagonalBlocks()
+   {
+      return 0;
+   }
+
+   /** Get the blocks of the entries of x, c, and d.
+    *
+    *  Each entry is assigned a block between 0 and num_blocks-1, or -1
+    *  if it is linking.  The block of an inequality constraint is also
+    *  that of its slack.  This may only be called after GetSpaces.
+    */
+   virtual bool GetDiagonalBlocks(
+      Index               /*num_blocks*/,
+      std::vector<Index>& /*x_block*/,
+      std::vector<Index>& /*c_block*/,
+      std::vector<Index>& /*d_block*/
+   )
+   {
+      return false;
+   }
+   ///@}
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -36,7 +36,14 @@ SolveStatistics::SolveStatistics(
      compl_(ip_cq->unscaled_curr_complementarity(0., NORM_MAX)),
      scaled_kkt_error_(ip_cq->curr_nlp_error()),
      kkt_error_(ip_cq->unscaled_curr_nlp_error())
-{ }
+{
+   const WorkCounters& work_counts = ip_data->WorkCounts();
+   for( Index i = 0; i < WorkCounters::NUM_COUNTERS; ++i )
+   {
+      work_count_[i] = work_counts.Total(WorkCounters::Counter(i));
+      work_count_per_iter_[i] = work_counts.PerIteration(WorkCounters::Counter(i));
+   }
+}
 
 Index SolveStatistics::IterationCount() const
 {
@@ -73,6 +80,20 @@ void SolveStatistics::NumberOfEvaluations(
    num_hess_evals       = num_hess_evals_;
 }
 
+Index SolveStatistics::WorkCount(
+   WorkCounters::Counter counter
+) const
+{
+   return work_count_[counter];
+}
+
+const std::vector<Index>& SolveStatistics::WorkCountPerIteration(
+   WorkCounters::Counter counter
+) const
+{
+   return work_count_per_iter_[counter];
+}
+
 void SolveStatistics::Infeasibilities(
    Number& dual_inf,
    Number& constr_viol,
@@ -9,6 +9,9 @@
 
 #include "IpReferenced.hpp"
 #include "IpSmartPtr.hpp"
+#include "IpWorkCounters.hpp"
+
+#include <vector>
 
 namespace Ipopt
 {
@@ -78,6 +81,25 @@ public:
       Index& num_hess_evals
    ) const;
 
+   /** Total number of factorizations, backsolves, function evaluations, etc.
+    *
+    *  See WorkCounters::Counter for the kinds of work that are counted.
+    */
+   virtual Index WorkCount(
+      WorkCounters::Counter counter
+   ) const;
+
+   /** Number of factorizations, backsolves, function evaluations, etc. in each iteration.
+    *
+    *  Entry k is the work done for iteration k, where entry 0 is the
+    *  work done for the initialization.  Work done after the last
+    *  iteration, e.g., for the computation of the final multipliers,
+    *  is only included in WorkCount.
+    */
+   virtual const std::vector<Index>& WorkCountPerIteration(
+      WorkCounters::Counter counter
+   ) const;
+
    /** Unscaled solution infeasibilities. */
    virtual void Infeasibilities(
       Number& dual_inf,
@@ -146,6 +168,10 @@ private:
    Index num_constr_jac_evals_;
    /** Number of Lagrangian Hessian evaluations. */
    Index num_hess_evals_;
+   /** Total counts of the work done */
+   Index work_count_[WorkCounters::NUM_COUNTERS];
+   /** Counts of the work done in each iteration */
+   std::vector<Index> work_count_per_iter_[WorkCounters::NUM_COUNTERS];
 
    /** Final scaled value of objective function */
    Number scaled_obj_val_;
@@ -10,6 +10,14 @@
 #include "IpStdInterfaceTNLP.hpp"
 #include "IpOptionsList.hpp"
 #include "IpIpoptApplication.hpp"
+#include "IpSolveStatistics.hpp"
+
+#if __cplusplus >= 201103L && defined(IPOPT_ATOMIC_REFCOUNT)
+#include <atomic>
+#include <thread>
+#include <vector>
+#define IPOPT_BATCH_THREADS
+#endif
 
 struct IpoptProblemInfo
 {
@@ -32,6 +40,8 @@ struct IpoptProblemInfo
    Number          obj_scaling;
    Number*         x_scaling;
    Number*         g_scaling;
+   /** TNLP of the last solve, kept for IpoptReSolve */
+   Ipopt::SmartPtr<Ipopt::StdInterfaceTNLP> tnlp;
 };
 
 IpoptProblem CreateIpoptProblem(
@@ -118,6 +128,7 @@ void FreeIpoptProblem(
    IpoptProblem ipopt_problem
 )
 {
+   ipopt_problem->tnlp = NULL;
    ipopt_problem->app = NULL;
 
    delete[] ipopt_problem->x_L;
@@ -173,6 +184,9 @@ Bool SetIpoptProblemScaling(
    Number*      g_scaling
 )
 {
+   // the scaling factors are copied by the TNLP, so it has to be recreated
+   ipopt_problem->tnlp = NULL;
+
    ipopt_problem->obj_scaling = obj_scaling;
 
    if( x_scaling )
@@ -217,35 +231,73 @@ Bool SetIntermediateCallback(
    Intermediate_CB intermediate_cb
 )
 {
+   ipopt_problem->tnlp = NULL;
    ipopt_problem->intermediate_cb = intermediate_cb;
 
    return (Bool) true;
 }
 
-enum ApplicationReturnStatus IpoptSolve(
+Bool SetIpoptProblemBounds(
    IpoptProblem ipopt_problem,
-   Number*      x,
-   Number*      g,
-   Number*      obj_val,
-   Number*      mult_g,
-   Number*      mult_x_L,
-   Number*      mult_x_U,
-   UserDataPtr  user_data
+   Number*      x_L,
+   Number*      x_U,
+   Number*      g_L,
+   Number*      g_U
 )
 {
-   // Initialize and process options
-   Ipopt::ApplicationReturnStatus retval = ipopt_problem->app->Initialize();
-   if( retval != Ipopt::Solve_Succeeded )
+   // the TNLP points to the arrays of ipopt_problem, so they are updated in place
+   if( x_L )
    {
-      return ApplicationReturnStatus(retval);
+      for( Index i = 0; i < ipopt_problem->n; i++ )
+      {
+         ipopt_problem->x_L[i] = x_L[i];
+      }
    }
-
-   if( !x )
+   if( x_U )
    {
-      ipopt_problem->app->Jnlst()->Printf(Ipopt::J_ERROR, Ipopt::J_MAIN, "Error: Array x with starting point information is NULL.");
-      return ApplicationReturnStatus(Ipopt::Invalid_Problem_Definition);
+      for( Index i = 0; i < ipopt_problem->n; i++ )
+      {
+         ipopt_problem->x_U[i] = x_U[i];
+      }
+   }
+   if( g_L )
+   {
+      for( Index i = 0; i < ipopt_problem->m; i++ )
+      {
+         ipopt_problem->g_L[i] = g_L[i];
+      }
+   }
+   if( g_U )
+   {
+      for( Index i = 0; i < ipopt_problem->m; i++ )
+      {
+         ipopt_problem->g_U[i] = g_U[i];
+      }
    }
 
+   return (Bool) true;
+}
+
+/** Solves the problem with app for a starting point, creating tnlp if it is NULL and reoptimizing it otherwise.
+ *
+ *  If a new tnlp is created and structure_source is not NULL, the
+ *  problem structure of structure_source is used.  If the problem
+ *  could not be set up, tnlp is set to NULL.
+ */
+static Ipopt::ApplicationReturnStatus solve_tnlp(
+   IpoptProblem                              ipopt_problem,
+   Ipopt::IpoptApplication&                  app,
+   Ipopt::SmartPtr<Ipopt::StdInterfaceTNLP>& tnlp,
+   const Ipopt::IpoptApplication*            structure_source,
+   Number*                                   x,
+   Number*                                   g,
+   Number*                                   obj_val,
+   Number*                                   mult_g,
+   Number*                                   mult_x_L,
+   Number*                                   mult_x_U,
+   UserDataPtr                               user_data
+)
+{
    // Copy the starting point information
    Number* start_x = new Number[ipopt_problem->n];
    for( Index i = 0; i < ipopt_problem->n; ++i )
@@ -283,37 +335,335 @@ enum ApplicationReturnStatus IpoptSolve(
       }
    }
 
-   // Create the original nlp
-   Ipopt::SmartPtr<Ipopt::TNLP> tnlp;
-
    Ipopt::ApplicationReturnStatus status;
    try
    {
-      tnlp = new Ipopt::StdInterfaceTNLP(ipopt_problem->n, ipopt_problem->x_L, ipopt_problem->x_U,
-                                         ipopt_problem->m, ipopt_problem->g_L, ipopt_problem->g_U,
-                                         ipopt_problem->nele_jac, ipopt_problem->nele_hess, ipopt_problem->index_style,
-                                         start_x, start_lam, start_z_L, start_z_U,
-                                         ipopt_problem->eval_f, ipopt_problem->eval_g, ipopt_problem->eval_grad_f, ipopt_problem->eval_jac_g, ipopt_problem->eval_h,
-                                         ipopt_problem->intermediate_cb,
-                                         x, mult_x_L, mult_x_U, g, mult_g, obj_val, user_data,
-                                         ipopt_problem->obj_scaling, ipopt_problem->x_scaling, ipopt_problem->g_scaling);
-      status = ipopt_problem->app->OptimizeTNLP(tnlp);
+      if( Ipopt::IsValid(tnlp) )
+      {
+         tnlp->SetSolveData(start_x, start_lam, start_z_L, start_z_U,
+                            x, mult_x_L, mult_x_U, g, mult_g, obj_val, user_data);
+         status = app.ReOptimizeTNLP(GetRawPtr(tnlp));
+      }
+      else
+      {
+         // Create the original nlp
+         tnlp = new Ipopt::StdInterfaceTNLP(ipopt_problem->n, ipopt_problem->x_L, ipopt_problem->x_U,
+                                            ipopt_problem->m, ipopt_problem->g_L, ipopt_problem->g_U,
+                                            ipopt_problem->nele_jac, ipopt_problem->nele_hess, ipopt_problem->index_style,
+                                            start_x, start_lam, start_z_L, start_z_U,
+                                            ipopt_problem->eval_f, ipopt_problem->eval_g, ipopt_problem->eval_grad_f, ipopt_problem->eval_jac_g, ipopt_problem->eval_h,
+                                            ipopt_problem->intermediate_cb,
+                                            x, mult_x_L, mult_x_U, g, mult_g, obj_val, user_data,
+                                            ipopt_problem->obj_scaling, ipopt_problem->x_scaling, ipopt_problem->g_scaling);
+         if( structure_source != NULL )
+         {
+            status = app.OptimizeTNLP(GetRawPtr(tnlp), *structure_source);
+         }
+         else
+         {
+            status = app.OptimizeTNLP(GetRawPtr(tnlp));
+         }
+      }
    }
    catch( Ipopt::INVALID_STDINTERFACE_NLP& exc )
    {
-      exc.ReportException(*ipopt_problem->app->Jnlst(), Ipopt::J_ERROR);
+      exc.ReportException(*app.Jnlst(), Ipopt::J_ERROR);
       status = Ipopt::Invalid_Problem_Definition;
    }
    catch( Ipopt::IpoptException& exc )
    {
-      exc.ReportException(*ipopt_problem->app->Jnlst(), Ipopt::J_ERROR);
+      exc.ReportException(*app.Jnlst(), Ipopt::J_ERROR);
       status = Ipopt::Unrecoverable_Exception;
    }
 
+   // if the problem could not be set up, do not try to reuse it in the next solve
+   if( status <= Ipopt::Not_Enough_Degrees_Of_Freedom && status != Ipopt::Invalid_Number_Detected )
+   {
+      tnlp = NULL;
+   }
+
    delete[] start_x;
    delete[] start_lam;
    delete[] start_z_L;
    delete[] start_z_U;
 
-   return ApplicationReturnStatus(status);
+   return status;
+}
+
+/** Solves the problem, reusing the TNLP and the algorithm of the previous solve if reoptimize is true and there is one */
+static enum ApplicationReturnStatus solve(
+   IpoptProblem ipopt_problem,
+   bool         reoptimize,
+   Number*      x,
+   Number*      g,
+   Number*      obj_val,
+   Number*      mult_g,
+   Number*      mult_x_L,
+   Number*      mult_x_U,
+   UserDataPtr  user_data
+)
+{
+   reoptimize = reoptimize && Ipopt::IsValid(ipopt_problem->tnlp);
+
+   // Initialize and process options; this has been done already if the algorithm is reused
+   if( !reoptimize )
+   {
+      Ipopt::ApplicationReturnStatus retval = ipopt_problem->app->Initialize();
+      if( retval != Ipopt::Solve_Succeeded )
+      {
+         return ApplicationReturnStatus(retval);
+      }
+      ipopt_problem->tnlp = NULL;
+   }
+
+   if( !x )
+   {
+      ipopt_problem->app->Jnlst()->Printf(Ipopt::J_ERROR, Ipopt::J_MAIN, "Error: Array x with starting point information is NULL.");
+      return ApplicationReturnStatus(Ipopt::Invalid_Problem_Definition);
+   }
+
+   return ApplicationReturnStatus(solve_tnlp(ipopt_problem, *ipopt_problem->app, ipopt_problem->tnlp, NULL,
+                                             x, g, obj_val, mult_g, mult_x_L, mult_x_U, user_data));
+}
+
+enum ApplicationReturnStatus IpoptSolve(
+   IpoptProblem ipopt_problem,
+   Number*      x,
+   Number*      g,
+   Number*      obj_val,
+   Number*      mult_g,
+   Number*      mult_x_L,
+   Number*      mult_x_U,
+   UserDataPtr  user_data
+)
+{
+   return solve(ipopt_problem, false, x, g, obj_val, mult_g, mult_x_L, mult_x_U, user_data);
+}
+
+enum ApplicationReturnStatus IpoptReSolve(
+   IpoptProblem ipopt_problem,
+   Number*      x,
+   Number*      g,
+   Number*      obj_val,
+   Number*      mult_g,
+   Number*      mult_x_L,
+   Number*      mult_x_U,
+   UserDataPtr  user_data
+)
+{
+   return solve(ipopt_problem, true, x, g, obj_val, mult_g, mult_x_L, mult_x_U, user_data);
+}
+
+/** Arrays and state of a batch solve */
+struct BatchData
+{
+   IpoptProblem                  ipopt_problem;
+   Index                         n_instances;
+   Number*                       x;
+   Number*                       g;
+   Number*                       obj_val;
+   Number*                       mult_g;
+   Number*                       mult_x_L;
+   Number*                       mult_x_U;
+   UserDataPtr*                  user_data;
+   enum ApplicationReturnStatus* status;
+   /** Application whose problem structure is used, or NULL */
+   const Ipopt::IpoptApplication* structure_source;
+#ifdef IPOPT_BATCH_THREADS
+   /** Next instance to be solved */
+   std::atomic<Index>            next;
+#endif
+};
+
+#ifdef IPOPT_BATCH_THREADS
+/** Solves instances of the batch with app until all instances are taken */
+static void solve_batch_instances(
+   BatchData*               data,
+   Ipopt::IpoptApplication* app
+)
+{
+   const Index n = data->ipopt_problem->n;
+   const Index m = data->ipopt_problem->m;
+
+   // the TNLP of this thread, which is reoptimized for all but the first instance
+   Ipopt::SmartPtr<Ipopt::StdInterfaceTNLP> tnlp;
+   for( Index i = data->next++; i < data->n_instances; i = data->next++ )
+   {
+      data->status[i] = ApplicationReturnStatus(
+                           solve_tnlp(data->ipopt_problem, *app, tnlp, data->structure_source,
+                                      data->x + i * n,
+                                      data->g ? data->g + i * m : NULL,
+                                      data->obj_val ? data->obj_val + i : NULL,
+                                      data->mult_g ? data->mult_g + i * m : NULL,
+                                      data->mult_x_L ? data->mult_x_L + i * n : NULL,
+                                      data->mult_x_U ? data->mult_x_U + i * n : NULL,
+                                      data->user_data ? data->user_data[i] : NULL));
+   }
+}
+#endif
+
+Bool IpoptSolveBatch(
+   IpoptProblem                  ipopt_problem,
+   Index                         n_instances,
+   Int                           n_threads,
+   Number*                       x,
+   Number*                       g,
+   Number*                       obj_val,
+   Number*                       mult_g,
+   Number*                       mult_x_L,
+   Number*                       mult_x_U,
+   UserDataPtr*                  user_data,
+   enum ApplicationReturnStatus* status
+)
+{
+   if( n_instances < 0 || !x || !status )
+   {
+      return (Bool) false;
+   }
+   if( n_instances == 0 )
+   {
+      return (Bool) true;
+   }
+
+   const Index n = ipopt_problem->n;
+   const Index m = ipopt_problem->m;
+
+   // The first instance is solved by the application of the problem,
+   // which sets up the problem structure for all other instances.
+   status[0] = solve(ipopt_problem, true, x, g, obj_val, mult_g, mult_x_L, mult_x_U,
+                     user_data ? user_data[0] : NULL);
+
+#ifdef IPOPT_BATCH_THREADS
+   Ipopt::Index num_threads;
+   ipopt_problem->app->Options()->GetIntegerValue("num_threads", num_threads, "");
+   if( n_threads <= 0 )
+   {
+      n_threads = num_threads > 0 ? (Int) num_threads : (Int) std::thread::hardware_concurrency();
+   }
+   if( n_threads > n_instances - 1 )
+   {
+      n_threads = n_instances - 1;
+   }
+
+   if( n_threads > 1 )
+   {
+      BatchData data;
+      data.ipopt_problem = ipopt_problem;
+      data.n_instances = n_instances;
+      data.x = x;
+      data.g = g;
+      data.obj_val = obj_val;
+      data.mult_g = mult_g;
+      data.mult_x_L = mult_x_L;
+      data.mult_x_U = mult_x_U;
+      data.user_data = user_data;
+      data.status = status;
+      data.structure_source = NULL;
+
+      // The problem structure can only be shared if the first instance
+      // has been set up and the TNLP was not changed by the presolve.
+      bool presolve;
+      ipopt_problem->app->Options()->GetBoolValue("presolve", presolve, "");
+      if( Ipopt::IsValid(ipopt_problem->tnlp) && !presolve )
+      {
+         data.structure_source = GetRawPtr(ipopt_problem->app);
+      }
+      data.next = 1;
+
+      // Every thread gets its own application with the options of the
+      // problem, but without output, and the output file is not opened again.
+      std::vector<Ipopt::SmartPtr<Ipopt::IpoptApplication> > apps(n_threads);
+      for( Int t = 0; t < n_threads; ++t )
+      {
+         apps[t] = new Ipopt::IpoptApplication(false);
+         *apps[t]->Options() = *ipopt_problem->app->Options();
+         apps[t]->Options()->SetJournalist(apps[t]->Jnlst());
+         apps[t]->Options()->SetStringValue("output_file", "", true, true);
+         if( num_threads > 0 )
+         {
+            // the concurrent instances share the threads
+            apps[t]->Options()->SetIntegerValue("num_threads", Ipopt::Max(num_threads / n_threads, (Ipopt::Index) 1), true, true);
+         }
+         apps[t]->RethrowNonIpoptException(false);
+         Ipopt::ApplicationReturnStatus retval = apps[t]->Initialize("");
+         if( retval != Ipopt::Solve_Succeeded )
+         {
+            for( Index i = 1; i < n_instances; ++i )
+            {
+               status[i] = ApplicationReturnStatus(retval);
+            }
+            return (Bool) true;
+         }
+      }
+
+      std::vector<std::thread> threads;
+      threads.reserve(n_threads - 1);
+      for( Int t = 1; t < n_threads; ++t )
+      {
+         threads.push_back(std::thread(solve_batch_instances, &data, GetRawPtr(apps[t])));
+      }
+      solve_batch_instances(&data, GetRawPtr(apps[0]));
+      for( size_t t = 0; t < threads.size(); ++t )
+      {
+         threads[t].join();
+      }
+
+      return (Bool) true;
+   }
+#else
+   (void) n_threads;
+#endif
+
+   // solve the remaining instances one after the other by reoptimizing the first one
+   for( Index i = 1; i < n_instances; ++i )
+   {
+      status[i] = solve(ipopt_problem, true,
+                        x + i * n,
+                        g ? g + i * m : NULL,
+                        obj_val ? obj_val + i : NULL,
+                        mult_g ? mult_g + i * m : NULL,
+                        mult_x_L ? mult_x_L + i * n : NULL,
+                        mult_x_U ? mult_x_U + i * n : NULL,
+                        user_data ? user_data[i] : NULL);
+   }
+
+   return (Bool) true;
+}
+
+Index GetIpoptIterationCount(
+   IpoptProblem ipopt_problem
+)
+{
+   Ipopt::SmartPtr<Ipopt::SolveStatistics> stats = ipopt_problem->app->Statistics();
+   if( Ipopt::IsNull(stats) )
+   {
+      return -1;
+   }
+   return stats->IterationCount();
+}
+
+Index GetIpoptWorkCount(
+   IpoptProblem          ipopt_problem,
+   enum IpoptWorkCounter counter,
+   Index*                per_iteration,
+   Index                 n_per_iteration
+)
+{
+   Ipopt::SmartPtr<Ipopt::SolveStatistics> stats = ipopt_problem->app->Statistics();
+   if( Ipopt::IsNull(stats) || (int) counter < 0 || (int) counter >= (int) Ipopt::WorkCounters::NUM_COUNTERS )
+   {
+      return -1;
+   }
+   Ipopt::WorkCounters::Counter work_counter = Ipopt::WorkCounters::Counter(counter);
+
+   if( per_iteration != NULL )
+   {
+      const std::vector<Index>& counts = stats->WorkCountPerIteration(work_counter);
+      for( Index k = 0; k < n_per_iteration; k++ )
+      {
+         per_iteration[k] = k < (Index) counts.size() ? counts[k] : 0;
+      }
+   }
+
+   return stats->WorkCount(work_counter);
 }
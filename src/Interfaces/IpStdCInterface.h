@@ -33,7 +33,11 @@ typedef double Number;
  *
  * We need to make sure that this is identical with what is defined in Common/IpTypes.hpp
  */
+#ifdef IPOPT_INT64
+typedef IPOPT_FORTRAN_INTEGER_TYPE Index;
+#else
 typedef int Index;
+#endif
 
 /** Type for all integers.
  *
@@ -334,6 +338,139 @@ IPOPTLIB_EXPORT IPOPT_EXPORT(enum ApplicationReturnStatus) IpoptSolve(
                                 */
 );
 
+/** Function for changing the bounds of a problem previously defined with CreateIpoptProblem.
+ *
+ *  The given arrays are copied into the IpoptProblem.  A NULL
+ *  pointer leaves the corresponding bounds unchanged.  If the
+ *  problem is solved with IpoptReSolve afterwards, then the set of
+ *  fixed variables and equality constraints, as well as the
+ *  finiteness of the bounds, should not change, since otherwise the
+ *  internal structures cannot be reused.
+ *
+ * @return FALSE, if the bounds could not be changed.
+ */
+IPOPTLIB_EXPORT IPOPT_EXPORT(Bool) SetIpoptProblemBounds(
+   IpoptProblem ipopt_problem,
+   Number*      x_L,           /**< New lower bounds on variables (array of size n, or NULL) */
+   Number*      x_U,           /**< New upper bounds on variables (array of size n, or NULL) */
+   Number*      g_L,           /**< New lower bounds on constraints (array of size m, or NULL) */
+   Number*      g_U            /**< New upper bounds on constraints (array of size m, or NULL) */
+);
+
+/** Function calling the Ipopt optimization algorithm again for a problem
+ * that has been solved before with IpoptSolve or IpoptReSolve.
+ *
+ * The arguments are the same as for IpoptSolve.  In contrast to
+ * IpoptSolve, the internal data structures of the previous solve,
+ * e.g., the adapter of the problem, the algorithm objects, and the
+ * symbolic factorization of the linear solver, are reused, which
+ * corresponds to Ipopt::IpoptApplication::ReOptimizeTNLP.  The
+ * options file is not read again.  New values for the bounds can be
+ * set with SetIpoptProblemBounds, while the sparsity structure has to
+ * stay the same.  To use the given multipliers as a warm start
+ * together with x, set the option warm_start_init_point to yes.
+ *
+ * If the problem has not been solved before, if the scaling or the
+ * intermediate callback have been changed since, or if the previous
+ * solve failed to set up the problem, then this function behaves
+ * like IpoptSolve.
+ *
+ * @return outcome of the optimization procedure (e.g., success, failure etc).
+ */
+IPOPTLIB_EXPORT IPOPT_EXPORT(enum ApplicationReturnStatus) IpoptReSolve(
+   IpoptProblem ipopt_problem,
+   Number*      x,
+   Number*      g,
+   Number*      obj_val,
+   Number*      mult_g,
+   Number*      mult_x_L,
+   Number*      mult_x_U,
+   UserDataPtr  user_data
+);
+
+/** Function solving many instances of a problem previously defined with CreateIpoptProblem.
+ *
+ * The instances share the dimensions, the sparsity structure, the
+ * bounds, the scaling, the options, and the callback functions of the
+ * IpoptProblem.  They differ in the starting points and in the user
+ * data that is passed to the callback functions, so the callbacks can
+ * evaluate a different problem for each instance.  The arrays for
+ * the starting points and the solutions hold the values of the
+ * instances one after the other, e.g., x has length n*n_instances and
+ * the variables of instance i start at x + i*n.
+ *
+ * The first instance is solved as by IpoptReSolve.  The other
+ * instances are solved by n_threads threads, each with its own
+ * IpoptApplication that reoptimizes its TNLP for every further
+ * instance and that takes the problem structure from the first
+ * instance.  The callback functions must then be safe to be called
+ * concurrently for different user data, and only the first instance
+ * prints output.  Threads are only used if Ipopt has been compiled
+ * with C++11 and IPOPT_ATOMIC_REFCOUNT is defined; otherwise, all
+ * instances are solved one after the other by IpoptReSolve.
+ *
+ * @return FALSE, if the input was invalid; the outcome of each
+ *   optimization is returned in status
+ */
+IPOPTLIB_EXPORT IPOPT_EXPORT(Bool) IpoptSolveBatch(
+   IpoptProblem                  ipopt_problem, /**< Problem that defines the instances */
+   Index                         n_instances,   /**< Number of instances */
+   Int                           n_threads,     /**< Number of threads, or a nonpositive value to use option num_threads, if set, or one thread per core */
+   Number*                       x,             /**< Input: Starting points; Output: Optimal solutions (size n*n_instances) */
+   Number*                       g,             /**< Values of constraints at final points (size m*n_instances; output only; ignored if set to NULL) */
+   Number*                       obj_val,       /**< Final values of objective function (size n_instances; output only; ignored if set to NULL) */
+   Number*                       mult_g,        /**< Input: Initial values for the constraint multipliers (only if warm start option is chosen);
+                                                 *  Output: Final multipliers for constraints (size m*n_instances; ignored if set to NULL)
+                                                 */
+   Number*                       mult_x_L,      /**< Input: Initial values for the multipliers for lower variable bounds (only if warm start option is chosen);
+                                                 *  Output: Final multipliers for lower variable bounds (size n*n_instances; ignored if set to NULL)
+                                                 */
+   Number*                       mult_x_U,      /**< Input: Initial values for the multipliers for upper variable bounds (only if warm start option is chosen);
+                                                 *  Output: Final multipliers for upper variable bounds (size n*n_instances; ignored if set to NULL)
+                                                 */
+   UserDataPtr*                  user_data,     /**< Pointers to the user data of the instances (size n_instances; NULL passes NULL to all callbacks) */
+   enum ApplicationReturnStatus* status         /**< Outcome of the optimization of each instance (size n_instances; output only) */
+);
+
+/** Kinds of work counted during a solve, see Ipopt::WorkCounters::Counter */
+enum IpoptWorkCounter
+{
+   IPOPT_FACTORIZATIONS = 0,  /**< Numerical factorizations by the linear solver */
+   IPOPT_INERTIA_CORRECTIONS, /**< Repeated solves of the primal-dual system because of singularity or wrong inertia */
+   IPOPT_BACKSOLVES,          /**< Right hand sides solved by the linear solver */
+   IPOPT_REFINEMENT_STEPS,    /**< Iterative refinement steps for the primal-dual system */
+   IPOPT_SOC_TRIALS,          /**< Second order correction steps tried by the line search */
+   IPOPT_OBJ_EVALS,           /**< Objective function evaluations */
+   IPOPT_CONSTR_EVALS,        /**< Constraint evaluations */
+   IPOPT_OBJ_GRAD_EVALS,      /**< Objective gradient evaluations */
+   IPOPT_CONSTR_JAC_EVALS,    /**< Constraint Jacobian evaluations */
+   IPOPT_HESS_EVALS           /**< Lagrangian Hessian evaluations */
+};
+
+/** Function returning the number of iterations of the last solve of a problem.
+ *
+ * @return the iteration count, or -1 if no statistics of a solve are available
+ */
+IPOPTLIB_EXPORT IPOPT_EXPORT(Index) GetIpoptIterationCount(
+   IpoptProblem ipopt_problem
+);
+
+/** Function returning the amount of work of a kind that was done in the last solve of a problem.
+ *
+ * The counts of the iterations are stored in per_iteration, where
+ * entry k is the work done for iteration k and entry 0 is the work
+ * done for the initialization.  Entries beyond the iteration count
+ * are set to 0.  See also Ipopt::SolveStatistics::WorkCountPerIteration.
+ *
+ * @return the total count, or -1 if no statistics of a solve are available
+ */
+IPOPTLIB_EXPORT IPOPT_EXPORT(Index) GetIpoptWorkCount(
+   IpoptProblem          ipopt_problem,
+   enum IpoptWorkCounter counter,
+   Index*                per_iteration, /**< Output: counts in each iteration (ignored if set to NULL) */
+   Index                 n_per_iteration /**< Length of per_iteration, e.g., the iteration count plus one */
+);
+
 #ifdef __cplusplus
 } /* extern "C" { */
 #endif
@@ -118,6 +118,35 @@ StdInterfaceTNLP::~StdInterfaceTNLP()
    delete[] g_scaling_;
 }
 
+void StdInterfaceTNLP::SetSolveData(
+   const Number* start_x,
+   const Number* start_lam,
+   const Number* start_z_L,
+   const Number* start_z_U,
+   Number*       x_sol,
+   Number*       z_L_sol,
+   Number*       z_U_sol,
+   Number*       g_sol,
+   Number*       lam_sol,
+   Number*       obj_sol,
+   UserDataPtr   user_data
+)
+{
+   ASSERT_EXCEPTION(start_x, INVALID_STDINTERFACE_NLP, "No initial point for the variables provided.");
+
+   start_x_ = start_x;
+   start_lam_ = start_lam;
+   start_z_L_ = start_z_L;
+   start_z_U_ = start_z_U;
+   x_sol_ = x_sol;
+   z_L_sol_ = z_L_sol;
+   z_U_sol_ = z_U_sol;
+   g_sol_ = g_sol;
+   lambda_sol_ = lam_sol;
+   obj_sol_ = obj_sol;
+   user_data_ = user_data;
+}
+
 bool StdInterfaceTNLP::get_nlp_info(
    Index&          n,
    Index&          m,
@@ -72,6 +72,26 @@ public:
    virtual ~StdInterfaceTNLP();
    ///@}
 
+   /** Replaces the starting point, the arrays for the solution, and the user data.
+    *
+    *  This allows to reoptimize this TNLP with ReOptimizeTNLP for a
+    *  new starting point.  As for the constructor, no copies of the
+    *  arrays are made.
+    */
+   void SetSolveData(
+      const Number* start_x,
+      const Number* start_lam,
+      const Number* start_z_L,
+      const Number* start_z_U,
+      Number*       x_sol,
+      Number*       z_L_sol,
+      Number*       z_U_sol,
+      Number*       g_sol,
+      Number*       lam_sol,
+      Number*       obj_sol,
+      UserDataPtr   user_data
+   );
+
    /**@name Methods to gather information about the NLP.
     *
     * These methods are overloaded from TNLP. See TNLP for their more detailed documentation.
@@ -191,6 +191,11 @@ public:
    jboolean using_scaling_parameters;
    jboolean using_LBFGS;
 
+   /// whether the evaluation callbacks with direct buffers are used
+   jboolean using_direct_buffers;
+   /// class of the solver, valid during OptimizeTNLP
+   jclass solver_class;
+
    SmartPtr<IpoptApplication> application;
 
    // the callback methods
@@ -206,7 +211,81 @@ public:
    jmethodID get_number_of_nonlinear_variables_;
    jmethodID get_list_of_nonlinear_variables_;
 
+   // the callback methods with direct buffers
+   jmethodID eval_f_direct_;
+   jmethodID eval_grad_f_direct_;
+   jmethodID eval_g_direct_;
+   jmethodID eval_jac_g_direct_;
+   jmethodID eval_h_direct_;
+
+   // the methods to view a ByteBuffer as DoubleBuffer and IntBuffer
+   jmethodID as_double_buffer_;
+   jmethodID as_int_buffer_;
+
+   /** A Java buffer that views native memory */
+   struct DirectBuffer
+   {
+      /// global reference to the DoubleBuffer or IntBuffer, or NULL
+      jobject buffer;
+      /// viewed memory
+      const void* ptr;
+      /// number of elements
+      Index len;
+   };
+
+   // the direct buffers for the callback arguments, which are kept as long as Ipopt passes the same memory
+   DirectBuffer x_buf;
+   DirectBuffer lambda_buf;
+   DirectBuffer f_buf;
+   DirectBuffer grad_f_buf;
+   DirectBuffer g_buf;
+   DirectBuffer jac_g_buf;
+   DirectBuffer hess_buf;
+   DirectBuffer iRow_buf;
+   DirectBuffer jCol_buf;
+
+   /// memory for the objective value that is viewed by f_buf
+   Number f_value;
+
+   /** Returns a DoubleBuffer that views len values at ptr, or NULL if ptr is NULL.
+    *
+    *  The buffer of buf is reused if it views the same memory.
+    */
+   jobject DirectDoubleBuffer(
+      DirectBuffer& buf,
+      const Number* ptr,
+      Index         len
+   )
+   {
+      return DirectView(buf, ptr, len, sizeof(Number), as_double_buffer_);
+   }
+
+   /** Returns an IntBuffer that views len values at ptr, or NULL if ptr is NULL. */
+   jobject DirectIntBuffer(
+      DirectBuffer& buf,
+      const Index*  ptr,
+      Index         len
+   )
+   {
+      return DirectView(buf, ptr, len, sizeof(Index), as_int_buffer_);
+   }
+
+   /** Frees the Java buffers of all direct buffers */
+   void ReleaseDirectBuffers();
+
 private:
+   jobject DirectView(
+      DirectBuffer& buf,
+      const void*   ptr,
+      Index         len,
+      size_t        elemsize,
+      jmethodID     as_buffer
+   );
+
+   void ReleaseDirectBuffer(
+      DirectBuffer& buf
+   );
+
    Jipopt(const Jipopt&);
    Jipopt& operator=(const Jipopt&);
 };
@@ -223,8 +302,12 @@ Jipopt::Jipopt(
    : env(env_), solver(solver_), n(n_), m(m_), nele_jac(nele_jac_), nele_hess(nele_hess_), index_style(index_style_),
      mult_gj(NULL), mult_x_Lj(NULL), mult_x_Uj(NULL), xj(NULL), fj(NULL), grad_fj(NULL),
      gj(NULL), jac_gj(NULL), hessj(NULL),
-     using_scaling_parameters(false), using_LBFGS(false)
+     using_scaling_parameters(false), using_LBFGS(false),
+     using_direct_buffers(false), solver_class(NULL), f_value(0.)
 {
+   DirectBuffer empty = { NULL, NULL, 0 };
+   x_buf = lambda_buf = f_buf = grad_f_buf = g_buf = jac_g_buf = hess_buf = iRow_buf = jCol_buf = empty;
+
    application = new IpoptApplication();
    application->RethrowNonIpoptException(false);
 
@@ -243,10 +326,21 @@ Jipopt::Jipopt(
    get_number_of_nonlinear_variables_ = env->GetMethodID(solverCls, "get_number_of_nonlinear_variables", "()I");
    get_list_of_nonlinear_variables_   = env->GetMethodID(solverCls, "get_list_of_nonlinear_variables", "(I[I)Z");
 
+   eval_f_direct_      = env->GetMethodID(solverCls, "eval_f", "(ILjava/nio/DoubleBuffer;ZLjava/nio/DoubleBuffer;)Z");
+   eval_grad_f_direct_ = env->GetMethodID(solverCls, "eval_grad_f", "(ILjava/nio/DoubleBuffer;ZLjava/nio/DoubleBuffer;)Z");
+   eval_g_direct_      = env->GetMethodID(solverCls, "eval_g", "(ILjava/nio/DoubleBuffer;ZILjava/nio/DoubleBuffer;)Z");
+   eval_jac_g_direct_  = env->GetMethodID(solverCls, "eval_jac_g", "(ILjava/nio/DoubleBuffer;ZIILjava/nio/IntBuffer;Ljava/nio/IntBuffer;Ljava/nio/DoubleBuffer;)Z");
+   eval_h_direct_      = env->GetMethodID(solverCls, "eval_h", "(ILjava/nio/DoubleBuffer;ZDILjava/nio/DoubleBuffer;ZILjava/nio/IntBuffer;Ljava/nio/IntBuffer;Ljava/nio/DoubleBuffer;)Z");
+   as_double_buffer_   = env->GetStaticMethodID(solverCls, "asDoubleBuffer", "(Ljava/nio/ByteBuffer;)Ljava/nio/DoubleBuffer;");
+   as_int_buffer_      = env->GetStaticMethodID(solverCls, "asIntBuffer", "(Ljava/nio/ByteBuffer;)Ljava/nio/IntBuffer;");
+
    if( get_bounds_info_ == 0 || get_starting_point_ == 0 || eval_f_ == 0
        || eval_grad_f_ == 0 || eval_g_ == 0 || eval_jac_g_ == 0 || eval_h_ == 0
        || get_scaling_parameters_ == 0 || get_number_of_nonlinear_variables_ == 0
-       || get_list_of_nonlinear_variables_ == 0 )
+       || get_list_of_nonlinear_variables_ == 0
+       || eval_f_direct_ == 0 || eval_grad_f_direct_ == 0 || eval_g_direct_ == 0
+       || eval_jac_g_direct_ == 0 || eval_h_direct_ == 0
+       || as_double_buffer_ == 0 || as_int_buffer_ == 0 )
    {
       std::cerr << "Expected callback methods missing on JIpopt.java" << std::endl;
    }
@@ -261,6 +355,79 @@ Jipopt::Jipopt(
    assert(get_scaling_parameters_ != 0);
    assert(get_number_of_nonlinear_variables_ != 0);
    assert(get_list_of_nonlinear_variables_   != 0);
+   assert(eval_f_direct_      != 0);
+   assert(eval_grad_f_direct_ != 0);
+   assert(eval_g_direct_      != 0);
+   assert(eval_jac_g_direct_  != 0);
+   assert(eval_h_direct_      != 0);
+   assert(as_double_buffer_   != 0);
+   assert(as_int_buffer_      != 0);
+}
+
+jobject Jipopt::DirectView(
+   DirectBuffer& buf,
+   const void*   ptr,
+   Index         len,
+   size_t        elemsize,
+   jmethodID     as_buffer
+)
+{
+   if( ptr == NULL )
+   {
+      return NULL;
+   }
+
+   if( buf.buffer != NULL && buf.ptr == ptr && buf.len == len )
+   {
+      return buf.buffer;
+   }
+
+   ReleaseDirectBuffer(buf);
+
+   jobject bytes = env->NewDirectByteBuffer(const_cast<void*>(ptr), (jlong) len * (jlong) elemsize);
+   if( bytes == NULL )
+   {
+      return NULL;
+   }
+   jobject view = env->CallStaticObjectMethod(solver_class, as_buffer, bytes);
+   env->DeleteLocalRef(bytes);
+   if( view == NULL )
+   {
+      return NULL;
+   }
+
+   buf.buffer = env->NewGlobalRef(view);
+   buf.ptr = ptr;
+   buf.len = len;
+   env->DeleteLocalRef(view);
+
+   return buf.buffer;
+}
+
+void Jipopt::ReleaseDirectBuffer(
+   DirectBuffer& buf
+)
+{
+   if( buf.buffer != NULL )
+   {
+      env->DeleteGlobalRef(buf.buffer);
+   }
+   buf.buffer = NULL;
+   buf.ptr = NULL;
+   buf.len = 0;
+}
+
+void Jipopt::ReleaseDirectBuffers()
+{
+   ReleaseDirectBuffer(x_buf);
+   ReleaseDirectBuffer(lambda_buf);
+   ReleaseDirectBuffer(f_buf);
+   ReleaseDirectBuffer(grad_f_buf);
+   ReleaseDirectBuffer(g_buf);
+   ReleaseDirectBuffer(jac_g_buf);
+   ReleaseDirectBuffer(hess_buf);
+   ReleaseDirectBuffer(iRow_buf);
+   ReleaseDirectBuffer(jCol_buf);
 }
 
 bool Jipopt::get_nlp_info(
@@ -364,6 +531,18 @@ bool Jipopt::eval_f(
    bool          new_x,
    Number&       obj_value)
 {
+   if( using_direct_buffers )
+   {
+      jobject x_b = DirectDoubleBuffer(x_buf, x, n);
+      jobject f_b = DirectDoubleBuffer(f_buf, &f_value, 1);
+      if( x_b == NULL || f_b == NULL || !env->CallBooleanMethod(solver, eval_f_direct_, n, x_b, (jboolean) new_x, f_b) )
+      {
+         return false;
+      }
+      obj_value = f_value;
+      return true;
+   }
+
    /* Copy the native double x to the Java double array xj, if new values */
    if( new_x )
    {
@@ -389,6 +568,13 @@ bool Jipopt::eval_grad_f(
    bool          new_x,
    Number*       grad_f)
 {
+   if( using_direct_buffers )
+   {
+      jobject x_b = DirectDoubleBuffer(x_buf, x, n);
+      jobject grad_f_b = DirectDoubleBuffer(grad_f_buf, grad_f, n);
+      return x_b != NULL && grad_f_b != NULL && env->CallBooleanMethod(solver, eval_grad_f_direct_, n, x_b, (jboolean) new_x, grad_f_b);
+   }
+
    /* Copy the native double x to the Java double array xj, if new values */
    if( new_x )
    {
@@ -414,6 +600,13 @@ bool Jipopt::eval_g(
    Index         m,
    Number*       g)
 {
+   if( using_direct_buffers )
+   {
+      jobject x_b = DirectDoubleBuffer(x_buf, x, n);
+      jobject g_b = DirectDoubleBuffer(g_buf, g, m);
+      return x_b != NULL && g_b != NULL && env->CallBooleanMethod(solver, eval_g_direct_, n, x_b, (jboolean) new_x, m, g_b);
+   }
+
    /* Copy the native double x to the Java double array xj, if new values */
    if( new_x )
    {
@@ -443,6 +636,27 @@ bool Jipopt::eval_jac_g(
    Index*        jCol,
    Number*       jac_g)
 {
+   if( using_direct_buffers && sizeof(jint) == sizeof(Index) )
+   {
+      jobject x_b = DirectDoubleBuffer(x_buf, x, n);
+      jobject iRow_b = DirectIntBuffer(iRow_buf, iRow, nele_jac);
+      jobject jCol_b = DirectIntBuffer(jCol_buf, jCol, nele_jac);
+      jobject jac_g_b = DirectDoubleBuffer(jac_g_buf, jac_g, nele_jac);
+      if( (x != NULL && x_b == NULL) || (iRow != NULL && iRow_b == NULL) || (jCol != NULL && jCol_b == NULL)
+          || (jac_g != NULL && jac_g_b == NULL) )
+      {
+         return false;
+      }
+      bool retval = env->CallBooleanMethod(solver, eval_jac_g_direct_, n, x_b, (jboolean) new_x, m, nele_jac, iRow_b, jCol_b, jac_g_b);
+      if( iRow != NULL )
+      {
+         // the structure is only requested once, so the memory of Ipopt is not viewed longer than necessary
+         ReleaseDirectBuffer(iRow_buf);
+         ReleaseDirectBuffer(jCol_buf);
+      }
+      return retval;
+   }
+
    // Copy the native double x to the Java double array xj, if new values
    if( new_x && x != NULL )
    {
@@ -514,6 +728,27 @@ bool Jipopt::eval_h(
    Index*        jCol,
    Number*       hess)
 {
+   if( using_direct_buffers && sizeof(jint) == sizeof(Index) )
+   {
+      jobject x_b = DirectDoubleBuffer(x_buf, x, n);
+      jobject lambda_b = DirectDoubleBuffer(lambda_buf, lambda, m);
+      jobject iRow_b = DirectIntBuffer(iRow_buf, iRow, nele_hess);
+      jobject jCol_b = DirectIntBuffer(jCol_buf, jCol, nele_hess);
+      jobject hess_b = DirectDoubleBuffer(hess_buf, hess, nele_hess);
+      if( (x != NULL && x_b == NULL) || (lambda != NULL && m > 0 && lambda_b == NULL) || (iRow != NULL && iRow_b == NULL)
+          || (jCol != NULL && jCol_b == NULL) || (hess != NULL && hess_b == NULL) )
+      {
+         return false;
+      }
+      bool retval = env->CallBooleanMethod(solver, eval_h_direct_, n, x_b, (jboolean) new_x, obj_factor, m, lambda_b, (jboolean) new_lambda, nele_hess, iRow_b, jCol_b, hess_b);
+      if( iRow != NULL )
+      {
+         ReleaseDirectBuffer(iRow_buf);
+         ReleaseDirectBuffer(jCol_buf);
+      }
+      return retval;
+   }
+
    /* Copy the native double x to the Java double array xj, if new values */
    if( new_x && x != NULL )
    {
@@ -760,7 +995,8 @@ extern "C"
       jdoubleArray mult_x_Uj,
       jdoubleArray callback_grad_f,
       jdoubleArray callback_jac_g,
-      jdoubleArray callback_hess)
+      jdoubleArray callback_hess,
+      jboolean     direct_buffers)
    {
       Jipopt* problem = GetRawPtr(*(SmartPtr<Jipopt>*) pipopt);
 
@@ -778,6 +1014,9 @@ extern "C"
       problem->jac_gj    = callback_jac_g;
       problem->hessj     = callback_hess;
 
+      problem->using_direct_buffers = direct_buffers;
+      problem->solver_class = env->GetObjectClass(obj_this);
+
       ApplicationReturnStatus status;
 
       status = problem->application->Initialize();
@@ -791,6 +1030,10 @@ extern "C"
       /* solve the problem */
       status = problem->application->OptimizeTNLP(problem);
 
+      /* the buffers view memory of Ipopt, which may be freed after the solve */
+      problem->ReleaseDirectBuffers();
+      problem->solver_class = NULL;
+
       return (jint) status;
    }
 
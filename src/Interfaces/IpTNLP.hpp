@@ -253,11 +253,14 @@ public:
 
    /** Method to request the constraints linearity.
     *
-    * This method is never called by \Ipopt, but is used by Bonmin
-    * to get information about which constraints are linear.
+    * This method is used by Bonmin to get information about which
+    * constraints are linear.
     * \Ipopt passes the array const_types of size m, which should be filled
     * with the appropriate linearity type of the constraints
     * (TNLP::LINEAR or TNLP::NON_LINEAR).
+    * If all equality constraints or all inequality constraints are
+    * declared linear, \Ipopt evaluates their Jacobian only once, as
+    * if the option jac_c_constant or jac_d_constant is set to yes.
     *
     * The default implementation just returns false and does not fill the array.
     */
@@ -653,6 +656,17 @@ public:
     * tnlp_adapter->ResortG(*ip_cq->curr_compl_s_L(), ...)
     * tnlp_adapter->ResortG(*ip_cq->curr_compl_s_U(), ...)
     * \endcode
+    *
+    * If only a few entries are needed, then TNLPAdapter::GetCurrIterateEntries
+    * resorts and unscales only these entries of \f$x\f$, \f$z_L\f$, \f$z_U\f$,
+    * \f$g(x)\f$, and \f$\lambda\f$, e.g.,
+    * \code
+    * Ipopt::Index idx[2] = { 3, 17 };
+    * double primals[2];
+    * tnlp_adapter->GetCurrIterateEntries(ip_data, ip_cq, false, 2, idx, primals, NULL, NULL,
+    *                                     0, NULL, NULL, NULL);
+    * \endcode
+    * The cost of this does not depend on the size of the problem.
     */
    // [TNLP_intermediate_callback]
    virtual bool intermediate_callback(
@@ -696,6 +710,11 @@ public:
     *  methods are call by \Ipopt if the \ref QUASI_NEWTON "quasi-Newton approximation"
     *  is selected.
     *
+    *  If the option hessian_approximation_exact_part is set to "yes",
+    *  eval_h returns the Hessian of the part of the Lagrangian that is
+    *  cheap to differentiate, and only the remaining part is approximated
+    *  in the space of these variables.
+    *
     * @{
     */
 
@@ -743,6 +762,644 @@ public:
    }
    ///@}
 
+   /** @name Method for matrix-free second derivatives.
+    *
+    *  If the option hessian_approximation is set to "matrix-free", then
+    *  \Ipopt does not call eval_h, but only requires products of the
+    *  Hessian of the Lagrangian with vectors.  The linear systems are
+    *  then solved by an iterative method.
+    *
+    * @{
+    */
+
+   /** Method to request the product of the Hessian of the Lagrangian with a vector.
+    *
+    *  The Hessian is the same as for TNLP::eval_h, but instead of its
+    *  nonzero elements, only the product \f$ hv = (\sigma_f \nabla^2 f(x_k) + \sum_{i=1}^m\lambda_i\nabla^2 g_i(x_k)) v \f$
+    *  is requested.
+    *
+    *  @param n          (in) the number of variables \f$x\f$ in the problem
+    *  @param x          (in) the values for the primal variables \f$x\f$ at which the Hessian is to be evaluated
+    *  @param new_x      (in) as for TNLP::eval_h
+    *  @param obj_factor (in) factor \f$\sigma_f\f$ in front of the objective term in the Hessian
+    *  @param m          (in) the number of constraints \f$g(x)\f$ in the problem
+    *  @param lambda     (in) the values for the constraint multipliers \f$\lambda\f$ at which the Hessian is to be evaluated
+    *  @param new_lambda (in) as for TNLP::eval_h
+    *  @param v          (in) array of length n with the vector that the Hessian is multiplied with
+    *  @param hv         (out) array of length n to store the product of the Hessian with v
+    *
+    *  @return true if success, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_eval_h_times_vec]
+   virtual bool eval_h_times_vec(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      const Number* v,
+      Number*       hv
+   )
+   // [TNLP_eval_h_times_vec]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) obj_factor;
+      (void) m;
+      (void) lambda;
+      (void) new_lambda;
+      (void) v;
+      (void) hv;
+      return false;
+   }
+   ///@}
+
+   /** @name Methods for a partitioned quasi-Newton approximation.
+    *
+    *  If the option hessian_approximation is set to "partitioned", then
+    *  \Ipopt does not call eval_h.  Instead, the Lagrangian
+    *  \f$\sigma_f f(x) + \sum_{i=1}^m\lambda_i g_i(x)\f$ is assumed to be
+    *  the sum of element functions, each of which depends only on a few
+    *  variables, and the Hessian of each element function is
+    *  approximated by a small dense quasi-Newton matrix.  The
+    *  approximation of the Hessian of the Lagrangian is then sparse.
+    *
+    * @{
+    */
+
+   /** Method to request the number of element functions.
+    *
+    *  @param n_elements   (out) the number of element functions
+    *  @param nnz_elements (out) the total number of variables of all element functions
+    *
+    *  @return true if the Lagrangian is given as a sum of element functions, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_get_element_functions_info]
+   virtual bool get_element_functions_info(
+      Index& n_elements,
+      Index& nnz_elements
+   )
+   // [TNLP_get_element_functions_info]
+   {
+      (void) n_elements;
+      (void) nnz_elements;
+      return false;
+   }
+
+   /** Method to request the variables of the element functions.
+    *
+    *  The variables of element function e are elem_vars[elem_start[e]],
+    *  ..., elem_vars[elem_start[e+1]-1], where elem_start[0] = 0 and
+    *  elem_start[n_elements] = nnz_elements.  The indices of the
+    *  variables are counted starting with 1 in the FORTRAN_STYLE,
+    *  and 0 for the C_STYLE.  A variable must not appear twice in the
+    *  same element function.
+    *
+    *  @param n_elements   (in) the number of element functions, as returned by get_element_functions_info
+    *  @param nnz_elements (in) the total number of variables of all element functions
+    *  @param elem_start   (out) array of length n_elements+1 with the start of each element function in elem_vars
+    *  @param elem_vars    (out) array of length nnz_elements with the variables of the element functions
+    *
+    *  @return true if success, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_get_element_functions_structure]
+   virtual bool get_element_functions_structure(
+      Index  n_elements,
+      Index  nnz_elements,
+      Index* elem_start,
+      Index* elem_vars
+   )
+   // [TNLP_get_element_functions_structure]
+   {
+      (void) n_elements;
+      (void) nnz_elements;
+      (void) elem_start;
+      (void) elem_vars;
+      return false;
+   }
+
+   /** Method to request the gradients of the element functions.
+    *
+    *  values[k] is the derivative of the element function e with respect
+    *  to the variable elem_vars[k], where elem_start[e] <= k < elem_start[e+1].
+    *  The sum of the element functions has to be the Lagrangian for the
+    *  given obj_factor and lambda.
+    *
+    *  @param n            (in) the number of variables \f$x\f$ in the problem
+    *  @param x            (in) the values for the primal variables \f$x\f$ at which the gradients are to be evaluated
+    *  @param new_x        (in) as for TNLP::eval_h
+    *  @param obj_factor   (in) factor \f$\sigma_f\f$ in front of the objective term in the Lagrangian
+    *  @param m            (in) the number of constraints \f$g(x)\f$ in the problem
+    *  @param lambda       (in) the values for the constraint multipliers \f$\lambda\f$ in the Lagrangian
+    *  @param new_lambda   (in) as for TNLP::eval_h
+    *  @param nnz_elements (in) the total number of variables of all element functions
+    *  @param values       (out) array of length nnz_elements to store the gradients of the element functions
+    *
+    *  @return true if success, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_eval_element_gradients]
+   virtual bool eval_element_gradients(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      Index         nnz_elements,
+      Number*       values
+   )
+   // [TNLP_eval_element_gradients]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) obj_factor;
+      (void) m;
+      (void) lambda;
+      (void) new_lambda;
+      (void) nnz_elements;
+      (void) values;
+      return false;
+   }
+   ///@}
+
+   /** @name Methods for the Hessian by components.
+    *
+    *  If the Hessian of the Lagrangian is evaluated by eval_h, all
+    *  second derivatives need to be recomputed whenever the
+    *  multipliers change, even if x does not.  A TNLP can instead
+    *  provide the Hessians of the objective and of the constraints
+    *  $
+abla^2 f(x)$ and $
+abla^2 g_i(x)$ separately.  \Ipopt
+    *  then evaluates them once for each x and forms
+    *  $\sigma_f 
+abla^2 f(x) + \sum_{i=1}^m\lambda_i
+abla^2 g_i(x)$
+    *  itself, in particular when only the multipliers changed, e.g., in
+    *  the restoration phase or after a reset of the multipliers.
+    *
+    *  The sparsity structure of the Hessian of the Lagrangian is still
+    *  obtained from eval_h.  These methods are only used if
+    *  hessian_approximation is "exact".
+    *
+    * @{
+    */
+
+   /** Method to request the number of nonzeros of all Hessian components.
+    *
+    *  @param nnz_h_comp (out) the total number of nonzeros of the Hessians of the objective and all constraints
+    *
+    *  @return true if the Hessian is provided by components, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_get_h_components_info]
+   virtual bool get_h_components_info(
+      Index& nnz_h_comp
+   )
+   // [TNLP_get_h_components_info]
+   {
+      (void) nnz_h_comp;
+      return false;
+   }
+
+   /** Method to request the structure of the Hessian components.
+    *
+    *  The k-th nonzero of the components belongs to the Hessian of the
+    *  objective function if comp[k] is -1, and to the Hessian of
+    *  constraint comp[k] otherwise.  It contributes to the entry pos[k]
+    *  of the values array of eval_h.  Constraints and positions are
+    *  counted starting with 1 in the FORTRAN_STYLE, and 0 for the
+    *  C_STYLE.  Several nonzeros of the components may contribute to
+    *  the same entry of the Hessian of the Lagrangian.
+    *
+    *  @param nele_hess  (in) the number of nonzero elements in the Hessian of the Lagrangian, as in eval_h
+    *  @param nnz_h_comp (in) the total number of nonzeros of all components, as returned by get_h_components_info
+    *  @param comp       (out) array of length nnz_h_comp with the component of each nonzero
+    *  @param pos        (out) array of length nnz_h_comp with the position of each nonzero in the Hessian of the Lagrangian
+    *
+    *  @return true if success, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_get_h_components_structure]
+   virtual bool get_h_components_structure(
+      Index  nele_hess,
+      Index  nnz_h_comp,
+      Index* comp,
+      Index* pos
+   )
+   // [TNLP_get_h_components_structure]
+   {
+      (void) nele_hess;
+      (void) nnz_h_comp;
+      (void) comp;
+      (void) pos;
+      return false;
+   }
+
+   /** Method to request the values of the Hessian components.
+    *
+    *  values[k] is the value of the k-th nonzero of the components, as
+    *  given by get_h_components_structure.  Since the components do
+    *  not depend on the multipliers, this is called at most once for
+    *  each x.
+    *
+    *  @param n          (in) the number of variables $x$ in the problem
+    *  @param x          (in) the values for the primal variables $x$ at which the Hessians are to be evaluated
+    *  @param new_x      (in) false if any evaluation method was previously called with the same values in x, true otherwise
+    *  @param nnz_h_comp (in) the total number of nonzeros of all components
+    *  @param values     (out) array of length nnz_h_comp to store the values of the nonzeros of the components
+    *
+    *  @return true if success, false otherwise.
+    *
+    *  The default implementation returns false.
+    */
+   // [TNLP_eval_h_components]
+   virtual bool eval_h_components(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         nnz_h_comp,
+      Number*       values
+   )
+   // [TNLP_eval_h_components]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) nnz_h_comp;
+      (void) values;
+      return false;
+   }
+   ///@}
+
+   /** @name Methods for concurrent evaluation.
+    *
+    *  By default, \Ipopt calls the evaluation methods (`eval_*`) one
+    *  after the other.  With the following methods, a TNLP can declare
+    *  that they may be called concurrently from several threads, and
+    *  provide variants of eval_g and eval_jac_g that evaluate only a
+    *  range of constraints and a variant of eval_h that evaluates only
+    *  a block of Hessian entries.  \Ipopt makes use of this only if it
+    *  has been build with OpenMP support.
+    *
+    * @{
+    */
+
+   /** Degree to which the evaluation methods can be called concurrently. */
+   enum EvaluationConcurrency
+   {
+      CONCURRENCY_NONE = 0,  /**< the evaluation methods must not be called concurrently */
+      CONCURRENCY_REENTRANT, /**< the evaluation methods can be called concurrently */
+      CONCURRENCY_ROW_RANGES /**< as CONCURRENCY_REENTRANT, and eval_g_rows and eval_jac_g_rows are implemented */
+   };
+
+   /** Return to which degree the evaluation methods can be called concurrently.
+    *
+    *  If CONCURRENCY_REENTRANT or CONCURRENCY_ROW_RANGES is returned,
+    *  then eval_f, eval_g, eval_jac_g, eval_h, eval_g_rows,
+    *  eval_jac_g_rows, and eval_h_block may be called at the same time from different
+    *  threads, for the same or for different values of x.  In this case,
+    *  the methods must not rely on new_x or new_lambda to share data
+    *  between concurrent calls.  Whether \Ipopt evaluates concurrently is
+    *  further controlled by options, e.g., concurrent_derivative_evaluation.
+    *
+    *  The default implementation returns CONCURRENCY_NONE.
+    */
+   // [TNLP_get_evaluation_concurrency]
+   virtual EvaluationConcurrency get_evaluation_concurrency()
+   // [TNLP_get_evaluation_concurrency]
+   {
+      return CONCURRENCY_NONE;
+   }
+
+   /** Method to request the values of a range of constraints.
+    *
+    *  This method is only called if get_evaluation_concurrency returns
+    *  CONCURRENCY_ROW_RANGES.  \Ipopt may then evaluate the constraints
+    *  by calling this method concurrently for disjoint ranges of
+    *  constraints instead of calling eval_g.
+    *
+    *  @param n         (in) the number of variables \f$x\f$ in the problem
+    *  @param x         (in) the values for the primal variables \f$x\f$ at which the constraint functions are to be evaluated
+    *  @param new_x     (in) as for TNLP::eval_g
+    *  @param m         (in) the number of constraints \f$g(x)\f$ in the problem
+    *  @param first_row (in) first constraint to evaluate, counted from 0 regardless of the index style
+    *  @param last_row  (in) one past the last constraint to evaluate
+    *  @param g         (out) array of length m; only the entries first_row, ..., last_row-1 must be set
+    *
+    *  @return true if success, false otherwise.
+    */
+   // [TNLP_eval_g_rows]
+   virtual bool eval_g_rows(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         first_row,
+      Index         last_row,
+      Number*       g
+   )
+   // [TNLP_eval_g_rows]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) m;
+      (void) first_row;
+      (void) last_row;
+      (void) g;
+      return false;
+   }
+
+   /** Method to request the values of the Jacobian entries in a range of rows.
+    *
+    *  This method is only called if get_evaluation_concurrency returns
+    *  CONCURRENCY_ROW_RANGES.  \Ipopt may then evaluate the Jacobian
+    *  by calling this method concurrently for disjoint ranges of rows
+    *  instead of calling eval_jac_g.
+    *
+    *  @param n         (in) the number of variables \f$x\f$ in the problem
+    *  @param x         (in) the values for the primal variables \f$x\f$ at which the constraint Jacobian is to be evaluated
+    *  @param new_x     (in) as for TNLP::eval_jac_g
+    *  @param m         (in) the number of constraints \f$g(x)\f$ in the problem
+    *  @param first_row (in) first row to evaluate, counted from 0 regardless of the index style
+    *  @param last_row  (in) one past the last row to evaluate
+    *  @param nele_jac  (in) the number of nonzero elements in the Jacobian
+    *  @param values    (out) array of length nele_jac; only the entries that belong to the rows first_row, ..., last_row-1
+    *                   in the sparsity structure given by eval_jac_g must be set
+    *
+    *  @return true if success, false otherwise.
+    */
+   // [TNLP_eval_jac_g_rows]
+   virtual bool eval_jac_g_rows(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         first_row,
+      Index         last_row,
+      Index         nele_jac,
+      Number*       values
+   )
+   // [TNLP_eval_jac_g_rows]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) m;
+      (void) first_row;
+      (void) last_row;
+      (void) nele_jac;
+      (void) values;
+      return false;
+   }
+
+   /** Return the number of Jacobian entries whose values can change between evaluations.
+    *
+    *  If a nonnegative number smaller than the number of nonzeros of
+    *  the Jacobian is returned, \Ipopt calls
+    *  get_list_of_varying_jac_g_entries to obtain the positions of these
+    *  entries.  During an optimization, \Ipopt then evaluates the full
+    *  Jacobian by eval_jac_g only once and keeps the values of all other
+    *  entries.  For later evaluations, it calls eval_jac_g_varying,
+    *  which only computes the values of the varying entries, and copies
+    *  only these entries.  This is useful if, e.g., most constraints are
+    *  linear, or the Jacobian of the nonlinear constraints has many
+    *  constant entries.
+    *
+    *  The default implementation returns -1, i.e., all entries can change.
+    */
+   // [TNLP_get_number_of_varying_jac_g_entries]
+   virtual Index get_number_of_varying_jac_g_entries()
+   // [TNLP_get_number_of_varying_jac_g_entries]
+   {
+      return -1;
+   }
+
+   /** Return the positions of the Jacobian entries whose values can change between evaluations.
+    *
+    *  This method is called only if get_number_of_varying_jac_g_entries
+    *  returned a nonnegative number, which is given in num_varying.
+    *
+    *  @param nele_jac    (in) the number of nonzero elements in the Jacobian
+    *  @param num_varying (in) the number of varying entries
+    *  @param pos_varying (out) array of length num_varying to store the positions of the varying entries
+    *                     in the sparsity structure given by eval_jac_g, counted from 0 regardless of the index style
+    *
+    *  @return true if success; if false, all entries are assumed to change
+    */
+   // [TNLP_get_list_of_varying_jac_g_entries]
+   virtual bool get_list_of_varying_jac_g_entries(
+      Index  nele_jac,
+      Index  num_varying,
+      Index* pos_varying
+   )
+   // [TNLP_get_list_of_varying_jac_g_entries]
+   {
+      (void) nele_jac;
+      (void) num_varying;
+      (void) pos_varying;
+      return false;
+   }
+
+   /** Method to request the values of the varying Jacobian entries.
+    *
+    *  This method is only called if get_list_of_varying_jac_g_entries
+    *  succeeded.  If it returns false, \Ipopt calls eval_jac_g instead.
+    *
+    *  @param n           (in) the number of variables \f$x\f$ in the problem
+    *  @param x           (in) the values for the primal variables \f$x\f$ at which the constraint Jacobian is to be evaluated
+    *  @param new_x       (in) as for TNLP::eval_jac_g
+    *  @param m           (in) the number of constraints \f$g(x)\f$ in the problem
+    *  @param num_varying (in) the number of varying entries
+    *  @param values      (out) array of length num_varying to store the values of the varying entries,
+    *                     in the order of get_list_of_varying_jac_g_entries
+    *
+    *  @return true if success, false otherwise.
+    */
+   // [TNLP_eval_jac_g_varying]
+   virtual bool eval_jac_g_varying(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         num_varying,
+      Number*       values
+   )
+   // [TNLP_eval_jac_g_varying]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) m;
+      (void) num_varying;
+      (void) values;
+      return false;
+   }
+
+   /** Return the number of blocks into which the Hessian entries are partitioned for eval_h_block.
+    *
+    *  If a number larger than 1 is returned and get_evaluation_concurrency
+    *  does not return CONCURRENCY_NONE, then \Ipopt calls get_hessian_blocks
+    *  to obtain the blocks and may evaluate the Hessian by calling eval_h_block
+    *  concurrently for all blocks instead of calling eval_h.  This is useful
+    *  if the Lagrangian is separable, e.g., into scenarios or time stages.
+    *
+    *  The default implementation returns 0, i.e., the Hessian is always evaluated by eval_h.
+    */
+   // [TNLP_get_number_of_hessian_blocks]
+   virtual Index get_number_of_hessian_blocks()
+   // [TNLP_get_number_of_hessian_blocks]
+   {
+      return 0;
+   }
+
+   /** Return the partition of the Hessian entries into blocks.
+    *
+    *  The entries of block k are those at the positions block_start[k], ...,
+    *  block_start[k+1]-1 in the sparsity structure given by eval_h, that is,
+    *  the blocks are contiguous ranges in this structure.
+    *
+    *  @param num_blocks  (in) the number of blocks, as returned by get_number_of_hessian_blocks
+    *  @param nele_hess   (in) the number of nonzero elements in the Hessian
+    *  @param block_start (out) array of length num_blocks+1 to store the start of each block,
+    *                     with block_start[0] = 0 and block_start[num_blocks] = nele_hess
+    *
+    *  @return true if success, false otherwise.
+    */
+   // [TNLP_get_hessian_blocks]
+   virtual bool get_hessian_blocks(
+      Index  num_blocks,
+      Index  nele_hess,
+      Index* block_start
+   )
+   // [TNLP_get_hessian_blocks]
+   {
+      (void) num_blocks;
+      (void) nele_hess;
+      (void) block_start;
+      return false;
+   }
+
+   /** Method to request the values of the Hessian entries in one block.
+    *
+    *  The arguments are as for TNLP::eval_h when the values are requested,
+    *  except for the number of the block.
+    *
+    *  @param block  (in) the number of the block, between 0 and num_blocks-1
+    *  @param values (out) array of length nele_hess; only the entries of the given block must be set
+    *
+    *  @return true if success, false otherwise.
+    */
+   // [TNLP_eval_h_block]
+   virtual bool eval_h_block(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      Index         block,
+      Index         nele_hess,
+      Number*       values
+   )
+   // [TNLP_eval_h_block]
+   {
+      (void) n;
+      (void) x;
+      (void) new_x;
+      (void) obj_factor;
+      (void) m;
+      (void) lambda;
+      (void) new_lambda;
+      (void) block;
+      (void) nele_hess;
+      (void) values;
+      return false;
+   }
+   ///@}
+
+   /** @name Methods for block-angular problems.
+    *
+    *  Two-stage stochastic and multi-period problems often have a
+    *  block-angular structure: the variables and constraints can be
+    *  partitioned into blocks, e.g., scenarios or time periods, that are
+    *  only coupled through some linking variables and linking
+    *  constraints.  The augmented system then has a block-bordered
+    *  diagonal form, which is exploited by the Schur complement solver
+    *  (option schur_complement_solver).  It factorizes the diagonal blocks
+    *  independently, possibly in parallel, and solves a dense system
+    *  for the linking variables and constraints.
+    *
+    * @{
+    */
+
+   /** Return the number of diagonal blocks of the block-angular structure.
+    *
+    *  The default implementation returns 0, i.e., no structure is known.
+    */
+   // [TNLP_get_number_of_diagonal_blocks]
+   virtual Index get_number_of_diagonal_blocks()
+   // [TNLP_get_number_of_diagonal_blocks]
+   {
+      return 0;
+   }
+
+   /** Return the assignment of the variables and constraints to the diagonal blocks.
+    *
+    *  A variable or constraint that is assigned to block -1 is a linking
+    *  variable or constraint.  Variables of different blocks must not
+    *  appear together in a nonzero element of the Hessian of the
+    *  Lagrangian, and a constraint of a block must depend only on the
+    *  variables of this block and on linking variables.  Linking
+    *  constraints can depend on all variables.  If the structure is
+    *  violated, the standard augmented system solver is used.
+    *
+    *  @param n          (in) the number of variables \f$x\f$ in the problem
+    *  @param m          (in) the number of constraints \f$g(x)\f$ in the problem
+    *  @param num_blocks (in) the number of blocks, as returned by get_number_of_diagonal_blocks
+    *  @param var_block  (out) array of length n to store the block of each variable,
+    *                    between 0 and num_blocks-1, or -1 for linking variables
+    *  @param con_block  (out) array of length m to store the block of each constraint,
+    *                    between 0 and num_blocks-1, or -1 for linking constraints
+    *
+    *  @return true if success, false otherwise.
+    */
+   // [TNLP_get_diagonal_blocks]
+   virtual bool get_diagonal_blocks(
+      Index  n,
+      Index  m,
+      Index  num_blocks,
+      Index* var_block,
+      Index* con_block
+   )
+   // [TNLP_get_diagonal_blocks]
+   {
+      (void) n;
+      (void) m;
+      (void) num_blocks;
+      (void) var_block;
+      (void) con_block;
+      return false;
+   }
+   ///@}
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -36,6 +36,11 @@
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Ipopt
 {
@@ -43,12 +48,29 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Entry i of a DenseVector, which may be homogeneous. */
+static inline Number VectorEntry(
+   const Vector& v,
+   Index         i
+)
+{
+   const DenseVector* dv = static_cast<const DenseVector*>(&v);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&v));
+   return dv->IsHomogeneous() ? dv->Scalar() : dv->Values()[i];
+}
+
 TNLPAdapter::TNLPAdapter(
    const SmartPtr<TNLP>             tnlp,
    const SmartPtr<const Journalist> jnlst /* = NULL */
 )
    : tnlp_(tnlp),
      jnlst_(jnlst),
+     dep_cache_valid_(false),
+     dep_cache_structure_hash_(0),
+     dep_cache_value_hash_(0),
+     evaluation_concurrency_(TNLP::CONCURRENCY_NONE),
+     have_varying_jac_g_(false),
+     jac_g_complete_(false),
      full_x_(NULL),
      full_lambda_(NULL),
      full_g_(NULL),
@@ -61,6 +83,15 @@ TNLPAdapter::TNLPAdapter(
      x_tag_for_jac_g_(0),
      jac_idx_map_(NULL),
      h_idx_map_(NULL),
+     nz_full_elem_(0),
+     jac_c_direct_(false),
+     jac_d_direct_(false),
+     g_c_direct_(false),
+     g_d_direct_(false),
+     entry_obj_unscale_factor_(1.),
+     n_h_blocks_(0),
+     h_block_start_(NULL),
+     h_comp_x_tag_(0),
      x_fixed_map_(NULL),
      findiff_jac_ia_(NULL),
      findiff_jac_ja_(NULL),
@@ -80,6 +111,7 @@ TNLPAdapter::~TNLPAdapter()
    delete[] c_rhs_;
    delete[] jac_idx_map_;
    delete[] h_idx_map_;
+   delete[] h_block_start_;
    delete[] x_fixed_map_;
    delete[] findiff_jac_ia_;
    delete[] findiff_jac_ja_;
@@ -113,6 +145,19 @@ void TNLPAdapter::RegisterOptions(
       "evaluated with the fixed values for those variables.  "
       "Also, for \"relax_bounds\", the fixing bound constraints are relaxed (according to\" bound_relax_factor\"). "
       "For both \"make_constraints\" and \"relax_bounds\", bound multipliers are computed for the fixed variables.");
+   roptions->AddStringOption2(
+      "presolve",
+      "Whether to remove constraints that can be handled before the optimization starts.",
+      "no",
+      "no", "give all constraints to the algorithm",
+      "yes", "remove or merge linear and constant constraints",
+      "If enabled, constraints that the TNLP declares as linear in get_constraints_linearity "
+      "and constraints without Jacobian entries are examined at the starting point. "
+      "Satisfied constant constraints are removed, constraints with a single coefficient are turned into variable bounds, "
+      "constraints that are multiples of another constraint are merged into that constraint, "
+      "and sides of constraints that are implied by the variable bounds are dropped. "
+      "The multipliers of the removed constraints are recovered before the solution is passed to finalize_solution. "
+      "This option is only considered when a TNLP is solved by IpoptApplication::OptimizeTNLP.");
    roptions->AddStringOption4(
       "dependency_detector",
       "Indicates which linear solver should be used to detect linearly dependent equality constraints.",
@@ -129,6 +174,16 @@ void TNLPAdapter::RegisterOptions(
       "no",
       "no", "only look at gradients",
       "yes", "also consider right hand side");
+   roptions->AddStringOption2(
+      "dependency_detection_presolve",
+      "Indicates if structurally independent constraints should be removed before dependency detection",
+      "yes",
+      "no", "give all equality constraints to the dependency detector",
+      "yes", "remove constraints that are independent because of their sparsity structure",
+      "A constraint that has the only nonzero entry of some column of the equality constraint Jacobian "
+      "cannot be linearly dependent on the other constraints. "
+      "These constraints are removed repeatedly, so that only the remaining core of the Jacobian "
+      "has to be factorized by the dependency detector, which is often much smaller.");
    roptions->AddLowerBoundedIntegerOption(
       "num_linear_variables",
       "Number of linear variables",
@@ -137,6 +192,18 @@ void TNLPAdapter::RegisterOptions(
       "When the Hessian is approximated, it is assumed that the first num_linear_variables variables are linear. "
       "The Hessian is then not approximated in this space. "
       "If the get_number_of_nonlinear_variables method in the TNLP is implemented, this option is ignored.");
+   roptions->AddStringOption2(
+      "derivative_storage_precision",
+      "Precision in which the values of the constraint Jacobian and Lagrangian Hessian are stored",
+      "double",
+      "double", "store values in double precision",
+      "single", "store values in single precision",
+      "Storing the values of the Jacobian and Hessian in single precision halves the memory and bandwidth required for them. "
+      "Products with these matrices are still computed in double precision, and the values are converted to double precision "
+      "when they are passed to the linear solver. "
+      "However, only about 7 significant digits of the derivatives are kept, "
+      "so that a tight convergence tolerance might not be reached, "
+      "and values beyond the single precision range (about 3.4e38) are treated as invalid numbers.");
 
    roptions->SetRegisteringCategory("Derivative Checker");
    roptions->AddStringOption4(
@@ -178,12 +245,31 @@ void TNLPAdapter::RegisterOptions(
       "no", "Print only suspect derivatives",
       "yes", "Print all derivatives",
       "Determines verbosity of derivative checker.");
+   roptions->AddStringOption2(
+      "derivative_test_sparse",
+      "Indicates whether the derivative checker uses the sparsity structure of the derivatives.",
+      "no",
+      "no", "perturb one variable at a time",
+      "yes", "perturb groups of structurally orthogonal variables at once",
+      "If enabled, the variables are partitioned into groups such that no two variables of a group appear in the same constraint "
+      "(Curtis-Powell-Reid coloring of the Jacobian columns), "
+      "and all variables of a group are perturbed at once, so that one evaluation of the constraints checks all Jacobian columns of the group. "
+      "The objective gradient is then checked by directional derivatives along the groups, "
+      "and constraint values that change although the Jacobian structure does not contain the perturbed variables are reported for the group. "
+      "The second derivative test compares the Hessian of the Lagrangian for random multipliers with differences of the gradient of the Lagrangian "
+      "along groups of structurally orthogonal Hessian columns. "
+      "If the TNLP allows concurrent evaluations (see TNLP::get_evaluation_concurrency) and Ipopt has been compiled with OpenMP, "
+      "the groups are evaluated in parallel.");
    roptions->AddStringOption2(
       "jacobian_approximation",
       "Specifies technique to compute constraint Jacobian",
       "exact",
       "exact", "user-provided derivatives",
-      "finite-difference-values", "user-provided structure, values by finite differences");
+      "finite-difference-values", "user-provided structure, values by finite differences",
+      "For finite differences, the variables are partitioned into groups such that no two variables of a group appear in the same constraint, "
+      "and all variables of a group are perturbed at once, so that one evaluation of the constraints is needed per group. "
+      "If the TNLP allows concurrent evaluations (see TNLP::get_evaluation_concurrency) and Ipopt has been compiled with OpenMP, "
+      "the groups are evaluated in parallel.");
    roptions->AddLowerBoundedNumberOption(
       "findiff_perturbation",
       "Size of the finite difference perturbation for derivative approximation.",
@@ -223,25 +309,60 @@ bool TNLPAdapter::ProcessOptions(
    options.GetNumericValue("derivative_test_tol", derivative_test_tol_, prefix);
    options.GetBoolValue("derivative_test_print_all", derivative_test_print_all_, prefix);
    options.GetIntegerValue("derivative_test_first_index", derivative_test_first_index_, prefix);
+   options.GetBoolValue("derivative_test_sparse", derivative_test_sparse_, prefix);
 
    // The option warm_start_same_structure is registered by OrigIpoptNLP
    options.GetBoolValue("warm_start_same_structure", warm_start_same_structure_, prefix);
    // The following is registered in OrigIpoptNLP
+   options.GetBoolValue("warm_start_previous_solution", warm_start_previous_solution_, prefix);
+   // with presolve, the constraints of the TNLP seen here are removed or
+   // reordered depending on the problem, so the stored multipliers could not
+   // be assigned to the right constraints after a change of the TNLP
+   bool presolve;
+   options.GetBoolValue("presolve", presolve, prefix);
+   if( presolve && warm_start_previous_solution_ )
+   {
+      jnlst_->Printf(J_WARNING, J_INITIALIZATION,
+                     "Option warm_start_previous_solution is ignored since presolve is enabled.\n");
+      warm_start_previous_solution_ = false;
+   }
+   if( !warm_start_previous_solution_ )
+   {
+      prev_x_.clear();
+      prev_z_L_.clear();
+      prev_z_U_.clear();
+      prev_lambda_.clear();
+   }
+   // The following is registered in OrigIpoptNLP
    options.GetEnumValue("hessian_approximation", enum_int, prefix);
    hessian_approximation_ = HessianApproximationType(enum_int);
+   // The following is registered in OrigIpoptNLP
+   options.GetBoolValue("hessian_approximation_exact_part", hessian_approximation_exact_part_, prefix);
    options.GetIntegerValue("num_linear_variables", num_linear_variables_, prefix);
+   options.GetEnumValue("derivative_storage_precision", enum_int, prefix);
+   single_precision_derivatives_ = (enum_int == 1);
+   // The following is registered in IpoptApplication
+   options.GetBoolValue("use_huge_pages", use_huge_pages_, prefix);
 
    options.GetEnumValue("jacobian_approximation", enum_int, prefix);
    jacobian_approximation_ = JacobianApproxEnum(enum_int);
    options.GetNumericValue("findiff_perturbation", findiff_perturbation_, prefix);
+   ASSERT_EXCEPTION(hessian_approximation_ != FINDIFF_VALUES || jacobian_approximation_ == JAC_EXACT, OPTION_INVALID,
+                    "Option \"hessian_approximation\" can only be \"finite-difference-values\" if \"jacobian_approximation\" is \"exact\".");
+   // The following is registered in OrigIpoptNLP
+   options.GetBoolValue("concurrent_derivative_evaluation", concurrent_derivative_evaluation_, prefix);
 
    options.GetNumericValue("point_perturbation_radius", point_perturbation_radius_, prefix);
 
    options.GetNumericValue("tol", tol_, prefix);
 
    options.GetBoolValue("dependency_detection_with_rhs", dependency_detection_with_rhs_, prefix);
+   options.GetBoolValue("dependency_detection_presolve", dependency_detection_presolve_, prefix);
    std::string dependency_detector;
    options.GetStringValue("dependency_detector", dependency_detector, prefix);
+   dependency_detector_name_ = dependency_detector;
+   // the tolerances of the detector are part of the key of the cached result
+   dependency_detector_tols_.clear();
    if( dependency_detector != "none" )
    {
       if( dependency_detector == "mumps" )
@@ -252,6 +373,9 @@ bool TNLPAdapter::ProcessOptions(
          SmartPtr<TSymLinearSolver> ScaledSolver =
             new TSymLinearSolver(SolverInterface, NULL);
          dependency_detector_ = new TSymDependencyDetector(*ScaledSolver);
+         Number tol;
+         options.GetNumericValue("mumps_dep_tol", tol, prefix);
+         dependency_detector_tols_.push_back(tol);
 #else
 
          THROW_EXCEPTION(OPTION_INVALID,
@@ -267,6 +391,11 @@ bool TNLPAdapter::ProcessOptions(
          SmartPtr<TSymLinearSolver> ScaledSolver =
             new TSymLinearSolver(SolverInterface, NULL);
          dependency_detector_ = new TSymDependencyDetector(*ScaledSolver);
+         Number tol;
+         options.GetNumericValue("wsmp_pivtol", tol, prefix);
+         dependency_detector_tols_.push_back(tol);
+         options.GetNumericValue("wsmp_singularity_threshold", tol, prefix);
+         dependency_detector_tols_.push_back(tol);
 #else
 
          THROW_EXCEPTION(OPTION_INVALID,
@@ -278,6 +407,9 @@ bool TNLPAdapter::ProcessOptions(
       {
 #if defined(COINHSL_HAS_MA28) && defined(F77_FUNC)
          dependency_detector_ = new Ma28TDependencyDetector();
+         Number tol;
+         options.GetNumericValue("ma28_pivtol", tol, prefix);
+         dependency_detector_tols_.push_back(tol);
 #else
          THROW_EXCEPTION(OPTION_INVALID, "Ipopt has not been compiled with MA28.  You cannot choose \"ma28\" for \"dependency_detector\".");
 #endif
@@ -314,6 +446,10 @@ bool TNLPAdapter::GetSpaces(
 {
    DBG_START_METH("TNLPAdapter::GetSpaces", dbg_verbosity);
 
+   // the scaling of the problem is determined again
+   entry_x_scaling_.clear();
+   entry_g_scaling_.clear();
+
    // First, if required, perform derivative test
    if( derivative_test_ != NO_TEST )
    {
@@ -352,6 +488,9 @@ bool TNLPAdapter::GetSpaces(
       jac_idx_map_ = NULL;
       delete[] h_idx_map_;
       h_idx_map_ = NULL;
+      delete[] h_block_start_;
+      h_block_start_ = NULL;
+      n_h_blocks_ = 0;
       delete[] x_fixed_map_;
       x_fixed_map_ = NULL;
    }
@@ -369,8 +508,40 @@ bool TNLPAdapter::GetSpaces(
    n_full_g_ = n_full_g;
    nz_full_jac_g_ = nz_full_jac_g;
    nz_full_h_ = nz_full_h;
+   evaluation_concurrency_ = tnlp_->get_evaluation_concurrency();
+
+   // the entries of the Jacobian that are not varying are taken from
+   // the first evaluation in each optimization
+   have_varying_jac_g_ = false;
+   varying_jac_g_pos_.clear();
+   Index num_varying = tnlp_->get_number_of_varying_jac_g_entries();
+   if( num_varying >= 0 && num_varying < nz_full_jac_g_ )
+   {
+      varying_jac_g_pos_.resize(num_varying);
+      if( tnlp_->get_list_of_varying_jac_g_entries(nz_full_jac_g_, num_varying,
+            num_varying > 0 ? &varying_jac_g_pos_[0] : NULL) )
+      {
+         for( Index i = 0; i < num_varying; i++ )
+         {
+            ASSERT_EXCEPTION(varying_jac_g_pos_[i] >= 0 && varying_jac_g_pos_[i] < nz_full_jac_g_, INVALID_TNLP,
+                             "get_list_of_varying_jac_g_entries returned an invalid position");
+         }
+         have_varying_jac_g_ = true;
+         varying_jac_g_vals_.resize(num_varying);
+      }
+      else
+      {
+         varying_jac_g_pos_.clear();
+      }
+   }
 
-   if( !warm_start_same_structure_ )
+   if( !warm_start_same_structure_ && IsValid(structure_source_) )
+   {
+      CopyStructure(*structure_source_);
+      // do not keep the source alive longer than necessary
+      structure_source_ = NULL;
+   }
+   else if( !warm_start_same_structure_ )
    {
       // create space to store vectors that are the full length of x
       full_x_ = new Number[n_full_x_];
@@ -478,7 +649,7 @@ bool TNLPAdapter::GetSpaces(
             {
                char string[128];
                Snprintf(string, 127,
-                        "There are inconsistent bounds on variable %d: lower = %25.16e and upper = %25.16e.", i, lower_bound,
+                        "There are inconsistent bounds on variable %" IPOPT_INDEX_FORMAT ": lower = %25.16e and upper = %25.16e.", i, lower_bound,
                         upper_bound);
                delete[] x_l;
                delete[] x_u;
@@ -570,7 +741,7 @@ bool TNLPAdapter::GetSpaces(
                delete[] d_u_map;
                char string[128];
                Snprintf(string, 127,
-                        "There are inconsistent bounds on constraint function %d: lower = %25.16e and upper = %25.16e.", i,
+                        "There are inconsistent bounds on constraint function %" IPOPT_INDEX_FORMAT ": lower = %25.16e and upper = %25.16e.", i,
                         lower_bound, upper_bound);
                THROW_EXCEPTION(INCONSISTENT_BOUNDS, string);
             }
@@ -600,7 +771,7 @@ bool TNLPAdapter::GetSpaces(
          {
             fixed_variable_treatment_ = RELAX_BOUNDS;
             jnlst_->Printf(J_WARNING, J_INITIALIZATION,
-                           "Too few degrees of freedom (n_x = %d, n_c = %d).\n  Trying fixed_variable_treatment = RELAX_BOUNDS\n\n",
+                           "Too few degrees of freedom (n_x = %" IPOPT_INDEX_FORMAT ", n_c = %" IPOPT_INDEX_FORMAT ").\n  Trying fixed_variable_treatment = RELAX_BOUNDS\n\n",
                            n_x_var, n_c);
          }
       } // while (!done)
@@ -701,7 +872,7 @@ bool TNLPAdapter::GetSpaces(
          if( c_deps.size() > 0 )
          {
             jnlst_->Printf(J_WARNING, J_INITIALIZATION,
-                           "\nDetected %d linearly dependent equality constraints; taking those out.\n\n", c_deps.size());
+                           "\nDetected %" IPOPT_INDEX_FORMAT " linearly dependent equality constraints; taking those out.\n\n", (Index) c_deps.size());
          }
          else
          {
@@ -713,7 +884,7 @@ bool TNLPAdapter::GetSpaces(
             int count = 0;
             for( std::list<Index>::iterator i = c_deps.begin(); i != c_deps.end(); i++ )
             {
-               jnlst_->Printf(J_DETAILED, J_INITIALIZATION, "c_dep[%d] = %d\n", count++, *i);
+               jnlst_->Printf(J_DETAILED, J_INITIALIZATION, "c_dep[%d] = %" IPOPT_INDEX_FORMAT "\n", count++, *i);
             }
             jnlst_->Printf(J_DETAILED, J_INITIALIZATION, "\n");
          }
@@ -758,11 +929,11 @@ bool TNLPAdapter::GetSpaces(
       x_u = NULL;
 
       // create x spaces
-      SmartPtr<DenseVectorSpace> dv_x_space = new DenseVectorSpace(n_x_var);
+      SmartPtr<DenseVectorSpace> dv_x_space = new DenseVectorSpace(n_x_var, use_huge_pages_);
       x_space_ = GetRawPtr(dv_x_space);
-      SmartPtr<DenseVectorSpace> dv_x_l_space = new DenseVectorSpace(n_x_l);
+      SmartPtr<DenseVectorSpace> dv_x_l_space = new DenseVectorSpace(n_x_l, use_huge_pages_);
       x_l_space_ = GetRawPtr(dv_x_l_space);
-      SmartPtr<DenseVectorSpace> dv_x_u_space = new DenseVectorSpace(n_x_u);
+      SmartPtr<DenseVectorSpace> dv_x_u_space = new DenseVectorSpace(n_x_u, use_huge_pages_);
       x_u_space_ = GetRawPtr(dv_x_u_space);
 
       if( n_x_fixed_ > 0 && fixed_variable_treatment_ == MAKE_PARAMETER )
@@ -928,11 +1099,11 @@ bool TNLPAdapter::GetSpaces(
       SmartPtr<DenseVectorSpace> dc_space;
       if( n_x_fixed_ == 0 || fixed_variable_treatment_ == MAKE_PARAMETER )
       {
-         dc_space = new DenseVectorSpace(n_c);
+         dc_space = new DenseVectorSpace(n_c, use_huge_pages_);
       }
       else
       {
-         dc_space = new DenseVectorSpace(n_c + n_x_fixed_);
+         dc_space = new DenseVectorSpace(n_c + n_x_fixed_, use_huge_pages_);
       }
       c_space_ = GetRawPtr(dc_space);
       c_rhs_ = new Number[dc_space->Dim()];
@@ -944,7 +1115,7 @@ bool TNLPAdapter::GetSpaces(
       c_map = NULL;
 
       // create the required d_space
-      SmartPtr<DenseVectorSpace> dv_d_space = new DenseVectorSpace(n_d);
+      SmartPtr<DenseVectorSpace> dv_d_space = new DenseVectorSpace(n_d, use_huge_pages_);
       d_space_ = GetRawPtr(dv_d_space);
       // create the internal expansion matrix for d to g
       P_d_g_space_ = new ExpansionMatrixSpace(n_full_g_, n_d, d_map);
@@ -953,7 +1124,7 @@ bool TNLPAdapter::GetSpaces(
       d_map = NULL;
 
       // create the required d_l space
-      SmartPtr<DenseVectorSpace> dv_d_l_space = new DenseVectorSpace(n_d_l);
+      SmartPtr<DenseVectorSpace> dv_d_l_space = new DenseVectorSpace(n_d_l, use_huge_pages_);
       d_l_space_ = GetRawPtr(dv_d_l_space);
       // create the required expansion matrix for d_L to d_L_exp
       SmartPtr<ExpansionMatrixSpace> P_d_l_space = new ExpansionMatrixSpace(n_d, n_d_l, d_l_map);
@@ -962,7 +1133,7 @@ bool TNLPAdapter::GetSpaces(
       d_l_map = NULL;
 
       // create the required d_u space
-      SmartPtr<DenseVectorSpace> dv_d_u_space = new DenseVectorSpace(n_d_u);
+      SmartPtr<DenseVectorSpace> dv_d_u_space = new DenseVectorSpace(n_d_u, use_huge_pages_);
       d_u_space_ = GetRawPtr(dv_d_u_space);
       // create the required expansion matrix for d_U to d_U_exp
       SmartPtr<ExpansionMatrixSpace> P_d_u_space = new ExpansionMatrixSpace(n_d, n_d_u, d_u_map);
@@ -1207,7 +1378,8 @@ bool TNLPAdapter::GetSpaces(
          n_added_constr = n_x_fixed_;
       }
 
-      Jac_c_space_ = new GenTMatrixSpace(n_c + n_added_constr, n_x_var, nz_jac_c_, jac_c_iRow, jac_c_jCol);
+      Jac_c_space_ = new GenTMatrixSpace(n_c + n_added_constr, n_x_var, nz_jac_c_, jac_c_iRow, jac_c_jCol,
+                                         single_precision_derivatives_, use_huge_pages_);
       delete[] jac_c_iRow;
       jac_c_iRow = NULL;
       delete[] jac_c_jCol;
@@ -1252,7 +1424,16 @@ bool TNLPAdapter::GetSpaces(
          }
       }
       nz_jac_d_ = current_nz;
-      Jac_d_space_ = new GenTMatrixSpace(n_d, n_x_var, nz_jac_d_, jac_d_iRow, jac_d_jCol);
+      // since jac_idx_map_ is increasing, it is the identity if all
+      // entries of jac_g belong to either jac_c or jac_d
+      jac_c_direct_ = jacobian_approximation_ == JAC_EXACT && nz_full_jac_g_ > 0 && nz_jac_c_no_extra_ == nz_full_jac_g_;
+      jac_d_direct_ = jacobian_approximation_ == JAC_EXACT && nz_full_jac_g_ > 0 && nz_jac_d_ == nz_full_jac_g_;
+      // similarly, the expansions of c and d are increasing; the finite
+      // difference Jacobian needs the values of g in full_g_
+      g_c_direct_ = jacobian_approximation_ == JAC_EXACT && n_full_g_ > 0 && P_c_g_->NCols() == n_full_g_;
+      g_d_direct_ = jacobian_approximation_ == JAC_EXACT && n_full_g_ > 0 && P_d_g_->NCols() == n_full_g_;
+      Jac_d_space_ = new GenTMatrixSpace(n_d, n_x_var, nz_jac_d_, jac_d_iRow, jac_d_jCol,
+                                         single_precision_derivatives_, use_huge_pages_);
       delete[] jac_d_iRow;
       jac_d_iRow = NULL;
       delete[] jac_d_jCol;
@@ -1263,7 +1444,8 @@ bool TNLPAdapter::GetSpaces(
       delete[] g_jCol;
       g_jCol = NULL;
 
-      if( hessian_approximation_ == EXACT )
+      if( hessian_approximation_ == EXACT || hessian_approximation_ == FINDIFF_VALUES || hessian_approximation_ == LAGGED_EXACT
+          || (hessian_approximation_ == LIMITED_MEMORY && hessian_approximation_exact_part_) )
       {
          /** Create the matrix space for the hessian of the lagrangian */
          Index* full_h_iRow = new Index[nz_full_h_];
@@ -1340,7 +1522,58 @@ bool TNLPAdapter::GetSpaces(
             current_nz = nz_full_h_;
          }
          nz_h_ = current_nz;
-         Hess_lagrangian_space_ = new SymTMatrixSpace(n_x_var, nz_h_, h_iRow, h_jCol);
+         Hess_lagrangian_space_ = new SymTMatrixSpace(n_x_var, nz_h_, h_iRow, h_jCol, single_precision_derivatives_,
+                                                      use_huge_pages_);
+
+         if( hessian_approximation_ == FINDIFF_VALUES )
+         {
+            initialize_findiff_hess(full_h_iRow, full_h_jCol);
+         }
+
+         // get the partition of the Hessian entries for eval_h_block
+         if( evaluation_concurrency_ != TNLP::CONCURRENCY_NONE && hessian_approximation_ != FINDIFF_VALUES )
+         {
+            Index n_h_blocks = tnlp_->get_number_of_hessian_blocks();
+            if( n_h_blocks > 1 )
+            {
+               h_block_start_ = new Index[n_h_blocks + 1];
+               retval = tnlp_->get_hessian_blocks(n_h_blocks, nz_full_h_, h_block_start_);
+               bool valid = retval && h_block_start_[0] == 0 && h_block_start_[n_h_blocks] == nz_full_h_;
+               for( Index k = 0; valid && k < n_h_blocks; k++ )
+               {
+                  valid = h_block_start_[k] <= h_block_start_[k + 1];
+               }
+               ASSERT_EXCEPTION(valid, INVALID_TNLP, "get_hessian_blocks returned false or an invalid partition");
+               n_h_blocks_ = n_h_blocks;
+            }
+         }
+
+         // get the components of the Hessian, if the TNLP provides them
+         h_comp_con_.clear();
+         h_comp_pos_.clear();
+         h_comp_values_.clear();
+         h_comp_x_tag_ = 0;
+         Index nz_h_comp;
+         if( (hessian_approximation_ == EXACT || hessian_approximation_ == LAGGED_EXACT)
+             && tnlp_->get_h_components_info(nz_h_comp) && nz_h_comp > 0 )
+         {
+            h_comp_con_.resize(nz_h_comp);
+            h_comp_pos_.resize(nz_h_comp);
+            retval = tnlp_->get_h_components_structure(nz_full_h_, nz_h_comp, &h_comp_con_[0], &h_comp_pos_[0]);
+            const Index offset = index_style_ == TNLP::FORTRAN_STYLE ? 1 : 0;
+            for( Index k = 0; retval && k < nz_h_comp; k++ )
+            {
+               if( h_comp_con_[k] != -1 )
+               {
+                  h_comp_con_[k] -= offset;
+                  retval = h_comp_con_[k] >= 0 && h_comp_con_[k] < n_full_g_;
+               }
+               h_comp_pos_[k] -= offset;
+               retval = retval && h_comp_pos_[k] >= 0 && h_comp_pos_[k] < nz_full_h_;
+            }
+            ASSERT_EXCEPTION(retval, INVALID_TNLP, "get_h_components_structure returned false or an invalid structure");
+            h_comp_values_.resize(nz_h_comp);
+         }
          delete[] full_h_iRow;
          full_h_iRow = NULL;
          delete[] full_h_jCol;
@@ -1350,6 +1583,87 @@ bool TNLPAdapter::GetSpaces(
          delete[] h_jCol;
          h_jCol = NULL;
       }
+      else if( hessian_approximation_ == PARTITIONED )
+      {
+         /** Create the matrix space for the hessian of the lagrangian from the element functions */
+         Index n_elements;
+         bool retval = tnlp_->get_element_functions_info(n_elements, nz_full_elem_);
+         Index* full_elem_start = NULL;
+         Index* full_elem_vars = NULL;
+         if( retval )
+         {
+            full_elem_start = new Index[n_elements + 1];
+            full_elem_vars = new Index[nz_full_elem_];
+            retval = tnlp_->get_element_functions_structure(n_elements, nz_full_elem_, full_elem_start, full_elem_vars);
+         }
+         if( !retval )
+         {
+            delete[] full_elem_start;
+            delete[] full_elem_vars;
+            jnlst_->Printf(J_ERROR, J_INITIALIZATION,
+                           "Option \"hessian_approximation\" is chosen as \"partitioned\", but the TNLP provides no element functions.\n");
+            THROW_EXCEPTION(OPTION_INVALID, "get_element_functions_structure has not been implemented");
+         }
+         ASSERT_EXCEPTION(full_elem_start[0] == 0 && full_elem_start[n_elements] == nz_full_elem_, INVALID_TNLP,
+                          "get_element_functions_structure returned an invalid elem_start");
+
+         // keep only the variables that are not fixed
+         const Index* x_pos = IsValid(P_x_full_x_) ? P_x_full_x_->CompressedPosIndices() : NULL;
+         const Index offset = index_style_ == TNLP::FORTRAN_STYLE ? 1 : 0;
+         elem_start_.resize(n_elements + 1);
+         elem_vars_.clear();
+         elem_idx_map_.clear();
+         elem_start_[0] = 0;
+         for( Index e = 0; e < n_elements; e++ )
+         {
+            for( Index k = full_elem_start[e]; k < full_elem_start[e + 1]; k++ )
+            {
+               Index full_var = full_elem_vars[k] - offset;
+               DBG_ASSERT(full_var >= 0 && full_var < n_full_x_);
+               Index var = x_pos ? x_pos[full_var] : full_var;
+               if( var != -1 )
+               {
+                  elem_vars_.push_back(var);
+                  elem_idx_map_.push_back(k);
+               }
+            }
+            elem_start_[e + 1] = (Index) elem_vars_.size();
+         }
+         if( (Index) elem_vars_.size() == nz_full_elem_ )
+         {
+            elem_idx_map_.clear();
+         }
+         delete[] full_elem_start;
+         delete[] full_elem_vars;
+
+         // the lower triangle of the dense Hessian of each element function
+         nz_h_ = 0;
+         for( Index e = 0; e < n_elements; e++ )
+         {
+            Index n_e = elem_start_[e + 1] - elem_start_[e];
+            nz_h_ += n_e * (n_e + 1) / 2;
+         }
+         Index* h_iRow = new Index[nz_h_];
+         Index* h_jCol = new Index[nz_h_];
+         current_nz = 0;
+         for( Index e = 0; e < n_elements; e++ )
+         {
+            for( Index i = elem_start_[e]; i < elem_start_[e + 1]; i++ )
+            {
+               for( Index j = elem_start_[e]; j <= i; j++ )
+               {
+                  h_iRow[current_nz] = elem_vars_[i] + 1;
+                  h_jCol[current_nz] = elem_vars_[j] + 1;
+                  current_nz++;
+               }
+            }
+         }
+         DBG_ASSERT(current_nz == nz_h_);
+         Hess_lagrangian_space_ = new SymTMatrixSpace(n_x_var, nz_h_, h_iRow, h_jCol, single_precision_derivatives_,
+                                                      use_huge_pages_);
+         delete[] h_iRow;
+         delete[] h_jCol;
+      }
       else
       {
          nz_h_ = 0;
@@ -1375,11 +1689,11 @@ bool TNLPAdapter::GetSpaces(
 
    if( IsValid(jnlst_) )
    {
-      jnlst_->Printf(J_ITERSUMMARY, J_STATISTICS, "Number of nonzeros in equality constraint Jacobian...:%9d\n",
+      jnlst_->Printf(J_ITERSUMMARY, J_STATISTICS, "Number of nonzeros in equality constraint Jacobian...:%9" IPOPT_INDEX_FORMAT "\n",
                      nz_jac_c_);
-      jnlst_->Printf(J_ITERSUMMARY, J_STATISTICS, "Number of nonzeros in inequality constraint Jacobian.:%9d\n",
+      jnlst_->Printf(J_ITERSUMMARY, J_STATISTICS, "Number of nonzeros in inequality constraint Jacobian.:%9" IPOPT_INDEX_FORMAT "\n",
                      nz_jac_d_);
-      jnlst_->Printf(J_ITERSUMMARY, J_STATISTICS, "Number of nonzeros in Lagrangian Hessian.............:%9d\n\n",
+      jnlst_->Printf(J_ITERSUMMARY, J_STATISTICS, "Number of nonzeros in Lagrangian Hessian.............:%9" IPOPT_INDEX_FORMAT "\n\n",
                      nz_h_);
    }
 
@@ -1530,7 +1844,7 @@ bool TNLPAdapter::GetBoundsInformation(
    }
 
    // In case we are doing finite differences, keep a copy of the bounds
-   if( jacobian_approximation_ != JAC_EXACT )
+   if( jacobian_approximation_ != JAC_EXACT || hessian_approximation_ == FINDIFF_VALUES )
    {
       delete[] findiff_x_l_;
       delete[] findiff_x_u_;
@@ -1565,6 +1879,10 @@ bool TNLPAdapter::GetStartingPoint(
    bool             need_z_U
 )
 {
+   // a new optimization starts, in which the entries of the Jacobian
+   // that are not varying may have other values than before
+   jac_g_complete_ = false;
+
    Number* full_x = new Number[n_full_x_];
    Number* full_z_l = new Number[n_full_x_];
    Number* full_z_u = new Number[n_full_x_];
@@ -1573,8 +1891,37 @@ bool TNLPAdapter::GetStartingPoint(
    bool init_z = need_z_L || need_z_U;
    bool init_lambda = need_y_c || need_y_d;
 
-   bool retvalue = tnlp_->get_starting_point(n_full_x_, init_x, full_x, init_z, full_z_l, full_z_u, n_full_g_,
-                   init_lambda, full_lambda);
+   // Start from the final point of the previous solve, if requested.
+   // Constraints may have been appended since then; their multipliers
+   // are zero.  If constraints have been removed, the multipliers are
+   // taken from the TNLP.
+   bool use_prev = warm_start_previous_solution_ && !prev_x_.empty() && (Index) prev_x_.size() == n_full_x_;
+   Index n_prev_g = (Index) prev_lambda_.size();
+   bool retvalue = true;
+   if( !use_prev || (init_lambda && n_prev_g > n_full_g_) )
+   {
+      retvalue = tnlp_->get_starting_point(n_full_x_, init_x, full_x, init_z, full_z_l, full_z_u, n_full_g_,
+                                           init_lambda, full_lambda);
+   }
+   else if( init_lambda )
+   {
+      for( Index i = 0; i < n_full_g_; i++ )
+      {
+         full_lambda[i] = i < n_prev_g ? prev_lambda_[i] : 0.;
+      }
+   }
+   if( retvalue && use_prev )
+   {
+      jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
+                     "Starting from the final point of the previous solve (%" IPOPT_INDEX_FORMAT " constraints before, %" IPOPT_INDEX_FORMAT " now).\n",
+                     n_prev_g, n_full_g_);
+      IpBlasDcopy(n_full_x_, &prev_x_[0], 1, full_x, 1);
+      if( init_z )
+      {
+         IpBlasDcopy(n_full_x_, &prev_z_L_[0], 1, full_z_l, 1);
+         IpBlasDcopy(n_full_x_, &prev_z_U_[0], 1, full_z_u, 1);
+      }
+   }
 
    if( !retvalue )
    {
@@ -1737,7 +2084,8 @@ bool TNLPAdapter::Eval_grad_f(
    Number* values = dg_f->Values();
    if( IsValid(P_x_full_x_) )
    {
-      Number* full_grad_f = new Number[n_full_x_];
+      work_full_x1_.resize(n_full_x_);
+      Number* full_grad_f = &work_full_x1_[0];
       if( tnlp_->eval_grad_f(n_full_x_, full_x_, new_x, full_grad_f) )
       {
          const Index* x_pos = P_x_full_x_->ExpandedPosIndices();
@@ -1747,7 +2095,6 @@ bool TNLPAdapter::Eval_grad_f(
          }
          retvalue = true;
       }
-      delete[] full_grad_f;
    }
    else
    {
@@ -1768,31 +2115,59 @@ bool TNLPAdapter::Eval_c(
       new_x = true;
    }
 
-   if( internal_eval_g(new_x) )
+   if( g_d_direct_ )
    {
-      DenseVector* dc = static_cast<DenseVector*>(&c);
-      DBG_ASSERT(dynamic_cast<DenseVector*>(&c));
-      Number* values = dc->Values();
-      const Index* c_pos = P_c_g_->ExpandedPosIndices();
-      Index n_c_no_fixed = P_c_g_->NCols();
-      for( Index i = 0; i < n_c_no_fixed; i++ )
-      {
-         values[i] = full_g_[c_pos[i]];
-         values[i] -= c_rhs_[i];
-      }
-      if( fixed_variable_treatment_ == MAKE_CONSTRAINT )
+      // c has only the constraints for fixed variables, if any
+      ExtractC(NULL, full_x_, c);
+      return true;
+   }
+
+   if( g_c_direct_ && x_tag_for_g_ != x_tag_for_iterates_ )
+   {
+      // c starts with the entries of g, so avoid the copy through full_g_
+      Number* values = static_cast<DenseVector*>(&c)->Values();
+      if( !eval_exact_g(new_x, values) )
       {
-         for( Index i = 0; i < n_x_fixed_; i++ )
-         {
-            values[n_c_no_fixed + i] = full_x_[x_fixed_map_[i]] - c_rhs_[n_c_no_fixed + i];
-         }
+         return false;
       }
+      ExtractC(values, full_x_, c);
+      return true;
+   }
+
+   if( internal_eval_g(new_x) )
+   {
+      ExtractC(full_g_, full_x_, c);
       return true;
    }
 
    return false;
 }
 
+void TNLPAdapter::ExtractC(
+   const Number* full_g,
+   const Number* full_x,
+   Vector&       c
+) const
+{
+   DenseVector* dc = static_cast<DenseVector*>(&c);
+   DBG_ASSERT(dynamic_cast<DenseVector*>(&c));
+   Number* values = dc->Values();
+   const Index* c_pos = P_c_g_->ExpandedPosIndices();
+   Index n_c_no_fixed = P_c_g_->NCols();
+   for( Index i = 0; i < n_c_no_fixed; i++ )
+   {
+      values[i] = full_g[c_pos[i]];
+      values[i] -= c_rhs_[i];
+   }
+   if( fixed_variable_treatment_ == MAKE_CONSTRAINT )
+   {
+      for( Index i = 0; i < n_x_fixed_; i++ )
+      {
+         values[n_c_no_fixed + i] = full_x[x_fixed_map_[i]] - c_rhs_[n_c_no_fixed + i];
+      }
+   }
+}
+
 bool TNLPAdapter::Eval_jac_c(
    const Vector& x,
    Matrix&       jac_c
@@ -1804,25 +2179,41 @@ bool TNLPAdapter::Eval_jac_c(
       new_x = true;
    }
 
-   if( internal_eval_jac_g(new_x) )
-   {
-      GenTMatrix* gt_jac_c = static_cast<GenTMatrix*>(&jac_c);
-      DBG_ASSERT(dynamic_cast<GenTMatrix*>(&jac_c));
-      Number* values = gt_jac_c->Values();
+   GenTMatrix* gt_jac_c = static_cast<GenTMatrix*>(&jac_c);
+   DBG_ASSERT(dynamic_cast<GenTMatrix*>(&jac_c));
+   Number* values = gt_jac_c->Values();
 
+   if( jac_c_direct_ && !have_varying_jac_g_ && x_tag_for_jac_g_ != x_tag_for_iterates_ )
+   {
+      // jac_c has the same entries as jac_g, so avoid the copy through jac_g_
+      if( !eval_exact_jac_g(new_x, values) )
+      {
+         return false;
+      }
+   }
+   else if( jac_d_direct_ && !have_varying_jac_g_ )
+   {
+      // all entries of jac_g belong to jac_d
+   }
+   else if( internal_eval_jac_g(new_x) )
+   {
       for( Index i = 0; i < nz_jac_c_no_extra_; i++ )
       {
          // Assume the same structure as initially given
          values[i] = jac_g_[jac_idx_map_[i]];
       }
-      if( fixed_variable_treatment_ == MAKE_CONSTRAINT )
-      {
-         const Number one = 1.;
-         IpBlasDcopy(n_x_fixed_, &one, 0, &values[nz_jac_c_no_extra_], 1);
-      }
-      return true;
    }
-   return false;
+   else
+   {
+      return false;
+   }
+
+   if( fixed_variable_treatment_ == MAKE_CONSTRAINT )
+   {
+      const Number one = 1.;
+      IpBlasDcopy(n_x_fixed_, &one, 0, &values[nz_jac_c_no_extra_], 1);
+   }
+   return true;
 }
 
 bool TNLPAdapter::Eval_d(
@@ -1836,22 +2227,43 @@ bool TNLPAdapter::Eval_d(
       new_x = true;
    }
 
-   DenseVector* dd = static_cast<DenseVector*>(&d);
-   DBG_ASSERT(dynamic_cast<DenseVector*>(&d));
-   Number* values = dd->Values();
+   if( g_c_direct_ )
+   {
+      // d is empty
+      return true;
+   }
+
+   if( g_d_direct_ && x_tag_for_g_ != x_tag_for_iterates_ )
+   {
+      // d has the same entries as g, so avoid the copy through full_g_
+      DBG_ASSERT(dynamic_cast<DenseVector*>(&d));
+      return eval_exact_g(new_x, static_cast<DenseVector*>(&d)->Values());
+   }
+
    if( internal_eval_g(new_x) )
    {
-      const Index* d_pos = P_d_g_->ExpandedPosIndices();
-      for( Index i = 0; i < d.Dim(); i++ )
-      {
-         values[i] = full_g_[d_pos[i]];
-      }
+      ExtractD(full_g_, d);
       return true;
    }
 
    return false;
 }
 
+void TNLPAdapter::ExtractD(
+   const Number* full_g,
+   Vector&       d
+) const
+{
+   DenseVector* dd = static_cast<DenseVector*>(&d);
+   DBG_ASSERT(dynamic_cast<DenseVector*>(&d));
+   Number* values = dd->Values();
+   const Index* d_pos = P_d_g_->ExpandedPosIndices();
+   for( Index i = 0; i < d.Dim(); i++ )
+   {
+      values[i] = full_g[d_pos[i]];
+   }
+}
+
 bool TNLPAdapter::Eval_jac_d(
    const Vector& x,
    Matrix&       jac_d
@@ -1863,12 +2275,23 @@ bool TNLPAdapter::Eval_jac_d(
       new_x = true;
    }
 
-   if( internal_eval_jac_g(new_x) )
+   GenTMatrix* gt_jac_d = static_cast<GenTMatrix*>(&jac_d);
+   DBG_ASSERT(dynamic_cast<GenTMatrix*>(&jac_d));
+   Number* values = gt_jac_d->Values();
+
+   if( jac_d_direct_ && !have_varying_jac_g_ && x_tag_for_jac_g_ != x_tag_for_iterates_ )
+   {
+      // jac_d has the same entries as jac_g, so avoid the copy through jac_g_
+      return eval_exact_jac_g(new_x, values);
+   }
+   if( jac_c_direct_ && !have_varying_jac_g_ )
    {
-      GenTMatrix* gt_jac_d = static_cast<GenTMatrix*>(&jac_d);
-      DBG_ASSERT(dynamic_cast<GenTMatrix*>(&jac_d));
-      Number* values = gt_jac_d->Values();
+      // all entries of jac_g belong to jac_c
+      return true;
+   }
 
+   if( internal_eval_jac_g(new_x) )
+   {
       for( Index i = 0; i < nz_jac_d_; i++ )
       {
          // Assume the same structure as initially given
@@ -1921,10 +2344,10 @@ bool TNLPAdapter::Eval_h(
 
    if( h_idx_map_ )
    {
-      Number* full_h = new Number[nz_full_h_];
+      work_values_.resize(nz_full_h_);
+      Number* full_h = &work_values_[0];
 
-      if( tnlp_->eval_h(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y, nz_full_h_, NULL, NULL,
-                        full_h) )
+      if( internal_eval_h(new_x, obj_factor, new_y, full_h) )
       {
          for( Index i = 0; i < nz_h_; i++ )
          {
@@ -1932,76 +2355,470 @@ bool TNLPAdapter::Eval_h(
          }
          retval = true;
       }
-      delete[] full_h;
    }
    else
    {
-      retval = tnlp_->eval_h(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y, nz_full_h_, NULL,
-                             NULL, values);
+      retval = internal_eval_h(new_x, obj_factor, new_y, values);
    }
 
    return retval;
 }
 
-void TNLPAdapter::GetScalingParameters(
-   const SmartPtr<const VectorSpace> x_space,
-   const SmartPtr<const VectorSpace> c_space,
-   const SmartPtr<const VectorSpace> d_space,
-   Number&                           obj_scaling,
-   SmartPtr<Vector>&                 x_scaling,
-   SmartPtr<Vector>&                 c_scaling,
-   SmartPtr<Vector>&                 d_scaling
-) const
+bool TNLPAdapter::Eval_h_times_vec(
+   const Vector& x,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd,
+   const Vector& v,
+   Vector&       hv
+)
 {
-   x_scaling = x_space->MakeNew();
-   c_scaling = c_space->MakeNew();
-   d_scaling = d_space->MakeNew();
-   DBG_ASSERT((c_scaling->Dim() + d_scaling->Dim()) == n_full_g_);
+   // As in Eval_h, there is nothing to compute if all weights are zero
+   if( obj_factor == 0. && yc.Asum() == 0. && yd.Asum() == 0. )
+   {
+      hv.Set(0.);
+      return true;
+   }
 
-   DenseVector* dx = static_cast<DenseVector*>(GetRawPtr(x_scaling));
-   DBG_ASSERT(dynamic_cast<DenseVector*>(GetRawPtr(x_scaling)));
-   DenseVector* dc = static_cast<DenseVector*>(GetRawPtr(c_scaling));
-   DBG_ASSERT(dynamic_cast<DenseVector*>(GetRawPtr(c_scaling)));
-   DenseVector* dd = static_cast<DenseVector*>(GetRawPtr(d_scaling));
-   DBG_ASSERT(dynamic_cast<DenseVector*>(GetRawPtr(d_scaling)));
-   Number* dx_values = dx->Values();
-   Number* dc_values = dc->Values();
-   Number* dd_values = dd->Values();
+   bool new_x = false;
+   if( update_local_x(x) )
+   {
+      new_x = true;
+   }
+   bool new_y = false;
+   if( update_local_lambda(yc, yd) )
+   {
+      new_y = true;
+   }
 
-   Number* full_g_scaling = new Number[n_full_g_];
-   bool use_x_scaling = true;
-   bool use_g_scaling = true;
+   const DenseVector* dv = static_cast<const DenseVector*>(&v);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&v));
+   DenseVector* dhv = static_cast<DenseVector*>(&hv);
+   DBG_ASSERT(dynamic_cast<DenseVector*>(&hv));
 
-   if( IsValid(P_x_full_x_) )
+   if( !IsValid(P_x_full_x_) && !dv->IsHomogeneous() )
    {
-      Number* full_x_scaling = new Number[n_full_x_];
-      bool retval = tnlp_->get_scaling_parameters(obj_scaling, use_x_scaling, n_full_x_, full_x_scaling, use_g_scaling,
-                    n_full_g_, full_g_scaling);
-      if( !retval )
-      {
-         delete[] full_x_scaling;
-         jnlst_->Printf(J_ERROR, J_INITIALIZATION,
-                        "Option nlp_scaling_method selected as user-scaling, but no user-scaling available, or it cannot be computed.\n");
-         THROW_EXCEPTION(OPTION_INVALID, "User scaling chosen, but get_scaling_parameters returned false.");
-      }
+      // x and the full x are the same, so avoid the copies
+      return tnlp_->eval_h_times_vec(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y,
+                                     dv->Values(), dhv->Values());
+   }
 
-      if( use_x_scaling )
+   // The fixed variables are not changed by v
+   work_full_x1_.resize(n_full_x_);
+   work_full_x2_.resize(n_full_x_);
+   Number* full_v = &work_full_x1_[0];
+   Number* full_hv = &work_full_x2_[0];
+   const Index* x_pos = NULL;
+   if( IsValid(P_x_full_x_) )
+   {
+      x_pos = P_x_full_x_->ExpandedPosIndices();
+      const Number zero = 0.;
+      IpBlasDcopy(n_full_x_, &zero, 0, full_v, 1);
+   }
+   if( dv->IsHomogeneous() )
+   {
+      Number scalar = dv->Scalar();
+      for( Index i = 0; i < v.Dim(); i++ )
       {
-         const Index* x_pos = P_x_full_x_->ExpandedPosIndices();
-         for( Index i = 0; i < dx->Dim(); i++ )
-         {
-            dx_values[i] = full_x_scaling[x_pos[i]];
-         }
+         full_v[x_pos ? x_pos[i] : i] = scalar;
       }
-      delete[] full_x_scaling;
    }
    else
    {
-      bool retval = tnlp_->get_scaling_parameters(obj_scaling, use_x_scaling, n_full_x_, dx_values, use_g_scaling,
-                    n_full_g_, full_g_scaling);
-      if( !retval )
+      const Number* v_values = dv->Values();
+      for( Index i = 0; i < v.Dim(); i++ )
       {
-         jnlst_->Printf(J_ERROR, J_INITIALIZATION,
+         full_v[x_pos ? x_pos[i] : i] = v_values[i];
+      }
+   }
+
+   bool retval = tnlp_->eval_h_times_vec(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y, full_v,
+                                         full_hv);
+   if( retval )
+   {
+      Number* hv_values = dhv->Values();
+      for( Index i = 0; i < hv.Dim(); i++ )
+      {
+         hv_values[i] = full_hv[x_pos ? x_pos[i] : i];
+      }
+   }
+
+   return retval;
+}
+
+bool TNLPAdapter::GetElementFunctions(
+   std::vector<Index>& elem_start,
+   std::vector<Index>& elem_vars
+)
+{
+   if( elem_start_.empty() )
+   {
+      return false;
+   }
+   elem_start = elem_start_;
+   elem_vars = elem_vars_;
+   return true;
+}
+
+bool TNLPAdapter::Eval_element_gradients(
+   const Vector& x,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd,
+   Vector&       elem_grad
+)
+{
+   DBG_ASSERT(!elem_start_.empty());
+   bool new_x = false;
+   if( update_local_x(x) )
+   {
+      new_x = true;
+   }
+   bool new_y = false;
+   if( update_local_lambda(yc, yd) )
+   {
+      new_y = true;
+   }
+
+   DenseVector* dgrad = static_cast<DenseVector*>(&elem_grad);
+   DBG_ASSERT(dynamic_cast<DenseVector*>(&elem_grad));
+   Number* values = dgrad->Values();
+
+   bool retval;
+   if( !elem_idx_map_.empty() )
+   {
+      work_values_.resize(nz_full_elem_);
+      Number* full_grad = &work_values_[0];
+      retval = tnlp_->eval_element_gradients(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y,
+                                             nz_full_elem_, full_grad);
+      if( retval )
+      {
+         for( Index i = 0; i < (Index) elem_vars_.size(); i++ )
+         {
+            values[i] = full_grad[elem_idx_map_[i]];
+         }
+      }
+   }
+   else
+   {
+      retval = tnlp_->eval_element_gradients(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y,
+                                             nz_full_elem_, values);
+   }
+
+   return retval;
+}
+
+bool TNLPAdapter::internal_eval_h(
+   bool    new_x,
+   Number  obj_factor,
+   bool    new_lambda,
+   Number* full_h
+)
+{
+   if( !h_comp_con_.empty() )
+   {
+      return eval_h_from_components(new_x, obj_factor, full_h);
+   }
+
+   if( hessian_approximation_ == FINDIFF_VALUES )
+   {
+      return eval_findiff_h(new_x, obj_factor, full_h);
+   }
+
+   int nthreads = 1;
+#ifdef _OPENMP
+   if( n_h_blocks_ > 1 && !omp_in_parallel() )
+   {
+      nthreads = (int) Min((Index) omp_get_max_threads(), n_h_blocks_);
+   }
+#endif
+   if( nthreads <= 1 )
+   {
+      return tnlp_->eval_h(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_lambda, nz_full_h_, NULL,
+                           NULL, full_h);
+   }
+
+   // The blocks write into disjoint parts of full_h.  Exceptions must
+   // not leave the parallel region; they are turned into a failed
+   // evaluation.
+   bool* ok = new bool[n_h_blocks_];
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+#endif
+   for( Index k = 0; k < n_h_blocks_; k++ )
+   {
+      try
+      {
+         ok[k] = tnlp_->eval_h_block(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_lambda, k,
+                                     nz_full_h_, full_h);
+      }
+      catch( ... )
+      {
+         ok[k] = false;
+      }
+   }
+
+   bool retval = true;
+   for( Index k = 0; k < n_h_blocks_; k++ )
+   {
+      retval = retval && ok[k];
+   }
+   delete[] ok;
+
+   return retval;
+}
+
+bool TNLPAdapter::eval_h_from_components(
+   bool    new_x,
+   Number  obj_factor,
+   Number* full_h
+)
+{
+   // The components do not depend on the multipliers, so they are
+   // only evaluated if x has changed since the last evaluation
+   if( h_comp_x_tag_ != x_tag_for_iterates_ )
+   {
+      Index nz_h_comp = (Index) h_comp_values_.size();
+      if( !tnlp_->eval_h_components(n_full_x_, full_x_, new_x, nz_h_comp, &h_comp_values_[0]) )
+      {
+         h_comp_x_tag_ = 0;
+         return false;
+      }
+      h_comp_x_tag_ = x_tag_for_iterates_;
+   }
+
+   for( Index i = 0; i < nz_full_h_; i++ )
+   {
+      full_h[i] = 0.;
+   }
+   for( Index k = 0; k < (Index) h_comp_values_.size(); k++ )
+   {
+      Index con = h_comp_con_[k];
+      Number weight = con == -1 ? obj_factor : full_lambda_[con];
+      full_h[h_comp_pos_[k]] += weight * h_comp_values_[k];
+   }
+
+   return true;
+}
+
+bool TNLPAdapter::Eval_jac_and_h(
+   const Vector& x,
+   Matrix*       jac_c,
+   Matrix*       jac_d,
+   Number        obj_factor,
+   const Vector& yc,
+   const Vector& yd,
+   SymMatrix&    h
+)
+{
+#ifdef _OPENMP
+   if( concurrent_derivative_evaluation_ && evaluation_concurrency_ != TNLP::CONCURRENCY_NONE
+       && jacobian_approximation_ == JAC_EXACT && hessian_approximation_ != FINDIFF_VALUES && h_comp_con_.empty()
+       && (obj_factor != 0. || yc.Asum() != 0. || yd.Asum() != 0.) )
+   {
+      bool new_x = update_local_x(x);
+      bool new_y = update_local_lambda(yc, yd);
+
+      if( x_tag_for_jac_g_ != x_tag_for_iterates_ )
+      {
+         // Everything that touches Ipopt objects is done outside of the
+         // parallel region; the threads only call the TNLP.
+         SymTMatrix* st_h = static_cast<SymTMatrix*>(&h);
+         DBG_ASSERT(dynamic_cast<SymTMatrix*>(&h));
+         Number* values = st_h->Values();
+         Number* full_h = h_idx_map_ ? new Number[nz_full_h_] : values;
+
+         // Exceptions must not leave the parallel region.  A failed
+         // evaluation is repeated by the caller outside of it.
+         bool jac_ok = false;
+         bool h_ok = false;
+         #pragma omp parallel sections num_threads(2)
+         {
+            #pragma omp section
+            {
+               try
+               {
+                  jac_ok = tnlp_->eval_jac_g(n_full_x_, full_x_, new_x, n_full_g_, nz_full_jac_g_, NULL, NULL, jac_g_);
+               }
+               catch( ... )
+               {
+                  jac_ok = false;
+               }
+            }
+            #pragma omp section
+            {
+               try
+               {
+                  h_ok = tnlp_->eval_h(n_full_x_, full_x_, new_x, obj_factor, n_full_g_, full_lambda_, new_y, nz_full_h_,
+                                       NULL, NULL, full_h);
+               }
+               catch( ... )
+               {
+                  h_ok = false;
+               }
+            }
+         }
+
+         x_tag_for_jac_g_ = jac_ok ? x_tag_for_iterates_ : 0;
+         jac_g_complete_ = jac_g_complete_ || jac_ok;
+         if( h_idx_map_ )
+         {
+            if( h_ok )
+            {
+               for( Index i = 0; i < nz_h_; i++ )
+               {
+                  values[i] = full_h[h_idx_map_[i]];
+               }
+            }
+            delete[] full_h;
+         }
+         if( !jac_ok || !h_ok )
+         {
+            return false;
+         }
+
+         // the Jacobians are now obtained from jac_g_
+         if( jac_c != NULL && !Eval_jac_c(x, *jac_c) )
+         {
+            return false;
+         }
+         if( jac_d != NULL && !Eval_jac_d(x, *jac_d) )
+         {
+            return false;
+         }
+         return true;
+      }
+   }
+#endif
+
+   return NLP::Eval_jac_and_h(x, jac_c, jac_d, obj_factor, yc, yd, h);
+}
+
+void TNLPAdapter::Eval_f_c_d(
+   const std::vector<SmartPtr<const Vector> >& x,
+   std::vector<Number>&                        f,
+   std::vector<SmartPtr<Vector> >&             c,
+   std::vector<SmartPtr<Vector> >&             d,
+   std::vector<bool>&                          success
+)
+{
+#ifdef _OPENMP
+   Index npoints = (Index) x.size();
+   if( npoints > 1 && evaluation_concurrency_ != TNLP::CONCURRENCY_NONE && !omp_in_parallel() )
+   {
+      Number* xs = new Number[npoints * n_full_x_];
+      Number* fs = new Number[npoints];
+      Number* gs = new Number[npoints * n_full_g_];
+      bool* ok = new bool[npoints];
+      for( Index i = 0; i < npoints; i++ )
+      {
+         ResortX(*x[i], &xs[i * n_full_x_]);
+      }
+
+      // The threads only call the TNLP.  Exceptions must not leave the
+      // parallel region; a failed evaluation is repeated by the caller.
+      #pragma omp parallel for schedule(dynamic, 1)
+      for( Index i = 0; i < npoints; i++ )
+      {
+         Number* x_i = &xs[i * n_full_x_];
+         try
+         {
+            ok[i] = tnlp_->eval_f(n_full_x_, x_i, true, fs[i]);
+            if( ok[i] && n_full_g_ > 0 )
+            {
+               ok[i] = tnlp_->eval_g(n_full_x_, x_i, true, n_full_g_, &gs[i * n_full_g_]);
+            }
+         }
+         catch( ... )
+         {
+            ok[i] = false;
+         }
+      }
+
+      for( Index i = 0; i < npoints; i++ )
+      {
+         success[i] = ok[i];
+         if( ok[i] )
+         {
+            f[i] = fs[i];
+            ExtractC(&gs[i * n_full_g_], &xs[i * n_full_x_], *c[i]);
+            ExtractD(&gs[i * n_full_g_], *d[i]);
+         }
+      }
+      delete[] xs;
+      delete[] fs;
+      delete[] gs;
+      delete[] ok;
+
+      // the TNLP has seen other points since the last call at full_x_,
+      // so the next call has to be made with new_x = true
+      x_tag_for_iterates_ = 0;
+      return;
+   }
+#endif
+
+   NLP::Eval_f_c_d(x, f, c, d, success);
+}
+
+void TNLPAdapter::GetScalingParameters(
+   const SmartPtr<const VectorSpace> x_space,
+   const SmartPtr<const VectorSpace> c_space,
+   const SmartPtr<const VectorSpace> d_space,
+   Number&                           obj_scaling,
+   SmartPtr<Vector>&                 x_scaling,
+   SmartPtr<Vector>&                 c_scaling,
+   SmartPtr<Vector>&                 d_scaling
+) const
+{
+   x_scaling = x_space->MakeNew();
+   c_scaling = c_space->MakeNew();
+   d_scaling = d_space->MakeNew();
+   DBG_ASSERT((c_scaling->Dim() + d_scaling->Dim()) == n_full_g_);
+
+   DenseVector* dx = static_cast<DenseVector*>(GetRawPtr(x_scaling));
+   DBG_ASSERT(dynamic_cast<DenseVector*>(GetRawPtr(x_scaling)));
+   DenseVector* dc = static_cast<DenseVector*>(GetRawPtr(c_scaling));
+   DBG_ASSERT(dynamic_cast<DenseVector*>(GetRawPtr(c_scaling)));
+   DenseVector* dd = static_cast<DenseVector*>(GetRawPtr(d_scaling));
+   DBG_ASSERT(dynamic_cast<DenseVector*>(GetRawPtr(d_scaling)));
+   Number* dx_values = dx->Values();
+   Number* dc_values = dc->Values();
+   Number* dd_values = dd->Values();
+
+   Number* full_g_scaling = new Number[n_full_g_];
+   bool use_x_scaling = true;
+   bool use_g_scaling = true;
+
+   if( IsValid(P_x_full_x_) )
+   {
+      Number* full_x_scaling = new Number[n_full_x_];
+      bool retval = tnlp_->get_scaling_parameters(obj_scaling, use_x_scaling, n_full_x_, full_x_scaling, use_g_scaling,
+                    n_full_g_, full_g_scaling);
+      if( !retval )
+      {
+         delete[] full_x_scaling;
+         jnlst_->Printf(J_ERROR, J_INITIALIZATION,
+                        "Option nlp_scaling_method selected as user-scaling, but no user-scaling available, or it cannot be computed.\n");
+         THROW_EXCEPTION(OPTION_INVALID, "User scaling chosen, but get_scaling_parameters returned false.");
+      }
+
+      if( use_x_scaling )
+      {
+         const Index* x_pos = P_x_full_x_->ExpandedPosIndices();
+         for( Index i = 0; i < dx->Dim(); i++ )
+         {
+            dx_values[i] = full_x_scaling[x_pos[i]];
+         }
+      }
+      delete[] full_x_scaling;
+   }
+   else
+   {
+      bool retval = tnlp_->get_scaling_parameters(obj_scaling, use_x_scaling, n_full_x_, dx_values, use_g_scaling,
+                    n_full_g_, full_g_scaling);
+      if( !retval )
+      {
+         jnlst_->Printf(J_ERROR, J_INITIALIZATION,
                         "Option nlp_scaling_method selected as user-scaling, but no user-scaling available, or it cannot be computed.\n");
          THROW_EXCEPTION(OPTION_INVALID, "User scaling chosen, but get_scaling_parameters returned false.");
       }
@@ -2198,6 +3015,14 @@ void TNLPAdapter::FinalizeSolution(
    tnlp_->finalize_metadata(n_full_x_, var_string_md, var_integer_md, var_numeric_md, n_full_g_, con_string_md,
                             con_integer_md, con_numeric_md);
 
+   if( warm_start_previous_solution_ )
+   {
+      prev_x_.assign(full_x_, full_x_ + n_full_x_);
+      prev_z_L_.assign(full_z_L, full_z_L + n_full_x_);
+      prev_z_U_.assign(full_z_U, full_z_U + n_full_x_);
+      prev_lambda_.assign(full_lambda_, full_lambda_ + n_full_g_);
+   }
+
    tnlp_->finalize_solution(status, n_full_x_, full_x_, full_z_L, full_z_U, n_full_g_, full_g, full_lambda_, obj_value,
                             ip_data, ip_cq);
 
@@ -2320,7 +3145,7 @@ void TNLPAdapter::GetQuasiNewtonApproximationSpaces(
       {
          SmartPtr<ExpansionMatrixSpace> ex_sp = new ExpansionMatrixSpace(n_full_x_, num_nonlin_vars, pos_nonlin_vars);
          P_approx = ex_sp->MakeNew();
-         approx_space = new DenseVectorSpace(num_nonlin_vars);
+         approx_space = new DenseVectorSpace(num_nonlin_vars, use_huge_pages_);
       }
    }
    else
@@ -2351,7 +3176,7 @@ void TNLPAdapter::GetQuasiNewtonApproximationSpaces(
          SmartPtr<ExpansionMatrixSpace> ex_sp = new ExpansionMatrixSpace(n_x_free, nonfixed_nonlin_vars,
                nonfixed_pos_nonlin_vars);
          P_approx = ex_sp->MakeNew();
-         approx_space = new DenseVectorSpace(nonfixed_nonlin_vars);
+         approx_space = new DenseVectorSpace(nonfixed_nonlin_vars, use_huge_pages_);
       }
 
       delete[] nonfixed_pos_nonlin_vars;
@@ -2359,21 +3184,114 @@ void TNLPAdapter::GetQuasiNewtonApproximationSpaces(
    delete[] pos_nonlin_vars;
 }
 
-void TNLPAdapter::ResortX(
-   const Vector& x,
-   Number*       x_orig
+Index TNLPAdapter::GetNumberOfDiagonalBlocks()
+{
+   return tnlp_->get_number_of_diagonal_blocks();
+}
+
+bool TNLPAdapter::GetConstantJacobians(
+   bool& jac_c_constant,
+   bool& jac_d_constant
 )
 {
-   const DenseVector* dx = static_cast<const DenseVector*>(&x);
-   DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
+   jac_c_constant = false;
+   jac_d_constant = false;
+   if( n_full_g_ == 0 )
+   {
+      return false;
+   }
 
-   if( IsValid(P_x_full_x_) )
+   TNLP::LinearityType* const_types = new TNLP::LinearityType[n_full_g_];
+   bool retval = tnlp_->get_constraints_linearity(n_full_g_, const_types);
+   if( retval )
    {
-      const Index* x_pos = P_x_full_x_->CompressedPosIndices();
+      // the constraints for fixed variables are linear
+      jac_c_constant = true;
+      const Index* c_pos = P_c_g_->ExpandedPosIndices();
+      for( Index i = 0; jac_c_constant && i < P_c_g_->NCols(); i++ )
+      {
+         jac_c_constant = const_types[c_pos[i]] == TNLP::LINEAR;
+      }
+      jac_d_constant = true;
+      const Index* d_pos = P_d_g_->ExpandedPosIndices();
+      for( Index i = 0; jac_d_constant && i < P_d_g_->NCols(); i++ )
+      {
+         jac_d_constant = const_types[d_pos[i]] == TNLP::LINEAR;
+      }
+   }
+   delete[] const_types;
+   return retval;
+}
 
-      if( dx->IsHomogeneous() )
+bool TNLPAdapter::GetDiagonalBlocks(
+   Index               num_blocks,
+   std::vector<Index>& x_block,
+   std::vector<Index>& c_block,
+   std::vector<Index>& d_block
+)
+{
+   Index* var_block = new Index[n_full_x_];
+   Index* con_block = new Index[n_full_g_];
+   bool retval = tnlp_->get_diagonal_blocks(n_full_x_, n_full_g_, num_blocks, var_block, con_block);
+   if( retval )
+   {
+      const Index* x_pos = NULL;
+      if( IsValid(P_x_full_x_) )
       {
-         const Number& scalar = dx->Scalar();
+         x_pos = P_x_full_x_->ExpandedPosIndices();
+      }
+      Index n_x = x_space_->Dim();
+      x_block.resize(n_x);
+      for( Index i = 0; i < n_x; i++ )
+      {
+         x_block[i] = var_block[x_pos ? x_pos[i] : i];
+      }
+
+      const Index* c_pos = P_c_g_->ExpandedPosIndices();
+      Index n_c_no_fixed = P_c_g_->NCols();
+      Index n_c = n_c_no_fixed;
+      if( fixed_variable_treatment_ == MAKE_CONSTRAINT )
+      {
+         n_c += n_x_fixed_;
+      }
+      c_block.resize(n_c);
+      for( Index i = 0; i < n_c_no_fixed; i++ )
+      {
+         c_block[i] = con_block[c_pos[i]];
+      }
+      for( Index i = n_c_no_fixed; i < n_c; i++ )
+      {
+         c_block[i] = var_block[x_fixed_map_[i - n_c_no_fixed]];
+      }
+
+      const Index* d_pos = P_d_g_->ExpandedPosIndices();
+      Index n_d = P_d_g_->NCols();
+      d_block.resize(n_d);
+      for( Index i = 0; i < n_d; i++ )
+      {
+         d_block[i] = con_block[d_pos[i]];
+      }
+   }
+   delete[] con_block;
+   delete[] var_block;
+   return retval;
+}
+
+void TNLPAdapter::ResortX(
+   const Vector& x,
+   Number*       x_orig
+)
+{
+   const DenseVector* dx = static_cast<const DenseVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
+
+   if( IsValid(P_x_full_x_) )
+   {
+      const Index* x_pos = P_x_full_x_->CompressedPosIndices();
+
+      if( dx->IsHomogeneous() )
+      {
+         const Number& scalar = dx->Scalar();
          for( Index i = 0; i < n_full_x_; i++ )
          {
             Index idx = x_pos[i];
@@ -2591,6 +3509,153 @@ void TNLPAdapter::ResortBnds(
    }
 }
 
+bool TNLPAdapter::GetCurrIterateEntries(
+   const IpoptData*           ip_data,
+   IpoptCalculatedQuantities* ip_cq,
+   bool                       scaled,
+   Index                      nx,
+   const Index*               x_idx,
+   Number*                    x,
+   Number*                    z_L,
+   Number*                    z_U,
+   Index                      ng,
+   const Index*               g_idx,
+   Number*                    g,
+   Number*                    lambda
+)
+{
+   if( ip_data == NULL || ip_cq == NULL )
+   {
+      return false;
+   }
+   // in the restoration phase, ip_cq belongs to the restoration problem
+   OrigIpoptNLP* orignlp = dynamic_cast<OrigIpoptNLP*>(GetRawPtr(ip_cq->GetIpoptNLP()));
+   if( orignlp == NULL || GetRawPtr(orignlp->nlp()) != this )
+   {
+      return false;
+   }
+
+   SmartPtr<const IteratesVector> curr = ip_data->curr();
+   if( entry_x_scaling_.empty() )
+   {
+      // compute the scaling factors for all entries once, so that the
+      // unscaling of single entries does not depend on the problem size
+      SmartPtr<NLPScalingObject> scaling = orignlp->NLP_scaling();
+
+      SmartPtr<Vector> one = curr->x()->MakeNew();
+      one->Set(1.);
+      SmartPtr<const Vector> dx = scaling->apply_vector_scaling_x(ConstPtr(one));
+      entry_x_scaling_.assign(n_full_x_, 1.);
+      for( Index i = 0; i < dx->Dim(); i++ )
+      {
+         entry_x_scaling_[IsValid(P_x_full_x_) ? P_x_full_x_->ExpandedPosIndices()[i] : i] = VectorEntry(*dx, i);
+      }
+
+      entry_g_scaling_.assign(n_full_g_, 1.);
+      one = curr->y_c()->MakeNew();
+      one->Set(1.);
+      SmartPtr<const Vector> dc = scaling->apply_vector_scaling_c(ConstPtr(one));
+      for( Index i = 0; i < P_c_g_->NCols(); i++ )
+      {
+         entry_g_scaling_[P_c_g_->ExpandedPosIndices()[i]] = VectorEntry(*dc, i);
+      }
+      one = curr->y_d()->MakeNew();
+      one->Set(1.);
+      SmartPtr<const Vector> dd = scaling->apply_vector_scaling_d(ConstPtr(one));
+      for( Index i = 0; i < P_d_g_->NCols(); i++ )
+      {
+         entry_g_scaling_[P_d_g_->ExpandedPosIndices()[i]] = VectorEntry(*dd, i);
+      }
+
+      entry_obj_unscale_factor_ = scaling->unapply_obj_scaling(1.);
+   }
+   // the multipliers are scaled with the objective, too
+   const Number obj_factor = scaled ? 1. : entry_obj_unscale_factor_;
+
+   if( nx > 0 )
+   {
+      const Index* x_pos = IsValid(P_x_full_x_) ? P_x_full_x_->CompressedPosIndices() : NULL;
+      const Index* x_L_pos = P_x_x_L_->CompressedPosIndices();
+      const Index* x_U_pos = P_x_x_U_->CompressedPosIndices();
+      for( Index k = 0; k < nx; k++ )
+      {
+         const Index i = x_idx[k];
+         DBG_ASSERT(i >= 0 && i < n_full_x_);
+         const Index ix = x_pos ? x_pos[i] : i;
+         const Number sx = scaled ? 1. : entry_x_scaling_[i];
+         if( x )
+         {
+            x[k] = ix >= 0 ? VectorEntry(*curr->x(), ix) / sx : full_x_[i];
+         }
+         if( z_L )
+         {
+            z_L[k] = ix >= 0 && x_L_pos[ix] >= 0 ? VectorEntry(*curr->z_L(), x_L_pos[ix]) * sx * obj_factor : 0.;
+         }
+         if( z_U )
+         {
+            z_U[k] = ix >= 0 && x_U_pos[ix] >= 0 ? VectorEntry(*curr->z_U(), x_U_pos[ix]) * sx * obj_factor : 0.;
+         }
+      }
+   }
+
+   if( ng > 0 )
+   {
+      const Index* c_pos = P_c_g_->CompressedPosIndices();
+      const Index* d_pos = P_d_g_->CompressedPosIndices();
+      SmartPtr<const Vector> c;
+      SmartPtr<const Vector> d;
+      if( g )
+      {
+         c = ip_cq->curr_c();
+         d = ip_cq->curr_d();
+      }
+      for( Index k = 0; k < ng; k++ )
+      {
+         const Index j = g_idx[k];
+         DBG_ASSERT(j >= 0 && j < n_full_g_);
+         const Number sg = scaled ? 1. : entry_g_scaling_[j];
+         if( c_pos[j] >= 0 )
+         {
+            if( g )
+            {
+               // c does not include the right hand side, which is unscaled
+               g[k] = (VectorEntry(*c, c_pos[j]) + entry_g_scaling_[j] * c_rhs_[c_pos[j]]) / sg;
+            }
+            if( lambda )
+            {
+               lambda[k] = VectorEntry(*curr->y_c(), c_pos[j]) * sg * obj_factor;
+            }
+         }
+         else if( d_pos[j] >= 0 )
+         {
+            if( g )
+            {
+               g[k] = VectorEntry(*d, d_pos[j]) / sg;
+            }
+            if( lambda )
+            {
+               lambda[k] = VectorEntry(*curr->y_d(), d_pos[j]) * sg * obj_factor;
+            }
+         }
+         else
+         {
+            // a dependent equality constraint that has been removed from
+            // the problem; give its value at the last evaluation of g
+            if( g )
+            {
+               g[k] = full_g_[j];
+            }
+            if( lambda )
+            {
+               lambda[k] = 0.;
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
 bool TNLPAdapter::update_local_x(
    const Vector& x
 )
@@ -2625,6 +3690,223 @@ bool TNLPAdapter::update_local_lambda(
    return true;
 }
 
+/** Compute the positions of the nonzeros of each column of a matrix
+ *  in triplet format (0-based indices).
+ *
+ *  On return, the nonzeros of column j are at the positions
+ *  col_nz[col_start[j]],...,col_nz[col_start[j+1]-1].
+ */
+static void ColumnwiseNonzeros(
+   Index               ncols,
+   Index               nnz,
+   const Index*        jCol,
+   std::vector<Index>& col_start,
+   std::vector<Index>& col_nz
+)
+{
+   col_start.assign(ncols + 1, 0);
+   for( Index k = 0; k < nnz; k++ )
+   {
+      col_start[jCol[k] + 1]++;
+   }
+   for( Index j = 0; j < ncols; j++ )
+   {
+      col_start[j + 1] += col_start[j];
+   }
+   std::vector<Index> fill(col_start.begin(), col_start.end() - 1);
+   col_nz.resize(nnz);
+   for( Index k = 0; k < nnz; k++ )
+   {
+      col_nz[fill[jCol[k]]++] = k;
+   }
+}
+
+/** Collect the columns first_col,...,ncols-1 by their group numbers.
+ *
+ *  On return, the columns of group s are group_cols[group_start[s]],...,
+ *  group_cols[group_start[s+1]-1].
+ */
+static void CollectGroups(
+   Index                     ncols,
+   Index                     first_col,
+   Index                     ngroups,
+   const std::vector<Index>& group,
+   std::vector<Index>&       group_start,
+   std::vector<Index>&       group_cols
+)
+{
+   group_start.assign(ngroups + 1, 0);
+   for( Index j = first_col; j < ncols; j++ )
+   {
+      group_start[group[j] + 1]++;
+   }
+   for( Index c = 0; c < ngroups; c++ )
+   {
+      group_start[c + 1] += group_start[c];
+   }
+   std::vector<Index> fill(group_start.begin(), group_start.end() - 1);
+   group_cols.resize(ncols - first_col);
+   for( Index j = first_col; j < ncols; j++ )
+   {
+      group_cols[fill[group[j]]++] = j;
+   }
+}
+
+/** Partition the columns first_col,...,ncols-1 of a matrix in triplet
+ *  format (0-based indices) into groups of structurally orthogonal
+ *  columns, that is, columns without nonzeros in a common row.
+ *
+ *  The columns are assigned greedily to the first group that they do
+ *  not conflict with (Curtis, Powell, and Reid).  The groups are
+ *  returned as by CollectGroups.
+ */
+static void GroupOrthogonalColumns(
+   Index               ncols,
+   Index               nrows,
+   Index               nnz,
+   const Index*        iRow,
+   const Index*        jCol,
+   Index               first_col,
+   std::vector<Index>& group_start,
+   std::vector<Index>& group_cols
+)
+{
+   std::vector<Index> col_start;
+   std::vector<Index> col_nz;
+   ColumnwiseNonzeros(ncols, nnz, jCol, col_start, col_nz);
+   std::vector<Index> row_start;
+   std::vector<Index> row_nz;
+   ColumnwiseNonzeros(nrows, nnz, iRow, row_start, row_nz);
+
+   // forbidden[c] == j if group c contains a column that shares a row with column j
+   std::vector<Index> group(ncols, -1);
+   std::vector<Index> forbidden;
+   Index ngroups = 0;
+   for( Index j = first_col; j < ncols; j++ )
+   {
+      for( Index p = col_start[j]; p < col_start[j + 1]; p++ )
+      {
+         Index r = iRow[col_nz[p]];
+         for( Index q = row_start[r]; q < row_start[r + 1]; q++ )
+         {
+            Index c = group[jCol[row_nz[q]]];
+            if( c >= 0 )
+            {
+               forbidden[c] = j;
+            }
+         }
+      }
+      Index c = 0;
+      while( c < ngroups && forbidden[c] == j )
+      {
+         c++;
+      }
+      if( c == ngroups )
+      {
+         forbidden.push_back(-1);
+         ngroups++;
+      }
+      group[j] = c;
+   }
+
+   CollectGroups(ncols, first_col, ngroups, group, group_start, group_cols);
+}
+
+/** Partition the variables of a symmetric matrix, given by the
+ *  adjacency lists of its off-diagonal nonzeros, into groups such that
+ *  adjacent variables are in different groups and every path of four
+ *  variables visits at least three groups.
+ *
+ *  This is the greedy star coloring of Gebremedhin, Manne, and Pothen.
+ *  Each off-diagonal entry of the matrix can then be read off directly
+ *  from the product with the sum of the unit vectors of a group of one
+ *  of its two variables, while such groups are usually much larger
+ *  than groups of structurally orthogonal columns.  The groups are
+ *  returned as by CollectGroups.
+ */
+static void StarColorSymmetric(
+   Index                     n,
+   const std::vector<Index>& adj_start,
+   const std::vector<Index>& adj,
+   std::vector<Index>&       group_start,
+   std::vector<Index>&       group_cols
+)
+{
+   // forbidden[c] == v if variable v must not be assigned to group c
+   std::vector<Index> group(n, -1);
+   std::vector<Index> forbidden;
+   Index ngroups = 0;
+   for( Index v = 0; v < n; v++ )
+   {
+      for( Index p = adj_start[v]; p < adj_start[v + 1]; p++ )
+      {
+         Index w = adj[p];
+         if( group[w] >= 0 )
+         {
+            forbidden[group[w]] = v;
+         }
+         for( Index q = adj_start[w]; q < adj_start[w + 1]; q++ )
+         {
+            Index x = adj[q];
+            if( x == v || group[x] < 0 )
+            {
+               continue;
+            }
+            if( group[w] < 0 )
+            {
+               // v and x would be at distance two via a variable without group
+               forbidden[group[x]] = v;
+            }
+            else
+            {
+               // avoid a path of four variables in two groups
+               for( Index r = adj_start[x]; r < adj_start[x + 1]; r++ )
+               {
+                  if( adj[r] != w && group[adj[r]] == group[w] )
+                  {
+                     forbidden[group[x]] = v;
+                     break;
+                  }
+               }
+            }
+         }
+      }
+      Index c = 0;
+      while( c < ngroups && forbidden[c] == v )
+      {
+         c++;
+      }
+      if( c == ngroups )
+      {
+         forbidden.push_back(-1);
+         ngroups++;
+      }
+      group[v] = c;
+   }
+
+   CollectGroups(n, 0, ngroups, group, group_start, group_cols);
+}
+
+/** Number of threads for evaluating a TNLP with the given concurrency
+ *  at npoints points. */
+static int PerturbedPointThreads(
+   TNLP::EvaluationConcurrency concurrency,
+   Index                       npoints
+)
+{
+   int nthreads = 1;
+#ifdef _OPENMP
+   if( npoints > 1 && concurrency != TNLP::CONCURRENCY_NONE && !omp_in_parallel() )
+   {
+      nthreads = (int) Min((Index) omp_get_max_threads(), npoints);
+   }
+#else
+   (void) concurrency;
+   (void) npoints;
+#endif
+   return nthreads > 1 ? nthreads : 1;
+}
+
 bool TNLPAdapter::internal_eval_g(
    bool new_x
 )
@@ -2637,7 +3919,7 @@ bool TNLPAdapter::internal_eval_g(
 
    x_tag_for_g_ = x_tag_for_iterates_;
 
-   bool retval = tnlp_->eval_g(n_full_x_, full_x_, new_x, n_full_g_, full_g_);
+   bool retval = eval_exact_g(new_x, full_g_);
 
    if( !retval )
    {
@@ -2660,9 +3942,21 @@ bool TNLPAdapter::internal_eval_jac_g(
    x_tag_for_jac_g_ = x_tag_for_iterates_;
 
    bool retval;
-   if( jacobian_approximation_ == JAC_EXACT )
+   if( jacobian_approximation_ == JAC_EXACT && have_varying_jac_g_ && jac_g_complete_
+       && tnlp_->eval_jac_g_varying(n_full_x_, full_x_, new_x, n_full_g_, (Index) varying_jac_g_vals_.size(),
+                                    varying_jac_g_vals_.empty() ? NULL : &varying_jac_g_vals_[0]) )
    {
-      retval = tnlp_->eval_jac_g(n_full_x_, full_x_, new_x, n_full_g_, nz_full_jac_g_, NULL, NULL, jac_g_);
+      // only the varying entries are updated
+      for( size_t i = 0; i < varying_jac_g_pos_.size(); i++ )
+      {
+         jac_g_[varying_jac_g_pos_[i]] = varying_jac_g_vals_[i];
+      }
+      retval = true;
+   }
+   else if( jacobian_approximation_ == JAC_EXACT )
+   {
+      retval = eval_exact_jac_g(new_x, jac_g_);
+      jac_g_complete_ = jac_g_complete_ || retval;
    }
    else
    {
@@ -2670,39 +3964,90 @@ bool TNLPAdapter::internal_eval_jac_g(
       retval = internal_eval_g(new_x);
       if( retval )
       {
-         Number* full_g_pert = new Number[n_full_g_];
-         Number* full_x_pert = new Number[n_full_x_];
-         IpBlasDcopy(n_full_x_, full_x_, 1, full_x_pert, 1);
-         // Compute the finite difference Jacobian
+         // Perturb all variables of a group of structurally orthogonal
+         // columns at once, so that there is one evaluation per group
+         const Index ngroups = (Index) findiff_jac_group_start_.size() - 1;
+         const int nthreads = PerturbedPointThreads(evaluation_concurrency_, ngroups);
+         std::vector<Number> perturbation(n_full_x_, 0.);
          for( Index ivar = 0; ivar < n_full_x_; ivar++ )
          {
             if( findiff_x_l_[ivar] < findiff_x_u_[ivar] )
             {
-               const Number xorig = full_x_pert[ivar];
-               Number this_perturbation = findiff_perturbation_ * Max(1., fabs(full_x_[ivar]));
-               full_x_pert[ivar] += this_perturbation;
-               if( full_x_pert[ivar] > findiff_x_u_[ivar] )
+               perturbation[ivar] = findiff_perturbation_ * Max(1., fabs(full_x_[ivar]));
+               if( full_x_[ivar] + perturbation[ivar] > findiff_x_u_[ivar] )
                {
                   // if at upper bound, then change direction towards lower bound
-                  this_perturbation = -this_perturbation;
-                  full_x_pert[ivar] = xorig + this_perturbation;
+                  perturbation[ivar] = -perturbation[ivar];
+               }
+            }
+         }
+         std::vector<Number> full_x_pert((size_t) nthreads * n_full_x_);
+         std::vector<Number> full_g_pert((size_t) nthreads * n_full_g_);
+         std::vector<int> ok(nthreads);
+
+         // Compute the finite difference Jacobian
+         for( Index s0 = 0; retval && s0 < ngroups; s0 += nthreads )
+         {
+            const Index nchunk = Min((Index) nthreads, ngroups - s0);
+            for( Index t = 0; t < nchunk; t++ )
+            {
+               Number* x_t = &full_x_pert[(size_t) t * n_full_x_];
+               IpBlasDcopy(n_full_x_, full_x_, 1, x_t, 1);
+               for( Index p = findiff_jac_group_start_[s0 + t]; p < findiff_jac_group_start_[s0 + t + 1]; p++ )
+               {
+                  const Index ivar = findiff_jac_group_cols_[p];
+                  x_t[ivar] += perturbation[ivar];
                }
-               retval = tnlp_->eval_g(n_full_x_, full_x_pert, true, n_full_g_, full_g_pert);
-               if( !retval )
+            }
+            if( nthreads > 1 )
+            {
+               // The threads only call the TNLP.  Exceptions must not leave
+               // the parallel region; they are turned into a failed evaluation.
+#ifdef _OPENMP
+               #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+#endif
+               for( Index t = 0; t < nchunk; t++ )
+               {
+                  try
+                  {
+                     ok[t] = tnlp_->eval_g(n_full_x_, &full_x_pert[(size_t) t * n_full_x_], true, n_full_g_,
+                                           &full_g_pert[(size_t) t * n_full_g_]);
+                  }
+                  catch( ... )
+                  {
+                     ok[t] = false;
+                  }
+               }
+            }
+            else
+            {
+               ok[0] = tnlp_->eval_g(n_full_x_, &full_x_pert[0], true, n_full_g_, &full_g_pert[0]);
+            }
+
+            for( Index t = 0; t < nchunk; t++ )
+            {
+               if( !ok[t] )
                {
+                  retval = false;
                   break;
                }
-               for( Index i = findiff_jac_ia_[ivar]; i < findiff_jac_ia_[ivar + 1]; i++ )
+               const Number* g_t = &full_g_pert[(size_t) t * n_full_g_];
+               for( Index p = findiff_jac_group_start_[s0 + t]; p < findiff_jac_group_start_[s0 + t + 1]; p++ )
                {
-                  const Index& icon = findiff_jac_ja_[i];
-                  const Index& ipos = findiff_jac_postriplet_[i];
-                  jac_g_[ipos] = (full_g_pert[icon] - full_g_[icon]) / this_perturbation;
+                  const Index ivar = findiff_jac_group_cols_[p];
+                  if( perturbation[ivar] == 0. )
+                  {
+                     continue;
+                  }
+                  for( Index i = findiff_jac_ia_[ivar]; i < findiff_jac_ia_[ivar + 1]; i++ )
+                  {
+                     const Index& icon = findiff_jac_ja_[i];
+                     const Index& ipos = findiff_jac_postriplet_[i];
+                     jac_g_[ipos] = (g_t[icon] - full_g_[icon]) / perturbation[ivar];
+                  }
                }
-               full_x_pert[ivar] = xorig;
             }
          }
-         delete[] full_g_pert;
-         delete[] full_x_pert;
       }
    }
 
@@ -2714,6 +4059,290 @@ bool TNLPAdapter::internal_eval_jac_g(
    return retval;
 }
 
+bool TNLPAdapter::eval_exact_g(
+   bool    new_x,
+   Number* values
+)
+{
+   int nthreads = RowRangeThreads();
+   if( nthreads > 1 )
+   {
+      return eval_g_by_rows(new_x, nthreads, values);
+   }
+   return tnlp_->eval_g(n_full_x_, full_x_, new_x, n_full_g_, values);
+}
+
+bool TNLPAdapter::eval_exact_jac_g(
+   bool    new_x,
+   Number* values
+)
+{
+   int nthreads = RowRangeThreads();
+   if( nthreads > 1 )
+   {
+      return eval_jac_g_by_rows(new_x, nthreads, values);
+   }
+   return tnlp_->eval_jac_g(n_full_x_, full_x_, new_x, n_full_g_, nz_full_jac_g_, NULL, NULL, values);
+}
+
+int TNLPAdapter::RowRangeThreads() const
+{
+#ifdef _OPENMP
+   if( evaluation_concurrency_ == TNLP::CONCURRENCY_ROW_RANGES && n_full_g_ > 1 && !omp_in_parallel() )
+   {
+      return (int) Min((Index) omp_get_max_threads(), n_full_g_);
+   }
+#endif
+   return 1;
+}
+
+bool TNLPAdapter::eval_g_by_rows(
+   bool    new_x,
+   int     nthreads,
+   Number* values
+)
+{
+   // Exceptions must not leave the parallel region; they are turned
+   // into a failed evaluation
+   bool* ok = new bool[nthreads];
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+#endif
+   for( int blk = 0; blk < nthreads; blk++ )
+   {
+      try
+      {
+         ok[blk] = tnlp_->eval_g_rows(n_full_x_, full_x_, new_x, n_full_g_, BlockStart(n_full_g_, nthreads, blk),
+                                      BlockStart(n_full_g_, nthreads, blk + 1), values);
+      }
+      catch( ... )
+      {
+         ok[blk] = false;
+      }
+   }
+
+   bool retval = true;
+   for( int blk = 0; blk < nthreads; blk++ )
+   {
+      retval = retval && ok[blk];
+   }
+   delete[] ok;
+
+   return retval;
+}
+
+bool TNLPAdapter::eval_jac_g_by_rows(
+   bool    new_x,
+   int     nthreads,
+   Number* values
+)
+{
+   // Exceptions must not leave the parallel region; they are turned
+   // into a failed evaluation
+   bool* ok = new bool[nthreads];
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+#endif
+   for( int blk = 0; blk < nthreads; blk++ )
+   {
+      try
+      {
+         ok[blk] = tnlp_->eval_jac_g_rows(n_full_x_, full_x_, new_x, n_full_g_, BlockStart(n_full_g_, nthreads, blk),
+                                          BlockStart(n_full_g_, nthreads, blk + 1), nz_full_jac_g_, values);
+      }
+      catch( ... )
+      {
+         ok[blk] = false;
+      }
+   }
+
+   bool retval = true;
+   for( int blk = 0; blk < nthreads; blk++ )
+   {
+      retval = retval && ok[blk];
+   }
+   delete[] ok;
+
+   return retval;
+}
+
+/** Create a DenseVectorSpace with the dimension and the meta data of space */
+static SmartPtr<const VectorSpace> CopyDenseVectorSpace(
+   const VectorSpace& space
+)
+{
+   DBG_ASSERT(dynamic_cast<const DenseVectorSpace*>(&space));
+   const DenseVectorSpace& dspace = static_cast<const DenseVectorSpace&>(space);
+   SmartPtr<DenseVectorSpace> copy = new DenseVectorSpace(dspace.Dim(), dspace.UseHugePages());
+   for( StringMetaDataMapType::const_iterator iter = dspace.GetStringMetaData().begin();
+        iter != dspace.GetStringMetaData().end(); ++iter )
+   {
+      copy->SetStringMetaData(iter->first, iter->second);
+   }
+   for( IntegerMetaDataMapType::const_iterator iter = dspace.GetIntegerMetaData().begin();
+        iter != dspace.GetIntegerMetaData().end(); ++iter )
+   {
+      copy->SetIntegerMetaData(iter->first, iter->second);
+   }
+   for( NumericMetaDataMapType::const_iterator iter = dspace.GetNumericMetaData().begin();
+        iter != dspace.GetNumericMetaData().end(); ++iter )
+   {
+      copy->SetNumericMetaData(iter->first, iter->second);
+   }
+   return GetRawPtr(copy);
+}
+
+/** Return a copy of an array of n indices, or NULL if the array is NULL */
+static Index* CopyIndexArray(
+   Index        n,
+   const Index* src
+)
+{
+   if( src == NULL )
+   {
+      return NULL;
+   }
+   Index* copy = new Index[n];
+   for( Index i = 0; i < n; i++ )
+   {
+      copy[i] = src[i];
+   }
+   return copy;
+}
+
+void TNLPAdapter::CopyStructure(
+   const TNLPAdapter& source
+)
+{
+   DBG_START_METH("TNLPAdapter::CopyStructure", dbg_verbosity);
+
+   ASSERT_EXCEPTION(source.full_x_ != NULL, INVALID_TNLP,
+                    "The structure source of TNLPAdapter has not set up a problem structure yet.");
+   ASSERT_EXCEPTION(
+      n_full_x_ == source.n_full_x_ && n_full_g_ == source.n_full_g_ && nz_full_jac_g_ == source.nz_full_jac_g_
+      && nz_full_h_ == source.nz_full_h_ && index_style_ == source.index_style_, INVALID_TNLP,
+      "The problem dimensions differ from those of the structure source of TNLPAdapter.");
+   ASSERT_EXCEPTION(
+      hessian_approximation_ == source.hessian_approximation_
+      && hessian_approximation_exact_part_ == source.hessian_approximation_exact_part_
+      && jacobian_approximation_ == source.jacobian_approximation_, OPTION_INVALID,
+      "The derivative approximation options differ from those of the structure source of TNLPAdapter.");
+
+   if( IsValid(jnlst_) )
+   {
+      jnlst_->Printf(J_DETAILED, J_INITIALIZATION, "Reusing problem structure of another TNLPAdapter.\n");
+   }
+
+   // the source may have switched to relaxing the bounds of fixed variables
+   fixed_variable_treatment_ = source.fixed_variable_treatment_;
+   n_x_fixed_ = source.n_x_fixed_;
+   nz_jac_c_ = source.nz_jac_c_;
+   nz_jac_c_no_extra_ = source.nz_jac_c_no_extra_;
+   nz_jac_d_ = source.nz_jac_d_;
+   nz_h_ = source.nz_h_;
+   nz_full_elem_ = source.nz_full_elem_;
+   elem_start_ = source.elem_start_;
+   elem_vars_ = source.elem_vars_;
+   elem_idx_map_ = source.elem_idx_map_;
+   jac_c_direct_ = source.jac_c_direct_;
+   jac_d_direct_ = source.jac_d_direct_;
+   g_c_direct_ = source.g_c_direct_;
+   g_d_direct_ = source.g_d_direct_;
+
+   // vector spaces recycle the storage of their vectors, so we need our own
+   x_space_ = CopyDenseVectorSpace(*source.x_space_);
+   c_space_ = CopyDenseVectorSpace(*source.c_space_);
+   d_space_ = CopyDenseVectorSpace(*source.d_space_);
+   x_l_space_ = CopyDenseVectorSpace(*source.x_l_space_);
+   x_u_space_ = CopyDenseVectorSpace(*source.x_u_space_);
+   d_l_space_ = CopyDenseVectorSpace(*source.d_l_space_);
+   d_u_space_ = CopyDenseVectorSpace(*source.d_u_space_);
+
+   // matrix spaces are not modified after their creation and can be shared
+   px_l_space_ = source.px_l_space_;
+   px_u_space_ = source.px_u_space_;
+   pd_l_space_ = source.pd_l_space_;
+   pd_u_space_ = source.pd_u_space_;
+   Jac_c_space_ = source.Jac_c_space_;
+   Jac_d_space_ = source.Jac_d_space_;
+   Hess_lagrangian_space_ = source.Hess_lagrangian_space_;
+
+   // matrices cache their validity, so we need our own
+   P_x_full_x_space_ = source.P_x_full_x_space_;
+   if( IsValid(P_x_full_x_space_) )
+   {
+      P_x_full_x_ = P_x_full_x_space_->MakeNewExpansionMatrix();
+   }
+   else
+   {
+      P_x_full_x_ = NULL;
+   }
+   P_x_x_L_space_ = source.P_x_x_L_space_;
+   P_x_x_L_ = P_x_x_L_space_->MakeNewExpansionMatrix();
+   P_x_x_U_space_ = source.P_x_x_U_space_;
+   P_x_x_U_ = P_x_x_U_space_->MakeNewExpansionMatrix();
+   P_c_g_space_ = source.P_c_g_space_;
+   P_c_g_ = P_c_g_space_->MakeNewExpansionMatrix();
+   P_d_g_space_ = source.P_d_g_space_;
+   P_d_g_ = P_d_g_space_->MakeNewExpansionMatrix();
+
+   // full_x_ holds the values of the fixed variables
+   full_x_ = new Number[n_full_x_];
+   IpBlasDcopy(n_full_x_, source.full_x_, 1, full_x_, 1);
+   full_lambda_ = new Number[n_full_g_];
+   IpBlasDcopy(n_full_g_, source.full_lambda_, 1, full_lambda_, 1);
+   full_g_ = new Number[n_full_g_];
+   jac_g_ = new Number[nz_full_jac_g_];
+   c_rhs_ = new Number[c_space_->Dim()];
+
+   Index nz_jac_all;
+   if( fixed_variable_treatment_ == MAKE_PARAMETER )
+   {
+      nz_jac_all = nz_full_jac_g_;
+   }
+   else
+   {
+      nz_jac_all = nz_full_jac_g_ + n_x_fixed_;
+   }
+   jac_idx_map_ = CopyIndexArray(nz_jac_all, source.jac_idx_map_);
+   h_idx_map_ = CopyIndexArray(nz_full_h_, source.h_idx_map_);
+   x_fixed_map_ = CopyIndexArray(n_x_fixed_, source.x_fixed_map_);
+
+   // eval_h_block is only called if our TNLP supports concurrent evaluations
+   if( evaluation_concurrency_ != TNLP::CONCURRENCY_NONE && source.n_h_blocks_ > 0 )
+   {
+      n_h_blocks_ = source.n_h_blocks_;
+      h_block_start_ = CopyIndexArray(n_h_blocks_ + 1, source.h_block_start_);
+   }
+
+   h_comp_con_ = source.h_comp_con_;
+   h_comp_pos_ = source.h_comp_pos_;
+   h_comp_values_.resize(source.h_comp_values_.size());
+   h_comp_x_tag_ = 0;
+
+   if( source.findiff_jac_ia_ != NULL )
+   {
+      delete[] findiff_jac_ia_;
+      delete[] findiff_jac_ja_;
+      delete[] findiff_jac_postriplet_;
+      findiff_jac_nnz_ = source.findiff_jac_nnz_;
+      findiff_jac_ia_ = CopyIndexArray(n_full_x_ + 1, source.findiff_jac_ia_);
+      findiff_jac_ja_ = CopyIndexArray(findiff_jac_nnz_, source.findiff_jac_ja_);
+      findiff_jac_postriplet_ = CopyIndexArray(findiff_jac_nnz_, source.findiff_jac_postriplet_);
+      findiff_jac_group_start_ = source.findiff_jac_group_start_;
+      findiff_jac_group_cols_ = source.findiff_jac_group_cols_;
+   }
+
+   findiff_hess_jac_row_ = source.findiff_hess_jac_row_;
+   findiff_hess_jac_col_ = source.findiff_hess_jac_col_;
+   findiff_hess_group_start_ = source.findiff_hess_group_start_;
+   findiff_hess_group_cols_ = source.findiff_hess_group_cols_;
+   findiff_hess_entry_start_ = source.findiff_hess_entry_start_;
+   findiff_hess_entry_pos_ = source.findiff_hess_entry_pos_;
+   findiff_hess_entry_row_ = source.findiff_hess_entry_row_;
+   findiff_hess_entry_col_ = source.findiff_hess_entry_col_;
+}
+
 void TNLPAdapter::initialize_findiff_jac(
    const Index* iRow,
    const Index* jCol
@@ -2767,6 +4396,310 @@ void TNLPAdapter::initialize_findiff_jac(
       findiff_jac_postriplet_[i] = postrip[i];
    }
 
+   // Group the columns that can be perturbed at once
+   std::vector<Index> rows(nz_full_jac_g_);
+   std::vector<Index> cols(nz_full_jac_g_);
+   for( Index i = 0; i < nz_full_jac_g_; i++ )
+   {
+      rows[i] = iRow[i] - 1;
+      cols[i] = jCol[i] - 1;
+   }
+   GroupOrthogonalColumns(n_full_x_, n_full_g_, nz_full_jac_g_, &rows[0], &cols[0], 0, findiff_jac_group_start_,
+                          findiff_jac_group_cols_);
+   if( IsValid(jnlst_) )
+   {
+      jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
+                     "Finite difference Jacobian is computed from %" IPOPT_INDEX_FORMAT " groups of structurally orthogonal columns.\n",
+                     (Index) findiff_jac_group_start_.size() - 1);
+   }
+}
+
+void TNLPAdapter::initialize_findiff_hess(
+   const Index* iRow,
+   const Index* jCol
+)
+{
+   // Jacobian structure for the gradient of the Lagrangian (0-based)
+   findiff_hess_jac_row_.resize(nz_full_jac_g_);
+   findiff_hess_jac_col_.resize(nz_full_jac_g_);
+   if( nz_full_jac_g_ > 0 )
+   {
+      bool retval = tnlp_->eval_jac_g(n_full_x_, NULL, false, n_full_g_, nz_full_jac_g_, &findiff_hess_jac_row_[0],
+                                      &findiff_hess_jac_col_[0], NULL);
+      ASSERT_EXCEPTION(retval, INVALID_TNLP, "eval_jac_g returned false for the Jacobian structure");
+      if( index_style_ == TNLP::FORTRAN_STYLE )
+      {
+         for( Index i = 0; i < nz_full_jac_g_; i++ )
+         {
+            findiff_hess_jac_row_[i] -= 1;
+            findiff_hess_jac_col_[i] -= 1;
+         }
+      }
+   }
+
+   // adjacency lists of the variables and the entries in each column of
+   // the full symmetric Hessian structure (0-based)
+   std::vector<Index> col_start(n_full_x_ + 1, 0);
+   std::vector<Index> adj_start(n_full_x_ + 1, 0);
+   for( Index i = 0; i < nz_full_h_; i++ )
+   {
+      col_start[jCol[i]]++;
+      if( iRow[i] != jCol[i] )
+      {
+         col_start[iRow[i]]++;
+         adj_start[jCol[i]]++;
+         adj_start[iRow[i]]++;
+      }
+   }
+   for( Index j = 0; j < n_full_x_; j++ )
+   {
+      col_start[j + 1] += col_start[j];
+      adj_start[j + 1] += adj_start[j];
+   }
+   std::vector<Index> col_row(col_start[n_full_x_]);
+   std::vector<Index> col_pos(col_start[n_full_x_]);
+   std::vector<Index> adj(adj_start[n_full_x_]);
+   std::vector<Index> col_fill(col_start.begin(), col_start.end() - 1);
+   std::vector<Index> adj_fill(adj_start.begin(), adj_start.end() - 1);
+   for( Index i = 0; i < nz_full_h_; i++ )
+   {
+      const Index row = iRow[i] - 1;
+      const Index col = jCol[i] - 1;
+      col_row[col_fill[col]] = row;
+      col_pos[col_fill[col]++] = i;
+      if( row != col )
+      {
+         col_row[col_fill[row]] = col;
+         col_pos[col_fill[row]++] = i;
+         adj[adj_fill[col]++] = row;
+         adj[adj_fill[row]++] = col;
+      }
+   }
+   std::vector<Index> mark(n_full_x_, -1);
+   for( Index j = 0; j < n_full_x_; j++ )
+   {
+      for( Index p = col_start[j]; p < col_start[j + 1]; p++ )
+      {
+         if( mark[col_row[p]] == j )
+         {
+            THROW_EXCEPTION(INVALID_TNLP,
+                            "Sparsity structure of Hessian has multiple occurrences of the same position.  This is not allowed for finite differences.");
+         }
+         mark[col_row[p]] = j;
+      }
+   }
+
+   StarColorSymmetric(n_full_x_, adj_start, adj, findiff_hess_group_start_, findiff_hess_group_cols_);
+
+   // For each entry, find a group such that the entry is the only one of
+   // the group in its row.  This holds for each entry and one of the groups
+   // of its row and column variable.
+   std::vector<Index> entry_group(nz_full_h_, -1);
+   std::vector<Index> entry_row(nz_full_h_);
+   std::vector<Index> entry_col(nz_full_h_);
+   std::vector<Index> count(n_full_x_, 0);
+   const Index ngroups = (Index) findiff_hess_group_start_.size() - 1;
+   for( Index s = 0; s < ngroups; s++ )
+   {
+      for( Index p = findiff_hess_group_start_[s]; p < findiff_hess_group_start_[s + 1]; p++ )
+      {
+         const Index j = findiff_hess_group_cols_[p];
+         for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+         {
+            count[col_row[q]]++;
+         }
+      }
+      for( Index p = findiff_hess_group_start_[s]; p < findiff_hess_group_start_[s + 1]; p++ )
+      {
+         const Index j = findiff_hess_group_cols_[p];
+         for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+         {
+            const Index k = col_pos[q];
+            if( entry_group[k] < 0 && count[col_row[q]] == 1 )
+            {
+               entry_group[k] = s;
+               entry_row[k] = col_row[q];
+               entry_col[k] = j;
+            }
+         }
+      }
+      for( Index p = findiff_hess_group_start_[s]; p < findiff_hess_group_start_[s + 1]; p++ )
+      {
+         const Index j = findiff_hess_group_cols_[p];
+         for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+         {
+            count[col_row[q]] = 0;
+         }
+      }
+   }
+   for( Index k = 0; k < nz_full_h_; k++ )
+   {
+      ASSERT_EXCEPTION(entry_group[k] >= 0, INTERNAL_ABORT, "Star coloring of the Hessian structure is invalid.");
+   }
+
+   // sort the entries by groups
+   findiff_hess_entry_start_.assign(ngroups + 1, 0);
+   for( Index k = 0; k < nz_full_h_; k++ )
+   {
+      findiff_hess_entry_start_[entry_group[k] + 1]++;
+   }
+   for( Index s = 0; s < ngroups; s++ )
+   {
+      findiff_hess_entry_start_[s + 1] += findiff_hess_entry_start_[s];
+   }
+   std::vector<Index> fill(findiff_hess_entry_start_.begin(), findiff_hess_entry_start_.end() - 1);
+   findiff_hess_entry_pos_.resize(nz_full_h_);
+   findiff_hess_entry_row_.resize(nz_full_h_);
+   findiff_hess_entry_col_.resize(nz_full_h_);
+   for( Index k = 0; k < nz_full_h_; k++ )
+   {
+      const Index e = fill[entry_group[k]]++;
+      findiff_hess_entry_pos_[e] = k;
+      findiff_hess_entry_row_[e] = entry_row[k];
+      findiff_hess_entry_col_[e] = entry_col[k];
+   }
+
+   if( IsValid(jnlst_) )
+   {
+      jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
+                     "Finite difference Hessian is computed from %" IPOPT_INDEX_FORMAT " groups of variables of a star coloring.\n", ngroups);
+   }
+}
+
+bool TNLPAdapter::eval_findiff_grad_lag(
+   const Number* x,
+   bool          new_x,
+   Number        obj_factor,
+   Number*       grad_lag,
+   Number*       jac_values
+)
+{
+   if( !tnlp_->eval_grad_f(n_full_x_, x, new_x, grad_lag) )
+   {
+      return false;
+   }
+   for( Index j = 0; j < n_full_x_; j++ )
+   {
+      grad_lag[j] *= obj_factor;
+   }
+   if( nz_full_jac_g_ > 0 )
+   {
+      if( !tnlp_->eval_jac_g(n_full_x_, x, new_x, n_full_g_, nz_full_jac_g_, NULL, NULL, jac_values) )
+      {
+         return false;
+      }
+      for( Index i = 0; i < nz_full_jac_g_; i++ )
+      {
+         grad_lag[findiff_hess_jac_col_[i]] += full_lambda_[findiff_hess_jac_row_[i]] * jac_values[i];
+      }
+   }
+   return true;
+}
+
+bool TNLPAdapter::eval_findiff_h(
+   bool    new_x,
+   Number  obj_factor,
+   Number* full_h
+)
+{
+   const Index ngroups = (Index) findiff_hess_group_start_.size() - 1;
+   const int nthreads = PerturbedPointThreads(evaluation_concurrency_, ngroups);
+   std::vector<Number> grad_lag((size_t) (nthreads + 1) * n_full_x_);
+   std::vector<Number> jac_values((size_t) (nthreads + 1) * Max(nz_full_jac_g_, (Index) 1));
+
+   // gradient of the Lagrangian at the reference point, at the end of grad_lag
+   Number* grad_ref = &grad_lag[(size_t) nthreads * n_full_x_];
+   if( !eval_findiff_grad_lag(full_x_, new_x, obj_factor, grad_ref, &jac_values[(size_t) nthreads * Max(nz_full_jac_g_,
+                              (Index) 1)]) )
+   {
+      return false;
+   }
+
+   std::vector<Number> perturbation(n_full_x_, 0.);
+   for( Index ivar = 0; ivar < n_full_x_; ivar++ )
+   {
+      if( findiff_x_l_[ivar] < findiff_x_u_[ivar] )
+      {
+         perturbation[ivar] = findiff_perturbation_ * Max(1., fabs(full_x_[ivar]));
+         if( full_x_[ivar] + perturbation[ivar] > findiff_x_u_[ivar] )
+         {
+            // if at upper bound, then change direction towards lower bound
+            perturbation[ivar] = -perturbation[ivar];
+         }
+      }
+   }
+   std::vector<Number> x_pert((size_t) nthreads * n_full_x_);
+   std::vector<int> ok(nthreads);
+
+   bool retval = true;
+   for( Index s0 = 0; retval && s0 < ngroups; s0 += nthreads )
+   {
+      const Index nchunk = Min((Index) nthreads, ngroups - s0);
+      for( Index t = 0; t < nchunk; t++ )
+      {
+         Number* x_t = &x_pert[(size_t) t * n_full_x_];
+         IpBlasDcopy(n_full_x_, full_x_, 1, x_t, 1);
+         for( Index p = findiff_hess_group_start_[s0 + t]; p < findiff_hess_group_start_[s0 + t + 1]; p++ )
+         {
+            const Index ivar = findiff_hess_group_cols_[p];
+            x_t[ivar] += perturbation[ivar];
+         }
+      }
+      if( nthreads > 1 )
+      {
+         // The threads only call the TNLP.  Exceptions must not leave
+         // the parallel region; they are turned into a failed evaluation.
+#ifdef _OPENMP
+         #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+#endif
+         for( Index t = 0; t < nchunk; t++ )
+         {
+            try
+            {
+               ok[t] = eval_findiff_grad_lag(&x_pert[(size_t) t * n_full_x_], true, obj_factor,
+                                             &grad_lag[(size_t) t * n_full_x_],
+                                             &jac_values[(size_t) t * Max(nz_full_jac_g_, (Index) 1)]);
+            }
+            catch( ... )
+            {
+               ok[t] = false;
+            }
+         }
+      }
+      else
+      {
+         ok[0] = eval_findiff_grad_lag(&x_pert[0], true, obj_factor, &grad_lag[0], &jac_values[0]);
+      }
+
+      for( Index t = 0; t < nchunk; t++ )
+      {
+         if( !ok[t] )
+         {
+            retval = false;
+            break;
+         }
+         const Number* grad_t = &grad_lag[(size_t) t * n_full_x_];
+         for( Index e = findiff_hess_entry_start_[s0 + t]; e < findiff_hess_entry_start_[s0 + t + 1]; e++ )
+         {
+            const Index row = findiff_hess_entry_row_[e];
+            const Index col = findiff_hess_entry_col_[e];
+            if( perturbation[col] == 0. )
+            {
+               full_h[findiff_hess_entry_pos_[e]] = 0.;
+            }
+            else
+            {
+               full_h[findiff_hess_entry_pos_[e]] = (grad_t[row] - grad_ref[row]) / perturbation[col];
+            }
+         }
+      }
+   }
+
+   // the TNLP has seen the perturbed points since the last call at
+   // full_x_, so the next call has to be made with new_x = true
+   x_tag_for_iterates_ = 0;
+
+   return retval;
 }
 
 bool TNLPAdapter::CheckDerivatives(
@@ -2910,7 +4843,14 @@ bool TNLPAdapter::CheckDerivatives(
       index_correction = 1;
    }
 
-   if( deriv_test == FIRST_ORDER_TEST || deriv_test == SECOND_ORDER_TEST )
+   if( derivative_test_sparse_ && (deriv_test == FIRST_ORDER_TEST || deriv_test == SECOND_ORDER_TEST) )
+   {
+      jnlst_->Printf(J_SUMMARY, J_NLP, "Starting sparse derivative checker for first derivatives.\n\n");
+
+      nerrors += CheckFirstDerivativesByGroups(nx, ng, nz_jac_g, xref, fref, gref, grad_f, g_iRow, g_jCol, jac_g,
+                 Max(0, deriv_test_start_index), index_correction);
+   }
+   else if( deriv_test == FIRST_ORDER_TEST || deriv_test == SECOND_ORDER_TEST )
    {
       jnlst_->Printf(J_SUMMARY, J_NLP, "Starting derivative checker for first derivatives.\n\n");
 
@@ -2939,7 +4879,7 @@ bool TNLPAdapter::CheckDerivatives(
          }
          if( cflag != ' ' || derivative_test_print_all_ )
          {
-            jnlst_->Printf(J_WARNING, J_NLP, "%c grad_f[      %5d] = %23.16e    ~ %23.16e  [%10.3e]\n", cflag,
+            jnlst_->Printf(J_WARNING, J_NLP, "%c grad_f[      %5" IPOPT_INDEX_FORMAT "] = %23.16e    ~ %23.16e  [%10.3e]\n", cflag,
                            ivar + index_correction, deriv_exact, deriv_approx, rel_error);
          }
 
@@ -2976,7 +4916,7 @@ bool TNLPAdapter::CheckDerivatives(
                }
                if( cflag != ' ' || derivative_test_print_all_ )
                {
-                  jnlst_->Printf(J_WARNING, J_NLP, "%c jac_g [%5d,%5d] = %23.16e %c  ~ %23.16e  [%10.3e]\n", cflag,
+                  jnlst_->Printf(J_WARNING, J_NLP, "%c jac_g [%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e %c  ~ %23.16e  [%10.3e]\n", cflag,
                                  icon + index_correction, ivar + index_correction, deriv_exact, sflag, deriv_approx, rel_error);
                }
             }
@@ -2987,7 +4927,14 @@ bool TNLPAdapter::CheckDerivatives(
 
    }
    const Number zero = 0.;
-   if( deriv_test == SECOND_ORDER_TEST || deriv_test == ONLY_SECOND_ORDER_TEST )
+   if( derivative_test_sparse_ && (deriv_test == SECOND_ORDER_TEST || deriv_test == ONLY_SECOND_ORDER_TEST) )
+   {
+      jnlst_->Printf(J_SUMMARY, J_NLP, "Starting sparse derivative checker for second derivatives.\n\n");
+
+      nerrors += CheckSecondDerivativesByGroups(nx, ng, nz_jac_g, nz_hess_lag, xref, grad_f, g_iRow, g_jCol, jac_g,
+                 Max(-1, deriv_test_start_index), index_correction);
+   }
+   else if( deriv_test == SECOND_ORDER_TEST || deriv_test == ONLY_SECOND_ORDER_TEST )
    {
       jnlst_->Printf(J_SUMMARY, J_NLP, "Starting derivative checker for second derivatives.\n\n");
 
@@ -3128,13 +5075,13 @@ bool TNLPAdapter::CheckDerivatives(
                   if( icon == -1 )
                   {
                      jnlst_->Printf(J_WARNING, J_NLP,
-                                    "%c             obj_hess[%5d,%5d] = %23.16e %c  ~ %23.16e  [%10.3e]\n", cflag,
+                                    "%c             obj_hess[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e %c  ~ %23.16e  [%10.3e]\n", cflag,
                                     ivar + index_correction, ivar2 + index_correction, deriv_exact, sflag, deriv_approx, rel_error);
                   }
                   else
                   {
                      jnlst_->Printf(J_WARNING, J_NLP,
-                                    "%c %5d-th constr_hess[%5d,%5d] = %23.16e %c  ~ %23.16e  [%10.3e]\n", cflag,
+                                    "%c %5" IPOPT_INDEX_FORMAT "-th constr_hess[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e %c  ~ %23.16e  [%10.3e]\n", cflag,
                                     icon + index_correction, ivar + index_correction, ivar2 + index_correction, deriv_exact, sflag,
                                     deriv_approx, rel_error);
                   }
@@ -3175,12 +5122,534 @@ bool TNLPAdapter::CheckDerivatives(
    }
    else
    {
-      jnlst_->Printf(J_WARNING, J_NLP, "\nDerivative checker detected %d error(s).\n\n", nerrors);
+      jnlst_->Printf(J_WARNING, J_NLP, "\nDerivative checker detected %" IPOPT_INDEX_FORMAT " error(s).\n\n", nerrors);
    }
 
    return retval;
 }
 
+Index TNLPAdapter::CheckFirstDerivativesByGroups(
+   Index         nx,
+   Index         ng,
+   Index         nz_jac_g,
+   const Number* xref,
+   Number        fref,
+   const Number* gref,
+   const Number* grad_f,
+   const Index*  g_iRow,
+   const Index*  g_jCol,
+   const Number* jac_g,
+   Index         ivar_first,
+   Index         index_correction
+)
+{
+   if( ivar_first >= nx )
+   {
+      return 0;
+   }
+
+   std::vector<Index> group_start;
+   std::vector<Index> group_cols;
+   GroupOrthogonalColumns(nx, ng, nz_jac_g, g_iRow, g_jCol, ivar_first, group_start, group_cols);
+   Index ngroups = (Index) group_start.size() - 1;
+   std::vector<Index> col_start;
+   std::vector<Index> col_nz;
+   ColumnwiseNonzeros(nx, nz_jac_g, g_jCol, col_start, col_nz);
+
+   int nthreads = PerturbedPointThreads(tnlp_->get_evaluation_concurrency(), ngroups);
+   jnlst_->Printf(J_SUMMARY, J_NLP, "Perturbing %" IPOPT_INDEX_FORMAT " groups of structurally orthogonal variables using %d thread(s).\n\n",
+                  ngroups, nthreads);
+
+   std::vector<Number> perturbation(nx);
+   for( Index j = 0; j < nx; j++ )
+   {
+      perturbation[j] = derivative_test_perturbation_ * Max(1., fabs(xref[j]));
+   }
+
+   std::vector<Number> xpert((size_t) nthreads * nx);
+   std::vector<Number> fpert(nthreads);
+   std::vector<Number> gpert((size_t) nthreads * ng);
+   std::vector<int> ok(nthreads);
+   // column and value of the Jacobian entry of each constraint within the current group
+   std::vector<Index> row_col(ng, -1);
+   std::vector<Number> row_exact(ng, 0.);
+
+   Index nerrors = 0;
+   for( Index s0 = 0; s0 < ngroups; s0 += nthreads )
+   {
+      Index nchunk = Min((Index) nthreads, ngroups - s0);
+
+      // The threads only call the TNLP.  Exceptions must not leave the
+      // parallel region; they are turned into a failed evaluation.
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+#endif
+      for( Index t = 0; t < nchunk; t++ )
+      {
+         Number* x_t = &xpert[(size_t) t * nx];
+         IpBlasDcopy(nx, xref, 1, x_t, 1);
+         for( Index p = group_start[s0 + t]; p < group_start[s0 + t + 1]; p++ )
+         {
+            x_t[group_cols[p]] += perturbation[group_cols[p]];
+         }
+         try
+         {
+            ok[t] = tnlp_->eval_f(nx, x_t, true, fpert[t]);
+            if( ok[t] && ng > 0 )
+            {
+               ok[t] = tnlp_->eval_g(nx, x_t, true, ng, &gpert[(size_t) t * ng]);
+            }
+         }
+         catch( ... )
+         {
+            ok[t] = false;
+         }
+      }
+
+      for( Index t = 0; t < nchunk; t++ )
+      {
+         ASSERT_EXCEPTION(ok[t], ERROR_IN_TNLP_DERIVATIVE_TEST,
+                          "In TNLP derivative test: f or g could not be evaluated at perturbed point.");
+         const Index s = s0 + t;
+         const Number* g_t = &gpert[(size_t) t * ng];
+
+         // directional derivative of the objective, scaled by the largest perturbation of the group
+         Number max_perturbation = 0.;
+         for( Index p = group_start[s]; p < group_start[s + 1]; p++ )
+         {
+            max_perturbation = Max(max_perturbation, perturbation[group_cols[p]]);
+         }
+         Number deriv_exact = 0.;
+         for( Index p = group_start[s]; p < group_start[s + 1]; p++ )
+         {
+            Index j = group_cols[p];
+            deriv_exact += grad_f[j] * (perturbation[j] / max_perturbation);
+            for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+            {
+               Index k = col_nz[q];
+               row_col[g_iRow[k]] = j;
+               row_exact[g_iRow[k]] += jac_g[k];
+            }
+         }
+
+         Number deriv_approx = (fpert[t] - fref) / max_perturbation;
+         Number rel_error = fabs(deriv_approx - deriv_exact) / Max(fabs(deriv_approx), 1.);
+         char cflag = ' ';
+         if( rel_error >= derivative_test_tol_ )
+         {
+            cflag = '*';
+            nerrors++;
+         }
+         if( cflag != ' ' || derivative_test_print_all_ )
+         {
+            jnlst_->Printf(J_WARNING, J_NLP, "%c grad_f[group %5" IPOPT_INDEX_FORMAT "] = %23.16e    ~ %23.16e  [%10.3e]\n", cflag,
+                           s, deriv_exact, deriv_approx, rel_error);
+         }
+
+         for( Index icon = 0; icon < ng; icon++ )
+         {
+            Index j = row_col[icon];
+            if( j >= 0 )
+            {
+               deriv_approx = (g_t[icon] - gref[icon]) / perturbation[j];
+               deriv_exact = row_exact[icon];
+            }
+            else
+            {
+               // the constraint should not depend on any variable of the group
+               deriv_approx = (g_t[icon] - gref[icon]) / max_perturbation;
+               deriv_exact = 0.;
+            }
+            rel_error = fabs(deriv_approx - deriv_exact) / Max(fabs(deriv_approx), 1.);
+            cflag = ' ';
+            if( rel_error >= derivative_test_tol_ )
+            {
+               cflag = '*';
+               nerrors++;
+            }
+            if( j >= 0 && (cflag != ' ' || derivative_test_print_all_) )
+            {
+               jnlst_->Printf(J_WARNING, J_NLP, "%c jac_g [%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e v  ~ %23.16e  [%10.3e]\n", cflag,
+                              icon + index_correction, j + index_correction, deriv_exact, deriv_approx, rel_error);
+            }
+            else if( j < 0 && cflag != ' ' )
+            {
+               jnlst_->Printf(J_WARNING, J_NLP, "%c jac_g [%5" IPOPT_INDEX_FORMAT ",group %5" IPOPT_INDEX_FORMAT "] = %23.16e    ~ %23.16e  [%10.3e]\n", cflag,
+                              icon + index_correction, s, deriv_exact, deriv_approx, rel_error);
+            }
+         }
+
+         for( Index p = group_start[s]; p < group_start[s + 1]; p++ )
+         {
+            Index j = group_cols[p];
+            for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+            {
+               row_col[g_iRow[col_nz[q]]] = -1;
+               row_exact[g_iRow[col_nz[q]]] = 0.;
+            }
+         }
+      }
+   }
+
+   return nerrors;
+}
+
+Index TNLPAdapter::CheckSecondDerivativesByGroups(
+   Index         nx,
+   Index         ng,
+   Index         nz_jac_g,
+   Index         nz_hess_lag,
+   const Number* xref,
+   const Number* grad_f,
+   const Index*  g_iRow,
+   const Index*  g_jCol,
+   const Number* jac_g,
+   Index         icon_first,
+   Index         index_correction
+)
+{
+   // Get sparsity structure of Hessian and extend it to both triangles
+   std::vector<Index> h_iRow(nz_hess_lag);
+   std::vector<Index> h_jCol(nz_hess_lag);
+   bool retval = nz_hess_lag == 0
+                 || tnlp_->eval_h(nx, NULL, false, 0., ng, NULL, false, nz_hess_lag, &h_iRow[0], &h_jCol[0], NULL);
+   ASSERT_EXCEPTION(retval, ERROR_IN_TNLP_DERIVATIVE_TEST,
+                    "In TNLP derivative test: Hessian structure could not be evaluated.");
+   std::vector<Index> sym_row;
+   std::vector<Index> sym_col;
+   std::vector<Index> sym_pos;
+   sym_row.reserve(2 * nz_hess_lag);
+   sym_col.reserve(2 * nz_hess_lag);
+   sym_pos.reserve(2 * nz_hess_lag);
+   for( Index k = 0; k < nz_hess_lag; k++ )
+   {
+      Index row = h_iRow[k] - index_correction;
+      Index col = h_jCol[k] - index_correction;
+      DBG_ASSERT(row >= 0 && row < nx);
+      DBG_ASSERT(col >= 0 && col < nx);
+      sym_row.push_back(row);
+      sym_col.push_back(col);
+      sym_pos.push_back(k);
+      if( row != col )
+      {
+         sym_row.push_back(col);
+         sym_col.push_back(row);
+         sym_pos.push_back(k);
+      }
+   }
+   Index nz_sym = (Index) sym_pos.size();
+   const Index* sym_row_ptr = nz_sym > 0 ? &sym_row[0] : NULL;
+   const Index* sym_col_ptr = nz_sym > 0 ? &sym_col[0] : NULL;
+
+   std::vector<Index> group_start;
+   std::vector<Index> group_cols;
+   GroupOrthogonalColumns(nx, nx, nz_sym, sym_row_ptr, sym_col_ptr, 0, group_start, group_cols);
+   Index ngroups = (Index) group_start.size() - 1;
+   std::vector<Index> col_start;
+   std::vector<Index> col_nz;
+   ColumnwiseNonzeros(nx, nz_sym, sym_col_ptr, col_start, col_nz);
+
+   int nthreads = PerturbedPointThreads(tnlp_->get_evaluation_concurrency(), ngroups);
+   jnlst_->Printf(J_SUMMARY, J_NLP,
+                  "Checking Hessian of the Lagrangian for random multipliers along %" IPOPT_INDEX_FORMAT " groups of structurally orthogonal variables using %d thread(s).\n\n",
+                  ngroups, nthreads);
+
+   // Multipliers and Hessian of the Lagrangian at the reference point
+   const Number objfact = icon_first == -1 ? 1. : 0.;
+   std::vector<Number> lambda(ng, 0.);
+   for( Index icon = Max(0, icon_first); icon < ng; icon++ )
+   {
+      lambda[icon] = 2. * IpRandom01() - 1.;
+   }
+   Number* lambda_ptr = ng > 0 ? &lambda[0] : NULL;
+   std::vector<Number> h_values(nz_hess_lag);
+   retval = nz_hess_lag == 0
+            || tnlp_->eval_h(nx, xref, true, objfact, ng, lambda_ptr, true, nz_hess_lag, NULL, NULL, &h_values[0]);
+   ASSERT_EXCEPTION(retval, ERROR_IN_TNLP_DERIVATIVE_TEST,
+                    "In TNLP derivative test: Hessian could not be evaluated at reference point.");
+
+   // gradient of the Lagrangian at the reference point
+   std::vector<Number> gradref(nx);
+   for( Index j = 0; j < nx; j++ )
+   {
+      gradref[j] = objfact * grad_f[j];
+   }
+   for( Index k = 0; k < nz_jac_g; k++ )
+   {
+      gradref[g_jCol[k]] += lambda[g_iRow[k]] * jac_g[k];
+   }
+
+   std::vector<Number> perturbation(nx);
+   for( Index j = 0; j < nx; j++ )
+   {
+      perturbation[j] = derivative_test_perturbation_ * Max(1., fabs(xref[j]));
+   }
+
+   std::vector<Number> xpert((size_t) nthreads * nx);
+   std::vector<Number> gradpert((size_t) nthreads * nx);
+   std::vector<Number> jacpert((size_t) nthreads * nz_jac_g);
+   std::vector<int> ok(nthreads);
+   // column and value of the Hessian entry of each row within the current group
+   std::vector<Index> row_col(nx, -1);
+   std::vector<Number> row_exact(nx, 0.);
+
+   Index nerrors = 0;
+   for( Index s0 = 0; s0 < ngroups; s0 += nthreads )
+   {
+      Index nchunk = Min((Index) nthreads, ngroups - s0);
+
+      // The threads only call the TNLP.  Exceptions must not leave the
+      // parallel region; they are turned into a failed evaluation.
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+#endif
+      for( Index t = 0; t < nchunk; t++ )
+      {
+         Number* x_t = &xpert[(size_t) t * nx];
+         Number* grad_t = &gradpert[(size_t) t * nx];
+         IpBlasDcopy(nx, xref, 1, x_t, 1);
+         for( Index p = group_start[s0 + t]; p < group_start[s0 + t + 1]; p++ )
+         {
+            x_t[group_cols[p]] += perturbation[group_cols[p]];
+         }
+         try
+         {
+            ok[t] = tnlp_->eval_grad_f(nx, x_t, true, grad_t);
+            if( ok[t] && ng > 0 )
+            {
+               Number* jac_t = &jacpert[(size_t) t * nz_jac_g];
+               ok[t] = tnlp_->eval_jac_g(nx, x_t, true, ng, nz_jac_g, NULL, NULL, jac_t);
+               if( ok[t] )
+               {
+                  for( Index j = 0; j < nx; j++ )
+                  {
+                     grad_t[j] *= objfact;
+                  }
+                  for( Index k = 0; k < nz_jac_g; k++ )
+                  {
+                     grad_t[g_jCol[k]] += lambda[g_iRow[k]] * jac_t[k];
+                  }
+               }
+            }
+         }
+         catch( ... )
+         {
+            ok[t] = false;
+         }
+      }
+
+      for( Index t = 0; t < nchunk; t++ )
+      {
+         ASSERT_EXCEPTION(ok[t], ERROR_IN_TNLP_DERIVATIVE_TEST,
+                          "In TNLP derivative test: grad_f or Jacobian could not be evaluated at perturbed point.");
+         const Index s = s0 + t;
+         const Number* grad_t = &gradpert[(size_t) t * nx];
+
+         Number max_perturbation = 0.;
+         for( Index p = group_start[s]; p < group_start[s + 1]; p++ )
+         {
+            Index j = group_cols[p];
+            max_perturbation = Max(max_perturbation, perturbation[j]);
+            for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+            {
+               Index k = col_nz[q];
+               row_col[sym_row[k]] = j;
+               row_exact[sym_row[k]] += h_values[sym_pos[k]];
+            }
+         }
+
+         for( Index ivar2 = 0; ivar2 < nx; ivar2++ )
+         {
+            Index ivar = row_col[ivar2];
+            Number deriv_approx;
+            if( ivar >= 0 )
+            {
+               deriv_approx = (grad_t[ivar2] - gradref[ivar2]) / perturbation[ivar];
+            }
+            else
+            {
+               // the gradient entry should not depend on any variable of the group
+               deriv_approx = (grad_t[ivar2] - gradref[ivar2]) / max_perturbation;
+            }
+            Number deriv_exact = row_exact[ivar2];
+            Number rel_error = fabs(deriv_approx - deriv_exact) / Max(fabs(deriv_approx), 1.);
+            char cflag = ' ';
+            if( rel_error >= derivative_test_tol_ )
+            {
+               cflag = '*';
+               nerrors++;
+            }
+            if( ivar >= 0 && (cflag != ' ' || derivative_test_print_all_) )
+            {
+               jnlst_->Printf(J_WARNING, J_NLP, "%c lag_hess[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e v  ~ %23.16e  [%10.3e]\n", cflag,
+                              ivar + index_correction, ivar2 + index_correction, deriv_exact, deriv_approx, rel_error);
+            }
+            else if( ivar < 0 && cflag != ' ' )
+            {
+               jnlst_->Printf(J_WARNING, J_NLP, "%c lag_hess[group %5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "] = %23.16e    ~ %23.16e  [%10.3e]\n", cflag,
+                              s, ivar2 + index_correction, deriv_exact, deriv_approx, rel_error);
+            }
+         }
+
+         for( Index p = group_start[s]; p < group_start[s + 1]; p++ )
+         {
+            Index j = group_cols[p];
+            for( Index q = col_start[j]; q < col_start[j + 1]; q++ )
+            {
+               row_col[sym_row[col_nz[q]]] = -1;
+               row_exact[sym_row[col_nz[q]]] = 0.;
+            }
+         }
+      }
+   }
+
+   return nerrors;
+}
+
+/** Find the rows of a matrix in triplet format (1-based indices) that
+ *  are linearly independent of all other rows because of its sparsity
+ *  structure.
+ *
+ *  A row that has the only nonzero of some column cannot be a linear
+ *  combination of the other rows, and removing it together with that
+ *  column does not change the dependencies among the other rows.  This
+ *  is repeated until no such column is left.  Entries with the same
+ *  position are summed up, and zero values are ignored.  The column
+ *  skip_col (0-based, or -1) is not used to remove rows.
+ *
+ *  @return number of rows that have been marked as independent
+ */
+static Index FindStructurallyIndependentRows(
+   Index               n_rows,
+   Index               n_cols,
+   Index               n_nz,
+   const Number*       vals,
+   const ipfint*       iRow,
+   const ipfint*       jCol,
+   Index               skip_col,
+   std::vector<bool>&  row_independent
+)
+{
+   // sort the entries by column and then by row (two counting sorts)
+   std::vector<Index> cnt(Max(n_rows, n_cols) + 1, 0);
+   std::vector<Index> by_row(n_nz);
+   for( Index i = 0; i < n_nz; i++ )
+   {
+      cnt[iRow[i]]++;
+   }
+   for( Index r = 1; r <= n_rows; r++ )
+   {
+      cnt[r] += cnt[r - 1];
+   }
+   for( Index i = 0; i < n_nz; i++ )
+   {
+      by_row[cnt[iRow[i] - 1]++] = i;
+   }
+   cnt.assign(cnt.size(), 0);
+   std::vector<Index> by_col(n_nz);
+   for( Index i = 0; i < n_nz; i++ )
+   {
+      cnt[jCol[i]]++;
+   }
+   for( Index c = 1; c <= n_cols; c++ )
+   {
+      cnt[c] += cnt[c - 1];
+   }
+   for( Index k = 0; k < n_nz; k++ )
+   {
+      Index i = by_row[k];
+      by_col[cnt[jCol[i] - 1]++] = i;
+   }
+
+   // merge duplicate entries and drop zeros; column-wise storage
+   std::vector<Index> col_start(n_cols + 1, 0);
+   std::vector<Index> col_rows;
+   col_rows.reserve(n_nz);
+   std::vector<Index> row_cnt(n_rows + 1, 0);
+   for( Index k = 0; k < n_nz; )
+   {
+      Index i = by_col[k];
+      Number val = 0.;
+      Index l = k;
+      for( ; l < n_nz && jCol[by_col[l]] == jCol[i] && iRow[by_col[l]] == iRow[i]; l++ )
+      {
+         val += vals[by_col[l]];
+      }
+      if( val != 0. )
+      {
+         col_rows.push_back(iRow[i] - 1);
+         col_start[jCol[i]]++;
+         row_cnt[iRow[i]]++;
+      }
+      k = l;
+   }
+   for( Index c = 1; c <= n_cols; c++ )
+   {
+      col_start[c] += col_start[c - 1];
+   }
+
+   // row-wise storage of the columns
+   for( Index r = 1; r <= n_rows; r++ )
+   {
+      row_cnt[r] += row_cnt[r - 1];
+   }
+   std::vector<Index> row_start(row_cnt);
+   std::vector<Index> row_cols(col_rows.size());
+   for( Index c = 0; c < n_cols; c++ )
+   {
+      for( Index k = col_start[c]; k < col_start[c + 1]; k++ )
+      {
+         row_cols[row_cnt[col_rows[k]]++] = c;
+      }
+   }
+
+   std::vector<Index> col_cnt(n_cols);
+   std::vector<Index> singletons;
+   for( Index c = 0; c < n_cols; c++ )
+   {
+      col_cnt[c] = col_start[c + 1] - col_start[c];
+      if( col_cnt[c] == 1 && c != skip_col )
+      {
+         singletons.push_back(c);
+      }
+   }
+
+   row_independent.assign(n_rows, false);
+   Index n_independent = 0;
+   while( !singletons.empty() )
+   {
+      Index c = singletons.back();
+      singletons.pop_back();
+      if( col_cnt[c] != 1 )
+      {
+         continue;
+      }
+      Index r = -1;
+      for( Index k = col_start[c]; k < col_start[c + 1]; k++ )
+      {
+         if( !row_independent[col_rows[k]] )
+         {
+            r = col_rows[k];
+            break;
+         }
+      }
+      DBG_ASSERT(r >= 0);
+      row_independent[r] = true;
+      n_independent++;
+      for( Index k = row_start[r]; k < row_start[r + 1]; k++ )
+      {
+         Index c2 = row_cols[k];
+         col_cnt[c2]--;
+         if( col_cnt[c2] == 1 && c2 != skip_col )
+         {
+            singletons.push_back(c2);
+         }
+      }
+   }
+
+   return n_independent;
+}
+
 bool TNLPAdapter::DetermineDependentConstraints(
    Index             n_x_var,
    const Index*      x_not_fixed_map,
@@ -3351,8 +5820,113 @@ bool TNLPAdapter::DetermineDependentConstraints(
    ASSERT_EXCEPTION(IsValid(dependency_detector_), OPTION_INVALID,
                     "No dependency_detector_ object available in TNLPAdapter::DetermineDependentConstraints");
 
-   bool retval = dependency_detector_->DetermineDependentRows(n_c, n_x_var, nz_jac_c, jac_c_vals, jac_c_iRow,
-                 jac_c_jCol, c_deps);
+   // Reuse the previous result if the matrix is the same
+   unsigned int structure_hash = HashBytes(&n_c, sizeof(Index));
+   structure_hash = HashBytes(&n_x_var, sizeof(Index), structure_hash);
+   structure_hash = HashBytes(&nz_jac_c, sizeof(Index), structure_hash);
+   structure_hash = HashBytes(jac_c_iRow, nz_jac_c * sizeof(ipfint), structure_hash);
+   structure_hash = HashBytes(jac_c_jCol, nz_jac_c * sizeof(ipfint), structure_hash);
+   unsigned int value_hash = HashBytes(jac_c_vals, nz_jac_c * sizeof(double));
+   std::string detector = dependency_detector_name_ + (dependency_detection_presolve_ ? "+presolve" : "");
+
+   bool retval = true;
+   if( dep_cache_valid_ && structure_hash == dep_cache_structure_hash_ && value_hash == dep_cache_value_hash_
+       && detector == dep_cache_detector_ && dependency_detector_tols_ == dep_cache_detector_tols_ )
+   {
+      jnlst_->Printf(J_DETAILED, J_INITIALIZATION, "Reusing result of previous dependency detection.\n");
+      c_deps = dep_cache_c_deps_;
+   }
+   else
+   {
+      dep_cache_valid_ = false;
+
+      // Rows that are independent because of the sparsity structure
+      // need not be given to the dependency detector
+      std::vector<bool> row_independent;
+      Index n_independent = 0;
+      if( dependency_detection_presolve_ )
+      {
+         n_independent = FindStructurallyIndependentRows(n_c, n_x_var, nz_jac_c, jac_c_vals, jac_c_iRow, jac_c_jCol,
+                         dependency_detection_with_rhs_ ? n_x_var - 1 : -1, row_independent);
+         jnlst_->Printf(J_DETAILED, J_INITIALIZATION,
+                        "%" IPOPT_INDEX_FORMAT " of %" IPOPT_INDEX_FORMAT " equality constraints are structurally independent.\n", n_independent, n_c);
+      }
+
+      if( n_independent == 0 )
+      {
+         retval = dependency_detector_->DetermineDependentRows(n_c, n_x_var, nz_jac_c, jac_c_vals, jac_c_iRow,
+                  jac_c_jCol, c_deps);
+      }
+      else if( n_independent < n_c )
+      {
+         // Renumber the remaining rows and the columns they use
+         std::vector<Index> core_rows;
+         std::vector<Index> row_pos(n_c, -1);
+         for( Index i = 0; i < n_c; i++ )
+         {
+            if( !row_independent[i] )
+            {
+               row_pos[i] = (Index) core_rows.size();
+               core_rows.push_back(i);
+            }
+         }
+         std::vector<Index> col_pos(n_x_var, -1);
+         Index n_core_cols = 0;
+         Index nz_core = 0;
+         for( Index i = 0; i < nz_jac_c; i++ )
+         {
+            if( row_pos[jac_c_iRow[i] - 1] != -1 )
+            {
+               nz_core++;
+               col_pos[jac_c_jCol[i] - 1] = 0;
+            }
+         }
+         for( Index j = 0; j < n_x_var; j++ )
+         {
+            if( col_pos[j] == 0 )
+            {
+               col_pos[j] = n_core_cols++;
+            }
+         }
+         ipfint* core_iRow = new ipfint[nz_core];
+         ipfint* core_jCol = new ipfint[nz_core];
+         double* core_vals = new double[nz_core];
+         nz_core = 0;
+         for( Index i = 0; i < nz_jac_c; i++ )
+         {
+            Index r = row_pos[jac_c_iRow[i] - 1];
+            if( r != -1 )
+            {
+               core_iRow[nz_core] = r + 1;
+               core_jCol[nz_core] = col_pos[jac_c_jCol[i] - 1] + 1;
+               core_vals[nz_core] = jac_c_vals[i];
+               nz_core++;
+            }
+         }
+
+         std::list<Index> core_deps;
+         retval = dependency_detector_->DetermineDependentRows((Index) core_rows.size(), n_core_cols, nz_core, core_vals,
+                  core_iRow, core_jCol, core_deps);
+         for( std::list<Index>::iterator i = core_deps.begin(); i != core_deps.end(); i++ )
+         {
+            c_deps.push_back(core_rows[*i]);
+         }
+
+         delete[] core_iRow;
+         delete[] core_jCol;
+         delete[] core_vals;
+      }
+
+      if( retval )
+      {
+         dep_cache_valid_ = true;
+         dep_cache_structure_hash_ = structure_hash;
+         dep_cache_value_hash_ = value_hash;
+         dep_cache_detector_ = detector;
+         dep_cache_detector_tols_ = dependency_detector_tols_;
+         dep_cache_c_deps_ = c_deps;
+      }
+   }
 
    // For now, we just get rid of the dependency_detector_ object, in
    // order to save memory.  Maybe we need to add a clean method at
@@ -11,6 +11,7 @@
 #include "IpTNLP.hpp"
 #include "IpOrigIpoptNLP.hpp"
 #include <list>
+#include <vector>
 
 namespace Ipopt
 {
@@ -150,6 +151,55 @@ public:
       SymMatrix&    h
    );
 
+   virtual bool Eval_h_times_vec(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      const Vector& v,
+      Vector&       hv
+   );
+
+   virtual bool GetElementFunctions(
+      std::vector<Index>& elem_start,
+      std::vector<Index>& elem_vars
+   );
+
+   virtual bool Eval_element_gradients(
+      const Vector& x,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      Vector&       elem_grad
+   );
+
+   /** Evaluates the constraint Jacobian and the Hessian of the
+    *  Lagrangian concurrently if concurrent_derivative_evaluation is
+    *  enabled, the TNLP can be evaluated concurrently, and Ipopt has
+    *  been build with OpenMP support.
+    */
+   virtual bool Eval_jac_and_h(
+      const Vector& x,
+      Matrix*       jac_c,
+      Matrix*       jac_d,
+      Number        obj_factor,
+      const Vector& yc,
+      const Vector& yd,
+      SymMatrix&    h
+   );
+
+   /** Evaluates the TNLP at the points concurrently if the TNLP
+    *  can be evaluated concurrently and Ipopt has been build with
+    *  OpenMP support.
+    */
+   virtual void Eval_f_c_d(
+      const std::vector<SmartPtr<const Vector> >& x,
+      std::vector<Number>&                        f,
+      std::vector<SmartPtr<Vector> >&             c,
+      std::vector<SmartPtr<Vector> >&             d,
+      std::vector<bool>&                          success
+   );
+
    virtual void GetScalingParameters(
       const SmartPtr<const VectorSpace> x_space,
       const SmartPtr<const VectorSpace> c_space,
@@ -200,6 +250,28 @@ public:
       SmartPtr<Matrix>&      P_approx
    );
 
+   /** Method returning whether the Jacobians are constant, based on
+    *  TNLP::get_constraints_linearity. */
+   virtual bool GetConstantJacobians(
+      bool& jac_c_constant,
+      bool& jac_d_constant
+   );
+
+   /** Method returning the number of diagonal blocks given by the TNLP. */
+   virtual Index GetNumberOfDiagonalBlocks();
+
+   /** Method returning the blocks of x, c, and d given by the TNLP.
+    *
+    *  Fixed variables that are made constraints belong to the block of
+    *  the variable.
+    */
+   virtual bool GetDiagonalBlocks(
+      Index               num_blocks,
+      std::vector<Index>& x_block,
+      std::vector<Index>& c_block,
+      std::vector<Index>& d_block
+   );
+
    /** Enum for treatment of fixed variables option */
    enum FixedVariableTreatmentEnum
    {
@@ -240,6 +312,29 @@ public:
       return tnlp_;
    }
 
+   /** Take the problem structure from another TNLPAdapter.
+    *
+    *  The next call of GetSpaces does not analyze the sparsity
+    *  structure of the TNLP, but copies the index maps and the
+    *  dimensions from source and shares its matrix spaces, which are
+    *  never modified after their creation.  source must have set up
+    *  the structure of a TNLP with the same dimensions, sparsity
+    *  structure, and bounds on fixed variables before, and must not be
+    *  solving a problem at the time this TNLPAdapter calls GetSpaces.
+    *  The vector spaces are not shared, since they recycle the storage
+    *  of their vectors.
+    *
+    *  If several TNLPAdapters that share their structure are used in
+    *  concurrent solves, Ipopt needs to be compiled with
+    *  IPOPT_ATOMIC_REFCOUNT defined.
+    */
+   void SetStructureSource(
+      const SmartPtr<const TNLPAdapter>& source
+   )
+   {
+      structure_source_ = source;
+   }
+
    /** @name Methods for translating data for IpoptNLP into the TNLP data.
     *
     *  These methods are used to obtain the current (or final)
@@ -269,6 +364,37 @@ public:
       Number*       x_U_orig,         /**< vector to fill with values from x_U */
       bool          clearorig = true  /**< whether to initialize complete x_L_orig and x_U_orig to 0.0 before setting values for non-fixed variables */
    );
+
+   /** Provides selected entries of the current iterate in the form of the TNLP.
+    *
+    *  Unlike ResortX, ResortG, and ResortBnds, only the requested
+    *  entries are resorted and unscaled, so that the cost does not
+    *  depend on the size of the problem.  This can be used in
+    *  TNLP::intermediate_callback to monitor a few variables or
+    *  constraints.  Indices are 0-based positions in the arrays of the
+    *  TNLP, and any of the output arrays can be NULL.
+    *
+    *  The bound multipliers of fixed variables are set to 0, as in
+    *  ResortBnds.  The constraint values g are those of the current
+    *  iterate, which the algorithm has usually evaluated already.
+    *
+    *  @return false if ip_cq does not belong to the problem of this
+    *    TNLPAdapter, e.g., in the restoration phase
+    */
+   bool GetCurrIterateEntries(
+      const IpoptData*           ip_data,   /**< data as passed to TNLP::intermediate_callback */
+      IpoptCalculatedQuantities* ip_cq,     /**< calculated quantities as passed to TNLP::intermediate_callback */
+      bool                       scaled,    /**< whether to return the values of the scaled problem */
+      Index                      nx,        /**< number of requested variables */
+      const Index*               x_idx,     /**< indices of the requested variables */
+      Number*                    x,         /**< values of the requested variables, or NULL */
+      Number*                    z_L,       /**< lower bound multipliers of the requested variables, or NULL */
+      Number*                    z_U,       /**< upper bound multipliers of the requested variables, or NULL */
+      Index                      ng,        /**< number of requested constraints */
+      const Index*               g_idx,     /**< indices of the requested constraints */
+      Number*                    g,         /**< values of the requested constraints, or NULL */
+      Number*                    lambda     /**< multipliers of the requested constraints, or NULL */
+   );
    ///@}
 
 private:
@@ -314,6 +440,28 @@ private:
    /** Object that can be used to detect linearly dependent rows in the equality constraint Jacobian */
    SmartPtr<TDependencyDetector> dependency_detector_;
 
+   /** @name Result of the most recent dependency detection.
+    *
+    *  The result is reused if the equality constraint Jacobian that is
+    *  given to the dependency detector has the same structure and values
+    *  and the same detector with the same tolerances is used, e.g., when
+    *  the problem is solved again without warm_start_same_structure.
+    */
+   ///@{
+   /** Whether a result is available */
+   bool dep_cache_valid_;
+   /** Hash of the dimensions and the sparsity structure of the Jacobian */
+   unsigned int dep_cache_structure_hash_;
+   /** Hash of the values of the Jacobian */
+   unsigned int dep_cache_value_hash_;
+   /** Detector and presolve setting used for the result */
+   std::string dep_cache_detector_;
+   /** Tolerances of the detector used for the result */
+   std::vector<Number> dep_cache_detector_tols_;
+   /** Indices of the dependent equality constraints */
+   std::list<Index> dep_cache_c_deps_;
+   ///@}
+
    /**@name Algorithmic parameters */
    ///@{
    /** Value for a lower bound that denotes -infinity */
@@ -339,20 +487,41 @@ private:
    bool derivative_test_print_all_;
    /** Index of first quantity to be checked. */
    Index derivative_test_first_index_;
+   /** Flag indicating whether the derivative test perturbs groups of
+    *  structurally orthogonal variables at once. */
+   bool derivative_test_sparse_;
    /** Flag indicating whether the TNLP with identical structure has already been solved before. */
    bool warm_start_same_structure_;
+   /** TNLPAdapter to take the problem structure from in the next call of GetSpaces, if not NULL */
+   SmartPtr<const TNLPAdapter> structure_source_;
+   /** Flag indicating whether a reoptimization starts from the final point of the previous solve. */
+   bool warm_start_previous_solution_;
    /** Flag indicating what Hessian information is to be used. */
    HessianApproximationType hessian_approximation_;
+   /** Flag indicating whether eval_h provides an exact part of a limited-memory approximation. */
+   bool hessian_approximation_exact_part_;
    /** Number of linear variables. */
    Index num_linear_variables_;
+   /** Flag indicating whether the Jacobian and Hessian values are stored in single precision. */
+   bool single_precision_derivatives_;
+   /** Flag indicating whether huge pages are requested for the values of vectors and matrices. */
+   bool use_huge_pages_;
    /** Flag indicating how Jacobian is computed. */
    JacobianApproxEnum jacobian_approximation_;
+   /** Flag indicating whether eval_jac_g and eval_h may be called concurrently. */
+   bool concurrent_derivative_evaluation_;
    /** Size of the perturbation for the derivative approximation */
    Number findiff_perturbation_;
    /** Maximal perturbation of the initial point */
    Number point_perturbation_radius_;
    /** Flag indicating if rhs should be considered during dependency detection */
    bool dependency_detection_with_rhs_;
+   /** Flag indicating if rows that are structurally independent should be removed before dependency detection */
+   bool dependency_detection_presolve_;
+   /** Selected dependency detector */
+   std::string dependency_detector_name_;
+   /** Values of the tolerance options of the dependency detector */
+   std::vector<Number> dependency_detector_tols_;
 
    /** Overall convergence tolerance */
    Number tol_;
@@ -383,6 +552,21 @@ private:
    /** Numbering style of variables and constraints */
    TNLP::IndexStyleEnum index_style_;
 
+   /** Degree to which the TNLP can be evaluated concurrently */
+   TNLP::EvaluationConcurrency evaluation_concurrency_;
+
+   /** @name Jacobian entries that can change, see TNLP::get_number_of_varying_jac_g_entries */
+   ///@{
+   /** whether the TNLP has given the varying entries */
+   bool have_varying_jac_g_;
+   /** whether jac_g_ holds the values of all entries from an evaluation in this optimization */
+   bool jac_g_complete_;
+   /** positions of the varying entries in jac_g_ */
+   std::vector<Index> varying_jac_g_pos_;
+   /** work space for the values of the varying entries */
+   std::vector<Number> varying_jac_g_vals_;
+   ///@}
+
    /** @name Local copy of spaces (for warm start) */
    ///@{
    SmartPtr<const VectorSpace> x_space_;
@@ -410,6 +594,15 @@ private:
    Number* c_rhs_; /** the rhs values of c */
    ///@}
 
+   /**@name Final point of the previous solve in the TNLP indices
+    *  (only stored if warm_start_previous_solution_ is true) */
+   ///@{
+   std::vector<Number> prev_x_;
+   std::vector<Number> prev_z_L_;
+   std::vector<Number> prev_z_U_;
+   std::vector<Number> prev_lambda_;
+   ///@}
+
    /**@name Tags for deciding when to update internal copies of vectors */
    ///@{
    TaggedObject::Tag x_tag_for_iterates_;
@@ -432,12 +625,143 @@ private:
    ///@{
    bool internal_eval_g(bool new_x);
    bool internal_eval_jac_g(bool new_x);
+   /** Evaluate g at full_x_ into values, by ranges of rows if possible */
+   bool eval_exact_g(
+      bool    new_x,
+      Number* values
+   );
+   /** Evaluate the exact Jacobian of g at full_x_ into values, by ranges of rows if possible */
+   bool eval_exact_jac_g(
+      bool    new_x,
+      Number* values
+   );
+   ///@}
+
+   /** @name Internal methods for evaluating g and its Jacobian in parallel by ranges of rows */
+   ///@{
+   /** Number of threads to be used, or 1 if eval_g and eval_jac_g are to be called */
+   int RowRangeThreads() const;
+   bool eval_g_by_rows(
+      bool    new_x,
+      int     nthreads,
+      Number* values
+   );
+   bool eval_jac_g_by_rows(
+      bool    new_x,
+      int     nthreads,
+      Number* values
+   );
+   ///@}
+
+   /** Evaluate the values of the full Hessian at full_x_ and
+    *  full_lambda_, in parallel by blocks if possible.
+    */
+   bool internal_eval_h(
+      bool    new_x,
+      Number  obj_factor,
+      bool    new_lambda,
+      Number* full_h
+   );
+
+   /** Form the values of the full Hessian from the components at
+    *  full_x_ and full_lambda_, evaluating the components only if
+    *  x has changed.
+    */
+   bool eval_h_from_components(
+      bool    new_x,
+      Number  obj_factor,
+      Number* full_h
+   );
+
+   /** @name Methods for extracting the Ipopt constraints from values of g and x of the TNLP */
+   ///@{
+   void ExtractC(
+      const Number* full_g,
+      const Number* full_x,
+      Vector&       c
+   ) const;
+   void ExtractD(
+      const Number* full_g,
+      Vector&       d
+   ) const;
    ///@}
 
    /** @name Internal methods for dealing with finite difference approximation */
    ///@{
    /** Initialize sparsity structure for finite difference Jacobian */
    void initialize_findiff_jac(const Index* iRow, const Index* jCol);
+
+   /** Initialize the star coloring of the Hessian structure (1-based
+    *  indices) for the finite difference Hessian */
+   void initialize_findiff_hess(
+      const Index* iRow,
+      const Index* jCol
+   );
+
+   /** Compute the full Hessian at full_x_ and full_lambda_ by
+    *  differences of the gradient of the Lagrangian */
+   bool eval_findiff_h(
+      bool    new_x,
+      Number  obj_factor,
+      Number* full_h
+   );
+
+   /** Evaluate the gradient of the Lagrangian at x for the multipliers
+    *  full_lambda_.  jac_values is space for the Jacobian values. */
+   bool eval_findiff_grad_lag(
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Number*       grad_lag,
+      Number*       jac_values
+   );
+
+   /** Set up the problem structure as a copy of the one of source */
+   void CopyStructure(
+      const TNLPAdapter& source
+   );
+   ///@}
+
+   /** @name Internal methods for the sparse derivative test */
+   ///@{
+   /** Check the first derivatives at xref by perturbing groups of
+    *  structurally orthogonal Jacobian columns, starting from variable
+    *  ivar_first.  All indices are 0-based.  Returns the number of
+    *  detected errors. */
+   Index CheckFirstDerivativesByGroups(
+      Index         nx,
+      Index         ng,
+      Index         nz_jac_g,
+      const Number* xref,
+      Number        fref,
+      const Number* gref,
+      const Number* grad_f,
+      const Index*  g_iRow,
+      const Index*  g_jCol,
+      const Number* jac_g,
+      Index         ivar_first,
+      Index         index_correction
+   );
+
+   /** Check the Hessian of the Lagrangian at xref for random
+    *  multipliers of the constraints from icon_first on (and the
+    *  objective, if icon_first is -1) by differences of the gradient of
+    *  the Lagrangian along groups of structurally orthogonal Hessian
+    *  columns.  All indices are 0-based.  Returns the number of
+    *  detected errors. */
+   Index CheckSecondDerivativesByGroups(
+      Index         nx,
+      Index         ng,
+      Index         nz_jac_g,
+      Index         nz_hess_lag,
+      const Number* xref,
+      const Number* grad_f,
+      const Index*  g_iRow,
+      const Index*  g_jCol,
+      const Number* jac_g,
+      Index         icon_first,
+      Index         index_correction
+   );
    ///@}
 
    /**@name Internal Permutation Spaces and matrices
@@ -466,6 +790,88 @@ private:
    Index* jac_idx_map_;
    Index* h_idx_map_;
 
+   /** @name Element functions for hessian_approximation=partitioned.
+    *
+    *  Only the variables that are not fixed are kept.
+    */
+   ///@{
+   /** total number of variables of all element functions of the TNLP */
+   Index nz_full_elem_;
+   /** start of each element function in elem_vars_ */
+   std::vector<Index> elem_start_;
+   /** variables of the element functions (with respect to x) */
+   std::vector<Index> elem_vars_;
+   /** position of each entry of elem_vars_ in the element gradients of the TNLP */
+   std::vector<Index> elem_idx_map_;
+   ///@}
+
+   /** @name Flags indicating that jac_idx_map_ is the identity for all entries of jac_c or jac_d.
+    *
+    *  In that case, the TNLP writes the values directly into the
+    *  Jacobian matrix, instead of into jac_g_.
+    */
+   ///@{
+   bool jac_c_direct_;
+   bool jac_d_direct_;
+   ///@}
+
+   /** @name Flags indicating that all constraints of the TNLP belong to c or to d, in their original order.
+    *
+    *  In that case, the TNLP writes the constraint values directly
+    *  into c or d, instead of into full_g_.
+    */
+   ///@{
+   bool g_c_direct_;
+   bool g_d_direct_;
+   ///@}
+
+   /** @name Work space for values of the TNLP that are not passed to the TNLP directly.
+    *
+    *  They are kept to avoid allocations in each evaluation.
+    */
+   ///@{
+   /** Two vectors in the space of the full x */
+   std::vector<Number> work_full_x1_;
+   std::vector<Number> work_full_x2_;
+   /** Values of the full Hessian or of the element gradients */
+   std::vector<Number> work_values_;
+   ///@}
+
+   /** @name Scaling factors for GetCurrIterateEntries, in the numbering of the TNLP.
+    *
+    *  They are computed at the first call after GetSpaces.  The scaled
+    *  values of the variables and constraints are the products of the
+    *  unscaled values with these factors.
+    */
+   ///@{
+   std::vector<Number> entry_x_scaling_;
+   std::vector<Number> entry_g_scaling_;
+   Number entry_obj_unscale_factor_;
+   ///@}
+
+   /** @name Partition of the full Hessian entries for eval_h_block */
+   ///@{
+   /** Number of blocks, or 0 if the Hessian is evaluated by eval_h */
+   Index n_h_blocks_;
+   /** Start of each block in the full Hessian entries (n_h_blocks_+1 entries) */
+   Index* h_block_start_;
+   ///@}
+
+   /** @name Hessian components of the TNLP, see TNLP::eval_h_components.
+    *
+    *  The components are empty if the Hessian is evaluated by eval_h.
+    */
+   ///@{
+   /** constraint of each nonzero of the components (0-based), or -1 for the objective */
+   std::vector<Index> h_comp_con_;
+   /** position of each nonzero of the components in the full Hessian entries */
+   std::vector<Index> h_comp_pos_;
+   /** values of the components at the point with tag h_comp_x_tag_ */
+   std::vector<Number> h_comp_values_;
+   /** tag of x for which h_comp_values_ have been evaluated */
+   TaggedObject::Tag h_comp_x_tag_;
+   ///@}
+
    /** Position of fixed variables. This is required for a warm start */
    Index* x_fixed_map_;
    ///@}
@@ -480,6 +886,28 @@ private:
    Index* findiff_jac_ja_;
    /** Position of entry in original triplet matrix */
    Index* findiff_jac_postriplet_;
+   /** Start of each group of structurally orthogonal columns in
+    *  findiff_jac_group_cols_ (number of groups + 1 entries) */
+   std::vector<Index> findiff_jac_group_start_;
+   /** Columns of the Jacobian, ordered by groups */
+   std::vector<Index> findiff_jac_group_cols_;
+   /** Row of each Jacobian entry, for the finite difference Hessian (0-based) */
+   std::vector<Index> findiff_hess_jac_row_;
+   /** Column of each Jacobian entry, for the finite difference Hessian (0-based) */
+   std::vector<Index> findiff_hess_jac_col_;
+   /** Start of each group of the star coloring of the Hessian in
+    *  findiff_hess_group_cols_ (number of groups + 1 entries) */
+   std::vector<Index> findiff_hess_group_start_;
+   /** Variables, ordered by groups of the star coloring of the Hessian */
+   std::vector<Index> findiff_hess_group_cols_;
+   /** Start of the Hessian entries that are computed from each group */
+   std::vector<Index> findiff_hess_entry_start_;
+   /** Position of each Hessian entry in the full Hessian, ordered by groups */
+   std::vector<Index> findiff_hess_entry_pos_;
+   /** Entry of the gradient of the Lagrangian from which the Hessian entry is computed */
+   std::vector<Index> findiff_hess_entry_row_;
+   /** Variable of the group whose perturbation determines the Hessian entry */
+   std::vector<Index> findiff_hess_entry_col_;
    /** Copy of the lower bounds */
    Number* findiff_x_l_;
    /** Copy of the upper bounds */
@@ -0,0 +1,717 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpTNLPPresolver.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace Ipopt
+{
+
+/** Pointer to the first element of a vector, or NULL if it is empty. */
+template<typename T>
+static inline T* vecptr(
+   std::vector<T>& v
+)
+{
+   return v.empty() ? NULL : &v[0];
+}
+
+TNLPPresolver::TNLPPresolver(
+   TNLP&  tnlp,
+   Number nlp_lower_bound_inf,
+   Number nlp_upper_bound_inf
+)
+   : tnlp_(&tnlp),
+     n_(-1),
+     m_orig_(-1),
+     nnz_jac_g_orig_(-1),
+     nnz_h_lag_(-1),
+     index_style_orig_(C_STYLE),
+     nlp_lower_bound_inf_(nlp_lower_bound_inf),
+     nlp_upper_bound_inf_(nlp_upper_bound_inf),
+     m_presolved_(-1),
+     n_tightened_bounds_(0)
+{ }
+
+TNLPPresolver::~TNLPPresolver()
+{ }
+
+bool TNLPPresolver::Presolve()
+{
+   if( !tnlp_->get_nlp_info(n_, m_orig_, nnz_jac_g_orig_, nnz_h_lag_, index_style_orig_) )
+   {
+      return false;
+   }
+   const Index n = n_;
+   const Index m = m_orig_;
+   const Index nnz = nnz_jac_g_orig_;
+   const Index offset = (index_style_orig_ == FORTRAN_STYLE ? 1 : 0);
+
+   x_l_.resize(n);
+   x_u_.resize(n);
+   std::vector<Number> gl(m);
+   std::vector<Number> gu(m);
+   if( !tnlp_->get_bounds_info(n, vecptr(x_l_), vecptr(x_u_), m, vecptr(gl), vecptr(gu)) )
+   {
+      return false;
+   }
+
+   std::vector<Index> iRow(nnz);
+   std::vector<Index> jCol(nnz);
+   if( nnz > 0 && !tnlp_->eval_jac_g(n, NULL, false, m, nnz, vecptr(iRow), vecptr(jCol), NULL) )
+   {
+      return false;
+   }
+   for( Index k = 0; k < nnz; k++ )
+   {
+      iRow[k] -= offset;
+      jCol[k] -= offset;
+   }
+
+   // Only constraints that are linear or do not have any Jacobian
+   // entries are considered.  For the others we do not know if the
+   // sparsity pattern of their Jacobian is structural.
+   std::vector<LinearityType> const_types(m, NON_LINEAR);
+   if( m > 0 && !tnlp_->get_constraints_linearity(m, vecptr(const_types)) )
+   {
+      const_types.assign(m, NON_LINEAR);
+   }
+   std::vector<bool> considered(m, false);
+   std::vector<Index> row_nnz(m, 0);
+   for( Index k = 0; k < nnz; k++ )
+   {
+      row_nnz[iRow[k]]++;
+   }
+   bool have_considered = false;
+   for( Index i = 0; i < m; i++ )
+   {
+      if( const_types[i] == LINEAR || row_nnz[i] == 0 )
+      {
+         considered[i] = true;
+         have_considered = true;
+      }
+   }
+
+   std::vector<bool> removed(m, false);
+   std::vector<Index> gl_row(m, -1);
+   std::vector<Index> gu_row(m, -1);
+   std::vector<Number> gl_factor(m, 1.);
+   std::vector<Number> gu_factor(m, 1.);
+   x_l_row_.assign(n, -1);
+   x_u_row_.assign(n, -1);
+   x_l_factor_.assign(n, 1.);
+   x_u_factor_.assign(n, 1.);
+
+   std::vector<Number> x0(n);
+   std::vector<Number> g0(m);
+   std::vector<Number> jac0(nnz);
+   if( have_considered
+       && tnlp_->get_starting_point(n, true, vecptr(x0), false, NULL, NULL, m, false, NULL)
+       && tnlp_->eval_g(n, vecptr(x0), true, m, vecptr(g0))
+       && (nnz == 0 || tnlp_->eval_jac_g(n, vecptr(x0), false, m, nnz, NULL, NULL, vecptr(jac0))) )
+   {
+      typedef std::vector<std::pair<Index, Number> > RowCoefs;
+
+      // Collect the coefficients of the considered constraints, sorted
+      // by variable and without zeros, and their constant terms.
+      std::vector<RowCoefs> coefs(m);
+      for( Index k = 0; k < nnz; k++ )
+      {
+         if( considered[iRow[k]] )
+         {
+            coefs[iRow[k]].push_back(std::make_pair(jCol[k], jac0[k]));
+         }
+      }
+      std::vector<Number> cons(m, 0.);
+      for( Index i = 0; i < m; i++ )
+      {
+         if( !considered[i] )
+         {
+            continue;
+         }
+         RowCoefs& row = coefs[i];
+         std::sort(row.begin(), row.end());
+         // sum up duplicate entries
+         size_t len = 0;
+         for( size_t k = 0; k < row.size(); k++ )
+         {
+            if( len > 0 && row[len - 1].first == row[k].first )
+            {
+               row[len - 1].second += row[k].second;
+            }
+            else
+            {
+               row[len++] = row[k];
+            }
+         }
+         row.resize(len);
+         len = 0;
+         for( size_t k = 0; k < row.size(); k++ )
+         {
+            if( row[k].second != 0. )
+            {
+               row[len++] = row[k];
+            }
+         }
+         row.resize(len);
+
+         cons[i] = g0[i];
+         for( size_t k = 0; k < row.size(); k++ )
+         {
+            cons[i] -= row[k].second * x0[row[k].first];
+         }
+      }
+
+      // Remove constant constraints that are satisfied, and turn
+      // constraints with a single coefficient into variable bounds.
+      for( Index i = 0; i < m; i++ )
+      {
+         if( !considered[i] )
+         {
+            continue;
+         }
+         const RowCoefs& row = coefs[i];
+         if( row.empty() )
+         {
+            if( gl[i] <= cons[i] && cons[i] <= gu[i] )
+            {
+               removed[i] = true;
+            }
+         }
+         else if( row.size() == 1 )
+         {
+            const Index j = row[0].first;
+            const Number a = row[0].second;
+            const bool has_l = gl[i] > nlp_lower_bound_inf_;
+            const bool has_u = gu[i] < nlp_upper_bound_inf_;
+            if( a > 0. ? has_l : has_u )
+            {
+               const Number lower = ((a > 0. ? gl[i] : gu[i]) - cons[i]) / a;
+               if( lower > x_l_[j] )
+               {
+                  x_l_[j] = lower;
+                  x_l_row_[j] = i;
+                  x_l_factor_[j] = a;
+               }
+            }
+            if( a > 0. ? has_u : has_l )
+            {
+               const Number upper = ((a > 0. ? gu[i] : gl[i]) - cons[i]) / a;
+               if( upper < x_u_[j] )
+               {
+                  x_u_[j] = upper;
+                  x_u_row_[j] = i;
+                  x_u_factor_[j] = a;
+               }
+            }
+            removed[i] = true;
+         }
+      }
+
+      // Merge linear constraints that are multiples of each other.
+      // They are identified by their coefficients, divided by the
+      // first coefficient.
+      typedef std::map<RowCoefs, Index> RowMap;
+      RowMap rows;
+      for( Index i = 0; i < m; i++ )
+      {
+         if( removed[i] || const_types[i] != LINEAR || coefs[i].size() < 2 )
+         {
+            continue;
+         }
+         RowCoefs key(coefs[i]);
+         const Number a = key[0].second;
+         for( size_t k = 0; k < key.size(); k++ )
+         {
+            key[k].second /= a;
+         }
+         std::pair<RowMap::iterator, bool> ins = rows.insert(std::make_pair(key, i));
+         if( ins.second )
+         {
+            continue;
+         }
+
+         // g_i(x) - cons[i] = t * (g_r(x) - cons[r])
+         const Index r = ins.first->second;
+         const Number t = a / coefs[r][0].second;
+         const bool has_l = gl[i] > nlp_lower_bound_inf_;
+         const bool has_u = gu[i] < nlp_upper_bound_inf_;
+         if( t > 0. ? has_l : has_u )
+         {
+            const Number lower = ((t > 0. ? gl[i] : gu[i]) - cons[i]) / t + cons[r];
+            if( lower > gl[r] )
+            {
+               gl[r] = lower;
+               gl_row[r] = i;
+               gl_factor[r] = t;
+            }
+         }
+         if( t > 0. ? has_u : has_l )
+         {
+            const Number upper = ((t > 0. ? gu[i] : gl[i]) - cons[i]) / t + cons[r];
+            if( upper < gu[r] )
+            {
+               gu[r] = upper;
+               gu_row[r] = i;
+               gu_factor[r] = t;
+            }
+         }
+         removed[i] = true;
+      }
+
+      // Drop the sides of linear constraints that are implied by the
+      // variable bounds, and remove constraints without sides.
+      for( Index i = 0; i < m; i++ )
+      {
+         if( removed[i] || const_types[i] != LINEAR || coefs[i].empty() )
+         {
+            continue;
+         }
+         const RowCoefs& row = coefs[i];
+         Number min_act = cons[i];
+         Number max_act = cons[i];
+         bool min_finite = true;
+         bool max_finite = true;
+         for( size_t k = 0; k < row.size(); k++ )
+         {
+            const Index j = row[k].first;
+            const Number a = row[k].second;
+            const Number xl = (a > 0. ? x_l_[j] : x_u_[j]);
+            const Number xu = (a > 0. ? x_u_[j] : x_l_[j]);
+            if( xl <= nlp_lower_bound_inf_ || xl >= nlp_upper_bound_inf_ )
+            {
+               min_finite = false;
+            }
+            else
+            {
+               min_act += a * xl;
+            }
+            if( xu <= nlp_lower_bound_inf_ || xu >= nlp_upper_bound_inf_ )
+            {
+               max_finite = false;
+            }
+            else
+            {
+               max_act += a * xu;
+            }
+         }
+         if( gl[i] > nlp_lower_bound_inf_ && min_finite && min_act >= gl[i] )
+         {
+            gl[i] = nlp_lower_bound_inf_;
+            gl_row[i] = -1;
+         }
+         if( gu[i] < nlp_upper_bound_inf_ && max_finite && max_act <= gu[i] )
+         {
+            gu[i] = nlp_upper_bound_inf_;
+            gu_row[i] = -1;
+         }
+         if( gl[i] <= nlp_lower_bound_inf_ && gu[i] >= nlp_upper_bound_inf_ )
+         {
+            removed[i] = true;
+         }
+      }
+   }
+
+   g_keep_map_.resize(m);
+   g_l_.clear();
+   g_u_.clear();
+   g_l_row_.clear();
+   g_u_row_.clear();
+   g_l_factor_.clear();
+   g_u_factor_.clear();
+   m_presolved_ = 0;
+   for( Index i = 0; i < m; i++ )
+   {
+      if( removed[i] )
+      {
+         g_keep_map_[i] = -1;
+         continue;
+      }
+      g_keep_map_[i] = m_presolved_;
+      m_presolved_++;
+      g_l_.push_back(gl[i]);
+      g_u_.push_back(gu[i]);
+      g_l_row_.push_back(gl_row[i]);
+      g_u_row_.push_back(gu_row[i]);
+      g_l_factor_.push_back(gl_factor[i]);
+      g_u_factor_.push_back(gu_factor[i]);
+   }
+
+   jac_g_keep_.clear();
+   for( Index k = 0; k < nnz; k++ )
+   {
+      if( !removed[iRow[k]] )
+      {
+         jac_g_keep_.push_back(k);
+      }
+   }
+
+   n_tightened_bounds_ = 0;
+   for( Index j = 0; j < n; j++ )
+   {
+      if( x_l_row_[j] >= 0 )
+      {
+         n_tightened_bounds_++;
+      }
+      if( x_u_row_[j] >= 0 )
+      {
+         n_tightened_bounds_++;
+      }
+   }
+
+   g_orig_.resize(m);
+   jac_g_orig_.resize(nnz);
+   lambda_orig_.resize(m);
+
+   return true;
+}
+
+bool TNLPPresolver::get_nlp_info(
+   Index&          n,
+   Index&          m,
+   Index&          nnz_jac_g,
+   Index&          nnz_h_lag,
+   IndexStyleEnum& index_style
+)
+{
+   // The reductions are computed only once
+   if( m_presolved_ == -1 && !Presolve() )
+   {
+      return false;
+   }
+
+   n = n_;
+   m = m_presolved_;
+   nnz_jac_g = (Index) jac_g_keep_.size();
+   nnz_h_lag = nnz_h_lag_;
+   index_style = index_style_orig_;
+
+   return true;
+}
+
+bool TNLPPresolver::get_bounds_info(
+   Index   /*n*/,
+   Number* x_l,
+   Number* x_u,
+   Index   /*m*/,
+   Number* g_l,
+   Number* g_u
+)
+{
+   std::copy(x_l_.begin(), x_l_.end(), x_l);
+   std::copy(x_u_.begin(), x_u_.end(), x_u);
+   std::copy(g_l_.begin(), g_l_.end(), g_l);
+   std::copy(g_u_.begin(), g_u_.end(), g_u);
+
+   return true;
+}
+
+bool TNLPPresolver::get_scaling_parameters(
+   Number& obj_scaling,
+   bool&   use_x_scaling,
+   Index   n,
+   Number* x_scaling,
+   bool&   use_g_scaling,
+   Index   /*m*/,
+   Number* g_scaling
+)
+{
+   std::vector<Number> g_scaling_orig(m_orig_);
+   bool retval = tnlp_->get_scaling_parameters(obj_scaling, use_x_scaling, n, x_scaling, use_g_scaling, m_orig_,
+                 vecptr(g_scaling_orig));
+
+   if( retval && use_g_scaling )
+   {
+      for( Index i = 0; i < m_orig_; i++ )
+      {
+         const Index new_index = g_keep_map_[i];
+         if( new_index >= 0 )
+         {
+            g_scaling[new_index] = g_scaling_orig[i];
+         }
+      }
+   }
+
+   return retval;
+}
+
+bool TNLPPresolver::get_variables_linearity(
+   Index          n,
+   LinearityType* var_types
+)
+{
+   return tnlp_->get_variables_linearity(n, var_types);
+}
+
+bool TNLPPresolver::get_constraints_linearity(
+   Index /*m*/,
+   LinearityType* const_types
+)
+{
+   std::vector<LinearityType> const_types_orig(m_orig_);
+
+   bool retval = tnlp_->get_constraints_linearity(m_orig_, vecptr(const_types_orig));
+   if( retval )
+   {
+      for( Index i = 0; i < m_orig_; i++ )
+      {
+         const Index new_index = g_keep_map_[i];
+         if( new_index >= 0 )
+         {
+            const_types[new_index] = const_types_orig[i];
+         }
+      }
+   }
+
+   return retval;
+}
+
+bool TNLPPresolver::get_starting_point(
+   Index   n,
+   bool    init_x,
+   Number* x,
+   bool    init_z,
+   Number* z_L,
+   Number* z_U,
+   Index   /*m*/,
+   bool    init_lambda,
+   Number* lambda
+)
+{
+   bool retval = tnlp_->get_starting_point(n, init_x, x, init_z, z_L, z_U, m_orig_, init_lambda,
+                                           init_lambda ? vecptr(lambda_orig_) : NULL);
+
+   if( retval && init_lambda )
+   {
+      for( Index i = 0; i < m_orig_; i++ )
+      {
+         const Index new_index = g_keep_map_[i];
+         if( new_index >= 0 )
+         {
+            lambda[new_index] = lambda_orig_[i];
+         }
+      }
+   }
+
+   return retval;
+}
+
+bool TNLPPresolver::eval_f(
+   Index         n,
+   const Number* x,
+   bool          new_x,
+   Number&       obj_value
+)
+{
+   return tnlp_->eval_f(n, x, new_x, obj_value);
+}
+
+bool TNLPPresolver::eval_grad_f(
+   Index         n,
+   const Number* x,
+   bool          new_x,
+   Number*       grad_f
+)
+{
+   return tnlp_->eval_grad_f(n, x, new_x, grad_f);
+}
+
+bool TNLPPresolver::eval_g(
+   Index         n,
+   const Number* x,
+   bool          new_x,
+   Index         /*m*/,
+   Number*       g
+)
+{
+   bool retval = tnlp_->eval_g(n, x, new_x, m_orig_, vecptr(g_orig_));
+   if( retval )
+   {
+      for( Index i = 0; i < m_orig_; i++ )
+      {
+         const Index new_index = g_keep_map_[i];
+         if( new_index >= 0 )
+         {
+            g[new_index] = g_orig_[i];
+         }
+      }
+   }
+
+   return retval;
+}
+
+bool TNLPPresolver::eval_jac_g(
+   Index         n,
+   const Number* x,
+   bool          new_x,
+   Index         /*m*/,
+   Index         /*nele_jac*/,
+   Index*        iRow,
+   Index*        jCol,
+   Number*       values
+)
+{
+   bool retval;
+
+   if( iRow != NULL )
+   {
+      std::vector<Index> iRow_orig(nnz_jac_g_orig_);
+      std::vector<Index> jCol_orig(nnz_jac_g_orig_);
+      retval = tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, vecptr(iRow_orig), vecptr(jCol_orig), NULL);
+      if( retval )
+      {
+         const Index offset = (index_style_orig_ == FORTRAN_STYLE ? 1 : 0);
+         for( size_t k = 0; k < jac_g_keep_.size(); k++ )
+         {
+            const Index k_orig = jac_g_keep_[k];
+            iRow[k] = g_keep_map_[iRow_orig[k_orig] - offset] + offset;
+            jCol[k] = jCol_orig[k_orig];
+         }
+      }
+   }
+   else
+   {
+      retval = tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, NULL, NULL, vecptr(jac_g_orig_));
+      if( retval )
+      {
+         for( size_t k = 0; k < jac_g_keep_.size(); k++ )
+         {
+            values[k] = jac_g_orig_[jac_g_keep_[k]];
+         }
+      }
+   }
+
+   return retval;
+}
+
+bool TNLPPresolver::eval_h(
+   Index         n,
+   const Number* x,
+   bool          new_x,
+   Number        obj_factor,
+   Index         /*m*/,
+   const Number* lambda,
+   bool          new_lambda,
+   Index         nele_hess,
+   Index*        iRow,
+   Index*        jCol,
+   Number*       values
+)
+{
+   if( !values )
+   {
+      return tnlp_->eval_h(n, x, new_x, obj_factor, m_orig_, lambda, new_lambda, nele_hess, iRow, jCol, values);
+   }
+
+   // the removed constraints are linear
+   for( Index i = 0; i < m_orig_; i++ )
+   {
+      const Index new_index = g_keep_map_[i];
+      lambda_orig_[i] = (new_index >= 0 ? lambda[new_index] : 0.);
+   }
+
+   return tnlp_->eval_h(n, x, new_x, obj_factor, m_orig_, vecptr(lambda_orig_), new_lambda, nele_hess, iRow, jCol,
+                        values);
+}
+
+void TNLPPresolver::finalize_solution(
+   SolverReturn               status,
+   Index                      n,
+   const Number*              x,
+   const Number*              z_L,
+   const Number*              z_U,
+   Index                      /*m*/,
+   const Number*              /*g*/,
+   const Number*              lambda,
+   Number                     obj_value,
+   const IpoptData*           ip_data,
+   IpoptCalculatedQuantities* ip_cq
+)
+{
+   // Give the multiplier of a merged constraint to the original
+   // constraint that defines the active side
+   std::fill(lambda_orig_.begin(), lambda_orig_.end(), 0.);
+   for( Index i = 0; i < m_orig_; i++ )
+   {
+      const Index new_index = g_keep_map_[i];
+      if( new_index < 0 )
+      {
+         continue;
+      }
+      const Number lam = lambda[new_index];
+      if( lam < 0. && g_l_row_[new_index] >= 0 )
+      {
+         lambda_orig_[g_l_row_[new_index]] += lam / g_l_factor_[new_index];
+      }
+      else if( lam > 0. && g_u_row_[new_index] >= 0 )
+      {
+         lambda_orig_[g_u_row_[new_index]] += lam / g_u_factor_[new_index];
+      }
+      else
+      {
+         lambda_orig_[i] += lam;
+      }
+   }
+
+   // Give the multiplier of a tightened variable bound to the
+   // constraint it has been obtained from
+   std::vector<Number> z_L_orig(z_L, z_L + n);
+   std::vector<Number> z_U_orig(z_U, z_U + n);
+   for( Index j = 0; j < n; j++ )
+   {
+      if( x_l_row_[j] >= 0 )
+      {
+         lambda_orig_[x_l_row_[j]] -= z_L[j] / x_l_factor_[j];
+         z_L_orig[j] = 0.;
+      }
+      if( x_u_row_[j] >= 0 )
+      {
+         lambda_orig_[x_u_row_[j]] += z_U[j] / x_u_factor_[j];
+         z_U_orig[j] = 0.;
+      }
+   }
+
+   // call evaluation method to get correct constraint values
+   tnlp_->eval_g(n, x, true, m_orig_, vecptr(g_orig_));
+
+   tnlp_->finalize_solution(status, n, x, vecptr(z_L_orig), vecptr(z_U_orig), m_orig_, vecptr(g_orig_),
+                            vecptr(lambda_orig_), obj_value, ip_data, ip_cq);
+}
+
+bool TNLPPresolver::intermediate_callback(
+   AlgorithmMode              mode,
+   Index                      iter,
+   Number                     obj_value,
+   Number                     inf_pr,
+   Number                     inf_du,
+   Number                     mu,
+   Number                     d_norm,
+   Number                     regularization_size,
+   Number                     alpha_du,
+   Number                     alpha_pr,
+   Index                      ls_trials,
+   const IpoptData*           ip_data,
+   IpoptCalculatedQuantities* ip_cq
+)
+{
+   return tnlp_->intermediate_callback(mode, iter, obj_value, inf_pr, inf_du, mu, d_norm, regularization_size, alpha_du,
+                                       alpha_pr, ls_trials, ip_data, ip_cq);
+}
+
+Index TNLPPresolver::get_number_of_nonlinear_variables()
+{
+   return tnlp_->get_number_of_nonlinear_variables();
+}
+
+bool TNLPPresolver::get_list_of_nonlinear_variables(
+   Index  num_nonlin_vars,
+   Index* pos_nonlin_vars
+)
+{
+   return tnlp_->get_list_of_nonlinear_variables(num_nonlin_vars, pos_nonlin_vars);
+}
+
+}
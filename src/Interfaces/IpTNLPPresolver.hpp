@@ -0,0 +1,320 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPTNLPPRESOLVER_HPP__
+#define __IPTNLPPRESOLVER_HPP__
+
+#include "IpTNLP.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+/** This is a wrapper around a given TNLP class that removes
+ *  constraints that can be handled before the optimization starts.
+ *
+ *  The presolve only works on constraints that the TNLP declares as
+ *  linear in get_constraints_linearity, and on constraints that do
+ *  not have any Jacobian entries.  Their coefficients are obtained
+ *  from the Jacobian at the starting point.  The following
+ *  reductions are done:
+ *  - constraints without (nonzero) coefficients that are satisfied
+ *    are removed,
+ *  - linear constraints with a single coefficient are turned into
+ *    bounds on the variable,
+ *  - linear constraints that are a multiple of another linear
+ *    constraint are merged into that constraint,
+ *  - sides of linear constraints that are implied by the variable
+ *    bounds are dropped, and constraints without sides are removed.
+ *
+ *  The variables are not changed.  Fixed variables that are obtained
+ *  from equality constraints with a single coefficient are handled
+ *  by the fixed_variable_treatment of TNLPAdapter.
+ *
+ *  In finalize_solution, the multipliers of the removed constraints
+ *  are recovered from the multipliers of the bounds and constraints
+ *  that replaced them, before the solution is passed to the original
+ *  TNLP.
+ */
+class IPOPTLIB_EXPORT TNLPPresolver: public TNLP
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor is given the original TNLP and the values below and
+    *  above which bounds are considered infinite.
+    */
+   TNLPPresolver(
+      TNLP&  tnlp,
+      Number nlp_lower_bound_inf,
+      Number nlp_upper_bound_inf
+   );
+
+   /** Default destructor */
+   virtual ~TNLPPresolver();
+   ///@}
+
+   /** @name Overloaded methods from TNLP */
+   ///@{
+   virtual bool get_nlp_info(
+      Index&          n,
+      Index&          m,
+      Index&          nnz_jac_g,
+      Index&          nnz_h_lag,
+      IndexStyleEnum& index_style
+   );
+
+   virtual bool get_bounds_info(
+      Index           n,
+      Number*         x_l,
+      Number*         x_u,
+      Index           m,
+      Number*         g_l,
+      Number*         g_u
+   );
+
+   virtual bool get_scaling_parameters(
+      Number&         obj_scaling,
+      bool&           use_x_scaling,
+      Index           n,
+      Number*         x_scaling,
+      bool&           use_g_scaling,
+      Index           m,
+      Number*         g_scaling
+   );
+
+   virtual bool get_variables_linearity(
+      Index          n,
+      LinearityType* var_types
+   );
+
+   virtual bool get_constraints_linearity(
+      Index          m,
+      LinearityType* const_types
+   );
+
+   virtual bool get_starting_point(
+      Index   n,
+      bool    init_x,
+      Number* x,
+      bool    init_z,
+      Number* z_L,
+      Number* z_U,
+      Index   m,
+      bool    init_lambda,
+      Number* lambda
+   );
+
+   virtual bool eval_f(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number&       obj_value
+   );
+
+   virtual bool eval_grad_f(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number*       grad_f
+   );
+
+   virtual bool eval_g(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Number*       g
+   );
+
+   virtual bool eval_jac_g(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Index         m,
+      Index         nele_jac,
+      Index*        iRow,
+      Index*        jCol,
+      Number*       values
+   );
+
+   virtual bool eval_h(
+      Index         n,
+      const Number* x,
+      bool          new_x,
+      Number        obj_factor,
+      Index         m,
+      const Number* lambda,
+      bool          new_lambda,
+      Index         nele_hess,
+      Index*        iRow,
+      Index*        jCol,
+      Number*       values
+   );
+
+   virtual void finalize_solution(
+      SolverReturn               status,
+      Index                      n,
+      const Number*              x,
+      const Number*              z_L,
+      const Number*              z_U,
+      Index                      m,
+      const Number*              g,
+      const Number*              lambda,
+      Number                     obj_value,
+      const IpoptData*           ip_data,
+      IpoptCalculatedQuantities* ip_cq
+   );
+
+   virtual bool intermediate_callback(
+      AlgorithmMode              mode,
+      Index                      iter,
+      Number                     obj_value,
+      Number                     inf_pr,
+      Number                     inf_du,
+      Number                     mu,
+      Number                     d_norm,
+      Number                     regularization_size,
+      Number                     alpha_du,
+      Number                     alpha_pr,
+      Index                      ls_trials,
+      const IpoptData*           ip_data,
+      IpoptCalculatedQuantities* ip_cq
+   );
+
+   virtual Index get_number_of_nonlinear_variables();
+
+   virtual bool get_list_of_nonlinear_variables(
+      Index  num_nonlin_vars,
+      Index* pos_nonlin_vars
+   );
+   ///@}
+
+   /** Accessor method for the original TNLP */
+   SmartPtr<TNLP> tnlp() const
+   {
+      return tnlp_;
+   }
+
+   /** @name Statistics of the presolve, available after get_nlp_info */
+   ///@{
+   /** Number of constraints that have been removed */
+   Index NumRemovedConstraints() const
+   {
+      return m_orig_ - m_presolved_;
+   }
+
+   /** Number of variable bounds that have been tightened */
+   Index NumTightenedBounds() const
+   {
+      return n_tightened_bounds_;
+   }
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   TNLPPresolver();
+
+   /** Copy Constructor */
+   TNLPPresolver(
+      const TNLPPresolver&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const TNLPPresolver&
+   );
+   ///@}
+
+   /** Compute the reductions.
+    *
+    *  Returns false if the original TNLP could not provide the
+    *  required information.
+    */
+   bool Presolve();
+
+   /** @name original TNLP */
+   ///@{
+   SmartPtr<TNLP> tnlp_;
+   Index n_;
+   Index m_orig_;
+   Index nnz_jac_g_orig_;
+   Index nnz_h_lag_;
+   ///@}
+
+   /** Index style for original problem.
+    *
+    * Internally, we use C-Style now.
+    */
+   IndexStyleEnum index_style_orig_;
+
+   /** @name Values below and above which bounds are infinite */
+   ///@{
+   Number nlp_lower_bound_inf_;
+   Number nlp_upper_bound_inf_;
+   ///@}
+
+   /** Number of constraints in presolved NLP, -1 before Presolve */
+   Index m_presolved_;
+
+   /** Map from original constraints to presolved constraints.
+    *
+    * A -1 means that a constraint is removed.
+    */
+   std::vector<Index> g_keep_map_;
+
+   /** Positions of the original Jacobian elements that are kept */
+   std::vector<Index> jac_g_keep_;
+
+   /** @name Bounds of the presolved NLP */
+   ///@{
+   std::vector<Number> x_l_;
+   std::vector<Number> x_u_;
+   std::vector<Number> g_l_;
+   std::vector<Number> g_u_;
+   ///@}
+
+   /** @name Data for the recovery of the multipliers
+    *
+    *  For each bound of the presolved NLP, the original constraint
+    *  that defines it (-1 if it is the original bound), and the
+    *  factor of that constraint: the coefficient of the variable for
+    *  variable bounds, the multiple of the presolved constraint for
+    *  constraint bounds.
+    */
+   ///@{
+   std::vector<Index> x_l_row_;
+   std::vector<Index> x_u_row_;
+   std::vector<Number> x_l_factor_;
+   std::vector<Number> x_u_factor_;
+   std::vector<Index> g_l_row_;
+   std::vector<Index> g_u_row_;
+   std::vector<Number> g_l_factor_;
+   std::vector<Number> g_u_factor_;
+   ///@}
+
+   /** Number of variable bounds that have been tightened */
+   Index n_tightened_bounds_;
+
+   /** @name Work space for the original constraint values, Jacobian, and multipliers */
+   ///@{
+   std::vector<Number> g_orig_;
+   std::vector<Number> jac_g_orig_;
+   std::vector<Number> lambda_orig_;
+   ///@}
+};
+
+} // namespace Ipopt
+
+#endif
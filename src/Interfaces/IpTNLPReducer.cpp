@@ -28,7 +28,11 @@ TNLPReducer::TNLPReducer(
      index_g_skip_(NULL),
      g_keep_map_(NULL),
      m_reduced_(-1),
-     jac_g_skipped_(NULL),
+     g_keep_(NULL),
+     jac_g_keep_(NULL),
+     g_orig_(NULL),
+     jac_g_orig_(NULL),
+     lambda_orig_(NULL),
      n_xL_skip_(n_xL_skip),
      index_xL_skip_(NULL),
      n_xU_skip_(n_xU_skip),
@@ -73,7 +77,11 @@ TNLPReducer::~TNLPReducer()
 {
    delete[] index_g_skip_;
    delete[] g_keep_map_;
-   delete[] jac_g_skipped_;
+   delete[] g_keep_;
+   delete[] jac_g_keep_;
+   delete[] g_orig_;
+   delete[] jac_g_orig_;
+   delete[] lambda_orig_;
    delete[] index_xL_skip_;
    delete[] index_xU_skip_;
    delete[] index_x_fix_;
@@ -137,11 +145,13 @@ bool TNLPReducer::get_nlp_info(
       {
          delete[] iRow;
          delete[] jCol;
+         return false;
       }
+      Index offset = (index_style_orig_ == FORTRAN_STYLE ? 1 : 0);
       nnz_jac_g_reduced_ = 0;
       nnz_jac_g_skipped_ = 0;
       for( Index i = 0; i < nnz_jac_g_orig_; i++ )
-         if( g_keep_map_[iRow[i]] != -1 )
+         if( g_keep_map_[iRow[i] - offset] != -1 )
          {
             nnz_jac_g_reduced_++;
          }
@@ -154,6 +164,27 @@ bool TNLPReducer::get_nlp_info(
 
       delete[] iRow;
       delete[] jCol;
+
+      // If constraints are skipped, set up the list of kept constraints
+      // and the work arrays for the original problem
+      if( m_reduced_ < m_orig_ )
+      {
+         g_keep_ = new Index[m_reduced_];
+         for( Index i = 0; i < m_orig_; i++ )
+         {
+            if( g_keep_map_[i] >= 0 )
+            {
+               g_keep_[g_keep_map_[i]] = i;
+            }
+         }
+         g_orig_ = new Number[m_orig_];
+         jac_g_orig_ = new Number[nnz_jac_g_orig_];
+         lambda_orig_ = new Number[m_orig_];
+         for( Index i = 0; i < m_orig_; i++ )
+         {
+            lambda_orig_[i] = 0.0;
+         }
+      }
    }
 
    m = m_reduced_;
@@ -372,23 +403,20 @@ bool TNLPReducer::eval_g(
    Number*       g
 )
 {
-   Number* g_orig = new Number[m_orig_];
+   if( g_keep_ == NULL )
+   {
+      return tnlp_->eval_g(n, x, new_x, m_orig_, g);
+   }
 
-   bool retval = tnlp_->eval_g(n, x, new_x, m_orig_, g_orig);
+   bool retval = tnlp_->eval_g(n, x, new_x, m_orig_, g_orig_);
    if( retval )
    {
-      for( Index i = 0; i < m_orig_; i++ )
+      for( Index i = 0; i < m_reduced_; i++ )
       {
-         Index& new_index = g_keep_map_[i];
-         if( new_index >= 0 )
-         {
-            g[new_index] = g_orig[i];
-         }
+         g[i] = g_orig_[g_keep_[i]];
       }
    }
 
-   delete[] g_orig;
-
    return retval;
 }
 
@@ -403,23 +431,28 @@ bool TNLPReducer::eval_jac_g(
    Number*       values
 )
 {
+   if( g_keep_ == NULL )
+   {
+      return tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, iRow, jCol, values);
+   }
+
    bool retval;
 
    if( iRow != NULL )
    {
-      delete[] jac_g_skipped_;
-      jac_g_skipped_ = NULL;
+      delete[] jac_g_keep_;
+      jac_g_keep_ = NULL;
 
+      // the structure is only requested once, so temporary arrays are fine here
       Index* iRow_orig = new Index[nnz_jac_g_orig_];
       Index* jCol_orig = new Index[nnz_jac_g_orig_];
-      retval = tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, iRow_orig, jCol_orig, values);
+      retval = tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, iRow_orig, jCol_orig, NULL);
 
       Index offset = (index_style_orig_ == FORTRAN_STYLE ? 1 : 0);
       if( retval )
       {
-         jac_g_skipped_ = new Index[nnz_jac_g_skipped_ + 1];
+         jac_g_keep_ = new Index[nnz_jac_g_reduced_];
          Index count = 0;
-         Index count2 = 0;
          for( Index i = 0; i < nnz_jac_g_orig_; i++ )
          {
             Index& irow_red = g_keep_map_[iRow_orig[i] - offset];
@@ -427,17 +460,11 @@ bool TNLPReducer::eval_jac_g(
             {
                iRow[count] = irow_red + offset;
                jCol[count] = jCol_orig[i];
+               jac_g_keep_[count] = i;
                count++;
             }
-            else
-            {
-               jac_g_skipped_[count2] = i;
-               count2++;
-            }
          }
-         DBG_ASSERT(count  == nnz_jac_g_reduced_);
-         DBG_ASSERT(count2 == nnz_jac_g_skipped_);
-         jac_g_skipped_[nnz_jac_g_skipped_] = -1;
+         DBG_ASSERT(count == nnz_jac_g_reduced_);
       }
 
       delete[] iRow_orig;
@@ -445,29 +472,15 @@ bool TNLPReducer::eval_jac_g(
    }
    else
    {
-      Number* values_orig = new Number[nnz_jac_g_orig_];
-      retval = tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, iRow, jCol, values_orig);
+      DBG_ASSERT(jac_g_keep_ != NULL);
+      retval = tnlp_->eval_jac_g(n, x, new_x, m_orig_, nnz_jac_g_orig_, iRow, jCol, jac_g_orig_);
       if( retval )
       {
-         Index count = 0;
-         Index count2 = 0;
-         for( Index i = 0; i < nnz_jac_g_orig_; i++ )
+         for( Index i = 0; i < nnz_jac_g_reduced_; i++ )
          {
-            if( jac_g_skipped_[count] == i )
-            {
-               count++;
-            }
-            else
-            {
-               values[count2] = values_orig[i];
-               count2++;
-            }
+            values[i] = jac_g_orig_[jac_g_keep_[i]];
          }
-         DBG_ASSERT(count  == nnz_jac_g_skipped_);
-         DBG_ASSERT(count2 == nnz_jac_g_reduced_);
       }
-
-      delete[] values_orig;
    }
 
    return retval;
@@ -487,30 +500,18 @@ bool TNLPReducer::eval_h(
    Number*       values
 )
 {
-   if( !values )
+   if( !values || g_keep_ == NULL )
    {
       return tnlp_->eval_h(n, x, new_x, obj_factor, m_orig_, lambda, new_lambda, nele_hess, iRow, jCol, values);
    }
 
-   Number* lambda_orig = new Number[m_orig_];
-   for( Index i = 0; i < m_orig_; i++ )
+   // the multipliers of the skipped constraints stay zero
+   for( Index i = 0; i < m_reduced_; i++ )
    {
-      Index& new_index = g_keep_map_[i];
-      if( new_index >= 0 )
-      {
-         lambda_orig[i] = lambda[new_index];
-      }
-      else
-      {
-         lambda_orig[i] = 0.0;
-      }
+      lambda_orig_[g_keep_[i]] = lambda[i];
    }
 
-   bool retval = tnlp_->eval_h(n, x, new_x, obj_factor, m_orig_, lambda_orig, new_lambda, nele_hess, iRow, jCol, values);
-
-   delete[] lambda_orig;
-
-   return retval;
+   return tnlp_->eval_h(n, x, new_x, obj_factor, m_orig_, lambda_orig_, new_lambda, nele_hess, iRow, jCol, values);
 }
 
 void TNLPReducer::finalize_solution(
@@ -16,9 +16,15 @@ namespace Ipopt
  *
  *  It is provided for convenience, if one wants to experiment with
  *  problems that consist of only a subset of the constraints.  But
- *  keep in mind that this is not efficient, since behind the scenes
- *  we are still evaluation all functions and derivatives, and are
- *  making copies of the original data.
+ *  keep in mind that behind the scenes we are still evaluating all
+ *  functions and derivatives.
+ *
+ *  If no constraints are taken out (i.e., only variable bounds are
+ *  skipped or variables are fixed), the arrays of the reduced problem
+ *  are passed to the original TNLP directly.  Otherwise, the values
+ *  of the original TNLP are evaluated into work arrays that are kept
+ *  between evaluations, and the kept elements are gathered by
+ *  compact lists of their original positions.
  */
 class IPOPTLIB_EXPORT TNLPReducer: public TNLP
 {
@@ -247,8 +253,33 @@ private:
    /** Number of Jacobian nonzeros that are skipped */
    Index nnz_jac_g_skipped_;
 
-   /** Array of Jacobian elements that are to be skipped in increasing order. */
-   Index* jac_g_skipped_;
+   /** Original indices of the constraints of the reduced NLP (length m_reduced_),
+    *  or NULL if no constraint is skipped.
+    */
+   Index* g_keep_;
+
+   /** Positions in the original Jacobian of the Jacobian elements of the
+    *  reduced NLP (length nnz_jac_g_reduced_), or NULL if the structure has
+    *  not been requested yet or no constraint is skipped.
+    */
+   Index* jac_g_keep_;
+
+   /** @name Work arrays for the original problem.
+    *
+    *  These are allocated once and NULL if no constraint is skipped.
+    */
+   ///@{
+   /** values of the original constraints (length m_orig_) */
+   Number* g_orig_;
+
+   /** values of the original Jacobian (length nnz_jac_g_orig_) */
+   Number* jac_g_orig_;
+
+   /** multipliers of the original constraints, which are zero for
+    *  the skipped constraints (length m_orig_)
+    */
+   Number* lambda_orig_;
+   ///@}
 
    /** Number of lower variable bounds to be skipped. */
    Index n_xL_skip_;
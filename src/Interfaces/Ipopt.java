@@ -7,6 +7,10 @@
 package org.coinor;
 
 import java.io.File;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.IntBuffer;
 
 /** A Java Native Interface for the Ipopt optimization solver.
  *
@@ -33,6 +37,10 @@ import java.io.File;
  * {@link #create(int, int, int, int, int)}
  * and {@link #OptimizeNLP()} can be called multiple times.
  *
+ * If {@link #setDirectBuffers(boolean)} is enabled, the evaluation callbacks are
+ * called with DoubleBuffer and IntBuffer arguments instead of arrays, see
+ * {@link #eval_f(int, DoubleBuffer, boolean, DoubleBuffer)}.
+ *
  * Programmers must call {@link #dispose()} when finished using a
  * Ipopt object, otherwise the nativelly allocated memory will be disposed of only
  * when the JVM call {@link #finalize()} on it.
@@ -89,9 +97,26 @@ public abstract class Ipopt
       double mult_x_U[],
       double callback_grad_f[],
       double callback_jac_g[],
-      double callback_hess[]
+      double callback_hess[],
+      boolean direct_buffers
    );
 
+   /* Used by the native code to view native memory as DoubleBuffer */
+   private static DoubleBuffer asDoubleBuffer(
+      ByteBuffer buffer
+   )
+   {
+      return buffer.order(ByteOrder.nativeOrder()).asDoubleBuffer();
+   }
+
+   /* Used by the native code to view native memory as IntBuffer */
+   private static IntBuffer asIntBuffer(
+      ByteBuffer buffer
+   )
+   {
+      return buffer.order(ByteOrder.nativeOrder()).asIntBuffer();
+   }
+
    /** Use C index style for iRow and jCol vectors */
    public final static int C_STYLE = 0;
 
@@ -147,6 +172,9 @@ public abstract class Ipopt
    /** Status returned by the solver */
    private int status = INVALID_PROBLEM_DEFINITION;
 
+   /** Whether the evaluation callbacks with direct buffers are used */
+   private boolean direct_buffers = false;
+
    /** Creates a new NLP Solver using a default as the DLL name.
     *
     * This expects the the Ipopt DLL can somehow be found
@@ -426,6 +454,114 @@ public abstract class Ipopt
       double[] values
    );
 
+   /** Method to request the value of the objective function, with direct buffers.
+    *
+    * This method and the other evaluation methods with DoubleBuffer and IntBuffer
+    * arguments are called instead of the ones with arrays if {@link #setDirectBuffers(boolean)}
+    * has been enabled. The buffers are views of the memory of Ipopt, so that no values
+    * are copied between Java and Ipopt. They are only valid during the call and must not be
+    * stored. Buffers for input arguments, e.g., x, must not be modified.
+    * The default implementation returns false; a subclass that enables direct buffers
+    * must override all five evaluation methods with buffers, while the ones with arrays
+    * are not called and may just return false.
+    *
+    *  @param n     (in) the number of variables in the problem
+    *  @param x     (in) the values for the primal variables at which the objective function is to be evaluated
+    *  @param new_x (in) false if any evaluation method was previously called with the same values in x, true otherwise
+    *  @param obj_value (out) buffer of length 1 to store the value of the objective function
+    *
+    * @return true on success, otherwise false
+    *
+    * @see #eval_f(int, double[], boolean, double[])
+    */
+   protected boolean eval_f(
+      int          n,
+      DoubleBuffer x,
+      boolean      new_x,
+      DoubleBuffer obj_value
+   )
+   {
+      return false;
+   }
+
+   /** Method to request the gradient of the objective function, with direct buffers.
+    *
+    * @see #eval_f(int, DoubleBuffer, boolean, DoubleBuffer)
+    * @see #eval_grad_f(int, double[], boolean, double[])
+    */
+   protected boolean eval_grad_f(
+      int          n,
+      DoubleBuffer x,
+      boolean      new_x,
+      DoubleBuffer grad_f
+   )
+   {
+      return false;
+   }
+
+   /** Method to request the constraint values, with direct buffers.
+    *
+    * @see #eval_f(int, DoubleBuffer, boolean, DoubleBuffer)
+    * @see #eval_g(int, double[], boolean, int, double[])
+    */
+   protected boolean eval_g(
+      int          n,
+      DoubleBuffer x,
+      boolean      new_x,
+      int          m,
+      DoubleBuffer g
+   )
+   {
+      return false;
+   }
+
+   /** Method to request either the sparsity structure or the values of the Jacobian of the constraints, with direct buffers.
+    *
+    * As for the method with arrays, x and values are null when the structure is requested,
+    * and iRow and jCol are null when the values are requested.
+    *
+    * @see #eval_f(int, DoubleBuffer, boolean, DoubleBuffer)
+    * @see #eval_jac_g(int, double[], boolean, int, int, int[], int[], double[])
+    */
+   protected boolean eval_jac_g(
+      int          n,
+      DoubleBuffer x,
+      boolean      new_x,
+      int          m,
+      int          nele_jac,
+      IntBuffer    iRow,
+      IntBuffer    jCol,
+      DoubleBuffer values
+   )
+   {
+      return false;
+   }
+
+   /** Method to request either the sparsity structure or the values of the Hessian of the Lagrangian, with direct buffers.
+    *
+    * As for the method with arrays, x, lambda, and values are null when the structure is requested,
+    * and iRow and jCol are null when the values are requested.
+    *
+    * @see #eval_f(int, DoubleBuffer, boolean, DoubleBuffer)
+    * @see #eval_h(int, double[], boolean, double, int, double[], boolean, int, int[], int[], double[])
+    */
+   protected boolean eval_h(
+      int          n,
+      DoubleBuffer x,
+      boolean      new_x,
+      double       obj_factor,
+      int          m,
+      DoubleBuffer lambda,
+      boolean      new_lambda,
+      int          nele_hess,
+      IntBuffer    iRow,
+      IntBuffer    jCol,
+      DoubleBuffer values
+   )
+   {
+      return false;
+   }
+
    /** Dispose of the natively allocated memory.
     *
     * Programmers must call the dispose method when finished
@@ -554,6 +690,24 @@ public abstract class Ipopt
       return AddIpoptStrOption(ipopt, keyword, val.toLowerCase());
    }
 
+   /** Sets whether the evaluation callbacks with direct buffers are used.
+    *
+    * If enabled, Ipopt calls the evaluation methods with DoubleBuffer and
+    * IntBuffer arguments, which view the memory of Ipopt directly, instead of
+    * copying the values into and from Java arrays on every call.
+    * This is useful for large problems, where the copying can take a
+    * considerable part of the time.
+    *
+    * @param use true to use direct buffers in the next calls of {@link #OptimizeNLP()}
+    *
+    * @see #eval_f(int, DoubleBuffer, boolean, DoubleBuffer)
+    */
+   public void setDirectBuffers(
+      boolean use)
+   {
+      direct_buffers = use;
+   }
+
    /** This function actually solve the problem.
     *
     * The solve status returned is one of the constant fields of this class,
@@ -568,7 +722,8 @@ public abstract class Ipopt
    {
       this.status = this.OptimizeTNLP(ipopt,
                                       x, g, obj_val, mult_g, mult_x_L, mult_x_U,
-                                      callback_grad_f, callback_jac_g, callback_hess);
+                                      callback_grad_f, callback_jac_g, callback_hess,
+                                      direct_buffers);
 
       return this.status;
    }
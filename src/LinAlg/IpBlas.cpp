@@ -15,6 +15,41 @@
 #endif
 
 #include <cstring>
+#include <cmath>
+
+/** Vectors with at most this number of elements are handled by inline
+ *  loops instead of a call of the BLAS library, since for such short
+ *  vectors the overhead of the call exceeds the actual work.
+ */
+#ifndef IPOPT_BLAS_INLINE_MAX_DIM
+#define IPOPT_BLAS_INLINE_MAX_DIM 16
+#endif
+
+/** Vectors with at least this number of elements are copied, scaled, and
+ *  updated by several threads if Ipopt has been compiled with OpenMP
+ *  support.
+ */
+#ifndef IPOPT_BLAS_PARALLEL_MIN_DIM
+#define IPOPT_BLAS_PARALLEL_MIN_DIM 50000
+#endif
+
+/* The thread counts of OpenBLAS and MKL can be set if one of them is the
+ * linked BLAS library.  The functions are declared weak, so that they are
+ * NULL for any other BLAS.
+ */
+#if defined(__GNUC__) && defined(__ELF__)
+#define IPOPT_BLAS_THREADS_CONTROL
+extern "C"
+{
+   void openblas_set_num_threads(
+      int num_threads
+   ) __attribute__((weak));
+   int openblas_get_num_threads(void) __attribute__((weak));
+   int mkl_set_num_threads_local(
+      int nt
+   ) __attribute__((weak));
+}
+#endif
 
 // Prototypes for the BLAS routines
 extern "C"
@@ -164,6 +199,61 @@ extern "C"
 
 namespace Ipopt
 {
+/** Number of threads set by IpBlasSetNumThreads, 0 if not set */
+static int blas_num_threads = 0;
+
+#ifdef IPOPT_BLAS_THREADS_CONTROL
+/** Thread count of the BLAS library before it was first changed by
+ *  IpBlasSetNumThreads, 0 if it has not been changed.
+ */
+static int blas_lib_num_threads = 0;
+#endif
+
+int IpBlasSetNumThreads(
+   int nthreads
+)
+{
+   int prev = blas_num_threads;
+   blas_num_threads = nthreads > 0 ? nthreads : 0;
+
+#ifdef IPOPT_BLAS_THREADS_CONTROL
+   if( blas_num_threads > 0 )
+   {
+      if( openblas_set_num_threads != NULL )
+      {
+         if( blas_lib_num_threads == 0 && openblas_get_num_threads != NULL )
+         {
+            blas_lib_num_threads = openblas_get_num_threads();
+         }
+         openblas_set_num_threads(blas_num_threads);
+      }
+      else if( mkl_set_num_threads_local != NULL )
+      {
+         int mkl_prev = mkl_set_num_threads_local(blas_num_threads);
+         if( blas_lib_num_threads == 0 )
+         {
+            // 0 indicates that MKL used its global setting
+            blas_lib_num_threads = mkl_prev > 0 ? mkl_prev : -1;
+         }
+      }
+   }
+   else if( blas_lib_num_threads != 0 )
+   {
+      if( openblas_set_num_threads != NULL )
+      {
+         openblas_set_num_threads(blas_lib_num_threads);
+      }
+      else if( mkl_set_num_threads_local != NULL )
+      {
+         mkl_set_num_threads_local(blas_lib_num_threads > 0 ? blas_lib_num_threads : 0);
+      }
+      blas_lib_num_threads = 0;
+   }
+#endif
+
+   return prev;
+}
+
 Number IpBlasDdot(
    Index         size,
    const Number* x,
@@ -172,7 +262,7 @@ Number IpBlasDdot(
    Index         incY
 )
 {
-   if( incX > 0 && incY > 0 )
+   if( incX > 0 && incY > 0 && size > IPOPT_BLAS_INLINE_MAX_DIM )
    {
       ipfint n = size, INCX = incX, INCY = incY;
 
@@ -182,7 +272,7 @@ Number IpBlasDdot(
    {
       Number s = 0.0;
 
-      for( ; size; --size, x += incX, y += incY )
+      for( ; size > 0; --size, x += incX, y += incY )
       {
          s += *x * *y;
       }
@@ -208,6 +298,18 @@ Number IpBlasDasum(
    Index         incX
 )
 {
+   if( size <= IPOPT_BLAS_INLINE_MAX_DIM && incX > 0 )
+   {
+      Number s = 0.0;
+
+      for( ; size > 0; --size, x += incX )
+      {
+         s += std::abs(*x);
+      }
+
+      return s;
+   }
+
    ipfint n = size, INCX = incX;
 
    return IPOPT_BLAS_FUNC(dasum, DASUM)(&n, x, &INCX);
@@ -220,6 +322,25 @@ Index IpBlasIdamax(
    Index         incX
 )
 {
+   if( size <= IPOPT_BLAS_INLINE_MAX_DIM && incX > 0 )
+   {
+      // as in BLAS, the index is 1-based and the first maximal element is taken
+      Index imax = size > 0 ? 1 : 0;
+      Number vmax = size > 0 ? std::abs(*x) : 0.0;
+
+      for( Index i = 2; i <= size; ++i )
+      {
+         x += incX;
+         if( std::abs(*x) > vmax )
+         {
+            imax = i;
+            vmax = std::abs(*x);
+         }
+      }
+
+      return imax;
+   }
+
    ipfint n = size, INCX = incX;
 
    return (Index) IPOPT_BLAS_FUNC(idamax, IDAMAX)(&n, x, &INCX);
@@ -234,7 +355,16 @@ void IpBlasDcopy(
    Index         incY
 )
 {
-   if( incX > 0 )
+   if( incX == 1 && incY == 1 && (size <= IPOPT_BLAS_INLINE_MAX_DIM || ParallelLoopThreads(size, IPOPT_BLAS_PARALLEL_MIN_DIM, blas_num_threads) > 1) )
+   {
+      const int nthreads = ParallelLoopThreads(size, IPOPT_BLAS_PARALLEL_MIN_DIM, blas_num_threads);
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < size; i++ )
+      {
+         y[i] = x[i];
+      }
+   }
+   else if( incX > 0 )
    {
       ipfint N = size, INCX = incX, INCY = incY;
 
@@ -265,7 +395,16 @@ void IpBlasDaxpy(
    Index         incY
 )
 {
-   if( incX > 0 )
+   if( incX == 1 && incY == 1 && (size <= IPOPT_BLAS_INLINE_MAX_DIM || ParallelLoopThreads(size, IPOPT_BLAS_PARALLEL_MIN_DIM, blas_num_threads) > 1) )
+   {
+      const int nthreads = ParallelLoopThreads(size, IPOPT_BLAS_PARALLEL_MIN_DIM, blas_num_threads);
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < size; i++ )
+      {
+         y[i] += alpha * x[i];
+      }
+   }
+   else if( incX > 0 )
    {
       ipfint N = size, INCX = incX, INCY = incY;
 
@@ -294,6 +433,29 @@ void IpBlasDscal(
    Index   incX
 )
 {
+   if( incX == 1 && (size <= IPOPT_BLAS_INLINE_MAX_DIM || ParallelLoopThreads(size, IPOPT_BLAS_PARALLEL_MIN_DIM, blas_num_threads) > 1) )
+   {
+      const int nthreads = ParallelLoopThreads(size, IPOPT_BLAS_PARALLEL_MIN_DIM, blas_num_threads);
+      if( alpha == 0. )
+      {
+         // as optimized BLAS libraries do, overwrite the vector also if it contains NaN or Inf
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
+         for( Index i = 0; i < size; i++ )
+         {
+            x[i] = 0.;
+         }
+      }
+      else
+      {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
+         for( Index i = 0; i < size; i++ )
+         {
+            x[i] *= alpha;
+         }
+      }
+      return;
+   }
+
    ipfint N = size, INCX = incX;
 
    IPOPT_BLAS_FUNC(dscal, DSCAL)(&N, &alpha, x, &INCX);
@@ -313,7 +475,7 @@ void IpBlasDgemv(
    Index         incY
 )
 {
-   ipfint M = nCols, N = nRows, LDA = ldA, INCX = incX, INCY = incY;
+   ipfint M = nRows, N = nCols, LDA = ldA, INCX = incX, INCY = incY;
 
    char TRANS;
    if( trans )
@@ -11,6 +11,22 @@
 
 namespace Ipopt
 {
+/** Set the number of threads used by the BLAS wrappers.
+ *
+ * Vectors with at most IPOPT_BLAS_INLINE_MAX_DIM elements are handled by
+ * inline loops.  If Ipopt has been compiled with OpenMP support, long
+ * contiguous vectors are copied, scaled, and updated by nthreads threads.
+ * If the linked BLAS library is OpenBLAS or MKL, its number of threads
+ * is set to nthreads as well.  A non-positive value restores the
+ * defaults, that is, the number of OpenMP threads for the wrappers and
+ * the previous setting of the BLAS library.
+ *
+ * @return the previous setting
+ */
+IPOPTLIB_EXPORT int IpBlasSetNumThreads(
+   int nthreads
+);
+
 /** Wrapper for BLAS function DDOT.
  *
  * Compute dot product of vector x and vector y.
@@ -47,7 +63,7 @@ IPOPTLIB_EXPORT Number IpBlasDasum(
  *
  * Compute index for largest absolute element of vector x.
  */
-IPOPTLIB_EXPORT int IpBlasIdamax(
+IPOPTLIB_EXPORT Index IpBlasIdamax(
    Index         size,
    const Number* x,
    Index         incX
@@ -46,6 +46,9 @@ public:
     *  The counting of indices starts at 0.
     *  Since this only the lower left components are stored, we need
     *  to have jcol<=irow, and if irow==jcol, the matrix must be a SymMatrix.
+    *  A component can be set again (also to the same matrix) to mark
+    *  the compound matrix as changed after the component has been
+    *  updated in place.
     */
    void SetComp(
       Index         irow,
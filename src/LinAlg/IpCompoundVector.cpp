@@ -10,6 +10,7 @@
 #include <cmath>
 #include <cstdio>
 #include <limits>
+#include <typeinfo>
 
 namespace Ipopt
 {
@@ -18,6 +19,38 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Array with the elements of all components of a CompoundVector */
+class CompoundVectorStorage: public ReferencedObject
+{
+public:
+   CompoundVectorStorage(
+      Index dim
+   )
+      : values_(new Number[dim])
+   { }
+
+   ~CompoundVectorStorage()
+   {
+      delete[] values_;
+   }
+
+   Number* Values() const
+   {
+      return values_;
+   }
+
+private:
+   CompoundVectorStorage();
+   CompoundVectorStorage(
+      const CompoundVectorStorage&
+   );
+   void operator=(
+      const CompoundVectorStorage&
+   );
+
+   Number* values_;
+};
+
 CompoundVector::CompoundVector(
    const CompoundVectorSpace* owner_space,
    bool                       create_new
@@ -26,7 +59,8 @@ CompoundVector::CompoundVector(
      comps_(owner_space->NCompSpaces()),
      const_comps_(owner_space->NCompSpaces()),
      owner_space_(owner_space),
-     vectors_valid_(false)
+     vectors_valid_(false),
+     contiguous_(false)
 {
    Index dim_check = 0;
    for( Index i = 0; i < NComps(); i++ )
@@ -34,26 +68,148 @@ CompoundVector::CompoundVector(
       SmartPtr<const VectorSpace> space = owner_space_->GetCompSpace(i);
       DBG_ASSERT(IsValid(space));
       dim_check += space->Dim();
-
-      if( create_new )
-      {
-         comps_[i] = space->MakeNew();
-      }
    }
 
    DBG_ASSERT(dim_check == Dim());
 
    if( create_new )
    {
+      if( Dim() > 0 && owner_space_->AllowsContiguousStorage() )
+      {
+         CompoundVectorStorage* storage = new CompoundVectorStorage(Dim());
+         storage_ = storage;
+         MakeContiguousComps(storage->Values());
+      }
+      else
+      {
+         for( Index i = 0; i < NComps(); i++ )
+         {
+            comps_[i] = owner_space_->GetCompSpace(i)->MakeNew();
+         }
+      }
       vectors_valid_ = VectorsValid();
    }
 }
 
+CompoundVector::CompoundVector(
+   const CompoundVectorSpace*              owner_space,
+   const SmartPtr<const ReferencedObject>& storage,
+   Number*                                 values
+)
+   : Vector(owner_space),
+     comps_(owner_space->NCompSpaces()),
+     const_comps_(owner_space->NCompSpaces()),
+     owner_space_(owner_space),
+     vectors_valid_(false),
+     contiguous_(false),
+     storage_(storage)
+{
+   MakeContiguousComps(values);
+   vectors_valid_ = VectorsValid();
+}
+
 CompoundVector::~CompoundVector()
 {
    // ToDo: Do we need an empty here?
 }
 
+void CompoundVector::MakeContiguousComps(
+   Number* values
+)
+{
+   DBG_ASSERT(IsValid(storage_));
+   flat_ = owner_space_->FlatSpace()->MakeNewDenseVector(values, GetRawPtr(storage_));
+   Index offset = 0;
+   for( Index i = 0; i < NComps(); i++ )
+   {
+      SmartPtr<const VectorSpace> space = owner_space_->GetCompSpace(i);
+      const DenseVectorSpace* dense_space = dynamic_cast<const DenseVectorSpace*>(GetRawPtr(space));
+      if( dense_space != NULL )
+      {
+         DenseVector* comp = dense_space->MakeNewDenseVector(values + offset, GetRawPtr(storage_));
+         comps_[i] = comp;
+         flat_leaves_.push_back(comp);
+      }
+      else
+      {
+         const CompoundVectorSpace* comp_space = static_cast<const CompoundVectorSpace*>(GetRawPtr(space));
+         DBG_ASSERT(dynamic_cast<const CompoundVectorSpace*>(GetRawPtr(space)));
+         CompoundVector* comp = new CompoundVector(comp_space, storage_, values + offset);
+         comps_[i] = comp;
+         flat_nested_.push_back(comp);
+         flat_nested_.insert(flat_nested_.end(), comp->flat_nested_.begin(), comp->flat_nested_.end());
+         flat_leaves_.insert(flat_leaves_.end(), comp->flat_leaves_.begin(), comp->flat_leaves_.end());
+      }
+      offset += space->Dim();
+   }
+   DBG_ASSERT(offset == Dim());
+   contiguous_ = true;
+}
+
+bool CompoundVector::IsContiguous() const
+{
+   if( !contiguous_ )
+   {
+      return false;
+   }
+   for( size_t k = 0; k < flat_nested_.size(); k++ )
+   {
+      if( !flat_nested_[k]->contiguous_ )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+const DenseVector* CompoundVector::FlatSource() const
+{
+   if( !IsContiguous() )
+   {
+      return NULL;
+   }
+   for( size_t k = 0; k < flat_leaves_.size(); k++ )
+   {
+      if( !flat_leaves_[k]->initialized_ || flat_leaves_[k]->homogeneous_ )
+      {
+         return NULL;
+      }
+   }
+   // the array holds the current values of all components
+   flat_->initialized_ = true;
+   flat_->homogeneous_ = false;
+   return GetRawPtr(flat_);
+}
+
+DenseVector* CompoundVector::FlatTarget(
+   bool overwrite
+)
+{
+   if( !overwrite )
+   {
+      if( FlatSource() == NULL )
+      {
+         return NULL;
+      }
+   }
+   else if( !IsContiguous() )
+   {
+      return NULL;
+   }
+   for( size_t k = 0; k < flat_leaves_.size(); k++ )
+   {
+      // marks the component as changed and as holding explicit values
+      flat_leaves_[k]->Values();
+   }
+   for( size_t k = 0; k < flat_nested_.size(); k++ )
+   {
+      flat_nested_[k]->ObjectChanged();
+   }
+   flat_->initialized_ = true;
+   flat_->homogeneous_ = false;
+   return GetRawPtr(flat_);
+}
+
 void CompoundVector::SetComp(
    Index         icomp,
    const Vector& vec
@@ -62,6 +218,7 @@ void CompoundVector::SetComp(
    DBG_ASSERT(icomp < NComps());
    comps_[icomp] = NULL;
    const_comps_[icomp] = &vec;
+   contiguous_ = false;
 
    vectors_valid_ = VectorsValid();
    ObjectChanged();
@@ -75,6 +232,7 @@ void CompoundVector::SetCompNonConst(
    DBG_ASSERT(icomp < NComps());
    comps_[icomp] = &vec;
    const_comps_[icomp] = NULL;
+   contiguous_ = false;
 
    vectors_valid_ = VectorsValid();
    ObjectChanged();
@@ -90,6 +248,16 @@ void CompoundVector::CopyImpl(
    DBG_ASSERT(dynamic_cast<const CompoundVector*>(&x));
 
    DBG_ASSERT(NComps() == comp_x->NComps());
+   const DenseVector* flat_x = comp_x->FlatSource();
+   if( flat_x != NULL )
+   {
+      DenseVector* flat = FlatTarget(true);
+      if( flat != NULL )
+      {
+         flat->Copy(*flat_x);
+         return;
+      }
+   }
    for( Index i = 0; i < NComps(); i++ )
    {
       Comp(i)->Copy(*comp_x->GetComp(i));
@@ -102,6 +270,12 @@ void CompoundVector::ScalImpl(
 {
    DBG_START_METH("CompoundVector::ScalImpl", dbg_verbosity);
    DBG_ASSERT(vectors_valid_);
+   DenseVector* flat = FlatTarget(false);
+   if( flat != NULL )
+   {
+      flat->Scal(alpha);
+      return;
+   }
    for( Index i = 0; i < NComps(); i++ )
    {
       DBG_ASSERT(Comp(i));
@@ -120,6 +294,16 @@ void CompoundVector::AxpyImpl(
    DBG_ASSERT(dynamic_cast<const CompoundVector*>(&x));
 
    DBG_ASSERT(NComps() == comp_x->NComps());
+   const DenseVector* flat_x = comp_x->FlatSource();
+   if( flat_x != NULL )
+   {
+      DenseVector* flat = FlatTarget(false);
+      if( flat != NULL )
+      {
+         flat->Axpy(alpha, *flat_x);
+         return;
+      }
+   }
    for( Index i = 0; i < NComps(); i++ )
    {
       DBG_ASSERT(Comp(i));
@@ -203,6 +387,16 @@ void CompoundVector::ElementWiseDivideImpl(
    const CompoundVector* comp_x = static_cast<const CompoundVector*>(&x);
    DBG_ASSERT(dynamic_cast<const CompoundVector*>(&x));
    DBG_ASSERT(NComps() == comp_x->NComps());
+   const DenseVector* flat_x = comp_x->FlatSource();
+   if( flat_x != NULL )
+   {
+      DenseVector* flat = FlatTarget(false);
+      if( flat != NULL )
+      {
+         flat->ElementWiseDivide(*flat_x);
+         return;
+      }
+   }
    for( Index i = 0; i < NComps(); i++ )
    {
       Comp(i)->ElementWiseDivide(*comp_x->GetComp(i));
@@ -218,6 +412,16 @@ void CompoundVector::ElementWiseMultiplyImpl(
    const CompoundVector* comp_x = static_cast<const CompoundVector*>(&x);
    DBG_ASSERT(dynamic_cast<const CompoundVector*>(&x));
    DBG_ASSERT(NComps() == comp_x->NComps());
+   const DenseVector* flat_x = comp_x->FlatSource();
+   if( flat_x != NULL )
+   {
+      DenseVector* flat = FlatTarget(false);
+      if( flat != NULL )
+      {
+         flat->ElementWiseMultiply(*flat_x);
+         return;
+      }
+   }
    for( Index i = 0; i < NComps(); i++ )
    {
       Comp(i)->ElementWiseMultiply(*comp_x->GetComp(i));
@@ -379,6 +583,22 @@ void CompoundVector::AddTwoVectorsImpl(
    DBG_ASSERT(dynamic_cast<const CompoundVector*>(&v2));
    DBG_ASSERT(NComps() == comp_v2->NComps());
 
+   if( a != 0. || b != 0. )
+   {
+      // the array of a vector with a zero factor is not accessed
+      const DenseVector* flat_v1 = a != 0. ? comp_v1->FlatSource() : NULL;
+      const DenseVector* flat_v2 = b != 0. ? comp_v2->FlatSource() : NULL;
+      if( (a == 0. || flat_v1 != NULL) && (b == 0. || flat_v2 != NULL) )
+      {
+         DenseVector* flat = FlatTarget(c == 0.);
+         if( flat != NULL )
+         {
+            flat->AddTwoVectors(a, flat_v1 != NULL ? *flat_v1 : *flat_v2, b, flat_v2 != NULL ? *flat_v2 : *flat_v1, c);
+            return;
+         }
+      }
+   }
+
    for( Index i = 0; i < NComps(); i++ )
    {
       Comp(i)->AddTwoVectors(a, *comp_v1->GetComp(i), b, *comp_v2->GetComp(i), c);
@@ -395,6 +615,16 @@ Number CompoundVector::FracToBoundImpl(
    DBG_ASSERT(dynamic_cast<const CompoundVector*>(&delta));
    DBG_ASSERT(NComps() == comp_delta->NComps());
 
+   const DenseVector* flat = FlatSource();
+   if( flat != NULL )
+   {
+      const DenseVector* flat_delta = comp_delta->FlatSource();
+      if( flat_delta != NULL )
+      {
+         return flat->FracToBound(*flat_delta, tau);
+      }
+   }
+
    Number alpha = 1.;
    for( Index i = 0; i < NComps(); i++ )
    {
@@ -424,6 +654,54 @@ void CompoundVector::AddVectorQuotientImpl(
    }
 }
 
+void CompoundVector::AddVectorProductImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   const Vector& w,
+   Number        c
+)
+{
+   DBG_ASSERT(vectors_valid_);
+   const CompoundVector* comp_v1 = static_cast<const CompoundVector*>(&v1);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&v1));
+   DBG_ASSERT(NComps() == comp_v1->NComps());
+   const CompoundVector* comp_v2 = static_cast<const CompoundVector*>(&v2);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&v2));
+   DBG_ASSERT(NComps() == comp_v2->NComps());
+   const CompoundVector* comp_w = static_cast<const CompoundVector*>(&w);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&w));
+   DBG_ASSERT(NComps() == comp_w->NComps());
+
+   for( Index i = 0; i < NComps(); i++ )
+   {
+      Comp(i)->AddVectorProduct(a, *comp_v1->GetComp(i), b, *comp_v2->GetComp(i), *comp_w->GetComp(i), c);
+   }
+}
+
+Number CompoundVector::AxpyDotImpl(
+   Number        alpha,
+   const Vector& x,
+   const Vector& z
+)
+{
+   DBG_ASSERT(vectors_valid_);
+   const CompoundVector* comp_x = static_cast<const CompoundVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&x));
+   DBG_ASSERT(NComps() == comp_x->NComps());
+   const CompoundVector* comp_z = static_cast<const CompoundVector*>(&z);
+   DBG_ASSERT(dynamic_cast<const CompoundVector*>(&z));
+   DBG_ASSERT(NComps() == comp_z->NComps());
+
+   Number dot = 0.;
+   for( Index i = 0; i < NComps(); i++ )
+   {
+      dot += Comp(i)->AxpyDot(alpha, *comp_x->GetComp(i), *comp_z->GetComp(i));
+   }
+   return dot;
+}
+
 bool CompoundVector::HasValidNumbersImpl() const
 {
    DBG_ASSERT(vectors_valid_);
@@ -450,25 +728,25 @@ void CompoundVector::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sCompoundVector \"%s\" with %d components:\n", prefix.c_str(), name.c_str(), NComps());
+                        "%sCompoundVector \"%s\" with %" IPOPT_INDEX_FORMAT " components:\n", prefix.c_str(), name.c_str(), NComps());
    for( Index i = 0; i < NComps(); i++ )
    {
       jnlst.Printf(level, category,
                    "\n");
       jnlst.PrintfIndented(level, category, indent,
-                           "%sComponent %d:\n", prefix.c_str(), i + 1);
+                           "%sComponent %" IPOPT_INDEX_FORMAT ":\n", prefix.c_str(), i + 1);
       if( ConstComp(i) )
       {
          DBG_ASSERT(name.size() < 200);
          char buffer[256];
-         Snprintf(buffer, 255, "%s[%2d]", name.c_str(), i);
+         Snprintf(buffer, 255, "%s[%2" IPOPT_INDEX_FORMAT "]", name.c_str(), i);
          std::string term_name = buffer;
          ConstComp(i)->Print(&jnlst, level, category, term_name, indent + 1, prefix);
       }
       else
       {
          jnlst.PrintfIndented(level, category, indent,
-                              "%sComponent %d is not yet set!\n", prefix.c_str(), i + 1);
+                              "%sComponent %" IPOPT_INDEX_FORMAT " is not yet set!\n", prefix.c_str(), i + 1);
       }
    }
 }
@@ -495,10 +773,29 @@ CompoundVectorSpace::CompoundVectorSpace(
 )
    : VectorSpace(total_dim),
      ncomp_spaces_(ncomp_spaces),
-     comp_spaces_(ncomp_spaces)
+     comp_spaces_(ncomp_spaces),
+     flat_space_(new DenseVectorSpace(total_dim))
 {
 }
 
+/** Whether huge pages are requested for the values of the vectors of a space */
+static bool UsesHugePages(
+   const VectorSpace& space
+)
+{
+   const DenseVectorSpace* dspace = dynamic_cast<const DenseVectorSpace*>(&space);
+   if( dspace != NULL )
+   {
+      return dspace->UseHugePages();
+   }
+   const CompoundVectorSpace* cspace = dynamic_cast<const CompoundVectorSpace*>(&space);
+   if( cspace != NULL )
+   {
+      return cspace->FlatSpace()->UseHugePages();
+   }
+   return false;
+}
+
 void CompoundVectorSpace::SetCompSpace(
    Index              icomp,
    const VectorSpace& vec_space
@@ -507,6 +804,37 @@ void CompoundVectorSpace::SetCompSpace(
    DBG_ASSERT(icomp < ncomp_spaces_);
    DBG_ASSERT(IsNull(comp_spaces_[icomp]));
    comp_spaces_[icomp] = &vec_space;
+
+   if( !flat_space_->UseHugePages() && UsesHugePages(vec_space) )
+   {
+      flat_space_ = new DenseVectorSpace(Dim(), true);
+   }
+}
+
+bool CompoundVectorSpace::AllowsContiguousStorage() const
+{
+   for( Index i = 0; i < ncomp_spaces_; i++ )
+   {
+      const VectorSpace* space = GetRawPtr(comp_spaces_[i]);
+      if( space == NULL )
+      {
+         return false;
+      }
+      // derived spaces may create vectors of a derived class, so their
+      // vectors are not created inside the array
+      if( typeid(*space) == typeid(CompoundVectorSpace) )
+      {
+         if( !static_cast<const CompoundVectorSpace*>(space)->AllowsContiguousStorage() )
+         {
+            return false;
+         }
+      }
+      else if( typeid(*space) != typeid(DenseVectorSpace) )
+      {
+         return false;
+      }
+   }
+   return true;
 }
 
 SmartPtr<const VectorSpace> CompoundVectorSpace::GetCompSpace(
@@ -9,6 +9,7 @@
 
 #include "IpUtils.hpp"
 #include "IpVector.hpp"
+#include "IpDenseVector.hpp"
 #include <vector>
 
 namespace Ipopt
@@ -42,6 +43,13 @@ public:
     *  each VectorSpace (and are non-const).  Otherwise, the
     *  individual components can later be set using the SetComp and
     *  SetCompNonConst method.
+    *
+    *  If create_new is true and all components are DenseVectors (or
+    *  CompoundVectors whose components are DenseVectors), the elements
+    *  of all components are stored in one contiguous array.  Then
+    *  elementwise operations with other such CompoundVectors are
+    *  performed on the whole array at once, as long as no component
+    *  has been replaced by SetComp or SetCompNonConst.
     */
    CompoundVector(
       const CompoundVectorSpace* owner_space,
@@ -204,6 +212,21 @@ protected:
       const Vector& s,
       Number        c
    );
+
+   void AddVectorProductImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      const Vector& w,
+      Number        c
+   );
+
+   Number AxpyDotImpl(
+      Number        alpha,
+      const Vector& x,
+      const Vector& z
+   );
    ///@}
 
    /** Method for determining if all stored numbers are valid (i.e., no Inf or Nan). */
@@ -256,8 +279,69 @@ private:
 
    bool vectors_valid_;
 
+   /** Whether the components are stored contiguously in storage_
+    *  and none of them has been replaced.
+    */
+   bool contiguous_;
+
    bool VectorsValid();
 
+   /** @name Contiguous storage of the components */
+   ///@{
+   /** Object that owns the array with the elements of all components;
+    *  NULL if the components are not stored contiguously.
+    */
+   SmartPtr<const ReferencedObject> storage_;
+
+   /** DenseVector that views the elements of all components */
+   SmartPtr<DenseVector> flat_;
+
+   /** DenseVector components in the order of their elements,
+    *  including those of nested CompoundVectors.
+    */
+   std::vector<DenseVector*> flat_leaves_;
+
+   /** Nested CompoundVectors whose elements are part of the array */
+   std::vector<CompoundVector*> flat_nested_;
+
+   /** Constructor for a CompoundVector whose components are created
+    *  in the array values, which is owned by storage.
+    */
+   CompoundVector(
+      const CompoundVectorSpace*              owner_space,
+      const SmartPtr<const ReferencedObject>& storage,
+      Number*                                 values
+   );
+
+   /** Create all components in the array values */
+   void MakeContiguousComps(
+      Number* values
+   );
+
+   /** Whether the components are still stored contiguously, also
+    *  within the nested CompoundVectors.
+    */
+   bool IsContiguous() const;
+
+   /** Returns the DenseVector with the elements of all components if
+    *  they are stored contiguously and all components hold explicit
+    *  (non-homogeneous) values; NULL otherwise.
+    */
+   const DenseVector* FlatSource() const;
+
+   /** Returns the DenseVector with the elements of all components if
+    *  they are stored contiguously, so that it can be modified; NULL
+    *  otherwise.
+    *
+    *  If overwrite is false, the current values of all components are
+    *  required to be explicit (non-homogeneous).  All components are
+    *  marked as changed.
+    */
+   DenseVector* FlatTarget(
+      bool overwrite
+   );
+   ///@}
+
    inline const Vector* ConstComp(
       Index i
    ) const;
@@ -309,6 +393,20 @@ public:
       return ncomp_spaces_;
    }
 
+   /** Whether the elements of all components of a vector in this space
+    *  can be stored in one array, that is, whether all component spaces
+    *  are DenseVectorSpaces or CompoundVectorSpaces with this property.
+    */
+   bool AllowsContiguousStorage() const;
+
+   /** DenseVectorSpace with the dimension of this space, for the
+    *  DenseVector that views the elements of all components.
+    */
+   const DenseVectorSpace* FlatSpace() const
+   {
+      return GetRawPtr(flat_space_);
+   }
+
    /** Method for creating a new vector of this specific type. */
    virtual CompoundVector* MakeNewCompoundVector(
       bool create_new = true
@@ -350,6 +448,12 @@ private:
 
    /** std::vector of vector spaces for the components */
    std::vector<SmartPtr<const VectorSpace> > comp_spaces_;
+
+   /** DenseVectorSpace with the dimension of this space
+    *
+    *  It requests huge pages if one of the component spaces does.
+    */
+   SmartPtr<const DenseVectorSpace> flat_space_;
 };
 
 /* inline methods */
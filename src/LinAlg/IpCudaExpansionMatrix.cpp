@@ -0,0 +1,155 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpCudaExpansionMatrix.hpp"
+#include "IpCudaVector.hpp"
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+CudaExpansionMatrix::CudaExpansionMatrix(
+   const CudaExpansionMatrixSpace* owner_space
+)
+   : Matrix(owner_space),
+     owner_space_(owner_space)
+{ }
+
+CudaExpansionMatrix::~CudaExpansionMatrix()
+{ }
+
+void CudaExpansionMatrix::MultVectorImpl(
+   Number        alpha,
+   const Vector& x,
+   Number        beta,
+   Vector&       y
+) const
+{
+   //  A few sanity checks
+   DBG_ASSERT(NCols() == x.Dim());
+   DBG_ASSERT(NRows() == y.Dim());
+
+   // Take care of the y part of the addition
+   if( beta != 0.0 )
+   {
+      y.Scal(beta);
+   }
+   else
+   {
+      y.Set(0.0);  // In case y hasn't been initialized yet
+   }
+
+   const CudaVector* cuda_x = static_cast<const CudaVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const CudaVector*>(&x));
+   CudaVector* cuda_y = static_cast<CudaVector*>(&y);
+   DBG_ASSERT(dynamic_cast<CudaVector*>(&y));
+
+   if( alpha != 0. )
+   {
+      cuda_y->AddScattered(alpha, *cuda_x, owner_space_->DeviceExpandedPosIndices());
+   }
+}
+
+void CudaExpansionMatrix::TransMultVectorImpl(
+   Number        alpha,
+   const Vector& x,
+   Number        beta,
+   Vector&       y
+) const
+{
+   //  A few sanity checks
+   DBG_ASSERT(NCols() == y.Dim());
+   DBG_ASSERT(NRows() == x.Dim());
+
+   // Take care of the y part of the addition
+   if( beta != 0.0 )
+   {
+      y.Scal(beta);
+   }
+   else
+   {
+      y.Set(0.0);  // In case y hasn't been initialized yet
+   }
+
+   const CudaVector* cuda_x = static_cast<const CudaVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const CudaVector*>(&x));
+   CudaVector* cuda_y = static_cast<CudaVector*>(&y);
+   DBG_ASSERT(dynamic_cast<CudaVector*>(&y));
+
+   if( alpha != 0. )
+   {
+      cuda_y->AddGathered(alpha, *cuda_x, owner_space_->DeviceExpandedPosIndices());
+   }
+}
+
+void CudaExpansionMatrix::ComputeRowAMaxImpl(
+   Vector& rows_norms,
+   bool    /*init*/
+) const
+{
+   CudaVector* cuda_vec = static_cast<CudaVector*>(&rows_norms);
+   DBG_ASSERT(dynamic_cast<CudaVector*>(&rows_norms));
+
+   cuda_vec->MaxScattered(1., NCols(), owner_space_->DeviceExpandedPosIndices());
+}
+
+void CudaExpansionMatrix::ComputeColAMaxImpl(
+   Vector& cols_norms,
+   bool    init
+) const
+{
+   if( init )
+   {
+      cols_norms.Set(1.);
+   }
+   else
+   {
+      SmartPtr<Vector> v = cols_norms.MakeNew();
+      v->Set(1.);
+      cols_norms.ElementWiseMax(*v);
+   }
+}
+
+void CudaExpansionMatrix::PrintImpl(
+   const Journalist&  jnlst,
+   EJournalLevel      level,
+   EJournalCategory   category,
+   const std::string& name,
+   Index              indent,
+   const std::string& prefix
+) const
+{
+   jnlst.Printf(level, category,
+                "\n");
+   jnlst.PrintfIndented(level, category, indent,
+                        "%sCudaExpansionMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " rows and %" IPOPT_INDEX_FORMAT " columns:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
+
+   const Index* exp_pos = owner_space_->HostSpace()->ExpandedPosIndices();
+
+   for( Index i = 0; i < NCols(); i++ )
+   {
+      jnlst.PrintfIndented(level, category, indent,
+                           "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e  (%" IPOPT_INDEX_FORMAT ")\n", prefix.c_str(), name.c_str(), exp_pos[i] + 1, i + 1, 1., i);
+   }
+}
+
+CudaExpansionMatrixSpace::CudaExpansionMatrixSpace(
+   const SmartPtr<const ExpansionMatrixSpace>& host_space
+)
+   : MatrixSpace(host_space->NRows(), host_space->NCols()),
+     host_space_(host_space)
+{
+   d_expanded_pos_ = CudaCopyIndicesToDevice(NCols(), host_space_->ExpandedPosIndices());
+}
+
+CudaExpansionMatrixSpace::~CudaExpansionMatrixSpace()
+{
+   CudaFreeIndices(d_expanded_pos_);
+}
+
+} // namespace Ipopt
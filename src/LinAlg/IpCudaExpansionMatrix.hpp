@@ -0,0 +1,165 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPCUDAEXPANSIONMATRIX_HPP__
+#define __IPCUDAEXPANSIONMATRIX_HPP__
+
+#include "IpUtils.hpp"
+#include "IpMatrix.hpp"
+#include "IpExpansionMatrix.hpp"
+
+namespace Ipopt
+{
+
+/** forward declarations */
+class CudaExpansionMatrixSpace;
+
+/** Expansion matrix for CudaVectors.
+ *
+ *  This is the counterpart of ExpansionMatrix for vectors in device
+ *  memory: the mapping from the small to the large vector is given
+ *  by an ExpansionMatrixSpace, and a copy of it is kept on the device
+ *  by the CudaExpansionMatrixSpace.  All vectors must be CudaVectors.
+ *
+ *  Diagonal matrices of CudaVectors do not need a class of their own,
+ *  since DiagMatrix only uses methods of the Vector base class.
+ *
+ *  This class is only available if Ipopt has been configured with
+ *  CUDA (IPOPT_HAS_CUDA).
+ */
+class IPOPTLIB_EXPORT CudaExpansionMatrix: public Matrix
+{
+public:
+   /**@name Constructors / Destructors */
+   ///@{
+   /** Constructor, taking the owner_space.
+    */
+   CudaExpansionMatrix(
+      const CudaExpansionMatrixSpace* owner_space
+   );
+
+   /** Destructor */
+   ~CudaExpansionMatrix();
+   ///@}
+
+protected:
+   /**@name Overloaded methods from Matrix base class*/
+   ///@{
+   virtual void MultVectorImpl(
+      Number        alpha,
+      const Vector& x,
+      Number        beta,
+      Vector&       y
+   ) const;
+
+   virtual void TransMultVectorImpl(
+      Number        alpha,
+      const Vector& x,
+      Number        beta,
+      Vector&       y
+   ) const;
+
+   virtual void ComputeRowAMaxImpl(
+      Vector& rows_norms,
+      bool    init
+   ) const;
+
+   virtual void ComputeColAMaxImpl(
+      Vector& cols_norms,
+      bool    init
+   ) const;
+
+   virtual void PrintImpl(
+      const Journalist&  jnlst,
+      EJournalLevel      level,
+      EJournalCategory   category,
+      const std::string& name,
+      Index              indent,
+      const std::string& prefix
+   ) const;
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   CudaExpansionMatrix();
+
+   /** Copy Constructor */
+   CudaExpansionMatrix(
+      const CudaExpansionMatrix&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const CudaExpansionMatrix&
+   );
+   ///@}
+
+   const CudaExpansionMatrixSpace* owner_space_;
+};
+
+/** This is the matrix space for CudaExpansionMatrix. */
+class IPOPTLIB_EXPORT CudaExpansionMatrixSpace: public MatrixSpace
+{
+public:
+   /** @name Constructors / Destructors */
+   ///@{
+   /** Constructor, given the space of the expansion matrix on the host.
+    *
+    *  Its mapping from the small to the large vector is copied to the
+    *  device.
+    */
+   CudaExpansionMatrixSpace(
+      const SmartPtr<const ExpansionMatrixSpace>& host_space
+   );
+
+   /** Destructor */
+   ~CudaExpansionMatrixSpace();
+   ///@}
+
+   /** Method for creating a new matrix of this specific type. */
+   CudaExpansionMatrix* MakeNewCudaExpansionMatrix() const
+   {
+      return new CudaExpansionMatrix(this);
+   }
+
+   virtual Matrix* MakeNew() const
+   {
+      return MakeNewCudaExpansionMatrix();
+   }
+
+   /** The space of the expansion matrix on the host */
+   SmartPtr<const ExpansionMatrixSpace> HostSpace() const
+   {
+      return host_space_;
+   }
+
+   /** Device array (of length NCols()) with the mapping from the
+    *  small vector to the large vector, see
+    *  ExpansionMatrixSpace::ExpandedPosIndices.
+    */
+   const Index* DeviceExpandedPosIndices() const
+   {
+      return d_expanded_pos_;
+   }
+
+private:
+   /** The space of the expansion matrix on the host */
+   SmartPtr<const ExpansionMatrixSpace> host_space_;
+
+   /** Copy of host_space_->ExpandedPosIndices() on the device */
+   Index* d_expanded_pos_;
+};
+
+} // namespace Ipopt
+
+#endif
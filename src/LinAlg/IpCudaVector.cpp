@@ -0,0 +1,911 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpCudaVector.hpp"
+#include "IpDenseVector.hpp"
+
+#include <cuda.h>
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+#include <nvrtc.h>
+
+#include <climits>
+#include <cmath>
+#include <limits>
+
+/** Maximal number of deleted vectors of a CudaVectorSpace whose device memory is kept for reuse */
+#ifndef IPOPT_CUDAVECTORSPACE_POOL_SIZE
+#define IPOPT_CUDAVECTORSPACE_POOL_SIZE 16
+#endif
+
+/** Number of threads of the blocks of the kernels, must be a power of 2 */
+#define IPOPT_CUDA_BLOCK_SIZE 256
+
+/** Maximal number of blocks of the element-wise kernels */
+#define IPOPT_CUDA_MAX_BLOCKS 4096
+
+/** Maximal number of blocks of the reduction kernel, i.e., of partial results that are combined on the host */
+#define IPOPT_CUDA_MAX_REDUCE_BLOCKS 256
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+/** Operations of the map kernel */
+enum ECudaMapOp
+{
+   MAP_SET = 0,
+   MAP_DIVIDE,
+   MAP_MULTIPLY,
+   MAP_MAX,
+   MAP_MIN,
+   MAP_RECIPROCAL,
+   MAP_ABS,
+   MAP_SQRT,
+   MAP_SGN,
+   MAP_ADD_SCALAR
+};
+
+/** Operations of the reduction kernel */
+enum ECudaReduceOp
+{
+   REDUCE_SUM = 0,
+   REDUCE_SUMLOGS,
+   REDUCE_MAX,
+   REDUCE_MIN,
+   REDUCE_FRAC_TO_BOUND
+};
+
+/** Source of the kernels, compiled with NVRTC.
+ *
+ *  The op codes must agree with ECudaMapOp and ECudaReduceOp.  The
+ *  comparisons in max and min are those of Ipopt::Max and Ipopt::Min,
+ *  so that the results agree with those of DenseVector also for NaN.
+ */
+static const char* cuda_vector_kernels =
+   "#ifdef IPOPT_CUDA_INT64\n"
+   "typedef long long ipindex;\n"
+   "#else\n"
+   "typedef int ipindex;\n"
+   "#endif\n"
+   "#define IPOPT_CUDA_LOOP(i, n) for( ipindex i = blockIdx.x * (ipindex) blockDim.x + threadIdx.x; i < n; i += (ipindex) blockDim.x * gridDim.x )\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_map(ipindex n, int op, double* y, const double* x, double s)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      switch( op )\n"
+   "      {\n"
+   "         case 0: y[i] = s; break;\n"
+   "         case 1: y[i] /= x[i]; break;\n"
+   "         case 2: y[i] *= x[i]; break;\n"
+   "         case 3: y[i] = y[i] > x[i] ? y[i] : x[i]; break;\n"
+   "         case 4: y[i] = y[i] < x[i] ? y[i] : x[i]; break;\n"
+   "         case 5: y[i] = 1. / y[i]; break;\n"
+   "         case 6: y[i] = fabs(y[i]); break;\n"
+   "         case 7: y[i] = sqrt(y[i]); break;\n"
+   "         case 8: y[i] = y[i] > 0. ? 1. : (y[i] < 0. ? -1. : 0.); break;\n"
+   "         case 9: y[i] += s; break;\n"
+   "      }\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_add_two(ipindex n, double* y, double a, const double* v1, double b, const double* v2, double c)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      double r = c == 0. ? 0. : c * y[i];\n"
+   "      if( a != 0. ) r += a * v1[i];\n"
+   "      if( b != 0. ) r += b * v2[i];\n"
+   "      y[i] = r;\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_add_quotient(ipindex n, double* y, double a, const double* z, const double* s, double c)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      y[i] = (c == 0. ? 0. : c * y[i]) + a * z[i] / s[i];\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_add_product(ipindex n, double* y, double a, const double* v1, double b, const double* v2, const double* w, double c)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      double r = c == 0. ? 0. : c * y[i];\n"
+   "      if( a != 0. ) r += a * v1[i];\n"
+   "      if( b != 0. ) r += b * v2[i] * w[i];\n"
+   "      y[i] = r;\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_gather(ipindex n, double* y, double alpha, const double* x, const ipindex* map)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      y[i] += alpha * x[map[i]];\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_scatter(ipindex n, double* y, double alpha, const double* x, const ipindex* map)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      y[map[i]] += alpha * x[i];\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_scatter_max(ipindex n, double* y, double value, const ipindex* map)\n"
+   "{\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      y[map[i]] = y[map[i]] > value ? y[map[i]] : value;\n"
+   "   }\n"
+   "}\n"
+   "\n"
+   "__device__ double ipopt_cuda_combine(int op, double r, double v)\n"
+   "{\n"
+   "   if( op <= 1 ) return r + v;\n"
+   "   if( op == 2 ) return v > r ? v : r;\n"
+   "   return v < r ? v : r;\n"
+   "}\n"
+   "\n"
+   "extern \"C\" __global__ void ipopt_cuda_reduce(ipindex n, int op, const double* x, const double* d, double tau, double init, double* partials)\n"
+   "{\n"
+   "   __shared__ double s[IPOPT_CUDA_BLOCK_SIZE];\n"
+   "   double r = init;\n"
+   "   IPOPT_CUDA_LOOP(i, n)\n"
+   "   {\n"
+   "      switch( op )\n"
+   "      {\n"
+   "         case 0: r += x[i]; break;\n"
+   "         case 1: r += log(x[i]); break;\n"
+   "         case 4: if( d[i] < 0. ) r = ipopt_cuda_combine(op, r, -tau / d[i] * x[i]); break;\n"
+   "         default: r = ipopt_cuda_combine(op, r, x[i]); break;\n"
+   "      }\n"
+   "   }\n"
+   "   s[threadIdx.x] = r;\n"
+   "   __syncthreads();\n"
+   "   for( unsigned int k = blockDim.x / 2; k > 0; k /= 2 )\n"
+   "   {\n"
+   "      if( threadIdx.x < k ) s[threadIdx.x] = ipopt_cuda_combine(op, s[threadIdx.x], s[threadIdx.x + k]);\n"
+   "      __syncthreads();\n"
+   "   }\n"
+   "   if( threadIdx.x == 0 ) partials[blockIdx.x] = s[0];\n"
+   "}\n";
+
+/** CUDA objects shared by all CudaVectors.
+ *
+ *  These are created by the first CudaVectorSpace and kept until the
+ *  end of the program.
+ */
+struct CudaVectorContext
+{
+   bool initialized;
+   cublasHandle_t blas;
+   CUmodule module;
+   CUfunction map;
+   CUfunction add_two;
+   CUfunction add_quotient;
+   CUfunction add_product;
+   CUfunction gather;
+   CUfunction scatter;
+   CUfunction scatter_max;
+   CUfunction reduce;
+   /** device array for the partial results of the reduction kernel */
+   Number* partials;
+};
+
+static CudaVectorContext cuda_context;
+
+static void CheckCuda(
+   cudaError_t status,
+   const char* what
+)
+{
+   if( status != cudaSuccess )
+   {
+      THROW_EXCEPTION(CUDA_VECTOR_ERROR, std::string(what) + " failed: " + cudaGetErrorString(status));
+   }
+}
+
+static void CheckCuda(
+   CUresult    status,
+   const char* what
+)
+{
+   if( status != CUDA_SUCCESS )
+   {
+      const char* msg = NULL;
+      cuGetErrorString(status, &msg);
+      THROW_EXCEPTION(CUDA_VECTOR_ERROR, std::string(what) + " failed: " + (msg != NULL ? msg : "unknown error"));
+   }
+}
+
+static void CheckCuda(
+   cublasStatus_t status,
+   const char*    what
+)
+{
+   if( status != CUBLAS_STATUS_SUCCESS )
+   {
+      char buffer[64];
+      Snprintf(buffer, 63, " failed with cuBLAS status %d", (int) status);
+      THROW_EXCEPTION(CUDA_VECTOR_ERROR, std::string(what) + buffer);
+   }
+}
+
+static void CheckCuda(
+   nvrtcResult status,
+   const char* what
+)
+{
+   if( status != NVRTC_SUCCESS )
+   {
+      THROW_EXCEPTION(CUDA_VECTOR_ERROR, std::string(what) + " failed: " + nvrtcGetErrorString(status));
+   }
+}
+
+/** Compile the kernels and create the cuBLAS handle, if not done yet */
+static void InitializeCudaContext()
+{
+   if( cuda_context.initialized )
+   {
+      return;
+   }
+
+   // make the primary context of the current device current, so that it is shared with the runtime API
+   CheckCuda(cudaFree(0), "Initialization of CUDA");
+   int device;
+   int major;
+   int minor;
+   CheckCuda(cudaGetDevice(&device), "cudaGetDevice");
+   CheckCuda(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device), "cudaDeviceGetAttribute");
+   CheckCuda(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device), "cudaDeviceGetAttribute");
+
+   char arch[64];
+   Snprintf(arch, 63, "--gpu-architecture=compute_%d%d", major, minor);
+   char block_size[64];
+   Snprintf(block_size, 63, "-DIPOPT_CUDA_BLOCK_SIZE=%d", IPOPT_CUDA_BLOCK_SIZE);
+   const char* compile_options[] =
+   {
+      arch,
+      block_size,
+#ifdef IPOPT_INT64
+      "-DIPOPT_CUDA_INT64",
+#endif
+      "--std=c++11"
+   };
+   int num_options = (int) (sizeof(compile_options) / sizeof(compile_options[0]));
+
+   nvrtcProgram program;
+   CheckCuda(nvrtcCreateProgram(&program, cuda_vector_kernels, "ipopt_cuda_vector.cu", 0, NULL, NULL),
+             "nvrtcCreateProgram");
+   nvrtcResult compiled = nvrtcCompileProgram(program, num_options, compile_options);
+   if( compiled != NVRTC_SUCCESS )
+   {
+      size_t log_size = 0;
+      nvrtcGetProgramLogSize(program, &log_size);
+      std::string log(log_size, '\0');
+      if( log_size > 0 )
+      {
+         nvrtcGetProgramLog(program, &log[0]);
+      }
+      nvrtcDestroyProgram(&program);
+      THROW_EXCEPTION(CUDA_VECTOR_ERROR, std::string("Compilation of the CudaVector kernels failed: ") + nvrtcGetErrorString(compiled) + "\n" + log);
+   }
+   size_t ptx_size;
+   CheckCuda(nvrtcGetPTXSize(program, &ptx_size), "nvrtcGetPTXSize");
+   std::string ptx(ptx_size, '\0');
+   CheckCuda(nvrtcGetPTX(program, &ptx[0]), "nvrtcGetPTX");
+   nvrtcDestroyProgram(&program);
+
+   CheckCuda(cuModuleLoadDataEx(&cuda_context.module, ptx.c_str(), 0, NULL, NULL), "Loading the CudaVector kernels");
+   CheckCuda(cuModuleGetFunction(&cuda_context.map, cuda_context.module, "ipopt_cuda_map"), "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.add_two, cuda_context.module, "ipopt_cuda_add_two"), "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.add_quotient, cuda_context.module, "ipopt_cuda_add_quotient"),
+             "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.add_product, cuda_context.module, "ipopt_cuda_add_product"),
+             "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.gather, cuda_context.module, "ipopt_cuda_gather"), "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.scatter, cuda_context.module, "ipopt_cuda_scatter"), "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.scatter_max, cuda_context.module, "ipopt_cuda_scatter_max"),
+             "cuModuleGetFunction");
+   CheckCuda(cuModuleGetFunction(&cuda_context.reduce, cuda_context.module, "ipopt_cuda_reduce"), "cuModuleGetFunction");
+
+   CheckCuda(cublasCreate(&cuda_context.blas), "cublasCreate");
+   CheckCuda(cudaMalloc((void**) &cuda_context.partials, IPOPT_CUDA_MAX_REDUCE_BLOCKS * sizeof(Number)),
+             "cudaMalloc");
+
+   cuda_context.initialized = true;
+}
+
+/** Number of blocks for a kernel on n elements */
+static unsigned int NumBlocks(
+   Index n,
+   Index max_blocks
+)
+{
+   Index nblocks = (n + IPOPT_CUDA_BLOCK_SIZE - 1) / IPOPT_CUDA_BLOCK_SIZE;
+   return (unsigned int) (nblocks < max_blocks ? nblocks : max_blocks);
+}
+
+/** Launch a kernel on n elements with the given arguments */
+static void LaunchKernel(
+   CUfunction function,
+   Index      n,
+   void**     args
+)
+{
+   CheckCuda(cuLaunchKernel(function, NumBlocks(n, IPOPT_CUDA_MAX_BLOCKS), 1, 1, IPOPT_CUDA_BLOCK_SIZE, 1, 1, 0, NULL, args,
+                            NULL), "Launch of a CudaVector kernel");
+}
+
+/** Combination of two results of the reduction kernel, as in ipopt_cuda_combine */
+static inline Number CombineReduction(
+   int    op,
+   Number r,
+   Number v
+)
+{
+   if( op <= REDUCE_SUMLOGS )
+   {
+      return r + v;
+   }
+   if( op == REDUCE_MAX )
+   {
+      return v > r ? v : r;
+   }
+   return v < r ? v : r;
+}
+
+Index* CudaCopyIndicesToDevice(
+   Index        n,
+   const Index* indices
+)
+{
+   if( n == 0 )
+   {
+      return NULL;
+   }
+   Index* d_indices;
+   CheckCuda(cudaMalloc((void**) &d_indices, n * sizeof(Index)), "cudaMalloc");
+   CheckCuda(cudaMemcpy(d_indices, indices, n * sizeof(Index), cudaMemcpyHostToDevice), "cudaMemcpy");
+   return d_indices;
+}
+
+void CudaFreeIndices(
+   Index* indices
+)
+{
+   if( indices != NULL )
+   {
+      cudaFree(indices);
+   }
+}
+
+CudaVector::CudaVector(
+   const CudaVectorSpace* owner_space
+)
+   : Vector(owner_space),
+     owner_space_(owner_space)
+{
+   values_ = owner_space_->AllocateInternalStorage();
+}
+
+CudaVector::~CudaVector()
+{
+   owner_space_->FreeInternalStorage(values_);
+}
+
+SmartPtr<CudaVector> CudaVector::MakeNewCudaVector() const
+{
+   return owner_space_->MakeNewCudaVector();
+}
+
+const Number* CudaVector::Values(
+   const Vector& x
+)
+{
+   DBG_ASSERT(dynamic_cast<const CudaVector*>(&x));
+   return static_cast<const CudaVector&>(x).values_;
+}
+
+void CudaVector::Map(
+   int           op,
+   const Number* x,
+   Number        scalar
+)
+{
+   if( Dim() == 0 )
+   {
+      return;
+   }
+   Index n = Dim();
+   void* args[] = { &n, &op, &values_, &x, &scalar };
+   LaunchKernel(cuda_context.map, n, args);
+}
+
+Number CudaVector::Reduce(
+   int           op,
+   const Number* d,
+   Number        tau
+) const
+{
+   DBG_ASSERT(Dim() > 0);
+   Number init;
+   switch( op )
+   {
+      case REDUCE_MAX:
+         init = -std::numeric_limits<Number>::max();
+         break;
+      case REDUCE_MIN:
+         init = std::numeric_limits<Number>::max();
+         break;
+      case REDUCE_FRAC_TO_BOUND:
+         init = 1.;
+         break;
+      default:
+         init = 0.;
+         break;
+   }
+
+   Index n = Dim();
+   const Number* x = values_;
+   void* args[] = { &n, &op, &x, &d, &tau, &init, &cuda_context.partials };
+   unsigned int nblocks = NumBlocks(n, IPOPT_CUDA_MAX_REDUCE_BLOCKS);
+   CheckCuda(cuLaunchKernel(cuda_context.reduce, nblocks, 1, 1, IPOPT_CUDA_BLOCK_SIZE, 1, 1, 0, NULL, args, NULL),
+             "Launch of a CudaVector kernel");
+
+   Number partials[IPOPT_CUDA_MAX_REDUCE_BLOCKS];
+   CheckCuda(cudaMemcpy(partials, cuda_context.partials, nblocks * sizeof(Number), cudaMemcpyDeviceToHost),
+             "cudaMemcpy");
+   Number result = partials[0];
+   for( unsigned int k = 1; k < nblocks; k++ )
+   {
+      result = CombineReduction(op, result, partials[k]);
+   }
+   return result;
+}
+
+void CudaVector::SetValues(
+   const Number* values
+)
+{
+   if( Dim() > 0 )
+   {
+      CheckCuda(cudaMemcpy(values_, values, Dim() * sizeof(Number), cudaMemcpyHostToDevice), "cudaMemcpy");
+   }
+   ObjectChanged();
+}
+
+void CudaVector::GetValues(
+   Number* values
+) const
+{
+   if( Dim() > 0 )
+   {
+      CheckCuda(cudaMemcpy(values, values_, Dim() * sizeof(Number), cudaMemcpyDeviceToHost), "cudaMemcpy");
+   }
+}
+
+void CudaVector::CopyToDenseVector(
+   DenseVector& x
+) const
+{
+   DBG_ASSERT(x.Dim() == Dim());
+   GetValues(x.Values());
+}
+
+void CudaVector::AddGathered(
+   Number            alpha,
+   const CudaVector& x,
+   const Index*      map
+)
+{
+   if( Dim() == 0 )
+   {
+      return;
+   }
+   Index n = Dim();
+   const Number* xvals = x.values_;
+   void* args[] = { &n, &values_, &alpha, &xvals, &map };
+   LaunchKernel(cuda_context.gather, n, args);
+   ObjectChanged();
+}
+
+void CudaVector::AddScattered(
+   Number            alpha,
+   const CudaVector& x,
+   const Index*      map
+)
+{
+   if( x.Dim() == 0 )
+   {
+      return;
+   }
+   Index n = x.Dim();
+   const Number* xvals = x.values_;
+   void* args[] = { &n, &values_, &alpha, &xvals, &map };
+   LaunchKernel(cuda_context.scatter, n, args);
+   ObjectChanged();
+}
+
+void CudaVector::MaxScattered(
+   Number       value,
+   Index        n,
+   const Index* map
+)
+{
+   if( n == 0 )
+   {
+      return;
+   }
+   void* args[] = { &n, &values_, &value, &map };
+   LaunchKernel(cuda_context.scatter_max, n, args);
+   ObjectChanged();
+}
+
+void CudaVector::CopyImpl(
+   const Vector& x
+)
+{
+   DBG_START_METH("CudaVector::CopyImpl(const Vector& x)", dbg_verbosity);
+   DBG_ASSERT(Dim() == x.Dim());
+   if( Dim() == 0 )
+   {
+      return;
+   }
+
+   const CudaVector* cuda_x = dynamic_cast<const CudaVector*>(&x);
+   if( cuda_x != NULL )
+   {
+      CheckCuda(cudaMemcpy(values_, cuda_x->values_, Dim() * sizeof(Number), cudaMemcpyDeviceToDevice), "cudaMemcpy");
+      return;
+   }
+
+   const DenseVector* dense_x = dynamic_cast<const DenseVector*>(&x);
+   ASSERT_EXCEPTION(dense_x != NULL, CUDA_VECTOR_ERROR, "A CudaVector can only be copied from a CudaVector or DenseVector.");
+   if( dense_x->IsHomogeneous() )
+   {
+      Map(MAP_SET, NULL, dense_x->Scalar());
+   }
+   else
+   {
+      CheckCuda(cudaMemcpy(values_, dense_x->ExpandedValues(), Dim() * sizeof(Number), cudaMemcpyHostToDevice), "cudaMemcpy");
+   }
+}
+
+void CudaVector::ScalImpl(
+   Number alpha
+)
+{
+   if( Dim() > 0 )
+   {
+      CheckCuda(cublasDscal(cuda_context.blas, (int) Dim(), &alpha, values_, 1), "cublasDscal");
+   }
+}
+
+void CudaVector::AxpyImpl(
+   Number        alpha,
+   const Vector& x
+)
+{
+   DBG_ASSERT(Dim() == x.Dim());
+   if( Dim() > 0 )
+   {
+      CheckCuda(cublasDaxpy(cuda_context.blas, (int) Dim(), &alpha, Values(x), 1, values_, 1), "cublasDaxpy");
+   }
+}
+
+Number CudaVector::DotImpl(
+   const Vector& x
+) const
+{
+   DBG_ASSERT(Dim() == x.Dim());
+   Number dot = 0.;
+   if( Dim() > 0 )
+   {
+      CheckCuda(cublasDdot(cuda_context.blas, (int) Dim(), values_, 1, Values(x), 1, &dot), "cublasDdot");
+   }
+   return dot;
+}
+
+Number CudaVector::Nrm2Impl() const
+{
+   Number nrm2 = 0.;
+   if( Dim() > 0 )
+   {
+      CheckCuda(cublasDnrm2(cuda_context.blas, (int) Dim(), values_, 1, &nrm2), "cublasDnrm2");
+   }
+   return nrm2;
+}
+
+Number CudaVector::AsumImpl() const
+{
+   Number asum = 0.;
+   if( Dim() > 0 )
+   {
+      CheckCuda(cublasDasum(cuda_context.blas, (int) Dim(), values_, 1, &asum), "cublasDasum");
+   }
+   return asum;
+}
+
+Number CudaVector::AmaxImpl() const
+{
+   if( Dim() == 0 )
+   {
+      return 0.;
+   }
+   int pos;
+   CheckCuda(cublasIdamax(cuda_context.blas, (int) Dim(), values_, 1, &pos), "cublasIdamax");
+   Number amax;
+   // cuBLAS counts positions from 1
+   CheckCuda(cudaMemcpy(&amax, values_ + (pos - 1), sizeof(Number), cudaMemcpyDeviceToHost), "cudaMemcpy");
+   return fabs(amax);
+}
+
+void CudaVector::SetImpl(
+   Number value
+)
+{
+   Map(MAP_SET, NULL, value);
+}
+
+void CudaVector::ElementWiseDivideImpl(
+   const Vector& x
+)
+{
+   Map(MAP_DIVIDE, Values(x), 0.);
+}
+
+void CudaVector::ElementWiseMultiplyImpl(
+   const Vector& x
+)
+{
+   Map(MAP_MULTIPLY, Values(x), 0.);
+}
+
+void CudaVector::ElementWiseMaxImpl(
+   const Vector& x
+)
+{
+   Map(MAP_MAX, Values(x), 0.);
+}
+
+void CudaVector::ElementWiseMinImpl(
+   const Vector& x
+)
+{
+   Map(MAP_MIN, Values(x), 0.);
+}
+
+void CudaVector::ElementWiseReciprocalImpl()
+{
+   Map(MAP_RECIPROCAL, NULL, 0.);
+}
+
+void CudaVector::ElementWiseAbsImpl()
+{
+   Map(MAP_ABS, NULL, 0.);
+}
+
+void CudaVector::ElementWiseSqrtImpl()
+{
+   Map(MAP_SQRT, NULL, 0.);
+}
+
+void CudaVector::ElementWiseSgnImpl()
+{
+   Map(MAP_SGN, NULL, 0.);
+}
+
+void CudaVector::AddScalarImpl(
+   Number scalar
+)
+{
+   Map(MAP_ADD_SCALAR, NULL, scalar);
+}
+
+Number CudaVector::MaxImpl() const
+{
+   if( Dim() == 0 )
+   {
+      return -std::numeric_limits<Number>::max();
+   }
+   return Reduce(REDUCE_MAX, NULL, 0.);
+}
+
+Number CudaVector::MinImpl() const
+{
+   if( Dim() == 0 )
+   {
+      return std::numeric_limits<Number>::max();
+   }
+   return Reduce(REDUCE_MIN, NULL, 0.);
+}
+
+Number CudaVector::SumImpl() const
+{
+   if( Dim() == 0 )
+   {
+      return 0.;
+   }
+   return Reduce(REDUCE_SUM, NULL, 0.);
+}
+
+Number CudaVector::SumLogsImpl() const
+{
+   if( Dim() == 0 )
+   {
+      return 0.;
+   }
+   return Reduce(REDUCE_SUMLOGS, NULL, 0.);
+}
+
+void CudaVector::AddTwoVectorsImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   Number        c
+)
+{
+   DBG_ASSERT(Dim() == v1.Dim());
+   DBG_ASSERT(Dim() == v2.Dim());
+   if( Dim() == 0 )
+   {
+      return;
+   }
+   Index n = Dim();
+   const Number* vals_v1 = Values(v1);
+   const Number* vals_v2 = Values(v2);
+   void* args[] = { &n, &values_, &a, &vals_v1, &b, &vals_v2, &c };
+   LaunchKernel(cuda_context.add_two, n, args);
+}
+
+Number CudaVector::FracToBoundImpl(
+   const Vector& delta,
+   Number        tau
+) const
+{
+   DBG_ASSERT(Dim() == delta.Dim());
+   DBG_ASSERT(tau >= 0.);
+   if( Dim() == 0 )
+   {
+      return 1.;
+   }
+   return Reduce(REDUCE_FRAC_TO_BOUND, Values(delta), tau);
+}
+
+void CudaVector::AddVectorQuotientImpl(
+   Number        a,
+   const Vector& z,
+   const Vector& s,
+   Number        c
+)
+{
+   DBG_ASSERT(Dim() == z.Dim());
+   DBG_ASSERT(Dim() == s.Dim());
+   if( Dim() == 0 )
+   {
+      return;
+   }
+   Index n = Dim();
+   const Number* vals_z = Values(z);
+   const Number* vals_s = Values(s);
+   void* args[] = { &n, &values_, &a, &vals_z, &vals_s, &c };
+   LaunchKernel(cuda_context.add_quotient, n, args);
+}
+
+void CudaVector::AddVectorProductImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   const Vector& w,
+   Number        c
+)
+{
+   DBG_ASSERT(Dim() == v1.Dim());
+   DBG_ASSERT(Dim() == v2.Dim());
+   DBG_ASSERT(Dim() == w.Dim());
+   if( Dim() == 0 )
+   {
+      return;
+   }
+   Index n = Dim();
+   const Number* vals_v1 = Values(v1);
+   const Number* vals_v2 = Values(v2);
+   const Number* vals_w = Values(w);
+   void* args[] = { &n, &values_, &a, &vals_v1, &b, &vals_v2, &vals_w, &c };
+   LaunchKernel(cuda_context.add_product, n, args);
+}
+
+void CudaVector::PrintImpl(
+   const Journalist&  jnlst,
+   EJournalLevel      level,
+   EJournalCategory   category,
+   const std::string& name,
+   Index              indent,
+   const std::string& prefix
+) const
+{
+   jnlst.PrintfIndented(level, category, indent,
+                        "%sCudaVector \"%s\" with %" IPOPT_INDEX_FORMAT " elements:\n", prefix.c_str(),
+                        name.c_str(), Dim());
+   if( Dim() == 0 || !jnlst.ProduceOutput(level, category) )
+   {
+      return;
+   }
+
+   std::vector<Number> values(Dim());
+   GetValues(&values[0]);
+   for( Index i = 0; i < Dim(); i++ )
+   {
+      jnlst.PrintfIndented(level, category, indent,
+                           "%s%s[%5" IPOPT_INDEX_FORMAT "]=%23.16e\n", prefix.c_str(), name.c_str(),
+                           i + 1, values[i]);
+   }
+}
+
+CudaVectorSpace::CudaVectorSpace(
+   Index dim
+)
+   : VectorSpace(dim)
+{
+   // cuBLAS counts the elements with int
+   ASSERT_EXCEPTION(dim <= INT_MAX, CUDA_VECTOR_ERROR, "The dimension of the vector exceeds the range of cuBLAS.");
+   InitializeCudaContext();
+}
+
+CudaVectorSpace::~CudaVectorSpace()
+{
+   for( size_t i = 0; i < free_storage_.size(); i++ )
+   {
+      cudaFree(free_storage_[i]);
+   }
+}
+
+Number* CudaVectorSpace::AllocateInternalStorage() const
+{
+   if( Dim() == 0 )
+   {
+      return NULL;
+   }
+   if( !free_storage_.empty() )
+   {
+      Number* values = free_storage_.back();
+      free_storage_.pop_back();
+      return values;
+   }
+   Number* values;
+   CheckCuda(cudaMalloc((void**) &values, Dim() * sizeof(Number)), "cudaMalloc");
+   return values;
+}
+
+void CudaVectorSpace::FreeInternalStorage(
+   Number* values
+) const
+{
+   if( values == NULL )
+   {
+      return;
+   }
+   if( free_storage_.size() < IPOPT_CUDAVECTORSPACE_POOL_SIZE )
+   {
+      free_storage_.push_back(values);
+   }
+   else
+   {
+      cudaFree(values);
+   }
+}
+
+} // namespace Ipopt
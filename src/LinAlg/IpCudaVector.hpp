@@ -0,0 +1,383 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPCUDAVECTOR_HPP__
+#define __IPCUDAVECTOR_HPP__
+
+#include "IpUtils.hpp"
+#include "IpVector.hpp"
+
+#include <vector>
+
+namespace Ipopt
+{
+
+/* forward declarations */
+class CudaVectorSpace;
+class DenseVector;
+
+/** @name Exceptions */
+///@{
+DECLARE_STD_EXCEPTION(CUDA_VECTOR_ERROR);
+///@}
+
+/** Vector whose elements are stored in the memory of a CUDA device.
+ *
+ *  All operations of the Vector base class are executed on the
+ *  device: the BLAS-like operations with cuBLAS, the remaining
+ *  element-wise operations and reductions with kernels that are
+ *  compiled at runtime with NVRTC when the first CudaVectorSpace is
+ *  created.  Reductions return their result to the host, so they
+ *  synchronize with the device.  All vectors that are combined in one
+ *  operation must be CudaVectors, except for Copy, which also accepts
+ *  a DenseVector.
+ *
+ *  Elements are transferred between the host and the device only by
+ *  SetValues, GetValues, copies from and to DenseVectors, and Print.
+ *
+ *  All CudaVectors use the current device of the thread that created
+ *  the first CudaVectorSpace and the default stream.  The operations
+ *  are not thread-safe.
+ *
+ *  This class is only available if Ipopt has been configured with
+ *  CUDA (IPOPT_HAS_CUDA).
+ */
+class IPOPTLIB_EXPORT CudaVector: public Vector
+{
+public:
+   /**@name Constructors / Destructors */
+   ///@{
+   /** Default Constructor */
+   CudaVector(
+      const CudaVectorSpace* owner_space
+   );
+
+   /** Destructor */
+   virtual ~CudaVector();
+   ///@}
+
+   /** @name Additional public methods not in Vector base class. */
+   ///@{
+   /** Create a new CudaVector from same VectorSpace */
+   SmartPtr<CudaVector> MakeNewCudaVector() const;
+
+   /** Set the elements from an array in host memory of length Dim() */
+   void SetValues(
+      const Number* values
+   );
+
+   /** Copy the elements to an array in host memory of length Dim() */
+   void GetValues(
+      Number* values
+   ) const;
+
+   /** Copy the elements into a DenseVector of the same dimension */
+   void CopyToDenseVector(
+      DenseVector& x
+   ) const;
+
+   /** Device pointer to the elements (non-const version).
+    *
+    *  This vector is marked as changed, so use this method only if
+    *  the elements are going to be changed, e.g., by a kernel of the
+    *  caller.
+    */
+   Number* DeviceValues()
+   {
+      ObjectChanged();
+      return values_;
+   }
+
+   /** Device pointer to the elements (const version) */
+   const Number* DeviceValues() const
+   {
+      return values_;
+   }
+
+   /** Add the elements of x at the positions of an index array.
+    *
+    *  Computes this[i] += alpha * x[map[i]] for i=0,..,Dim()-1, where
+    *  map is a device array of length Dim().
+    */
+   void AddGathered(
+      Number            alpha,
+      const CudaVector& x,
+      const Index*      map
+   );
+
+   /** Add the elements of x to the positions of an index array.
+    *
+    *  Computes this[map[i]] += alpha * x[i] for i=0,..,x.Dim()-1,
+    *  where map is a device array of length x.Dim() without duplicate
+    *  entries.
+    */
+   void AddScattered(
+      Number            alpha,
+      const CudaVector& x,
+      const Index*      map
+   );
+
+   /** Raise the elements at the positions of an index array to a value.
+    *
+    *  Computes this[map[i]] = max(this[map[i]], value) for
+    *  i=0,..,n-1, where map is a device array of length n.
+    */
+   void MaxScattered(
+      Number       value,
+      Index        n,
+      const Index* map
+   );
+   ///@}
+
+protected:
+   /** @name Overloaded methods from Vector base class */
+   ///@{
+   /** Copy the data of the vector x into this vector.
+    *
+    *  x can be a CudaVector or a DenseVector.
+    */
+   virtual void CopyImpl(
+      const Vector& x
+   );
+
+   virtual void ScalImpl(
+      Number alpha
+   );
+
+   virtual void AxpyImpl(
+      Number        alpha,
+      const Vector& x
+   );
+
+   virtual Number DotImpl(
+      const Vector& x
+   ) const;
+
+   virtual Number Nrm2Impl() const;
+
+   virtual Number AsumImpl() const;
+
+   virtual Number AmaxImpl() const;
+
+   virtual void SetImpl(
+      Number value
+   );
+
+   virtual void ElementWiseDivideImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseMultiplyImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseMaxImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseMinImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseReciprocalImpl();
+
+   virtual void ElementWiseAbsImpl();
+
+   virtual void ElementWiseSqrtImpl();
+
+   virtual void ElementWiseSgnImpl();
+
+   virtual void AddScalarImpl(
+      Number scalar
+   );
+
+   virtual Number MaxImpl() const;
+
+   virtual Number MinImpl() const;
+
+   virtual Number SumImpl() const;
+
+   virtual Number SumLogsImpl() const;
+
+   virtual void AddTwoVectorsImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      Number        c
+   );
+
+   virtual Number FracToBoundImpl(
+      const Vector& delta,
+      Number        tau
+   ) const;
+
+   virtual void AddVectorQuotientImpl(
+      Number        a,
+      const Vector& z,
+      const Vector& s,
+      Number        c
+   );
+
+   virtual void AddVectorProductImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      const Vector& w,
+      Number        c
+   );
+   ///@}
+
+   /** @name Output methods */
+   ///@{
+   /** Print the vector.
+    *
+    *  The elements are copied to the host for this.
+    */
+   virtual void PrintImpl(
+      const Journalist&  jnlst,
+      EJournalLevel      level,
+      EJournalCategory   category,
+      const std::string& name,
+      Index              indent,
+      const std::string& prefix
+   ) const;
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   CudaVector();
+
+   /** Copy Constructor */
+   CudaVector(
+      const CudaVector&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const CudaVector&
+   );
+   ///@}
+
+   /** Copy of the owner_space ptr as a CudaVectorSpace instead
+    *  of a VectorSpace
+    */
+   const CudaVectorSpace* owner_space_;
+
+   /** Device array of the elements, NULL if Dim() is 0 */
+   Number* values_;
+
+   /** Elements of another CudaVector of the same dimension */
+   static const Number* Values(
+      const Vector& x
+   );
+
+   /** Launch the map kernel for an element-wise operation with op
+    *  code op, another vector x (or NULL), and a scalar.
+    */
+   void Map(
+      int           op,
+      const Number* x,
+      Number        scalar
+   );
+
+   /** Launch the reduction kernel with op code op for this vector
+    *  and another vector d (or NULL) and return the result.
+    */
+   Number Reduce(
+      int           op,
+      const Number* d,
+      Number        tau
+   ) const;
+};
+
+/** This vectors space is the vector space for CudaVector.
+ *
+ *  It keeps the device memory of deleted vectors for reuse, since
+ *  allocations on the device are expensive and synchronize with the
+ *  device.
+ */
+class IPOPTLIB_EXPORT CudaVectorSpace: public VectorSpace
+{
+public:
+   /** @name Constructors/Destructors. */
+   ///@{
+   /** Constructor, given the dimension of the vectors.
+    *
+    *  Initializes CUDA, cuBLAS, and the kernels when it is called for
+    *  the first time; throws CUDA_VECTOR_ERROR if this fails.
+    */
+   CudaVectorSpace(
+      Index dim
+   );
+
+   /** Destructor */
+   ~CudaVectorSpace();
+   ///@}
+
+   /** Method for creating a new vector of this specific type. */
+   inline CudaVector* MakeNewCudaVector() const
+   {
+      return new CudaVector(this);
+   }
+
+   virtual Vector* MakeNew() const
+   {
+      return MakeNewCudaVector();
+   }
+
+   /**@name Methods called by CudaVector for memory management.
+    *
+    * This could allow to have sophisticated memory management in the
+    * VectorSpace.
+    */
+   ///@{
+   /** Allocate device memory for the elements of a vector */
+   Number* AllocateInternalStorage() const;
+
+   /** Deallocate device memory of the elements of a vector */
+   void FreeInternalStorage(
+      Number* values
+   ) const;
+   ///@}
+
+private:
+   /** Device arrays of deleted vectors that can be reused */
+   mutable std::vector<Number*> free_storage_;
+};
+
+/** @name Device memory for index arrays
+ *
+ *  These are used by matrices that operate on CudaVectors.
+ */
+///@{
+/** Copy an index array of length n to device memory.
+ *
+ *  Returns NULL if n is 0; throws CUDA_VECTOR_ERROR if the memory
+ *  cannot be allocated.
+ */
+IPOPTLIB_EXPORT Index* CudaCopyIndicesToDevice(
+   Index        n,
+   const Index* indices
+);
+
+/** Free an index array of CudaCopyIndicesToDevice */
+IPOPTLIB_EXPORT void CudaFreeIndices(
+   Index* indices
+);
+///@}
+
+} // namespace Ipopt
+
+#endif
@@ -10,6 +10,15 @@
 
 #include <cmath>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Maximal number of freed arrays kept by a dense matrix space for reuse. */
+#ifndef IPOPT_DENSEMATRIXSPACE_POOL_SIZE
+#define IPOPT_DENSEMATRIXSPACE_POOL_SIZE 8
+#endif
+
 namespace Ipopt
 {
 
@@ -22,7 +31,7 @@ DenseGenMatrix::DenseGenMatrix(
 )
    : Matrix(owner_space),
      owner_space_(owner_space),
-     values_(new Number[NCols() * NRows()]),
+     values_(owner_space->AllocateInternalStorage()),
      initialized_(false),
      factorization_(NONE),
      pivot_(NULL)
@@ -32,7 +41,7 @@ DenseGenMatrix::DenseGenMatrix(
 DenseGenMatrix::~DenseGenMatrix()
 {
    DBG_START_METH("DenseGenMatrix::~DenseGenMatrix()", dbg_verbosity);
-   delete[] values_;
+   owner_space_->FreeInternalStorage(values_);
    delete[] pivot_;
 }
 
@@ -125,6 +134,27 @@ void DenseGenMatrix::HighRankUpdateTranspose(
    DBG_ASSERT(NCols() == V2.NCols());
    DBG_ASSERT(beta == 0. || initialized_);
 
+   const Index nrows = V1.NRows();
+   if( NRows() > 0 && NCols() > 0 && nrows > 0 )
+   {
+      // If all columns are DenseVectors, compute V1^T*V2 with one
+      // Level-3 BLAS call instead of NRows()*NCols() dot products
+      Number* V1vals = owner_space_->Workspace(nrows * (NRows() + NCols()));
+      Number* V2vals = V1vals + nrows * NRows();
+      bool dense = V1.GetDenseValues(V1vals) && V2.GetDenseValues(V2vals);
+      if( dense )
+      {
+         IpBlasDgemm(true, false, NRows(), NCols(), nrows, alpha, V1vals, nrows, V2vals, nrows, beta, values_,
+                     NRows());
+      }
+      if( dense )
+      {
+         initialized_ = true;
+         ObjectChanged();
+         return;
+      }
+   }
+
    if( beta == 0. )
    {
       for( Index j = 0; j < NCols(); j++ )
@@ -218,7 +248,7 @@ bool DenseGenMatrix::ComputeEigenVectors(
    bool compute_eigenvectors = true;
    Number* Evals = Evalues.Values();
    Index info;
-   IpLapackDsyev(compute_eigenvectors, dim, values_, dim, Evals, info);
+   IpLapackDsyev(compute_eigenvectors, dim, values_, dim, Evals, info, owner_space_->EigenWorkspace());
 
    initialized_ = (info == 0);
    ObjectChanged();
@@ -439,7 +469,7 @@ void DenseGenMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sDenseGenMatrix \"%s\" with %d rows and %d columns:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
+                        "%sDenseGenMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " rows and %" IPOPT_INDEX_FORMAT " columns:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
 
    if( initialized_ )
    {
@@ -448,7 +478,7 @@ void DenseGenMatrix::PrintImpl(
          for( Index i = 0; i < NRows(); i++ )
          {
             jnlst.PrintfIndented(level, category, indent,
-                                 "%s%s[%5d,%5d]=%23.16e\n", prefix.c_str(), name.c_str(), i, j, values_[i + NRows() * j]);
+                                 "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e\n", prefix.c_str(), name.c_str(), i, j, values_[i + NRows() * j]);
          }
       }
    }
@@ -466,4 +496,57 @@ DenseGenMatrixSpace::DenseGenMatrixSpace(
    : MatrixSpace(nRows, nCols)
 { }
 
+DenseGenMatrixSpace::~DenseGenMatrixSpace()
+{
+   for( size_t i = 0; i < free_storage_.size(); i++ )
+   {
+      delete[] free_storage_[i];
+   }
+}
+
+Number* DenseGenMatrixSpace::AllocateInternalStorage() const
+{
+#ifdef _OPENMP
+   // the pool is not protected against concurrent access
+   if( !free_storage_.empty() && !omp_in_parallel() )
+#else
+   if( !free_storage_.empty() )
+#endif
+   {
+      Number* values = free_storage_.back();
+      free_storage_.pop_back();
+      return values;
+   }
+
+   return new Number[NRows() * NCols()];
+}
+
+void DenseGenMatrixSpace::FreeInternalStorage(
+   Number* values
+) const
+{
+#ifdef _OPENMP
+   if( free_storage_.size() < IPOPT_DENSEMATRIXSPACE_POOL_SIZE && !omp_in_parallel() )
+#else
+   if( free_storage_.size() < IPOPT_DENSEMATRIXSPACE_POOL_SIZE )
+#endif
+   {
+      free_storage_.push_back(values);
+      return;
+   }
+
+   delete[] values;
+}
+
+Number* DenseGenMatrixSpace::Workspace(
+   Index size
+) const
+{
+   if( (Index) workspace_.size() < size )
+   {
+      workspace_.resize(size);
+   }
+   return workspace_.empty() ? NULL : &workspace_[0];
+}
+
 } // namespace Ipopt
@@ -12,6 +12,8 @@
 #include "IpDenseVector.hpp"
 #include "IpDenseSymMatrix.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 
@@ -290,8 +292,7 @@ public:
    );
 
    /** Destructor */
-   ~DenseGenMatrixSpace()
-   { }
+   ~DenseGenMatrixSpace();
    ///@}
 
    /** Method for creating a new matrix of this specific type. */
@@ -305,6 +306,48 @@ public:
       return MakeNewDenseGenMatrix();
    }
 
+   /**@name Methods called by DenseGenMatrix for memory management.
+    *
+    * Since all matrices of this space have the same size, freed arrays
+    * are kept in a pool and handed out again by the next allocation.
+    * The space also keeps the workspace for LAPACK and for temporary
+    * arrays, so that repeated operations on the (often small) matrices
+    * of a space do not allocate memory.  As for DenseVectorSpace, this
+    * is not protected against concurrent access.
+    */
+   ///@{
+   /** Allocate internal storage for the DenseGenMatrix */
+   Number* AllocateInternalStorage() const;
+
+   /** Deallocate internal storage for the DenseGenMatrix */
+   void FreeInternalStorage(
+      Number* values
+   ) const;
+
+   /** Temporary array of at least the given length.
+    *
+    *  The array is valid until the next call of this method.
+    */
+   Number* Workspace(
+      Index size
+   ) const;
+
+   /** Workspace for the eigenvalue decomposition by IpLapackDsyev */
+   std::vector<Number>& EigenWorkspace() const
+   {
+      return eigen_workspace_;
+   }
+   ///@}
+
+private:
+   /** Freed arrays of length NRows()*NCols() that can be reused */
+   mutable std::vector<Number*> free_storage_;
+
+   /** Storage for Workspace() */
+   mutable std::vector<Number> workspace_;
+
+   /** Storage for EigenWorkspace() */
+   mutable std::vector<Number> eigen_workspace_;
 };
 
 inline SmartPtr<DenseGenMatrix> DenseGenMatrix::MakeNewDenseGenMatrix() const
@@ -11,6 +11,15 @@
 
 #include <cmath>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Maximal number of freed arrays kept by a dense matrix space for reuse. */
+#ifndef IPOPT_DENSEMATRIXSPACE_POOL_SIZE
+#define IPOPT_DENSEMATRIXSPACE_POOL_SIZE 8
+#endif
+
 namespace Ipopt
 {
 
@@ -23,14 +32,14 @@ DenseSymMatrix::DenseSymMatrix(
 )
    : SymMatrix(owner_space),
      owner_space_(owner_space),
-     values_(new Number[NCols() * NRows()]),
+     values_(owner_space->AllocateInternalStorage()),
      initialized_(false)
 {
 }
 
 DenseSymMatrix::~DenseSymMatrix()
 {
-   delete[] values_;
+   owner_space_->FreeInternalStorage(values_);
 }
 
 void DenseSymMatrix::MultVectorImpl(
@@ -133,6 +142,47 @@ void DenseSymMatrix::HighRankUpdateTranspose(
    DBG_ASSERT(beta == 0. || initialized_);
 
    const Index dim = Dim();
+   const Index nrows = V1.NRows();
+   if( dim > 0 && nrows > 0 )
+   {
+      // If all columns are DenseVectors, compute V1^T*V2 with one
+      // Level-3 BLAS call instead of dim*(dim+1)/2 dot products
+      // One temporary array for the values of V1, V2 (if it is not the same as V1), and V1^T*V2
+      Number* prod = owner_space_->Workspace(dim * dim + 2 * nrows * dim);
+      Number* V1vals = prod + dim * dim;
+      Number* V2vals = V1vals;
+      bool dense = V1.GetDenseValues(V1vals);
+      if( dense && &V1 != &V2 )
+      {
+         V2vals = V1vals + nrows * dim;
+         dense = V2.GetDenseValues(V2vals);
+      }
+      if( dense )
+      {
+         IpBlasDgemm(true, false, dim, dim, nrows, alpha, V1vals, nrows, V2vals, nrows, 0., prod, dim);
+         for( Index j = 0; j < dim; j++ )
+         {
+            for( Index i = j; i < dim; i++ )
+            {
+               if( beta == 0. )
+               {
+                  values_[i + j * dim] = prod[i + j * dim];
+               }
+               else
+               {
+                  values_[i + j * dim] = prod[i + j * dim] + beta * values_[i + j * dim];
+               }
+            }
+         }
+      }
+      if( dense )
+      {
+         initialized_ = true;
+         ObjectChanged();
+         return;
+      }
+   }
+
    if( beta == 0. )
    {
       for( Index j = 0; j < dim; j++ )
@@ -266,7 +316,7 @@ void DenseSymMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sDenseSymMatrix \"%s\" of dimension %d (only lower triangular part printed):\n", prefix.c_str(), name.c_str(),
+                        "%sDenseSymMatrix \"%s\" of dimension %" IPOPT_INDEX_FORMAT " (only lower triangular part printed):\n", prefix.c_str(), name.c_str(),
                         Dim());
 
    if( initialized_ )
@@ -276,7 +326,7 @@ void DenseSymMatrix::PrintImpl(
          for( Index i = j; i < NRows(); i++ )
          {
             jnlst.PrintfIndented(level, category, indent,
-                                 "%s%s[%5d,%5d]=%23.16e\n", prefix.c_str(), name.c_str(), i, j, values_[i + NRows() * j]);
+                                 "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e\n", prefix.c_str(), name.c_str(), i, j, values_[i + NRows() * j]);
          }
       }
    }
@@ -294,4 +344,57 @@ DenseSymMatrixSpace::DenseSymMatrixSpace(
 {
 }
 
+DenseSymMatrixSpace::~DenseSymMatrixSpace()
+{
+   for( size_t i = 0; i < free_storage_.size(); i++ )
+   {
+      delete[] free_storage_[i];
+   }
+}
+
+Number* DenseSymMatrixSpace::AllocateInternalStorage() const
+{
+#ifdef _OPENMP
+   // the pool is not protected against concurrent access
+   if( !free_storage_.empty() && !omp_in_parallel() )
+#else
+   if( !free_storage_.empty() )
+#endif
+   {
+      Number* values = free_storage_.back();
+      free_storage_.pop_back();
+      return values;
+   }
+
+   return new Number[Dim() * Dim()];
+}
+
+void DenseSymMatrixSpace::FreeInternalStorage(
+   Number* values
+) const
+{
+#ifdef _OPENMP
+   if( free_storage_.size() < IPOPT_DENSEMATRIXSPACE_POOL_SIZE && !omp_in_parallel() )
+#else
+   if( free_storage_.size() < IPOPT_DENSEMATRIXSPACE_POOL_SIZE )
+#endif
+   {
+      free_storage_.push_back(values);
+      return;
+   }
+
+   delete[] values;
+}
+
+Number* DenseSymMatrixSpace::Workspace(
+   Index size
+) const
+{
+   if( (Index) workspace_.size() < size )
+   {
+      workspace_.resize(size);
+   }
+   return workspace_.empty() ? NULL : &workspace_[0];
+}
+
 } // namespace Ipopt
@@ -12,6 +12,8 @@
 #include "IpMultiVectorMatrix.hpp"
 #include "IpDenseVector.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 
@@ -190,8 +192,7 @@ public:
    );
 
    /** Destructor */
-   ~DenseSymMatrixSpace()
-   { }
+   ~DenseSymMatrixSpace();
    ///@}
 
    /** Method for creating a new matrix of this specific type. */
@@ -205,6 +206,36 @@ public:
       return MakeNewDenseSymMatrix();
    }
 
+   /**@name Methods called by DenseSymMatrix for memory management.
+    *
+    * As for DenseGenMatrixSpace, freed arrays are kept in a pool, and
+    * temporary arrays are kept by the space.  This is not protected
+    * against concurrent access.
+    */
+   ///@{
+   /** Allocate internal storage for the DenseSymMatrix */
+   Number* AllocateInternalStorage() const;
+
+   /** Deallocate internal storage for the DenseSymMatrix */
+   void FreeInternalStorage(
+      Number* values
+   ) const;
+
+   /** Temporary array of at least the given length.
+    *
+    *  The array is valid until the next call of this method.
+    */
+   Number* Workspace(
+      Index size
+   ) const;
+   ///@}
+
+private:
+   /** Freed arrays of length Dim()*Dim() that can be reused */
+   mutable std::vector<Number*> free_storage_;
+
+   /** Storage for Workspace() */
+   mutable std::vector<Number> workspace_;
 };
 
 inline SmartPtr<DenseSymMatrix> DenseSymMatrix::MakeNewDenseSymMatrix() const
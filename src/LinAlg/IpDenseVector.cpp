@@ -8,9 +8,46 @@
 #include "IpBlas.hpp"
 #include "IpUtils.hpp"
 #include "IpDebug.hpp"
+#include "IpAlignedMemory.hpp"
 
 #include <cmath>
 #include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* The kernels for fraction-to-the-boundary, quotient-add, and element-wise
+ * min/max have AVX versions on x86 that are selected at runtime if the CPU
+ * supports it.  Define IPOPT_DENSEVECTOR_NO_AVX to disable them.
+ */
+#if !defined(IPOPT_DENSEVECTOR_NO_AVX) && (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define IPOPT_DENSEVECTOR_AVX
+#include <immintrin.h>
+#endif
+
+/** Vectors with at least this number of elements are processed by
+ *  several threads if Ipopt has been compiled with OpenMP support.
+ */
+#ifndef IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM
+#define IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM 50000
+#endif
+
+/** Maximal number of freed arrays kept by a DenseVectorSpace for reuse. */
+#ifndef IPOPT_DENSEVECTORSPACE_POOL_SIZE
+#define IPOPT_DENSEVECTORSPACE_POOL_SIZE 16
+#endif
+
+/** Copies of vectors with at least this number of elements share the
+ *  values array with the original vector until one of them is changed.
+ *
+ *  For shorter vectors, copying the values is cheaper than the
+ *  bookkeeping for the shared array.
+ */
+#ifndef IPOPT_DENSEVECTOR_SHARE_MIN_DIM
+#define IPOPT_DENSEVECTOR_SHARE_MIN_DIM 1000
+#endif
 
 namespace Ipopt
 {
@@ -19,6 +56,452 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+#ifdef IPOPT_DENSEVECTOR_AVX
+/** Whether the CPU (and operating system) supports AVX instructions. */
+static bool CpuHasAvx()
+{
+   static const bool has_avx = (__builtin_cpu_supports("avx") != 0);
+   return has_avx;
+}
+
+/** @name AVX versions of the kernels below.
+ *
+ *  These perform the same floating-point operations in the same order
+ *  for every element as the scalar loops (no FMA), so results agree.
+ */
+///@{
+__attribute__((target("avx")))
+static Number FracToBoundAvx(
+   Index         n,
+   const Number* x,
+   const Number* delta,
+   Number        tau
+)
+{
+   const __m256d zero = _mm256_setzero_pd();
+   const __m256d one = _mm256_set1_pd(1.);
+   const __m256d mtau = _mm256_set1_pd(-tau);
+   __m256d alphav = one;
+   Index i = 0;
+   for( ; i + 4 <= n; i += 4 )
+   {
+      __m256d d = _mm256_loadu_pd(delta + i);
+      __m256d r = _mm256_mul_pd(_mm256_div_pd(mtau, d), _mm256_loadu_pd(x + i));
+      // only entries with negative delta bound the step
+      r = _mm256_blendv_pd(one, r, _mm256_cmp_pd(d, zero, _CMP_LT_OQ));
+      alphav = _mm256_min_pd(alphav, r);
+   }
+
+   Number lanes[4];
+   _mm256_storeu_pd(lanes, alphav);
+   Number alpha = 1.;
+   for( int k = 0; k < 4; k++ )
+   {
+      alpha = Ipopt::Min(alpha, lanes[k]);
+   }
+   for( ; i < n; i++ )
+   {
+      if( delta[i] < 0. )
+      {
+         alpha = Ipopt::Min(alpha, -tau / delta[i] * x[i]);
+      }
+   }
+   return alpha;
+}
+
+__attribute__((target("avx")))
+static void AddVectorQuotientAvx(
+   Index         n,
+   Number        a,
+   const Number* z,
+   const Number* s,
+   Number        c,
+   Number*       y
+)
+{
+   const __m256d av = _mm256_set1_pd(a);
+   Index i = 0;
+   if( c == 0. )
+   {
+      for( ; i + 4 <= n; i += 4 )
+      {
+         __m256d q = _mm256_div_pd(_mm256_mul_pd(av, _mm256_loadu_pd(z + i)), _mm256_loadu_pd(s + i));
+         _mm256_storeu_pd(y + i, q);
+      }
+      for( ; i < n; i++ )
+      {
+         y[i] = a * z[i] / s[i];
+      }
+   }
+   else
+   {
+      const __m256d cv = _mm256_set1_pd(c);
+      for( ; i + 4 <= n; i += 4 )
+      {
+         __m256d q = _mm256_div_pd(_mm256_mul_pd(av, _mm256_loadu_pd(z + i)), _mm256_loadu_pd(s + i));
+         _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_mul_pd(cv, _mm256_loadu_pd(y + i)), q));
+      }
+      for( ; i < n; i++ )
+      {
+         y[i] = c * y[i] + a * z[i] / s[i];
+      }
+   }
+}
+
+__attribute__((target("avx")))
+static void ElementWiseMaxAvx(
+   Index         n,
+   Number*       y,
+   const Number* x
+)
+{
+   Index i = 0;
+   for( ; i + 4 <= n; i += 4 )
+   {
+      _mm256_storeu_pd(y + i, _mm256_max_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+   }
+   for( ; i < n; i++ )
+   {
+      y[i] = Ipopt::Max(y[i], x[i]);
+   }
+}
+
+__attribute__((target("avx")))
+static void ElementWiseMinAvx(
+   Index         n,
+   Number*       y,
+   const Number* x
+)
+{
+   Index i = 0;
+   for( ; i + 4 <= n; i += 4 )
+   {
+      _mm256_storeu_pd(y + i, _mm256_min_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+   }
+   for( ; i < n; i++ )
+   {
+      y[i] = Ipopt::Min(y[i], x[i]);
+   }
+}
+///@}
+#endif
+
+/** @name Kernels on n contiguous elements of non-homogeneous vectors. */
+///@{
+/** Fraction to the boundary for x and step delta. */
+static Number FracToBoundKernel(
+   Index         n,
+   const Number* x,
+   const Number* delta,
+   Number        tau
+)
+{
+#ifdef IPOPT_DENSEVECTOR_AVX
+   if( CpuHasAvx() )
+   {
+      return FracToBoundAvx(n, x, delta, tau);
+   }
+#endif
+   Number alpha = 1.;
+   for( Index i = 0; i < n; i++ )
+   {
+      if( delta[i] < 0. )
+      {
+         alpha = Ipopt::Min(alpha, -tau / delta[i] * x[i]);
+      }
+   }
+   return alpha;
+}
+
+/** y = a * z/s + c * y */
+static void AddVectorQuotientKernel(
+   Index         n,
+   Number        a,
+   const Number* z,
+   const Number* s,
+   Number        c,
+   Number*       y
+)
+{
+#ifdef IPOPT_DENSEVECTOR_AVX
+   if( CpuHasAvx() )
+   {
+      AddVectorQuotientAvx(n, a, z, s, c, y);
+      return;
+   }
+#endif
+   if( c == 0. )
+   {
+      for( Index i = 0; i < n; i++ )
+      {
+         y[i] = a * z[i] / s[i];
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < n; i++ )
+      {
+         y[i] = c * y[i] + a * z[i] / s[i];
+      }
+   }
+}
+
+/** y = max(y, x) */
+static void ElementWiseMaxKernel(
+   Index         n,
+   Number*       y,
+   const Number* x
+)
+{
+#ifdef IPOPT_DENSEVECTOR_AVX
+   if( CpuHasAvx() )
+   {
+      ElementWiseMaxAvx(n, y, x);
+      return;
+   }
+#endif
+   for( Index i = 0; i < n; i++ )
+   {
+      y[i] = Ipopt::Max(y[i], x[i]);
+   }
+}
+
+/** y = min(y, x) */
+static void ElementWiseMinKernel(
+   Index         n,
+   Number*       y,
+   const Number* x
+)
+{
+#ifdef IPOPT_DENSEVECTOR_AVX
+   if( CpuHasAvx() )
+   {
+      ElementWiseMinAvx(n, y, x);
+      return;
+   }
+#endif
+   for( Index i = 0; i < n; i++ )
+   {
+      y[i] = Ipopt::Min(y[i], x[i]);
+   }
+}
+///@}
+
+/** @name Reductions for the parallel kernels.
+ *
+ *  The vectors are split into nblocks contiguous blocks and the
+ *  results for the blocks are combined in a fixed order afterwards.
+ *  Hence, for a given number of threads, the result does not depend
+ *  on the scheduling of the threads and is reproducible.
+ *
+ *  The increments incx and incy are either 1, or 0 for homogeneous
+ *  vectors.
+ */
+///@{
+static Number BlockedDot(
+   Index         dim,
+   const Number* x,
+   Index         incx,
+   const Number* y,
+   Index         incy,
+   int           nblocks
+)
+{
+   std::vector<Number> partial(nblocks);
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index end = BlockStart(dim, nblocks, blk + 1);
+      Number sum = 0.;
+      for( Index i = BlockStart(dim, nblocks, blk); i < end; i++ )
+      {
+         sum += x[i * incx] * y[i * incy];
+      }
+      partial[blk] = sum;
+   }
+
+   Number retValue = 0.;
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      retValue += partial[blk];
+   }
+   return retValue;
+}
+
+/** Euclidean norm, with the same scaling as the reference DNRM2 to
+ *  avoid overflow. */
+static Number BlockedNrm2(
+   Index         dim,
+   const Number* x,
+   int           nblocks
+)
+{
+   std::vector<Number> scale(nblocks);
+   std::vector<Number> ssq(nblocks);
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index end = BlockStart(dim, nblocks, blk + 1);
+      Number sc = 0.;
+      Number sq = 1.;
+      for( Index i = BlockStart(dim, nblocks, blk); i < end; i++ )
+      {
+         if( x[i] != 0. )
+         {
+            Number absxi = fabs(x[i]);
+            if( sc < absxi )
+            {
+               sq = 1. + sq * (sc / absxi) * (sc / absxi);
+               sc = absxi;
+            }
+            else
+            {
+               sq += (absxi / sc) * (absxi / sc);
+            }
+         }
+      }
+      scale[blk] = sc;
+      ssq[blk] = sq;
+   }
+
+   Number sc = 0.;
+   Number sq = 1.;
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      if( scale[blk] == 0. )
+      {
+         continue;
+      }
+      if( sc < scale[blk] )
+      {
+         sq = ssq[blk] + sq * (sc / scale[blk]) * (sc / scale[blk]);
+         sc = scale[blk];
+      }
+      else
+      {
+         sq += ssq[blk] * (scale[blk] / sc) * (scale[blk] / sc);
+      }
+   }
+   return sc * sqrt(sq);
+}
+
+static Number BlockedAmax(
+   Index         dim,
+   const Number* x,
+   int           nblocks
+)
+{
+   std::vector<Number> partial(nblocks);
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index end = BlockStart(dim, nblocks, blk + 1);
+      Number amax = 0.;
+      for( Index i = BlockStart(dim, nblocks, blk); i < end; i++ )
+      {
+         amax = Ipopt::Max(amax, fabs(x[i]));
+      }
+      partial[blk] = amax;
+   }
+
+   Number retValue = 0.;
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      retValue = Ipopt::Max(retValue, partial[blk]);
+   }
+   return retValue;
+}
+
+/** Fraction to the boundary for vector x and step delta. */
+static Number BlockedFracToBound(
+   Index         dim,
+   const Number* x,
+   Index         incx,
+   const Number* delta,
+   Index         incdelta,
+   Number        tau,
+   int           nblocks
+)
+{
+   std::vector<Number> partial(nblocks);
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index start = BlockStart(dim, nblocks, blk);
+      Index end = BlockStart(dim, nblocks, blk + 1);
+      Number alpha = 1.;
+      if( incx == 1 && incdelta == 1 )
+      {
+         alpha = FracToBoundKernel(end - start, x + start, delta + start, tau);
+      }
+      else
+      {
+         for( Index i = start; i < end; i++ )
+         {
+            if( delta[i * incdelta] < 0. )
+            {
+               alpha = Ipopt::Min(alpha, -tau / delta[i * incdelta] * x[i * incx]);
+            }
+         }
+      }
+      partial[blk] = alpha;
+   }
+
+   Number alpha = 1.;
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      alpha = Ipopt::Min(alpha, partial[blk]);
+   }
+   return alpha;
+}
+///@}
+
+/** Values array of a DenseVector that is shared by several vectors
+ *  after a copy.
+ *
+ *  The array is returned to the vector space when the last vector
+ *  that shares it drops its reference.
+ */
+class DenseVectorSharedValues: public ReferencedObject
+{
+public:
+   DenseVectorSharedValues(
+      const DenseVectorSpace* owner_space,
+      Number*                 values
+   )
+      : owner_space_(owner_space),
+        values_(values)
+   { }
+
+   ~DenseVectorSharedValues()
+   {
+      owner_space_->FreeInternalStorage(values_);
+   }
+
+   /** Shared values array */
+   Number* Values() const
+   {
+      return values_;
+   }
+
+   /** Hand the array over to the caller, who becomes responsible for
+    *  freeing it.
+    */
+   Number* Release()
+   {
+      Number* values = values_;
+      values_ = NULL;
+      return values;
+   }
+
+private:
+   /** Space that allocated the array */
+   SmartPtr<const DenseVectorSpace> owner_space_;
+
+   /** Shared array */
+   Number* values_;
+};
+
 DenseVector::DenseVector(
    const DenseVectorSpace* owner_space
 )
@@ -36,24 +519,77 @@ DenseVector::DenseVector(
    }
 }
 
-DenseVector::~DenseVector()
+DenseVector::DenseVector(
+   const DenseVectorSpace* owner_space,
+   Number*                 values,
+   const ReferencedObject* storage_owner
+)
+   : Vector(owner_space),
+     owner_space_(owner_space),
+     values_(values),
+     storage_owner_(storage_owner),
+     expanded_values_(NULL),
+     initialized_(false),
+     homogeneous_(false)
 {
-   DBG_START_METH("DenseVector::~DenseVector()", dbg_verbosity);
-   if( values_ )
+   DBG_ASSERT(storage_owner != NULL);
+   if( Dim() == 0 )
    {
-      owner_space_->FreeInternalStorage(values_);
+      initialized_ = true;
    }
+}
+
+DenseVector::~DenseVector()
+{
+   DBG_START_METH("DenseVector::~DenseVector()", dbg_verbosity);
+   ReleaseValues();
    if( expanded_values_ )
    {
       owner_space_->FreeInternalStorage(expanded_values_);
    }
 }
 
+void DenseVector::DetachSharedValues(
+   bool keep_values
+)
+{
+   DBG_ASSERT(IsValid(shared_values_));
+   if( shared_values_->ReferenceCount() == 1 )
+   {
+      // no other vector shares the array anymore
+      values_ = shared_values_->Release();
+   }
+   else
+   {
+      values_ = owner_space_->AllocateInternalStorage();
+      if( keep_values )
+      {
+         IpBlasDcopy(Dim(), shared_values_->Values(), 1, values_, 1);
+      }
+   }
+   shared_values_ = NULL;
+}
+
+void DenseVector::ReleaseValues()
+{
+   if( IsValid(shared_values_) )
+   {
+      shared_values_ = NULL;
+      values_ = NULL;
+   }
+   else if( values_ && IsNull(storage_owner_) )
+   {
+      owner_space_->FreeInternalStorage(values_);
+      values_ = NULL;
+   }
+}
+
 void DenseVector::SetValues(
    const Number* x
 )
 {
    initialized_ = true;
+   UnshareValues(false);
    IpBlasDcopy(Dim(), x, 1, values_allocated(), 1);
    homogeneous_ = false;
    // This is not an overloaded method from
@@ -102,9 +638,33 @@ void DenseVector::CopyImpl(
    if( homogeneous_ )
    {
       scalar_ = dense_x->scalar_;
+      if( IsValid(shared_values_) )
+      {
+         ReleaseValues();
+      }
+   }
+   else if( Dim() >= IPOPT_DENSEVECTOR_SHARE_MIN_DIM && IsNull(storage_owner_) && IsNull(dense_x->storage_owner_)
+#ifdef _OPENMP
+            // sharing changes x, which might be used by other threads
+            && !omp_in_parallel()
+#endif
+          )
+   {
+      // share the values of x, they are copied when one of the vectors is changed
+      if( IsNull(dense_x->shared_values_) )
+      {
+         dense_x->shared_values_ = new DenseVectorSharedValues(dense_x->owner_space_, dense_x->values_);
+      }
+      if( GetRawPtr(shared_values_) != GetRawPtr(dense_x->shared_values_) )
+      {
+         ReleaseValues();
+         shared_values_ = dense_x->shared_values_;
+         values_ = dense_x->values_;
+      }
    }
    else
    {
+      UnshareValues(false);
       IpBlasDcopy(Dim(), dense_x->values_, 1, values_allocated(), 1);
    }
    initialized_ = true;
@@ -115,6 +675,7 @@ void DenseVector::ScalImpl(
 )
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
    if( homogeneous_ )
    {
       scalar_ *= alpha;
@@ -136,6 +697,8 @@ void DenseVector::AxpyImpl(
 
    DBG_ASSERT(dense_x->initialized_);
    DBG_ASSERT(Dim() == dense_x->Dim());
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+   UnshareValues();
    if( homogeneous_ )
    {
       if( dense_x->homogeneous_ )
@@ -146,12 +709,32 @@ void DenseVector::AxpyImpl(
       {
          homogeneous_ = false;
          Number* vals = values_allocated();
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             vals[i] = scalar_ + alpha * dense_x->values_[i];
          }
       }
    }
+   else if( nthreads > 1 )
+   {
+      const Number* values_x = dense_x->values_;
+      Index incx = 1;
+      if( dense_x->homogeneous_ )
+      {
+         if( dense_x->scalar_ == 0. )
+         {
+            return;
+         }
+         values_x = &dense_x->scalar_;
+         incx = 0;
+      }
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < Dim(); i++ )
+      {
+         values_[i] += alpha * values_x[i * incx];
+      }
+   }
    else
    {
       if( dense_x->homogeneous_ )
@@ -179,7 +762,13 @@ Number DenseVector::DotImpl(
 
    DBG_ASSERT(dense_x->initialized_);
    DBG_ASSERT(Dim() == dense_x->Dim());
-   if( homogeneous_ )
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+   if( nthreads > 1 && !(homogeneous_ && dense_x->homogeneous_) )
+   {
+      retValue = BlockedDot(Dim(), homogeneous_ ? &scalar_ : values_, homogeneous_ ? 0 : 1,
+                            dense_x->homogeneous_ ? &dense_x->scalar_ : dense_x->values_, dense_x->homogeneous_ ? 0 : 1, nthreads);
+   }
+   else if( homogeneous_ )
    {
       if( dense_x->homogeneous_ )
       {
@@ -213,6 +802,11 @@ Number DenseVector::Nrm2Impl() const
    }
    else
    {
+      const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+      if( nthreads > 1 )
+      {
+         return BlockedNrm2(Dim(), values_, nthreads);
+      }
       return IpBlasDnrm2(Dim(), values_, 1);
    }
 }
@@ -245,6 +839,11 @@ Number DenseVector::AmaxImpl() const
       }
       else
       {
+         const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+         if( nthreads > 1 )
+         {
+            return BlockedAmax(Dim(), values_, nthreads);
+         }
          return fabs(values_[IpBlasIdamax(Dim(), values_, 1) - 1]);
       }
    }
@@ -258,11 +857,7 @@ void DenseVector::SetImpl(
    homogeneous_ = true;
    scalar_ = value;
    // ToDo decide if we want this here:
-   if( values_ )
-   {
-      owner_space_->FreeInternalStorage(values_);
-      values_ = NULL;
-   }
+   ReleaseValues();
 }
 
 void DenseVector::ElementWiseDivideImpl(
@@ -270,12 +865,14 @@ void DenseVector::ElementWiseDivideImpl(
 )
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
    const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
    DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
 
    DBG_ASSERT(dense_x->initialized_);
    const Number* values_x = dense_x->values_;
    DBG_ASSERT(Dim() == dense_x->Dim());
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       if( dense_x->homogeneous_ )
@@ -286,6 +883,7 @@ void DenseVector::ElementWiseDivideImpl(
       {
          homogeneous_ = false;
          Number* vals = values_allocated();
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             vals[i] = scalar_ / values_x[i];
@@ -296,6 +894,7 @@ void DenseVector::ElementWiseDivideImpl(
    {
       if( dense_x->homogeneous_ )
       {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] /= dense_x->scalar_;
@@ -303,6 +902,7 @@ void DenseVector::ElementWiseDivideImpl(
       }
       else
       {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] /= values_x[i];
@@ -316,12 +916,14 @@ void DenseVector::ElementWiseMultiplyImpl(
 )
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
    const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
    DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
 
    DBG_ASSERT(dense_x->initialized_);
    const Number* values_x = dense_x->values_;
    DBG_ASSERT(Dim() == dense_x->Dim());
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       if( dense_x->homogeneous_ )
@@ -332,6 +934,7 @@ void DenseVector::ElementWiseMultiplyImpl(
       {
          homogeneous_ = false;
          Number* vals = values_allocated();
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             vals[i] = scalar_ * values_x[i];
@@ -344,6 +947,7 @@ void DenseVector::ElementWiseMultiplyImpl(
       {
          if( dense_x->scalar_ != 1.0 )
          {
+            IPOPT_OMP_PARALLEL_FOR(nthreads)
             for( Index i = 0; i < Dim(); i++ )
             {
                values_[i] *= dense_x->scalar_;
@@ -352,6 +956,7 @@ void DenseVector::ElementWiseMultiplyImpl(
       }
       else
       {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] *= values_x[i];
@@ -365,12 +970,14 @@ void DenseVector::ElementWiseMaxImpl(
 )
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
    const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
    DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
 
    DBG_ASSERT(dense_x->initialized_);
    const Number* values_x = dense_x->values_;
    DBG_ASSERT(Dim() == dense_x->Dim());
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       if( dense_x->homogeneous_ )
@@ -381,6 +988,7 @@ void DenseVector::ElementWiseMaxImpl(
       {
          homogeneous_ = false;
          Number* vals = values_allocated();
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             vals[i] = Ipopt::Max(scalar_, values_x[i]);
@@ -391,6 +999,7 @@ void DenseVector::ElementWiseMaxImpl(
    {
       if( dense_x->homogeneous_ )
       {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = Ipopt::Max(values_[i], dense_x->scalar_);
@@ -398,9 +1007,11 @@ void DenseVector::ElementWiseMaxImpl(
       }
       else
       {
-         for( Index i = 0; i < Dim(); i++ )
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
+         for( int blk = 0; blk < nthreads; blk++ )
          {
-            values_[i] = Ipopt::Max(values_[i], values_x[i]);
+            Index start = BlockStart(Dim(), nthreads, blk);
+            ElementWiseMaxKernel(BlockStart(Dim(), nthreads, blk + 1) - start, values_ + start, values_x + start);
          }
       }
    }
@@ -411,12 +1022,14 @@ void DenseVector::ElementWiseMinImpl(
 )
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
    const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
    DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
 
    DBG_ASSERT(dense_x->initialized_);
    const Number* values_x = dense_x->values_;
    DBG_ASSERT(Dim() == dense_x->Dim());
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       if( dense_x->homogeneous_ )
@@ -427,6 +1040,7 @@ void DenseVector::ElementWiseMinImpl(
       {
          homogeneous_ = false;
          Number* vals = values_allocated();
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             vals[i] = Ipopt::Min(scalar_, values_x[i]);
@@ -437,6 +1051,7 @@ void DenseVector::ElementWiseMinImpl(
    {
       if( dense_x->homogeneous_ )
       {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = Ipopt::Min(values_[i], dense_x->scalar_);
@@ -444,9 +1059,11 @@ void DenseVector::ElementWiseMinImpl(
       }
       else
       {
-         for( Index i = 0; i < Dim(); i++ )
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
+         for( int blk = 0; blk < nthreads; blk++ )
          {
-            values_[i] = Ipopt::Min(values_[i], values_x[i]);
+            Index start = BlockStart(Dim(), nthreads, blk);
+            ElementWiseMinKernel(BlockStart(Dim(), nthreads, blk + 1) - start, values_ + start, values_x + start);
          }
       }
    }
@@ -455,12 +1072,15 @@ void DenseVector::ElementWiseMinImpl(
 void DenseVector::ElementWiseReciprocalImpl()
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       scalar_ = 1.0 / scalar_;
    }
    else
    {
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
       for( Index i = 0; i < Dim(); i++ )
       {
          values_[i] = 1.0 / values_[i];
@@ -471,12 +1091,15 @@ void DenseVector::ElementWiseReciprocalImpl()
 void DenseVector::ElementWiseAbsImpl()
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       scalar_ = fabs(scalar_);
    }
    else
    {
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
       for( Index i = 0; i < Dim(); i++ )
       {
          values_[i] = fabs(values_[i]);
@@ -487,12 +1110,15 @@ void DenseVector::ElementWiseAbsImpl()
 void DenseVector::ElementWiseSqrtImpl()
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       scalar_ = sqrt(scalar_);
    }
    else
    {
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
       for( Index i = 0; i < Dim(); i++ )
       {
          values_[i] = sqrt(values_[i]);
@@ -505,6 +1131,7 @@ void DenseVector::AddScalarImpl(
 )
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
    if( homogeneous_ )
    {
       scalar_ += scalar;
@@ -604,6 +1231,8 @@ Number DenseVector::SumLogsImpl() const
 void DenseVector::ElementWiseSgnImpl()
 {
    DBG_ASSERT(initialized_);
+   UnshareValues();
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
    if( homogeneous_ )
    {
       if( scalar_ > 0. )
@@ -621,6 +1250,7 @@ void DenseVector::ElementWiseSgnImpl()
    }
    else
    {
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
       for( Index i = 0; i < Dim(); i++ )
       {
          if( values_[i] > 0. )
@@ -683,6 +1313,20 @@ void DenseVector::AddTwoVectorsImpl(
       }
    }
    DBG_ASSERT(c == 0. || initialized_);
+
+   // If one of the terms is zero, e.g., a component of a step that is
+   // zero, this is a copy of the other vector, which can share its values
+   if( c == 0. && a == 1. && &v1 != this && (b == 0. || (homogeneous_v2 && scalar_v2 == 0.)) )
+   {
+      CopyImpl(v1);
+      return;
+   }
+   if( c == 0. && b == 1. && &v2 != this && (a == 0. || (homogeneous_v1 && scalar_v1 == 0.)) )
+   {
+      CopyImpl(v2);
+      return;
+   }
+
    if( (c == 0. || homogeneous_) && homogeneous_v1 && homogeneous_v2 )
    {
       homogeneous_ = true;
@@ -693,8 +1337,14 @@ void DenseVector::AddTwoVectorsImpl(
       }
       scalar_ = val + a * scalar_v1 + b * scalar_v2;
       initialized_ = true;
+      if( IsValid(shared_values_) )
+      {
+         ReleaseValues();
+      }
       return;
    }
+   // the current values are not needed if they are overwritten
+   UnshareValues(c != 0. || &v1 == this || &v2 == this);
    if( c == 0. )
    {
       // make sure we have memory allocated for this vector
@@ -782,10 +1432,7 @@ void DenseVector::AddTwoVectorsImpl(
          }
          else if( b == 1. )
          {
-            for( Index i = 0; i < Dim(); i++ )
-            {
-               IpBlasDcopy(Dim(), values_v2, 1, values_, 1);
-            }
+            IpBlasDcopy(Dim(), values_v2, 1, values_, 1);
          }
          else if( b == -1. )
          {
@@ -1207,7 +1854,17 @@ Number DenseVector::FracToBoundImpl(
    Number alpha = 1.;
    Number* values_x = values_;
    Number* values_delta = dense_delta->values_;
-   if( homogeneous_ )
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+   if( nthreads > 1 && !(homogeneous_ && dense_delta->homogeneous_) )
+   {
+      if( !dense_delta->homogeneous_ || dense_delta->scalar_ < 0. )
+      {
+         alpha = BlockedFracToBound(Dim(), homogeneous_ ? &scalar_ : values_x, homogeneous_ ? 0 : 1,
+                                    dense_delta->homogeneous_ ? &dense_delta->scalar_ : values_delta, dense_delta->homogeneous_ ? 0 : 1,
+                                    tau, nthreads);
+      }
+   }
+   else if( homogeneous_ )
    {
       if( dense_delta->homogeneous_ )
       {
@@ -1241,13 +1898,7 @@ Number DenseVector::FracToBoundImpl(
       }
       else
       {
-         for( Index i = 0; i < Dim(); i++ )
-         {
-            if( values_delta[i] < 0. )
-            {
-               alpha = Ipopt::Min(alpha, -tau / values_delta[i] * values_x[i]);
-            }
-         }
+         alpha = FracToBoundKernel(Dim(), values_x, values_delta, tau);
       }
    }
 
@@ -1275,6 +1926,7 @@ void DenseVector::AddVectorQuotientImpl(
    DBG_ASSERT(c == 0. || initialized_);
    bool homogeneous_z = dense_z->homogeneous_;
    bool homogeneous_s = dense_s->homogeneous_;
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
 
    if( (c == 0. || homogeneous_) && homogeneous_z && homogeneous_s )
    {
@@ -1288,16 +1940,13 @@ void DenseVector::AddVectorQuotientImpl(
       }
       initialized_ = true;
       homogeneous_ = true;
-      if( values_ )
-      {
-         owner_space_->FreeInternalStorage(values_);
-         values_ = NULL;
-      }
+      ReleaseValues();
       return;
    }
 
    // At least one is not homogeneous
    // Make sure we have memory to store a non-homogeneous vector
+   UnshareValues(c != 0. || &z == this || &s == this);
    values_allocated();
 
    Number* values_z = dense_z->values_;
@@ -1308,6 +1957,7 @@ void DenseVector::AddVectorQuotientImpl(
       if( homogeneous_z )
       {
          // then s is not homogeneous
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = a * dense_z->scalar_ / values_s[i];
@@ -1316,6 +1966,7 @@ void DenseVector::AddVectorQuotientImpl(
       else if( homogeneous_s )
       {
          // then z is not homogeneous
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = values_z[i] * a / dense_s->scalar_;
@@ -1323,9 +1974,11 @@ void DenseVector::AddVectorQuotientImpl(
       }
       else
       {
-         for( Index i = 0; i < Dim(); i++ )
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
+         for( int blk = 0; blk < nthreads; blk++ )
          {
-            values_[i] = a * values_z[i] / values_s[i];
+            Index start = BlockStart(Dim(), nthreads, blk);
+            AddVectorQuotientKernel(BlockStart(Dim(), nthreads, blk + 1) - start, a, values_z + start, values_s + start, 0., values_ + start);
          }
       }
    }
@@ -1335,6 +1988,7 @@ void DenseVector::AddVectorQuotientImpl(
       if( homogeneous_z )
       {
          // then s is not homogeneous
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = val + a * dense_z->scalar_ / values_s[i];
@@ -1343,6 +1997,7 @@ void DenseVector::AddVectorQuotientImpl(
       else if( homogeneous_s )
       {
          // then z is not homogeneous
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = val + values_z[i] * a / dense_s->scalar_;
@@ -1350,6 +2005,7 @@ void DenseVector::AddVectorQuotientImpl(
       }
       else
       {
+         IPOPT_OMP_PARALLEL_FOR(nthreads)
          for( Index i = 0; i < Dim(); i++ )
          {
             values_[i] = val + a * values_z[i] / values_s[i];
@@ -1363,6 +2019,7 @@ void DenseVector::AddVectorQuotientImpl(
       {
          if( homogeneous_s )
          {
+            IPOPT_OMP_PARALLEL_FOR(nthreads)
             for( Index i = 0; i < Dim(); i++ )
             {
                values_[i] = c * values_[i] + a * dense_z->scalar_ / dense_s->scalar_;
@@ -1370,6 +2027,7 @@ void DenseVector::AddVectorQuotientImpl(
          }
          else
          {
+            IPOPT_OMP_PARALLEL_FOR(nthreads)
             for( Index i = 0; i < Dim(); i++ )
             {
                values_[i] = c * values_[i] + a * dense_z->scalar_ / values_s[i];
@@ -1380,6 +2038,7 @@ void DenseVector::AddVectorQuotientImpl(
       {
          if( homogeneous_s )
          {
+            IPOPT_OMP_PARALLEL_FOR(nthreads)
             for( Index i = 0; i < Dim(); i++ )
             {
                values_[i] = c * values_[i] + values_z[i] * a / dense_s->scalar_;
@@ -1387,9 +2046,11 @@ void DenseVector::AddVectorQuotientImpl(
          }
          else
          {
-            for( Index i = 0; i < Dim(); i++ )
+            IPOPT_OMP_PARALLEL_FOR(nthreads)
+            for( int blk = 0; blk < nthreads; blk++ )
             {
-               values_[i] = c * values_[i] + a * values_z[i] / values_s[i];
+               Index start = BlockStart(Dim(), nthreads, blk);
+               AddVectorQuotientKernel(BlockStart(Dim(), nthreads, blk + 1) - start, a, values_z + start, values_s + start, c, values_ + start);
             }
          }
       }
@@ -1399,6 +2060,142 @@ void DenseVector::AddVectorQuotientImpl(
    homogeneous_ = false;
 }
 
+void DenseVector::AddVectorProductImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   const Vector& w,
+   Number        c
+)
+{
+   DBG_ASSERT(Dim() == v1.Dim());
+   DBG_ASSERT(Dim() == v2.Dim());
+   DBG_ASSERT(Dim() == w.Dim());
+   const DenseVector* dense_v1 = static_cast<const DenseVector*>(&v1);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&v1));
+   const DenseVector* dense_v2 = static_cast<const DenseVector*>(&v2);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&v2));
+   const DenseVector* dense_w = static_cast<const DenseVector*>(&w);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&w));
+
+   DBG_ASSERT(a == 0. || dense_v1->initialized_);
+   DBG_ASSERT(b == 0. || (dense_v2->initialized_ && dense_w->initialized_));
+   DBG_ASSERT(c == 0. || initialized_);
+
+   // Terms with zero factor are treated as homogeneous zero vectors, so
+   // that their (possibly uninitialized) values are not touched
+   const Number zero = 0.;
+   bool homogeneous_v1 = (a == 0. || dense_v1->homogeneous_);
+   bool homogeneous_v2 = (b == 0. || dense_v2->homogeneous_);
+   bool homogeneous_w = (b == 0. || dense_w->homogeneous_);
+
+   if( (c == 0. || homogeneous_) && homogeneous_v1 && homogeneous_v2 && homogeneous_w )
+   {
+      Number val = 0.;
+      if( a != 0. )
+      {
+         val += a * dense_v1->scalar_;
+      }
+      if( b != 0. )
+      {
+         val += b * dense_v2->scalar_ * dense_w->scalar_;
+      }
+      if( c != 0. )
+      {
+         val += c * scalar_;
+      }
+      scalar_ = val;
+      initialized_ = true;
+      homogeneous_ = true;
+      ReleaseValues();
+      return;
+   }
+
+   // Homogeneous vectors are accessed with increment 0
+   const Number* values_v1 = a == 0. ? &zero : (homogeneous_v1 ? &dense_v1->scalar_ : dense_v1->values_);
+   const Number* values_v2 = b == 0. ? &zero : (homogeneous_v2 ? &dense_v2->scalar_ : dense_v2->values_);
+   const Number* values_w = b == 0. ? &zero : (homogeneous_w ? &dense_w->scalar_ : dense_w->values_);
+   Index inc_v1 = homogeneous_v1 ? 0 : 1;
+   Index inc_v2 = homogeneous_v2 ? 0 : 1;
+   Index inc_w = homogeneous_w ? 0 : 1;
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+   UnshareValues(c != 0. || &v1 == this || &v2 == this || &w == this);
+
+   if( c == 0. || homogeneous_ )
+   {
+      Number val = (c == 0.) ? 0. : c * scalar_;
+      Number* vals = values_allocated();
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < Dim(); i++ )
+      {
+         vals[i] = val + a * values_v1[i * inc_v1] + b * values_v2[i * inc_v2] * values_w[i * inc_w];
+      }
+   }
+   else
+   {
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < Dim(); i++ )
+      {
+         values_[i] = c * values_[i] + a * values_v1[i * inc_v1] + b * values_v2[i * inc_v2] * values_w[i * inc_w];
+      }
+   }
+
+   initialized_ = true;
+   homogeneous_ = false;
+}
+
+Number DenseVector::AxpyDotImpl(
+   Number        alpha,
+   const Vector& x,
+   const Vector& z
+)
+{
+   DBG_ASSERT(Dim() == x.Dim());
+   DBG_ASSERT(Dim() == z.Dim());
+   const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
+   const DenseVector* dense_z = static_cast<const DenseVector*>(&z);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&z));
+   DBG_ASSERT(initialized_);
+   DBG_ASSERT(dense_x->initialized_);
+   DBG_ASSERT(dense_z->initialized_);
+
+   if( homogeneous_ || dense_x->homogeneous_ || dense_z->homogeneous_ || &z == this )
+   {
+      // nothing to gain from fusing the two operations here
+      AxpyImpl(alpha, x);
+      return DotImpl(z);
+   }
+
+   // The inner product is accumulated per block and the block sums are
+   // added in a fixed order, see BlockedDot
+   const int nblocks = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+   UnshareValues();
+   const Number* values_x = dense_x->values_;
+   const Number* values_z = dense_z->values_;
+   std::vector<Number> partial(nblocks);
+   IPOPT_OMP_PARALLEL_FOR(nblocks)
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      Index end = BlockStart(Dim(), nblocks, blk + 1);
+      Number sum = 0.;
+      for( Index i = BlockStart(Dim(), nblocks, blk); i < end; i++ )
+      {
+         values_[i] += alpha * values_x[i];
+         sum += values_[i] * values_z[i];
+      }
+      partial[blk] = sum;
+   }
+
+   Number retValue = 0.;
+   for( int blk = 0; blk < nblocks; blk++ )
+   {
+      retValue += partial[blk];
+   }
+   return retValue;
+}
+
 void DenseVector::CopyToPos(
    Index         Pos,
    const Vector& x
@@ -1456,7 +2253,7 @@ void DenseVector::PrintImplOffset(
 ) const
 {
    jnlst.PrintfIndented(level, category, indent,
-                        "%sDenseVector \"%s\" with %d elements:\n", prefix.c_str(),
+                        "%sDenseVector \"%s\" with %" IPOPT_INDEX_FORMAT " elements:\n", prefix.c_str(),
                         name.c_str(), Dim());
 
    if( initialized_ )
@@ -1475,7 +2272,7 @@ void DenseVector::PrintImplOffset(
             for( Index i = 0; i < Dim(); i++ )
             {
                jnlst.PrintfIndented(level, category, indent,
-                                    "%s%s[%5d]{%s}=%23.16e\n", prefix.c_str(), name.c_str(),
+                                    "%s%s[%5" IPOPT_INDEX_FORMAT "]{%s}=%23.16e\n", prefix.c_str(), name.c_str(),
                                     i + offset, idx_names[i].c_str(), values_[i]);
             }
          }
@@ -1484,7 +2281,7 @@ void DenseVector::PrintImplOffset(
             for( Index i = 0; i < Dim(); i++ )
             {
                jnlst.PrintfIndented(level, category, indent,
-                                    "%s%s[%5d]=%23.16e\n", prefix.c_str(), name.c_str(),
+                                    "%s%s[%5" IPOPT_INDEX_FORMAT "]=%23.16e\n", prefix.c_str(), name.c_str(),
                                     i + offset, values_[i]);
             }
          }
@@ -1497,4 +2294,72 @@ void DenseVector::PrintImplOffset(
    }
 }
 
+DenseVectorSpace::~DenseVectorSpace()
+{
+   for( size_t i = 0; i < free_storage_.size(); i++ )
+   {
+      FreeAlignedNumbers(free_storage_[i]);
+   }
+   memory_account_.Free(free_storage_.size() * Dim() * sizeof(Number));
+}
+
+Number* DenseVectorSpace::AllocateInternalStorage() const
+{
+   if( Dim() == 0 )
+   {
+      return NULL;
+   }
+
+#ifdef _OPENMP
+   // the pool is not protected against concurrent access
+   if( !free_storage_.empty() && !omp_in_parallel() )
+#else
+   if( !free_storage_.empty() )
+#endif
+   {
+      Number* values = free_storage_.back();
+      free_storage_.pop_back();
+      return values;
+   }
+
+   memory_account_.Allocate(Dim() * sizeof(Number));
+   Number* values = AllocateAlignedNumbers(Dim(), use_huge_pages_);
+
+   // Touch the pages first by the threads of the kernels, so that they
+   // are placed on the NUMA nodes of the threads that work on them
+   const int nthreads = ParallelLoopThreads(Dim(), IPOPT_DENSEVECTOR_PARALLEL_MIN_DIM);
+   if( nthreads > 1 )
+   {
+      IPOPT_OMP_PARALLEL_FOR(nthreads)
+      for( Index i = 0; i < Dim(); i++ )
+      {
+         values[i] = 0.;
+      }
+   }
+   return values;
+}
+
+void DenseVectorSpace::FreeInternalStorage(
+   Number* values
+) const
+{
+   if( values == NULL )
+   {
+      return;
+   }
+
+#ifdef _OPENMP
+   if( free_storage_.size() < IPOPT_DENSEVECTORSPACE_POOL_SIZE && !omp_in_parallel() )
+#else
+   if( free_storage_.size() < IPOPT_DENSEVECTORSPACE_POOL_SIZE )
+#endif
+   {
+      free_storage_.push_back(values);
+      return;
+   }
+
+   FreeAlignedNumbers(values);
+   memory_account_.Free(Dim() * sizeof(Number));
+}
+
 } // namespace Ipopt
@@ -9,13 +9,16 @@
 
 #include "IpUtils.hpp"
 #include "IpVector.hpp"
+#include "IpMemoryStatistics.hpp"
 #include <map>
+#include <vector>
 
 namespace Ipopt
 {
 
 /* forward declarations */
 class DenseVectorSpace;
+class DenseVectorSharedValues;
 
 /** @name Exceptions */
 ///@{
@@ -36,6 +39,12 @@ DECLARE_STD_EXCEPTION(METADATA_ERROR);
  *  of a non-homogeneous vector, use the SetValues method, or use
  *  the non-const Values method to get an array that you can
  *  overwrite.  In the latter case, storage is ensured.
+ *
+ *  A copy of a non-homogeneous vector (e.g., by MakeNewCopy) shares
+ *  the values array with the original vector, and the array is only
+ *  copied when one of the vectors is changed.  Therefore, a pointer
+ *  obtained by the non-const Values method must not be used for
+ *  writing anymore after the vector has been copied.
  */
 class IPOPTLIB_EXPORT DenseVector: public Vector
 {
@@ -48,6 +57,21 @@ public:
       const DenseVectorSpace* owner_space
    );
 
+   /** Constructor for a vector that stores its elements in an array
+    *  that is owned by another object.
+    *
+    *  The array values must have length owner_space->Dim() and is
+    *  not freed by this vector.  The vector keeps a reference to
+    *  storage_owner, which must ensure that the array is valid as long
+    *  as storage_owner exists.  This is used by CompoundVector to
+    *  store all components in one array.
+    */
+   DenseVector(
+      const DenseVectorSpace* owner_space,
+      Number*                 values,
+      const ReferencedObject* storage_owner
+   );
+
    /** Destructor
     */
    virtual ~DenseVector();
@@ -230,6 +254,21 @@ protected:
       const Vector& s,
       Number        c
    );
+
+   void AddVectorProductImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      const Vector& w,
+      Number        c
+   );
+
+   Number AxpyDotImpl(
+      Number        alpha,
+      const Vector& x,
+      const Vector& z
+   );
    ///@}
 
    /** @name Output methods */
@@ -259,6 +298,7 @@ protected:
    ///@}
 
    friend class ParVector;
+   friend class CompoundVector;
 
 private:
    /**@name Default Compiler Generated Methods
@@ -289,12 +329,50 @@ private:
    /** Dense Number array of vector values. */
    Number* values_;
 
+   /** Object that owns values_ if the array was not allocated by the
+    *  owner space; NULL otherwise.
+    */
+   SmartPtr<const ReferencedObject> storage_owner_;
+
+   /** Values array that is shared with other DenseVectors after a
+    *  copy; NULL if values_ is not shared.
+    *
+    *  If this is not NULL, values_ points to the array of this object
+    *  and is not owned by this vector.  The array is copied before this
+    *  vector is changed as long as another vector still shares it.
+    */
+   mutable SmartPtr<DenseVectorSharedValues> shared_values_;
+
    /** Dense Number array pointer that is used for ExpandedValues */
    mutable Number* expanded_values_;
 
-   /** Get the internal values array, making sure that memory has been allocated. */
+   /** Get the internal values array, making sure that memory has been
+    *  allocated and is not shared with another vector.
+    */
    inline Number* values_allocated();
 
+   /** Make sure that values_ is not shared with another vector before
+    *  it is changed.
+    *
+    *  If keep_values is false, the current values are about to be
+    *  overwritten and are not copied.
+    */
+   inline void UnshareValues(
+      bool keep_values = true
+   );
+
+   /** Implementation of UnshareValues for a shared values array */
+   void DetachSharedValues(
+      bool keep_values
+   );
+
+   /** Free values_ if it is owned by this vector, or drop the reference
+    *  to the shared values array.
+    *
+    *  Values that are owned by storage_owner_ are kept.
+    */
+   void ReleaseValues();
+
    /** Flag for Initialization.
     *
     * This flag is false, if the data has not yet been initialized.
@@ -331,16 +409,22 @@ class IPOPTLIB_EXPORT DenseVectorSpace: public VectorSpace
 public:
    /** @name Constructors/Destructors. */
    ///@{
-   /** Constructor, requires dimension of all vector for this VectorSpace */
+   /** Constructor, requires dimension of all vector for this VectorSpace
+    *
+    *  If use_huge_pages is true, transparent huge pages are requested
+    *  for the values of large vectors (see AllocateAlignedNumbers).
+    */
    DenseVectorSpace(
-      Index dim
+      Index dim,
+      bool  use_huge_pages = false
    )
-      : VectorSpace(dim)
+      : VectorSpace(dim),
+        use_huge_pages_(use_huge_pages),
+        memory_account_(MemoryStatistics::VECTOR_VALUES)
    { }
 
    /** Destructor */
-   ~DenseVectorSpace()
-   { }
+   ~DenseVectorSpace();
    ///@}
 
    /** Method for creating a new vector of this specific type. */
@@ -349,22 +433,41 @@ public:
       return new DenseVector(this);
    }
 
+   /** Method for creating a new vector of this specific type that
+    *  stores its elements in the given array.
+    *
+    *  See the corresponding constructor of DenseVector.
+    */
+   inline DenseVector* MakeNewDenseVector(
+      Number*                 values,
+      const ReferencedObject* storage_owner
+   ) const
+   {
+      return new DenseVector(this, values, storage_owner);
+   }
+
    virtual Vector* MakeNew() const
    {
       return MakeNewDenseVector();
    }
 
+   /** Whether huge pages are requested for the values of the vectors of this space */
+   bool UseHugePages() const
+   {
+      return use_huge_pages_;
+   }
+
    /**@name Methods called by DenseVector for memory management.
     *
-    * This could allow to have sophisticated memory management in the
-    * VectorSpace.
+    * Since all vectors of this space have the same length, freed arrays
+    * are kept in a pool and handed out again by the next allocation.
     */
    ///@{
    /** Allocate internal storage for the DenseVector */
-   inline Number* AllocateInternalStorage() const;
+   Number* AllocateInternalStorage() const;
 
    /** Deallocate internal storage for the DenseVector */
-   inline void FreeInternalStorage(
+   void FreeInternalStorage(
       Number* values
    ) const;
    ///@}
@@ -438,6 +541,15 @@ private:
    StringMetaDataMapType string_meta_data_;
    IntegerMetaDataMapType integer_meta_data_;
    NumericMetaDataMapType numeric_meta_data_;
+
+   /** Freed arrays of length Dim() that can be reused */
+   mutable std::vector<Number*> free_storage_;
+
+   /** Whether huge pages are requested for the values */
+   const bool use_huge_pages_;
+
+   /** Memory of the values of the vectors of this space */
+   MemoryAccount memory_account_;
 };
 
 // inline functions
@@ -465,33 +577,24 @@ inline const Number* DenseVector::Values() const
    return values_;
 }
 
-inline Number* DenseVector::values_allocated()
+inline void DenseVector::UnshareValues(
+   bool keep_values
+)
 {
-   if( values_ == NULL )
+   if( IsValid(shared_values_) )
    {
-      values_ = owner_space_->AllocateInternalStorage();
+      DetachSharedValues(keep_values);
    }
-   return values_;
 }
 
-inline Number* DenseVectorSpace::AllocateInternalStorage() const
+inline Number* DenseVector::values_allocated()
 {
-   if( Dim() > 0 )
-   {
-      return new Number[Dim()];
-   }
-   else
+   UnshareValues();
+   if( values_ == NULL )
    {
-      return NULL;
+      values_ = owner_space_->AllocateInternalStorage();
    }
-}
-
-inline
-void DenseVectorSpace::FreeInternalStorage(
-   Number* values
-) const
-{
-   delete[] values;
+   return values_;
 }
 
 inline SmartPtr<DenseVector> DenseVector::MakeNewDenseVector() const
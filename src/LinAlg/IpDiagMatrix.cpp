@@ -30,20 +30,9 @@ void DiagMatrix::MultVectorImpl(
    DBG_ASSERT(Dim() == y.Dim());
    DBG_ASSERT(IsValid(diag_));
 
-   // Take care of the y part of the addition
-   if( beta != 0.0 )
-   {
-      y.Scal(beta);
-   }
-   else
-   {
-      y.Set(0.0);  // In case y hasn't been initialized yet
-   }
-
-   SmartPtr<Vector> tmp_vec = y.MakeNew();
-   tmp_vec->Copy(x);
-   tmp_vec->ElementWiseMultiply(*diag_);
-   y.Axpy(alpha, *tmp_vec);
+   // y = alpha * x .* diag + beta * y; a homogeneous diagonal or x is
+   // not expanded, and y is not read if beta is zero
+   y.AddVectorProduct(0., x, alpha, x, *diag_, beta);
 }
 
 bool DiagMatrix::HasValidNumbersImpl() const
@@ -83,7 +72,7 @@ void DiagMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sDiagMatrix \"%s\" with %d rows and columns, and with diagonal elements:\n", prefix.c_str(), name.c_str(),
+                        "%sDiagMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " rows and columns, and with diagonal elements:\n", prefix.c_str(), name.c_str(),
                         Dim());
    if( IsValid(diag_) )
    {
@@ -32,12 +32,17 @@ public:
    ~DiagMatrix();
    ///@}
 
-   /** Set the diagonal elements (as a Vector). */
+   /** Set the diagonal elements (as a Vector).
+    *
+    *  The matrix is marked as changed, so that the tag of a DiagMatrix
+    *  that is reused with a new diagonal differs from the previous one.
+    */
    void SetDiag(
       const Vector& diag
    )
    {
       diag_ = &diag;
+      ObjectChanged();
    }
 
    /** Get the diagonal elements. */
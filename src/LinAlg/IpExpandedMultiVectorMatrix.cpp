@@ -204,7 +204,7 @@ void ExpandedMultiVectorMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sExpandedMultiVectorMatrix \"%s\" with %d columns:\n", prefix.c_str(), name.c_str(), NRows());
+                        "%sExpandedMultiVectorMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " columns:\n", prefix.c_str(), name.c_str(), NRows());
 
    for( Index i = 0; i < NRows(); i++ )
    {
@@ -212,14 +212,14 @@ void ExpandedMultiVectorMatrix::PrintImpl(
       {
          DBG_ASSERT(name.size() < 200);
          char buffer[256];
-         Snprintf(buffer, 255, "%s[%2d]", name.c_str(), i);
+         Snprintf(buffer, 255, "%s[%2" IPOPT_INDEX_FORMAT "]", name.c_str(), i);
          std::string term_name = buffer;
          vecs_[i]->Print(&jnlst, level, category, term_name, indent + 1, prefix);
       }
       else
       {
          jnlst.PrintfIndented(level, category, indent,
-                              "%sVector in column %d is not yet set!\n", prefix.c_str(), i);
+                              "%sVector in column %" IPOPT_INDEX_FORMAT " is not yet set!\n", prefix.c_str(), i);
       }
    }
    SmartPtr<const ExpansionMatrix> P = GetExpansionMatrix();
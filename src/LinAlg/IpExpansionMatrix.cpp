@@ -7,6 +7,14 @@
 #include "IpExpansionMatrix.hpp"
 #include "IpDenseVector.hpp"
 
+/** The operations of an ExpansionMatrix loop over the contiguous runs of
+ *  its mapping instead of the individual elements if the runs have at
+ *  least this length on average.
+ */
+#ifndef IPOPT_EXPANSION_MIN_AVG_RUN_LENGTH
+#define IPOPT_EXPANSION_MIN_AVG_RUN_LENGTH 4
+#endif
+
 namespace Ipopt
 {
 
@@ -14,6 +22,50 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Compute y[i] += alpha*x[i] for i=0,..,n-1 */
+static inline void AddContiguous(
+   Index         n,
+   Number        alpha,
+   const Number* x,
+   Number*       y
+)
+{
+   if( alpha == 1. )
+   {
+      for( Index i = 0; i < n; i++ )
+      {
+         y[i] += x[i];
+      }
+   }
+   else if( alpha == -1. )
+   {
+      for( Index i = 0; i < n; i++ )
+      {
+         y[i] -= x[i];
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < n; i++ )
+      {
+         y[i] += alpha * x[i];
+      }
+   }
+}
+
+/** Compute y[i] += val for i=0,..,n-1 */
+static inline void AddScalarContiguous(
+   Index   n,
+   Number  val,
+   Number* y
+)
+{
+   for( Index i = 0; i < n; i++ )
+   {
+      y[i] += val;
+   }
+}
+
 ExpansionMatrix::ExpansionMatrix(
    const ExpansionMatrixSpace* owner_space
 )
@@ -56,7 +108,31 @@ void ExpansionMatrix::MultVectorImpl(
    if( dense_x && dense_y )
    {
       Number* yvals = dense_y->Values();
-      if( dense_x->IsHomogeneous() )
+      if( UseRuns() )
+      {
+         const Index* run_starts = RunStarts();
+         const Index* run_pos = RunPositions();
+         if( dense_x->IsHomogeneous() )
+         {
+            Number val = alpha * dense_x->Scalar();
+            if( val != 0. )
+            {
+               for( Index k = 0; k < NumRuns(); k++ )
+               {
+                  AddScalarContiguous(run_starts[k + 1] - run_starts[k], val, yvals + run_pos[k]);
+               }
+            }
+         }
+         else
+         {
+            const Number* xvals = dense_x->Values();
+            for( Index k = 0; k < NumRuns(); k++ )
+            {
+               AddContiguous(run_starts[k + 1] - run_starts[k], alpha, xvals + run_starts[k], yvals + run_pos[k]);
+            }
+         }
+      }
+      else if( dense_x->IsHomogeneous() )
       {
          Number val = alpha * dense_x->Scalar();
          if( val != 0. )
@@ -138,6 +214,16 @@ void ExpansionMatrix::TransMultVectorImpl(
             }
          }
       }
+      else if( UseRuns() )
+      {
+         const Number* xvals = dense_x->Values();
+         const Index* run_starts = RunStarts();
+         const Index* run_pos = RunPositions();
+         for( Index k = 0; k < NumRuns(); k++ )
+         {
+            AddContiguous(run_starts[k + 1] - run_starts[k], alpha, xvals + run_pos[k], yvals + run_starts[k]);
+         }
+      }
       else
       {
          const Number* xvals = dense_x->Values();
@@ -200,7 +286,40 @@ void ExpansionMatrix::AddMSinvZImpl(
    const Number* vals_S = dense_S->Values();
    Number* vals_X = dense_X->Values();
 
-   if( dense_Z->IsHomogeneous() )
+   if( UseRuns() && !dense_Z->IsHomogeneous() )
+   {
+      // shift X for each run, so that its elements can be accessed with
+      // the indices of the small vectors
+      const Number* vals_Z = dense_Z->Values();
+      const Index* run_starts = RunStarts();
+      const Index* run_pos = RunPositions();
+      for( Index k = 0; k < NumRuns(); k++ )
+      {
+         Number* X_k = vals_X + (run_pos[k] - run_starts[k]);
+         if( alpha == 1. )
+         {
+            for( Index i = run_starts[k]; i < run_starts[k + 1]; i++ )
+            {
+               X_k[i] += vals_Z[i] / vals_S[i];
+            }
+         }
+         else if( alpha == -1. )
+         {
+            for( Index i = run_starts[k]; i < run_starts[k + 1]; i++ )
+            {
+               X_k[i] -= vals_Z[i] / vals_S[i];
+            }
+         }
+         else
+         {
+            for( Index i = run_starts[k]; i < run_starts[k + 1]; i++ )
+            {
+               X_k[i] += alpha * vals_Z[i] / vals_S[i];
+            }
+         }
+      }
+   }
+   else if( dense_Z->IsHomogeneous() )
    {
       Number val = alpha * dense_Z->Scalar();
       if( val != 0. )
@@ -421,14 +540,14 @@ void ExpansionMatrix::PrintImplOffset(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sExpansionMatrix \"%s\" with %d rows and %d columns:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
+                        "%sExpansionMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " rows and %" IPOPT_INDEX_FORMAT " columns:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
 
    const Index* exp_pos = ExpandedPosIndices();
 
    for( Index i = 0; i < NCols(); i++ )
    {
       jnlst.PrintfIndented(level, category, indent,
-                           "%s%s[%5d,%5d]=%23.16e  (%d)\n", prefix.c_str(), name.c_str(), exp_pos[i] + row_offset, i + col_offset, 1., i);
+                           "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e  (%" IPOPT_INDEX_FORMAT ")\n", prefix.c_str(), name.c_str(), exp_pos[i] + row_offset, i + col_offset, 1., i);
    }
 }
 
@@ -440,7 +559,11 @@ ExpansionMatrixSpace::ExpansionMatrixSpace(
 )
    : MatrixSpace(NLargeVec, NSmallVec),
      expanded_pos_(NULL),
-     compressed_pos_(NULL)
+     compressed_pos_(NULL),
+     num_runs_(0),
+     run_starts_(NULL),
+     run_positions_(NULL),
+     use_runs_(false)
 {
    if( NCols() > 0 )
    {
@@ -461,6 +584,32 @@ ExpansionMatrixSpace::ExpansionMatrixSpace(
       expanded_pos_[i] = ExpPos[i] - offset;
       compressed_pos_[ExpPos[i] - offset] = i;
    }
+
+   // determine the contiguous runs of the mapping
+   for( Index i = 0; i < NCols(); i++ )
+   {
+      if( i == 0 || expanded_pos_[i] != expanded_pos_[i - 1] + 1 )
+      {
+         num_runs_++;
+      }
+   }
+   run_starts_ = new Index[num_runs_ + 1];
+   if( num_runs_ > 0 )
+   {
+      run_positions_ = new Index[num_runs_];
+   }
+   Index k = 0;
+   for( Index i = 0; i < NCols(); i++ )
+   {
+      if( i == 0 || expanded_pos_[i] != expanded_pos_[i - 1] + 1 )
+      {
+         run_starts_[k] = i;
+         run_positions_[k] = expanded_pos_[i];
+         k++;
+      }
+   }
+   run_starts_[num_runs_] = NCols();
+   use_runs_ = num_runs_ > 0 && NCols() >= IPOPT_EXPANSION_MIN_AVG_RUN_LENGTH * num_runs_;
 }
 
 } // namespace Ipopt
@@ -60,6 +60,19 @@ public:
     */
    const Index* CompressedPosIndices() const;
 
+   /** @name Contiguous runs of the mapping
+    *
+    *  A run is a maximal sequence of consecutive elements of the small
+    *  vector that are mapped to consecutive positions of the large
+    *  vector.  See ExpansionMatrixSpace.
+    */
+   ///@{
+   Index NumRuns() const;
+   const Index* RunStarts() const;
+   const Index* RunPositions() const;
+   bool UseRuns() const;
+   ///@}
+
 protected:
    /**@name Overloaded methods from Matrix base class*/
    ///@{
@@ -184,6 +197,8 @@ public:
    {
       delete[] compressed_pos_;
       delete[] expanded_pos_;
+      delete[] run_starts_;
+      delete[] run_positions_;
    }
    ///@}
 
@@ -225,9 +240,58 @@ public:
       return compressed_pos_;
    }
 
+   /** Number of runs, i.e., maximal sequences of consecutive elements
+    *  of the small vector that are mapped to consecutive positions of
+    *  the large vector.
+    *
+    *  This is 1 if the mapping is a contiguous range, e.g., the
+    *  identity.
+    */
+   Index NumRuns() const
+   {
+      return num_runs_;
+   }
+
+   /** Accessor Method to obtain the Index array (of length
+    *  NumRuns()+1) with the first element of each run in the small
+    *  vector.
+    *
+    *  The last entry is NSmallVec, so that run k consists of the
+    *  elements RunStarts()[k],..,RunStarts()[k+1]-1.
+    */
+   const Index* RunStarts() const
+   {
+      return run_starts_;
+   }
+
+   /** Accessor Method to obtain the Index array (of length NumRuns())
+    *  with the position in the large vector of the first element of
+    *  each run.
+    */
+   const Index* RunPositions() const
+   {
+      return run_positions_;
+   }
+
+   /** Whether the runs are long enough on average so that operations
+    *  should loop over the runs instead of the individual elements.
+    */
+   bool UseRuns() const
+   {
+      return use_runs_;
+   }
+
 private:
    Index* expanded_pos_;
    Index* compressed_pos_;
+
+   /** @name Contiguous runs of the mapping */
+   ///@{
+   Index num_runs_;
+   Index* run_starts_;
+   Index* run_positions_;
+   bool use_runs_;
+   ///@}
 };
 
 /* inline methods */
@@ -241,5 +305,25 @@ inline const Index* ExpansionMatrix::CompressedPosIndices() const
    return owner_space_->CompressedPosIndices();
 }
 
+inline Index ExpansionMatrix::NumRuns() const
+{
+   return owner_space_->NumRuns();
+}
+
+inline const Index* ExpansionMatrix::RunStarts() const
+{
+   return owner_space_->RunStarts();
+}
+
+inline const Index* ExpansionMatrix::RunPositions() const
+{
+   return owner_space_->RunPositions();
+}
+
+inline bool ExpansionMatrix::UseRuns() const
+{
+   return owner_space_->UseRuns();
+}
+
 } // namespace Ipopt
 #endif
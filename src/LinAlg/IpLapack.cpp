@@ -90,6 +90,33 @@ extern "C"
       ipfint*       ldB,
       ipfint*       info
    );
+
+   /** LAPACK Fortran subroutine DSYTRF. */
+   void IPOPT_LAPACK_FUNC(dsytrf, DSYTRF)(
+      char*        uplo,
+      ipfint*      n,
+      double*      A,
+      ipfint*      ldA,
+      ipfintarray* IPIV,
+      double*      WORK,
+      ipfint*      LWORK,
+      ipfint*      info,
+      int          uplo_len
+   );
+
+   /** LAPACK Fortran subroutine DSYTRS. */
+   void IPOPT_LAPACK_FUNC(dsytrs, DSYTRS)(
+      char*              uplo,
+      ipfint*            n,
+      ipfint*            nrhs,
+      const double*      A,
+      ipfint*            ldA,
+      const ipfintarray* IPIV,
+      double*            B,
+      ipfint*            ldB,
+      ipfint*            info,
+      int                uplo_len
+   );
 }
 #endif
 
@@ -150,6 +177,20 @@ void IpLapackDsyev(
    Number* w,
    Index&  info
 )
+{
+   std::vector<Number> work;
+   IpLapackDsyev(compute_eigenvectors, ndim, a, lda, w, info, work);
+}
+
+void IpLapackDsyev(
+   bool                 compute_eigenvectors,
+   Index                ndim,
+   Number*              a,
+   Index                lda,
+   Number*              w,
+   Index&               info,
+   std::vector<Number>& work
+)
 {
 #ifdef IPOPT_HAS_LAPACK
    ipfint N = ndim, LDA = lda, INFO;
@@ -165,28 +206,27 @@ void IpLapackDsyev(
    }
    char UPLO = 'L';
 
-   // First we find out how large LWORK should be
-   ipfint LWORK = -1;
-   double WORK_PROBE;
-   IPOPT_LAPACK_FUNC(dsyev, DSYEV)(&JOBZ, &UPLO, &N, a, &LDA, w,
-                                  &WORK_PROBE, &LWORK, &INFO, 1, 1);
-   DBG_ASSERT(INFO == 0);
-
-   LWORK = (ipfint) WORK_PROBE;
-   DBG_ASSERT(LWORK > 0);
-
-   double* WORK = new double[LWORK];
-   for (Index i = 0; i < LWORK; i++)
+   // If work is too short, we find out how large LWORK should be
+   const Index min_lwork = Max(1, 3 * ndim - 1);
+   if( (Index) work.size() < min_lwork )
    {
-      WORK[i] = i;
+      ipfint LWORK = -1;
+      double WORK_PROBE;
+      IPOPT_LAPACK_FUNC(dsyev, DSYEV)(&JOBZ, &UPLO, &N, a, &LDA, w,
+                                     &WORK_PROBE, &LWORK, &INFO, 1, 1);
+      DBG_ASSERT(INFO == 0);
+
+      LWORK = (ipfint) WORK_PROBE;
+      DBG_ASSERT(LWORK > 0);
+      work.resize(Max((Index) LWORK, min_lwork));
    }
+
+   ipfint LWORK = (ipfint) work.size();
    IPOPT_LAPACK_FUNC(dsyev, DSYEV)(&JOBZ, &UPLO, &N, a, &LDA, w,
-                                  WORK, &LWORK, &INFO, 1, 1);
+                                  &work[0], &LWORK, &INFO, 1, 1);
 
    DBG_ASSERT(INFO >= 0);
    info = INFO;
-
-   delete [] WORK;
 #else
 
    std::string msg =
@@ -269,4 +309,64 @@ void IpLapackDppsv(
 #endif
 }
 
+void IpLapackDsytrf(
+   Index   ndim,
+   Number* a,
+   Index*  ipiv,
+   Index   lda,
+   Index&  info
+)
+{
+#ifdef IPOPT_HAS_LAPACK
+   ipfint N = ndim, LDA = lda, INFO;
+   char uplo = 'L';
+
+   // First we find out how large LWORK should be
+   ipfint LWORK = -1;
+   double WORK_PROBE;
+   IPOPT_LAPACK_FUNC(dsytrf, DSYTRF)(&uplo, &N, a, &LDA, ipiv, &WORK_PROBE, &LWORK, &INFO, 1);
+   DBG_ASSERT(INFO == 0);
+
+   LWORK = (ipfint) WORK_PROBE;
+   if( LWORK < 1 )
+   {
+      LWORK = 1;
+   }
+   double* WORK = new double[LWORK];
+   IPOPT_LAPACK_FUNC(dsytrf, DSYTRF)(&uplo, &N, a, &LDA, ipiv, WORK, &LWORK, &INFO, 1);
+   delete [] WORK;
+
+   info = INFO;
+#else
+
+   std::string msg =
+      "Ipopt has been compiled without LAPACK routine DSYTRF, but options are chosen that require this dependency.  Abort.";
+   THROW_EXCEPTION(LAPACK_NOT_INCLUDED, msg);
+#endif
+}
+
+void IpLapackDsytrs(
+   Index         ndim,
+   Index         nrhs,
+   const Number* a,
+   Index         lda,
+   const Index*  ipiv,
+   Number*       b,
+   Index         ldb
+)
+{
+#ifdef IPOPT_HAS_LAPACK
+   ipfint N = ndim, NRHS = nrhs, LDA = lda, LDB = ldb, INFO;
+   char uplo = 'L';
+
+   IPOPT_LAPACK_FUNC(dsytrs, DSYTRS)(&uplo, &N, &NRHS, a, &LDA, ipiv, b, &LDB, &INFO, 1);
+   DBG_ASSERT(INFO == 0);
+#else
+
+   std::string msg =
+      "Ipopt has been compiled without LAPACK routine DSYTRS, but options are chosen that require this dependency.  Abort.";
+   THROW_EXCEPTION(LAPACK_NOT_INCLUDED, msg);
+#endif
+}
+
 } // namespace Ipopt
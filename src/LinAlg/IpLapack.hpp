@@ -10,6 +10,8 @@
 #include "IpUtils.hpp"
 #include "IpException.hpp"
 
+#include <vector>
+
 namespace Ipopt
 {
 DECLARE_STD_EXCEPTION(LAPACK_NOT_INCLUDED);
@@ -55,6 +57,24 @@ IPOPTLIB_EXPORT void IpLapackDsyev(
    Index&  info
 );
 
+/** Wrapper for LAPACK subroutine DSYEV with a workspace kept by the caller.
+ *
+ *  Same as above, but if work is shorter than the minimal workspace of
+ *  DSYEV for ndim, it is resized to the optimal length given by a
+ *  workspace query.  Passing the same work to repeated calls for
+ *  matrices of the same size avoids the query and the allocation of
+ *  the workspace in each call.
+ */
+IPOPTLIB_EXPORT void IpLapackDsyev(
+   bool                 compute_eigenvectors,
+   Index                ndim,
+   Number*              a,
+   Index                lda,
+   Number*              w,
+   Index&               info,
+   std::vector<Number>& work
+);
+
 /** Wrapper for LAPACK subroutine DGETRF.
  *
  *  Compute LU factorization.
@@ -97,6 +117,36 @@ IPOPTLIB_EXPORT void IpLapackDppsv(
    Index&        info
 );
 
+/** Wrapper for LAPACK subroutine DSYTRF.
+ *
+ *  Compute the Bunch-Kaufman factorization \f$LDL^T\f$ of a
+ *  symmetric indefinite matrix, given by its lower triangle.
+ *  D is block diagonal with blocks of order 1 and 2, see the LAPACK
+ *  documentation for the meaning of ipiv.
+ *  info is the return value from the LAPACK routine.
+ */
+IPOPTLIB_EXPORT void IpLapackDsytrf(
+   Index   ndim,
+   Number* a,
+   Index*  ipiv,
+   Index   lda,
+   Index&  info
+);
+
+/** Wrapper for LAPACK subroutine DSYTRS.
+ *
+ *  Solving a linear system given a factorization by DSYTRF.
+ */
+IPOPTLIB_EXPORT void IpLapackDsytrs(
+   Index         ndim,
+   Index         nrhs,
+   const Number* a,
+   Index         lda,
+   const Index*  ipiv,
+   Number*       b,
+   Index         ldb
+);
+
 } // namespace Ipopt
 
 #endif
@@ -128,6 +128,12 @@ void LowRankUpdateSymMatrix::MultVectorImpl(
          P_LR->MultVector(alpha, *small_y, 1., y);
       }
    }
+
+   if( IsValid(E_) )
+   {
+      // Exact part
+      E_->MultVector(alpha, x, 1., y);
+   }
 }
 
 bool LowRankUpdateSymMatrix::HasValidNumbersImpl() const
@@ -151,6 +157,13 @@ bool LowRankUpdateSymMatrix::HasValidNumbersImpl() const
          return false;
       }
    }
+   if( IsValid(E_) )
+   {
+      if( !E_->HasValidNumbers() )
+      {
+         return false;
+      }
+   }
    return true;
 }
 
@@ -182,7 +195,7 @@ void LowRankUpdateSymMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sLowRankUpdateSymMatrix \"%s\" with %d rows and columns:\n", prefix.c_str(), name.c_str(), Dim());
+                        "%sLowRankUpdateSymMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " rows and columns:\n", prefix.c_str(), name.c_str(), Dim());
 
    if( ReducedDiag() )
    {
@@ -229,6 +242,13 @@ void LowRankUpdateSymMatrix::PrintImpl(
       jnlst.PrintfIndented(level, category, indent,
                            "%sU matrix not set!\n", prefix.c_str());
    }
+
+   if( IsValid(E_) )
+   {
+      jnlst.PrintfIndented(level, category, indent + 1,
+                           "%sExact part:\n", prefix.c_str());
+      E_->Print(&jnlst, level, category, name + "-E", indent + 1, prefix);
+   }
 }
 
 } // namespace Ipopt
@@ -27,6 +27,11 @@ class LowRankUpdateSymMatrixSpace;
  *  LowRankVectorSpace.  If P_LR is NULL, P_LR is assumed to be the
  *  identity matrix.  If V or U is NULL, it is assume to be a matrix
  *  of zero columns.
+ *
+ *  If the matrix space has an exact space, an additional (sparse)
+ *  matrix E from that space is added to M in the full space, that is,
+ *  the low-rank update is a correction of E.  If E is NULL, it is
+ *  assumed to be zero.
  */
 class LowRankUpdateSymMatrix: public SymMatrix
 {
@@ -87,6 +92,21 @@ public:
       return U_;
    }
 
+   /** Method for setting the exact part E (from the ExactSpace). */
+   void SetExact(
+      const SymMatrix& E
+   )
+   {
+      E_ = &E;
+      ObjectChanged();
+   }
+
+   /** Method for getting the exact part E. */
+   SmartPtr<const SymMatrix> GetExact() const
+   {
+      return E_;
+   }
+
    /** Return the expansion matrix to lift the low-rank update to the
     *  higher-dimensional space.
     */
@@ -100,6 +120,11 @@ public:
     */
    bool ReducedDiag() const;
 
+   /** Return the matrix space of the exact part E, or NULL if the
+    *  matrix has no exact part.
+    */
+   SmartPtr<const SymMatrixSpace> ExactSpace() const;
+
 protected:
    /**@name Methods overloaded from matrix */
    ///@{
@@ -167,6 +192,9 @@ private:
 
    /** Vector storing the negative low-rank update. */
    SmartPtr<const MultiVectorMatrix> U_;
+
+   /** Matrix storing the exact part. */
+   SmartPtr<const SymMatrix> E_;
 };
 
 /** This is the matrix space for LowRankUpdateSymMatrix. */
@@ -175,19 +203,26 @@ class LowRankUpdateSymMatrixSpace: public SymMatrixSpace
 public:
    /** @name Constructors / Destructors */
    ///@{
-   /** Constructor, given the dimension of the matrix. */
+   /** Constructor, given the dimension of the matrix.
+    *
+    *  If ExactSpace is not NULL, the matrices have an exact part
+    *  from this space, see LowRankUpdateSymMatrix.
+    */
    LowRankUpdateSymMatrixSpace(
-      Index                       dim,
-      SmartPtr<const Matrix>      P_LowRank,
-      SmartPtr<const VectorSpace> LowRankVectorSpace,
-      bool                        reduced_diag
+      Index                          dim,
+      SmartPtr<const Matrix>         P_LowRank,
+      SmartPtr<const VectorSpace>    LowRankVectorSpace,
+      bool                           reduced_diag,
+      SmartPtr<const SymMatrixSpace> ExactSpace = NULL
    )
       : SymMatrixSpace(dim),
         P_LowRank_(P_LowRank),
         lowrank_vector_space_(LowRankVectorSpace),
-        reduced_diag_(reduced_diag)
+        reduced_diag_(reduced_diag),
+        exact_space_(ExactSpace)
    {
       DBG_ASSERT(IsValid(lowrank_vector_space_));
+      DBG_ASSERT(IsNull(exact_space_) || exact_space_->Dim() == dim);
    }
 
    /** Destructor */
@@ -221,6 +256,11 @@ public:
       return reduced_diag_;
    }
 
+   SmartPtr<const SymMatrixSpace> ExactSpace() const
+   {
+      return exact_space_;
+   }
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -259,6 +299,9 @@ private:
     *  the space of V or in the full space.
     */
    bool reduced_diag_;
+
+   /** Matrix space for the exact part, or NULL if there is none. */
+   SmartPtr<const SymMatrixSpace> exact_space_;
 };
 
 inline SmartPtr<const Matrix> LowRankUpdateSymMatrix::P_LowRank() const
@@ -276,5 +319,10 @@ inline bool LowRankUpdateSymMatrix::ReducedDiag() const
    return owner_space_->ReducedDiag();
 }
 
+inline SmartPtr<const SymMatrixSpace> LowRankUpdateSymMatrix::ExactSpace() const
+{
+   return owner_space_->ExactSpace();
+}
+
 } // namespace Ipopt
 #endif
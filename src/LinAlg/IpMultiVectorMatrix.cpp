@@ -7,6 +7,7 @@
 #include "IpMultiVectorMatrix.hpp"
 #include "IpDenseVector.hpp"
 #include "IpDenseGenMatrix.hpp"
+#include "IpBlas.hpp"
 
 #include <cstdio>
 
@@ -17,13 +18,46 @@ namespace Ipopt
 static const Index dbg_verbosity = 0;
 #endif
 
+/** Array with the elements of all columns of a MultiVectorMatrix */
+class MultiVectorStorage: public ReferencedObject
+{
+public:
+   MultiVectorStorage(
+      size_t len
+   )
+      : values_(new Number[len])
+   { }
+
+   ~MultiVectorStorage()
+   {
+      delete[] values_;
+   }
+
+   Number* Values() const
+   {
+      return values_;
+   }
+
+private:
+   MultiVectorStorage();
+   MultiVectorStorage(
+      const MultiVectorStorage&
+   );
+   void operator=(
+      const MultiVectorStorage&
+   );
+
+   Number* values_;
+};
+
 MultiVectorMatrix::MultiVectorMatrix(
    const MultiVectorMatrixSpace* owner_space
 )
    : Matrix(owner_space),
      owner_space_(owner_space),
      const_vecs_(owner_space->NCols()),
-     non_const_vecs_(owner_space->NCols())
+     non_const_vecs_(owner_space->NCols()),
+     dense_values_(NULL)
 { }
 
 void MultiVectorMatrix::SetVector(
@@ -34,6 +68,8 @@ void MultiVectorMatrix::SetVector(
    DBG_ASSERT(i < NCols());
    non_const_vecs_[i] = NULL;
    const_vecs_[i] = &vec;
+   storage_ = NULL;
+   dense_values_ = NULL;
    ObjectChanged();
 }
 
@@ -45,6 +81,8 @@ void MultiVectorMatrix::SetVectorNonConst(
    DBG_ASSERT(i < NCols());
    const_vecs_[i] = NULL;
    non_const_vecs_[i] = &vec;
+   storage_ = NULL;
+   dense_values_ = NULL;
    ObjectChanged();
 }
 
@@ -59,6 +97,25 @@ void MultiVectorMatrix::MultVectorImpl(
    DBG_ASSERT(NCols() == x.Dim());
    DBG_ASSERT(NRows() == y.Dim());
 
+   // See if we can understand the data
+   const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
+
+   const Number* Vvals = ContiguousValues();
+   DenseVector* dense_y = dynamic_cast<DenseVector*>(&y);
+   if( Vvals != NULL && dense_y != NULL )
+   {
+      std::vector<Number> xvals;
+      if( dense_x->IsHomogeneous() )
+      {
+         xvals.assign(NCols(), dense_x->Scalar());
+      }
+      const Number* x_vals = dense_x->IsHomogeneous() ? &xvals[0] : dense_x->Values();
+      // Values() gives the current values of y also if it is homogeneous
+      IpBlasDgemv(false, NRows(), NCols(), alpha, Vvals, NRows(), x_vals, 1, beta, dense_y->Values(), 1);
+      return;
+   }
+
    // Take care of the y part of the addition
    if( beta != 0.0 )
    {
@@ -69,10 +126,6 @@ void MultiVectorMatrix::MultVectorImpl(
       y.Set(0.0);  // In case y hasn't been initialized yet
    }
 
-   // See if we can understand the data
-   const DenseVector* dense_x = static_cast<const DenseVector*>(&x);
-   DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
-
    // We simply add all the Vectors one after the other
    if( dense_x->IsHomogeneous() )
    {
@@ -142,6 +195,24 @@ void MultiVectorMatrix::LRMultVector(
    DBG_PRINT((1, "alpha = %e beta = %e\n", alpha, beta));
    DBG_PRINT_VECTOR(2, "x", x);
 
+   // With contiguous columns, y = beta*y + alpha*V*(V^T*x) is computed
+   // by one matrix-vector product from the dot products, so that y is
+   // not read and written once per column.  The dot products are
+   // computed per column to keep their summation order.
+   const Number* Vvals = ContiguousValues();
+   DenseVector* dense_y = dynamic_cast<DenseVector*>(&y);
+   if( Vvals != NULL && dense_y != NULL )
+   {
+      std::vector<Number> Vtx(NCols());
+      for( Index i = 0; i < NCols(); i++ )
+      {
+         Vtx[i] = ConstVec(i)->Dot(x);
+      }
+      // Values() gives the current values of y also if it is homogeneous
+      IpBlasDgemv(false, NRows(), NCols(), alpha, Vvals, NRows(), &Vtx[0], 1, beta, dense_y->Values(), 1);
+      return;
+   }
+
    if( beta != 0.0 )
    {
       y.Scal(beta);
@@ -163,14 +234,72 @@ void MultiVectorMatrix::LRMultVector(
 void MultiVectorMatrix::FillWithNewVectors()
 {
    SmartPtr<const VectorSpace> vec_space = owner_space_->ColVectorSpace();
-   for( Index i = 0; i < NCols(); i++ )
+   const DenseVectorSpace* dense_space = dynamic_cast<const DenseVectorSpace*>(GetRawPtr(vec_space));
+   if( dense_space != NULL && NRows() > 0 && NCols() > 0 )
    {
-      non_const_vecs_[i] = vec_space->MakeNew();
-      const_vecs_[i] = NULL;
+      MultiVectorStorage* storage = new MultiVectorStorage((size_t) NRows() * NCols());
+      storage_ = storage;
+      dense_values_ = storage->Values();
+      for( Index i = 0; i < NCols(); i++ )
+      {
+         non_const_vecs_[i] = dense_space->MakeNewDenseVector(dense_values_ + (size_t) i * NRows(), storage);
+         const_vecs_[i] = NULL;
+      }
+   }
+   else
+   {
+      storage_ = NULL;
+      dense_values_ = NULL;
+      for( Index i = 0; i < NCols(); i++ )
+      {
+         non_const_vecs_[i] = vec_space->MakeNew();
+         const_vecs_[i] = NULL;
+      }
    }
    ObjectChanged();
 }
 
+const Number* MultiVectorMatrix::ContiguousValues() const
+{
+   if( dense_values_ == NULL )
+   {
+      return NULL;
+   }
+   for( Index i = 0; i < NCols(); i++ )
+   {
+      if( static_cast<const DenseVector*>(ConstVec(i))->IsHomogeneous() )
+      {
+         return NULL;
+      }
+   }
+   return dense_values_;
+}
+
+bool MultiVectorMatrix::GetDenseValues(
+   Number* values
+) const
+{
+   const Index nrows = NRows();
+   for( Index i = 0; i < NCols(); i++ )
+   {
+      const DenseVector* dvec = dynamic_cast<const DenseVector*>(ConstVec(i));
+      if( dvec == NULL )
+      {
+         return false;
+      }
+      if( dvec->IsHomogeneous() )
+      {
+         Number scalar = dvec->Scalar();
+         IpBlasDcopy(nrows, &scalar, 0, values + i * nrows, 1);
+      }
+      else
+      {
+         IpBlasDcopy(nrows, dvec->Values(), 1, values + i * nrows, 1);
+      }
+   }
+   return true;
+}
+
 void MultiVectorMatrix::ScaleRows(
    const Vector& scal_vec
 )
@@ -252,17 +381,30 @@ void MultiVectorMatrix::AddRightMultMatrix(
       FillWithNewVectors();
    }
 
-   // ToDo: For now, we simply use MatrixVector multiplications, but
-   // we might be more efficient (at least in the non-parallel case)
-   // if we used Level 3 Blas
+   const DenseGenMatrix* dense_C = static_cast<const DenseGenMatrix*>(&C);
+   DBG_ASSERT(dynamic_cast<const DenseGenMatrix*>(&C));
+   const Number* Uvals = U.ContiguousValues();
+   if( Uvals != NULL && dense_values_ != NULL && U.NCols() > 0 )
+   {
+      // Values() marks the columns as changed and gives their current
+      // values also if they are homogeneous
+      for( Index i = 0; i < NCols(); i++ )
+      {
+         static_cast<DenseVector*>(Vec(i))->Values();
+      }
+      IpBlasDgemm(false, false, NRows(), NCols(), U.NCols(), a, Uvals, NRows(), dense_C->Values(), C.NRows(), b,
+                  dense_values_, NRows());
+      ObjectChanged();
+      return;
+   }
+
+   // Otherwise, we simply use MatrixVector multiplications
    SmartPtr<const DenseVectorSpace> mydspace = new DenseVectorSpace(C.NRows());
    SmartPtr<DenseVector> mydvec = mydspace->MakeNewDenseVector();
 
-   const DenseGenMatrix* dgm_C = static_cast<const DenseGenMatrix*>(&C);
-   DBG_ASSERT(dynamic_cast<const DenseGenMatrix*>(&C));
    for( Index i = 0; i < NCols(); i++ )
    {
-      const Number* CValues = dgm_C->Values();
+      const Number* CValues = dense_C->Values();
       Number* myvalues = mydvec->Values();
       for( Index j = 0; j < U.NCols(); j++ )
       {
@@ -313,7 +455,7 @@ void MultiVectorMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sMultiVectorMatrix \"%s\" with %d columns:\n", prefix.c_str(), name.c_str(), NCols());
+                        "%sMultiVectorMatrix \"%s\" with %" IPOPT_INDEX_FORMAT " columns:\n", prefix.c_str(), name.c_str(), NCols());
 
    for( Index i = 0; i < NCols(); i++ )
    {
@@ -321,14 +463,14 @@ void MultiVectorMatrix::PrintImpl(
       {
          DBG_ASSERT(name.size() < 200);
          char buffer[256];
-         Snprintf(buffer, 255, "%s[%2d]", name.c_str(), i);
+         Snprintf(buffer, 255, "%s[%2" IPOPT_INDEX_FORMAT "]", name.c_str(), i);
          std::string term_name = buffer;
          ConstVec(i)->Print(&jnlst, level, category, term_name, indent + 1, prefix);
       }
       else
       {
          jnlst.PrintfIndented(level, category, indent,
-                              "%sVector in column %d is not yet set!\n", prefix.c_str(), i);
+                              "%sVector in column %" IPOPT_INDEX_FORMAT " is not yet set!\n", prefix.c_str(), i);
       }
    }
 }
@@ -114,7 +114,14 @@ public:
       Number                   b
    );
 
-   /** Method for initializing all Vectors with new (uninitialized) Vectors. */
+   /** Method for initializing all Vectors with new (uninitialized) Vectors.
+    *
+    *  If the column space is a DenseVectorSpace, the elements of the
+    *  new columns are stored in one array in column-major order, so
+    *  that products with this matrix can be computed by Level 2 and 3
+    *  BLAS, as long as no column is replaced by SetVector or
+    *  SetVectorNonConst.
+    */
    void FillWithNewVectors();
 
    /** Method for adding the low-rank update matrix corresponding to
@@ -130,6 +137,17 @@ public:
       Vector&       y
    ) const;
 
+   /** Method for copying the elements of all columns into the array
+    *  values in column-major order, with leading dimension NRows().
+    *
+    *  This is only possible if all columns are DenseVectors.  If this
+    *  is not the case, false is returned and the content of values is
+    *  undefined.
+    */
+   bool GetDenseValues(
+      Number* values
+   ) const;
+
    /** Vector space for the columns */
    SmartPtr<const VectorSpace> ColVectorSpace() const;
 
@@ -207,6 +225,22 @@ private:
    /** space for storing the non-const Vector's */
    std::vector<SmartPtr<Vector> > non_const_vecs_;
 
+   /** Object that owns the array with the elements of all columns, if
+    *  they have been created by FillWithNewVectors in one array.
+    */
+   SmartPtr<const ReferencedObject> storage_;
+
+   /** Array with the elements of all columns in column-major order;
+    *  NULL if the columns are not stored contiguously.
+    */
+   Number* dense_values_;
+
+   /** Returns the array with the elements of all columns if they are
+    *  stored contiguously and all columns hold explicit
+    *  (non-homogeneous) values; NULL otherwise.
+    */
+   const Number* ContiguousValues() const;
+
    /** Method for accessing the internal Vectors internally */
    ///@{
    inline const Vector* ConstVec(
@@ -0,0 +1,322 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpParVector.hpp"
+
+#ifdef HAVE_MPI
+
+#include "IpBlas.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Ipopt
+{
+
+#if IPOPT_VERBOSITY > 0
+static const Index dbg_verbosity = 0;
+#endif
+
+ParVector::ParVector(
+   const ParVectorSpace* owner_space
+)
+   : Vector(owner_space),
+     owner_space_(owner_space)
+{
+   local_vector_ = owner_space_->LocalSpace()->MakeNewDenseVector();
+}
+
+ParVector::~ParVector()
+{ }
+
+SmartPtr<ParVector> ParVector::MakeNewParVector() const
+{
+   return owner_space_->MakeNewParVector();
+}
+
+void ParVector::SetGlobalValues(
+   const Number* values
+)
+{
+   local_vector_->SetValues(values + StartPos());
+   ObjectChanged();
+}
+
+void ParVector::GetGlobalValues(
+   Number* values
+) const
+{
+   const Number* local_values = local_vector_->ExpandedValues();
+   MPI_Allgatherv(const_cast<Number*>(local_values), LocalSize(), MPI_DOUBLE, values,
+                  const_cast<int*>(&owner_space_->LocalSizes()[0]), const_cast<int*>(&owner_space_->StartPositions()[0]),
+                  MPI_DOUBLE, owner_space_->Comm());
+}
+
+Number ParVector::ReduceSum(
+   Number value
+) const
+{
+   Number global;
+   MPI_Allreduce(&value, &global, 1, MPI_DOUBLE, MPI_SUM, owner_space_->Comm());
+   return global;
+}
+
+void ParVector::CopyImpl(
+   const Vector& x
+)
+{
+   DBG_START_METH("ParVector::CopyImpl(const Vector& x)", dbg_verbosity);
+   local_vector_->Copy(Local(x));
+}
+
+void ParVector::ScalImpl(
+   Number alpha
+)
+{
+   local_vector_->Scal(alpha);
+}
+
+void ParVector::AxpyImpl(
+   Number        alpha,
+   const Vector& x
+)
+{
+   local_vector_->Axpy(alpha, Local(x));
+}
+
+Number ParVector::DotImpl(
+   const Vector& x
+) const
+{
+   return ReduceSum(local_vector_->Dot(Local(x)));
+}
+
+Number ParVector::Nrm2Impl() const
+{
+   Number local_nrm2 = local_vector_->Nrm2();
+   return sqrt(ReduceSum(local_nrm2 * local_nrm2));
+}
+
+Number ParVector::AsumImpl() const
+{
+   return ReduceSum(local_vector_->Asum());
+}
+
+Number ParVector::AmaxImpl() const
+{
+   Number local_amax = local_vector_->Amax();
+   Number global;
+   MPI_Allreduce(&local_amax, &global, 1, MPI_DOUBLE, MPI_MAX, owner_space_->Comm());
+   return global;
+}
+
+void ParVector::SetImpl(
+   Number value
+)
+{
+   local_vector_->Set(value);
+}
+
+void ParVector::ElementWiseDivideImpl(
+   const Vector& x
+)
+{
+   local_vector_->ElementWiseDivide(Local(x));
+}
+
+void ParVector::ElementWiseMultiplyImpl(
+   const Vector& x
+)
+{
+   local_vector_->ElementWiseMultiply(Local(x));
+}
+
+void ParVector::ElementWiseMaxImpl(
+   const Vector& x
+)
+{
+   local_vector_->ElementWiseMax(Local(x));
+}
+
+void ParVector::ElementWiseMinImpl(
+   const Vector& x
+)
+{
+   local_vector_->ElementWiseMin(Local(x));
+}
+
+void ParVector::ElementWiseReciprocalImpl()
+{
+   local_vector_->ElementWiseReciprocal();
+}
+
+void ParVector::ElementWiseAbsImpl()
+{
+   local_vector_->ElementWiseAbs();
+}
+
+void ParVector::ElementWiseSqrtImpl()
+{
+   local_vector_->ElementWiseSqrt();
+}
+
+void ParVector::ElementWiseSgnImpl()
+{
+   local_vector_->ElementWiseSgn();
+}
+
+void ParVector::AddScalarImpl(
+   Number scalar
+)
+{
+   local_vector_->AddScalar(scalar);
+}
+
+Number ParVector::MaxImpl() const
+{
+   // DenseVector::Max returns -max Number if there are no local elements
+   Number local_max = local_vector_->Max();
+   Number global;
+   MPI_Allreduce(&local_max, &global, 1, MPI_DOUBLE, MPI_MAX, owner_space_->Comm());
+   return global;
+}
+
+Number ParVector::MinImpl() const
+{
+   Number local_min = local_vector_->Min();
+   Number global;
+   MPI_Allreduce(&local_min, &global, 1, MPI_DOUBLE, MPI_MIN, owner_space_->Comm());
+   return global;
+}
+
+Number ParVector::SumImpl() const
+{
+   return ReduceSum(local_vector_->Sum());
+}
+
+Number ParVector::SumLogsImpl() const
+{
+   return ReduceSum(local_vector_->SumLogs());
+}
+
+void ParVector::AddTwoVectorsImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   Number        c
+)
+{
+   local_vector_->AddTwoVectors(a, Local(v1), b, Local(v2), c);
+}
+
+Number ParVector::FracToBoundImpl(
+   const Vector& delta,
+   Number        tau
+) const
+{
+   Number local_alpha = local_vector_->FracToBound(Local(delta), tau);
+   Number global;
+   MPI_Allreduce(&local_alpha, &global, 1, MPI_DOUBLE, MPI_MIN, owner_space_->Comm());
+   return global;
+}
+
+void ParVector::AddVectorQuotientImpl(
+   Number        a,
+   const Vector& z,
+   const Vector& s,
+   Number        c
+)
+{
+   local_vector_->AddVectorQuotient(a, Local(z), Local(s), c);
+}
+
+void ParVector::AddVectorProductImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   const Vector& w,
+   Number        c
+)
+{
+   local_vector_->AddVectorProduct(a, Local(v1), b, Local(v2), Local(w), c);
+}
+
+Number ParVector::AxpyDotImpl(
+   Number        alpha,
+   const Vector& x,
+   const Vector& z
+)
+{
+   return ReduceSum(local_vector_->AxpyDot(alpha, Local(x), Local(z)));
+}
+
+bool ParVector::HasValidNumbersImpl() const
+{
+   int local_valid = local_vector_->HasValidNumbers() ? 1 : 0;
+   int global_valid;
+   MPI_Allreduce(&local_valid, &global_valid, 1, MPI_INT, MPI_MIN, owner_space_->Comm());
+   return global_valid != 0;
+}
+
+void ParVector::PrintImpl(
+   const Journalist&  jnlst,
+   EJournalLevel      level,
+   EJournalCategory   category,
+   const std::string& name,
+   Index              indent,
+   const std::string& prefix
+) const
+{
+   jnlst.PrintfIndented(level, category, indent,
+                        "%sParVector \"%s\" with %" IPOPT_INDEX_FORMAT " elements, elements %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT " on process %d of %d:\n", prefix.c_str(), name.c_str(),
+                        Dim(), StartPos() + 1, StartPos() + LocalSize(), owner_space_->Rank(), owner_space_->NumProc());
+   local_vector_->PrintImplOffset(jnlst, level, category, name, indent, prefix, StartPos() + 1);
+}
+
+ParVectorSpace::ParVectorSpace(
+   Index    total_dim,
+   Index    start_pos,
+   Index    local_dim,
+   MPI_Comm comm
+)
+   : VectorSpace(total_dim),
+     comm_(comm),
+     start_pos_(start_pos)
+{
+   int nproc;
+   MPI_Comm_rank(comm_, &rank_);
+   MPI_Comm_size(comm_, &nproc);
+
+   // the MPI counts and displacements for the collective operations are int
+   ASSERT_EXCEPTION(total_dim <= std::numeric_limits<int>::max(), INVALID_PARVECTOR_LAYOUT,
+                    "The dimension of the vector exceeds the range of MPI counts.");
+
+   // Index can be a 64-bit integer, so gather the bytes
+   Index layout[2] = { start_pos, local_dim };
+   std::vector<Index> layouts(2 * nproc);
+   MPI_Allgather(layout, (int) sizeof(layout), MPI_BYTE, &layouts[0], (int) sizeof(layout), MPI_BYTE, comm_);
+
+   local_sizes_.resize(nproc);
+   start_positions_.resize(nproc);
+   Index next_pos = 0;
+   for( int p = 0; p < nproc; p++ )
+   {
+      start_positions_[p] = (int) layouts[2 * p];
+      local_sizes_[p] = (int) layouts[2 * p + 1];
+      ASSERT_EXCEPTION(local_sizes_[p] >= 0 && start_positions_[p] == next_pos, INVALID_PARVECTOR_LAYOUT,
+                       "The elements of the processes are not contiguous in the order of the ranks.");
+      next_pos += local_sizes_[p];
+   }
+   ASSERT_EXCEPTION(next_pos == total_dim, INVALID_PARVECTOR_LAYOUT,
+                    "The number of elements of all processes differs from the dimension of the vector.");
+
+   local_space_ = new DenseVectorSpace(local_dim);
+}
+
+} // namespace Ipopt
+
+#endif // HAVE_MPI
@@ -0,0 +1,412 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPPARVECTOR_HPP__
+#define __IPPARVECTOR_HPP__
+
+#include "IpUtils.hpp"
+#include "IpDenseVector.hpp"
+
+#ifdef HAVE_MPI
+
+#include <mpi.h>
+#include <vector>
+
+namespace Ipopt
+{
+
+/* forward declarations */
+class ParVectorSpace;
+
+/** @name Exceptions */
+///@{
+DECLARE_STD_EXCEPTION(INVALID_PARVECTOR_LAYOUT);
+///@}
+
+/** Vector whose elements are distributed over the processes of an
+ *  MPI communicator.
+ *
+ *  Each process stores a contiguous range of the elements of the
+ *  vector in a DenseVector, the local vector.  The ranges of the
+ *  processes are given by the ParVectorSpace and follow the order of
+ *  the ranks in the communicator.
+ *
+ *  Element-wise operations only work on the local vector.  Reductions
+ *  (dot products, norms, sums, minimum and maximum, fraction to
+ *  the boundary) combine the results of all processes, so they are
+ *  collective operations and must be called by all processes of the
+ *  communicator in the same order.  All vectors that are combined in
+ *  one operation must be ParVectors of spaces with the same
+ *  distribution.
+ */
+class IPOPTLIB_EXPORT ParVector: public Vector
+{
+public:
+   /**@name Constructors / Destructors */
+   ///@{
+   /** Default Constructor */
+   ParVector(
+      const ParVectorSpace* owner_space
+   );
+
+   /** Destructor */
+   virtual ~ParVector();
+   ///@}
+
+   /** @name Additional public methods not in Vector base class. */
+   ///@{
+   /** Create a new ParVector from same VectorSpace */
+   SmartPtr<ParVector> MakeNewParVector() const;
+
+   /** Local part of the vector (non-const version).
+    *
+    *  This vector is marked as changed, so use this method only if
+    *  the local values are going to be changed.
+    */
+   SmartPtr<DenseVector> LocalVector()
+   {
+      ObjectChanged();
+      return local_vector_;
+   }
+
+   /** Local part of the vector (const version) */
+   SmartPtr<const DenseVector> LocalVector() const
+   {
+      return ConstPtr(local_vector_);
+   }
+
+   /** Owner space of this vector as a ParVectorSpace */
+   inline SmartPtr<const ParVectorSpace> OwnerParVectorSpace() const;
+
+   /** Position of the first local element in the global vector (counting starts at 0) */
+   inline Index StartPos() const;
+
+   /** Number of elements stored on this process */
+   inline Index LocalSize() const;
+
+   /** Set the local part of the vector from an array with the elements
+    *  of the global vector.
+    *
+    *  values must have length Dim().
+    */
+   void SetGlobalValues(
+      const Number* values
+   );
+
+   /** Collect the elements of the global vector from all processes.
+    *
+    *  values must have length Dim().  This is a collective operation.
+    */
+   void GetGlobalValues(
+      Number* values
+   ) const;
+   ///@}
+
+protected:
+   /** @name Overloaded methods from Vector base class */
+   ///@{
+   virtual void CopyImpl(
+      const Vector& x
+   );
+
+   virtual void ScalImpl(
+      Number alpha
+   );
+
+   virtual void AxpyImpl(
+      Number        alpha,
+      const Vector& x
+   );
+
+   virtual Number DotImpl(
+      const Vector& x
+   ) const;
+
+   virtual Number Nrm2Impl() const;
+
+   virtual Number AsumImpl() const;
+
+   virtual Number AmaxImpl() const;
+
+   virtual void SetImpl(
+      Number value
+   );
+
+   virtual void ElementWiseDivideImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseMultiplyImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseMaxImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseMinImpl(
+      const Vector& x
+   );
+
+   virtual void ElementWiseReciprocalImpl();
+
+   virtual void ElementWiseAbsImpl();
+
+   virtual void ElementWiseSqrtImpl();
+
+   virtual void ElementWiseSgnImpl();
+
+   virtual void AddScalarImpl(
+      Number scalar
+   );
+
+   virtual Number MaxImpl() const;
+
+   virtual Number MinImpl() const;
+
+   virtual Number SumImpl() const;
+
+   virtual Number SumLogsImpl() const;
+
+   virtual void AddTwoVectorsImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      Number        c
+   );
+
+   virtual Number FracToBoundImpl(
+      const Vector& delta,
+      Number        tau
+   ) const;
+
+   virtual void AddVectorQuotientImpl(
+      Number        a,
+      const Vector& z,
+      const Vector& s,
+      Number        c
+   );
+
+   virtual void AddVectorProductImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      const Vector& w,
+      Number        c
+   );
+
+   virtual Number AxpyDotImpl(
+      Number        alpha,
+      const Vector& x,
+      const Vector& z
+   );
+
+   virtual bool HasValidNumbersImpl() const;
+   ///@}
+
+   /** @name Output methods */
+   ///@{
+   /** Print the local part of the vector.
+    *
+    *  Each process prints its elements to its own journalist, counting
+    *  the elements as in the global vector.
+    */
+   virtual void PrintImpl(
+      const Journalist&  jnlst,
+      EJournalLevel      level,
+      EJournalCategory   category,
+      const std::string& name,
+      Index              indent,
+      const std::string& prefix
+   ) const;
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   ParVector();
+
+   /** Copy Constructor */
+   ParVector(
+      const ParVector&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const ParVector&
+   );
+   ///@}
+
+   /** Copy of the owner_space ptr as a ParVectorSpace instead
+    *  of a VectorSpace
+    */
+   const ParVectorSpace* owner_space_;
+
+   /** The elements of the vector that are stored on this process */
+   SmartPtr<DenseVector> local_vector_;
+
+   /** Local vector of another ParVector of the same distribution */
+   static const DenseVector& Local(
+      const Vector& x
+   )
+   {
+      DBG_ASSERT(dynamic_cast<const ParVector*>(&x));
+      return *static_cast<const ParVector&>(x).local_vector_;
+   }
+
+   /** Sum of a value over all processes */
+   Number ReduceSum(
+      Number value
+   ) const;
+};
+
+/** This vectors space is the vector space for ParVector.
+ *
+ *  It stores the communicator and the range of elements of each
+ *  process.
+ */
+class IPOPTLIB_EXPORT ParVectorSpace: public VectorSpace
+{
+public:
+   /** @name Constructors/Destructors. */
+   ///@{
+   /** Constructor, given the dimension of the global vector and the
+    *  range of elements stored on this process.
+    *
+    *  This is a collective operation.  The ranges of the processes must
+    *  be contiguous, in the order of the ranks in comm, and cover all
+    *  total_dim elements; otherwise INVALID_PARVECTOR_LAYOUT is thrown
+    *  on all processes.
+    */
+   ParVectorSpace(
+      Index    total_dim,
+      Index    start_pos,
+      Index    local_dim,
+      MPI_Comm comm = MPI_COMM_WORLD
+   );
+
+   /** Destructor */
+   ~ParVectorSpace()
+   { }
+   ///@}
+
+   /** Method for creating a new vector of this specific type. */
+   inline ParVector* MakeNewParVector() const
+   {
+      return new ParVector(this);
+   }
+
+   virtual Vector* MakeNew() const
+   {
+      return MakeNewParVector();
+   }
+
+   /** @name Accessor methods */
+   ///@{
+   /** Position of the first local element in the global vector (counting starts at 0) */
+   Index StartPos() const
+   {
+      return start_pos_;
+   }
+
+   /** Position after the last local element in the global vector */
+   Index EndPos() const
+   {
+      return start_pos_ + LocalSize();
+   }
+
+   /** Number of elements stored on this process */
+   Index LocalSize() const
+   {
+      return local_space_->Dim();
+   }
+
+   /** Space of the local vectors */
+   SmartPtr<const DenseVectorSpace> LocalSpace() const
+   {
+      return local_space_;
+   }
+
+   /** Communicator over which the vectors are distributed */
+   MPI_Comm Comm() const
+   {
+      return comm_;
+   }
+
+   /** Rank of this process in the communicator */
+   int Rank() const
+   {
+      return rank_;
+   }
+
+   /** Number of processes in the communicator */
+   int NumProc() const
+   {
+      return (int) local_sizes_.size();
+   }
+
+   /** Number of elements stored on each process */
+   const std::vector<int>& LocalSizes() const
+   {
+      return local_sizes_;
+   }
+
+   /** Position of the first element of each process in the global vector */
+   const std::vector<int>& StartPositions() const
+   {
+      return start_positions_;
+   }
+   ///@}
+
+private:
+   /** Communicator over which the vectors are distributed */
+   MPI_Comm comm_;
+
+   /** Rank of this process in comm_ */
+   int rank_;
+
+   /** Position of the first local element in the global vector */
+   Index start_pos_;
+
+   /** Space of the local vectors */
+   SmartPtr<DenseVectorSpace> local_space_;
+
+   /** Number of elements stored on each process, as needed for MPI_Allgatherv */
+   std::vector<int> local_sizes_;
+
+   /** Start position of each process, as needed for MPI_Allgatherv */
+   std::vector<int> start_positions_;
+};
+
+/* inline methods */
+inline SmartPtr<const ParVectorSpace> ParVector::OwnerParVectorSpace() const
+{
+   return owner_space_;
+}
+
+inline Index ParVector::StartPos() const
+{
+   return owner_space_->StartPos();
+}
+
+inline Index ParVector::LocalSize() const
+{
+   return owner_space_->LocalSize();
+}
+
+} // namespace Ipopt
+
+#endif // HAVE_MPI
+
+#endif
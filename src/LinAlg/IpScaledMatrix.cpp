@@ -5,6 +5,8 @@
 // Authors:  Carl Laird, Andreas Waechter     IBM    2004-08-13
 
 #include "IpScaledMatrix.hpp"
+#include "IpGenTMatrix.hpp"
+#include "IpDenseVector.hpp"
 
 namespace Ipopt
 {
@@ -13,12 +15,85 @@ ScaledMatrix::ScaledMatrix(
    const ScaledMatrixSpace* owner_space
 )
    : Matrix(owner_space),
-     owner_space_(owner_space)
+     owner_space_(owner_space),
+     scaled_matrix_tag_(TaggedObject::Tag())
 { }
 
 ScaledMatrix::~ScaledMatrix()
 { }
 
+SmartPtr<const Matrix> ScaledMatrix::GetScaledValuesMatrix() const
+{
+   if( !owner_space_->StoreScaledValues() )
+   {
+      return NULL;
+   }
+
+   const GenTMatrix* unscaled = dynamic_cast<const GenTMatrix*>(GetRawPtr(matrix_));
+   const DenseVector* row_scaling = dynamic_cast<const DenseVector*>(GetRawPtr(owner_space_->RowScaling()));
+   const DenseVector* column_scaling = dynamic_cast<const DenseVector*>(GetRawPtr(owner_space_->ColumnScaling()));
+   if( unscaled == NULL || (IsValid(owner_space_->RowScaling()) && row_scaling == NULL)
+       || (IsValid(owner_space_->ColumnScaling()) && column_scaling == NULL) )
+   {
+      return NULL;
+   }
+
+   if( IsValid(scaled_matrix_) && scaled_matrix_tag_ == unscaled->GetTag()
+       && GetRawPtr(scaled_matrix_->OwnerSpace()) == GetRawPtr(unscaled->OwnerSpace()) )
+   {
+      return ConstPtr(scaled_matrix_);
+   }
+
+   if( IsNull(scaled_matrix_) || GetRawPtr(scaled_matrix_->OwnerSpace()) != GetRawPtr(unscaled->OwnerSpace()) )
+   {
+      scaled_matrix_ = unscaled->OwnerSpace()->MakeNew();
+   }
+   GenTMatrix* scaled = static_cast<GenTMatrix*>(GetRawPtr(scaled_matrix_));
+   DBG_ASSERT(dynamic_cast<GenTMatrix*>(GetRawPtr(scaled_matrix_)));
+
+   // scale the values in the same way as TripletHelper
+   const Index nonzeros = unscaled->Nonzeros();
+   const Index* irows = unscaled->Irows();
+   const Index* jcols = unscaled->Jcols();
+   Number* values = scaled->Values();
+   unscaled->FillValues(values);
+   if( row_scaling != NULL && row_scaling->IsHomogeneous() )
+   {
+      Number scaling = row_scaling->Scalar();
+      for( Index i = 0; i < nonzeros; i++ )
+      {
+         values[i] *= scaling;
+      }
+   }
+   else if( row_scaling != NULL )
+   {
+      const Number* scaling = row_scaling->Values();
+      for( Index i = 0; i < nonzeros; i++ )
+      {
+         values[i] *= scaling[irows[i] - 1];
+      }
+   }
+   if( column_scaling != NULL && column_scaling->IsHomogeneous() )
+   {
+      Number scaling = column_scaling->Scalar();
+      for( Index i = 0; i < nonzeros; i++ )
+      {
+         values[i] *= scaling;
+      }
+   }
+   else if( column_scaling != NULL )
+   {
+      const Number* scaling = column_scaling->Values();
+      for( Index i = 0; i < nonzeros; i++ )
+      {
+         values[i] *= scaling[jcols[i] - 1];
+      }
+   }
+
+   scaled_matrix_tag_ = unscaled->GetTag();
+   return ConstPtr(scaled_matrix_);
+}
+
 void ScaledMatrix::MultVectorImpl(
    Number        alpha,
    const Vector& x,
@@ -28,6 +103,13 @@ void ScaledMatrix::MultVectorImpl(
 {
    DBG_ASSERT(IsValid(matrix_));
 
+   SmartPtr<const Matrix> scaled_matrix = GetScaledValuesMatrix();
+   if( IsValid(scaled_matrix) )
+   {
+      scaled_matrix->MultVector(alpha, x, beta, y);
+      return;
+   }
+
    // Take care of the y part of the addition
    if( beta != 0.0 )
    {
@@ -38,13 +120,16 @@ void ScaledMatrix::MultVectorImpl(
       y.Set(0.0);  // In case y hasn't been initialized yet
    }
 
-   // need some temporary vectors
-   SmartPtr<Vector> tmp_x = x.MakeNewCopy();
+   // need some temporary vectors; x is copied only if it is scaled
+   const Vector* tmp_x = &x;
+   SmartPtr<Vector> scaled_x;
    SmartPtr<Vector> tmp_y = y.MakeNew();
 
    if( IsValid(owner_space_->ColumnScaling()) )
    {
-      tmp_x->ElementWiseMultiply(*owner_space_->ColumnScaling());
+      scaled_x = x.MakeNewCopy();
+      scaled_x->ElementWiseMultiply(*owner_space_->ColumnScaling());
+      tmp_x = GetRawPtr(scaled_x);
    }
 
    matrix_->MultVector(1.0, *tmp_x, 0.0, *tmp_y);
@@ -66,6 +151,13 @@ void ScaledMatrix::TransMultVectorImpl(
 {
    DBG_ASSERT(IsValid(matrix_));
 
+   SmartPtr<const Matrix> scaled_matrix = GetScaledValuesMatrix();
+   if( IsValid(scaled_matrix) )
+   {
+      scaled_matrix->TransMultVector(alpha, x, beta, y);
+      return;
+   }
+
    // Take care of the y part of the addition
    if( beta != 0.0 )
    {
@@ -76,13 +168,16 @@ void ScaledMatrix::TransMultVectorImpl(
       y.Set(0.0);  // In case y hasn't been initialized yet
    }
 
-   // need some temporary vectors
-   SmartPtr<Vector> tmp_x = x.MakeNewCopy();
+   // need some temporary vectors; x is copied only if it is scaled
+   const Vector* tmp_x = &x;
+   SmartPtr<Vector> scaled_x;
    SmartPtr<Vector> tmp_y = y.MakeNew();
 
    if( IsValid(owner_space_->RowScaling()) )
    {
-      tmp_x->ElementWiseMultiply(*owner_space_->RowScaling());
+      scaled_x = x.MakeNewCopy();
+      scaled_x->ElementWiseMultiply(*owner_space_->RowScaling());
+      tmp_x = GetRawPtr(scaled_x);
    }
 
    matrix_->TransMultVector(1.0, *tmp_x, 0.0, *tmp_y);
@@ -129,7 +224,7 @@ void ScaledMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sScaledMatrix \"%s\" of dimension %d x %d:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
+                        "%sScaledMatrix \"%s\" of dimension %" IPOPT_INDEX_FORMAT " x %" IPOPT_INDEX_FORMAT ":\n", prefix.c_str(), name.c_str(), NRows(), NCols());
    if( IsValid(owner_space_->RowScaling()) )
    {
       owner_space_->RowScaling()->Print(&jnlst, level, category, name + "_row_scaling", indent + 1, prefix);
@@ -195,10 +290,12 @@ ScaledMatrixSpace::ScaledMatrixSpace(
    bool                               row_scaling_reciprocal,
    const SmartPtr<const MatrixSpace>& unscaled_matrix_space,
    const SmartPtr<const Vector>&      column_scaling,
-   bool                               column_scaling_reciprocal
+   bool                               column_scaling_reciprocal,
+   bool                               store_scaled_values
 )
    : MatrixSpace(unscaled_matrix_space->NRows(), unscaled_matrix_space->NCols()),
-     unscaled_matrix_space_(unscaled_matrix_space)
+     unscaled_matrix_space_(unscaled_matrix_space),
+     store_scaled_values_(store_scaled_values)
 {
    if( IsValid(row_scaling) )
    {
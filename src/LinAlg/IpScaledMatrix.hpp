@@ -60,6 +60,16 @@ public:
    /** return the vector for the column scaling */
    SmartPtr<const Vector> ColumnScaling() const;
 
+   /** Return a matrix with the scaled values of this matrix.
+    *
+    *  This is available only if the owner space stores the scaled
+    *  values, the unscaled matrix is a GenTMatrix, and the scaling
+    *  vectors are DenseVectors; otherwise NULL is returned.  The
+    *  scaled values are computed once after each change of the
+    *  unscaled matrix.
+    */
+   SmartPtr<const Matrix> GetScaledValuesMatrix() const;
+
 protected:
    /**@name Methods overloaded from Matrix */
    ///@{
@@ -155,6 +165,12 @@ private:
 
    /** Matrix space stored as a ScaledMatrixSpace */
    SmartPtr<const ScaledMatrixSpace> owner_space_;
+
+   /** Matrix with the scaled values, in the space of the unscaled matrix */
+   mutable SmartPtr<Matrix> scaled_matrix_;
+
+   /** Tag of the unscaled matrix for which scaled_matrix_ has been computed */
+   mutable TaggedObject::Tag scaled_matrix_tag_;
 };
 
 /** This is the matrix space for ScaledMatrix. */
@@ -165,13 +181,17 @@ public:
    ///@{
    /** Constructor, given the number of row and columns blocks, as
     *  well as the totel number of rows and columns.
+    *
+    *  If store_scaled_values is true, matrices of this space keep a
+    *  copy of their scaled values if possible, see GetScaledValuesMatrix.
     */
    ScaledMatrixSpace(
       const SmartPtr<const Vector>&      row_scaling,
       bool                               row_scaling_reciprocal,
       const SmartPtr<const MatrixSpace>& unscaled_matrix_space,
       const SmartPtr<const Vector>&      column_scaling,
-      bool                               column_scaling_reciprocal
+      bool                               column_scaling_reciprocal,
+      bool                               store_scaled_values = false
    );
 
    /** Destructor */
@@ -210,12 +230,33 @@ public:
       return unscaled_matrix_space_;
    }
 
+   /** Multiply the row scaling by the elements of factors.
+    *
+    *  This changes all matrices of this space, so their users have
+    *  to discard results that have been computed with them.
+    */
+   void ScaleRowScaling(
+      const Vector& factors
+   )
+   {
+      DBG_ASSERT(IsValid(row_scaling_));
+      row_scaling_->ElementWiseMultiply(factors);
+   }
+
    /** return the vector for the column scaling */
    SmartPtr<const Vector> ColumnScaling() const
    {
       return ConstPtr(column_scaling_);
    }
 
+   /** whether matrices of this space store their scaled values to
+    *  compute products without applying the scaling vectors
+    */
+   bool StoreScaledValues() const
+   {
+      return store_scaled_values_;
+   }
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -248,6 +289,9 @@ private:
 
    /** column scaling vector */
    SmartPtr<Vector> column_scaling_;
+
+   /** whether matrices of this space store their scaled values */
+   bool store_scaled_values_;
 };
 
 inline void ScaledMatrix::SetUnscaledMatrix(
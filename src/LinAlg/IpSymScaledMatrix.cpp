@@ -5,6 +5,8 @@
 // Authors:  Carl Laird, Andreas Waechter     IBM    2004-08-13
 
 #include "IpSymScaledMatrix.hpp"
+#include "IpSymTMatrix.hpp"
+#include "IpDenseVector.hpp"
 
 namespace Ipopt
 {
@@ -13,12 +15,69 @@ SymScaledMatrix::SymScaledMatrix(
    const SymScaledMatrixSpace* owner_space
 )
    : SymMatrix(owner_space),
-     owner_space_(owner_space)
+     owner_space_(owner_space),
+     scaled_matrix_tag_(TaggedObject::Tag())
 { }
 
 SymScaledMatrix::~SymScaledMatrix()
 { }
 
+SmartPtr<const SymMatrix> SymScaledMatrix::GetScaledValuesMatrix() const
+{
+   if( !owner_space_->StoreScaledValues() )
+   {
+      return NULL;
+   }
+
+   const SymTMatrix* unscaled = dynamic_cast<const SymTMatrix*>(GetRawPtr(matrix_));
+   const DenseVector* row_col_scaling = dynamic_cast<const DenseVector*>(GetRawPtr(owner_space_->RowColScaling()));
+   if( unscaled == NULL || (IsValid(owner_space_->RowColScaling()) && row_col_scaling == NULL) )
+   {
+      return NULL;
+   }
+
+   if( IsValid(scaled_matrix_) && scaled_matrix_tag_ == unscaled->GetTag()
+       && GetRawPtr(scaled_matrix_->OwnerSpace()) == GetRawPtr(unscaled->OwnerSpace()) )
+   {
+      return ConstPtr(scaled_matrix_);
+   }
+
+   if( IsNull(scaled_matrix_) || GetRawPtr(scaled_matrix_->OwnerSpace()) != GetRawPtr(unscaled->OwnerSpace()) )
+   {
+      scaled_matrix_ = unscaled->OwnerSymMatrixSpace()->MakeNewSymMatrix();
+   }
+   SymTMatrix* scaled = static_cast<SymTMatrix*>(GetRawPtr(scaled_matrix_));
+   DBG_ASSERT(dynamic_cast<SymTMatrix*>(GetRawPtr(scaled_matrix_)));
+
+   // scale the values in the same way as TripletHelper
+   const Index nonzeros = unscaled->Nonzeros();
+   const Index* irows = unscaled->Irows();
+   const Index* jcols = unscaled->Jcols();
+   Number* values = scaled->Values();
+   unscaled->FillValues(values);
+   if( row_col_scaling != NULL && row_col_scaling->IsHomogeneous() )
+   {
+      Number scaling = row_col_scaling->Scalar();
+      for( Index i = 0; i < nonzeros; i++ )
+      {
+         values[i] *= scaling;
+         values[i] *= scaling;
+      }
+   }
+   else if( row_col_scaling != NULL )
+   {
+      const Number* scaling = row_col_scaling->Values();
+      for( Index i = 0; i < nonzeros; i++ )
+      {
+         values[i] *= scaling[irows[i] - 1];
+         values[i] *= scaling[jcols[i] - 1];
+      }
+   }
+
+   scaled_matrix_tag_ = unscaled->GetTag();
+   return ConstPtr(scaled_matrix_);
+}
+
 void SymScaledMatrix::MultVectorImpl(
    Number        alpha,
    const Vector& x,
@@ -28,6 +87,13 @@ void SymScaledMatrix::MultVectorImpl(
 {
    DBG_ASSERT(IsValid(matrix_));
 
+   SmartPtr<const SymMatrix> scaled_matrix = GetScaledValuesMatrix();
+   if( IsValid(scaled_matrix) )
+   {
+      scaled_matrix->MultVector(alpha, x, beta, y);
+      return;
+   }
+
    // Take care of the y part of the addition
    if( beta != 0.0 )
    {
@@ -38,13 +104,16 @@ void SymScaledMatrix::MultVectorImpl(
       y.Set(0.0);  // In case y hasn't been initialized yet
    }
 
-   // need some temporary vectors
-   SmartPtr<Vector> tmp_x = x.MakeNewCopy();
+   // need some temporary vectors; x is copied only if it is scaled
+   const Vector* tmp_x = &x;
+   SmartPtr<Vector> scaled_x;
    SmartPtr<Vector> tmp_y = y.MakeNew();
 
    if( IsValid(owner_space_->RowColScaling()) )
    {
-      tmp_x->ElementWiseMultiply(*owner_space_->RowColScaling());
+      scaled_x = x.MakeNewCopy();
+      scaled_x->ElementWiseMultiply(*owner_space_->RowColScaling());
+      tmp_x = GetRawPtr(scaled_x);
    }
 
    matrix_->MultVector(1.0, *tmp_x, 0.0, *tmp_y);
@@ -82,7 +151,7 @@ void SymScaledMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sSymScaledMatrix \"%s\" of dimension %d x %d:\n", prefix.c_str(), name.c_str(), NRows(), NCols());
+                        "%sSymScaledMatrix \"%s\" of dimension %" IPOPT_INDEX_FORMAT " x %" IPOPT_INDEX_FORMAT ":\n", prefix.c_str(), name.c_str(), NRows(), NCols());
    owner_space_->RowColScaling()->Print(&jnlst, level, category, name + "_row_col_scaling", indent + 1, prefix);
    if( IsValid(matrix_) )
    {
@@ -57,6 +57,16 @@ public:
    /** return the vector for the row and column scaling */
    SmartPtr<const Vector> RowColScaling() const;
 
+   /** Return a matrix with the scaled values of this matrix.
+    *
+    *  This is available only if the owner space stores the scaled
+    *  values, the unscaled matrix is a SymTMatrix, and the scaling
+    *  vector is a DenseVector; otherwise NULL is returned.  The
+    *  scaled values are computed once after each change of the
+    *  unscaled matrix.
+    */
+   SmartPtr<const SymMatrix> GetScaledValuesMatrix() const;
+
 protected:
    /**@name Methods overloaded from Matrix */
    ///@{
@@ -116,6 +126,12 @@ private:
 
    /** Matrix space stored as a SymScaledMatrixSpace */
    SmartPtr<const SymScaledMatrixSpace> owner_space_;
+
+   /** Matrix with the scaled values, in the space of the unscaled matrix */
+   mutable SmartPtr<SymMatrix> scaled_matrix_;
+
+   /** Tag of the unscaled matrix for which scaled_matrix_ has been computed */
+   mutable TaggedObject::Tag scaled_matrix_tag_;
 };
 
 /** This is the matrix space for SymScaledMatrix.
@@ -127,14 +143,19 @@ public:
    ///@{
    /** Constructor, given the number of row and columns blocks, as
     *  well as the total number of rows and columns.
+    *
+    *  If store_scaled_values is true, matrices of this space keep a
+    *  copy of their scaled values if possible, see GetScaledValuesMatrix.
     */
    SymScaledMatrixSpace(
       const SmartPtr<const Vector>&         row_col_scaling,
       bool                                  row_col_scaling_reciprocal,
-      const SmartPtr<const SymMatrixSpace>& unscaled_matrix_space
+      const SmartPtr<const SymMatrixSpace>& unscaled_matrix_space,
+      bool                                  store_scaled_values = false
    )
       : SymMatrixSpace(unscaled_matrix_space->Dim()),
-        unscaled_matrix_space_(unscaled_matrix_space)
+        unscaled_matrix_space_(unscaled_matrix_space),
+        store_scaled_values_(store_scaled_values)
    {
       scaling_ = row_col_scaling->MakeNewCopy();
       if( row_col_scaling_reciprocal )
@@ -184,6 +205,14 @@ public:
       return unscaled_matrix_space_;
    }
 
+   /** whether matrices of this space store their scaled values to
+    *  compute products without applying the scaling vector
+    */
+   bool StoreScaledValues() const
+   {
+      return store_scaled_values_;
+   }
+
 private:
    /**@name Default Compiler Generated Methods
     * (Hidden to avoid implicit creation/calling).
@@ -213,6 +242,9 @@ private:
 
    /** unscaled matrix space */
    SmartPtr<const SymMatrixSpace> unscaled_matrix_space_;
+
+   /** whether matrices of this space store their scaled values */
+   bool store_scaled_values_;
 };
 
 inline void SymScaledMatrix::SetUnscaledMatrix(
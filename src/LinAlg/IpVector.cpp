@@ -230,6 +230,38 @@ void Vector::AddVectorQuotientImpl(
    }
 }
 
+void Vector::AddVectorProductImpl(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   const Vector& w,
+   Number        c
+)
+{
+   DBG_ASSERT(Dim() == v1.Dim());
+   DBG_ASSERT(Dim() == v2.Dim());
+   DBG_ASSERT(Dim() == w.Dim());
+
+   SmartPtr<Vector> tmp = MakeNew();
+   tmp->Copy(v2);
+   tmp->ElementWiseMultiply(w);
+   AddTwoVectors(a, v1, b, *tmp, c);
+}
+
+Number Vector::AxpyDotImpl(
+   Number        alpha,
+   const Vector& x,
+   const Vector& z
+)
+{
+   DBG_ASSERT(Dim() == x.Dim());
+   DBG_ASSERT(Dim() == z.Dim());
+
+   Axpy(alpha, x);
+   return Dot(z);
+}
+
 bool Vector::HasValidNumbersImpl() const
 {
    Number sum = Asum();
@@ -165,6 +165,17 @@ public:
 
    /** Returns the sum of the logs of each vector entry */
    inline Number SumLogs() const;
+
+   /** Stores the sum of the logs of the vector entries as if SumLogs()
+    *  had been called.
+    *
+    *  This is for kernels that obtain the sum while they traverse the
+    *  values for another purpose.  sumlogs must be the value that
+    *  SumLogs() would return for the current values of the vector.
+    */
+   inline void SetCachedSumLogs(
+      Number sumlogs
+   ) const;
    ///@}
 
    /** @name Methods for specialized operations.
@@ -211,6 +222,31 @@ public:
       const Vector& s,
       Number        c
    );
+
+   /** Add a vector and the element-wise product of two vectors,
+    *  y = a * v1 + b * v2 .* w + c * y.
+    *
+    *  Here, this vector is y.
+    */
+   inline void AddVectorProduct(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      const Vector& w,
+      Number        c
+   );
+
+   /** Add one vector and compute the inner product with another one,
+    *  y = y + alpha * x, return y^T z.
+    *
+    *  Here, this vector is y.
+    */
+   inline Number AxpyDot(
+      Number        alpha,
+      const Vector& x,
+      const Vector& z
+   );
    ///@}
 
    /** Method for determining if all stored numbers are valid (i.e., no Inf or Nan). */
@@ -366,6 +402,23 @@ protected:
       Number        c
    );
 
+   /** Add a vector and the element-wise product of two vectors */
+   virtual void AddVectorProductImpl(
+      Number        a,
+      const Vector& v1,
+      Number        b,
+      const Vector& v2,
+      const Vector& w,
+      Number        c
+   );
+
+   /** Add one vector and compute the inner product with another one */
+   virtual Number AxpyDotImpl(
+      Number        alpha,
+      const Vector& x,
+      const Vector& z
+   );
+
    /** Method for determining if all stored numbers are valid (i.e., no Inf or Nan).
     *
     *  A default implementation using Asum is provided. */
@@ -673,6 +726,14 @@ inline Number Vector::SumLogs() const
    return cached_sumlogs_;
 }
 
+inline void Vector::SetCachedSumLogs(
+   Number sumlogs
+) const
+{
+   cached_sumlogs_ = sumlogs;
+   sumlogs_cache_tag_ = GetTag();
+}
+
 inline void Vector::ElementWiseSgn()
 {
    ElementWiseSgnImpl();
@@ -823,6 +884,30 @@ inline void Vector::AddVectorQuotient(
    ObjectChanged();
 }
 
+inline void Vector::AddVectorProduct(
+   Number        a,
+   const Vector& v1,
+   Number        b,
+   const Vector& v2,
+   const Vector& w,
+   Number        c
+)
+{
+   AddVectorProductImpl(a, v1, b, v2, w, c);
+   ObjectChanged();
+}
+
+inline Number Vector::AxpyDot(
+   Number        alpha,
+   const Vector& x,
+   const Vector& z
+)
+{
+   Number retValue = AxpyDotImpl(alpha, x, z);
+   ObjectChanged();
+   return retValue;
+}
+
 inline bool Vector::HasValidNumbers() const
 {
    if( valid_cache_tag_ != GetTag() )
@@ -849,6 +934,14 @@ inline VectorSpace::VectorSpace(
    : dim_(dim)
 { }
 
+/** Memory held by a cached Vector, see CachedResultBytes */
+inline std::size_t CachedResultBytes(
+   const SmartPtr<const Vector>& result
+)
+{
+   return IsValid(result) ? (std::size_t) result->Dim() * sizeof(Number) : 0;
+}
+
 } // namespace Ipopt
 
 // Macro definitions for debugging vectors
@@ -7,21 +7,246 @@
 #include "IpGenTMatrix.hpp"
 #include "IpDenseVector.hpp"
 #include "IpBlas.hpp"
+#include "IpAlignedMemory.hpp"
 
 #include <cmath>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Matrix-vector products and row or column maxima of matrices that
+ *  have at least this number of nonzeros are computed by several
+ *  threads if Ipopt has been compiled with OpenMP support.
+ */
+#ifndef IPOPT_TMATRIX_PARALLEL_MIN_NONZEROS
+#define IPOPT_TMATRIX_PARALLEL_MIN_NONZEROS 100000
+#endif
+
 namespace Ipopt
 {
 
+/** Number of threads to be used for a matrix-vector product or the
+ *  row or column maxima of a matrix with nnz nonzeros.
+ *
+ *  This is 1 if Ipopt has not been compiled with OpenMP support, if
+ *  nnz is small, or if we are already inside a parallel region.
+ */
+static inline int MatVecThreads(
+   Index nnz
+)
+{
+#ifdef _OPENMP
+   if( nnz >= IPOPT_TMATRIX_PARALLEL_MIN_NONZEROS && !omp_in_parallel() )
+   {
+      return omp_get_max_threads();
+   }
+#else
+   (void) nnz;
+#endif
+   return 1;
+}
+
+/** Sort the nonzeros of a triplet matrix by key.
+ *
+ *  On return, the elements with key k (counting starts at 1) are
+ *  elems[start[k-1]], ..., elems[start[k]-1], in increasing order, and
+ *  others[p] is other[elems[p]]-1.
+ */
+static void CompressIndex(
+   Index               nkeys,
+   Index               nnz,
+   const Index*        key,
+   const Index*        other,
+   std::vector<Index>& start,
+   std::vector<Index>& elems,
+   std::vector<Index>& others
+)
+{
+   start.assign(nkeys + 1, 0);
+   for( Index i = 0; i < nnz; i++ )
+   {
+      start[key[i]]++;
+   }
+   for( Index k = 0; k < nkeys; k++ )
+   {
+      start[k + 1] += start[k];
+   }
+
+   elems.resize(nnz);
+   others.resize(nnz);
+   std::vector<Index> pos(start.begin(), start.end() - 1);
+   for( Index i = 0; i < nnz; i++ )
+   {
+      Index p = pos[key[i] - 1]++;
+      elems[p] = i;
+      others[p] = other[i] - 1;
+   }
+}
+
+/** Compute y += alpha*A*x row by row, based on the compressed index of
+ *  the rows of A.
+ *
+ *  The elements of each row are added in the order of the triplet
+ *  arrays, which gives the same result as the loop over the triplets.
+ *  If xvals is NULL, x is homogeneous with value as/alpha.
+ *  T is the type in which the values of A are stored.
+ */
+template<typename T>
+static void CompressedMultVector(
+   int                       nthreads,
+   Index                     nrows,
+   const std::vector<Index>& start,
+   const std::vector<Index>& elems,
+   const std::vector<Index>& cols,
+   const T*                  val,
+   Number                    alpha,
+   Number                    as,
+   const Number*             xvals,
+   Number*                   yvals
+)
+{
+   const Index* pstart = &start[0];
+   const Index* pelems = elems.empty() ? NULL : &elems[0];
+   const Index* pcols = cols.empty() ? NULL : &cols[0];
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(guided) num_threads(nthreads)
+#else
+   (void) nthreads;
+#endif
+   for( Index i = 0; i < nrows; i++ )
+   {
+      Number yi = yvals[i];
+      if( xvals == NULL )
+      {
+         for( Index p = pstart[i]; p < pstart[i + 1]; p++ )
+         {
+            yi += as * val[pelems[p]];
+         }
+      }
+      else
+      {
+         for( Index p = pstart[i]; p < pstart[i + 1]; p++ )
+         {
+            yi += alpha * val[pelems[p]] * xvals[pcols[p]];
+         }
+      }
+      yvals[i] = yi;
+   }
+}
+
+/** Compute y += alpha*A*x, or y += alpha*A^T*x with the roles of the
+ *  row and column indices exchanged, by a loop over the triplets.
+ *
+ *  If xvals is NULL, x is homogeneous with value as/alpha.
+ *  T is the type in which the values of A are stored.
+ */
+template<typename T>
+static void TripletMultVector(
+   Index         nnz,
+   const Index*  yidx,
+   const Index*  xidx,
+   const T*      val,
+   Number        alpha,
+   Number        as,
+   const Number* xvals,
+   Number*       yvals
+)
+{
+   yvals--;
+   if( xvals == NULL )
+   {
+      for( Index i = 0; i < nnz; i++ )
+      {
+         yvals[*yidx] += as * (*val);
+         val++;
+         yidx++;
+      }
+   }
+   else
+   {
+      xvals--;
+      for( Index i = 0; i < nnz; i++ )
+      {
+         yvals[*yidx] += alpha * (*val) * xvals[*xidx];
+         val++;
+         yidx++;
+         xidx++;
+      }
+   }
+}
+
+/** Compute the maximal absolute value of A in each row (or column, if
+ *  idx are the column indices).
+ */
+template<typename T>
+static void TripletAMax(
+   Index        nnz,
+   const Index* idx,
+   const T*     val,
+   Number*      vec_vals
+)
+{
+   vec_vals--;
+   for( Index i = 0; i < nnz; i++ )
+   {
+      vec_vals[idx[i]] = Max(vec_vals[idx[i]], fabs((Number) val[i]));
+   }
+}
+
+/** Compute the maximal absolute value of A in each row (or column)
+ *  based on the compressed index of the rows (or columns) of A.
+ *
+ *  Each thread handles a set of rows, so no thread writes to an entry
+ *  of vec_vals that is used by another thread.
+ */
+template<typename T>
+static void CompressedAMax(
+   int                       nthreads,
+   Index                     nkeys,
+   const std::vector<Index>& start,
+   const std::vector<Index>& elems,
+   const T*                  val,
+   Number*                   vec_vals
+)
+{
+   const Index* pstart = &start[0];
+   const Index* pelems = elems.empty() ? NULL : &elems[0];
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(guided) num_threads(nthreads)
+#else
+   (void) nthreads;
+#endif
+   for( Index k = 0; k < nkeys; k++ )
+   {
+      Number amax = vec_vals[k];
+      for( Index p = pstart[k]; p < pstart[k + 1]; p++ )
+      {
+         amax = Max(amax, fabs((Number) val[pelems[p]]));
+      }
+      vec_vals[k] = amax;
+   }
+}
+
 GenTMatrix::GenTMatrix(
    const GenTMatrixSpace* owner_space
 )
    : Matrix(owner_space),
      owner_space_(owner_space),
      values_(NULL),
+     svalues_(NULL),
+     values_pending_(false),
      initialized_(false)
 {
-   values_ = owner_space_->AllocateInternalStorage();
+   if( owner_space_->SinglePrecision() )
+   {
+      svalues_ = new float[Nonzeros()];
+      owner_space_->memory_account_.Allocate(Nonzeros() * sizeof(float));
+   }
+   else
+   {
+      values_ = owner_space_->AllocateInternalStorage();
+   }
 
    if( Nonzeros() == 0 )
    {
@@ -32,17 +257,107 @@ GenTMatrix::GenTMatrix(
 GenTMatrix::~GenTMatrix()
 {
    owner_space_->FreeInternalStorage(values_);
+   if( svalues_ != NULL )
+   {
+      delete[] svalues_;
+      owner_space_->memory_account_.Free(Nonzeros() * sizeof(float));
+   }
 }
 
 void GenTMatrix::SetValues(
    const Number* Values
 )
 {
-   IpBlasDcopy(Nonzeros(), Values, 1, values_, 1);
+   if( svalues_ != NULL )
+   {
+      owner_space_->FreeInternalStorage(values_);
+      values_ = NULL;
+      values_pending_ = false;
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         svalues_[i] = (float) Values[i];
+      }
+   }
+   else
+   {
+      IpBlasDcopy(Nonzeros(), Values, 1, values_, 1);
+   }
    initialized_ = true;
    ObjectChanged();
 }
 
+const Number* GenTMatrix::Values() const
+{
+   if( svalues_ != NULL )
+   {
+      StoreSingleValues();
+      if( values_ == NULL )
+      {
+         values_ = owner_space_->AllocateInternalStorage();
+         for( Index i = 0; i < Nonzeros(); i++ )
+         {
+            values_[i] = svalues_[i];
+         }
+      }
+   }
+   return values_;
+}
+
+Number* GenTMatrix::Values()
+{
+   if( svalues_ != NULL )
+   {
+      if( values_ == NULL )
+      {
+         values_ = owner_space_->AllocateInternalStorage();
+         if( initialized_ )
+         {
+            for( Index i = 0; i < Nonzeros(); i++ )
+            {
+               values_[i] = svalues_[i];
+            }
+         }
+      }
+      values_pending_ = true;
+   }
+   ObjectChanged();
+   initialized_ = true;
+   return values_;
+}
+
+void GenTMatrix::FillValues(
+   Number* Values
+) const
+{
+   DBG_ASSERT(initialized_);
+   if( svalues_ != NULL )
+   {
+      StoreSingleValues();
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         Values[i] = svalues_[i];
+      }
+   }
+   else
+   {
+      IpBlasDcopy(Nonzeros(), values_, 1, Values, 1);
+   }
+}
+
+void GenTMatrix::StoreSingleValues() const
+{
+   if( values_pending_ )
+   {
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         svalues_[i] = (float) values_[i];
+      }
+      owner_space_->FreeInternalStorage(values_);
+      values_ = NULL;
+      values_pending_ = false;
+   }
+}
+
 void GenTMatrix::MultVectorImpl(
    Number        alpha,
    const Vector& x,
@@ -73,32 +388,33 @@ void GenTMatrix::MultVectorImpl(
 
    if( dense_x && dense_y )
    {
-      const Index* irows = Irows();
-      const Index* jcols = Jcols();
-      const Number* val = values_;
+      StoreSingleValues();
+      Number as = dense_x->IsHomogeneous() ? alpha * dense_x->Scalar() : 0.;
+      const Number* xvals = dense_x->IsHomogeneous() ? NULL : dense_x->Values();
       Number* yvals = dense_y->Values();
-      yvals--;
-      if( dense_x->IsHomogeneous() )
+
+      int nthreads = MatVecThreads(Nonzeros());
+      if( nthreads > 1 )
       {
-         Number as = alpha * dense_x->Scalar();
-         for( Index i = 0; i < Nonzeros(); i++ )
+         owner_space_->InitializeRowIndex();
+         if( svalues_ != NULL )
+         {
+            CompressedMultVector(nthreads, NRows(), owner_space_->row_start_, owner_space_->row_elems_,
+                                 owner_space_->row_cols_, svalues_, alpha, as, xvals, yvals);
+         }
+         else
          {
-            yvals[*irows] += as * (*val);
-            val++;
-            irows++;
+            CompressedMultVector(nthreads, NRows(), owner_space_->row_start_, owner_space_->row_elems_,
+                                 owner_space_->row_cols_, values_, alpha, as, xvals, yvals);
          }
       }
+      else if( svalues_ != NULL )
+      {
+         TripletMultVector(Nonzeros(), Irows(), Jcols(), svalues_, alpha, as, xvals, yvals);
+      }
       else
       {
-         const Number* xvals = dense_x->Values();
-         xvals--;
-         for( Index i = 0; i < Nonzeros(); i++ )
-         {
-            yvals[*irows] += alpha * (*val) * xvals[*jcols];
-            val++;
-            irows++;
-            jcols++;
-         }
+         TripletMultVector(Nonzeros(), Irows(), Jcols(), values_, alpha, as, xvals, yvals);
       }
    }
 }
@@ -133,33 +449,33 @@ void GenTMatrix::TransMultVectorImpl(
 
    if( dense_x && dense_y )
    {
-      const Index* irows = Irows();
-      const Index* jcols = Jcols();
-      const Number* val = values_;
+      StoreSingleValues();
+      Number as = dense_x->IsHomogeneous() ? alpha * dense_x->Scalar() : 0.;
+      const Number* xvals = dense_x->IsHomogeneous() ? NULL : dense_x->Values();
       Number* yvals = dense_y->Values();
-      yvals--;
 
-      if( dense_x->IsHomogeneous() )
+      int nthreads = MatVecThreads(Nonzeros());
+      if( nthreads > 1 )
       {
-         Number as = alpha * dense_x->Scalar();
-         for( Index i = 0; i < Nonzeros(); i++ )
+         owner_space_->InitializeColIndex();
+         if( svalues_ != NULL )
          {
-            yvals[*jcols] += as * (*val);
-            val++;
-            jcols++;
+            CompressedMultVector(nthreads, NCols(), owner_space_->col_start_, owner_space_->col_elems_,
+                                 owner_space_->col_rows_, svalues_, alpha, as, xvals, yvals);
+         }
+         else
+         {
+            CompressedMultVector(nthreads, NCols(), owner_space_->col_start_, owner_space_->col_elems_,
+                                 owner_space_->col_rows_, values_, alpha, as, xvals, yvals);
          }
       }
+      else if( svalues_ != NULL )
+      {
+         TripletMultVector(Nonzeros(), Jcols(), Irows(), svalues_, alpha, as, xvals, yvals);
+      }
       else
       {
-         const Number* xvals = dense_x->Values();
-         xvals--;
-         for( Index i = 0; i < Nonzeros(); i++ )
-         {
-            yvals[*jcols] += alpha * (*val) * xvals[*irows];
-            val++;
-            irows++;
-            jcols++;
-         }
+         TripletMultVector(Nonzeros(), Jcols(), Irows(), values_, alpha, as, xvals, yvals);
       }
    }
 }
@@ -167,6 +483,16 @@ void GenTMatrix::TransMultVectorImpl(
 bool GenTMatrix::HasValidNumbersImpl() const
 {
    DBG_ASSERT(initialized_);
+   if( svalues_ != NULL )
+   {
+      StoreSingleValues();
+      Number sum = 0.;
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         sum += fabs((Number) svalues_[i]);
+      }
+      return IsFiniteNumber(sum);
+   }
    Number sum = IpBlasDasum(Nonzeros(), values_, 1);
    return IsFiniteNumber(sum);
 }
@@ -181,14 +507,29 @@ void GenTMatrix::ComputeRowAMaxImpl(
    DenseVector* dense_vec = static_cast<DenseVector*>(&rows_norms);
    DBG_ASSERT(dynamic_cast<DenseVector*>(&rows_norms));
 
-   const Index* irows = Irows();
-   const Number* val = values_;
-   Number* vec_vals = dense_vec->Values();
-   vec_vals--;
-
-   for( Index i = 0; i < Nonzeros(); i++ )
+   StoreSingleValues();
+   int nthreads = MatVecThreads(Nonzeros());
+   if( nthreads > 1 )
    {
-      vec_vals[irows[i]] = Max(vec_vals[irows[i]], fabs(val[i]));
+      owner_space_->InitializeRowIndex();
+      if( svalues_ != NULL )
+      {
+         CompressedAMax(nthreads, NRows(), owner_space_->row_start_, owner_space_->row_elems_, svalues_,
+                        dense_vec->Values());
+      }
+      else
+      {
+         CompressedAMax(nthreads, NRows(), owner_space_->row_start_, owner_space_->row_elems_, values_,
+                        dense_vec->Values());
+      }
+   }
+   else if( svalues_ != NULL )
+   {
+      TripletAMax(Nonzeros(), Irows(), svalues_, dense_vec->Values());
+   }
+   else
+   {
+      TripletAMax(Nonzeros(), Irows(), values_, dense_vec->Values());
    }
 }
 
@@ -202,14 +543,29 @@ void GenTMatrix::ComputeColAMaxImpl(
    DenseVector* dense_vec = static_cast<DenseVector*>(&cols_norms);
    DBG_ASSERT(dynamic_cast<DenseVector*>(&cols_norms));
 
-   const Index* jcols = Jcols();
-   const Number* val = values_;
-   Number* vec_vals = dense_vec->Values();
-   vec_vals--;
-
-   for( Index i = 0; i < Nonzeros(); i++ )
+   StoreSingleValues();
+   int nthreads = MatVecThreads(Nonzeros());
+   if( nthreads > 1 )
+   {
+      owner_space_->InitializeColIndex();
+      if( svalues_ != NULL )
+      {
+         CompressedAMax(nthreads, NCols(), owner_space_->col_start_, owner_space_->col_elems_, svalues_,
+                        dense_vec->Values());
+      }
+      else
+      {
+         CompressedAMax(nthreads, NCols(), owner_space_->col_start_, owner_space_->col_elems_, values_,
+                        dense_vec->Values());
+      }
+   }
+   else if( svalues_ != NULL )
+   {
+      TripletAMax(Nonzeros(), Jcols(), svalues_, dense_vec->Values());
+   }
+   else
    {
-      vec_vals[jcols[i]] = Max(vec_vals[jcols[i]], fabs(val[i]));
+      TripletAMax(Nonzeros(), Jcols(), values_, dense_vec->Values());
    }
 }
 
@@ -226,14 +582,16 @@ void GenTMatrix::PrintImplOffset(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sGenTMatrix \"%s\" of dimension %d by %d with %d nonzero elements:\n", prefix.c_str(), name.c_str(), NRows(),
+                        "%sGenTMatrix \"%s\" of dimension %" IPOPT_INDEX_FORMAT " by %" IPOPT_INDEX_FORMAT " with %" IPOPT_INDEX_FORMAT " nonzero elements:\n", prefix.c_str(), name.c_str(), NRows(),
                         NCols(), Nonzeros());
    if( initialized_ )
    {
+      StoreSingleValues();
       for( Index i = 0; i < Nonzeros(); i++ )
       {
          jnlst.PrintfIndented(level, category, indent,
-                              "%s%s[%5d,%5d]=%23.16e  (%d)\n", prefix.c_str(), name.c_str(), Irows()[i] + offset, Jcols()[i], values_[i], i);
+                              "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e  (%" IPOPT_INDEX_FORMAT ")\n", prefix.c_str(), name.c_str(), Irows()[i] + offset, Jcols()[i],
+                              svalues_ != NULL ? (Number) svalues_[i] : values_[i], i);
       }
    }
    else
@@ -248,12 +606,17 @@ GenTMatrixSpace::GenTMatrixSpace(
    Index        nCols,
    Index        nonZeros,
    const Index* iRows,
-   const Index* jCols
+   const Index* jCols,
+   bool         single_precision,
+   bool         use_huge_pages
 )
    : MatrixSpace(nRows, nCols),
      nonZeros_(nonZeros),
      jCols_(NULL),
-     iRows_(NULL)
+     iRows_(NULL),
+     single_precision_(single_precision),
+     use_huge_pages_(use_huge_pages),
+     memory_account_(MemoryStatistics::TRIPLET_MATRIX_VALUES)
 {
    iRows_ = new Index[nonZeros];
    jCols_ = new Index[nonZeros];
@@ -266,14 +629,50 @@ GenTMatrixSpace::GenTMatrixSpace(
 
 Number* GenTMatrixSpace::AllocateInternalStorage() const
 {
-   return new Number[Nonzeros()];
+   memory_account_.Allocate(Nonzeros() * sizeof(Number));
+   Number* values = AllocateAlignedNumbers(Nonzeros(), use_huge_pages_);
+
+   // Touch the pages first by the threads of the matrix-vector
+   // products, so that they are spread over the NUMA nodes of these threads
+   const int nthreads = MatVecThreads(Nonzeros());
+   if( nthreads > 1 )
+   {
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(static) num_threads(nthreads)
+#endif
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         values[i] = 0.;
+      }
+   }
+   return values;
+}
+
+void GenTMatrixSpace::InitializeRowIndex() const
+{
+   if( row_start_.empty() )
+   {
+      CompressIndex(NRows(), nonZeros_, iRows_, jCols_, row_start_, row_elems_, row_cols_);
+   }
+}
+
+void GenTMatrixSpace::InitializeColIndex() const
+{
+   if( col_start_.empty() )
+   {
+      CompressIndex(NCols(), nonZeros_, jCols_, iRows_, col_start_, col_elems_, col_rows_);
+   }
 }
 
 void GenTMatrixSpace::FreeInternalStorage(
    Number* values
 ) const
 {
-   delete[] values;
+   if( values != NULL )
+   {
+      FreeAlignedNumbers(values);
+      memory_account_.Free(Nonzeros() * sizeof(Number));
+   }
 }
 
 } // namespace Ipopt
@@ -9,6 +9,9 @@
 
 #include "IpUtils.hpp"
 #include "IpMatrix.hpp"
+#include "IpMemoryStatistics.hpp"
+
+#include <vector>
 
 namespace Ipopt
 {
@@ -71,23 +74,33 @@ public:
    /** Array with Column indices (counting starts at 1) */
    const Index* Jcols() const;
 
-   /** Array with nonzero values (const version).  */
-   const Number* Values() const
-   {
-      return values_;
-   }
+   /** Array with nonzero values (const version).
+    *
+    *  If the values are stored in single precision, this expands them
+    *  into a temporary double precision array, which is kept until the
+    *  values are changed.
+    */
+   const Number* Values() const;
 
    /** Array with the nonzero values of this matrix (non-const version).
     *
     *  Use this method only if you are intending to change
     *  the values, because the GenTMatrix will be marked as changed.
+    *
+    *  If the values are stored in single precision, the returned array
+    *  is a temporary double precision copy, which is rounded into the
+    *  single precision storage at the next read access to the matrix.
+    *  The pointer is valid only until then.
     */
-   Number* Values()
-   {
-      ObjectChanged();
-      initialized_ = true;
-      return values_;
-   }
+   Number* Values();
+   ///@}
+
+   /**@name Methods for providing copy of the matrix data */
+   ///@{
+   /** Copy the value data into provided space */
+   void FillValues(
+      Number* Values
+   ) const;
    ///@}
 
 protected:
@@ -173,12 +186,26 @@ private:
     */
    const GenTMatrixSpace* owner_space_;
 
-   /** Values of nonzeros */
-   Number* values_;
+   /** Values of nonzeros.
+    *
+    *  If the values are stored in single precision, this is NULL or a
+    *  temporary copy of the values.
+    */
+   mutable Number* values_;
+
+   /** Values of nonzeros in single precision, NULL if they are stored in double precision */
+   float* svalues_;
+
+   /** Whether values_ has been handed out for changes and not yet rounded into svalues_ */
+   mutable bool values_pending_;
 
    /** Flag for Initialization */
    bool initialized_;
 
+   /** Round changed values from values_ into svalues_ and free values_,
+    *  if the values are stored in single precision.
+    */
+   void StoreSingleValues() const;
 };
 
 /** This is the matrix space for a GenTMatrix with fixed sparsity structure.
@@ -198,13 +225,23 @@ public:
     *  i.e., iRows[i]==1 and jCols[i]==1 refers to the first element
     *  in the first row.  This is in accordance with the HSL data
     *  structure.
+    *
+    *  If single_precision is true, the matrices of this space store
+    *  their values as float, which halves the memory for the values,
+    *  but keeps only about 7 significant digits.  Products with the
+    *  matrices are still computed in double precision.
+    *
+    *  If use_huge_pages is true, transparent huge pages are requested
+    *  for the values of large matrices (see AllocateAlignedNumbers).
     */
    GenTMatrixSpace(
       Index        nRows,
       Index        nCols,
       Index        nonZeros,
       const Index* iRows,
-      const Index* jCols
+      const Index* jCols,
+      bool         single_precision = false,
+      bool         use_huge_pages = false
    );
 
    /** Destructor */
@@ -245,6 +282,18 @@ public:
    {
       return jCols_;
    }
+
+   /** Whether matrices of this space store their values in single precision */
+   bool SinglePrecision() const
+   {
+      return single_precision_;
+   }
+
+   /** Whether huge pages are requested for the values of the matrices of this space */
+   bool UseHugePages() const
+   {
+      return use_huge_pages_;
+   }
    ///@}
 
 private:
@@ -255,6 +304,39 @@ private:
    Index* iRows_;
    ///@}
 
+   /** Whether matrices of this space store their values in single precision */
+   const bool single_precision_;
+
+   /** Whether huge pages are requested for the values of the matrices of this space */
+   const bool use_huge_pages_;
+
+   /** Memory of the values of the matrices of this space */
+   MemoryAccount memory_account_;
+
+   /** @name Compressed copies of the sparsity structure.
+    *
+    *  These are set up at the first parallel matrix-vector product
+    *  with a matrix of this space.  For each row (column), the
+    *  positions of its elements in the triplet arrays are stored in
+    *  increasing order, together with the (0-based) column (row)
+    *  index of each element, so that the products can be computed
+    *  row by row (column by column) without conflicting writes.
+    */
+   ///@{
+   mutable std::vector<Index> row_start_;
+   mutable std::vector<Index> row_elems_;
+   mutable std::vector<Index> row_cols_;
+   mutable std::vector<Index> col_start_;
+   mutable std::vector<Index> col_elems_;
+   mutable std::vector<Index> col_rows_;
+   ///@}
+
+   /** Set up row_start_, row_elems_, and row_cols_, if not done yet */
+   void InitializeRowIndex() const;
+
+   /** Set up col_start_, col_elems_, and col_rows_, if not done yet */
+   void InitializeColIndex() const;
+
    /** This method is only for the GenTMatrix to call in order
     *  to allocate internal storage
     */
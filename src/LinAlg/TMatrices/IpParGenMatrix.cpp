@@ -0,0 +1,202 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#include "IpoptConfig.h"
+#include "IpParGenMatrix.hpp"
+
+#ifdef HAVE_MPI
+
+#include <vector>
+
+namespace Ipopt
+{
+
+ParGenMatrix::ParGenMatrix(
+   const ParGenMatrixSpace* owner_space
+)
+   : Matrix(owner_space),
+     owner_space_(owner_space)
+{
+   local_matrix_ = owner_space_->LocalSpace()->MakeNewGenTMatrix();
+}
+
+ParGenMatrix::~ParGenMatrix()
+{ }
+
+void ParGenMatrix::SetValues(
+   const Number* Values
+)
+{
+   local_matrix_->SetValues(Values);
+   ObjectChanged();
+}
+
+void ParGenMatrix::MultVectorImpl(
+   Number        alpha,
+   const Vector& x,
+   Number        beta,
+   Vector&       y
+) const
+{
+   DBG_ASSERT(NCols() == x.Dim());
+   DBG_ASSERT(NRows() == y.Dim());
+
+   ParVector* par_y = static_cast<ParVector*>(&y);
+   DBG_ASSERT(dynamic_cast<ParVector*>(&y));
+
+   // collect a distributed x on all processes
+   const DenseVector* dense_x;
+   SmartPtr<DenseVector> gathered_x;
+   const ParVector* par_x = dynamic_cast<const ParVector*>(&x);
+   if( par_x != NULL )
+   {
+      gathered_x = owner_space_->ColsSpace()->MakeNewDenseVector();
+      par_x->GetGlobalValues(gathered_x->Values());
+      dense_x = GetRawPtr(gathered_x);
+   }
+   else
+   {
+      dense_x = static_cast<const DenseVector*>(&x);
+      DBG_ASSERT(dynamic_cast<const DenseVector*>(&x));
+   }
+
+   local_matrix_->MultVector(alpha, *dense_x, beta, *par_y->LocalVector());
+}
+
+void ParGenMatrix::TransMultVectorImpl(
+   Number        alpha,
+   const Vector& x,
+   Number        beta,
+   Vector&       y
+) const
+{
+   DBG_ASSERT(NCols() == y.Dim());
+   DBG_ASSERT(NRows() == x.Dim());
+
+   const ParVector* par_x = static_cast<const ParVector*>(&x);
+   DBG_ASSERT(dynamic_cast<const ParVector*>(&x));
+
+   // contribution of the local rows to all columns
+   SmartPtr<DenseVector> contrib = owner_space_->ColsSpace()->MakeNewDenseVector();
+   local_matrix_->TransMultVector(1., *par_x->LocalVector(), 0., *contrib);
+   Number* contrib_vals = contrib->Values();
+
+   MPI_Comm comm = owner_space_->RowsSpace()->Comm();
+   SmartPtr<DenseVector> sum;
+   DenseVector* dense_y;
+   ParVector* par_y = dynamic_cast<ParVector*>(&y);
+   if( par_y != NULL )
+   {
+      // each process only needs the sum for its own columns
+      SmartPtr<const ParVectorSpace> y_space = par_y->OwnerParVectorSpace();
+      sum = y_space->LocalSpace()->MakeNewDenseVector();
+      MPI_Reduce_scatter(contrib_vals, sum->Values(), const_cast<int*>(&y_space->LocalSizes()[0]), MPI_DOUBLE, MPI_SUM,
+                         comm);
+      dense_y = GetRawPtr(par_y->LocalVector());
+   }
+   else
+   {
+      MPI_Allreduce(MPI_IN_PLACE, contrib_vals, NCols(), MPI_DOUBLE, MPI_SUM, comm);
+      sum = contrib;
+      dense_y = static_cast<DenseVector*>(&y);
+      DBG_ASSERT(dynamic_cast<DenseVector*>(&y));
+   }
+
+   if( beta != 0.0 )
+   {
+      dense_y->Scal(beta);
+   }
+   else
+   {
+      dense_y->Set(0.0);  // In case y hasn't been initialized yet
+   }
+   dense_y->Axpy(alpha, *sum);
+}
+
+bool ParGenMatrix::HasValidNumbersImpl() const
+{
+   int local_valid = local_matrix_->HasValidNumbers() ? 1 : 0;
+   int global_valid;
+   MPI_Allreduce(&local_valid, &global_valid, 1, MPI_INT, MPI_MIN, owner_space_->RowsSpace()->Comm());
+   return global_valid != 0;
+}
+
+void ParGenMatrix::ComputeRowAMaxImpl(
+   Vector& rows_norms,
+   bool    /*init*/
+) const
+{
+   ParVector* par_vec = static_cast<ParVector*>(&rows_norms);
+   DBG_ASSERT(dynamic_cast<ParVector*>(&rows_norms));
+
+   local_matrix_->ComputeRowAMax(*par_vec->LocalVector(), false);
+}
+
+void ParGenMatrix::ComputeColAMaxImpl(
+   Vector& cols_norms,
+   bool    /*init*/
+) const
+{
+   SmartPtr<DenseVector> local_amax = owner_space_->ColsSpace()->MakeNewDenseVector();
+   local_matrix_->ComputeColAMax(*local_amax, true);
+   Number* amax_vals = local_amax->Values();
+   MPI_Allreduce(MPI_IN_PLACE, amax_vals, NCols(), MPI_DOUBLE, MPI_MAX, owner_space_->RowsSpace()->Comm());
+
+   ParVector* par_vec = dynamic_cast<ParVector*>(&cols_norms);
+   if( par_vec != NULL )
+   {
+      SmartPtr<const ParVectorSpace> vec_space = par_vec->OwnerParVectorSpace();
+      SmartPtr<DenseVector> own_amax = vec_space->LocalSpace()->MakeNewDenseVector(amax_vals + vec_space->StartPos(),
+                                       GetRawPtr(local_amax));
+      par_vec->LocalVector()->ElementWiseMax(*own_amax);
+   }
+   else
+   {
+      DBG_ASSERT(dynamic_cast<DenseVector*>(&cols_norms));
+      cols_norms.ElementWiseMax(*local_amax);
+   }
+}
+
+void ParGenMatrix::PrintImpl(
+   const Journalist&  jnlst,
+   EJournalLevel      level,
+   EJournalCategory   category,
+   const std::string& name,
+   Index              indent,
+   const std::string& prefix
+) const
+{
+   SmartPtr<const ParVectorSpace> rows_space = owner_space_->RowsSpace();
+   jnlst.PrintfIndented(level, category, indent,
+                        "%sParGenMatrix \"%s\" of dimension %" IPOPT_INDEX_FORMAT " by %" IPOPT_INDEX_FORMAT ", rows %" IPOPT_INDEX_FORMAT " to %" IPOPT_INDEX_FORMAT " on process %d of %d:\n", prefix.c_str(),
+                        name.c_str(), NRows(), NCols(), rows_space->StartPos() + 1, rows_space->EndPos(), rows_space->Rank(),
+                        rows_space->NumProc());
+   local_matrix_->PrintImplOffset(jnlst, level, category, name, indent + 1, prefix, rows_space->StartPos());
+}
+
+ParGenMatrixSpace::ParGenMatrixSpace(
+   SmartPtr<const ParVectorSpace> rows_space,
+   Index                          nCols,
+   Index                          nonZeros,
+   const Index*                   iRows,
+   const Index*                   jCols
+)
+   : MatrixSpace(rows_space->Dim(), nCols),
+     rows_space_(rows_space)
+{
+   std::vector<Index> local_rows(nonZeros);
+   for( Index i = 0; i < nonZeros; i++ )
+   {
+      ASSERT_EXCEPTION(iRows[i] > rows_space_->StartPos() && iRows[i] <= rows_space_->EndPos(),
+                       INVALID_PARGENMATRIX_STRUCTURE, "A nonzero is not in a row of this process.");
+      local_rows[i] = iRows[i] - rows_space_->StartPos();
+   }
+   local_space_ = new GenTMatrixSpace(rows_space_->LocalSize(), nCols, nonZeros, nonZeros > 0 ? &local_rows[0] : NULL,
+                                      jCols);
+   cols_space_ = new DenseVectorSpace(nCols);
+}
+
+} // namespace Ipopt
+
+#endif // HAVE_MPI
@@ -0,0 +1,248 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+#ifndef __IPPARGENMATRIX_HPP__
+#define __IPPARGENMATRIX_HPP__
+
+#include "IpUtils.hpp"
+#include "IpGenTMatrix.hpp"
+#include "IpParVector.hpp"
+
+#ifdef HAVE_MPI
+
+namespace Ipopt
+{
+
+/* forward declarations */
+class ParGenMatrixSpace;
+
+/** @name Exceptions */
+///@{
+DECLARE_STD_EXCEPTION(INVALID_PARGENMATRIX_STRUCTURE);
+///@}
+
+/** Class for general matrices in triplet format whose rows are
+ *  distributed over the processes of an MPI communicator.
+ *
+ *  The rows are distributed as the elements of a ParVectorSpace.  Each
+ *  process stores the nonzeros of its rows in a GenTMatrix, the local
+ *  matrix, whose row indices are relative to the first row of the
+ *  process.  The columns are not distributed.
+ *
+ *  In a product with the matrix, x can be a ParVector (which is then
+ *  collected on all processes) or a DenseVector that has the same
+ *  values on all processes, and y must be a ParVector of the row
+ *  space.  In a product with the transpose, x must be a ParVector of
+ *  the row space, and y can be a ParVector (the contributions of the
+ *  processes are then reduced and scattered) or a DenseVector (which
+ *  obtains the same values on all processes).  The products are
+ *  collective operations.
+ */
+class IPOPTLIB_EXPORT ParGenMatrix: public Matrix
+{
+public:
+   /**@name Constructors / Destructors */
+   ///@{
+   /** Constructor, taking the owner_space. */
+   ParGenMatrix(
+      const ParGenMatrixSpace* owner_space
+   );
+
+   /** Destructor */
+   ~ParGenMatrix();
+   ///@}
+
+   /**@name Changing the Values.*/
+   ///@{
+   /** Set values of the local nonzero elements.
+    *
+    *  The order of the values corresponds to the one of the local
+    *  nonzeros given to the matrix space.
+    */
+   void SetValues(
+      const Number* Values
+   );
+   ///@}
+
+   /** @name Accessor Methods */
+   ///@{
+   /** Local part of the matrix (non-const version).
+    *
+    *  This matrix is marked as changed, so use this method only if
+    *  the local values are going to be changed.
+    */
+   SmartPtr<GenTMatrix> LocalMatrix()
+   {
+      ObjectChanged();
+      return local_matrix_;
+   }
+
+   /** Local part of the matrix (const version) */
+   SmartPtr<const GenTMatrix> LocalMatrix() const
+   {
+      return ConstPtr(local_matrix_);
+   }
+   ///@}
+
+protected:
+   /**@name Overloaded methods from Matrix base class*/
+   ///@{
+   virtual void MultVectorImpl(
+      Number        alpha,
+      const Vector& x,
+      Number        beta,
+      Vector&       y
+   ) const;
+
+   virtual void TransMultVectorImpl(
+      Number        alpha,
+      const Vector& x,
+      Number        beta,
+      Vector&       y
+   ) const;
+
+   virtual bool HasValidNumbersImpl() const;
+
+   virtual void ComputeRowAMaxImpl(
+      Vector& rows_norms,
+      bool    init
+   ) const;
+
+   virtual void ComputeColAMaxImpl(
+      Vector& cols_norms,
+      bool    init
+   ) const;
+
+   /** Print the local part of the matrix.
+    *
+    *  Each process prints its nonzeros to its own journalist, with the
+    *  row indices of the global matrix.
+    */
+   virtual void PrintImpl(
+      const Journalist&  jnlst,
+      EJournalLevel      level,
+      EJournalCategory   category,
+      const std::string& name,
+      Index              indent,
+      const std::string& prefix
+   ) const;
+   ///@}
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Default Constructor */
+   ParGenMatrix();
+
+   /** Copy Constructor */
+   ParGenMatrix(
+      const ParGenMatrix&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const ParGenMatrix&
+   );
+   ///@}
+
+   /** Copy of the owner space as a ParGenMatrixSpace instead of
+    *  a MatrixSpace
+    */
+   const ParGenMatrixSpace* owner_space_;
+
+   /** The nonzeros of the rows that are stored on this process */
+   SmartPtr<GenTMatrix> local_matrix_;
+};
+
+/** This is the matrix space for a ParGenMatrix.
+ *
+ *  It stores the distribution of the rows and the space of the local
+ *  matrices.
+ */
+class IPOPTLIB_EXPORT ParGenMatrixSpace: public MatrixSpace
+{
+public:
+   /** @name Constructors / Destructors */
+   ///@{
+   /** Constructor, given the distribution of the rows, the number of
+    *  columns, and the local nonzeros.
+    *
+    *  iRows are the row indices in the global matrix and must be rows
+    *  of this process.  As for GenTMatrixSpace, counting of rows and
+    *  columns starts at 1.
+    */
+   ParGenMatrixSpace(
+      SmartPtr<const ParVectorSpace> rows_space,
+      Index                          nCols,
+      Index                          nonZeros,
+      const Index*                   iRows,
+      const Index*                   jCols
+   );
+
+   /** Destructor */
+   ~ParGenMatrixSpace()
+   { }
+   ///@}
+
+   /** Method for creating a new matrix of this specific type. */
+   ParGenMatrix* MakeNewParGenMatrix() const
+   {
+      return new ParGenMatrix(this);
+   }
+
+   virtual Matrix* MakeNew() const
+   {
+      return MakeNewParGenMatrix();
+   }
+
+   /** @name Accessor Methods */
+   ///@{
+   /** Distribution of the rows */
+   SmartPtr<const ParVectorSpace> RowsSpace() const
+   {
+      return rows_space_;
+   }
+
+   /** Space of the local matrices */
+   SmartPtr<const GenTMatrixSpace> LocalSpace() const
+   {
+      return local_space_;
+   }
+
+   /** Space of vectors with all columns, used for the products */
+   SmartPtr<const DenseVectorSpace> ColsSpace() const
+   {
+      return cols_space_;
+   }
+
+   /** Number of local nonzeros */
+   Index Nonzeros() const
+   {
+      return local_space_->Nonzeros();
+   }
+   ///@}
+
+private:
+   /** Distribution of the rows */
+   SmartPtr<const ParVectorSpace> rows_space_;
+
+   /** Space of the local matrices */
+   SmartPtr<GenTMatrixSpace> local_space_;
+
+   /** Space of vectors with all columns */
+   SmartPtr<DenseVectorSpace> cols_space_;
+};
+
+} // namespace Ipopt
+
+#endif // HAVE_MPI
+
+#endif
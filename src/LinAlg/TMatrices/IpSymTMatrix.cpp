@@ -7,21 +7,184 @@
 #include "IpSymTMatrix.hpp"
 #include "IpDenseVector.hpp"
 #include "IpBlas.hpp"
+#include "IpAlignedMemory.hpp"
 
 #include <cmath>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Matrix-vector products with matrices that have at least this number
+ *  of nonzeros are computed by several threads if Ipopt has been
+ *  compiled with OpenMP support.
+ */
+#ifndef IPOPT_TMATRIX_PARALLEL_MIN_NONZEROS
+#define IPOPT_TMATRIX_PARALLEL_MIN_NONZEROS 100000
+#endif
+
 namespace Ipopt
 {
 
+/** Number of threads to be used for a matrix-vector product with
+ *  nnz nonzeros.
+ *
+ *  This is 1 if Ipopt has not been compiled with OpenMP support, if
+ *  nnz is small, or if we are already inside a parallel region.
+ */
+static inline int MatVecThreads(
+   Index nnz
+)
+{
+#ifdef _OPENMP
+   if( nnz >= IPOPT_TMATRIX_PARALLEL_MIN_NONZEROS && !omp_in_parallel() )
+   {
+      return omp_get_max_threads();
+   }
+#else
+   (void) nnz;
+#endif
+   return 1;
+}
+
+/** Compute y += alpha*A*x for a symmetric matrix A row by row, based
+ *  on the compressed index of the rows of A.
+ *
+ *  The elements in each row are added in the same order as in the
+ *  loop over the triplets.  If xvals is NULL, x is homogeneous with
+ *  value as/alpha.  T is the type in which the values of A are stored.
+ */
+template<typename T>
+static void CompressedMultVector(
+   int           nthreads,
+   Index         dim,
+   const Index*  start,
+   const Index*  elems,
+   const Index*  cols,
+   const T*      val,
+   Number        alpha,
+   Number        as,
+   const Number* xvals,
+   Number*       yvals
+)
+{
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(guided) num_threads(nthreads)
+#else
+   (void) nthreads;
+#endif
+   for( Index i = 0; i < dim; i++ )
+   {
+      Number yi = yvals[i];
+      if( xvals == NULL )
+      {
+         for( Index p = start[i]; p < start[i + 1]; p++ )
+         {
+            yi += as * val[elems[p]];
+         }
+      }
+      else
+      {
+         for( Index p = start[i]; p < start[i + 1]; p++ )
+         {
+            yi += alpha * val[elems[p]] * xvals[cols[p]];
+         }
+      }
+      yvals[i] = yi;
+   }
+}
+
+/** Compute y += alpha*A*x for a symmetric matrix A by a loop over the
+ *  triplets.
+ *
+ *  If xvals is NULL, x is homogeneous with value as/alpha.
+ *  T is the type in which the values of A are stored.
+ */
+template<typename T>
+static void TripletMultVector(
+   Index         nnz,
+   const Index*  irn,
+   const Index*  jcn,
+   const T*      val,
+   Number        alpha,
+   Number        as,
+   const Number* xvals,
+   Number*       yvals
+)
+{
+   if( xvals == NULL )
+   {
+      for( Index i = 0; i < nnz; i++ )
+      {
+         yvals[*irn - 1] += as * (*val);
+         if( *irn != *jcn )
+         {
+            // this is not a diagonal element
+            yvals[*jcn - 1] += as * (*val);
+         }
+         val++;
+         irn++;
+         jcn++;
+      }
+   }
+   else
+   {
+      for( Index i = 0; i < nnz; i++ )
+      {
+         yvals[*irn - 1] += alpha * (*val) * xvals[*jcn - 1];
+         if( *irn != *jcn )
+         {
+            // this is not a diagonal element
+            yvals[*jcn - 1] += alpha * (*val) * xvals[*irn - 1];
+         }
+         val++;
+         irn++;
+         jcn++;
+      }
+   }
+}
+
+/** Compute the maximal absolute value in each row of a symmetric matrix */
+template<typename T>
+static void TripletAMax(
+   Index        nnz,
+   const Index* irn,
+   const Index* jcn,
+   const T*     val,
+   Number*      vec_vals
+)
+{
+   vec_vals--;
+   for( Index i = 0; i < nnz; i++ )
+   {
+      const double f = fabs((Number) *val);
+      vec_vals[*irn] = Max(vec_vals[*irn], f);
+      vec_vals[*jcn] = Max(vec_vals[*jcn], f);
+      val++;
+      irn++;
+      jcn++;
+   }
+}
+
 SymTMatrix::SymTMatrix(
    const SymTMatrixSpace* owner_space
 )
    : SymMatrix(owner_space),
      owner_space_(owner_space),
      values_(NULL),
+     svalues_(NULL),
+     values_pending_(false),
      initialized_(false)
 {
-   values_ = owner_space_->AllocateInternalStorage();
+   if( owner_space_->SinglePrecision() )
+   {
+      svalues_ = new float[Nonzeros()];
+      owner_space_->memory_account_.Allocate(Nonzeros() * sizeof(float));
+   }
+   else
+   {
+      values_ = owner_space_->AllocateInternalStorage();
+   }
 
    if( Nonzeros() == 0 )
    {
@@ -32,17 +195,49 @@ SymTMatrix::SymTMatrix(
 SymTMatrix::~SymTMatrix()
 {
    owner_space_->FreeInternalStorage(values_);
+   if( svalues_ != NULL )
+   {
+      delete[] svalues_;
+      owner_space_->memory_account_.Free(Nonzeros() * sizeof(float));
+   }
 }
 
 void SymTMatrix::SetValues(
    const Number* Values
 )
 {
-   IpBlasDcopy(Nonzeros(), Values, 1, values_, 1);
+   if( svalues_ != NULL )
+   {
+      owner_space_->FreeInternalStorage(values_);
+      values_ = NULL;
+      values_pending_ = false;
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         svalues_[i] = (float) Values[i];
+      }
+   }
+   else
+   {
+      IpBlasDcopy(Nonzeros(), Values, 1, values_, 1);
+   }
    initialized_ = true;
    ObjectChanged();
 }
 
+void SymTMatrix::StoreSingleValues() const
+{
+   if( values_pending_ )
+   {
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         svalues_[i] = (float) values_[i];
+      }
+      owner_space_->FreeInternalStorage(values_);
+      values_ = NULL;
+      values_pending_ = false;
+   }
+}
+
 void SymTMatrix::MultVectorImpl(
    Number        alpha,
    const Vector& x,
@@ -73,42 +268,36 @@ void SymTMatrix::MultVectorImpl(
 
    if( dense_x && dense_y )
    {
-      const Index* irn = Irows();
-      const Index* jcn = Jcols();
-      const Number* val = values_;
+      StoreSingleValues();
+      Number as = dense_x->IsHomogeneous() ? alpha * dense_x->Scalar() : 0.;
+      const Number* xvals = dense_x->IsHomogeneous() ? NULL : dense_x->Values();
       Number* yvals = dense_y->Values();
 
-      if( dense_x->IsHomogeneous() )
+      int nthreads = MatVecThreads(Nonzeros());
+      if( nthreads > 1 )
       {
-         Number as = alpha * dense_x->Scalar();
-         for( Index i = 0; i < Nonzeros(); i++ )
+         // compute the product row by row; the elements in each row
+         // are added in the same order as in the loop over the triplets
+         owner_space_->InitializeRowIndex();
+         const Index* start = &owner_space_->row_start_[0];
+         const Index* elems = &owner_space_->row_elems_[0];
+         const Index* cols = &owner_space_->row_cols_[0];
+         if( svalues_ != NULL )
          {
-            yvals[*irn - 1] += as * (*val);
-            if( *irn != *jcn )
-            {
-               // this is not a diagonal element
-               yvals[*jcn - 1] += as * (*val);
-            }
-            val++;
-            irn++;
-            jcn++;
+            CompressedMultVector(nthreads, Dim(), start, elems, cols, svalues_, alpha, as, xvals, yvals);
+         }
+         else
+         {
+            CompressedMultVector(nthreads, Dim(), start, elems, cols, values_, alpha, as, xvals, yvals);
          }
       }
+      else if( svalues_ != NULL )
+      {
+         TripletMultVector(Nonzeros(), Irows(), Jcols(), svalues_, alpha, as, xvals, yvals);
+      }
       else
       {
-         const Number* xvals = dense_x->Values();
-         for( Index i = 0; i < Nonzeros(); i++ )
-         {
-            yvals[*irn - 1] += alpha * (*val) * xvals[*jcn - 1];
-            if( *irn != *jcn )
-            {
-               // this is not a diagonal element
-               yvals[*jcn - 1] += alpha * (*val) * xvals[*irn - 1];
-            }
-            val++;
-            irn++;
-            jcn++;
-         }
+         TripletMultVector(Nonzeros(), Irows(), Jcols(), values_, alpha, as, xvals, yvals);
       }
    }
 }
@@ -122,6 +311,21 @@ Number* SymTMatrix::Values()
    // Here we assume that every time someone requests this direct raw
    // pointer, the data is going to change and the Tag for this
    // vector has to be updated.
+   if( svalues_ != NULL )
+   {
+      if( values_ == NULL )
+      {
+         values_ = owner_space_->AllocateInternalStorage();
+         if( initialized_ )
+         {
+            for( Index i = 0; i < Nonzeros(); i++ )
+            {
+               values_[i] = svalues_[i];
+            }
+         }
+      }
+      values_pending_ = true;
+   }
    ObjectChanged();
    initialized_ = true;
    return values_;
@@ -130,6 +334,18 @@ Number* SymTMatrix::Values()
 const Number* SymTMatrix::Values() const
 {
    DBG_ASSERT(initialized_);
+   if( svalues_ != NULL )
+   {
+      StoreSingleValues();
+      if( values_ == NULL )
+      {
+         values_ = owner_space_->AllocateInternalStorage();
+         for( Index i = 0; i < Nonzeros(); i++ )
+         {
+            values_[i] = svalues_[i];
+         }
+      }
+   }
    return values_;
 }
 
@@ -151,12 +367,33 @@ void SymTMatrix::FillValues(
 ) const
 {
    DBG_ASSERT(initialized_);
-   IpBlasDcopy(Nonzeros(), values_, 1, Values, 1);
+   if( svalues_ != NULL )
+   {
+      StoreSingleValues();
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         Values[i] = svalues_[i];
+      }
+   }
+   else
+   {
+      IpBlasDcopy(Nonzeros(), values_, 1, Values, 1);
+   }
 }
 
 bool SymTMatrix::HasValidNumbersImpl() const
 {
    DBG_ASSERT(initialized_);
+   if( svalues_ != NULL )
+   {
+      StoreSingleValues();
+      Number sum = 0.;
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         sum += fabs((Number) svalues_[i]);
+      }
+      return IsFiniteNumber(sum);
+   }
    Number sum = IpBlasDasum(Nonzeros(), values_, 1);
    return IsFiniteNumber(sum);
 }
@@ -171,23 +408,19 @@ void SymTMatrix::ComputeRowAMaxImpl(
    DenseVector* dense_vec = static_cast<DenseVector*>(&rows_norms);
    DBG_ASSERT(dynamic_cast<DenseVector*>(&rows_norms));
 
-   const Index* irn = Irows();
-   const Index* jcn = Jcols();
-   const Number* val = values_;
    Number* vec_vals = dense_vec->Values();
-   vec_vals--;
 
    const Number zero = 0.;
    IpBlasDcopy(NRows(), &zero, 0, vec_vals, 1);
 
-   for( Index i = 0; i < Nonzeros(); i++ )
+   StoreSingleValues();
+   if( svalues_ != NULL )
    {
-      const double f = fabs(*val);
-      vec_vals[*irn] = Max(vec_vals[*irn], f);
-      vec_vals[*jcn] = Max(vec_vals[*jcn], f);
-      val++;
-      irn++;
-      jcn++;
+      TripletAMax(Nonzeros(), Irows(), Jcols(), svalues_, vec_vals);
+   }
+   else
+   {
+      TripletAMax(Nonzeros(), Irows(), Jcols(), values_, vec_vals);
    }
 }
 
@@ -203,13 +436,15 @@ void SymTMatrix::PrintImpl(
    jnlst.Printf(level, category,
                 "\n");
    jnlst.PrintfIndented(level, category, indent,
-                        "%sSymTMatrix \"%s\" of dimension %d with %d nonzero elements:\n", prefix.c_str(), name.c_str(), Dim(), Nonzeros());
+                        "%sSymTMatrix \"%s\" of dimension %" IPOPT_INDEX_FORMAT " with %" IPOPT_INDEX_FORMAT " nonzero elements:\n", prefix.c_str(), name.c_str(), Dim(), Nonzeros());
    if( initialized_ )
    {
+      StoreSingleValues();
       for( Index i = 0; i < Nonzeros(); i++ )
       {
          jnlst.PrintfIndented(level, category, indent,
-                              "%s%s[%5d,%5d]=%23.16e  (%d)\n", prefix.c_str(), name.c_str(), Irows()[i], Jcols()[i], values_[i], i);
+                              "%s%s[%5" IPOPT_INDEX_FORMAT ",%5" IPOPT_INDEX_FORMAT "]=%23.16e  (%" IPOPT_INDEX_FORMAT ")\n", prefix.c_str(), name.c_str(), Irows()[i], Jcols()[i],
+                              svalues_ != NULL ? (Number) svalues_[i] : values_[i], i);
       }
    }
    else
@@ -223,12 +458,17 @@ SymTMatrixSpace::SymTMatrixSpace(
    Index        dim,
    Index        nonZeros,
    const Index* iRows,
-   const Index* jCols
+   const Index* jCols,
+   bool         single_precision,
+   bool         use_huge_pages
 )
    : SymMatrixSpace(dim),
      nonZeros_(nonZeros),
      iRows_(NULL),
-     jCols_(NULL)
+     jCols_(NULL),
+     single_precision_(single_precision),
+     use_huge_pages_(use_huge_pages),
+     memory_account_(MemoryStatistics::TRIPLET_MATRIX_VALUES)
 {
    iRows_ = new Index[nonZeros];
    jCols_ = new Index[nonZeros];
@@ -245,15 +485,74 @@ SymTMatrixSpace::~SymTMatrixSpace()
    delete[] jCols_;
 }
 
+void SymTMatrixSpace::InitializeRowIndex() const
+{
+   if( !row_start_.empty() )
+   {
+      return;
+   }
+
+   const Index dim = Dim();
+   row_start_.assign(dim + 1, 0);
+   for( Index i = 0; i < nonZeros_; i++ )
+   {
+      row_start_[iRows_[i]]++;
+      if( iRows_[i] != jCols_[i] )
+      {
+         row_start_[jCols_[i]]++;
+      }
+   }
+   for( Index k = 0; k < dim; k++ )
+   {
+      row_start_[k + 1] += row_start_[k];
+   }
+
+   row_elems_.resize(row_start_[dim]);
+   row_cols_.resize(row_start_[dim]);
+   std::vector<Index> pos(row_start_.begin(), row_start_.end() - 1);
+   for( Index i = 0; i < nonZeros_; i++ )
+   {
+      Index p = pos[iRows_[i] - 1]++;
+      row_elems_[p] = i;
+      row_cols_[p] = jCols_[i] - 1;
+      if( iRows_[i] != jCols_[i] )
+      {
+         p = pos[jCols_[i] - 1]++;
+         row_elems_[p] = i;
+         row_cols_[p] = iRows_[i] - 1;
+      }
+   }
+}
+
 Number* SymTMatrixSpace::AllocateInternalStorage() const
 {
-   return new Number[Nonzeros()];
+   memory_account_.Allocate(Nonzeros() * sizeof(Number));
+   Number* values = AllocateAlignedNumbers(Nonzeros(), use_huge_pages_);
+
+   // Touch the pages first by the threads of the matrix-vector
+   // products, so that they are spread over the NUMA nodes of these threads
+   const int nthreads = MatVecThreads(Nonzeros());
+   if( nthreads > 1 )
+   {
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(static) num_threads(nthreads)
+#endif
+      for( Index i = 0; i < Nonzeros(); i++ )
+      {
+         values[i] = 0.;
+      }
+   }
+   return values;
 }
 
 void SymTMatrixSpace::FreeInternalStorage(
    Number* values) const
 {
-   delete[] values;
+   if( values != NULL )
+   {
+      FreeAlignedNumbers(values);
+      memory_account_.Free(Nonzeros() * sizeof(Number));
+   }
 }
 
 } // namespace Ipopt
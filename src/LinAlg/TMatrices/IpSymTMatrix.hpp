@@ -9,6 +9,9 @@
 
 #include "IpUtils.hpp"
 #include "IpSymMatrix.hpp"
+#include "IpMemoryStatistics.hpp"
+
+#include <vector>
 
 namespace Ipopt
 {
@@ -86,6 +89,11 @@ public:
    /** Obtain pointer to the internal Number array values_ with the
     *  intention to change the matrix data.
     *
+    *  If the values are stored in single precision, the returned array
+    *  is a temporary double precision copy, which is rounded into the
+    *  single precision storage at the next read access to the matrix.
+    *  The pointer is valid only until then.
+    *
     *  @attention This does not produce a copy, and lifetime is not guaranteed!
     */
    Number* Values();
@@ -93,6 +101,10 @@ public:
    /** Obtain pointer to the internal Number array values_ without the
     *  intention to change the matrix data.
     *
+    *  If the values are stored in single precision, this expands them
+    *  into a temporary double precision array, which is kept until the
+    *  values are changed.
+    *
     *  @attention This does not produce a copy, and lifetime is not guaranteed!
     */
    const Number* Values() const;
@@ -168,11 +180,26 @@ private:
     */
    const SymTMatrixSpace* owner_space_;
 
-   /** Values of nonzeros */
-   Number* values_;
+   /** Values of nonzeros.
+    *
+    *  If the values are stored in single precision, this is NULL or a
+    *  temporary copy of the values.
+    */
+   mutable Number* values_;
+
+   /** Values of nonzeros in single precision, NULL if they are stored in double precision */
+   float* svalues_;
+
+   /** Whether values_ has been handed out for changes and not yet rounded into svalues_ */
+   mutable bool values_pending_;
 
    /** Flag for Initialization */
    bool initialized_;
+
+   /** Round changed values from values_ into svalues_ and free values_,
+    *  if the values are stored in single precision.
+    */
+   void StoreSingleValues() const;
 };
 
 /** This is the matrix space for a SymTMatrix with fixed sparsity
@@ -192,12 +219,22 @@ public:
     *  first element in the first row.  This is in accordance with
     *  the HSL data structure.  Off-diagonal elements are stored only
     *  once.
+    *
+    *  If single_precision is true, the matrices of this space store
+    *  their values as float, which halves the memory for the values,
+    *  but keeps only about 7 significant digits.  Products with the
+    *  matrices are still computed in double precision.
+    *
+    *  If use_huge_pages is true, transparent huge pages are requested
+    *  for the values of large matrices (see AllocateAlignedNumbers).
     */
    SymTMatrixSpace(
       Index        dim,
       Index        nonZeros,
       const Index* iRows,
-      const Index* jCols
+      const Index* jCols,
+      bool         single_precision = false,
+      bool         use_huge_pages = false
    );
 
    /** Destructor */
@@ -234,6 +271,18 @@ public:
    {
       return jCols_;
    }
+
+   /** Whether matrices of this space store their values in single precision */
+   bool SinglePrecision() const
+   {
+      return single_precision_;
+   }
+
+   /** Whether huge pages are requested for the values of the matrices of this space */
+   bool UseHugePages() const
+   {
+      return use_huge_pages_;
+   }
    ///@}
 
 private:
@@ -252,6 +301,33 @@ private:
    Index* iRows_;
    Index* jCols_;
 
+   /** Whether matrices of this space store their values in single precision */
+   const bool single_precision_;
+
+   /** Whether huge pages are requested for the values of the matrices of this space */
+   const bool use_huge_pages_;
+
+   /** Memory of the values of the matrices of this space */
+   MemoryAccount memory_account_;
+
+   /** @name Compressed copy of the sparsity structure.
+    *
+    *  This is set up at the first parallel matrix-vector product with
+    *  a matrix of this space.  For each row, the positions in the
+    *  triplet arrays of the elements in this row, including those that
+    *  are stored as their transposed counterpart, are stored in
+    *  increasing order, together with the (0-based) column index of
+    *  each element.
+    */
+   ///@{
+   mutable std::vector<Index> row_start_;
+   mutable std::vector<Index> row_elems_;
+   mutable std::vector<Index> row_cols_;
+   ///@}
+
+   /** Set up row_start_, row_elems_, and row_cols_, if not done yet */
+   void InitializeRowIndex() const;
+
    friend class SymTMatrix;
 };
 
@@ -30,6 +30,17 @@
 namespace Ipopt
 {
 
+/** Whether a scaling vector is a homogeneous DenseVector, so that the
+ *  scaling can be applied without expanding it.
+ */
+static bool IsHomogeneousDense(
+   const Vector& vector
+)
+{
+   const DenseVector* dv = dynamic_cast<const DenseVector*>(&vector);
+   return dv != NULL && dv->IsHomogeneous();
+}
+
 Index TripletHelper::GetNumberEntries(
    const Matrix& matrix
 )
@@ -476,11 +487,8 @@ void TripletHelper::FillValues_(
 )
 {
    DBG_ASSERT(n_entries == matrix.Nonzeros());
-   const Number* vals = matrix.Values();
-   for( Index i = 0; i < n_entries; i++ )
-   {
-      values[i] = vals[i];
-   }
+   (void) n_entries;
+   matrix.FillValues(values);
 }
 
 void TripletHelper::FillRowCol_(
@@ -872,6 +880,67 @@ void TripletHelper::FillValues_(
    (void) n_entries;
 }
 
+Index TripletHelper::FillChangedValues(
+   Index                           n_entries,
+   const CompoundSymMatrix&        matrix,
+   std::vector<TaggedObject::Tag>& comp_tags,
+   Number*                         values
+)
+{
+   const Index ncomps = matrix.NComps_Dim();
+   const size_t nblocks = (size_t) ncomps * (ncomps + 1) / 2;
+
+   // the positions of the components are only the same as before if
+   // the same components are NULL
+   bool fill_all = comp_tags.size() != nblocks;
+   size_t k = 0;
+   for( Index i = 0; !fill_all && i < ncomps; i++ )
+   {
+      for( Index j = 0; j <= i; j++ )
+      {
+         if( IsValid(matrix.GetComp(i, j)) != (comp_tags[k] != 0) )
+         {
+            fill_all = true;
+            break;
+         }
+         k++;
+      }
+   }
+   comp_tags.resize(nblocks);
+
+   Index total_n_entries = 0;
+   Index n_filled = 0;
+   k = 0;
+   for( Index i = 0; i < ncomps; i++ )
+   {
+      for( Index j = 0; j <= i; j++ )
+      {
+         SmartPtr<const Matrix> blk_mat = matrix.GetComp(i, j);
+         if( IsValid(blk_mat) )
+         {
+            Index blk_n_entries = GetNumberEntries(*blk_mat);
+            if( fill_all || blk_mat->GetTag() != comp_tags[k] )
+            {
+               FillValues(blk_n_entries, *blk_mat, values);
+               n_filled += blk_n_entries;
+            }
+            comp_tags[k] = blk_mat->GetTag();
+            total_n_entries += blk_n_entries;
+            values += blk_n_entries;
+         }
+         else
+         {
+            comp_tags[k] = 0;
+         }
+         k++;
+      }
+   }
+   DBG_ASSERT(total_n_entries == n_entries);
+   (void) n_entries;
+
+   return n_filled;
+}
+
 void TripletHelper::FillValuesFromVector(
    Index         dim,
    const Vector& vector,
@@ -933,9 +1002,13 @@ void TripletHelper::FillValues_(
    Number*             values
 )
 {
-   // ToDo:
-   // This method can be made much more efficient for ScaledMatrix with GenTMatrix
-   // contained
+   // Use the stored scaled values if the matrix keeps them
+   SmartPtr<const Matrix> scaled_matrix = matrix.GetScaledValuesMatrix();
+   if( IsValid(scaled_matrix) )
+   {
+      FillValues(n_entries, *scaled_matrix, values);
+      return;
+   }
 
    // Get the matrix values
    FillValues(n_entries, *GetRawPtr(matrix.GetUnscaledMatrix()), values);
@@ -946,7 +1019,15 @@ void TripletHelper::FillValues_(
    Index* jCol = new Index[n_entries];
    FillRowCol(n_entries, *GetRawPtr(matrix.GetUnscaledMatrix()), iRow, jCol, 0, 0);
 
-   if( IsValid(matrix.RowScaling()) )
+   if( IsValid(matrix.RowScaling()) && IsHomogeneousDense(*matrix.RowScaling()) )
+   {
+      Number scaling = static_cast<const DenseVector*>(GetRawPtr(matrix.RowScaling()))->Scalar();
+      for( Index i = 0; i < n_entries; i++ )
+      {
+         values[i] *= scaling;
+      }
+   }
+   else if( IsValid(matrix.RowScaling()) )
    {
       Index n_rows = matrix.NRows();
       Number* row_scaling = new Number[n_rows];
@@ -958,7 +1039,15 @@ void TripletHelper::FillValues_(
       delete[] row_scaling;
    }
 
-   if( IsValid(matrix.ColumnScaling()) )
+   if( IsValid(matrix.ColumnScaling()) && IsHomogeneousDense(*matrix.ColumnScaling()) )
+   {
+      Number scaling = static_cast<const DenseVector*>(GetRawPtr(matrix.ColumnScaling()))->Scalar();
+      for( Index i = 0; i < n_entries; i++ )
+      {
+         values[i] *= scaling;
+      }
+   }
+   else if( IsValid(matrix.ColumnScaling()) )
    {
       Index n_cols = matrix.NCols();
       Number* col_scaling = new Number[n_cols];
@@ -992,9 +1081,13 @@ void TripletHelper::FillValues_(
    Number*                values
 )
 {
-   // ToDo:
-   // This method can be made much more efficient for ScaledMatrix with SymTMatrix
-   // contained
+   // Use the stored scaled values if the matrix keeps them
+   SmartPtr<const SymMatrix> scaled_matrix = matrix.GetScaledValuesMatrix();
+   if( IsValid(scaled_matrix) )
+   {
+      FillValues(n_entries, *scaled_matrix, values);
+      return;
+   }
 
    // Get the matrix values
    FillValues(n_entries, *GetRawPtr(matrix.GetUnscaledMatrix()), values);
@@ -1005,7 +1098,16 @@ void TripletHelper::FillValues_(
    Index* jCol = new Index[n_entries];
    FillRowCol(n_entries, *GetRawPtr(matrix.GetUnscaledMatrix()), iRow, jCol, 0, 0);
 
-   if( IsValid(matrix.RowColScaling()) )
+   if( IsValid(matrix.RowColScaling()) && IsHomogeneousDense(*matrix.RowColScaling()) )
+   {
+      Number scaling = static_cast<const DenseVector*>(GetRawPtr(matrix.RowColScaling()))->Scalar();
+      for( Index i = 0; i < n_entries; i++ )
+      {
+         values[i] *= scaling;
+         values[i] *= scaling;
+      }
+   }
+   else if( IsValid(matrix.RowColScaling()) )
    {
       Index n_dim = matrix.NRows();
       Number* scaling = new Number[n_dim];
@@ -1178,5 +1280,630 @@ void TripletHelper::PutValuesInVector(
    THROW_EXCEPTION(UNKNOWN_VECTOR_TYPE, "Unknown vector type passed to TripletHelper::PutValuesInVector");
 }
 
+TripletFillPlan::TripletFillPlan()
+{ }
+
+TripletFillPlan::~TripletFillPlan()
+{ }
+
+void TripletFillPlan::Build(
+   const Matrix& matrix
+)
+{
+   nodes_.clear();
+   AddNode(matrix, 0, 0);
+}
+
+void TripletFillPlan::Clear()
+{
+   nodes_.clear();
+}
+
+void TripletFillPlan::AddNode(
+   const Matrix& matrix,
+   Index         pos,
+   Index         offset
+)
+{
+   const size_t k = nodes_.size();
+   nodes_.push_back(Node());
+   nodes_[k].type = GENERIC_NODE;
+   nodes_[k].space = matrix.OwnerSpace();
+   nodes_[k].n_entries = TripletHelper::GetNumberEntries(matrix);
+   nodes_[k].offset = offset;
+   nodes_[k].pos = pos;
+   nodes_[k].row_scaling_tag = 0;
+   nodes_[k].col_scaling_tag = 0;
+   nodes_[k].filled_tag = 0;
+   nodes_[k].filled_factor = 0.;
+
+   // the nodes of the children are added after this node, so nodes_[k]
+   // has to be accessed by index after the recursive calls
+   const Matrix* mptr = &matrix;
+   ENodeType type = GENERIC_NODE;
+   if( dynamic_cast<const GenTMatrix*>(mptr) )
+   {
+      type = GENT_NODE;
+   }
+   else if( dynamic_cast<const SymTMatrix*>(mptr) )
+   {
+      type = SYMT_NODE;
+   }
+   else if( dynamic_cast<const DiagMatrix*>(mptr) )
+   {
+      type = DIAG_NODE;
+   }
+   else if( dynamic_cast<const IdentityMatrix*>(mptr) )
+   {
+      type = IDENTITY_NODE;
+   }
+   else if( dynamic_cast<const ExpansionMatrix*>(mptr) )
+   {
+      type = EXPANSION_NODE;
+   }
+   else if( dynamic_cast<const ZeroMatrix*>(mptr) || dynamic_cast<const ZeroSymMatrix*>(mptr) )
+   {
+      type = ZERO_NODE;
+   }
+   else if( dynamic_cast<const SumMatrix*>(mptr) )
+   {
+      type = SUM_NODE;
+      const SumMatrix* sum = static_cast<const SumMatrix*>(mptr);
+      Index term_offset = offset;
+      for( Index i = 0; i < sum->NTerms(); i++ )
+      {
+         Number factor;
+         SmartPtr<const Matrix> term;
+         sum->GetTerm(i, factor, term);
+         size_t c = nodes_.size();
+         AddNode(*term, i, term_offset);
+         term_offset += nodes_[c].n_entries;
+      }
+   }
+   else if( dynamic_cast<const SumSymMatrix*>(mptr) )
+   {
+      type = SUMSYM_NODE;
+      const SumSymMatrix* sumsym = static_cast<const SumSymMatrix*>(mptr);
+      Index term_offset = offset;
+      for( Index i = 0; i < sumsym->NTerms(); i++ )
+      {
+         Number factor;
+         SmartPtr<const SymMatrix> term;
+         sumsym->GetTerm(i, factor, term);
+         size_t c = nodes_.size();
+         AddNode(*term, i, term_offset);
+         term_offset += nodes_[c].n_entries;
+      }
+   }
+   else if( dynamic_cast<const CompoundMatrix*>(mptr) )
+   {
+      type = COMPOUND_NODE;
+      const CompoundMatrix* cmpd = static_cast<const CompoundMatrix*>(mptr);
+      Index blk_offset = offset;
+      for( Index i = 0; i < cmpd->NComps_Rows(); i++ )
+      {
+         for( Index j = 0; j < cmpd->NComps_Cols(); j++ )
+         {
+            SmartPtr<const Matrix> blk_mat = cmpd->GetComp(i, j);
+            if( IsValid(blk_mat) )
+            {
+               size_t c = nodes_.size();
+               AddNode(*blk_mat, i * cmpd->NComps_Cols() + j, blk_offset);
+               blk_offset += nodes_[c].n_entries;
+            }
+         }
+      }
+   }
+   else if( dynamic_cast<const CompoundSymMatrix*>(mptr) )
+   {
+      type = COMPOUNDSYM_NODE;
+      const CompoundSymMatrix* cmpd_sym = static_cast<const CompoundSymMatrix*>(mptr);
+      Index blk_offset = offset;
+      Index blk = 0;
+      for( Index i = 0; i < cmpd_sym->NComps_Dim(); i++ )
+      {
+         for( Index j = 0; j <= i; j++ )
+         {
+            SmartPtr<const Matrix> blk_mat = cmpd_sym->GetComp(i, j);
+            if( IsValid(blk_mat) )
+            {
+               size_t c = nodes_.size();
+               AddNode(*blk_mat, blk, blk_offset);
+               blk_offset += nodes_[c].n_entries;
+            }
+            blk++;
+         }
+      }
+   }
+   else if( dynamic_cast<const ScaledMatrix*>(mptr) )
+   {
+      type = SCALED_NODE;
+      AddNode(*static_cast<const ScaledMatrix*>(mptr)->GetUnscaledMatrix(), 0, offset);
+   }
+   else if( dynamic_cast<const SymScaledMatrix*>(mptr) )
+   {
+      type = SYMSCALED_NODE;
+      AddNode(*static_cast<const SymScaledMatrix*>(mptr)->GetUnscaledMatrix(), 0, offset);
+   }
+   else if( dynamic_cast<const TransposeMatrix*>(mptr) )
+   {
+      type = TRANSPOSE_NODE;
+      AddNode(*static_cast<const TransposeMatrix*>(mptr)->OrigMatrix(), 0, offset);
+   }
+
+   nodes_[k].type = type;
+   nodes_[k].next = nodes_.size();
+}
+
+/** Whether a scaling vector is set and has the given tag (0 if it is not set) */
+static bool SameScaling(
+   const SmartPtr<const Vector>& vector,
+   TaggedObject::Tag             tag
+)
+{
+   return IsValid(vector) ? vector->GetTag() == tag : tag == 0;
+}
+
+bool TripletFillPlan::FillNode(
+   size_t        k,
+   const Matrix& matrix,
+   Number*       values
+)
+{
+   Node& node = nodes_[k];
+   if( GetRawPtr(matrix.OwnerSpace()) != GetRawPtr(node.space) )
+   {
+      return false;
+   }
+
+   Number* node_values = values + node.offset;
+   switch( node.type )
+   {
+      case GENT_NODE:
+         DBG_ASSERT(dynamic_cast<const GenTMatrix*>(&matrix));
+         static_cast<const GenTMatrix&>(matrix).FillValues(node_values);
+         break;
+
+      case SYMT_NODE:
+         DBG_ASSERT(dynamic_cast<const SymTMatrix*>(&matrix));
+         static_cast<const SymTMatrix&>(matrix).FillValues(node_values);
+         break;
+
+      case DIAG_NODE:
+         DBG_ASSERT(dynamic_cast<const DiagMatrix*>(&matrix));
+         TripletHelper::FillValuesFromVector(node.n_entries, *static_cast<const DiagMatrix&>(matrix).GetDiag(),
+                                             node_values);
+         break;
+
+      case IDENTITY_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const IdentityMatrix*>(&matrix));
+         Number factor = static_cast<const IdentityMatrix&>(matrix).GetFactor();
+         IpBlasDcopy(node.n_entries, &factor, 0, node_values, 1);
+         break;
+      }
+
+      case EXPANSION_NODE:
+      {
+         const Number one = 1.;
+         IpBlasDcopy(node.n_entries, &one, 0, node_values, 1);
+         break;
+      }
+
+      case ZERO_NODE:
+         break;
+
+      case SUM_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const SumMatrix*>(&matrix));
+         const SumMatrix& sum = static_cast<const SumMatrix&>(matrix);
+         size_t c = k + 1;
+         for( Index i = 0; i < sum.NTerms(); i++ )
+         {
+            Number factor;
+            SmartPtr<const Matrix> term;
+            sum.GetTerm(i, factor, term);
+            if( !FillNode(c, *term, values) )
+            {
+               return false;
+            }
+            IpBlasDscal(nodes_[c].n_entries, factor, values + nodes_[c].offset, 1);
+            c = nodes_[c].next;
+         }
+         break;
+      }
+
+      case SUMSYM_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const SumSymMatrix*>(&matrix));
+         const SumSymMatrix& sumsym = static_cast<const SumSymMatrix&>(matrix);
+         size_t c = k + 1;
+         for( Index i = 0; i < sumsym.NTerms(); i++ )
+         {
+            Number factor;
+            SmartPtr<const SymMatrix> term;
+            sumsym.GetTerm(i, factor, term);
+            if( factor != 0. )
+            {
+               if( !FillNode(c, *term, values) )
+               {
+                  return false;
+               }
+               if( factor != 1. )
+               {
+                  IpBlasDscal(nodes_[c].n_entries, factor, values + nodes_[c].offset, 1);
+               }
+            }
+            else
+            {
+               if( GetRawPtr(term->OwnerSpace()) != GetRawPtr(nodes_[c].space) )
+               {
+                  return false;
+               }
+               const Number zero = 0.;
+               IpBlasDcopy(nodes_[c].n_entries, &zero, 0, values + nodes_[c].offset, 1);
+            }
+            c = nodes_[c].next;
+         }
+         break;
+      }
+
+      case COMPOUND_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const CompoundMatrix*>(&matrix));
+         const CompoundMatrix& cmpd = static_cast<const CompoundMatrix&>(matrix);
+         const size_t end = node.next;
+         size_t c = k + 1;
+         for( Index i = 0; i < cmpd.NComps_Rows(); i++ )
+         {
+            for( Index j = 0; j < cmpd.NComps_Cols(); j++ )
+            {
+               SmartPtr<const Matrix> blk_mat = cmpd.GetComp(i, j);
+               bool in_plan = c < end && nodes_[c].pos == i * cmpd.NComps_Cols() + j;
+               if( IsValid(blk_mat) != in_plan )
+               {
+                  return false;
+               }
+               if( in_plan )
+               {
+                  if( !FillNode(c, *blk_mat, values) )
+                  {
+                     return false;
+                  }
+                  c = nodes_[c].next;
+               }
+            }
+         }
+         break;
+      }
+
+      case COMPOUNDSYM_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const CompoundSymMatrix*>(&matrix));
+         Index n_filled = 0;
+         return FillCompoundSymNode(k, static_cast<const CompoundSymMatrix&>(matrix), values, NULL, n_filled);
+      }
+
+      case SCALED_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const ScaledMatrix*>(&matrix));
+         const ScaledMatrix& scaled = static_cast<const ScaledMatrix&>(matrix);
+
+         // Use the stored scaled values if the matrix keeps them
+         SmartPtr<const Matrix> scaled_matrix = scaled.GetScaledValuesMatrix();
+         if( IsValid(scaled_matrix) )
+         {
+            TripletHelper::FillValues(node.n_entries, *scaled_matrix, node_values);
+            break;
+         }
+
+         if( !FillNode(k + 1, *scaled.GetUnscaledMatrix(), values) )
+         {
+            return false;
+         }
+
+         // the scaling vectors belong to the matrix space, so the
+         // factors of the entries only change if the vectors change
+         SmartPtr<const Vector> row_scaling = scaled.RowScaling();
+         SmartPtr<const Vector> col_scaling = scaled.ColumnScaling();
+         if( IsNull(row_scaling) && IsNull(col_scaling) )
+         {
+            break;
+         }
+         if( node.scaling.empty() || !SameScaling(row_scaling, node.row_scaling_tag)
+             || !SameScaling(col_scaling, node.col_scaling_tag) )
+         {
+            std::vector<Index> iRow(node.n_entries);
+            std::vector<Index> jCol(node.n_entries);
+            if( node.n_entries > 0 )
+            {
+               TripletHelper::FillRowCol(node.n_entries, *scaled.GetUnscaledMatrix(), &iRow[0], &jCol[0], 0, 0);
+            }
+            node.scaling.assign(node.n_entries, 1.);
+            if( IsValid(row_scaling) )
+            {
+               std::vector<Number> row_vals(scaled.NRows());
+               if( scaled.NRows() > 0 )
+               {
+                  TripletHelper::FillValuesFromVector(scaled.NRows(), *row_scaling, &row_vals[0]);
+               }
+               for( Index i = 0; i < node.n_entries; i++ )
+               {
+                  node.scaling[i] *= row_vals[iRow[i] - 1];
+               }
+            }
+            if( IsValid(col_scaling) )
+            {
+               std::vector<Number> col_vals(scaled.NCols());
+               if( scaled.NCols() > 0 )
+               {
+                  TripletHelper::FillValuesFromVector(scaled.NCols(), *col_scaling, &col_vals[0]);
+               }
+               for( Index i = 0; i < node.n_entries; i++ )
+               {
+                  node.scaling[i] *= col_vals[jCol[i] - 1];
+               }
+            }
+            node.row_scaling_tag = IsValid(row_scaling) ? row_scaling->GetTag() : 0;
+            node.col_scaling_tag = IsValid(col_scaling) ? col_scaling->GetTag() : 0;
+         }
+         for( Index i = 0; i < node.n_entries; i++ )
+         {
+            node_values[i] *= node.scaling[i];
+         }
+         break;
+      }
+
+      case SYMSCALED_NODE:
+      {
+         DBG_ASSERT(dynamic_cast<const SymScaledMatrix*>(&matrix));
+         const SymScaledMatrix& symscaled = static_cast<const SymScaledMatrix&>(matrix);
+
+         // Use the stored scaled values if the matrix keeps them
+         SmartPtr<const SymMatrix> scaled_matrix = symscaled.GetScaledValuesMatrix();
+         if( IsValid(scaled_matrix) )
+         {
+            TripletHelper::FillValues(node.n_entries, *scaled_matrix, node_values);
+            break;
+         }
+
+         if( !FillNode(k + 1, *symscaled.GetUnscaledMatrix(), values) )
+         {
+            return false;
+         }
+
+         SmartPtr<const Vector> scaling = symscaled.RowColScaling();
+         if( IsNull(scaling) )
+         {
+            break;
+         }
+         if( node.scaling.empty() || !SameScaling(scaling, node.row_scaling_tag) )
+         {
+            std::vector<Index> iRow(node.n_entries);
+            std::vector<Index> jCol(node.n_entries);
+            std::vector<Number> scaling_vals(symscaled.NRows());
+            if( node.n_entries > 0 )
+            {
+               TripletHelper::FillRowCol(node.n_entries, *symscaled.GetUnscaledMatrix(), &iRow[0], &jCol[0], 0, 0);
+            }
+            if( symscaled.NRows() > 0 )
+            {
+               TripletHelper::FillValuesFromVector(symscaled.NRows(), *scaling, &scaling_vals[0]);
+            }
+            node.scaling.resize(node.n_entries);
+            for( Index i = 0; i < node.n_entries; i++ )
+            {
+               node.scaling[i] = scaling_vals[iRow[i] - 1] * scaling_vals[jCol[i] - 1];
+            }
+            node.row_scaling_tag = scaling->GetTag();
+         }
+         for( Index i = 0; i < node.n_entries; i++ )
+         {
+            node_values[i] *= node.scaling[i];
+         }
+         break;
+      }
+
+      case TRANSPOSE_NODE:
+         DBG_ASSERT(dynamic_cast<const TransposeMatrix*>(&matrix));
+         return FillNode(k + 1, *static_cast<const TransposeMatrix&>(matrix).OrigMatrix(), values);
+
+      case GENERIC_NODE:
+         TripletHelper::FillValues(node.n_entries, matrix, node_values);
+         break;
+   }
+
+   return true;
+}
+
+bool TripletFillPlan::FillCompoundSymNode(
+   size_t                          k,
+   const CompoundSymMatrix&        matrix,
+   Number*                         values,
+   std::vector<TaggedObject::Tag>* comp_tags,
+   Index&                          n_filled
+)
+{
+   if( GetRawPtr(matrix.OwnerSpace()) != GetRawPtr(nodes_[k].space) )
+   {
+      return false;
+   }
+
+   const size_t end = nodes_[k].next;
+   size_t c = k + 1;
+   Index blk = 0;
+   for( Index i = 0; i < matrix.NComps_Dim(); i++ )
+   {
+      for( Index j = 0; j <= i; j++ )
+      {
+         SmartPtr<const Matrix> blk_mat = matrix.GetComp(i, j);
+         bool in_plan = c < end && nodes_[c].pos == blk;
+         if( IsValid(blk_mat) != in_plan )
+         {
+            return false;
+         }
+         if( in_plan )
+         {
+            if( comp_tags != NULL && nodes_[c].type == SUMSYM_NODE )
+            {
+               if( blk_mat->GetTag() != (*comp_tags)[blk] && !FillChangedSumSymNode(c, *blk_mat, values, n_filled) )
+               {
+                  return false;
+               }
+            }
+            else if( comp_tags == NULL || blk_mat->GetTag() != (*comp_tags)[blk] )
+            {
+               if( !FillNode(c, *blk_mat, values) )
+               {
+                  return false;
+               }
+               n_filled += nodes_[c].n_entries;
+            }
+            if( comp_tags != NULL )
+            {
+               (*comp_tags)[blk] = blk_mat->GetTag();
+            }
+            c = nodes_[c].next;
+         }
+         else if( comp_tags != NULL )
+         {
+            (*comp_tags)[blk] = 0;
+         }
+         blk++;
+      }
+   }
+
+   return true;
+}
+
+bool TripletFillPlan::FillChangedSumSymNode(
+   size_t        k,
+   const Matrix& matrix,
+   Number*       values,
+   Index&        n_filled
+)
+{
+   if( GetRawPtr(matrix.OwnerSpace()) != GetRawPtr(nodes_[k].space) )
+   {
+      return false;
+   }
+
+   DBG_ASSERT(dynamic_cast<const SumSymMatrix*>(&matrix));
+   const SumSymMatrix& sumsym = static_cast<const SumSymMatrix&>(matrix);
+   size_t c = k + 1;
+   for( Index i = 0; i < sumsym.NTerms(); i++ )
+   {
+      Number factor;
+      SmartPtr<const SymMatrix> term;
+      sumsym.GetTerm(i, factor, term);
+      // a term with the same tag is the same matrix with the same values
+      if( term->GetTag() != nodes_[c].filled_tag || factor != nodes_[c].filled_factor )
+      {
+         if( factor != 0. )
+         {
+            if( !FillNode(c, *term, values) )
+            {
+               return false;
+            }
+            if( factor != 1. )
+            {
+               IpBlasDscal(nodes_[c].n_entries, factor, values + nodes_[c].offset, 1);
+            }
+         }
+         else
+         {
+            if( GetRawPtr(term->OwnerSpace()) != GetRawPtr(nodes_[c].space) )
+            {
+               return false;
+            }
+            const Number zero = 0.;
+            IpBlasDcopy(nodes_[c].n_entries, &zero, 0, values + nodes_[c].offset, 1);
+         }
+         n_filled += nodes_[c].n_entries;
+         nodes_[c].filled_tag = term->GetTag();
+         nodes_[c].filled_factor = factor;
+      }
+      c = nodes_[c].next;
+   }
+
+   return true;
+}
+
+void TripletFillPlan::ResetFilledTags()
+{
+   for( size_t k = 0; k < nodes_.size(); k++ )
+   {
+      nodes_[k].filled_tag = 0;
+   }
+}
+
+void TripletFillPlan::FillValues(
+   Index         n_entries,
+   const Matrix& matrix,
+   Number*       values
+)
+{
+   // the values array may differ from the one of FillChangedValues
+   ResetFilledTags();
+   if( nodes_.empty() || !FillNode(0, matrix, values) )
+   {
+      Build(matrix);
+      bool filled = FillNode(0, matrix, values);
+      DBG_ASSERT(filled);
+      (void) filled;
+   }
+   DBG_ASSERT(nodes_[0].n_entries == n_entries);
+   (void) n_entries;
+}
+
+Index TripletFillPlan::FillChangedValues(
+   Index                           n_entries,
+   const CompoundSymMatrix&        matrix,
+   std::vector<TaggedObject::Tag>& comp_tags,
+   Number*                         values
+)
+{
+   const Index ncomps = matrix.NComps_Dim();
+   const size_t nblocks = (size_t) ncomps * (ncomps + 1) / 2;
+
+   // the positions of the components are only the same as before if
+   // the same components are NULL
+   bool fill_all = comp_tags.size() != nblocks;
+   size_t k = 0;
+   for( Index i = 0; !fill_all && i < ncomps; i++ )
+   {
+      for( Index j = 0; j <= i; j++ )
+      {
+         if( IsValid(matrix.GetComp(i, j)) != (comp_tags[k] != 0) )
+         {
+            fill_all = true;
+            break;
+         }
+         k++;
+      }
+   }
+   if( fill_all )
+   {
+      comp_tags.assign(nblocks, 0);
+      ResetFilledTags();
+   }
+
+   Index n_filled = 0;
+   if( nodes_.empty() || nodes_[0].type != COMPOUNDSYM_NODE
+       || !FillCompoundSymNode(0, matrix, values, &comp_tags, n_filled) )
+   {
+      Build(matrix);
+      comp_tags.assign(nblocks, 0);
+      n_filled = 0;
+      bool filled = FillCompoundSymNode(0, matrix, values, &comp_tags, n_filled);
+      DBG_ASSERT(filled);
+      (void) filled;
+   }
+   DBG_ASSERT(nodes_[0].n_entries == n_entries);
+   (void) n_entries;
+
+   return n_filled;
+}
+
 } // namespace Ipopt
 
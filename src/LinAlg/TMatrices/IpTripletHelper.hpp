@@ -9,6 +9,10 @@
 
 #include "IpTypes.hpp"
 #include "IpException.hpp"
+#include "IpTaggedObject.hpp"
+#include "IpMatrix.hpp"
+
+#include <vector>
 
 namespace Ipopt
 {
@@ -62,6 +66,25 @@ public:
       Number*       values
    );
 
+   /** fill the values for the triplet format of the components of
+    *  the matrix that have changed
+    *
+    *  comp_tags has an entry for each component (i,j) with j <= i,
+    *  which is the tag of the component whose values are already in
+    *  values, or 0 if the component is NULL.  The values of a
+    *  component with the same tag are not filled again, and comp_tags
+    *  is updated.  If comp_tags does not match the components, e.g.,
+    *  if it is empty, all values are filled.
+    *
+    *  @return the number of entries that have been filled
+    */
+   static Index FillChangedValues(
+      Index                           n_entries,
+      const CompoundSymMatrix&        matrix,
+      std::vector<TaggedObject::Tag>& comp_tags,
+      Number*                         values
+   );
+
    /** fill the values from the vector into a dense double* structure */
    static void FillValuesFromVector(
       Index         dim,
@@ -304,5 +327,208 @@ private:
    );
 };
 
+/** Precomputed plan for filling the triplet values of a matrix.
+ *
+ *  TripletHelper::FillValues discovers the types of the matrices in a
+ *  tree of compound, sum, scaled, etc., matrices by a chain of
+ *  dynamic_casts at every call.  A plan does this only once, when it
+ *  is built for a matrix, and stores a flattened list of the nodes of
+ *  the tree with their types, matrix spaces, and positions in the
+ *  array of values.  For scaled matrices, it also keeps the products
+ *  of the row and column scaling factors of the entries.
+ *
+ *  When the values of a matrix are filled with the plan, the tree is
+ *  traversed with static_casts, and only the matrix spaces of the
+ *  nodes are compared with the ones of the plan.  If the matrix does
+ *  not match the plan, e.g., because a component has been set to NULL
+ *  or a different matrix type is used for a component, the plan is
+ *  rebuilt for the matrix.
+ */
+class IPOPTLIB_EXPORT TripletFillPlan
+{
+public:
+   /**@name Constructors/Destructors */
+   ///@{
+   /** Constructor of an empty plan */
+   TripletFillPlan();
+
+   /** Destructor */
+   ~TripletFillPlan();
+   ///@}
+
+   /** build the plan for the structure of a matrix */
+   void Build(
+      const Matrix& matrix
+   );
+
+   /** discard the plan */
+   void Clear();
+
+   /** whether the plan has been built */
+   bool IsBuilt() const
+   {
+      return !nodes_.empty();
+   }
+
+   /** fill the values for the triplet format from the matrix
+    *
+    *  This is equivalent to TripletHelper::FillValues.  The plan is
+    *  built or rebuilt if it does not match the matrix.
+    */
+   void FillValues(
+      Index         n_entries,
+      const Matrix& matrix,
+      Number*       values
+   );
+
+   /** fill the values for the triplet format of the components of
+    *  the matrix that have changed
+    *
+    *  This is equivalent to TripletHelper::FillChangedValues, except
+    *  that for a component that is a SumSymMatrix, only the terms
+    *  that changed are filled.  For this, values must be the same
+    *  array in every call.  The plan is built or rebuilt if it does not
+    *  match the matrix, and then all values are filled.
+    *
+    *  @return the number of entries that have been filled
+    */
+   Index FillChangedValues(
+      Index                           n_entries,
+      const CompoundSymMatrix&        matrix,
+      std::vector<TaggedObject::Tag>& comp_tags,
+      Number*                         values
+   );
+
+private:
+   /**@name Default Compiler Generated Methods
+    * (Hidden to avoid implicit creation/calling).
+    *
+    * These methods are not implemented and
+    * we do not want the compiler to implement
+    * them for us, so we declare them private
+    * and do not define them. This ensures that
+    * they will not be implicitly created/called.
+    */
+   ///@{
+   /** Copy Constructor */
+   TripletFillPlan(
+      const TripletFillPlan&
+   );
+
+   /** Default Assignment Operator */
+   void operator=(
+      const TripletFillPlan&
+   );
+   ///@}
+
+   /** Types of the nodes of a plan */
+   enum ENodeType
+   {
+      GENT_NODE,
+      SYMT_NODE,
+      DIAG_NODE,
+      IDENTITY_NODE,
+      EXPANSION_NODE,
+      ZERO_NODE,
+      SUM_NODE,
+      SUMSYM_NODE,
+      COMPOUND_NODE,
+      COMPOUNDSYM_NODE,
+      SCALED_NODE,
+      SYMSCALED_NODE,
+      TRANSPOSE_NODE,
+      /** other matrix types, which are filled by TripletHelper */
+      GENERIC_NODE
+   };
+
+   /** Node of a plan, for one matrix of the tree */
+   struct Node
+   {
+      /** type of the matrix */
+      ENodeType type;
+      /** matrix space of the matrix */
+      SmartPtr<const MatrixSpace> space;
+      /** number of triplet entries of the matrix */
+      Index n_entries;
+      /** position of the first value of the matrix in the array of values */
+      Index offset;
+      /** position of the matrix in its parent: the term for a sum, and
+       *  the component (counted row-wise) for a compound matrix */
+      Index pos;
+      /** index of the node after the subtree of this node */
+      size_t next;
+      /** for a scaled matrix, the scaling factors of the entries */
+      std::vector<Number> scaling;
+      /** tag of the row scaling (or row and column scaling) vector for
+       *  which scaling has been computed */
+      TaggedObject::Tag row_scaling_tag;
+      /** tag of the column scaling vector for which scaling has been
+       *  computed */
+      TaggedObject::Tag col_scaling_tag;
+      /** for a term of a sum in a compound symmetric matrix, the tag
+       *  of the term whose values are in the array of values of
+       *  FillChangedValues, or 0 if they are not known */
+      TaggedObject::Tag filled_tag;
+      /** factor of the term with tag filled_tag */
+      Number filled_factor;
+   };
+
+   /** add the nodes for a matrix and its children */
+   void AddNode(
+      const Matrix& matrix,
+      Index         pos,
+      Index         offset
+   );
+
+   /** fill the values of a matrix with the subtree of node k
+    *
+    *  values is the array of values of the root of the plan.
+    *
+    *  @return false if the matrix does not match the plan
+    */
+   bool FillNode(
+      size_t        k,
+      const Matrix& matrix,
+      Number*       values
+   );
+
+   /** fill the values of the terms of a symmetric sum matrix whose
+    *  tag or factor differs from the ones filled before with the
+    *  subtree of node k
+    *
+    *  This is used by FillChangedValues for the components of the
+    *  compound matrix that are sums, so that an unchanged term, e.g.,
+    *  a constant Hessian, is not filled again if only another term
+    *  changed.
+    */
+   bool FillChangedSumSymNode(
+      size_t        k,
+      const Matrix& matrix,
+      Number*       values,
+      Index&        n_filled
+   );
+
+   /** forget the tags of the terms filled by FillChangedSumSymNode */
+   void ResetFilledTags();
+
+   /** fill the values of the components of a compound symmetric
+    *  matrix with the subtree of node k
+    *
+    *  If comp_tags is not NULL, only the values of components whose
+    *  tag differs from the one in comp_tags are filled, and comp_tags
+    *  is updated, see TripletHelper::FillChangedValues.
+    */
+   bool FillCompoundSymNode(
+      size_t                          k,
+      const CompoundSymMatrix&        matrix,
+      Number*                         values,
+      std::vector<TaggedObject::Tag>* comp_tags,
+      Index&                          n_filled
+   );
+
+   /** the nodes of the plan in depth-first order, starting with the root */
+   std::vector<Node> nodes_;
+};
+
 } // namespace Ipopt
 #endif
@@ -28,6 +28,9 @@ CGPenaltyLSAcceptor::CGPenaltyLSAcceptor(
    const SmartPtr<PDSystemSolver>& pd_solver
 )
    : PiecewisePenalty_(1),
+     dx_tag_(0),
+     ds_tag_(0),
+     nrm_dx_ds_(0.),
      pd_solver_(pd_solver)
 {
    DBG_START_FUN("CGPenaltyLSAcceptor::CGPenaltyLSAcceptor",
@@ -348,7 +351,17 @@ bool CGPenaltyLSAcceptor::IsAcceptableToPiecewisePenalty(
    SmartPtr<const Vector> ds = IpData().delta()->s();
    Number curr_barr = IpCq().curr_barrier_obj();
    Number trial_barr = IpCq().trial_barrier_obj();
-   Number nrm_dx_ds = pow(dx->Nrm2(), 2.) + pow(ds->Nrm2(), 2.);
+   // The search direction does not change during the backtracking,
+   // so its norm is only computed for the first trial step size.
+   if( dx->GetTag() != dx_tag_ || ds->GetTag() != ds_tag_ )
+   {
+      Number nrm_dx = dx->Nrm2();
+      Number nrm_ds = ds->Nrm2();
+      nrm_dx_ds_ = nrm_dx * nrm_dx + nrm_ds * nrm_ds;
+      dx_tag_ = dx->GetTag();
+      ds_tag_ = ds->GetTag();
+   }
+   Number nrm_dx_ds = nrm_dx_ds_;
    if( infeasibility < theta_min_ )
    {
       Number biggest_barr = PiecewisePenalty_.BiggestBarr();
@@ -360,7 +373,7 @@ bool CGPenaltyLSAcceptor::IsAcceptableToPiecewisePenalty(
       }
    }
    Number Fzconst, Fzlin;
-   Fzconst = IpCq().trial_barrier_obj() + alpha_primal_test * piecewisepenalty_gamma_obj_ * nrm_dx_ds;
+   Fzconst = trial_barr + alpha_primal_test * piecewisepenalty_gamma_obj_ * nrm_dx_ds;
    Fzlin = IpCq().trial_constraint_violation()
            + alpha_primal_test * piecewisepenalty_gamma_infeasi_ * IpCq().curr_constraint_violation();
    accept = PiecewisePenalty_.Acceptable(Fzconst, Fzlin);
@@ -463,7 +476,8 @@ bool CGPenaltyLSAcceptor::TrySecondOrderCorrection(
       theta_soc_old = theta_trial;
       theta_soc_old2 = theta_trial2;
       Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                     "Trying second order correction number %d\n", count_soc + 1);
+                     "Trying second order correction number %" IPOPT_INDEX_FORMAT "\n", count_soc + 1);
+      IpData().WorkCounts().Increase(WorkCounters::SOC_TRIALS);
       // Compute SOC constraint violation
       /*
        Number c_over_r = 0.;
@@ -513,7 +527,7 @@ bool CGPenaltyLSAcceptor::TrySecondOrderCorrection(
       if( accept )
       {
          Jnlst().Printf(J_DETAILED, J_LINE_SEARCH,
-                        "Second order correction step accepted with %d corrections.\n", count_soc + 1);
+                        "Second order correction step accepted with %" IPOPT_INDEX_FORMAT " corrections.\n", count_soc + 1);
          // Accept all SOC quantities
          alpha_primal = alpha_primal_soc;
          actual_delta = delta_soc;
@@ -314,6 +314,13 @@ private:
    bool never_use_piecewise_penalty_ls_;
    /** piecewise penalty list */
    PiecewisePenalty PiecewisePenalty_;
+   /** @name Squared norm of the primal search direction (dx,ds),
+    *  and the tags of dx and ds for which it was computed */
+   ///@{
+   TaggedObject::Tag dx_tag_;
+   TaggedObject::Tag ds_tag_;
+   Number nrm_dx_ds_;
+   ///@}
    /** Flag indicating whether PiecewisePenalty has to be initialized */
    bool reset_piecewise_penalty_;
 
@@ -42,47 +42,33 @@ bool PiecewisePenalty::Acceptable(
    {
       Number trial_inf = Fzlin;
       Number trial_barrier = Fzconst;
+      // Evaluate the value of every entry at the trial point once.
+      values_.resize(size);
+      for( Index i = 0; i < size; i++ )
+      {
+         const PiecewisePenEntry& entry = PiecewisePenalty_list_[i];
+         values_[i] = entry.barrier_obj + entry.pen_r * entry.infeasi - trial_barrier - entry.pen_r * trial_inf;
+      }
       // First check the starting entry of the list.
-      iter = PiecewisePenalty_list_.begin();
-      Number value = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-      if( value >= 0. )
+      if( values_[0] >= 0. && values_[1] <= 0. )
       {
-         iter++;
-         value = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-         if( value <= 0. )
-         {
-            return false;
-         }
+         return false;
       }
       // Then check the ending entry of the list.
-      iter = PiecewisePenalty_list_.end();
-      iter--;
-      value = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-      if( value <= 0. && trial_inf <= iter->infeasi )
+      const PiecewisePenEntry& last = PiecewisePenalty_list_.back();
+      if( values_[size - 1] <= 0. && trial_inf <= last.infeasi )
       {
          return false;
       }
       // Check the next to the ending entry.
-      if( value >= 0. && trial_inf >= iter->infeasi )
+      if( values_[size - 1] >= 0. && trial_inf >= last.infeasi && values_[size - 2] <= 0. )
       {
-         iter -= 1;
-         value = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-         if( value <= 0. )
-         {
-            return false;
-         }
+         return false;
       }
       // Finally, check the middle entries of the list.
-      Number value_left, value_mid, value_right;
-      for( iter = PiecewisePenalty_list_.begin() + 1; iter != PiecewisePenalty_list_.end(); iter++ )
+      for( Index i = 1; i < size - 1; i++ )
       {
-         value_mid = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-         iter++;
-         value_right = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-         iter -= 2;
-         value_left = iter->barrier_obj + iter->pen_r * iter->infeasi - trial_barrier - iter->pen_r * trial_inf;
-         iter++;
-         if( value_left <= 0. && value_mid >= 0. && value_right <= 0. )
+         if( values_[i - 1] <= 0. && values_[i] >= 0. && values_[i + 1] <= 0. )
          {
             return false;
          }
@@ -134,11 +120,13 @@ void PiecewisePenalty::UpdateEntry(
    Number Gzi1, Gzi2;
    Number epsM = 0.0; //1e-20;
    Number TmpPen = 0.0;
-   // construt a temp list, copy current list to the temp list
-   std::vector<PiecewisePenEntry> TmpList(PiecewisePenalty_list_);
-   // Erases the elements of current list
+   // move the current list to the temp list and rebuild the current list;
+   // swapping keeps the memory of both lists, so no allocation is needed
+   // once the lists have reached their maximal length
+   TmpList_.swap(PiecewisePenalty_list_);
    PiecewisePenalty_list_.clear();
-   std::vector<PiecewisePenEntry>::iterator iter = TmpList.begin(), iter2;
+   const std::vector<PiecewisePenEntry>& TmpList = TmpList_;
+   std::vector<PiecewisePenEntry>::const_iterator iter = TmpList.begin(), iter2;
    Gzi1 = barrier_obj + iter->pen_r * (infeasi - iter->infeasi) - iter->barrier_obj;
    for( ; iter <= TmpList.end() - 1; iter++ )
    {
@@ -213,11 +201,11 @@ void PiecewisePenalty::Print(
 {
    // DBG_START_METH("FilterLineSearch::Filter::Print", dbg_verbosity);
    jnlst.Printf(J_DETAILED, J_LINE_SEARCH,
-                "The current piecewise penalty has %d entries.\n", PiecewisePenalty_list_.size());
+                "The current piecewise penalty has %d entries.\n", (int) PiecewisePenalty_list_.size());
    jnlst.Printf(J_DETAILED, J_LINE_SEARCH,
-                "We only allow %d entries.\n", max_piece_number_);
+                "We only allow %" IPOPT_INDEX_FORMAT " entries.\n", max_piece_number_);
    jnlst.Printf(J_DETAILED, J_LINE_SEARCH,
-                "The min piecewise penalty is %d .\n", min_piece_penalty_);
+                "The min piecewise penalty is %g .\n", min_piece_penalty_);
    if( !jnlst.ProduceOutput(J_DETAILED, J_LINE_SEARCH) )
    {
       return;
@@ -233,7 +221,7 @@ void PiecewisePenalty::Print(
       }
       count++;
       jnlst.Printf(J_DETAILED, J_LINE_SEARCH,
-                   "%5d ", count);
+                   "%5" IPOPT_INDEX_FORMAT " ", count);
       jnlst.Printf(J_DETAILED, J_LINE_SEARCH,
                    "%23.16e %23.16e  %23.16e \n", iter->pen_r, iter->barrier_obj, iter->infeasi);
    }
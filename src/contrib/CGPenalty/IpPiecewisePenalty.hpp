@@ -162,6 +162,12 @@ private:
 
    /** vector storing the Piecewise Penalty entries */
    std::vector<PiecewisePenEntry> PiecewisePenalty_list_;
+
+   /** Work space for UpdateEntry, holds the previous list */
+   std::vector<PiecewisePenEntry> TmpList_;
+
+   /** Work space for Acceptable, holds the values of the entries at the trial point */
+   std::vector<Number> values_;
 };
 
 } // namespace Ipopt
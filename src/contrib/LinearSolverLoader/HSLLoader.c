@@ -18,11 +18,25 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_SNPRINTF
+#define mysnprintf snprintf
+#else
+# ifdef HAVE__SNPRINTF
+# define mysnprintf _snprintf
+# else
+#  define mysnprintf snprintf
+# endif
+#endif
 
 #define HSLLIBNAME "libhsl." SHAREDLIBEXT
 
 static soHandle_t HSL_handle = NULL;
 
+/* name of the library that HSL_handle refers to */
+static char HSL_libname[512] = "";
+
 void LSL_lateHSLLoad(void);
 
 typedef void (*voidfun)(void);
@@ -1010,25 +1024,41 @@ void mc68_order_i(
 
 #endif
 
-int LSL_loadHSL(
+static int unloadHSL(void);
+
+static int loadHSL(
    const char* libname,
    char*       msgbuf,
    int         msglen
 )
 {
-   /* load HSL library */
-   if( libname )
+   if( libname == NULL ) /* use a default library name */
    {
-      HSL_handle = LSL_loadLib(libname, msgbuf, msglen);
+      libname = HSLLIBNAME;
    }
-   else /* try a default library name */
+
+   /* the symbols of a library that has been loaded before are kept;
+    * the library is not replaced by another one, since solvers in other
+    * threads may still run its code
+    */
+   if( HSL_handle != NULL )
    {
-      HSL_handle = LSL_loadLib(HSLLIBNAME, msgbuf, msglen);
+      if( strcmp(libname, HSL_libname) == 0 )
+      {
+         return 0;
+      }
+      mysnprintf(msgbuf, msglen, "Cannot load HSL library %s, since HSL library %s has been loaded already.", libname, HSL_libname);
+      return 1;
    }
+
+   /* load HSL library */
+   HSL_handle = LSL_loadLib(libname, msgbuf, msglen);
    if( HSL_handle == NULL )
    {
       return 1;
    }
+   strncpy(HSL_libname, libname, sizeof(HSL_libname) - 1);
+   HSL_libname[sizeof(HSL_libname) - 1] = '\0';
 
    /* load HSL functions */
 #ifndef COINHSL_HAS_MA27
@@ -1099,10 +1129,36 @@ int LSL_loadHSL(
    return 0;
 }
 
+int LSL_loadHSL(
+   const char* libname,
+   char*       msgbuf,
+   int         msglen
+)
+{
+   int rc;
+
+   LSL_lockLoader();
+   rc = loadHSL(libname, msgbuf, msglen);
+   LSL_unlockLoader();
+
+   return rc;
+}
+
 int LSL_unloadHSL(void)
 {
    int rc;
 
+   LSL_lockLoader();
+   rc = unloadHSL();
+   LSL_unlockLoader();
+
+   return rc;
+}
+
+static int unloadHSL(void)
+{
+   int rc;
+
    if( HSL_handle == NULL )
    {
       return 0;
@@ -1110,6 +1166,7 @@ int LSL_unloadHSL(void)
 
    rc = LSL_unloadLib(HSL_handle);
    HSL_handle = NULL;
+   HSL_libname[0] = '\0';
 
 #ifndef COINHSL_HAS_MA27
    func_ma27id = NULL;
@@ -1161,6 +1218,7 @@ int LSL_unloadHSL(void)
    func_ma97_factor_solve = NULL;
    func_ma97_solve = NULL;
    func_ma97_finalise = NULL;
+   func_ma97_free_akeep = NULL;
 #endif
 
 #ifndef COINHSL_HAS_MC19
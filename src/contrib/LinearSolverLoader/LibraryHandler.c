@@ -13,6 +13,10 @@
 #include <string.h>
 #include <ctype.h>
 
+#if !defined(HAVE_WINDOWS_H) && defined(HAVE_DLFCN_H)
+# include <pthread.h>
+#endif
+
 #ifdef HAVE_SNPRINTF
 #define mysnprintf snprintf
 #else
@@ -79,6 +83,33 @@ int LSL_unloadLib(
    return rc;
 } /* LSL_unLoadLib */
 
+#ifdef HAVE_WINDOWS_H
+static volatile LONG loader_lock = 0;
+#elif defined(HAVE_DLFCN_H)
+static pthread_mutex_t loader_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void LSL_lockLoader(void)
+{
+#ifdef HAVE_WINDOWS_H
+   while( InterlockedCompareExchange(&loader_lock, 1, 0) != 0 )
+   {
+      Sleep(0);
+   }
+#elif defined(HAVE_DLFCN_H)
+   pthread_mutex_lock(&loader_lock);
+#endif
+} /* LSL_lockLoader */
+
+void LSL_unlockLoader(void)
+{
+#ifdef HAVE_WINDOWS_H
+   InterlockedExchange(&loader_lock, 0);
+#elif defined(HAVE_DLFCN_H)
+   pthread_mutex_unlock(&loader_lock);
+#endif
+} /* LSL_unlockLoader */
+
 #ifdef HAVE_WINDOWS_H
 typedef FARPROC symtype;
 #else
@@ -58,4 +58,14 @@ int LSL_unloadLib(
    soHandle_t libhandle
 );
 
+/** Acquires the process-wide lock that protects loading and unloading
+ *  of the linear solver libraries and their symbol tables.
+ *
+ *  The lock is not recursive.
+ */
+void LSL_lockLoader(void);
+
+/** Releases the lock acquired by LSL_lockLoader. */
+void LSL_unlockLoader(void);
+
 #endif /* LIBRARYHANDLER_H_ */
@@ -11,13 +11,27 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#ifdef HAVE_SNPRINTF
+#define mysnprintf snprintf
+#else
+# ifdef HAVE__SNPRINTF
+# define mysnprintf _snprintf
+# else
+#  define mysnprintf snprintf
+# endif
+#endif
+
 /* Type of Fortran integer translated into C */
 typedef IPOPT_FORTRAN_INTEGER_TYPE ipfint;
 
 static soHandle_t Pardiso_handle = NULL;
 
+/* name of the library that Pardiso_handle refers to */
+static char Pardiso_libname[512] = "";
+
 void LSL_lateParadisoLibLoad(void);
 
 typedef void (*voidfun)(void);
@@ -118,25 +132,64 @@ void pardiso(
 
 #define PARDISOLIBNAME "libpardiso." SHAREDLIBEXT
 
-int LSL_loadPardisoLib(
+static int unloadPardisoLib(void)
+{
+   int rc;
+
+   if( Pardiso_handle == NULL )
+   {
+      return 0;
+   }
+
+   rc = LSL_unloadLib(Pardiso_handle);
+   Pardiso_handle = NULL;
+   Pardiso_libname[0] = '\0';
+
+   func_pardisoinit = NULL;
+   func_pardiso = NULL;
+
+   return rc;
+}
+
+static int loadPardisoLib(
    const char* libname,
    char*       msgbuf,
    int         msglen
 )
 {
-   /* load Pardiso library */
-   if( libname )
+   if( libname == NULL )
    {
-      Pardiso_handle = LSL_loadLib(libname, msgbuf, msglen);
+      /* try a default library name */
+      libname = PARDISOLIBNAME;
    }
-   else
+
+   /* the symbols of a library that has been loaded before are kept;
+    * the library is not replaced by another one, since solvers in other
+    * threads may still run its code
+    */
+   if( Pardiso_handle != NULL )
    {
-      /* try a default library name */
-      Pardiso_handle = LSL_loadLib(PARDISOLIBNAME, msgbuf, msglen);
+      if( strcmp(libname, Pardiso_libname) != 0 )
+      {
+         mysnprintf(msgbuf, msglen, "Cannot load Pardiso library %s, since Pardiso library %s has been loaded already.", libname, Pardiso_libname);
+         return 1;
+      }
+      if( func_pardisoinit != NULL && func_pardiso != NULL )
+      {
+         return 0;
+      }
+      /* look for the symbols in the loaded library again */
    }
-   if( Pardiso_handle == NULL )
+   else
    {
-      return 1;
+      /* load Pardiso library */
+      Pardiso_handle = LSL_loadLib(libname, msgbuf, msglen);
+      if( Pardiso_handle == NULL )
+      {
+         return 1;
+      }
+      strncpy(Pardiso_libname, libname, sizeof(Pardiso_libname) - 1);
+      Pardiso_libname[sizeof(Pardiso_libname) - 1] = '\0';
    }
 
    /* load Pardiso functions, we assume the >= 4.0.0 interface */
@@ -158,20 +211,28 @@ int LSL_loadPardisoLib(
    return 0;
 }
 
-int LSL_unloadPardisoLib(void)
+int LSL_loadPardisoLib(
+   const char* libname,
+   char*       msgbuf,
+   int         msglen
+)
 {
    int rc;
 
-   if( Pardiso_handle == NULL )
-   {
-      return 0;
-   }
+   LSL_lockLoader();
+   rc = loadPardisoLib(libname, msgbuf, msglen);
+   LSL_unlockLoader();
 
-   rc = LSL_unloadLib(Pardiso_handle);
-   Pardiso_handle = NULL;
+   return rc;
+}
 
-   func_pardisoinit = NULL;
-   func_pardiso = NULL;
+int LSL_unloadPardisoLib(void)
+{
+   int rc;
+
+   LSL_lockLoader();
+   rc = unloadPardisoLib();
+   LSL_unlockLoader();
 
    return rc;
 }
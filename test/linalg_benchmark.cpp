@@ -0,0 +1,868 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+// Micro-benchmarks for the kernels of the linear algebra layer and the
+// assembly of the KKT matrix for the linear solver.
+//
+// All data is generated deterministically, so that the timings of
+// different builds (compilers, BLAS libraries, machines) can be compared.
+// Run "linalg_benchmark -h" for the command line options.
+
+#include "IpDenseVector.hpp"
+#include "IpCompoundVector.hpp"
+#include "IpExpansionMatrix.hpp"
+#include "IpCompoundSymMatrix.hpp"
+#include "IpDiagMatrix.hpp"
+#include "IpSymTMatrix.hpp"
+#include "IpGenTMatrix.hpp"
+#include "IpTripletHelper.hpp"
+#include "IpTripletToCSRConverter.hpp"
+#include "IpUtils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace Ipopt;
+
+/** Results of the kernels are accumulated here, so that the compiler
+ *  cannot remove the calls. */
+static volatile Number bench_sink = 0.;
+
+/** DenseVector that exposes the implementations of the reductions.
+ *
+ *  Vector::Dot and Vector::Nrm2 return cached values if the vectors
+ *  have not changed, so a repeated call would not measure anything.
+ */
+class BenchDenseVector: public DenseVector
+{
+public:
+   BenchDenseVector(
+      const DenseVectorSpace* owner_space
+   )
+      : DenseVector(owner_space)
+   { }
+
+   Number UncachedDot(
+      const Vector& x
+   ) const
+   {
+      return DotImpl(x);
+   }
+
+   Number UncachedNrm2() const
+   {
+      return Nrm2Impl();
+   }
+};
+
+/** Fill a vector with reproducible values in [-1,1] */
+static void FillRandom(
+   Vector& v
+)
+{
+   std::vector<Number> values(v.Dim());
+   for( Index i = 0; i < v.Dim(); i++ )
+   {
+      values[i] = 2. * IpRandom01() - 1.;
+   }
+   if( v.Dim() > 0 )
+   {
+      TripletHelper::PutValuesInVector(v.Dim(), &values[0], v);
+   }
+}
+
+/** Base class of a micro-benchmark */
+class BenchKernel
+{
+public:
+   BenchKernel(
+      const char* name,
+      Index       n,
+      Index       nnz
+   )
+      : name_(name),
+        n_(n),
+        nnz_(nnz)
+   { }
+
+   virtual ~BenchKernel()
+   { }
+
+   /** Execute the kernel once */
+   virtual void Run() = 0;
+
+   const char* Name() const
+   {
+      return name_;
+   }
+
+   /** Dimension of the problem the data was generated for */
+   Index N() const
+   {
+      return n_;
+   }
+
+   /** Number of nonzeros of the matrix, or the vector length */
+   Index Nnz() const
+   {
+      return nnz_;
+   }
+
+private:
+   const char* name_;
+   Index n_;
+   Index nnz_;
+};
+
+/** Vectors for the dense kernels */
+class DenseData
+{
+public:
+   DenseData(
+      Index n
+   )
+      : space_(new DenseVectorSpace(n)),
+        x_(new BenchDenseVector(GetRawPtr(space_))),
+        y_(new BenchDenseVector(GetRawPtr(space_))),
+        z_(new BenchDenseVector(GetRawPtr(space_)))
+   {
+      FillRandom(*x_);
+      FillRandom(*y_);
+      FillRandom(*z_);
+   }
+
+   SmartPtr<DenseVectorSpace> space_;
+   SmartPtr<BenchDenseVector> x_;
+   SmartPtr<BenchDenseVector> y_;
+   SmartPtr<BenchDenseVector> z_;
+};
+
+class DenseDot: public BenchKernel
+{
+public:
+   DenseDot(
+      const DenseData& d
+   )
+      : BenchKernel("dense_dot", d.x_->Dim(), d.x_->Dim()),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      bench_sink += d_.x_->UncachedDot(*d_.y_);
+   }
+
+private:
+   const DenseData& d_;
+};
+
+class DenseNrm2: public BenchKernel
+{
+public:
+   DenseNrm2(
+      const DenseData& d
+   )
+      : BenchKernel("dense_nrm2", d.x_->Dim(), d.x_->Dim()),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      bench_sink += d_.x_->UncachedNrm2();
+   }
+
+private:
+   const DenseData& d_;
+};
+
+/** y += alpha*x for a vector of any type; alpha alternates its sign
+ *  so that the values stay bounded */
+class VectorAxpy: public BenchKernel
+{
+public:
+   VectorAxpy(
+      const char* name,
+      Index       n,
+      Vector&     x,
+      Vector&     y
+   )
+      : BenchKernel(name, n, x.Dim()),
+        x_(x),
+        y_(y),
+        alpha_(0.5)
+   { }
+
+   virtual void Run()
+   {
+      y_.Axpy(alpha_, x_);
+      alpha_ = -alpha_;
+   }
+
+private:
+   Vector& x_;
+   Vector& y_;
+   Number alpha_;
+};
+
+/** Fused y += alpha*x and y^T z with the AxpyDot method */
+class VectorAxpyDot: public BenchKernel
+{
+public:
+   VectorAxpyDot(
+      const char* name,
+      Index       n,
+      Vector&     x,
+      Vector&     y,
+      Vector&     z
+   )
+      : BenchKernel(name, n, x.Dim()),
+        x_(x),
+        y_(y),
+        z_(z),
+        alpha_(0.5)
+   { }
+
+   virtual void Run()
+   {
+      bench_sink += y_.AxpyDot(alpha_, x_, z_);
+      alpha_ = -alpha_;
+   }
+
+private:
+   Vector& x_;
+   Vector& y_;
+   Vector& z_;
+   Number alpha_;
+};
+
+/** z = x + 0.5*y with the AddTwoVectors method */
+class VectorAddTwoVectors: public BenchKernel
+{
+public:
+   VectorAddTwoVectors(
+      const char* name,
+      Index       n,
+      Vector&     x,
+      Vector&     y,
+      Vector&     z
+   )
+      : BenchKernel(name, n, x.Dim()),
+        x_(x),
+        y_(y),
+        z_(z)
+   { }
+
+   virtual void Run()
+   {
+      z_.AddTwoVectors(1., x_, 0.5, y_, 0.);
+   }
+
+private:
+   Vector& x_;
+   Vector& y_;
+   Vector& z_;
+};
+
+/** z = x, z = z .* y with the Copy and ElementWiseMultiply methods */
+class VectorElementWiseMultiply: public BenchKernel
+{
+public:
+   VectorElementWiseMultiply(
+      const char* name,
+      Index       n,
+      Vector&     x,
+      Vector&     y,
+      Vector&     z
+   )
+      : BenchKernel(name, n, x.Dim()),
+        x_(x),
+        y_(y),
+        z_(z)
+   { }
+
+   virtual void Run()
+   {
+      z_.Copy(x_);
+      z_.ElementWiseMultiply(y_);
+   }
+
+private:
+   Vector& x_;
+   Vector& y_;
+   Vector& z_;
+};
+
+/** CompoundVectors with four components of (almost) equal size */
+class CompoundData
+{
+public:
+   CompoundData(
+      Index n
+   )
+   {
+      const Index ncomp = 4;
+      space_ = new CompoundVectorSpace(ncomp, n);
+      for( Index i = 0; i < ncomp; i++ )
+      {
+         Index dim = n / ncomp + (i < n % ncomp ? 1 : 0);
+         comp_spaces_.push_back(new DenseVectorSpace(dim));
+         space_->SetCompSpace(i, *comp_spaces_[i]);
+      }
+      x_ = space_->MakeNewCompoundVector();
+      y_ = space_->MakeNewCompoundVector();
+      z_ = space_->MakeNewCompoundVector();
+      FillRandom(*x_);
+      FillRandom(*y_);
+      FillRandom(*z_);
+   }
+
+   std::vector<SmartPtr<DenseVectorSpace> > comp_spaces_;
+   SmartPtr<CompoundVectorSpace> space_;
+   SmartPtr<CompoundVector> x_;
+   SmartPtr<CompoundVector> y_;
+   SmartPtr<CompoundVector> z_;
+};
+
+/** ExpansionMatrix that selects every second element of a vector of
+ *  length n, as for variables with one bound */
+class ExpansionData
+{
+public:
+   ExpansionData(
+      Index n
+   )
+   {
+      std::vector<Index> pos;
+      for( Index i = 0; i < n; i += 2 )
+      {
+         pos.push_back(i);
+      }
+      large_space_ = new DenseVectorSpace(n);
+      small_space_ = new DenseVectorSpace((Index) pos.size());
+      space_ = new ExpansionMatrixSpace(n, (Index) pos.size(), pos.empty() ? NULL : &pos[0]);
+      P_ = space_->MakeNewExpansionMatrix();
+      large_ = large_space_->MakeNewDenseVector();
+      small_ = small_space_->MakeNewDenseVector();
+      FillRandom(*large_);
+      FillRandom(*small_);
+   }
+
+   SmartPtr<DenseVectorSpace> large_space_;
+   SmartPtr<DenseVectorSpace> small_space_;
+   SmartPtr<ExpansionMatrixSpace> space_;
+   SmartPtr<ExpansionMatrix> P_;
+   SmartPtr<DenseVector> large_;
+   SmartPtr<DenseVector> small_;
+};
+
+class ExpansionMult: public BenchKernel
+{
+public:
+   ExpansionMult(
+      ExpansionData& d
+   )
+      : BenchKernel("expansion_mult", d.large_->Dim(), d.small_->Dim()),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      d_.P_->MultVector(1., *d_.small_, 0., *d_.large_);
+   }
+
+private:
+   ExpansionData& d_;
+};
+
+class ExpansionTransMult: public BenchKernel
+{
+public:
+   ExpansionTransMult(
+      ExpansionData& d
+   )
+      : BenchKernel("expansion_trans_mult", d.large_->Dim(), d.small_->Dim()),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      d_.P_->TransMultVector(1., *d_.large_, 0., *d_.small_);
+   }
+
+private:
+   ExpansionData& d_;
+};
+
+/** Matrices with the structure of a KKT matrix
+ *
+ *  The Hessian W of dimension n is banded with three nonzeros per row
+ *  in its lower triangle, the Jacobian J has n/2 rows with three
+ *  nonzeros each, and the KKT matrix is [W J^T; J -D] with a diagonal D.
+ */
+class KKTData
+{
+public:
+   KKTData(
+      Index n
+   )
+   {
+      Index m = n / 2;
+      std::vector<Index> irows, jcols;
+      for( Index i = 0; i < n; i++ )
+      {
+         irows.push_back(i + 1);
+         jcols.push_back(i + 1);
+         if( i >= 1 )
+         {
+            irows.push_back(i + 1);
+            jcols.push_back(i);
+         }
+         if( i >= 5 )
+         {
+            irows.push_back(i + 1);
+            jcols.push_back(i - 4);
+         }
+      }
+      W_space_ = new SymTMatrixSpace(n, (Index) irows.size(), &irows[0], &jcols[0]);
+      W_ = W_space_->MakeNewSymTMatrix();
+      std::vector<Number> values(irows.size());
+      for( size_t k = 0; k < values.size(); k++ )
+      {
+         values[k] = irows[k] == jcols[k] ? 10. : IpRandom01() - 0.5;
+      }
+      W_->SetValues(&values[0]);
+
+      irows.clear();
+      jcols.clear();
+      for( Index j = 0; j < m; j++ )
+      {
+         irows.push_back(j + 1);
+         jcols.push_back(2 * j + 1);
+         irows.push_back(j + 1);
+         jcols.push_back(2 * j + 2);
+         irows.push_back(j + 1);
+         jcols.push_back((2 * j + 7) % n + 1);
+      }
+      J_space_ = new GenTMatrixSpace(m, n, (Index) irows.size(), irows.empty() ? NULL : &irows[0],
+                                     jcols.empty() ? NULL : &jcols[0]);
+      J_ = J_space_->MakeNewGenTMatrix();
+      values.resize(irows.size());
+      for( size_t k = 0; k < values.size(); k++ )
+      {
+         values[k] = IpRandom01() - 0.5;
+      }
+      if( !values.empty() )
+      {
+         J_->SetValues(&values[0]);
+      }
+
+      c_space_ = new DenseVectorSpace(m);
+      D_space_ = new DiagMatrixSpace(m);
+      D_ = D_space_->MakeNewDiagMatrix();
+      SmartPtr<DenseVector> d = c_space_->MakeNewDenseVector();
+      d->Set(-1e-8);
+      D_->SetDiag(*d);
+
+      K_space_ = new CompoundSymMatrixSpace(2, n + m);
+      K_space_->SetBlockDim(0, n);
+      K_space_->SetBlockDim(1, m);
+      K_space_->SetCompSpace(0, 0, *W_space_);
+      K_space_->SetCompSpace(1, 0, *J_space_);
+      K_space_->SetCompSpace(1, 1, *D_space_);
+      K_ = K_space_->MakeNewCompoundSymMatrix();
+      K_->SetComp(0, 0, *W_);
+      K_->SetComp(1, 0, *J_);
+      K_->SetComp(1, 1, *D_);
+
+      nnz_ = TripletHelper::GetNumberEntries(*K_);
+      airn_.resize(nnz_);
+      ajcn_.resize(nnz_);
+      TripletHelper::FillRowCol(nnz_, *K_, &airn_[0], &ajcn_[0]);
+      values_.resize(nnz_);
+      TripletHelper::FillValues(nnz_, *K_, &values_[0]);
+
+      x_space_ = new DenseVectorSpace(n);
+      x_ = x_space_->MakeNewDenseVector();
+      y_ = x_space_->MakeNewDenseVector();
+      FillRandom(*x_);
+   }
+
+   SmartPtr<SymTMatrixSpace> W_space_;
+   SmartPtr<SymTMatrix> W_;
+   SmartPtr<GenTMatrixSpace> J_space_;
+   SmartPtr<GenTMatrix> J_;
+   SmartPtr<DenseVectorSpace> c_space_;
+   SmartPtr<DiagMatrixSpace> D_space_;
+   SmartPtr<DiagMatrix> D_;
+   SmartPtr<CompoundSymMatrixSpace> K_space_;
+   SmartPtr<CompoundSymMatrix> K_;
+   SmartPtr<DenseVectorSpace> x_space_;
+   SmartPtr<DenseVector> x_;
+   SmartPtr<DenseVector> y_;
+
+   /** Triplet format of the KKT matrix */
+   Index nnz_;
+   std::vector<Index> airn_;
+   std::vector<Index> ajcn_;
+   std::vector<Number> values_;
+};
+
+class SymTMult: public BenchKernel
+{
+public:
+   SymTMult(
+      KKTData& d
+   )
+      : BenchKernel("symt_mult", d.x_->Dim(), d.W_->Nonzeros()),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      d_.W_->MultVector(1., *d_.x_, 0., *d_.y_);
+   }
+
+private:
+   KKTData& d_;
+};
+
+class GenTRowAMax: public BenchKernel
+{
+public:
+   GenTRowAMax(
+      KKTData& d
+   )
+      : BenchKernel("gent_row_amax", d.x_->Dim(), d.J_->Nonzeros()),
+        d_(d),
+        rows_(d.c_space_->MakeNewDenseVector())
+   { }
+
+   virtual void Run()
+   {
+      rows_->Set(0.);
+      d_.J_->ComputeRowAMax(*rows_, false);
+   }
+
+private:
+   KKTData& d_;
+   SmartPtr<DenseVector> rows_;
+};
+
+class TripletFillValues: public BenchKernel
+{
+public:
+   TripletFillValues(
+      KKTData& d
+   )
+      : BenchKernel("triplet_fill_values", d.x_->Dim(), d.nnz_),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      TripletHelper::FillValues(d_.nnz_, *d_.K_, &d_.values_[0]);
+   }
+
+private:
+   KKTData& d_;
+};
+
+class TripletToCSRInitialize: public BenchKernel
+{
+public:
+   TripletToCSRInitialize(
+      KKTData& d
+   )
+      : BenchKernel("triplet_to_csr_initialize", d.x_->Dim(), d.nnz_),
+        d_(d)
+   { }
+
+   virtual void Run()
+   {
+      SmartPtr<TripletToCSRConverter> converter = new TripletToCSRConverter(0);
+      bench_sink += converter->InitializeConverter(d_.K_->Dim(), d_.nnz_, &d_.airn_[0], &d_.ajcn_[0]);
+   }
+
+private:
+   KKTData& d_;
+};
+
+class TripletToCSRConvert: public BenchKernel
+{
+public:
+   TripletToCSRConvert(
+      KKTData& d
+   )
+      : BenchKernel("triplet_to_csr_convert", d.x_->Dim(), d.nnz_),
+        d_(d),
+        converter_(new TripletToCSRConverter(0))
+   {
+      nonzeros_compressed_ = converter_->InitializeConverter(d_.K_->Dim(), d_.nnz_, &d_.airn_[0], &d_.ajcn_[0]);
+      values_compressed_.resize(nonzeros_compressed_);
+   }
+
+   virtual void Run()
+   {
+      converter_->ConvertValues(d_.nnz_, &d_.values_[0], nonzeros_compressed_, &values_compressed_[0]);
+   }
+
+private:
+   KKTData& d_;
+   SmartPtr<TripletToCSRConverter> converter_;
+   Index nonzeros_compressed_;
+   std::vector<Number> values_compressed_;
+};
+
+/** Settings of the benchmark */
+struct BenchSettings
+{
+   std::vector<Index> sizes;
+   /** number of timed batches of calls */
+   Index repetitions;
+   /** minimal time of a batch for the calibration of the number of calls */
+   Number min_time;
+   /** fixed number of calls per batch, or 0 for calibration */
+   Index calls;
+   /** run only kernels whose name contains this string */
+   std::string filter;
+   bool json;
+};
+
+/** Time a kernel and write one record */
+static void Measure(
+   const BenchSettings& settings,
+   BenchKernel&         kernel,
+   bool&                first_record
+)
+{
+   if( std::string(kernel.Name()).find(settings.filter) == std::string::npos )
+   {
+      return;
+   }
+
+   // warm up caches and calibrate the number of calls per batch
+   Index calls = settings.calls;
+   kernel.Run();
+   if( calls <= 0 )
+   {
+      calls = 1;
+      while( true )
+      {
+         Number start = MonotonicTime();
+         for( Index k = 0; k < calls; k++ )
+         {
+            kernel.Run();
+         }
+         if( MonotonicTime() - start >= settings.min_time || calls >= 1 << 28 )
+         {
+            break;
+         }
+         calls *= 2;
+      }
+   }
+
+   std::vector<Number> times;
+   for( Index r = 0; r < settings.repetitions; r++ )
+   {
+      Number start = MonotonicTime();
+      for( Index k = 0; k < calls; k++ )
+      {
+         kernel.Run();
+      }
+      times.push_back((MonotonicTime() - start) / calls);
+   }
+   std::sort(times.begin(), times.end());
+   Number median = times[times.size() / 2];
+   if( times.size() % 2 == 0 )
+   {
+      median = 0.5 * (median + times[times.size() / 2 - 1]);
+   }
+
+   if( settings.json )
+   {
+      printf("%s\n  {\"kernel\": \"%s\", \"n\": %d, \"nnz\": %d, \"calls\": %d, \"repetitions\": %d, "
+             "\"min\": %.6e, \"median\": %.6e, \"max\": %.6e}", first_record ? "" : ",", kernel.Name(), (int) kernel.N(),
+             (int) kernel.Nnz(), (int) calls, (int) settings.repetitions, times.front(), median, times.back());
+   }
+   else
+   {
+      printf("%s,%d,%d,%d,%d,%.6e,%.6e,%.6e\n", kernel.Name(), (int) kernel.N(), (int) kernel.Nnz(), (int) calls,
+             (int) settings.repetitions, times.front(), median, times.back());
+   }
+   fflush(stdout);
+   first_record = false;
+}
+
+static void RunBenchmarks(
+   const BenchSettings& settings,
+   Index                n,
+   bool&                first_record
+)
+{
+   // the same data for every run with the same sizes
+   IpResetRandom01();
+
+   {
+      DenseData d(n);
+      DenseDot dot(d);
+      Measure(settings, dot, first_record);
+      DenseNrm2 nrm2(d);
+      Measure(settings, nrm2, first_record);
+      VectorAxpy axpy("dense_axpy", n, *d.x_, *d.y_);
+      Measure(settings, axpy, first_record);
+      VectorAxpyDot axpydot("dense_axpy_dot", n, *d.x_, *d.y_, *d.z_);
+      Measure(settings, axpydot, first_record);
+      VectorAddTwoVectors add("dense_add_two_vectors", n, *d.x_, *d.y_, *d.z_);
+      Measure(settings, add, first_record);
+      VectorElementWiseMultiply mult("dense_elementwise_multiply", n, *d.x_, *d.y_, *d.z_);
+      Measure(settings, mult, first_record);
+   }
+
+   {
+      CompoundData d(n);
+      VectorAxpy axpy("compound_axpy", n, *d.x_, *d.y_);
+      Measure(settings, axpy, first_record);
+      VectorAxpyDot axpydot("compound_axpy_dot", n, *d.x_, *d.y_, *d.z_);
+      Measure(settings, axpydot, first_record);
+      VectorAddTwoVectors add("compound_add_two_vectors", n, *d.x_, *d.y_, *d.z_);
+      Measure(settings, add, first_record);
+      VectorElementWiseMultiply mult("compound_elementwise_multiply", n, *d.x_, *d.y_, *d.z_);
+      Measure(settings, mult, first_record);
+   }
+
+   {
+      ExpansionData d(n);
+      ExpansionMult mult(d);
+      Measure(settings, mult, first_record);
+      ExpansionTransMult transmult(d);
+      Measure(settings, transmult, first_record);
+   }
+
+   {
+      KKTData d(n);
+      SymTMult mult(d);
+      Measure(settings, mult, first_record);
+      GenTRowAMax rowamax(d);
+      Measure(settings, rowamax, first_record);
+      TripletFillValues fill(d);
+      Measure(settings, fill, first_record);
+      TripletToCSRInitialize init(d);
+      Measure(settings, init, first_record);
+      TripletToCSRConvert convert(d);
+      Measure(settings, convert, first_record);
+   }
+}
+
+static void PrintUsage(
+   const char* exe
+)
+{
+   printf("Usage: %s [-n SIZES] [-r REPEAT] [-m MINTIME] [-c CALLS] [-k KERNEL] [-f csv|json]\n", exe);
+   printf("   -n SIZES    comma separated list of problem dimensions (default 1000,10000,100000)\n");
+   printf("   -r REPEAT   number of timed batches of calls per kernel (default 5)\n");
+   printf("   -m MINTIME  minimal time in seconds of a batch to calibrate the number of calls (default 0.02)\n");
+   printf("   -c CALLS    fixed number of calls per batch instead of the calibration\n");
+   printf("   -k KERNEL   run only the kernels whose name contains KERNEL\n");
+   printf("   -f FORMAT   output format, csv (default) or json\n");
+   printf("The times are in seconds per call of the kernel.\n");
+}
+
+int main(
+   int   argc,
+   char* argv[]
+)
+{
+   BenchSettings settings;
+   settings.sizes.push_back(1000);
+   settings.sizes.push_back(10000);
+   settings.sizes.push_back(100000);
+   settings.repetitions = 5;
+   settings.min_time = 0.02;
+   settings.calls = 0;
+   settings.json = false;
+
+   for( int i = 1; i < argc; i++ )
+   {
+      if( i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2 )
+      {
+         PrintUsage(argv[0]);
+         return argc == 2 && !strcmp(argv[1], "-h") ? 0 : 1;
+      }
+      const char* arg = argv[++i];
+      bool ok = true;
+      switch( argv[i - 1][1] )
+      {
+         case 'n':
+         {
+            settings.sizes.clear();
+            std::string list(arg);
+            size_t start = 0;
+            while( ok && start <= list.size() )
+            {
+               size_t end = list.find(',', start);
+               if( end == std::string::npos )
+               {
+                  end = list.size();
+               }
+               Index n = atoi(list.substr(start, end - start).c_str());
+               ok = n > 0;
+               settings.sizes.push_back(n);
+               start = end + 1;
+            }
+            break;
+         }
+         case 'r':
+            settings.repetitions = atoi(arg);
+            ok = settings.repetitions > 0;
+            break;
+         case 'm':
+            settings.min_time = atof(arg);
+            ok = settings.min_time > 0.;
+            break;
+         case 'c':
+            settings.calls = atoi(arg);
+            ok = settings.calls > 0;
+            break;
+         case 'k':
+            settings.filter = arg;
+            break;
+         case 'f':
+            ok = !strcmp(arg, "csv") || !strcmp(arg, "json");
+            settings.json = !strcmp(arg, "json");
+            break;
+         default:
+            ok = false;
+      }
+      if( !ok )
+      {
+         printf("Invalid argument \"%s\" for %s.\n", arg, argv[i - 1]);
+         PrintUsage(argv[0]);
+         return 1;
+      }
+   }
+
+   if( settings.json )
+   {
+      printf("{\"results\": [");
+   }
+   else
+   {
+      printf("kernel,n,nnz,calls,repetitions,min,median,max\n");
+   }
+   bool first_record = true;
+   for( size_t i = 0; i < settings.sizes.size(); i++ )
+   {
+      RunBenchmarks(settings, settings.sizes[i], first_record);
+   }
+   if( settings.json )
+   {
+      printf("\n]}\n");
+   }
+
+   return 0;
+}
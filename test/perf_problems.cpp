@@ -0,0 +1,13 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+// Implementations of the problems of examples/ScalableProblems that are
+// solved by perf_regression, compiled here so that the test directory
+// does not depend on a build of the examples.
+
+#include "LuksanVlcek1.cpp"
+#include "LuksanVlcek2.cpp"
+#include "LuksanVlcek5.cpp"
+#include "MittelmannBndryCntrlDiri.cpp"
+#include "MittelmannDistCntrlDiri.cpp"
@@ -0,0 +1,9 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+// Implementations of the problems of examples/ScalableProblems that are
+// solved by perf_regression and that cannot be compiled together with
+// those in perf_problems.cpp, since they define the same local helpers.
+
+#include "LuksanVlcek6.cpp"
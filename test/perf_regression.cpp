@@ -0,0 +1,462 @@
+// Copyright (C) 2021 COIN-OR Foundation
+// All Rights Reserved.
+// This code is published under the Eclipse Public License.
+
+// Performance regression test.
+//
+// Solves the problems listed in a baseline file and compares the number
+// of iterations, the number of factorizations of the KKT matrix, and the
+// wallclock times of tasks of the timing statistics with the values in
+// the file.  The test fails if a count or a time exceeds its baseline by
+// more than the tolerance.  With -w, the measured values are written as
+// a new baseline, e.g., to record the times on a new machine.
+//
+// Each line of the baseline file has the form
+//   PROBLEM N LINEAR_SOLVER [option:NAME=VALUE ...] iterations=I factorizations=F [TASK=SECONDS ...]
+// where TASK is the name of a task of the timing statistics, e.g.,
+// OverallAlgorithm/ComputeSearchDirection, and option:NAME=VALUE sets
+// the Ipopt string option NAME for the solve.  Lines starting with # are
+// ignored.
+
+#include "IpIpoptApplication.hpp"
+#include "IpSolveStatistics.hpp"
+#include "IpIpoptData.hpp"
+#include "IpTimingStatistics.hpp"
+
+#include "LuksanVlcek1.hpp"
+#include "LuksanVlcek2.hpp"
+#include "LuksanVlcek5.hpp"
+#include "LuksanVlcek6.hpp"
+#include "MittelmannBndryCntrlDiri.hpp"
+#include "MittelmannDistCntrlDiri.hpp"
+#include "MittelmannParaCntrl.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Ipopt;
+
+/** Tasks whose times are written with -w */
+static const char* recorded_tasks[] =
+{
+   "OverallAlgorithm",
+   "OverallAlgorithm/ComputeSearchDirection",
+   "OverallAlgorithm/ComputeAcceptableTrialPoint",
+   "PDSystemSolverTotal/LinearSystemFactorization",
+   "PDSystemSolverTotal/LinearSystemBackSolve"
+};
+static const size_t num_recorded_tasks = sizeof(recorded_tasks) / sizeof(recorded_tasks[0]);
+
+/** Problems that can be listed in the baseline file */
+static SmartPtr<RegisteredTNLP> CreateProblem(
+   const std::string& name
+)
+{
+   if( name == "LukVlE1" )
+   {
+      return new LuksanVlcek1(0., 0.);
+   }
+   if( name == "LukVlI1" )
+   {
+      return new LuksanVlcek1(-1., 0.);
+   }
+   if( name == "LukVlE2" )
+   {
+      return new LuksanVlcek2(0., 0.);
+   }
+   if( name == "LukVlI2" )
+   {
+      return new LuksanVlcek2(-1., 0.);
+   }
+   if( name == "LukVlE5" )
+   {
+      return new LuksanVlcek5(0., 0.);
+   }
+   if( name == "LukVlI5" )
+   {
+      return new LuksanVlcek5(-1., 0.);
+   }
+   if( name == "LukVlE6" )
+   {
+      return new LuksanVlcek6(0., 0.);
+   }
+   if( name == "LukVlI6" )
+   {
+      return new LuksanVlcek6(-1., 0.);
+   }
+   if( name == "MBndryCntrl1" )
+   {
+      return new MittelmannBndryCntrlDiri1();
+   }
+   if( name == "MDistCntrl1" )
+   {
+      return new MittelmannDistCntrlDiri1();
+   }
+   if( name == "MPara5_1" )
+   {
+      return new MittelmannParaCntrlBase<MittelmannParaCntrl5_1>();
+   }
+   return NULL;
+}
+
+/** One line of the baseline file */
+struct BaselineEntry
+{
+   std::string problem;
+   Index N;
+   std::string linear_solver;
+   std::vector<std::string> option_names;
+   std::vector<std::string> option_values;
+   Index iterations;
+   Index factorizations;
+   std::vector<std::string> task_names;
+   std::vector<Number> task_times;
+};
+
+/** Tolerances for the comparison with the baseline */
+struct Tolerances
+{
+   /** relative tolerance for iterations and factorizations */
+   Number count_rel;
+   /** absolute tolerance for iterations and factorizations */
+   Index count_abs;
+   /** factor by which a time may exceed its baseline */
+   Number time_factor;
+   /** absolute slack in seconds for the times, for short tasks */
+   Number time_abs;
+};
+
+static bool ReadBaseline(
+   const char*                 filename,
+   std::vector<BaselineEntry>& entries
+)
+{
+   std::ifstream is(filename);
+   if( !is )
+   {
+      printf("Cannot open baseline file %s.\n", filename);
+      return false;
+   }
+   std::string line;
+   int lineno = 0;
+   while( std::getline(is, line) )
+   {
+      lineno++;
+      std::istringstream ls(line);
+      BaselineEntry entry;
+      if( !(ls >> entry.problem) || entry.problem[0] == '#' )
+      {
+         continue;
+      }
+      entry.iterations = -1;
+      entry.factorizations = -1;
+      bool ok = (bool) (ls >> entry.N >> entry.linear_solver);
+      std::string item;
+      while( ok && ls >> item )
+      {
+         size_t eq = item.find('=');
+         ok = eq != std::string::npos && eq > 0;
+         if( !ok )
+         {
+            break;
+         }
+         std::string key = item.substr(0, eq);
+         Number value = atof(item.c_str() + eq + 1);
+         if( key.compare(0, 7, "option:") == 0 )
+         {
+            entry.option_names.push_back(key.substr(7));
+            entry.option_values.push_back(item.substr(eq + 1));
+         }
+         else if( key == "iterations" )
+         {
+            entry.iterations = (Index) value;
+         }
+         else if( key == "factorizations" )
+         {
+            entry.factorizations = (Index) value;
+         }
+         else
+         {
+            entry.task_names.push_back(key);
+            entry.task_times.push_back(value);
+         }
+      }
+      if( !ok )
+      {
+         printf("Invalid line %d in baseline file %s:\n%s\n", lineno, filename, line.c_str());
+         return false;
+      }
+      entries.push_back(entry);
+   }
+   return true;
+}
+
+/** Check a measured count against its baseline */
+static bool CheckCount(
+   const char*       what,
+   Index             measured,
+   Index             baseline,
+   const Tolerances& tol
+)
+{
+   if( baseline < 0 )
+   {
+      return true;
+   }
+   Index allowed = baseline + Max(tol.count_abs, (Index) std::ceil(tol.count_rel * baseline));
+   if( measured > allowed )
+   {
+      printf("    REGRESSION: %d %s, baseline %d (allowed %d)\n", (int) measured, what, (int) baseline, (int) allowed);
+      return false;
+   }
+   if( measured < baseline )
+   {
+      printf("    improvement: %d %s, baseline %d\n", (int) measured, what, (int) baseline);
+   }
+   return true;
+}
+
+/** Solve the problem of an entry and compare with the baseline.
+ *
+ *  The measured values are stored in measured.
+ */
+static bool RunEntry(
+   const BaselineEntry& entry,
+   Index                repetitions,
+   const Tolerances&    tol,
+   BaselineEntry&       measured
+)
+{
+   printf("%s N=%d linear_solver=%s", entry.problem.c_str(), (int) entry.N, entry.linear_solver.c_str());
+   for( size_t i = 0; i < entry.option_names.size(); i++ )
+   {
+      printf(" %s=%s", entry.option_names[i].c_str(), entry.option_values[i].c_str());
+   }
+   printf("\n");
+   measured = entry;
+   measured.task_names.assign(recorded_tasks, recorded_tasks + num_recorded_tasks);
+   for( size_t i = 0; i < entry.task_names.size(); i++ )
+   {
+      if( std::find(measured.task_names.begin(), measured.task_names.end(), entry.task_names[i]) == measured.task_names.end() )
+      {
+         measured.task_names.push_back(entry.task_names[i]);
+      }
+   }
+   measured.task_times.assign(measured.task_names.size(), -1.);
+
+   SmartPtr<RegisteredTNLP> tnlp = CreateProblem(entry.problem);
+   if( !IsValid(tnlp) || !tnlp->InitializeProblem(entry.N) )
+   {
+      printf("    FAILED: unknown problem or invalid size\n");
+      return false;
+   }
+
+   // the counts are taken from the first solve, the times are the minima over all solves
+   for( Index r = 0; r < repetitions; r++ )
+   {
+      SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+      app->Options()->SetIntegerValue("print_level", 0);
+      app->Options()->SetStringValue("sb", "yes");
+      // the tasks of the timing statistics are timed only if they are printed
+      app->Options()->SetStringValue("print_timing_statistics", "yes");
+      app->Options()->SetStringValue("timing_statistics_clock", "wallclock");
+      bool ok = app->Options()->SetStringValue("linear_solver", entry.linear_solver);
+      for( size_t i = 0; ok && i < entry.option_names.size(); i++ )
+      {
+         ok = app->Options()->SetStringValue(entry.option_names[i], entry.option_values[i]);
+      }
+      // an ipopt.opt file is not read, since it would change the results
+      if( !ok || app->Initialize("") != Solve_Succeeded )
+      {
+         printf("    FAILED: cannot initialize Ipopt\n");
+         return false;
+      }
+      ApplicationReturnStatus status = app->OptimizeTNLP(GetRawPtr(tnlp));
+      if( status != Solve_Succeeded && status != Solved_To_Acceptable_Level )
+      {
+         printf("    FAILED: return status %d\n", (int) status);
+         return false;
+      }
+
+      TimingStatistics& timing = app->IpoptDataObject()->TimingStats();
+      if( r == 0 )
+      {
+         measured.iterations = app->Statistics()->IterationCount();
+         measured.factorizations = timing.LinearSystemFactorization().NumberOfCalls();
+      }
+      for( size_t i = 0; i < measured.task_names.size(); i++ )
+      {
+         Number time = timing.NamedTask(measured.task_names[i]).TotalWallclockTime();
+         if( r == 0 || time < measured.task_times[i] )
+         {
+            measured.task_times[i] = time;
+         }
+      }
+   }
+
+   bool ok = CheckCount("iterations", measured.iterations, entry.iterations, tol);
+   ok = CheckCount("factorizations", measured.factorizations, entry.factorizations, tol) && ok;
+   for( size_t i = 0; i < entry.task_names.size(); i++ )
+   {
+      size_t k = std::find(measured.task_names.begin(), measured.task_names.end(), entry.task_names[i])
+                 - measured.task_names.begin();
+      Number allowed = tol.time_factor * entry.task_times[i] + tol.time_abs;
+      if( measured.task_times[k] > allowed )
+      {
+         printf("    REGRESSION: %.4fs in %s, baseline %.4fs (allowed %.4fs)\n", measured.task_times[k],
+                entry.task_names[i].c_str(), entry.task_times[i], allowed);
+         ok = false;
+      }
+   }
+   printf("    %s: %d iterations, %d factorizations, %.4fs\n", ok ? "passed" : "FAILED", (int) measured.iterations,
+          (int) measured.factorizations, measured.task_times[0]);
+   return ok;
+}
+
+static void WriteBaseline(
+   FILE*                             fp,
+   const std::vector<BaselineEntry>& entries
+)
+{
+   fprintf(fp, "# PROBLEM N LINEAR_SOLVER [option:NAME=VALUE ...] iterations=I factorizations=F [TASK=SECONDS ...]\n");
+   for( size_t k = 0; k < entries.size(); k++ )
+   {
+      const BaselineEntry& entry = entries[k];
+      fprintf(fp, "%s %d %s", entry.problem.c_str(), (int) entry.N, entry.linear_solver.c_str());
+      for( size_t i = 0; i < entry.option_names.size(); i++ )
+      {
+         fprintf(fp, " option:%s=%s", entry.option_names[i].c_str(), entry.option_values[i].c_str());
+      }
+      fprintf(fp, " iterations=%d factorizations=%d", (int) entry.iterations, (int) entry.factorizations);
+      for( size_t i = 0; i < entry.task_names.size(); i++ )
+      {
+         fprintf(fp, " %s=%.4g", entry.task_names[i].c_str(), entry.task_times[i]);
+      }
+      fprintf(fp, "\n");
+   }
+}
+
+static void PrintUsage(
+   const char* exe
+)
+{
+   printf("Usage: %s [options] BASELINE\n", exe);
+   printf("   -c REL    relative tolerance for iterations and factorizations (default 0.1)\n");
+   printf("   -a ABS    absolute tolerance for iterations and factorizations (default 1)\n");
+   printf("   -t FACTOR factor by which a time may exceed its baseline (default 3)\n");
+   printf("   -s SEC    absolute slack for the times in seconds (default 0.05)\n");
+   printf("   -r REPEAT number of solves of each problem, the minimal times are compared (default 3)\n");
+   printf("   -w FILE   write the measured values as a new baseline to FILE\n");
+   printf("   -n        do not compare the times, only the counts\n");
+}
+
+int main(
+   int   argc,
+   char* argv[]
+)
+{
+   Tolerances tol;
+   tol.count_rel = 0.1;
+   tol.count_abs = 1;
+   tol.time_factor = 3.;
+   tol.time_abs = 0.05;
+   Index repetitions = 3;
+   const char* outfile = NULL;
+   bool check_times = true;
+
+   int i = 1;
+   for( ; i < argc && argv[i][0] == '-'; i++ )
+   {
+      if( !strcmp(argv[i], "-n") )
+      {
+         check_times = false;
+         continue;
+      }
+      if( i + 1 >= argc || strlen(argv[i]) != 2 )
+      {
+         PrintUsage(argv[0]);
+         return 1;
+      }
+      const char* arg = argv[++i];
+      switch( argv[i - 1][1] )
+      {
+         case 'c':
+            tol.count_rel = atof(arg);
+            break;
+         case 'a':
+            tol.count_abs = atoi(arg);
+            break;
+         case 't':
+            tol.time_factor = atof(arg);
+            break;
+         case 's':
+            tol.time_abs = atof(arg);
+            break;
+         case 'r':
+            repetitions = Max((Index) 1, (Index) atoi(arg));
+            break;
+         case 'w':
+            outfile = arg;
+            break;
+         default:
+            PrintUsage(argv[0]);
+            return 1;
+      }
+   }
+   if( i + 1 != argc )
+   {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+
+   std::vector<BaselineEntry> entries;
+   if( !ReadBaseline(argv[i], entries) )
+   {
+      return 1;
+   }
+
+   printf("Running performance regression tests...\n");
+   std::vector<BaselineEntry> measured(entries.size());
+   Index num_failed = 0;
+   for( size_t k = 0; k < entries.size(); k++ )
+   {
+      BaselineEntry entry = entries[k];
+      if( !check_times )
+      {
+         entry.task_names.clear();
+         entry.task_times.clear();
+      }
+      if( !RunEntry(entry, repetitions, tol, measured[k]) )
+      {
+         num_failed++;
+      }
+   }
+
+   if( outfile != NULL )
+   {
+      FILE* fp = fopen(outfile, "w");
+      if( fp == NULL )
+      {
+         printf("Cannot open %s.\n", outfile);
+         return 1;
+      }
+      WriteBaseline(fp, measured);
+      fclose(fp);
+      printf("New baseline written to %s.\n", outfile);
+   }
+
+   if( num_failed > 0 )
+   {
+      printf("\n    ******** %d of %d performance tests FAILED! ********\n", (int) num_failed, (int) entries.size());
+      return 1;
+   }
+   printf("\nAll %d performance tests passed.\n", (int) entries.size());
+   return 0;
+}